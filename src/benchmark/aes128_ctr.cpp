@@ -0,0 +1,120 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <array>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include "algorithm/aes128.h"
+#include "base/party.h"
+#include "communication/communication_layer.h"
+#include "communication/dummy_transport.h"
+#include "communication/simulated_transport.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+namespace mo = encrypto::motion;
+
+namespace {
+
+// two parties whose links have the network profile, e.g., "lan" or "wan"
+std::vector<mo::PartyPointer> MakeParties(const std::string& network_profile) {
+  namespace communication = mo::communication;
+  auto [transport_01, transport_10] = communication::DummyTransport::MakeTransportPair();
+  std::array<std::vector<std::unique_ptr<communication::Transport>>, 2> transports;
+  transports[0].resize(2);
+  transports[1].resize(2);
+  transports[0][1] = std::move(transport_01);
+  transports[1][0] = std::move(transport_10);
+  std::vector<mo::PartyPointer> parties;
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    auto communication_layer{std::make_unique<communication::CommunicationLayer>(
+        party_id, communication::MakeSimulatedTransports(
+                      std::move(transports[party_id]),
+                      communication::NetworkProfile::FromString(network_profile)))};
+    auto& party{parties.emplace_back(std::make_unique<mo::Party>(std::move(communication_layer)))};
+    party->GetConfiguration()->SetLoggingEnabled(false);
+  }
+  return parties;
+}
+
+}  // namespace
+
+// Encrypts state.range(0) counter blocks in one SIMD batch of protocol P under a key that is
+// expanded once with two parties on the network profile and reports the blocks per second.
+template <mo::MpcProtocol P>
+static void BM_Aes128Ctr(benchmark::State& state, const std::string& network_profile) {
+  const std::size_t number_of_blocks{static_cast<std::size_t>(state.range(0))};
+  const std::array<std::uint8_t, 16> key{}, initial_counter_block{};
+  const auto key_wires{mo::algorithm::Aes128CounterBlocks(key, 0, 1)};
+  const auto counter_blocks{
+      mo::algorithm::Aes128CounterBlocks(initial_counter_block, 0, number_of_blocks)};
+  for (auto _ : state) {
+    auto parties{MakeParties(network_profile)};
+    std::vector<std::future<void>> futures;
+    for (auto& party : parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party, &key_wires, &counter_blocks] {
+        const mo::algorithm::Aes128CtrKeystream keystream(
+            party->In<P>(std::span<const mo::BitVector<>>(key_wires), 0));
+        mo::ShareWrapper counters{
+            party->In<P>(std::span<const mo::BitVector<>>(counter_blocks), 0)};
+        keystream.Encrypt(counters).Out();
+        party->Run();
+        party->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+  state.counters["Blocks"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * number_of_blocks), benchmark::Counter::kIsRate);
+}
+
+[[maybe_unused]] static const bool kAes128CtrBenchmarksRegistered{[] {
+  using Benchmark = void (*)(benchmark::State&, const std::string&);
+  const std::array<std::pair<std::string_view, Benchmark>, 2> kProtocols{
+      {{"BooleanGmw", BM_Aes128Ctr<mo::MpcProtocol::kBooleanGmw>},
+       {"Bmr", BM_Aes128Ctr<mo::MpcProtocol::kBmr>}}};
+  for (const std::string network_profile : {"lan", "wan"}) {
+    for (const auto& [name, function] : kProtocols) {
+      benchmark::RegisterBenchmark(
+          fmt::format("BM_Aes128Ctr/{}/{}", name, network_profile).c_str(), function,
+          network_profile)
+          ->RangeMultiplier(100)
+          ->Range(1, 10000)
+          ->Unit(benchmark::kMillisecond)
+          ->UseRealTime();
+    }
+  }
+  return true;
+}()};
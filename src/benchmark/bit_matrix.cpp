@@ -0,0 +1,192 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/pseudo_random_generator.h"
+#include "utility/bit_matrix.h"
+#include "utility/bit_vector.h"
+
+using encrypto::motion::BitMatrix;
+
+namespace {
+
+// Selects the kernel given by state.range(0) for the lifetime of the object
+class ScopedTransposeKernel {
+ public:
+  explicit ScopedTransposeKernel(benchmark::State& state)
+      : default_kernel_(BitMatrix::GetTransposeKernel()) {
+    const auto kernel{static_cast<BitMatrix::TransposeKernel>(state.range(0))};
+    if (!BitMatrix::IsSupported(kernel)) {
+      state.SkipWithError("transpose kernel is not supported by this CPU");
+      return;
+    }
+    BitMatrix::SetTransposeKernel(kernel);
+  }
+  ~ScopedTransposeKernel() { BitMatrix::SetTransposeKernel(default_kernel_); }
+
+ private:
+  BitMatrix::TransposeKernel default_kernel_;
+};
+
+void TransposeKernelArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"kernel", "columns"});
+  for (auto kernel : {BitMatrix::TransposeKernel::kSse, BitMatrix::TransposeKernel::kAvx2,
+                      BitMatrix::TransposeKernel::kAvx512}) {
+    for (long columns = 1 << 10; columns <= 1 << 20; columns <<= 5) {
+      benchmark->Args({static_cast<long>(kernel), columns});
+    }
+  }
+}
+
+}  // namespace
+
+// Bit-sliced transposition of a 128 x state.range(1) matrix using the kernel state.range(0).
+static void BM_TransposeUsingBitSlicing(benchmark::State& state) {
+  ScopedTransposeKernel kernel(state);
+  const std::size_t number_of_columns = state.range(1);
+  std::vector<encrypto::motion::AlignedBitVector> rows(128);
+  for (auto& row : rows) {
+    row = encrypto::motion::AlignedBitVector::SecureRandom(number_of_columns);
+  }
+  std::array<std::byte*, 128> pointers;
+  for (std::size_t i = 0; i < pointers.size(); ++i) {
+    pointers[i] = rows[i].GetMutableData().data();
+  }
+  for (auto _ : state) {
+    BitMatrix::TransposeUsingBitSlicing(pointers, number_of_columns);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_columns * 128 / 8);
+}
+BENCHMARK(BM_TransposeUsingBitSlicing)->Apply(TransposeKernelArguments);
+
+// Receiver side of the OT extension, i.e., the transposition and hashing of a 128 x state.range(1)
+// matrix using the kernel state.range(0).
+static void BM_ReceiverTranspose128AndEncrypt(benchmark::State& state) {
+  ScopedTransposeKernel kernel(state);
+  const std::size_t number_of_columns = state.range(1);
+  std::vector<encrypto::motion::AlignedBitVector> rows(128);
+  for (auto& row : rows) {
+    row = encrypto::motion::AlignedBitVector::SecureRandom(number_of_columns);
+  }
+  std::array<const std::byte*, 128> pointers;
+  for (std::size_t i = 0; i < pointers.size(); ++i) {
+    pointers[i] = rows[i].GetData().data();
+  }
+  encrypto::motion::primitives::Prg prg_fixed_key;
+  std::array<std::byte, 16> key{};
+  prg_fixed_key.SetKey(key.data());
+  const std::vector<std::size_t> bitlengths(number_of_columns, 128);
+  std::vector<encrypto::motion::BitVector<>> output;
+  for (auto _ : state) {
+    output.resize(number_of_columns);
+    BitMatrix::ReceiverTranspose128AndEncrypt(pointers, output, prg_fixed_key, number_of_columns,
+                                              bitlengths);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_columns);
+}
+BENCHMARK(BM_ReceiverTranspose128AndEncrypt)->Apply(TransposeKernelArguments);
+
+// BitMatrix::Transpose of a state.range(0) x state.range(1) matrix, e.g., in the TransposeGate
+static void BM_Transpose(benchmark::State& state) {
+  const std::size_t number_of_rows = state.range(0), number_of_columns = state.range(1);
+  std::vector<encrypto::motion::AlignedBitVector> rows(number_of_rows);
+  for (auto& row : rows) {
+    row = encrypto::motion::AlignedBitVector::SecureRandom(number_of_columns);
+  }
+  BitMatrix matrix(std::move(rows));
+  for (auto _ : state) {
+    matrix.Transpose();
+    benchmark::DoNotOptimize(matrix.GetRow(0).GetData().data());
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_rows * number_of_columns / 8);
+}
+BENCHMARK(BM_Transpose)
+    ->ArgNames({"rows", "columns"})
+    ->Args({32, 1000})
+    ->Args({100, 100})
+    ->Args({129, 1000})
+    ->Args({1000, 129})
+    ->Args({1000, 1000})
+    ->Args({3000, 5000})
+    ->Args({64, 100000});
+
+// Code-word encoding of the KK13 receiver choices for state.range(0) OTs as in the previous
+// implementation, i.e., copying the code words into a BitMatrix and calling Transpose256Columns.
+static void BM_EncodeUsingTranspose256Columns(benchmark::State& state) {
+  const std::size_t number_of_ots = state.range(0);
+  const auto code_words{encrypto::motion::AlignedBitVector::SecureRandom(256 * 256 * 8)};
+  std::vector<std::size_t> inputs(number_of_ots);
+  for (std::size_t i = 0; i < number_of_ots; ++i) inputs[i] = i % 256;
+  for (auto _ : state) {
+    std::vector<encrypto::motion::AlignedBitVector> encoded(number_of_ots);
+    for (std::size_t i = 0; i < number_of_ots; ++i) {
+      encoded[i] =
+          encrypto::motion::AlignedBitVector(code_words.GetData().data() + 256 * inputs[i], 256);
+    }
+    BitMatrix matrix(std::move(encoded));
+    matrix.Transpose256Columns();
+    benchmark::DoNotOptimize(matrix.GetRow(0).GetData().data());
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_ots);
+}
+BENCHMARK(BM_EncodeUsingTranspose256Columns)
+    ->ArgName("ots")
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+
+// Code-word encoding of the KK13 receiver choices for state.range(1) OTs with
+// BitMatrix::EncodeTranspose256 using the kernel state.range(0).
+static void BM_EncodeTranspose256(benchmark::State& state) {
+  ScopedTransposeKernel kernel(state);
+  const std::size_t number_of_ots = state.range(1);
+  const auto code_words{encrypto::motion::AlignedBitVector::SecureRandom(256 * 256 * 8)};
+  std::vector<std::size_t> inputs(number_of_ots);
+  for (std::size_t i = 0; i < number_of_ots; ++i) inputs[i] = i % 256;
+  const std::size_t padded_size{(number_of_ots + 255) / 256 * 256};
+  for (auto _ : state) {
+    std::vector<encrypto::motion::AlignedBitVector> rows(
+        256, encrypto::motion::AlignedBitVector(padded_size));
+    std::array<std::byte*, 256> pointers;
+    for (std::size_t j = 0; j < pointers.size(); ++j) {
+      pointers[j] = rows[j].GetMutableData().data();
+    }
+    BitMatrix::EncodeTranspose256(code_words.GetData().data(), 256, inputs, pointers);
+    benchmark::DoNotOptimize(rows.data());
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_ots);
+}
+BENCHMARK(BM_EncodeTranspose256)->Apply([](benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"kernel", "ots"});
+  for (auto kernel : {BitMatrix::TransposeKernel::kSse, BitMatrix::TransposeKernel::kAvx2,
+                      BitMatrix::TransposeKernel::kAvx512}) {
+    for (long ots = 1 << 10; ots <= 1 << 18; ots <<= 4) {
+      benchmark->Args({static_cast<long>(kernel), ots});
+    }
+  }
+});
@@ -0,0 +1,257 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/blake2b.h"
+#include "primitives/pseudo_random_generator.h"
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+
+using encrypto::motion::BitVector;
+using encrypto::motion::BitwiseKernel;
+
+namespace {
+
+// Selects the kernel given by state.range(0) for the lifetime of the object
+class ScopedBitwiseKernel {
+ public:
+  explicit ScopedBitwiseKernel(benchmark::State& state)
+      : default_kernel_(encrypto::motion::GetBitwiseKernel()) {
+    const auto kernel{static_cast<BitwiseKernel>(state.range(0))};
+    if (!encrypto::motion::IsSupported(kernel)) {
+      state.SkipWithError("bitwise kernel is not supported by this CPU");
+      return;
+    }
+    encrypto::motion::SetBitwiseKernel(kernel);
+  }
+  ~ScopedBitwiseKernel() { encrypto::motion::SetBitwiseKernel(default_kernel_); }
+
+ private:
+  BitwiseKernel default_kernel_;
+};
+
+void BitwiseKernelArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"kernel", "bits"});
+  for (auto kernel : {BitwiseKernel::kSse, BitwiseKernel::kAvx2, BitwiseKernel::kAvx512}) {
+    for (long bits : {128, 256, 512, 4096, 65536, 1 << 20}) {
+      benchmark->Args({static_cast<long>(kernel), bits});
+    }
+  }
+}
+
+void BlockKernelArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"kernel", "blocks"});
+  for (auto kernel : {BitwiseKernel::kSse, BitwiseKernel::kAvx2, BitwiseKernel::kAvx512}) {
+    for (long blocks : {1, 4, 16, 256, 4096}) {
+      benchmark->Args({static_cast<long>(kernel), blocks});
+    }
+  }
+}
+
+}  // namespace
+
+// XOR of a BitVector of state.range(1) bits into another one using the kernel state.range(0).
+static void BM_XorAssign(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  auto a{BitVector<>::RandomSeeded(state.range(1), 0)};
+  const auto b{BitVector<>::RandomSeeded(state.range(1), 1)};
+  for (auto _ : state) {
+    a ^= b;
+    benchmark::DoNotOptimize(a.GetData().data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(1) / 8);
+}
+BENCHMARK(BM_XorAssign)->Apply(BitwiseKernelArguments);
+
+// AND of a BitVector of state.range(1) bits into another one using the kernel state.range(0).
+static void BM_AndAssign(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  auto a{BitVector<>::RandomSeeded(state.range(1), 0)};
+  const auto b{BitVector<>(state.range(1), true)};
+  for (auto _ : state) {
+    a &= b;
+    benchmark::DoNotOptimize(a.GetData().data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(1) / 8);
+}
+BENCHMARK(BM_AndAssign)->Apply(BitwiseKernelArguments);
+
+static void BM_PopCount(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  const auto a{BitVector<>::RandomSeeded(state.range(1), 0)};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.PopCount());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(1) / 8);
+}
+BENCHMARK(BM_PopCount)->Apply(BitwiseKernelArguments);
+
+static void BM_Parity(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  const auto a{BitVector<>::RandomSeeded(state.range(1), 0)};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.Parity());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(1) / 8);
+}
+BENCHMARK(BM_Parity)->Apply(BitwiseKernelArguments);
+
+// The worst case of FindFirstSet and reductions such as AndReduceBitVector, where only the last
+// bit is set and the whole vector has to be scanned.
+static void BM_FindFirstSet(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  BitVector<> a(state.range(1));
+  a.Set(true, state.range(1) - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.FindFirstSet());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(1) / 8);
+}
+BENCHMARK(BM_FindFirstSet)->Apply(BitwiseKernelArguments);
+
+// Concatenation of state.range(0) vectors of 61 bits each, i.e., copies at odd bit offsets as in
+// SimdifyGate.
+static void BM_AppendAtBitOffsets(benchmark::State& state) {
+  const auto part{BitVector<>::RandomSeeded(61, 0)};
+  for (auto _ : state) {
+    BitVector<> result;
+    for (long i = 0; i < state.range(0); ++i) result.Append(part);
+    benchmark::DoNotOptimize(result.GetData().data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 61 / 8);
+}
+BENCHMARK(BM_AppendAtBitOffsets)->ArgNames({"parts"})->RangeMultiplier(16)->Range(16, 1 << 12);
+
+// Subset of state.range(0) bits starting at bit 3, as in UnsimdifyGate.
+static void BM_SubsetAtBitOffset(benchmark::State& state) {
+  const auto a{BitVector<>::RandomSeeded(state.range(0) + 3, 0)};
+  for (auto _ : state) {
+    auto subset{a.Subset(3, state.range(0) + 3)};
+    benchmark::DoNotOptimize(subset.GetData().data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) / 8);
+}
+BENCHMARK(BM_SubsetAtBitOffset)->ArgNames({"bits"})->RangeMultiplier(16)->Range(256, 1 << 20);
+
+// XOR of state.range(1) blocks, e.g., the labels of a garbled circuit XOR gate, using the kernel
+// state.range(0).
+static void BM_XorBlocks(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  const std::size_t number_of_blocks = state.range(1);
+  const auto a{encrypto::motion::Block128Vector::MakeRandom(number_of_blocks)};
+  const auto b{encrypto::motion::Block128Vector::MakeRandom(number_of_blocks)};
+  encrypto::motion::Block128Vector out(number_of_blocks);
+  for (auto _ : state) {
+    encrypto::motion::XorBlocks(a.data(), b.data(), out.data(), number_of_blocks);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_blocks * 16);
+}
+BENCHMARK(BM_XorBlocks)->Apply(BlockKernelArguments);
+
+// XOR of the offset into the state.range(1) blocks selected by random bits, e.g., the input labels
+// of a garbled circuit, using the kernel state.range(0).
+static void BM_SelectXorBlocks(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  const std::size_t number_of_blocks = state.range(1);
+  const auto a{encrypto::motion::Block128Vector::MakeRandom(number_of_blocks)};
+  const auto offset{encrypto::motion::Block128::MakeRandom()};
+  const auto bits{BitVector<>::RandomSeeded(number_of_blocks, 0)};
+  encrypto::motion::Block128Vector out(number_of_blocks);
+  for (auto _ : state) {
+    encrypto::motion::SelectXorBlocks(bits.GetData().data(), a.data(), offset, out.data(),
+                                      number_of_blocks);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_blocks * 16);
+}
+BENCHMARK(BM_SelectXorBlocks)->Apply(BlockKernelArguments);
+
+// AES-CTR key stream of state.range(1) blocks, e.g., for the seed expansion of OT extension, using
+// the VAES kernel if state.range(0) selects AVX-512.
+static void BM_AesCtrStream(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  const std::size_t number_of_blocks = state.range(1);
+  encrypto::motion::primitives::Prg prg;
+  const auto key{encrypto::motion::Block128::MakeRandom()};
+  prg.SetKey(key.data());
+  encrypto::motion::Block128Vector out(number_of_blocks);
+  std::uint64_t counter{0};
+  for (auto _ : state) {
+    AesniCtrStreamBlocks128(prg.GetRoundKeys(), &counter, out.data(), number_of_blocks);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_blocks * 16);
+}
+BENCHMARK(BM_AesCtrStream)->Apply(BlockKernelArguments);
+
+// expansion of a seed to a row of state.range(0) bits of the OT extension matrix
+static void BM_PrgKeyStreamBits(benchmark::State& state) {
+  encrypto::motion::primitives::Prg prg;
+  const auto key{encrypto::motion::Block128::MakeRandom()};
+  prg.SetKey(key.data());
+  for (auto _ : state) {
+    auto row{prg.KeyStreamBits<encrypto::motion::AlignedAllocator>(state.range(0))};
+    benchmark::DoNotOptimize(row.GetData().data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) / 8);
+}
+BENCHMARK(BM_PrgKeyStreamBits)->ArgNames({"bits"})->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// hashes of 256 messages of state.range(1) bytes each, e.g., the 96-byte inputs (S, R, P) of the
+// key derivation of the base OTs, one by one via OpenSSL for the SSE kernel and 4 at a time else
+static void BM_Blake2bBatch(benchmark::State& state) {
+  ScopedBitwiseKernel kernel(state);
+  constexpr std::size_t kNumberOfMessages{256};
+  const std::size_t length = state.range(1);
+  std::vector<std::uint8_t> messages(kNumberOfMessages * length, 0x42),
+      digests(kNumberOfMessages * encrypto::motion::kBlake2bDigestSize);
+  std::vector<const std::uint8_t*> message_pointers;
+  std::vector<std::uint8_t*> digest_pointers;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_pointers.push_back(messages.data() + i * length);
+    digest_pointers.push_back(digests.data() + i * encrypto::motion::kBlake2bDigestSize);
+  }
+  for (auto _ : state) {
+    encrypto::motion::Blake2bBatch(message_pointers, length, digest_pointers);
+    benchmark::DoNotOptimize(digests.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * kNumberOfMessages);
+}
+BENCHMARK(BM_Blake2bBatch)
+    ->ArgNames({"kernel", "bytes"})
+    ->Args({static_cast<long>(BitwiseKernel::kSse), 32})
+    ->Args({static_cast<long>(BitwiseKernel::kSse), 96})
+    ->Args({static_cast<long>(BitwiseKernel::kSse), 1024})
+    ->Args({static_cast<long>(BitwiseKernel::kAvx2), 32})
+    ->Args({static_cast<long>(BitwiseKernel::kAvx2), 96})
+    ->Args({static_cast<long>(BitwiseKernel::kAvx2), 1024});
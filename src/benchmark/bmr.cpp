@@ -0,0 +1,77 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "primitives/aes/aesni_primitives.h"
+#include "primitives/pseudo_random_generator.h"
+#include "utility/block.h"
+
+// garbles the four rows of state.range(1) BMR AND gates for state.range(0) parties, one DKC
+// invocation per row
+static void BM_BmrDkc(benchmark::State& state) {
+  const std::size_t number_of_parties = state.range(0);
+  const std::size_t number_of_rows = 4 * state.range(1);
+  encrypto::motion::primitives::Prg prg;
+  prg.SetKey(encrypto::motion::Block128::MakeRandom().data());
+  const auto aes_round_keys = prg.GetRoundKeys();
+  const auto keys_a{encrypto::motion::Block128Vector::MakeRandom(number_of_rows)};
+  const auto keys_b{encrypto::motion::Block128Vector::MakeRandom(number_of_rows)};
+  encrypto::motion::Block128Vector garbled_tables(number_of_rows * number_of_parties);
+
+  for (auto _ : state) {
+    for (std::size_t row_i = 0; row_i < number_of_rows; ++row_i) {
+      AesniBmrDkc(aes_round_keys, keys_a[row_i].data(), keys_b[row_i].data(), row_i / 4,
+                  number_of_parties, garbled_tables[row_i * number_of_parties].data());
+    }
+    benchmark::DoNotOptimize(garbled_tables.data());
+  }
+  state.counters["Gates"] = benchmark::Counter(state.iterations() * state.range(1),
+                                               benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_BmrDkc)->ArgsProduct({{2, 3, 5}, {1, 64, 10000}});
+
+// the same rows garbled with the batched DKC
+static void BM_BmrDkcBatch(benchmark::State& state) {
+  const std::size_t number_of_parties = state.range(0);
+  const std::size_t number_of_rows = 4 * state.range(1);
+  encrypto::motion::primitives::Prg prg;
+  prg.SetKey(encrypto::motion::Block128::MakeRandom().data());
+  const auto aes_round_keys = prg.GetRoundKeys();
+  const auto keys_a{encrypto::motion::Block128Vector::MakeRandom(number_of_rows)};
+  const auto keys_b{encrypto::motion::Block128Vector::MakeRandom(number_of_rows)};
+  std::vector<std::uint64_t> gate_ids(number_of_rows);
+  for (std::size_t row_i = 0; row_i < number_of_rows; ++row_i) gate_ids[row_i] = row_i / 4;
+  encrypto::motion::Block128Vector garbled_tables(number_of_rows * number_of_parties);
+
+  for (auto _ : state) {
+    AesniBmrDkcBatch(aes_round_keys, keys_a.data(), keys_b.data(), gate_ids.data(),
+                     number_of_rows, number_of_parties, garbled_tables.data());
+    benchmark::DoNotOptimize(garbled_tables.data());
+  }
+  state.counters["Gates"] = benchmark::Counter(state.iterations() * state.range(1),
+                                               benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_BmrDkcBatch)->ArgsProduct({{2, 3, 5}, {1, 64, 10000}});
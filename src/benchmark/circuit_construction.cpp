@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <benchmark/benchmark.h>
+
+#include "algorithm/algorithm_description.h"
+#include "base/backend.h"
+#include "base/party.h"
+#include "base/register.h"
+#include "protocols/share_wrapper.h"
+#include "utility/allocation_counter.h"
+#include "utility/bit_vector.h"
+#include "utility/config.h"
+
+namespace mo = encrypto::motion;
+
+// Reports all heap allocations to the object accounting of the Register, which costs a thread-local
+// addition per allocation of the benchmarks.
+void* operator new(std::size_t size) {
+  mo::CountThreadAllocation(size);
+  if (auto pointer{std::malloc(size == 0 ? 1 : size)}) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace {
+
+constexpr std::array kCircuits{"advanced/aes_128.bristol", "advanced/sha_256.bristol",
+                               "int/int_mul64_size.bristol"};
+
+void CircuitArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"circuit", "simd"});
+  for (long circuit = 0; circuit < static_cast<long>(kCircuits.size()); ++circuit) {
+    for (long simd : {1, 100, 10000}) {
+      benchmark->Args({circuit, simd});
+    }
+  }
+}
+
+// maximum resident set size of the process so far
+std::size_t GetPeakResidentSetSize() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+}
+
+}  // namespace
+
+// Construction of the Boolean GMW gates and wires of a Bristol circuit with state.range(1) SIMD
+// values in one party, one gate per primitive operation. Besides the build time, reports the
+// objects created, the bytes per AND gate including its own wires, and the peak RSS of the
+// process, see Register::SetObjectAccounting.
+static void BM_BuildCircuit(benchmark::State& state) {
+  const auto algorithm{mo::AlgorithmDescription::FromBristol(
+      std::string(mo::kRootDir) + "/circuits/" + kCircuits.at(state.range(0)))};
+  const std::size_t number_of_inputs{algorithm.number_of_input_wires_parent_a +
+                                     algorithm.number_of_input_wires_parent_b.value_or(0)};
+  const std::vector<mo::BitVector<>> input(number_of_inputs, mo::BitVector<>(state.range(1)));
+  mo::ObjectStatisticsMap statistics;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto parties{mo::MakeLocallyConnectedParties(2, 0)};
+    auto& party{*parties.at(0)};
+    party.GetConfiguration()->SetOptimizeAlgorithms(false);
+    auto& gate_register{*party.GetBackend()->GetRegister()};
+    const mo::ShareWrapper share{party.In<mo::MpcProtocol::kBooleanGmw>(input, 0)};
+    gate_register.SetObjectAccounting(true);
+    state.ResumeTiming();
+
+    benchmark::DoNotOptimize(share.Evaluate(algorithm));
+
+    state.PauseTiming();
+    statistics = gate_register.GetObjectStatistics();
+    std::vector<std::future<void>> futures;
+    for (auto& p : parties) {
+      p->GetBackend()->GetCommunicationLayer().Start();
+      futures.emplace_back(std::async(std::launch::async, [&p] { p->Finish(); }));
+    }
+    std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+    state.ResumeTiming();
+  }
+
+  const auto total{statistics.GetTotal()};
+  state.counters["objects"] = total.number_of_objects;
+  state.counters["bytes_per_object"] =
+      static_cast<double>(total.GetBytes()) / std::max<std::size_t>(total.number_of_objects, 1);
+  const auto and_gates{statistics.find("boolean_gmw::AndGate")};
+  if (and_gates != statistics.end() && and_gates->second.number_of_objects > 0) {
+    // the AND gates of a Bristol circuit have a single output wire
+    const auto wires{statistics.at("boolean_gmw::Wire")};
+    state.counters["bytes_per_and_gate"] =
+        static_cast<double>(and_gates->second.GetBytes()) / and_gates->second.number_of_objects +
+        static_cast<double>(wires.GetBytes()) / wires.number_of_objects;
+  }
+  state.counters["peak_rss"] = GetPeakResidentSetSize();
+  state.SetLabel(kCircuits.at(state.range(0)));
+}
+BENCHMARK(BM_BuildCircuit)->Apply(CircuitArguments)->Unit(benchmark::kMillisecond);
@@ -100,7 +100,7 @@ static void BM_FiberMixComputationNoCheck(benchmark::State& state) {
   // evaluates the operator()
   std::size_t counter = 0;
   for (auto _ : state) {
-    encrypto::motion::FiberThreadPool fiber_pool(0, 2 * number_of_gates);
+    encrypto::motion::FiberThreadPool fiber_pool(0);
     for (auto& gate : gates) {
       fiber_pool.post([gate] { gate->operator()(); });
     }
@@ -147,7 +147,7 @@ static void BM_FiberMixComputationWithCheck(benchmark::State& state) {
   // evaluates the operator()
   std::size_t counter = 0;
   for (auto _ : state) {
-    encrypto::motion::FiberThreadPool fiber_pool(0, 2 * number_of_gates);
+    encrypto::motion::FiberThreadPool fiber_pool(0);
     for (auto& gate : gates) {
       if (gate->HasWork()) {
         fiber_pool.post([gate] { gate->operator()(); });
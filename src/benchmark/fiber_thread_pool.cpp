@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+
+#include <benchmark/benchmark.h>
+
+#include "utility/constants.h"
+#include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
+
+// Latency of evaluating a query of state.range(0) small tasks, creating and joining a pool for each
+// query as GateExecutor does by default.
+static void BM_FiberThreadPoolPerQuery(benchmark::State& state) {
+  const std::size_t number_of_tasks = state.range(0);
+  std::atomic<std::size_t> counter{0};
+  for (auto _ : state) {
+    encrypto::motion::FiberThreadPool fiber_pool(0, number_of_tasks);
+    for (std::size_t i = 0; i < number_of_tasks; ++i) {
+      fiber_pool.post([&counter] { ++counter; });
+    }
+    fiber_pool.wait_idle();
+    fiber_pool.join();
+  }
+  benchmark::DoNotOptimize(counter.load());
+  state.counters["Queries"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FiberThreadPoolPerQuery)->RangeMultiplier(4)->Range(16, 4096);
+
+// Latency of the same queries evaluated by a persistent pool with pooled fiber stacks.
+static void BM_FiberThreadPoolPersistent(benchmark::State& state) {
+  const std::size_t number_of_tasks = state.range(0);
+  std::atomic<std::size_t> counter{0};
+  encrypto::motion::FiberThreadPool fiber_pool(
+      0, number_of_tasks, true, false, encrypto::motion::FiberStackAllocator::kPooledFixedSize);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < number_of_tasks; ++i) {
+      fiber_pool.post([&counter] { ++counter; });
+    }
+    fiber_pool.wait_idle();
+  }
+  fiber_pool.join();
+  benchmark::DoNotOptimize(counter.load());
+  state.counters["Queries"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FiberThreadPoolPersistent)->RangeMultiplier(4)->Range(16, 4096);
@@ -45,7 +45,7 @@ static void BM_ThreeHalvesEvaluation(benchmark::State& state) {
   std::size_t counter{0};
   for (auto _ : state) {
     provider.Evaluate(keys_a, keys_b, keys_out, garbled_tables.GetData().data(),
-                      garbled_control_bits.GetData().data(), 0, 0);
+                      garbled_control_bits.GetData().data(), 0, 0, 0);
     counter += number_of_simd;
   }
 
@@ -58,7 +58,7 @@ static void BM_ThreeHalvesEvaluation(benchmark::State& state) {
 
   state.counters["Gates"] = benchmark::Counter(counter, benchmark::Counter::kIsRate);
 }
-BENCHMARK(BM_ThreeHalvesEvaluation)->RangeMultiplier(2)->Range(1, 128);
+BENCHMARK(BM_ThreeHalvesEvaluation)->RangeMultiplier(2)->Range(1, 4096);
 
 static void BM_ThreeHalvesGarbling(benchmark::State& state) {
   auto communication_layers = encrypto::motion::communication::MakeDummyCommunicationLayers(2);
@@ -79,7 +79,7 @@ static void BM_ThreeHalvesGarbling(benchmark::State& state) {
   std::size_t counter{0};
   for (auto _ : state) {
     provider.Garble(keys_a, keys_b, keys_out, garbled_tables.GetMutableData().data(),
-                    garbled_control_bits.GetMutableData().data(), 0, 0);
+                    garbled_control_bits.GetMutableData().data(), 0, 0, 0);
     counter += number_of_simd;
   }
 
@@ -92,4 +92,64 @@ static void BM_ThreeHalvesGarbling(benchmark::State& state) {
 
   state.counters["Gates"] = benchmark::Counter(counter, benchmark::Counter::kIsRate);
 }
-BENCHMARK(BM_ThreeHalvesGarbling)->RangeMultiplier(2)->Range(1, 128);
\ No newline at end of file
+BENCHMARK(BM_ThreeHalvesGarbling)->RangeMultiplier(2)->Range(1, 4096);
+static void BM_HalfGatesEvaluation(benchmark::State& state) {
+  auto communication_layers = encrypto::motion::communication::MakeDummyCommunicationLayers(2);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  encrypto::motion::proto::garbled_circuit::HalfGatesEvaluatorProvider provider(
+      *communication_layers[1]);
+
+  std::size_t number_of_simd = state.range(0);
+  encrypto::motion::Block128Vector keys_a(number_of_simd), keys_b(number_of_simd),
+      keys_out(number_of_simd);
+  std::vector<std::byte> garbled_tables(
+      number_of_simd * encrypto::motion::proto::garbled_circuit::kHalfGatesTableByteSize);
+
+  std::size_t counter{0};
+  for (auto _ : state) {
+    provider.Evaluate(keys_a, keys_b, keys_out, garbled_tables.data(), nullptr, 0, 0, 0);
+    counter += number_of_simd;
+  }
+
+  // shutdown all commmunication layers
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+
+  state.counters["Gates"] = benchmark::Counter(counter, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_HalfGatesEvaluation)->RangeMultiplier(2)->Range(1, 4096);
+
+static void BM_HalfGatesGarbling(benchmark::State& state) {
+  auto communication_layers = encrypto::motion::communication::MakeDummyCommunicationLayers(2);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  encrypto::motion::proto::garbled_circuit::HalfGatesGarblerProvider provider(
+      *communication_layers[0]);
+
+  std::size_t number_of_simd = state.range(0);
+  encrypto::motion::Block128Vector keys_a(number_of_simd), keys_b(number_of_simd),
+      keys_out(number_of_simd);
+  std::vector<std::byte> garbled_tables(
+      number_of_simd * encrypto::motion::proto::garbled_circuit::kHalfGatesTableByteSize);
+
+  std::size_t counter{0};
+  for (auto _ : state) {
+    provider.Garble(keys_a, keys_b, keys_out, garbled_tables.data(), nullptr, 0, 0, 0);
+    counter += number_of_simd;
+  }
+
+  // shutdown all commmunication layers
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+
+  state.counters["Gates"] = benchmark::Counter(counter, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_HalfGatesGarbling)->RangeMultiplier(2)->Range(1, 4096);
@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <set>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "base/configuration.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "statistics/gate_profile.h"
+#include "statistics/run_time_statistics.h"
+#include "utility/bit_vector.h"
+
+namespace mo = encrypto::motion;
+
+namespace {
+
+constexpr std::uint16_t kPortOffset{17777};
+constexpr std::size_t kNumberOfSimd{1000};
+
+template <mo::MpcProtocol P, bool kAnd>
+void BuildBooleanGate(mo::Party& party) {
+  const mo::BitVector<> input(kNumberOfSimd, true);
+  mo::ShareWrapper a{party.In<P>(input, 0)}, b{party.In<P>(input, 1)};
+  (kAnd ? a & b : a ^ b).Out();
+}
+
+template <typename T, bool kMultiplication>
+void BuildArithmeticGate(mo::Party& party) {
+  constexpr auto kArithmeticGmw{mo::MpcProtocol::kArithmeticGmw};
+  const std::vector<T> input(kNumberOfSimd, 1);
+  mo::ShareWrapper a{party.In<kArithmeticGmw>(input, 0)}, b{party.In<kArithmeticGmw>(input, 1)};
+  (kMultiplication ? a * b : a + b).Out();
+}
+
+struct GateBenchmark {
+  // as returned by GetGateType()
+  std::string_view gate_type;
+  // constructs a circuit with one gate of gate_type in party 0 or 1
+  void (*build)(mo::Party&);
+};
+
+// the garbler is party 0
+constexpr std::array kGateBenchmarks{
+    GateBenchmark{"boolean_gmw::AndGate", BuildBooleanGate<mo::MpcProtocol::kBooleanGmw, true>},
+    GateBenchmark{"boolean_gmw::XorGate", BuildBooleanGate<mo::MpcProtocol::kBooleanGmw, false>},
+    GateBenchmark{"bmr::AndGate", BuildBooleanGate<mo::MpcProtocol::kBmr, true>},
+    GateBenchmark{"bmr::XorGate", BuildBooleanGate<mo::MpcProtocol::kBmr, false>},
+    GateBenchmark{"garbled_circuit::AndGateGarbler",
+                  BuildBooleanGate<mo::MpcProtocol::kGarbledCircuit, true>},
+    GateBenchmark{"garbled_circuit::AndGateEvaluator",
+                  BuildBooleanGate<mo::MpcProtocol::kGarbledCircuit, true>},
+    GateBenchmark{"arithmetic_gmw::MultiplicationGate<unsigned int>",
+                  BuildArithmeticGate<std::uint32_t, true>},
+    GateBenchmark{"arithmetic_gmw::AdditionGate<unsigned int>",
+                  BuildArithmeticGate<std::uint32_t, false>},
+    GateBenchmark{"arithmetic_gmw::MultiplicationGate<unsigned long>",
+                  BuildArithmeticGate<std::uint64_t, true>},
+    GateBenchmark{"arithmetic_gmw::AdditionGate<unsigned long>",
+                  BuildArithmeticGate<std::uint64_t, false>}};
+
+}  // namespace
+
+// Evaluates a gate of kNumberOfSimd values in two locally connected parties with profiled gates
+// and reports the compute time per value of the gate type in both phases, averaged over the
+// parties that evaluate gates of the type, as the counter compute_ns_per_value, from which
+// CostModel::Calibrate takes the costs of EstimateCosts.
+static void BM_GateCost(benchmark::State& state, const GateBenchmark& gate) {
+  double compute_ns{0};
+  std::size_t number_of_values{0};
+  for (auto _ : state) {
+    auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+    std::vector<std::future<void>> futures;
+    for (auto& party : parties) {
+      party->GetConfiguration()->SetProfileGates(true);
+      futures.emplace_back(std::async(std::launch::async, [&party, &gate] {
+        gate.build(*party);
+        party->Run();
+        party->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+
+    for (auto& party : parties) {
+      const auto& profile{party->GetBackend()->GetRunTimeStatistics().back().gate_profile};
+      std::set<std::int64_t> gate_ids;
+      for (const auto& event : profile->events) {
+        if (event.gate_type != gate.gate_type) continue;
+        compute_ns += std::chrono::duration<double, std::nano>(event.GetComputeTime()).count();
+        gate_ids.insert(event.gate_id);
+      }
+      number_of_values += gate_ids.size() * kNumberOfSimd;
+    }
+  }
+  state.counters["compute_ns_per_value"] =
+      number_of_values > 0 ? compute_ns / static_cast<double>(number_of_values) : 0.0;
+}
+
+[[maybe_unused]] static const bool kGateCostBenchmarksRegistered{[] {
+  for (const auto& gate : kGateBenchmarks) {
+    benchmark::RegisterBenchmark(fmt::format("BM_GateCost/{}", gate.gate_type).c_str(),
+                                 BM_GateCost, gate)
+        ->Unit(benchmark::kMillisecond);
+  }
+  return true;
+}()};
@@ -0,0 +1,70 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "communication/message.h"
+#include "communication/message_buffer.h"
+#include "communication/message_manager.h"
+
+namespace communication = encrypto::motion::communication;
+
+// Registration of state.range(0) receives of a gate layer and the delivery of their messages of
+// state.range(1) bytes by the receive thread, i.e., the routing overhead per message excluding
+// the transport.
+static void BM_MessageManagerRegisterAndDeliver(benchmark::State& state) {
+  const std::size_t number_of_messages = state.range(0);
+  const std::vector<std::uint8_t> payload(state.range(1), 0x42);
+  communication::MessageManager message_manager(2, 0);
+  // the storage of the messages is shared with the buffers delivered in the loop
+  std::vector<communication::MessageBuffer> messages;
+  messages.reserve(number_of_messages);
+  for (std::size_t i = 0; i < number_of_messages; ++i) {
+    auto message_builder{
+        communication::BuildMessage(communication::MessageType::kBeaverOpening, i, payload)};
+    const auto raw_message{message_builder.Release()};
+    messages.emplace_back(
+        std::vector<std::uint8_t>(raw_message.data(), raw_message.data() + raw_message.size()));
+  }
+  std::vector<communication::MessageManager::future_type> futures;
+  futures.reserve(number_of_messages);
+  for (auto _ : state) {
+    futures.clear();
+    for (std::size_t i = 0; i < number_of_messages; ++i) {
+      futures.emplace_back(
+          message_manager.RegisterReceive(1, communication::MessageType::kBeaverOpening, i));
+    }
+    for (std::size_t i = 0; i < number_of_messages; ++i) {
+      message_manager.ReceivedMessage(1, messages[i].GetSubBuffer(0, messages[i].size()));
+    }
+    for (auto& future : futures) {
+      benchmark::DoNotOptimize(future.get().data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_messages);
+}
+BENCHMARK(BM_MessageManagerRegisterAndDeliver)
+    ->ArgNames({"messages", "bytes"})
+    ->ArgsProduct({{1, 64, 4096}, {16, 4096}});
@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "communication/message.h"
+
+namespace communication = encrypto::motion::communication;
+
+// Receive thread work to route a message of state.range(0) bytes by verifying and parsing the
+// flatbuffer, as done for control messages.
+static void BM_ReceiveVerifiedMessage(benchmark::State& state) {
+  const std::vector<std::uint8_t> payload(state.range(0), 0x42);
+  // the synchronization message type is never framed
+  auto message_builder{communication::BuildMessage(
+      communication::MessageType::kSynchronizationMessage, 42, payload)};
+  const auto raw_message{message_builder.Release()};
+  for (auto _ : state) {
+    flatbuffers::Verifier verifier(raw_message.data(), raw_message.size());
+    benchmark::DoNotOptimize(communication::VerifyMessageBuffer(verifier));
+    auto message{communication::GetMessage(raw_message.data())};
+    benchmark::DoNotOptimize(message->message_type());
+    benchmark::DoNotOptimize(message->message_id());
+  }
+  state.SetBytesProcessed(state.iterations() * raw_message.size());
+}
+BENCHMARK(BM_ReceiveVerifiedMessage)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+
+// Receive thread work to route a bulk message of state.range(0) bytes by its frame header.
+static void BM_ReceiveFramedMessage(benchmark::State& state) {
+  const std::vector<std::uint8_t> payload(state.range(0), 0x42);
+  auto message_builder{
+      communication::BuildMessage(communication::MessageType::kOtExtensionSender, 42, payload)};
+  const auto raw_message{message_builder.Release()};
+  for (auto _ : state) {
+    auto header{communication::ReadMessageFrameHeader(
+        std::span(raw_message.data(), raw_message.size()))};
+    benchmark::DoNotOptimize(header);
+  }
+  state.SetBytesProcessed(state.iterations() * raw_message.size());
+}
+BENCHMARK(BM_ReceiveFramedMessage)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "base/backend.h"
+#include "base/party.h"
+#include "base/register.h"
+#include "protocols/boolean_gmw/boolean_gmw_gate.h"
+#include "utility/bit_vector.h"
+
+namespace mo = encrypto::motion;
+
+// Construction of state.range(0) Boolean GMW XOR gates of state.range(1) SIMD values with
+// Register::EmplaceGate, i.e., the allocation of the gates and their output wires in the arena of
+// the register and their registration. The circuit is never evaluated, hence the number of
+// iterations is fixed to bound the memory of the register.
+static void BM_RegisterEmplaceGate(benchmark::State& state) {
+  const std::size_t number_of_gates = state.range(0);
+  const std::size_t number_of_simd = state.range(1);
+  auto parties{mo::MakeLocallyConnectedParties(2, 0)};
+  auto& party{*parties.at(0)};
+  auto& gate_register{*party.GetBackend()->GetRegister()};
+  const auto a{party.In<mo::MpcProtocol::kBooleanGmw>(mo::BitVector<>(number_of_simd), 0)};
+  const auto b{party.In<mo::MpcProtocol::kBooleanGmw>(mo::BitVector<>(number_of_simd), 0)};
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < number_of_gates; ++i) {
+      auto gate{gate_register.EmplaceGate<mo::proto::boolean_gmw::XorGate>(a, b)};
+      benchmark::DoNotOptimize(gate.get());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_gates);
+
+  std::vector<std::future<void>> futures;
+  for (auto& p : parties) {
+    p->GetBackend()->GetCommunicationLayer().Start();
+    futures.emplace_back(std::async(std::launch::async, [&p] { p->Finish(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+BENCHMARK(BM_RegisterEmplaceGate)
+    ->ArgNames({"gates", "simd"})
+    ->ArgsProduct({{16, 256, 4096}, {1, 1000}})
+    ->Iterations(100);
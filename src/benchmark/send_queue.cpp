@@ -0,0 +1,70 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utility/mpsc_fiber_queue.h"
+#include "utility/synchronized_queue.h"
+
+// state.range(0) threads enqueue state.range(1) messages each into the send queue of a peer,
+// which the benchmark thread drains like the send thread of the communication layer.
+template <typename QueueType>
+static void BM_SendQueue(benchmark::State& state) {
+  const std::size_t number_of_producers = state.range(0);
+  const std::size_t number_of_messages = state.range(1);
+  const auto message{std::make_shared<const std::vector<std::uint8_t>>(64, 0x42)};
+  for (auto _ : state) {
+    QueueType queue;
+    std::vector<std::thread> producers;
+    for (std::size_t producer_i = 0; producer_i < number_of_producers; ++producer_i) {
+      producers.emplace_back([&queue, &message, number_of_messages] {
+        for (std::size_t i = 0; i < number_of_messages; ++i) {
+          queue.enqueue(message);
+        }
+      });
+    }
+    for (std::size_t remaining = number_of_producers * number_of_messages; remaining > 0;) {
+      auto messages{queue.BatchDequeue()};
+      remaining -= messages->size();
+      benchmark::DoNotOptimize(messages);
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_producers * number_of_messages);
+}
+
+using MessagePointer = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+BENCHMARK_TEMPLATE(BM_SendQueue, encrypto::motion::SynchronizedFiberQueue<MessagePointer>)
+    ->ArgNames({"producers", "messages"})
+    ->ArgsProduct({{1, 4, 16, 64}, {1 << 14}})
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SendQueue, encrypto::motion::MpscFiberQueue<MessagePointer>)
+    ->ArgNames({"producers", "messages"})
+    ->ArgsProduct({{1, 4, 16, 64}, {1 << 14}})
+    ->UseRealTime();
@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstdint>
+#include <future>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "algorithm/sha256.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+namespace mo = encrypto::motion;
+
+namespace {
+
+constexpr std::uint16_t kPortOffset{17877};
+
+}  // namespace
+
+// Hashes state.range(0) messages of state.range(1) blocks in one SIMD batch of protocol P with two
+// locally connected parties and reports the hashes per second.
+template <mo::MpcProtocol P, mo::algorithm::IntegerCircuitOptimization kOptimization>
+static void BM_Sha256(benchmark::State& state) {
+  const std::size_t number_of_messages{static_cast<std::size_t>(state.range(0))};
+  const std::size_t number_of_blocks{static_cast<std::size_t>(state.range(1))};
+  const std::vector<std::vector<std::uint8_t>> messages(
+      number_of_messages,
+      std::vector<std::uint8_t>(number_of_blocks * mo::algorithm::kSha256BlockBitSize / 8 - 9));
+  const auto padded_messages{mo::algorithm::Sha256PadMessages(messages)};
+  for (auto _ : state) {
+    auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+    std::vector<std::future<void>> futures;
+    for (auto& party : parties) {
+      party->GetLogger()->SetEnabled(false);
+      futures.emplace_back(std::async(std::launch::async, [&party, &padded_messages] {
+        mo::ShareWrapper input{
+            party->In<P>(std::span<const mo::BitVector<>>(padded_messages), 0)};
+        mo::algorithm::Sha256(input, kOptimization).Out();
+        party->Run();
+        party->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+  state.counters["Hashes"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * number_of_messages), benchmark::Counter::kIsRate);
+}
+
+using mo::algorithm::IntegerCircuitOptimization;
+BENCHMARK_TEMPLATE(BM_Sha256, mo::MpcProtocol::kBooleanGmw, IntegerCircuitOptimization::kDepth)
+    ->ArgsProduct({{1, 100}, {1, 2}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sha256, mo::MpcProtocol::kBooleanGmw, IntegerCircuitOptimization::kSize)
+    ->ArgsProduct({{1, 100}, {1, 2}})
+    ->Unit(benchmark::kMillisecond);
+// the constant-round protocols only profit from fewer AND gates
+BENCHMARK_TEMPLATE(BM_Sha256, mo::MpcProtocol::kBmr, IntegerCircuitOptimization::kSize)
+    ->ArgsProduct({{1, 100}, {1, 2}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sha256, mo::MpcProtocol::kGarbledCircuit, IntegerCircuitOptimization::kSize)
+    ->ArgsProduct({{1, 100}, {1, 2}})
+    ->Unit(benchmark::kMillisecond);
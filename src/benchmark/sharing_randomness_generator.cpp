@@ -0,0 +1,94 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/sharing_randomness_generator.h"
+
+using encrypto::motion::primitives::SharingRandomnessGenerator;
+
+namespace {
+
+void InitializeWithFixedSeed(SharingRandomnessGenerator& generator) {
+  std::array<std::uint8_t, SharingRandomnessGenerator::kMasterSeedByteLength> seed;
+  seed.fill(0x42);
+  generator.Initialize(seed.data());
+}
+
+}  // namespace
+
+// randomness of state.range(0) arithmetic gates with one value each, as requested by the
+// arithmetic GMW input gates of consecutive gate ids
+template <typename T>
+static void BM_GetUnsigned(benchmark::State& state) {
+  const std::size_t number_of_gates = state.range(0);
+  SharingRandomnessGenerator generator(0);
+  InitializeWithFixedSeed(generator);
+  std::size_t gate_id{0};
+  for (auto _ : state) {
+    auto values{generator.GetUnsigned<T>(gate_id, number_of_gates)};
+    benchmark::DoNotOptimize(values.data());
+    gate_id += number_of_gates;
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_gates);
+}
+BENCHMARK_TEMPLATE(BM_GetUnsigned, std::uint32_t)->RangeMultiplier(16)->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_GetUnsigned, std::uint64_t)->RangeMultiplier(16)->Range(1, 1 << 16);
+
+// state.range(0) SIMD values of a single arithmetic gate expanded from its own AES-CTR stream
+template <typename T>
+static void BM_GetUnsignedStream(benchmark::State& state) {
+  const std::size_t number_of_simd = state.range(0);
+  SharingRandomnessGenerator generator(0);
+  InitializeWithFixedSeed(generator);
+  std::vector<T> values(number_of_simd);
+  std::size_t gate_id{0};
+  for (auto _ : state) {
+    generator.GetUnsignedStream<T>(gate_id++, std::span<T>(values));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_simd * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_GetUnsignedStream, std::uint32_t)->RangeMultiplier(16)->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_GetUnsignedStream, std::uint64_t)->RangeMultiplier(16)->Range(1, 1 << 16);
+
+// Boolean GMW randomness of consecutive gates with state.range(0) bits each, which are served from
+// the lookahead pool for small gates
+static void BM_GetBits(benchmark::State& state) {
+  const std::size_t number_of_bits = state.range(0);
+  SharingRandomnessGenerator generator(0);
+  InitializeWithFixedSeed(generator);
+  std::size_t gate_id{0};
+  for (auto _ : state) {
+    auto bits{generator.GetBits(gate_id, number_of_bits)};
+    benchmark::DoNotOptimize(bits.GetData().data());
+    gate_id += number_of_bits;
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_bits);
+}
+BENCHMARK(BM_GetBits)->ArgNames({"bits"})->RangeMultiplier(16)->Range(1, 1 << 20);
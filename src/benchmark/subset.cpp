@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2022 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "protocols/data_management/subset_gate.h"
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+
+namespace {
+
+constexpr std::size_t kNumberOfPositions{1'000'000};
+
+// kNumberOfPositions positions with the given stride starting at an unaligned position of
+// NumberOfValues(stride) values, or random positions for stride 0
+std::vector<std::size_t> Positions(std::size_t stride) {
+  std::vector<std::size_t> positions(kNumberOfPositions);
+  std::mt19937_64 random(0);
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    positions[i] = stride == 0 ? random() % kNumberOfPositions : 3 + i * stride;
+  }
+  return positions;
+}
+
+std::size_t NumberOfValues(std::size_t stride) { return (stride + 1) * kNumberOfPositions + 3; }
+
+void Strides(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"stride"})->Arg(0)->Arg(1)->Arg(2);
+}
+
+}  // namespace
+
+// Subset of the bits of a Boolean GMW or BMR wire with a BitVector::Set per position, as the
+// SubsetGate did before.
+static void BM_BitVectorSubsetPerPosition(benchmark::State& state) {
+  const auto positions{Positions(state.range(0))};
+  const auto in{encrypto::motion::BitVector<>::RandomSeeded(NumberOfValues(state.range(0)), 0)};
+  for (auto _ : state) {
+    encrypto::motion::BitVector<> out(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) out.Set(in[positions[i]], i);
+    benchmark::DoNotOptimize(out.GetData().data());
+  }
+  state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_BitVectorSubsetPerPosition)->Apply(Strides);
+
+// Subset of the same bits with the ranges of the SubsetGate, which are copied word-wise.
+static void BM_BitVectorSubsetRanges(benchmark::State& state) {
+  const auto positions{Positions(state.range(0))};
+  const auto in{encrypto::motion::BitVector<>::RandomSeeded(NumberOfValues(state.range(0)), 0)};
+  const auto ranges{encrypto::motion::ToSubsetRanges(positions)};
+  for (auto _ : state) {
+    auto out{encrypto::motion::BitVectorSubset(in, positions, ranges)};
+    benchmark::DoNotOptimize(out.GetData().data());
+  }
+  state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_BitVectorSubsetRanges)->Apply(Strides);
+
+// Subset of the keys of a BMR wire per position.
+static void BM_BlockSubsetPerPosition(benchmark::State& state) {
+  const auto positions{Positions(state.range(0))};
+  const auto in{encrypto::motion::Block128Vector::MakeRandom(NumberOfValues(state.range(0)))};
+  encrypto::motion::Block128Vector out(positions.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < positions.size(); ++i) out[i] = in[positions[i]];
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_BlockSubsetPerPosition)->Apply(Strides);
+
+// Subset of the keys of a BMR wire with ranges, which are copied with memmove.
+static void BM_BlockSubsetRanges(benchmark::State& state) {
+  const auto positions{Positions(state.range(0))};
+  const auto in{encrypto::motion::Block128Vector::MakeRandom(NumberOfValues(state.range(0)))};
+  const auto ranges{encrypto::motion::ToSubsetRanges(positions)};
+  encrypto::motion::Block128Vector out(positions.size());
+  for (auto _ : state) {
+    encrypto::motion::CopySubset(in.begin(), out.begin(), positions, ranges);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_BlockSubsetRanges)->Apply(Strides);
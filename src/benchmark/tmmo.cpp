@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/aes/aesni_primitives.h"
+#include "primitives/pseudo_random_generator.h"
+#include "utility/block.h"
+
+// TMMO hashing of state.range(0) blocks given by pointers, as done for the OTs of OT extension
+static void BM_TmmoBatch(benchmark::State& state) {
+  const std::size_t number_of_blocks = state.range(0);
+  encrypto::motion::primitives::Prg prg;
+  prg.SetKey(encrypto::motion::Block128::MakeRandom().data());
+  auto blocks{encrypto::motion::Block128Vector::MakeRandom(number_of_blocks)};
+  std::vector<void*> inputs(number_of_blocks);
+  for (std::size_t i = 0; i < number_of_blocks; ++i) inputs[i] = blocks[i].data();
+  for (auto _ : state) {
+    AesniTmmoBatch(prg.GetRoundKeys(), inputs.data(), number_of_blocks, 0);
+    benchmark::DoNotOptimize(blocks.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_blocks * 16);
+}
+BENCHMARK(BM_TmmoBatch)->ArgNames({"blocks"})->RangeMultiplier(4)->Range(1, 1 << 14);
+
+// TMMO hashing of state.range(0) consecutive blocks with two blocks per tweak, as done for the
+// labels of garbled AND gates
+static void BM_TmmoBatchContiguous(benchmark::State& state) {
+  const std::size_t number_of_blocks = state.range(0);
+  encrypto::motion::primitives::Prg prg;
+  prg.SetKey(encrypto::motion::Block128::MakeRandom().data());
+  auto blocks{encrypto::motion::Block128Vector::MakeRandom(number_of_blocks)};
+  for (auto _ : state) {
+    AesniTmmoBatchContiguous(prg.GetRoundKeys(), blocks.data(), number_of_blocks, 0, 2);
+    benchmark::DoNotOptimize(blocks.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * number_of_blocks * 16);
+}
+BENCHMARK(BM_TmmoBatchContiguous)->ArgNames({"blocks"})->RangeMultiplier(4)->Range(2, 1 << 14);
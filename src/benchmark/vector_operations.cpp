@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2022 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utility/helpers.h"
+
+namespace {
+
+template <typename T>
+std::vector<T> RandomValues(std::size_t size) {
+  std::mt19937_64 random(size);
+  std::vector<T> values(size);
+  for (auto& value : values) value = static_cast<T>(random());
+  return values;
+}
+
+void VectorSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"size"})->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+}
+
+}  // namespace
+
+// Element-wise addition into a freshly allocated vector, as used by the gates before.
+template <typename T>
+static void BM_AddVectorsAllocating(benchmark::State& state) {
+  const auto a{RandomValues<T>(state.range(0))}, b{RandomValues<T>(state.range(0) + 1)};
+  const std::span<const T> b_view(b.data(), a.size());
+  for (auto _ : state) {
+    auto result{encrypto::motion::AddVectors<T>(a, b_view)};
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_AddVectorsAllocating, std::uint8_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_AddVectorsAllocating, std::uint16_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_AddVectorsAllocating, std::uint32_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_AddVectorsAllocating, std::uint64_t)->Apply(VectorSizes);
+
+// Element-wise addition into an existing vector.
+template <typename T>
+static void BM_AddVectors(benchmark::State& state) {
+  const auto a{RandomValues<T>(state.range(0))}, b{RandomValues<T>(state.range(0) + 1)};
+  const std::span<const T> b_view(b.data(), a.size());
+  std::vector<T> result(a.size());
+  for (auto _ : state) {
+    encrypto::motion::AddVectors<T>(a, b_view, result);
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_AddVectors, std::uint8_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_AddVectors, std::uint16_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_AddVectors, std::uint32_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_AddVectors, std::uint64_t)->Apply(VectorSizes);
+
+// Element-wise multiplication into an existing vector, which has no native vector instruction for
+// 8 and 64 bit lanes without AVX-512.
+template <typename T>
+static void BM_MultiplyVectors(benchmark::State& state) {
+  const auto a{RandomValues<T>(state.range(0))}, b{RandomValues<T>(state.range(0) + 1)};
+  const std::span<const T> b_view(b.data(), a.size());
+  std::vector<T> result(a.size());
+  for (auto _ : state) {
+    encrypto::motion::MultiplyVectors<T>(a, b_view, result);
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_MultiplyVectors, std::uint8_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_MultiplyVectors, std::uint16_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_MultiplyVectors, std::uint32_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_MultiplyVectors, std::uint64_t)->Apply(VectorSizes);
+
+// Sum of 8 shares of state.range(0) values, as in the reconstruction of an output.
+template <typename T>
+static void BM_RowSumReduction(benchmark::State& state) {
+  std::vector<std::vector<T>> values(8);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = RandomValues<T>(state.range(0) + i);
+    values[i].resize(state.range(0));
+  }
+  std::vector<T> sum(state.range(0));
+  for (auto _ : state) {
+    encrypto::motion::RowSumReduction<T>(values, sum);
+    benchmark::DoNotOptimize(sum.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * values.size() * sum.size() * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_RowSumReduction, std::uint8_t)->Apply(VectorSizes);
+BENCHMARK_TEMPLATE(BM_RowSumReduction, std::uint64_t)->Apply(VectorSizes);
+
+// Product of a size x size matrix and a size x columns matrix, i.e., a matrix-vector product of a
+// dense layer for 1 column.
+template <typename T>
+static void BM_AddMatrixProduct(benchmark::State& state) {
+  const std::size_t size(state.range(0)), columns(state.range(1));
+  const auto a{RandomValues<T>(size * size)}, b{RandomValues<T>(size * columns + 1)};
+  std::vector<T> c(size * columns);
+  for (auto _ : state) {
+    encrypto::motion::AddMatrixProduct(a.data(), b.data(), c.data(), size, size, columns);
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * size * size * columns);
+}
+BENCHMARK_TEMPLATE(BM_AddMatrixProduct, std::uint8_t)
+    ->ArgNames({"size", "columns"})
+    ->ArgsProduct({{128, 1024}, {1, 128}});
+BENCHMARK_TEMPLATE(BM_AddMatrixProduct, std::uint32_t)
+    ->ArgNames({"size", "columns"})
+    ->ArgsProduct({{128, 1024}, {1, 128}});
+BENCHMARK_TEMPLATE(BM_AddMatrixProduct, std::uint64_t)
+    ->ArgNames({"size", "columns"})
+    ->ArgsProduct({{128, 1024}, {1, 128}});
@@ -57,6 +57,7 @@ int main(int ac, char* av[]) {
     encrypto::motion::MpcProtocol protocol;
     const std::string protocol_string{user_options["protocol"].as<std::string>()};
     auto check = user_options["check"].as<bool>();
+    const auto ctr{user_options["ctr"].as<bool>()};
     encrypto::motion::AccumulatedRunTimeStatistics accumulated_statistics;
     encrypto::motion::AccumulatedCommunicationStatistics accumulated_communication_statistics;
 
@@ -65,12 +66,12 @@ int main(int ac, char* av[]) {
       // establish communication channels with other parties
 
       if (protocol_string == "BMR") {
-        auto statistics =
-            EvaluateProtocol(party, number_of_simd, encrypto::motion::MpcProtocol::kBmr, check);
+        auto statistics = EvaluateProtocol(party, number_of_simd,
+                                           encrypto::motion::MpcProtocol::kBmr, check, ctr);
         accumulated_statistics.Add(statistics);
       } else if (protocol_string == "GMW" || protocol_string == "BooleanGMW") {
         auto statistics = EvaluateProtocol(party, number_of_simd,
-                                           encrypto::motion::MpcProtocol::kBooleanGmw, check);
+                                           encrypto::motion::MpcProtocol::kBooleanGmw, check, ctr);
         accumulated_statistics.Add(statistics);
       } else {
         throw std::invalid_argument("Only GMW or BMR is allowed");
@@ -81,7 +82,8 @@ int main(int ac, char* av[]) {
     }
 
     std::cout << encrypto::motion::PrintStatistics(
-        fmt::format("AES128 with {} SIMD values in {}", number_of_simd, protocol_string),
+        fmt::format("AES128{} with {} SIMD values in {}", ctr ? " CTR" : "", number_of_simd,
+                    protocol_string),
         accumulated_statistics, accumulated_communication_statistics);
 
   } catch (std::runtime_error& e) {
@@ -127,8 +129,10 @@ std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char
       ("num-simd", program_options::value<std::size_t>()->default_value(1), "number of SIMD values for AES evaluation")
       ("protocol", program_options::value<std::string>()->default_value("BMR"), "Boolean MPC protocol (BMR or GMW)")
       ("online-after-setup", program_options::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
+      ("critical-path-priority", program_options::value<bool>()->default_value(false), "post gates with a longer remaining path to the outputs first (true/1 or false/0)")
       ("repetitions", program_options::value<std::size_t>()->default_value(1), "number of repetitions")
-      ("check", program_options::value<bool>()->default_value(false), "check the computed values for correctness (true/1 or false/0)");
+      ("check", program_options::value<bool>()->default_value(false), "check the computed values for correctness (true/1 or false/0)")
+      ("ctr", program_options::value<bool>()->default_value(false), "encrypt num-simd counter blocks in CTR mode under a key that is expanded once (true/1 or false/0)");
   // clang-format on
 
   program_options::variables_map user_options;
@@ -211,5 +215,6 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
   const auto logging{!user_options.count("disable-logging")};
   configuration->SetLoggingEnabled(logging);
   configuration->SetOnlineAfterSetup(user_options["online-after-setup"].as<bool>());
+  configuration->SetCriticalPathPriority(user_options["critical-path-priority"].as<bool>());
   return party;
 }
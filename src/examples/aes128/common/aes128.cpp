@@ -24,6 +24,7 @@
 
 #include "aes128.h"
 
+#include "algorithm/aes128.h"
 #include "algorithm/algorithm_description.h"
 #include "protocols/bmr/bmr_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
@@ -32,7 +33,9 @@
 #include "statistics/run_time_statistics.h"
 #include "utility/config.h"
 
-static void check_correctness(encrypto::motion::ShareWrapper output) {
+// checks the first number_of_checked_values SIMD values of output
+static void check_correctness(encrypto::motion::ShareWrapper output,
+                              std::size_t number_of_checked_values) {
   // #!/usr/bin/env python3
   // import pyaes
   // ct = pyaes.AES(bytes(16)).encrypt(bytes(16))
@@ -42,7 +45,7 @@ static void check_correctness(encrypto::motion::ShareWrapper output) {
       "011100101011110100101001011101100110";
   const auto values{output.As<std::vector<encrypto::motion::BitVector<>>>()};
   for (std::size_t wire_i = 0; wire_i < 128; ++wire_i) {
-    for (std::size_t simd_j = 0; simd_j < output->GetNumberOfSimdValues(); ++simd_j) {
+    for (std::size_t simd_j = 0; simd_j < number_of_checked_values; ++simd_j) {
       auto computed_bit = values[wire_i].Get(simd_j);
       if ((kCorrectionBits[wire_i] == '1') != computed_bit) {
         std::cerr << fmt::format("Computation not correct at output bit {} and SIMD value {}\n",
@@ -56,18 +59,37 @@ static void check_correctness(encrypto::motion::ShareWrapper output) {
 encrypto::motion::RunTimeStatistics EvaluateProtocol(encrypto::motion::PartyPointer& party,
                                                      std::size_t number_of_simd,
                                                      encrypto::motion::MpcProtocol protocol,
-                                                     bool check) {
-  // TODO tests
-  std::vector<encrypto::motion::BitVector<>> tmp(256,
-                                                 encrypto::motion::BitVector<>(number_of_simd));
-  encrypto::motion::ShareWrapper input{
-      protocol == encrypto::motion::MpcProtocol::kBooleanGmw
-          ? party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(tmp, 0)
-          : party->In<encrypto::motion::MpcProtocol::kBmr>(tmp, 0)};
-  const auto kPathToAlgorithm{std::string(encrypto::motion::kRootDir) +
-                              "/circuits/advanced/aes_128.bristol"};
-  const auto aes_algorithm{encrypto::motion::AlgorithmDescription::FromBristol(kPathToAlgorithm)};
-  const auto result{input.Evaluate(aes_algorithm)};
+                                                     bool check, bool ctr) {
+  encrypto::motion::ShareWrapper result;
+  if (ctr) {
+    // the zero key expanded once and the counter blocks 0, ..., number_of_simd - 1
+    const std::vector<std::uint8_t> zero_block(16, 0);
+    const auto key{encrypto::motion::algorithm::Aes128CounterBlocks(zero_block, 0, 1)};
+    const auto counter_blocks{
+        encrypto::motion::algorithm::Aes128CounterBlocks(zero_block, 0, number_of_simd)};
+    encrypto::motion::ShareWrapper key_share{
+        protocol == encrypto::motion::MpcProtocol::kBooleanGmw
+            ? party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(key, 0)
+            : party->In<encrypto::motion::MpcProtocol::kBmr>(key, 0)};
+    encrypto::motion::ShareWrapper counters{
+        protocol == encrypto::motion::MpcProtocol::kBooleanGmw
+            ? party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(counter_blocks, 0)
+            : party->In<encrypto::motion::MpcProtocol::kBmr>(counter_blocks, 0)};
+    result = encrypto::motion::algorithm::Aes128CtrKeystream(key_share).Encrypt(counters);
+  } else {
+    // TODO tests
+    std::vector<encrypto::motion::BitVector<>> tmp(256,
+                                                   encrypto::motion::BitVector<>(number_of_simd));
+    encrypto::motion::ShareWrapper input{
+        protocol == encrypto::motion::MpcProtocol::kBooleanGmw
+            ? party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(tmp, 0)
+            : party->In<encrypto::motion::MpcProtocol::kBmr>(tmp, 0)};
+    const auto kPathToAlgorithm{std::string(encrypto::motion::kRootDir) +
+                                "/circuits/advanced/aes_128.bristol"};
+    const auto aes_algorithm{
+        encrypto::motion::AlgorithmDescription::FromBristol(kPathToAlgorithm)};
+    result = input.Evaluate(aes_algorithm);
+  }
   encrypto::motion::ShareWrapper output;
   if (check) {
     output = result.Out();
@@ -75,7 +97,8 @@ encrypto::motion::RunTimeStatistics EvaluateProtocol(encrypto::motion::PartyPoin
   party->Run();
   party->Finish();
   if (check) {
-    check_correctness(output);
+    // only the first counter block is the zero block
+    check_correctness(output, ctr ? 1 : number_of_simd);
   }
   const auto& statistics = party->GetBackend()->GetRunTimeStatistics();
   return statistics.front();
@@ -27,7 +27,9 @@
 #include "base/party.h"
 #include "statistics/run_time_statistics.h"
 
+// encrypts number_of_simd blocks with aes_128.bristol or, if ctr is set, number_of_simd counter
+// blocks under a key that is expanded only once
 encrypto::motion::RunTimeStatistics EvaluateProtocol(encrypto::motion::PartyPointer& party,
                                                      std::size_t number_of_simd,
                                                      encrypto::motion::MpcProtocol protocol,
-                                                     bool check);
+                                                     bool check, bool ctr);
@@ -0,0 +1,280 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Sweeps protocol x operation x bit size x SIMD x number of parties x network profile. All parties
+// of a combination run in this process, connected by dummy transports that are optionally delayed
+// according to a simulated network profile, and the results of all combinations are written as a
+// single JSON document.
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <optional>
+
+#include <fmt/format.h>
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include "base/party.h"
+#include "common/benchmark_primitive_operations.h"
+#include "communication/communication_layer.h"
+#include "communication/dummy_transport.h"
+#include "communication/simulated_transport.h"
+#include "statistics/analysis.h"
+#include "utility/typedefs.h"
+
+namespace program_options = boost::program_options;
+
+using encrypto::motion::MpcProtocol;
+using encrypto::motion::PrimitiveOperationType;
+
+namespace {
+
+// profile of the dummy transports without simulated delays
+constexpr std::string_view kNoNetworkProfile{"none"};
+
+constexpr std::array kProtocols{MpcProtocol::kBooleanGmw, MpcProtocol::kBmr,
+                                MpcProtocol::kArithmeticGmw};
+
+constexpr std::array kOperationTypes{
+    PrimitiveOperationType::kIn,  PrimitiveOperationType::kOut, PrimitiveOperationType::kXor,
+    PrimitiveOperationType::kAnd, PrimitiveOperationType::kMux, PrimitiveOperationType::kInv,
+    PrimitiveOperationType::kOr,  PrimitiveOperationType::kAdd, PrimitiveOperationType::kMul,
+    PrimitiveOperationType::kSqr, PrimitiveOperationType::kA2B, PrimitiveOperationType::kA2Y,
+    PrimitiveOperationType::kB2A, PrimitiveOperationType::kB2Y, PrimitiveOperationType::kY2A,
+    PrimitiveOperationType::kY2B};
+
+struct Combination {
+  MpcProtocol protocol;
+  PrimitiveOperationType operation_type;
+  std::size_t bit_size;
+  std::size_t number_of_simd;
+  std::size_t number_of_parties;
+  std::string network_profile;
+};
+
+template <typename T, std::size_t N>
+T ParseByName(const std::string& name, const std::array<T, N>& values, std::string_view kind) {
+  for (const auto value : values) {
+    if (encrypto::motion::to_string(value) == name) {
+      return value;
+    }
+  }
+  throw std::invalid_argument(fmt::format("Unknown {} {}", kind, name));
+}
+
+bool IsArithmeticBitSize(std::size_t bit_size) {
+  return bit_size == 8 || bit_size == 16 || bit_size == 32 || bit_size == 64;
+}
+
+// whether EvaluateProtocol supports the operation on shares of the protocol and bit size
+bool IsSupported(MpcProtocol protocol, PrimitiveOperationType operation_type,
+                 std::size_t bit_size) {
+  using T = PrimitiveOperationType;
+  switch (operation_type) {
+    case T::kIn:
+    case T::kOut:
+      return protocol != MpcProtocol::kArithmeticGmw || IsArithmeticBitSize(bit_size);
+    case T::kXor:
+    case T::kAnd:
+    case T::kMux:
+    case T::kInv:
+    case T::kOr:
+      return protocol == MpcProtocol::kBooleanGmw || protocol == MpcProtocol::kBmr;
+    case T::kAdd:
+    case T::kMul:
+    case T::kSqr:
+    case T::kA2B:
+    case T::kA2Y:
+      return protocol == MpcProtocol::kArithmeticGmw && IsArithmeticBitSize(bit_size);
+    case T::kB2A:
+      return protocol == MpcProtocol::kBooleanGmw && IsArithmeticBitSize(bit_size);
+    case T::kB2Y:
+      return protocol == MpcProtocol::kBooleanGmw;
+    case T::kY2A:
+      return protocol == MpcProtocol::kBmr && IsArithmeticBitSize(bit_size);
+    case T::kY2B:
+      return protocol == MpcProtocol::kBmr;
+    default:
+      return false;
+  }
+}
+
+std::vector<encrypto::motion::PartyPointer> MakeParties(std::size_t number_of_parties,
+                                                        const std::string& network_profile,
+                                                        bool logging, bool online_after_setup) {
+  namespace communication = encrypto::motion::communication;
+  std::vector<std::vector<std::unique_ptr<communication::Transport>>> transports(
+      number_of_parties);
+  for (auto& party_transports : transports) party_transports.resize(number_of_parties);
+  for (std::size_t party_i = 0; party_i + 1 < number_of_parties; ++party_i) {
+    for (std::size_t party_j = party_i + 1; party_j < number_of_parties; ++party_j) {
+      auto [transport_ij, transport_ji] = communication::DummyTransport::MakeTransportPair();
+      transports[party_i][party_j] = std::move(transport_ij);
+      transports[party_j][party_i] = std::move(transport_ji);
+    }
+  }
+  std::vector<encrypto::motion::PartyPointer> parties;
+  parties.reserve(number_of_parties);
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    if (network_profile != kNoNetworkProfile) {
+      transports[party_id] = communication::MakeSimulatedTransports(
+          std::move(transports[party_id]),
+          communication::NetworkProfile::FromString(network_profile));
+    }
+    auto communication_layer{std::make_unique<communication::CommunicationLayer>(
+        party_id, std::move(transports[party_id]))};
+    auto& party{parties.emplace_back(
+        std::make_unique<encrypto::motion::Party>(std::move(communication_layer)))};
+    auto configuration{party->GetConfiguration()};
+    configuration->SetLoggingEnabled(logging);
+    configuration->SetOnlineAfterSetup(online_after_setup);
+  }
+  return parties;
+}
+
+// Evaluates the combination in all parties concurrently and accumulates the run times of all
+// parties and the traffic of all their transports.
+boost::json::object Run(const Combination& combination, std::size_t number_of_repetitions,
+                        bool logging, bool online_after_setup) {
+  encrypto::motion::AccumulatedRunTimeStatistics run_time_statistics;
+  encrypto::motion::AccumulatedCommunicationStatistics communication_statistics;
+  for (std::size_t i = 0; i < number_of_repetitions; ++i) {
+    auto parties{MakeParties(combination.number_of_parties, combination.network_profile, logging,
+                             online_after_setup)};
+    std::vector<std::future<encrypto::motion::RunTimeStatistics>> futures;
+    for (auto& party : parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party, &combination] {
+        return EvaluateProtocol(party, combination.number_of_simd, combination.bit_size,
+                                combination.protocol, combination.operation_type);
+      }));
+    }
+    for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+      run_time_statistics.Add(futures[party_id].get());
+    }
+    for (auto& party : parties) {
+      communication_statistics.Add(
+          party->GetBackend()->GetCommunicationLayer().GetTransportStatistics());
+    }
+  }
+  return {{"protocol", encrypto::motion::to_string(combination.protocol)},
+          {"operation", encrypto::motion::to_string(combination.operation_type)},
+          {"bit_size", combination.bit_size},
+          {"simd", combination.number_of_simd},
+          {"parties", combination.number_of_parties},
+          {"network_profile", combination.network_profile},
+          {"run_time", run_time_statistics.ToJson()},
+          {"communication", communication_statistics.ToJson()}};
+}
+
+}  // namespace
+
+std::optional<program_options::variables_map> ParseProgramOptions(int ac, char* av[]) {
+  const std::vector<std::string> kDefaultProtocols{"BooleanGMW", "BMR", "ArithmeticGMW"};
+  const std::vector<std::string> kDefaultOperations{"IN",  "OUT", "XOR", "AND",
+                                                    "ADD", "MUL", "A2B", "B2A"};
+  const std::vector<std::string> kDefaultNetworkProfiles{std::string(kNoNetworkProfile)};
+  bool help;
+  program_options::options_description description("Allowed options");
+  // clang-format off
+  description.add_options()
+      ("help,h", program_options::bool_switch(&help)->default_value(false), "produce help message")
+      ("enable-logging", "enable logging to file")
+      ("protocols", program_options::value<std::vector<std::string>>()->multitoken()->default_value(kDefaultProtocols, "BooleanGMW BMR ArithmeticGMW"), "protocols: BooleanGMW, BMR, ArithmeticGMW")
+      ("operations", program_options::value<std::vector<std::string>>()->multitoken()->default_value(kDefaultOperations, "IN OUT XOR AND ADD MUL A2B B2A"), "operations, e.g., IN OUT XOR AND MUX INV OR ADD MUL SQR A2B A2Y B2A B2Y Y2A Y2B, combinations that a protocol does not support are skipped")
+      ("bit-sizes", program_options::value<std::vector<std::size_t>>()->multitoken()->default_value({32}, "32"), "bit sizes, i.e., the number of wires of Boolean shares")
+      ("simd", program_options::value<std::vector<std::size_t>>()->multitoken()->default_value({1000}, "1000"), "numbers of SIMD values")
+      ("parties", program_options::value<std::vector<std::size_t>>()->multitoken()->default_value({2, 3}, "2 3"), "numbers of parties")
+      ("network-profiles", program_options::value<std::vector<std::string>>()->multitoken()->default_value(kDefaultNetworkProfiles, "none"), "simulated network profiles: none, lan, wan, or <latency ms>,<bandwidth Mbit/s>[,<jitter ms>]")
+      ("repetitions", program_options::value<std::size_t>()->default_value(1), "number of repetitions of each combination")
+      ("online-after-setup", program_options::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
+      ("output,o", program_options::value<std::string>(), "file to write the JSON results to instead of stdout");
+  // clang-format on
+
+  program_options::variables_map user_options;
+  program_options::store(program_options::parse_command_line(ac, av, description), user_options);
+  program_options::notify(user_options);
+  if (help) {
+    std::cout << description << "\n";
+    return std::nullopt;
+  }
+  return user_options;
+}
+
+int main(int ac, char* av[]) {
+  const auto user_options{ParseProgramOptions(ac, av)};
+  // if help flag is set - print allowed command line arguments and exit
+  if (!user_options) return EXIT_SUCCESS;
+  const auto& options{*user_options};
+
+  std::vector<Combination> combinations;
+  for (const auto& network_profile : options["network-profiles"].as<std::vector<std::string>>()) {
+    if (network_profile != kNoNetworkProfile) {
+      // fail before running any combination
+      encrypto::motion::communication::NetworkProfile::FromString(network_profile);
+    }
+    for (const auto number_of_parties : options["parties"].as<std::vector<std::size_t>>()) {
+      if (number_of_parties < 2) {
+        throw std::invalid_argument("At least two parties are required");
+      }
+      for (const auto& protocol_name : options["protocols"].as<std::vector<std::string>>()) {
+        const auto protocol{ParseByName(protocol_name, kProtocols, "protocol")};
+        for (const auto& operation_name : options["operations"].as<std::vector<std::string>>()) {
+          const auto operation_type{ParseByName(operation_name, kOperationTypes, "operation")};
+          for (const auto bit_size : options["bit-sizes"].as<std::vector<std::size_t>>()) {
+            if (!IsSupported(protocol, operation_type, bit_size)) continue;
+            for (const auto number_of_simd : options["simd"].as<std::vector<std::size_t>>()) {
+              combinations.push_back({protocol, operation_type, bit_size, number_of_simd,
+                                      number_of_parties, network_profile});
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const auto number_of_repetitions{options["repetitions"].as<std::size_t>()};
+  const bool logging{options.count("enable-logging") > 0};
+  const auto online_after_setup{options["online-after-setup"].as<bool>()};
+  boost::json::array results;
+  for (std::size_t i = 0; i < combinations.size(); ++i) {
+    const auto& combination{combinations[i]};
+    std::cerr << fmt::format("[{}/{}] {} {} bit size {} SIMD {} parties {} network {}\n", i + 1,
+                             combinations.size(), encrypto::motion::to_string(combination.protocol),
+                             encrypto::motion::to_string(combination.operation_type),
+                             combination.bit_size, combination.number_of_simd,
+                             combination.number_of_parties, combination.network_profile);
+    results.emplace_back(Run(combination, number_of_repetitions, logging, online_after_setup));
+  }
+  const boost::json::object document{{"repetitions", number_of_repetitions},
+                                     {"online_after_setup", online_after_setup},
+                                     {"results", std::move(results)}};
+
+  if (options.count("output")) {
+    std::ofstream output(options["output"].as<std::string>());
+    output << boost::json::serialize(document) << '\n';
+  } else {
+    std::cout << boost::json::serialize(document) << '\n';
+  }
+  return EXIT_SUCCESS;
+}
@@ -35,6 +35,7 @@
 #include "base/party.h"
 #include "common/benchmark_primitive_operations.h"
 #include "communication/communication_layer.h"
+#include "communication/simulated_transport.h"
 #include "communication/tcp_transport.h"
 #include "statistics/analysis.h"
 #include "utility/typedefs.h"
@@ -45,7 +46,8 @@ bool CheckPartyArgumentSyntax(const std::string& party_argument);
 
 std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char* av[]);
 
-encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options);
+encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options,
+                                          const std::string& network_profile);
 
 constexpr std::size_t kIllegalProtocol{100}, kIllegalOperationType{100};
 
@@ -122,25 +124,34 @@ int main(int ac, char* av[]) {
 
   combinations = GenerateAllCombinations();
 
-  for (const auto combination : combinations) {
-    encrypto::motion::AccumulatedRunTimeStatistics accumulated_statistics;
-    encrypto::motion::AccumulatedCommunicationStatistics accumulated_communication_statistics;
-    for (std::size_t i = 0; i < number_of_repititions; ++i) {
-      encrypto::motion::PartyPointer party{CreateParty(user_options)};
-      // establish communication channels with other parties
-      auto statistics = EvaluateProtocol(party, combination.number_of_simd, combination.bit_size,
-                                         combination.protocol, combination.operation_type);
-      accumulated_statistics.Add(statistics);
-      auto communcation_statistics =
-          party->GetBackend()->GetCommunicationLayer().GetTransportStatistics();
-      accumulated_communication_statistics.Add(communcation_statistics);
+  // an empty profile means the real network
+  std::vector<std::string> network_profiles{""};
+  if (user_options.count("network-profiles")) {
+    network_profiles = user_options["network-profiles"].as<std::vector<std::string>>();
+  }
+
+  for (const auto& network_profile : network_profiles) {
+    for (const auto combination : combinations) {
+      encrypto::motion::AccumulatedRunTimeStatistics accumulated_statistics;
+      encrypto::motion::AccumulatedCommunicationStatistics accumulated_communication_statistics;
+      for (std::size_t i = 0; i < number_of_repititions; ++i) {
+        encrypto::motion::PartyPointer party{CreateParty(user_options, network_profile)};
+        // establish communication channels with other parties
+        auto statistics = EvaluateProtocol(party, combination.number_of_simd, combination.bit_size,
+                                           combination.protocol, combination.operation_type);
+        accumulated_statistics.Add(statistics);
+        auto communcation_statistics =
+            party->GetBackend()->GetCommunicationLayer().GetTransportStatistics();
+        accumulated_communication_statistics.Add(communcation_statistics);
+      }
+      std::cout << encrypto::motion::PrintStatistics(
+          fmt::format("Protocol {} operation {} bit size {} SIMD {}{}",
+                      encrypto::motion::to_string(combination.protocol),
+                      encrypto::motion::to_string(combination.operation_type), combination.bit_size,
+                      combination.number_of_simd,
+                      network_profile.empty() ? "" : " network " + network_profile),
+          accumulated_statistics, accumulated_communication_statistics);
     }
-    std::cout << encrypto::motion::PrintStatistics(
-        fmt::format("Protocol {} operation {} bit size {} SIMD {}",
-                    encrypto::motion::to_string(combination.protocol),
-                    encrypto::motion::to_string(combination.operation_type), combination.bit_size,
-                    combination.number_of_simd),
-        accumulated_statistics, accumulated_communication_statistics);
   }
   return EXIT_SUCCESS;
 }
@@ -179,7 +190,8 @@ std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char
       ("my-id", program_options::value<std::size_t>(), "my party id")
       ("parties", program_options::value<std::vector<std::string>>()->multitoken(), "info (id,IP,port) for each party e.g., --parties 0,127.0.0.1,23000 1,127.0.0.1,23001")
       ("online-after-setup", program_options::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
-      ("repetitions", program_options::value<std::size_t>()->default_value(1), "number of repetitions");
+      ("repetitions", program_options::value<std::size_t>()->default_value(1), "number of repetitions")
+      ("network-profiles", program_options::value<std::vector<std::string>>()->multitoken(), "simulate each network profile in turn: lan, wan, or <latency ms>,<bandwidth Mbit/s>[,<jitter ms>], e.g., --network-profiles lan wan");
   // clang-format on
 
   program_options::variables_map user_options;
@@ -231,7 +243,8 @@ std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char
   return std::make_pair(user_options, help);
 }
 
-encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options) {
+encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options,
+                                          const std::string& network_profile) {
   const auto parties_string{user_options["parties"].as<const std::vector<std::string>>()};
   const auto number_of_parties{parties_string.size()};
   const auto my_id{user_options["my-id"].as<std::size_t>()};
@@ -254,8 +267,15 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
     parties_configuration.at(party_id) = std::make_pair(host, port);
   }
   encrypto::motion::communication::TcpSetupHelper helper(my_id, parties_configuration);
+  auto transports{helper.SetupConnections()};
+  // an empty profile means the real network
+  if (!network_profile.empty()) {
+    transports = encrypto::motion::communication::MakeSimulatedTransports(
+        std::move(transports),
+        encrypto::motion::communication::NetworkProfile::FromString(network_profile));
+  }
   auto communication_layer = std::make_unique<encrypto::motion::communication::CommunicationLayer>(
-      my_id, helper.SetupConnections());
+      my_id, std::move(transports));
   auto party = std::make_unique<encrypto::motion::Party>(std::move(communication_layer));
   auto configuration = party->GetConfiguration();
   // disable logging if the corresponding flag was set
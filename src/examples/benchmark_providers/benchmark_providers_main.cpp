@@ -22,11 +22,16 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
 #include <random>
 #include <regex>
+#include <tuple>
 
 #include <fmt/format.h>
 #include <boost/lexical_cast.hpp>
@@ -35,6 +40,8 @@
 #include "base/party.h"
 #include "common/benchmark_providers.h"
 #include "communication/communication_layer.h"
+#include "communication/dummy_transport.h"
+#include "communication/simulated_transport.h"
 #include "communication/tcp_transport.h"
 #include "statistics/analysis.h"
 #include "utility/typedefs.h"
@@ -45,71 +52,146 @@ bool CheckPartyArgumentSyntax(const std::string& party_arguments);
 
 std::tuple<program_options::variables_map, bool, bool> ParseProgramOptions(int ac, char* av[]);
 
-encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options);
+encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options,
+                                          const std::string& network_profile);
+
+// Creates both parties in this process, connected by in-memory transports, such that the
+// providers can be benchmarked standalone without setting up a network between machines.
+std::vector<encrypto::motion::PartyPointer> CreateLocalParties(
+    const program_options::variables_map& user_options, const std::string& network_profile);
 
 int main(int ac, char* av[]) {
   auto [user_options, help_flag, ots_flag] = ParseProgramOptions(ac, av);
   // if help flag is set - print allowed command line arguments and exit
-  if (help_flag) EXIT_SUCCESS;
+  if (help_flag) return EXIT_SUCCESS;
   const auto number_of_repetitions{user_options["repetitions"].as<std::size_t>()};
-  const auto batch_size{user_options["batch-size"].as<std::size_t>()};
+  const auto batch_sizes{user_options["batch-size"].as<std::vector<std::size_t>>()};
+  const bool standalone{user_options["standalone"].as<bool>()};
 
   struct Combination {
-    Combination(Provider provider, std::size_t bit_size, std::size_t batch_size)
-        : provider_(provider), bit_size_(bit_size), batch_size_(batch_size) {}
+    Combination(Provider provider, std::size_t bit_size)
+        : provider_(provider), bit_size_(bit_size) {}
     Provider provider_;
     std::size_t bit_size_;
-    std::size_t batch_size_;
   };
 
   // clang-format off
   std::vector<Combination> combinations = {
-    {kAmt, 8, batch_size},
-    {kAmt, 16, batch_size},
-    {kAmt, 32, batch_size},
-    {kAmt, 64, batch_size},
-    {kBmt, 1, batch_size},
-    {kSb, 8, batch_size},
-    {kSb, 16, batch_size},
-    {kSb, 32, batch_size},
-    {kSb, 64, batch_size},
-    {kSp, 8, batch_size},
-    {kSp, 16, batch_size},
-    {kSp, 32, batch_size},
-    {kSp, 64, batch_size}
+    {kAmt, 8},
+    {kAmt, 16},
+    {kAmt, 32},
+    {kAmt, 64},
+    {kBmt, 1},
+    {kBmtKk13, 1},
+    {kSb, 8},
+    {kSb, 16},
+    {kSb, 32},
+    {kSb, 64},
+    {kSp, 8},
+    {kSp, 16},
+    {kSp, 32},
+    {kSp, 64}
   };
 
   std::vector<Combination> combinations_ots = {
-    {kGOt, 1, batch_size},
-    {kGOt, 128, batch_size},
-    {kXcOt, 1, batch_size},
-    {kXcOt, 128, batch_size},
-    {kAcOt, 8, batch_size},
-    {kAcOt, 16, batch_size},
-    {kAcOt, 32, batch_size},
-    {kAcOt, 64, batch_size},
-    {kAcOt, 128, batch_size},
-    {kROt, 128, batch_size}
+    {kGOt, 1},
+    {kGOt, 128},
+    {kXcOt, 1},
+    {kXcOt, 128},
+    {kAcOt, 8},
+    {kAcOt, 16},
+    {kAcOt, 32},
+    {kAcOt, 64},
+    {kAcOt, 128},
+    {kROt, 128},
+    {kGOtKk13, 4},
+    {kGOtKk13, 16}
   };
   // clang-format on
 
   auto chosen_combinations = ots_flag ? combinations_ots : combinations;
-  for (const auto combination : chosen_combinations) {
-    encrypto::motion::AccumulatedRunTimeStatistics accumulated_statistics;
-    encrypto::motion::AccumulatedCommunicationStatistics accumulated_communication_statistics;
-    for (std::size_t i = 0; i < number_of_repetitions; ++i) {
-      encrypto::motion::PartyPointer party{CreateParty(user_options)};
-      auto statistics = BenchmarkProvider(party, combination.batch_size_, combination.provider_,
-                                          combination.bit_size_);
-      accumulated_statistics.Add(statistics);
-      auto communication_statistics =
-          party->GetBackend()->GetCommunicationLayer().GetTransportStatistics();
-      accumulated_communication_statistics.Add(communication_statistics);
+
+  // an empty profile means the real network
+  std::vector<std::string> network_profiles{""};
+  if (user_options.count("network-profiles")) {
+    network_profiles = user_options["network-profiles"].as<std::vector<std::string>>();
+  }
+  // 0 means the default number of threads of the configuration
+  std::vector<std::size_t> thread_counts{0};
+  if (user_options.count("threads")) {
+    thread_counts = user_options["threads"].as<std::vector<std::size_t>>();
+  }
+  for (const auto& network_profile : network_profiles) {
+    // the rate per thread of the first thread count of the sweep for each combination and batch
+    // size, relative to which the efficiency of the other thread counts is reported
+    std::map<std::tuple<Provider, std::size_t, std::size_t>, double> reference_rates;
+    for (const auto number_of_threads : thread_counts) {
+      for (const auto combination : chosen_combinations) {
+        for (const auto batch_size : batch_sizes) {
+          encrypto::motion::AccumulatedRunTimeStatistics accumulated_statistics;
+          encrypto::motion::AccumulatedCommunicationStatistics
+              accumulated_communication_statistics;
+          std::size_t used_threads{number_of_threads};
+          // the time until the batch is available to all parties, summed over the repetitions
+          double total_seconds{0.0};
+          for (std::size_t i = 0; i < number_of_repetitions; ++i) {
+            std::vector<encrypto::motion::PartyPointer> parties;
+            if (standalone) {
+              parties = CreateLocalParties(user_options, network_profile);
+            } else {
+              parties.emplace_back(CreateParty(user_options, network_profile));
+            }
+            for (auto& party : parties) {
+              auto configuration{party->GetConfiguration()};
+              if (number_of_threads > 0) configuration->SetNumOfThreads(number_of_threads);
+              used_threads = configuration->GetNumOfThreads();
+            }
+            std::vector<std::future<encrypto::motion::RunTimeStatistics>> futures;
+            for (auto& party : parties) {
+              futures.emplace_back(std::async(std::launch::async, [&party, &combination,
+                                                                   batch_size] {
+                return BenchmarkProvider(party, batch_size, combination.provider_,
+                                         combination.bit_size_);
+              }));
+            }
+            double seconds{0.0};
+            for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+              auto& communication_layer{parties[party_id]->GetBackend()->GetCommunicationLayer()};
+              auto statistics{futures[party_id].get()};
+              const auto& [start, end] =
+                  statistics.Get(encrypto::motion::RunTimeStatistics::StatisticsId::kEvaluate);
+              seconds = std::max(seconds, std::chrono::duration<double>(end - start).count());
+              accumulated_statistics.Add(statistics);
+              accumulated_communication_statistics.Add(
+                  communication_layer.GetTransportStatistics());
+            }
+            total_seconds += seconds;
+          }
+          const auto name{fmt::format(
+              "Provider {} bit size {} batch size {}{}{}", to_string(combination.provider_),
+              combination.bit_size_, batch_size,
+              network_profile.empty() ? "" : " network " + network_profile,
+              number_of_threads == 0 ? "" : fmt::format(" threads {}", number_of_threads))};
+          std::cout << encrypto::motion::PrintStatistics(name, accumulated_statistics,
+                                                         accumulated_communication_statistics);
+
+          const double rate{static_cast<double>(batch_size * number_of_repetitions) /
+                            total_seconds};
+          const double rate_per_thread{rate / static_cast<double>(std::max<std::size_t>(
+                                                  1, used_threads))};
+          const double reference_rate{
+              reference_rates
+                  .try_emplace({combination.provider_, combination.bit_size_, batch_size},
+                               rate_per_thread)
+                  .first->second};
+          std::cout << fmt::format(
+              "Throughput {}: {:.0f} /s with {} threads, {:.0f} /s per thread, {:.1f}% "
+              "efficiency per thread\n",
+              name, rate, used_threads, rate_per_thread,
+              100.0 * rate_per_thread / reference_rate);
+        }
+      }
     }
-    std::cout << encrypto::motion::PrintStatistics(
-        fmt::format("Provider {} bit size {} batch size {}", to_string(combination.provider_),
-                    combination.bit_size_, combination.batch_size_),
-        accumulated_statistics, accumulated_communication_statistics);
   }
   return EXIT_SUCCESS;
 }
@@ -137,7 +219,7 @@ std::tuple<program_options::variables_map, bool, bool> ParseProgramOptions(int a
   using namespace std::string_view_literals;
   constexpr std::string_view kConfigFileMessage =
       "configuration file, other arguments will overwrite the parameters read from the configuration file"sv;
-  bool print, help, ots;
+  bool print, help, ots, standalone;
   boost::program_options::options_description description("Allowed options");
   // clang-format off
   description.add_options()
@@ -146,11 +228,14 @@ std::tuple<program_options::variables_map, bool, bool> ParseProgramOptions(int a
       ("print-configuration,p", program_options::bool_switch(&print)->default_value(false), "print configuration")
       ("configuration-file,f", program_options::value<std::string>(), kConfigFileMessage.data())
       ("my-id", program_options::value<std::size_t>(), "my party id")
-      ("batch-size", program_options::value<std::size_t>()->default_value(1000000), "number of elements in the batch")
+      ("batch-size", program_options::value<std::vector<std::size_t>>()->multitoken()->default_value({1000000}, "1000000"), "sweep over the number of elements in the batch, e.g., --batch-size 10000 1000000")
       ("parties", program_options::value<std::vector<std::string>>()->multitoken(), "info (id,IP,port) for each party e.g., --parties 0,127.0.0.1,23000 1,127.0.0.1,23001")
       ("online-after-setup", program_options::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
       ("repetitions", program_options::value<std::size_t>()->default_value(1), "number of repetitions")
-      ("ots,o", program_options::bool_switch(&ots)->default_value(false),"test OTs, otherwise all other providers");
+      ("network-profiles", program_options::value<std::vector<std::string>>()->multitoken(), "simulate each network profile in turn: lan, wan, or <latency ms>,<bandwidth Mbit/s>[,<jitter ms>], e.g., --network-profiles lan wan")
+      ("threads", program_options::value<std::vector<std::size_t>>()->multitoken(), "sweep over the number of threads, e.g., --threads 1 2 4 8")
+      ("ots,o", program_options::bool_switch(&ots)->default_value(false),"test OTs, otherwise all other providers")
+      ("standalone,s", program_options::bool_switch(&standalone)->default_value(false), "run both parties in this process over in-memory transports, --my-id and --parties are not needed");
   // clang-format on
 
   program_options::variables_map user_options;
@@ -172,6 +257,9 @@ std::tuple<program_options::variables_map, bool, bool> ParseProgramOptions(int a
     program_options::notify(user_options);
   }
 
+  // both parties are created locally in standalone mode
+  if (standalone) return std::make_tuple(user_options, help, ots);
+
   // print parsed parameters
   if (user_options.count("my-id")) {
     if (print) std::cout << "My id " << user_options["my-id"].as<std::size_t>() << std::endl;
@@ -202,7 +290,8 @@ std::tuple<program_options::variables_map, bool, bool> ParseProgramOptions(int a
   return std::make_tuple(user_options, help, ots);
 }
 
-encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options) {
+encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options,
+                                          const std::string& network_profile) {
   const auto parties_string{user_options["parties"].as<const std::vector<std::string>>()};
   const auto number_of_parties{parties_string.size()};
   const auto my_id{user_options["my-id"].as<std::size_t>()};
@@ -225,8 +314,15 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
     parties_configuration.at(party_id) = std::make_pair(host, port);
   }
   encrypto::motion::communication::TcpSetupHelper helper(my_id, parties_configuration);
+  auto transports{helper.SetupConnections()};
+  // an empty profile means the real network
+  if (!network_profile.empty()) {
+    transports = encrypto::motion::communication::MakeSimulatedTransports(
+        std::move(transports),
+        encrypto::motion::communication::NetworkProfile::FromString(network_profile));
+  }
   auto communication_layer = std::make_unique<encrypto::motion::communication::CommunicationLayer>(
-      my_id, helper.SetupConnections());
+      my_id, std::move(transports));
   auto party = std::make_unique<encrypto::motion::Party>(std::move(communication_layer));
   auto configuration = party->GetConfiguration();
   // disable logging if the corresponding flag was set
@@ -235,3 +331,34 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
   configuration->SetOnlineAfterSetup(user_options["online-after-setup"].as<bool>());
   return party;
 }
+
+std::vector<encrypto::motion::PartyPointer> CreateLocalParties(
+    const program_options::variables_map& user_options, const std::string& network_profile) {
+  namespace communication = encrypto::motion::communication;
+  constexpr std::size_t kNumberOfParties{2};
+  std::vector<std::vector<std::unique_ptr<communication::Transport>>> transports(
+      kNumberOfParties);
+  for (auto& party_transports : transports) party_transports.resize(kNumberOfParties);
+  auto [transport_01, transport_10] = communication::DummyTransport::MakeTransportPair();
+  transports[0][1] = std::move(transport_01);
+  transports[1][0] = std::move(transport_10);
+
+  std::vector<encrypto::motion::PartyPointer> parties;
+  parties.reserve(kNumberOfParties);
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    // an empty profile means no simulated network
+    if (!network_profile.empty()) {
+      transports[party_id] = communication::MakeSimulatedTransports(
+          std::move(transports[party_id]),
+          communication::NetworkProfile::FromString(network_profile));
+    }
+    auto communication_layer{std::make_unique<communication::CommunicationLayer>(
+        party_id, std::move(transports[party_id]))};
+    auto& party{parties.emplace_back(
+        std::make_unique<encrypto::motion::Party>(std::move(communication_layer)))};
+    auto configuration{party->GetConfiguration()};
+    configuration->SetLoggingEnabled(!user_options.count("disable-logging"));
+    configuration->SetOnlineAfterSetup(user_options["online-after-setup"].as<bool>());
+  }
+  return parties;
+}
@@ -28,6 +28,8 @@
 #include "multiplication_triple/mt_provider.h"
 #include "multiplication_triple/sb_provider.h"
 #include "multiplication_triple/sp_provider.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_flavors.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
 #include "oblivious_transfer/ot_flavors.h"
 #include "statistics/analysis.h"
 #include "statistics/run_time_statistics.h"
@@ -83,6 +85,18 @@ encrypto::motion::RunTimeStatistics BenchmarkProvider(encrypto::motion::PartyPoi
       mt_provider.Setup();
       break;
     }
+    case Provider::kBmtKk13: {
+      dynamic_cast<encrypto::motion::MtProviderFromOts&>(mt_provider)
+          .SetKk13BinaryMts(backend->GetKk13OtProviderManager().GetProviders());
+      mt_provider.RequestBinaryMts(batch_size);
+      mt_provider.PreSetup();
+      backend->GetOtProviderManager().PreSetup();
+      backend->GetKk13OtProviderManager().PreSetup();
+      backend->Synchronize();
+      backend->OtExtensionSetup();
+      mt_provider.Setup();
+      break;
+    }
     case Provider::kAcOt: {
       switch (bit_size) {
         case 8:
@@ -281,6 +295,29 @@ encrypto::motion::RunTimeStatistics BenchmarkProvider(encrypto::motion::PartyPoi
       }
       break;
     }
+    case Provider::kGOtKk13: {
+      if (bit_size < 2) {
+        throw std::invalid_argument("KK13 OTs in benchmarks need at least 2 messages");
+      }
+      if (my_id == 0) {
+        auto ot{backend->GetKk13OtProvider(1).RegisterReceiveGOtBit(batch_size, bit_size)};
+        ot->SetChoices(std::vector<std::uint8_t>(batch_size, 0));
+        backend->GetKk13OtProviderManager().PreSetup();
+        backend->Synchronize();
+        backend->OtExtensionSetup();
+        ot->SendCorrections();
+        ot->ComputeOutputs();
+        ot->GetOutputs();
+      } else {
+        auto ot{backend->GetKk13OtProvider(0).RegisterSendGOtBit(batch_size, bit_size)};
+        backend->GetKk13OtProviderManager().PreSetup();
+        backend->Synchronize();
+        backend->OtExtensionSetup();
+        ot->SetInputs(encrypto::motion::BitVector<>(bit_size * batch_size));
+        ot->SendMessages();
+      }
+      break;
+    }
     case Provider::kROt: {
       if (my_id == 0) {
         auto ot{ot_provider.RegisterReceiveROt(batch_size, bit_size)};
@@ -36,13 +36,17 @@ enum Provider : std::size_t {
   kAcOt = 4,
   kROt = 5,
   kSb = 6,
-  kSp = 7
+  kSp = 7,
+  kBmtKk13 = 8,
+  kGOtKk13 = 9
 };
 
-constexpr std::array kProviderName{"AMT", "BMT", "GOT", "XCOT", "ACOT", "ROT", "SB", "SP"};
+constexpr std::array kProviderName{"AMT", "BMT", "GOT", "XCOT",     "ACOT",
+                                   "ROT", "SB",  "SP",  "BMT-KK13", "GOT-KK13"};
 
 inline std::string to_string(Provider p) { return kProviderName[p]; }
 
+// for kGOtKk13, bit_size is the number of messages of the 1-out-of-N bit OTs
 encrypto::motion::RunTimeStatistics BenchmarkProvider(encrypto::motion::PartyPointer& party,
                                                       std::size_t batch_size, Provider provider,
                                                       std::size_t bit_size = 0);
@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2019 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <iostream>
+
+#include <fmt/format.h>
+#include <boost/program_options.hpp>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/binary_circuit.h"
+
+namespace program_options = boost::program_options;
+
+// Converts a circuit in Bristol, Bristol Fashion or ABY format into a binary circuit file once
+// offline, which is then loaded via AlgorithmDescription::FromBinary or
+// FlatCircuit::FromBinaryCircuit without parsing.
+int main(int ac, char* av[]) {
+  try {
+    bool help;
+    program_options::options_description description("Allowed options");
+    // clang-format off
+    description.add_options()
+        ("help,h", program_options::bool_switch(&help)->default_value(false), "produce help message")
+        ("input,i", program_options::value<std::string>()->required(), "path of the input circuit")
+        ("format", program_options::value<std::string>()->default_value("bristol"), "format of the input circuit (bristol, bristol-fashion or aby)")
+        ("output,o", program_options::value<std::string>()->required(), "path of the binary circuit file");
+    // clang-format on
+
+    program_options::variables_map user_options;
+    program_options::store(program_options::parse_command_line(ac, av, description), user_options);
+    if (help) {
+      std::cout << description << "\n";
+      return EXIT_SUCCESS;
+    }
+    program_options::notify(user_options);
+
+    const auto input{user_options["input"].as<std::string>()};
+    const auto format{user_options["format"].as<std::string>()};
+    encrypto::motion::AlgorithmDescription algorithm;
+    if (format == "bristol") {
+      algorithm = encrypto::motion::AlgorithmDescription::FromBristol(input);
+    } else if (format == "bristol-fashion") {
+      algorithm = encrypto::motion::AlgorithmDescription::FromBristolFashion(input);
+    } else if (format == "aby") {
+      algorithm = encrypto::motion::AlgorithmDescription::FromAby(input);
+    } else {
+      throw std::invalid_argument(fmt::format("Unknown circuit format {}", format));
+    }
+
+    const auto output{user_options["output"].as<std::string>()};
+    encrypto::motion::WriteBinaryCircuit(algorithm, output);
+    std::cout << fmt::format("Wrote {} gates on {} wires to {}\n", algorithm.gates.size(),
+                             algorithm.number_of_wires, output);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <boost/program_options.hpp>
+
+#include "statistics/timeline.h"
+
+namespace program_options = boost::program_options;
+
+// Merges the traces of PartyTimeline::ToChromeTrace written by the parties into a single Chrome
+// trace, which shows the evaluations of all parties and the messages between them on the clock of
+// party 0, e.g., in chrome://tracing or Perfetto.
+int main(int ac, char* av[]) {
+  try {
+    bool help;
+    program_options::options_description description("Allowed options");
+    // clang-format off
+    description.add_options()
+        ("help,h", program_options::bool_switch(&help)->default_value(false), "produce help message")
+        ("traces", program_options::value<std::vector<std::string>>()->multitoken()->required(), "paths of the traces of the parties")
+        ("output,o", program_options::value<std::string>()->required(), "path of the merged trace");
+    // clang-format on
+    program_options::positional_options_description positional_options;
+    positional_options.add("traces", -1);
+
+    program_options::variables_map user_options;
+    program_options::store(program_options::command_line_parser(ac, av)
+                               .options(description)
+                               .positional(positional_options)
+                               .run(),
+                           user_options);
+    if (help) {
+      std::cout << description << "\n";
+      return EXIT_SUCCESS;
+    }
+    program_options::notify(user_options);
+
+    std::vector<std::string> traces;
+    for (const auto& path : user_options["traces"].as<std::vector<std::string>>()) {
+      std::ifstream file(path);
+      if (!file) {
+        throw std::runtime_error(fmt::format("Could not open {}", path));
+      }
+      std::stringstream content;
+      content << file.rdbuf();
+      traces.emplace_back(content.str());
+    }
+
+    const auto output{user_options["output"].as<std::string>()};
+    std::ofstream output_file(output);
+    output_file << encrypto::motion::MergeChromeTraces(traces);
+    if (!output_file) {
+      throw std::runtime_error(fmt::format("Could not write {}", output));
+    }
+    std::cout << fmt::format("Merged {} traces into {}\n", traces.size(), output);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,258 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs the microbenchmarks of motion_benchmark and the end-to-end benchmarks of benchmark_matrix,
+// stores the mean and variance of each benchmark together with the git revision and the machine
+// they were measured on, and flags statistically significant regressions against a baseline.
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+
+#include <fmt/format.h>
+#include <boost/json.hpp>
+#include <boost/process/args.hpp>
+#include <boost/process/child.hpp>
+#include <boost/process/exe.hpp>
+#include <boost/program_options.hpp>
+
+#include "statistics/performance_comparison.h"
+#include "utility/runtime_info.h"
+#include "utility/version.h"
+
+namespace program_options = boost::program_options;
+
+using encrypto::motion::PerformanceSample;
+using encrypto::motion::PerformanceSamples;
+
+namespace {
+
+boost::json::value ReadJson(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot open {}", path.string()));
+  }
+  std::stringstream content;
+  content << file.rdbuf();
+  return boost::json::parse(content.str());
+}
+
+void Run(const std::string& executable, const std::vector<std::string>& arguments) {
+  std::cout << executable;
+  for (const auto& argument : arguments) std::cout << ' ' << argument;
+  std::cout << std::endl;
+  boost::process::child child(boost::process::exe = executable, boost::process::args = arguments);
+  child.wait();
+  if (child.exit_code() != 0) {
+    throw std::runtime_error(
+        fmt::format("{} failed with exit code {}", executable, child.exit_code()));
+  }
+}
+
+// the mean and standard deviation aggregates of Google Benchmark, whose standard deviation is
+// already corrected
+PerformanceSamples RunMicroBenchmarks(const std::string& executable, const std::string& filter,
+                                      std::size_t repetitions,
+                                      const std::filesystem::path& output) {
+  Run(executable, {"--benchmark_out=" + output.string(), "--benchmark_out_format=json",
+                   fmt::format("--benchmark_repetitions={}", repetitions),
+                   "--benchmark_report_aggregates_only=true", "--benchmark_filter=" + filter});
+  std::map<std::string, double> means, standard_deviations;
+  std::map<std::string, std::size_t> numbers_of_repetitions;
+  for (const auto& benchmark : ReadJson(output).as_object().at("benchmarks").as_array()) {
+    const auto& object{benchmark.as_object()};
+    const auto aggregate_name{object.if_contains("aggregate_name")};
+    if (aggregate_name == nullptr) continue;
+    const std::string name{"micro/" + std::string(object.at("run_name").as_string())};
+    const auto time{object.at("real_time").to_number<double>()};
+    if (aggregate_name->as_string() == "mean") {
+      means[name] = time;
+      numbers_of_repetitions[name] = object.at("repetitions").to_number<std::size_t>();
+    } else if (aggregate_name->as_string() == "stddev") {
+      standard_deviations[name] = time;
+    }
+  }
+  std::filesystem::remove(output);
+  PerformanceSamples samples;
+  for (const auto& [name, mean] : means) {
+    const auto standard_deviation{standard_deviations[name]};
+    samples[name] = {.mean = mean,
+                     .variance = standard_deviation * standard_deviation,
+                     .repetitions = numbers_of_repetitions[name]};
+  }
+  return samples;
+}
+
+// the run times of all parties accumulated by AccumulatedRunTimeStatistics
+PerformanceSamples RunEndToEndBenchmarks(const std::string& executable,
+                                         std::vector<std::string> arguments,
+                                         std::size_t repetitions,
+                                         const std::filesystem::path& output) {
+  arguments.insert(arguments.end(),
+                   {"--repetitions", std::to_string(repetitions), "--output", output.string()});
+  Run(executable, arguments);
+  PerformanceSamples samples;
+  for (const auto& result : ReadJson(output).as_object().at("results").as_array()) {
+    const auto& object{result.as_object()};
+    const auto name{fmt::format(
+        "end-to-end/{}/{}/{} bit/{} simd/{} parties/{}",
+        std::string_view(object.at("protocol").as_string()),
+        std::string_view(object.at("operation").as_string()),
+        object.at("bit_size").to_number<std::size_t>(), object.at("simd").to_number<std::size_t>(),
+        object.at("parties").to_number<std::size_t>(),
+        std::string_view(object.at("network_profile").as_string()))};
+    const auto& run_time{object.at("run_time").as_object()};
+    const auto number_of_repetitions{run_time.at("repetitions").to_number<std::size_t>()};
+    for (std::string_view phase : {"evaluate", "gates_online"}) {
+      const auto& statistics{run_time.at(phase).as_object()};
+      samples[fmt::format("{}/{}", name, phase)] =
+          PerformanceSample::FromUncorrectedStandardDeviation(
+              statistics.at("mean").to_number<double>(),
+              statistics.at("stddev").to_number<double>(), number_of_repetitions);
+    }
+  }
+  std::filesystem::remove(output);
+  return samples;
+}
+
+boost::json::object ToJson(const PerformanceSamples& samples) {
+  boost::json::object result;
+  for (const auto& [name, sample] : samples) {
+    result[name] = boost::json::object{{"mean", sample.mean},
+                                       {"variance", sample.variance},
+                                       {"repetitions", sample.repetitions}};
+  }
+  return result;
+}
+
+PerformanceSamples SamplesFromJson(const boost::json::object& document) {
+  PerformanceSamples samples;
+  for (const auto& sample : document.at("samples").as_object()) {
+    const auto& object{sample.value().as_object()};
+    samples[std::string(sample.key())] = {
+        .mean = object.at("mean").to_number<double>(),
+        .variance = object.at("variance").to_number<double>(),
+        .repetitions = object.at("repetitions").to_number<std::size_t>()};
+  }
+  return samples;
+}
+
+std::optional<program_options::variables_map> ParseProgramOptions(int ac, char* av[]) {
+  bool help;
+  program_options::options_description description("Allowed options");
+  // clang-format off
+  description.add_options()
+      ("help,h", program_options::bool_switch(&help)->default_value(false), "produce help message")
+      ("micro-benchmark", program_options::value<std::string>(), "path of motion_benchmark")
+      ("micro-benchmark-filter", program_options::value<std::string>()->default_value("."), "regular expression selecting the microbenchmarks")
+      ("end-to-end-benchmark", program_options::value<std::string>(), "path of benchmark_matrix")
+      ("end-to-end-arguments", program_options::value<std::vector<std::string>>()->multitoken(), "further arguments of benchmark_matrix, e.g., --end-to-end-arguments=--protocols=BooleanGMW")
+      ("repetitions", program_options::value<std::size_t>()->default_value(5), "number of repetitions of each benchmark")
+      ("results-directory", program_options::value<std::string>()->default_value("performance_results"), "directory to store the results in, named by revision and host")
+      ("load", program_options::value<std::string>(), "compare the stored results in this file instead of running the benchmarks")
+      ("baseline", program_options::value<std::string>(), "stored results to compare to")
+      ("significance-level", program_options::value<double>()->default_value(0.01), "maximal p-value of Welch's t-test of a reported change")
+      ("minimum-change", program_options::value<double>()->default_value(0.05), "minimal relative change of the mean of a reported change");
+  // clang-format on
+
+  program_options::variables_map options;
+  program_options::store(program_options::parse_command_line(ac, av, description), options);
+  program_options::notify(options);
+  if (help) {
+    std::cout << description << "\n";
+    return std::nullopt;
+  }
+  if (!options.count("load") && !options.count("micro-benchmark") &&
+      !options.count("end-to-end-benchmark")) {
+    throw std::runtime_error(
+        "Either stored results or at least one benchmark executable need to be given");
+  }
+  return options;
+}
+
+}  // namespace
+
+int main(int ac, char* av[]) {
+  const auto options{ParseProgramOptions(ac, av)};
+  if (!options) return EXIT_SUCCESS;
+  const auto& user_options{*options};
+
+  boost::json::object current;
+  if (user_options.count("load")) {
+    current = ReadJson(user_options["load"].as<std::string>()).as_object();
+  } else {
+    const auto repetitions{user_options["repetitions"].as<std::size_t>()};
+    const std::filesystem::path directory{user_options["results-directory"].as<std::string>()};
+    std::filesystem::create_directories(directory);
+    PerformanceSamples samples;
+    if (user_options.count("micro-benchmark")) {
+      samples.merge(RunMicroBenchmarks(user_options["micro-benchmark"].as<std::string>(),
+                                       user_options["micro-benchmark-filter"].as<std::string>(),
+                                       repetitions, directory / "micro_benchmark.json"));
+    }
+    if (user_options.count("end-to-end-benchmark")) {
+      std::vector<std::string> arguments;
+      if (user_options.count("end-to-end-arguments")) {
+        arguments = user_options["end-to-end-arguments"].as<std::vector<std::string>>();
+      }
+      samples.merge(RunEndToEndBenchmarks(user_options["end-to-end-benchmark"].as<std::string>(),
+                                          arguments, repetitions,
+                                          directory / "end_to_end_benchmark.json"));
+    }
+    current = {{"revision", encrypto::motion::GetGitCommit()},
+               {"version", encrypto::motion::GetGitVersion()},
+               {"branch", encrypto::motion::GetGitBranch()},
+               {"hostname", encrypto::motion::GetHostname()},
+               {"cpu_model", encrypto::motion::GetCpuModel()},
+               {"samples", ToJson(samples)}};
+    const auto path{directory / fmt::format("{}_{}.json", encrypto::motion::GetGitCommit(),
+                                            encrypto::motion::GetHostname())};
+    std::ofstream(path) << boost::json::serialize(current) << '\n';
+    std::cout << fmt::format("Stored the results of {} benchmarks in {}\n", samples.size(),
+                             path.string());
+  }
+
+  if (!user_options.count("baseline")) return EXIT_SUCCESS;
+  const auto baseline{ReadJson(user_options["baseline"].as<std::string>()).as_object()};
+  for (std::string_view key : {"hostname", "cpu_model"}) {
+    if (baseline.at(key).as_string() != current.at(key).as_string()) {
+      std::cout << fmt::format("Warning: the {} of the baseline {} differs from {}\n", key,
+                               std::string_view(baseline.at(key).as_string()),
+                               std::string_view(current.at(key).as_string()));
+    }
+  }
+  const auto changes{encrypto::motion::ComparePerformance(
+      SamplesFromJson(baseline), SamplesFromJson(current),
+      {.significance_level = user_options["significance-level"].as<double>(),
+       .minimum_relative_change = user_options["minimum-change"].as<double>()})};
+  std::cout << fmt::format("Comparing revision {} to baseline revision {}\n",
+                           std::string_view(current.at("revision").as_string()),
+                           std::string_view(baseline.at("revision").as_string()));
+  std::cout << encrypto::motion::PrintPerformanceChanges(changes);
+  const bool has_regressions{std::any_of(changes.begin(), changes.end(), [](const auto& change) {
+    return change.verdict == encrypto::motion::PerformanceChange::Verdict::kRegression;
+  })};
+  // fails, e.g., a CI job if there are regressions
+  return has_regressions ? EXIT_FAILURE : EXIT_SUCCESS;
+}
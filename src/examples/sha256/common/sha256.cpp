@@ -24,26 +24,39 @@
 
 #include "sha256.h"
 
-#include "algorithm/algorithm_description.h"
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithm/sha256.h"
 #include "protocols/share_wrapper.h"
 #include "statistics/run_time_statistics.h"
-#include "utility/config.h"
 
-encrypto::motion::RunTimeStatistics EvaluateProtocol(encrypto::motion::PartyPointer& party,
-                                                     std::size_t number_of_simd,
-                                                     encrypto::motion::MpcProtocol protocol) {
-  // TODO tests
-  std::vector<encrypto::motion::BitVector<>> tmp(512 + 256,
-                                                 encrypto::motion::BitVector<>(number_of_simd));
-  encrypto::motion::ShareWrapper input{
-      protocol == encrypto::motion::MpcProtocol::kBooleanGmw
-          ? party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(tmp, 0)
-          : party->In<encrypto::motion::MpcProtocol::kBmr>(tmp, 0)};
-  const auto kAlgorithmPath{std::string(encrypto::motion::kRootDir) +
-                            "/circuits/advanced/sha_256.bristol"};
-  const auto sha_algorithm{
-      encrypto::motion::AlgorithmDescription::FromBristolFashion(kAlgorithmPath)};
-  const auto result{input.Evaluate(sha_algorithm)};
+encrypto::motion::RunTimeStatistics EvaluateProtocol(
+    encrypto::motion::PartyPointer& party, std::size_t number_of_simd,
+    std::size_t number_of_blocks, encrypto::motion::MpcProtocol protocol,
+    encrypto::motion::algorithm::IntegerCircuitOptimization optimization) {
+  // number_of_simd messages that are padded to number_of_blocks blocks each
+  const std::size_t kBlockByteSize{encrypto::motion::algorithm::kSha256BlockBitSize / 8};
+  const std::vector<std::vector<std::uint8_t>> messages(
+      number_of_simd, std::vector<std::uint8_t>(number_of_blocks * kBlockByteSize - 9));
+  const auto padded_messages{encrypto::motion::algorithm::Sha256PadMessages(messages)};
+  const std::span<const encrypto::motion::BitVector<>> input_wires(padded_messages);
+  encrypto::motion::ShareWrapper input;
+  switch (protocol) {
+    case encrypto::motion::MpcProtocol::kBooleanGmw:
+      input = party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(input_wires, 0);
+      break;
+    case encrypto::motion::MpcProtocol::kBmr:
+      input = party->In<encrypto::motion::MpcProtocol::kBmr>(input_wires, 0);
+      break;
+    case encrypto::motion::MpcProtocol::kGarbledCircuit:
+      input = party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(input_wires, 0);
+      break;
+    default:
+      throw std::invalid_argument("SHA256 is only implemented for Boolean GMW, BMR and GC");
+  }
+  const auto result{encrypto::motion::algorithm::Sha256(input, optimization)};
   party->Run();
   party->Finish();
   const auto& statistics = party->GetBackend()->GetRunTimeStatistics();
@@ -24,9 +24,12 @@
 
 #pragma once
 
+#include "algorithm/integer_circuits.h"
 #include "base/party.h"
 #include "statistics/run_time_statistics.h"
 
-encrypto::motion::RunTimeStatistics EvaluateProtocol(encrypto::motion::PartyPointer& party,
-                                                     std::size_t number_of_simd,
-                                                     encrypto::motion::MpcProtocol protocol);
+// hashes number_of_simd messages of number_of_blocks blocks each as one SIMD batch
+encrypto::motion::RunTimeStatistics EvaluateProtocol(
+    encrypto::motion::PartyPointer& party, std::size_t number_of_simd,
+    std::size_t number_of_blocks, encrypto::motion::MpcProtocol protocol,
+    encrypto::motion::algorithm::IntegerCircuitOptimization optimization);
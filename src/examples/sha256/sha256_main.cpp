@@ -53,34 +53,44 @@ int main(int ac, char* av[]) {
     if (help_flag) return EXIT_SUCCESS;
 
     const auto number_of_simd{user_options["num-simd"].as<std::size_t>()};
+    const auto number_of_blocks{user_options["num-blocks"].as<std::size_t>()};
+    if (number_of_blocks == 0) throw std::invalid_argument("At least one block is required");
     const auto number_of_repetitions{user_options["repetitions"].as<std::size_t>()};
-    encrypto::motion::MpcProtocol protocol;
     const std::string protocol_string{user_options["protocol"].as<std::string>()};
+    encrypto::motion::MpcProtocol protocol;
+    if (protocol_string == "BMR") {
+      protocol = encrypto::motion::MpcProtocol::kBmr;
+    } else if (protocol_string == "GMW" || protocol_string == "BooleanGMW") {
+      protocol = encrypto::motion::MpcProtocol::kBooleanGmw;
+    } else if (protocol_string == "GC") {
+      protocol = encrypto::motion::MpcProtocol::kGarbledCircuit;
+    } else {
+      throw std::invalid_argument("Only GMW, BMR or GC is allowed");
+    }
+    const std::string optimization_string{user_options["optimization"].as<std::string>()};
+    encrypto::motion::algorithm::IntegerCircuitOptimization optimization;
+    if (optimization_string == "depth") {
+      optimization = encrypto::motion::algorithm::IntegerCircuitOptimization::kDepth;
+    } else if (optimization_string == "size") {
+      optimization = encrypto::motion::algorithm::IntegerCircuitOptimization::kSize;
+    } else {
+      throw std::invalid_argument("Only depth or size optimization is allowed");
+    }
     encrypto::motion::AccumulatedRunTimeStatistics accumulated_statistics;
     encrypto::motion::AccumulatedCommunicationStatistics accumulated_communication_statistics;
 
     for (std::size_t i = 0; i < number_of_repetitions; ++i) {
       encrypto::motion::PartyPointer party{CreateParty(user_options)};
-      // establish communication channels with other parties
-
-      if (protocol_string == "BMR") {
-        auto statistics =
-            EvaluateProtocol(party, number_of_simd, encrypto::motion::MpcProtocol::kBmr);
-        accumulated_statistics.Add(statistics);
-      } else if (protocol_string == "GMW" || protocol_string == "BooleanGMW") {
-        auto statistics =
-            EvaluateProtocol(party, number_of_simd, encrypto::motion::MpcProtocol::kBooleanGmw);
-        accumulated_statistics.Add(statistics);
-      } else {
-        throw std::invalid_argument("Only GMW or BMR is allowed");
-      }
+      accumulated_statistics.Add(
+          EvaluateProtocol(party, number_of_simd, number_of_blocks, protocol, optimization));
       auto communication_statistics =
           party->GetBackend()->GetCommunicationLayer().GetTransportStatistics();
       accumulated_communication_statistics.Add(communication_statistics);
     }
 
     std::cout << encrypto::motion::PrintStatistics(
-        fmt::format("SHA256 with {} SIMD values in {}", number_of_simd, protocol_string),
+        fmt::format("SHA256 of {} messages of {} blocks in {}", number_of_simd, number_of_blocks,
+                    protocol_string),
         accumulated_statistics, accumulated_communication_statistics);
 
   } catch (std::runtime_error& e) {
@@ -123,9 +133,12 @@ std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char
       ("configuration-file,f", program_options::value<std::string>(), kConfigFileMessage.data())
       ("my-id", program_options::value<std::size_t>(), "my party id")
       ("parties", program_options::value<std::vector<std::string>>()->multitoken(), "info (id,IP,port) for each party e.g., --parties 0,127.0.0.1,23000 1,127.0.0.1,23001")
-      ("num-simd", program_options::value<std::size_t>()->default_value(1), "number of SIMD values for SHA256 evaluation")
-      ("protocol", program_options::value<std::string>()->default_value("BMR"), "Boolean MPC protocol (BMR or GMW)")
+      ("num-simd", program_options::value<std::size_t>()->default_value(1), "number of messages that are hashed in one SIMD batch")
+      ("num-blocks", program_options::value<std::size_t>()->default_value(1), "number of 512-bit blocks per padded message")
+      ("optimization", program_options::value<std::string>()->default_value("depth"), "optimization of the compression function (depth or size)")
+      ("protocol", program_options::value<std::string>()->default_value("BMR"), "Boolean MPC protocol (BMR, GMW or GC)")
       ("online-after-setup", program_options::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
+      ("critical-path-priority", program_options::value<bool>()->default_value(false), "post gates with a longer remaining path to the outputs first (true/1 or false/0)")
       ("repetitions", program_options::value<std::size_t>()->default_value(1), "number of repetitions");
   // clang-format on
 
@@ -173,6 +186,8 @@ std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char
     std::cout << "Number of SIMD SHA256 evaluations: " << user_options["num-simd"].as<std::size_t>()
               << std::endl;
 
+    std::cout << "Number of blocks per message: " << user_options["num-blocks"].as<std::size_t>()
+              << std::endl;
     std::cout << "MPC Protocol: " << user_options["protocol"].as<std::string>() << std::endl;
   }
   return std::make_pair(user_options, help);
@@ -209,5 +224,6 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
   const auto logging{!user_options.count("disable-logging")};
   configuration->SetLoggingEnabled(logging);
   configuration->SetOnlineAfterSetup(user_options["online-after-setup"].as<bool>());
+  configuration->SetCriticalPathPriority(user_options["critical-path-priority"].as<bool>());
   return party;
 }
@@ -0,0 +1,366 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "aes128.h"
+
+#include <array>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "circuit_builder.h"
+#include "protocols/share.h"
+#include "protocols/share_view.h"
+
+namespace encrypto::motion::algorithm {
+
+using circuit_builder::Bits;
+using circuit_builder::CircuitBuilder;
+using circuit_builder::Wire;
+
+namespace {
+
+constexpr std::size_t kBlockByteSize{kAes128BlockBitSize / 8};
+constexpr std::size_t kRoundKeysBitSize{kAes128NumberOfRoundKeys * kAes128BlockBitSize};
+
+// the 16 bytes of 8 wires each, least significant bit first, of the block at first_wire
+using State = std::array<Bits, kBlockByteSize>;
+
+State Bytes(const Bits& wires, std::size_t first_wire) {
+  State state;
+  for (std::size_t b = 0; b < kBlockByteSize; ++b) {
+    const auto begin{wires.begin() + first_wire + 8 * (kBlockByteSize - 1 - b)};
+    state[b] = Bits(begin, begin + 8);
+  }
+  return state;
+}
+
+void AppendWires(Bits& wires, const State& state) {
+  const std::size_t first_wire{wires.size()};
+  wires.resize(first_wire + kAes128BlockBitSize);
+  for (std::size_t b = 0; b < kBlockByteSize; ++b) {
+    std::copy(state[b].begin(), state[b].end(),
+              wires.begin() + first_wire + 8 * (kBlockByteSize - 1 - b));
+  }
+}
+
+Bits Xor(CircuitBuilder& builder, const Bits& a, const Bits& b) {
+  Bits bits(a.size());
+  for (std::size_t k = 0; k < a.size(); ++k) bits[k] = builder.Xor(a[k], b[k]);
+  return bits;
+}
+
+// the S-box circuit of Boyar and Peralta, "A depth-16 circuit for the AES S-box", where u[0] is
+// the most significant bit
+Bits SubByte(CircuitBuilder& builder, const Bits& byte) {
+  const auto x = [&builder](Wire v, Wire w) { return builder.Xor(v, w); };
+  const auto a = [&builder](Wire v, Wire w) { return builder.And(v, w); };
+  const auto xn = [&builder](Wire v, Wire w) { return builder.Inv(builder.Xor(v, w)); };
+  const std::array u{byte[7], byte[6], byte[5], byte[4], byte[3], byte[2], byte[1], byte[0]};
+  const Wire t1{x(u[0], u[3])};
+  const Wire t2{x(u[0], u[5])};
+  const Wire t3{x(u[0], u[6])};
+  const Wire t4{x(u[3], u[5])};
+  const Wire t5{x(u[4], u[6])};
+  const Wire t6{x(t1, t5)};
+  const Wire t7{x(u[1], u[2])};
+  const Wire t8{x(u[7], t6)};
+  const Wire t9{x(u[7], t7)};
+  const Wire t10{x(t6, t7)};
+  const Wire t11{x(u[1], u[5])};
+  const Wire t12{x(u[2], u[5])};
+  const Wire t13{x(t3, t4)};
+  const Wire t14{x(t6, t11)};
+  const Wire t15{x(t5, t11)};
+  const Wire t16{x(t5, t12)};
+  const Wire t17{x(t9, t16)};
+  const Wire t18{x(u[3], u[7])};
+  const Wire t19{x(t7, t18)};
+  const Wire t20{x(t1, t19)};
+  const Wire t21{x(u[6], u[7])};
+  const Wire t22{x(t7, t21)};
+  const Wire t23{x(t2, t22)};
+  const Wire t24{x(t2, t10)};
+  const Wire t25{x(t20, t17)};
+  const Wire t26{x(t3, t16)};
+  const Wire t27{x(t1, t12)};
+  const Wire m1{a(t13, t6)};
+  const Wire m2{a(t23, t8)};
+  const Wire m3{x(t14, m1)};
+  const Wire m4{a(t19, u[7])};
+  const Wire m5{x(m4, m1)};
+  const Wire m6{a(t3, t16)};
+  const Wire m7{a(t22, t9)};
+  const Wire m8{x(t26, m6)};
+  const Wire m9{a(t20, t17)};
+  const Wire m10{x(m9, m6)};
+  const Wire m11{a(t1, t15)};
+  const Wire m12{a(t4, t27)};
+  const Wire m13{x(m12, m11)};
+  const Wire m14{a(t2, t10)};
+  const Wire m15{x(m14, m11)};
+  const Wire m16{x(m3, m2)};
+  const Wire m17{x(m5, t24)};
+  const Wire m18{x(m8, m7)};
+  const Wire m19{x(m10, m15)};
+  const Wire m20{x(m16, m13)};
+  const Wire m21{x(m17, m15)};
+  const Wire m22{x(m18, m13)};
+  const Wire m23{x(m19, t25)};
+  const Wire m24{x(m22, m23)};
+  const Wire m25{a(m22, m20)};
+  const Wire m26{x(m21, m25)};
+  const Wire m27{x(m20, m21)};
+  const Wire m28{x(m23, m25)};
+  const Wire m29{a(m28, m27)};
+  const Wire m30{a(m26, m24)};
+  const Wire m31{a(m20, m23)};
+  const Wire m32{a(m27, m31)};
+  const Wire m33{x(m27, m25)};
+  const Wire m34{a(m21, m22)};
+  const Wire m35{a(m24, m34)};
+  const Wire m36{x(m24, m25)};
+  const Wire m37{x(m21, m29)};
+  const Wire m38{x(m32, m33)};
+  const Wire m39{x(m23, m30)};
+  const Wire m40{x(m35, m36)};
+  const Wire m41{x(m38, m40)};
+  const Wire m42{x(m37, m39)};
+  const Wire m43{x(m37, m38)};
+  const Wire m44{x(m39, m40)};
+  const Wire m45{x(m42, m41)};
+  const Wire m46{a(m44, t6)};
+  const Wire m47{a(m40, t8)};
+  const Wire m48{a(m39, u[7])};
+  const Wire m49{a(m43, t16)};
+  const Wire m50{a(m38, t9)};
+  const Wire m51{a(m37, t17)};
+  const Wire m52{a(m42, t15)};
+  const Wire m53{a(m45, t27)};
+  const Wire m54{a(m41, t10)};
+  const Wire m55{a(m44, t13)};
+  const Wire m56{a(m40, t23)};
+  const Wire m57{a(m39, t19)};
+  const Wire m58{a(m43, t3)};
+  const Wire m59{a(m38, t22)};
+  const Wire m60{a(m37, t20)};
+  const Wire m61{a(m42, t1)};
+  const Wire m62{a(m45, t4)};
+  const Wire m63{a(m41, t2)};
+  const Wire l0{x(m61, m62)};
+  const Wire l1{x(m50, m56)};
+  const Wire l2{x(m46, m48)};
+  const Wire l3{x(m47, m55)};
+  const Wire l4{x(m54, m58)};
+  const Wire l5{x(m49, m61)};
+  const Wire l6{x(m62, l5)};
+  const Wire l7{x(m46, l3)};
+  const Wire l8{x(m51, m59)};
+  const Wire l9{x(m52, m53)};
+  const Wire l10{x(m53, l4)};
+  const Wire l11{x(m60, l2)};
+  const Wire l12{x(m48, m51)};
+  const Wire l13{x(m50, l0)};
+  const Wire l14{x(m52, m61)};
+  const Wire l15{x(m55, l1)};
+  const Wire l16{x(m56, l0)};
+  const Wire l17{x(m57, l1)};
+  const Wire l18{x(m58, l8)};
+  const Wire l19{x(m63, l4)};
+  const Wire l20{x(l0, l1)};
+  const Wire l21{x(l1, l7)};
+  const Wire l22{x(l3, l12)};
+  const Wire l23{x(l18, l2)};
+  const Wire l24{x(l15, l9)};
+  const Wire l25{x(l6, l10)};
+  const Wire l26{x(l7, l9)};
+  const Wire l27{x(l8, l10)};
+  const Wire l28{x(l11, l14)};
+  const Wire l29{x(l11, l17)};
+  Bits s(8);
+  s[7] = x(l6, l24);
+  s[6] = xn(l16, l26);
+  s[5] = xn(l19, l28);
+  s[4] = x(l6, l21);
+  s[3] = x(l20, l22);
+  s[2] = x(l25, l29);
+  s[1] = xn(l13, l27);
+  s[0] = xn(l6, l23);
+  return s;
+}
+
+// multiplication by x in GF(2^8) modulo x^8 + x^4 + x^3 + x + 1
+Bits Xtime(CircuitBuilder& builder, const Bits& a) {
+  return {a[7],
+          builder.Xor(a[0], a[7]),
+          a[1],
+          builder.Xor(a[2], a[7]),
+          builder.Xor(a[3], a[7]),
+          a[4],
+          a[5],
+          a[6]};
+}
+
+State Round(CircuitBuilder& builder, const State& state, const State& round_key, bool last) {
+  // SubBytes and ShiftRows, where byte r + 4 * c is in row r and column c
+  State shifted;
+  for (std::size_t r = 0; r < 4; ++r) {
+    for (std::size_t c = 0; c < 4; ++c) {
+      shifted[r + 4 * c] = SubByte(builder, state[r + 4 * ((c + r) % 4)]);
+    }
+  }
+  State mixed{shifted};
+  if (!last) {
+    // column byte i becomes a_i ^ (a_0 ^ a_1 ^ a_2 ^ a_3) ^ 2 * (a_i ^ a_{i + 1})
+    for (std::size_t c = 0; c < 4; ++c) {
+      const Bits* column{&shifted[4 * c]};
+      const Bits sum{Xor(builder, Xor(builder, column[0], column[1]),
+                         Xor(builder, column[2], column[3]))};
+      for (std::size_t i = 0; i < 4; ++i) {
+        mixed[4 * c + i] = Xor(builder, Xor(builder, column[i], sum),
+                               Xtime(builder, Xor(builder, column[i], column[(i + 1) % 4])));
+      }
+    }
+  }
+  for (std::size_t b = 0; b < kBlockByteSize; ++b) mixed[b] = Xor(builder, mixed[b], round_key[b]);
+  return mixed;
+}
+
+}  // namespace
+
+AlgorithmDescription Aes128KeyExpansionCircuit() {
+  CircuitBuilder builder(kAes128BlockBitSize, 1);
+  const State key{Bytes(builder.Operand(0), 0)};
+  // the 44 words of 4 bytes each
+  std::vector<std::array<Bits, 4>> words;
+  for (std::size_t i = 0; i < 4; ++i) {
+    words.push_back({key[4 * i], key[4 * i + 1], key[4 * i + 2], key[4 * i + 3]});
+  }
+  std::uint8_t round_constant{1};
+  for (std::size_t i = 4; i < 4 * kAes128NumberOfRoundKeys; ++i) {
+    std::array<Bits, 4> word{words[i - 1]};
+    if (i % 4 == 0) {
+      // SubWord(RotWord(word)) ^ round_constant
+      word = {SubByte(builder, words[i - 1][1]), SubByte(builder, words[i - 1][2]),
+              SubByte(builder, words[i - 1][3]), SubByte(builder, words[i - 1][0])};
+      for (std::size_t k = 0; k < 8; ++k) {
+        if ((round_constant >> k) & 1) word[0][k] = builder.Inv(word[0][k]);
+      }
+      round_constant = static_cast<std::uint8_t>((round_constant << 1) ^
+                                                 ((round_constant >> 7) * 0x1b));
+    }
+    for (std::size_t b = 0; b < 4; ++b) word[b] = Xor(builder, words[i - 4][b], word[b]);
+    words.push_back(std::move(word));
+  }
+  Bits outputs;
+  for (std::size_t r = 0; r < kAes128NumberOfRoundKeys; ++r) {
+    State round_key;
+    for (std::size_t b = 0; b < kBlockByteSize; ++b) round_key[b] = words[4 * r + b / 4][b % 4];
+    AppendWires(outputs, round_key);
+  }
+  return builder.Finish(outputs);
+}
+
+AlgorithmDescription Aes128EncryptionCircuit() {
+  CircuitBuilder builder(kAes128BlockBitSize + kRoundKeysBitSize, 1);
+  const Bits inputs{builder.Operand(0)};
+  State state{Bytes(inputs, 0)};
+  const State first_round_key{Bytes(inputs, kAes128BlockBitSize)};
+  for (std::size_t b = 0; b < kBlockByteSize; ++b) {
+    state[b] = Xor(builder, state[b], first_round_key[b]);
+  }
+  for (std::size_t r = 1; r < kAes128NumberOfRoundKeys; ++r) {
+    state = Round(builder, state, Bytes(inputs, (r + 1) * kAes128BlockBitSize),
+                  r + 1 == kAes128NumberOfRoundKeys);
+  }
+  Bits outputs;
+  AppendWires(outputs, state);
+  return builder.Finish(outputs);
+}
+
+std::vector<BitVector<>> Aes128CounterBlocks(std::span<const std::uint8_t> initial_counter_block,
+                                             std::size_t first_counter,
+                                             std::size_t number_of_blocks) {
+  if (initial_counter_block.size() != kBlockByteSize) {
+    throw std::invalid_argument(fmt::format("Aes128CounterBlocks: {} instead of {} bytes",
+                                            initial_counter_block.size(), kBlockByteSize));
+  }
+  std::vector<BitVector<>> wires(kAes128BlockBitSize, BitVector<>(number_of_blocks));
+  for (std::size_t j = 0; j < number_of_blocks; ++j) {
+    // adds first_counter + j to the big-endian block
+    std::array<std::uint8_t, kBlockByteSize> block;
+    std::uint64_t carry{static_cast<std::uint64_t>(first_counter + j)};
+    for (std::size_t b = kBlockByteSize; b-- > 0;) {
+      const std::uint64_t sum{initial_counter_block[b] + (carry & 0xff)};
+      block[b] = static_cast<std::uint8_t>(sum);
+      carry = (carry >> 8) + (sum >> 8);
+    }
+    for (std::size_t i = 0; i < kAes128BlockBitSize; ++i) {
+      wires[i].Set(((block[kBlockByteSize - 1 - i / 8] >> i % 8) & 1) != 0, j);
+    }
+  }
+  return wires;
+}
+
+std::vector<std::vector<std::uint8_t>> Aes128Blocks(std::span<const BitVector<>> wires) {
+  if (wires.size() != kAes128BlockBitSize) {
+    throw std::invalid_argument(
+        fmt::format("Aes128Blocks: {} instead of {} wires", wires.size(), kAes128BlockBitSize));
+  }
+  std::vector<std::vector<std::uint8_t>> blocks(wires[0].GetSize(),
+                                                std::vector<std::uint8_t>(kBlockByteSize, 0));
+  for (std::size_t i = 0; i < kAes128BlockBitSize; ++i) {
+    for (std::size_t j = 0; j < blocks.size(); ++j) {
+      if (wires[i].Get(j)) blocks[j][kBlockByteSize - 1 - i / 8] |= 1 << i % 8;
+    }
+  }
+  return blocks;
+}
+
+Aes128CtrKeystream::Aes128CtrKeystream(const ShareWrapper& key) {
+  if (key->GetBitLength() != kAes128BlockBitSize || key->GetNumberOfSimdValues() != 1) {
+    throw std::invalid_argument(
+        fmt::format("Aes128CtrKeystream: the key has {} wires of {} SIMD values",
+                    key->GetBitLength(), key->GetNumberOfSimdValues()));
+  }
+  static const AlgorithmDescription kKeyExpansion{Aes128KeyExpansionCircuit()};
+  round_keys_ = key.Evaluate(kKeyExpansion);
+}
+
+ShareWrapper Aes128CtrKeystream::Encrypt(const ShareWrapper& counter_blocks) const {
+  if (counter_blocks->GetBitLength() != kAes128BlockBitSize) {
+    throw std::invalid_argument(fmt::format("Aes128CtrKeystream: {} instead of {} wires",
+                                            counter_blocks->GetBitLength(),
+                                            kAes128BlockBitSize));
+  }
+  static const AlgorithmDescription kEncryption{Aes128EncryptionCircuit()};
+  // the round keys are the same for all SIMD values
+  const std::vector<std::size_t> positions(counter_blocks->GetNumberOfSimdValues(), 0);
+  ShareWrapper round_keys{round_keys_};
+  const std::array inputs{counter_blocks, round_keys.Subset(positions)};
+  return ShareWrapper::Concatenate(inputs).Evaluate(kEncryption);
+}
+
+}  // namespace encrypto::motion::algorithm
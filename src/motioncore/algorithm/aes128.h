@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "algorithm_description.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::algorithm {
+
+inline constexpr std::size_t kAes128BlockBitSize{128};
+inline constexpr std::size_t kAes128NumberOfRoundKeys{11};
+
+/// \brief creates the Boolean circuit of the AES-128 key expansion, whose inputs are the 128 wires
+/// of the key and whose outputs are the 11 round keys of 128 wires each. A string of 16 bytes is
+/// laid out like in circuits/advanced/aes_128.bristol, i.e., wire i is bit i % 8 of byte
+/// 15 - i / 8. The S-boxes are the depth-16 circuit of Boyar and Peralta with 34 AND gates.
+AlgorithmDescription Aes128KeyExpansionCircuit();
+
+/// \brief creates the Boolean circuit of the AES-128 encryption of a block with expanded keys,
+/// whose inputs are the 128 wires of the block followed by the round keys of
+/// Aes128KeyExpansionCircuit and whose outputs are the 128 wires of the ciphertext
+AlgorithmDescription Aes128EncryptionCircuit();
+
+/// \brief the counter blocks initial_counter_block + first_counter + j modulo 2^128 for
+/// j < number_of_blocks as the SIMD values of 128 wires
+/// \throws std::invalid_argument if initial_counter_block does not have 16 bytes
+std::vector<BitVector<>> Aes128CounterBlocks(std::span<const std::uint8_t> initial_counter_block,
+                                             std::size_t first_counter,
+                                             std::size_t number_of_blocks);
+
+/// \brief converts 128 wires to the 16 bytes of the block of each SIMD value
+std::vector<std::vector<std::uint8_t>> Aes128Blocks(std::span<const BitVector<>> wires);
+
+/// \brief keystream of AES-128 in counter mode under a secret key, which is expanded only once
+/// when the keystream is constructed. Each call of Encrypt() evaluates the rounds on a batch of
+/// SIMD-packed counter blocks, whose keystream can be consumed by ShareWrapper::WaitOnline() while
+/// Party::RunAsync() still evaluates the following batches. Only Boolean GMW and BMR shares are
+/// supported, since the round keys are repeated for the SIMD values by a SubsetGate.
+class Aes128CtrKeystream {
+ public:
+  /// \param key share of the 128 key wires with one SIMD value
+  /// \throws std::invalid_argument if key does not have 128 wires of one SIMD value
+  explicit Aes128CtrKeystream(const ShareWrapper& key);
+
+  /// \brief encrypts the counter blocks, e.g., an input of Aes128CounterBlocks, one per SIMD value
+  /// \throws std::invalid_argument if counter_blocks does not have 128 wires
+  ShareWrapper Encrypt(const ShareWrapper& counter_blocks) const;
+
+  const ShareWrapper& GetRoundKeys() const { return round_keys_; }
+
+ private:
+  ShareWrapper round_keys_;
+};
+
+}  // namespace encrypto::motion::algorithm
@@ -23,6 +23,8 @@
 // SOFTWARE.
 
 #include "algorithm_description.h"
+#include "binary_circuit.h"
+#include "circuit_schedule.h"
 
 #include <fstream>
 #include <regex>
@@ -143,6 +145,7 @@ AlgorithmDescription AlgorithmDescription::FromBristol(std::ifstream& stream) {
     line.clear();
     line_vector.clear();
   }
+  algorithm_description.ComputeSchedule();
   return algorithm_description;
 }
 
@@ -268,6 +271,7 @@ AlgorithmDescription AlgorithmDescription::FromBristolFashion(std::ifstream& str
     algorithm_description.gates.emplace_back(std::move(primitive_operation));
   }
 
+  algorithm_description.ComputeSchedule();
   return algorithm_description;
 }
 
@@ -418,4 +422,25 @@ AlgorithmDescription AlgorithmDescription::FromAby(std::ifstream& stream) {
   return algorithm_description;
 }
 
+AlgorithmDescription AlgorithmDescription::FromBinary(const std::string& path) {
+  const MappedBinaryCircuit binary_circuit(path);
+  auto algorithm_description{binary_circuit.ToAlgorithmDescription()};
+  algorithm_description.schedule =
+      std::make_shared<const CircuitSchedule>(CircuitSchedule::FromBinaryCircuit(binary_circuit));
+  return algorithm_description;
+}
+
+std::shared_ptr<const CircuitSchedule> AlgorithmDescription::GetSchedule() const {
+  if (schedule && schedule->GetNumberOfGates() == gates.size() &&
+      schedule->wire_layers.size() == number_of_wires) {
+    return schedule;
+  }
+  return std::make_shared<const CircuitSchedule>(CircuitSchedule::FromAlgorithmDescription(*this));
+}
+
+void AlgorithmDescription::ComputeSchedule() {
+  schedule =
+      std::make_shared<const CircuitSchedule>(CircuitSchedule::FromAlgorithmDescription(*this));
+}
+
 }  // namespace encrypto::motion
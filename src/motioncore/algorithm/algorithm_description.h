@@ -25,6 +25,7 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -32,6 +33,8 @@
 
 namespace encrypto::motion {
 
+struct CircuitSchedule;
+
 struct PrimitiveOperation {
   PrimitiveOperationType type{PrimitiveOperationType::kInvalid};
   std::size_t parent_a{0};
@@ -61,10 +64,24 @@ struct AlgorithmDescription {
 
   static AlgorithmDescription FromAby(std::ifstream& stream);
 
+  // reads a binary circuit file written by WriteBinaryCircuit, see binary_circuit.h
+  static AlgorithmDescription FromBinary(const std::string& path);
+
   std::size_t number_of_output_wires{0}, number_of_input_wires_parent_a{0}, number_of_wires{0},
       number_of_gates{0};
   std::optional<std::size_t> number_of_input_wires_parent_b{std::nullopt};
   std::vector<PrimitiveOperation> gates;
+
+  // the layered schedule of the gates, which the loaders and
+  // Register::AddCachedAlgorithmDescription compute once, see circuit_schedule.h. Code that
+  // modifies the gates of a loaded description has to reset it.
+  std::shared_ptr<const CircuitSchedule> schedule;
+
+  // returns the cached schedule if it matches the gates and computes a new one otherwise
+  std::shared_ptr<const CircuitSchedule> GetSchedule() const;
+
+  // computes and caches the schedule of the gates
+  void ComputeSchedule();
 };
 
 }  // namespace encrypto::motion
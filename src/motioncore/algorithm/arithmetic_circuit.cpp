@@ -0,0 +1,355 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "arithmetic_circuit.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "protocols/share.h"
+
+namespace encrypto::motion {
+
+std::string to_string(ArithmeticOperationType type) {
+  switch (type) {
+    case ArithmeticOperationType::kAdd:
+      return "ADD";
+    case ArithmeticOperationType::kSub:
+      return "SUB";
+    case ArithmeticOperationType::kMul:
+      return "MUL";
+    case ArithmeticOperationType::kConstantMul:
+      return "CMUL";
+    case ArithmeticOperationType::kDot:
+      return "DOT";
+  }
+  return "INVALID";
+}
+
+ArithmeticAlgorithmDescription ArithmeticAlgorithmDescription::FromText(const std::string& path) {
+  std::ifstream stream(path);
+  if (!stream.is_open()) {
+    throw std::runtime_error(fmt::format("Cannot open arithmetic circuit file {}", path));
+  }
+  return FromText(stream);
+}
+
+ArithmeticAlgorithmDescription ArithmeticAlgorithmDescription::FromText(std::istream& stream) {
+  ArithmeticAlgorithmDescription circuit;
+  std::size_t number_of_operations{0};
+  if (!(stream >> number_of_operations >> circuit.number_of_wires >>
+        circuit.number_of_input_wires >> circuit.number_of_output_wires)) {
+    throw std::runtime_error("Malformed header of the arithmetic circuit file");
+  }
+  if (circuit.number_of_input_wires + number_of_operations > circuit.number_of_wires ||
+      circuit.number_of_output_wires > circuit.number_of_wires) {
+    throw std::runtime_error(fmt::format(
+        "Arithmetic circuit with {} wires cannot have {} inputs, {} operations and {} outputs",
+        circuit.number_of_wires, circuit.number_of_input_wires, number_of_operations,
+        circuit.number_of_output_wires));
+  }
+
+  circuit.operations.reserve(number_of_operations);
+  std::string line;
+  // the remainder of the header line
+  std::getline(stream, line);
+  for (std::size_t line_number = 3; circuit.operations.size() < number_of_operations;
+       ++line_number) {
+    if (!std::getline(stream, line)) {
+      throw std::runtime_error(fmt::format("Arithmetic circuit file ends after {} of {} operations",
+                                           circuit.operations.size(), number_of_operations));
+    }
+    std::istringstream line_stream(line);
+    std::string type;
+    if (!(line_stream >> type)) continue;
+
+    ArithmeticOperation operation;
+    std::size_t number_of_input_wires{2};
+    if (type == "ADD") {
+      operation.type = ArithmeticOperationType::kAdd;
+    } else if (type == "SUB") {
+      operation.type = ArithmeticOperationType::kSub;
+    } else if (type == "MUL") {
+      operation.type = ArithmeticOperationType::kMul;
+    } else if (type == "CMUL") {
+      operation.type = ArithmeticOperationType::kConstantMul;
+      number_of_input_wires = 1;
+    } else if (type == "DOT") {
+      operation.type = ArithmeticOperationType::kDot;
+      std::size_t length{0};
+      if (!(line_stream >> length) || length == 0) {
+        throw std::runtime_error(
+            fmt::format("Malformed length of the dot product at line {}", line_number));
+      }
+      number_of_input_wires = 2 * length;
+    } else {
+      throw std::runtime_error(
+          fmt::format("Unknown arithmetic operation {} at line {}", type, line_number));
+    }
+    operation.input_wires.resize(number_of_input_wires);
+    bool is_well_formed{true};
+    for (auto& wire : operation.input_wires) is_well_formed = is_well_formed && (line_stream >> wire);
+    if (operation.type == ArithmeticOperationType::kConstantMul) {
+      is_well_formed = is_well_formed && (line_stream >> operation.constant);
+    }
+    is_well_formed = is_well_formed && (line_stream >> operation.output_wire);
+    std::string rest;
+    if (!is_well_formed || (line_stream >> rest)) {
+      throw std::runtime_error(
+          fmt::format("Malformed arithmetic operation {} at line {}", type, line_number));
+    }
+    circuit.operations.emplace_back(std::move(operation));
+  }
+
+  // checks the wires and that the outputs are computed
+  circuit.ComputeLayers();
+  return circuit;
+}
+
+std::vector<std::vector<std::size_t>> ArithmeticAlgorithmDescription::ComputeLayers() const {
+  constexpr std::size_t kNotComputed{std::numeric_limits<std::size_t>::max()};
+  // the layer of the operation computing a wire plus one, 0 for the inputs
+  std::vector<std::size_t> depths(number_of_wires, kNotComputed);
+  std::fill_n(depths.begin(), std::min(number_of_input_wires, number_of_wires), 0);
+  std::vector<std::vector<std::size_t>> layers;
+  for (std::size_t i = 0; i < operations.size(); ++i) {
+    const auto& operation{operations[i]};
+    std::size_t depth{0};
+    for (auto wire : operation.input_wires) {
+      if (wire >= number_of_wires || depths[wire] == kNotComputed) {
+        throw std::runtime_error(fmt::format(
+            "Arithmetic operation {} reads wire {}, which is not computed before", i, wire));
+      }
+      depth = std::max(depth, depths[wire]);
+    }
+    if (operation.output_wire >= number_of_wires ||
+        depths[operation.output_wire] != kNotComputed) {
+      throw std::runtime_error(fmt::format("Arithmetic operation {} cannot write wire {}", i,
+                                           operation.output_wire));
+    }
+    depths[operation.output_wire] = depth + 1;
+    if (layers.size() <= depth) layers.resize(depth + 1);
+    layers[depth].push_back(i);
+  }
+  for (std::size_t wire = number_of_wires - number_of_output_wires; wire < number_of_wires;
+       ++wire) {
+    if (depths[wire] == kNotComputed) {
+      throw std::runtime_error(fmt::format("Output wire {} is not computed", wire));
+    }
+  }
+  return layers;
+}
+
+namespace algorithm {
+
+namespace {
+
+// splits the output of a gate on number_of_instances SIMD-packed operands with number_of_simd
+// SIMD values each, see SimdBatch
+std::vector<ShareWrapper> Unpack(const ShareWrapper& packed, std::size_t number_of_instances,
+                                 std::size_t number_of_simd) {
+  std::vector<std::size_t> simd_begins(number_of_instances + 1);
+  for (std::size_t i = 0; i < simd_begins.size(); ++i) simd_begins[i] = i * number_of_simd;
+  return SimdBatch(packed, std::move(simd_begins)).Unsimdify();
+}
+
+// the public factors of the constant multiplications as a constant share with the SIMD values of
+// the packed operands
+template <typename T>
+ShareWrapper MakeConstants(const ShareWrapper& share, std::span<const std::uint64_t> constants,
+                           std::size_t number_of_simd) {
+  std::vector<T> values;
+  values.reserve(constants.size() * number_of_simd);
+  for (auto constant : constants) values.insert(values.end(), number_of_simd, T(constant));
+  return ShareWrapper(share->GetBackend().ConstantArithmeticGmwInput<T>(std::move(values)));
+}
+
+ShareWrapper MakeConstants(const ShareWrapper& share, std::span<const std::uint64_t> constants,
+                           std::size_t number_of_simd) {
+  switch (share->GetBitLength()) {
+    case 8u:
+      return MakeConstants<std::uint8_t>(share, constants, number_of_simd);
+    case 16u:
+      return MakeConstants<std::uint16_t>(share, constants, number_of_simd);
+    case 32u:
+      return MakeConstants<std::uint32_t>(share, constants, number_of_simd);
+    case 64u:
+      return MakeConstants<std::uint64_t>(share, constants, number_of_simd);
+    default:
+      throw std::invalid_argument(fmt::format(
+          "EvaluateArithmeticCircuit: unsupported bit length {}", share->GetBitLength()));
+  }
+}
+
+// sums the number_of_chunks consecutive chunks of chunk_size SIMD values of share, which are
+// folded in half in each round
+ShareWrapper SumChunks(ShareWrapper share, std::size_t number_of_chunks, std::size_t chunk_size) {
+  auto positions = [chunk_size](std::size_t begin, std::size_t end) {
+    std::vector<std::size_t> result((end - begin) * chunk_size);
+    std::iota(result.begin(), result.end(), begin * chunk_size);
+    return result;
+  };
+  while (number_of_chunks > 1) {
+    const std::size_t half{number_of_chunks / 2};
+    auto folded{share.Subset(positions(0, half)) + share.Subset(positions(half, 2 * half))};
+    // the last chunk of an odd number of chunks is kept
+    if (number_of_chunks % 2 == 1) {
+      folded = ShareWrapper::Simdify(std::vector<ShareWrapper>{
+          folded, share.Subset(positions(2 * half, number_of_chunks))});
+    }
+    share = std::move(folded);
+    number_of_chunks = half + number_of_chunks % 2;
+  }
+  return share;
+}
+
+// evaluates the operations of group, which have the same type and number of input wires, by one
+// gate on the SIMD-packed operands
+void EvaluateGroup(const ArithmeticAlgorithmDescription& circuit,
+                   std::span<const std::size_t> group, std::vector<ShareWrapper>& wires,
+                   std::size_t number_of_simd) {
+  const auto& first{circuit.operations[group.front()]};
+  // packs input wire position of all operations
+  auto pack = [&](std::size_t position) {
+    std::vector<ShareWrapper> column;
+    column.reserve(group.size());
+    for (auto i : group) column.emplace_back(wires[circuit.operations[i].input_wires[position]]);
+    return ShareWrapper::Simdify(column);
+  };
+
+  ShareWrapper result;
+  switch (first.type) {
+    case ArithmeticOperationType::kAdd:
+      result = pack(0) + pack(1);
+      break;
+    case ArithmeticOperationType::kSub:
+      result = pack(0) - pack(1);
+      break;
+    case ArithmeticOperationType::kMul:
+      result = pack(0) * pack(1);
+      break;
+    case ArithmeticOperationType::kConstantMul: {
+      auto a{pack(0)};
+      if (a->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+        throw std::invalid_argument(
+            "EvaluateArithmeticCircuit: constant multiplications are only supported for "
+            "arithmetic GMW shares");
+      }
+      std::vector<std::uint64_t> constants;
+      constants.reserve(group.size());
+      for (auto i : group) constants.push_back(circuit.operations[i].constant);
+      result = a * MakeConstants(a, constants, number_of_simd);
+      break;
+    }
+    case ArithmeticOperationType::kDot: {
+      const std::size_t length{first.input_wires.size() / 2};
+      if (wires[first.input_wires[0]]->GetProtocol() == MpcProtocol::kAstra) {
+        // element i of the vectors are the packed elements i of all dot products
+        std::vector<ShareWrapper> a, b;
+        for (std::size_t i = 0; i < length; ++i) {
+          a.emplace_back(pack(i));
+          b.emplace_back(pack(length + i));
+        }
+        result = encrypto::motion::DotProduct(a, b);
+      } else {
+        // the products of element i of all dot products are chunk i of a single multiplication
+        std::vector<ShareWrapper> a, b;
+        a.reserve(length * group.size());
+        b.reserve(length * group.size());
+        for (std::size_t i = 0; i < length; ++i) {
+          for (auto j : group) {
+            a.emplace_back(wires[circuit.operations[j].input_wires[i]]);
+            b.emplace_back(wires[circuit.operations[j].input_wires[length + i]]);
+          }
+        }
+        result = SumChunks(ShareWrapper::Simdify(a) * ShareWrapper::Simdify(b), length,
+                           group.size() * number_of_simd);
+      }
+      break;
+    }
+  }
+
+  const auto outputs{Unpack(result, group.size(), number_of_simd)};
+  for (std::size_t i = 0; i < group.size(); ++i) {
+    wires[circuit.operations[group[i]].output_wire] = outputs[i];
+  }
+}
+
+}  // namespace
+
+std::vector<ShareWrapper> EvaluateArithmeticCircuit(const ArithmeticAlgorithmDescription& circuit,
+                                                    std::span<const ShareWrapper> inputs) {
+  if (inputs.size() != circuit.number_of_input_wires) {
+    throw std::invalid_argument(
+        fmt::format("EvaluateArithmeticCircuit: expected {} inputs, got {}",
+                    circuit.number_of_input_wires, inputs.size()));
+  }
+  if (inputs.empty()) throw std::invalid_argument("EvaluateArithmeticCircuit: no inputs");
+  const auto protocol{inputs[0]->GetProtocol()};
+  const std::size_t number_of_simd{inputs[0]->GetNumberOfSimdValues()};
+  const std::size_t bit_length{inputs[0]->GetBitLength()};
+  for (const auto& input : inputs) {
+    if ((input->GetProtocol() != MpcProtocol::kArithmeticGmw &&
+         input->GetProtocol() != MpcProtocol::kAstra) ||
+        input->GetProtocol() != protocol || input->GetBitLength() != bit_length ||
+        input->GetNumberOfSimdValues() != number_of_simd) {
+      throw std::invalid_argument(
+          "EvaluateArithmeticCircuit: the inputs need to be arithmetic GMW or Astra shares of the "
+          "same protocol, bit length and number of SIMD values");
+    }
+  }
+  // SIMD-packed Astra shares can be split by an UnsimdifyGate, but not by a SubsetGate
+  const bool can_pack{protocol == MpcProtocol::kArithmeticGmw || number_of_simd == 1};
+
+  std::vector<ShareWrapper> wires(circuit.number_of_wires);
+  std::copy(inputs.begin(), inputs.end(), wires.begin());
+  for (const auto& layer : circuit.ComputeLayers()) {
+    // the operations of a layer by type and, for dot products, length
+    std::map<std::pair<ArithmeticOperationType, std::size_t>, std::vector<std::size_t>> groups;
+    for (auto i : layer) {
+      const auto& operation{circuit.operations[i]};
+      groups[{operation.type, operation.input_wires.size()}].push_back(i);
+    }
+    for (const auto& [type, group] : groups) {
+      if (can_pack) {
+        EvaluateGroup(circuit, group, wires, number_of_simd);
+      } else {
+        for (auto i : group) EvaluateGroup(circuit, std::span(&i, 1), wires, number_of_simd);
+      }
+    }
+  }
+  return std::vector<ShareWrapper>(wires.end() - circuit.number_of_output_wires, wires.end());
+}
+
+}  // namespace algorithm
+
+}  // namespace encrypto::motion
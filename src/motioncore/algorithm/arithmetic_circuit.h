@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion {
+
+enum class ArithmeticOperationType : std::uint8_t { kAdd, kSub, kMul, kConstantMul, kDot };
+
+std::string to_string(ArithmeticOperationType type);
+
+// An operation of an ArithmeticAlgorithmDescription on ring elements modulo 2^k
+struct ArithmeticOperation {
+  ArithmeticOperationType type{ArithmeticOperationType::kAdd};
+  // a and b for kAdd, kSub and kMul, a for kConstantMul, and a_0, ..., a_{n - 1}, b_0, ...,
+  // b_{n - 1} for the dot product kDot
+  std::vector<std::size_t> input_wires;
+  // the public factor of kConstantMul, which is reduced modulo 2^k
+  std::uint64_t constant{0};
+  std::size_t output_wire{0};
+};
+
+// Circuit over the ring Z/2^kZ, the arithmetic counterpart of AlgorithmDescription, e.g., a
+// linear layer of a neural network as one kDot per output neuron. The inputs are the wires
+// 0, ..., number_of_input_wires - 1 and the outputs the last number_of_output_wires wires.
+struct ArithmeticAlgorithmDescription {
+  ArithmeticAlgorithmDescription() = default;
+
+  // Reads a text file of the form
+  //   <number of operations> <number of wires>
+  //   <number of input wires> <number of output wires>
+  // followed by one operation per line, whose wires are given before the output wire:
+  //   ADD a b out, SUB a b out, MUL a b out, CMUL a constant out,
+  //   DOT n a_0 ... a_{n - 1} b_0 ... b_{n - 1} out
+  // Empty lines are skipped.
+  // \throws std::runtime_error if the file cannot be opened or is malformed
+  static ArithmeticAlgorithmDescription FromText(const std::string& path);
+
+  static ArithmeticAlgorithmDescription FromText(std::istream& stream);
+
+  // groups the operations into layers, such that the operations of a layer only depend on the
+  // inputs and on the outputs of previous layers
+  // \throws std::runtime_error if an operation reads a wire that is not an input and not computed
+  // by a previous operation, or if a wire is out of range or computed twice
+  std::vector<std::vector<std::size_t>> ComputeLayers() const;
+
+  std::size_t number_of_input_wires{0}, number_of_output_wires{0}, number_of_wires{0};
+  std::vector<ArithmeticOperation> operations;
+};
+
+namespace algorithm {
+
+// Evaluates the arithmetic circuit on arithmetic GMW or Astra shares, which hold one input wire
+// each and have the same number of SIMD values. The operations of a layer are evaluated by one gate
+// per type on the SIMD-packed operands, e.g., all multiplications of a layer by a single
+// MultiplicationGate, and the dot products of the same length by a single Astra DotProductGate or
+// an arithmetic GMW MultiplicationGate followed by a tree of additions. Constant multiplications
+// are only supported for arithmetic GMW shares.
+// \returns the shares of the output wires
+// \throws std::invalid_argument if the inputs do not match the circuit
+std::vector<ShareWrapper> EvaluateArithmeticCircuit(const ArithmeticAlgorithmDescription& circuit,
+                                                    std::span<const ShareWrapper> inputs);
+
+}  // namespace algorithm
+
+}  // namespace encrypto::motion
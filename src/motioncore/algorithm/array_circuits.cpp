@@ -0,0 +1,116 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "array_circuits.h"
+
+#include <bit>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "circuit_builder.h"
+
+namespace encrypto::motion::algorithm {
+
+using circuit_builder::Bits;
+using circuit_builder::CircuitBuilder;
+
+namespace {
+
+void CheckArrayDimensions(std::string_view name, std::size_t number_of_elements,
+                          std::size_t element_bit_length, std::size_t index_bit_length) {
+  if (number_of_elements == 0 || element_bit_length == 0 || index_bit_length == 0 ||
+      index_bit_length > 64 ||
+      index_bit_length < static_cast<std::size_t>(std::bit_width(number_of_elements - 1))) {
+    throw std::invalid_argument(fmt::format(
+        "{}: invalid array of {} elements of {} bits with a {}-bit index", name,
+        number_of_elements, element_bit_length, index_bit_length));
+  }
+}
+
+// the one-hot encoding of the index bits that can address one of the elements, where the upper
+// index bits have to be zero
+Bits ElementSelection(CircuitBuilder& builder, const Bits& index, std::size_t number_of_elements) {
+  const std::size_t number_of_used_bits{
+      std::max<std::size_t>(std::bit_width(number_of_elements - 1), 1)};
+  const Bits used_bits(index.begin(), index.begin() + number_of_used_bits);
+  Bits selection{OneHot(builder, used_bits, number_of_elements)};
+  if (number_of_used_bits < index.size()) {
+    const Bits upper_bits(index.begin() + number_of_used_bits, index.end());
+    const auto upper_is_zero{AndAll(builder, builder.Inv(upper_bits), true)};
+    for (auto& bit : selection) bit = builder.And(bit, upper_is_zero);
+  }
+  return selection;
+}
+
+}  // namespace
+
+AlgorithmDescription ArrayReadCircuit(std::size_t number_of_elements,
+                                      std::size_t element_bit_length,
+                                      std::size_t index_bit_length) {
+  CheckArrayDimensions("ArrayReadCircuit", number_of_elements, element_bit_length,
+                       index_bit_length);
+  CircuitBuilder builder(index_bit_length + number_of_elements * element_bit_length, 1);
+  const Bits inputs{builder.Operand(0)};
+  const Bits index(inputs.begin(), inputs.begin() + index_bit_length);
+  const Bits selection{ElementSelection(builder, index, number_of_elements)};
+  Bits element(element_bit_length);
+  for (std::size_t j = 0; j < number_of_elements; ++j) {
+    const std::size_t offset{index_bit_length + j * element_bit_length};
+    for (std::size_t i = 0; i < element_bit_length; ++i) {
+      const auto selected_bit{builder.And(selection[j], inputs[offset + i])};
+      element[i] = j == 0 ? selected_bit : builder.Xor(element[i], selected_bit);
+    }
+  }
+  return builder.Finish(element);
+}
+
+AlgorithmDescription ArrayWriteCircuit(std::size_t number_of_elements,
+                                       std::size_t element_bit_length,
+                                       std::size_t index_bit_length) {
+  CheckArrayDimensions("ArrayWriteCircuit", number_of_elements, element_bit_length,
+                       index_bit_length);
+  CircuitBuilder builder(index_bit_length + (number_of_elements + 1) * element_bit_length, 1);
+  const Bits inputs{builder.Operand(0)};
+  const Bits index(inputs.begin(), inputs.begin() + index_bit_length);
+  const Bits value(inputs.begin() + index_bit_length,
+                   inputs.begin() + index_bit_length + element_bit_length);
+  const Bits selection{ElementSelection(builder, index, number_of_elements)};
+  Bits elements(number_of_elements * element_bit_length);
+  for (std::size_t j = 0; j < number_of_elements; ++j) {
+    for (std::size_t i = 0; i < element_bit_length; ++i) {
+      const auto bit{inputs[index_bit_length + (j + 1) * element_bit_length + i]};
+      // selection ? value : bit
+      elements[j * element_bit_length + i] = builder.Mux(selection[j], value[i], bit);
+    }
+  }
+  return builder.Finish(elements);
+}
+
+AlgorithmDescription OneHotCircuit(std::size_t number_of_outputs, std::size_t index_bit_length) {
+  CheckArrayDimensions("OneHotCircuit", number_of_outputs, 1, index_bit_length);
+  CircuitBuilder builder(index_bit_length, 1);
+  return builder.Finish(ElementSelection(builder, builder.Operand(0), number_of_outputs));
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,58 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+
+#include <cstddef>
+
+#include "algorithm_description.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief creates the Boolean circuit of the element at a secret index of an array of
+/// number_of_elements elements of element_bit_length bits by a linear scan. The input wires of
+/// parent a are the index_bit_length bits of the index followed by the bits of the elements, the
+/// element j at the wires index_bit_length + j * element_bit_length, ... with the least
+/// significant bit first. The output wires are the XOR of the ANDs of the elements with the
+/// one-hot encoding of the index, i.e., 0 for an index >= number_of_elements.
+/// \throws std::invalid_argument if an argument is 0 or index_bit_length is too small for the
+/// indices of the elements or larger than 64.
+AlgorithmDescription ArrayReadCircuit(std::size_t number_of_elements,
+                                      std::size_t element_bit_length, std::size_t index_bit_length);
+
+/// \brief creates the Boolean circuit that writes a value to the array of ArrayReadCircuit at a
+/// secret index. The input wires of parent a are the index, the element_bit_length bits of the
+/// value and the elements, the output wires are the elements after the write, which are
+/// unchanged for an index >= number_of_elements.
+/// \throws std::invalid_argument like ArrayReadCircuit.
+AlgorithmDescription ArrayWriteCircuit(std::size_t number_of_elements,
+                                       std::size_t element_bit_length,
+                                       std::size_t index_bit_length);
+
+/// \brief creates the Boolean circuit of the one-hot encoding [x == j] for j = 0, ...,
+/// number_of_outputs - 1 of the index_bit_length-bit input x of parent a, e.g., the bin indicators
+/// of a histogram, which are all 0 for x >= number_of_outputs.
+/// \throws std::invalid_argument like ArrayReadCircuit with number_of_outputs elements.
+AlgorithmDescription OneHotCircuit(std::size_t number_of_outputs, std::size_t index_bit_length);
+
+}  // namespace encrypto::motion::algorithm
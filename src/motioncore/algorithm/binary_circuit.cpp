@@ -0,0 +1,187 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "binary_circuit.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+namespace {
+
+static_assert(sizeof(BinaryCircuitHeader) == 56);
+static_assert(sizeof(BinaryCircuitGate) == 20);
+
+bool IsSupportedType(PrimitiveOperationType type) {
+  switch (type) {
+    case PrimitiveOperationType::kXor:
+    case PrimitiveOperationType::kAnd:
+    case PrimitiveOperationType::kOr:
+    case PrimitiveOperationType::kInv:
+    case PrimitiveOperationType::kMux:
+    case PrimitiveOperationType::kAdd:
+    case PrimitiveOperationType::kMul:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+void WriteBinaryCircuit(const AlgorithmDescription& algorithm, const std::filesystem::path& path) {
+  if (algorithm.number_of_wires >= kBinaryCircuitNoWire) {
+    throw std::invalid_argument(fmt::format(
+        "Cannot write a binary circuit with {} wires, which do not fit into 32 bits",
+        algorithm.number_of_wires));
+  }
+  BinaryCircuitHeader header{
+      .magic = kBinaryCircuitMagic,
+      .version = kBinaryCircuitVersion,
+      .has_parent_b = algorithm.number_of_input_wires_parent_b.has_value(),
+      .number_of_gates = algorithm.gates.size(),
+      .number_of_wires = algorithm.number_of_wires,
+      .number_of_input_wires_parent_a = algorithm.number_of_input_wires_parent_a,
+      .number_of_input_wires_parent_b = algorithm.number_of_input_wires_parent_b.value_or(0),
+      .number_of_output_wires = algorithm.number_of_output_wires};
+
+  std::vector<BinaryCircuitGate> gates(algorithm.gates.size());
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    const auto& operation{algorithm.gates[i]};
+    if (!IsSupportedType(operation.type)) {
+      throw std::invalid_argument(fmt::format("Cannot write gate #{} of type {}", i,
+                                              static_cast<unsigned>(operation.type)));
+    }
+    gates[i] = {.type = operation.type,
+                .padding = {},
+                .parent_a = static_cast<std::uint32_t>(operation.parent_a),
+                .parent_b = static_cast<std::uint32_t>(
+                    operation.parent_b.value_or(kBinaryCircuitNoWire)),
+                .selection_bit = static_cast<std::uint32_t>(
+                    operation.selection_bit.value_or(kBinaryCircuitNoWire)),
+                .output_wire = static_cast<std::uint32_t>(operation.output_wire)};
+  }
+
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  stream.write(reinterpret_cast<const char*>(gates.data()),
+               gates.size() * sizeof(BinaryCircuitGate));
+  if (!stream) {
+    throw std::runtime_error(fmt::format("cannot write binary circuit {}", path.string()));
+  }
+}
+
+MappedBinaryCircuit::MappedBinaryCircuit(const std::filesystem::path& path) {
+  const int file_descriptor{open(path.c_str(), O_RDONLY)};
+  if (file_descriptor == -1) {
+    throw std::runtime_error(fmt::format("cannot open binary circuit {}: {}", path.string(),
+                                         std::strerror(errno)));
+  }
+  try {
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) == -1) {
+      throw std::runtime_error(fmt::format("cannot stat binary circuit {}: {}", path.string(),
+                                           std::strerror(errno)));
+    }
+    size_ = file_status.st_size;
+    if (size_ < sizeof(BinaryCircuitHeader)) {
+      throw std::runtime_error(
+          fmt::format("{} is too small to be a binary circuit", path.string()));
+    }
+    void* address{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0)};
+    if (address == MAP_FAILED) {
+      throw std::runtime_error(fmt::format("cannot map binary circuit {}: {}", path.string(),
+                                           std::strerror(errno)));
+    }
+    address_ = address;
+    // the gates are read once from the front to the back
+    madvise(address_, size_, MADV_SEQUENTIAL);
+    madvise(address_, size_, MADV_WILLNEED);
+    header_ = static_cast<const BinaryCircuitHeader*>(address_);
+
+    if (header_->magic != kBinaryCircuitMagic) {
+      throw std::runtime_error(fmt::format("{} is not a binary circuit", path.string()));
+    }
+    if (header_->version != kBinaryCircuitVersion) {
+      throw std::runtime_error(
+          fmt::format("Binary circuit {} has version {}, but version {} is supported",
+                      path.string(), header_->version, kBinaryCircuitVersion));
+    }
+    if ((size_ - sizeof(BinaryCircuitHeader)) / sizeof(BinaryCircuitGate) !=
+            header_->number_of_gates ||
+        (size_ - sizeof(BinaryCircuitHeader)) % sizeof(BinaryCircuitGate) != 0) {
+      throw std::runtime_error(fmt::format("Binary circuit {} of {} gates has {} bytes",
+                                           path.string(), header_->number_of_gates, size_));
+    }
+    gates_ = std::span(reinterpret_cast<const BinaryCircuitGate*>(
+                           static_cast<const std::byte*>(address_) + sizeof(BinaryCircuitHeader)),
+                       header_->number_of_gates);
+  } catch (...) {
+    if (address_) munmap(address_, size_);
+    close(file_descriptor);
+    throw;
+  }
+  // the mapping stays valid after the file is closed
+  close(file_descriptor);
+}
+
+MappedBinaryCircuit::~MappedBinaryCircuit() { munmap(address_, size_); }
+
+AlgorithmDescription MappedBinaryCircuit::ToAlgorithmDescription() const {
+  AlgorithmDescription algorithm;
+  algorithm.number_of_gates = header_->number_of_gates;
+  algorithm.number_of_wires = header_->number_of_wires;
+  algorithm.number_of_input_wires_parent_a = header_->number_of_input_wires_parent_a;
+  if (header_->has_parent_b) {
+    algorithm.number_of_input_wires_parent_b = header_->number_of_input_wires_parent_b;
+  }
+  algorithm.number_of_output_wires = header_->number_of_output_wires;
+
+  algorithm.gates.resize(gates_.size());
+  for (std::size_t i = 0; i < gates_.size(); ++i) {
+    const auto& gate{gates_[i]};
+    if (!IsSupportedType(gate.type)) {
+      throw std::runtime_error(
+          fmt::format("Gate #{} of the binary circuit has the unknown type {}", i,
+                      static_cast<unsigned>(gate.type)));
+    }
+    auto& operation{algorithm.gates[i]};
+    operation.type = gate.type;
+    operation.parent_a = gate.parent_a;
+    if (gate.parent_b != kBinaryCircuitNoWire) operation.parent_b = gate.parent_b;
+    if (gate.selection_bit != kBinaryCircuitNoWire) operation.selection_bit = gate.selection_bit;
+    operation.output_wire = gate.output_wire;
+  }
+  return algorithm;
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <span>
+
+#include "algorithm_description.h"
+
+namespace encrypto::motion {
+
+// Header of a binary circuit file, which is followed by number_of_gates BinaryCircuitGate records.
+// All values are stored in the byte order of the host, i.e., little endian on x86.
+struct BinaryCircuitHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  // 1 if number_of_input_wires_parent_b is present, 0 otherwise
+  std::uint32_t has_parent_b;
+  std::uint64_t number_of_gates;
+  std::uint64_t number_of_wires;
+  std::uint64_t number_of_input_wires_parent_a;
+  std::uint64_t number_of_input_wires_parent_b;
+  std::uint64_t number_of_output_wires;
+};
+
+// Marks the absent second parent or selection bit of a BinaryCircuitGate
+inline constexpr std::uint32_t kBinaryCircuitNoWire{std::numeric_limits<std::uint32_t>::max()};
+
+// A PrimitiveOperation with 32-bit wire indices in 20 instead of 48 bytes
+struct BinaryCircuitGate {
+  PrimitiveOperationType type;
+  std::array<std::uint8_t, 3> padding;
+  std::uint32_t parent_a;
+  std::uint32_t parent_b;
+  std::uint32_t selection_bit;
+  std::uint32_t output_wire;
+};
+
+inline constexpr std::array<char, 8> kBinaryCircuitMagic{'M', 'O', 'T', 'I', 'O', 'N', 'B', 'C'};
+inline constexpr std::uint32_t kBinaryCircuitVersion{1};
+
+// Writes the algorithm as a binary circuit file, e.g., to convert a Bristol circuit once offline
+// throws std::invalid_argument if the wires do not fit into 32 bits and std::runtime_error if the
+// file cannot be written
+void WriteBinaryCircuit(const AlgorithmDescription& algorithm, const std::filesystem::path& path);
+
+// Read-only memory mapping of a binary circuit file, whose gates are used in place without parsing
+class MappedBinaryCircuit {
+ public:
+  // throws std::runtime_error if the file cannot be mapped or is not a binary circuit of this
+  // version
+  explicit MappedBinaryCircuit(const std::filesystem::path& path);
+  ~MappedBinaryCircuit();
+
+  MappedBinaryCircuit(const MappedBinaryCircuit&) = delete;
+  MappedBinaryCircuit& operator=(const MappedBinaryCircuit&) = delete;
+
+  const BinaryCircuitHeader& GetHeader() const noexcept { return *header_; }
+
+  std::span<const BinaryCircuitGate> GetGates() const noexcept { return gates_; }
+
+  // throws std::runtime_error if a gate has an unknown type
+  AlgorithmDescription ToAlgorithmDescription() const;
+
+ private:
+  void* address_{nullptr};
+  std::size_t size_{0};
+  const BinaryCircuitHeader* header_{nullptr};
+  std::span<const BinaryCircuitGate> gates_;
+};
+
+}  // namespace encrypto::motion
@@ -25,13 +25,194 @@
 #include "boolean_algorithms.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
-#include <cmath>
+#include <functional>
+#include <stdexcept>
 
+#include <fmt/format.h>
+
+#include "algorithm/low_depth_reduce.h"
 #include "protocols/share.h"
+#include "protocols/share_view.h"
 
 namespace encrypto::motion::algorithm {
 
+namespace {
+
+// splits the output of a gate on the SIMD-packed inputs into the outputs of the instances, which
+// have the SIMD values of the inputs, see SimdBatch
+std::vector<ShareWrapper> Unpack(const ShareWrapper& packed, std::span<const ShareView> inputs) {
+  std::vector<std::size_t> simd_begins{0};
+  simd_begins.reserve(inputs.size() + 1);
+  for (auto& input : inputs) {
+    simd_begins.push_back(simd_begins.back() + input.GetNumberOfSimdValues());
+  }
+  return SimdBatch(packed, std::move(simd_begins)).Unsimdify();
+}
+
+// moves the shares to gate_outputs, which keeps them alive, and returns views of them
+std::vector<ShareView> Keep(std::vector<ShareWrapper>&& shares,
+                            std::vector<ShareWrapper>& gate_outputs) {
+  std::vector<ShareView> views;
+  views.reserve(shares.size());
+  for (auto& share : shares) {
+    views.emplace_back(share.View());
+    gate_outputs.emplace_back(std::move(share));
+  }
+  return views;
+}
+
+// evaluates operation(a[i], b[i]) for all i by a single gate on the SIMD-packed inputs
+template <typename Operation>
+std::vector<ShareView> PackedOperation(std::span<const ShareView> a, std::span<const ShareView> b,
+                                       Operation operation,
+                                       std::vector<ShareWrapper>& gate_outputs) {
+  assert(a.size() == b.size());
+  if (a.empty()) return {};
+  return Keep(Unpack(operation(ShareWrapper::Simdify(a), ShareWrapper::Simdify(b)), a),
+              gate_outputs);
+}
+
+// adds the columns, which hold at most two bits of weight 2^c each, and carry_in, which may hold
+// no share, by a Kogge-Stone adder. The ANDs and XORs of a round are single gates on the
+// SIMD-packed bits, such that the adder has ceil(log2(columns.size() + 1)) + 1 rounds. Missing
+// bits, e.g., the propagate of a column with a single bit, are known to be zero and hold no share.
+// All bits are views, such that only the outputs of the gates are shares. Returns the
+// concatenation of the columns.size() sum bits and the carry out if with_carry_out is true.
+ShareWrapper PrefixAdder(std::span<const std::vector<ShareView>> columns, ShareView carry_in,
+                         bool with_carry_out) {
+  std::vector<ShareWrapper> gate_outputs;
+  // position 0 is the carry in, position c + 1 is column c
+  const std::size_t number_of_positions{columns.size() + 1};
+  std::vector<ShareView> propagate(number_of_positions), generate(number_of_positions);
+  generate[0] = carry_in;
+
+  std::vector<ShareView> operands_a, operands_b;
+  std::vector<std::size_t> targets;
+  for (std::size_t c = 0; c < columns.size(); ++c) {
+    assert(columns[c].size() <= 2);
+    if (columns[c].size() == 1) {
+      propagate[c + 1] = columns[c][0];
+    } else if (columns[c].size() == 2) {
+      operands_a.emplace_back(columns[c][0]);
+      operands_b.emplace_back(columns[c][1]);
+      targets.push_back(c + 1);
+    }
+  }
+  auto xors{PackedOperation(operands_a, operands_b, std::bit_xor<>(), gate_outputs)};
+  auto ands{PackedOperation(operands_a, operands_b, std::bit_and<>(), gate_outputs)};
+  for (std::size_t i = 0; i < targets.size(); ++i) {
+    propagate[targets[i]] = xors[i];
+    generate[targets[i]] = ands[i];
+  }
+
+  // the sum of column c needs the group generate of the positions 0, ..., c, the carry out the one
+  // of all positions
+  const std::size_t number_of_generates{with_carry_out ? number_of_positions
+                                                       : number_of_positions - 1};
+  std::vector<ShareView> group_propagate(propagate.begin(),
+                                         propagate.begin() + number_of_generates);
+  group_propagate[0] = ShareView();
+  // after the round with distance d, generate[j] and group_propagate[j] cover the positions
+  // max(0, j - 2d + 1), ..., j, see KoggeStoneAdditionCircuit
+  for (std::size_t d = 1; d < number_of_generates; d *= 2) {
+    operands_a.clear();
+    operands_b.clear();
+    std::vector<std::size_t> generate_targets, propagate_targets;
+    for (std::size_t j = d; j < number_of_generates; ++j) {
+      if (group_propagate[j] && generate[j - d]) {
+        operands_a.emplace_back(group_propagate[j]);
+        operands_b.emplace_back(generate[j - d]);
+        generate_targets.push_back(j);
+      }
+    }
+    // the group propagate of j < 2d is not used by the following rounds
+    for (std::size_t j = 2 * d; j < number_of_generates; ++j) {
+      if (group_propagate[j] && group_propagate[j - d]) {
+        operands_a.emplace_back(group_propagate[j]);
+        operands_b.emplace_back(group_propagate[j - d]);
+        propagate_targets.push_back(j);
+      }
+    }
+    const auto products{PackedOperation(operands_a, operands_b, std::bit_and<>(), gate_outputs)};
+
+    std::vector<ShareView> next_propagate(group_propagate.size());
+    std::copy_n(group_propagate.begin(), std::min(2 * d, group_propagate.size()),
+                next_propagate.begin());
+    for (std::size_t i = 0; i < propagate_targets.size(); ++i) {
+      next_propagate[propagate_targets[i]] = products[generate_targets.size() + i];
+    }
+    group_propagate = std::move(next_propagate);
+
+    // the carried generates are XORed to the generates that are not missing in a single gate
+    operands_a.clear();
+    operands_b.clear();
+    targets.clear();
+    for (std::size_t i = 0; i < generate_targets.size(); ++i) {
+      auto& target{generate[generate_targets[i]]};
+      if (target) {
+        operands_a.emplace_back(target);
+        operands_b.emplace_back(products[i]);
+        targets.push_back(generate_targets[i]);
+      } else {
+        target = products[i];
+      }
+    }
+    xors = PackedOperation(operands_a, operands_b, std::bit_xor<>(), gate_outputs);
+    for (std::size_t i = 0; i < targets.size(); ++i) generate[targets[i]] = xors[i];
+  }
+
+  // the sum of a column is missing only if it is always zero, which cannot be represented
+  std::vector<ShareView> sum(columns.size());
+  operands_a.clear();
+  operands_b.clear();
+  targets.clear();
+  for (std::size_t c = 0; c < columns.size(); ++c) {
+    if (propagate[c + 1] && generate[c]) {
+      operands_a.emplace_back(propagate[c + 1]);
+      operands_b.emplace_back(generate[c]);
+      targets.push_back(c);
+    } else {
+      sum[c] = propagate[c + 1] ? propagate[c + 1] : generate[c];
+      assert(sum[c]);
+    }
+  }
+  xors = PackedOperation(operands_a, operands_b, std::bit_xor<>(), gate_outputs);
+  for (std::size_t i = 0; i < targets.size(); ++i) sum[targets[i]] = xors[i];
+  if (with_carry_out) {
+    assert(generate.back());
+    sum.emplace_back(generate.back());
+  }
+  return ShareWrapper::Concatenate(sum);
+}
+
+// views the single-wire shares
+std::vector<ShareView> ViewBits(std::span<const ShareWrapper> bits) {
+  std::vector<ShareView> views;
+  views.reserve(bits.size());
+  for (const auto& bit : bits) views.emplace_back(bit.View());
+  return views;
+}
+
+// views the wires of the bit string
+std::vector<ShareView> ViewBits(const ShareWrapper& bit_string) {
+  const auto bit_string_view{bit_string.View()};
+  std::vector<ShareView> views;
+  views.reserve(bit_string_view.GetNumberOfWires());
+  for (std::size_t i = 0; i < bit_string_view.GetNumberOfWires(); ++i) {
+    views.emplace_back(bit_string_view.GetWire(i));
+  }
+  return views;
+}
+
+ShareView ViewOrEmpty(const ShareWrapper& share) {
+  return share.Get() ? share.View() : ShareView();
+}
+
+}  // namespace
+
 std::pair<ShareWrapper, ShareWrapper> FullAdder(const ShareWrapper& a, const ShareWrapper& b,
                                                 const ShareWrapper& carry) {
   for (auto& s [[maybe_unused]] : {a, b, carry}) assert(s->GetBitLength() == 1);
@@ -45,81 +226,162 @@ std::pair<ShareWrapper, ShareWrapper> FullAdder(const ShareWrapper& a, const Sha
 
 ShareWrapper AdderChain(const ShareWrapper& bit_string_0, const ShareWrapper& bit_string_1,
                         const ShareWrapper& carry_in) {
-  std::vector<ShareWrapper> bits_0{bit_string_0.Split()};
-  std::vector<ShareWrapper> bits_1{bit_string_1.Split()};
-  return AdderChain(bits_0, bits_1, carry_in);
+  return AdderChain(ViewBits(bit_string_0), ViewBits(bit_string_1), carry_in);
 }
 
 ShareWrapper AdderChain(std::span<const ShareWrapper> bits_0, std::span<const ShareWrapper> bits_1,
                         const ShareWrapper& carry_in) {
-  if (!bits_0.empty()) assert(bits_0[0]->GetCircuitType() == CircuitType::kBoolean);
-  if (!bits_1.empty()) assert(bits_1[0]->GetCircuitType() == CircuitType::kBoolean);
+  return AdderChain(ViewBits(bits_0), ViewBits(bits_1), carry_in);
+}
+
+ShareWrapper AdderChain(std::span<const ShareView> bits_0, std::span<const ShareView> bits_1,
+                        const ShareWrapper& carry_in) {
+  if (!bits_0.empty()) assert(bits_0[0].GetShare().GetCircuitType() == CircuitType::kBoolean);
+  if (!bits_1.empty()) assert(bits_1[0].GetShare().GetCircuitType() == CircuitType::kBoolean);
   assert(!bits_0.empty() || !bits_1.empty());
 
   // inlining seems to be causing constexpr retrieval of size which yields the extent and not the
   // actual runtime size, i.e., max std::size
   // not sure how to avoid it in a more elegant way...
   std::size_t bits_0_length = bits_0.size(), bits_1_length = bits_1.size();
-  auto [min_length, max_length] = std::minmax(bits_0_length, bits_1_length);
-
-  // allocate wires
-  std::vector<ShareWrapper> result_wires(max_length + 1);
-
-  // compute the output wires using full adders for bit strings of equal size
-  ShareWrapper carry{carry_in};
-  std::size_t i = 0;
-  for (; i < min_length; ++i) {
-    std::tie(result_wires[i], carry) = FullAdder(bits_0[i], bits_1[i], carry);
-  }
-
-  // if shares are of unequal size, compute the remaining part using only the longer share
-  std::span<const ShareWrapper> long_share{bits_0.size() > bits_1.size() ? bits_0 : bits_1};
-
-  for (; i < max_length; ++i) {
-    result_wires[i] = long_share[i] ^ carry;
-    carry = long_share[i] & carry;
+  std::vector<std::vector<ShareView>> columns(std::max(bits_0_length, bits_1_length));
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    if (i < bits_0_length) columns[i].emplace_back(bits_0[i]);
+    if (i < bits_1_length) columns[i].emplace_back(bits_1[i]);
   }
 
-  // save the carry bit for the case of an overflow
-  result_wires.back() = carry;
-
-  // concatenate wires into a single share
-  return ShareWrapper::Concatenate(result_wires);
+  // the carry out is saved for the case of an overflow
+  return PrefixAdder(columns, ViewOrEmpty(carry_in), true);
 }
 
 ShareWrapper HammingWeight(const ShareWrapper& bit_string) {
-  std::vector<ShareWrapper> bits{bit_string.Split()};
-  return HammingWeight(bits);
+  return HammingWeight(ViewBits(bit_string));
 }
 
 ShareWrapper HammingWeight(std::span<const ShareWrapper> bits) {
+  return HammingWeight(ViewBits(bits));
+}
+
+ShareWrapper HammingWeight(std::span<const ShareView> bits) {
   if (bits.size() == 0) {
     return ShareWrapper(nullptr);
   } else if (bits.size() == 1) {
     // HW(bit) = bit
-    return bits[0];
-  } else if (bits.size() == 2) {
-    // return {sum (0th pos.), carry (1st pos.)}
-    return ShareWrapper::Concatenate({bits[0] ^ bits[1], bits[0] & bits[1]});
-  } else if (bits.size() == 3) {
-    // use full adder
-    // FullAdder returns
-    auto [sum, carry] = FullAdder(bits[0], bits[1], bits[2]);
-    return ShareWrapper::Concatenate({sum, carry});
-  } else {  // bits.size() > 3
-    // split the input bit string into three parts: v, u and i
-    // length of v is the largest possible power of two - 1, e.g., 3, 7, 15, etc
-    // length of u is total length - length of v - 1
-    // length of i is always 1
-    size_t length_v{static_cast<std::size_t>(std::pow(2, std::floor(log2(bits.size())))) - 1};
-    size_t length_u{bits.size() - length_v - 1};
-
-    auto v{bits.first(length_v)};
-    auto u{bits.subspan(length_v, length_u)};
-    ShareWrapper i{bits.back()};
-
-    return AdderChain(HammingWeight(v), HammingWeight(u), i);
+    return ShareWrapper::Concatenate(bits);
   }
+  assert(bits[0].GetShare().GetCircuitType() == CircuitType::kBoolean);
+
+  // column c holds the bits of weight 2^c, whose sum is the Hamming weight. Bits of weight
+  // 2^bit_width(n) or more are always zero, because the sum is at most n.
+  const std::size_t bits_size = bits.size();
+  std::vector<std::vector<ShareView>> columns(std::bit_width(bits_size));
+  columns[0].assign(bits.begin(), bits.end());
+  std::vector<ShareWrapper> gate_outputs;
+
+  // Wallace tree: each level replaces every three bits of a column by their sum in the same and
+  // their carry in the next column, until at most two bits are left per column. The full adders
+  // of a level are a single full adder on the SIMD-packed bits, i.e., there are
+  // O(log(n)) levels of AND depth 1 instead of the O(n) depth of a chain of AdderChains.
+  auto tallest = [&columns]() {
+    return std::max_element(columns.begin(), columns.end(),
+                            [](const auto& a, const auto& b) { return a.size() < b.size(); })
+        ->size();
+  };
+  while (tallest() > 2) {
+    std::array<std::vector<ShareView>, 3> operands;
+    std::vector<std::size_t> adder_columns;
+    std::vector<std::vector<ShareView>> next_columns(columns.size());
+    for (std::size_t c = 0; c < columns.size(); ++c) {
+      std::size_t i = 0;
+      for (; i + 3 <= columns[c].size(); i += 3) {
+        for (std::size_t k = 0; k < 3; ++k) operands[k].emplace_back(columns[c][i + k]);
+        adder_columns.push_back(c);
+      }
+      // the remaining bits are not delayed by this level
+      next_columns[c].assign(columns[c].begin() + i, columns[c].end());
+    }
+    auto [sum, carry] =
+        FullAdder(ShareWrapper::Simdify(operands[0]), ShareWrapper::Simdify(operands[1]),
+                  ShareWrapper::Simdify(operands[2]));
+    const auto sums{Keep(Unpack(sum, operands[0]), gate_outputs)};
+    const auto carries{Keep(Unpack(carry, operands[0]), gate_outputs)};
+    for (std::size_t i = 0; i < adder_columns.size(); ++i) {
+      const std::size_t c{adder_columns[i]};
+      next_columns[c].emplace_back(sums[i]);
+      if (c + 1 < next_columns.size()) next_columns[c + 1].emplace_back(carries[i]);
+    }
+    columns = std::move(next_columns);
+  }
+
+  return PrefixAdder(columns, ShareView(), false);
+}
+
+AlgorithmDescription KoggeStoneAdditionCircuit(std::size_t number_of_operands,
+                                               std::size_t bit_length) {
+  if (number_of_operands < 2 || bit_length == 0) {
+    throw std::invalid_argument(
+        fmt::format("KoggeStoneAdditionCircuit: cannot add {} operands of {} bits",
+                    number_of_operands, bit_length));
+  }
+  AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = number_of_operands * bit_length;
+  // appends a gate and returns its output wire
+  auto emplace_gate = [&algorithm](PrimitiveOperationType type, std::size_t a, std::size_t b) {
+    const std::size_t output_wire{algorithm.number_of_input_wires_parent_a +
+                                  algorithm.gates.size()};
+    algorithm.gates.emplace_back(PrimitiveOperation{type, a, b, std::nullopt, output_wire});
+    return output_wire;
+  };
+
+  using Operand = std::vector<std::size_t>;
+  std::vector<Operand> operands(number_of_operands, Operand(bit_length));
+  for (std::size_t operand_i = 0; operand_i < number_of_operands; ++operand_i) {
+    for (std::size_t bit_i = 0; bit_i < bit_length; ++bit_i) {
+      operands[operand_i][bit_i] = operand_i * bit_length + bit_i;
+    }
+  }
+
+  auto add = [&emplace_gate, bit_length](const Operand& a, const Operand& b) {
+    constexpr auto kXor{PrimitiveOperationType::kXor};
+    constexpr auto kAnd{PrimitiveOperationType::kAnd};
+    // the carry into bit i + 1 is the group generate of bits 0, ..., i, so only the bit_length - 1
+    // lower bits generate carries
+    Operand propagate(bit_length), generate(bit_length - 1);
+    for (std::size_t i = 0; i < bit_length; ++i) propagate[i] = emplace_gate(kXor, a[i], b[i]);
+    for (std::size_t i = 0; i + 1 < bit_length; ++i) generate[i] = emplace_gate(kAnd, a[i], b[i]);
+
+    // parallel prefix: after the round with distance d, generate[j] and group_propagate[j] cover
+    // the bits max(0, j - 2d + 1), ..., j. Generate and propagate of a group are exclusive, hence
+    // the OR of the carry operator is an XOR.
+    Operand group_propagate(propagate.begin(), propagate.end() - 1);
+    for (std::size_t d = 1; d < generate.size(); d *= 2) {
+      Operand next_generate{generate}, next_propagate{group_propagate};
+      for (std::size_t j = d; j < generate.size(); ++j) {
+        const auto carried{emplace_gate(kAnd, group_propagate[j], generate[j - d])};
+        next_generate[j] = emplace_gate(kXor, generate[j], carried);
+      }
+      // the group propagate of j < 2d is not used by the following rounds
+      for (std::size_t j = 2 * d; j < group_propagate.size(); ++j) {
+        next_propagate[j] = emplace_gate(kAnd, group_propagate[j], group_propagate[j - d]);
+      }
+      generate = std::move(next_generate);
+      group_propagate = std::move(next_propagate);
+    }
+
+    // the sum is emplaced last, such that the final sum are the output wires of the circuit
+    Operand sum(bit_length);
+    sum[0] = emplace_gate(kXor, a[0], b[0]);
+    for (std::size_t i = 1; i < bit_length; ++i) {
+      sum[i] = emplace_gate(kXor, propagate[i], generate[i - 1]);
+    }
+    return sum;
+  };
+  LowDepthReduce(std::move(operands), add);
+
+  algorithm.number_of_gates = algorithm.gates.size();
+  algorithm.number_of_wires = algorithm.number_of_input_wires_parent_a + algorithm.number_of_gates;
+  algorithm.number_of_output_wires = bit_length;
+  return algorithm;
 }
 
 }  // namespace encrypto::motion::algorithm
\ No newline at end of file
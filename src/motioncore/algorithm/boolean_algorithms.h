@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include "algorithm/algorithm_description.h"
+#include "protocols/share_view.h"
 #include "protocols/share_wrapper.h"
 
 namespace encrypto::motion::algorithm {
@@ -41,15 +43,41 @@ std::pair<ShareWrapper, ShareWrapper> FullAdder(const ShareWrapper& bit_0,
                                                 const ShareWrapper& bit_1,
                                                 const ShareWrapper& carry);
 
-/// \brief
+/// \brief adds two bit strings and a carry bit, whose bits are given least significant bit first.
+/// The adder is a Kogge-Stone adder, whose ANDs and XORs of a round are a single gate on the
+/// SIMD-packed bits, i.e., it has an AND depth of ceil(log2(max_length + 1)) + 1 instead of the
+/// max_length of a chain of FullAdders.
+/// \returns the sum of max_length + 1 bits, where max_length is the length of the longer string
 ShareWrapper AdderChain(const ShareWrapper& bit_string_0, const ShareWrapper& bit_string_1,
                         const ShareWrapper& carry_in);
 
 ShareWrapper AdderChain(std::span<const ShareWrapper> bits_0, std::span<const ShareWrapper> bits_1,
                         const ShareWrapper& carry_in);
 
+/// \brief adds the viewed bits without creating a share per input bit, see ShareView.
+ShareWrapper AdderChain(std::span<const ShareView> bits_0, std::span<const ShareView> bits_1,
+                        const ShareWrapper& carry_in);
+
+/// \brief counts the bits that are one. The bits are reduced by a Wallace tree of carry-save
+/// FullAdders, all of whose full adders of a level are evaluated as one full adder on the
+/// SIMD-packed bits, followed by the logarithmic depth adder of AdderChain. The AND depth is
+/// O(log(n)) for n bits, and the number of gates per level does not depend on n.
+/// \returns the Hamming weight of bit_width(n) bits, least significant bit first, or a
+/// ShareWrapper without a share if there are no bits
 ShareWrapper HammingWeight(const ShareWrapper& bit_string);
 
 ShareWrapper HammingWeight(std::span<const ShareWrapper> bits);
 
+/// \brief counts the viewed bits that are one without creating a share per input bit.
+ShareWrapper HammingWeight(std::span<const ShareView> bits);
+
+/// \brief creates a Boolean circuit that adds number_of_operands operands of bit_length bits
+/// modulo 2^bit_length. The operands are the consecutive input wires, the sum consists of the
+/// last bit_length wires. Pairs of operands are added tree-wise by Kogge-Stone adders like
+/// LowDepthReduce, such that the AND depth is ceil(log2(number_of_operands)) *
+/// (ceil(log2(bit_length - 1)) + 1) instead of the linear depth of AdderChain.
+/// \throws std::invalid_argument if there are less than two operands or bit_length is 0.
+AlgorithmDescription KoggeStoneAdditionCircuit(std::size_t number_of_operands,
+                                               std::size_t bit_length);
+
 }  // namespace encrypto::motion::algorithm
\ No newline at end of file
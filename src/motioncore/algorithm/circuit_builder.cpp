@@ -0,0 +1,286 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "circuit_builder.h"
+
+namespace encrypto::motion::algorithm::circuit_builder {
+
+Bits RippleCarryAdd(CircuitBuilder& builder, const Bits& a, const Bits& b, bool with_carry_out) {
+  const std::size_t n{a.size()};
+  Bits sum(n);
+  sum[0] = builder.Xor(a[0], b[0]);
+  if (n == 1 && !with_carry_out) return sum;
+  // c_{i + 1} = c_i ^ ((a_i ^ c_i) & (b_i ^ c_i)) is the majority of a_i, b_i and c_i
+  Wire carry{builder.And(a[0], b[0])};
+  for (std::size_t i = 1; i < n; ++i) {
+    const Wire a_carry{builder.Xor(a[i], carry)}, b_carry{builder.Xor(b[i], carry)};
+    sum[i] = builder.Xor(a_carry, b[i]);
+    if (i + 1 < n || with_carry_out) carry = builder.Xor(carry, builder.And(a_carry, b_carry));
+  }
+  if (with_carry_out) sum.push_back(carry);
+  return sum;
+}
+
+// like RippleCarryAdd, but the carries are the group generates of a Sklansky parallel-prefix tree.
+// Bit 0 is split into the elements a_0 and a_0 & b_0, such that element i + 1 is bit i and the
+// carry into bit i, which is the group generate of the elements 0, ..., i, has the optimal AND
+// depth ceil(log2(i + 1)).
+Bits ParallelPrefixAdd(CircuitBuilder& builder, const Bits& a, const Bits& b, bool with_carry_out) {
+  const std::size_t n{a.size()};
+  const std::size_t number_of_elements{with_carry_out ? n + 1 : n};
+  Bits propagate(n), generate(number_of_elements), group_propagate(number_of_elements);
+  for (std::size_t i = 0; i < n; ++i) propagate[i] = builder.Xor(a[i], b[i]);
+  generate[0] = a[0];
+  for (std::size_t i = 1; i < number_of_elements; ++i) {
+    generate[i] = builder.And(a[i - 1], b[i - 1]);
+    group_propagate[i] = propagate[i - 1];
+  }
+
+  // after the round with distance d, generate[j] and group_propagate[j] cover the elements
+  // j & ~(2d - 1), ..., j. Generate and propagate of a group are exclusive, hence the OR of the
+  // carry operator is an XOR. Element 1 already covers element 0, and the propagate of the groups
+  // that start at element 0 is never used.
+  for (std::size_t d = 1; d < number_of_elements; d *= 2) {
+    for (std::size_t j = std::max<std::size_t>(d, 2); j < number_of_elements; ++j) {
+      if ((j & d) == 0) continue;
+      const std::size_t group_begin{j & ~(2 * d - 1)};
+      const std::size_t k{group_begin + d - 1};
+      generate[j] = builder.Xor(generate[j], builder.And(group_propagate[j], generate[k]));
+      if (group_begin > 0 && 2 * d < number_of_elements) {
+        group_propagate[j] = builder.And(group_propagate[j], group_propagate[k]);
+      }
+    }
+  }
+
+  Bits sum(n);
+  sum[0] = builder.Xor(a[0], b[0]);
+  for (std::size_t i = 1; i < n; ++i) sum[i] = builder.Xor(propagate[i], generate[i]);
+  if (with_carry_out) sum.push_back(generate[n]);
+  return sum;
+}
+
+Bits Add(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth,
+         bool with_carry_out) {
+  return low_depth ? ParallelPrefixAdd(builder, a, b, with_carry_out)
+                   : RippleCarryAdd(builder, a, b, with_carry_out);
+}
+
+Wire CarryOut(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth) {
+  if (!low_depth) {
+    Wire carry{builder.And(a[0], b[0])};
+    for (std::size_t i = 1; i < a.size(); ++i) {
+      const Wire a_carry{builder.Xor(a[i], carry)}, b_carry{builder.Xor(b[i], carry)};
+      carry = builder.Xor(carry, builder.And(a_carry, b_carry));
+    }
+    return carry;
+  }
+  // the group generate and, unless the group starts at bit 0, group propagate of [begin, end)
+  auto carry = [&](auto& self, std::size_t begin,
+                   std::size_t end) -> std::pair<Wire, std::optional<Wire>> {
+    if (end - begin == 1) {
+      return {builder.And(a[begin], b[begin]),
+              begin > 0 ? std::optional(builder.Xor(a[begin], b[begin])) : std::nullopt};
+    }
+    const std::size_t middle{begin + (end - begin) / 2};
+    const auto [low_generate, low_propagate] = self(self, begin, middle);
+    const auto [high_generate, high_propagate] = self(self, middle, end);
+    const Wire generate{builder.Xor(high_generate, builder.And(*high_propagate, low_generate))};
+    if (begin == 0) return {generate, std::nullopt};
+    return {generate, builder.And(*high_propagate, *low_propagate)};
+  };
+  return carry(carry, 0, a.size()).first;
+}
+
+Wire AndAll(CircuitBuilder& builder, Bits bits, bool low_depth) {
+  if (!low_depth) {
+    Wire result{bits[0]};
+    for (std::size_t i = 1; i < bits.size(); ++i) result = builder.And(result, bits[i]);
+    return result;
+  }
+  while (bits.size() > 1) {
+    Bits next;
+    for (std::size_t i = 0; i + 1 < bits.size(); i += 2) {
+      next.push_back(builder.And(bits[i], bits[i + 1]));
+    }
+    if (bits.size() % 2 == 1) next.push_back(bits.back());
+    bits = std::move(next);
+  }
+  return bits[0];
+}
+
+Bits SuffixAnds(CircuitBuilder& builder, const Bits& bits, bool low_depth) {
+  const std::size_t n{bits.size()};
+  Bits suffixes(bits);
+  if (!low_depth) {
+    for (std::size_t k = n - 1; k-- > 0;) suffixes[k] = builder.And(bits[k], suffixes[k + 1]);
+    return suffixes;
+  }
+  // prefix ANDs of the reversed bits
+  for (std::size_t d = 1; d < n; d *= 2) {
+    for (std::size_t j = d; j < n; ++j) {
+      if ((j & d) == 0) continue;
+      const std::size_t k{(j & ~(2 * d - 1)) + d - 1};
+      suffixes[n - 1 - j] = builder.And(suffixes[n - 1 - j], suffixes[n - 1 - k]);
+    }
+  }
+  return suffixes;
+}
+
+Bits Multiply(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth,
+              std::optional<std::size_t> number_of_product_bits) {
+  const std::size_t n{a.size()}, m{number_of_product_bits.value_or(n)};
+  if (!low_depth) {
+    // schoolbook multiplication, which adds the row of b_i to the bits i, ..., m - 1
+    Bits product(m);
+    for (std::size_t j = 0; j < m; ++j) {
+      product[j] = j < n ? builder.And(a[j], b[0]) : builder.Zero();
+    }
+    for (std::size_t i = 1; i < std::min(n, m); ++i) {
+      // the row ends at bit i + n - 1, the sum carries into bit i + n
+      const std::size_t row_length{std::min(n, m - i)};
+      const bool with_carry_out{i + n < m};
+      Bits row(row_length);
+      for (std::size_t j = 0; j < row_length; ++j) row[j] = builder.And(a[j], b[i]);
+      const Bits high(product.begin() + i, product.begin() + i + row_length);
+      const Bits sum{RippleCarryAdd(builder, high, row, with_carry_out)};
+      std::copy(sum.begin(), sum.end(), product.begin() + i);
+    }
+    return product;
+  }
+
+  // Dadda tree: full and half adders reduce the partial products of each column to at most
+  // d_j = 2, 3, 4, 6, 9, ... bits in each stage, carries out of column m - 1 are dropped
+  std::vector<Bits> columns(m);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n && i + j < m; ++j) {
+      columns[i + j].push_back(builder.And(a[j], b[i]));
+    }
+  }
+  std::vector<std::size_t> targets{2};
+  while (targets.back() < n) targets.push_back(targets.back() * 3 / 2);
+  for (auto target = targets.rbegin(); target != targets.rend(); ++target) {
+    std::vector<Bits> next(m);
+    for (std::size_t c = 0; c < m; ++c) {
+      // the carries of column c - 1 are already in next[c]
+      Bits bits{columns[c]};
+      bits.insert(bits.end(), next[c].begin(), next[c].end());
+      next[c].clear();
+      // the height of the column in the next stage is next[c].size() + bits.size() - i
+      std::size_t i{0};
+      while (next[c].size() + bits.size() - i > *target && bits.size() - i >= 2) {
+        const bool is_full_adder{next[c].size() + bits.size() - i - *target >= 2 &&
+                                 bits.size() - i >= 3};
+        const Wire x{bits[i]}, y{bits[i + 1]};
+        if (is_full_adder) {
+          const Wire z{bits[i + 2]};
+          const Wire x_z{builder.Xor(x, z)};
+          next[c].push_back(builder.Xor(x_z, y));
+          if (c + 1 < m) {
+            next[c + 1].push_back(builder.Xor(z, builder.And(x_z, builder.Xor(y, z))));
+          }
+          i += 3;
+        } else {
+          next[c].push_back(builder.Xor(x, y));
+          if (c + 1 < m) next[c + 1].push_back(builder.And(x, y));
+          i += 2;
+        }
+      }
+      next[c].insert(next[c].end(), bits.begin() + i, bits.end());
+    }
+    columns = std::move(next);
+  }
+
+  // the columns below the first column of two bits are already the product
+  std::size_t first{0};
+  while (first < m && columns[first].size() < 2) ++first;
+  Bits product(m);
+  for (std::size_t c = 0; c < first; ++c) {
+    product[c] = columns[c].empty() ? builder.Zero() : columns[c][0];
+  }
+  if (first < m) {
+    Bits x, y;
+    for (std::size_t c = first; c < m; ++c) {
+      x.push_back(columns[c].empty() ? builder.Zero() : columns[c][0]);
+      y.push_back(columns[c].size() < 2 ? builder.Zero() : columns[c][1]);
+    }
+    const Bits sum{ParallelPrefixAdd(builder, x, y, false)};
+    std::copy(sum.begin(), sum.end(), product.begin() + first);
+  }
+  return product;
+}
+
+// restoring division: step k = 1, ..., n shifts the next bit of a into the remainder t of k bits,
+// which is at least b iff b has no bits above the lower k bits and t - b does not borrow
+Bits Divide(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth) {
+  const std::size_t n{a.size()};
+  // b_zero_from[k] = 1 iff b_k, ..., b_{n - 1} are 0
+  const Bits b_zero_from{SuffixAnds(builder, builder.Inv(b), low_depth)};
+  Bits quotient(n), remainder;
+  for (std::size_t k = 1; k <= n; ++k) {
+    const std::size_t i{n - k};
+    Bits t{a[i]};
+    t.insert(t.end(), remainder.begin(), remainder.end());
+    // t - b_low = ~(~t + b_low) with the carry out ~t + b_low >= 2^k iff b_low > t
+    const Bits inverted_t{builder.Inv(t)};
+    const Bits b_low(b.begin(), b.begin() + k);
+    if (i == 0) {
+      // the last step does not need the remainder
+      quotient[0] = builder.Inv(CarryOut(builder, inverted_t, b_low, low_depth));
+      break;
+    }
+    const Bits sum{Add(builder, inverted_t, b_low, low_depth, true)};
+    const Wire greater_equal{builder.Inv(sum.back())};
+    quotient[i] = builder.And(greater_equal, b_zero_from[k]);
+    // t - b_low ^ t = ~sum ^ t = sum ^ ~t
+    remainder.resize(k);
+    for (std::size_t j = 0; j < k; ++j) {
+      remainder[j] =
+          builder.Xor(t[j], builder.And(quotient[i], builder.Xor(sum[j], inverted_t[j])));
+    }
+  }
+  return quotient;
+}
+
+Bits OneHot(CircuitBuilder& builder, const Bits& index, std::size_t number_of_outputs) {
+  if (index.size() == 1) {
+    Bits one_hot{builder.Inv(index[0])};
+    if (number_of_outputs > 1) one_hot.push_back(index[0]);
+    return one_hot;
+  }
+  const std::size_t number_of_lower_bits{index.size() / 2};
+  const std::size_t number_of_lower_outputs{
+      std::min(number_of_outputs, std::size_t(1) << number_of_lower_bits)};
+  const Bits lower{OneHot(builder, Bits(index.begin(), index.begin() + number_of_lower_bits),
+                          number_of_lower_outputs)};
+  const Bits upper{OneHot(builder, Bits(index.begin() + number_of_lower_bits, index.end()),
+                          ((number_of_outputs - 1) >> number_of_lower_bits) + 1)};
+  Bits one_hot(number_of_outputs);
+  for (std::size_t j = 0; j < number_of_outputs; ++j) {
+    one_hot[j] = builder.And(upper[j >> number_of_lower_bits],
+                             lower[j & ((std::size_t(1) << number_of_lower_bits) - 1)]);
+  }
+  return one_hot;
+}
+
+}  // namespace encrypto::motion::algorithm::circuit_builder
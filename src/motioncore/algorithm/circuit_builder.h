@@ -0,0 +1,163 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "algorithm_description.h"
+
+namespace encrypto::motion::algorithm::circuit_builder {
+
+using Wire = std::size_t;
+using Bits = std::vector<Wire>;
+
+// appends gates to an AlgorithmDescription, whose gate i computes wire number_of_inputs + i as
+// ShareWrapper::Evaluate() expects. The circuit has one or two operands of bit_length wires.
+class CircuitBuilder {
+ public:
+  explicit CircuitBuilder(std::size_t bit_length, std::size_t number_of_operands = 2)
+      : number_of_operands_(number_of_operands) {
+    algorithm_.number_of_input_wires_parent_a = bit_length;
+    if (number_of_operands == 2) algorithm_.number_of_input_wires_parent_b = bit_length;
+  }
+
+  Bits Operand(std::size_t i) const {
+    const std::size_t bit_length{algorithm_.number_of_input_wires_parent_a};
+    Bits bits(bit_length);
+    for (std::size_t j = 0; j < bit_length; ++j) bits[j] = i * bit_length + j;
+    return bits;
+  }
+
+  Wire Xor(Wire a, Wire b) { return Emplace(PrimitiveOperationType::kXor, a, b); }
+
+  Wire And(Wire a, Wire b) { return Emplace(PrimitiveOperationType::kAnd, a, b); }
+
+  // a | b = a ^ b ^ (a & b), which uses only the operations of all Boolean protocols
+  Wire Or(Wire a, Wire b) { return Xor(Xor(a, b), And(a, b)); }
+
+  Wire Inv(Wire a) { return Emplace(PrimitiveOperationType::kInv, a, std::nullopt); }
+
+  Bits Inv(const Bits& a) {
+    Bits result(a.size());
+    std::transform(a.begin(), a.end(), result.begin(), [this](Wire wire) { return Inv(wire); });
+    return result;
+  }
+
+  // selection ? a : b
+  Wire Mux(Wire selection, Wire a, Wire b) { return Xor(b, And(selection, Xor(a, b))); }
+
+  Bits Mux(Wire selection, const Bits& a, const Bits& b) {
+    Bits result(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) result[i] = Mux(selection, a[i], b[i]);
+    return result;
+  }
+
+  Wire Zero() {
+    if (!zero_) zero_ = Xor(0, 0);
+    return *zero_;
+  }
+
+  Wire One() {
+    if (!one_) one_ = Inv(Zero());
+    return *one_;
+  }
+
+  // the n bits of value with the least significant bit first
+  Bits Constant(std::uint64_t value, std::size_t n) {
+    Bits bits(n);
+    for (std::size_t i = 0; i < n; ++i) bits[i] = ((value >> i) & 1) != 0 ? One() : Zero();
+    return bits;
+  }
+
+  // copies the outputs to the last wires of the circuit unless they already are
+  AlgorithmDescription Finish(const Bits& outputs) {
+    const std::size_t number_of_wires{GetNumberOfWires()};
+    bool are_last{outputs.size() <= number_of_wires - GetNumberOfInputWires()};
+    for (std::size_t i = 0; are_last && i < outputs.size(); ++i) {
+      are_last = outputs[i] == number_of_wires - outputs.size() + i;
+    }
+    if (!are_last) {
+      const Wire zero{Zero()};
+      for (const Wire output : outputs) Xor(output, zero);
+    }
+    algorithm_.number_of_gates = algorithm_.gates.size();
+    algorithm_.number_of_wires = GetNumberOfWires();
+    algorithm_.number_of_output_wires = outputs.size();
+    return std::move(algorithm_);
+  }
+
+ private:
+  std::size_t GetNumberOfInputWires() const {
+    return number_of_operands_ * algorithm_.number_of_input_wires_parent_a;
+  }
+
+  std::size_t GetNumberOfWires() const { return GetNumberOfInputWires() + algorithm_.gates.size(); }
+
+  Wire Emplace(PrimitiveOperationType type, Wire a, std::optional<Wire> b) {
+    const Wire output_wire{GetNumberOfWires()};
+    algorithm_.gates.push_back(PrimitiveOperation{type, a, b, std::nullopt, output_wire});
+    return output_wire;
+  }
+
+  AlgorithmDescription algorithm_;
+  std::size_t number_of_operands_;
+  std::optional<Wire> zero_, one_;
+};
+
+// a + b modulo 2^n for n-bit a and b, followed by the carry out if with_carry_out is set
+Bits RippleCarryAdd(CircuitBuilder& builder, const Bits& a, const Bits& b, bool with_carry_out);
+
+// like RippleCarryAdd, but the carries are the group generates of a Sklansky parallel-prefix tree
+Bits ParallelPrefixAdd(CircuitBuilder& builder, const Bits& a, const Bits& b, bool with_carry_out);
+
+Bits Add(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth,
+         bool with_carry_out = false);
+
+// the carry out of a + b, which is computed by a balanced tree of carry operators for low_depth
+Wire CarryOut(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth);
+
+// AND of all bits, a balanced tree for low_depth
+Wire AndAll(CircuitBuilder& builder, Bits bits, bool low_depth);
+
+// the ANDs of all suffixes bits[k], ..., bits.back(), Sklansky-like for low_depth
+Bits SuffixAnds(CircuitBuilder& builder, const Bits& bits, bool low_depth);
+
+// the lower number_of_product_bits <= 2n bits of the product of n-bit a and b, by default n
+Bits Multiply(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth,
+              std::optional<std::size_t> number_of_product_bits = std::nullopt);
+
+// the n bits of a / b rounded down for n-bit a and b, where x / 0 is 2^n - 1
+Bits Divide(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth);
+
+// the bits [index == j] for j < number_of_outputs <= 2^index.size(), which are the ANDs of the
+// one-hot encodings of the lower and upper half of the index bits
+Bits OneHot(CircuitBuilder& builder, const Bits& index, std::size_t number_of_outputs);
+
+}  // namespace encrypto::motion::algorithm::circuit_builder
@@ -0,0 +1,169 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "circuit_cache.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <fmt/format.h>
+#include <openssl/evp.h>
+
+#include "algorithm_description.h"
+#include "binary_circuit.h"
+#include "circuit_optimizer.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// hashed before the contents of the circuit file, such that cached files of other formats or
+// versions are not used
+struct CacheKeyPrefix {
+  std::array<char, 8> magic;
+  std::uint32_t binary_circuit_version;
+  std::uint32_t optimizer_version;
+  std::uint32_t format;
+};
+
+constexpr std::array<char, 8> kCircuitCacheMagic{'M', 'O', 'T', 'I', 'O', 'N', 'C', 'C'};
+
+// number of bytes of the BLAKE2b digest used as the name of a cached file
+constexpr std::size_t kKeySize{32};
+
+// distinguishes the temporary files written concurrently by the threads of a process
+std::atomic<std::size_t> temporary_file_counter{0};
+
+}  // namespace
+
+CircuitCache::CircuitCache(std::filesystem::path directory) : directory_(std::move(directory)) {
+  std::filesystem::create_directories(directory_);
+}
+
+std::string CircuitCache::ComputeKey(const std::filesystem::path& path, CircuitFormat format,
+                                     bool optimize) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    throw std::runtime_error(fmt::format("cannot open circuit file {}", path.string()));
+  }
+  std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> context(EVP_MD_CTX_new(),
+                                                                  &EVP_MD_CTX_free);
+  EVP_DigestInit_ex(context.get(), EVP_blake2b512(), nullptr);
+  const CacheKeyPrefix prefix{.magic = kCircuitCacheMagic,
+                              .binary_circuit_version = kBinaryCircuitVersion,
+                              .optimizer_version = optimize ? kCircuitOptimizerVersion : 0,
+                              .format = static_cast<std::uint32_t>(format)};
+  EVP_DigestUpdate(context.get(), &prefix, sizeof(prefix));
+  std::vector<char> buffer(std::size_t(1) << 16);
+  while (stream) {
+    stream.read(buffer.data(), buffer.size());
+    EVP_DigestUpdate(context.get(), buffer.data(), stream.gcount());
+  }
+  if (stream.bad()) {
+    throw std::runtime_error(fmt::format("cannot read circuit file {}", path.string()));
+  }
+  std::array<std::uint8_t, EVP_MAX_MD_SIZE> digest;
+  unsigned int digest_size;
+  EVP_DigestFinal_ex(context.get(), digest.data(), &digest_size);
+
+  std::string key;
+  key.reserve(2 * kKeySize);
+  for (std::size_t i = 0; i < kKeySize; ++i) {
+    key.append(fmt::format("{:02x}", digest[i]));
+  }
+  return key;
+}
+
+std::shared_ptr<AlgorithmDescription> CircuitCache::Load(const std::filesystem::path& path,
+                                                         CircuitFormat format, bool optimize) {
+  const auto key{ComputeKey(path, format, optimize)};
+  {
+    std::scoped_lock lock(mutex_);
+    if (auto iterator{descriptions_.find(key)}; iterator != descriptions_.end()) {
+      ++statistics_.number_of_memory_hits;
+      return iterator->second;
+    }
+  }
+
+  const auto cached_path{directory_ / (key + ".mbc")};
+  std::shared_ptr<AlgorithmDescription> algorithm;
+  bool is_disk_hit{false};
+  if (std::filesystem::exists(cached_path)) {
+    try {
+      algorithm =
+          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBinary(cached_path.string()));
+      is_disk_hit = true;
+    } catch (const std::runtime_error&) {
+      // e.g., a file of another binary circuit version, which is replaced below
+    }
+  }
+
+  if (!algorithm) {
+    auto parsed{format == CircuitFormat::kBristol
+                    ? AlgorithmDescription::FromBristol(path.string())
+                    : AlgorithmDescription::FromBristolFashion(path.string())};
+    if (optimize) {
+      parsed = OptimizeAlgorithmDescription(parsed);
+    }
+    parsed.ComputeSchedule();
+    algorithm = std::make_shared<AlgorithmDescription>(std::move(parsed));
+
+    const auto temporary_path{
+        directory_ / fmt::format("{}.{}.{}.tmp", key, getpid(), temporary_file_counter++)};
+    try {
+      WriteBinaryCircuit(*algorithm, temporary_path);
+      std::filesystem::rename(temporary_path, cached_path);
+    } catch (const std::exception&) {
+      // the description is still valid if it cannot be cached, e.g., if it has arithmetic gates
+      std::error_code error_code;
+      std::filesystem::remove(temporary_path, error_code);
+    }
+  }
+
+  std::scoped_lock lock(mutex_);
+  const auto [iterator, success]{descriptions_.try_emplace(key, std::move(algorithm))};
+  if (!success) {
+    // another thread loaded the same circuit in the meantime
+    ++statistics_.number_of_memory_hits;
+  } else if (is_disk_hit) {
+    ++statistics_.number_of_disk_hits;
+  } else {
+    ++statistics_.number_of_misses;
+  }
+  return iterator->second;
+}
+
+CircuitCacheStatistics CircuitCache::GetStatistics() const {
+  std::scoped_lock lock(mutex_);
+  return statistics_;
+}
+
+}  // namespace encrypto::motion
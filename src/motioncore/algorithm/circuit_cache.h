@@ -0,0 +1,86 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace encrypto::motion {
+
+struct AlgorithmDescription;
+
+enum class CircuitFormat : std::uint8_t { kBristol, kBristolFashion };
+
+struct CircuitCacheStatistics {
+  // descriptions found in memory, loaded from a cached binary circuit, and parsed from the file
+  std::size_t number_of_memory_hits{0}, number_of_disk_hits{0}, number_of_misses{0};
+};
+
+// Persistent, content-addressed cache of parsed and optionally optimized circuit files, which
+// avoids parsing a circuit again in a new process or under another path. A description is stored
+// as a binary circuit file (see binary_circuit.h) in the cache directory, which is named after the
+// BLAKE2b hash of the contents and format of the circuit file, the binary circuit version and the
+// version of the circuit optimizer if the circuit is optimized. Cached files are written to a
+// temporary file first and renamed afterwards, such that several processes can share the
+// directory. The loaded descriptions are also kept in memory by their hash.
+//
+// Thread-safe.
+class CircuitCache {
+ public:
+  // throws std::filesystem::filesystem_error if the directory cannot be created
+  explicit CircuitCache(std::filesystem::path directory);
+
+  CircuitCache(const CircuitCache&) = delete;
+
+  // returns the description of the circuit file at path, which is optimized with
+  // OptimizeAlgorithmDescription if optimize is set, and computes its schedule
+  // throws std::runtime_error if the circuit file cannot be read
+  std::shared_ptr<AlgorithmDescription> Load(const std::filesystem::path& path,
+                                             CircuitFormat format, bool optimize = false);
+
+  // returns the hexadecimal name of the cached description of the circuit file at path
+  // throws std::runtime_error if the circuit file cannot be read
+  static std::string ComputeKey(const std::filesystem::path& path, CircuitFormat format,
+                                bool optimize);
+
+  const std::filesystem::path& GetDirectory() const noexcept { return directory_; }
+
+  CircuitCacheStatistics GetStatistics() const;
+
+ private:
+  std::filesystem::path directory_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<AlgorithmDescription>> descriptions_;
+  CircuitCacheStatistics statistics_;
+};
+
+}  // namespace encrypto::motion
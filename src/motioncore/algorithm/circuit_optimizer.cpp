@@ -0,0 +1,497 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "circuit_optimizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+namespace {
+
+// A literal refers to a node, which is inverted if the lowest bit is set. Node 0 is the constant
+// false, hence literals 0 and 1 are the constants false and true.
+using Literal = std::size_t;
+constexpr Literal kFalse{0}, kTrue{1};
+
+constexpr std::size_t NodeOf(Literal literal) { return literal >> 1; }
+constexpr bool IsInverted(Literal literal) { return literal & 1; }
+constexpr Literal MakeLiteral(std::size_t node) { return node << 1; }
+
+enum class NodeType : std::uint8_t { kConstant, kInput, kXor, kAnd };
+
+struct Node {
+  NodeType type;
+  Literal a{kFalse}, b{kFalse};
+
+  bool operator==(const Node& other) const = default;
+};
+
+struct NodeHash {
+  std::size_t operator()(const Node& node) const {
+    return std::hash<std::size_t>{}(node.a * 0x9e3779b97f4a7c15 + node.b) ^
+           static_cast<std::size_t>(node.type);
+  }
+};
+
+// Graph of XOR and AND nodes in topological order, which merges common subexpressions and
+// simplifies nodes with constant or equal inputs on construction. XOR nodes have no inverted
+// inputs, since those are moved to their output.
+class AndXorGraph {
+ public:
+  explicit AndXorGraph(std::size_t number_of_inputs) : number_of_inputs_(number_of_inputs) {
+    nodes_.push_back({NodeType::kConstant});
+    for (std::size_t i = 0; i < number_of_inputs; ++i) nodes_.push_back({NodeType::kInput});
+  }
+
+  std::size_t GetNumberOfInputs() const { return number_of_inputs_; }
+
+  std::size_t GetNumberOfNodes() const { return nodes_.size(); }
+
+  const Node& GetNode(std::size_t node) const { return nodes_[node]; }
+
+  Literal Input(std::size_t input) const { return MakeLiteral(input + 1); }
+
+  Literal Xor(Literal a, Literal b) {
+    const Literal inverted{(a ^ b) & 1};
+    a &= ~Literal(1);
+    b &= ~Literal(1);
+    if (a == b) return kFalse ^ inverted;
+    if (a == kFalse) return b ^ inverted;
+    if (b == kFalse) return a ^ inverted;
+    return Insert(NodeType::kXor, a, b) ^ inverted;
+  }
+
+  Literal And(Literal a, Literal b) {
+    if (a == kFalse || b == kFalse || a == (b ^ 1)) return kFalse;
+    if (a == kTrue || a == b) return b;
+    if (b == kTrue) return a;
+    return Insert(NodeType::kAnd, a, b);
+  }
+
+  Literal Or(Literal a, Literal b) { return And(a ^ 1, b ^ 1) ^ 1; }
+
+ private:
+  Literal Insert(NodeType type, Literal a, Literal b) {
+    Node node{type, std::min(a, b), std::max(a, b)};
+    const auto [iterator, inserted] = node_indices_.try_emplace(node, nodes_.size());
+    if (inserted) nodes_.push_back(node);
+    return MakeLiteral(iterator->second);
+  }
+
+  std::size_t number_of_inputs_;
+  std::vector<Node> nodes_;
+  std::unordered_map<Node, std::size_t, NodeHash> node_indices_;
+};
+
+// counts how often each node is used by the outputs and by the nodes the outputs depend on, such
+// that nodes without uses can be removed
+std::vector<std::size_t> CountUses(const AndXorGraph& graph, std::span<const Literal> outputs) {
+  std::vector<std::size_t> uses(graph.GetNumberOfNodes(), 0);
+  for (auto output : outputs) ++uses[NodeOf(output)];
+  for (std::size_t node_i = graph.GetNumberOfNodes(); node_i-- > 0;) {
+    const auto& node{graph.GetNode(node_i)};
+    if (uses[node_i] == 0 || node.type == NodeType::kConstant || node.type == NodeType::kInput) {
+      continue;
+    }
+    ++uses[NodeOf(node.a)];
+    ++uses[NodeOf(node.b)];
+  }
+  return uses;
+}
+
+std::size_t CountAndNodes(const AndXorGraph& graph, std::span<const std::size_t> uses) {
+  std::size_t number_of_and_nodes{0};
+  for (std::size_t node_i = 0; node_i < graph.GetNumberOfNodes(); ++node_i) {
+    if (uses[node_i] > 0 && graph.GetNode(node_i).type == NodeType::kAnd) ++number_of_and_nodes;
+  }
+  return number_of_and_nodes;
+}
+
+// Rebuilds graph and replaces the XOR or OR of two AND nodes without further uses by an equivalent
+// with a single AND node where possible. OR(x, y) is represented as NOT AND(NOT x, NOT y).
+AndXorGraph Rewrite(const AndXorGraph& graph, std::vector<Literal>& outputs) {
+  const auto uses{CountUses(graph, outputs)};
+  AndXorGraph result(graph.GetNumberOfInputs());
+  std::vector<Literal> literals(graph.GetNumberOfNodes(), kFalse);
+  for (std::size_t i = 0; i < graph.GetNumberOfInputs(); ++i) literals[i + 1] = result.Input(i);
+  auto translate = [&literals](Literal literal) {
+    return literals[NodeOf(literal)] ^ (literal & 1);
+  };
+  auto is_single_use_and = [&graph, &uses](Literal literal) {
+    return uses[NodeOf(literal)] == 1 && graph.GetNode(NodeOf(literal)).type == NodeType::kAnd;
+  };
+
+  // returns the literal of (a AND b) XOR (c AND d) with a single AND node if such exists, where
+  // is_disjoint indicates that the XOR is an OR, i.e., both products are never true together
+  auto combine = [&](Literal a, Literal b, Literal c, Literal d,
+                     bool is_disjoint) -> std::optional<Literal> {
+    for (std::size_t i = 0; i < 4; ++i) {
+      // (x AND y) XOR (z AND w) for all orders of the operands
+      const Literal x{i & 1 ? b : a}, y{i & 1 ? a : b}, z{i & 2 ? d : c}, w{i & 2 ? c : d};
+      if (x == z && !is_disjoint) {
+        return result.And(translate(x), result.Xor(translate(y), translate(w)));
+      }
+      if (x == (z ^ 1)) {
+        // multiplexer
+        const Literal y_xor_w{result.Xor(translate(y), translate(w))};
+        return result.Xor(result.And(translate(x), y_xor_w), translate(w));
+      }
+      // majority of x, y, z if w = x XOR y, which is disjoint to x AND y
+      const auto& node_w{graph.GetNode(NodeOf(w))};
+      if (!IsInverted(w) && node_w.type == NodeType::kXor && IsInverted(x) == IsInverted(y) &&
+          std::minmax(x & ~Literal(1), y & ~Literal(1)) == std::minmax(node_w.a, node_w.b)) {
+        const Literal x_xor_z{result.Xor(translate(x), translate(z))};
+        const Literal y_xor_z{result.Xor(translate(y), translate(z))};
+        return result.Xor(result.And(x_xor_z, y_xor_z), translate(z));
+      }
+    }
+    return std::nullopt;
+  };
+
+  for (std::size_t node_i = graph.GetNumberOfInputs() + 1; node_i < graph.GetNumberOfNodes();
+       ++node_i) {
+    if (uses[node_i] == 0) continue;
+    const auto& node{graph.GetNode(node_i)};
+    std::optional<Literal> rewritten;
+    if (is_single_use_and(node.a) && is_single_use_and(node.b)) {
+      const auto& node_a{graph.GetNode(NodeOf(node.a))};
+      const auto& node_b{graph.GetNode(NodeOf(node.b))};
+      if (node.type == NodeType::kXor) {
+        rewritten = combine(node_a.a, node_a.b, node_b.a, node_b.b, false);
+      } else if (IsInverted(node.a) && IsInverted(node.b)) {
+        rewritten = combine(node_a.a, node_a.b, node_b.a, node_b.b, true);
+        if (rewritten) *rewritten ^= 1;
+      }
+    }
+    if (rewritten) {
+      literals[node_i] = *rewritten;
+    } else if (node.type == NodeType::kXor) {
+      literals[node_i] = result.Xor(translate(node.a), translate(node.b));
+    } else {
+      literals[node_i] = result.And(translate(node.a), translate(node.b));
+    }
+  }
+  for (auto& output : outputs) output = translate(output);
+  return result;
+}
+
+// writes graph as an AlgorithmDescription with the input and output layout of algorithm
+//
+// Since XOR gates compute the same up to the inversion of their output for either wire of an input
+// and its inversion, they read whichever exists, and INV gates are only inserted where AND gates
+// and outputs need the other one.
+AlgorithmDescription ToAlgorithmDescription(const AndXorGraph& graph,
+                                            std::span<const Literal> outputs,
+                                            const AlgorithmDescription& algorithm,
+                                            bool count_xor_inversions) {
+  const auto uses{CountUses(graph, outputs)};
+  AlgorithmDescription result;
+  result.number_of_input_wires_parent_a = algorithm.number_of_input_wires_parent_a;
+  result.number_of_input_wires_parent_b = algorithm.number_of_input_wires_parent_b;
+  result.number_of_output_wires = outputs.size();
+
+  const std::size_t number_of_inputs{graph.GetNumberOfInputs()};
+  if (uses[0] > 0 && number_of_inputs == 0) {
+    throw std::invalid_argument("Constant outputs require a circuit with inputs");
+  }
+  // wires of every literal, i.e., of the nodes and their inversions
+  std::vector<std::optional<std::size_t>> wires(2 * graph.GetNumberOfNodes());
+  for (std::size_t i = 0; i < number_of_inputs; ++i) wires[graph.Input(i)] = i;
+  auto add_gate = [&result, number_of_inputs](PrimitiveOperationType type, std::size_t parent_a,
+                                              std::optional<std::size_t> parent_b) {
+    const std::size_t output_wire{number_of_inputs + result.gates.size()};
+    result.gates.push_back({type, parent_a, parent_b, std::nullopt, output_wire});
+    return output_wire;
+  };
+  auto get_wire = [&](Literal literal) {
+    if (!wires[literal]) {
+      wires[literal] = add_gate(PrimitiveOperationType::kInv, *wires[literal ^ 1], std::nullopt);
+    }
+    return *wires[literal];
+  };
+  // returns the existing literals of a and b whose XOR is the inversion of a XOR b iff inverted
+  auto find_xor_operands = [&wires](Literal a, Literal b,
+                                    bool inverted) -> std::optional<std::pair<Literal, Literal>> {
+    for (Literal inversion_a : {0, 1}) {
+      const Literal inversion_b{inversion_a ^ inverted};
+      if (wires[a ^ inversion_a] && wires[b ^ inversion_b]) {
+        return std::pair(a ^ inversion_a, b ^ inversion_b);
+      }
+    }
+    return std::nullopt;
+  };
+
+  // the outputs need to be the last wires, hence nodes used by nothing but one output are written
+  // last and all other outputs are copied there by an INV gate
+  std::vector<bool> is_output_node(graph.GetNumberOfNodes(), false);
+  for (auto output : outputs) {
+    const auto& node{graph.GetNode(NodeOf(output))};
+    if (uses[NodeOf(output)] == 1 && (node.type == NodeType::kXor || node.type == NodeType::kAnd)) {
+      is_output_node[NodeOf(output)] = true;
+    }
+  }
+
+  // literals in which output nodes and XOR nodes are preferably written
+  std::vector<std::optional<Literal>> preferred_literals(graph.GetNumberOfNodes());
+  for (auto output : outputs) {
+    if (is_output_node[NodeOf(output)]) preferred_literals[NodeOf(output)] = output;
+  }
+
+  // AND nodes are written as NOT ((NOT a) AND (NOT b)) = a OR b if their inputs are rather
+  // available inverted, where the wires of XOR nodes may have either inversion unless
+  // count_xor_inversions is set
+  std::vector<bool> is_or(graph.GetNumberOfNodes(), false);
+  auto count_inversions = [&graph, &is_or, count_xor_inversions](Literal a, Literal b) {
+    std::size_t number_of_inversions{0};
+    for (auto literal : {a, b}) {
+      const auto& node{graph.GetNode(NodeOf(literal))};
+      if ((node.type != NodeType::kXor || count_xor_inversions) &&
+          IsInverted(literal) != is_or[NodeOf(literal)]) {
+        ++number_of_inversions;
+      }
+    }
+    return number_of_inversions;
+  };
+  for (std::size_t node_i = number_of_inputs + 1; node_i < graph.GetNumberOfNodes(); ++node_i) {
+    const auto& node{graph.GetNode(node_i)};
+    if (uses[node_i] == 0 || node.type != NodeType::kAnd) continue;
+    if (is_output_node[node_i]) {
+      is_or[node_i] = IsInverted(*preferred_literals[node_i]);
+    } else {
+      is_or[node_i] = count_inversions(node.a ^ 1, node.b ^ 1) < count_inversions(node.a, node.b);
+    }
+  }
+
+  // literals that AND and OR gates and outputs read
+  std::vector<bool> is_needed(2 * graph.GetNumberOfNodes(), false);
+  for (std::size_t node_i = number_of_inputs + 1; node_i < graph.GetNumberOfNodes(); ++node_i) {
+    const auto& node{graph.GetNode(node_i)};
+    if (uses[node_i] == 0 || node.type != NodeType::kAnd) continue;
+    is_needed[node.a ^ is_or[node_i]] = is_needed[node.b ^ is_or[node_i]] = true;
+  }
+  for (auto output : outputs) {
+    if (output == kFalse || output == kTrue) {
+      is_needed[graph.Input(0) ^ output] = true;
+    } else if (!is_output_node[NodeOf(output)]) {
+      is_needed[output ^ 1] = true;
+    }
+  }
+
+  // XOR nodes that are only read by XOR gates get the inversion their readers prefer, such that
+  // an inversion is moved towards the inputs
+  for (std::size_t node_i = graph.GetNumberOfNodes(); node_i-- > number_of_inputs + 1;) {
+    const auto& node{graph.GetNode(node_i)};
+    if (uses[node_i] == 0 || node.type != NodeType::kXor) continue;
+    const Literal plain{MakeLiteral(node_i)};
+    if (is_needed[plain] != is_needed[plain ^ 1]) {
+      preferred_literals[node_i] = is_needed[plain] ? plain : plain ^ 1;
+    }
+    if (!preferred_literals[node_i] || !IsInverted(*preferred_literals[node_i])) continue;
+    for (auto operand : {node.a, node.b}) {
+      const std::size_t operand_node{NodeOf(operand)};
+      if (graph.GetNode(operand_node).type == NodeType::kXor && !is_needed[operand] &&
+          !is_needed[operand ^ 1] && !preferred_literals[operand_node]) {
+        preferred_literals[operand_node] = operand ^ 1;
+        break;
+      }
+    }
+  }
+
+  // writes the needed literals of a node and creates the needed inversions right away, such that
+  // subsequent XOR gates can read them
+  auto add_inversions = [&](std::size_t node_i) {
+    const Literal plain{MakeLiteral(node_i)};
+    for (Literal literal : {plain, plain ^ 1}) {
+      if (is_needed[literal] && !wires[literal]) get_wire(literal);
+    }
+  };
+  for (std::size_t i = 0; i < number_of_inputs; ++i) add_inversions(NodeOf(graph.Input(i)));
+  for (std::size_t node_i = number_of_inputs + 1; node_i < graph.GetNumberOfNodes(); ++node_i) {
+    if (uses[node_i] == 0 || is_output_node[node_i]) continue;
+    const auto& node{graph.GetNode(node_i)};
+    const Literal plain{MakeLiteral(node_i)};
+    if (node.type == NodeType::kXor) {
+      bool is_written{false};
+      for (Literal literal : {plain, plain ^ 1}) {
+        if (!is_needed[literal] && preferred_literals[node_i] != literal) continue;
+        auto operands{find_xor_operands(node.a, node.b, IsInverted(literal))};
+        if (!operands && is_needed[literal] && !is_written) {
+          // invert the input with more readers, which other XOR gates may read as well
+          const Literal operand{uses[NodeOf(node.a)] >= uses[NodeOf(node.b)] ? node.a : node.b};
+          get_wire(operand);
+          get_wire(operand ^ 1);
+          operands = find_xor_operands(node.a, node.b, IsInverted(literal));
+        }
+        if (operands) {
+          wires[literal] = add_gate(PrimitiveOperationType::kXor, *wires[operands->first],
+                                    *wires[operands->second]);
+          is_written = true;
+        }
+      }
+      if (!is_written) {
+        const Literal operand_a{wires[node.a] ? node.a : node.a ^ 1};
+        const Literal operand_b{wires[node.b] ? node.b : node.b ^ 1};
+        wires[plain ^ IsInverted(operand_a ^ operand_b)] =
+            add_gate(PrimitiveOperationType::kXor, *wires[operand_a], *wires[operand_b]);
+      }
+    } else {
+      if (is_or[node_i]) {
+        wires[plain ^ 1] =
+            add_gate(PrimitiveOperationType::kOr, get_wire(node.a ^ 1), get_wire(node.b ^ 1));
+      } else {
+        wires[plain] = add_gate(PrimitiveOperationType::kAnd, get_wire(node.a), get_wire(node.b));
+      }
+    }
+    add_inversions(node_i);
+  }
+
+  // create the wires the outputs read before the outputs
+  for (auto output : outputs) {
+    const auto& node{graph.GetNode(NodeOf(output))};
+    if (!is_output_node[NodeOf(output)]) {
+      get_wire(output == kFalse || output == kTrue ? graph.Input(0) ^ output : output ^ 1);
+    } else if (node.type == NodeType::kXor) {
+      if (!find_xor_operands(node.a, node.b, IsInverted(output))) {
+        get_wire(node.a);
+        get_wire(node.a ^ 1);
+      }
+    } else if (IsInverted(output)) {
+      get_wire(node.a ^ 1);
+      get_wire(node.b ^ 1);
+    } else {
+      get_wire(node.a);
+      get_wire(node.b);
+    }
+  }
+  for (auto output : outputs) {
+    const auto& node{graph.GetNode(NodeOf(output))};
+    if (output == kFalse || output == kTrue) {
+      const std::size_t input_wire{*wires[graph.Input(0)]};
+      add_gate(PrimitiveOperationType::kXor, input_wire, *wires[graph.Input(0) ^ output]);
+    } else if (!is_output_node[NodeOf(output)]) {
+      add_gate(PrimitiveOperationType::kInv, *wires[output ^ 1], std::nullopt);
+    } else if (node.type == NodeType::kXor) {
+      const auto operands{*find_xor_operands(node.a, node.b, IsInverted(output))};
+      add_gate(PrimitiveOperationType::kXor, *wires[operands.first], *wires[operands.second]);
+    } else if (IsInverted(output)) {
+      add_gate(PrimitiveOperationType::kOr, *wires[node.a ^ 1], *wires[node.b ^ 1]);
+    } else {
+      add_gate(PrimitiveOperationType::kAnd, *wires[node.a], *wires[node.b]);
+    }
+  }
+
+  result.number_of_gates = result.gates.size();
+  result.number_of_wires = number_of_inputs + result.gates.size();
+  return result;
+}
+}  // namespace
+
+std::size_t GetNumberOfAndGates(const AlgorithmDescription& algorithm) {
+  return std::count_if(algorithm.gates.begin(), algorithm.gates.end(), [](const auto& gate) {
+    return gate.type == PrimitiveOperationType::kAnd || gate.type == PrimitiveOperationType::kOr ||
+           gate.type == PrimitiveOperationType::kMux;
+  });
+}
+
+AlgorithmDescription OptimizeAlgorithmDescription(const AlgorithmDescription& algorithm,
+                                                  AlgorithmOptimizationStatistics* statistics) {
+  const std::size_t number_of_inputs{algorithm.number_of_input_wires_parent_a +
+                                     algorithm.number_of_input_wires_parent_b.value_or(0)};
+  if (statistics) {
+    statistics->number_of_and_gates_before = statistics->number_of_and_gates_after =
+        GetNumberOfAndGates(algorithm);
+    statistics->number_of_gates_before = statistics->number_of_gates_after =
+        algorithm.gates.size();
+  }
+  if (algorithm.number_of_output_wires > algorithm.number_of_wires) {
+    throw std::invalid_argument(
+        fmt::format("AlgorithmDescription has {} output wires but only {} wires",
+                    algorithm.number_of_output_wires, algorithm.number_of_wires));
+  }
+
+  AndXorGraph graph(number_of_inputs);
+  std::vector<Literal> wires(algorithm.number_of_wires, kFalse);
+  for (std::size_t i = 0; i < number_of_inputs; ++i) wires.at(i) = graph.Input(i);
+  for (const auto& gate : algorithm.gates) {
+    switch (gate.type) {
+      case PrimitiveOperationType::kXor: {
+        wires.at(gate.output_wire) = graph.Xor(wires.at(gate.parent_a), wires.at(*gate.parent_b));
+        break;
+      }
+      case PrimitiveOperationType::kAnd: {
+        wires.at(gate.output_wire) = graph.And(wires.at(gate.parent_a), wires.at(*gate.parent_b));
+        break;
+      }
+      case PrimitiveOperationType::kOr: {
+        wires.at(gate.output_wire) = graph.Or(wires.at(gate.parent_a), wires.at(*gate.parent_b));
+        break;
+      }
+      case PrimitiveOperationType::kInv: {
+        wires.at(gate.output_wire) = wires.at(gate.parent_a) ^ 1;
+        break;
+      }
+      default:
+        return algorithm;
+    }
+  }
+  std::vector<Literal> outputs(wires.end() - algorithm.number_of_output_wires, wires.end());
+
+  // rewrite until the number of AND gates does not decrease anymore
+  std::size_t number_of_and_nodes{CountAndNodes(graph, CountUses(graph, outputs))};
+  while (number_of_and_nodes > 0) {
+    auto rewritten_outputs{outputs};
+    auto rewritten_graph{Rewrite(graph, rewritten_outputs)};
+    const std::size_t rewritten_number_of_and_nodes{
+        CountAndNodes(rewritten_graph, CountUses(rewritten_graph, rewritten_outputs))};
+    if (rewritten_number_of_and_nodes >= number_of_and_nodes) break;
+    graph = std::move(rewritten_graph);
+    outputs = std::move(rewritten_outputs);
+    number_of_and_nodes = rewritten_number_of_and_nodes;
+  }
+
+  // which inversions are cheaper depends on the circuit, hence keep the smaller result, or the
+  // original circuit if it is not improved
+  auto result{ToAlgorithmDescription(graph, outputs, algorithm, false)};
+  auto alternative_result{ToAlgorithmDescription(graph, outputs, algorithm, true)};
+  if (alternative_result.gates.size() < result.gates.size()) result = std::move(alternative_result);
+  if (GetNumberOfAndGates(result) == GetNumberOfAndGates(algorithm) &&
+      result.gates.size() >= algorithm.gates.size()) {
+    return algorithm;
+  }
+  if (statistics) {
+    statistics->number_of_and_gates_after = GetNumberOfAndGates(result);
+    statistics->number_of_gates_after = result.gates.size();
+  }
+  return result;
+}
+
+}  // namespace encrypto::motion
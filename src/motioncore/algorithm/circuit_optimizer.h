@@ -0,0 +1,60 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "algorithm_description.h"
+
+namespace encrypto::motion {
+
+// numbers of gates of a Boolean AlgorithmDescription before and after OptimizeAlgorithmDescription
+struct AlgorithmOptimizationStatistics {
+  std::size_t number_of_and_gates_before{0}, number_of_and_gates_after{0};
+  std::size_t number_of_gates_before{0}, number_of_gates_after{0};
+};
+
+// version of the rewrite rules of OptimizeAlgorithmDescription, which needs to be increased when
+// they change such that optimized circuits cached by a CircuitCache are optimized again
+inline constexpr std::uint32_t kCircuitOptimizerVersion{1};
+
+// number of gates of algorithm that need an AND gate in a Boolean protocol, i.e., AND, OR, and MUX
+// gates, whereas XOR and INV gates are free in garbled circuits and local in GMW
+std::size_t GetNumberOfAndGates(const AlgorithmDescription& algorithm);
+
+// Rewrites the Boolean circuit algorithm into an equivalent circuit of XOR, AND, and INV gates with
+// as few AND gates as possible:
+// - constants, e.g., x XOR x, are propagated and gates with constant or equal inputs are removed,
+// - OR gates are expressed by AND and INV gates and common subexpressions are merged,
+// - (a AND b) XOR (a AND c) becomes a AND (b XOR c), the multiplexer (s AND a) XOR (NOT s AND b)
+//   becomes (s AND (a XOR b)) XOR b, and the majority (a AND b) XOR (c AND (a XOR b)) becomes
+//   ((a XOR c) AND (b XOR c)) XOR c if the replaced AND gates are not used elsewhere, which also
+//   applies if the two AND gates are combined by OR instead of XOR,
+// - gates that do not affect any output are removed.
+// The inputs and outputs keep their layout. Circuits with other gates, e.g., MUX or arithmetic
+// gates, are returned unchanged.
+AlgorithmDescription OptimizeAlgorithmDescription(
+    const AlgorithmDescription& algorithm, AlgorithmOptimizationStatistics* statistics = nullptr);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,152 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "flat_circuit.h"
+
+
+#include "circuit_schedule.h"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+namespace {
+
+std::optional<std::size_t> GetParentB(const PrimitiveOperation& operation) {
+  return operation.parent_b;
+}
+
+std::optional<std::size_t> GetParentB(const BinaryCircuitGate& gate) {
+  if (gate.parent_b == kBinaryCircuitNoWire) return std::nullopt;
+  return gate.parent_b;
+}
+
+std::optional<std::size_t> GetSelectionBit(const PrimitiveOperation& operation) {
+  return operation.selection_bit;
+}
+
+std::optional<std::size_t> GetSelectionBit(const BinaryCircuitGate& gate) {
+  if (gate.selection_bit == kBinaryCircuitNoWire) return std::nullopt;
+  return gate.selection_bit;
+}
+
+// schedules the gates, which are PrimitiveOperations or BinaryCircuitGates
+template <typename Gate>
+CircuitSchedule FromGates(std::size_t number_of_wires, std::size_t number_of_output_wires,
+                          std::span<const Gate> gates) {
+  if (number_of_output_wires > number_of_wires) {
+    throw std::invalid_argument(fmt::format("CircuitSchedule: {} output wires of {} wires",
+                                            number_of_output_wires, number_of_wires));
+  }
+  CircuitSchedule schedule;
+  schedule.gate_layers.reserve(gates.size());
+  schedule.wire_layers.assign(number_of_wires, 0);
+  std::size_t number_of_layers{1};
+  for (const auto& gate : gates) {
+    std::size_t layer{schedule.wire_layers.at(gate.parent_a)};
+    if (const auto parent_b{GetParentB(gate)}) {
+      layer = std::max(layer, schedule.wire_layers.at(*parent_b));
+    }
+    if (const auto selection_bit{GetSelectionBit(gate)}) {
+      layer = std::max(layer, schedule.wire_layers.at(*selection_bit));
+    }
+    if (CircuitSchedule::IsInteractive(gate.type)) ++layer;
+    schedule.wire_layers.at(gate.output_wire) = layer;
+    schedule.gate_layers.push_back(layer);
+    number_of_layers = std::max(number_of_layers, layer + 1);
+  }
+
+  schedule.interactive_widths.assign(number_of_layers, 0);
+  schedule.local_widths.assign(number_of_layers, 0);
+  schedule.last_use_layers.assign(number_of_wires, std::nullopt);
+  auto use = [&schedule](std::size_t wire, std::size_t layer) {
+    auto& last_use{schedule.last_use_layers[wire]};
+    last_use = std::max(last_use.value_or(0), layer);
+  };
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    const auto& gate{gates[i]};
+    const std::size_t layer{schedule.gate_layers[i]};
+    if (CircuitSchedule::IsInteractive(gate.type)) {
+      ++schedule.interactive_widths[layer];
+    } else {
+      ++schedule.local_widths[layer];
+    }
+    use(gate.parent_a, layer);
+    if (const auto parent_b{GetParentB(gate)}) use(*parent_b, layer);
+    if (const auto selection_bit{GetSelectionBit(gate)}) use(*selection_bit, layer);
+  }
+  for (std::size_t wire = number_of_wires - number_of_output_wires; wire < number_of_wires;
+       ++wire) {
+    use(wire, number_of_layers);
+  }
+
+  // counting sort of the gates into the interactive and local slots of their layers, which keeps
+  // the circuit order within each slot
+  std::vector<std::size_t> interactive_begins(number_of_layers), local_begins(number_of_layers);
+  std::size_t offset{0};
+  for (std::size_t layer = 0; layer < number_of_layers; ++layer) {
+    interactive_begins[layer] = offset;
+    offset += schedule.interactive_widths[layer];
+    local_begins[layer] = offset;
+    offset += schedule.local_widths[layer];
+  }
+  schedule.order.resize(gates.size());
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    const std::size_t layer{schedule.gate_layers[i]};
+    auto& position{CircuitSchedule::IsInteractive(gates[i].type) ? interactive_begins[layer]
+                                                                 : local_begins[layer]};
+    schedule.order[position++] = i;
+  }
+  return schedule;
+}
+
+}  // namespace
+
+bool CircuitSchedule::IsInteractive(PrimitiveOperationType type) {
+  switch (type) {
+    case PrimitiveOperationType::kAnd:
+    case PrimitiveOperationType::kOr:
+    case PrimitiveOperationType::kMux:
+    case PrimitiveOperationType::kMul:
+    case PrimitiveOperationType::kSqr:
+      return true;
+    default:
+      return false;
+  }
+}
+
+CircuitSchedule CircuitSchedule::FromAlgorithmDescription(const AlgorithmDescription& algorithm) {
+  return FromGates(algorithm.number_of_wires, algorithm.number_of_output_wires,
+                   std::span<const PrimitiveOperation>(algorithm.gates));
+}
+
+CircuitSchedule CircuitSchedule::FromBinaryCircuit(const MappedBinaryCircuit& binary_circuit) {
+  const auto& header{binary_circuit.GetHeader()};
+  return FromGates(header.number_of_wires, header.number_of_output_wires,
+                   binary_circuit.GetGates());
+}
+
+}  // namespace encrypto::motion
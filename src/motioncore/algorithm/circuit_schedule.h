@@ -0,0 +1,71 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "flat_circuit.h"
+
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "algorithm_description.h"
+#include "binary_circuit.h"
+
+namespace encrypto::motion {
+
+// Layered schedule of the gates of an AlgorithmDescription, which is computed once when the
+// description is loaded (see AlgorithmDescription::schedule) and shared by FlatCircuit and
+// AssignProtocols instead of repeating the graph analysis for every instantiation. The layer of a
+// gate is its multiplicative depth: interactive gates (AND, OR, MUX, MUL and SQR) are one layer
+// deeper than their deepest parent and all other gates are in the layer of their deepest parent.
+// The local gates of a layer form the cluster that is evaluated after its interactive gates.
+struct CircuitSchedule {
+  static CircuitSchedule FromAlgorithmDescription(const AlgorithmDescription& algorithm);
+
+  static CircuitSchedule FromBinaryCircuit(const MappedBinaryCircuit& binary_circuit);
+
+  static bool IsInteractive(PrimitiveOperationType type);
+
+  std::size_t GetNumberOfLayers() const { return interactive_widths.size(); }
+
+  std::size_t GetMultiplicativeDepth() const { return GetNumberOfLayers() - 1; }
+
+  std::size_t GetNumberOfGates() const { return gate_layers.size(); }
+
+  // the layer of every gate and of every wire, which is 0 for the input wires
+  std::vector<std::size_t> gate_layers, wire_layers;
+
+  // the number of interactive and local gates of every layer, layer 0 has no interactive gates
+  std::vector<std::size_t> interactive_widths, local_widths;
+
+  // the gate indices sorted by layer and by interactive before local gates, otherwise in circuit
+  // order, since local gates may depend on each other
+  std::vector<std::size_t> order;
+
+  // the last layer in which every wire is read, GetNumberOfLayers() for the output wires and
+  // std::nullopt for unused wires
+  std::vector<std::optional<std::size_t>> last_use_layers;
+};
+
+}  // namespace encrypto::motion
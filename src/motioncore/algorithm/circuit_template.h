@@ -0,0 +1,56 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <memory>
+
+#include "algorithm_description.h"
+#include "flat_circuit.h"
+
+namespace encrypto::motion {
+
+// A Boolean subcircuit that is prepared once and instantiated many times via
+// ShareWrapper::Evaluate(const CircuitTemplate&), e.g., the AES or SHA-256 circuit for many
+// messages. It keeps the (optionally optimized) AlgorithmDescription and its FlatCircuit, such
+// that an instance neither re-optimizes nor re-parses the circuit: in Boolean GMW an instance is a
+// single CircuitGate sharing the FlatCircuit, and the other protocols build their gates from the
+// prepared description. A template does not depend on a backend and can be shared across parties.
+class CircuitTemplate {
+ public:
+  // \throws invalid_argument if algorithm contains other than XOR, AND, OR and INV operations
+  explicit CircuitTemplate(const AlgorithmDescription& algorithm, bool optimize = false);
+
+  const AlgorithmDescription& GetAlgorithmDescription() const { return algorithm_; }
+
+  const std::shared_ptr<const FlatCircuit>& GetFlatCircuit() const { return circuit_; }
+
+  std::size_t GetNumberOfInputWires() const { return circuit_->number_of_input_wires; }
+
+  std::size_t GetNumberOfOutputWires() const { return circuit_->number_of_output_wires; }
+
+ private:
+  AlgorithmDescription algorithm_;
+  std::shared_ptr<const FlatCircuit> circuit_;
+};
+
+}  // namespace encrypto::motion
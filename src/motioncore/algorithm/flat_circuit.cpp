@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "flat_circuit.h"
+
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "circuit_schedule.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+std::optional<std::size_t> GetParentB(const PrimitiveOperation& operation) {
+  return operation.parent_b;
+}
+
+std::optional<std::size_t> GetParentB(const BinaryCircuitGate& gate) {
+  if (gate.parent_b == kBinaryCircuitNoWire) return std::nullopt;
+  return gate.parent_b;
+}
+
+// builds the circuit of the gates, which are PrimitiveOperations or BinaryCircuitGates, in the
+// order of their schedule
+template <typename Gate>
+FlatCircuit FromGates(std::size_t number_of_input_wires, std::size_t number_of_output_wires,
+                      std::size_t number_of_wires, std::span<const Gate> gates,
+                      const CircuitSchedule& schedule) {
+  using Opcode = FlatCircuit::Opcode;
+  FlatCircuit circuit;
+  circuit.number_of_input_wires = number_of_input_wires;
+  circuit.number_of_output_wires = number_of_output_wires;
+  circuit.number_of_wires = number_of_wires;
+  if (circuit.number_of_output_wires > circuit.number_of_wires) {
+    throw std::invalid_argument(fmt::format("FlatCircuit: {} output wires of {} wires",
+                                            circuit.number_of_output_wires,
+                                            circuit.number_of_wires));
+  }
+  if (circuit.number_of_wires > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::invalid_argument(
+        fmt::format("FlatCircuit: {} wires exceed 32-bit indices", circuit.number_of_wires));
+  }
+
+  for (const auto& operation : gates) {
+    const bool is_binary{operation.type == PrimitiveOperationType::kXor ||
+                         operation.type == PrimitiveOperationType::kAnd ||
+                         operation.type == PrimitiveOperationType::kOr};
+    if ((!is_binary && operation.type != PrimitiveOperationType::kInv) ||
+        (is_binary && !GetParentB(operation))) {
+      throw std::invalid_argument(
+          fmt::format("FlatCircuit: unsupported primitive operation {} for output wire {}",
+                      static_cast<int>(operation.type),
+                      static_cast<std::size_t>(operation.output_wire)));
+    }
+  }
+
+  // the layers of the circuit are the layers of the schedule
+  const std::size_t number_of_layers{schedule.GetNumberOfLayers()};
+  const std::size_t number_of_operations{schedule.order.size()};
+  circuit.layer_begins.resize(number_of_layers + 1);
+  circuit.local_begins.resize(number_of_layers);
+  std::size_t offset{0};
+  for (std::size_t l = 0; l < number_of_layers; ++l) {
+    circuit.layer_begins[l] = offset;
+    circuit.local_begins[l] = offset + schedule.interactive_widths[l];
+    offset = circuit.local_begins[l] + schedule.local_widths[l];
+    circuit.number_of_interactive_operations += schedule.interactive_widths[l];
+  }
+  circuit.layer_begins[number_of_layers] = offset;
+
+  circuit.opcodes.reserve(number_of_operations);
+  circuit.parents_a.reserve(number_of_operations);
+  circuit.parents_b.reserve(number_of_operations);
+  circuit.outputs.reserve(number_of_operations);
+  for (const std::size_t index : schedule.order) {
+    const auto& operation{gates[index]};
+    switch (operation.type) {
+      case PrimitiveOperationType::kXor:
+        circuit.opcodes.push_back(Opcode::kXor);
+        break;
+      case PrimitiveOperationType::kAnd:
+        circuit.opcodes.push_back(Opcode::kAnd);
+        break;
+      case PrimitiveOperationType::kOr:
+        circuit.opcodes.push_back(Opcode::kOr);
+        break;
+      default:
+        circuit.opcodes.push_back(Opcode::kInv);
+    }
+    circuit.parents_a.push_back(operation.parent_a);
+    circuit.parents_b.push_back(GetParentB(operation).value_or(0));
+    circuit.outputs.push_back(operation.output_wire);
+  }
+  return circuit;
+}
+
+}  // namespace
+
+FlatCircuit FlatCircuit::FromAlgorithmDescription(const AlgorithmDescription& algorithm) {
+  return FromGates(algorithm.number_of_input_wires_parent_a +
+                       algorithm.number_of_input_wires_parent_b.value_or(0),
+                   algorithm.number_of_output_wires, algorithm.number_of_wires,
+                   std::span<const PrimitiveOperation>(algorithm.gates), *algorithm.GetSchedule());
+}
+
+FlatCircuit FlatCircuit::FromBinaryCircuit(const MappedBinaryCircuit& binary_circuit) {
+  const auto& header{binary_circuit.GetHeader()};
+  return FromGates(
+      header.number_of_input_wires_parent_a +
+          (header.has_parent_b ? header.number_of_input_wires_parent_b : 0),
+      header.number_of_output_wires, header.number_of_wires, binary_circuit.GetGates(),
+      CircuitSchedule::FromBinaryCircuit(binary_circuit));
+}
+
+}  // namespace encrypto::motion
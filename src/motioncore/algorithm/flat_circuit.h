@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "algorithm_description.h"
+#include "binary_circuit.h"
+
+namespace encrypto::motion {
+
+// Compact struct-of-arrays representation of a Boolean AlgorithmDescription of XOR, AND, OR and
+// INV gates, which is evaluated by an interpreter loop over indices into an array of wire values
+// instead of one Gate object per operation. The operations are sorted into layers by their AND
+// depth: layer l consists of the interactive AND and OR operations of depth l, which are
+// independent of each other, followed by the local XOR and INV operations of depth l in circuit
+// order. Layer 0 has no interactive operations.
+struct FlatCircuit {
+  enum class Opcode : std::uint8_t { kXor, kAnd, kOr, kInv };
+
+  static FlatCircuit FromAlgorithmDescription(const AlgorithmDescription& algorithm);
+
+  // builds the circuit directly from the gates of a memory-mapped binary circuit file
+  static FlatCircuit FromBinaryCircuit(const MappedBinaryCircuit& binary_circuit);
+
+  std::size_t GetNumberOfLayers() const { return layer_begins.size() - 1; }
+
+  std::size_t GetNumberOfOperations() const { return opcodes.size(); }
+
+  // the interactive operations of layer l are [layer_begins[l], local_begins[l]) and its local
+  // operations [local_begins[l], layer_begins[l + 1])
+  std::size_t GetNumberOfInteractiveOperations(std::size_t layer) const {
+    return local_begins[layer] - layer_begins[layer];
+  }
+
+  std::size_t number_of_input_wires{0}, number_of_output_wires{0}, number_of_wires{0};
+  std::size_t number_of_interactive_operations{0};
+
+  // one entry per operation, the second parent of INV operations is unused
+  std::vector<Opcode> opcodes;
+  std::vector<std::uint32_t> parents_a, parents_b, outputs;
+
+  std::vector<std::size_t> layer_begins, local_begins;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,417 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "floating_point_circuits.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "circuit_builder.h"
+
+namespace encrypto::motion::algorithm {
+
+using circuit_builder::Bits;
+using circuit_builder::CircuitBuilder;
+
+namespace {
+
+using circuit_builder::Wire;
+
+constexpr std::size_t kFractionBits{23}, kExponentBits{8}, kBitLength{32};
+// the exponents of intermediate results are 10-bit two's complement numbers
+constexpr std::size_t kExponentWidth{10};
+constexpr std::uint32_t kInfinity{0x7F800000}, kQuietNan{0x7FC00000};
+
+Bits Slice(const Bits& bits, std::size_t begin, std::size_t end) {
+  return Bits(bits.begin() + begin, bits.begin() + end);
+}
+
+Bits Concatenate(Bits low, const Bits& high) {
+  low.insert(low.end(), high.begin(), high.end());
+  return low;
+}
+
+Bits ZeroExtend(CircuitBuilder& builder, Bits bits, std::size_t n) {
+  while (bits.size() < n) bits.push_back(builder.Zero());
+  return bits;
+}
+
+Wire OrAll(CircuitBuilder& builder, const Bits& bits, bool low_depth) {
+  return builder.Inv(AndAll(builder, builder.Inv(bits), low_depth));
+}
+
+// x + carry_in modulo 2^n followed by the carry out, where the carry into bit i is the AND of
+// carry_in and the bits below i
+Bits Increment(CircuitBuilder& builder, const Bits& x, Wire carry_in, bool low_depth) {
+  const std::size_t n{x.size()};
+  Bits reversed(x.rbegin(), x.rend());
+  reversed.push_back(carry_in);
+  // suffixes[n - i] is the carry into bit i
+  const Bits suffixes{SuffixAnds(builder, reversed, low_depth)};
+  Bits result(n + 1);
+  for (std::size_t i = 0; i < n; ++i) result[i] = builder.Xor(x[i], suffixes[n - i]);
+  result[n] = suffixes[0];
+  return result;
+}
+
+// a - b modulo 2^n = ~(~a + b)
+Bits Subtract(CircuitBuilder& builder, const Bits& a, const Bits& b, bool low_depth) {
+  return builder.Inv(Add(builder, builder.Inv(a), b, low_depth));
+}
+
+// replaces x by value if condition is set, except for the sign bit if keep_sign is set
+void Override(CircuitBuilder& builder, Bits& x, Wire condition, std::uint32_t value,
+              bool keep_sign) {
+  const Wire not_condition{builder.Inv(condition)};
+  for (std::size_t i = 0; i < (keep_sign ? kBitLength - 1 : kBitLength); ++i) {
+    x[i] = ((value >> i) & 1) != 0 ? builder.Or(x[i], condition) : builder.And(x[i], not_condition);
+  }
+}
+
+// the fields of an operand, where the significand includes the hidden bit
+struct Operand {
+  Wire sign, is_zero, is_infinity, is_nan;
+  Bits exponent, significand;
+};
+
+// subnormal numbers are zero and have the significand 0 if flush_fraction is set, otherwise their
+// fraction is kept and the result needs to be replaced for zero operands
+Operand Decode(CircuitBuilder& builder, const Bits& x, bool flush_fraction, bool low_depth) {
+  Operand operand;
+  operand.sign = x[kBitLength - 1];
+  operand.exponent = Slice(x, kFractionBits, kBitLength - 1);
+  const Bits fraction{Slice(x, 0, kFractionBits)};
+  operand.is_zero = AndAll(builder, builder.Inv(operand.exponent), low_depth);
+  const Wire exponent_is_max{AndAll(builder, operand.exponent, low_depth)};
+  const Wire fraction_is_zero{AndAll(builder, builder.Inv(fraction), low_depth)};
+  operand.is_infinity = builder.And(exponent_is_max, fraction_is_zero);
+  operand.is_nan = builder.And(exponent_is_max, builder.Inv(fraction_is_zero));
+  const Wire is_normal{builder.Inv(operand.is_zero)};
+  operand.significand = fraction;
+  if (flush_fraction) {
+    for (auto& bit : operand.significand) bit = builder.And(bit, is_normal);
+  }
+  operand.significand.push_back(is_normal);
+  return operand;
+}
+
+// rounds the fraction with the guard and sticky bits below it to nearest even and packs the
+// result, which is infinity if the 10-bit exponent is at least 255 and zero if it is at most 0
+Bits RoundAndPack(CircuitBuilder& builder, Wire sign, const Bits& exponent, const Bits& fraction,
+                  Wire guard, Wire sticky, bool low_depth) {
+  const Wire round_up{builder.And(guard, builder.Or(sticky, fraction[0]))};
+  const Bits rounded_fraction{Increment(builder, fraction, round_up, low_depth)};
+  // a carry out of the fraction yields the significand 2 = 1.0 * 2^1
+  const Bits rounded_exponent{
+      Slice(Increment(builder, exponent, rounded_fraction.back(), low_depth), 0, kExponentWidth)};
+  const Wire is_negative{rounded_exponent.back()};
+  const Wire underflow{builder.Or(
+      is_negative, AndAll(builder, builder.Inv(rounded_exponent), low_depth))};
+  const Wire overflow{builder.And(
+      builder.Inv(is_negative),
+      builder.Or(rounded_exponent[kExponentBits],
+                 AndAll(builder, Slice(rounded_exponent, 0, kExponentBits), low_depth)))};
+
+  Bits result{Slice(rounded_fraction, 0, kFractionBits)};
+  result = Concatenate(result, Slice(rounded_exponent, 0, kExponentBits));
+  result.push_back(sign);
+  Override(builder, result, underflow, 0, true);
+  Override(builder, result, overflow, kInfinity, true);
+  return result;
+}
+
+Bits FloatAdd(CircuitBuilder& builder, const Bits& x, Bits y, bool subtract, bool low_depth) {
+  if (subtract) y.back() = builder.Inv(y.back());
+  const Operand a{Decode(builder, x, true, low_depth)}, b{Decode(builder, y, true, low_depth)};
+
+  // swap the operands such that |big| >= |small|
+  const Bits a_magnitude{Concatenate(Slice(a.significand, 0, kFractionBits), a.exponent)};
+  const Bits b_magnitude{Concatenate(Slice(b.significand, 0, kFractionBits), b.exponent)};
+  const Wire swap{CarryOut(builder, b_magnitude, builder.Inv(a_magnitude), low_depth)};
+  auto conditional_swap = [&builder, swap](const Bits& u, const Bits& v) {
+    Bits big(u.size()), small(u.size());
+    for (std::size_t i = 0; i < u.size(); ++i) {
+      const Wire difference{builder.And(swap, builder.Xor(u[i], v[i]))};
+      big[i] = builder.Xor(u[i], difference);
+      small[i] = builder.Xor(v[i], difference);
+    }
+    return std::pair{big, small};
+  };
+  const auto [big_sign, small_sign] = conditional_swap({a.sign}, {b.sign});
+  const auto [big_exponent, small_exponent] = conditional_swap(a.exponent, b.exponent);
+  const auto [big_significand, small_significand] =
+      conditional_swap(a.significand, b.significand);
+
+  // shift the smaller significand with a guard and a round bit right by the exponent difference
+  // and collect the shifted out bits in the sticky bit
+  const Bits difference{Subtract(builder, big_exponent, small_exponent, low_depth)};
+  Bits aligned{Concatenate({builder.Zero(), builder.Zero()}, small_significand)};
+  Wire sticky{builder.Zero()};
+  for (std::size_t k = 0; k < 5; ++k) {
+    const std::size_t shift{std::size_t(1) << k};
+    const Wire condition{difference[k]};
+    const Wire lost{OrAll(builder, Slice(aligned, 0, std::min(shift, aligned.size())), low_depth)};
+    sticky = builder.Or(sticky, builder.And(condition, lost));
+    Bits shifted(aligned.size());
+    for (std::size_t i = 0; i < aligned.size(); ++i) {
+      shifted[i] = i + shift < aligned.size() ? aligned[i + shift] : builder.Zero();
+    }
+    aligned = builder.Mux(condition, shifted, aligned);
+  }
+  // differences of 32 and more shift out all bits
+  const Wire is_far{OrAll(builder, Slice(difference, 5, kExponentBits), low_depth)};
+  sticky = builder.Or(sticky, builder.And(is_far, OrAll(builder, aligned, low_depth)));
+  const Wire is_near{builder.Inv(is_far)};
+  for (auto& bit : aligned) bit = builder.And(bit, is_near);
+
+  // big + (small ^ s) + s with the carry in s as an additional least significant bit, where
+  // s is set for an effective subtraction
+  const Wire is_subtraction{builder.Xor(a.sign, b.sign)};
+  const Bits small_bits{Concatenate({sticky}, aligned)};
+  Bits u{builder.One(), builder.Zero(), builder.Zero(), builder.Zero()};
+  u = Concatenate(u, big_significand);
+  Bits v{is_subtraction};
+  for (const Wire bit : small_bits) v.push_back(builder.Xor(bit, is_subtraction));
+  const Bits sum{Add(builder, u, v, low_depth, true)};
+  // the carry out of a subtraction only indicates that the difference is not negative
+  Bits total{Slice(sum, 1, sum.size() - 1)};
+  total.push_back(builder.And(sum.back(), builder.Inv(is_subtraction)));
+
+  // shift left until the most significant bit is set
+  const std::size_t n{total.size()};
+  Bits leading_zeros(5);
+  for (std::size_t k = 5; k-- > 0;) {
+    const std::size_t shift{std::size_t(1) << k};
+    const Wire condition{AndAll(builder, builder.Inv(Slice(total, n - shift, n)), low_depth)};
+    leading_zeros[k] = condition;
+    Bits shifted(n);
+    for (std::size_t i = 0; i < n; ++i) shifted[i] = i >= shift ? total[i - shift] : builder.Zero();
+    total = builder.Mux(condition, shifted, total);
+  }
+  const Wire is_zero{builder.Inv(total.back())};
+
+  // the most significant bit of the sum has the exponent of big plus 1
+  const Bits exponent{Subtract(
+      builder,
+      Add(builder, ZeroExtend(builder, big_exponent, kExponentWidth),
+          builder.Constant(1, kExponentWidth), low_depth),
+      ZeroExtend(builder, leading_zeros, kExponentWidth), low_depth)};
+  // an exact zero is +0 for an effective subtraction and has the sign of the operands otherwise
+  const Wire sign{builder.And(big_sign[0], builder.Inv(builder.And(is_subtraction, is_zero)))};
+  Bits result{RoundAndPack(builder, sign, exponent, Slice(total, n - 1 - kFractionBits, n - 1),
+                           total[n - 2 - kFractionBits],
+                           OrAll(builder, Slice(total, 0, n - 2 - kFractionBits), low_depth),
+                           low_depth)};
+  Override(builder, result, is_zero, 0, true);
+  Override(builder, result, builder.Or(a.is_infinity, b.is_infinity), kInfinity, true);
+  const Wire is_nan{builder.Or(
+      builder.Or(a.is_nan, b.is_nan),
+      builder.And(is_subtraction, builder.And(a.is_infinity, b.is_infinity)))};
+  Override(builder, result, is_nan, kQuietNan, false);
+  return result;
+}
+
+Bits FloatMultiply(CircuitBuilder& builder, const Bits& x, const Bits& y, bool low_depth) {
+  const Operand a{Decode(builder, x, false, low_depth)}, b{Decode(builder, y, false, low_depth)};
+  const std::size_t n{a.significand.size()};
+  // the product of the significands in [1, 4) has 2n - 2 fraction bits
+  const Bits product{Multiply(builder, a.significand, b.significand, low_depth, 2 * n)};
+  const Wire is_high{product[2 * n - 1]};
+  const Bits fraction{builder.Mux(is_high, Slice(product, n, 2 * n - 1),
+                                  Slice(product, n - 1, 2 * n - 2))};
+  const Wire guard{builder.Mux(is_high, product[n - 1], product[n - 2])};
+  const Wire sticky{builder.Or(OrAll(builder, Slice(product, 0, n - 2), low_depth),
+                               builder.And(is_high, product[n - 2]))};
+  // e_a + e_b - 127 + is_high
+  const Bits exponent_sum{Add(builder,
+                              Add(builder, ZeroExtend(builder, a.exponent, kExponentWidth),
+                                  ZeroExtend(builder, b.exponent, kExponentWidth), low_depth),
+                              builder.Constant((1 << kExponentWidth) - 127, kExponentWidth),
+                              low_depth)};
+  const Bits exponent{
+      Slice(Increment(builder, exponent_sum, is_high, low_depth), 0, kExponentWidth)};
+  Bits result{RoundAndPack(builder, builder.Xor(a.sign, b.sign), exponent, fraction, guard, sticky,
+                           low_depth)};
+  Override(builder, result, builder.Or(a.is_zero, b.is_zero), 0, true);
+  Override(builder, result, builder.Or(a.is_infinity, b.is_infinity), kInfinity, true);
+  const Wire is_nan{builder.Or(builder.Or(a.is_nan, b.is_nan),
+                               builder.Or(builder.And(a.is_infinity, b.is_zero),
+                                          builder.And(a.is_zero, b.is_infinity)))};
+  Override(builder, result, is_nan, kQuietNan, false);
+  return result;
+}
+
+Bits FloatDivide(CircuitBuilder& builder, const Bits& x, const Bits& y, bool low_depth) {
+  const Operand a{Decode(builder, x, false, low_depth)}, b{Decode(builder, y, false, low_depth)};
+  const std::size_t n{a.significand.size()};
+  // restoring division of m_a * 2^(n + 1) by m_b, whose quotient has n + 2 bits, the remainder is
+  // below m_b < 2^n and shifted into n + 1 bits before each step
+  const Bits divisor{ZeroExtend(builder, b.significand, n + 1)};
+  Bits quotient(n + 2), remainder{a.significand};
+  for (std::size_t k = n + 2; k-- > 0;) {
+    const Bits t{k == n + 1 ? ZeroExtend(builder, remainder, n + 1)
+                            : Concatenate({builder.Zero()}, remainder)};
+    const Bits sum{Add(builder, builder.Inv(t), divisor, low_depth, true)};
+    quotient[k] = builder.Inv(sum.back());
+    remainder = Slice(builder.Mux(quotient[k], builder.Inv(Slice(sum, 0, n + 1)), t), 0, n);
+  }
+  const Wire is_high{quotient[n + 1]};
+  const Bits fraction{builder.Mux(is_high, Slice(quotient, 2, n + 1), Slice(quotient, 1, n))};
+  const Wire guard{builder.Mux(is_high, quotient[1], quotient[0])};
+  const Wire sticky{
+      builder.Or(OrAll(builder, remainder, low_depth), builder.And(is_high, quotient[0]))};
+  // e_a - e_b + 126 + is_high = e_a + ~e_b + 127 + is_high
+  const Bits exponent_difference{
+      Add(builder,
+          Add(builder, ZeroExtend(builder, a.exponent, kExponentWidth),
+              builder.Inv(ZeroExtend(builder, b.exponent, kExponentWidth)), low_depth),
+          builder.Constant(127, kExponentWidth), low_depth)};
+  const Bits exponent{
+      Slice(Increment(builder, exponent_difference, is_high, low_depth), 0, kExponentWidth)};
+  Bits result{RoundAndPack(builder, builder.Xor(a.sign, b.sign), exponent, fraction, guard, sticky,
+                           low_depth)};
+  Override(builder, result, builder.Or(a.is_zero, b.is_infinity), 0, true);
+  Override(builder, result, builder.Or(a.is_infinity, b.is_zero), kInfinity, true);
+  const Wire is_nan{builder.Or(builder.Or(a.is_nan, b.is_nan),
+                               builder.Or(builder.And(a.is_zero, b.is_zero),
+                                          builder.And(a.is_infinity, b.is_infinity)))};
+  Override(builder, result, is_nan, kQuietNan, false);
+  return result;
+}
+
+Bits FloatSquareRoot(CircuitBuilder& builder, const Bits& x, bool low_depth) {
+  const Operand a{Decode(builder, x, false, low_depth)};
+  const std::size_t n{a.significand.size()};
+  // for an even exponent e, e - 127 is odd and the significand is doubled, such that the root of
+  // the radicand m * 2^(n + 1) or 2m * 2^(n + 1) has n + 1 bits and the exponent (e + 127) / 2
+  const Wire is_odd_power{builder.Inv(a.exponent[0])};
+  Bits radicand_high(n + 1);
+  for (std::size_t j = 0; j <= n; ++j) {
+    radicand_high[j] = builder.Mux(is_odd_power, j > 0 ? a.significand[j - 1] : builder.Zero(),
+                                   j < n ? a.significand[j] : builder.Zero());
+  }
+  Bits radicand(n + 1, builder.Zero());
+  radicand = Concatenate(radicand, radicand_high);
+
+  // restoring square root: in step j, the remainder r <= 2q of the root q of j - 1 bits is
+  // shifted by the next two bits of the radicand and compared to 4q + 1
+  Bits root, remainder;
+  for (std::size_t j = 1; j <= n + 1; ++j) {
+    const std::size_t i{n + 1 - j}, width{j + 2};
+    const Bits shifted_remainder{ZeroExtend(
+        builder, Concatenate({radicand[2 * i], radicand[2 * i + 1]}, remainder), width)};
+    const Bits trial{
+        ZeroExtend(builder, Concatenate({builder.One(), builder.Zero()}, root), width)};
+    const Bits sum{Add(builder, builder.Inv(shifted_remainder), trial, low_depth, true)};
+    const Wire bit{builder.Inv(sum.back())};
+    remainder = Slice(
+        builder.Mux(bit, builder.Inv(Slice(sum, 0, width)), shifted_remainder), 0, j + 1);
+    root = Concatenate({bit}, root);
+  }
+  const Bits exponent{ZeroExtend(
+      builder,
+      Slice(Add(builder, ZeroExtend(builder, a.exponent, kExponentBits + 1),
+                builder.Constant(127, kExponentBits + 1), low_depth),
+            1, kExponentBits + 1),
+      kExponentWidth)};
+  Bits result{RoundAndPack(builder, a.sign, exponent, Slice(root, 1, n), root[0],
+                           OrAll(builder, remainder, low_depth), low_depth)};
+  Override(builder, result, a.is_zero, 0, true);
+  Override(builder, result, a.is_infinity, kInfinity, true);
+  const Wire is_nan{
+      builder.Or(a.is_nan, builder.And(a.sign, builder.Inv(a.is_zero)))};
+  Override(builder, result, is_nan, kQuietNan, false);
+  return result;
+}
+
+Wire FloatCompare(CircuitBuilder& builder, FloatingPointOperationType type, const Bits& x,
+                  const Bits& y, bool low_depth) {
+  const Operand a{Decode(builder, x, true, low_depth)}, b{Decode(builder, y, true, low_depth)};
+  const Bits a_magnitude{Concatenate(Slice(a.significand, 0, kFractionBits), a.exponent)};
+  const Bits b_magnitude{Concatenate(Slice(b.significand, 0, kFractionBits), b.exponent)};
+  const Wire is_ordered{builder.Inv(builder.Or(a.is_nan, b.is_nan))};
+  const Wire both_are_zero{builder.And(a.is_zero, b.is_zero)};
+  const Wire signs_are_equal{builder.Inv(builder.Xor(a.sign, b.sign))};
+  // -0 < +0 is excluded by both_are_zero
+  const Wire a_is_negative_b_is_not{builder.And(a.sign, builder.Inv(b.sign))};
+  if (type == FloatingPointOperationType::kEq) {
+    Bits equal_bits(a_magnitude.size());
+    for (std::size_t i = 0; i < equal_bits.size(); ++i) {
+      equal_bits[i] = builder.Inv(builder.Xor(a_magnitude[i], b_magnitude[i]));
+    }
+    const Wire is_equal{builder.And(signs_are_equal, AndAll(builder, equal_bits, true))};
+    return builder.And(is_ordered, builder.Or(both_are_zero, is_equal));
+  }
+  // |a| < |b| and |a| > |b|
+  const Wire magnitude_is_less{CarryOut(builder, b_magnitude, builder.Inv(a_magnitude), low_depth)};
+  const Wire magnitude_is_greater{
+      CarryOut(builder, a_magnitude, builder.Inv(b_magnitude), low_depth)};
+  if (type == FloatingPointOperationType::kLt) {
+    // a < b for equal signs iff |a| < |b| for positive and |a| > |b| for negative numbers
+    const Wire is_less_with_equal_signs{builder.And(
+        signs_are_equal, builder.Mux(a.sign, magnitude_is_greater, magnitude_is_less))};
+    return builder.And(builder.And(is_ordered, builder.Inv(both_are_zero)),
+                       builder.Xor(a_is_negative_b_is_not, is_less_with_equal_signs));
+  }
+  const Wire is_less_equal_with_equal_signs{
+      builder.And(signs_are_equal, builder.Inv(builder.Mux(a.sign, magnitude_is_less,
+                                                           magnitude_is_greater)))};
+  return builder.And(is_ordered,
+                     builder.Or(both_are_zero, builder.Xor(a_is_negative_b_is_not,
+                                                           is_less_equal_with_equal_signs)));
+}
+
+}  // namespace
+
+AlgorithmDescription FloatingPointCircuit(FloatingPointOperationType type,
+                                          IntegerCircuitOptimization optimization) {
+  const bool low_depth{optimization == IntegerCircuitOptimization::kDepth};
+  const bool is_unary{type == FloatingPointOperationType::kSqrt};
+  CircuitBuilder builder(kBitLength, is_unary ? 1 : 2);
+  const Bits a{builder.Operand(0)};
+  const Bits b{is_unary ? Bits{} : builder.Operand(1)};
+  switch (type) {
+    case FloatingPointOperationType::kAdd:
+      return builder.Finish(FloatAdd(builder, a, b, false, low_depth));
+    case FloatingPointOperationType::kSub:
+      return builder.Finish(FloatAdd(builder, a, b, true, low_depth));
+    case FloatingPointOperationType::kMul:
+      return builder.Finish(FloatMultiply(builder, a, b, low_depth));
+    case FloatingPointOperationType::kDiv:
+      return builder.Finish(FloatDivide(builder, a, b, low_depth));
+    case FloatingPointOperationType::kSqrt:
+      return builder.Finish(FloatSquareRoot(builder, a, low_depth));
+    case FloatingPointOperationType::kLt:
+    case FloatingPointOperationType::kLe:
+    case FloatingPointOperationType::kEq:
+      return builder.Finish({FloatCompare(builder, type, a, b, low_depth)});
+    default:
+      throw std::invalid_argument(
+          fmt::format("FloatingPointCircuit: invalid operation {}", static_cast<unsigned>(type)));
+  }
+}
+
+}  // namespace encrypto::motion::algorithm
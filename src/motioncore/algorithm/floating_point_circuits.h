@@ -0,0 +1,49 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "algorithm_description.h"
+#include "integer_circuits.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief creates the Boolean circuit of the operation type on IEEE-754 single-precision numbers,
+/// whose operands are the input wires 0, ..., 31 of parent a and 32, ..., 63 of parent b with the
+/// least significant bit first, i.e., 23 fraction bits, 8 exponent bits and the sign bit. kSqrt has
+/// only parent a. kAdd, kSub, kMul, kDiv and kSqrt output the 32 wires of the result rounded to
+/// nearest even, kLt, kLe and kEq a single wire, which is 0 if an operand is NaN. Subnormal
+/// operands are treated as zero and subnormal results are flushed to zero. Infinities are handled
+/// as in IEEE-754, whereas NaN operands and invalid operations, e.g., 0 / 0 or the square root of a
+/// negative number, result in the quiet NaN 0x7FC00000.
+/// kSize uses the ripple-carry adders and comparators and the schoolbook multiplication of
+/// IntegerCircuit, kDepth its parallel-prefix adders and the Dadda tree multiplier and balanced
+/// trees for all ANDs and ORs of many bits. Division and square root are restoring with one
+/// subtraction per bit of the result.
+/// \throws std::invalid_argument if type is kInvalid.
+AlgorithmDescription FloatingPointCircuit(FloatingPointOperationType type,
+                                          IntegerCircuitOptimization optimization);
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,144 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "histogram.h"
+
+#include <fmt/format.h>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "algorithm/array_circuits.h"
+#include "algorithm/circuit_template.h"
+#include "base/backend.h"
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
+#include "protocols/share.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+const CircuitTemplate& GetOneHotCircuit(std::size_t number_of_outputs,
+                                        std::size_t index_bit_length) {
+  static std::mutex mutex;
+  static std::map<std::pair<std::size_t, std::size_t>, std::unique_ptr<const CircuitTemplate>>
+      cache;
+  std::scoped_lock lock(mutex);
+  auto& circuit{cache[{number_of_outputs, index_bit_length}]};
+  if (!circuit) {
+    circuit = std::make_unique<const CircuitTemplate>(
+        OneHotCircuit(number_of_outputs, index_bit_length));
+  }
+  return *circuit;
+}
+
+template <typename T>
+ShareWrapper RowSum(const ShareWrapper& matrix, std::size_t rows) {
+  auto share = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(matrix.Get());
+  assert(share);
+  const auto register_pointer{share->GetRegister()};
+  auto row_sum_gate{register_pointer->template EmplaceGate<proto::arithmetic_gmw::RowSumGate<T>>(
+      share->GetArithmeticWire(), rows)};
+  return ShareWrapper(std::static_pointer_cast<Share>(row_sum_gate->GetOutputAsArithmeticShare()));
+}
+
+}  // namespace
+
+ShareWrapper OneHotBins(const ShareWrapper& bins, std::size_t number_of_bins,
+                        std::size_t first_bin) {
+  const std::size_t bit_length{bins->GetBitLength()};
+  const std::size_t number_of_outputs{first_bin + number_of_bins};
+  if (bins->GetCircuitType() != CircuitType::kBoolean || number_of_bins == 0 || bit_length == 0 ||
+      bit_length > 64 || (bit_length < 64 && number_of_outputs > (std::size_t(1) << bit_length))) {
+    throw std::invalid_argument(fmt::format(
+        "OneHotBins: cannot encode the bins {}, ..., {} of a {} share of {} wires", first_bin,
+        number_of_outputs - 1, to_string(bins->GetProtocol()), bit_length));
+  }
+  ShareWrapper one_hot;
+  if (bins->GetProtocol() == MpcProtocol::kBooleanGmw && bit_length <= 8 &&
+      bins->GetBackend().GetCommunicationLayer().GetNumberOfParties() == 2) {
+    std::vector<BitVector<>> table(std::size_t(1) << bit_length, BitVector<>(number_of_bins));
+    for (std::size_t j = 0; j < number_of_bins; ++j) table[first_bin + j].Set(true, j);
+    one_hot = bins.Lut(table);
+  } else {
+    one_hot = bins.Evaluate(GetOneHotCircuit(number_of_outputs, bit_length));
+    if (bins->GetProtocol() != MpcProtocol::kBooleanGmw) {
+      one_hot = one_hot.Convert<MpcProtocol::kBooleanGmw>();
+    }
+  }
+  // the indicators of the bins below first_bin are dropped
+  auto wires{one_hot.Split()};
+  wires.erase(wires.begin(), wires.begin() + (one_hot->GetBitLength() - number_of_bins));
+  return ShareWrapper::Simdify(wires);
+}
+
+ShareWrapper Histogram(const ShareWrapper& bins, std::size_t number_of_bins,
+                       std::size_t bit_length, std::size_t first_bin) {
+  return RowSums(OneHotBins(bins, number_of_bins, first_bin).BitsToArithmeticGmw(bit_length),
+                 number_of_bins);
+}
+
+ShareWrapper RowSums(const ShareWrapper& matrix, std::size_t rows) {
+  if (matrix->GetProtocol() != MpcProtocol::kArithmeticGmw || rows == 0 ||
+      matrix->GetNumberOfSimdValues() % rows != 0) {
+    throw std::invalid_argument(fmt::format(
+        "RowSums expects an arithmetic GMW share of a multiple of {} SIMD values, got a {} share "
+        "of {} SIMD values",
+        rows, to_string(matrix->GetProtocol()), matrix->GetNumberOfSimdValues()));
+  }
+  switch (matrix->GetBitLength()) {
+    case 8u:
+      return RowSum<std::uint8_t>(matrix, rows);
+    case 16u:
+      return RowSum<std::uint16_t>(matrix, rows);
+    case 32u:
+      return RowSum<std::uint32_t>(matrix, rows);
+    default:
+      return RowSum<std::uint64_t>(matrix, rows);
+  }
+}
+
+ShareWrapper GroupBySum(const ShareWrapper& bins, const ShareWrapper& values,
+                        std::size_t number_of_bins, std::size_t first_bin) {
+  const std::size_t number_of_records{bins->GetNumberOfSimdValues()};
+  if (values->GetProtocol() != MpcProtocol::kArithmeticGmw ||
+      values->GetNumberOfSimdValues() != number_of_records) {
+    throw std::invalid_argument(fmt::format(
+        "GroupBySum expects an arithmetic GMW share of {} SIMD values, got a {} share of {} SIMD "
+        "values",
+        number_of_records, to_string(values->GetProtocol()), values->GetNumberOfSimdValues()));
+  }
+  const auto one_hot{
+      OneHotBins(bins, number_of_bins, first_bin).BitsToArithmeticGmw(values->GetBitLength())};
+  return MatrixMultiplication(one_hot, values, number_of_bins, number_of_records, 1);
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,66 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief returns the Boolean GMW share of one wire with number_of_bins * N SIMD values of the
+/// indicators [x_i == first_bin + j] of the bins x_i of the N records, which are the SIMD values of
+/// the Boolean share bins, in row-major order, i.e., SIMD value j * N + i for bin j and record i.
+/// Two-party Boolean GMW bins of up to 8 wires are encoded by ShareWrapper::Lut with one
+/// 1-out-of-2^w OT per record, others by the circuit algorithm::OneHotCircuit.
+/// \throws invalid_argument if bins is not a Boolean share or first_bin + number_of_bins exceeds
+/// the values of its wires.
+ShareWrapper OneHotBins(const ShareWrapper& bins, std::size_t number_of_bins,
+                        std::size_t first_bin = 0);
+
+/// \brief returns the arithmetic GMW share of bit_length = 8, 16, 32, 64 bits with number_of_bins
+/// SIMD values of the number of records in each of the bins first_bin, ..., first_bin +
+/// number_of_bins - 1, whose one-hot encodings of OneHotBins are converted with
+/// ShareWrapper::BitsToArithmeticGmw and summed locally. Records of other bins are not counted,
+/// such that many bins can be counted in sets to bound the memory of number_of_bins * N values.
+ShareWrapper Histogram(const ShareWrapper& bins, std::size_t number_of_bins,
+                       std::size_t bit_length, std::size_t first_bin = 0);
+
+/// \brief returns the arithmetic GMW share with rows SIMD values of the sums of the rows of the
+/// rows x N matrix, whose elements are the SIMD values of the arithmetic GMW share matrix in
+/// row-major order. The sums are computed locally.
+/// \throws invalid_argument if matrix is not an arithmetic GMW share of a multiple of rows SIMD
+/// values.
+ShareWrapper RowSums(const ShareWrapper& matrix, std::size_t rows);
+
+/// \brief returns the arithmetic GMW share with number_of_bins SIMD values of the sums of the
+/// values of the records in each bin like Histogram, where values is an arithmetic GMW share with
+/// a SIMD value per record. The sums are a single matrix multiplication of the number_of_bins x N
+/// one-hot matrix and the values, i.e., one opening of number_of_bins * N + N masked values.
+/// \throws invalid_argument if values is not an arithmetic GMW share with the SIMD values of bins.
+ShareWrapper GroupBySum(const ShareWrapper& bins, const ShareWrapper& values,
+                        std::size_t number_of_bins, std::size_t first_bin = 0);
+
+}  // namespace encrypto::motion::algorithm
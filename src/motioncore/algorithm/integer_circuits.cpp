@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "integer_circuits.h"
+
+#include <bit>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "circuit_builder.h"
+#include "circuit_optimizer.h"
+
+namespace encrypto::motion::algorithm {
+
+using circuit_builder::Bits;
+using circuit_builder::CircuitBuilder;
+
+AlgorithmDescription IntegerCircuit(IntegerOperationType type, std::size_t bit_length,
+                                    IntegerCircuitOptimization optimization) {
+  if (bit_length == 0) {
+    throw std::invalid_argument("IntegerCircuit: the bit length must be positive");
+  }
+  const bool low_depth{optimization == IntegerCircuitOptimization::kDepth};
+  CircuitBuilder builder(bit_length);
+  const Bits a{builder.Operand(0)}, b{builder.Operand(1)};
+  switch (type) {
+    case IntegerOperationType::kAdd:
+      return builder.Finish(Add(builder, a, b, low_depth));
+    case IntegerOperationType::kSub: {
+      // a - b = ~(~a + b)
+      const Bits sum{Add(builder, builder.Inv(a), b, low_depth)};
+      return builder.Finish(builder.Inv(sum));
+    }
+    case IntegerOperationType::kMul:
+      return builder.Finish(Multiply(builder, a, b, low_depth));
+    case IntegerOperationType::kDiv:
+      return builder.Finish(Divide(builder, a, b, low_depth));
+    case IntegerOperationType::kGt:
+      // a + ~b = a + 2^n - 1 - b >= 2^n iff a > b
+      return builder.Finish({CarryOut(builder, a, builder.Inv(b), low_depth)});
+    case IntegerOperationType::kEq: {
+      Bits equal(bit_length);
+      for (std::size_t i = 0; i < bit_length; ++i) equal[i] = builder.Inv(builder.Xor(a[i], b[i]));
+      return builder.Finish({AndAll(builder, std::move(equal), true)});
+    }
+    default:
+      throw std::invalid_argument(
+          fmt::format("IntegerCircuit: invalid operation {}", static_cast<unsigned>(type)));
+  }
+}
+
+AlgorithmDescription IntegerDivisionByConstantCircuit(std::uint64_t divisor,
+                                                      std::size_t bit_length,
+                                                      IntegerCircuitOptimization optimization) {
+  if (bit_length == 0 || bit_length > 64) {
+    throw std::invalid_argument(fmt::format(
+        "IntegerDivisionByConstantCircuit: invalid bit length {}, expected 1 to 64", bit_length));
+  }
+  if (divisor == 0 || (bit_length < 64 && divisor >> bit_length != 0)) {
+    throw std::invalid_argument(fmt::format(
+        "IntegerDivisionByConstantCircuit: invalid divisor {} for {} bits", divisor, bit_length));
+  }
+  const bool low_depth{optimization == IntegerCircuitOptimization::kDepth};
+  CircuitBuilder builder(bit_length, 1);
+  const Bits a{builder.Operand(0)};
+  Bits quotient;
+  if (std::has_single_bit(divisor)) {
+    quotient.assign(a.begin() + std::countr_zero(divisor), a.end());
+  } else {
+    const std::size_t l{static_cast<std::size_t>(std::bit_width(divisor - 1))};
+    const auto magic_number{static_cast<std::uint64_t>(
+        (((__uint128_t(1) << l) - divisor) << bit_length) / divisor + 1)};
+    const Bits product{Multiply(builder, a, builder.Constant(magic_number, bit_length), low_depth,
+                                2 * bit_length)};
+    const Bits t(product.begin() + bit_length, product.end());
+    // (x - t) >> 1 = ~(~x + t) >> 1, which does not overflow since t <= x
+    const Bits difference{builder.Inv(Add(builder, builder.Inv(a), t, low_depth))};
+    Bits half_difference(difference.begin() + 1, difference.end());
+    half_difference.push_back(builder.Zero());
+    const Bits sum{Add(builder, t, half_difference, low_depth, true)};
+    quotient.assign(sum.begin() + (l - 1), sum.end());
+  }
+  quotient.resize(bit_length, builder.Zero());
+  return OptimizeAlgorithmDescription(builder.Finish(quotient));
+}
+
+AlgorithmDescription IntegerNormalizationCircuit(std::size_t bit_length,
+                                                 std::size_t number_of_scale_bits,
+                                                 IntegerCircuitOptimization optimization) {
+  const std::size_t f{number_of_scale_bits};
+  if (f == 0 || f > bit_length) {
+    throw std::invalid_argument(fmt::format(
+        "IntegerNormalizationCircuit: invalid number of scale bits {} for {} bits", f, bit_length));
+  }
+  CircuitBuilder builder(bit_length, 1);
+  const Bits x{builder.Operand(0)};
+  // any_from[j] = x_j | ... | x_(f - 1), where any_from[0] is set to map 0 to bit width 1
+  const Bits none_from{SuffixAnds(builder, builder.Inv(Bits(x.begin(), x.begin() + f)),
+                                  optimization == IntegerCircuitOptimization::kDepth)};
+  Bits any_from{builder.Inv(none_from)};
+  any_from[0] = builder.One();
+  any_from.push_back(builder.Zero());
+  // bit_width(x) = f - p iff any_from[f - 1 - p] is set and any_from[f - p] is not
+  Bits scale(f);
+  for (std::size_t p = 0; p < f; ++p) scale[p] = builder.Xor(any_from[f - 1 - p], any_from[f - p]);
+  return OptimizeAlgorithmDescription(builder.Finish(scale));
+}
+
+}  // namespace encrypto::motion::algorithm
+
@@ -0,0 +1,74 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "algorithm_description.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion::algorithm {
+
+enum class IntegerCircuitOptimization { kSize, kDepth };
+
+/// \brief creates the Boolean circuit of the operation type on two unsigned integers of bit_length
+/// bits, which replaces the int_* Bristol circuits for any bit length. The operands are the input
+/// wires 0, ..., bit_length - 1 of parent a and bit_length, ..., 2 * bit_length - 1 of parent b
+/// with the least significant bit first. kAdd, kSub and kMul output bit_length wires modulo
+/// 2^bit_length, kDiv the bit_length wires of the quotient rounded down, where x / 0 is
+/// 2^bit_length - 1, and kGt and kEq a single wire.
+/// kSize uses ripple-carry adders and comparators, schoolbook multiplication and restoring
+/// division with about bit_length, bit_length^2 and 1.25 * bit_length^2 AND gates. kDepth uses
+/// Sklansky (Ladner-Fischer) parallel-prefix adders and comparators of logarithmic AND depth, a
+/// Dadda tree of full adders for the partial products of multiplication and parallel-prefix
+/// subtractors in each step of the division.
+/// \throws std::invalid_argument if bit_length is 0 or type is kInvalid.
+AlgorithmDescription IntegerCircuit(IntegerOperationType type, std::size_t bit_length,
+                                    IntegerCircuitOptimization optimization);
+
+/// \brief creates the Boolean circuit of x / divisor rounded down for the public divisor and an
+/// unsigned integer x of bit_length <= 64 bits, which are the input wires of parent a. Powers of
+/// two are shifted without gates. Other divisors d use the multiplication by the magic number
+/// m = floor(2^n * (2^l - d) / d) + 1 with l = ceil(log2(d)) of Granlund and Montgomery, i.e.,
+/// x / d = (t + ((x - t) >> 1)) >> (l - 1) for the upper n bits t of x * m, whose partial products
+/// of the constant are folded by OptimizeAlgorithmDescription. The circuit has about half of the
+/// AND gates of the kDiv circuit of IntegerCircuit for kSize and 25 to 40% of them for kDepth.
+/// \throws std::invalid_argument if bit_length is 0 or larger than 64, or if divisor is 0 or does
+/// not fit into bit_length bits.
+AlgorithmDescription IntegerDivisionByConstantCircuit(std::uint64_t divisor,
+                                                      std::size_t bit_length,
+                                                      IntegerCircuitOptimization optimization);
+
+/// \brief creates the Boolean circuit of the one-hot encoding of the scale 2^(f - bit_width(x))
+/// for the lower f = number_of_scale_bits bits of an unsigned integer x of bit_length bits, i.e.,
+/// output wire p is set iff 2^p * x lies in [2^(f - 1), 2^f). The scale normalizes a divisor to
+/// [1/2, 1) with f fractional bits for an arithmetic reciprocal, and it is 2^(f - 1) for x = 0.
+/// \throws std::invalid_argument if number_of_scale_bits is 0 or larger than bit_length.
+AlgorithmDescription IntegerNormalizationCircuit(std::size_t bit_length,
+                                                 std::size_t number_of_scale_bits,
+                                                 IntegerCircuitOptimization optimization);
+
+}  // namespace encrypto::motion::algorithm
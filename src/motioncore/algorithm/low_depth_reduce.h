@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstddef>
 #include <vector>
 
 /**
@@ -44,3 +45,68 @@ T LowDepthReduce(std::vector<T> input, BinaryOperation operation) {
   }
   return input[0];
 }
+
+/**
+ * Reduces the SIMD values of a single share, e.g., a ShareWrapper, with the associative operation
+ * in the same order as LowDepthReduce, but folds the SIMD dimension instead of a vector of shares:
+ * each level pairs the SIMD values 2j and 2j + 1 by Subset() and applies the operation once to the
+ * two subsets, such that the reduction of n SIMD values needs ceil(log2(n)) levels of a constant
+ * number of gates each instead of n - 1 gate objects. An odd value at the end of a level is carried
+ * to the next level by Simdify(). Returns a share with a single SIMD value.
+ *
+ * | a | b | c | d | e |  ->  | ab | cd | e |  ->  | abcd | e |  ->  | abcde |
+ */
+
+template <typename T, typename BinaryOperation>
+T SimdLowDepthReduce(T input, BinaryOperation operation) {
+  for (std::size_t n = input->GetNumberOfSimdValues(); n > 1; n = (n + 1) / 2) {
+    std::vector<std::size_t> left_positions, right_positions;
+    left_positions.reserve(n / 2);
+    right_positions.reserve(n / 2);
+    for (std::size_t j = 0; j + 1 < n; j += 2) {
+      left_positions.push_back(j);
+      right_positions.push_back(j + 1);
+    }
+    T result{operation(input.Subset(std::move(left_positions)),
+                       input.Subset(std::move(right_positions)))};
+    if (n % 2 == 1) {
+      result = T::Simdify(std::vector<T>{result, input.Subset(std::vector<std::size_t>{n - 1})});
+    }
+    input = result;
+  }
+  return input;
+}
+
+/**
+ * Computes the inclusive prefixes x_0, x_0 x_1, ..., x_0 ... x_{n-1} of the SIMD values of a single
+ * share with the associative operation using the Sklansky parallel-prefix network. In level l, the
+ * values in the second half of each block of 2^(l+1) values are combined with the last prefix of
+ * the first half, such that there are ceil(log2(n)) levels with n / 2 operations each. Each level
+ * is a constant number of gates, which select the operands by Subset() and merge the results into
+ * the SIMD values that stay unchanged by Simdify() and Subset().
+ *
+ * | a | b | c | d |  ->  | a | ab | c | cd |  ->  | a | ab | abc | abcd |
+ */
+
+template <typename T, typename BinaryOperation>
+T Scan(T input, BinaryOperation operation) {
+  const std::size_t n{input->GetNumberOfSimdValues()};
+  for (std::size_t d = 1; d < n; d *= 2) {
+    std::vector<std::size_t> left_positions, right_positions;
+    // the values are taken from input or, if they are updated, from the results after input
+    std::vector<std::size_t> positions(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      if ((i / d) % 2 == 1) {
+        positions[i] = n + right_positions.size();
+        left_positions.push_back((i / d) * d - 1);
+        right_positions.push_back(i);
+      } else {
+        positions[i] = i;
+      }
+    }
+    T result{operation(input.Subset(std::move(left_positions)),
+                       input.Subset(std::move(right_positions)))};
+    input = T::Simdify(std::vector<T>{input, result}).Subset(std::move(positions));
+  }
+  return input;
+}
@@ -0,0 +1,60 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "private_set_intersection.h"
+
+#include <fmt/format.h>
+#include <stdexcept>
+
+#include "algorithm/histogram.h"
+#include "base/backend.h"
+#include "base/register.h"
+#include "protocols/boolean_gmw/boolean_gmw_gate.h"
+#include "protocols/share.h"
+
+namespace encrypto::motion::algorithm {
+
+ShareWrapper PrivateSetIntersection(Backend& backend, std::span<const std::uint64_t> set,
+                                    std::size_t receiver_set_size, std::size_t sender_set_size) {
+  const auto psi_gate{backend.GetRegister()->EmplaceGate<proto::boolean_gmw::PsiGate>(
+      set, receiver_set_size, sender_set_size, backend)};
+  return ShareWrapper(psi_gate->GetOutputAsShare());
+}
+
+ShareWrapper IntersectionCardinality(const ShareWrapper& intersection, std::size_t bit_length) {
+  return RowSums(intersection.BitsToArithmeticGmw(bit_length), 1);
+}
+
+ShareWrapper IntersectionSum(const ShareWrapper& intersection, const ShareWrapper& values) {
+  const std::size_t number_of_elements{intersection->GetNumberOfSimdValues()};
+  if (values->GetProtocol() != MpcProtocol::kArithmeticGmw ||
+      values->GetNumberOfSimdValues() != number_of_elements) {
+    throw std::invalid_argument(fmt::format(
+        "IntersectionSum expects an arithmetic GMW share of {} SIMD values, got a {} share of {} "
+        "SIMD values",
+        number_of_elements, to_string(values->GetProtocol()), values->GetNumberOfSimdValues()));
+  }
+  return MatrixMultiplication(intersection.BitsToArithmeticGmw(values->GetBitLength()), values, 1,
+                              number_of_elements, 1);
+}
+
+}  // namespace encrypto::motion::algorithm
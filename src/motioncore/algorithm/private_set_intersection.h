@@ -0,0 +1,60 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion {
+
+class Backend;
+
+}  // namespace encrypto::motion
+
+namespace encrypto::motion::algorithm {
+
+/// \brief returns the two-party Boolean GMW share of one wire with receiver_set_size SIMD values,
+/// whose SIMD value i is 1 iff element i of the set of party 0 is in the set of party 1, see
+/// proto::boolean_gmw::PsiGate. Each party passes its own set of distinct elements, the set sizes
+/// are public. Party 0 learns the intersection, the shares are meant for further computation,
+/// e.g., IntersectionCardinality or IntersectionSum.
+/// \throws invalid_argument if there are not 2 parties or the set does not fit the set size.
+ShareWrapper PrivateSetIntersection(Backend& backend, std::span<const std::uint64_t> set,
+                                    std::size_t receiver_set_size, std::size_t sender_set_size);
+
+/// \brief returns the arithmetic GMW share of bit_length = 8, 16, 32, 64 bits with one SIMD value
+/// of the number of elements in the intersection of PrivateSetIntersection.
+ShareWrapper IntersectionCardinality(const ShareWrapper& intersection, std::size_t bit_length);
+
+/// \brief returns the arithmetic GMW share with one SIMD value of the sum of the values of the
+/// elements in the intersection, where values is an arithmetic GMW share with a SIMD value per
+/// element of party 0, e.g., an input of either party. The sum is a single matrix multiplication
+/// of the 1 x N indicators of the intersection and the values.
+/// \throws invalid_argument if values is not an arithmetic GMW share with the SIMD values of
+/// intersection.
+ShareWrapper IntersectionSum(const ShareWrapper& intersection, const ShareWrapper& values);
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,212 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "protocol_assignment.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "circuit_schedule.h"
+#include "communication/transport.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+using Seconds = std::chrono::duration<double>;
+
+// estimated number of bytes that every party sends to every other party, see AssignProtocols()
+constexpr std::size_t kKeyByteSize{16};
+// two OT extension rows for a multiplication triple and the two masked bits in the online phase
+constexpr double kGmwAndByteSize{2 * kKeyByteSize + 0.25};
+// four garbled rows of one key per party, which are computed by OTs of the same size
+constexpr std::size_t kBmrRowsPerAndGate{4};
+constexpr std::size_t kBmrSetupRounds{3};
+// a masked bit and the corresponding key
+constexpr double kGmwToBmrByteSize{kKeyByteSize + 0.125};
+
+enum Protocol : std::size_t { kGmw = 0, kBmr = 1 };
+
+constexpr std::size_t kNumberOfProtocols{2};
+
+}  // namespace
+
+ProtocolCostModel ProtocolCostModel::FromTransportStatistics(
+    std::span<const communication::TransportStatistics> statistics,
+    std::chrono::duration<double> duration, std::chrono::duration<double> round_trip_time) {
+  if (duration.count() <= 0) {
+    throw std::invalid_argument("The bandwidth can only be estimated from a positive duration");
+  }
+  std::size_t number_of_bytes_sent{0};
+  for (const auto& transport_statistics : statistics) {
+    number_of_bytes_sent += transport_statistics.number_of_bytes_sent;
+  }
+  ProtocolCostModel cost_model;
+  cost_model.round_trip_time = round_trip_time;
+  if (number_of_bytes_sent > 0) {
+    cost_model.bandwidth = static_cast<double>(number_of_bytes_sent) / duration.count();
+  }
+  return cost_model;
+}
+
+ProtocolAssignment AssignProtocols(const AlgorithmDescription& algorithm,
+                                   MpcProtocol input_protocol, std::size_t number_of_parties,
+                                   std::size_t number_of_simd,
+                                   const ProtocolCostModel& cost_model) {
+  if (input_protocol != MpcProtocol::kBooleanGmw && input_protocol != MpcProtocol::kBmr) {
+    throw std::invalid_argument(
+        fmt::format("Protocols can only be assigned to circuits with Boolean GMW or BMR inputs, "
+                    "but the inputs are in {}",
+                    to_string(input_protocol)));
+  }
+  for (const auto& gate : algorithm.gates) {
+    const bool is_binary{gate.type == PrimitiveOperationType::kXor ||
+                         gate.type == PrimitiveOperationType::kAnd ||
+                         gate.type == PrimitiveOperationType::kOr};
+    if ((!is_binary && gate.type != PrimitiveOperationType::kInv) ||
+        (is_binary && !gate.parent_b)) {
+      throw std::invalid_argument(
+          "Protocols can only be assigned to circuits of XOR, AND, OR, and INV gates");
+    }
+  }
+  // the gates of AND depth d form layer d of the schedule, whose interactive gates are the AND
+  // and OR gates
+  const auto schedule{algorithm.GetSchedule()};
+  const std::size_t depth{schedule->GetMultiplicativeDepth()};
+  const auto& depths{schedule->wire_layers};
+  const auto& number_of_and_gates{schedule->interactive_widths};
+  // the last layer in which a wire is used, depth + 1 for the outputs
+  const auto& last_uses{schedule->last_use_layers};
+  // the number of wires that are created before layer d and used in layer d or later, which are
+  // converted if the protocol changes before layer d
+  std::vector<std::int64_t> live_wire_changes(depth + 2, 0);
+  for (std::size_t wire = 0; wire < algorithm.number_of_wires; ++wire) {
+    if (!last_uses[wire] || *last_uses[wire] <= depths[wire]) continue;
+    ++live_wire_changes[depths[wire] + 1];
+    --live_wire_changes[std::min(*last_uses[wire], depth) + 1];
+  }
+  std::vector<std::size_t> number_of_live_wires(depth + 1, 0);
+  std::int64_t live_wires{0};
+  for (std::size_t layer = 1; layer <= depth; ++layer) {
+    live_wires += live_wire_changes[layer];
+    number_of_live_wires[layer] = static_cast<std::size_t>(live_wires);
+  }
+
+  const std::size_t number_of_peers{number_of_parties > 0 ? number_of_parties - 1 : 0};
+  auto transfer_time = [&](double bytes_per_peer, std::size_t count) {
+    return Seconds(bytes_per_peer * static_cast<double>(number_of_peers * number_of_simd * count) /
+                   cost_model.bandwidth);
+  };
+  auto layer_time = [&](std::size_t protocol, std::size_t layer) {
+    const std::size_t and_gates{number_of_and_gates[layer]};
+    if (protocol == kGmw) {
+      return (and_gates > 0 ? cost_model.round_trip_time : Seconds(0)) +
+             transfer_time(kGmwAndByteSize, and_gates);
+    }
+    return transfer_time(
+        static_cast<double>(kBmrRowsPerAndGate * number_of_parties * kKeyByteSize * 2), and_gates);
+  };
+  auto conversion_time = [&](std::size_t from, std::size_t to, std::size_t number_of_wires) {
+    if (from != kGmw || to != kBmr || number_of_wires == 0) return Seconds(0);
+    return cost_model.round_trip_time + transfer_time(kGmwToBmrByteSize, number_of_wires);
+  };
+
+  const std::size_t input{input_protocol == MpcProtocol::kBooleanGmw ? kGmw : kBmr};
+  // the cheapest assignment of the layers 1, ..., depth that ends in each protocol, where BMR is
+  // only used if allow_bmr is set
+  auto assign = [&](bool allow_bmr, std::vector<std::size_t>& layer_protocols) {
+    constexpr double kInfinity{std::numeric_limits<double>::infinity()};
+    std::array<Seconds, kNumberOfProtocols> times{Seconds(kInfinity), Seconds(kInfinity)};
+    times[input] = Seconds(0);
+    // the protocol of the previous layer for each protocol of each layer
+    std::vector<std::array<std::size_t, kNumberOfProtocols>> predecessors(depth + 1);
+    for (std::size_t layer = 1; layer <= depth; ++layer) {
+      std::array<Seconds, kNumberOfProtocols> next_times{Seconds(kInfinity), Seconds(kInfinity)};
+      for (std::size_t to = 0; to < kNumberOfProtocols; ++to) {
+        if (to == kBmr && !allow_bmr) continue;
+        for (std::size_t from = 0; from < kNumberOfProtocols; ++from) {
+          const Seconds time{times[from] +
+                             conversion_time(from, to, number_of_live_wires[layer]) +
+                             layer_time(to, layer)};
+          if (time < next_times[to]) {
+            next_times[to] = time;
+            predecessors[layer][to] = from;
+          }
+        }
+      }
+      times = next_times;
+    }
+    std::size_t last{input};
+    Seconds time{kInfinity};
+    for (std::size_t protocol = 0; protocol < kNumberOfProtocols; ++protocol) {
+      const Seconds total{times[protocol] +
+                          conversion_time(protocol, input, algorithm.number_of_output_wires)};
+      if (total < time) {
+        time = total;
+        last = protocol;
+      }
+    }
+    layer_protocols.assign(depth + 1, input);
+    for (std::size_t layer = depth; layer > 0; --layer) {
+      layer_protocols[layer] = last;
+      last = predecessors[layer][last];
+    }
+    return time;
+  };
+
+  std::vector<std::size_t> layer_protocols;
+  std::vector<std::size_t> gmw_layer_protocols;
+  Seconds time{assign(true, layer_protocols)};
+  if (input == kGmw) {
+    // the setup of BMR takes a constant number of rounds once
+    time += kBmrSetupRounds * cost_model.round_trip_time;
+    const Seconds gmw_time{assign(false, gmw_layer_protocols)};
+    if (gmw_time <= time) {
+      time = gmw_time;
+      layer_protocols = std::move(gmw_layer_protocols);
+    }
+  }
+
+  ProtocolAssignment assignment;
+  assignment.estimated_time = time;
+  for (std::size_t layer = 1; layer <= depth; ++layer) {
+    assignment.estimated_time_in_input_protocol += layer_time(input, layer);
+    if (layer_protocols[layer] != layer_protocols[layer - 1]) {
+      ++assignment.number_of_protocol_switches;
+    }
+  }
+  if (layer_protocols[depth] != input) ++assignment.number_of_protocol_switches;
+  assignment.gate_protocols.reserve(algorithm.gates.size());
+  for (const std::size_t layer : schedule->gate_layers) {
+    assignment.gate_protocols.push_back(layer_protocols[layer] == kGmw ? MpcProtocol::kBooleanGmw
+                                                                       : MpcProtocol::kBmr);
+  }
+  return assignment;
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "algorithm_description.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+namespace communication {
+
+struct TransportStatistics;
+
+}  // namespace communication
+
+// Parameters of the links between the parties, from which AssignProtocols() estimates the time of
+// evaluating a circuit in Boolean GMW and BMR
+struct ProtocolCostModel {
+  // time of one round of communication
+  std::chrono::duration<double> round_trip_time{std::chrono::milliseconds(1)};
+  // number of bytes that a party sends per second
+  double bandwidth{125e6};
+
+  // Estimates the bandwidth from the bytes sent over the transports of a party in duration, e.g.,
+  // the statistics of CommunicationLayer::GetTransportStatistics() after a previous run, which
+  // needs to send enough data to saturate the links. The round trip time cannot be derived from
+  // the statistics, so it needs to be measured separately, e.g., by timing
+  // CommunicationLayer::Synchronize().
+  static ProtocolCostModel FromTransportStatistics(
+      std::span<const communication::TransportStatistics> statistics,
+      std::chrono::duration<double> duration, std::chrono::duration<double> round_trip_time);
+};
+
+// protocol of every gate of an AlgorithmDescription chosen by AssignProtocols()
+struct ProtocolAssignment {
+  // protocol in which gate i of the algorithm is evaluated, either kBooleanGmw or kBmr
+  std::vector<MpcProtocol> gate_protocols;
+  // estimated time of the evaluation in the assigned protocols including the conversions
+  std::chrono::duration<double> estimated_time{0};
+  // estimated time of the evaluation in the protocol of the inputs only
+  std::chrono::duration<double> estimated_time_in_input_protocol{0};
+  // number of times the circuit switches from one protocol to the other
+  std::size_t number_of_protocol_switches{0};
+};
+
+// Assigns Boolean GMW or BMR to the layers of AND gates of the Boolean circuit algorithm to
+// minimize its estimated evaluation time, where the inputs and the outputs are shared in
+// input_protocol. The cost model
+// - charges Boolean GMW one round per layer of AND gates and two OT extension rows per AND gate
+//   and pair of parties for the multiplication triples,
+// - charges BMR its constant number of setup rounds once and garbled rows of all parties per AND
+//   gate, but no rounds per layer,
+// - charges a conversion from Boolean GMW to BMR one round and one key per converted wire, whereas
+//   a conversion from BMR to Boolean GMW is local.
+// XOR and INV gates are free in both protocols and keep the protocol of the layer of their
+// parents. The wires crossing a switch of protocols are converted, see
+// ShareWrapper::Evaluate(const AlgorithmDescription&, const ProtocolCostModel&).
+// throws std::invalid_argument if input_protocol is neither kBooleanGmw nor kBmr or if the
+// algorithm contains other gates than XOR, AND, OR, and INV gates
+ProtocolAssignment AssignProtocols(const AlgorithmDescription& algorithm,
+                                   MpcProtocol input_protocol, std::size_t number_of_parties,
+                                   std::size_t number_of_simd, const ProtocolCostModel& cost_model);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,290 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "sha256.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "circuit_builder.h"
+#include "circuit_optimizer.h"
+#include "protocols/share.h"
+#include "protocols/share_view.h"
+
+namespace encrypto::motion::algorithm {
+
+using circuit_builder::Bits;
+using circuit_builder::CircuitBuilder;
+using circuit_builder::Wire;
+
+namespace {
+
+constexpr std::size_t kWordBitSize{32};
+
+constexpr std::array<std::uint32_t, 64> kRoundConstants{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr std::array<std::uint32_t, 8> kInitialValue{0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                                     0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                                     0x1f83d9ab, 0x5be0cd19};
+
+// word j of the big-endian string of number_of_words words that starts at first_wire
+Bits Word(std::size_t first_wire, std::size_t number_of_words, std::size_t j) {
+  Bits bits(kWordBitSize);
+  for (std::size_t k = 0; k < kWordBitSize; ++k) {
+    bits[k] = first_wire + kWordBitSize * (number_of_words - 1 - j) + k;
+  }
+  return bits;
+}
+
+Bits RotateRight(const Bits& x, std::size_t n) {
+  Bits bits(kWordBitSize);
+  for (std::size_t k = 0; k < kWordBitSize; ++k) bits[k] = x[(k + n) % kWordBitSize];
+  return bits;
+}
+
+Bits ShiftRight(CircuitBuilder& builder, const Bits& x, std::size_t n) {
+  Bits bits(kWordBitSize);
+  for (std::size_t k = 0; k < kWordBitSize; ++k) {
+    bits[k] = k + n < kWordBitSize ? x[k + n] : builder.Zero();
+  }
+  return bits;
+}
+
+Bits Xor(CircuitBuilder& builder, const Bits& a, const Bits& b, const Bits& c) {
+  Bits bits(kWordBitSize);
+  for (std::size_t k = 0; k < kWordBitSize; ++k) {
+    bits[k] = builder.Xor(builder.Xor(a[k], b[k]), c[k]);
+  }
+  return bits;
+}
+
+// (a & b) ^ (a & c) ^ (b & c) = b ^ ((a ^ b) & (b ^ c)) with a single AND gate
+Wire Majority(CircuitBuilder& builder, Wire a, Wire b, Wire c) {
+  return builder.Xor(b, builder.And(builder.Xor(a, b), builder.Xor(b, c)));
+}
+
+Bits Majority(CircuitBuilder& builder, const Bits& a, const Bits& b, const Bits& c) {
+  Bits bits(kWordBitSize);
+  for (std::size_t k = 0; k < kWordBitSize; ++k) bits[k] = Majority(builder, a[k], b[k], c[k]);
+  return bits;
+}
+
+// (e & f) ^ (~e & g) = g ^ (e & (f ^ g))
+Bits Choose(CircuitBuilder& builder, const Bits& e, const Bits& f, const Bits& g) {
+  Bits bits(kWordBitSize);
+  for (std::size_t k = 0; k < kWordBitSize; ++k) {
+    bits[k] = builder.Xor(g[k], builder.And(e[k], builder.Xor(f[k], g[k])));
+  }
+  return bits;
+}
+
+// the sum of the words modulo 2^32. For low_depth, carry-save adders reduce every three words to
+// their sum and carry words until two words are left, which a parallel-prefix adder adds.
+Bits AddWords(CircuitBuilder& builder, std::vector<Bits> words, bool low_depth) {
+  if (!low_depth) {
+    Bits sum{words[0]};
+    for (std::size_t i = 1; i < words.size(); ++i) sum = Add(builder, sum, words[i], false);
+    return sum;
+  }
+  while (words.size() > 2) {
+    std::vector<Bits> reduced_words;
+    std::size_t i{0};
+    for (; i + 3 <= words.size(); i += 3) {
+      const Bits &a{words[i]}, &b{words[i + 1]}, &c{words[i + 2]};
+      Bits sum{Xor(builder, a, b, c)}, carry(kWordBitSize);
+      carry[0] = builder.Zero();
+      for (std::size_t k = 0; k + 1 < kWordBitSize; ++k) {
+        carry[k + 1] = Majority(builder, a[k], b[k], c[k]);
+      }
+      reduced_words.emplace_back(std::move(sum));
+      reduced_words.emplace_back(std::move(carry));
+    }
+    reduced_words.insert(reduced_words.end(), words.begin() + i, words.end());
+    words = std::move(reduced_words);
+  }
+  return words.size() == 1 ? words[0] : Add(builder, words[0], words[1], true);
+}
+
+}  // namespace
+
+AlgorithmDescription Sha256CompressionCircuit(IntegerCircuitOptimization optimization,
+                                              bool with_initial_value) {
+  const bool low_depth{optimization == IntegerCircuitOptimization::kDepth};
+  CircuitBuilder builder(kSha256BlockBitSize + (with_initial_value ? 0 : kSha256DigestBitSize), 1);
+  const std::size_t kNumberOfBlockWords{kSha256BlockBitSize / kWordBitSize};
+  const std::size_t kNumberOfDigestWords{kSha256DigestBitSize / kWordBitSize};
+
+  std::vector<Bits> chaining_value;
+  for (std::size_t j = 0; j < kNumberOfDigestWords; ++j) {
+    chaining_value.emplace_back(with_initial_value
+                                    ? builder.Constant(kInitialValue[j], kWordBitSize)
+                                    : Word(kSha256BlockBitSize, kNumberOfDigestWords, j));
+  }
+
+  // message schedule
+  std::vector<Bits> w;
+  for (std::size_t t = 0; t < kNumberOfBlockWords; ++t) {
+    w.emplace_back(Word(0, kNumberOfBlockWords, t));
+  }
+  for (std::size_t t = kNumberOfBlockWords; t < kRoundConstants.size(); ++t) {
+    const Bits sigma_0{Xor(builder, RotateRight(w[t - 15], 7), RotateRight(w[t - 15], 18),
+                           ShiftRight(builder, w[t - 15], 3))};
+    const Bits sigma_1{Xor(builder, RotateRight(w[t - 2], 17), RotateRight(w[t - 2], 19),
+                           ShiftRight(builder, w[t - 2], 10))};
+    w.emplace_back(AddWords(builder, {sigma_1, w[t - 7], sigma_0, w[t - 16]}, low_depth));
+  }
+
+  // rounds, where v = {a, b, c, d, e, f, g, h}
+  std::vector<Bits> v{chaining_value};
+  for (std::size_t t = 0; t < kRoundConstants.size(); ++t) {
+    const Bits big_sigma_0{
+        Xor(builder, RotateRight(v[0], 2), RotateRight(v[0], 13), RotateRight(v[0], 22))};
+    const Bits big_sigma_1{
+        Xor(builder, RotateRight(v[4], 6), RotateRight(v[4], 11), RotateRight(v[4], 25))};
+    std::vector<Bits> t_1{v[7], big_sigma_1, Choose(builder, v[4], v[5], v[6]),
+                          builder.Constant(kRoundConstants[t], kWordBitSize), w[t]};
+    const Bits majority{Majority(builder, v[0], v[1], v[2])};
+    Bits a, e;
+    if (low_depth) {
+      // the summands of T1 are added to a and e separately to keep the trees flat
+      std::vector<Bits> a_words{t_1};
+      a_words.insert(a_words.end(), {big_sigma_0, majority});
+      std::vector<Bits> e_words{t_1};
+      e_words.push_back(v[3]);
+      a = AddWords(builder, std::move(a_words), true);
+      e = AddWords(builder, std::move(e_words), true);
+    } else {
+      const Bits sum_1{AddWords(builder, std::move(t_1), false)};
+      a = Add(builder, sum_1, Add(builder, big_sigma_0, majority, false), false);
+      e = Add(builder, v[3], sum_1, false);
+    }
+    v.pop_back();
+    v.insert(v.begin(), std::move(a));
+    v[4] = std::move(e);
+  }
+
+  Bits outputs(kSha256DigestBitSize);
+  for (std::size_t j = 0; j < kNumberOfDigestWords; ++j) {
+    const Bits word{AddWords(builder, {chaining_value[j], v[j]}, low_depth)};
+    for (std::size_t k = 0; k < kWordBitSize; ++k) {
+      outputs[kWordBitSize * (kNumberOfDigestWords - 1 - j) + k] = word[k];
+    }
+  }
+  return OptimizeAlgorithmDescription(builder.Finish(outputs));
+}
+
+std::vector<BitVector<>> Sha256PadMessages(std::span<const std::vector<std::uint8_t>> messages) {
+  if (messages.empty()) {
+    throw std::invalid_argument("Sha256PadMessages: no messages");
+  }
+  constexpr std::size_t kBlockByteSize{kSha256BlockBitSize / 8};
+  // the message, 0x80 and the 64-bit length in bits
+  const auto number_of_blocks = [](std::size_t length) {
+    return (length + 8) / kBlockByteSize + 1;
+  };
+  const std::size_t number_of_message_blocks{number_of_blocks(messages[0].size())};
+  std::vector<BitVector<>> wires(number_of_message_blocks * kSha256BlockBitSize,
+                                 BitVector<>(messages.size()));
+  for (std::size_t j = 0; j < messages.size(); ++j) {
+    const auto& message{messages[j]};
+    if (number_of_blocks(message.size()) != number_of_message_blocks) {
+      throw std::invalid_argument(
+          fmt::format("Sha256PadMessages: message {} has {} instead of {} blocks", j,
+                      number_of_blocks(message.size()), number_of_message_blocks));
+    }
+    std::vector<std::uint8_t> padded_message(number_of_message_blocks * kBlockByteSize, 0);
+    std::copy(message.begin(), message.end(), padded_message.begin());
+    padded_message[message.size()] = 0x80;
+    const std::uint64_t bit_length{8 * message.size()};
+    for (std::size_t i = 0; i < 8; ++i) {
+      padded_message[padded_message.size() - 1 - i] =
+          static_cast<std::uint8_t>(bit_length >> 8 * i);
+    }
+    for (std::size_t k = 0; k < number_of_message_blocks; ++k) {
+      const std::uint8_t* block{padded_message.data() + k * kBlockByteSize};
+      for (std::size_t i = 0; i < kSha256BlockBitSize; ++i) {
+        const bool bit{((block[kBlockByteSize - 1 - i / 8] >> i % 8) & 1) != 0};
+        wires[k * kSha256BlockBitSize + i].Set(bit, j);
+      }
+    }
+  }
+  return wires;
+}
+
+ShareWrapper Sha256(const ShareWrapper& padded_messages, IntegerCircuitOptimization optimization) {
+  const std::size_t number_of_wires{padded_messages->GetBitLength()};
+  if (number_of_wires == 0 || number_of_wires % kSha256BlockBitSize != 0) {
+    throw std::invalid_argument(fmt::format(
+        "Sha256: {} wires are no positive multiple of {}", number_of_wires, kSha256BlockBitSize));
+  }
+  // the circuits are built once per optimization
+  static const std::array<AlgorithmDescription, 2> kFirstCompression{
+      Sha256CompressionCircuit(IntegerCircuitOptimization::kSize, true),
+      Sha256CompressionCircuit(IntegerCircuitOptimization::kDepth, true)};
+  static const std::array<AlgorithmDescription, 2> kCompression{
+      Sha256CompressionCircuit(IntegerCircuitOptimization::kSize),
+      Sha256CompressionCircuit(IntegerCircuitOptimization::kDepth)};
+  const std::size_t index{optimization == IntegerCircuitOptimization::kDepth ? 1u : 0u};
+
+  const std::array first_block{padded_messages.View(0, kSha256BlockBitSize)};
+  ShareWrapper chaining_value{
+      ShareWrapper::Concatenate(first_block).Evaluate(kFirstCompression[index])};
+  for (std::size_t begin = kSha256BlockBitSize; begin < number_of_wires;
+       begin += kSha256BlockBitSize) {
+    const std::array inputs{padded_messages.View(begin, begin + kSha256BlockBitSize),
+                            chaining_value.View()};
+    chaining_value = ShareWrapper::Concatenate(inputs).Evaluate(kCompression[index]);
+  }
+  return chaining_value;
+}
+
+std::vector<std::vector<std::uint8_t>> Sha256Digests(std::span<const BitVector<>> digest_wires) {
+  if (digest_wires.size() != kSha256DigestBitSize) {
+    throw std::invalid_argument(fmt::format("Sha256Digests: {} instead of {} wires",
+                                            digest_wires.size(), kSha256DigestBitSize));
+  }
+  constexpr std::size_t kDigestByteSize{kSha256DigestBitSize / 8};
+  std::vector<std::vector<std::uint8_t>> digests(digest_wires[0].GetSize(),
+                                                 std::vector<std::uint8_t>(kDigestByteSize, 0));
+  for (std::size_t i = 0; i < kSha256DigestBitSize; ++i) {
+    for (std::size_t j = 0; j < digests.size(); ++j) {
+      if (digest_wires[i].Get(j)) digests[j][kDigestByteSize - 1 - i / 8] |= 1 << i % 8;
+    }
+  }
+  return digests;
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "algorithm_description.h"
+#include "integer_circuits.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::algorithm {
+
+inline constexpr std::size_t kSha256BlockBitSize{512};
+inline constexpr std::size_t kSha256DigestBitSize{256};
+
+/// \brief creates the Boolean circuit of the SHA-256 compression function with the wire layout of
+/// circuits/advanced/sha_256.bristol: the inputs are the 512 bits of a message block followed by
+/// the 256 bits of the chaining value and the outputs are the 256 bits of the next chaining value,
+/// where a string of n bytes is the big-endian integer with the least significant bit first, i.e.,
+/// wire i is bit i % 8 of byte n - 1 - i / 8. If with_initial_value is set, the chaining value is
+/// the initial value of SHA-256, whose constants are folded, and the inputs are only the block.
+/// kSize adds with ripple-carry adders like the Bristol circuit. kDepth reduces the up to seven
+/// summands of each word to two with carry-save adders and adds them with a Sklansky
+/// parallel-prefix adder, which needs more AND gates but has a much lower AND depth.
+AlgorithmDescription Sha256CompressionCircuit(IntegerCircuitOptimization optimization,
+                                              bool with_initial_value = false);
+
+/// \brief pads the messages to their blocks, which are the wires 512 * k, ..., 512 * k + 511 of
+/// block k in the layout of Sha256CompressionCircuit, where SIMD value j belongs to messages[j]
+/// \throws std::invalid_argument if messages is empty or the padded messages have different
+/// numbers of blocks
+std::vector<BitVector<>> Sha256PadMessages(std::span<const std::vector<std::uint8_t>> messages);
+
+/// \brief hashes the messages of the SIMD values of padded_messages, whose wires are the blocks of
+/// Sha256PadMessages, at once and returns the 256 wires of their digests, which are chained
+/// through one compression per block. The gates of consecutive blocks overlap, since each round
+/// only waits for the words it needs of the previous compression.
+/// \throws std::invalid_argument if the number of wires is not a positive multiple of 512
+ShareWrapper Sha256(const ShareWrapper& padded_messages,
+                    IntegerCircuitOptimization optimization = IntegerCircuitOptimization::kDepth);
+
+/// \brief converts the 256 output wires of Sha256 to the 32 bytes of the digest of each SIMD value
+std::vector<std::vector<std::uint8_t>> Sha256Digests(std::span<const BitVector<>> digest_wires);
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,226 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "sorting.h"
+
+#include <bit>
+#include <cassert>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "communication/communication_layer.h"
+#include "protocols/share.h"
+#include "utility/bit_vector.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+// the bitonic sorter in the variant without descending comparators, i.e., the first step of each
+// merge compares the mirrored positions of the two halves
+void AppendBitonicLayers(std::vector<ComparatorLayer>& layers, std::size_t number_of_values,
+                         std::size_t padded_size) {
+  for (std::size_t block_size = 2; block_size <= padded_size; block_size *= 2) {
+    ComparatorLayer& mirror_layer{layers.emplace_back()};
+    for (std::size_t i = 0; i < padded_size; ++i) {
+      const std::size_t offset{i % block_size};
+      const std::size_t j{i - offset + block_size - 1 - offset};
+      if (offset < block_size / 2 && j < number_of_values) mirror_layer.emplace_back(i, j);
+    }
+    for (std::size_t distance = block_size / 4; distance > 0; distance /= 2) {
+      ComparatorLayer& layer{layers.emplace_back()};
+      for (std::size_t i = 0; i + distance < number_of_values; ++i) {
+        if ((i & distance) == 0) layer.emplace_back(i, i + distance);
+      }
+    }
+  }
+}
+
+// Batcher's odd-even merge sort, where each pair of merge size and distance is one layer
+void AppendOddEvenMergeLayers(std::vector<ComparatorLayer>& layers, std::size_t number_of_values,
+                              std::size_t padded_size) {
+  for (std::size_t merge_size = 1; merge_size < padded_size; merge_size *= 2) {
+    for (std::size_t distance = merge_size; distance > 0; distance /= 2) {
+      ComparatorLayer& layer{layers.emplace_back()};
+      for (std::size_t j = distance % merge_size; j + distance < padded_size; j += 2 * distance) {
+        for (std::size_t i = 0; i < distance && i + j + distance < padded_size; ++i) {
+          const std::size_t low{i + j}, high{i + j + distance};
+          if (low / (2 * merge_size) == high / (2 * merge_size) && high < number_of_values) {
+            layer.emplace_back(low, high);
+          }
+        }
+      }
+    }
+  }
+}
+
+// compare-exchanges the SIMD values of a and b with swap ? (b, a) : (a, b)
+std::pair<ShareWrapper, ShareWrapper> ConditionalSwap(const ShareWrapper& swap,
+                                                      const ShareWrapper& a,
+                                                      const ShareWrapper& b) {
+  if (a->GetCircuitType() == CircuitType::kArithmetic) {
+    // the swap bit is a Boolean GMW share, which is multiplied with the difference in one round
+    const auto delta{swap * (b - a)};
+    return {a + delta, b - delta};
+  }
+  const auto low{swap.Mux(b, a)};
+  return {low, a ^ b ^ low};
+}
+
+// evaluates one layer of comparators on the SIMD values of keys and applies the same swaps to the
+// SIMD values of values if given
+void EvaluateLayer(const ComparatorLayer& layer, ShareWrapper& keys, ShareWrapper* values) {
+  const std::size_t number_of_values{keys->GetNumberOfSimdValues()};
+  std::vector<std::size_t> lows, highs, untouched;
+  std::vector<bool> is_touched(number_of_values, false);
+  for (const auto& [low, high] : layer) {
+    lows.emplace_back(low);
+    highs.emplace_back(high);
+    is_touched[low] = is_touched[high] = true;
+  }
+  for (std::size_t i = 0; i < number_of_values; ++i) {
+    if (!is_touched[i]) untouched.emplace_back(i);
+  }
+
+  // the positions of the SIMD values in [lows || highs || untouched]
+  std::vector<std::size_t> positions(number_of_values);
+  std::size_t position{0};
+  for (const auto& indices : {std::cref(lows), std::cref(highs), std::cref(untouched)}) {
+    for (auto i : indices.get()) positions[i] = position++;
+  }
+
+  auto a{keys.Subset(lows)}, b{keys.Subset(highs)};
+  const auto swap{SecureUnsignedInteger(a) > SecureUnsignedInteger(b)};
+
+  const auto apply = [&](ShareWrapper& share, ShareWrapper&& share_a, ShareWrapper&& share_b) {
+    auto [low, high] = ConditionalSwap(swap, share_a, share_b);
+    std::vector<ShareWrapper> parts{std::move(low), std::move(high)};
+    if (!untouched.empty()) parts.emplace_back(share.Subset(untouched));
+    share = ShareWrapper::Simdify(std::move(parts)).Subset(positions);
+  };
+  apply(keys, std::move(a), std::move(b));
+  if (values) apply(*values, values->Subset(lows), values->Subset(highs));
+}
+
+}  // namespace
+
+std::vector<ComparatorLayer> MakeSortingNetwork(std::size_t number_of_values,
+                                                SortingNetworkType type) {
+  std::vector<ComparatorLayer> layers;
+  if (number_of_values < 2) return layers;
+  const std::size_t padded_size{std::bit_ceil(number_of_values)};
+  switch (type) {
+    case SortingNetworkType::kBitonic:
+      AppendBitonicLayers(layers, number_of_values, padded_size);
+      break;
+    case SortingNetworkType::kOddEvenMerge:
+      AppendOddEvenMergeLayers(layers, number_of_values, padded_size);
+      break;
+    default:
+      throw std::invalid_argument("Unknown sorting network type");
+  }
+  std::erase_if(layers, [](const ComparatorLayer& layer) { return layer.empty(); });
+  return layers;
+}
+
+SecureUnsignedInteger Sort(const SecureUnsignedInteger& values, SortingNetworkType type) {
+  ShareWrapper keys{values.Get()};
+  for (const auto& layer : MakeSortingNetwork(keys->GetNumberOfSimdValues(), type)) {
+    EvaluateLayer(layer, keys, nullptr);
+  }
+  return SecureUnsignedInteger(keys);
+}
+
+std::pair<SecureUnsignedInteger, SecureUnsignedInteger> SortByKey(
+    const SecureUnsignedInteger& keys, const SecureUnsignedInteger& values,
+    SortingNetworkType type) {
+  ShareWrapper sorted_keys{keys.Get()}, sorted_values{values.Get()};
+  if (sorted_keys->GetNumberOfSimdValues() != sorted_values->GetNumberOfSimdValues()) {
+    throw std::invalid_argument(
+        fmt::format("SortByKey: got {} keys for {} values", sorted_keys->GetNumberOfSimdValues(),
+                    sorted_values->GetNumberOfSimdValues()));
+  }
+  for (const auto& layer : MakeSortingNetwork(sorted_keys->GetNumberOfSimdValues(), type)) {
+    EvaluateLayer(layer, sorted_keys, &sorted_values);
+  }
+  return {SecureUnsignedInteger(sorted_keys), SecureUnsignedInteger(sorted_values)};
+}
+
+SecureUnsignedInteger TopK(const SecureUnsignedInteger& values, std::size_t k,
+                           SortingNetworkType type) {
+  const std::size_t number_of_values{values.Get()->GetNumberOfSimdValues()};
+  if (k == 0 || k > number_of_values) {
+    throw std::invalid_argument(
+        fmt::format("TopK: k = {} is not in [1, {}]", k, number_of_values));
+  }
+  std::vector<std::size_t> positions(k);
+  for (std::size_t i = 0; i < k; ++i) positions[i] = number_of_values - k + i;
+  return Sort(values, type).Subset(std::move(positions));
+}
+
+SecureUnsignedInteger Shuffle(const SecureUnsignedInteger& values) {
+  const auto& share{values.Get().Get()};
+  auto& backend{share->GetBackend()};
+  const std::size_t number_of_values{share->GetNumberOfSimdValues()};
+  const std::size_t number_of_parties{backend.GetCommunicationLayer().GetNumberOfParties()};
+  const std::size_t my_id{backend.GetCommunicationLayer().GetMyId()};
+
+  ShareWrapper keys;
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    std::vector<std::uint64_t> key_shares(number_of_values, 0);
+    if (party_id == my_id) key_shares = RandomVector<std::uint64_t>(number_of_values);
+    SharePointer key;
+    switch (share->GetProtocol()) {
+      case MpcProtocol::kArithmeticGmw: {
+        // the sum of the keys has to be smaller than 2^63 for the comparisons
+        for (auto& key_share : key_shares) key_share >>= 1 + std::bit_width(number_of_parties - 1);
+        key = backend.ArithmeticGmwInput(party_id, std::move(key_shares));
+        break;
+      }
+      case MpcProtocol::kBooleanGmw:
+        key = backend.BooleanGmwInput(party_id, ToInput(key_shares));
+        break;
+      case MpcProtocol::kBmr:
+        key = backend.BmrInput(party_id, ToInput(key_shares));
+        break;
+      case MpcProtocol::kGarbledCircuit:
+        key = backend.GarbledCircuitInput(party_id, ToInput(key_shares));
+        break;
+      default:
+        throw std::invalid_argument(
+            fmt::format("Shuffle is not supported for {} shares", to_string(share->GetProtocol())));
+    }
+    if (!*keys) {
+      keys = ShareWrapper(key);
+    } else if (share->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+      keys += ShareWrapper(key);
+    } else {
+      keys ^= ShareWrapper(key);
+    }
+  }
+  return SortByKey(SecureUnsignedInteger(keys), values).second;
+}
+
+}  // namespace encrypto::motion::algorithm
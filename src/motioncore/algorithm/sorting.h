@@ -0,0 +1,69 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "secure_type/secure_unsigned_integer.h"
+
+namespace encrypto::motion::algorithm {
+
+enum class SortingNetworkType : unsigned int { kBitonic, kOddEvenMerge };
+
+/// \brief a compare-exchange (i, j) with i < j, which moves the minimum to i and the maximum to j
+using Comparator = std::pair<std::size_t, std::size_t>;
+
+/// \brief the comparators of a sorting network grouped into layers of disjoint comparators
+using ComparatorLayer = std::vector<Comparator>;
+
+/// \brief constructs a sorting network for number_of_values values. Every comparator moves the
+/// minimum to the lower position, such that networks for arbitrary sizes are obtained from the
+/// next power of two by dropping the comparators of the padding positions.
+std::vector<ComparatorLayer> MakeSortingNetwork(std::size_t number_of_values,
+                                                SortingNetworkType type);
+
+/// \brief sorts the SIMD values of values in ascending order. Each layer of the network is
+/// evaluated as a single batch, i.e., one comparison and one selection on a share whose SIMD values
+/// are the comparator inputs, which are obtained with Subset and put back with Simdify.
+/// \note comparisons of arithmetic GMW shares require 2 parties and values smaller than 2^(k - 1)
+SecureUnsignedInteger Sort(const SecureUnsignedInteger& values,
+                           SortingNetworkType type = SortingNetworkType::kOddEvenMerge);
+
+/// \brief sorts the SIMD values of keys in ascending order and applies the same permutation to
+/// values, which need to have the same number of SIMD values and the same protocol as keys.
+std::pair<SecureUnsignedInteger, SecureUnsignedInteger> SortByKey(
+    const SecureUnsignedInteger& keys, const SecureUnsignedInteger& values,
+    SortingNetworkType type = SortingNetworkType::kOddEvenMerge);
+
+/// \brief returns the k largest SIMD values of values in ascending order
+SecureUnsignedInteger TopK(const SecureUnsignedInteger& values, std::size_t k,
+                           SortingNetworkType type = SortingNetworkType::kOddEvenMerge);
+
+/// \brief obliviously shuffles the SIMD values of values by sorting them by 64-bit random keys,
+/// to which every party contributes a share, such that no proper subset of the parties learns the
+/// permutation. Supports Boolean GMW, BMR and arithmetic GMW shares.
+SecureUnsignedInteger Shuffle(const SecureUnsignedInteger& values);
+
+}  // namespace encrypto::motion::algorithm
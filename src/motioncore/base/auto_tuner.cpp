@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "auto_tuner.h"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+#include "base/register.h"
+#include "protocols/gate.h"
+#include "protocols/wire.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// interactive gates per round below which another thread does not pay off
+constexpr std::size_t kGatesPerThread{256};
+
+// rounds of the online phase below which overlapping it with the setup gains less than the
+// contention between both costs
+constexpr std::chrono::milliseconds kMaxSequentialOnlineTime{10};
+
+// bandwidth-delay products that a chunk or batch should cover, such that the links are kept busy
+constexpr double kBandwidthDelayProducts{4.0};
+
+// bytes sent per OT of the OT extension and per binary MT
+constexpr double kBytesPerOt{kKappa / 8.0};
+constexpr double kBytesPerMt{2 * kKappa / 8.0};
+
+std::size_t ClampPowerOfTwo(double value, std::size_t min, std::size_t max) {
+  if (!(value > static_cast<double>(min))) return min;
+  if (value >= static_cast<double>(max)) return max;
+  return std::clamp(std::bit_ceil(static_cast<std::size_t>(value)), min, max);
+}
+
+}  // namespace
+
+CircuitShape InspectCircuit(const Register& register_) {
+  const auto& gates{register_.GetGates()};
+  CircuitShape shape;
+  shape.number_of_gates = gates.size();
+  // the rounds of the interactive gates producing the wires, local gates add no round
+  std::unordered_map<const Wire*, std::size_t> wire_rounds;
+  std::map<std::size_t, std::size_t> gates_per_round;
+  for (const auto& gate : gates) {
+    std::size_t round{0};
+    for (const auto& wire : gate->GetInputWires()) {
+      if (auto it = wire_rounds.find(wire.get()); it != wire_rounds.end()) {
+        round = std::max(round, it->second);
+      }
+    }
+    if (!gate->IsLocal()) {
+      ++round;
+      ++shape.number_of_interactive_gates;
+      shape.max_interactive_width = std::max(shape.max_interactive_width, ++gates_per_round[round]);
+    }
+    shape.interactive_depth = std::max(shape.interactive_depth, round);
+    for (const auto& wire : gate->GetOutputWires()) {
+      wire_rounds[wire.get()] = round;
+    }
+  }
+  return shape;
+}
+
+ProtocolCostModel GetSlowestLink(
+    const std::vector<std::vector<communication::LinkParameters>>& links) {
+  ProtocolCostModel network{.round_trip_time = std::chrono::duration<double>::zero(),
+                            .bandwidth = 0.0};
+  bool first{true};
+  for (std::size_t i = 0; i < links.size(); ++i) {
+    for (std::size_t j = 0; j < links[i].size(); ++j) {
+      if (i == j) continue;
+      const auto& link{links[i][j]};
+      network.round_trip_time = std::max<std::chrono::duration<double>>(network.round_trip_time,
+                                                                        link.round_trip_time);
+      network.bandwidth =
+          first ? link.bytes_per_second : std::min(network.bandwidth, link.bytes_per_second);
+      first = false;
+    }
+  }
+  return network;
+}
+
+TuningDecision ChooseConfiguration(const ProtocolCostModel& network, const CircuitShape& circuit,
+                                   std::size_t hardware_threads) {
+  TuningDecision decision{.network = network, .circuit = circuit};
+  decision.number_of_threads =
+      std::clamp<std::size_t>(circuit.max_interactive_width / kGatesPerThread, 1,
+                              std::max<std::size_t>(hardware_threads, 1));
+  decision.online_after_setup =
+      static_cast<double>(circuit.interactive_depth) * network.round_trip_time <
+      kMaxSequentialOnlineTime;
+  const double bytes_in_flight{kBandwidthDelayProducts * network.bandwidth *
+                               network.round_trip_time.count()};
+  decision.ot_extension_chunk_size =
+      ClampPowerOfTwo(bytes_in_flight / kBytesPerOt, std::size_t(1) << 16, std::size_t(1) << 22);
+  decision.mt_batch_size =
+      ClampPowerOfTwo(bytes_in_flight / kBytesPerMt, std::size_t(1) << 12, std::size_t(1) << 17);
+  return decision;
+}
+
+std::string TuningDecision::PrintHumanReadable() const {
+  return fmt::format(
+      "round trip time {:.3f} ms, bandwidth {:.1f} MB/s, {} gates ({} interactive), depth {}, "
+      "width {}\n{} threads, {}, OT extension chunks of {} OTs, MT batches of {} MTs\n",
+      network.round_trip_time.count() * 1e3, network.bandwidth / 1e6, circuit.number_of_gates,
+      circuit.number_of_interactive_gates, circuit.interactive_depth, circuit.max_interactive_width,
+      number_of_threads, online_after_setup ? "online after setup" : "online parallel to setup",
+      ot_extension_chunk_size, mt_batch_size);
+}
+
+}  // namespace encrypto::motion
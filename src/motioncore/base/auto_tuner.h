@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "algorithm/protocol_assignment.h"
+#include "communication/communication_layer.h"
+#include "utility/constants.h"
+
+namespace encrypto::motion {
+
+class Register;
+
+// Structure of a circuit that the configuration chosen by ChooseConfiguration depends on
+struct CircuitShape {
+  std::size_t number_of_gates{0};
+  // gates that communicate, i.e., that are not local
+  std::size_t number_of_interactive_gates{0};
+  // interactive gates on the longest path through the circuit, i.e., its rounds
+  std::size_t interactive_depth{0};
+  // most interactive gates in one round, which could be evaluated in parallel
+  std::size_t max_interactive_width{0};
+};
+
+// Takes the rounds of the interactive gates in a single pass over the gates of the register, as
+// gates are registered after the gates producing their inputs
+CircuitShape InspectCircuit(const Register& register_);
+
+// The longest round trip time and lowest bandwidth of the links measured by
+// CommunicationLayer::MeasureLinks, which bound the protocols that communicate with all parties
+ProtocolCostModel GetSlowestLink(
+    const std::vector<std::vector<communication::LinkParameters>>& links);
+
+// Configuration chosen by ChooseConfiguration, see Configuration::SetAutoTune
+struct TuningDecision {
+  std::size_t number_of_threads{1};
+  bool online_after_setup{false};
+  // see OtProviderManager::SetChunkSize and MtProviderFromOts::SetBatchSize
+  std::size_t ot_extension_chunk_size{kOtExtensionChunkSize};
+  std::size_t mt_batch_size{128 * 128};
+
+  // what the decision was based on
+  ProtocolCostModel network;
+  CircuitShape circuit;
+
+  std::string PrintHumanReadable() const;
+};
+
+// Chooses the threads from the width of the circuit, evaluates the online phase after the setup
+// if its rounds take only a few milliseconds, and sizes the OT extension chunks and MT batches to
+// a few bandwidth-delay products of the network. The parties need to pass the same network, e.g.,
+// of GetSlowestLink, since the chunk and batch sizes need to be equal at all of them.
+TuningDecision ChooseConfiguration(const ProtocolCostModel& network, const CircuitShape& circuit,
+                                   std::size_t hardware_threads);
+
+}  // namespace encrypto::motion
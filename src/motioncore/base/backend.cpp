@@ -28,27 +28,40 @@
 #include "motion_base_provider.h"
 
 #include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
 #include <functional>
 #include <future>
 #include <iterator>
+#include <map>
 #include <span>
+#include <thread>
+#include <unordered_set>
 
 #include <fmt/format.h>
 
+#include "auto_tuner.h"
 #include "communication/communication_layer.h"
 #include "communication/message.h"
 #include "configuration.h"
+#include "third_party_dealer.h"
 #include "data_storage/base_ot_data.h"
+#include "data_storage/preprocessing_plan.h"
+#include "data_storage/preprocessing_store.h"
 #include "executor/gate_executor.h"
+#include "multiplication_triple/dabit_provider.h"
 #include "multiplication_triple/mt_provider.h"
 #include "multiplication_triple/sb_provider.h"
 #include "multiplication_triple/sp_provider.h"
+#include "multiplication_triple/truncation_pair_provider.h"
 #include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
 #include "oblivious_transfer/base_ots/base_ot_provider.h"
 #include "oblivious_transfer/ot_provider.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
 #include "protocols/astra/astra_gate.h"
+#include "protocols/astra/astra_provider.h"
 #include "protocols/astra/astra_share.h"
 #include "protocols/bmr/bmr_gate.h"
 #include "protocols/bmr/bmr_provider.h"
@@ -59,9 +72,15 @@
 #include "protocols/garbled_circuit/garbled_circuit_gate.h"
 #include "protocols/garbled_circuit/garbled_circuit_provider.h"
 #include "protocols/garbled_circuit/garbled_circuit_share.h"
+#include "protocols/share_wrapper.h"
 #include "register.h"
+#include "statistics/cost_estimate.h"
+#include "statistics/metrics.h"
 #include "statistics/run_time_statistics.h"
+#include "statistics/timeline.h"
 #include "utility/constants.h"
+#include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
+#include "utility/mapped_file.h"
 
 using namespace std::chrono_literals;
 
@@ -75,10 +94,12 @@ Backend::Backend(std::unique_ptr<communication::CommunicationLayer> communicatio
       configuration_(configuration),
       register_(std::make_shared<Register>(logger_)),
       gate_executor_(std::make_unique<GateExecutor>(
-          *register_, [this] { RunPreprocessing(); }, logger_)) {
+          *register_, *configuration_, *communication_layer_, [this] { WaitForPreprocessing(); },
+          logger_)) {
   motion_base_provider_ = std::make_unique<BaseProvider>(*communication_layer_);
   base_ot_provider_ = std::make_unique<BaseOtProvider>(*communication_layer_);
   communication_layer_->SetLogger(logger_);
+  communication_layer_->SetMessageTracing(configuration_->GetRecordTimeline());
   auto my_id = communication_layer_->GetMyId();
 
   ot_provider_manager_ = std::make_unique<OtProviderManager>(
@@ -93,6 +114,9 @@ Backend::Backend(std::unique_ptr<communication::CommunicationLayer> communicatio
                                                      logger, run_time_statistics_.back());
   sb_provider_ = std::make_shared<SbProviderFromSps>(*communication_layer_, sp_provider_, logger,
                                                      run_time_statistics_.back());
+  truncation_pair_provider_ = std::make_shared<TruncationPairProvider>(*sb_provider_);
+  dabit_provider_ = std::make_shared<DaBitProvider>(*sb_provider_);
+  astra_provider_ = std::make_unique<proto::astra::Provider>(*communication_layer_);
   bmr_provider_ = std::make_unique<proto::bmr::Provider>(*communication_layer_);
   if (communication_layer_->GetNumberOfParties() == 2) {
     garbled_circuit_provider_ =
@@ -103,7 +127,7 @@ Backend::Backend(std::unique_ptr<communication::CommunicationLayer> communicatio
   communication_layer_->Start();
 }
 
-Backend::~Backend() {}
+Backend::~Backend() { WaitForBatches(); }
 
 const LoggerPointer& Backend::GetLogger() const noexcept { return logger_; }
 
@@ -122,6 +146,9 @@ void Backend::RunPreprocessing() {
 
   const bool needs_mts = mt_provider_->NeedMts();
   if (needs_mts) {
+    if (auto mt_provider{std::dynamic_pointer_cast<MtProviderFromOts>(mt_provider_)}) {
+      mt_provider->SetNumberOfThreads(configuration_->GetNumOfThreads());
+    }
     mt_provider_->PreSetup();
   }
   const bool needs_sbs = sb_provider_->NeedSbs();
@@ -134,9 +161,11 @@ void Backend::RunPreprocessing() {
   }
 
   if (kk13_ot_provider_manager_->HasWork()) {
+    kk13_ot_provider_manager_->SetCodeBitLength(configuration_->GetKk13CodeBitLength());
     kk13_ot_provider_manager_->PreSetup();
   }
 
+  ot_provider_manager_->RegisterOtBatches();
   if (ot_provider_manager_->HasWork()) {
     ot_provider_manager_->PreSetup();
   }
@@ -147,6 +176,16 @@ void Backend::RunPreprocessing() {
 
   communication_layer_->Synchronize();
 
+  // the backends of the batches of SubmitBatch() run over sessions, which cannot probe the clocks
+  if (configuration_->GetRecordTimeline() && clock_offsets_.empty() &&
+      communication_layer_->GetSessionId() == 0) {
+    clock_offsets_ = communication_layer_->EstimateClockOffsets();
+  }
+
+  if (third_party_dealer_client_) {
+    third_party_dealer_client_->Exchange();
+  }
+
   if (base_ot_provider_->HasWork()) {
     base_ot_provider_->ComputeBaseOts();
   }
@@ -173,19 +212,166 @@ void Backend::RunPreprocessing() {
   run_time_statistics_.back().RecordEnd<RunTimeStatistics::StatisticsId::kPreprocessing>();
 }
 
+void Backend::StartPreprocessing() {
+  std::scoped_lock lock(preprocessing_mutex_);
+  if (!preprocessing_future_) {
+    // drops the requests of dead gates before the providers count them in PreSetup
+    register_->EliminateDeadGates();
+    preprocessing_future_ =
+        std::async(std::launch::async, [this] { RunPreprocessing(); }).share();
+  }
+}
+
+void Backend::WaitForPreprocessing() {
+  StartPreprocessing();
+  std::shared_future<void> preprocessing_future;
+  {
+    std::scoped_lock lock(preprocessing_mutex_);
+    preprocessing_future = *preprocessing_future_;
+  }
+  preprocessing_future.get();
+}
+
+void Backend::PrepareFiberThreadPool() {
+  if (configuration_->GetPersistentThreadPool()) {
+    if (!fiber_thread_pool_) {
+      // stacks of finished fibers are returned to a memory pool and reused in later evaluations
+      fiber_thread_pool_ = std::make_unique<FiberThreadPool>(
+          std::max<std::size_t>(configuration_->GetNumOfThreads(), 2), 0, true,
+          configuration_->GetPinWorkerThreads(),
+          FiberStackAllocator::kPooledFixedSize);
+    }
+    gate_executor_->SetPersistentFiberThreadPool(fiber_thread_pool_.get());
+  } else {
+    gate_executor_->SetPersistentFiberThreadPool(nullptr);
+    fiber_thread_pool_.reset();
+  }
+}
+
 void Backend::EvaluateSequential() {
+  PrepareFiberThreadPool();
   gate_executor_->EvaluateSetupOnline(run_time_statistics_.back());
 }
 
-void Backend::EvaluateParallel() { gate_executor_->Evaluate(run_time_statistics_.back()); }
+void Backend::EvaluateParallel() {
+  PrepareFiberThreadPool();
+  gate_executor_->Evaluate(run_time_statistics_.back());
+}
+
+std::shared_future<Backend::EvaluatedBatch> Backend::SubmitBatch(
+    const std::function<std::vector<SharePointer>(Backend&)>& construct_batch) {
+  auto batch_backend{std::make_shared<Backend>(
+      communication_layer_->CreateSession(next_batch_session_id_), configuration_, logger_)};
+  if (++next_batch_session_id_ == 0) {
+    next_batch_session_id_ = kFirstBatchSessionId;
+  }
+  auto outputs{construct_batch(*batch_backend)};
+  // overlaps the evaluation of the previous batches
+  batch_backend->StartPreprocessing();
+  last_batch_ =
+      std::async(std::launch::async, [batch_backend = std::move(batch_backend),
+                                      outputs = std::move(outputs),
+                                      previous_batch = std::move(last_batch_)]() mutable {
+        if (previous_batch.valid()) {
+          previous_batch.wait();
+          // such that the batches do not keep each other alive
+          previous_batch = {};
+        }
+        // like Party::Run()
+        batch_backend->WaitForStartedPreprocessing();
+        batch_backend->Synchronize();
+        if (batch_backend->GetConfiguration()->GetOnlineAfterSetup()) {
+          batch_backend->EvaluateSequential();
+        } else {
+          batch_backend->EvaluateParallel();
+        }
+        return EvaluatedBatch{.backend = std::move(batch_backend), .outputs = std::move(outputs)};
+      }).share();
+  return last_batch_;
+}
+
+void Backend::WaitForBatches() {
+  if (last_batch_.valid()) {
+    last_batch_.wait();
+  }
+}
 
 const GatePointer& Backend::GetGate(std::size_t gate_id) const {
   return register_->GetGate(gate_id);
 }
 
-void Backend::Reset() { register_->Reset(); }
+void Backend::Reset() {
+  ResetPreprocessing();
+  register_->Reset();
+  astra_provider_->Reset();
+}
+
+void Backend::Clear() {
+  ResetPreprocessing();
+  register_->Clear();
+  astra_provider_->Clear();
+}
+
+void Backend::ClearDownstream(const std::vector<SharePointer>& changed_shares) {
+  if (configuration_->GetReleaseWireValues()) {
+    throw std::logic_error("Cannot re-evaluate a part of a circuit whose wire values are released");
+  }
+  std::unordered_set<const Wire*> changed_wires;
+  for (auto& share : changed_shares) {
+    for (auto& wire : share->GetWires()) {
+      changed_wires.insert(wire.get());
+    }
+  }
+  std::vector<GatePointer> changed_gates;
+  for (auto& gate : register_->GetGates()) {
+    const auto& output_wires{gate->GetOutputWires()};
+    if (std::any_of(output_wires.begin(), output_wires.end(),
+                    [&changed_wires](auto& wire) { return changed_wires.contains(wire.get()); })) {
+      changed_gates.emplace_back(gate);
+    }
+  }
+  register_->ClearDownstreamGates(changed_gates);
+}
+
+void Backend::WaitForStartedPreprocessing() {
+  std::optional<std::shared_future<void>> preprocessing_future;
+  {
+    std::scoped_lock lock(preprocessing_mutex_);
+    preprocessing_future = preprocessing_future_;
+  }
+  if (preprocessing_future) {
+    preprocessing_future->get();
+  }
+}
 
-void Backend::Clear() { register_->Clear(); }
+void Backend::AutoTune() {
+  WaitForStartedPreprocessing();
+  const auto network{GetSlowestLink(communication_layer_->MeasureLinks())};
+  auto decision{std::make_shared<const TuningDecision>(ChooseConfiguration(
+      network, InspectCircuit(*register_), std::thread::hardware_concurrency()))};
+  configuration_->SetNumOfThreads(decision->number_of_threads);
+  configuration_->SetOnlineAfterSetup(decision->online_after_setup);
+  bool preprocessing_started;
+  {
+    std::scoped_lock lock(preprocessing_mutex_);
+    preprocessing_started = preprocessing_future_.has_value();
+  }
+  // the providers have registered their OTs and MTs once the preprocessing is started
+  if (!preprocessing_started) {
+    ot_provider_manager_->SetChunkSize(decision->ot_extension_chunk_size);
+    if (auto mt_provider{std::dynamic_pointer_cast<MtProviderFromOts>(mt_provider_)}) {
+      mt_provider->SetBatchSize(decision->mt_batch_size);
+    }
+  }
+  logger_->LogInfo(fmt::format("Auto-tuned configuration: {}", decision->PrintHumanReadable()));
+  run_time_statistics_.back().tuning_decision = std::move(decision);
+}
+
+void Backend::ResetPreprocessing() {
+  WaitForStartedPreprocessing();
+  std::scoped_lock lock(preprocessing_mutex_);
+  preprocessing_future_.reset();
+}
 
 SharePointer Backend::BooleanGmwInput(std::size_t party_id, bool input) {
   return BooleanGmwInput(party_id, BitVector(1, input));
@@ -211,6 +397,16 @@ SharePointer Backend::BooleanGmwInput(std::size_t party_id, std::vector<BitVecto
   return std::static_pointer_cast<Share>(input_gate->GetOutputAsGmwShare());
 }
 
+std::pair<SharePointer, ReusableFiberPromise<std::vector<BitVector<>>>*>
+Backend::BooleanGmwInput(std::size_t party_id, std::size_t number_of_wires,
+                         std::size_t number_of_simd) {
+  auto input_gate = register_->EmplaceGate<proto::boolean_gmw::InputGate>(
+      number_of_wires, number_of_simd, party_id, *this);
+  bool my_input{party_id == GetCommunicationLayer().GetMyId()};
+  return std::pair(std::static_pointer_cast<Share>(input_gate->GetOutputAsGmwShare()),
+                   my_input ? &input_gate->GetInputPromise() : nullptr);
+}
+
 SharePointer Backend::BooleanGmwOutput(const SharePointer& parent, std::size_t output_owner) {
   assert(parent);
   const auto output_gate =
@@ -218,6 +414,102 @@ SharePointer Backend::BooleanGmwOutput(const SharePointer& parent, std::size_t o
   return std::static_pointer_cast<Share>(output_gate->GetOutputAsShare());
 }
 
+// reveal the shares of the given indices with a single RevealGateType
+template <typename RevealGateType>
+static void RevealWithGate(Register& register_, std::span<const ShareWrapper> shares,
+                           const std::vector<std::size_t>& indices,
+                           std::vector<ShareWrapper>& outputs) {
+  if (indices.empty()) {
+    return;
+  }
+  std::vector<SharePointer> parents;
+  parents.reserve(indices.size());
+  for (auto index : indices) {
+    parents.emplace_back(*shares[index]);
+  }
+  auto reveal_gate{register_.EmplaceGate<RevealGateType>(std::span<const SharePointer>(parents))};
+  auto revealed_shares{reveal_gate->GetOutputAsShares()};
+  for (std::size_t i = 0; i < indices.size(); ++i) {
+    outputs[indices[i]] = revealed_shares[i];
+  }
+}
+
+std::vector<ShareWrapper> Backend::Reveal(std::span<const ShareWrapper> shares) {
+  std::vector<ShareWrapper> outputs(shares.size());
+  std::vector<std::size_t> boolean_gmw_indices;
+  // arithmetic GMW shares of 8, 16, 32, and 64 bits
+  std::array<std::vector<std::size_t>, 4> arithmetic_gmw_indices;
+  for (std::size_t i = 0; i < shares.size(); ++i) {
+    const auto& share{*shares[i]};
+    assert(share);
+    if (share->GetProtocol() == MpcProtocol::kBooleanGmw) {
+      boolean_gmw_indices.push_back(i);
+    } else if (share->GetProtocol() == MpcProtocol::kArithmeticGmw &&
+               std::has_single_bit(share->GetBitLength()) && share->GetBitLength() >= 8 &&
+               share->GetBitLength() <= 64) {
+      arithmetic_gmw_indices[std::countr_zero(share->GetBitLength()) - 3].push_back(i);
+    } else {
+      outputs[i] = shares[i].Out();
+    }
+  }
+  RevealWithGate<proto::boolean_gmw::RevealGate>(*register_, shares, boolean_gmw_indices, outputs);
+  RevealWithGate<proto::arithmetic_gmw::RevealGate<std::uint8_t>>(
+      *register_, shares, arithmetic_gmw_indices[0], outputs);
+  RevealWithGate<proto::arithmetic_gmw::RevealGate<std::uint16_t>>(
+      *register_, shares, arithmetic_gmw_indices[1], outputs);
+  RevealWithGate<proto::arithmetic_gmw::RevealGate<std::uint32_t>>(
+      *register_, shares, arithmetic_gmw_indices[2], outputs);
+  RevealWithGate<proto::arithmetic_gmw::RevealGate<std::uint64_t>>(
+      *register_, shares, arithmetic_gmw_indices[3], outputs);
+  return outputs;
+}
+
+std::vector<ShareWrapper> Backend::BooleanInputs(MpcProtocol protocol, std::size_t party_id,
+                                                 std::span<const std::vector<BitVector<>>> inputs) {
+  // the wires of an input gate have the same number of SIMD values
+  std::map<std::size_t, std::vector<std::size_t>> indices_by_number_of_simd;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    if (inputs[i].empty()) {
+      throw std::invalid_argument(fmt::format("Input #{} has no wires", i));
+    }
+    indices_by_number_of_simd[inputs[i][0].GetSize()].push_back(i);
+  }
+
+  std::vector<ShareWrapper> outputs(inputs.size());
+  for (const auto& [number_of_simd, indices] : indices_by_number_of_simd) {
+    std::vector<BitVector<>> wires;
+    for (auto index : indices) {
+      wires.insert(wires.end(), inputs[index].begin(), inputs[index].end());
+    }
+    SharePointer share;
+    switch (protocol) {
+      case MpcProtocol::kBooleanGmw:
+        share = BooleanGmwInput(party_id, std::move(wires));
+        break;
+      case MpcProtocol::kBmr:
+        share = BmrInput(party_id, std::move(wires));
+        break;
+      case MpcProtocol::kGarbledCircuit:
+        share = GarbledCircuitInput(party_id, std::move(wires));
+        break;
+      case MpcProtocol::kAstra:
+        share = AstraBooleanInput(party_id, wires);
+        break;
+      default:
+        throw std::invalid_argument(fmt::format("Protocol {} has no Boolean input gates",
+                                                static_cast<unsigned int>(protocol)));
+    }
+    const auto wire_shares{ShareWrapper(share).Split()};
+    auto wire_iterator{wire_shares.begin()};
+    for (auto index : indices) {
+      const auto wires_end{wire_iterator + inputs[index].size()};
+      outputs[index] = ShareWrapper::Concatenate(wire_iterator, wires_end);
+      wire_iterator = wires_end;
+    }
+  }
+  return outputs;
+}
+
 SharePointer Backend::BmrInput(std::size_t party_id, bool input) {
   return BmrInput(party_id, BitVector(1, input));
 }
@@ -240,6 +532,15 @@ SharePointer Backend::BmrInput(std::size_t party_id, std::vector<BitVector<>>&&
   return std::static_pointer_cast<Share>(input_gate->GetOutputAsBmrShare());
 }
 
+std::pair<SharePointer, ReusableFiberPromise<std::vector<BitVector<>>>*>
+Backend::BmrInput(std::size_t party_id, std::size_t number_of_wires, std::size_t number_of_simd) {
+  auto input_gate = register_->EmplaceGate<proto::bmr::InputGate>(number_of_simd, number_of_wires,
+                                                                  party_id, *this);
+  bool my_input{party_id == GetCommunicationLayer().GetMyId()};
+  return std::pair(std::static_pointer_cast<Share>(input_gate->GetOutputAsBmrShare()),
+                   my_input ? &input_gate->GetInputPromise() : nullptr);
+}
+
 SharePointer Backend::BmrOutput(const SharePointer& parent, std::size_t output_owner) {
   assert(parent);
   const auto output_gate = register_->EmplaceGate<proto::bmr::OutputGate>(parent, output_owner);
@@ -299,6 +600,94 @@ template SharePointer Backend::ArithmeticGmwInput<std::uint64_t>(
 template SharePointer Backend::ArithmeticGmwInput<__uint128_t>(std::size_t party_id,
                                                                std::vector<__uint128_t>&& input);
 
+template <typename T>
+std::pair<SharePointer, ReusableFiberPromise<std::vector<T>>*>
+Backend::ArithmeticGmwDeferredInput(std::size_t party_id, std::size_t number_of_simd) {
+  auto input_gate = register_->EmplaceGate<proto::arithmetic_gmw::InputGate<T>>(
+      number_of_simd, party_id, *this);
+  bool my_input{party_id == GetCommunicationLayer().GetMyId()};
+  return std::pair(std::static_pointer_cast<Share>(input_gate->GetOutputAsArithmeticShare()),
+                   my_input ? &input_gate->GetInputPromise() : nullptr);
+}
+
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint8_t>>*>
+Backend::ArithmeticGmwDeferredInput<std::uint8_t>(std::size_t party_id,
+                                                  std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint16_t>>*>
+Backend::ArithmeticGmwDeferredInput<std::uint16_t>(std::size_t party_id,
+                                                   std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint32_t>>*>
+Backend::ArithmeticGmwDeferredInput<std::uint32_t>(std::size_t party_id,
+                                                   std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint64_t>>*>
+Backend::ArithmeticGmwDeferredInput<std::uint64_t>(std::size_t party_id,
+                                                   std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<__uint128_t>>*>
+Backend::ArithmeticGmwDeferredInput<__uint128_t>(std::size_t party_id,
+                                                 std::size_t number_of_simd);
+
+template <typename T>
+SharePointer Backend::ArithmeticGmwInputColumn(std::size_t party_id,
+                                               const std::filesystem::path& path) {
+  auto file{std::make_shared<const MappedFile>(path)};
+  const auto input{file->GetValues<T>()};
+  return ArithmeticGmwInputColumn<T>(party_id, input, std::move(file));
+}
+
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint8_t>(
+    std::size_t party_id, const std::filesystem::path& path);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint16_t>(
+    std::size_t party_id, const std::filesystem::path& path);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint32_t>(
+    std::size_t party_id, const std::filesystem::path& path);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint64_t>(
+    std::size_t party_id, const std::filesystem::path& path);
+template SharePointer Backend::ArithmeticGmwInputColumn<__uint128_t>(
+    std::size_t party_id, const std::filesystem::path& path);
+
+template <typename T>
+SharePointer Backend::ArithmeticGmwInputColumn(std::size_t party_id, std::span<const T> input,
+                                               std::shared_ptr<const void> input_storage) {
+  auto input_gate = register_->EmplaceGate<proto::arithmetic_gmw::InputColumnGate<T>>(
+      input, std::move(input_storage), party_id, *this);
+  return std::static_pointer_cast<Share>(input_gate->GetOutputAsArithmeticShare());
+}
+
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint8_t>(
+    std::size_t party_id, std::span<const std::uint8_t> input,
+    std::shared_ptr<const void> input_storage);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint16_t>(
+    std::size_t party_id, std::span<const std::uint16_t> input,
+    std::shared_ptr<const void> input_storage);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint32_t>(
+    std::size_t party_id, std::span<const std::uint32_t> input,
+    std::shared_ptr<const void> input_storage);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint64_t>(
+    std::size_t party_id, std::span<const std::uint64_t> input,
+    std::shared_ptr<const void> input_storage);
+template SharePointer Backend::ArithmeticGmwInputColumn<__uint128_t>(
+    std::size_t party_id, std::span<const __uint128_t> input,
+    std::shared_ptr<const void> input_storage);
+
+template <typename T>
+SharePointer Backend::ArithmeticGmwInputColumn(std::size_t party_id,
+                                               std::size_t number_of_values) {
+  auto input_gate = register_->EmplaceGate<proto::arithmetic_gmw::InputColumnGate<T>>(
+      number_of_values, party_id, *this);
+  return std::static_pointer_cast<Share>(input_gate->GetOutputAsArithmeticShare());
+}
+
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint8_t>(
+    std::size_t party_id, std::size_t number_of_values);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint16_t>(
+    std::size_t party_id, std::size_t number_of_values);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint32_t>(
+    std::size_t party_id, std::size_t number_of_values);
+template SharePointer Backend::ArithmeticGmwInputColumn<std::uint64_t>(
+    std::size_t party_id, std::size_t number_of_values);
+template SharePointer Backend::ArithmeticGmwInputColumn<__uint128_t>(
+    std::size_t party_id, std::size_t number_of_values);
+
 template <typename T>
 SharePointer Backend::ArithmeticGmwOutput(const proto::arithmetic_gmw::SharePointer<T>& parent,
                                           std::size_t output_owner) {
@@ -367,6 +756,27 @@ template SharePointer Backend::AstraInput<std::uint64_t>(std::size_t party_id,
 template SharePointer Backend::AstraInput<__uint128_t>(std::size_t party_id,
                                                        std::vector<__uint128_t> input);
 
+template <typename T>
+std::pair<SharePointer, ReusableFiberPromise<std::vector<T>>*> Backend::AstraDeferredInput(
+    std::size_t party_id, std::size_t number_of_simd) {
+  auto input_gate =
+      register_->EmplaceGate<proto::astra::InputGate<T>>(number_of_simd, party_id, *this);
+  bool my_input{party_id == GetCommunicationLayer().GetMyId()};
+  return std::pair(std::static_pointer_cast<Share>(input_gate->GetOutputAsAstraShare()),
+                   my_input ? &input_gate->GetInputPromise() : nullptr);
+}
+
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint8_t>>*>
+Backend::AstraDeferredInput<std::uint8_t>(std::size_t party_id, std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint16_t>>*>
+Backend::AstraDeferredInput<std::uint16_t>(std::size_t party_id, std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint32_t>>*>
+Backend::AstraDeferredInput<std::uint32_t>(std::size_t party_id, std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<std::uint64_t>>*>
+Backend::AstraDeferredInput<std::uint64_t>(std::size_t party_id, std::size_t number_of_simd);
+template std::pair<SharePointer, ReusableFiberPromise<std::vector<__uint128_t>>*>
+Backend::AstraDeferredInput<__uint128_t>(std::size_t party_id, std::size_t number_of_simd);
+
 template <typename T>
 SharePointer Backend::AstraOutput(const proto::astra::SharePointer<T>& parent,
                                   std::size_t output_owner) {
@@ -405,6 +815,28 @@ template SharePointer Backend::AstraOutput<std::uint64_t>(const SharePointer& pa
 template SharePointer Backend::AstraOutput<__uint128_t>(const SharePointer& parent,
                                                         std::size_t output_owner);
 
+SharePointer Backend::AstraBooleanInput(std::size_t party_id,
+                                        std::span<const BitVector<>> input) {
+  auto input_gate = register_->EmplaceGate<proto::astra::BooleanInputGate>(input, party_id, *this);
+  return std::static_pointer_cast<Share>(input_gate->GetOutputAsAstraShare());
+}
+
+std::pair<SharePointer, ReusableFiberPromise<std::vector<BitVector<>>>*>
+Backend::AstraBooleanInput(std::size_t party_id, std::size_t number_of_wires,
+                           std::size_t number_of_simd) {
+  auto input_gate = register_->EmplaceGate<proto::astra::BooleanInputGate>(
+      number_of_wires, number_of_simd, party_id, *this);
+  bool my_input{party_id == GetCommunicationLayer().GetMyId()};
+  return std::pair(std::static_pointer_cast<Share>(input_gate->GetOutputAsAstraShare()),
+                   my_input ? &input_gate->GetInputPromise() : nullptr);
+}
+
+SharePointer Backend::AstraBooleanOutput(const SharePointer& parent, std::size_t output_owner) {
+  assert(parent);
+  auto output_gate = register_->EmplaceGate<proto::astra::BooleanOutputGate>(parent, output_owner);
+  return std::static_pointer_cast<Share>(output_gate->GetOutputAsAstraShare());
+}
+
 SharePointer Backend::GarbledCircuitInput(std::size_t party_id,
                                           std::span<const BitVector<>> input) {
   bool is_garbler =
@@ -442,6 +874,24 @@ SharePointer Backend::GarbledCircuitOutput(const SharePointer& parent, std::size
 
 void Backend::Synchronize() { communication_layer_->Synchronize(); }
 
+proto::garbled_circuit::Provider& Backend::GetGarbledCircuitProvider() {
+  // the provider is created with the backend, i.e., before the configuration can be changed, but
+  // the garbler only sends its setup message after the parties synchronized in Party::Run(), so
+  // the provider can still be replaced as long as no gates were created with it
+  const auto scheme{configuration_->GetGarbledCircuitScheme()};
+  if (garbled_circuit_provider_->GetScheme() != scheme) {
+    if (garbled_circuit_provider_is_used_) {
+      throw std::logic_error(
+          "The garbled circuit scheme cannot be changed after garbled circuit gates were created");
+    }
+    garbled_circuit_provider_ =
+        proto::garbled_circuit::Provider::MakeProvider(*communication_layer_, scheme);
+  }
+  // gates only read the flag once it is set, e.g., while they are evaluated concurrently
+  if (!garbled_circuit_provider_is_used_) garbled_circuit_provider_is_used_ = true;
+  return *garbled_circuit_provider_;
+}
+
 void Backend::ComputeBaseOts() {
   run_time_statistics_.back().RecordStart<RunTimeStatistics::StatisticsId::kBaseOts>();
   base_ot_provider_->ComputeBaseOts();
@@ -459,6 +909,12 @@ void Backend::OtExtensionSetup() {
   std::vector<std::future<void>> task_futures;
   task_futures.reserve(2 * (communication_layer_->GetNumberOfParties() - 1));
 
+  // share the threads of the configuration among the sender and receiver setups with every party
+  const std::size_t number_of_setups{
+      std::max<std::size_t>(1, 2 * (communication_layer_->GetNumberOfParties() - 1))};
+  ot_provider_manager_->SetNumberOfThreads(
+      std::max<std::size_t>(1, configuration_->GetNumOfThreads() / number_of_setups));
+
   for (auto i = 0ull; i < communication_layer_->GetNumberOfParties(); ++i) {
     if (i == communication_layer_->GetMyId()) {
       continue;
@@ -481,6 +937,9 @@ void Backend::OtExtensionSetup() {
 
   for (auto& f : task_futures) f.get();
 
+  // derive the base OTs of the next setup from the OTs extended now
+  ot_provider_manager_->RefreshBaseOts();
+
   run_time_statistics_.back().RecordEnd<RunTimeStatistics::StatisticsId::kOtExtensionSetup>();
 
   if constexpr (kDebug) {
@@ -488,6 +947,21 @@ void Backend::OtExtensionSetup() {
   }
 }
 
+void Backend::SaveBaseOts(const std::filesystem::path& path, std::uint64_t session_id) {
+  WaitForStartedPreprocessing();
+  PreprocessingStoreWriter writer(session_id, communication_layer_->GetMyId(),
+                                  communication_layer_->GetNumberOfParties());
+  if (!ot_provider_manager_->ExportBaseOts(writer)) {
+    throw std::logic_error("There are no refreshed base OTs which have not been used yet");
+  }
+  writer.Write(path);
+}
+
+void Backend::LoadBaseOts(const std::filesystem::path& path, std::uint64_t session_id) {
+  PreprocessingStore store(path, session_id, communication_layer_->GetMyId());
+  base_ot_provider_->ImportBaseOts(store);
+}
+
 OtProvider& Backend::GetOtProvider(std::size_t party_id) {
   return ot_provider_manager_->GetProvider(party_id);
 }
@@ -496,4 +970,107 @@ Kk13OtProvider& Backend::GetKk13OtProvider(std::size_t party_id) {
   return kk13_ot_provider_manager_->GetProvider(party_id);
 }
 
+void Backend::SetPreprocessingStore(std::shared_ptr<PreprocessingStore> store) {
+  if (mt_provider_->NeedMts()) {
+    throw std::logic_error("The MT provider cannot be changed after MTs have been requested");
+  }
+  ot_provider_manager_->SetPreprocessingStore(store);
+  mt_provider_ =
+      std::make_shared<MtProviderFromFile>(std::move(store), communication_layer_->GetMyId(),
+                                           communication_layer_->GetNumberOfParties());
+}
+
+void Backend::SetThirdPartyDealer(std::unique_ptr<communication::Transport> transport) {
+  if (mt_provider_->NeedMts() || sp_provider_->NeedSps() || sb_provider_->NeedSbs()) {
+    throw std::logic_error(
+        "The preprocessing providers cannot be changed after correlations have been requested");
+  }
+  third_party_dealer_client_ = std::make_shared<ThirdPartyDealerClient>(
+      std::move(transport), communication_layer_->GetMyId(),
+      communication_layer_->GetNumberOfParties());
+  ot_provider_manager_->SetThirdPartyDealer(third_party_dealer_client_);
+  mt_provider_ = std::make_shared<MtProviderFromThirdParty>(third_party_dealer_client_);
+  sp_provider_ = std::make_shared<SpProviderFromThirdParty>(third_party_dealer_client_);
+  sb_provider_ = std::make_shared<SbProviderFromSps>(*communication_layer_, sp_provider_, logger_,
+                                                     run_time_statistics_.back());
+  truncation_pair_provider_ = std::make_shared<TruncationPairProvider>(*sb_provider_);
+  dabit_provider_ = std::make_shared<DaBitProvider>(*sb_provider_);
+}
+
+void Backend::RegisterMetrics(const std::shared_ptr<MetricsRegistry>& registry) {
+  const MetricLabels labels{{"party", std::to_string(communication_layer_->GetMyId())}};
+  communication_layer_->RegisterMetrics(registry);
+  gate_executor_->RegisterMetrics(*registry, labels);
+  metrics_collector_ = registry->AddCollector([this, labels](MetricsSnapshot& snapshot) {
+    auto with = [&labels](std::initializer_list<std::pair<std::string, std::string>> extra) {
+      auto extended_labels{labels};
+      extended_labels.insert(extended_labels.end(), extra);
+      return extended_labels;
+    };
+    constexpr std::string_view kMts{"motion_mts_available"};
+    constexpr std::string_view kMtsHelp{"MTs generated and not yet consumed by gates"};
+    snapshot.AddGauge(kMts, kMtsHelp, with({{"type", "binary"}}),
+                      mt_provider_->GetNumberOfAvailableMts<bool>());
+    snapshot.AddGauge(kMts, kMtsHelp, with({{"type", "8"}}),
+                      mt_provider_->GetNumberOfAvailableMts<std::uint8_t>());
+    snapshot.AddGauge(kMts, kMtsHelp, with({{"type", "16"}}),
+                      mt_provider_->GetNumberOfAvailableMts<std::uint16_t>());
+    snapshot.AddGauge(kMts, kMtsHelp, with({{"type", "32"}}),
+                      mt_provider_->GetNumberOfAvailableMts<std::uint32_t>());
+    snapshot.AddGauge(kMts, kMtsHelp, with({{"type", "64"}}),
+                      mt_provider_->GetNumberOfAvailableMts<std::uint64_t>());
+    const auto& ot_providers{ot_provider_manager_->GetProviders()};
+    for (std::size_t party_id = 0; party_id < ot_providers.size(); ++party_id) {
+      if (ot_providers[party_id] == nullptr) {
+        continue;
+      }
+      const auto peer{std::to_string(party_id)};
+      constexpr std::string_view kOts{"motion_ots_registered"};
+      constexpr std::string_view kOtsHelp{"OTs registered with the OT extension of the peer"};
+      snapshot.AddGauge(kOts, kOtsHelp, with({{"peer", peer}, {"role", "sender"}}),
+                        ot_providers[party_id]->GetNumOtsSender());
+      snapshot.AddGauge(kOts, kOtsHelp, with({{"peer", peer}, {"role", "receiver"}}),
+                        ot_providers[party_id]->GetNumOtsReceiver());
+    }
+    snapshot.AddGauge("motion_gate_phases_running",
+                      "Setup and online phases of gates being evaluated by the fiber pool", labels,
+                      gate_executor_->GetNumberOfRunningGatePhases());
+  });
+}
+
+PreprocessingPlan Backend::GetPreprocessingPlan() const {
+  return PreprocessingPlan::FromProviders(*mt_provider_, *sp_provider_, *sb_provider_);
+}
+
+CostEstimate Backend::EstimateCosts(const CostModel& model) {
+  register_->EliminateDeadGates();
+  std::size_t number_of_ots{0};
+  for (const auto& provider : ot_provider_manager_->GetProviders()) {
+    if (provider) number_of_ots += provider->GetNumOtsSender() + provider->GetNumOtsReceiver();
+  }
+  return motion::EstimateCosts(*register_, GetPreprocessingPlan(), number_of_ots,
+                               communication_layer_->GetNumberOfParties(), model);
+}
+
+PartyTimeline Backend::TakeTimeline() {
+  PartyTimeline timeline;
+  timeline.party_id = communication_layer_->GetMyId();
+  // the offset of party 0 to this party with the opposite sign
+  if (!clock_offsets_.empty()) timeline.clock_offset = -clock_offsets_.at(0);
+  timeline.statistics.assign(run_time_statistics_.begin(), run_time_statistics_.end());
+  timeline.message_trace = communication_layer_->TakeMessageTrace();
+  return timeline;
+}
+
+void Backend::Prime(const PreprocessingPlan& plan) {
+  if (mt_provider_->NeedMts() || sp_provider_->NeedSps() || sb_provider_->NeedSbs()) {
+    throw std::logic_error(
+        "The preprocessing providers can only be primed before any correlations are requested");
+  }
+  // the SB provider requests its SPs while it is primed
+  sb_provider_->Prime(plan);
+  sp_provider_->Prime(plan);
+  mt_provider_->Prime(plan);
+}
+
 }  // namespace encrypto::motion
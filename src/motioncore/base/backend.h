@@ -24,19 +24,29 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 
 #include <flatbuffers/flatbuffers.h>
 #include <span>
 
 #include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
 #include "protocols/constant/constant_gate.h"
+#include "statistics/metrics.h"
 
 static_assert(FLATBUFFERS_LITTLEENDIAN);
 
 namespace encrypto::motion::communication {
 
 class CommunicationLayer;
+class Transport;
 
 }  // namespace encrypto::motion::communication
 
@@ -49,6 +59,9 @@ using SharePointer = std::shared_ptr<Share>;
 
 namespace encrypto::motion::proto {
 
+namespace astra {
+class Provider;
+}
 namespace bmr {
 class Provider;
 }
@@ -78,6 +91,7 @@ class OtProviderManager;
 
 class Gate;
 using GatePointer = std::shared_ptr<Gate>;
+class ShareWrapper;
 class InputGate;
 using InputGatePointer = std::shared_ptr<InputGate>;
 
@@ -85,12 +99,17 @@ class GarbledCircuitProvider;
 class MtProvider;
 class SpProvider;
 class SbProvider;
-
+class TruncationPairProvider;
+class DaBitProvider;
+struct CostEstimate;
+struct CostModel;
+struct PreprocessingPlan;
+class PreprocessingStore;
+class ThirdPartyDealerClient;
+
+struct PartyTimeline;
 struct RunTimeStatistics;
 
-struct SenderMessage;
-struct ReceiverMessage;
-
 class Logger;
 using LoggerPointer = std::shared_ptr<Logger>;
 
@@ -100,6 +119,7 @@ using ConfigurationPointer = std::shared_ptr<Configuration>;
 class Register;
 using RegisterPointer = std::shared_ptr<Register>;
 
+class FiberThreadPool;
 class GateExecutor;
 
 class Backend : public std::enable_shared_from_this<Backend> {
@@ -120,10 +140,51 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   void RunPreprocessing();
 
+  /// \brief Starts RunPreprocessing() for the gates constructed so far in a separate thread unless
+  /// it was already started since the last Reset() or Clear(). This allows to compute the
+  /// input-independent preprocessing of one backend while another backend is evaluating its online
+  /// phase. All parties need to call this method for the same circuit.
+  void StartPreprocessing();
+
+  /// \brief Starts the preprocessing if necessary and blocks until it is finished.
+  void WaitForPreprocessing();
+
+  /// \brief Blocks until the preprocessing is finished if it was started, e.g., before
+  /// synchronizing the parties, which must not happen concurrently to the preprocessing.
+  void WaitForStartedPreprocessing();
+
+  /// \brief Measures the links and the circuit and applies the configuration chosen by
+  /// ChooseConfiguration, see Configuration::SetAutoTune. The OT extension chunk and MT batch
+  /// sizes are only changed if the preprocessing was not started yet. All parties need to call
+  /// this method, which must not happen concurrently to the preprocessing.
+  void AutoTune();
+
   void EvaluateSequential();
 
   void EvaluateParallel();
 
+  /// \brief The outputs of a batch of SubmitBatch() with the backend owning its gates, which the
+  /// batch keeps alive such that the outputs can be read.
+  struct EvaluatedBatch {
+    std::shared_ptr<Backend> backend;
+    std::vector<SharePointer> outputs;
+  };
+
+  /// \brief Submits the next batch of a pipelined evaluation of a stream of input batches, e.g.,
+  /// of an instance of a CircuitTemplate per batch. construct_batch builds the circuit of the batch
+  /// on a new backend, which communicates over a session of this backend's communication layer
+  /// (see communication::CommunicationLayer::CreateSession), and returns its outputs. The
+  /// preprocessing of the batch starts right away, whereas the batches are evaluated one after
+  /// another in the order of their submission, such that the setup phase of batch k+1 overlaps
+  /// the online phase of batch k. All parties need to submit the same batches in the same order
+  /// from one thread. Configuration::SetAutoTune does not apply to the batches.
+  /// \returns the batch, which is ready once it has been evaluated
+  std::shared_future<EvaluatedBatch> SubmitBatch(
+      const std::function<std::vector<SharePointer>(Backend&)>& construct_batch);
+
+  /// \brief Blocks until all batches submitted by SubmitBatch() have been evaluated.
+  void WaitForBatches();
+
   const GatePointer& GetGate(std::size_t gate_id) const;
 
   const std::vector<GatePointer>& GetInputGates() const;
@@ -132,6 +193,14 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   void Clear();
 
+  /// \brief Like Clear(), but only clears the gates producing the wires of changed_shares and the
+  /// gates downstream of them, see Register::ClearDownstreamGates, such that the next evaluation
+  /// re-evaluates only these gates, e.g., after the owner of a deferred input promised its next
+  /// value. The preprocessing is kept, since re-evaluable gates do not need any.
+  /// \throws std::logic_error if the values of wires may have been released, see
+  /// Configuration::SetReleaseWireValues, or a gate to clear is not re-evaluable
+  void ClearDownstream(const std::vector<SharePointer>& changed_shares);
+
   SharePointer BooleanGmwInput(std::size_t party_id, bool input = false);
 
   SharePointer BooleanGmwInput(std::size_t party_id, const BitVector<>& input);
@@ -142,6 +211,14 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   SharePointer BooleanGmwInput(std::size_t party_id, std::vector<BitVector<>>&& input);
 
+  /// \brief Creates an input gate of number_of_wires wires with number_of_simd values each, whose
+  ///        values party_id passes later via the returned promise, e.g., after the setup phase
+  ///        ran ahead of the data. The online phase of the gate waits for them. The promise is
+  ///        nullptr for the other parties. The same holds for the deferred inputs of the other
+  ///        protocols.
+  std::pair<SharePointer, ReusableFiberPromise<std::vector<BitVector<>>>*>
+  BooleanGmwInput(std::size_t party_id, std::size_t number_of_wires, std::size_t number_of_simd);
+
   SharePointer BooleanGmwOutput(const SharePointer& parent, std::size_t output_owner);
 
   SharePointer BmrInput(std::size_t party_id, bool input = false);
@@ -154,6 +231,9 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   SharePointer BmrInput(std::size_t party_id, std::vector<BitVector<>>&& input);
 
+  std::pair<SharePointer, ReusableFiberPromise<std::vector<BitVector<>>>*> BmrInput(
+      std::size_t party_id, std::size_t number_of_wires, std::size_t number_of_simd);
+
   SharePointer BmrOutput(const SharePointer& parent, std::size_t output_owner);
 
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
@@ -184,6 +264,32 @@ class Backend : public std::enable_shared_from_this<Backend> {
   template <typename T>
   SharePointer ArithmeticGmwInput(std::size_t party_id, std::vector<T>&& input_vector);
 
+  /// \brief Deferred input of number_of_simd values, see BooleanGmwInput(party_id,
+  ///        number_of_wires, number_of_simd)
+  template <typename T>
+  std::pair<SharePointer, ReusableFiberPromise<std::vector<T>>*> ArithmeticGmwDeferredInput(
+      std::size_t party_id, std::size_t number_of_simd);
+
+  /// \brief Shares the values of type T in the file at path, which are stored in the native byte
+  ///        order, as a single proto::arithmetic_gmw::InputColumnGate without copying the column
+  ///        into memory. Called by the input owner party_id.
+  template <typename T>
+  SharePointer ArithmeticGmwInputColumn(std::size_t party_id, const std::filesystem::path& path);
+
+  /// \brief Shares the values in place, which need to stay valid as long as input_storage is alive
+  ///        or, without input_storage, until the gates are destroyed by Reset() or Clear().
+  ///        Large columns can be shared in chunks of subspans, e.g., of the values of a MappedFile
+  ///        that is passed as input_storage, where each chunk is evaluated by Run() and its output
+  ///        written by ShareWrapper::WriteTo() before the next chunk is constructed after
+  ///        Reset(). Called by the input owner party_id.
+  template <typename T>
+  SharePointer ArithmeticGmwInputColumn(std::size_t party_id, std::span<const T> input,
+                                        std::shared_ptr<const void> input_storage = nullptr);
+
+  /// \brief Called by the other parties for the column of number_of_values values of party_id.
+  template <typename T>
+  SharePointer ArithmeticGmwInputColumn(std::size_t party_id, std::size_t number_of_values);
+
   template <typename T>
   SharePointer ArithmeticGmwOutput(const proto::arithmetic_gmw::SharePointer<T>& parent,
                                    std::size_t output_owner);
@@ -197,12 +303,23 @@ class Backend : public std::enable_shared_from_this<Backend> {
   template <typename T>
   SharePointer AstraInput(std::size_t party_id, std::vector<T> input);
 
+  template <typename T>
+  std::pair<SharePointer, ReusableFiberPromise<std::vector<T>>*> AstraDeferredInput(
+      std::size_t party_id, std::size_t number_of_simd);
+
   template <typename T>
   SharePointer AstraOutput(const proto::astra::SharePointer<T>& parent, std::size_t output_owner);
 
   template <typename T>
   SharePointer AstraOutput(const SharePointer& parent, std::size_t output_owner);
 
+  SharePointer AstraBooleanInput(std::size_t party_id, std::span<const BitVector<>> input);
+
+  std::pair<SharePointer, ReusableFiberPromise<std::vector<BitVector<>>>*> AstraBooleanInput(
+      std::size_t party_id, std::size_t number_of_wires, std::size_t number_of_simd);
+
+  SharePointer AstraBooleanOutput(const SharePointer& parent, std::size_t output_owner);
+
   SharePointer GarbledCircuitInput(std::size_t party_id, bool input = false);
 
   SharePointer GarbledCircuitInput(std::size_t party_id, const BitVector<>& input);
@@ -219,17 +336,50 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   SharePointer GarbledCircuitOutput(const SharePointer& parent, std::size_t output_owner);
 
+  /// \brief Reveals the shares to all parties like ShareWrapper::Out() does, but the Boolean and
+  /// arithmetic GMW shares of each ring are opened by a single gate with one message per party,
+  /// e.g., for the thousands of outputs of an Unsimdify. Shares of other protocols get an output
+  /// gate each. Returns the output shares in the order of the given shares.
+  std::vector<ShareWrapper> Reveal(std::span<const ShareWrapper> shares);
+
+  /// \brief Shares the Boolean inputs of party_id like In() does, but all inputs with the same
+  /// number of SIMD values are shared by a single input gate, i.e., with one message per phase and
+  /// one OT vector of the garbled circuit evaluator instead of one per input, e.g., for the fields
+  /// of wide records. Supports the Boolean GMW, BMR, garbled circuit and ASTRA protocols. Returns a
+  /// share with the wires of each input in the order of the inputs.
+  /// \throws std::invalid_argument if an input has no wires or the protocol is not supported
+  std::vector<ShareWrapper> BooleanInputs(MpcProtocol protocol, std::size_t party_id,
+                                          std::span<const std::vector<BitVector<>>> inputs);
+
   /// \brief Blocking wait for synchronizing between parties. Called in Clear() and Reset()
   void Synchronize();
 
   void ComputeBaseOts();
 
+  /// \brief Runs the setup of the OT extensions, which also refreshes their base OTs, such that
+  /// the base OTs are computed only for the first evaluation and kept across Reset() and Clear()
   void OtExtensionSetup();
 
+  /// \brief Writes the base OTs refreshed by the last OT extension setup to a PreprocessingStore
+  /// at path, with owner-only permissions, from which a later process can load them with
+  /// LoadBaseOts() to skip the public-key operations of the base OTs. This process computes new
+  /// base OTs instead of using the written ones. All parties need to save after the same
+  /// evaluation and load the stores of the same evaluation.
+  /// throws std::logic_error if no base OTs were refreshed since they were last used
+  void SaveBaseOts(const std::filesystem::path& path, std::uint64_t session_id);
+
+  /// \brief Takes the unused base OTs of a store written by SaveBaseOts() instead of computing
+  /// new ones, and marks them as consumed in the store. Needs to be called before the
+  /// preprocessing is started.
+  /// throws std::runtime_error if the store cannot be opened or is not one of this party
+  void LoadBaseOts(const std::filesystem::path& path, std::uint64_t session_id);
+
   communication::CommunicationLayer& GetCommunicationLayer() { return *communication_layer_; }
 
   BaseProvider& GetBaseProvider() { return *motion_base_provider_; }
 
+  proto::astra::Provider& GetAstraProvider() { return *astra_provider_; }
+
   proto::bmr::Provider& GetBmrProvider() { return *bmr_provider_; }
 
   BaseOtProvider& GetBaseOtProvider() { return *base_ot_provider_; }
@@ -244,34 +394,113 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   auto& GetMtProvider() { return *mt_provider_; }
 
+  /// \brief Takes the random OTs and the multiplication triples from the store instead of
+  /// generating them (see OtProviderFromFile and MtProviderFromFile). Square pairs and shared bits
+  /// are then derived from the stored OTs. Needs to be called before any gates are created.
+  void SetPreprocessingStore(std::shared_ptr<PreprocessingStore> store);
+
+  /// \brief Obtains the random OTs, multiplication triples, and square pairs from a trusted
+  /// dealer which is connected by the transport (see ThirdPartyDealer). Shared bits are derived
+  /// from the square pairs. All parties need to use the same dealer, and this needs to be called
+  /// before any gates are created.
+  void SetThirdPartyDealer(std::unique_ptr<communication::Transport> transport);
+
+  /// \brief Returns the numbers of MTs, SPs and SBs requested by the gates constructed so far,
+  /// e.g., in a dry run of a circuit. Needs to be called before the preprocessing is started.
+  PreprocessingPlan GetPreprocessingPlan() const;
+
+  /// \brief Estimates the rounds, bytes per party, preprocessing material and run time of the
+  /// circuit constructed so far from the costs of its gates in the model (see EstimateCosts()),
+  /// without running any cryptography or communication. Dead gates are eliminated first if this is
+  /// enabled. Needs to be called before the preprocessing is started.
+  CostEstimate EstimateCosts(const CostModel& model);
+
+  /// \brief Reserves the MTs, SPs and SBs of the plan, which allows to start the preprocessing
+  /// (see StartPreprocessing()) before the circuit is constructed. The gates then take their
+  /// material from the reserved one, and throw std::logic_error if they request more than planned.
+  /// Needs to be called before any gates are created and after the providers are chosen (see
+  /// SetPreprocessingStore() and SetThirdPartyDealer()).
+  void Prime(const PreprocessingPlan& plan);
+
   auto& GetSpProvider() { return *sp_provider_; }
 
   auto& GetSbProvider() { return *sb_provider_; }
 
-  auto& GetGarbledCircuitProvider() { return *garbled_circuit_provider_; }
+  auto& GetTruncationPairProvider() { return *truncation_pair_provider_; }
+
+  auto& GetDaBitProvider() { return *dabit_provider_; }
+
+  /// \brief Returns the garbled circuit provider of the scheme set by
+  /// Configuration::SetGarbledCircuitScheme(), which is created for this scheme on first use.
+  /// throws std::logic_error if the scheme was changed after the provider was used
+  proto::garbled_circuit::Provider& GetGarbledCircuitProvider();
+
+  /// \brief Exposes the metrics of this party in the registry as long as the backend exists: the
+  /// traffic and send queues of the communication layer, the started and evaluated gate phases,
+  /// the generated MTs, and the registered OTs (see MetricsRegistry). Needs to be called after the
+  /// providers are chosen (see SetPreprocessingStore() and SetThirdPartyDealer()) and not during
+  /// an evaluation.
+  void RegisterMetrics(const std::shared_ptr<MetricsRegistry>& registry);
+
+  /// \brief Returns the run time statistics of all evaluations so far and the messages traced
+  /// since the last call, with the clock offset of this party to party 0, if
+  /// Configuration::SetRecordTimeline is enabled. The offset is 0 before the first preprocessing.
+  PartyTimeline TakeTimeline();
 
   const auto& GetRunTimeStatistics() const { return run_time_statistics_; }
 
   auto& GetMutableRunTimeStatistics() { return run_time_statistics_; }
 
  private:
+  /// \brief Creates or destroys the persistent fiber thread pool according to the configuration
+  /// and hands it to the gate executor
+  void PrepareFiberThreadPool();
+
+  /// \brief Waits for a started preprocessing and forgets it such that it is run again for the
+  /// next circuit
+  void ResetPreprocessing();
+
   std::list<RunTimeStatistics> run_time_statistics_;
 
+  // estimated once if Configuration::SetRecordTimeline is enabled, see TakeTimeline()
+  std::vector<std::chrono::nanoseconds> clock_offsets_;
+
+  // preprocessing running in the background, reset by Reset() and Clear()
+  std::mutex preprocessing_mutex_;
+  std::optional<std::shared_future<void>> preprocessing_future_;
+
   std::unique_ptr<communication::CommunicationLayer> communication_layer_;
   std::shared_ptr<Logger> logger_;
   ConfigurationPointer configuration_;
   RegisterPointer register_;
   std::unique_ptr<GateExecutor> gate_executor_;
+  // kept alive across evaluations if Configuration::GetPersistentThreadPool() is set
+  std::unique_ptr<FiberThreadPool> fiber_thread_pool_;
 
   std::unique_ptr<BaseProvider> motion_base_provider_;
   std::unique_ptr<BaseOtProvider> base_ot_provider_;
   std::unique_ptr<proto::garbled_circuit::Provider> garbled_circuit_provider_;
+  bool garbled_circuit_provider_is_used_{false};
   std::unique_ptr<OtProviderManager> ot_provider_manager_;
   std::unique_ptr<Kk13OtProviderManager> kk13_ot_provider_manager_;
   std::shared_ptr<MtProvider> mt_provider_;
   std::shared_ptr<SpProvider> sp_provider_;
   std::shared_ptr<SbProvider> sb_provider_;
+  std::shared_ptr<TruncationPairProvider> truncation_pair_provider_;
+  std::shared_ptr<DaBitProvider> dabit_provider_;
+  std::shared_ptr<ThirdPartyDealerClient> third_party_dealer_client_;
+  std::unique_ptr<proto::astra::Provider> astra_provider_;
   std::unique_ptr<proto::bmr::Provider> bmr_provider_;
+
+  // the sessions of the batches of SubmitBatch() are numbered from kFirstBatchSessionId on, apart
+  // from the sessions created by the user
+  static constexpr std::uint32_t kFirstBatchSessionId{std::uint32_t(1) << 31};
+  std::uint32_t next_batch_session_id_{kFirstBatchSessionId};
+  // the evaluation of the last submitted batch, which waits for the previous ones
+  std::shared_future<EvaluatedBatch> last_batch_;
+
+  // reads the members above and is hence destroyed first
+  MetricsCollectorHandle metrics_collector_;
 };
 
 using BackendPointer = std::shared_ptr<Backend>;
@@ -24,8 +24,11 @@
 
 #include "configuration.h"
 
+#include <stdexcept>
 #include <thread>
 
+#include <fmt/format.h>
+
 #include "utility/constants.h"
 
 namespace encrypto::motion {
@@ -33,7 +36,7 @@ namespace encrypto::motion {
 Configuration::Configuration(std::size_t my_id, std::size_t number_of_parties)
     : my_id_(my_id),
       number_of_parties_(number_of_parties),
-      number_of_threads_(std::max(std::thread::hardware_concurrency(), 8u)) {
+      number_of_threads_(std::max(std::thread::hardware_concurrency(), 2u)) {
   if constexpr (kVerboseDebug) {
     severity_level_ = boost::log::trivial::trace;
   } else if constexpr (kDebug) {
@@ -43,4 +46,17 @@ Configuration::Configuration(std::size_t my_id, std::size_t number_of_parties)
 
 void Configuration::SetOnlineAfterSetup(bool value) { online_after_setup_ = value; }
 
+void Configuration::SetHugePageMode(HugePageMode mode) {
+  huge_page_mode_ = mode;
+  encrypto::motion::SetHugePageMode(mode);
+}
+
+void Configuration::SetKk13CodeBitLength(std::size_t value) {
+  if (value != 128 && value != 256 && value != 512) {
+    throw std::invalid_argument(fmt::format(
+        "The KK13 code length must be 128, 256 or 512 bits, but {} bits were given", value));
+  }
+  kk13_code_bit_length_ = value;
+}
+
 }  // namespace encrypto::motion
@@ -27,6 +27,9 @@
 #include <boost/log/trivial.hpp>
 #include <memory>
 
+#include "utility/huge_page_allocator.h"
+#include "utility/typedefs.h"
+
 namespace encrypto::motion {
 
 class Configuration {
@@ -39,6 +42,18 @@ class Configuration {
 
   void SetNumOfThreads(std::size_t n) { number_of_threads_ = n; }
 
+  bool GetPinWorkerThreads() const noexcept { return pin_worker_threads_; }
+
+  void SetPinWorkerThreads(bool value) { pin_worker_threads_ = value; }
+
+  bool GetPersistentThreadPool() const noexcept { return persistent_thread_pool_; }
+
+  void SetPersistentThreadPool(bool value) { persistent_thread_pool_ = value; }
+
+  HugePageMode GetHugePageMode() const noexcept { return huge_page_mode_; }
+
+  void SetHugePageMode(HugePageMode mode);
+
   void SetLoggingSeverityLevel(boost::log::trivial::severity_level severity_level) {
     severity_level_ = severity_level;
   }
@@ -47,6 +62,75 @@ class Configuration {
 
   void SetOnlineAfterSetup(bool value);
 
+  bool GetDependencyDrivenScheduling() const noexcept { return dependency_driven_scheduling_; }
+
+  void SetDependencyDrivenScheduling(bool value) { dependency_driven_scheduling_ = value; }
+
+  bool GetLayerWiseEvaluation() const noexcept { return layer_wise_evaluation_; }
+
+  void SetLayerWiseEvaluation(bool value) { layer_wise_evaluation_ = value; }
+
+  bool GetCriticalPathPriority() const noexcept { return critical_path_priority_; }
+
+  void SetCriticalPathPriority(bool value) { critical_path_priority_ = value; }
+
+  bool GetInlineLocalGates() const noexcept { return inline_local_gates_; }
+
+  void SetInlineLocalGates(bool value) { inline_local_gates_ = value; }
+
+  bool GetCoroutineOnlinePhases() const noexcept { return coroutine_online_phases_; }
+
+  void SetCoroutineOnlinePhases(bool value) { coroutine_online_phases_ = value; }
+
+  bool GetReleaseWireValues() const noexcept { return release_wire_values_; }
+
+  void SetReleaseWireValues(bool value) { release_wire_values_ = value; }
+
+  bool GetProfileGates() const noexcept { return profile_gates_; }
+
+  void SetProfileGates(bool value) { profile_gates_ = value; }
+
+  bool GetTraceContention() const noexcept { return trace_contention_; }
+
+  void SetTraceContention(bool value) { trace_contention_ = value; }
+
+  bool GetRecordTimeline() const noexcept { return record_timeline_; }
+
+  void SetRecordTimeline(bool value) { record_timeline_ = value; }
+
+  bool GetAutoTune() const noexcept { return auto_tune_; }
+
+  void SetAutoTune(bool value) { auto_tune_ = value; }
+
+  bool GetOptimizeAlgorithms() const noexcept { return optimize_algorithms_; }
+
+  void SetOptimizeAlgorithms(bool value) { optimize_algorithms_ = value; }
+
+  std::size_t GetParallelGateThreshold() const noexcept { return parallel_gate_threshold_; }
+
+  void SetParallelGateThreshold(std::size_t value) { parallel_gate_threshold_ = value; }
+
+  std::size_t GetSimdChunkSize() const noexcept { return simd_chunk_size_; }
+
+  void SetSimdChunkSize(std::size_t value) { simd_chunk_size_ = value; }
+
+  GarbledCircuitScheme GetGarbledCircuitScheme() const noexcept { return garbled_circuit_scheme_; }
+
+  void SetGarbledCircuitScheme(GarbledCircuitScheme scheme) { garbled_circuit_scheme_ = scheme; }
+
+  bool GetAggregateBmrGarbledTables() const noexcept { return aggregate_bmr_garbled_tables_; }
+
+  void SetAggregateBmrGarbledTables(bool value) { aggregate_bmr_garbled_tables_ = value; }
+
+  bool GetKingOpenings() const noexcept { return king_openings_; }
+
+  void SetKingOpenings(bool value) { king_openings_ = value; }
+
+  std::size_t GetKk13CodeBitLength() const noexcept { return kk13_code_bit_length_; }
+
+  /// \throws std::invalid_argument if value is not 128, 256 or 512.
+  void SetKk13CodeBitLength(std::size_t value);
+
   void SetLoggingEnabled(bool value = true) { logging_enabled_ = value; }
 
   bool GetLoggingEnabled() const noexcept { return logging_enabled_; }
@@ -71,10 +155,126 @@ class Configuration {
   /// until proceeding to the online phase
   bool online_after_setup_ = false;
 
-  // determines how many worker threads are used in openmp, but not in
+  /// @param dependency_driven_scheduling_ if set true, the online phase of a gate is posted to the
+  /// fiber pool only after all of its input wires are online-ready instead of posting all gates up
+  /// front and letting them wait for their inputs
+  bool dependency_driven_scheduling_ = false;
+
+  /// @param layer_wise_evaluation_ if set true, gates are posted in the order of their circuit
+  /// depth with dependency-driven scheduling, and the openings of the multiplications of each
+  /// layer, see Gate::OpensBeforeSuspending, are sent as a single communication::MessageBatch per
+  /// party once all of them are computed. Other messages, and all of them if gates are profiled,
+  /// are sent as usual.
+  bool layer_wise_evaluation_ = false;
+
+  /// @param critical_path_priority_ if set true, gates with a longer remaining path to the outputs
+  /// of the circuit are posted first and, with dependency-driven scheduling, evaluated first among
+  /// the gates that are ready
+  bool critical_path_priority_ = false;
+
+  /// @param inline_local_gates_ if set true together with dependency_driven_scheduling_, local
+  /// gates, e.g., XOR gates, are evaluated by the fiber that completes their last input instead
+  /// of being posted to the fiber pool as separate tasks
+  bool inline_local_gates_ = false;
+
+  /// @param coroutine_online_phases_ if set true together with dependency_driven_scheduling_, the
+  /// online phases of interactive gates are started as coroutines, see
+  /// Gate::EvaluateOnlineCoroutine, which release their fiber while they await messages and are
+  /// resumed by a new task of the fiber pool, such that waiting gates hold a coroutine frame
+  /// instead of a fiber stack
+  bool coroutine_online_phases_ = false;
+
+  /// @param release_wire_values_ if set true, the values of a wire are freed as soon as all gates
+  /// reading them finished their online phase, hence only the values on wires without consumers,
+  /// e.g., the outputs, remain accessible after the evaluation
+  bool release_wire_values_ = false;
+
+  /// @param profile_gates_ if set true, the wall time of the setup and online phase of each gate
+  /// is recorded in RunTimeStatistics::gate_profile, split into compute time and the time spent
+  /// waiting on parent wires and on messages
+  bool profile_gates_ = false;
+
+  /// @param trace_contention_ if set true, the call sites at which fibers block on FiberConditions,
+  /// FiberSignals, ReusableFiberFutures and the synchronized queues during an evaluation are
+  /// recorded with their wait times and woken waiters, see ContentionTracer, and the top call sites
+  /// are logged and stored in RunTimeStatistics::contention_report
+  bool trace_contention_ = false;
+
+  /// @param record_timeline_ if set true, the messages are traced by the communication layer and
+  /// the clock offsets to the other parties are estimated before the first preprocessing, such that
+  /// the timelines of all parties can be merged, see Backend::TakeTimeline. It needs to be set
+  /// before the backend is created and by all parties.
+  bool record_timeline_ = false;
+
+  /// @param auto_tune_ if set true, Party::Run measures the links to the other parties and the
+  /// shape of the circuit before the evaluation and chooses the number of threads, whether the
+  /// online phase follows the setup, and the sizes of the OT extension chunks and MT batches from
+  /// them, see ChooseConfiguration. The sizes are kept if the preprocessing was already started.
+  /// It needs to be set by all parties, and the decision is stored in
+  /// RunTimeStatistics::tuning_decision.
+  bool auto_tune_ = false;
+
+  /// @param optimize_algorithms_ if set true, ShareWrapper::Evaluate rewrites Boolean
+  /// AlgorithmDescriptions with as few AND gates as possible before creating their gates, see
+  /// OptimizeAlgorithmDescription
+  bool optimize_algorithms_ = false;
+
+  /// @param parallel_gate_threshold_ if not 0, AND and multiplication gates of Boolean and
+  /// arithmetic GMW with at least this many values, i.e., wires times SIMD values, split the
+  /// computation of their masked inputs, the addition of the received openings, and their outputs
+  /// over GetNumOfThreads() OpenMP threads, see ParallelForRanges in utility/helpers.h. The
+  /// garbler of garbled circuits splits the garbled tables of such AND gates over the threads.
+  std::size_t parallel_gate_threshold_ = 0;
+
+  /// @param simd_chunk_size_ if not 0, ShareWrapper::Evaluate splits shares with more SIMD values
+  /// into chunks of this size, which are evaluated as independent circuits in a pipeline and
+  /// stitched back into a single output share. Needs to be set equally by all parties.
+  std::size_t simd_chunk_size_ = 0;
+
+  /// @param garbled_circuit_scheme_ the garbling scheme of the AND gates in garbled circuits, i.e.,
+  /// three-halves if bandwidth is the bottleneck or half-gates if computation is, which needs to
+  /// be set by both parties before any garbled circuit gates are created
+  GarbledCircuitScheme garbled_circuit_scheme_ = GarbledCircuitScheme::kThreeHalves;
+
+  /// @param aggregate_bmr_garbled_tables_ if set true, the parties send their shares of the garbled
+  /// tables of a BMR AND gate only to an aggregating party, which is chosen round-robin by the gate
+  /// id and broadcasts the reconstructed tables, instead of broadcasting their shares to everyone
+  bool aggregate_bmr_garbled_tables_ = false;
+
+  /// @param king_openings_ if set true, the parties open the masked inputs of the GMW AND and
+  /// multiplication gates and the outputs for all parties by sending their shares only to a king,
+  /// which is chosen round-robin by the message id and broadcasts the reconstructed value, instead
+  /// of broadcasting their shares to everyone. This costs O(n) instead of O(n^2) messages per
+  /// opening and one more hop, i.e., it pays off for more than two parties, and needs to be set by
+  /// all parties before the gates are created.
+  bool king_openings_ = false;
+
+  /// @param kk13_code_bit_length_ the length of the code words of the KK13 1-out-of-N OT extension,
+  /// i.e., the number of base OTs and rows of its bit matrices, which bounds the number of messages
+  /// N of each OT. A 128-bit code halves the base OTs, masks and hashes of the default, but the
+  /// smaller distance of its code words lowers the security, while a 512-bit code raises it at
+  /// twice the cost. It needs to be set equally by all parties.
+  std::size_t kk13_code_bit_length_ = 256;
+
+  /// @param pin_worker_threads_ if set true, the worker threads evaluating the gates are pinned to
+  /// logical cpus, one NUMA node after another, and steal work from workers on their own node first
+  bool pin_worker_threads_ = false;
+
+  /// @param persistent_thread_pool_ if set true, the backend keeps the fiber thread pool and its
+  /// pooled fiber stacks alive across evaluations, Reset() and Clear() instead of creating a new
+  /// pool for each evaluation
+  bool persistent_thread_pool_ = false;
+
+  /// @param huge_page_mode_ the pages backing large aligned buffers, e.g., of AlignedBitVector,
+  /// BitMatrix and Block128Vector, which are allocated from then on. The setting is shared by all
+  /// parties in a process, since the allocators are stateless.
+  HugePageMode huge_page_mode_ = HugePageMode::kNone;
+
+  // determines how many worker threads are used in openmp and for evaluating the gates, but not in
   // communication handlers! the latter always use at least 2 threads for each
   // communication channel to send and receive data to prevent the communication
-  // becoming a bottleneck, e.g., in 10 Gbps networks.
+  // becoming a bottleneck, e.g., in 10 Gbps networks. Defaults to the number of logical cpus, and
+  // the fiber thread pools use at least 2 workers.
   std::size_t number_of_threads_;
 };
 
@@ -0,0 +1,284 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "input_ingestion.h"
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "base/register.h"
+#include "communication/transport.h"
+#include "primitives/pseudo_random_generator.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
+#include "utility/constants.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// Header of the message of a client to one party, which is followed by the PRG seed or the values
+struct ClientInputHeader {
+  std::uint64_t client_id;
+  std::uint32_t bit_length;
+  std::uint32_t is_seed;
+  std::uint64_t number_of_values;
+};
+
+static_assert(sizeof(ClientInputHeader) == 24);
+
+// the additive share of number_of_values values that is expanded from seed
+template <typename T>
+std::vector<T> ExpandShare(const std::uint8_t* seed, std::size_t number_of_values) {
+  primitives::Prg prg;
+  prg.SetKey(seed);
+  std::vector<T> share(number_of_values);
+  prg.KeyStream(std::as_writable_bytes(std::span(share)));
+  return share;
+}
+
+template <typename T>
+std::vector<std::byte> ParseShare(const ClientInputHeader& header, const std::uint8_t* payload) {
+  if (header.is_seed) {
+    const auto share{ExpandShare<T>(payload, header.number_of_values)};
+    const auto bytes{std::as_bytes(std::span(share))};
+    return std::vector<std::byte>(bytes.begin(), bytes.end());
+  }
+  const auto bytes{reinterpret_cast<const std::byte*>(payload)};
+  return std::vector<std::byte>(bytes, bytes + header.number_of_values * sizeof(T));
+}
+
+}  // namespace
+
+template <typename T>
+std::vector<std::vector<std::uint8_t>> MakeClientInputMessages(std::uint64_t client_id,
+                                                               std::span<const T> values,
+                                                               std::size_t number_of_parties) {
+  if (number_of_parties < 2) {
+    throw std::invalid_argument("Inputs need to be shared among at least two parties");
+  }
+  const std::size_t explicit_party{client_id % number_of_parties};
+  std::vector<T> explicit_share(values.begin(), values.end());
+  std::vector<std::vector<std::uint8_t>> messages(number_of_parties);
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    const bool is_seed{party_id != explicit_party};
+    const ClientInputHeader header{client_id, sizeof(T) * 8, is_seed, values.size()};
+    auto& message{messages[party_id]};
+    message.resize(sizeof(header));
+    std::memcpy(message.data(), &header, sizeof(header));
+    if (is_seed) {
+      const auto seed{RandomVector<std::uint8_t>(kAesKeySize)};
+      message.insert(message.end(), seed.begin(), seed.end());
+      const auto share{ExpandShare<T>(seed.data(), values.size())};
+      for (std::size_t i = 0; i < values.size(); ++i) explicit_share[i] -= share[i];
+    }
+  }
+  const auto bytes{reinterpret_cast<const std::uint8_t*>(explicit_share.data())};
+  messages[explicit_party].insert(messages[explicit_party].end(), bytes,
+                                  bytes + explicit_share.size() * sizeof(T));
+  return messages;
+}
+
+InputIngestionClient::InputIngestionClient(
+    std::vector<std::unique_ptr<communication::Transport>>&& transports)
+    : transports_(std::move(transports)) {}
+
+InputIngestionClient::~InputIngestionClient() { Close(); }
+
+template <typename T>
+void InputIngestionClient::Submit(std::uint64_t client_id, std::span<const T> values) {
+  const auto messages{MakeClientInputMessages(client_id, values, transports_.size())};
+  for (std::size_t party_id = 0; party_id < transports_.size(); ++party_id) {
+    transports_[party_id]->SendMessage(messages[party_id]);
+  }
+}
+
+void InputIngestionClient::Close() {
+  for (auto& transport : transports_) transport->ShutdownSend();
+}
+
+InputIngestion::InputIngestion(std::size_t my_id, std::size_t number_of_parties)
+    : my_id_(my_id), number_of_parties_(number_of_parties) {
+  if (my_id >= number_of_parties) {
+    throw std::invalid_argument(
+        fmt::format("Party#{} does not exist among {} parties", my_id, number_of_parties));
+  }
+}
+
+InputIngestion::~InputIngestion() {
+  {
+    std::scoped_lock lock(mutex_);
+    for (auto& transport : transports_) transport->Shutdown();
+  }
+  for (auto& thread : threads_) thread.join();
+}
+
+void InputIngestion::AddClient(std::unique_ptr<communication::Transport> transport) {
+  std::scoped_lock lock(mutex_);
+  auto& client_transport{*transports_.emplace_back(std::move(transport))};
+  threads_.emplace_back([this, &client_transport] { ReceiveSubmissions(client_transport); });
+}
+
+void InputIngestion::ReceiveSubmissions(communication::Transport& transport) {
+  while (auto message{transport.ReceiveMessage()}) {
+    try {
+      Ingest(*message);
+    } catch (std::runtime_error&) {
+      // a misbehaving client cannot disturb the others
+      transport.Shutdown();
+      return;
+    }
+  }
+}
+
+void InputIngestion::Ingest(std::span<const std::uint8_t> message) {
+  if (message.size() < sizeof(ClientInputHeader)) {
+    throw std::runtime_error("Received a truncated client input");
+  }
+  ClientInputHeader header;
+  std::memcpy(&header, message.data(), sizeof(header));
+  const std::size_t value_size{header.bit_length / 8};
+  const std::size_t payload_size{header.is_seed ? kAesKeySize
+                                                : header.number_of_values * value_size};
+  if (message.size() != sizeof(header) + payload_size) {
+    throw std::runtime_error(fmt::format("Client input of client #{} has {} B instead of {} B",
+                                         header.client_id, message.size(),
+                                         sizeof(header) + payload_size));
+  }
+  const std::uint8_t* payload{message.data() + sizeof(header)};
+  Submission submission{header.bit_length, {}};
+  switch (header.bit_length) {
+    case 8:
+      submission.share = ParseShare<std::uint8_t>(header, payload);
+      break;
+    case 16:
+      submission.share = ParseShare<std::uint16_t>(header, payload);
+      break;
+    case 32:
+      submission.share = ParseShare<std::uint32_t>(header, payload);
+      break;
+    case 64:
+      submission.share = ParseShare<std::uint64_t>(header, payload);
+      break;
+    case 128:
+      submission.share = ParseShare<__uint128_t>(header, payload);
+      break;
+    default:
+      throw std::runtime_error(fmt::format("Client input of client #{} has {} bit values",
+                                           header.client_id, header.bit_length));
+  }
+  {
+    std::scoped_lock lock(mutex_);
+    if (!submissions_.emplace(header.client_id, std::move(submission)).second) {
+      throw std::runtime_error(
+          fmt::format("Client #{} submitted a second input before the first one was taken",
+                      header.client_id));
+    }
+  }
+  submission_condition_.notify_all();
+}
+
+std::size_t InputIngestion::GetNumberOfPendingSubmissions() const {
+  std::scoped_lock lock(mutex_);
+  return submissions_.size();
+}
+
+template <typename T>
+SharePointer InputIngestion::TakeBatch(Backend& backend,
+                                       std::span<const std::uint64_t> client_ids) {
+  std::vector<Submission> batch;
+  batch.reserve(client_ids.size());
+  {
+    std::unique_lock lock(mutex_);
+    for (const auto client_id : client_ids) {
+      submission_condition_.wait(lock, [this, client_id] {
+        return submissions_.contains(client_id);
+      });
+      if (submissions_.at(client_id).bit_length != sizeof(T) * 8) {
+        throw std::invalid_argument(
+            fmt::format("Client #{} submitted {} bit values instead of {} bit values", client_id,
+                        submissions_.at(client_id).bit_length, sizeof(T) * 8));
+      }
+    }
+    for (const auto client_id : client_ids) {
+      auto node{submissions_.extract(client_id)};
+      assert(node);
+      batch.emplace_back(std::move(node.mapped()));
+    }
+  }
+
+  std::size_t number_of_values{0};
+  for (const auto& submission : batch) number_of_values += submission.share.size() / sizeof(T);
+  std::vector<T> values(number_of_values);
+  auto output{reinterpret_cast<std::byte*>(values.data())};
+  for (const auto& submission : batch) {
+    std::memcpy(output, submission.share.data(), submission.share.size());
+    output += submission.share.size();
+  }
+  auto wire{backend.GetRegister()->EmplaceWire<proto::arithmetic_gmw::Wire<T>>(std::move(values),
+                                                                               backend)};
+  wire->SetOnlineFinished();
+  return std::make_shared<proto::arithmetic_gmw::Share<T>>(wire);
+}
+
+template std::vector<std::vector<std::uint8_t>> MakeClientInputMessages<std::uint8_t>(
+    std::uint64_t, std::span<const std::uint8_t>, std::size_t);
+template std::vector<std::vector<std::uint8_t>> MakeClientInputMessages<std::uint16_t>(
+    std::uint64_t, std::span<const std::uint16_t>, std::size_t);
+template std::vector<std::vector<std::uint8_t>> MakeClientInputMessages<std::uint32_t>(
+    std::uint64_t, std::span<const std::uint32_t>, std::size_t);
+template std::vector<std::vector<std::uint8_t>> MakeClientInputMessages<std::uint64_t>(
+    std::uint64_t, std::span<const std::uint64_t>, std::size_t);
+template std::vector<std::vector<std::uint8_t>> MakeClientInputMessages<__uint128_t>(
+    std::uint64_t, std::span<const __uint128_t>, std::size_t);
+
+template void InputIngestionClient::Submit<std::uint8_t>(std::uint64_t,
+                                                         std::span<const std::uint8_t>);
+template void InputIngestionClient::Submit<std::uint16_t>(std::uint64_t,
+                                                          std::span<const std::uint16_t>);
+template void InputIngestionClient::Submit<std::uint32_t>(std::uint64_t,
+                                                          std::span<const std::uint32_t>);
+template void InputIngestionClient::Submit<std::uint64_t>(std::uint64_t,
+                                                          std::span<const std::uint64_t>);
+template void InputIngestionClient::Submit<__uint128_t>(std::uint64_t,
+                                                        std::span<const __uint128_t>);
+
+template SharePointer InputIngestion::TakeBatch<std::uint8_t>(Backend&,
+                                                              std::span<const std::uint64_t>);
+template SharePointer InputIngestion::TakeBatch<std::uint16_t>(Backend&,
+                                                               std::span<const std::uint64_t>);
+template SharePointer InputIngestion::TakeBatch<std::uint32_t>(Backend&,
+                                                               std::span<const std::uint64_t>);
+template SharePointer InputIngestion::TakeBatch<std::uint64_t>(Backend&,
+                                                               std::span<const std::uint64_t>);
+template SharePointer InputIngestion::TakeBatch<__uint128_t>(Backend&,
+                                                             std::span<const std::uint64_t>);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace encrypto::motion::communication {
+
+class Transport;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion {
+
+class Backend;
+class Share;
+using SharePointer = std::shared_ptr<Share>;
+
+// Returns the messages of an external client to each of the number_of_parties compute parties,
+// which secret-share values additively among them. All parties but one receive only a 16 B PRG
+// seed from which they expand their shares, and the party client_id % number_of_parties receives
+// the values minus the expanded shares of the others, such that the traffic of the clients is
+// spread over the parties.
+template <typename T>
+std::vector<std::vector<std::uint8_t>> MakeClientInputMessages(std::uint64_t client_id,
+                                                               std::span<const T> values,
+                                                               std::size_t number_of_parties);
+
+// A lightweight data owner connected to every compute party by a transport, which submits its
+// inputs to the InputIngestion of the parties instead of taking part in the protocol
+class InputIngestionClient {
+ public:
+  InputIngestionClient(std::vector<std::unique_ptr<communication::Transport>>&& transports);
+  ~InputIngestionClient();
+
+  InputIngestionClient(const InputIngestionClient&) = delete;
+
+  // submits the values under client_id, which needs to be unique among the pending submissions
+  template <typename T>
+  void Submit(std::uint64_t client_id, std::span<const T> values);
+
+  // signals the parties that no further inputs follow
+  void Close();
+
+ private:
+  std::vector<std::unique_ptr<communication::Transport>> transports_;
+};
+
+// Collects the shares which external clients submit to this compute party concurrently to the
+// evaluation of circuits, and batches them into wide SIMD arithmetic GMW shares without input
+// gates. The parties need to agree on the client ids of a batch and their order, e.g., by a fixed
+// schedule of the ids or by announcing the ids of a batch.
+class InputIngestion {
+ public:
+  InputIngestion(std::size_t my_id, std::size_t number_of_parties);
+  // shuts down the transports of the clients
+  ~InputIngestion();
+
+  InputIngestion(const InputIngestion&) = delete;
+
+  // receives the submissions of a client on a thread of its own until the client closes the
+  // transport, malformed messages close it as well
+  void AddClient(std::unique_ptr<communication::Transport> transport);
+
+  // stores the share of a submission that was received by other means, e.g., by an event-driven
+  // front-end for many short-lived clients
+  // throws std::runtime_error if the message is malformed or the client id is already pending
+  void Ingest(std::span<const std::uint8_t> message);
+
+  std::size_t GetNumberOfPendingSubmissions() const;
+
+  // Waits for the submissions of the clients, removes them, and returns the concatenation of
+  // their shares as one SIMD arithmetic GMW share in backend, which is ready without any gate or
+  // communication
+  // throws std::invalid_argument if a submission has values of another type
+  template <typename T>
+  SharePointer TakeBatch(Backend& backend, std::span<const std::uint64_t> client_ids);
+
+ private:
+  struct Submission {
+    std::size_t bit_length;
+    // the share of this party of the values
+    std::vector<std::byte> share;
+  };
+
+  void ReceiveSubmissions(communication::Transport& transport);
+
+  const std::size_t my_id_;
+  const std::size_t number_of_parties_;
+  mutable std::mutex mutex_;
+  std::condition_variable submission_condition_;
+  std::map<std::uint64_t, Submission> submissions_;
+  std::vector<std::unique_ptr<communication::Transport>> transports_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace encrypto::motion
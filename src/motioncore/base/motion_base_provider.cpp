@@ -22,6 +22,13 @@
 
 #include "motion_base_provider.h"
 
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/hello_message_generated.h"
 #include "communication/fbs_headers/message_generated.h"
@@ -34,6 +41,68 @@
 
 namespace encrypto::motion {
 
+namespace {
+
+constexpr std::size_t kSeedSize{32};
+constexpr std::size_t kFixedKeyAesSeedSize{16};
+constexpr std::array<char, 8> kSeedsMagic{'M', 'O', 'T', 'I', 'O', 'N', 'S', 'D'};
+
+void WriteBytes(std::ofstream& file, const std::vector<std::uint8_t>& bytes) {
+  const std::uint64_t size{bytes.size()};
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(size));
+}
+
+std::vector<std::uint8_t> ReadBytes(std::ifstream& file) {
+  std::uint64_t size{0};
+  file.read(reinterpret_cast<char*>(&size), sizeof(size));
+  // seeds are small, so a larger size is a corrupt file
+  if (!file || size > kSeedSize) {
+    throw std::runtime_error("corrupt seeds file");
+  }
+  std::vector<std::uint8_t> bytes(size);
+  file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size));
+  return bytes;
+}
+
+}  // namespace
+
+void BaseProvider::Seeds::Save(const std::filesystem::path& path) const {
+  std::ofstream file(path, std::ios::binary);
+  file.write(kSeedsMagic.data(), kSeedsMagic.size());
+  const std::uint64_t number_of_parties{input_sharing_seeds.size()};
+  file.write(reinterpret_cast<const char*>(&number_of_parties), sizeof(number_of_parties));
+  for (const auto& seed : input_sharing_seeds) {
+    WriteBytes(file, seed);
+  }
+  WriteBytes(file, global_sharing_seed);
+  WriteBytes(file, fixed_key_aes_seed);
+  if (!file) {
+    throw std::runtime_error(fmt::format("could not write the seeds to {}", path.string()));
+  }
+}
+
+BaseProvider::Seeds BaseProvider::Seeds::Load(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::array<char, kSeedsMagic.size()> magic{};
+  file.read(magic.data(), magic.size());
+  std::uint64_t number_of_parties{0};
+  file.read(reinterpret_cast<char*>(&number_of_parties), sizeof(number_of_parties));
+  if (!file || magic != kSeedsMagic) {
+    throw std::runtime_error(fmt::format("{} contains no seeds", path.string()));
+  }
+  Seeds seeds;
+  for (std::uint64_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    seeds.input_sharing_seeds.push_back(ReadBytes(file));
+  }
+  seeds.global_sharing_seed = ReadBytes(file);
+  seeds.fixed_key_aes_seed = ReadBytes(file);
+  if (!file) {
+    throw std::runtime_error(fmt::format("the seeds in {} are truncated", path.string()));
+  }
+  return seeds;
+}
+
 BaseProvider::BaseProvider(communication::CommunicationLayer& communication_layer)
     : communication_layer_(communication_layer),
       logger_(communication_layer_.GetLogger()),
@@ -46,6 +115,20 @@ BaseProvider::BaseProvider(communication::CommunicationLayer& communication_laye
 
 BaseProvider::~BaseProvider() {}
 
+void BaseProvider::SetSeeds(Seeds seeds) {
+  bool fits{seeds.input_sharing_seeds.size() == number_of_parties_ &&
+            seeds.global_sharing_seed.size() == kSeedSize &&
+            seeds.fixed_key_aes_seed.size() == kFixedKeyAesSeedSize};
+  for (std::size_t party_id = 0; fits && party_id < number_of_parties_; ++party_id) {
+    fits = party_id == my_id_ || seeds.input_sharing_seeds[party_id].size() == kSeedSize;
+  }
+  if (!fits) {
+    throw std::invalid_argument(
+        fmt::format("the seeds do not fit party {} of {} parties", my_id_, number_of_parties_));
+  }
+  preset_seeds_ = std::move(seeds);
+}
+
 void BaseProvider::Setup() {
   if constexpr (kDebug) {
     if (logger_) {
@@ -54,11 +137,21 @@ void BaseProvider::Setup() {
   }
 
   // generate share, broadcast, wait for messages, xor
-  aes_fixed_key_ = RandomVector<std::uint8_t>(16);
-  std::vector<std::vector<std::uint8_t>> my_seeds;
-  std::generate_n(std::back_inserter(my_seeds), number_of_parties_,
-                  [] { return RandomVector<std::uint8_t>(32); });
-  std::vector<std::uint8_t> global_seed = RandomVector<std::uint8_t>(32);
+  if (preset_seeds_.has_value()) {
+    seeds_ = std::move(*preset_seeds_);
+    preset_seeds_.reset();
+  } else {
+    seeds_.fixed_key_aes_seed = RandomVector<std::uint8_t>(kFixedKeyAesSeedSize);
+    seeds_.input_sharing_seeds.clear();
+    for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+      seeds_.input_sharing_seeds.push_back(
+          party_id == my_id_ ? std::vector<std::uint8_t>{} : RandomVector<std::uint8_t>(kSeedSize));
+    }
+    seeds_.global_sharing_seed = RandomVector<std::uint8_t>(kSeedSize);
+  }
+  aes_fixed_key_ = seeds_.fixed_key_aes_seed;
+  auto my_seeds{seeds_.input_sharing_seeds};
+  std::vector<std::uint8_t> global_seed = seeds_.global_sharing_seed;
 
   // prepare and send HelloMessage
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
@@ -23,9 +23,13 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "communication/message_buffer.h"
 #include "utility/fiber_waitable.h"
 #include "utility/reusable_future.h"
 
@@ -48,11 +52,34 @@ class Logger;
 
 class BaseProvider : public FiberSetupWaitable {
  public:
+  // the randomness this party contributes to the hello messages, from which the randomness
+  // generators of the input sharing, the global randomness generator and the fixed AES key derive
+  struct Seeds {
+    // 32 bytes for each other party, empty for this party
+    std::vector<std::vector<std::uint8_t>> input_sharing_seeds;
+    std::vector<std::uint8_t> global_sharing_seed;  // 32 bytes
+    std::vector<std::uint8_t> fixed_key_aes_seed;   // 16 bytes
+
+    // Writes the seeds to a binary file, throws a std::runtime_error if this fails.
+    void Save(const std::filesystem::path& path) const;
+
+    // Reads seeds written by Save, throws a std::runtime_error if this fails.
+    static Seeds Load(const std::filesystem::path& path);
+  };
+
   BaseProvider(communication::CommunicationLayer&);
   ~BaseProvider();
 
   void Setup();
 
+  // the seeds of the last Setup
+  const Seeds& GetSeeds() const { return seeds_; }
+
+  // Use the given seeds in the next Setup instead of sampling new ones, e.g., the seeds of a
+  // recorded run replayed with communication::ReplayTransport, which then yields the same shares.
+  // Throws a std::invalid_argument if the seeds do not fit the number of parties.
+  void SetSeeds(Seeds seeds);
+
   const std::vector<std::uint8_t>& GetAesFixedKey() const { return aes_fixed_key_; }
   primitives::SharingRandomnessGenerator& GetMyRandomnessGenerator(std::size_t party_id) {
     return *my_randomness_generators_[party_id];
@@ -70,11 +97,13 @@ class BaseProvider : public FiberSetupWaitable {
   std::size_t number_of_parties_;
   std::size_t my_id_;
   std::vector<std::uint8_t> aes_fixed_key_;
+  Seeds seeds_;
+  std::optional<Seeds> preset_seeds_;
   std::vector<std::unique_ptr<primitives::SharingRandomnessGenerator>> my_randomness_generators_;
   std::vector<std::unique_ptr<primitives::SharingRandomnessGenerator>> their_randomness_generators_;
   std::unique_ptr<primitives::SharingRandomnessGenerator> global_randomness_generator_;
 
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> hello_message_futures_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> hello_message_futures_;
 };
 
 }  // namespace encrypto::motion
@@ -100,7 +100,12 @@ void Party::Run(std::size_t repetitions) {
     return;
   }
 
+  // synchronizing must not happen concurrently to a preprocessing started by StartPreprocessing()
+  backend_->WaitForStartedPreprocessing();
   backend_->Synchronize();
+  if (configuration_->GetAutoTune()) {
+    backend_->AutoTune();
+  }
   for (auto i = 0ull; i < repetitions; ++i) {
     if (i > 0u) {
       Clear();
@@ -110,6 +115,10 @@ void Party::Run(std::size_t repetitions) {
   }
 }
 
+std::future<void> Party::RunAsync() {
+  return std::async(std::launch::async, [this] { Run(); });
+}
+
 void Party::Reset() {
   logger_->LogError("Not yet implemented");
   backend_->Synchronize();
@@ -130,6 +139,14 @@ void Party::Clear() {
   backend_->Synchronize();
 }
 
+void Party::ClearDownstream(const std::vector<SharePointer>& changed_shares) {
+  backend_->Synchronize();
+  logger_->LogDebug("Party clear downstream");
+  backend_->ClearDownstream(changed_shares);
+  logger_->LogDebug("Party sync");
+  backend_->Synchronize();
+}
+
 void Party::EvaluateCircuit() {
   if (configuration_->GetOnlineAfterSetup()) {
     backend_->EvaluateSequential();
@@ -141,6 +158,8 @@ void Party::EvaluateCircuit() {
 void Party::Finish() {
   bool finished = finished_.exchange(true);
   if (!finished) {
+    // the batches of Backend::SubmitBatch communicate over sessions of the communication layer
+    backend_->WaitForBatches();
     backend_->GetCommunicationLayer().Shutdown();
     logger_->LogInfo(fmt::format("Finished evaluating {} gates",
                                  backend_->GetRegister()->GetTotalNumberOfGates()));
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <fmt/format.h>
+#include <future>
 #include <memory>
 #include <span>
 #include <vector>
@@ -66,7 +67,6 @@ class Party {
                   std::size_t party_id = std::numeric_limits<std::size_t>::max()) {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
-    static_assert(P != MpcProtocol::kAstra);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
         // TODO implement
@@ -82,6 +82,9 @@ class Party {
       case MpcProtocol::kGarbledCircuit: {
         return backend_->GarbledCircuitInput(party_id, input);
       }
+      case MpcProtocol::kAstra: {
+        return backend_->AstraBooleanInput(party_id, input);
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -99,18 +102,37 @@ class Party {
         // return backend_->BooleanGmwInput(party_id, input);
       }
       case MpcProtocol::kBooleanGmw: {
-        // TODO implement
-        static_assert(P != MpcProtocol::kBooleanGmw, "Not implemented yet");
-        // return backend_->BooleanGmwInput(party_id, input);
+        return backend_->BooleanGmwInput(input_owner_id, number_of_wires, number_of_simd);
       }
       case MpcProtocol::kBmr: {
-        // TODO implement
-        static_assert(P != MpcProtocol::kBmr, "Not implemented yet");
-        // return backend_->BmrInput(party_id, input);
+        return backend_->BmrInput(input_owner_id, number_of_wires, number_of_simd);
       }
       case MpcProtocol::kGarbledCircuit: {
         return backend_->GarbledCircuitInput(input_owner_id, number_of_wires, number_of_simd);
       }
+      case MpcProtocol::kAstra: {
+        return backend_->AstraBooleanInput(input_owner_id, number_of_wires, number_of_simd);
+      }
+      default: {
+        throw std::runtime_error(fmt::format("Unknown or unimplemented MPC protocol with id {}",
+                                             static_cast<unsigned int>(P)));
+      }
+    }
+  }
+
+  /// \brief Creates an arithmetic input of number_of_simd values, which input_owner_id passes
+  ///        later via the returned promise, e.g., after the setup phase. The promise is nullptr
+  ///        for the other parties.
+  template <MpcProtocol P, typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  std::pair<SharePointer, ReusableFiberPromise<std::vector<T>>*> DeferredIn(
+      std::size_t input_owner_id, std::size_t number_of_simd) {
+    switch (P) {
+      case MpcProtocol::kArithmeticGmw: {
+        return backend_->ArithmeticGmwDeferredInput<T>(input_owner_id, number_of_simd);
+      }
+      case MpcProtocol::kAstra: {
+        return backend_->AstraDeferredInput<T>(input_owner_id, number_of_simd);
+      }
       default: {
         throw std::runtime_error(fmt::format("Unknown or unimplemented MPC protocol with id {}",
                                              static_cast<unsigned int>(P)));
@@ -123,7 +145,6 @@ class Party {
                   std::size_t party_id = std::numeric_limits<std::size_t>::max()) {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
-    static_assert(P != MpcProtocol::kAstra);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
         // TODO implement
@@ -139,6 +160,9 @@ class Party {
       case MpcProtocol::kGarbledCircuit: {
         return backend_->GarbledCircuitInput(party_id, input);
       }
+      case MpcProtocol::kAstra: {
+        return backend_->AstraBooleanInput(party_id, input);
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -151,7 +175,6 @@ class Party {
                   std::size_t party_id = std::numeric_limits<std::size_t>::max()) {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
-    static_assert(P != MpcProtocol::kAstra);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
         // TODO implement
@@ -164,6 +187,9 @@ class Party {
       case MpcProtocol::kBmr: {
         return backend_->BmrInput(party_id, input);
       }
+      case MpcProtocol::kAstra: {
+        return backend_->AstraBooleanInput(party_id, std::span(&input, 1));
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -176,7 +202,6 @@ class Party {
                   std::size_t party_id = std::numeric_limits<std::size_t>::max()) {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
-    static_assert(P != MpcProtocol::kAstra);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
         // TODO implement
@@ -189,6 +214,9 @@ class Party {
       case MpcProtocol::kBmr: {
         return backend_->BmrInput(party_id, input);
       }
+      case MpcProtocol::kAstra: {
+        return backend_->AstraBooleanInput(party_id, std::span(&input, 1));
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -402,6 +430,19 @@ class Party {
   /// @param repetitions Number of iterations.
   void Run(std::size_t repetitions = 1);
 
+  /// \brief Runs Run() once in a separate thread.
+  /// No gates may be constructed until the returned future is ready, so all batches of inputs
+  /// need to be part of the circuit beforehand. The outputs of a batch can be consumed via
+  /// ShareWrapper::WaitOnline() before the other batches have finished. Batches that arrive one
+  /// by one can be submitted by Backend::SubmitBatch() instead.
+  /// \returns a future that becomes ready when the whole evaluation has finished.
+  std::future<void> RunAsync();
+
+  /// \brief Starts the input-independent preprocessing of the gates constructed so far in the
+  /// background, e.g., while another Party evaluates the online phase of a previous circuit.
+  /// Run() waits for it and does not repeat it. All parties need to call this method.
+  void StartPreprocessing() { backend_->StartPreprocessing(); }
+
   /// \brief Destroys all the gates and wires that were constructed until now.
   void Reset();
 
@@ -409,6 +450,12 @@ class Party {
   /// can be executed again.
   void Clear();
 
+  /// \brief Like Clear(), but Party::Run() then only re-evaluates the gates producing the wires
+  /// of changed_shares and the gates downstream of them, whereas all other gates keep their
+  /// results, see Backend::ClearDownstream. All parties need to call this method with the same
+  /// shares.
+  void ClearDownstream(const std::vector<SharePointer>& changed_shares);
+
   const auto& GetLogger() { return logger_; }
 
   /// \brief Sends a termination message to all of the connected parties.
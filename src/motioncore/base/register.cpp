@@ -24,10 +24,15 @@
 
 #include "register.h"
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <unordered_set>
 
 #include <fmt/format.h>
 
+#include "algorithm/algorithm_description.h"
+#include "algorithm/circuit_cache.h"
 #include "configuration.h"
 #include "protocols/gate.h"
 #include "protocols/wire.h"
@@ -37,6 +42,31 @@
 
 namespace encrypto::motion {
 
+// the subcircuit constructed by the thread, see Subcircuit::Scope
+static thread_local Subcircuit* current_subcircuit{nullptr};
+
+Subcircuit::Scope::Scope(Subcircuit& subcircuit) : previous_subcircuit_(current_subcircuit) {
+  current_subcircuit = &subcircuit;
+}
+
+Subcircuit::Scope::~Scope() { current_subcircuit = previous_subcircuit_; }
+
+Subcircuit::Subcircuit(Register& register_reference, std::size_t index, std::size_t gate_position,
+                       std::size_t wire_position, std::size_t first_gate_id,
+                       std::size_t number_of_gates, std::size_t first_wire_id,
+                       std::size_t number_of_wires)
+    : register_(register_reference),
+      index_(index),
+      gate_position_(gate_position),
+      wire_position_(wire_position),
+      next_gate_id_(first_gate_id),
+      end_gate_id_(first_gate_id + number_of_gates),
+      next_wire_id_(first_wire_id),
+      end_wire_id_(first_wire_id + number_of_wires) {
+  gates_.reserve(number_of_gates);
+  wires_.reserve(number_of_wires);
+}
+
 Register::Register(std::shared_ptr<Logger> logger) : logger_(std::move(logger)) {
   gates_setup_done_condition_ =
       std::make_shared<FiberCondition>([this]() { return gates_setup_done_flag_; });
@@ -49,13 +79,44 @@ Register::~Register() {
   wires_.clear();
 }
 
-std::size_t Register::NextGateId() noexcept {
-  // TODO the return value is old global_gate_id, not the increased one. Check if that is intended.
+Subcircuit* Register::GetSubcircuit() {
+  return current_subcircuit != nullptr && &current_subcircuit->register_ == this
+             ? current_subcircuit
+             : nullptr;
+}
+
+const std::shared_ptr<ObjectArena>& Register::GetArena() {
+  auto subcircuit{GetSubcircuit()};
+  return subcircuit != nullptr ? subcircuit->arena_ : arena_;
+}
+
+std::size_t Register::NextGateId() {
+  if (auto subcircuit{GetSubcircuit()}) {
+    if (subcircuit->next_gate_id_ == subcircuit->end_gate_id_) {
+      throw std::length_error(fmt::format("Subcircuit {} exceeds its {} reserved gate ids",
+                                          subcircuit->index_, subcircuit->gates_.capacity()));
+    }
+    return subcircuit->next_gate_id_++;
+  }
+  if (global_gate_id_ == kMaxNumberOfIds) {
+    throw std::length_error(
+        fmt::format("The circuit of epoch {} exceeds {} gate ids", epoch_, kMaxNumberOfIds));
+  }
   return global_gate_id_++;
 }
 
-std::size_t Register::NextWireId() noexcept {
-  // TODO the return value is old global_wire_id, not the increased one. Check if that is intended.
+std::size_t Register::NextWireId() {
+  if (auto subcircuit{GetSubcircuit()}) {
+    if (subcircuit->next_wire_id_ == subcircuit->end_wire_id_) {
+      throw std::length_error(fmt::format("Subcircuit {} exceeds its {} reserved wire ids",
+                                          subcircuit->index_, subcircuit->wires_.capacity()));
+    }
+    return subcircuit->next_wire_id_++;
+  }
+  if (global_wire_id_ == kMaxNumberOfIds) {
+    throw std::length_error(
+        fmt::format("The circuit of epoch {} exceeds {} wire ids", epoch_, kMaxNumberOfIds));
+  }
   return global_wire_id_++;
 }
 
@@ -75,6 +136,14 @@ std::size_t Register::NextBooleanGmwSharingId(std::size_t number_of_parallel_val
 
 void Register::RegisterGate(const GatePointer& gate) {
   assert(gate != nullptr);
+  if (auto subcircuit{GetSubcircuit()}) {
+    // counted when the subcircuit is merged
+    subcircuit->gates_setup_ += gate->NeedsSetup() ? 1 : 0;
+    subcircuit->gates_online_ += gate->NeedsOnline() ? 1 : 0;
+    subcircuit->gates_.push_back(gate);
+    return;
+  }
+  dead_gates_eliminated_ = false;
   if (gate->NeedsSetup()) {
     gates_setup_++;
   }
@@ -84,6 +153,133 @@ void Register::RegisterGate(const GatePointer& gate) {
   gates_.push_back(gate);
 }
 
+void Register::RegisterWire(const WirePointer& wire) {
+  if (auto subcircuit{GetSubcircuit()}) {
+    subcircuit->wires_.push_back(wire);
+  } else {
+    wires_.push_back(wire);
+  }
+}
+
+void Register::RunInConstructionOrder(std::function<void()> request) {
+  RunOrDeferRequest(-1, std::move(request));
+}
+
+void Register::RunInConstructionOrder(const Gate& gate, std::function<void()> request) {
+  RunOrDeferRequest(gate.GetId(), std::move(request));
+}
+
+void Register::RunOrDeferRequest(std::int64_t gate_id, std::function<void()> request) {
+  if (auto subcircuit{GetSubcircuit()}) {
+    subcircuit->deferred_requests_.emplace_back(gate_id, std::move(request));
+  } else if (dead_gate_elimination_) {
+    deferred_requests_.emplace_back(gate_id, std::move(request));
+  } else {
+    request();
+  }
+}
+
+std::unique_ptr<Subcircuit> Register::ReserveSubcircuit(std::size_t number_of_gates,
+                                                        std::size_t number_of_wires) {
+  if (GetSubcircuit() != nullptr) {
+    throw std::logic_error("Subcircuits cannot be reserved while constructing a subcircuit");
+  }
+  if (number_of_gates > kMaxNumberOfIds - global_gate_id_ ||
+      number_of_wires > kMaxNumberOfIds - global_wire_id_) {
+    throw std::length_error(fmt::format(
+        "Reserving a subcircuit of {} gates and {} wires exceeds the {} ids of epoch {}",
+        number_of_gates, number_of_wires, kMaxNumberOfIds, epoch_));
+  }
+  std::unique_ptr<Subcircuit> subcircuit(
+      new Subcircuit(*this, number_of_reserved_subcircuits_++, gates_.size(), wires_.size(),
+                     global_gate_id_, number_of_gates, global_wire_id_, number_of_wires));
+  global_gate_id_ += number_of_gates;
+  global_wire_id_ += number_of_wires;
+  return subcircuit;
+}
+
+void Register::MergeSubcircuit(std::unique_ptr<Subcircuit>&& subcircuit) {
+  assert(subcircuit != nullptr);
+  if (&subcircuit->register_ != this ||
+      subcircuit->index_ != number_of_merged_subcircuits_) {
+    throw std::logic_error(fmt::format(
+        "Subcircuit {} is merged before subcircuit {}, but subcircuits must be merged in the order "
+        "of their reservation",
+        subcircuit->index_, number_of_merged_subcircuits_));
+  }
+  ++number_of_merged_subcircuits_;
+  gates_setup_ += subcircuit->gates_setup_;
+  gates_online_ += subcircuit->gates_online_;
+  dead_gates_eliminated_ = false;
+  for (auto& [gate_id, request] : subcircuit->deferred_requests_) {
+    RunOrDeferRequest(gate_id, std::move(request));
+  }
+  subcircuit->deferred_requests_.clear();
+  merged_subcircuits_.emplace_back(std::move(subcircuit));
+  if (GetNumberOfPendingSubcircuits() == 0) {
+    InsertMergedSubcircuits();
+  }
+}
+
+void Register::InsertMergedSubcircuits() {
+  std::size_t number_of_gates{gates_.size()}, number_of_wires{wires_.size()};
+  for (auto& subcircuit : merged_subcircuits_) {
+    number_of_gates += subcircuit->gates_.size();
+    number_of_wires += subcircuit->wires_.size();
+  }
+  // the subcircuits are ordered by their positions, hence the gates remain ordered by their ids
+  std::vector<GatePointer> gates;
+  std::vector<WirePointer> wires;
+  gates.reserve(number_of_gates);
+  wires.reserve(number_of_wires);
+  std::size_t gate_position{0}, wire_position{0};
+  for (auto& subcircuit : merged_subcircuits_) {
+    std::move(gates_.begin() + gate_position, gates_.begin() + subcircuit->gate_position_,
+              std::back_inserter(gates));
+    std::move(wires_.begin() + wire_position, wires_.begin() + subcircuit->wire_position_,
+              std::back_inserter(wires));
+    std::move(subcircuit->gates_.begin(), subcircuit->gates_.end(), std::back_inserter(gates));
+    std::move(subcircuit->wires_.begin(), subcircuit->wires_.end(), std::back_inserter(wires));
+    gate_position = subcircuit->gate_position_;
+    wire_position = subcircuit->wire_position_;
+  }
+  std::move(gates_.begin() + gate_position, gates_.end(), std::back_inserter(gates));
+  std::move(wires_.begin() + wire_position, wires_.end(), std::back_inserter(wires));
+  gates_ = std::move(gates);
+  wires_ = std::move(wires);
+  // the arenas of the subcircuits are kept alive by the allocations of their gates and wires
+  merged_subcircuits_.clear();
+}
+
+const GatePointer& Register::GetGate(std::size_t gate_id) const {
+  // the gates are ordered by their dense ids, which have gaps only if subcircuits used fewer ids
+  // than they reserved
+  if (gate_id < gates_.size() && static_cast<std::size_t>(gates_[gate_id]->GetId()) == gate_id) {
+    return gates_[gate_id];
+  }
+  auto iterator{std::lower_bound(gates_.begin(), gates_.end(), gate_id,
+                                 [](const GatePointer& gate, std::size_t id) {
+                                   return static_cast<std::size_t>(gate->GetId()) < id;
+                                 })};
+  if (iterator == gates_.end() || static_cast<std::size_t>((*iterator)->GetId()) != gate_id) {
+    throw std::out_of_range(fmt::format("There is no gate with id {}", gate_id));
+  }
+  return *iterator;
+}
+
+WirePointer Register::GetWire(std::size_t wire_id) const {
+  if (wire_id < wires_.size() && wires_[wire_id]->GetWireId() == wire_id) {
+    return wires_[wire_id];
+  }
+  auto iterator{std::lower_bound(
+      wires_.begin(), wires_.end(), wire_id,
+      [](const WirePointer& wire, std::size_t id) { return wire->GetWireId() < id; })};
+  if (iterator == wires_.end() || (*iterator)->GetWireId() != wire_id) {
+    throw std::out_of_range(fmt::format("There is no wire with id {}", wire_id));
+  }
+  return *iterator;
+}
+
 void Register::IncrementEvaluatedGatesSetupCounter() {
   ++evaluated_gates_setup_;
   CheckSetupCondition();
@@ -94,6 +290,106 @@ void Register::IncrementEvaluatedGatesOnlineCounter() {
   CheckOnlineCondition();
 }
 
+std::vector<GatePointer> Register::GetDownstreamGates(
+    const std::vector<GatePointer>& changed_gates) const {
+  std::unordered_set<const Gate*> dirty_gates;
+  std::unordered_set<const Wire*> dirty_wires;
+  for (auto& gate : changed_gates) {
+    dirty_gates.insert(gate.get());
+  }
+  // consumers are registered after the gates producing their inputs, hence a single pass suffices
+  std::vector<GatePointer> downstream_gates;
+  for (auto& gate : gates_) {
+    bool is_dirty = dirty_gates.contains(gate.get());
+    if (!is_dirty) {
+      const auto input_wires = gate->GetInputWires();
+      is_dirty = std::any_of(input_wires.begin(), input_wires.end(), [&dirty_wires](auto& wire) {
+        return dirty_wires.contains(wire.get());
+      });
+    }
+    if (is_dirty) {
+      for (auto& wire : gate->GetOutputWires()) {
+        dirty_wires.insert(wire.get());
+      }
+      downstream_gates.emplace_back(gate);
+    }
+  }
+  return downstream_gates;
+}
+
+// gates of the other protocols reserve per-backend state in their constructors, e.g., batches of
+// the garbled circuit and ASTRA providers, and are evaluated even if their outputs are not used
+static bool IsRemovable(const Gate& gate) {
+  const auto is_gmw_or_constant = [](const WirePointer& wire) {
+    const auto protocol{wire->GetProtocol()};
+    return protocol == MpcProtocol::kBooleanGmw || protocol == MpcProtocol::kArithmeticGmw ||
+           protocol == MpcProtocol::kBooleanConstant ||
+           protocol == MpcProtocol::kArithmeticConstant;
+  };
+  const auto& output_wires{gate.GetOutputWires()};
+  const auto input_wires{gate.GetInputWires()};
+  return !gate.IsOutput() && !output_wires.empty() &&
+         std::all_of(output_wires.begin(), output_wires.end(), is_gmw_or_constant) &&
+         std::all_of(input_wires.begin(), input_wires.end(), is_gmw_or_constant);
+}
+
+void Register::EliminateDeadGates() {
+  if (dead_gates_eliminated_) {
+    return;
+  }
+  std::unordered_set<std::int64_t> dead_gate_ids;
+  if (dead_gate_elimination_) {
+    if (const auto n{GetNumberOfPendingSubcircuits()}; n != 0) {
+      throw std::logic_error(
+          fmt::format("Cannot eliminate dead gates, {} subcircuits are not merged", n));
+    }
+    // consumers are registered after the gates producing their inputs, hence a single backward
+    // pass finds all gates on which a kept gate depends
+    std::unordered_set<const Wire*> needed_wires;
+    for (auto gate_iterator = gates_.rbegin(); gate_iterator != gates_.rend(); ++gate_iterator) {
+      const auto& gate{**gate_iterator};
+      const auto& output_wires{gate.GetOutputWires()};
+      const bool is_needed{!IsRemovable(gate) ||
+                           std::any_of(output_wires.begin(), output_wires.end(),
+                                       [&needed_wires](const WirePointer& wire) {
+                                         return needed_wires.contains(wire.get());
+                                       })};
+      if (is_needed) {
+        for (auto& wire : gate.GetInputWires()) {
+          needed_wires.insert(wire.get());
+        }
+      } else {
+        dead_gate_ids.insert(gate.GetId());
+      }
+    }
+    std::erase_if(gates_, [this, &dead_gate_ids](const GatePointer& gate) {
+      if (!dead_gate_ids.contains(gate->GetId())) {
+        return false;
+      }
+      gates_setup_ -= gate->NeedsSetup() ? 1 : 0;
+      gates_online_ -= gate->NeedsOnline() ? 1 : 0;
+      return true;
+    });
+    number_of_eliminated_gates_ += dead_gate_ids.size();
+    if (logger_ && !dead_gate_ids.empty()) {
+      logger_->LogDebug(fmt::format("Eliminated {} dead gates", dead_gate_ids.size()));
+    }
+  }
+  // the requests are run in construction order, which is the same in all parties
+  for (auto& [gate_id, request] : deferred_requests_) {
+    if (gate_id < 0 || !dead_gate_ids.contains(gate_id)) {
+      request();
+    }
+  }
+  deferred_requests_.clear();
+  dead_gates_eliminated_ = true;
+}
+
+void Register::AddToProcessingQueue(Gate& gate) {
+  assert(processing_queue_function_);
+  processing_queue_function_(gate);
+}
+
 void Register::CheckSetupCondition() {
   if (evaluated_gates_setup_ == gates_setup_) {
     {
@@ -115,22 +411,27 @@ void Register::CheckOnlineCondition() {
 }
 
 void Register::Reset() {
+  if (GetNumberOfPendingSubcircuits() != 0) {
+    throw std::logic_error("Register::Reset while subcircuits are not merged");
+  }
   if (evaluated_gates_setup_ != gates_setup_ || evaluated_gates_online_ != gates_online_) {
     throw(std::runtime_error("Register::Reset evaluated_gates_ != gates_.size()"));
   }
 
   assert(evaluated_gates_setup_ == gates_setup_);
   assert(evaluated_gates_online_ == gates_online_);
-  if (!gates_.empty()) {
-    gate_id_offset_ = global_gate_id_;
-  }
-
-  if (!wires_.empty()) {
-    wire_id_offset_ = global_wire_id_;
-  }
+  // the ids of the next circuit start at 0 again, the messages of the previous circuit are
+  // separated from its messages by the synchronization epochs of the MessageManager
+  global_gate_id_ = 0;
+  global_wire_id_ = 0;
+  ++epoch_;
 
   wires_.clear();
   gates_.clear();
+  if (!arena_->IsRecycling()) {
+    arena_ = std::make_shared<ObjectArena>();
+  }
+  dead_gates_eliminated_ = false;
 
   evaluated_gates_setup_ = 0;
   evaluated_gates_online_ = 0;
@@ -160,8 +461,40 @@ void Register::Clear() {
   gates_online_done_flag_ = false;
 }
 
+std::vector<GatePointer> Register::ClearDownstreamGates(
+    const std::vector<GatePointer>& changed_gates) {
+  if (evaluated_gates_setup_ != gates_setup_ || evaluated_gates_online_ != gates_online_) {
+    throw(std::runtime_error("Register::ClearDownstreamGates evaluated_gates_ != gates_.size()"));
+  }
+  auto downstream_gates{GetDownstreamGates(changed_gates)};
+  // check all gates before clearing any of them
+  for (auto& gate : downstream_gates) {
+    if (!gate->IsReEvaluable()) {
+      throw std::logic_error(fmt::format(
+          "Gate#{} depends on a changed gate, but needs fresh preprocessing to be re-evaluated",
+          gate->GetId()));
+    }
+  }
+  // the other gates keep their ready flags and are skipped by the GateExecutor
+  for (auto& gate : downstream_gates) {
+    gate->Clear();
+    for (auto& wire : gate->GetOutputWires()) {
+      wire->Clear();
+    }
+    evaluated_gates_setup_ -= gate->NeedsSetup() ? 1 : 0;
+    evaluated_gates_online_ -= gate->NeedsOnline() ? 1 : 0;
+  }
+  gates_setup_done_flag_ = false;
+  gates_online_done_flag_ = false;
+  return downstream_gates;
+}
+
 bool Register::AddCachedAlgorithmDescription(
     std::string path, const std::shared_ptr<AlgorithmDescription>& algorithm_description) {
+  // the schedule is computed outside of the lock and shared by all users of the description
+  if (algorithm_description && !algorithm_description->schedule) {
+    algorithm_description->ComputeSchedule();
+  }
   std::scoped_lock lock(cached_algos_mutex_);
   const auto [iterator, success] = cached_algos_.try_emplace(path, algorithm_description);
   return success;
@@ -178,4 +511,24 @@ std::shared_ptr<AlgorithmDescription> Register::GetCachedAlgorithmDescription(
   }
 }
 
+std::shared_ptr<AlgorithmDescription> Register::LoadAlgorithmDescription(const std::string& path,
+                                                                   CircuitFormat format) {
+  if (auto algorithm_description{GetCachedAlgorithmDescription(path)}) {
+    return algorithm_description;
+  }
+  std::shared_ptr<AlgorithmDescription> algorithm_description;
+  if (circuit_cache_) {
+    algorithm_description = circuit_cache_->Load(path, format);
+  } else {
+    algorithm_description = std::make_shared<AlgorithmDescription>(
+        format == CircuitFormat::kBristol ? AlgorithmDescription::FromBristol(path)
+                                          : AlgorithmDescription::FromBristolFashion(path));
+  }
+  if (!AddCachedAlgorithmDescription(path, algorithm_description)) {
+    // another thread loaded the same file in the meantime
+    return GetCachedAlgorithmDescription(path);
+  }
+  return algorithm_description;
+}
+
 }  // namespace encrypto::motion
@@ -25,15 +25,26 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <span>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "statistics/object_statistics.h"
+#include "utility/object_arena.h"
 
 namespace encrypto::motion {
 
 struct AlgorithmDescription;
 class Backend;
+class CircuitCache;
+enum class CircuitFormat : std::uint8_t;
 class FiberCondition;
 class Gate;
 using GatePointer = std::shared_ptr<Gate>;
@@ -43,28 +54,95 @@ using WirePointer = std::shared_ptr<Wire>;
 // >> forward declarations
 
 class Logger;
+class Register;
 
 // forward declarations <<
 
+/// \brief Independent part of a circuit that is constructed by another thread than the one
+/// constructing the rest of the circuit, see Register::ReserveSubcircuit.
+/// While a Subcircuit::Scope exists on a thread, the gates and wires created by the thread draw
+/// their ids from the ranges reserved for the subcircuit, are allocated in the arena of the
+/// subcircuit and are appended to its gate and wire lists instead of the ones of the Register.
+/// Hence, the subcircuits can be constructed concurrently without synchronization and yield the
+/// same ids in all parties, regardless of the scheduling of the threads. Subcircuits may contain
+/// the gates of the GMW protocols, whereas garbled circuit, BMR and ASTRA gates reserve per-backend
+/// state in their constructors and need to be created outside of subcircuits.
+class Subcircuit {
+ public:
+  /// \brief Makes the subcircuit the one constructed by the calling thread until destruction
+  class Scope {
+   public:
+    Scope(Subcircuit& subcircuit);
+
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    Subcircuit* previous_subcircuit_;
+  };
+
+  Subcircuit(const Subcircuit&) = delete;
+
+  std::size_t GetNumberOfGates() const { return gates_.size(); }
+
+  std::size_t GetNumberOfWires() const { return wires_.size(); }
+
+ private:
+  friend class Register;
+
+  Subcircuit(Register& register_reference, std::size_t index, std::size_t gate_position,
+             std::size_t wire_position, std::size_t first_gate_id, std::size_t number_of_gates,
+             std::size_t first_wire_id, std::size_t number_of_wires);
+
+  Register& register_;
+  // position in the order of reservation and the number of gates and wires of the register that
+  // precede the subcircuit
+  std::size_t index_, gate_position_, wire_position_;
+  std::size_t next_gate_id_, end_gate_id_, next_wire_id_, end_wire_id_;
+  std::size_t gates_setup_ = 0, gates_online_ = 0;
+
+  std::shared_ptr<ObjectArena> arena_{std::make_shared<ObjectArena>()};
+
+  std::vector<GatePointer> gates_;
+
+  std::vector<WirePointer> wires_;
+
+  // requests on state shared by all gates and the ids of the gates making them, which are run
+  // when the subcircuit is merged
+  std::vector<std::pair<std::int64_t, std::function<void()>>> deferred_requests_;
+};
+
 class Register {
  public:
   Register(std::shared_ptr<Logger> logger);
 
   ~Register();
 
+  /// gates and wires store their ids in 32 bits, with -1 for no id
+  static constexpr std::size_t kMaxNumberOfIds{std::numeric_limits<std::int32_t>::max()};
+
   std::shared_ptr<Logger> GetLogger() { return logger_; }
 
-  std::size_t NextGateId() noexcept;
+  /// \throws std::length_error if the calling thread constructs a subcircuit whose reserved gate
+  /// ids are exhausted or if the circuit exceeds kMaxNumberOfIds gates
+  std::size_t NextGateId();
 
-  std::size_t NextWireId() noexcept;
+  /// \throws std::length_error if the calling thread constructs a subcircuit whose reserved wire
+  /// ids are exhausted or if the circuit exceeds kMaxNumberOfIds wires
+  std::size_t NextWireId();
 
   std::size_t NextArithmeticSharingId(std::size_t number_of_parallel_values);
 
   std::size_t NextBooleanGmwSharingId(std::size_t number_of_parallel_values);
 
+  // gates and wires and their control blocks are allocated in the arena of the register or of the
+  // subcircuit constructed by the calling thread
   template <typename T, typename... Args>
   std::shared_ptr<T> EmplaceGate(Args&&... args) {
-    auto gate = std::make_shared<T>(std::forward<Args&&>(args)...);
+    auto gate = AllocateObject<T>(std::forward<Args&&>(args)...);
     RegisterGate(gate);
     return gate;
   }
@@ -73,25 +151,91 @@ class Register {
 
   template <typename T, typename... Args>
   std::shared_ptr<T> EmplaceWire(Args&&... args) {
-    auto wire = std::make_shared<T>(std::forward<Args&&>(args)...);
+    auto wire = AllocateObject<T>(std::forward<Args&&>(args)...);
     RegisterWire(wire);
     return wire;
   }
 
-  void RegisterWire(const WirePointer& wire) { wires_.push_back(wire); }
-
-  const GatePointer& GetGate(std::size_t gate_id) const {
-    return gates_.at(gate_id - gate_id_offset_);
+  void RegisterWire(const WirePointer& wire);
+
+  /// \brief Runs request, which draws from state that is shared by all gates and assigned in
+  /// construction order, e.g., the requests of gates to the MT, SP and OT providers. While the
+  /// calling thread constructs a subcircuit, request is deferred until the subcircuit is merged,
+  /// such that the requests are run in the same order in all parties. Hence, request must not be
+  /// relied on before the construction of the circuit has finished.
+  void RunInConstructionOrder(std::function<void()> request);
+
+  /// \brief Runs request of gate in construction order, see above. With dead gate elimination,
+  /// request is deferred until EliminateDeadGates and dropped if gate is eliminated.
+  void RunInConstructionOrder(const Gate& gate, std::function<void()> request);
+
+  /// \brief Enables the elimination of dead gates by EliminateDeadGates, which is called before
+  /// the preprocessing. Must be set in all parties before the construction of the circuit, since
+  /// the requests of gates to the providers are deferred until the elimination. Only the gates on
+  /// which an output depends are evaluated, hence the shares of the other gates must not be read.
+  /// Disabled by default.
+  void SetDeadGateElimination(bool value) noexcept { dead_gate_elimination_ = value; }
+
+  bool GetDeadGateElimination() const noexcept { return dead_gate_elimination_; }
+
+  /// \brief Removes the gates on which no output gate depends if dead gate elimination is
+  /// enabled and runs the deferred requests of the remaining gates, such that the providers count
+  /// only the MTs, SPs, SBs and OTs of these. Only the gates of the GMW protocols and constants are
+  /// removed, since the other protocols reserve per-backend state in the constructors of their
+  /// gates. Does nothing if no gates were added since the last call.
+  /// \throws std::logic_error if dead gate elimination is enabled and there are subcircuits that
+  /// have not been merged yet
+  void EliminateDeadGates();
+
+  /// \brief Returns the number of gates removed by EliminateDeadGates, which is kept across Reset()
+  std::size_t GetNumberOfEliminatedGates() const { return number_of_eliminated_gates_; }
+
+  /// \brief Reserves number_of_gates gate ids and number_of_wires wire ids for an independent
+  /// subcircuit, which is constructed by another thread in a Subcircuit::Scope and merged back by
+  /// MergeSubcircuit before the evaluation. Must be called by the thread constructing the circuit
+  /// in the same order in all parties. The subcircuit may only use shares that were created before
+  /// its reservation, and its gates are evaluated as if they were created at this point.
+  std::unique_ptr<Subcircuit> ReserveSubcircuit(std::size_t number_of_gates,
+                                                std::size_t number_of_wires);
+
+  /// \brief Merges the gates and wires of a subcircuit into the register after its construction
+  /// has finished and runs its deferred requests, see RunInConstructionOrder. Subcircuits must be
+  /// merged in the order of their reservation by the thread constructing the circuit.
+  /// \throws std::logic_error if an earlier subcircuit has not been merged yet, in which case the
+  /// subcircuit is not consumed
+  void MergeSubcircuit(std::unique_ptr<Subcircuit>&& subcircuit);
+
+  /// \brief Returns the number of reserved subcircuits that have not been merged yet. The circuit
+  /// cannot be evaluated before they are merged.
+  std::size_t GetNumberOfPendingSubcircuits() const {
+    return number_of_reserved_subcircuits_ - number_of_merged_subcircuits_;
   }
 
+  const GatePointer& GetGate(std::size_t gate_id) const;
+
   auto& GetGates() const { return gates_; }
 
-  WirePointer GetWire(std::size_t wire_id) const { return wires_.at(wire_id - wire_id_offset_); }
+  /// \brief Returns the given gates and all gates that transitively consume their output wires in
+  ///        registration order, i.e., the gates that need to be re-evaluated if the outputs of the
+  ///        given gates change. Gates that are only connected via wires they do not report in
+  ///        Gate::GetInputWires(), e.g., the internal output gates of a GMW AND gate, are not
+  ///        included.
+  std::vector<GatePointer> GetDownstreamGates(const std::vector<GatePointer>& changed_gates) const;
+
+  WirePointer GetWire(std::size_t wire_id) const;
 
   void IncrementEvaluatedGatesSetupCounter();
 
   void IncrementEvaluatedGatesOnlineCounter();
 
+  /// \brief Sets the function that is called for gates whose dependencies are resolved, e.g., to
+  ///        post them to the GateExecutor's fiber pool. An empty function disables the queue.
+  void SetProcessingQueueFunction(std::function<void(Gate&)> processing_queue_function) {
+    processing_queue_function_ = std::move(processing_queue_function);
+  }
+
+  void AddToProcessingQueue(Gate& gate);
+
   void CheckSetupCondition();
 
   void CheckOnlineCondition();
@@ -104,14 +248,47 @@ class Register {
 
   std::size_t GetNumberOfEvaluatedGatesOnline() const { return evaluated_gates_online_; }
 
-  std::size_t GetTotalNumberOfGates() const { return global_gate_id_ - gate_id_offset_; }
-  
-  std::size_t GetGateIdOffset() const { return gate_id_offset_; }
+  std::size_t GetTotalNumberOfGates() const { return global_gate_id_; }
 
+  /// \brief Returns the number of calls of Reset(). The gate and wire ids are dense within an
+  /// epoch, i.e., they start at 0 for each circuit and index gates_ and wires_ directly.
+  std::size_t GetEpoch() const { return epoch_; }
+
+  /// \brief Removes the evaluated gates and wires and starts a new arena for the next circuit.
+  /// The memory of the previous arena is released as soon as the last share referencing its
+  /// wires is destroyed. A recycling arena is kept instead (see SetObjectRecycling).
   void Reset();
 
   void Clear();
 
+  /// \brief Clears only the gates of GetDownstreamGates(changed_gates) and their output wires
+  ///        after an evaluation, such that the next evaluation re-evaluates these gates and keeps
+  ///        the values of all other gates. \returns the cleared gates.
+  /// \throws std::logic_error if a cleared gate is not re-evaluable, see Gate::IsReEvaluable
+  std::vector<GatePointer> ClearDownstreamGates(const std::vector<GatePointer>& changed_gates);
+
+  /// \brief Enables the accounting of the number and the memory of the gates and wires per class
+  /// constructed by EmplaceGate and EmplaceWire, e.g., to compare memory layouts. Disabled by
+  /// default, in which case it costs a single check per object.
+  void SetObjectAccounting(bool value) noexcept { object_accounting_.SetEnabled(value); }
+
+  /// \brief Replaces the arena by one which recycles the memory of destroyed gates and wires for
+  /// the objects of the same class and is kept across Reset(), such that constructing a circuit of
+  /// the same structure again, e.g., per query of a service, does not allocate the objects anew
+  /// once the shares of the previous circuit are destroyed. Applies to the gates and wires that
+  /// are constructed afterwards.
+  void SetObjectRecycling(bool value) {
+    arena_ = std::make_shared<ObjectArena>(ObjectArena::kDefaultInitialSize, value);
+  }
+
+  /// \brief Returns the bytes of the gates and wires, including their control blocks, which the
+  /// recycling arena reused from destroyed objects
+  std::size_t GetNumberOfRecycledObjectBytes() const { return arena_->GetNumberOfRecycledBytes(); }
+
+  /// \brief Returns the statistics of the objects constructed while the accounting was enabled,
+  /// which are kept across Reset().
+  ObjectStatisticsMap GetObjectStatistics() const { return object_accounting_.GetStatistics(); }
+
   std::shared_ptr<FiberCondition> GetGatesSetupDoneCondition() {
     return gates_setup_done_condition_;
   };
@@ -121,7 +298,9 @@ class Register {
   };
 
   /// \brief Tries to insert an AlgorithmDescription object read from a file into cached_algos_
-  /// \param path absolute path to the corresponding file
+  /// and computes its CircuitSchedule if it has none, such that users of the cached description
+  /// do not repeat the analysis
+  /// \param path absolute path to the corresponding file or the name of a generated circuit
   /// \param algorithm_description AlgorithmDescription object corresponding to the parsed file
   /// \returns true if the insertion was successful and false if the object is already in the cache
   bool AddCachedAlgorithmDescription(
@@ -131,13 +310,49 @@ class Register {
   /// \return shared_ptr to the algorithm description or to nullptr if not in the hash table
   std::shared_ptr<AlgorithmDescription> GetCachedAlgorithmDescription(const std::string& path);
 
+  /// \brief Sets the persistent circuit cache used by LoadAlgorithmDescription, which may be
+  /// shared by several registers, or disables it if circuit_cache is nullptr
+  void SetCircuitCache(std::shared_ptr<CircuitCache> circuit_cache) {
+    circuit_cache_ = std::move(circuit_cache);
+  }
+
+  /// \brief Gets the AlgorithmDescription of the circuit file at path from cached_algos_ or loads
+  /// it through the circuit cache, which parses it only if the same contents were not cached
+  /// before, or parses it if there is no circuit cache, and adds it to cached_algos_
+  /// \throws std::runtime_error if the circuit cache cannot read the circuit file
+  std::shared_ptr<AlgorithmDescription> LoadAlgorithmDescription(const std::string& path,
+                                                                 CircuitFormat format);
+
  private:
+  // returns the subcircuit constructed by the calling thread for this register or nullptr
+  Subcircuit* GetSubcircuit();
+
+  const std::shared_ptr<ObjectArena>& GetArena();
+
+  template <typename T, typename... Args>
+  std::shared_ptr<T> AllocateObject(Args&&... args) {
+    const auto& arena{GetArena()};
+    if (!object_accounting_.IsEnabled()) [[likely]] {
+      return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args&&>(args)...);
+    }
+    ObjectAccounting::Scope scope(object_accounting_, *arena);
+    auto object{std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args&&>(args)...)};
+    scope.Finish(typeid(T));
+    return object;
+  }
+
+  // inserts the gates and wires of the merged subcircuits at their positions in a single pass
+  void InsertMergedSubcircuits();
+
+  // runs the request of the gate with gate_id, or of no gate if gate_id is negative, or defers it
+  void RunOrDeferRequest(std::int64_t gate_id, std::function<void()> request);
+
   std::shared_ptr<Logger> logger_;
 
   // don't need atomic here, since only the master thread has access to these
   std::size_t global_gate_id_ = 0, global_wire_id_ = 0;
   std::size_t global_arithmetic_gmw_sharing_id_ = 0, global_boolean_gmw_sharing_id_ = 0;
-  std::size_t gate_id_offset_ = 0, wire_id_offset_ = 0;
+  std::size_t epoch_ = 0;
 
   std::atomic<std::size_t> gates_setup_ = 0;
   std::atomic<std::size_t> gates_online_ = 0;
@@ -152,12 +367,32 @@ class Register {
   std::shared_ptr<FiberCondition> gates_setup_done_condition_;
   std::shared_ptr<FiberCondition> gates_online_done_condition_;
 
+  // the gates and wires are destroyed before the arena
+  std::shared_ptr<ObjectArena> arena_{std::make_shared<ObjectArena>()};
+
   std::vector<GatePointer> gates_;
 
   std::vector<WirePointer> wires_;
 
+  ObjectAccounting object_accounting_;
+
+  std::function<void(Gate&)> processing_queue_function_;
+
+  std::size_t number_of_reserved_subcircuits_ = 0, number_of_merged_subcircuits_ = 0;
+  // merged subcircuits that are inserted into gates_ and wires_ once all are merged
+  std::vector<std::unique_ptr<Subcircuit>> merged_subcircuits_;
+
+  bool dead_gate_elimination_ = false;
+  // true if no gates were added since the last EliminateDeadGates
+  bool dead_gates_eliminated_ = false;
+  std::size_t number_of_eliminated_gates_ = 0;
+  // requests deferred until EliminateDeadGates and the ids of the gates making them
+  std::vector<std::pair<std::int64_t, std::function<void()>>> deferred_requests_;
+
   std::unordered_map<std::string, std::shared_ptr<AlgorithmDescription>> cached_algos_;
   std::mutex cached_algos_mutex_;
+
+  std::shared_ptr<CircuitCache> circuit_cache_;
 };
 
 using RegisterPointer = std::shared_ptr<Register>;
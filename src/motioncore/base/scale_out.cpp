@@ -0,0 +1,244 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "scale_out.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "communication/transport.h"
+
+namespace encrypto::motion {
+
+SimdSlice GetSimdSlice(std::size_t number_of_simd, std::size_t number_of_workers,
+                       std::size_t worker_index) {
+  if (worker_index >= number_of_workers) {
+    throw std::invalid_argument(fmt::format("worker index {} out of range for {} workers",
+                                            worker_index, number_of_workers));
+  }
+  // the first number_of_simd % number_of_workers slices hold one more value
+  const std::size_t base_size{number_of_simd / number_of_workers};
+  const std::size_t remainder{number_of_simd % number_of_workers};
+  return {worker_index * base_size + std::min(worker_index, remainder),
+          base_size + (worker_index < remainder ? 1 : 0)};
+}
+
+namespace {
+
+// messages are a header of 64 bit integers followed by the payload
+void AppendHeader(std::vector<std::uint8_t>& message, std::uint64_t value) {
+  const auto position{message.size()};
+  message.resize(position + sizeof(value));
+  std::memcpy(message.data() + position, &value, sizeof(value));
+}
+
+std::uint64_t ReadHeader(std::span<const std::uint8_t>& message) {
+  std::uint64_t value;
+  if (message.size() < sizeof(value)) {
+    throw std::runtime_error("truncated scale-out message");
+  }
+  std::memcpy(&value, message.data(), sizeof(value));
+  message = message.subspan(sizeof(value));
+  return value;
+}
+
+std::vector<std::uint8_t> Receive(communication::Transport& transport) {
+  auto message{transport.ReceiveMessage()};
+  if (!message.has_value()) {
+    throw std::runtime_error("scale-out transport was closed");
+  }
+  return std::move(*message);
+}
+
+// number of wires and of SIMD values, then the bytes of every wire
+std::vector<std::uint8_t> SerializeWires(std::span<const BitVector<>> wires, SimdSlice slice) {
+  std::vector<std::uint8_t> message;
+  AppendHeader(message, wires.size());
+  AppendHeader(message, slice.size);
+  const std::size_t number_of_bytes{(slice.size + 7) / 8};
+  message.reserve(message.size() + wires.size() * number_of_bytes);
+  for (const auto& wire : wires) {
+    const auto bits{wire.Subset(slice.offset, slice.offset + slice.size)};
+    const auto* data{reinterpret_cast<const std::uint8_t*>(bits.GetData().data())};
+    message.insert(message.end(), data, data + number_of_bytes);
+  }
+  return message;
+}
+
+std::vector<BitVector<>> DeserializeWires(std::span<const std::uint8_t> message) {
+  const auto number_of_wires{ReadHeader(message)};
+  const auto number_of_simd{ReadHeader(message)};
+  const std::size_t number_of_bytes{(number_of_simd + 7) / 8};
+  if (message.size() != number_of_wires * number_of_bytes) {
+    throw std::runtime_error(fmt::format("scale-out message of {} wires with {} bits has {} B",
+                                         number_of_wires, number_of_simd, message.size()));
+  }
+  std::vector<BitVector<>> wires;
+  wires.reserve(number_of_wires);
+  for (std::size_t wire_i = 0; wire_i < number_of_wires; ++wire_i) {
+    const auto* data{reinterpret_cast<const std::byte*>(message.data())};
+    wires.emplace_back(data + wire_i * number_of_bytes, number_of_simd);
+  }
+  return wires;
+}
+
+template <typename T>
+std::vector<std::uint8_t> SerializeValues(std::span<const T> values) {
+  std::vector<std::uint8_t> message;
+  AppendHeader(message, values.size());
+  const auto position{message.size()};
+  message.resize(position + values.size_bytes());
+  std::memcpy(message.data() + position, values.data(), values.size_bytes());
+  return message;
+}
+
+template <typename T>
+std::vector<T> DeserializeValues(std::span<const std::uint8_t> message) {
+  const auto number_of_values{ReadHeader(message)};
+  if (message.size() != number_of_values * sizeof(T)) {
+    throw std::runtime_error(fmt::format("scale-out message of {} values of {} B has {} B",
+                                         number_of_values, sizeof(T), message.size()));
+  }
+  std::vector<T> values(number_of_values);
+  std::memcpy(values.data(), message.data(), message.size());
+  return values;
+}
+
+}  // namespace
+
+ScaleOutCoordinator::ScaleOutCoordinator(
+    std::vector<std::unique_ptr<communication::Transport>> worker_transports)
+    : worker_transports_(std::move(worker_transports)) {
+  if (worker_transports_.empty()) {
+    throw std::invalid_argument("scale-out coordinator without workers");
+  }
+}
+
+ScaleOutCoordinator::~ScaleOutCoordinator() = default;
+
+void ScaleOutCoordinator::ScatterBooleanInputs(std::span<const BitVector<>> wires) {
+  const std::size_t number_of_simd{wires.empty() ? 0 : wires[0].GetSize()};
+  for (const auto& wire : wires) {
+    if (wire.GetSize() != number_of_simd) {
+      throw std::invalid_argument(fmt::format(
+          "scattered wires have {} and {} SIMD values", number_of_simd, wire.GetSize()));
+    }
+  }
+  for (std::size_t worker_i = 0; worker_i < GetNumberOfWorkers(); ++worker_i) {
+    worker_transports_[worker_i]->SendMessage(SerializeWires(
+        wires, GetSimdSlice(number_of_simd, GetNumberOfWorkers(), worker_i)));
+  }
+}
+
+template <typename T>
+void ScaleOutCoordinator::ScatterArithmeticInputs(std::span<const T> values) {
+  for (std::size_t worker_i = 0; worker_i < GetNumberOfWorkers(); ++worker_i) {
+    const auto slice{GetSimdSlice(values.size(), GetNumberOfWorkers(), worker_i)};
+    worker_transports_[worker_i]->SendMessage(
+        SerializeValues(values.subspan(slice.offset, slice.size)));
+  }
+}
+
+std::vector<BitVector<>> ScaleOutCoordinator::GatherBooleanOutputs() {
+  std::vector<BitVector<>> wires;
+  for (std::size_t worker_i = 0; worker_i < GetNumberOfWorkers(); ++worker_i) {
+    auto slice{DeserializeWires(Receive(*worker_transports_[worker_i]))};
+    if (worker_i == 0) {
+      wires = std::move(slice);
+      continue;
+    }
+    if (slice.size() != wires.size()) {
+      throw std::runtime_error(fmt::format("scale-out worker {} sent {} instead of {} wires",
+                                           worker_i, slice.size(), wires.size()));
+    }
+    for (std::size_t wire_i = 0; wire_i < wires.size(); ++wire_i) {
+      wires[wire_i].Append(slice[wire_i]);
+    }
+  }
+  return wires;
+}
+
+template <typename T>
+std::vector<T> ScaleOutCoordinator::GatherArithmeticOutputs() {
+  std::vector<T> values;
+  for (auto& worker_transport : worker_transports_) {
+    const auto slice{DeserializeValues<T>(Receive(*worker_transport))};
+    values.insert(values.end(), slice.begin(), slice.end());
+  }
+  return values;
+}
+
+void ScaleOutCoordinator::Finish() {
+  for (auto& worker_transport : worker_transports_) {
+    worker_transport->Shutdown();
+  }
+}
+
+ScaleOutWorker::ScaleOutWorker(std::unique_ptr<communication::Transport> coordinator_transport,
+                               std::size_t worker_index, std::size_t number_of_workers)
+    : coordinator_transport_(std::move(coordinator_transport)),
+      worker_index_(worker_index),
+      number_of_workers_(number_of_workers) {
+  if (worker_index_ >= number_of_workers_) {
+    throw std::invalid_argument(fmt::format("worker index {} out of range for {} workers",
+                                            worker_index_, number_of_workers_));
+  }
+}
+
+ScaleOutWorker::~ScaleOutWorker() = default;
+
+std::vector<BitVector<>> ScaleOutWorker::ReceiveBooleanInputs() {
+  return DeserializeWires(Receive(*coordinator_transport_));
+}
+
+template <typename T>
+std::vector<T> ScaleOutWorker::ReceiveArithmeticInputs() {
+  return DeserializeValues<T>(Receive(*coordinator_transport_));
+}
+
+void ScaleOutWorker::SendBooleanOutputs(std::span<const BitVector<>> wires) {
+  const std::size_t number_of_simd{wires.empty() ? 0 : wires[0].GetSize()};
+  coordinator_transport_->SendMessage(SerializeWires(wires, {0, number_of_simd}));
+}
+
+template <typename T>
+void ScaleOutWorker::SendArithmeticOutputs(std::span<const T> values) {
+  coordinator_transport_->SendMessage(SerializeValues(values));
+}
+
+#define MOTION_SCALE_OUT_INSTANTIATE(T)                                                  \
+  template void ScaleOutCoordinator::ScatterArithmeticInputs<T>(std::span<const T>);    \
+  template std::vector<T> ScaleOutCoordinator::GatherArithmeticOutputs<T>();            \
+  template std::vector<T> ScaleOutWorker::ReceiveArithmeticInputs<T>();                 \
+  template void ScaleOutWorker::SendArithmeticOutputs<T>(std::span<const T>);
+
+MOTION_SCALE_OUT_INSTANTIATE(std::uint8_t)
+MOTION_SCALE_OUT_INSTANTIATE(std::uint16_t)
+MOTION_SCALE_OUT_INSTANTIATE(std::uint32_t)
+MOTION_SCALE_OUT_INSTANTIATE(std::uint64_t)
+
+#undef MOTION_SCALE_OUT_INSTANTIATE
+
+}  // namespace encrypto::motion
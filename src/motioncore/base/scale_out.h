@@ -0,0 +1,124 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::communication {
+
+class Transport;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion {
+
+// Scale-out of one logical party: The party runs as a coordinator plus number_of_workers workers,
+// e.g., on different machines.  Worker k of every party is a separate motion::Party that forms a
+// session with worker k of the other parties, i.e., it has its own transports, providers and
+// correlated randomness, and evaluates SIMD slice k of a data-parallel circuit.  The coordinator
+// scatters the input slices of its party to the workers and gathers their output slices via
+// transports to the workers, which TcpSetupHelper can establish with the coordinator as party 0
+// and worker k as party k + 1.
+
+// Range [offset, offset + size) of SIMD values
+struct SimdSlice {
+  std::size_t offset;
+  std::size_t size;
+};
+
+// Splits number_of_simd values into number_of_workers slices whose sizes differ by at most one.
+// Throws a std::invalid_argument if worker_index >= number_of_workers.
+SimdSlice GetSimdSlice(std::size_t number_of_simd, std::size_t number_of_workers,
+                       std::size_t worker_index);
+
+class ScaleOutCoordinator {
+ public:
+  // worker_transports[k] is connected to worker k
+  explicit ScaleOutCoordinator(
+      std::vector<std::unique_ptr<communication::Transport>> worker_transports);
+
+  ~ScaleOutCoordinator();
+
+  std::size_t GetNumberOfWorkers() const { return worker_transports_.size(); }
+
+  // Sends the slices of all wires, which have the same number of SIMD values, to the workers.
+  // Throws a std::invalid_argument for wires of different sizes.
+  void ScatterBooleanInputs(std::span<const BitVector<>> wires);
+
+  template <typename T>
+  void ScatterArithmeticInputs(std::span<const T> values);
+
+  // Receives the output slices of the workers and concatenates them wire by wire.
+  // Throws a std::runtime_error if the workers send different numbers of wires.
+  std::vector<BitVector<>> GatherBooleanOutputs();
+
+  template <typename T>
+  std::vector<T> GatherArithmeticOutputs();
+
+  // shuts down the transports to the workers
+  void Finish();
+
+ private:
+  std::vector<std::unique_ptr<communication::Transport>> worker_transports_;
+};
+
+class ScaleOutWorker {
+ public:
+  ScaleOutWorker(std::unique_ptr<communication::Transport> coordinator_transport,
+                 std::size_t worker_index, std::size_t number_of_workers);
+
+  ~ScaleOutWorker();
+
+  std::size_t GetWorkerIndex() const { return worker_index_; }
+
+  std::size_t GetNumberOfWorkers() const { return number_of_workers_; }
+
+  // slice of the SIMD values of number_of_simd values that this worker evaluates
+  SimdSlice GetSimdSlice(std::size_t number_of_simd) const {
+    return motion::GetSimdSlice(number_of_simd, number_of_workers_, worker_index_);
+  }
+
+  // receives this worker's slice of the wires scattered by ScaleOutCoordinator
+  std::vector<BitVector<>> ReceiveBooleanInputs();
+
+  template <typename T>
+  std::vector<T> ReceiveArithmeticInputs();
+
+  void SendBooleanOutputs(std::span<const BitVector<>> wires);
+
+  template <typename T>
+  void SendArithmeticOutputs(std::span<const T> values);
+
+ private:
+  std::unique_ptr<communication::Transport> coordinator_transport_;
+  std::size_t worker_index_;
+  std::size_t number_of_workers_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,430 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "third_party_dealer.h"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "communication/transport.h"
+#include "primitives/sharing_randomness_generator.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// index of the 8, 16, 32, 64, and 128 bit types in the arrays of ThirdPartyRequest
+template <typename T>
+constexpr std::size_t kTypeIndex{static_cast<std::size_t>(std::countr_zero(sizeof(T)))};
+
+constexpr std::size_t kOtMessageSize{16};
+
+void AppendBytes(std::vector<std::uint8_t>& message, const void* data, std::size_t size) {
+  const auto pointer{reinterpret_cast<const std::uint8_t*>(data)};
+  message.insert(message.end(), pointer, pointer + size);
+}
+
+// reads the corrections and OT messages from the response of the dealer
+class ResponseReader {
+ public:
+  ResponseReader(std::span<const std::uint8_t> response) : response_(response) {}
+
+  const std::uint8_t* Read(std::size_t size) {
+    if (offset_ + size > response_.size()) {
+      throw std::runtime_error("Received a truncated response from the third party dealer");
+    }
+    const auto pointer{response_.data() + offset_};
+    offset_ += size;
+    return pointer;
+  }
+
+  bool IsFinished() const { return offset_ == response_.size(); }
+
+ private:
+  std::span<const std::uint8_t> response_;
+  std::size_t offset_{0};
+};
+
+// expands the next bytes of the randomness which a party shares with the dealer
+std::vector<std::byte> ExpandSeed(primitives::SharingRandomnessGenerator& generator,
+                                  std::size_t& counter, std::size_t number_of_bytes) {
+  const std::size_t number_of_blocks{(number_of_bytes + sizeof(__uint128_t) - 1) /
+                                     sizeof(__uint128_t)};
+  const auto blocks{generator.GetUnsigned<__uint128_t>(counter, number_of_blocks)};
+  counter += number_of_blocks;
+  std::vector<std::byte> output(number_of_bytes);
+  if (number_of_bytes > 0) std::memcpy(output.data(), blocks.data(), number_of_bytes);
+  return output;
+}
+
+template <typename T>
+std::vector<T> ExpandValues(primitives::SharingRandomnessGenerator& generator,
+                            std::size_t& counter, std::size_t number_of_values) {
+  const auto bytes{ExpandSeed(generator, counter, number_of_values * sizeof(T))};
+  std::vector<T> output(number_of_values);
+  if (number_of_values > 0) std::memcpy(output.data(), bytes.data(), bytes.size());
+  return output;
+}
+
+BitVector<> ExpandBits(primitives::SharingRandomnessGenerator& generator, std::size_t& counter,
+                       std::size_t number_of_bits) {
+  return BitVector<>(ExpandSeed(generator, counter, BitsToBytes(number_of_bits)), number_of_bits);
+}
+
+template <typename T>
+void ExpandIntegerMts(ThirdPartyMaterial& material,
+                      primitives::SharingRandomnessGenerator& generator, std::size_t& counter,
+                      const ThirdPartyRequest& request) {
+  const std::size_t number_of_mts{request.number_of_integer_mts[kTypeIndex<T>]};
+  auto& mts{material.GetIntegerMts<T>()};
+  mts.a = ExpandValues<T>(generator, counter, number_of_mts);
+  mts.b = ExpandValues<T>(generator, counter, number_of_mts);
+  mts.c = ExpandValues<T>(generator, counter, number_of_mts);
+}
+
+template <typename T>
+void ExpandSps(ThirdPartyMaterial& material, primitives::SharingRandomnessGenerator& generator,
+               std::size_t& counter, const ThirdPartyRequest& request) {
+  const std::size_t number_of_sps{request.number_of_sps[kTypeIndex<T>]};
+  auto& sps{material.GetSps<T>()};
+  sps.a = ExpandValues<T>(generator, counter, number_of_sps);
+  sps.c = ExpandValues<T>(generator, counter, number_of_sps);
+}
+
+// expands the shares of a party, which are identical for the party and the dealer
+ThirdPartyMaterial ExpandMaterial(primitives::SharingRandomnessGenerator& generator,
+                                  std::size_t& counter, const ThirdPartyRequest& request) {
+  ThirdPartyMaterial material;
+  const std::size_t number_of_binary_mts{request.number_of_binary_mts};
+  material.binary_mts.a = ExpandBits(generator, counter, number_of_binary_mts);
+  material.binary_mts.b = ExpandBits(generator, counter, number_of_binary_mts);
+  material.binary_mts.c = ExpandBits(generator, counter, number_of_binary_mts);
+  ExpandIntegerMts<std::uint8_t>(material, generator, counter, request);
+  ExpandIntegerMts<std::uint16_t>(material, generator, counter, request);
+  ExpandIntegerMts<std::uint32_t>(material, generator, counter, request);
+  ExpandIntegerMts<std::uint64_t>(material, generator, counter, request);
+  ExpandSps<std::uint8_t>(material, generator, counter, request);
+  ExpandSps<std::uint16_t>(material, generator, counter, request);
+  ExpandSps<std::uint32_t>(material, generator, counter, request);
+  ExpandSps<std::uint64_t>(material, generator, counter, request);
+  ExpandSps<__uint128_t>(material, generator, counter, request);
+
+  const std::size_t number_of_parties{request.number_of_sender_ots.size()};
+  material.ot_sender_messages.resize(number_of_parties);
+  material.ot_receiver_choices.resize(number_of_parties);
+  material.ot_receiver_messages.resize(number_of_parties);
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    material.ot_sender_messages[party_id] = ExpandSeed(
+        generator, counter, 2 * kOtMessageSize * request.number_of_sender_ots[party_id]);
+    material.ot_receiver_choices[party_id] =
+        ExpandBits(generator, counter, request.number_of_receiver_ots[party_id]);
+  }
+  return material;
+}
+
+// the corrections c - sum_i c_i of the shares of the products
+template <typename T>
+void AppendIntegerMtCorrections(std::vector<std::uint8_t>& message,
+                                const std::vector<ThirdPartyMaterial>& materials) {
+  const std::size_t number_of_mts{materials[0].GetIntegerMts<T>().a.size()};
+  std::vector<T> corrections(number_of_mts);
+  for (std::size_t i = 0; i < number_of_mts; ++i) {
+    T a{0}, b{0}, c{0};
+    for (auto& material : materials) {
+      const auto& mts{material.GetIntegerMts<T>()};
+      a += mts.a[i];
+      b += mts.b[i];
+      c += mts.c[i];
+    }
+    corrections[i] = static_cast<T>(a * b - c);
+  }
+  AppendBytes(message, corrections.data(), corrections.size() * sizeof(T));
+}
+
+template <typename T>
+void AppendSpCorrections(std::vector<std::uint8_t>& message,
+                         const std::vector<ThirdPartyMaterial>& materials) {
+  const std::size_t number_of_sps{materials[0].GetSps<T>().a.size()};
+  std::vector<T> corrections(number_of_sps);
+  for (std::size_t i = 0; i < number_of_sps; ++i) {
+    T a{0}, c{0};
+    for (auto& material : materials) {
+      const auto& sps{material.GetSps<T>()};
+      a += sps.a[i];
+      c += sps.c[i];
+    }
+    corrections[i] = static_cast<T>(a * a - c);
+  }
+  AppendBytes(message, corrections.data(), corrections.size() * sizeof(T));
+}
+
+template <typename T>
+void ApplyIntegerMtCorrections(ThirdPartyMaterial& material, ResponseReader& reader) {
+  auto& mts{material.GetIntegerMts<T>()};
+  const auto corrections{reader.Read(mts.c.size() * sizeof(T))};
+  for (std::size_t i = 0; i < mts.c.size(); ++i) {
+    T correction;
+    std::memcpy(&correction, corrections + i * sizeof(T), sizeof(T));
+    mts.c[i] += correction;
+  }
+}
+
+template <typename T>
+void ApplySpCorrections(ThirdPartyMaterial& material, ResponseReader& reader) {
+  auto& sps{material.GetSps<T>()};
+  const auto corrections{reader.Read(sps.c.size() * sizeof(T))};
+  for (std::size_t i = 0; i < sps.c.size(); ++i) {
+    T correction;
+    std::memcpy(&correction, corrections + i * sizeof(T), sizeof(T));
+    sps.c[i] += correction;
+  }
+}
+
+}  // namespace
+
+ThirdPartyRequest::ThirdPartyRequest(std::size_t number_of_parties)
+    : number_of_sender_ots(number_of_parties, 0), number_of_receiver_ots(number_of_parties, 0) {}
+
+std::vector<std::uint8_t> ThirdPartyRequest::Serialize() const {
+  std::vector<std::uint64_t> values{number_of_binary_mts};
+  values.insert(values.end(), number_of_integer_mts.begin(), number_of_integer_mts.end());
+  values.insert(values.end(), number_of_sps.begin(), number_of_sps.end());
+  values.insert(values.end(), number_of_sender_ots.begin(), number_of_sender_ots.end());
+  values.insert(values.end(), number_of_receiver_ots.begin(), number_of_receiver_ots.end());
+  std::vector<std::uint8_t> message;
+  AppendBytes(message, values.data(), values.size() * sizeof(std::uint64_t));
+  return message;
+}
+
+ThirdPartyRequest ThirdPartyRequest::Deserialize(std::span<const std::uint8_t> message,
+                                                 std::size_t number_of_parties) {
+  ThirdPartyRequest request(number_of_parties);
+  const std::size_t number_of_values{1 + request.number_of_integer_mts.size() +
+                                     request.number_of_sps.size() + 2 * number_of_parties};
+  if (message.size() != number_of_values * sizeof(std::uint64_t)) {
+    throw std::runtime_error(
+        fmt::format("Received a request of {} B for the third party dealer, expected {} B",
+                    message.size(), number_of_values * sizeof(std::uint64_t)));
+  }
+  std::vector<std::uint64_t> values(number_of_values);
+  std::memcpy(values.data(), message.data(), message.size());
+  auto value{values.begin()};
+  request.number_of_binary_mts = *value++;
+  for (auto& number : request.number_of_integer_mts) number = *value++;
+  for (auto& number : request.number_of_sps) number = *value++;
+  for (auto& number : request.number_of_sender_ots) number = *value++;
+  for (auto& number : request.number_of_receiver_ots) number = *value++;
+  return request;
+}
+
+ThirdPartyDealer::ThirdPartyDealer(
+    std::vector<std::unique_ptr<communication::Transport>>&& transports)
+    : transports_(std::move(transports)), counters_(transports_.size(), 0) {
+  if (transports_.size() < 2) {
+    throw std::invalid_argument("The third party dealer needs to serve at least 2 parties");
+  }
+  for (std::size_t party_id = 0; party_id < transports_.size(); ++party_id) {
+    generators_.emplace_back(std::make_unique<primitives::SharingRandomnessGenerator>(party_id));
+  }
+}
+
+ThirdPartyDealer::~ThirdPartyDealer() = default;
+
+void ThirdPartyDealer::Run() {
+  for (std::size_t party_id = 0; party_id < transports_.size(); ++party_id) {
+    auto seed{RandomVector<std::uint8_t>(
+        primitives::SharingRandomnessGenerator::kMasterSeedByteLength)};
+    generators_[party_id]->Initialize(seed.data());
+    transports_[party_id]->SendMessage(seed);
+  }
+  while (HandleRequests()) {
+  }
+  for (auto& transport : transports_) {
+    transport->ShutdownSend();
+  }
+}
+
+bool ThirdPartyDealer::HandleRequests() {
+  const std::size_t number_of_parties{transports_.size()};
+  std::vector<ThirdPartyRequest> requests;
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    const auto message{transports_[party_id]->ReceiveMessage()};
+    if (!message) return false;
+    requests.emplace_back(ThirdPartyRequest::Deserialize(*message, number_of_parties));
+  }
+
+  for (std::size_t party_id = 1; party_id < number_of_parties; ++party_id) {
+    if (requests[party_id].number_of_binary_mts != requests[0].number_of_binary_mts ||
+        requests[party_id].number_of_integer_mts != requests[0].number_of_integer_mts ||
+        requests[party_id].number_of_sps != requests[0].number_of_sps) {
+      throw std::runtime_error(fmt::format(
+          "Party#{} requested different numbers of MTs or SPs than Party#0", party_id));
+    }
+  }
+  for (std::size_t sender = 0; sender < number_of_parties; ++sender) {
+    for (std::size_t receiver = 0; receiver < number_of_parties; ++receiver) {
+      if (requests[sender].number_of_sender_ots[receiver] !=
+          requests[receiver].number_of_receiver_ots[sender]) {
+        throw std::runtime_error(fmt::format(
+            "Party#{} requested {} OTs as sender, but Party#{} {} OTs as receiver", sender,
+            requests[sender].number_of_sender_ots[receiver], receiver,
+            requests[receiver].number_of_receiver_ots[sender]));
+      }
+    }
+  }
+
+  std::vector<ThirdPartyMaterial> materials;
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    materials.emplace_back(
+        ExpandMaterial(*generators_[party_id], counters_[party_id], requests[party_id]));
+  }
+
+  std::vector<std::vector<std::uint8_t>> responses(number_of_parties);
+
+  // the last party corrects its shares of the products
+  auto& correction_response{responses.back()};
+  BitVector<> a{materials[0].binary_mts.a}, b{materials[0].binary_mts.b},
+      c{materials[0].binary_mts.c};
+  for (std::size_t party_id = 1; party_id < number_of_parties; ++party_id) {
+    a ^= materials[party_id].binary_mts.a;
+    b ^= materials[party_id].binary_mts.b;
+    c ^= materials[party_id].binary_mts.c;
+  }
+  const auto binary_corrections{(a & b) ^ c};
+  AppendBytes(correction_response, binary_corrections.GetData().data(),
+              BitsToBytes(binary_corrections.GetSize()));
+  AppendIntegerMtCorrections<std::uint8_t>(correction_response, materials);
+  AppendIntegerMtCorrections<std::uint16_t>(correction_response, materials);
+  AppendIntegerMtCorrections<std::uint32_t>(correction_response, materials);
+  AppendIntegerMtCorrections<std::uint64_t>(correction_response, materials);
+  AppendSpCorrections<std::uint8_t>(correction_response, materials);
+  AppendSpCorrections<std::uint16_t>(correction_response, materials);
+  AppendSpCorrections<std::uint32_t>(correction_response, materials);
+  AppendSpCorrections<std::uint64_t>(correction_response, materials);
+  AppendSpCorrections<__uint128_t>(correction_response, materials);
+
+  // the receivers obtain the chosen messages of their OTs
+  for (std::size_t receiver = 0; receiver < number_of_parties; ++receiver) {
+    for (std::size_t sender = 0; sender < number_of_parties; ++sender) {
+      if (sender == receiver) continue;
+      const auto& choices{materials[receiver].ot_receiver_choices[sender]};
+      const auto& messages{materials[sender].ot_sender_messages[receiver]};
+      for (std::size_t i = 0; i < choices.GetSize(); ++i) {
+        AppendBytes(responses[receiver],
+                    messages.data() + (2 * i + (choices.Get(i) ? 1 : 0)) * kOtMessageSize,
+                    kOtMessageSize);
+      }
+    }
+  }
+
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    transports_[party_id]->SendMessage(responses[party_id]);
+  }
+  return true;
+}
+
+ThirdPartyDealerClient::ThirdPartyDealerClient(std::unique_ptr<communication::Transport> transport,
+                                               std::size_t my_id, std::size_t number_of_parties)
+    : transport_(std::move(transport)),
+      my_id_(my_id),
+      number_of_parties_(number_of_parties),
+      request_(number_of_parties) {}
+
+// signals the dealer that this party does not send further requests
+ThirdPartyDealerClient::~ThirdPartyDealerClient() { transport_->ShutdownSend(); }
+
+void ThirdPartyDealerClient::RequestMts(const MtProvider& mt_provider) {
+  std::scoped_lock lock(mutex_);
+  request_.number_of_binary_mts = mt_provider.GetNumberOfMts<bool>();
+  request_.number_of_integer_mts = {
+      mt_provider.GetNumberOfMts<std::uint8_t>(), mt_provider.GetNumberOfMts<std::uint16_t>(),
+      mt_provider.GetNumberOfMts<std::uint32_t>(), mt_provider.GetNumberOfMts<std::uint64_t>()};
+}
+
+void ThirdPartyDealerClient::RequestSps(const SpProvider& sp_provider) {
+  std::scoped_lock lock(mutex_);
+  request_.number_of_sps = {
+      sp_provider.GetNumberOfSps<std::uint8_t>(), sp_provider.GetNumberOfSps<std::uint16_t>(),
+      sp_provider.GetNumberOfSps<std::uint32_t>(), sp_provider.GetNumberOfSps<std::uint64_t>(),
+      sp_provider.GetNumberOfSps<__uint128_t>()};
+}
+
+void ThirdPartyDealerClient::RequestRandomOts(std::size_t party_id,
+                                              std::size_t number_of_sender_ots,
+                                              std::size_t number_of_receiver_ots) {
+  std::scoped_lock lock(mutex_);
+  request_.number_of_sender_ots.at(party_id) = number_of_sender_ots;
+  request_.number_of_receiver_ots.at(party_id) = number_of_receiver_ots;
+}
+
+void ThirdPartyDealerClient::Exchange() {
+  std::scoped_lock lock(mutex_);
+  if (!generator_) {
+    const auto seed{transport_->ReceiveMessage()};
+    if (!seed || seed->size() != primitives::SharingRandomnessGenerator::kMasterSeedByteLength) {
+      throw std::runtime_error("Did not receive a seed from the third party dealer");
+    }
+    generator_ = std::make_unique<primitives::SharingRandomnessGenerator>(my_id_);
+    generator_->Initialize(seed->data());
+  }
+
+  transport_->SendMessage(request_.Serialize());
+  const auto response{transport_->ReceiveMessage()};
+  if (!response) {
+    throw std::runtime_error("Lost the connection to the third party dealer");
+  }
+
+  material_ = ExpandMaterial(*generator_, counter_, request_);
+  ResponseReader reader(*response);
+  if (my_id_ == number_of_parties_ - 1) {
+    auto& c{material_.binary_mts.c};
+    c ^= BitVector<>(reinterpret_cast<const std::byte*>(reader.Read(BitsToBytes(c.GetSize()))),
+                     c.GetSize());
+    ApplyIntegerMtCorrections<std::uint8_t>(material_, reader);
+    ApplyIntegerMtCorrections<std::uint16_t>(material_, reader);
+    ApplyIntegerMtCorrections<std::uint32_t>(material_, reader);
+    ApplyIntegerMtCorrections<std::uint64_t>(material_, reader);
+    ApplySpCorrections<std::uint8_t>(material_, reader);
+    ApplySpCorrections<std::uint16_t>(material_, reader);
+    ApplySpCorrections<std::uint32_t>(material_, reader);
+    ApplySpCorrections<std::uint64_t>(material_, reader);
+    ApplySpCorrections<__uint128_t>(material_, reader);
+  }
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) continue;
+    const std::size_t size{kOtMessageSize * request_.number_of_receiver_ots[party_id]};
+    const auto messages{reinterpret_cast<const std::byte*>(reader.Read(size))};
+    material_.ot_receiver_messages[party_id].assign(messages, messages + size);
+  }
+  if (!reader.IsFinished()) {
+    throw std::runtime_error("Received an oversized response from the third party dealer");
+  }
+
+  // the next preprocessing phase starts with an empty request
+  request_ = ThirdPartyRequest(number_of_parties_);
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,192 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sp_provider.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::primitives {
+
+class SharingRandomnessGenerator;
+
+}  // namespace encrypto::motion::primitives
+
+namespace encrypto::motion::communication {
+
+class Transport;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion {
+
+// Numbers of correlations which a party requests from the dealer in one preprocessing phase
+struct ThirdPartyRequest {
+  ThirdPartyRequest(std::size_t number_of_parties);
+
+  std::vector<std::uint8_t> Serialize() const;
+  static ThirdPartyRequest Deserialize(std::span<const std::uint8_t> message,
+                                       std::size_t number_of_parties);
+
+  std::size_t number_of_binary_mts{0};
+  // MTs of 8, 16, 32 and 64 bit
+  std::array<std::size_t, 4> number_of_integer_mts{};
+  // SPs of 8, 16, 32, 64 and 128 bit
+  std::array<std::size_t, 5> number_of_sps{};
+  // random OTs with each party in which this party is the sender/receiver
+  std::vector<std::size_t> number_of_sender_ots, number_of_receiver_ots;
+};
+
+// The correlated randomness of one party
+struct ThirdPartyMaterial {
+  template <typename T>
+  const IntegerMtVector<T>& GetIntegerMts() const noexcept {
+    if constexpr (std::is_same_v<T, std::uint8_t>) {
+      return mts_8;
+    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
+      return mts_16;
+    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
+      return mts_32;
+    } else {
+      static_assert(std::is_same_v<T, std::uint64_t>);
+      return mts_64;
+    }
+  }
+
+  template <typename T>
+  IntegerMtVector<T>& GetIntegerMts() noexcept {
+    return const_cast<IntegerMtVector<T>&>(std::as_const(*this).GetIntegerMts<T>());
+  }
+
+  template <typename T>
+  const SpVector<T>& GetSps() const noexcept {
+    if constexpr (std::is_same_v<T, std::uint8_t>) {
+      return sps_8;
+    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
+      return sps_16;
+    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
+      return sps_32;
+    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
+      return sps_64;
+    } else {
+      static_assert(std::is_same_v<T, __uint128_t>);
+      return sps_128;
+    }
+  }
+
+  template <typename T>
+  SpVector<T>& GetSps() noexcept {
+    return const_cast<SpVector<T>&>(std::as_const(*this).GetSps<T>());
+  }
+
+  BinaryMtVector binary_mts;
+  IntegerMtVector<std::uint8_t> mts_8;
+  IntegerMtVector<std::uint16_t> mts_16;
+  IntegerMtVector<std::uint32_t> mts_32;
+  IntegerMtVector<std::uint64_t> mts_64;
+  SpVector<std::uint8_t> sps_8;
+  SpVector<std::uint16_t> sps_16;
+  SpVector<std::uint32_t> sps_32;
+  SpVector<std::uint64_t> sps_64;
+  SpVector<__uint128_t> sps_128;
+  // 128 bit random OTs with each party, the sender holds m_0 || m_1 of every OT, and the receiver
+  // the choice bits c and the messages m_c
+  std::vector<std::vector<std::byte>> ot_sender_messages;
+  std::vector<BitVector<>> ot_receiver_choices;
+  std::vector<std::vector<std::byte>> ot_receiver_messages;
+};
+
+// Trusted dealer (e.g., a semi-trusted helper server) which produces the MTs, SPs, and random OTs
+// of the parties.  The dealer shares a seed with every party, from which the party expands its
+// shares locally.  Only the last party additionally receives the corrections of its shares of the
+// products, and every OT receiver receives the messages m_c of its OTs.
+//
+// The dealer is connected to every party by a transport which the party passes to
+// Backend::SetThirdPartyDealer.
+class ThirdPartyDealer {
+ public:
+  ThirdPartyDealer(std::vector<std::unique_ptr<communication::Transport>>&& transports);
+  ~ThirdPartyDealer();
+
+  ThirdPartyDealer(const ThirdPartyDealer&) = delete;
+
+  // serve the requests of the parties until one of them closes its transport
+  void Run();
+
+ private:
+  // handle one request of every party, returns false if a transport has been closed
+  bool HandleRequests();
+
+  std::vector<std::unique_ptr<communication::Transport>> transports_;
+  std::vector<std::unique_ptr<primitives::SharingRandomnessGenerator>> generators_;
+  std::vector<std::size_t> counters_;
+};
+
+// The party side of the connection to a ThirdPartyDealer, which the providers use to request and
+// obtain their correlations
+class ThirdPartyDealerClient {
+ public:
+  ThirdPartyDealerClient(std::unique_ptr<communication::Transport> transport, std::size_t my_id,
+                         std::size_t number_of_parties);
+  ~ThirdPartyDealerClient();
+
+  ThirdPartyDealerClient(const ThirdPartyDealerClient&) = delete;
+
+  std::size_t GetMyId() const { return my_id_; }
+  std::size_t GetNumberOfParties() const { return number_of_parties_; }
+
+  // register the correlations needed for the next preprocessing phase
+  void RequestMts(const MtProvider& mt_provider);
+  void RequestSps(const SpProvider& sp_provider);
+  void RequestRandomOts(std::size_t party_id, std::size_t number_of_sender_ots,
+                        std::size_t number_of_receiver_ots);
+
+  // send the request to the dealer and derive the correlations, needs to be called by all parties
+  // after all requests have been registered
+  void Exchange();
+
+  // the correlations of the last exchange
+  ThirdPartyMaterial& GetMaterial() { return material_; }
+
+ private:
+  std::unique_ptr<communication::Transport> transport_;
+  std::unique_ptr<primitives::SharingRandomnessGenerator> generator_;
+  std::size_t counter_{0};
+  const std::size_t my_id_;
+  const std::size_t number_of_parties_;
+  ThirdPartyRequest request_;
+  ThirdPartyMaterial material_;
+  std::mutex mutex_;
+};
+
+}  // namespace encrypto::motion
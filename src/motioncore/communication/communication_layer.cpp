@@ -22,25 +22,53 @@
 
 #include "communication_layer.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <future>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <set>
 #include <shared_mutex>
+#include <span>
 #include <stdexcept>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <variant>
+#include <vector>
 
+#include <unistd.h>
+
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/fss.hpp>
+#include <boost/fiber/mutex.hpp>
 #include <flatbuffers/flatbuffers.h>
 #include <fmt/format.h>
 
 #include "dummy_transport.h"
 #include "message.h"
+#include "message_buffer.h"
+#include "message_compression.h"
 #include "message_manager.h"
+#include "message_priority.h"
+#include "shared_memory_transport.h"
+#include "statistics/metrics.h"
 #include "tcp_transport.h"
 #include "utility/constants.h"
+#include "utility/locked_fiber_queue.h"
 #include "utility/logger.h"
-#include "utility/synchronized_queue.h"
+#include "utility/mpsc_fiber_queue.h"
 #include "utility/thread.h"
 
 namespace encrypto::motion::communication {
@@ -52,6 +80,126 @@ struct CommunicationLayer::CommunicationLayerImplementation {
   // run in a thread for each party
   void ReceiveTask(std::size_t party_id, MessageManager& message_manager);
   void SendTask(std::size_t party_id);
+  // event-driven counterparts of the tasks which run on the event loop of the transports
+  void StartEventDriven();
+  void ReceiveAsync(std::size_t party_id);
+  void SendAsync(std::size_t party_id);
+  // wake up the event-driven sender of a party after enqueuing messages
+  void NotifySend(std::size_t party_id);
+  // dispatch a single received message, returns false if it was a termination message
+  bool HandleMessage(std::size_t party_id, MessageManager& message_manager,
+                     MessageBuffer&& raw_message);
+  // state of MessageCompression::kAdaptive for the messages of one type sent to one party
+  struct AdaptiveCompressionState {
+    // number of messages to send without trying to compress them
+    std::size_t number_of_messages_to_skip = 0;
+    // number of messages to skip after the next message that does not compress well
+    std::size_t backoff = 1;
+  };
+  // compress a message to be sent if configured for its type, std::nullopt if it is sent as is
+  std::optional<std::vector<std::uint8_t>> TryCompressMessage(
+      std::size_t party_id, std::span<const std::uint8_t> message,
+      std::span<AdaptiveCompressionState> compression_states);
+  // serialized message to be sent, which is shared by the send queues of a broadcast
+  class SerializedMessage {
+   public:
+    explicit SerializedMessage(flatbuffers::DetachedBuffer&& buffer)
+        : storage_(std::move(buffer)), enqueue_time_(std::chrono::steady_clock::now()) {}
+    // a received message to be forwarded
+    explicit SerializedMessage(MessageBuffer&& buffer)
+        : storage_(std::move(buffer)), enqueue_time_(std::chrono::steady_clock::now()) {}
+
+    const std::uint8_t* data() const {
+      return std::visit([](const auto& buffer) -> const std::uint8_t* { return buffer.data(); },
+                        storage_);
+    }
+    std::size_t size() const {
+      return std::visit([](const auto& buffer) { return buffer.size(); }, storage_);
+    }
+    std::span<const std::uint8_t> GetSpan() const { return {data(), size()}; }
+    std::chrono::steady_clock::time_point GetEnqueueTime() const { return enqueue_time_; }
+
+   private:
+    std::variant<flatbuffers::DetachedBuffer, MessageBuffer> storage_;
+    std::chrono::steady_clock::time_point enqueue_time_;
+  };
+
+  // messages taken from a send queue and prepared to be written to the transport
+  struct OutgoingMessages {
+    std::vector<std::shared_ptr<const SerializedMessage>> messages;
+    std::vector<std::vector<std::uint8_t>> compressed_messages;
+    // fragments of prioritized messages, each a header followed by its part of the message, such
+    // that a fragment is a single message of the transport
+    std::deque<std::vector<std::uint8_t>> fragments;
+    // refer to the data above
+    std::vector<std::span<const std::uint8_t>> spans;
+  };
+  // compress the messages as configured
+  void PrepareMessages(std::size_t party_id, OutgoingMessages& outgoing_messages);
+  // messages taken from the send queue of a party if prioritization is enabled
+  struct PendingMessage {
+    std::shared_ptr<const SerializedMessage> message;
+    std::vector<std::uint8_t> compressed_message;
+    // what is sent, i.e., the message or its compressed form
+    std::span<const std::uint8_t> bytes;
+    // number of bytes already sent in fragments
+    std::size_t number_of_sent_bytes = 0;
+  };
+  struct SendSchedule {
+    std::array<std::deque<PendingMessage>, kNumberOfMessagePriorities> queues;
+    // credits of the deficit round robin over the priorities
+    std::array<std::size_t, kNumberOfMessagePriorities> deficits{};
+    // sent after all other messages
+    std::shared_ptr<const SerializedMessage> termination_message;
+
+    bool empty() const {
+      return termination_message == nullptr &&
+             std::all_of(queues.begin(), queues.end(), [](auto& queue) { return queue.empty(); });
+    }
+  };
+  // move messages into the schedule of a party, compressing them as configured
+  void ScheduleMessages(std::size_t party_id,
+                        std::queue<std::shared_ptr<const SerializedMessage>>& messages);
+  // take the messages and fragments for the next write from the schedule of a party
+  void TakeScheduledMessages(std::size_t party_id, OutgoingMessages& outgoing_messages);
+  // enqueue a message for a party, waiting for space in the queue first if it is bounded
+  void EnqueueMessage(std::size_t party_id, std::shared_ptr<const SerializedMessage> message,
+                      bool wait_for_space);
+  // enqueue a message broadcast by origin_id for the children of this party in the relay tree
+  void RelayBroadcast(std::size_t origin_id, std::shared_ptr<const SerializedMessage> message);
+  // count the messages per type once they have been written to the transport or received
+  void RecordSentMessages(std::size_t party_id, const OutgoingMessages& outgoing_messages);
+  void RecordReceivedMessage(std::size_t party_id, MessageType message_type,
+                             std::size_t number_of_bytes);
+  // record a message in the message trace if message tracing is enabled
+  void TraceMessage(std::size_t party_id, MessageTrace::Direction direction,
+                    MessageType message_type, std::uint64_t message_id,
+                    std::size_t number_of_bytes);
+  void TraceSentMessage(std::size_t party_id, std::span<const std::uint8_t> message);
+  // answer a request of EstimateClockOffsets or MeasureLinks, or pass a response on to it
+  void HandleClockProbe(std::size_t party_id, const Message& message);
+  // send a clock probe of payload_size bytes to each other party and wait for the responses,
+  // returns the times [t0, t1, t2, t3] per party
+  std::vector<std::array<std::int64_t, 4>> ProbeClocks(std::size_t probe,
+                                                       std::size_t payload_size);
+  // the message manager of a session, which is created on the first message of the session or by
+  // CreateSession, whichever comes first, and kept until the communication layer is destroyed
+  MessageManager& GetSessionMessageManager(std::uint32_t session_id,
+                                           MessageManager& message_manager);
+  std::shared_ptr<MessageManager> GetSessionMessageManager(std::uint32_t session_id);
+  // hand a message on to the promise registered for it, unless it is held until this party
+  // reaches the epoch of the sender
+  void DeliverMessage(std::size_t party_id, MessageManager& message_manager,
+                      MessageType message_type, std::size_t message_id,
+                      MessageBuffer&& message);
+  void FulfillMessagePromise(std::size_t party_id, MessageManager& message_manager,
+                             MessageType message_type, std::size_t message_id,
+                             MessageBuffer&& message);
+  // the synchronization messages mark the epochs in the streams of the parties, which requires
+  // that messages are neither reordered by priority nor relayed by other parties
+  bool UsesImplicitSynchronization() const {
+    return implicit_synchronization_ && !prioritize_messages_ && !relay_broadcasts_;
+  }
 
   // setup threads and data structures
   void Initialize(std::size_t my_id, std::size_t number_of_parties);
@@ -63,18 +211,113 @@ struct CommunicationLayer::CommunicationLayerImplementation {
 
   std::promise<void> start_promise_;
   std::shared_future<void> start_sfuture_;
+  // the communication is started once by the first of the layers sharing this implementation
+  std::once_flag start_flag_;
+  std::atomic<bool> is_started_ = false;
   std::atomic<bool> continue_communication_ = true;
+  std::atomic<bool> relay_broadcasts_ = false;
+  std::atomic<bool> prioritize_messages_ = false;
+  std::atomic<bool> implicit_synchronization_ = false;
+  // size of the fragments of large prioritized messages
+  static constexpr std::size_t kMessageFragmentSize{std::size_t(64) << 10};
+  // number of fragments per priority in each write of prioritized messages
+  static constexpr std::array<std::size_t, kNumberOfMessagePriorities> kPriorityWeights{8, 4, 1};
+  // smaller broadcasts are always sent directly, e.g., synchronization and termination messages
+  static constexpr std::size_t kMinRelayedBroadcastSize{4096};
+  // number of children of a party in the relay tree
+  static constexpr std::size_t kRelayFanout{2};
+  // budget for gathering pending messages into vectored writes
+  std::atomic<std::size_t> max_send_bytes_ = kDefaultMaxSendBytes;
+  std::atomic<std::int64_t> max_send_delay_us_ = 0;
+  static constexpr std::size_t kDefaultMaxSendBytes{1 << 20};
+
+  // compression configuration per message type
+  static constexpr std::size_t kNumberOfMessageTypes{std::size_t(1) << (8 * sizeof(MessageType))};
+  std::array<std::atomic<MessageCompression>, kNumberOfMessageTypes> message_compression_{};
+  // priority configuration per message type, initialized with GetDefaultMessagePriority
+  std::array<std::atomic<MessagePriority>, kNumberOfMessageTypes> message_priorities_;
+  // smaller messages are never compressed
+  static constexpr std::size_t kMinCompressedMessageSize{64};
+  // in adaptive mode, messages need to compress to at most this fraction of their size
+  static constexpr double kAdaptiveCompressionRatio{0.875};
+  static constexpr std::size_t kMaxCompressionBackoff{1024};
+
+  struct CompressionStatistics {
+    std::atomic<std::size_t> number_of_uncompressed_bytes_sent = 0;
+    std::atomic<std::size_t> number_of_compressed_bytes_sent = 0;
+    std::atomic<std::size_t> number_of_uncompressed_bytes_received = 0;
+    std::atomic<std::size_t> number_of_compressed_bytes_received = 0;
+  };
 
   std::vector<std::unique_ptr<Transport>> transports_;
 
+  // shared by all receive threads, buffers are recycled once their consumers released them
+  std::shared_ptr<MessageBufferPool> receive_buffer_pool_ = std::make_shared<MessageBufferPool>();
+
   // message type
-  using message_t = std::shared_ptr<flatbuffers::DetachedBuffer>;
+  using message_t = std::shared_ptr<const SerializedMessage>;
 
-  std::vector<SynchronizedFiberQueue<message_t>> send_queues_;
+  // written by the gate fibers of all threads and read by the send thread of the party
+  std::vector<MpscFiberQueue<message_t>> send_queues_;
+  // bytes in the send queue and in the schedule of a party, which are released once written
+  struct SendQueueState {
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable condition_variable;
+    // updated without the mutex if the send queues are unbounded, else guarded by it
+    std::atomic<std::size_t> number_of_queued_bytes = 0;
+    std::atomic<std::size_t> max_number_of_queued_bytes = 0;
+    std::atomic<std::size_t> number_of_blocked_sends = 0;
+  };
+  std::vector<SendQueueState> send_queue_states_;
+  // 0 if the send queues are unbounded
+  std::atomic<std::size_t> max_queued_bytes_ = 0;
   std::vector<std::thread> receive_threads_;
   std::vector<std::thread> send_threads_;
+  std::vector<CompressionStatistics> compression_statistics_;
+  std::vector<std::array<AdaptiveCompressionState, kNumberOfMessageTypes>> compression_states_;
+  // accessed by the sender of a party only
+  std::vector<SendSchedule> send_schedules_;
+  // a fragmented message being received from a party, accessed by the receiver of the party only
+  struct FragmentedMessage {
+    MessageBuffer message;
+    std::size_t number_of_received_bytes = 0;
+  };
+  std::vector<std::array<FragmentedMessage, kNumberOfMessagePriorities>> fragmented_messages_;
+  // written by the send and receive tasks of a party and read by GetTransportStatistics
+  struct TrafficStatistics {
+    std::mutex mutex;
+    std::map<std::size_t, MessageTypeStatistics> message_type_statistics;
+  };
+  std::vector<TrafficStatistics> traffic_statistics_;
+  // the times [t0, t1, t2, t3] of the answered clock probes of this party, see kClockProbe, with
+  // the receive time t3 of the response
+  std::vector<LockedFiberQueue<std::array<std::int64_t, 4>>> clock_probe_responses_;
+
+  std::atomic<bool> trace_messages_ = false;
+  std::mutex message_trace_mutex_;
+  MessageTrace message_trace_;
+
+  // state of the event-driven mode in which no threads are spawned
+  struct EventDrivenState {
+    // set while a sender takes messages from the queue or waits for a write to complete
+    std::atomic<bool> is_sending = false;
+    std::promise<void> send_finished;
+    std::promise<void> receive_finished;
+  };
+  bool is_event_driven_;
+  std::atomic<bool> is_running_ = false;
+  std::vector<EventDrivenState> event_driven_states_;
+  MessageManager* message_manager_;
+
+  std::mutex sessions_mutex_;
+  std::map<std::uint32_t, std::shared_ptr<MessageManager>> session_message_managers_;
+  std::set<std::uint32_t> open_sessions_;
 
   std::shared_ptr<Logger> logger_;
+
+  // set by RegisterMetrics, the collector reads the members above and is hence destroyed first
+  std::atomic<MetricsHistogram*> sent_message_size_histogram_ = nullptr;
+  MetricsCollectorHandle metrics_collector_;
 };
 
 CommunicationLayer::CommunicationLayerImplementation::CommunicationLayerImplementation(
@@ -85,9 +328,28 @@ CommunicationLayer::CommunicationLayerImplementation::CommunicationLayerImplemen
       start_sfuture_(start_promise_.get_future().share()),
       transports_(std::move(transports)),
       send_queues_(number_of_parties_),
+      send_queue_states_(number_of_parties_),
+      compression_statistics_(number_of_parties_),
+      compression_states_(number_of_parties_),
+      send_schedules_(number_of_parties_),
+      fragmented_messages_(number_of_parties_),
+      traffic_statistics_(number_of_parties_),
+      clock_probe_responses_(number_of_parties_),
+      is_event_driven_(kEventDrivenCommunication),
+      event_driven_states_(number_of_parties_),
+      message_manager_(&message_manager),
       logger_(std::move(logger)) {
+  for (std::size_t message_type = 0; message_type < kNumberOfMessageTypes; ++message_type) {
+    message_priorities_[message_type] =
+        GetDefaultMessagePriority(static_cast<MessageType>(message_type));
+  }
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
-    if (party_id == my_id) {
+    if (party_id != my_id && !transports_.at(party_id)->SupportsAsynchronousOperations()) {
+      is_event_driven_ = false;
+    }
+  }
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id || is_event_driven_) {
       receive_threads_.emplace_back();
       send_threads_.emplace_back();
       continue;
@@ -104,24 +366,82 @@ CommunicationLayer::CommunicationLayerImplementation::CommunicationLayerImplemen
 void CommunicationLayer::CommunicationLayerImplementation::SendTask(std::size_t party_id) {
   auto& queue = send_queues_.at(party_id);
   auto& transport = *transports_.at(party_id);
+  auto& schedule = send_schedules_.at(party_id);
 
   auto my_start_sfuture = start_sfuture_;
   my_start_sfuture.get();
 
-  while (!queue.IsClosedAndEmpty()) {
+  while (!queue.IsClosedAndEmpty() || !schedule.empty()) {
+    if (prioritize_messages_ || !schedule.empty()) {
+      // only wait for new messages if nothing is scheduled, otherwise they join the next write
+      if (schedule.empty()) {
+        auto new_messages = queue.BatchDequeue();
+        if (!new_messages.has_value()) {
+          assert(queue.IsClosed());
+          break;
+        }
+        ScheduleMessages(party_id, *new_messages);
+      } else {
+        auto new_messages{queue.TryBatchDequeue()};
+        ScheduleMessages(party_id, new_messages);
+      }
+      OutgoingMessages outgoing_messages;
+      TakeScheduledMessages(party_id, outgoing_messages);
+      transport.SendMessages(outgoing_messages.spans);
+      RecordSentMessages(party_id, outgoing_messages);
+      if (logger_) {
+        logger_->LogDebug("Sent {} prioritized messages and fragments to party {}",
+                          outgoing_messages.spans.size(), party_id);
+      }
+      continue;
+    }
     auto tmp_queue = queue.BatchDequeue();
     if (!tmp_queue.has_value()) {
       assert(queue.IsClosed());
       break;
     }
-    while (!tmp_queue->empty()) {
-      auto& message = tmp_queue->front();
-      transport.SendMessage(std::span(message->data(), message->size()));
-      tmp_queue->pop();
+    OutgoingMessages outgoing_messages;
+    auto& messages{outgoing_messages.messages};
+    std::size_t number_of_bytes = 0;
+    auto take_messages = [&messages, &number_of_bytes](std::queue<message_t>& new_messages) {
+      for (; !new_messages.empty(); new_messages.pop()) {
+        number_of_bytes += new_messages.front()->size();
+        messages.emplace_back(std::move(new_messages.front()));
+      }
+    };
+    take_messages(*tmp_queue);
+    const std::size_t max_send_bytes{max_send_bytes_};
+    const std::int64_t max_send_delay_us{max_send_delay_us_};
+    if (max_send_delay_us > 0 && number_of_bytes < max_send_bytes && !queue.IsClosed()) {
+      // wait for further messages to fill the budget
+      std::this_thread::sleep_for(std::chrono::microseconds(max_send_delay_us));
+      auto more_messages{queue.TryBatchDequeue()};
+      take_messages(more_messages);
+    }
+    PrepareMessages(party_id, outgoing_messages);
+    const auto& message_spans{outgoing_messages.spans};
+    // gather the messages into vectored writes of at most max_send_bytes each
+    std::vector<std::span<const std::uint8_t>> spans;
+    std::size_t number_of_span_bytes = 0;
+    auto send_spans = [&] {
+      transport.SendMessages(spans);
       if (logger_) {
-        logger_->LogDebug(fmt::format("Sent message to party {}", party_id));
+        logger_->LogDebug("Sent {} messages to party {}", spans.size(), party_id);
+      }
+      spans.clear();
+      number_of_span_bytes = 0;
+    };
+    for (auto message : message_spans) {
+      if (!spans.empty() && number_of_span_bytes + message.size() > max_send_bytes) {
+        send_spans();
       }
+      spans.push_back(message);
+      number_of_span_bytes += message.size();
     }
+    if (!spans.empty()) {
+      send_spans();
+    }
+    RecordSentMessages(party_id, outgoing_messages);
   }
 
   transport.ShutdownSend();
@@ -131,6 +451,140 @@ void CommunicationLayer::CommunicationLayerImplementation::SendTask(std::size_t
   }
 }
 
+void CommunicationLayer::CommunicationLayerImplementation::PrepareMessages(
+    std::size_t party_id, OutgoingMessages& outgoing_messages) {
+  // compress the messages of the configured types, the spans refer to what is sent
+  auto& message_spans{outgoing_messages.spans};
+  auto& compressed_messages{outgoing_messages.compressed_messages};
+  message_spans.reserve(outgoing_messages.messages.size());
+  for (auto& message : outgoing_messages.messages) {
+    std::span<const std::uint8_t> message_span(message->data(), message->size());
+    if (auto compressed_message{
+            TryCompressMessage(party_id, message_span, compression_states_.at(party_id))};
+        compressed_message.has_value()) {
+      compressed_messages.emplace_back(std::move(*compressed_message));
+      message_span = compressed_messages.back();
+    }
+    message_spans.push_back(message_span);
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::StartEventDriven() {
+  is_running_ = true;
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    ReceiveAsync(party_id);
+    // send what has been enqueued before the start
+    NotifySend(party_id);
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::NotifySend(std::size_t party_id) {
+  if (!is_event_driven_ || !is_running_) {
+    return;
+  }
+  if (!event_driven_states_.at(party_id).is_sending.exchange(true)) {
+    SendAsync(party_id);
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::SendAsync(std::size_t party_id) {
+  auto& queue = send_queues_.at(party_id);
+  auto& transport = *transports_.at(party_id);
+  auto& state = event_driven_states_.at(party_id);
+
+  auto& schedule = send_schedules_.at(party_id);
+
+  while (true) {
+    auto new_messages{queue.TryBatchDequeue()};
+    auto outgoing_messages{std::make_shared<OutgoingMessages>()};
+    if (prioritize_messages_ || !schedule.empty()) {
+      ScheduleMessages(party_id, new_messages);
+      TakeScheduledMessages(party_id, *outgoing_messages);
+    } else if (!new_messages.empty()) {
+      for (; !new_messages.empty(); new_messages.pop()) {
+        outgoing_messages->messages.emplace_back(std::move(new_messages.front()));
+      }
+      PrepareMessages(party_id, *outgoing_messages);
+    }
+    if (!outgoing_messages->spans.empty()) {
+      // the handler keeps the messages alive until they are written
+      transport.AsyncSendMessages(
+          outgoing_messages->spans, [this, party_id, outgoing_messages](std::exception_ptr error) {
+            if (error) {
+              try {
+                std::rethrow_exception(error);
+              } catch (std::runtime_error& e) {
+                if (logger_) {
+                  logger_->LogError(
+                      fmt::format("SendMessages failed for party {}: {}", party_id, e.what()));
+                }
+              }
+              event_driven_states_.at(party_id).send_finished.set_value();
+              return;
+            }
+            RecordSentMessages(party_id, *outgoing_messages);
+            if (logger_) {
+              logger_->LogDebug("Sent {} messages to party {}",
+                                outgoing_messages->messages.size(), party_id);
+            }
+            SendAsync(party_id);
+          });
+      return;
+    }
+    if (queue.IsClosedAndEmpty()) {
+      // shutdown on the event loop after all pending writes, is_sending stays set from now on
+      transport.AsyncSendMessages({}, [this, party_id, &transport](std::exception_ptr) {
+        transport.ShutdownSend();
+        if (logger_) {
+          logger_->LogDebug(fmt::format("SendAsync finished for party {}", party_id));
+        }
+        event_driven_states_.at(party_id).send_finished.set_value();
+      });
+      return;
+    }
+    state.is_sending = false;
+    // a message may have been enqueued before is_sending was reset, then nobody else sends it
+    if ((queue.empty() && !queue.IsClosed()) || state.is_sending.exchange(true)) {
+      return;
+    }
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::ReceiveAsync(std::size_t party_id) {
+  transports_.at(party_id)->AsyncReceivePooledMessage(
+      *receive_buffer_pool_, [this, party_id](std::optional<MessageBuffer>&& raw_message_opt,
+                                              std::exception_ptr error) {
+        bool continue_receiving = false;
+        if (error) {
+          try {
+            std::rethrow_exception(error);
+          } catch (std::runtime_error& e) {
+            if (logger_) {
+              logger_->LogError(
+                  fmt::format("ReceiveMessage failed for party {}: {}", party_id, e.what()));
+            }
+          }
+        } else if (!raw_message_opt.has_value()) {
+          // underlying transport was closed unexpectedly
+          if (logger_) {
+            logger_->LogError(fmt::format(
+                "underlying transport was closed unexpectedly from party {}", party_id));
+          }
+        } else {
+          continue_receiving =
+              HandleMessage(party_id, *message_manager_, std::move(*raw_message_opt));
+        }
+        if (continue_receiving) {
+          ReceiveAsync(party_id);
+        } else {
+          event_driven_states_.at(party_id).receive_finished.set_value();
+        }
+      });
+}
+
 void CommunicationLayer::CommunicationLayerImplementation::ReceiveTask(
     std::size_t party_id, MessageManager& message_manager) {
   auto& transport = *transports_.at(party_id);
@@ -139,9 +593,9 @@ void CommunicationLayer::CommunicationLayerImplementation::ReceiveTask(
   my_start_sfuture.get();
 
   while (continue_communication_) {
-    std::optional<std::vector<std::uint8_t>> raw_message_opt;
+    std::optional<MessageBuffer> raw_message_opt;
     try {
-      raw_message_opt = transport.ReceiveMessage();
+      raw_message_opt = transport.ReceivePooledMessage(*receive_buffer_pool_);
     } catch (std::runtime_error& e) {
       if (logger_) {
         logger_->LogError(
@@ -157,50 +611,521 @@ void CommunicationLayer::CommunicationLayerImplementation::ReceiveTask(
       }
       break;
     }
-    auto raw_message = std::move(*raw_message_opt);
-    flatbuffers::Verifier verifier(reinterpret_cast<std::uint8_t*>(raw_message.data()),
-                                   raw_message.size());
-    if (!VerifyMessageBuffer(verifier)) {
+    if (!HandleMessage(party_id, message_manager, std::move(*raw_message_opt))) {
+      break;
+    }
+  }
+
+  if constexpr (kDebug) {
+    if (logger_) {
+      logger_->LogDebug(fmt::format("ReceiveTask finished for party {}", party_id));
+    }
+  }
+}
+
+bool CommunicationLayer::CommunicationLayerImplementation::HandleMessage(
+    std::size_t party_id, MessageManager& message_manager,
+    MessageBuffer&& raw_message) {
+  if (auto header{ReadMessageFragmentHeader(raw_message.GetSpan())}; header.has_value()) {
+    auto& fragmented_message{
+        fragmented_messages_.at(party_id)[static_cast<std::size_t>(header->priority)]};
+    if (header->offset == 0) {
+      if (header->total_length > kMaxMessageSize) {
+        if (logger_) {
+          logger_->LogError(fmt::format("received too large fragmented message from party {}",
+                                        party_id));
+        }
+        return true;
+      }
+      fragmented_message.message = receive_buffer_pool_->Acquire(header->total_length);
+      fragmented_message.number_of_received_bytes = 0;
+    } else if (fragmented_message.message.empty() ||
+               header->total_length != fragmented_message.message.size() ||
+               header->offset != fragmented_message.number_of_received_bytes) {
       if (logger_) {
-        logger_->LogError(fmt::format("received corrupt message from party {}", party_id));
+        logger_->LogError(fmt::format("received unexpected fragment from party {}", party_id));
       }
-      continue;
+      fragmented_message.message = MessageBuffer();
+      return true;
     }
+    std::copy_n(raw_message.data() + sizeof(MessageFragmentHeader), header->length,
+                fragmented_message.message.data() + header->offset);
+    fragmented_message.number_of_received_bytes += header->length;
+    if (fragmented_message.number_of_received_bytes < fragmented_message.message.size()) {
+      return true;
+    }
+    auto message{std::move(fragmented_message.message)};
+    fragmented_message.message = MessageBuffer();
+    return HandleMessage(party_id, message_manager, std::move(message));
+  }
+  if (auto header{ReadCompressedMessageHeader(raw_message.GetSpan())}; header.has_value()) {
+    if (header->uncompressed_length > kMaxMessageSize) {
+      if (logger_) {
+        logger_->LogError(fmt::format("received too large compressed message from party {}",
+                                      party_id));
+      }
+      return true;
+    }
+    auto message{receive_buffer_pool_->Acquire(header->uncompressed_length)};
+    try {
+      DecompressMessage(raw_message.GetSpan(), std::span(message.data(), message.size()));
+    } catch (std::runtime_error& e) {
+      if (logger_) {
+        logger_->LogError(fmt::format("received corrupt compressed message from party {}: {}",
+                                      party_id, e.what()));
+      }
+      return true;
+    }
+    auto& statistics{compression_statistics_.at(party_id)};
+    statistics.number_of_uncompressed_bytes_received += message.size();
+    statistics.number_of_compressed_bytes_received += raw_message.size();
+    return HandleMessage(party_id, message_manager, std::move(message));
+  }
+  if (auto header{ReadMessageFrameHeader(raw_message.GetSpan())}; header.has_value()) {
+    // bulk payloads are routed by their frame header without verifying the flatbuffer
+    if (logger_) {
+      logger_->LogDebug("received framed message of type {} with id {} from party {}",
+                        EnumNameMessageType(header->message_type), header->message_id, party_id);
+    }
+    RecordReceivedMessage(party_id, header->message_type, raw_message.size());
+    DeliverMessage(party_id, GetSessionMessageManager(header->session_id, message_manager),
+                   header->message_type, header->message_id,
+                   raw_message.GetSubBuffer(sizeof(MessageFrameHeader), header->length));
+    return true;
+  }
+
+  flatbuffers::Verifier verifier(raw_message.data(), raw_message.size());
+  if (!VerifyMessageBuffer(verifier)) {
+    if (logger_) {
+      logger_->LogError(fmt::format("received corrupt message from party {}", party_id));
+    }
+    return true;
+  }
 
-    // XXX: maybe use a separate thread for this
-    auto message = GetMessage(raw_message.data());
+  // XXX: maybe use a separate thread for this
+  auto message = GetMessage(raw_message.data());
 
-    auto message_id = message->message_id();
-    auto message_type = message->message_type();
+  auto message_id = message->message_id();
+  auto message_type = message->message_type();
+  if (logger_) {
+    logger_->LogDebug("received message of type {} with id {} from party {}",
+                      EnumNameMessageType(message_type), message_id, party_id);
+  }
+  if (message_type != MessageType::kMessageBatch &&
+      message_type != MessageType::kRelayedBroadcast) {
+    RecordReceivedMessage(party_id, message_type, raw_message.size());
+  }
+  if (message_type == MessageType::kMessageBatch) {
+    auto payload = message->payload();
+    if (payload == nullptr) {
+      return true;
+    }
+    std::size_t offset = 0;
+    while (offset < payload->size()) {
+      std::uint32_t size;
+      if (payload->size() - offset < sizeof(size)) {
+        if (logger_) {
+          logger_->LogError(fmt::format("received corrupt message batch from party {}", party_id));
+        }
+        return true;
+      }
+      std::copy_n(payload->data() + offset, sizeof(size), reinterpret_cast<std::uint8_t*>(&size));
+      offset += sizeof(size);
+      if (payload->size() - offset < size) {
+        if (logger_) {
+          logger_->LogError(fmt::format("received corrupt message batch from party {}", party_id));
+        }
+        return true;
+      }
+      // the inner message shares the storage of the batch
+      auto inner_message{raw_message.GetSubBuffer(
+          static_cast<std::size_t>(payload->data() - raw_message.data()) + offset, size)};
+      offset += size;
+      if (!HandleMessage(party_id, message_manager, std::move(inner_message))) {
+        return false;
+      }
+    }
+    return true;
+  } else if (message_type == MessageType::kRelayedBroadcast) {
+    auto payload = message->payload();
+    if (payload == nullptr || message_id >= number_of_parties_ || message_id == my_id_) {
+      if (logger_) {
+        logger_->LogError(
+            fmt::format("received corrupt relayed broadcast from party {}", party_id));
+      }
+      return true;
+    }
+    auto inner_message{raw_message.GetSubBuffer(
+        static_cast<std::size_t>(payload->data() - raw_message.data()), payload->size())};
+    // forward before delivering, such that the broadcast is on its way once this party can
+    // proceed and potentially shut down
+    RelayBroadcast(message_id, std::make_shared<const SerializedMessage>(std::move(raw_message)));
+    return HandleMessage(message_id, message_manager, std::move(inner_message));
+  } else if (message_type == MessageType::kTerminationMessage) {
     if constexpr (kDebug) {
       if (logger_) {
-        logger_->LogDebug(fmt::format("received message of type {} with id {} from party {}",
-                                      EnumNameMessageType(message_type), message_id, party_id));
+        logger_->LogDebug(fmt::format("received termination message from party {}", party_id));
       }
     }
+    return false;
+  } else if (message_type == MessageType::kClockProbe) {
+    HandleClockProbe(party_id, *message);
+  } else if (message_type == MessageType::kSynchronizationMessage) {
+    auto& session_message_manager{
+        GetSessionMessageManager(message->session_id(), message_manager)};
+    if (UsesImplicitSynchronization()) {
+      session_message_manager.AdvanceSenderEpoch(party_id);
+    } else {
+      session_message_manager.GetSyncStates(party_id).enqueue(std::move(raw_message));
+    }
+  } else {
+    DeliverMessage(party_id, GetSessionMessageManager(message->session_id(), message_manager),
+                   message_type, message_id, std::move(raw_message));
+  }
+  return true;
+}
+
+static std::int64_t ToNanoseconds(std::chrono::steady_clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::HandleClockProbe(
+    std::size_t party_id, const Message& message) {
+  const auto receive_time{ToNanoseconds(std::chrono::steady_clock::now())};
+  auto payload{message.payload()};
+  // requests may be padded to measure the bandwidth, responses have exactly 3 times
+  if (payload == nullptr || payload->size() < sizeof(std::int64_t)) {
+    if (logger_) {
+      logger_->LogError(fmt::format("received corrupt clock probe from party {}", party_id));
+    }
+    return;
+  }
+  std::array<std::int64_t, 4> times{};
+  if (payload->size() == 3 * sizeof(std::int64_t)) {
+    std::memcpy(times.data(), payload->data(), payload->size());
+    times[3] = receive_time;
+    clock_probe_responses_.at(party_id).enqueue(times);
+    return;
+  }
+  std::memcpy(times.data(), payload->data(), sizeof(std::int64_t));
+  times[1] = receive_time;
+  times[2] = ToNanoseconds(std::chrono::steady_clock::now());
+  auto message_builder{BuildMessage(
+      MessageType::kClockProbe, message.message_id(),
+      std::span(reinterpret_cast<const std::uint8_t*>(times.data()), 3 * sizeof(std::int64_t)))};
+  EnqueueMessage(party_id, std::make_shared<const SerializedMessage>(message_builder.Release()),
+                 false);
+}
+
+// type of a serialized message which may be framed
+static MessageType GetMessageType(std::span<const std::uint8_t> message) {
+  if (auto header{ReadMessageFrameHeader(message)}; header.has_value()) {
+    return header->message_type;
+  }
+  return GetMessage(message.data())->message_type();
+}
+
+std::optional<std::vector<std::uint8_t>>
+CommunicationLayer::CommunicationLayerImplementation::TryCompressMessage(
+    std::size_t party_id, std::span<const std::uint8_t> message,
+    std::span<AdaptiveCompressionState> compression_states) {
+  if (message.size() < kMinCompressedMessageSize) {
+    return std::nullopt;
+  }
+  const auto message_type{static_cast<std::size_t>(GetMessageType(message))};
+  const MessageCompression compression{message_compression_[message_type]};
+  if (compression == MessageCompression::kNone) {
+    return std::nullopt;
+  }
+  auto& state{compression_states[message_type]};
+  auto max_size{message.size()};
+  if (compression == MessageCompression::kAdaptive) {
+    if (state.number_of_messages_to_skip > 0) {
+      --state.number_of_messages_to_skip;
+      return std::nullopt;
+    }
+    max_size = static_cast<std::size_t>(kAdaptiveCompressionRatio * message.size());
+  }
+  auto compressed_message{CompressMessage(message, max_size)};
+  if (compression == MessageCompression::kAdaptive) {
+    if (compressed_message.has_value()) {
+      state.backoff = 1;
+    } else {
+      // probably random-looking data, so do not waste time on the next messages
+      state.number_of_messages_to_skip = state.backoff;
+      state.backoff = std::min(2 * state.backoff, kMaxCompressionBackoff);
+    }
+  }
+  if (compressed_message.has_value()) {
+    auto& statistics{compression_statistics_.at(party_id)};
+    statistics.number_of_uncompressed_bytes_sent += message.size();
+    statistics.number_of_compressed_bytes_sent += compressed_message->size();
+  }
+  return compressed_message;
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::ScheduleMessages(
+    std::size_t party_id, std::queue<message_t>& messages) {
+  auto& schedule{send_schedules_.at(party_id)};
+  for (; !messages.empty(); messages.pop()) {
+    auto& message{messages.front()};
+    const auto message_type{GetMessageType(message->GetSpan())};
     if (message_type == MessageType::kTerminationMessage) {
-      if constexpr (kDebug) {
-        if (logger_) {
-          logger_->LogDebug(fmt::format("received termination message from party {}", party_id));
+      schedule.termination_message = std::move(message);
+      continue;
+    }
+    PendingMessage pending_message{.message = std::move(message)};
+    if (auto compressed_message{TryCompressMessage(party_id, pending_message.message->GetSpan(),
+                                                   compression_states_.at(party_id))};
+        compressed_message.has_value()) {
+      pending_message.compressed_message = std::move(*compressed_message);
+      pending_message.bytes = pending_message.compressed_message;
+    } else {
+      pending_message.bytes = pending_message.message->GetSpan();
+    }
+    const MessagePriority priority{message_priorities_[static_cast<std::size_t>(message_type)]};
+    schedule.queues[static_cast<std::size_t>(priority)].emplace_back(std::move(pending_message));
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::TakeScheduledMessages(
+    std::size_t party_id, OutgoingMessages& outgoing_messages) {
+  auto& schedule{send_schedules_.at(party_id)};
+  auto& spans{outgoing_messages.spans};
+  // one round of a deficit round robin, starting with the highest priority
+  for (std::size_t priority = 0; priority < kNumberOfMessagePriorities; ++priority) {
+    auto& queue{schedule.queues[priority]};
+    auto& deficit{schedule.deficits[priority]};
+    if (queue.empty()) {
+      deficit = 0;
+      continue;
+    }
+    deficit += kPriorityWeights[priority] * kMessageFragmentSize;
+    while (!queue.empty() && deficit > 0) {
+      auto& pending_message{queue.front()};
+      const auto remaining_bytes{pending_message.bytes.size() -
+                                 pending_message.number_of_sent_bytes};
+      std::size_t number_of_bytes;
+      if (pending_message.number_of_sent_bytes == 0 && remaining_bytes <= kMessageFragmentSize) {
+        spans.push_back(pending_message.bytes);
+        number_of_bytes = remaining_bytes;
+      } else {
+        const auto length{std::min(remaining_bytes, kMessageFragmentSize)};
+        const MessageFragmentHeader header{.magic = MessageFragmentHeader::kMagic,
+                                           .length = static_cast<std::uint32_t>(length),
+                                           .priority = static_cast<MessagePriority>(priority),
+                                           .reserved = {},
+                                           .total_length = pending_message.bytes.size(),
+                                           .offset = pending_message.number_of_sent_bytes};
+        auto& fragment{outgoing_messages.fragments.emplace_back(sizeof(header) + length)};
+        std::memcpy(fragment.data(), &header, sizeof(header));
+        std::copy_n(pending_message.bytes.data() + pending_message.number_of_sent_bytes, length,
+                    fragment.data() + sizeof(header));
+        spans.emplace_back(fragment);
+        number_of_bytes = fragment.size();
+      }
+      pending_message.number_of_sent_bytes += std::min(remaining_bytes, kMessageFragmentSize);
+      deficit -= std::min(deficit, number_of_bytes);
+      if (pending_message.number_of_sent_bytes == pending_message.bytes.size()) {
+        // an unfragmented message is referred to by its span and hence kept until the write
+        // completed
+        outgoing_messages.messages.emplace_back(std::move(pending_message.message));
+        if (!pending_message.compressed_message.empty()) {
+          outgoing_messages.compressed_messages.emplace_back(
+              std::move(pending_message.compressed_message));
         }
+        queue.pop_front();
       }
+    }
+  }
+  if (schedule.termination_message != nullptr &&
+      std::all_of(schedule.queues.begin(), schedule.queues.end(),
+                  [](auto& queue) { return queue.empty(); })) {
+    spans.push_back(schedule.termination_message->GetSpan());
+    outgoing_messages.messages.emplace_back(std::move(schedule.termination_message));
+    schedule.termination_message = nullptr;
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::EnqueueMessage(
+    std::size_t party_id, std::shared_ptr<const SerializedMessage> message, bool wait_for_space) {
+  auto& state{send_queue_states_.at(party_id)};
+  auto& queue{send_queues_.at(party_id)};
+  const auto number_of_bytes{message->size()};
+  if (max_queued_bytes_ == 0) {
+    // unbounded queues need no lock, which producers of all threads would contend for
+    const auto number_of_queued_bytes{state.number_of_queued_bytes.fetch_add(number_of_bytes) +
+                                      number_of_bytes};
+    auto max_number_of_queued_bytes{state.max_number_of_queued_bytes.load()};
+    while (number_of_queued_bytes > max_number_of_queued_bytes &&
+           !state.max_number_of_queued_bytes.compare_exchange_weak(max_number_of_queued_bytes,
+                                                                   number_of_queued_bytes)) {
+    }
+  } else {
+    std::unique_lock lock(state.mutex);
+    // waiting before the start would block the sender of this party or other parties forever
+    const auto fits = [this, &state, &queue, number_of_bytes] {
+      const std::size_t max_queued_bytes{max_queued_bytes_};
+      return max_queued_bytes == 0 || !is_started_ || state.number_of_queued_bytes == 0 ||
+             state.number_of_queued_bytes + number_of_bytes <= max_queued_bytes ||
+             queue.IsClosed();
+    };
+    if (wait_for_space && !fits()) {
+      ++state.number_of_blocked_sends;
+      state.condition_variable.wait(lock, fits);
+    }
+    state.number_of_queued_bytes += number_of_bytes;
+    if (state.number_of_queued_bytes > state.max_number_of_queued_bytes) {
+      state.max_number_of_queued_bytes = state.number_of_queued_bytes.load();
+    }
+  }
+  queue.enqueue(std::move(message));
+  NotifySend(party_id);
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::RelayBroadcast(
+    std::size_t origin_id, std::shared_ptr<const SerializedMessage> message) {
+  // the parties are ranked relative to the origin, whose rank is 0, and the children of rank r
+  // are the ranks kRelayFanout * r + 1, ..., kRelayFanout * r + kRelayFanout
+  const auto rank{(my_id_ + number_of_parties_ - origin_id) % number_of_parties_};
+  for (std::size_t i = 1; i <= kRelayFanout; ++i) {
+    const auto child_rank{kRelayFanout * rank + i};
+    if (child_rank >= number_of_parties_) {
       break;
-    } else if (message_type == MessageType::kSynchronizationMessage) {
-      message_manager.GetSyncStates(party_id).enqueue(std::move(raw_message));
-    } else {
-      assert(!message_manager.GetMessagePromises(party_id).empty());
-      assert(message_manager.GetMessagePromises(party_id).contains(message_type));
-      assert(message_manager.GetMessagePromises(party_id)[message_type].contains(message_id));
-      message_manager.GetMessagePromises(party_id)[message_type][message_id]->set_value(
-          std::move(raw_message));
     }
+    const auto child_id{(origin_id + child_rank) % number_of_parties_};
+    auto& queue{send_queues_.at(child_id)};
+    if (queue.IsClosed()) {
+      if (logger_) {
+        logger_->LogError(fmt::format(
+            "cannot relay broadcast of party {} to party {} after shutdown", origin_id, child_id));
+      }
+      continue;
+    }
+    EnqueueMessage(child_id, message, false);
   }
+}
 
-  if constexpr (kDebug) {
+void CommunicationLayer::CommunicationLayerImplementation::RecordSentMessages(
+    std::size_t party_id, const OutgoingMessages& outgoing_messages) {
+  const auto now{std::chrono::steady_clock::now()};
+  auto& traffic_statistics{traffic_statistics_.at(party_id)};
+  std::scoped_lock lock(traffic_statistics.mutex);
+  for (const auto& message : outgoing_messages.messages) {
+    const auto latency{std::chrono::duration_cast<std::chrono::microseconds>(
+        now - message->GetEnqueueTime())};
+    const auto message_type{static_cast<std::size_t>(GetMessageType(message->GetSpan()))};
+    traffic_statistics.message_type_statistics[message_type].AddSentMessage(
+        message->size(), static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0)));
+  }
+  if (auto histogram{sent_message_size_histogram_.load(std::memory_order_relaxed)}) {
+    for (const auto& message : outgoing_messages.messages) {
+      histogram->Observe(message->size());
+    }
+  }
+  std::size_t number_of_bytes = 0;
+  for (const auto& message : outgoing_messages.messages) {
+    number_of_bytes += message->size();
+  }
+  auto& state{send_queue_states_.at(party_id)};
+  {
+    std::scoped_lock queue_lock(state.mutex);
+    state.number_of_queued_bytes -= number_of_bytes;
+  }
+  state.condition_variable.notify_all();
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::RecordReceivedMessage(
+    std::size_t party_id, MessageType message_type, std::size_t number_of_bytes) {
+  auto& traffic_statistics{traffic_statistics_.at(party_id)};
+  std::scoped_lock lock(traffic_statistics.mutex);
+  auto& statistics{
+      traffic_statistics.message_type_statistics[static_cast<std::size_t>(message_type)]};
+  statistics.number_of_messages_received += 1;
+  statistics.number_of_bytes_received += number_of_bytes;
+}
+
+MessageManager& CommunicationLayer::CommunicationLayerImplementation::GetSessionMessageManager(
+    std::uint32_t session_id, MessageManager& message_manager) {
+  if (session_id == 0) {
+    return message_manager;
+  }
+  return *GetSessionMessageManager(session_id);
+}
+
+std::shared_ptr<MessageManager>
+CommunicationLayer::CommunicationLayerImplementation::GetSessionMessageManager(
+    std::uint32_t session_id) {
+  std::scoped_lock lock(sessions_mutex_);
+  auto& session_message_manager{session_message_managers_[session_id]};
+  if (!session_message_manager) {
+    session_message_manager = std::make_shared<MessageManager>(number_of_parties_, my_id_);
+  }
+  return session_message_manager;
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::TraceMessage(
+    std::size_t party_id, MessageTrace::Direction direction, MessageType message_type,
+    std::uint64_t message_id, std::size_t number_of_bytes) {
+  if (!trace_messages_) {
+    return;
+  }
+  const auto time{MessageTrace::ClockType::now()};
+  std::scoped_lock lock(message_trace_mutex_);
+  message_trace_.events.push_back(
+      {party_id, direction, message_type, message_id, number_of_bytes, time});
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::TraceSentMessage(
+    std::size_t party_id, std::span<const std::uint8_t> message) {
+  if (!trace_messages_) {
+    return;
+  }
+  if (auto header{ReadMessageFrameHeader(message)}; header.has_value()) {
+    TraceMessage(party_id, MessageTrace::Direction::kSent, header->message_type,
+                 header->message_id, message.size());
+    return;
+  }
+  auto deserialized_message{GetMessage(message.data())};
+  const auto message_type{deserialized_message->message_type()};
+  // like the clock probes, these are consumed by the communication layer and never delivered
+  if (message_type == MessageType::kSynchronizationMessage ||
+      message_type == MessageType::kTerminationMessage) {
+    return;
+  }
+  TraceMessage(party_id, MessageTrace::Direction::kSent, message_type,
+               deserialized_message->message_id(), message.size());
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::DeliverMessage(
+    std::size_t party_id, MessageManager& message_manager, MessageType message_type,
+    std::size_t message_id, MessageBuffer&& message) {
+  TraceMessage(party_id, MessageTrace::Direction::kReceived, message_type, message_id,
+               message.size());
+  if (UsesImplicitSynchronization()) {
+    auto ready_message{
+        message_manager.HoldIfAhead(party_id, message_type, message_id, std::move(message))};
+    if (!ready_message.has_value()) {
+      return;
+    }
+    message = std::move(*ready_message);
+  }
+  FulfillMessagePromise(party_id, message_manager, message_type, message_id, std::move(message));
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::FulfillMessagePromise(
+    std::size_t party_id, MessageManager& message_manager, MessageType message_type,
+    std::size_t message_id, MessageBuffer&& message) {
+  auto promise{message_manager.FindMessagePromise(party_id, message_type, message_id)};
+  if (promise == nullptr) {
     if (logger_) {
-      logger_->LogDebug(fmt::format("ReceiveTask finished for party {}", party_id));
+      logger_->LogError(
+          fmt::format("received unexpected message of type {} with id {} from party {}",
+                      EnumNameMessageType(message_type), message_id, party_id));
     }
+    return;
   }
+  promise->set_value(std::move(message));
 }
 
 void CommunicationLayer::CommunicationLayerImplementation::Shutdown() {
@@ -209,6 +1134,25 @@ void CommunicationLayer::CommunicationLayerImplementation::Shutdown() {
       continue;
     }
     send_queues_.at(party_id).close();
+    {
+      // blocked senders find the queue closed
+      std::scoped_lock lock(send_queue_states_.at(party_id).mutex);
+    }
+    send_queue_states_.at(party_id).condition_variable.notify_all();
+  }
+  if (is_event_driven_) {
+    for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+      if (party_id == my_id_) {
+        continue;
+      }
+      if (is_running_) {
+        NotifySend(party_id);
+        event_driven_states_.at(party_id).send_finished.get_future().wait();
+        event_driven_states_.at(party_id).receive_finished.get_future().wait();
+      }
+      transports_.at(party_id)->Shutdown();
+    }
+    return;
   }
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
     if (party_id == my_id_) {
@@ -241,17 +1185,53 @@ CommunicationLayer::CommunicationLayer(std::size_t my_id,
     throw std::invalid_argument(
         fmt::format("speficied invalid party id: {} >= {}", my_id, number_of_parties_));
   }
-  implementation_ = std::make_unique<CommunicationLayerImplementation>(my_id, std::move(transports),
+  implementation_ = std::make_shared<CommunicationLayerImplementation>(my_id, std::move(transports),
                                                                        *message_manager_, logger);
 }
 
+CommunicationLayer::CommunicationLayer(
+    std::shared_ptr<CommunicationLayerImplementation> implementation, std::uint32_t session_id,
+    std::size_t my_id, std::size_t number_of_parties, std::shared_ptr<Logger> logger)
+    : my_id_(my_id),
+      number_of_parties_(number_of_parties),
+      implementation_(std::move(implementation)),
+      session_id_(session_id),
+      is_started_(false),
+      is_shutdown_(false),
+      logger_(std::move(logger)),
+      message_manager_(implementation_->GetSessionMessageManager(session_id)) {}
+
 CommunicationLayer::~CommunicationLayer() { Shutdown(); }
 
+std::unique_ptr<CommunicationLayer> CommunicationLayer::CreateSession(std::uint32_t session_id) {
+  if (session_id == 0) {
+    throw std::invalid_argument("session id 0 belongs to the communication layer itself");
+  }
+  if (is_shutdown_) {
+    throw std::logic_error("cannot create a session of a communication layer that is shut down");
+  }
+  {
+    std::scoped_lock lock(implementation_->sessions_mutex_);
+    if (!implementation_->open_sessions_.insert(session_id).second) {
+      throw std::invalid_argument(fmt::format("session {} is already open", session_id));
+    }
+  }
+  // the constructor is private
+  return std::unique_ptr<CommunicationLayer>(new CommunicationLayer(
+      implementation_, session_id, my_id_, number_of_parties_, logger_));
+}
+
 void CommunicationLayer::Start() {
   if (is_started_) {
     return;
   }
-  implementation_->start_promise_.set_value();
+  std::call_once(implementation_->start_flag_, [this] {
+    implementation_->is_started_ = true;
+    implementation_->start_promise_.set_value();
+    if (implementation_->is_event_driven_) {
+      implementation_->StartEventDriven();
+    }
+  });
   is_started_ = true;
 }
 
@@ -268,6 +1248,17 @@ void CommunicationLayer::Synchronize() {
     auto message_builder = BuildMessage(MessageType::kSynchronizationMessage, s);
     BroadcastMessage(message_builder.Release());
   }
+  if (implementation_->UsesImplicitSynchronization()) {
+    // the other parties hold the messages of the next epoch until they synchronize as well, so
+    // waiting is not needed and the synchronization message travels with the next messages
+    for (auto& held_message : message_manager_->AdvanceEpoch()) {
+      implementation_->FulfillMessagePromise(held_message.sender_id, *message_manager_,
+                                             held_message.message_type, held_message.message_id,
+                                             std::move(held_message.message));
+    }
+    ++sync_state_;
+    return;
+  }
   // wait for N-1 sync messages with at least the same value
   for (auto& q : message_manager_->GetSyncStates()) {
     if constexpr (kDebug) {
@@ -290,8 +1281,24 @@ void CommunicationLayer::Synchronize() {
 }
 
 void CommunicationLayer::SendMessage(std::size_t party_id, flatbuffers::DetachedBuffer&& message) {
-  implementation_->send_queues_[party_id].enqueue(
-      std::make_shared<flatbuffers::DetachedBuffer>(std::move(message)));
+  if (session_id_ != 0) {
+    message = SetSessionId(std::move(message), session_id_);
+  }
+  implementation_->TraceSentMessage(party_id, std::span(message.data(), message.size()));
+  if (auto batch{MessageBatch::GetCollectingBatch(*this)}) {
+    batch->Add(party_id, std::span(message.data(), message.size()));
+    return;
+  }
+  EnqueueMessage(party_id, std::move(message));
+}
+
+void CommunicationLayer::EnqueueMessage(std::size_t party_id,
+                                        flatbuffers::DetachedBuffer&& message) {
+  implementation_->EnqueueMessage(
+      party_id,
+      std::make_shared<const CommunicationLayerImplementation::SerializedMessage>(
+          std::move(message)),
+      true);
 }
 
 void CommunicationLayer::BroadcastMessage(flatbuffers::DetachedBuffer&& message) {
@@ -299,10 +1306,39 @@ void CommunicationLayer::BroadcastMessage(flatbuffers::DetachedBuffer&& message)
     SendMessage(1 - my_id_, std::move(message));
     return;
   }
-  auto shared_message = std::make_shared<flatbuffers::DetachedBuffer>(std::move(message));
+  if (session_id_ != 0) {
+    message = SetSessionId(std::move(message), session_id_);
+  }
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id != my_id_) {
+      implementation_->TraceSentMessage(party_id, std::span(message.data(), message.size()));
+    }
+  }
+  if (auto batch{MessageBatch::GetCollectingBatch(*this)}) {
+    for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+      if (party_id != my_id_) {
+        batch->Add(party_id, std::span(message.data(), message.size()));
+      }
+    }
+    return;
+  }
+  if (implementation_->relay_broadcasts_ &&
+      message.size() >= CommunicationLayerImplementation::kMinRelayedBroadcastSize) {
+    auto message_builder{BuildMessage(MessageType::kRelayedBroadcast, my_id_,
+                                      std::span(message.data(), message.size()))};
+    implementation_->RelayBroadcast(
+        my_id_, std::make_shared<const CommunicationLayerImplementation::SerializedMessage>(
+                    message_builder.Release()));
+    return;
+  }
+  // a single serialized buffer is shared by all send queues
+  auto shared_message = std::make_shared<const CommunicationLayerImplementation::SerializedMessage>(
+      std::move(message));
 
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
-    if (party_id != my_id_) implementation_->send_queues_[party_id].enqueue(shared_message);
+    if (party_id != my_id_) {
+      implementation_->EnqueueMessage(party_id, shared_message, true);
+    }
   }
 }
 
@@ -310,6 +1346,13 @@ void CommunicationLayer::Shutdown() {
   if (is_shutdown_) {
     return;
   }
+  if (session_id_ != 0) {
+    // the transports are shut down by the communication layer owning them
+    std::scoped_lock lock(implementation_->sessions_mutex_);
+    implementation_->open_sessions_.erase(session_id_);
+    is_shutdown_ = true;
+    return;
+  }
   auto message_builder = BuildMessage(MessageType::kTerminationMessage);
   BroadcastMessage(message_builder.Release());
   if constexpr (kDebug) {
@@ -328,18 +1371,348 @@ std::vector<TransportStatistics> CommunicationLayer::GetTransportStatistics() co
     if (party_id == my_id_) {
       continue;
     }
-    statistics.emplace_back(implementation_->transports_.at(party_id)->GetStatistics());
+    auto& transport_statistics{
+        statistics.emplace_back(implementation_->transports_.at(party_id)->GetStatistics())};
+    const auto& compression_statistics{implementation_->compression_statistics_.at(party_id)};
+    transport_statistics.number_of_uncompressed_bytes_sent =
+        compression_statistics.number_of_uncompressed_bytes_sent;
+    transport_statistics.number_of_compressed_bytes_sent =
+        compression_statistics.number_of_compressed_bytes_sent;
+    transport_statistics.number_of_uncompressed_bytes_received =
+        compression_statistics.number_of_uncompressed_bytes_received;
+    transport_statistics.number_of_compressed_bytes_received =
+        compression_statistics.number_of_compressed_bytes_received;
+    auto& traffic_statistics{implementation_->traffic_statistics_.at(party_id)};
+    std::scoped_lock lock(traffic_statistics.mutex);
+    transport_statistics.message_type_statistics = traffic_statistics.message_type_statistics;
+    const auto& send_queue_state{implementation_->send_queue_states_.at(party_id)};
+    transport_statistics.max_number_of_queued_bytes = send_queue_state.max_number_of_queued_bytes;
+    transport_statistics.number_of_blocked_sends = send_queue_state.number_of_blocked_sends;
   }
   return statistics;
 }
 
+void CommunicationLayer::RegisterMetrics(const std::shared_ptr<MetricsRegistry>& registry) {
+  // the metrics of the shared transports are exposed by the communication layer owning them
+  if (session_id_ != 0) {
+    return;
+  }
+  const auto my_id{std::to_string(my_id_)};
+  implementation_->sent_message_size_histogram_ =
+      &registry->GetHistogram("motion_sent_message_size_bytes",
+                              "Size of the messages written to the transports", {{"party", my_id}});
+  auto collect = [implementation = implementation_.get(), my_id](MetricsSnapshot& snapshot) {
+    for (std::size_t party_id = 0; party_id < implementation->number_of_parties_; ++party_id) {
+      if (party_id == implementation->my_id_) {
+        continue;
+      }
+      const MetricLabels labels{{"party", my_id}, {"peer", std::to_string(party_id)}};
+      snapshot.AddGauge("motion_send_queue_depth", "Messages waiting to be sent to the peer",
+                        labels, implementation->send_queues_.at(party_id).size());
+      const auto& send_queue_state{implementation->send_queue_states_.at(party_id)};
+      snapshot.AddGauge("motion_send_queue_bytes", "Bytes waiting to be sent to the peer", labels,
+                        send_queue_state.number_of_queued_bytes);
+      snapshot.AddGauge("motion_send_queue_max_bytes",
+                        "High-water mark of the bytes waiting to be sent to the peer", labels,
+                        send_queue_state.max_number_of_queued_bytes);
+      snapshot.AddCounter("motion_blocked_sends",
+                          "Messages whose sender waited for space in the send queue", labels,
+                          send_queue_state.number_of_blocked_sends);
+      auto& traffic_statistics{implementation->traffic_statistics_.at(party_id)};
+      std::scoped_lock lock(traffic_statistics.mutex);
+      for (const auto& [type, statistics] : traffic_statistics.message_type_statistics) {
+        auto type_labels{labels};
+        type_labels.emplace_back("type", to_string(static_cast<MessageType>(type)));
+        snapshot.AddCounter("motion_messages_sent", "Messages sent to the peer", type_labels,
+                            statistics.number_of_messages_sent);
+        snapshot.AddCounter("motion_messages_received", "Messages received from the peer",
+                            type_labels, statistics.number_of_messages_received);
+        snapshot.AddCounter("motion_message_bytes_sent", "Bytes of the messages sent to the peer",
+                            type_labels, statistics.number_of_bytes_sent);
+        snapshot.AddCounter("motion_message_bytes_received",
+                            "Bytes of the messages received from the peer", type_labels,
+                            statistics.number_of_bytes_received);
+      }
+    }
+  };
+  // captures the implementation, which destroys the collector before its members
+  implementation_->metrics_collector_ = registry->AddCollector(std::move(collect));
+}
+
+void CommunicationLayer::SetRelayBroadcasts(bool value) {
+  implementation_->relay_broadcasts_ = value;
+}
+
+void CommunicationLayer::SetMessageCompression(MessageType message_type,
+                                               MessageCompression compression) {
+  implementation_->message_compression_[static_cast<std::size_t>(message_type)] = compression;
+}
+
+void CommunicationLayer::SetMessagePrioritization(bool value) {
+  implementation_->prioritize_messages_ = value;
+}
+
+void CommunicationLayer::SetMessageTracing(bool value) {
+  implementation_->trace_messages_ = value;
+}
+
+MessageTrace CommunicationLayer::TakeMessageTrace() {
+  std::scoped_lock lock(implementation_->message_trace_mutex_);
+  return std::exchange(implementation_->message_trace_, MessageTrace{});
+}
+
+std::vector<std::array<std::int64_t, 4>>
+CommunicationLayer::CommunicationLayerImplementation::ProbeClocks(std::size_t probe,
+                                                                  std::size_t payload_size) {
+  assert(payload_size >= sizeof(std::int64_t) && payload_size != 3 * sizeof(std::int64_t));
+  // the padding of bandwidth probes should not be compressible
+  std::vector<std::uint8_t> payload(payload_size);
+  std::mt19937_64 padding(probe);
+  for (std::size_t i = sizeof(std::int64_t); i < payload_size; ++i) {
+    payload[i] = static_cast<std::uint8_t>(padding());
+  }
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    const auto send_time{ToNanoseconds(std::chrono::steady_clock::now())};
+    std::memcpy(payload.data(), &send_time, sizeof(send_time));
+    auto message_builder{BuildMessage(MessageType::kClockProbe, probe, payload)};
+    // bypass the message trace, the probes are no messages of the protocol
+    EnqueueMessage(party_id, std::make_shared<const SerializedMessage>(message_builder.Release()),
+                   false);
+  }
+  std::vector<std::array<std::int64_t, 4>> times(number_of_parties_);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    auto response{clock_probe_responses_.at(party_id).dequeue()};
+    if (!response.has_value()) {
+      throw std::runtime_error(
+          fmt::format("no response to the clock probe {} of party {}", probe, party_id));
+    }
+    times.at(party_id) = *response;
+  }
+  return times;
+}
+
+std::vector<std::chrono::nanoseconds> CommunicationLayer::EstimateClockOffsets(
+    std::size_t number_of_probes) {
+  if (session_id_ != 0) {
+    throw std::logic_error("clock offsets can only be estimated by the communication layer "
+                           "owning the transports");
+  }
+  if (number_of_probes == 0) {
+    throw std::invalid_argument("at least one clock probe is needed to estimate clock offsets");
+  }
+  std::vector<std::chrono::nanoseconds> offsets(number_of_parties_);
+  std::vector<std::chrono::nanoseconds> min_delays(number_of_parties_,
+                                                   std::chrono::nanoseconds::max());
+  for (std::size_t probe = 0; probe < number_of_probes; ++probe) {
+    const auto times{implementation_->ProbeClocks(probe, sizeof(std::int64_t))};
+    for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+      if (party_id == my_id_) {
+        continue;
+      }
+      const auto [t0, t1, t2, t3]{times.at(party_id)};
+      // the round trip without the time the probe spent at the other party
+      const std::chrono::nanoseconds delay{(t3 - t0) - (t2 - t1)};
+      if (delay < min_delays.at(party_id)) {
+        min_delays.at(party_id) = delay;
+        offsets.at(party_id) = std::chrono::nanoseconds(((t1 - t0) + (t2 - t3)) / 2);
+      }
+    }
+  }
+  Synchronize();
+  return offsets;
+}
+
+std::vector<std::vector<LinkParameters>> CommunicationLayer::MeasureLinks(
+    std::size_t number_of_probes, std::size_t bandwidth_probe_size) {
+  if (session_id_ != 0) {
+    throw std::logic_error(
+        "links can only be measured by the communication layer owning the transports");
+  }
+  if (number_of_probes == 0) {
+    throw std::invalid_argument("at least one probe is needed to measure the links");
+  }
+  // a padded probe must not be mistaken for a response
+  bandwidth_probe_size = std::max(bandwidth_probe_size, 4 * sizeof(std::int64_t));
+
+  std::vector<MessageManager::future_type> report_futures(number_of_parties_);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id != my_id_) {
+      report_futures.at(party_id) =
+          message_manager_->RegisterReceive(party_id, MessageType::kLinkReport, 0);
+    }
+  }
+  // the reports of the other parties may only arrive once this party has registered for them
+  Synchronize();
+
+  std::vector<LinkParameters> my_links(number_of_parties_);
+  std::vector<std::chrono::nanoseconds> min_delays(number_of_parties_,
+                                                   std::chrono::nanoseconds::max());
+  for (std::size_t probe = 0; probe < number_of_probes; ++probe) {
+    const auto times{implementation_->ProbeClocks(probe, sizeof(std::int64_t))};
+    for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+      if (party_id == my_id_) {
+        continue;
+      }
+      const auto [t0, t1, t2, t3]{times.at(party_id)};
+      min_delays.at(party_id) =
+          std::min(min_delays.at(party_id), std::chrono::nanoseconds((t3 - t0) - (t2 - t1)));
+    }
+  }
+  const auto times{implementation_->ProbeClocks(number_of_probes, bandwidth_probe_size)};
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    const auto [t0, t1, t2, t3]{times.at(party_id)};
+    // the time the probe needed beyond a small one, at least a microsecond against noise
+    const std::chrono::nanoseconds transfer_time{std::max<std::int64_t>(
+        (t3 - t0) - (t2 - t1) - min_delays.at(party_id).count(), 1'000)};
+    my_links.at(party_id).round_trip_time = min_delays.at(party_id);
+    my_links.at(party_id).bytes_per_second =
+        static_cast<double>(bandwidth_probe_size) * 1e9 / transfer_time.count();
+  }
+
+  // the report is [rtt_0 || bandwidth_0 || ... || rtt_last || bandwidth_last] with the round trip
+  // times as 8-byte nanoseconds and the bandwidths as doubles
+  constexpr std::size_t kEntrySize{sizeof(std::int64_t) + sizeof(double)};
+  std::vector<std::uint8_t> report(number_of_parties_ * kEntrySize);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    const std::int64_t round_trip_time{my_links.at(party_id).round_trip_time.count()};
+    std::memcpy(report.data() + party_id * kEntrySize, &round_trip_time, sizeof(std::int64_t));
+    std::memcpy(report.data() + party_id * kEntrySize + sizeof(std::int64_t),
+                &my_links.at(party_id).bytes_per_second, sizeof(double));
+  }
+  BroadcastMessage(BuildMessage(MessageType::kLinkReport, 0, report).Release());
+
+  std::vector<std::vector<LinkParameters>> links(number_of_parties_);
+  links.at(my_id_) = std::move(my_links);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    const auto message{report_futures.at(party_id).get()};
+    const auto payload{GetMessage(message.data())->payload()};
+    if (payload == nullptr || payload->size() != report.size()) {
+      throw std::runtime_error(fmt::format("received corrupt link report from party {}", party_id));
+    }
+    auto& row{links.at(party_id)};
+    row.resize(number_of_parties_);
+    for (std::size_t other_id = 0; other_id < number_of_parties_; ++other_id) {
+      std::int64_t round_trip_time;
+      std::memcpy(&round_trip_time, payload->data() + other_id * kEntrySize,
+                  sizeof(std::int64_t));
+      row.at(other_id).round_trip_time = std::chrono::nanoseconds(round_trip_time);
+      std::memcpy(&row.at(other_id).bytes_per_second,
+                  payload->data() + other_id * kEntrySize + sizeof(std::int64_t), sizeof(double));
+    }
+  }
+  // both ends of a link agree on the worse of their measurements
+  for (std::size_t i = 0; i < number_of_parties_; ++i) {
+    for (std::size_t j = i + 1; j < number_of_parties_; ++j) {
+      auto& forward{links.at(i).at(j)};
+      auto& backward{links.at(j).at(i)};
+      forward.round_trip_time = backward.round_trip_time =
+          std::max(forward.round_trip_time, backward.round_trip_time);
+      forward.bytes_per_second = backward.bytes_per_second =
+          std::min(forward.bytes_per_second, backward.bytes_per_second);
+    }
+  }
+  return links;
+}
+
+void CommunicationLayer::SetImplicitSynchronization(bool value) {
+  implementation_->implicit_synchronization_ = value;
+}
+
+void CommunicationLayer::SetMessagePriority(MessageType message_type, MessagePriority priority) {
+  implementation_->message_priorities_[static_cast<std::size_t>(message_type)] = priority;
+}
+
+void CommunicationLayer::SetSendQueueLimit(std::size_t max_number_of_bytes) {
+  implementation_->max_queued_bytes_ = max_number_of_bytes;
+  for (auto& state : implementation_->send_queue_states_) {
+    {
+      std::scoped_lock lock(state.mutex);
+    }
+    state.condition_variable.notify_all();
+  }
+}
+
+void CommunicationLayer::SetSendBudget(std::size_t max_number_of_bytes,
+                                       std::chrono::microseconds max_delay) {
+  implementation_->max_send_bytes_ = max_number_of_bytes;
+  implementation_->max_send_delay_us_ = max_delay.count();
+}
+
 void CommunicationLayer::SetLogger(std::shared_ptr<Logger> logger) {
   if (is_started_) {
     throw std::logic_error(
         "changing the logger is not allowed after the CommunicationLayer has been started");
   }
   logger_ = logger;
-  implementation_->logger_ = logger;
+  if (session_id_ == 0) {
+    implementation_->logger_ = logger;
+  }
+}
+
+// The batch whose scope the current fiber holds. Fiber-specific since fibers may migrate between
+// threads, looked up only while some fiber holds a scope.
+static boost::fibers::fiber_specific_ptr<MessageBatch> collecting_batch(nullptr);
+static std::atomic<std::size_t> number_of_batch_scopes{0};
+
+MessageBatch::MessageBatch(CommunicationLayer& communication_layer)
+    : communication_layer_(communication_layer),
+      payloads_(communication_layer.GetNumberOfParties()) {}
+
+MessageBatch::Scope::Scope(MessageBatch& batch) : previous_batch_(collecting_batch.get()) {
+  ++number_of_batch_scopes;
+  collecting_batch.reset(&batch);
+}
+
+MessageBatch::Scope::~Scope() {
+  collecting_batch.reset(previous_batch_);
+  --number_of_batch_scopes;
+}
+
+MessageBatch* MessageBatch::GetCollectingBatch(const CommunicationLayer& communication_layer) {
+  if (number_of_batch_scopes == 0) {
+    return nullptr;
+  }
+  auto batch{collecting_batch.get()};
+  return batch != nullptr && &batch->communication_layer_ == &communication_layer ? batch
+                                                                                   : nullptr;
+}
+
+void MessageBatch::Add(std::size_t party_id, std::span<const std::uint8_t> message) {
+  assert(message.size() <= std::numeric_limits<std::uint32_t>::max());
+  const auto size = static_cast<std::uint32_t>(message.size());
+  std::scoped_lock lock(mutex_);
+  auto& payload{payloads_.at(party_id)};
+  const auto offset = payload.size();
+  payload.resize(offset + sizeof(size) + message.size());
+  std::copy_n(reinterpret_cast<const std::uint8_t*>(&size), sizeof(size), payload.data() + offset);
+  std::copy_n(message.data(), message.size(), payload.data() + offset + sizeof(size));
+}
+
+void MessageBatch::Send() {
+  std::vector<std::vector<std::uint8_t>> payloads(payloads_.size());
+  {
+    std::scoped_lock lock(mutex_);
+    payloads.swap(payloads_);
+  }
+  for (std::size_t party_id = 0; party_id < payloads.size(); ++party_id) {
+    if (!payloads[party_id].empty()) {
+      // the messages were traced when they were added
+      auto message_builder{BuildMessage(MessageType::kMessageBatch, payloads[party_id])};
+      communication_layer_.EnqueueMessage(party_id, message_builder.Release());
+    }
+  }
 }
 
 std::vector<std::unique_ptr<CommunicationLayer>> MakeDummyCommunicationLayers(
@@ -392,4 +1765,27 @@ std::vector<std::unique_ptr<CommunicationLayer>> MakeLocalTcpCommunicationLayers
   return communication_layers;
 }
 
+std::vector<std::unique_ptr<CommunicationLayer>> MakeSharedMemoryCommunicationLayers(
+    std::size_t number_of_parties) {
+  // segment names need to be unique among all concurrently running sets of parties
+  static std::atomic<std::size_t> session_counter{0};
+  const auto session_name = fmt::format("motion-{}-{}", getpid(), session_counter++);
+  std::vector<std::future<std::vector<std::unique_ptr<Transport>>>> futures;
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    futures.emplace_back(
+        std::async(std::launch::async, [party_id, number_of_parties, &session_name] {
+          SharedMemorySetupHelper helper(party_id, number_of_parties, session_name);
+          return helper.SetupConnections();
+        }));
+  }
+  std::vector<std::unique_ptr<CommunicationLayer>> communication_layers;
+  communication_layers.reserve(number_of_parties);
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    auto transports = futures.at(party_id).get();
+    communication_layers.emplace_back(
+        std::make_unique<CommunicationLayer>(party_id, std::move(transports)));
+  }
+  return communication_layers;
+}
+
 }  // namespace encrypto::motion::communication
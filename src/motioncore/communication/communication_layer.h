@@ -24,8 +24,11 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <span>
 #include <vector>
 
@@ -39,12 +42,16 @@
 #endif
 
 #include "fbs_headers/message_generated.h"
+#include "message_compression.h"
+#include "message_priority.h"
+#include "message_trace.h"
 #include "transport.h"
 #include "utility/reusable_future.h"
 
 namespace encrypto::motion {
 
 class Logger;
+class MetricsRegistry;
 
 }  // namespace encrypto::motion
 
@@ -53,6 +60,12 @@ namespace encrypto::motion::communication {
 class MessageManager;
 struct TransportStatistics;
 
+// round trip time and bandwidth of the link between two parties, see MeasureLinks
+struct LinkParameters {
+  std::chrono::nanoseconds round_trip_time{0};
+  double bytes_per_second{0.0};
+};
+
 // Central interface for all communication related functionality
 //
 // Allows to send messages to other parties and to register handlers for
@@ -72,6 +85,8 @@ class CommunicationLayer {
 
   // Start communication
   void Start();
+  // Wait until all parties have called Synchronize as often as this party, or only mark the end of
+  // an epoch if implicit synchronization is enabled, see SetImplicitSynchronization
   void Synchronize();
 
   // Send a message to a specified party
@@ -85,18 +100,103 @@ class CommunicationLayer {
 
   std::vector<TransportStatistics> GetTransportStatistics() const noexcept;
 
+  // Broadcast large messages along a tree of the parties rooted at the sender, in which every
+  // party forwards them to its children, instead of sending them to all other parties directly.
+  // This relieves the uplink of the sender for large numbers of parties.
+  void SetRelayBroadcasts(bool value);
+
+  // Compress messages of the given type before sending them, see MessageCompression
+  void SetMessageCompression(MessageType message_type, MessageCompression compression);
+
+  // Send the messages pending for a party by their MessagePriority instead of in the order in which
+  // they were enqueued, such that latency critical messages do not wait behind bulk traffic.
+  // Messages of the same priority are sent in order, larger messages in fragments of 64 KiB, of
+  // which each write takes up to 8, 4, and 1 for high, normal, and bulk priority, respectively.
+  // The byte limit of SetSendBudget does not apply to prioritized messages.
+  void SetMessagePrioritization(bool value);
+
+  // Let Synchronize return without waiting for the other parties.  Instead, the messages of a party
+  // following its n-th synchronization message are held by the receiver until it has called
+  // Synchronize n times itself, so that they reach the receives registered after the
+  // synchronization.  This saves the round trip of each synchronization, since its message is sent
+  // together with the following messages of the epoch.  All parties need to enable it before their
+  // first synchronization.  It applies to the sessions of this communication layer too, and it is
+  // ignored while message prioritization or relayed broadcasts are enabled, which reorder messages.
+  void SetImplicitSynchronization(bool value);
+
+  // Schedule messages of the given type with the given priority, see SetMessagePrioritization
+  void SetMessagePriority(MessageType message_type, MessagePriority priority);
+
+  // Bound the bytes waiting to be sent to each party, 0 for unbounded send queues (the default).
+  // Once the communication is started, SendMessage and BroadcastMessage block the calling fiber
+  // or thread while the message does not fit into the queue, such that producers are throttled
+  // to the speed of the network.  An empty queue accepts messages of any size and relayed
+  // broadcasts are never blocked.
+  void SetSendQueueLimit(std::size_t max_number_of_bytes);
+
+  // Send the messages pending for a party in vectored writes of at most max_number_of_bytes each,
+  // waiting up to max_delay for further messages if less than max_number_of_bytes are pending
+  void SetSendBudget(std::size_t max_number_of_bytes, std::chrono::microseconds max_delay);
+
+  // Record the time of every message sent and delivered through this communication layer and its
+  // sessions, e.g., to merge the timelines of all parties, see PartyTimeline
+  void SetMessageTracing(bool value);
+
+  // Returns the messages recorded since message tracing was enabled or the last call and clears
+  // them.
+  MessageTrace TakeMessageTrace();
+
+  // Estimate the offsets of the steady clocks of the other parties to the clock of this party from
+  // number_of_probes round trips with each of them, taking the round trip with the shortest delay
+  // as in NTP. The offset of party i is the time of its clock minus the time of the clock of this
+  // party at the same instant, so an offset of 0 is returned for this party. All parties need to
+  // call it, which synchronizes them at the end. It cannot be called on sessions.
+  std::vector<std::chrono::nanoseconds> EstimateClockOffsets(std::size_t number_of_probes = 8);
+
+  // Measure the links between all parties, taking the shortest of number_of_probes round trips
+  // as round trip time and the time to receive bandwidth_probe_size bytes beyond it for the
+  // bandwidth. The parties exchange their measurements, such that all of them return the same
+  // matrix, in which the link between i and j has the longer round trip time and the lower
+  // bandwidth measured by i and j. All parties need to call it, which synchronizes them. It cannot
+  // be called on sessions.
+  std::vector<std::vector<LinkParameters>> MeasureLinks(
+      std::size_t number_of_probes = 8, std::size_t bandwidth_probe_size = 1 << 20);
+
+  // Expose the traffic per message type, the depth of the send queues, and the sizes of the sent
+  // messages in the registry as long as the communication layer exists, see MetricsRegistry
+  void RegisterMetrics(const std::shared_ptr<MetricsRegistry>& registry);
+
   auto GetLogger() { return logger_; }
 
   void SetLogger(std::shared_ptr<Logger> logger);
 
   MessageManager& GetMessageManager() { return *message_manager_; }
 
+  // Create the communication layer of an independent session, e.g., of a Backend serving another
+  // query concurrently, which shares the transports and the send and receive threads of this one.
+  // Its messages carry session_id and are routed to a MessageManager of its own, such that the
+  // message ids of the sessions do not collide. All parties need to create the session with the
+  // same id, which needs to be unique among the open sessions and not 0. The session does not
+  // send termination messages and needs to be destroyed before this communication layer.
+  std::unique_ptr<CommunicationLayer> CreateSession(std::uint32_t session_id);
+
+  std::uint32_t GetSessionId() const noexcept { return session_id_; }
+
  private:
   struct CommunicationLayerImplementation;
+  friend class MessageBatch;
+
+  // enqueues the message for the party without tracing it, e.g., a MessageBatch of traced messages
+  void EnqueueMessage(std::size_t party_id, flatbuffers::DetachedBuffer&& message);
+
+  CommunicationLayer(std::shared_ptr<CommunicationLayerImplementation> implementation,
+                     std::uint32_t session_id, std::size_t my_id, std::size_t number_of_parties,
+                     std::shared_ptr<Logger> logger);
 
   std::size_t my_id_;
   std::size_t number_of_parties_;
-  std::unique_ptr<CommunicationLayerImplementation> implementation_;
+  std::shared_ptr<CommunicationLayerImplementation> implementation_;
+  std::uint32_t session_id_{0};
   bool is_started_;
   bool is_shutdown_;
   std::shared_ptr<Logger> logger_;
@@ -105,6 +205,48 @@ class CommunicationLayer {
   std::size_t sync_state_{0};
 };
 
+// Messages to the other parties that are sent as a single kMessageBatch message per party, e.g.,
+// the openings of all multiplications of a circuit layer. While a fiber holds a Scope of the
+// batch, SendMessage and BroadcastMessage of the communication layer add the messages of the fiber
+// to the batch instead of enqueueing them, such that the fibers evaluating different gates can
+// fill the same batch. The receiver delivers the messages of a batch as if they were sent alone.
+class MessageBatch {
+ public:
+  explicit MessageBatch(CommunicationLayer& communication_layer);
+
+  // Collects the messages that the calling fiber sends via the communication layer of the batch
+  // until the scope is destroyed
+  class Scope {
+   public:
+    explicit Scope(MessageBatch& batch);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+
+   private:
+    MessageBatch* previous_batch_;
+  };
+
+  // Enqueues the collected messages, one kMessageBatch message for each party with messages, and
+  // empties the batch for the next ones
+  void Send();
+
+ private:
+  friend class CommunicationLayer;
+
+  // returns the batch of the calling fiber's scope if it collects the messages of the given
+  // communication layer, e.g., not of a session of it, and nullptr otherwise
+  static MessageBatch* GetCollectingBatch(const CommunicationLayer& communication_layer);
+
+  void Add(std::size_t party_id, std::span<const std::uint8_t> message);
+
+  CommunicationLayer& communication_layer_;
+  // only held for appending a message, hence it never blocks across a fiber switch
+  std::mutex mutex_;
+  // the size of each collected message followed by the message, for each party
+  std::vector<std::vector<std::uint8_t>> payloads_;
+};
+
 // Create a set of communication layers connected by dummy transports
 std::vector<std::unique_ptr<CommunicationLayer>> MakeDummyCommunicationLayers(
     std::size_t number_of_parties);
@@ -113,4 +255,8 @@ std::vector<std::unique_ptr<CommunicationLayer>> MakeDummyCommunicationLayers(
 std::vector<std::unique_ptr<CommunicationLayer>> MakeLocalTcpCommunicationLayers(
     std::size_t number_of_parties, bool ipv6 = true);
 
+// Create a set of communication layers connected by shared memory transports
+std::vector<std::unique_ptr<CommunicationLayer>> MakeSharedMemoryCommunicationLayers(
+    std::size_t number_of_parties);
+
 }  // namespace encrypto::motion::communication
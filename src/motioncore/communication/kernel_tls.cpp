@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "kernel_tls.h"
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/format.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+namespace encrypto::motion::communication::detail {
+
+// append the queued OpenSSL errors to what
+[[noreturn]] static void ThrowTlsError(const std::string& what) {
+  std::string message{what};
+  while (auto error = ERR_get_error()) {
+    std::array<char, 256> buffer;
+    ERR_error_string_n(error, buffer.data(), buffer.size());
+    message += fmt::format(": {}", buffer.data());
+  }
+  throw std::runtime_error(message);
+}
+
+struct KernelTlsContext::Implementation {
+  struct ContextDeleter {
+    void operator()(SSL_CTX* context) const { SSL_CTX_free(context); }
+  };
+
+  std::unique_ptr<SSL_CTX, ContextDeleter> context;
+};
+
+KernelTlsContext::KernelTlsContext(const TcpTlsConfiguration& configuration)
+    : implementation_(std::make_unique<Implementation>()) {
+  implementation_->context.reset(SSL_CTX_new(TLS_method()));
+  auto* context = implementation_->context.get();
+  if (context == nullptr) {
+    ThrowTlsError("cannot create TLS context");
+  }
+  SSL_CTX_set_min_proto_version(context, TLS1_2_VERSION);
+#if OPENSSL_VERSION_NUMBER < 0x30200000L
+  // older versions hand only the sending direction of TLS 1.3 connections to the kernel
+  SSL_CTX_set_max_proto_version(context, TLS1_2_VERSION);
+#endif
+  // the kernel supports these ciphers, and session tickets after the handshake would arrive as
+  // records that the kernel passes up instead of decrypting them
+  SSL_CTX_set_options(context, SSL_OP_ENABLE_KTLS | SSL_OP_NO_TICKET | SSL_OP_NO_COMPRESSION);
+  SSL_CTX_set_num_tickets(context, 0);
+  if (SSL_CTX_set_cipher_list(context,
+                              "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+                              "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384") != 1 ||
+      SSL_CTX_set_ciphersuites(context, "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384") != 1) {
+    ThrowTlsError("cannot select the TLS ciphers");
+  }
+  if (SSL_CTX_use_certificate_chain_file(context, configuration.certificate_file.c_str()) != 1) {
+    ThrowTlsError(fmt::format("cannot load certificate {}", configuration.certificate_file));
+  }
+  if (SSL_CTX_use_PrivateKey_file(context, configuration.private_key_file.c_str(),
+                                  SSL_FILETYPE_PEM) != 1 ||
+      SSL_CTX_check_private_key(context) != 1) {
+    ThrowTlsError(fmt::format("cannot load private key {}", configuration.private_key_file));
+  }
+  if (SSL_CTX_load_verify_locations(context, configuration.certificate_authority_file.c_str(),
+                                    nullptr) != 1) {
+    ThrowTlsError(fmt::format("cannot load certificate authorities {}",
+                              configuration.certificate_authority_file));
+  }
+  SSL_CTX_set_verify(context, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+}
+
+KernelTlsContext::~KernelTlsContext() = default;
+
+void KernelTlsContext::Handshake(int socket, bool is_server, std::size_t other_id) const {
+  struct SslDeleter {
+    void operator()(SSL* ssl) const { SSL_free(ssl); }
+  };
+  std::unique_ptr<SSL, SslDeleter> ssl(SSL_new(implementation_->context.get()));
+  if (!ssl) {
+    ThrowTlsError("cannot create TLS connection");
+  }
+  // the socket stays owned by the transport
+  auto* bio = BIO_new_socket(socket, BIO_NOCLOSE);
+  if (bio == nullptr) {
+    ThrowTlsError("cannot create TLS socket BIO");
+  }
+  SSL_set_bio(ssl.get(), bio, bio);
+  const auto result = is_server ? SSL_accept(ssl.get()) : SSL_connect(ssl.get());
+  if (result != 1) {
+    ThrowTlsError(fmt::format("TLS handshake with party {} failed (error {})", other_id,
+                              SSL_get_error(ssl.get(), result)));
+  }
+  if (!BIO_get_ktls_send(SSL_get_wbio(ssl.get())) || !BIO_get_ktls_recv(SSL_get_rbio(ssl.get()))) {
+    throw std::runtime_error(fmt::format(
+        "kernel TLS is not available for the connection to party {}, is the tls module loaded?",
+        other_id));
+  }
+  // the kernel holds the keys now, and freeing the connection does not send a close_notify alert
+}
+
+}  // namespace encrypto::motion::communication::detail
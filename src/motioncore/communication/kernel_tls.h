@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace encrypto::motion::communication {
+
+// Certificates for TLS-protected TCP connections, see TcpSetupHelper::SetTlsConfiguration.  All
+// files are in PEM format.
+struct TcpTlsConfiguration {
+  // certificate chain and private key of this party
+  std::string certificate_file;
+  std::string private_key_file;
+  // certificate authorities by which the certificates of the other parties must be issued
+  std::string certificate_authority_file;
+};
+
+namespace detail {
+
+// Runs mutually authenticated TLS handshakes with OpenSSL and hands the record layer of the
+// connection to the kernel (kTLS) afterwards.  Then, plain reads and writes on the socket are
+// decrypted and encrypted by the kernel, or by the NIC if it supports TLS offload and the offload
+// is enabled, e.g., via ethtool, so no user-space copy is added to the data path.
+class KernelTlsContext {
+ public:
+  explicit KernelTlsContext(const TcpTlsConfiguration& configuration);
+  ~KernelTlsContext();
+
+  KernelTlsContext(const KernelTlsContext&) = delete;
+  KernelTlsContext& operator=(const KernelTlsContext&) = delete;
+
+  // Run the handshake on the connected blocking socket, as server if is_server is set.
+  // Throws a std::runtime_error if the handshake fails or the kernel does not take over both
+  // directions, e.g., because the tls kernel module is not loaded.
+  void Handshake(int socket, bool is_server, std::size_t other_id) const;
+
+ private:
+  struct Implementation;
+
+  std::unique_ptr<Implementation> implementation_;
+};
+
+}  // namespace detail
+
+}  // namespace encrypto::motion::communication
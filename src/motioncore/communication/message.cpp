@@ -24,11 +24,36 @@
 
 #include "message.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
 #include "fbs_headers/message_generated.h"
+#include "utility/constants.h"
 #include "utility/typedefs.h"
 
 namespace encrypto::motion::communication {
 
+// prepend a frame header to a finished message
+static void FrameMessage(flatbuffers::FlatBufferBuilder& fbb, MessageType message_type,
+                         std::size_t message_id) {
+  if constexpr (!kFrameBulkMessages) {
+    return;
+  }
+  if (!IsBulkMessageType(message_type)) {
+    return;
+  }
+  MessageFrameHeader header{.magic = MessageFrameHeader::kMagic,
+                            .length = fbb.GetSize(),
+                            .message_type = message_type,
+                            .reserved = {},
+                            .session_id = 0,
+                            .message_id = message_id};
+  // the builder grows towards the front of the buffer
+  fbb.PushBytes(reinterpret_cast<const std::uint8_t*>(&header), sizeof(header));
+}
+
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type) {
   auto allocation_size = 32;
   flatbuffers::FlatBufferBuilder fbb(allocation_size);
@@ -39,18 +64,33 @@ flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type) {
   return fbb;
 }
 
+OutgoingMessage::OutgoingMessage(MessageType message_type, std::size_t message_id,
+                                 std::size_t payload_size)
+    : builder_(payload_size + 20 + sizeof(MessageFrameHeader)),
+      message_type_(message_type),
+      message_id_(message_id) {
+  std::uint8_t* payload;
+  payload_vector_ = builder_.CreateUninitializedVector<std::uint8_t>(payload_size, &payload);
+  payload_ = std::span(payload, payload_size);
+}
+
+flatbuffers::FlatBufferBuilder OutgoingMessage::Finish() && {
+  MessageBuilder message_builder(builder_);
+  message_builder.add_message_id(message_id_);
+  message_builder.add_payload(payload_vector_);
+  message_builder.add_message_type(message_type_);
+  auto root = message_builder.Finish();
+  FinishMessageBuffer(builder_, root);
+  FrameMessage(builder_, message_type_, message_id_);
+  payload_ = {};
+  return std::move(builder_);
+}
+
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type, std::size_t message_id,
                                             std::span<const uint8_t> payload) {
-  auto allocation_size = payload.size() + 20;
-  flatbuffers::FlatBufferBuilder fbb(allocation_size);
-  auto payload_vector = fbb.CreateVector<uint8_t>(payload.data(), payload.size());
-  MessageBuilder message_builder(fbb);
-  message_builder.add_message_id(message_id);
-  message_builder.add_payload(payload_vector);
-  message_builder.add_message_type(message_type);
-  auto root = message_builder.Finish();
-  FinishMessageBuffer(fbb, root);
-  return fbb;
+  OutgoingMessage message(message_type, message_id, payload.size());
+  std::copy(payload.begin(), payload.end(), message.GetPayload().begin());
+  return std::move(message).Finish();
 }
 
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
@@ -63,6 +103,7 @@ flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
   message_builder.add_message_type(message_type);
   auto root = message_builder.Finish();
   FinishMessageBuffer(fbb, root);
+  FrameMessage(fbb, message_type, 0);
   return fbb;
 }
 
@@ -72,6 +113,81 @@ flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
   return BuildMessage(message_type, std::span(*payload));
 }
 
+flatbuffers::DetachedBuffer SetSessionId(flatbuffers::DetachedBuffer&& message,
+                                         std::uint32_t session_id) {
+  if (ReadMessageFrameHeader(std::span(message.data(), message.size())).has_value()) {
+    std::memcpy(message.data() + offsetof(MessageFrameHeader, session_id), &session_id,
+                sizeof(session_id));
+    return std::move(message);
+  }
+  const auto original{GetMessage(message.data())};
+  flatbuffers::FlatBufferBuilder fbb(message.size() + 8);
+  flatbuffers::Offset<flatbuffers::Vector<std::uint8_t>> payload_vector;
+  if (original->payload() != nullptr) {
+    payload_vector =
+        fbb.CreateVector<std::uint8_t>(original->payload()->data(), original->payload()->size());
+  }
+  MessageBuilder message_builder(fbb);
+  message_builder.add_message_id(original->message_id());
+  if (original->payload() != nullptr) {
+    message_builder.add_payload(payload_vector);
+  }
+  message_builder.add_session_id(session_id);
+  message_builder.add_message_type(original->message_type());
+  auto root = message_builder.Finish();
+  FinishMessageBuffer(fbb, root);
+  return fbb.Release();
+}
+
+bool IsBulkMessageType(MessageType message_type) {
+  switch (message_type) {
+    case MessageType::kOutputMessage:
+    case MessageType::kOtExtensionReceiverMasks:
+    case MessageType::kOtExtensionReceiverCorrections:
+    case MessageType::kOtExtensionSender:
+    case MessageType::kBmrInputGate0:
+    case MessageType::kBmrInputGate1:
+    case MessageType::kBmrAndGate:
+    case MessageType::kBmrAndGateAggregated:
+    case MessageType::kSharedBitsMask:
+    case MessageType::kSharedBitsReconstruct:
+    case MessageType::kGarbledCircuitGarbledTables:
+    case MessageType::kGarbledCircuitOutput:
+    case MessageType::kGarbledCircuitInput:
+    case MessageType::kKK13OtExtensionReceiverMasks:
+    case MessageType::kKK13OtExtensionReceiverCorrections:
+    case MessageType::kKK13OtExtensionSender:
+    case MessageType::kSilentOtReceiverMasks:
+    case MessageType::kSilentOtSenderTrees:
+    case MessageType::kGarbledCircuitTableStream:
+    case MessageType::kBeaverOpening:
+    case MessageType::kMultiInputMaskProducts:
+    case MessageType::kTruncationOpening:
+    case MessageType::kCircuitLayerOpening:
+    case MessageType::kDaBitOpening:
+    case MessageType::kPsiOprfOffsets:
+    case MessageType::kPsiSenderValues:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::optional<MessageFrameHeader> ReadMessageFrameHeader(
+    std::span<const std::uint8_t> raw_message) {
+  MessageFrameHeader header;
+  if (raw_message.size() < sizeof(header)) {
+    return std::nullopt;
+  }
+  std::memcpy(&header, raw_message.data(), sizeof(header));
+  if (header.magic != MessageFrameHeader::kMagic ||
+      header.length != raw_message.size() - sizeof(header) ||
+      !IsBulkMessageType(header.message_type)) {
+    return std::nullopt;
+  }
+  return header;
+}
+
 using namespace std::string_literals;
 
 std::string to_string(MessageType message_type) {
@@ -24,13 +24,66 @@
 
 #pragma once
 
-#include <flatbuffers/flatbuffers.h>
+#include <cstdint>
+#include <optional>
 #include <span>
 
+#include <flatbuffers/flatbuffers.h>
+
 #include "fbs_headers/message_generated.h"
 
 namespace encrypto::motion::communication {
 
+// Compact header in front of the serialized Message of bulk payload types.
+// A flatbuffer begins with the offset of its root table which is always smaller than the buffer,
+// so a serialized Message can never start with kMagic and both kinds of messages can be told apart.
+struct MessageFrameHeader {
+  static constexpr std::uint32_t kMagic{0xFFFFFFFF};
+
+  std::uint32_t magic;
+  // size of the serialized Message following the header
+  std::uint32_t length;
+  MessageType message_type;
+  std::uint8_t reserved[3];
+  // see Message.session_id, bulk messages are routed by the header without parsing the Message
+  std::uint32_t session_id;
+  std::uint64_t message_id;
+};
+
+static_assert(sizeof(MessageFrameHeader) == 24);
+
+// Check if messages of this type carry bulk payloads which are framed if kFrameBulkMessages is set
+bool IsBulkMessageType(MessageType message_type);
+
+// Read the frame header of a raw message, std::nullopt if the message is not framed or the header
+// is inconsistent with the message
+std::optional<MessageFrameHeader> ReadMessageFrameHeader(std::span<const std::uint8_t> raw_message);
+
+// Message whose payload is computed directly into the buffer of the builder instead of being
+// copied into it by BuildMessage, e.g., for large payloads that are only computed to be sent. The
+// payload is uninitialized and can be written through GetPayload() until Finish(), also
+// concurrently by several threads.
+class OutgoingMessage {
+ public:
+  OutgoingMessage(MessageType message_type, std::size_t message_id, std::size_t payload_size);
+
+  OutgoingMessage(OutgoingMessage&&) = default;
+
+  OutgoingMessage(const OutgoingMessage&) = delete;
+
+  std::span<std::uint8_t> GetPayload() const noexcept { return payload_; }
+
+  // completes the message around the payload like BuildMessage(message_type, message_id, payload)
+  flatbuffers::FlatBufferBuilder Finish() &&;
+
+ private:
+  flatbuffers::FlatBufferBuilder builder_;
+  flatbuffers::Offset<flatbuffers::Vector<std::uint8_t>> payload_vector_;
+  std::span<std::uint8_t> payload_;
+  MessageType message_type_;
+  std::size_t message_id_;
+};
+
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type);
 
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type, std::size_t message_id,
@@ -42,6 +95,11 @@ flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
                                             const std::vector<uint8_t>* payload);
 
+// Assign a serialized message to a session of CommunicationLayer::CreateSession. The frame header
+// of framed messages is updated in place, other messages are rebuilt.
+flatbuffers::DetachedBuffer SetSessionId(flatbuffers::DetachedBuffer&& message,
+                                         std::uint32_t session_id);
+
 // Give a human readable representation of MessageType values
 std::string to_string(MessageType message_type);
 
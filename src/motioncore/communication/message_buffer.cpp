@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "message_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace encrypto::motion::communication {
+
+struct MessageBuffer::Storage {
+  Storage(std::vector<std::uint8_t>&& bytes, std::weak_ptr<MessageBufferPool> pool)
+      : bytes_(std::move(bytes)), pool_(std::move(pool)) {}
+
+  ~Storage() {
+    if (auto pool = pool_.lock()) {
+      pool->Recycle(std::move(bytes_));
+    }
+  }
+
+  std::vector<std::uint8_t> bytes_;
+  std::weak_ptr<MessageBufferPool> pool_;
+};
+
+MessageBuffer::MessageBuffer(std::vector<std::uint8_t>&& bytes)
+    : storage_(std::make_shared<Storage>(std::move(bytes), std::weak_ptr<MessageBufferPool>())),
+      data_(storage_->bytes_.data()),
+      size_(storage_->bytes_.size()) {}
+
+MessageBuffer::MessageBuffer(MessageBuffer&& other) noexcept
+    : storage_(std::move(other.storage_)), data_(other.data_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MessageBuffer& MessageBuffer::operator=(MessageBuffer&& other) noexcept {
+  if (this != &other) {
+    storage_ = std::move(other.storage_);
+    data_ = other.data_;
+    size_ = other.size_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+MessageBuffer MessageBuffer::GetSubBuffer(std::size_t offset, std::size_t size) const {
+  assert(offset + size <= size_);
+  return MessageBuffer(storage_, data_ + offset, size);
+}
+
+MessageBufferPool::MessageBufferPool(std::size_t max_number_of_free_buffers,
+                                     std::size_t max_number_of_free_bytes)
+    : max_number_of_free_buffers_(max_number_of_free_buffers),
+      max_number_of_free_bytes_(max_number_of_free_bytes) {}
+
+MessageBuffer MessageBufferPool::Acquire(std::size_t size) {
+  std::vector<std::uint8_t> bytes;
+  {
+    std::scoped_lock lock(mutex_);
+    // prefer the smallest free buffer that is large enough, otherwise grow the largest one
+    auto fits = [size](const auto& free_buffer) { return free_buffer.size() >= size; };
+    auto best = free_buffers_.end();
+    for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+      if (best == free_buffers_.end()) {
+        best = it;
+      } else if (fits(*it) != fits(*best)) {
+        best = fits(*it) ? it : best;
+      } else if (fits(*it) ? it->size() < best->size() : it->size() > best->size()) {
+        best = it;
+      }
+    }
+    if (best != free_buffers_.end()) {
+      std::iter_swap(best, free_buffers_.end() - 1);
+      bytes = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+      number_of_free_bytes_ -= bytes.size();
+    }
+    if (bytes.size() >= size) {
+      ++number_of_reuses_;
+    } else {
+      ++number_of_allocations_;
+    }
+  }
+  // the storage keeps its size such that reusing it does not initialize the bytes again
+  if (bytes.size() < size) {
+    bytes.resize(size);
+  }
+  auto storage{std::make_shared<MessageBuffer::Storage>(std::move(bytes), weak_from_this())};
+  auto data{storage->bytes_.data()};
+  return MessageBuffer(std::move(storage), data, size);
+}
+
+void MessageBufferPool::Recycle(std::vector<std::uint8_t>&& bytes) {
+  std::scoped_lock lock(mutex_);
+  if (free_buffers_.size() < max_number_of_free_buffers_ &&
+      number_of_free_bytes_ + bytes.size() <= max_number_of_free_bytes_) {
+    number_of_free_bytes_ += bytes.size();
+    free_buffers_.emplace_back(std::move(bytes));
+  }
+}
+
+std::size_t MessageBufferPool::GetNumberOfAllocations() const {
+  std::scoped_lock lock(mutex_);
+  return number_of_allocations_;
+}
+
+std::size_t MessageBufferPool::GetNumberOfReuses() const {
+  std::scoped_lock lock(mutex_);
+  return number_of_reuses_;
+}
+
+}  // namespace encrypto::motion::communication
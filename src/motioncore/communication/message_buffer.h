@@ -0,0 +1,121 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace encrypto::motion::communication {
+
+class MessageBufferPool;
+
+// Reference-counted, movable view of the bytes of a received message.
+// Buffers obtained via GetSubBuffer share the storage of their parent, hence messages can be
+// handed on to their consumers without copying them.  The storage is returned to the pool it
+// was acquired from as soon as the last buffer referring to it is destroyed.
+class MessageBuffer {
+ public:
+  MessageBuffer() = default;
+
+  // adopt the given bytes without copying, the storage does not belong to any pool
+  explicit MessageBuffer(std::vector<std::uint8_t>&& bytes);
+
+  MessageBuffer(MessageBuffer&& other) noexcept;
+  MessageBuffer& operator=(MessageBuffer&& other) noexcept;
+
+  // copying would silently share the storage, use GetSubBuffer for this
+  MessageBuffer(const MessageBuffer&) = delete;
+  MessageBuffer& operator=(const MessageBuffer&) = delete;
+
+  ~MessageBuffer() = default;
+
+  std::uint8_t* data() noexcept { return data_; }
+  const std::uint8_t* data() const noexcept { return data_; }
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  const std::uint8_t* begin() const noexcept { return data_; }
+  const std::uint8_t* end() const noexcept { return data_ + size_; }
+
+  std::uint8_t operator[](std::size_t i) const { return data_[i]; }
+
+  std::span<const std::uint8_t> GetSpan() const noexcept { return {data_, size_}; }
+
+  // return a buffer referring to size bytes starting at offset which shares the storage
+  MessageBuffer GetSubBuffer(std::size_t offset, std::size_t size) const;
+
+ private:
+  friend class MessageBufferPool;
+
+  struct Storage;
+
+  MessageBuffer(std::shared_ptr<Storage> storage, std::uint8_t* data, std::size_t size) noexcept
+      : storage_(std::move(storage)), data_(data), size_(size) {}
+
+  std::shared_ptr<Storage> storage_;
+  std::uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+// Thread-safe pool of receive buffers.
+// Acquired buffers reuse the memory of released ones if it is large enough, so that, e.g., the
+// messages of an OT extension do not require a fresh allocation and zero-initialization each.
+// The pool must be owned by a std::shared_ptr for buffers to be recycled, and it retains at most
+// max_number_of_free_buffers buffers of at most max_number_of_free_bytes in total.
+class MessageBufferPool : public std::enable_shared_from_this<MessageBufferPool> {
+ public:
+  static constexpr std::size_t kDefaultMaxNumberOfFreeBuffers{64};
+  static constexpr std::size_t kDefaultMaxNumberOfFreeBytes{std::size_t(256) << 20};
+
+  MessageBufferPool(std::size_t max_number_of_free_buffers = kDefaultMaxNumberOfFreeBuffers,
+                    std::size_t max_number_of_free_bytes = kDefaultMaxNumberOfFreeBytes);
+
+  MessageBufferPool(const MessageBufferPool&) = delete;
+
+  // return a buffer of the given size with unspecified contents
+  MessageBuffer Acquire(std::size_t size);
+
+  // return the storage of a released buffer to the pool, called by the last referring buffer
+  void Recycle(std::vector<std::uint8_t>&& bytes);
+
+  // number of buffers acquired that required a new allocation
+  std::size_t GetNumberOfAllocations() const;
+
+  // number of buffers acquired that reused the storage of a released buffer
+  std::size_t GetNumberOfReuses() const;
+
+ private:
+  const std::size_t max_number_of_free_buffers_;
+  const std::size_t max_number_of_free_bytes_;
+  mutable std::mutex mutex_;
+  std::vector<std::vector<std::uint8_t>> free_buffers_;
+  std::size_t number_of_free_bytes_ = 0;
+  std::size_t number_of_allocations_ = 0;
+  std::size_t number_of_reuses_ = 0;
+};
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,199 @@
+// MIT License
+//
+// Copyright (c) 2019 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "message_compression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace encrypto::motion::communication {
+
+// The compressed data is a sequence of (literals, match) pairs, each starting with a token byte
+// whose upper and lower nibble hold the number of literals and the length of the match minus
+// kMinMatch.  A nibble value of 15 is followed by bytes which are added to it as long as they are
+// 255.  The literals follow the token, then the 2-byte little-endian offset to the start of the
+// match, then the extended match length.  The last pair consists of literals only.
+
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kMaxOffset = std::numeric_limits<std::uint16_t>::max();
+constexpr std::size_t kHashLog = 14;
+// number of consecutive misses after which the step size increases on incompressible data
+constexpr std::size_t kSkipTrigger = 6;
+
+static std::uint32_t Load32(const std::uint8_t* data) {
+  std::uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static std::size_t Hash(std::uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kHashLog);
+}
+
+static void PutLength(std::vector<std::uint8_t>& output, std::size_t length) {
+  for (; length >= 255; length -= 255) {
+    output.push_back(255);
+  }
+  output.push_back(static_cast<std::uint8_t>(length));
+}
+
+static void PutSequence(std::vector<std::uint8_t>& output, std::span<const std::uint8_t> literals,
+                        std::size_t offset, std::size_t match_length) {
+  const auto literal_nibble{std::min<std::size_t>(literals.size(), 15)};
+  const auto match_nibble{
+      match_length == 0 ? 0 : std::min<std::size_t>(match_length - kMinMatch, 15)};
+  output.push_back(static_cast<std::uint8_t>(literal_nibble << 4 | match_nibble));
+  if (literal_nibble == 15) {
+    PutLength(output, literals.size() - 15);
+  }
+  output.insert(output.end(), literals.begin(), literals.end());
+  if (match_length == 0) {
+    return;
+  }
+  output.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+  output.push_back(static_cast<std::uint8_t>(offset >> 8));
+  if (match_nibble == 15) {
+    PutLength(output, match_length - kMinMatch - 15);
+  }
+}
+
+std::optional<std::vector<std::uint8_t>> CompressMessage(std::span<const std::uint8_t> message,
+                                                         std::size_t max_size) {
+  if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> output(sizeof(CompressedMessageHeader));
+  const CompressedMessageHeader header{.magic = CompressedMessageHeader::kMagic,
+                                       .uncompressed_length =
+                                           static_cast<std::uint32_t>(message.size())};
+  std::memcpy(output.data(), &header, sizeof(header));
+  output.reserve(std::min(max_size, message.size() + message.size() / 255 + 16));
+
+  // positions + 1 of the last occurrence of the hashed sequences, 0 if there is none
+  std::vector<std::uint32_t> table(std::size_t(1) << kHashLog, 0);
+  const auto data{message.data()};
+  std::size_t anchor = 0;
+  std::size_t position = 0;
+  std::size_t number_of_misses = 0;
+  while (position + kMinMatch <= message.size()) {
+    const auto sequence{Load32(data + position)};
+    auto& entry{table[Hash(sequence)]};
+    const std::size_t candidate = entry;
+    entry = static_cast<std::uint32_t>(position + 1);
+    if (candidate == 0 || position - (candidate - 1) > kMaxOffset ||
+        Load32(data + candidate - 1) != sequence) {
+      position += 1 + (number_of_misses++ >> kSkipTrigger);
+      continue;
+    }
+    const auto match{candidate - 1};
+    auto match_length{kMinMatch};
+    while (position + match_length < message.size() &&
+           data[match + match_length] == data[position + match_length]) {
+      ++match_length;
+    }
+    PutSequence(output, message.subspan(anchor, position - anchor), position - match,
+                match_length);
+    if (output.size() >= max_size) {
+      return std::nullopt;
+    }
+    position += match_length;
+    anchor = position;
+    number_of_misses = 0;
+  }
+  PutSequence(output, message.subspan(anchor), 0, 0);
+  if (output.size() >= max_size) {
+    return std::nullopt;
+  }
+  return output;
+}
+
+std::optional<CompressedMessageHeader> ReadCompressedMessageHeader(
+    std::span<const std::uint8_t> raw_message) {
+  CompressedMessageHeader header;
+  if (raw_message.size() < sizeof(header)) {
+    return std::nullopt;
+  }
+  std::memcpy(&header, raw_message.data(), sizeof(header));
+  if (header.magic != CompressedMessageHeader::kMagic) {
+    return std::nullopt;
+  }
+  return header;
+}
+
+void DecompressMessage(std::span<const std::uint8_t> raw_message, std::span<std::uint8_t> output) {
+  auto input{raw_message.subspan(sizeof(CompressedMessageHeader))};
+  std::size_t input_position = 0;
+  std::size_t output_position = 0;
+  auto malformed = [] { return std::runtime_error("malformed compressed message"); };
+  auto get_length = [&](std::size_t length) {
+    if (length < 15) {
+      return length;
+    }
+    std::uint8_t byte;
+    do {
+      if (input_position >= input.size()) {
+        throw malformed();
+      }
+      byte = input[input_position++];
+      length += byte;
+    } while (byte == 255);
+    return length;
+  };
+  while (input_position < input.size()) {
+    const auto token{input[input_position++]};
+    const auto number_of_literals{get_length(token >> 4)};
+    if (number_of_literals > input.size() - input_position ||
+        number_of_literals > output.size() - output_position) {
+      throw malformed();
+    }
+    std::copy_n(input.data() + input_position, number_of_literals,
+                output.data() + output_position);
+    input_position += number_of_literals;
+    output_position += number_of_literals;
+    if (input_position == input.size()) {
+      break;
+    }
+    if (input.size() - input_position < 2) {
+      throw malformed();
+    }
+    const std::size_t offset = input[input_position] | input[input_position + 1] << 8;
+    input_position += 2;
+    const auto match_length{get_length(token & 0x0F) + kMinMatch};
+    if (offset == 0 || offset > output_position ||
+        match_length > output.size() - output_position) {
+      throw malformed();
+    }
+    // matches may overlap with the bytes they produce
+    for (std::size_t i = 0; i < match_length; ++i, ++output_position) {
+      output[output_position] = output[output_position - offset];
+    }
+  }
+  if (output_position != output.size()) {
+    throw malformed();
+  }
+}
+
+}  // namespace encrypto::motion::communication
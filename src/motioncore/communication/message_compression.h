@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2019 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace encrypto::motion::communication {
+
+enum class MessageCompression : std::uint8_t {
+  // send messages as they are
+  kNone,
+  // compress every message that becomes smaller
+  kAlways,
+  // compress messages, but stop trying for an increasing number of messages after messages did not
+  // compress well, e.g., because they contain random-looking data such as OT masks
+  kAdaptive,
+};
+
+// Header in front of compressed messages.  Like MessageFrameHeader::kMagic, kMagic can never be the
+// root offset at the beginning of a flatbuffer.
+struct CompressedMessageHeader {
+  static constexpr std::uint32_t kMagic{0xFFFFFFFE};
+
+  std::uint32_t magic;
+  // size of the message after decompression
+  std::uint32_t uncompressed_length;
+};
+
+static_assert(sizeof(CompressedMessageHeader) == 8);
+
+// Compress a message with a fast LZ77 scheme in the style of LZ4 and prepend a
+// CompressedMessageHeader.  Returns std::nullopt as soon as the result would not be smaller than
+// max_size bytes.
+std::optional<std::vector<std::uint8_t>> CompressMessage(std::span<const std::uint8_t> message,
+                                                         std::size_t max_size);
+
+// Read the header of a compressed message, std::nullopt if the message is not compressed
+std::optional<CompressedMessageHeader> ReadCompressedMessageHeader(
+    std::span<const std::uint8_t> raw_message);
+
+// Decompress the data following the header of a compressed message into output, which needs to
+// be of the uncompressed length given in the header.
+// Throws a std::runtime_error if the compressed data is malformed.
+void DecompressMessage(std::span<const std::uint8_t> raw_message, std::span<std::uint8_t> output);
+
+}  // namespace encrypto::motion::communication
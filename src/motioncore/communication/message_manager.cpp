@@ -22,43 +22,163 @@
 
 #include "message_manager.h"
 
+#include <cassert>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
 #include "fbs_headers/message_generated.h"
 
 namespace encrypto::motion::communication {
 
-MessageManager::MessageManager(std::size_t number_of_parties, std::size_t my_id) : my_id_(my_id) {
-  incoming_message_promises_.resize(number_of_parties - 1);
-  incoming_sync_states_ =
-      std::vector<SynchronizedFiberQueue<container_type>>(number_of_parties - 1);
+MessageRoutingTable::~MessageRoutingTable() {
+  for (auto& directory : directories_) {
+    auto directory_pointer{directory.load(std::memory_order_acquire)};
+    if (directory_pointer == nullptr) {
+      continue;
+    }
+    for (auto& chunk : *directory_pointer) {
+      delete chunk.load(std::memory_order_acquire);
+    }
+    delete directory_pointer;
+  }
+}
+
+// return the object pointed to, allocating it if it does not exist yet
+template <typename T>
+static T* GetOrCreate(std::atomic<T*>& pointer) {
+  auto result{pointer.load(std::memory_order_acquire)};
+  if (result != nullptr) {
+    return result;
+  }
+  auto new_object{new T()};
+  if (pointer.compare_exchange_strong(result, new_object, std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+    return new_object;
+  }
+  // another thread was faster
+  delete new_object;
+  return result;
+}
+
+MessageRoutingTable::Slot* MessageRoutingTable::GetSlot(MessageType message_type,
+                                                        std::size_t message_id, bool create) {
+  assert(message_id < kMaxDenseMessageId);
+  auto& directory{directories_[static_cast<std::size_t>(message_type)]};
+  auto directory_pointer{create ? GetOrCreate(directory)
+                                : directory.load(std::memory_order_acquire)};
+  if (directory_pointer == nullptr) {
+    return nullptr;
+  }
+  auto& chunk{(*directory_pointer)[message_id / kChunkSize]};
+  auto chunk_pointer{create ? GetOrCreate(chunk) : chunk.load(std::memory_order_acquire)};
+  if (chunk_pointer == nullptr) {
+    return nullptr;
+  }
+  return &(*chunk_pointer)[message_id % kChunkSize];
+}
+
+MessageRoutingTable::future_type MessageRoutingTable::Register(MessageType message_type,
+                                                               std::size_t message_id) {
+  if (message_id >= kMaxDenseMessageId) {
+    std::scoped_lock lock(sparse_promises_mutex_);
+    auto [iterator, inserted]{sparse_promises_.try_emplace({message_type, message_id})};
+    if (!inserted && !iterator->second.renew()) {
+      iterator->second = promise_type();
+    }
+    return iterator->second.get_future();
+  }
+  auto slot{GetSlot(message_type, message_id, true)};
+  slot->is_registered.store(false, std::memory_order_relaxed);
+  // reuse the promise of the last evaluation unless its future is still alive
+  if (!slot->promise || !slot->promise->renew()) {
+    slot->promise.emplace();
+  }
+  auto future{slot->promise->get_future()};
+  slot->is_registered.store(true, std::memory_order_release);
+  return future;
+}
+
+MessageRoutingTable::promise_type* MessageRoutingTable::Find(MessageType message_type,
+                                                             std::size_t message_id) {
+  if (message_id >= kMaxDenseMessageId) {
+    std::scoped_lock lock(sparse_promises_mutex_);
+    auto iterator{sparse_promises_.find({message_type, message_id})};
+    return iterator == sparse_promises_.end() ? nullptr : &iterator->second;
+  }
+  auto slot{GetSlot(message_type, message_id, false)};
+  if (slot == nullptr || !slot->is_registered.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return &*slot->promise;
 }
 
+MessageManager::MessageManager(std::size_t number_of_parties, std::size_t my_id)
+    : incoming_message_promises_(number_of_parties - 1),
+      incoming_sync_states_(number_of_parties - 1),
+      sender_epoch_states_(number_of_parties - 1),
+      my_id_(my_id) {}
+
 void MessageManager::ReceivedMessage(std::size_t sender_id,
-                                     std::vector<std::uint8_t>&& message) {
+                                     container_type&& message) {
   auto fb_message{GetMessage(message.data())};
   MessageType message_type{fb_message->message_type()};
   std::size_t message_id{fb_message->message_id()};
-  incoming_message_promises_[ComputeId(sender_id)][message_type][message_id]->set_value(
-      std::move(message));
+  auto promise{FindMessagePromise(sender_id, message_type, message_id)};
+  if (promise == nullptr) {
+    throw std::runtime_error(fmt::format("received unexpected message of type {} with id {}",
+                                         EnumNameMessageType(message_type), message_id));
+  }
+  promise->set_value(std::move(message));
+}
+
+void MessageManager::AdvanceSenderEpoch(std::size_t sender_id) {
+  ++sender_epoch_states_[ComputeId(sender_id)].epoch;
+}
+
+std::optional<MessageManager::container_type> MessageManager::HoldIfAhead(
+    std::size_t sender_id, MessageType message_type, std::size_t message_id,
+    container_type&& message) {
+  auto& state{sender_epoch_states_[ComputeId(sender_id)]};
+  if (state.epoch <= epoch_.load()) {
+    return std::move(message);
+  }
+  std::scoped_lock lock(state.mutex);
+  // AdvanceEpoch may have advanced the epoch before taking the lock
+  if (state.epoch <= epoch_.load()) {
+    return std::move(message);
+  }
+  state.held_messages.emplace_back(
+      state.epoch, HeldMessage{sender_id, message_type, message_id, std::move(message)});
+  return std::nullopt;
+}
+
+std::vector<MessageManager::HeldMessage> MessageManager::AdvanceEpoch() {
+  const auto epoch{epoch_.load() + 1};
+  epoch_.store(epoch);
+  std::vector<HeldMessage> messages;
+  for (auto& state : sender_epoch_states_) {
+    std::scoped_lock lock(state.mutex);
+    while (!state.held_messages.empty() && state.held_messages.front().first <= epoch) {
+      messages.emplace_back(std::move(state.held_messages.front().second));
+      state.held_messages.pop_front();
+    }
+  }
+  return messages;
 }
 
 MessageManager::future_type MessageManager::RegisterReceive(std::size_t sender_id,
                                                             MessageType message_type,
                                                             std::size_t message_id) {
-  auto p{std::make_unique<promise_type>()};
-  auto f{p->get_future()};
-  incoming_message_promises_[ComputeId(sender_id)][message_type][message_id] = std::move(p);
-  return f;
+  return incoming_message_promises_[ComputeId(sender_id)].Register(message_type, message_id);
 }
 
 std::vector<MessageManager::future_type> MessageManager::RegisterReceiveAll(
     MessageType message_type, std::size_t message_id) {
   std::vector<MessageManager::future_type> futures;
   futures.reserve(incoming_message_promises_.size());
-  for (auto& m : incoming_message_promises_) {
-    auto p{std::make_unique<promise_type>()};
-    auto f{p->get_future()};
-    m[message_type][message_id] = std::move(p);
-    futures.emplace_back(std::move(f));
+  for (auto& routing_table : incoming_message_promises_) {
+    futures.emplace_back(routing_table.Register(message_type, message_id));
   }
   return futures;
 }
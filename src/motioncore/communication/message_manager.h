@@ -22,9 +22,18 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
+#include "message_buffer.h"
 #include "utility/reusable_future.h"
 #include "utility/synchronized_queue.h"
 
@@ -32,11 +41,58 @@ namespace encrypto::motion::communication {
 
 enum class MessageType : uint8_t;
 
+/// \brief Dense table of the promises registered for the messages of one party.
+/// Promises are stored in place in chunks of consecutive message ids per message type, which are
+/// allocated on first use and never freed before the table is destroyed. Hence, registering and
+/// finding promises is lock-free and can be done concurrently from any thread as long as no two
+/// threads register the same message. Message ids beyond the dense range of kMaxDenseMessageId
+/// ids fall back to a map protected by a mutex. The promises are kept across evaluations, such
+/// that registering the messages of a repeated circuit reuses their shared states.
+class MessageRoutingTable {
+ public:
+  using promise_type = ReusableFiberPromise<MessageBuffer>;
+  using future_type = ReusableFiberFuture<MessageBuffer>;
+
+  // number of consecutive message ids per chunk
+  static constexpr std::size_t kChunkSize{std::size_t(1) << 12};
+  // number of chunks per message type
+  static constexpr std::size_t kNumberOfChunks{std::size_t(1) << 14};
+  static constexpr std::size_t kMaxDenseMessageId{kChunkSize * kNumberOfChunks};
+
+  MessageRoutingTable() = default;
+  MessageRoutingTable(const MessageRoutingTable&) = delete;
+  ~MessageRoutingTable();
+
+  /// \brief Registers a new promise for the message and returns its future.
+  /// A promise registered before for the same message is replaced, reusing its shared state if
+  /// its future was destroyed.
+  [[nodiscard]] future_type Register(MessageType message_type, std::size_t message_id);
+
+  /// \brief Returns the promise registered for the message or nullptr if there is none.
+  promise_type* Find(MessageType message_type, std::size_t message_id);
+
+ private:
+  struct Slot {
+    std::atomic<bool> is_registered{false};
+    std::optional<promise_type> promise;
+  };
+  using Chunk = std::array<Slot, kChunkSize>;
+  using Directory = std::array<std::atomic<Chunk*>, kNumberOfChunks>;
+
+  Slot* GetSlot(MessageType message_type, std::size_t message_id, bool create);
+
+  // directories_[message_type][message_id / kChunkSize][message_id % kChunkSize]
+  std::array<std::atomic<Directory*>, std::size_t(1) << (8 * sizeof(MessageType))> directories_{};
+
+  std::mutex sparse_promises_mutex_;
+  std::map<std::pair<MessageType, std::size_t>, promise_type> sparse_promises_;
+};
+
 /// \brief Manages future/promise based communication channels in the following way:
 /// In a pre-setup phase, a callee calls some Register* function eg RegisterReceive for
 /// some \p sender_id, \p message_type and a \p message_id. The result of the function is a future.
-/// The respective promise is stored in a nested hash map based structure that allows to efficiently
-/// find the promise, when a matching message arrives.
+/// The respective promise is stored in a dense per-party MessageRoutingTable that allows to
+/// efficiently find the promise, when a matching message arrives.
 /// After the pre-setup phase, another party transmits the message corresponding to the registered
 /// parameters. The message gets moved to the promise as a whole ie all further actions such as
 /// parsing the message depend on the code calling the get() function. Consequently, a message
@@ -46,16 +102,14 @@ class MessageManager {
  public:
   // byte type
   using value_type = std::uint8_t;
-  // byte container for the message data
-  using container_type = std::vector<value_type>;
+  // reference-counted byte buffer for the message data, recycled after the consumer released it
+  using container_type = MessageBuffer;
   // promise for a message
   using promise_type = ReusableFiberPromise<container_type>;
   // future belonging to a promise
   using future_type = ReusableFiberFuture<container_type>;
-  // submap[message_id] -> message_promise
-  using submap_type = std::unordered_map<std::size_t, std::unique_ptr<promise_type>>;
-  // map[message_type] -> submap
-  using map_type = std::unordered_map<MessageType, submap_type>;
+  // routing_table.Find(message_type, message_id) -> message_promise
+  using routing_table_type = MessageRoutingTable;
 
   MessageManager() = delete;
   MessageManager(const MessageManager&) = delete;
@@ -63,7 +117,7 @@ class MessageManager {
   MessageManager(std::size_t number_of_parties, std::size_t my_id);
 
   // This method is called to forward a received message to the corresponding future.
-  void ReceivedMessage(std::size_t sender_id, std::vector<std::uint8_t>&& message);
+  void ReceivedMessage(std::size_t sender_id, container_type&& message);
 
   [[nodiscard]] future_type RegisterReceive(std::size_t sender_id, MessageType message_type,
                                             std::size_t message_id);
@@ -71,24 +125,56 @@ class MessageManager {
   [[nodiscard]] std::vector<future_type> RegisterReceiveAll(MessageType message_type,
                                                             std::size_t message_id);
 
-  auto& GetMessagePromises(std::size_t party_id) {
-    return incoming_message_promises_[ComputeId(party_id)];
+  // Returns the promise registered for the message or nullptr if there is none.
+  promise_type* FindMessagePromise(std::size_t party_id, MessageType message_type,
+                                   std::size_t message_id) {
+    return incoming_message_promises_[ComputeId(party_id)].Find(message_type, message_id);
   }
 
-  auto& GetMessagePromises() { return incoming_message_promises_; }
-
   auto& GetSyncStates(std::size_t party_id) { return incoming_sync_states_[ComputeId(party_id)]; }
 
   auto& GetSyncStates() { return incoming_sync_states_; }
 
+  // message held back by HoldIfAhead
+  struct HeldMessage {
+    std::size_t sender_id;
+    MessageType message_type;
+    std::size_t message_id;
+    container_type message;
+  };
+
+  // Implicit synchronization, see CommunicationLayer::SetImplicitSynchronization:
+  // The epoch of a sender advances with each of its synchronization messages, which it sends when
+  // it synchronizes, such that its later messages belong to the next epoch.
+  // Must only be called by the receiver of the messages of the sender.
+  void AdvanceSenderEpoch(std::size_t sender_id);
+
+  // Returns the message if this party has reached the current epoch of the sender, otherwise the
+  // message is held until AdvanceEpoch reaches it.
+  // Must only be called by the receiver of the messages of the sender.
+  std::optional<container_type> HoldIfAhead(std::size_t sender_id, MessageType message_type,
+                                            std::size_t message_id, container_type&& message);
+
+  // Advances the epoch of this party and returns the held messages of the epochs it reached.
+  std::vector<HeldMessage> AdvanceEpoch();
+
  private:
   std::size_t ComputeId(std::size_t id) { return id < my_id_ ? id : id - 1; }
 
-  // incoming_message_promises_[sender_id][message_type][message_id]
-  std::vector<map_type> incoming_message_promises_;
+  // incoming_message_promises_[sender_id].Find(message_type, message_id)
+  std::vector<routing_table_type> incoming_message_promises_;
   // sync states need to be handled differently because it may happen that 2 sync states arrive
   // sequentially, which would break the promise-future logic.
   std::vector<SynchronizedFiberQueue<container_type>> incoming_sync_states_;
+  struct SenderEpochState {
+    // only accessed by the receiver of the messages of the sender
+    std::size_t epoch{0};
+    std::mutex mutex;
+    // pairs of the epoch of the sender and a message of it, guarded by the mutex
+    std::deque<std::pair<std::size_t, HeldMessage>> held_messages;
+  };
+  std::vector<SenderEpochState> sender_epoch_states_;
+  std::atomic<std::size_t> epoch_{0};
   std::size_t my_id_;
 };
 
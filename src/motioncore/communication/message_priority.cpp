@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "message_priority.h"
+
+#include <cstring>
+
+namespace encrypto::motion::communication {
+
+MessagePriority GetDefaultMessagePriority(MessageType message_type) {
+  switch (message_type) {
+    case MessageType::kHelloMessage:
+    case MessageType::kOutputMessage:
+    case MessageType::kSynchronizationMessage:
+    case MessageType::kClockProbe:
+    case MessageType::kLinkReport:
+    case MessageType::kAstraOnlineMultiplyGate:
+    case MessageType::kAstraOnlineDotProductGate:
+    case MessageType::kAstraOnlineAndGate:
+    case MessageType::kGarbledCircuitOutput:
+    case MessageType::kBeaverOpening:
+    case MessageType::kTruncationOpening:
+    case MessageType::kCircuitLayerOpening:
+    case MessageType::kDaBitOpening:
+    case MessageType::kMessageBatch:
+      return MessagePriority::kHigh;
+    case MessageType::kOtExtensionReceiverMasks:
+    case MessageType::kOtExtensionReceiverCorrections:
+    case MessageType::kOtExtensionSender:
+    case MessageType::kBmrAndGate:
+    case MessageType::kBmrAndGateAggregated:
+    case MessageType::kAstraSetupMultiplyGate:
+    case MessageType::kAstraSetupDotProductGate:
+    case MessageType::kAstraSetupAndGate:
+    case MessageType::kGarbledCircuitGarbledTables:
+    case MessageType::kGarbledCircuitTableStream:
+    case MessageType::kKK13OtExtensionReceiverMasks:
+    case MessageType::kKK13OtExtensionReceiverCorrections:
+    case MessageType::kKK13OtExtensionSender:
+    case MessageType::kSilentOtReceiverMasks:
+    case MessageType::kSilentOtSenderTrees:
+    case MessageType::kMultiInputMaskProducts:
+      return MessagePriority::kBulk;
+    default:
+      return MessagePriority::kNormal;
+  }
+}
+
+std::optional<MessageFragmentHeader> ReadMessageFragmentHeader(
+    std::span<const std::uint8_t> raw_message) {
+  MessageFragmentHeader header;
+  if (raw_message.size() < sizeof(header)) {
+    return std::nullopt;
+  }
+  std::memcpy(&header, raw_message.data(), sizeof(header));
+  if (header.magic != MessageFragmentHeader::kMagic ||
+      header.length != raw_message.size() - sizeof(header) ||
+      static_cast<std::size_t>(header.priority) >= kNumberOfMessagePriorities ||
+      header.offset > header.total_length || header.length > header.total_length - header.offset) {
+    return std::nullopt;
+  }
+  return header;
+}
+
+}  // namespace encrypto::motion::communication
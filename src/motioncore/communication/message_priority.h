@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "fbs_headers/message_generated.h"
+
+namespace encrypto::motion::communication {
+
+// Classes of messages which are scheduled separately, see
+// CommunicationLayer::SetMessagePrioritization
+enum class MessagePriority : std::uint8_t {
+  // latency critical messages of the online phase, e.g., the openings of multiplications
+  kHigh,
+  kNormal,
+  // large messages which are not waited for immediately, e.g., OT extensions and garbled tables
+  kBulk,
+};
+
+constexpr std::size_t kNumberOfMessagePriorities{3};
+
+// Priority of the messages of a type if not configured otherwise
+MessagePriority GetDefaultMessagePriority(MessageType message_type);
+
+// Header in front of each fragment of a large message, whose fragments are sent in order but may be
+// interleaved with messages of other priorities.  Like MessageFrameHeader::kMagic, kMagic can never
+// be the root offset at the beginning of a flatbuffer.
+struct MessageFragmentHeader {
+  static constexpr std::uint32_t kMagic{0xFFFFFFFD};
+
+  std::uint32_t magic;
+  // size of the fragment following the header
+  std::uint32_t length;
+  // at most one fragmented message per priority is in transit at a time
+  MessagePriority priority;
+  std::uint8_t reserved[7];
+  // size of the whole message and position of the fragment in it
+  std::uint64_t total_length;
+  std::uint64_t offset;
+};
+
+static_assert(sizeof(MessageFragmentHeader) == 32);
+
+// Read the header of a fragment, std::nullopt if the message is not a fragment or the header is
+// inconsistent with the message
+std::optional<MessageFragmentHeader> ReadMessageFragmentHeader(
+    std::span<const std::uint8_t> raw_message);
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,54 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fbs_headers/message_generated.h"
+
+namespace encrypto::motion::communication {
+
+// Times at which the messages of the protocol were handed to a CommunicationLayer to be sent and
+// at which they were delivered to their receivers, recorded if message tracing is enabled, see
+// CommunicationLayer::SetMessageTracing
+struct MessageTrace {
+  using ClockType = std::chrono::steady_clock;
+
+  enum class Direction : std::uint8_t { kSent, kReceived };
+
+  struct Event {
+    std::size_t party_id;  // of the receiver of a sent message or the sender of a received one
+    Direction direction;
+    MessageType message_type;
+    std::uint64_t message_id;
+    std::size_t number_of_bytes;
+    ClockType::time_point time;
+  };
+
+  std::vector<Event> events;
+};
+
+}  // namespace encrypto::motion::communication
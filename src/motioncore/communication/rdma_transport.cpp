@@ -0,0 +1,667 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rdma_transport.h"
+
+#include <arpa/inet.h>
+#include <infiniband/verbs.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+// spin for a while, then yield, then sleep while waiting for the other side
+class RdmaBackoff {
+ public:
+  void operator()() {
+    if (iteration_ < kNumberOfSpins) {
+      ++iteration_;
+    } else if (iteration_ < kNumberOfSpins + kNumberOfYields) {
+      ++iteration_;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+ private:
+  static constexpr std::size_t kNumberOfSpins = 1000;
+  static constexpr std::size_t kNumberOfYields = 1000;
+  std::size_t iteration_ = 0;
+};
+
+// the verbs calls return 0 on success and an errno value or -1 with errno set otherwise
+static void CheckVerbs(int result, const char* operation) {
+  if (result != 0) {
+    const auto error = result > 0 ? result : errno;
+    throw std::runtime_error(fmt::format("{} failed: {}", operation, std::strerror(error)));
+  }
+}
+
+template <typename T>
+static T* CheckPointer(T* pointer, const char* operation) {
+  if (pointer == nullptr) {
+    throw std::runtime_error(fmt::format("{} failed: {}", operation, std::strerror(errno)));
+  }
+  return pointer;
+}
+
+struct VerbsDeleter {
+  void operator()(ibv_context* context) const { ibv_close_device(context); }
+  void operator()(ibv_pd* protection_domain) const { ibv_dealloc_pd(protection_domain); }
+  void operator()(ibv_cq* completion_queue) const { ibv_destroy_cq(completion_queue); }
+  void operator()(ibv_qp* queue_pair) const { ibv_destroy_qp(queue_pair); }
+  void operator()(ibv_mr* memory_region) const { ibv_dereg_mr(memory_region); }
+};
+
+template <typename T>
+using VerbsPointer = std::unique_ptr<T, VerbsDeleter>;
+
+// opened device shared by all connections of one setup
+struct RdmaDevice {
+  RdmaDevice(const RdmaDeviceConfiguration& configuration)
+      : port_number(configuration.port_number), gid_index(configuration.gid_index) {
+    int number_of_devices = 0;
+    auto device_list = CheckPointer(ibv_get_device_list(&number_of_devices), "ibv_get_device_list");
+    ibv_device* device = nullptr;
+    for (int i = 0; i < number_of_devices && device == nullptr; ++i) {
+      if (configuration.device_name.empty() ||
+          configuration.device_name == ibv_get_device_name(device_list[i])) {
+        device = device_list[i];
+      }
+    }
+    if (device == nullptr) {
+      ibv_free_device_list(device_list);
+      throw std::runtime_error(configuration.device_name.empty()
+                                   ? std::string("no RDMA device found")
+                                   : fmt::format("RDMA device {} not found",
+                                                 configuration.device_name));
+    }
+    context.reset(ibv_open_device(device));
+    ibv_free_device_list(device_list);
+    CheckPointer(context.get(), "ibv_open_device");
+    protection_domain.reset(CheckPointer(ibv_alloc_pd(context.get()), "ibv_alloc_pd"));
+    CheckVerbs(ibv_query_port(context.get(), port_number, &port_attributes), "ibv_query_port");
+    CheckVerbs(ibv_query_gid(context.get(), port_number, gid_index, &gid), "ibv_query_gid");
+  }
+
+  VerbsPointer<ibv_context> context;
+  VerbsPointer<ibv_pd> protection_domain;
+  std::uint8_t port_number;
+  int gid_index;
+  ibv_port_attr port_attributes;
+  ibv_gid gid;
+};
+
+// everything the other party needs to connect its queue pair and to write into our memory
+struct RdmaEndpoint {
+  std::uint32_t queue_pair_number;
+  std::uint32_t packet_sequence_number;
+  std::uint16_t lid;
+  std::array<std::uint8_t, 16> gid;
+  std::uint64_t ring_address;
+  std::uint32_t ring_key;
+  std::uint64_t capacity;
+  std::uint64_t credit_address;
+  std::uint32_t credit_key;
+
+  static constexpr std::size_t kSerializedSize{4 + 4 + 2 + 16 + 8 + 4 + 8 + 8 + 4};
+
+  std::vector<std::uint8_t> Serialize() const {
+    std::vector<std::uint8_t> result;
+    result.reserve(kSerializedSize);
+    auto append = [&result](std::uint64_t value, std::size_t size) {
+      for (std::size_t i = 0; i < size; ++i) result.push_back((value >> (8 * i)) & 0xFF);
+    };
+    append(queue_pair_number, 4);
+    append(packet_sequence_number, 4);
+    append(lid, 2);
+    result.insert(result.end(), gid.begin(), gid.end());
+    append(ring_address, 8);
+    append(ring_key, 4);
+    append(capacity, 8);
+    append(credit_address, 8);
+    append(credit_key, 4);
+    return result;
+  }
+
+  static RdmaEndpoint Deserialize(std::span<const std::uint8_t> bytes) {
+    if (bytes.size() != kSerializedSize) {
+      throw std::runtime_error(fmt::format("received RDMA endpoint of {} B instead of {} B",
+                                           bytes.size(), kSerializedSize));
+    }
+    std::size_t position = 0;
+    auto take = [&bytes, &position](std::size_t size) {
+      std::uint64_t value = 0;
+      for (std::size_t i = 0; i < size; ++i) value |= std::uint64_t(bytes[position++]) << (8 * i);
+      return value;
+    };
+    RdmaEndpoint endpoint;
+    endpoint.queue_pair_number = take(4);
+    endpoint.packet_sequence_number = take(4);
+    endpoint.lid = take(2);
+    std::copy_n(bytes.begin() + position, endpoint.gid.size(), endpoint.gid.begin());
+    position += endpoint.gid.size();
+    endpoint.ring_address = take(8);
+    endpoint.ring_key = take(4);
+    endpoint.capacity = take(8);
+    endpoint.credit_address = take(8);
+    endpoint.credit_key = take(4);
+    return endpoint;
+  }
+};
+
+// One queue pair with the ring buffer of the received messages, the staging buffer of the sent
+// messages, and the word into which the other party writes how many bytes it has read from our
+// writes.  The sender and the receiver thread both post to the send queue, e.g., the receiver
+// for returning free space, so it is shared under a mutex.  Only the receiver polls the receive
+// queue.
+class RdmaConnection {
+ public:
+  RdmaConnection(std::shared_ptr<RdmaDevice> device, std::size_t capacity)
+      : device_(std::move(device)),
+        capacity_(capacity),
+        ring_(std::make_unique_for_overwrite<std::uint8_t[]>(capacity)),
+        staging_(std::make_unique_for_overwrite<std::uint8_t[]>(capacity)),
+        credit_(std::make_unique<Credit>()) {
+    auto* context = device_->context.get();
+    auto* protection_domain = device_->protection_domain.get();
+    send_queue_.reset(CheckPointer(ibv_create_cq(context, kSendQueueDepth, nullptr, nullptr, 0),
+                                   "ibv_create_cq"));
+    receive_queue_.reset(CheckPointer(
+        ibv_create_cq(context, kReceiveQueueDepth, nullptr, nullptr, 0), "ibv_create_cq"));
+    ibv_qp_init_attr attributes{};
+    attributes.send_cq = send_queue_.get();
+    attributes.recv_cq = receive_queue_.get();
+    attributes.qp_type = IBV_QPT_RC;
+    attributes.sq_sig_all = 1;
+    attributes.cap.max_send_wr = kSendQueueDepth;
+    attributes.cap.max_recv_wr = kReceiveQueueDepth;
+    attributes.cap.max_send_sge = 1;
+    attributes.cap.max_recv_sge = 1;
+    attributes.cap.max_inline_data = sizeof(std::uint64_t);
+    queue_pair_.reset(CheckPointer(ibv_create_qp(protection_domain, &attributes), "ibv_create_qp"));
+
+    ring_region_.reset(CheckPointer(
+        ibv_reg_mr(protection_domain, ring_.get(), capacity_,
+                   IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE),
+        "ibv_reg_mr"));
+    staging_region_.reset(CheckPointer(
+        ibv_reg_mr(protection_domain, staging_.get(), capacity_, IBV_ACCESS_LOCAL_WRITE),
+        "ibv_reg_mr"));
+    credit_region_.reset(CheckPointer(
+        ibv_reg_mr(protection_domain, &credit_->read_position, sizeof(credit_->read_position),
+                   IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE),
+        "ibv_reg_mr"));
+
+    std::random_device random_device;
+    packet_sequence_number_ = random_device() & 0xFFFFFF;
+  }
+
+  RdmaEndpoint GetLocalEndpoint() const {
+    RdmaEndpoint endpoint;
+    endpoint.queue_pair_number = queue_pair_->qp_num;
+    endpoint.packet_sequence_number = packet_sequence_number_;
+    endpoint.lid = device_->port_attributes.lid;
+    std::copy_n(device_->gid.raw, endpoint.gid.size(), endpoint.gid.begin());
+    endpoint.ring_address = reinterpret_cast<std::uintptr_t>(ring_.get());
+    endpoint.ring_key = ring_region_->rkey;
+    endpoint.capacity = capacity_;
+    endpoint.credit_address = reinterpret_cast<std::uintptr_t>(&credit_->read_position);
+    endpoint.credit_key = credit_region_->rkey;
+    return endpoint;
+  }
+
+  // move the queue pair through INIT and RTR to RTS, receives are posted before it can receive
+  void Connect(const RdmaEndpoint& remote) {
+    if (remote.capacity != capacity_) {
+      throw std::runtime_error(fmt::format(
+          "RDMA ring capacities differ: {} B locally and {} B remotely", capacity_,
+          remote.capacity));
+    }
+    remote_ = remote;
+
+    ibv_qp_attr attributes{};
+    attributes.qp_state = IBV_QPS_INIT;
+    attributes.pkey_index = 0;
+    attributes.port_num = device_->port_number;
+    attributes.qp_access_flags = IBV_ACCESS_REMOTE_WRITE;
+    CheckVerbs(ibv_modify_qp(queue_pair_.get(), &attributes,
+                             IBV_QP_STATE | IBV_QP_PKEY_INDEX | IBV_QP_PORT | IBV_QP_ACCESS_FLAGS),
+               "ibv_modify_qp to INIT");
+
+    for (std::size_t i = 0; i < kReceiveQueueDepth; ++i) PostReceive();
+
+    attributes = {};
+    attributes.qp_state = IBV_QPS_RTR;
+    attributes.path_mtu = device_->port_attributes.active_mtu;
+    attributes.dest_qp_num = remote.queue_pair_number;
+    attributes.rq_psn = remote.packet_sequence_number;
+    attributes.max_dest_rd_atomic = 1;
+    attributes.min_rnr_timer = 12;
+    attributes.ah_attr.dlid = remote.lid;
+    attributes.ah_attr.port_num = device_->port_number;
+    // RoCE addresses the port by its GID, InfiniBand by its LID
+    if (device_->port_attributes.link_layer == IBV_LINK_LAYER_ETHERNET || remote.lid == 0) {
+      attributes.ah_attr.is_global = 1;
+      std::copy(remote.gid.begin(), remote.gid.end(), attributes.ah_attr.grh.dgid.raw);
+      attributes.ah_attr.grh.sgid_index = device_->gid_index;
+      attributes.ah_attr.grh.hop_limit = 1;
+    }
+    CheckVerbs(ibv_modify_qp(queue_pair_.get(), &attributes,
+                             IBV_QP_STATE | IBV_QP_AV | IBV_QP_PATH_MTU | IBV_QP_DEST_QPN |
+                                 IBV_QP_RQ_PSN | IBV_QP_MAX_DEST_RD_ATOMIC |
+                                 IBV_QP_MIN_RNR_TIMER),
+               "ibv_modify_qp to RTR");
+
+    attributes = {};
+    attributes.qp_state = IBV_QPS_RTS;
+    attributes.sq_psn = packet_sequence_number_;
+    attributes.timeout = 14;
+    attributes.retry_cnt = 7;
+    // retry infinitely while the receiver has not reposted its receives
+    attributes.rnr_retry = 7;
+    attributes.max_rd_atomic = 1;
+    CheckVerbs(ibv_modify_qp(queue_pair_.get(), &attributes,
+                             IBV_QP_STATE | IBV_QP_SQ_PSN | IBV_QP_TIMEOUT | IBV_QP_RETRY_CNT |
+                                 IBV_QP_RNR_RETRY | IBV_QP_MAX_QP_RD_ATOMIC),
+               "ibv_modify_qp to RTS");
+  }
+
+  // write all bytes into the ring of the other party, waiting for free space if necessary
+  void Write(const std::uint8_t* data, std::size_t size) {
+    RdmaBackoff backoff;
+    while (size > 0) {
+      if (closed_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Error while writing to RDMA transport: transport was shut down");
+      }
+      const auto read_position =
+          std::atomic_ref(credit_->read_position).load(std::memory_order_acquire);
+      const auto free_bytes = capacity_ - (write_position_ - read_position);
+      if (free_bytes == 0) {
+        backoff();
+        continue;
+      }
+      const auto number_of_bytes = std::min<std::size_t>(size, free_bytes);
+      const auto offset = write_position_ % capacity_;
+      const auto first_part = std::min(number_of_bytes, capacity_ - offset);
+      std::copy_n(data, first_part, staging_.get() + offset);
+      std::copy_n(data + first_part, number_of_bytes - first_part, staging_.get());
+      // the staging buffer mirrors the ring, so a part is only overwritten after the other
+      // party has read it
+      PostWrite(offset, first_part);
+      if (first_part < number_of_bytes) {
+        PostWrite(0, number_of_bytes - first_part);
+      }
+      write_position_ += number_of_bytes;
+      data += number_of_bytes;
+      size -= number_of_bytes;
+      backoff = RdmaBackoff();
+    }
+  }
+
+  // read exactly size bytes from the ring, returns false if the ring was closed before
+  bool Read(std::uint8_t* data, std::size_t size) {
+    RdmaBackoff backoff;
+    while (size > 0) {
+      PollReceives();
+      if (received_position_ == read_position_) {
+        if (peer_closed_ || closed_.load(std::memory_order_acquire)) {
+          return false;
+        }
+        // the sender may wait for the rest of the free space
+        TryReturnFreeSpace(true);
+        backoff();
+        continue;
+      }
+      const auto number_of_bytes = std::min<std::size_t>(size, received_position_ - read_position_);
+      const auto offset = read_position_ % capacity_;
+      const auto first_part = std::min(number_of_bytes, capacity_ - offset);
+      std::copy_n(ring_.get() + offset, first_part, data);
+      std::copy_n(ring_.get(), number_of_bytes - first_part, data + first_part);
+      read_position_ += number_of_bytes;
+      data += number_of_bytes;
+      size -= number_of_bytes;
+      TryReturnFreeSpace(false);
+      backoff = RdmaBackoff();
+    }
+    return true;
+  }
+
+  bool Empty() {
+    PollReceives();
+    return received_position_ == read_position_;
+  }
+
+  // tell the other party that no more data follows
+  void CloseSend() {
+    if (send_closed_) return;
+    RdmaBackoff backoff;
+    while (!TryPostSend(nullptr, 0, 0, 0, kShutdownImmediate)) backoff();
+    send_closed_ = true;
+  }
+
+  void Close() { closed_.store(true, std::memory_order_release); }
+
+ private:
+  // the immediate data of the write of a part of the ring is its size, unless it is this value
+  static constexpr std::uint32_t kShutdownImmediate{std::numeric_limits<std::uint32_t>::max()};
+  static constexpr int kSendQueueDepth{128};
+  // each write of the other party consumes a receive, so there are more receives than writes in
+  // flight
+  static constexpr int kReceiveQueueDepth{2 * kSendQueueDepth};
+
+  // word written by the other party, on its own cache line
+  struct Credit {
+    alignas(64) std::uint64_t read_position = 0;
+  };
+
+  void PostReceive() {
+    ibv_recv_wr request{};
+    ibv_recv_wr* bad_request = nullptr;
+    CheckVerbs(ibv_post_recv(queue_pair_.get(), &request, &bad_request), "ibv_post_recv");
+  }
+
+  // reap the completions of the receive queue and repost their receives
+  void PollReceives() {
+    std::array<ibv_wc, 16> completions;
+    int number_of_completions;
+    while ((number_of_completions = ibv_poll_cq(receive_queue_.get(), completions.size(),
+                                                completions.data())) > 0) {
+      for (int i = 0; i < number_of_completions; ++i) {
+        const auto& completion = completions[i];
+        if (completion.status != IBV_WC_SUCCESS) {
+          throw std::runtime_error(fmt::format("RDMA receive failed: {}",
+                                               ibv_wc_status_str(completion.status)));
+        }
+        const auto immediate = ntohl(completion.imm_data);
+        if (immediate == kShutdownImmediate) {
+          peer_closed_ = true;
+        } else {
+          received_position_ += immediate;
+        }
+        PostReceive();
+      }
+    }
+    if (number_of_completions < 0) {
+      throw std::runtime_error("Error while polling the RDMA receive completion queue");
+    }
+  }
+
+  // write the read position into the credit word of the other party once a quarter of the ring
+  // is free, or whenever there is new free space if force is set, and retry later if the send
+  // queue is full, which would otherwise block the receiver
+  void TryReturnFreeSpace(bool force) {
+    const auto new_free_space = read_position_ - returned_read_position_;
+    if (new_free_space == 0 || (!force && new_free_space < capacity_ / 4)) return;
+    if (TryPostSend(&read_position_, sizeof(read_position_), remote_.credit_address,
+                    remote_.credit_key, std::nullopt)) {
+      returned_read_position_ = read_position_;
+    }
+  }
+
+  // post the write of a part of the staging buffer into the same part of the remote ring
+  void PostWrite(std::size_t offset, std::size_t size) {
+    RdmaBackoff backoff;
+    while (!TryPostSend(staging_.get() + offset, size, remote_.ring_address + offset,
+                        remote_.ring_key, static_cast<std::uint32_t>(size))) {
+      backoff();
+    }
+  }
+
+  // post an RDMA write with immediate data if a slot of the send queue is free, small sources
+  // such as the read position are inlined
+  bool TryPostSend(const void* source, std::size_t size, std::uint64_t remote_address,
+                   std::uint32_t remote_key, std::optional<std::uint32_t> immediate) {
+    std::scoped_lock lock(send_mutex_);
+    PollSends();
+    if (number_of_outstanding_sends_ == kSendQueueDepth) return false;
+    ibv_sge element{};
+    element.addr = reinterpret_cast<std::uintptr_t>(source);
+    element.length = size;
+    element.lkey = staging_region_->lkey;
+    ibv_send_wr request{};
+    request.sg_list = size > 0 ? &element : nullptr;
+    request.num_sge = size > 0 ? 1 : 0;
+    request.wr.rdma.remote_addr = remote_address;
+    request.wr.rdma.rkey = remote_key;
+    if (immediate.has_value()) {
+      request.opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
+      request.imm_data = htonl(*immediate);
+    } else {
+      request.opcode = IBV_WR_RDMA_WRITE;
+      request.send_flags = IBV_SEND_INLINE;
+    }
+    ibv_send_wr* bad_request = nullptr;
+    CheckVerbs(ibv_post_send(queue_pair_.get(), &request, &bad_request), "ibv_post_send");
+    ++number_of_outstanding_sends_;
+    return true;
+  }
+
+  // reap the completions of the send queue, the caller holds send_mutex_
+  void PollSends() {
+    std::array<ibv_wc, 16> completions;
+    int number_of_completions;
+    while ((number_of_completions =
+                ibv_poll_cq(send_queue_.get(), completions.size(), completions.data())) > 0) {
+      for (int i = 0; i < number_of_completions; ++i) {
+        if (completions[i].status != IBV_WC_SUCCESS) {
+          throw std::runtime_error(fmt::format("RDMA write failed: {}",
+                                               ibv_wc_status_str(completions[i].status)));
+        }
+      }
+      number_of_outstanding_sends_ -= number_of_completions;
+    }
+    if (number_of_completions < 0) {
+      throw std::runtime_error("Error while polling the RDMA send completion queue");
+    }
+  }
+
+  std::shared_ptr<RdmaDevice> device_;
+  std::size_t capacity_;
+  std::unique_ptr<std::uint8_t[]> ring_;
+  std::unique_ptr<std::uint8_t[]> staging_;
+  std::unique_ptr<Credit> credit_;
+  // the queue pair is destroyed before its completion queues and the memory regions before the
+  // buffers
+  VerbsPointer<ibv_cq> send_queue_;
+  VerbsPointer<ibv_cq> receive_queue_;
+  VerbsPointer<ibv_qp> queue_pair_;
+  VerbsPointer<ibv_mr> ring_region_;
+  VerbsPointer<ibv_mr> staging_region_;
+  VerbsPointer<ibv_mr> credit_region_;
+  std::uint32_t packet_sequence_number_;
+  RdmaEndpoint remote_{};
+
+  std::mutex send_mutex_;
+  int number_of_outstanding_sends_ = 0;
+
+  // owned by the sender
+  std::uint64_t write_position_ = 0;
+  bool send_closed_ = false;
+
+  // owned by the receiver
+  std::uint64_t received_position_ = 0;
+  std::uint64_t read_position_ = 0;
+  std::uint64_t returned_read_position_ = 0;
+  bool peer_closed_ = false;
+
+  std::atomic<bool> closed_ = false;
+};
+
+}  // namespace detail
+
+RdmaTransport::RdmaTransport(std::unique_ptr<detail::RdmaConnection> connection)
+    : connection_(std::move(connection)) {}
+
+RdmaTransport::RdmaTransport(RdmaTransport&& other)
+    : Transport(std::move(other)), connection_(std::move(other.connection_)) {}
+
+RdmaTransport::~RdmaTransport() = default;
+
+static void u32tou8(std::uint32_t v, std::uint8_t* result) {
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    result[i] = (v >> i * 8) & 0xFF;
+  }
+}
+
+static std::uint32_t u8tou32(std::array<std::uint8_t, sizeof(std::uint32_t)>& v) {
+  std::uint32_t result = 0;
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    result += (v[i] << i * 8);
+  }
+  return result;
+}
+
+void RdmaTransport::SendMessage(std::span<const std::uint8_t> message) {
+  if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                         std::numeric_limits<std::uint32_t>::max(),
+                                         message.size()));
+  }
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size;
+  u32tou8(message.size(), message_size.data());
+  connection_->Write(message_size.data(), message_size.size());
+  connection_->Write(message.data(), message.size());
+  statistics_.number_of_bytes_sent += message.size() + sizeof(std::uint32_t);
+  statistics_.number_of_messages_sent += 1;
+}
+
+bool RdmaTransport::Available() const { return !connection_->Empty(); }
+
+std::optional<std::uint32_t> RdmaTransport::ReceiveMessageSize() {
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+  if (!connection_->Read(message_size_buffer.data(), message_size_buffer.size())) {
+    // the other party has shut down the transport
+    return std::nullopt;
+  }
+  return u8tou32(message_size_buffer);
+}
+
+void RdmaTransport::ReceiveMessageBody(std::uint8_t* data, std::size_t size) {
+  if (!connection_->Read(data, size)) {
+    throw std::runtime_error("Error while reading from RDMA transport: transport was shut down");
+  }
+  statistics_.number_of_bytes_received += size + sizeof(std::uint32_t);
+  statistics_.number_of_messages_received += 1;
+}
+
+std::optional<std::vector<std::uint8_t>> RdmaTransport::ReceiveMessage() {
+  auto message_size{ReceiveMessageSize()};
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message_buffer(*message_size);
+  ReceiveMessageBody(message_buffer.data(), message_buffer.size());
+  return message_buffer;
+}
+
+std::optional<MessageBuffer> RdmaTransport::ReceivePooledMessage(MessageBufferPool& pool) {
+  auto message_size{ReceiveMessageSize()};
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  auto message_buffer{pool.Acquire(*message_size)};
+  ReceiveMessageBody(message_buffer.data(), message_buffer.size());
+  return message_buffer;
+}
+
+void RdmaTransport::ShutdownSend() { connection_->CloseSend(); }
+
+void RdmaTransport::Shutdown() {
+  ShutdownSend();
+  connection_->Close();
+}
+
+RdmaSetupHelper::RdmaSetupHelper(std::size_t my_id,
+                                 const TcpPartiesConfiguration& parties_configuration,
+                                 RdmaDeviceConfiguration device_configuration)
+    : my_id_(my_id),
+      number_of_parties_(parties_configuration.size()),
+      parties_configuration_(parties_configuration),
+      device_configuration_(std::move(device_configuration)) {
+  if (number_of_parties_ <= 1) {
+    throw std::invalid_argument("specified number of parties: number_of_parties <= 1");
+  }
+  if (my_id_ >= number_of_parties_) {
+    throw std::invalid_argument("specified invalid party id: my_id >= number_of_parties");
+  }
+  // the immediate data of a write holds the size of the written part of the ring
+  if (device_configuration_.capacity == 0 ||
+      device_configuration_.capacity >= std::numeric_limits<std::uint32_t>::max()) {
+    throw std::invalid_argument(fmt::format(
+        "specified capacity of the RDMA ring buffers: {}", device_configuration_.capacity));
+  }
+}
+
+std::vector<std::unique_ptr<Transport>> RdmaSetupHelper::SetupConnections() {
+  auto device = std::make_shared<detail::RdmaDevice>(device_configuration_);
+  auto tcp_transports = TcpSetupHelper(my_id_, parties_configuration_).SetupConnections();
+  std::vector<std::unique_ptr<detail::RdmaConnection>> connections(number_of_parties_);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) continue;
+    auto& connection = connections.at(party_id);
+    connection =
+        std::make_unique<detail::RdmaConnection>(device, device_configuration_.capacity);
+    auto& tcp_transport = *tcp_transports.at(party_id);
+    tcp_transport.SendMessage(connection->GetLocalEndpoint().Serialize());
+    auto remote_endpoint = tcp_transport.ReceiveMessage();
+    if (!remote_endpoint.has_value()) {
+      throw std::runtime_error(
+          fmt::format("party {} closed the connection during the RDMA setup", party_id));
+    }
+    connection->Connect(detail::RdmaEndpoint::Deserialize(*remote_endpoint));
+  }
+  // the first write must not reach a queue pair that is not ready to receive yet
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) continue;
+    const std::array<std::uint8_t, 1> ready{1};
+    tcp_transports.at(party_id)->SendMessage(ready);
+  }
+  std::vector<std::unique_ptr<Transport>> result(number_of_parties_);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) continue;
+    auto& tcp_transport = *tcp_transports.at(party_id);
+    if (!tcp_transport.ReceiveMessage().has_value()) {
+      throw std::runtime_error(
+          fmt::format("party {} closed the connection during the RDMA setup", party_id));
+    }
+    tcp_transport.Shutdown();
+    result.at(party_id) = std::make_unique<RdmaTransport>(std::move(connections.at(party_id)));
+  }
+  return result;
+}
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tcp_transport.h"
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+class RdmaConnection;
+struct RdmaDevice;
+
+}  // namespace detail
+
+// Transport over a reliable connected InfiniBand/RoCE queue pair, which is only available if
+// MOTION is built with MOTION_BUILD_RDMA.
+// Each party registers a ring buffer for the messages it receives.  The sender copies the
+// size-prefixed messages into a registered staging buffer and writes them into the ring of the
+// receiver with one-sided RDMA writes, whose immediate data tells the receiver how many bytes
+// arrived.  The receiver returns free space by writing its read position into a registered word
+// of the sender, hence the data path does not involve any system call.  Messages larger than the
+// ring are streamed through it.
+class RdmaTransport : public Transport {
+ public:
+  // default size of the ring buffer of each direction
+  static constexpr std::size_t kDefaultCapacity{std::size_t(16) << 20};
+
+  RdmaTransport(std::unique_ptr<detail::RdmaConnection> connection);
+  RdmaTransport(RdmaTransport&& other);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~RdmaTransport();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  std::optional<MessageBuffer> ReceivePooledMessage(MessageBufferPool& pool) override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  // read the size prefix of the next message, std::nullopt if the sender shut down
+  std::optional<std::uint32_t> ReceiveMessageSize();
+  // read exactly size bytes of the message body
+  void ReceiveMessageBody(std::uint8_t* data, std::size_t size);
+
+  std::unique_ptr<detail::RdmaConnection> connection_;
+};
+
+struct RdmaDeviceConfiguration {
+  // name of the RDMA device, e.g., "mlx5_0", the first device is used if it is empty
+  std::string device_name;
+  std::uint8_t port_number = 1;
+  // index of the GID that addresses the port, which is needed for RoCE
+  int gid_index = 0;
+  // size of the ring buffer of each direction, less than 4 GiB
+  std::size_t capacity = RdmaTransport::kDefaultCapacity;
+};
+
+// Helper class to establish RDMA connections among a set of parties.  The parties first connect
+// via TCP like TcpSetupHelper, exchange the addresses of their queue pairs and the keys of their
+// registered memory regions over these connections, and close them once all queue pairs are
+// ready to send.
+class RdmaSetupHelper {
+ public:
+  RdmaSetupHelper(std::size_t my_id, const TcpPartiesConfiguration& parties_configuration,
+                  RdmaDeviceConfiguration device_configuration = {});
+
+  // Try to establish connections as described above.
+  // Throws a std::runtime_error if something goes wrong.
+  std::vector<std::unique_ptr<Transport>> SetupConnections();
+
+ private:
+  std::size_t my_id_;
+  std::size_t number_of_parties_;
+  const TcpPartiesConfiguration parties_configuration_;
+  RdmaDeviceConfiguration device_configuration_;
+};
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,212 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "recording_transport.h"
+
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+#include <flatbuffers/flatbuffers.h>
+#include <fmt/format.h>
+
+#include "message.h"
+#include "message_compression.h"
+
+namespace encrypto::motion::communication {
+
+namespace {
+
+constexpr std::array<char, 8> kRecordingMagic{'M', 'O', 'T', 'I', 'O', 'N', 'T', 'R'};
+
+bool IsSynchronizationMessage(std::span<const std::uint8_t> message) {
+  if (ReadMessageFrameHeader(message).has_value() ||
+      ReadCompressedMessageHeader(message).has_value()) {
+    return false;
+  }
+  flatbuffers::Verifier verifier(message.data(), message.size());
+  return VerifyMessageBuffer(verifier) &&
+         GetMessage(message.data())->message_type() == MessageType::kSynchronizationMessage;
+}
+
+void WriteSize(std::ofstream& file, std::uint64_t value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::uint64_t ReadSize(std::ifstream& file) {
+  std::uint64_t value{0};
+  file.read(reinterpret_cast<char*>(&value), sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+void TrafficRecording::Save(const std::filesystem::path& path) const {
+  std::ofstream file(path, std::ios::binary);
+  file.write(kRecordingMagic.data(), kRecordingMagic.size());
+  WriteSize(file, messages.size());
+  for (const auto& message : messages) {
+    WriteSize(file, message.number_of_synchronizations);
+    WriteSize(file, message.bytes.size());
+    file.write(reinterpret_cast<const char*>(message.bytes.data()),
+               static_cast<std::streamsize>(message.bytes.size()));
+  }
+  if (!file) {
+    throw std::runtime_error(
+        fmt::format("could not write the traffic recording {}", path.string()));
+  }
+}
+
+TrafficRecording TrafficRecording::Load(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::array<char, kRecordingMagic.size()> magic{};
+  file.read(magic.data(), magic.size());
+  if (!file || magic != kRecordingMagic) {
+    throw std::runtime_error(fmt::format("{} is no traffic recording", path.string()));
+  }
+  TrafficRecording recording;
+  const auto number_of_messages{ReadSize(file)};
+  for (std::uint64_t i = 0; i < number_of_messages && file; ++i) {
+    auto& message{recording.messages.emplace_back()};
+    message.number_of_synchronizations = ReadSize(file);
+    message.bytes.resize(ReadSize(file));
+    file.read(reinterpret_cast<char*>(message.bytes.data()),
+              static_cast<std::streamsize>(message.bytes.size()));
+  }
+  if (!file) {
+    throw std::runtime_error(fmt::format("the traffic recording {} is truncated", path.string()));
+  }
+  return recording;
+}
+
+RecordingTransport::RecordingTransport(std::unique_ptr<Transport> transport,
+                                       std::shared_ptr<TrafficRecording> recording)
+    : transport_(std::move(transport)), recording_(std::move(recording)) {}
+
+void RecordingTransport::CountSynchronization(std::span<const std::uint8_t> message) {
+  if (IsSynchronizationMessage(message)) {
+    ++number_of_synchronizations_;
+  }
+}
+
+void RecordingTransport::UpdateStatistics() { statistics_ = transport_->GetStatistics(); }
+
+void RecordingTransport::SendMessage(std::span<const std::uint8_t> message) {
+  CountSynchronization(message);
+  transport_->SendMessage(message);
+  UpdateStatistics();
+}
+
+void RecordingTransport::SendMessages(std::span<const std::span<const std::uint8_t>> messages) {
+  for (auto message : messages) {
+    CountSynchronization(message);
+  }
+  transport_->SendMessages(messages);
+  UpdateStatistics();
+}
+
+bool RecordingTransport::Available() const { return transport_->Available(); }
+
+std::optional<std::vector<std::uint8_t>> RecordingTransport::ReceiveMessage() {
+  auto message{transport_->ReceiveMessage()};
+  if (message.has_value()) {
+    recording_->messages.push_back({number_of_synchronizations_, *message});
+  }
+  UpdateStatistics();
+  return message;
+}
+
+std::optional<MessageBuffer> RecordingTransport::ReceivePooledMessage(MessageBufferPool& pool) {
+  auto message{transport_->ReceivePooledMessage(pool)};
+  if (message.has_value()) {
+    const auto bytes{message->GetSpan()};
+    recording_->messages.push_back(
+        {number_of_synchronizations_, std::vector<std::uint8_t>(bytes.begin(), bytes.end())});
+  }
+  UpdateStatistics();
+  return message;
+}
+
+void RecordingTransport::ShutdownSend() { transport_->ShutdownSend(); }
+
+void RecordingTransport::Shutdown() { transport_->Shutdown(); }
+
+ReplayTransport::ReplayTransport(TrafficRecording recording) : recording_(std::move(recording)) {}
+
+void ReplayTransport::SendMessage(std::span<const std::uint8_t> message) {
+  ++statistics_.number_of_messages_sent;
+  statistics_.number_of_bytes_sent += message.size();
+  if (IsSynchronizationMessage(message)) {
+    {
+      std::scoped_lock lock(mutex_);
+      ++number_of_synchronizations_;
+    }
+    condition_variable_.notify_all();
+  }
+}
+
+bool ReplayTransport::IsNextMessageReady() const {
+  return number_of_received_messages_ < recording_.messages.size() &&
+         recording_.messages[number_of_received_messages_].number_of_synchronizations <=
+             number_of_synchronizations_;
+}
+
+bool ReplayTransport::Available() const {
+  std::scoped_lock lock(mutex_);
+  return IsNextMessageReady();
+}
+
+std::optional<std::vector<std::uint8_t>> ReplayTransport::ReceiveMessage() {
+  std::unique_lock lock(mutex_);
+  condition_variable_.wait(lock, [this] { return is_shut_down_ || IsNextMessageReady(); });
+  if (!IsNextMessageReady()) {
+    return std::nullopt;
+  }
+  auto message{std::move(recording_.messages[number_of_received_messages_++].bytes)};
+  ++statistics_.number_of_messages_received;
+  statistics_.number_of_bytes_received += message.size();
+  return message;
+}
+
+void ReplayTransport::ShutdownSend() {}
+
+void ReplayTransport::Shutdown() {
+  {
+    std::scoped_lock lock(mutex_);
+    is_shut_down_ = true;
+  }
+  condition_variable_.notify_all();
+}
+
+std::vector<std::shared_ptr<TrafficRecording>> MakeRecordingTransports(
+    std::vector<std::unique_ptr<Transport>>& transports) {
+  std::vector<std::shared_ptr<TrafficRecording>> recordings(transports.size());
+  for (std::size_t i = 0; i < transports.size(); ++i) {
+    if (transports[i]) {
+      recordings[i] = std::make_shared<TrafficRecording>();
+      transports[i] = std::make_unique<RecordingTransport>(std::move(transports[i]), recordings[i]);
+    }
+  }
+  return recordings;
+}
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+// The messages received from one party over a transport, recorded by a RecordingTransport and fed
+// back by a ReplayTransport, such that one party can be benchmarked without the other parties and
+// the network. See BaseProvider::SetSeeds for reproducing the randomness of the recorded party.
+struct TrafficRecording {
+  struct Message {
+    // number of synchronization messages sent to the party before the message was received, which
+    // the replaying party needs to have sent as well before it receives the message
+    std::size_t number_of_synchronizations;
+    std::vector<std::uint8_t> bytes;
+  };
+
+  std::vector<Message> messages;
+
+  // Writes the recording to a binary file, throws a std::runtime_error if this fails.
+  void Save(const std::filesystem::path& path) const;
+
+  // Reads a recording written by Save, throws a std::runtime_error if the file cannot be read or is
+  // no recording.
+  static TrafficRecording Load(const std::filesystem::path& path);
+};
+
+// Decorator for a transport which appends every received message to a TrafficRecording, which may
+// be read once the transport is shut down. Both the recorded and the replaying party need to send
+// their messages unbatched and unprioritized (the default) for the synchronizations to be counted.
+class RecordingTransport : public Transport {
+ public:
+  RecordingTransport(std::unique_ptr<Transport> transport,
+                     std::shared_ptr<TrafficRecording> recording);
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+  void SendMessages(std::span<const std::span<const std::uint8_t>> messages) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  std::optional<MessageBuffer> ReceivePooledMessage(MessageBufferPool& pool) override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  void CountSynchronization(std::span<const std::uint8_t> message);
+  void UpdateStatistics();
+
+  std::unique_ptr<Transport> transport_;
+  std::shared_ptr<TrafficRecording> recording_;
+  std::atomic<std::size_t> number_of_synchronizations_{0};
+};
+
+// Transport which receives the messages of a TrafficRecording instead of the messages of another
+// party, each as soon as this party has sent as many synchronization messages as in the recording,
+// and discards the sent messages. Once all recorded messages were received, which ends with the
+// termination message of the other party, it waits for the shutdown.
+class ReplayTransport : public Transport {
+ public:
+  explicit ReplayTransport(TrafficRecording recording);
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  // needs to be called with the mutex locked
+  bool IsNextMessageReady() const;
+
+  TrafficRecording recording_;
+  std::size_t number_of_received_messages_{0};
+  std::size_t number_of_synchronizations_{0};
+  bool is_shut_down_{false};
+  mutable std::mutex mutex_;
+  std::condition_variable condition_variable_;
+};
+
+// Wrap each of the transports into a RecordingTransport and return the recordings in the same
+// order, with nullptr in place of missing transports
+std::vector<std::shared_ptr<TrafficRecording>> MakeRecordingTransports(
+    std::vector<std::unique_ptr<Transport>>& transports);
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,402 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "shared_memory_transport.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+// control block at the beginning of each segment, followed by the ring of capacity bytes
+struct SharedMemoryRingHeader {
+  static constexpr std::uint64_t kMagic{0x4d4f54494f4e5348};  // "MOTIONSH"
+
+  // set last by the creator, the other fields are valid once it is kMagic
+  std::atomic<std::uint64_t> magic;
+  std::uint64_t capacity;
+  // total number of bytes written and read, the producer and consumer own one each
+  alignas(64) std::atomic<std::uint64_t> head;
+  alignas(64) std::atomic<std::uint64_t> tail;
+  // set if the sender or the receiver shut down the ring
+  alignas(64) std::atomic<bool> closed;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+static_assert(std::atomic<bool>::is_always_lock_free);
+
+// spin for a while, then yield, then sleep while waiting for the other side
+class Backoff {
+ public:
+  void operator()() {
+    if (iteration_ < kNumberOfSpins) {
+      ++iteration_;
+    } else if (iteration_ < kNumberOfSpins + kNumberOfYields) {
+      ++iteration_;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+ private:
+  static constexpr std::size_t kNumberOfSpins = 1000;
+  static constexpr std::size_t kNumberOfYields = 1000;
+  std::size_t iteration_ = 0;
+};
+
+// a mapped shared memory segment containing one ring buffer
+class SharedMemorySegment {
+ public:
+  // create a new segment, replacing a stale one of the same name
+  static std::unique_ptr<SharedMemorySegment> Create(const std::string& name,
+                                                     std::size_t capacity) {
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1 && errno == EEXIST) {
+      shm_unlink(name.c_str());
+      fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    }
+    if (fd == -1) {
+      throw std::runtime_error(
+          fmt::format("cannot create shared memory segment {}: {}", name, std::strerror(errno)));
+    }
+    const auto size = sizeof(SharedMemoryRingHeader) + capacity;
+    if (ftruncate(fd, static_cast<off_t>(size)) == -1) {
+      const auto error = errno;
+      close(fd);
+      shm_unlink(name.c_str());
+      throw std::runtime_error(
+          fmt::format("cannot resize shared memory segment {}: {}", name, std::strerror(error)));
+    }
+    auto segment = std::unique_ptr<SharedMemorySegment>(new SharedMemorySegment(name, fd, size));
+    segment->is_owner_ = true;
+    auto header = new (segment->address_) SharedMemoryRingHeader;
+    header->capacity = capacity;
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_relaxed);
+    header->closed.store(false, std::memory_order_relaxed);
+    header->magic.store(SharedMemoryRingHeader::kMagic, std::memory_order_release);
+    return segment;
+  }
+
+  // open a segment created by another party, waiting until it is initialized
+  static std::unique_ptr<SharedMemorySegment> Open(const std::string& name,
+                                                   std::chrono::steady_clock::time_point deadline) {
+    while (true) {
+      if (int fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR); fd != -1) {
+        struct stat status;
+        if (fstat(fd, &status) == 0 &&
+            static_cast<std::size_t>(status.st_size) > sizeof(SharedMemoryRingHeader)) {
+          auto segment = std::unique_ptr<SharedMemorySegment>(
+              new SharedMemorySegment(name, fd, static_cast<std::size_t>(status.st_size)));
+          auto& header = segment->GetHeader();
+          Backoff backoff;
+          while (header.magic.load(std::memory_order_acquire) != SharedMemoryRingHeader::kMagic) {
+            if (std::chrono::steady_clock::now() > deadline) {
+              throw std::runtime_error(
+                  fmt::format("shared memory segment {} was not initialized in time", name));
+            }
+            backoff();
+          }
+          if (sizeof(SharedMemoryRingHeader) + header.capacity != segment->size_) {
+            throw std::runtime_error(
+                fmt::format("shared memory segment {} has an unexpected size", name));
+          }
+          return segment;
+        }
+        // the creator did not resize the segment yet
+        close(fd);
+      } else if (errno != ENOENT) {
+        throw std::runtime_error(
+            fmt::format("cannot open shared memory segment {}: {}", name, std::strerror(errno)));
+      }
+      if (std::chrono::steady_clock::now() > deadline) {
+        throw std::runtime_error(
+            fmt::format("timeout while waiting for shared memory segment {}", name));
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  ~SharedMemorySegment() {
+    munmap(address_, size_);
+    if (is_owner_) {
+      shm_unlink(name_.c_str());
+    }
+  }
+
+  SharedMemorySegment(const SharedMemorySegment&) = delete;
+
+  // write all bytes to the ring, waiting for free space if necessary
+  void Write(const std::uint8_t* data, std::size_t size) {
+    auto& header = GetHeader();
+    const auto capacity = header.capacity;
+    auto head = header.head.load(std::memory_order_relaxed);
+    Backoff backoff;
+    while (size > 0) {
+      if (header.closed.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Error while writing to shared memory: transport was shut down");
+      }
+      const auto tail = header.tail.load(std::memory_order_acquire);
+      const auto free_bytes = capacity - (head - tail);
+      if (free_bytes == 0) {
+        backoff();
+        continue;
+      }
+      const auto number_of_bytes = std::min<std::size_t>(size, free_bytes);
+      Copy(head % capacity, number_of_bytes, [this, data](std::size_t offset, std::size_t i,
+                                                          std::size_t n) {
+        std::copy_n(data + i, n, GetRing() + offset);
+      });
+      head += number_of_bytes;
+      header.head.store(head, std::memory_order_release);
+      data += number_of_bytes;
+      size -= number_of_bytes;
+      backoff = Backoff();
+    }
+  }
+
+  // read exactly size bytes from the ring, returns false if the ring was closed before
+  bool Read(std::uint8_t* data, std::size_t size) {
+    auto& header = GetHeader();
+    const auto capacity = header.capacity;
+    auto tail = header.tail.load(std::memory_order_relaxed);
+    Backoff backoff;
+    while (size > 0) {
+      const auto head = header.head.load(std::memory_order_acquire);
+      if (head == tail) {
+        if (header.closed.load(std::memory_order_acquire) &&
+            header.head.load(std::memory_order_acquire) == tail) {
+          return false;
+        }
+        backoff();
+        continue;
+      }
+      const auto number_of_bytes = std::min<std::size_t>(size, head - tail);
+      Copy(tail % capacity, number_of_bytes, [this, data](std::size_t offset, std::size_t i,
+                                                          std::size_t n) {
+        std::copy_n(GetRing() + offset, n, data + i);
+      });
+      tail += number_of_bytes;
+      header.tail.store(tail, std::memory_order_release);
+      data += number_of_bytes;
+      size -= number_of_bytes;
+      backoff = Backoff();
+    }
+    return true;
+  }
+
+  bool Empty() const {
+    auto& header = GetHeader();
+    return header.head.load(std::memory_order_acquire) ==
+           header.tail.load(std::memory_order_acquire);
+  }
+
+  void Close() { GetHeader().closed.store(true, std::memory_order_release); }
+
+ private:
+  SharedMemorySegment(std::string name, int fd, std::size_t size) : name_(std::move(name)) {
+    address_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const auto error = errno;
+    close(fd);
+    if (address_ == MAP_FAILED) {
+      throw std::runtime_error(
+          fmt::format("cannot map shared memory segment {}: {}", name_, std::strerror(error)));
+    }
+    size_ = size;
+  }
+
+  // call copy(ring offset, data offset, number of bytes) for the at most two contiguous parts of
+  // the ring starting at offset
+  template <typename CopyFunction>
+  void Copy(std::size_t offset, std::size_t size, CopyFunction copy) {
+    const auto capacity = GetHeader().capacity;
+    const auto first_part = std::min(size, capacity - offset);
+    copy(offset, 0, first_part);
+    if (first_part < size) {
+      copy(0, first_part, size - first_part);
+    }
+  }
+
+  SharedMemoryRingHeader& GetHeader() const {
+    return *reinterpret_cast<SharedMemoryRingHeader*>(address_);
+  }
+
+  std::uint8_t* GetRing() const {
+    return reinterpret_cast<std::uint8_t*>(address_) + sizeof(SharedMemoryRingHeader);
+  }
+
+  std::string name_;
+  void* address_ = nullptr;
+  std::size_t size_ = 0;
+  bool is_owner_ = false;
+};
+
+}  // namespace detail
+
+SharedMemoryTransport::SharedMemoryTransport(
+    std::unique_ptr<detail::SharedMemorySegment> send_segment,
+    std::unique_ptr<detail::SharedMemorySegment> receive_segment)
+    : send_segment_(std::move(send_segment)), receive_segment_(std::move(receive_segment)) {}
+
+SharedMemoryTransport::SharedMemoryTransport(SharedMemoryTransport&& other)
+    : Transport(std::move(other)),
+      send_segment_(std::move(other.send_segment_)),
+      receive_segment_(std::move(other.receive_segment_)) {}
+
+SharedMemoryTransport::~SharedMemoryTransport() = default;
+
+static void u32tou8(std::uint32_t v, std::uint8_t* result) {
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    result[i] = (v >> i * 8) & 0xFF;
+  }
+}
+
+static std::uint32_t u8tou32(std::array<std::uint8_t, sizeof(std::uint32_t)>& v) {
+  std::uint32_t result = 0;
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    result += (v[i] << i * 8);
+  }
+  return result;
+}
+
+void SharedMemoryTransport::SendMessage(std::span<const std::uint8_t> message) {
+  if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                         std::numeric_limits<std::uint32_t>::max(),
+                                         message.size()));
+  }
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size;
+  u32tou8(message.size(), message_size.data());
+  send_segment_->Write(message_size.data(), message_size.size());
+  send_segment_->Write(message.data(), message.size());
+  statistics_.number_of_bytes_sent += message.size() + sizeof(std::uint32_t);
+  statistics_.number_of_messages_sent += 1;
+}
+
+bool SharedMemoryTransport::Available() const { return !receive_segment_->Empty(); }
+
+std::optional<std::uint32_t> SharedMemoryTransport::ReceiveMessageSize() {
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+  if (!receive_segment_->Read(message_size_buffer.data(), message_size_buffer.size())) {
+    // the other party has shut down the transport
+    return std::nullopt;
+  }
+  return u8tou32(message_size_buffer);
+}
+
+void SharedMemoryTransport::ReceiveMessageBody(std::uint8_t* data, std::size_t size) {
+  if (!receive_segment_->Read(data, size)) {
+    throw std::runtime_error("Error while reading from shared memory: transport was shut down");
+  }
+  statistics_.number_of_bytes_received += size + sizeof(std::uint32_t);
+  statistics_.number_of_messages_received += 1;
+}
+
+std::optional<std::vector<std::uint8_t>> SharedMemoryTransport::ReceiveMessage() {
+  auto message_size{ReceiveMessageSize()};
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message_buffer(*message_size);
+  ReceiveMessageBody(message_buffer.data(), message_buffer.size());
+  return message_buffer;
+}
+
+std::optional<MessageBuffer> SharedMemoryTransport::ReceivePooledMessage(MessageBufferPool& pool) {
+  auto message_size{ReceiveMessageSize()};
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  auto message_buffer{pool.Acquire(*message_size)};
+  ReceiveMessageBody(message_buffer.data(), message_buffer.size());
+  return message_buffer;
+}
+
+void SharedMemoryTransport::ShutdownSend() { send_segment_->Close(); }
+
+void SharedMemoryTransport::Shutdown() {
+  ShutdownSend();
+  receive_segment_->Close();
+}
+
+SharedMemorySetupHelper::SharedMemorySetupHelper(std::size_t my_id, std::size_t number_of_parties,
+                                                 std::string session_name, std::size_t capacity)
+    : my_id_(my_id),
+      number_of_parties_(number_of_parties),
+      session_name_(std::move(session_name)),
+      capacity_(capacity) {
+  if (number_of_parties_ <= 1) {
+    throw std::invalid_argument("specified number of parties: number_of_parties <= 1");
+  }
+  if (my_id_ >= number_of_parties_) {
+    throw std::invalid_argument("specified invalid party id: my_id >= number_of_parties");
+  }
+  if (capacity_ == 0) {
+    throw std::invalid_argument("specified capacity of the shared memory ring buffers: 0");
+  }
+}
+
+std::vector<std::unique_ptr<Transport>> SharedMemorySetupHelper::SetupConnections(
+    std::chrono::milliseconds timeout) {
+  auto segment_name = [this](std::size_t sender_id, std::size_t receiver_id) {
+    return fmt::format("/{}-{}-{}", session_name_, sender_id, receiver_id);
+  };
+  // create all own segments first such that no party waits for another one in a cycle
+  std::vector<std::unique_ptr<detail::SharedMemorySegment>> send_segments(number_of_parties_);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id != my_id_) {
+      send_segments.at(party_id) =
+          detail::SharedMemorySegment::Create(segment_name(my_id_, party_id), capacity_);
+    }
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  std::vector<std::unique_ptr<Transport>> result(number_of_parties_);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id != my_id_) {
+      auto receive_segment =
+          detail::SharedMemorySegment::Open(segment_name(party_id, my_id_), deadline);
+      result.at(party_id) = std::make_unique<SharedMemoryTransport>(
+          std::move(send_segments.at(party_id)), std::move(receive_segment));
+    }
+  }
+  return result;
+}
+
+}  // namespace encrypto::motion::communication
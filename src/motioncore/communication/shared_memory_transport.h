@@ -0,0 +1,102 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+class SharedMemorySegment;
+
+}  // namespace detail
+
+// Transport between two processes on the same host.
+// Each direction is a lock-free single-producer single-consumer ring buffer in a POSIX shared
+// memory segment, hence messages are copied into and out of the ring without any system call or
+// kernel copy.  Messages larger than the ring are streamed through it.
+class SharedMemoryTransport : public Transport {
+ public:
+  // default size of each of the two ring buffers
+  static constexpr std::size_t kDefaultCapacity{std::size_t(16) << 20};
+
+  SharedMemoryTransport(std::unique_ptr<detail::SharedMemorySegment> send_segment,
+                        std::unique_ptr<detail::SharedMemorySegment> receive_segment);
+  SharedMemoryTransport(SharedMemoryTransport&& other);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~SharedMemoryTransport();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  std::optional<MessageBuffer> ReceivePooledMessage(MessageBufferPool& pool) override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  // read the size prefix of the next message, std::nullopt if the sender shut down
+  std::optional<std::uint32_t> ReceiveMessageSize();
+  // read exactly size bytes of the message body
+  void ReceiveMessageBody(std::uint8_t* data, std::size_t size);
+
+  std::unique_ptr<detail::SharedMemorySegment> send_segment_;
+  std::unique_ptr<detail::SharedMemorySegment> receive_segment_;
+};
+
+// Helper class to establish shared memory connections among a set of parties running on the same
+// host.  Every party creates the segments for the messages it sends, named
+// "/<session_name>-<sender id>-<receiver id>", and then opens the segments of the messages it
+// receives as soon as the other parties created them.  Segments are removed from the file system
+// when the transport of their creator is destroyed.
+class SharedMemorySetupHelper {
+ public:
+  SharedMemorySetupHelper(std::size_t my_id, std::size_t number_of_parties,
+                          std::string session_name,
+                          std::size_t capacity = SharedMemoryTransport::kDefaultCapacity);
+
+  // Try to establish connections as described above.
+  // Throws a std::runtime_error if something goes wrong or another party does not create its
+  // segment within the timeout.
+  std::vector<std::unique_ptr<Transport>> SetupConnections(
+      std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+ private:
+  std::size_t my_id_;
+  std::size_t number_of_parties_;
+  std::string session_name_;
+  std::size_t capacity_;
+};
+
+}  // namespace encrypto::motion::communication
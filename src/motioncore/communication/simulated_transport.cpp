@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "simulated_transport.h"
+
+#include <algorithm>
+#include <regex>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion::communication {
+
+NetworkProfile NetworkProfile::FromString(const std::string& profile) {
+  using namespace std::chrono_literals;
+  if (profile == "lan") {
+    return {.latency = 250us, .jitter = 0us, .bandwidth = 1e9};
+  } else if (profile == "wan") {
+    return {.latency = 50ms, .jitter = 1ms, .bandwidth = 100e6};
+  }
+  static const std::regex kProfileRegex(
+      "(\\d+(?:\\.\\d+)?),(\\d+(?:\\.\\d+)?)(?:,(\\d+(?:\\.\\d+)?))?");
+  std::smatch match;
+  if (!std::regex_match(profile, match, kProfileRegex)) {
+    throw std::invalid_argument(fmt::format("invalid network profile: {}", profile));
+  }
+  auto milliseconds = [](const std::string& value) {
+    return std::chrono::microseconds(static_cast<std::int64_t>(std::stod(value) * 1000));
+  };
+  return {.latency = milliseconds(match[1]),
+          .jitter = match[3].matched ? milliseconds(match[3]) : 0us,
+          .bandwidth = std::stod(match[2]) * 1e6};
+}
+
+SimulatedTransport::SimulatedTransport(std::unique_ptr<Transport> transport, NetworkProfile profile)
+    : transport_(std::move(transport)),
+      profile_(profile),
+      link_free_time_(Clock::now()),
+      last_arrival_time_(link_free_time_),
+      delay_thread_([this] { DelayTask(); }) {}
+
+SimulatedTransport::~SimulatedTransport() {
+  delay_line_.close();
+  if (delay_thread_.joinable()) {
+    delay_thread_.join();
+  }
+}
+
+void SimulatedTransport::SendMessage(std::span<const std::uint8_t> message) {
+  const auto now{Clock::now()};
+  // the message is queued at the link until the previous messages are transmitted
+  auto transmission_time{Clock::duration::zero()};
+  if (profile_.bandwidth > 0) {
+    transmission_time = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(8.0 * message.size() / profile_.bandwidth));
+  }
+  link_free_time_ = std::max(link_free_time_, now) + transmission_time;
+  auto arrival_time{link_free_time_ + profile_.latency};
+  if (profile_.jitter.count() > 0) {
+    std::uniform_int_distribution<std::int64_t> distribution(0, profile_.jitter.count());
+    arrival_time += std::chrono::microseconds(distribution(random_number_generator_));
+  }
+  last_arrival_time_ = std::max(last_arrival_time_, arrival_time);
+  delay_line_.enqueue(DelayedMessage{last_arrival_time_, {message.begin(), message.end()}});
+}
+
+void SimulatedTransport::DelayTask() {
+  while (auto delayed_message{delay_line_.dequeue()}) {
+    std::this_thread::sleep_until(delayed_message->arrival_time);
+    transport_->SendMessage(delayed_message->message);
+    const auto& statistics{transport_->GetStatistics()};
+    statistics_.number_of_messages_sent = statistics.number_of_messages_sent;
+    statistics_.number_of_bytes_sent = statistics.number_of_bytes_sent;
+    statistics_.number_of_send_calls = statistics.number_of_send_calls;
+  }
+}
+
+void SimulatedTransport::UpdateReceiveStatistics() {
+  const auto& statistics{transport_->GetStatistics()};
+  statistics_.number_of_messages_received = statistics.number_of_messages_received;
+  statistics_.number_of_bytes_received = statistics.number_of_bytes_received;
+}
+
+bool SimulatedTransport::Available() const { return transport_->Available(); }
+
+std::optional<std::vector<std::uint8_t>> SimulatedTransport::ReceiveMessage() {
+  auto message{transport_->ReceiveMessage()};
+  UpdateReceiveStatistics();
+  return message;
+}
+
+std::optional<MessageBuffer> SimulatedTransport::ReceivePooledMessage(MessageBufferPool& pool) {
+  auto message{transport_->ReceivePooledMessage(pool)};
+  UpdateReceiveStatistics();
+  return message;
+}
+
+void SimulatedTransport::ShutdownSend() {
+  if (is_send_shut_down_) {
+    return;
+  }
+  // deliver all messages still in flight first
+  delay_line_.close();
+  delay_thread_.join();
+  transport_->ShutdownSend();
+  is_send_shut_down_ = true;
+}
+
+void SimulatedTransport::Shutdown() {
+  ShutdownSend();
+  transport_->Shutdown();
+}
+
+std::vector<std::unique_ptr<Transport>> MakeSimulatedTransports(
+    std::vector<std::unique_ptr<Transport>>&& transports, const NetworkProfile& profile) {
+  for (auto& transport : transports) {
+    if (transport) {
+      transport = std::make_unique<SimulatedTransport>(std::move(transport), profile);
+    }
+  }
+  return std::move(transports);
+}
+
+}  // namespace encrypto::motion::communication
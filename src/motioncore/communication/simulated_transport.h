@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "transport.h"
+#include "utility/synchronized_queue.h"
+
+namespace encrypto::motion::communication {
+
+// characteristics of a simulated network link
+struct NetworkProfile {
+  // one-way delay of every message
+  std::chrono::microseconds latency{0};
+  // maximum additional delay, uniformly distributed, messages are not reordered
+  std::chrono::microseconds jitter{0};
+  // capacity of the link in bit/s, 0 means unlimited
+  double bandwidth = 0;
+
+  // Parse a named profile, i.e., "lan" (0.25 ms, 1 Gbit/s) or "wan" (50 ms, 100 Mbit/s, 1 ms
+  // jitter), or a custom profile "<latency ms>,<bandwidth Mbit/s>[,<jitter ms>]".
+  // Throws a std::invalid_argument for other strings.
+  static NetworkProfile FromString(const std::string& profile);
+};
+
+// Decorator for a transport which delays outgoing messages as if they were sent over a link with
+// the given NetworkProfile.  Messages are copied into a delay line and handed on to the wrapped
+// transport by a separate thread once they would have arrived, so that the latency of consecutive
+// messages overlaps as in a real network.  Incoming messages are passed through, since they were
+// already delayed by the other party's simulated transport.
+class SimulatedTransport : public Transport {
+ public:
+  SimulatedTransport(std::unique_ptr<Transport> transport, NetworkProfile profile);
+  ~SimulatedTransport();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  std::optional<MessageBuffer> ReceivePooledMessage(MessageBufferPool& pool) override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  struct DelayedMessage {
+    Clock::time_point arrival_time;
+    std::vector<std::uint8_t> message;
+  };
+
+  void DelayTask();
+  void UpdateReceiveStatistics();
+
+  std::unique_ptr<Transport> transport_;
+  NetworkProfile profile_;
+  std::mt19937_64 random_number_generator_{std::random_device{}()};
+  // time at which the link finished transmitting the last message
+  Clock::time_point link_free_time_;
+  Clock::time_point last_arrival_time_;
+  SynchronizedQueue<DelayedMessage> delay_line_;
+  std::thread delay_thread_;
+  bool is_send_shut_down_ = false;
+};
+
+// Wrap each of the transports, e.g., the result of TcpSetupHelper::SetupConnections, into a
+// SimulatedTransport with the given profile
+std::vector<std::unique_ptr<Transport>> MakeSimulatedTransports(
+    std::vector<std::unique_ptr<Transport>>&& transports, const NetworkProfile& profile);
+
+}  // namespace encrypto::motion::communication
@@ -22,16 +22,27 @@
 
 #include "tcp_transport.h"
 
+#include <algorithm>
 #include <chrono>
+#include <exception>
 #include <future>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <shared_mutex>
+#include <span>
+#include <thread>
+#include <vector>
 
 #include <fmt/format.h>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/error.hpp>
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/read.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/system/error_code.hpp>
 
@@ -46,13 +57,55 @@ namespace encrypto::motion::communication {
 
 namespace detail {
 
+// Runs the io_context shared by the transports of one TcpSetupHelper on a single thread, which is
+// started with the first asynchronous operation and stopped once the last transport is destroyed.
+class TcpEventLoop {
+ public:
+  explicit TcpEventLoop(std::shared_ptr<boost::asio::io_context> io_context)
+      : io_context_(std::move(io_context)) {}
+
+  ~TcpEventLoop() {
+    if (thread_.joinable()) {
+      work_guard_.reset();
+      io_context_->stop();
+      thread_.join();
+    }
+  }
+
+  // run function on the event loop thread
+  template <typename Function>
+  void Post(Function&& function) {
+    std::call_once(start_flag_, [this] {
+      work_guard_.emplace(io_context_->get_executor());
+      io_context_->restart();
+      thread_ = std::thread([this] { io_context_->run(); });
+    });
+    boost::asio::post(*io_context_, std::forward<Function>(function));
+  }
+
+ private:
+  std::shared_ptr<boost::asio::io_context> io_context_;
+  std::optional<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
+      work_guard_;
+  std::once_flag start_flag_;
+  std::thread thread_;
+};
+
 struct TcpTransportImplementation {
   TcpTransportImplementation(std::shared_ptr<boost::asio::io_context> io_context,
-                             tcp::socket&& socket)
-      : io_context_(io_context), socket_(std::move(socket)) {}
+                             tcp::socket&& socket, std::vector<tcp::socket>&& stripe_sockets = {},
+                             std::shared_ptr<TcpEventLoop> event_loop = nullptr)
+      : io_context_(io_context),
+        socket_(std::move(socket)),
+        stripe_sockets_(std::move(stripe_sockets)),
+        event_loop_(std::move(event_loop)) {}
   std::shared_ptr<boost::asio::io_context> io_context_;
+  // carries the size prefixes, small messages and the first stripe of each large message
   boost::asio::ip::tcp::socket socket_;
+  // carry the remaining stripes of large messages
+  std::vector<boost::asio::ip::tcp::socket> stripe_sockets_;
   std::shared_mutex socket_mutex_;
+  std::shared_ptr<TcpEventLoop> event_loop_;
 };
 
 }  // namespace detail
@@ -75,6 +128,9 @@ void TcpTransport::ShutdownSend() {
   std::scoped_lock lock(implementation_->socket_mutex_);
   boost::system::error_code ec;
   implementation_->socket_.shutdown(tcp::socket::shutdown_send, ec);
+  for (auto& socket : implementation_->stripe_sockets_) {
+    socket.shutdown(tcp::socket::shutdown_send, ec);
+  }
 }
 
 void TcpTransport::Shutdown() {
@@ -82,6 +138,24 @@ void TcpTransport::Shutdown() {
   boost::system::error_code ec;
   implementation_->socket_.shutdown(tcp::socket::shutdown_both, ec);
   implementation_->socket_.close(ec);
+  for (auto& socket : implementation_->stripe_sockets_) {
+    socket.shutdown(tcp::socket::shutdown_both, ec);
+    socket.close(ec);
+  }
+}
+
+bool TcpTransport::IsStriped(std::size_t message_size) const {
+  return !implementation_->stripe_sockets_.empty() && message_size >= kMinStripedMessageSize;
+}
+
+// returns offset and size of the i-th of number_of_stripes stripes of a message
+static std::pair<std::size_t, std::size_t> GetStripe(std::size_t message_size,
+                                                     std::size_t number_of_stripes,
+                                                     std::size_t i) {
+  const auto stripe_size = (message_size + number_of_stripes - 1) / number_of_stripes;
+  const auto begin = std::min(message_size, i * stripe_size);
+  const auto end = std::min(message_size, (i + 1) * stripe_size);
+  return {begin, end - begin};
 }
 
 static void u32tou8(std::uint32_t v, std::uint8_t* result) {
@@ -90,26 +164,94 @@ static void u32tou8(std::uint32_t v, std::uint8_t* result) {
   }
 }
 
-void TcpTransport::SendMessage(std::span<const std::uint8_t> message) {
-  if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
-    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
-                                         std::numeric_limits<std::uint32_t>::max(),
-                                         message.size()));
+// maximum number of buffers passed to a single vectored write
+constexpr std::size_t kMaxNumberOfBuffersPerWrite = 64;
+
+// write all buffers to the socket and count the system calls this took
+static void WriteBuffers(tcp::socket& socket, std::span<boost::asio::const_buffer> buffers,
+                         std::size_t& number_of_send_calls) {
+  auto first = buffers.begin();
+  while (true) {
+    while (first != buffers.end() && first->size() == 0) {
+      ++first;
+    }
+    if (first == buffers.end()) {
+      break;
+    }
+    const auto number_of_buffers =
+        std::min<std::size_t>(kMaxNumberOfBuffersPerWrite, buffers.end() - first);
+    boost::system::error_code ec;
+    auto bytes_written = socket.write_some(std::span(first, number_of_buffers), ec);
+    ++number_of_send_calls;
+    if (ec) {
+      throw std::runtime_error(fmt::format("Error while writing to socket: {}", ec.message()));
+    }
+    // skip the completely written buffers and advance the partially written one
+    while (bytes_written > 0) {
+      if (bytes_written >= first->size()) {
+        bytes_written -= first->size();
+        ++first;
+      } else {
+        *first += bytes_written;
+        bytes_written = 0;
+      }
+    }
   }
-  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size;
-  u32tou8(message.size(), message_size.data());
+}
 
-  std::array<boost::asio::const_buffer, 2> buffers = {
-      boost::asio::buffer(message_size), boost::asio::buffer(message.data(), message.size())};
+void TcpTransport::SendMessage(std::span<const std::uint8_t> message) {
+  const std::array<std::span<const std::uint8_t>, 1> messages{message};
+  SendMessages(messages);
+}
+
+void TcpTransport::SendMessages(std::span<const std::span<const std::uint8_t>> messages) {
+  std::vector<std::array<std::uint8_t, sizeof(std::uint32_t)>> message_sizes(messages.size());
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(2 * messages.size());
+  std::size_t number_of_bytes = 0;
+  std::size_t number_of_send_calls = 0;
 
-  boost::system::error_code ec;
   std::shared_lock lock(implementation_->socket_mutex_);
-  boost::asio::write(implementation_->socket_, buffers, boost::asio::transfer_all(), ec);
-  if (ec) {
-    throw std::runtime_error(fmt::format("Error while writing to socket: {}", ec.message()));
+  auto& stripe_sockets = implementation_->stripe_sockets_;
+  const auto number_of_stripes = stripe_sockets.size() + 1;
+  for (std::size_t i = 0; i < messages.size(); ++i) {
+    const auto& message = messages[i];
+    if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                           std::numeric_limits<std::uint32_t>::max(),
+                                           message.size()));
+    }
+    u32tou8(message.size(), message_sizes[i].data());
+    buffers.emplace_back(boost::asio::buffer(message_sizes[i]));
+    number_of_bytes += message.size() + sizeof(std::uint32_t);
+    if (!IsStriped(message.size())) {
+      buffers.emplace_back(boost::asio::buffer(message.data(), message.size()));
+      continue;
+    }
+    // write the remaining stripes concurrently to the pending buffers and the first stripe
+    std::vector<std::future<std::size_t>> stripe_futures;
+    for (std::size_t stripe = 1; stripe < number_of_stripes; ++stripe) {
+      const auto [offset, size] = GetStripe(message.size(), number_of_stripes, stripe);
+      stripe_futures.emplace_back(std::async(std::launch::async, [&, offset, size, stripe] {
+        std::size_t number_of_stripe_send_calls = 0;
+        std::array<boost::asio::const_buffer, 1> stripe_buffer{
+            boost::asio::buffer(message.data() + offset, size)};
+        WriteBuffers(stripe_sockets[stripe - 1], stripe_buffer, number_of_stripe_send_calls);
+        return number_of_stripe_send_calls;
+      }));
+    }
+    const auto [offset, size] = GetStripe(message.size(), number_of_stripes, 0);
+    buffers.emplace_back(boost::asio::buffer(message.data() + offset, size));
+    WriteBuffers(implementation_->socket_, buffers, number_of_send_calls);
+    buffers.clear();
+    for (auto& stripe_future : stripe_futures) {
+      number_of_send_calls += stripe_future.get();
+    }
   }
-  statistics_.number_of_bytes_sent += message.size() + sizeof(uint32_t);
-  statistics_.number_of_messages_sent += 1;
+  WriteBuffers(implementation_->socket_, buffers, number_of_send_calls);
+  statistics_.number_of_send_calls += number_of_send_calls;
+  statistics_.number_of_bytes_sent += number_of_bytes;
+  statistics_.number_of_messages_sent += messages.size();
 }
 
 static std::uint32_t u8tou32(std::array<std::uint8_t, sizeof(std::uint32_t)>& v) {
@@ -120,7 +262,7 @@ static std::uint32_t u8tou32(std::array<std::uint8_t, sizeof(std::uint32_t)>& v)
   return result;
 }
 
-std::optional<std::vector<std::uint8_t>> TcpTransport::ReceiveMessage() {
+std::optional<std::uint32_t> TcpTransport::ReceiveMessageSize() {
   std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
   boost::system::error_code ec;
   std::shared_lock lock(implementation_->socket_mutex_);
@@ -139,40 +281,219 @@ std::optional<std::vector<std::uint8_t>> TcpTransport::ReceiveMessage() {
     throw std::runtime_error(fmt::format("Error while reading message size from socket: {} ({})",
                                          ec.message(), ec.value()));
   }
-  std::uint32_t message_size = u8tou32(message_size_buffer);
-  std::vector<std::uint8_t> message_buffer(message_size);
-  boost::asio::read(implementation_->socket_, boost::asio::buffer(message_buffer),
-                    boost::asio::transfer_exactly(message_buffer.size()), ec);
+  return u8tou32(message_size_buffer);
+}
+
+// read exactly size bytes from the socket
+static void ReadBytes(tcp::socket& socket, std::uint8_t* data, std::size_t size) {
+  boost::system::error_code ec;
+  boost::asio::read(socket, boost::asio::buffer(data, size), boost::asio::transfer_exactly(size),
+                    ec);
   if (ec) {
     throw std::runtime_error(
         fmt::format("Error while reading message size socket: {} ({})", ec.message(), ec.value()));
   }
-  statistics_.number_of_bytes_received += message_size + sizeof(uint32_t);
+}
+
+void TcpTransport::ReceiveMessageBody(std::uint8_t* data, std::size_t size) {
+  std::shared_lock lock(implementation_->socket_mutex_);
+  if (IsStriped(size)) {
+    auto& stripe_sockets = implementation_->stripe_sockets_;
+    const auto number_of_stripes = stripe_sockets.size() + 1;
+    std::vector<std::future<void>> stripe_futures;
+    for (std::size_t stripe = 1; stripe < number_of_stripes; ++stripe) {
+      const auto [offset, stripe_size] = GetStripe(size, number_of_stripes, stripe);
+      stripe_futures.emplace_back(std::async(std::launch::async, [&, offset, stripe_size, stripe] {
+        ReadBytes(stripe_sockets[stripe - 1], data + offset, stripe_size);
+      }));
+    }
+    const auto [offset, stripe_size] = GetStripe(size, number_of_stripes, 0);
+    ReadBytes(implementation_->socket_, data + offset, stripe_size);
+    for (auto& stripe_future : stripe_futures) {
+      stripe_future.get();
+    }
+  } else {
+    ReadBytes(implementation_->socket_, data, size);
+  }
+  statistics_.number_of_bytes_received += size + sizeof(uint32_t);
   statistics_.number_of_messages_received += 1;
+}
+
+std::optional<std::vector<std::uint8_t>> TcpTransport::ReceiveMessage() {
+  auto message_size{ReceiveMessageSize()};
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message_buffer(*message_size);
+  ReceiveMessageBody(message_buffer.data(), message_buffer.size());
+  return message_buffer;
+}
+
+std::optional<MessageBuffer> TcpTransport::ReceivePooledMessage(MessageBufferPool& pool) {
+  auto message_size{ReceiveMessageSize()};
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  auto message_buffer{pool.Acquire(*message_size)};
+  ReceiveMessageBody(message_buffer.data(), message_buffer.size());
   return message_buffer;
 }
 
+bool TcpTransport::SupportsAsynchronousOperations() const {
+  return implementation_->event_loop_ != nullptr && implementation_->stripe_sockets_.empty();
+}
+
+void TcpTransport::AsyncReceivePooledMessage(MessageBufferPool& pool, ReceiveHandler handler) {
+  struct ReceiveState {
+    std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+    std::optional<MessageBuffer> message_buffer;
+    ReceiveHandler handler;
+  };
+  auto state{std::make_shared<ReceiveState>()};
+  state->handler = std::move(handler);
+  implementation_->event_loop_->Post([this, &pool, state] {
+    boost::asio::async_read(
+        implementation_->socket_, boost::asio::buffer(state->message_size_buffer),
+        boost::asio::transfer_exactly(state->message_size_buffer.size()),
+        [this, &pool, state](const boost::system::error_code& ec, std::size_t) {
+          if (ec == boost::asio::error::eof) {
+            // connection has been closed
+            state->handler(std::nullopt, nullptr);
+            return;
+          } else if (ec) {
+            state->handler(std::nullopt,
+                           std::make_exception_ptr(std::runtime_error(fmt::format(
+                               "Error while reading message size from socket: {} ({})",
+                               ec.message(), ec.value()))));
+            return;
+          }
+          state->message_buffer.emplace(pool.Acquire(u8tou32(state->message_size_buffer)));
+          auto& message_buffer{*state->message_buffer};
+          boost::asio::async_read(
+              implementation_->socket_,
+              boost::asio::buffer(message_buffer.data(), message_buffer.size()),
+              boost::asio::transfer_exactly(message_buffer.size()),
+              [this, state](const boost::system::error_code& ec, std::size_t size) {
+                if (ec) {
+                  state->handler(std::nullopt,
+                                 std::make_exception_ptr(std::runtime_error(fmt::format(
+                                     "Error while reading message from socket: {} ({})",
+                                     ec.message(), ec.value()))));
+                  return;
+                }
+                statistics_.number_of_bytes_received += size + sizeof(uint32_t);
+                statistics_.number_of_messages_received += 1;
+                state->handler(std::move(state->message_buffer), nullptr);
+              });
+        });
+  });
+}
+
+void TcpTransport::AsyncSendMessages(std::span<const std::span<const std::uint8_t>> messages,
+                                     SendHandler handler) {
+  struct SendState {
+    std::vector<std::array<std::uint8_t, sizeof(std::uint32_t)>> message_sizes;
+    std::vector<boost::asio::const_buffer> buffers;
+    SendHandler handler;
+  };
+  auto state{std::make_shared<SendState>()};
+  state->message_sizes.resize(messages.size());
+  state->buffers.reserve(2 * messages.size());
+  state->handler = std::move(handler);
+  for (std::size_t i = 0; i < messages.size(); ++i) {
+    const auto& message = messages[i];
+    if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                           std::numeric_limits<std::uint32_t>::max(),
+                                           message.size()));
+    }
+    u32tou8(message.size(), state->message_sizes[i].data());
+    state->buffers.emplace_back(boost::asio::buffer(state->message_sizes[i]));
+    state->buffers.emplace_back(boost::asio::buffer(message.data(), message.size()));
+  }
+  const auto number_of_messages{messages.size()};
+  implementation_->event_loop_->Post([this, state, number_of_messages] {
+    boost::asio::async_write(
+        implementation_->socket_, state->buffers,
+        [this, state, number_of_messages](const boost::system::error_code& ec, std::size_t size) {
+          if (ec) {
+            state->handler(std::make_exception_ptr(std::runtime_error(fmt::format(
+                "Error while writing to socket: {} ({})", ec.message(), ec.value()))));
+            return;
+          }
+          statistics_.number_of_send_calls += 1;
+          statistics_.number_of_bytes_sent += size;
+          statistics_.number_of_messages_sent += number_of_messages;
+          state->handler(nullptr);
+        });
+  });
+}
+
 using namespace std::chrono_literals;
 
 struct TcpSetupHelper::TcpSetupImplementation {
-  [[nodiscard]] std::map<std::size_t, tcp::socket> accept_task();
-  [[nodiscard]] tcp::socket connect_task(std::size_t other_id, std::string host,
-                                         std::uint16_t port);
+  // connections are identified by the party id and the index of the connection to this party
+  using ConnectionId = std::pair<std::size_t, std::size_t>;
+
+  // state of the attempts to connect to a party with a smaller id
+  struct ConnectState {
+    ConnectState(boost::asio::io_context& io_context, ConnectionId connection_id, std::string host,
+                 std::uint16_t port)
+        : connection_id(connection_id),
+          host(std::move(host)),
+          port(port),
+          resolver(io_context),
+          socket(io_context),
+          timer(io_context) {}
+
+    ConnectionId connection_id;
+    std::string host;
+    std::uint16_t port;
+    tcp::resolver resolver;
+    tcp::resolver::results_type endpoints;
+    tcp::socket socket;
+    boost::asio::steady_timer timer;
+    std::size_t number_of_attempts = 0;
+    std::array<std::uint64_t, 2> own_id_and_index;
+    std::uint64_t received_id;
+  };
+
+  // start accepting connections until all parties with larger ids are connected
+  void Accept();
+  // read the id and connection index of an accepted peer and answer with our id
+  void IdentifyAcceptedPeer(std::shared_ptr<tcp::socket> socket);
+  void Connect(std::shared_ptr<ConnectState> state);
+  void RetryConnect(std::shared_ptr<ConnectState> state, const boost::system::error_code& ec);
+  void AddSocket(ConnectionId connection_id, tcp::socket&& socket);
+  // record the first error and cancel all pending operations
+  void Fail(std::string message);
+  // close the acceptor and everything that is not an established connection
+  void CancelPendingOperations();
 
   std::size_t my_id_;
   std::size_t number_of_parties_;
-  int number_of_connection_retries_ = 10;
-  decltype(1s) retry_delay_ = 3s;
+  std::size_t number_of_connections_;
+  TcpConnectionRetryConfiguration retry_configuration_;
   boost::asio::ip::address bind_address_;
   std::uint16_t bind_port_;
   std::shared_ptr<boost::asio::io_context> io_context_;
-  std::map<std::size_t, tcp::socket> sockets_;
+  std::optional<tcp::acceptor> acceptor_;
+  std::vector<std::shared_ptr<ConnectState>> connect_states_;
+  // accepted sockets whose peer is not identified yet
+  std::set<std::shared_ptr<tcp::socket>> accepted_sockets_;
+  // connections of accepted peers that are answered right now
+  std::set<ConnectionId> reserved_connections_;
+  std::size_t number_of_missing_connections_ = 0;
+  std::optional<std::string> error_;
+  std::map<ConnectionId, tcp::socket> sockets_;
 };
 
 TcpSetupHelper::TcpSetupHelper(std::size_t my_id,
-                               const TcpPartiesConfiguration& parties_configuration)
+                               const TcpPartiesConfiguration& parties_configuration,
+                               std::size_t number_of_connections)
     : my_id_(my_id),
       number_of_parties_(parties_configuration.size()),
+      number_of_connections_(number_of_connections),
       parties_configuration_(parties_configuration),
       implementation_(std::make_unique<TcpSetupImplementation>()) {
   // check arguments
@@ -183,10 +504,14 @@ TcpSetupHelper::TcpSetupHelper(std::size_t my_id,
     throw std::invalid_argument(
         "specified invalid party id: my_id >= parties_configuration.size()");
   }
+  if (number_of_connections_ == 0) {
+    throw std::invalid_argument("specified number of connections per party: 0");
+  }
   boost::system::error_code ec;
   auto my_configuration = parties_configuration_[my_id_];
   implementation_->my_id_ = my_id_;
   implementation_->number_of_parties_ = number_of_parties_;
+  implementation_->number_of_connections_ = number_of_connections_;
   implementation_->bind_port_ = std::get<1>(my_configuration);
   implementation_->bind_address_ = boost::asio::ip::make_address(std::get<0>(my_configuration), ec);
   if (ec) {
@@ -198,21 +523,88 @@ TcpSetupHelper::TcpSetupHelper(std::size_t my_id,
 
 TcpSetupHelper::~TcpSetupHelper() = default;
 
-std::vector<std::unique_ptr<Transport>> TcpSetupHelper::SetupConnections() {
-  auto accept_future =
-      std::async(std::launch::async, [this] { return implementation_->accept_task(); });
-  std::vector<std::future<tcp::socket>> futures;
-  for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
-    auto party_configuration = parties_configuration_.at(party_id);
-    futures.emplace_back(std::async(std::launch::async, [this, party_id, party_configuration] {
-      return implementation_->connect_task(party_id, std::get<0>(party_configuration),
-                                           std::get<1>(party_configuration));
-    }));
+void TcpSetupHelper::SetTlsConfiguration(TcpTlsConfiguration tls_configuration) {
+  tls_configuration_ = std::move(tls_configuration);
+}
+
+void TcpSetupHelper::SetRetryConfiguration(TcpConnectionRetryConfiguration retry_configuration) {
+  if (retry_configuration.number_of_attempts == 0) {
+    throw std::invalid_argument("specified number of connection attempts: 0");
   }
+  implementation_->retry_configuration_ = retry_configuration;
+}
+
+std::vector<std::unique_ptr<Transport>> TcpSetupHelper::SetupConnections() {
+  auto& implementation{*implementation_};
+  implementation.sockets_.clear();
+  implementation.error_.reset();
+  implementation.number_of_missing_connections_ =
+      (number_of_parties_ - 1) * number_of_connections_;
   try {
-    implementation_->sockets_ = accept_future.get();
+    // listen before connecting, such that no two parties wait for each other
+    if (my_id_ + 1 < number_of_parties_) {
+      implementation.acceptor_.emplace(
+          *implementation.io_context_,
+          tcp::endpoint(implementation.bind_address_, implementation.bind_port_),
+          /* reuse_addr = */ true);
+      boost::system::error_code ec;
+      implementation.acceptor_->listen(boost::asio::socket_base::max_listen_connections, ec);
+      if (ec) {
+        throw std::runtime_error(fmt::format("error occurred on listen: {}\n", ec.message()));
+      }
+      implementation.Accept();
+    }
+    // all connections are established concurrently on this thread
     for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
-      implementation_->sockets_.emplace(party_id, futures.at(party_id).get());
+      const auto& [host, port] = parties_configuration_.at(party_id);
+      for (std::size_t connection_index = 0; connection_index < number_of_connections_;
+           ++connection_index) {
+        auto state{std::make_shared<TcpSetupImplementation::ConnectState>(
+            *implementation.io_context_, std::make_pair(party_id, connection_index), host, port)};
+        implementation.connect_states_.push_back(state);
+        state->resolver.async_resolve(
+            host, std::to_string(port),
+            [&implementation, state](const boost::system::error_code& ec,
+                                     tcp::resolver::results_type endpoints) {
+              if (implementation.error_.has_value()) return;
+              if (ec) {
+                implementation.Fail(fmt::format("cannot resolve {}:{}, {}\n", state->host,
+                                                state->port, ec.message()));
+                return;
+              }
+              state->endpoints = std::move(endpoints);
+              implementation.Connect(state);
+            });
+      }
+    }
+    implementation.io_context_->restart();
+    implementation.io_context_->run();
+    implementation.connect_states_.clear();
+    implementation.acceptor_.reset();
+    if (implementation.error_.has_value()) {
+      throw std::runtime_error(*implementation.error_);
+    }
+    if (tls_configuration_.has_value()) {
+      detail::KernelTlsContext tls_context(*tls_configuration_);
+      // the parties handle their connections in different orders, so the handshakes run
+      // concurrently
+      std::vector<std::future<void>> handshake_futures;
+      for (auto& [connection_id, socket] : implementation_->sockets_) {
+        handshake_futures.emplace_back(std::async(
+            std::launch::async, [this, &tls_context, &socket, other_id = connection_id.first] {
+              // the party with the smaller id accepted the connection
+              tls_context.Handshake(socket.native_handle(), other_id > my_id_, other_id);
+            }));
+      }
+      std::exception_ptr handshake_exception;
+      for (auto& handshake_future : handshake_futures) {
+        try {
+          handshake_future.get();
+        } catch (std::runtime_error&) {
+          if (!handshake_exception) handshake_exception = std::current_exception();
+        }
+      }
+      if (handshake_exception) std::rethrow_exception(handshake_exception);
     }
   } catch (std::runtime_error& e) {
     // an error happened => close all other sockets
@@ -230,126 +622,179 @@ std::vector<std::unique_ptr<Transport>> TcpSetupHelper::SetupConnections() {
   }
 
   std::vector<std::unique_ptr<Transport>> result(number_of_parties_);
-  std::for_each(std::begin(implementation_->sockets_), std::end(implementation_->sockets_),
-                [this, &result](auto& iterator) {
-                  auto transport_implementation =
-                      std::make_unique<detail::TcpTransportImplementation>(
-                          implementation_->io_context_, std::move(iterator.second));
-                  result.at(iterator.first) =
-                      std::make_unique<TcpTransport>(std::move(transport_implementation));
-                });
+  auto event_loop{std::make_shared<detail::TcpEventLoop>(implementation_->io_context_)};
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    auto& sockets = implementation_->sockets_;
+    auto socket{std::move(sockets.at(std::make_pair(party_id, std::size_t(0))))};
+    std::vector<tcp::socket> stripe_sockets;
+    for (std::size_t connection_index = 1; connection_index < number_of_connections_;
+         ++connection_index) {
+      stripe_sockets.emplace_back(
+          std::move(sockets.at(std::make_pair(party_id, connection_index))));
+    }
+    auto transport_implementation = std::make_unique<detail::TcpTransportImplementation>(
+        implementation_->io_context_, std::move(socket), std::move(stripe_sockets), event_loop);
+    result.at(party_id) = std::make_unique<TcpTransport>(std::move(transport_implementation));
+  }
+  implementation_->sockets_.clear();
   return result;
 }
 
-std::map<std::size_t, tcp::socket> TcpSetupHelper::TcpSetupImplementation::accept_task() {
-  if (my_id_ == number_of_parties_ - 1) {
-    return {};
-  }
-  std::map<std::size_t, tcp::socket> sockets;
-  std::size_t number_of_accepted_connections = 0;
-  std::size_t expected_connections = number_of_parties_ - my_id_ - 1;
-  boost::system::error_code ec;
-  tcp::acceptor acceptor(*io_context_, tcp::endpoint(bind_address_, bind_port_),
-                         /* reuse_addr = */ true);
-  acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
-  if (ec) {
-    throw std::runtime_error(fmt::format("error occurred on listen: {}\n", ec.message()));
-  }
-  while (number_of_accepted_connections < expected_connections) {
-    tcp::socket socket(*io_context_);
-    acceptor.accept(socket, ec);
+void TcpSetupHelper::TcpSetupImplementation::Accept() {
+  auto socket{std::make_shared<tcp::socket>(*io_context_)};
+  acceptor_->async_accept(*socket, [this, socket](const boost::system::error_code& ec) {
+    if (ec == boost::asio::error::operation_aborted || error_.has_value()) return;
     if (ec) {
-      throw std::runtime_error(fmt::format("error occurred on accept: {}\n", ec.message()));
-    }
-    std::size_t other_id;
-    // receive other id
-    {
-      std::uint64_t received_id;
-      boost::asio::read(socket, boost::asio::mutable_buffer(&received_id, sizeof(received_id)), ec);
-      if (ec) {
-        socket.close();
-        continue;
-      }
-      other_id = static_cast<std::size_t>(received_id);
-    }
-    // validate received id
-    if (other_id <= my_id_ || other_id >= number_of_parties_) {
-      // invalid_id
-      socket.close();
-      continue;
-    }
-    // check if we are already connected to this party
-    if (auto iterator = sockets.find(static_cast<std::size_t>(other_id));
-        iterator != sockets.end()) {
-      socket.close();
-      continue;
-    }
-    // send my party id
-    {
-      std::uint64_t my_id = static_cast<std::uint64_t>(my_id_);
-      boost::asio::write(socket, boost::asio::const_buffer(&my_id, sizeof(my_id)), ec);
-      if (ec) {
-        socket.close();
-        continue;
-      }
+      Fail(fmt::format("error occurred on accept: {}\n", ec.message()));
+      return;
     }
-    // success
-    sockets.emplace(std::make_pair(other_id, std::move(socket)));
-    ++number_of_accepted_connections;
+    // a slow peer does not delay accepting the others
+    accepted_sockets_.insert(socket);
+    IdentifyAcceptedPeer(socket);
+    Accept();
+  });
+}
+
+void TcpSetupHelper::TcpSetupImplementation::IdentifyAcceptedPeer(
+    std::shared_ptr<tcp::socket> socket) {
+  auto id_and_index{std::make_shared<std::array<std::uint64_t, 2>>()};
+  // drop the socket of a peer that fails or sends invalid data, it may retry
+  auto drop = [this, socket] {
+    boost::system::error_code ignored;
+    socket->close(ignored);
+    accepted_sockets_.erase(socket);
+  };
+  boost::asio::async_read(
+      *socket, boost::asio::buffer(*id_and_index),
+      [this, socket, id_and_index, drop](const boost::system::error_code& ec, std::size_t) {
+        if (error_.has_value()) return;
+        const std::size_t other_id{static_cast<std::size_t>((*id_and_index)[0])};
+        const std::size_t connection_index{static_cast<std::size_t>((*id_and_index)[1])};
+        const auto connection_id{std::make_pair(other_id, connection_index)};
+        if (ec || other_id <= my_id_ || other_id >= number_of_parties_ ||
+            connection_index >= number_of_connections_ || sockets_.contains(connection_id) ||
+            reserved_connections_.contains(connection_id)) {
+          drop();
+          return;
+        }
+        // reserve the connection, the peer only retries if the answer does not arrive
+        reserved_connections_.insert(connection_id);
+        auto my_id{std::make_shared<std::uint64_t>(my_id_)};
+        boost::asio::async_write(
+            *socket, boost::asio::buffer(my_id.get(), sizeof(*my_id)),
+            [this, socket, my_id, connection_id, drop](const boost::system::error_code& ec,
+                                                       std::size_t) {
+              if (error_.has_value()) return;
+              reserved_connections_.erase(connection_id);
+              if (ec) {
+                drop();
+                return;
+              }
+              accepted_sockets_.erase(socket);
+              AddSocket(connection_id, std::move(*socket));
+            });
+      });
+}
+
+void TcpSetupHelper::TcpSetupImplementation::Connect(std::shared_ptr<ConnectState> state) {
+  ++state->number_of_attempts;
+  boost::asio::async_connect(
+      state->socket, state->endpoints,
+      [this, state](const boost::system::error_code& ec, const tcp::endpoint&) {
+        if (error_.has_value()) return;
+        if (ec) {
+          RetryConnect(state, ec);
+          return;
+        }
+        // send my id and the index of this connection to the peer
+        state->own_id_and_index = {static_cast<std::uint64_t>(my_id_),
+                                   static_cast<std::uint64_t>(state->connection_id.second)};
+        boost::asio::async_write(
+            state->socket, boost::asio::buffer(state->own_id_and_index),
+            [this, state](const boost::system::error_code& ec, std::size_t) {
+              if (error_.has_value()) return;
+              if (ec) {
+                RetryConnect(state, ec);
+                return;
+              }
+              // receive id of the peer
+              boost::asio::async_read(
+                  state->socket,
+                  boost::asio::buffer(&state->received_id, sizeof(state->received_id)),
+                  [this, state](const boost::system::error_code& ec, std::size_t) {
+                    if (error_.has_value()) return;
+                    if (ec) {
+                      RetryConnect(state, ec);
+                      return;
+                    }
+                    if (static_cast<std::size_t>(state->received_id) !=
+                        state->connection_id.first) {
+                      Fail(fmt::format("received unexpected party id {} of peer {}:{}\n",
+                                       state->received_id, state->host, state->port));
+                      return;
+                    }
+                    AddSocket(state->connection_id, std::move(state->socket));
+                  });
+            });
+      });
+}
+
+void TcpSetupHelper::TcpSetupImplementation::RetryConnect(std::shared_ptr<ConnectState> state,
+                                                         const boost::system::error_code& ec) {
+  boost::system::error_code ignored;
+  state->socket.close(ignored);
+  if (state->number_of_attempts >= retry_configuration_.number_of_attempts) {
+    Fail(fmt::format(
+        "too many errors while trying to connect to party {} at {}:{}, last error message: {}",
+        state->connection_id.first, state->host, state->port, ec.message()));
+    return;
   }
-  return sockets;
+  // exponential backoff, e.g., while the peer is not listening yet
+  const auto exponent{std::min<std::size_t>(state->number_of_attempts - 1, 30)};
+  const auto delay{std::min<std::chrono::milliseconds>(
+      retry_configuration_.initial_retry_delay * (std::int64_t(1) << exponent),
+      retry_configuration_.maximum_retry_delay)};
+  state->timer.expires_after(delay);
+  state->timer.async_wait([this, state](const boost::system::error_code& ec) {
+    if (ec || error_.has_value()) return;
+    Connect(state);
+  });
 }
 
-tcp::socket TcpSetupHelper::TcpSetupImplementation::connect_task(std::size_t other_id,
-                                                                 std::string host,
-                                                                 std::uint16_t port) {
-  boost::system::error_code ec;
-  tcp::socket socket(*io_context_);
-  tcp::resolver resolver(*io_context_);
-  auto endpoints = resolver.resolve(host, std::to_string(port), ec);
-  if (ec) {
-    throw std::runtime_error(fmt::format("cannot resolve {}:{}, {}\n", host, port, ec.message()));
+void TcpSetupHelper::TcpSetupImplementation::AddSocket(ConnectionId connection_id,
+                                                       tcp::socket&& socket) {
+  sockets_.emplace(connection_id, std::move(socket));
+  if (--number_of_missing_connections_ == 0) {
+    CancelPendingOperations();
   }
-  int connect_retry_i = 0;
-  for (; connect_retry_i < number_of_connection_retries_; ++connect_retry_i) {
-    boost::asio::connect(socket, endpoints, ec);
-    if (ec) {
-      std::this_thread::sleep_for(retry_delay_);
-      continue;
-    }
+}
 
-    // send my id to the peer
-    {
-      std::uint64_t own_id = static_cast<std::uint64_t>(my_id_);
-      boost::asio::write(socket, boost::asio::const_buffer(&own_id, sizeof(own_id)), ec);
-      if (ec) {
-        socket.close();
-        continue;
-      }
-    }
+void TcpSetupHelper::TcpSetupImplementation::Fail(std::string message) {
+  if (!error_.has_value()) {
+    error_ = std::move(message);
+    CancelPendingOperations();
+  }
+}
 
-    // receive id of the peer
-    {
-      std::uint64_t received_id;
-      boost::asio::read(socket, boost::asio::mutable_buffer(&received_id, sizeof(received_id)), ec);
-      if (ec) {
-        socket.close();
-        continue;
-      }
-      if (static_cast<std::size_t>(received_id) != other_id) {
-        throw std::runtime_error(fmt::format("received unexpected party id {} of peer {}:{}\n",
-                                             received_id, host, port));
-      }
-    }
-    // success
-    break;
+void TcpSetupHelper::TcpSetupImplementation::CancelPendingOperations() {
+  boost::system::error_code ignored;
+  if (acceptor_.has_value()) {
+    acceptor_->close(ignored);
   }
-  if (connect_retry_i == number_of_connection_retries_) {
-    throw std::runtime_error(fmt::format(
-        "too many errors while trying to connect to party {} at {}:{}, last error message: {}",
-        other_id, host, port, ec.message()));
+  for (auto& socket : accepted_sockets_) {
+    socket->close(ignored);
+  }
+  accepted_sockets_.clear();
+  for (auto& state : connect_states_) {
+    state->resolver.cancel();
+    state->timer.cancel();
+    if (state->socket.is_open()) {
+      state->socket.close(ignored);
+    }
   }
-  return socket;
 }
 
 }  // namespace encrypto::motion::communication
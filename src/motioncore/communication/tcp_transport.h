@@ -22,23 +22,30 @@
 
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <vector>
 
+#include "kernel_tls.h"
 #include "transport.h"
 
 namespace encrypto::motion::communication {
 
 namespace detail {
 
+class TcpEventLoop;
 struct TcpTransportImplementation;
 
 }  // namespace detail
 
 class TcpTransport : public Transport {
  public:
+  // messages of at least this size are striped across all connections of the transport
+  static constexpr std::size_t kMinStripedMessageSize{std::size_t(1) << 20};
+
   TcpTransport(std::unique_ptr<detail::TcpTransportImplementation> implementation);
   TcpTransport(TcpTransport&& other);
 
@@ -46,13 +53,29 @@ class TcpTransport : public Transport {
   ~TcpTransport();
 
   void SendMessage(std::span<const std::uint8_t> message) override;
+  // sends all messages including their size prefixes via vectored writes
+  void SendMessages(std::span<const std::span<const std::uint8_t>> messages) override;
 
   bool Available() const override;
   std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  std::optional<MessageBuffer> ReceivePooledMessage(MessageBufferPool& pool) override;
+  // asynchronous operations run on a single event loop thread shared by all transports created by
+  // the same TcpSetupHelper, they are not supported if messages are striped
+  bool SupportsAsynchronousOperations() const override;
+  void AsyncReceivePooledMessage(MessageBufferPool& pool, ReceiveHandler handler) override;
+  void AsyncSendMessages(std::span<const std::span<const std::uint8_t>> messages,
+                         SendHandler handler) override;
   void ShutdownSend() override;
   void Shutdown() override;
 
  private:
+  // read the size prefix of the next message, std::nullopt if the connection has been closed
+  std::optional<std::uint32_t> ReceiveMessageSize();
+  // read exactly size bytes of the message body
+  void ReceiveMessageBody(std::uint8_t* data, std::size_t size);
+  // check if a message of the given size is striped across multiple connections
+  bool IsStriped(std::size_t message_size) const;
+
   bool is_connected_;
   std::unique_ptr<detail::TcpTransportImplementation> implementation_;
 };
@@ -60,18 +83,40 @@ class TcpTransport : public Transport {
 using TcpConnectionConfiguration = std::pair<std::string, std::uint16_t>;
 using TcpPartiesConfiguration = std::vector<TcpConnectionConfiguration>;
 
+// Attempts to connect to a party with a smaller id.  The delay before the i-th retry is
+// min(initial_retry_delay * 2^(i-1), maximum_retry_delay), which covers about 36 s by default.
+struct TcpConnectionRetryConfiguration {
+  std::size_t number_of_attempts = 18;
+  std::chrono::milliseconds initial_retry_delay{50};
+  std::chrono::milliseconds maximum_retry_delay{3000};
+};
+
 // Helper class to establish point-to-point TCP connections among a set of
 // parties.  Given the ID of the local party and a collection of host and port
 // for all parties, connections are created as follows: This party tries to
 // connect to all parties with smaller IDs, and it accepts connections from the
-// parties with larger IDs.
+// parties with larger IDs.  All connections, including the exchange of the
+// party IDs, are established concurrently with asynchronous operations, so a
+// slow peer does not delay the others.
+// If number_of_connections > 1, that many connections are established to each party, and messages
+// of at least TcpTransport::kMinStripedMessageSize bytes are striped across them.  Messages are
+// still sent and received one after another, so their order is preserved.
 class TcpSetupHelper {
  public:
-  TcpSetupHelper(std::size_t my_id, const TcpPartiesConfiguration& parties_configuration);
+  TcpSetupHelper(std::size_t my_id, const TcpPartiesConfiguration& parties_configuration,
+                 std::size_t number_of_connections = 1);
 
   // Destructor needs to be defined in implementation due to pimpl
   ~TcpSetupHelper();
 
+  // Protect all connections with mutually authenticated TLS whose records are encrypted and
+  // decrypted by the kernel after the handshake, see detail::KernelTlsContext.  All parties need
+  // to enable TLS.
+  void SetTlsConfiguration(TcpTlsConfiguration tls_configuration);
+
+  // Throws a std::invalid_argument if number_of_attempts is 0.
+  void SetRetryConfiguration(TcpConnectionRetryConfiguration retry_configuration);
+
   // Try to establish connections as described above.
   // Throws a std::runtime_error if something goes wrong.
   std::vector<std::unique_ptr<Transport>> SetupConnections();
@@ -81,7 +126,9 @@ class TcpSetupHelper {
 
   std::size_t my_id_;
   std::size_t number_of_parties_;
+  std::size_t number_of_connections_;
   const TcpPartiesConfiguration parties_configuration_;
+  std::optional<TcpTlsConfiguration> tls_configuration_;
   std::unique_ptr<TcpSetupImplementation> implementation_;
 };
 
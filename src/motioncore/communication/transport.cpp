@@ -22,15 +22,61 @@
 
 #include "transport.h"
 
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
 namespace encrypto::motion::communication {
 
 const TransportStatistics& Transport::GetStatistics() const { return statistics_; }
 
+void Transport::SendMessages(std::span<const std::span<const std::uint8_t>> messages) {
+  for (const auto& message : messages) {
+    SendMessage(message);
+  }
+}
+
+std::optional<MessageBuffer> Transport::ReceivePooledMessage(MessageBufferPool&) {
+  auto message{ReceiveMessage()};
+  if (!message.has_value()) {
+    return std::nullopt;
+  }
+  return MessageBuffer(std::move(*message));
+}
+
+void MessageTypeStatistics::AddSentMessage(std::size_t number_of_bytes,
+                                           std::uint64_t latency_us) {
+  number_of_messages_sent += 1;
+  number_of_bytes_sent += number_of_bytes;
+  const auto bucket{std::min<std::size_t>(std::bit_width(latency_us), kNumberOfLatencyBuckets - 1)};
+  send_latency_histogram[bucket] += 1;
+}
+
+MessageTypeStatistics& MessageTypeStatistics::operator+=(const MessageTypeStatistics& other) {
+  number_of_messages_sent += other.number_of_messages_sent;
+  number_of_messages_received += other.number_of_messages_received;
+  number_of_bytes_sent += other.number_of_bytes_sent;
+  number_of_bytes_received += other.number_of_bytes_received;
+  for (std::size_t i = 0; i < kNumberOfLatencyBuckets; ++i) {
+    send_latency_histogram[i] += other.send_latency_histogram[i];
+  }
+  return *this;
+}
+
+void Transport::AsyncReceivePooledMessage(MessageBufferPool&, ReceiveHandler) {
+  throw std::logic_error("transport does not support asynchronous operations");
+}
+
+void Transport::AsyncSendMessages(std::span<const std::span<const std::uint8_t>>, SendHandler) {
+  throw std::logic_error("transport does not support asynchronous operations");
+}
+
 void Transport::ResetStatistics() {
   statistics_.number_of_messages_sent = 0;
   statistics_.number_of_messages_received = 0;
   statistics_.number_of_bytes_sent = 0;
   statistics_.number_of_bytes_received = 0;
+  statistics_.number_of_send_calls = 0;
 }
 
 }  // namespace encrypto::motion::communication
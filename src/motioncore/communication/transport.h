@@ -22,20 +22,61 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
 #include <optional>
 #include <stdexcept>
 #include <span>
 #include <vector>
 #include <cstdint>
 
+#include "message_buffer.h"
+
 namespace encrypto::motion::communication {
 
+// traffic of the messages of one MessageType, which are counted before compression. A MessageBatch
+// is sent as one kMessageBatch message, whose messages are received as messages of their own types
+struct MessageTypeStatistics {
+  // bucket 0 counts latencies below 1 us, bucket i > 0 those in [2^(i-1), 2^i) us, and the last
+  // bucket also all larger ones
+  static constexpr std::size_t kNumberOfLatencyBuckets{32};
+
+  std::size_t number_of_messages_sent = 0;
+  std::size_t number_of_messages_received = 0;
+  std::size_t number_of_bytes_sent = 0;
+  std::size_t number_of_bytes_received = 0;
+  // time from enqueuing a message for sending until it has been written to the transport
+  std::array<std::size_t, kNumberOfLatencyBuckets> send_latency_histogram{};
+
+  // count a sent message with the given latency in microseconds
+  void AddSentMessage(std::size_t number_of_bytes, std::uint64_t latency_us);
+
+  MessageTypeStatistics& operator+=(const MessageTypeStatistics& other);
+};
+
 struct TransportStatistics {
   std::size_t number_of_messages_sent = 0;
   std::size_t number_of_messages_received = 0;
   std::size_t number_of_bytes_sent = 0;
   std::size_t number_of_bytes_received = 0;
+  // number of write system calls issued for sending, if the transport uses any
+  std::size_t number_of_send_calls = 0;
+  // size of the compressed messages before and after compression, filled in by the
+  // CommunicationLayer
+  std::size_t number_of_uncompressed_bytes_sent = 0;
+  std::size_t number_of_compressed_bytes_sent = 0;
+  std::size_t number_of_uncompressed_bytes_received = 0;
+  std::size_t number_of_compressed_bytes_received = 0;
+  // traffic per message type indexed by the MessageType value, filled in by the
+  // CommunicationLayer, types without traffic are omitted
+  std::map<std::size_t, MessageTypeStatistics> message_type_statistics;
+  // high-water mark of the bytes waiting in the send queue and number of messages whose sender
+  // waited for space in the queue, see CommunicationLayer::SetSendQueueLimit
+  std::size_t max_number_of_queued_bytes = 0;
+  std::size_t number_of_blocked_sends = 0;
 };
 
 // underlying transport between two parties
@@ -52,12 +93,38 @@ class Transport {
   // send a message
   virtual void SendMessage(std::span<const std::uint8_t> message) = 0;
 
+  // send several messages at once, e.g., in a single vectored write
+  // by default, each message is sent separately via SendMessage
+  virtual void SendMessages(std::span<const std::span<const std::uint8_t>> messages);
+
   // check if a new message is available
   virtual bool Available() const = 0;
 
   // receive message, possibly blocking
   virtual std::optional<std::vector<std::uint8_t>> ReceiveMessage() = 0;
 
+  // receive message into a buffer acquired from the pool, possibly blocking
+  // by default, the result of ReceiveMessage() is adopted without copying
+  virtual std::optional<MessageBuffer> ReceivePooledMessage(MessageBufferPool& pool);
+
+  // Asynchronous operations for an event-driven CommunicationLayer.  The handlers are called on an
+  // event loop thread which may be shared among the transports of one setup, so they should not
+  // block.  At most one operation of each kind may be pending per transport.
+  using ReceiveHandler = std::function<void(std::optional<MessageBuffer>&&, std::exception_ptr)>;
+  using SendHandler = std::function<void(std::exception_ptr)>;
+
+  // check if the transport supports the asynchronous operations, by default it does not
+  virtual bool SupportsAsynchronousOperations() const { return false; }
+
+  // receive a message into a buffer acquired from the pool and pass it to the handler, or
+  // std::nullopt if the transport was closed
+  virtual void AsyncReceivePooledMessage(MessageBufferPool& pool, ReceiveHandler handler);
+
+  // send the messages and call the handler once this is done, the messages need to stay valid
+  // until then
+  virtual void AsyncSendMessages(std::span<const std::span<const std::uint8_t>> messages,
+                                 SendHandler handler);
+
   // shutdown the outgoing part of the transport to signal end of communication
   virtual void ShutdownSend() = 0;
 
@@ -31,6 +31,7 @@
 #include <memory>
 #include <vector>
 
+#include "communication/message_buffer.h"
 #include "utility/bit_vector.h"
 #include "utility/fiber_waitable.h"
 #include "utility/reusable_future.h"
@@ -77,8 +78,9 @@ struct BaseOtData {
   BaseOtReceiverData receiver_data;
   BaseOtSenderData sender_data;
 
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> receiver_futures;
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> sender_futures;
+  // the messages of all base OTs are sent at once
+  ReusableFiberFuture<communication::MessageBuffer> receiver_future;
+  ReusableFiberFuture<communication::MessageBuffer> sender_future;
 
   std::size_t total_number_ots{0};
 };
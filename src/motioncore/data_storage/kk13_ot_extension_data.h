@@ -33,6 +33,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "communication/message_buffer.h"
 #include "data_storage/ot_extension_data.h"
 #include "utility/bit_matrix.h"
 #include "utility/bit_vector.h"
@@ -63,7 +64,7 @@ struct Kk13OtExtensionReceiverData : public FiberSetupWaitable {
   std::unique_ptr<std::vector<std::uint8_t>> random_choices;
 
   // how many ots are in each batch?
-  ReusableFiberFuture<std::vector<std::uint8_t>> key_future;
+  ReusableFiberFuture<communication::MessageBuffer> key_future;
 
   // XXX: unused
   std::atomic<std::size_t> consumed_offset{0};
@@ -77,9 +78,11 @@ struct Kk13OtExtensionSenderData : public FiberSetupWaitable {
   std::atomic<std::size_t> bit_size{0};
 
   /// receiver's mask that are needed to construct matrix @param V
-  std::array<AlignedBitVector, kKappa * 2> u;
+  std::vector<AlignedBitVector> u;
 
-  std::array<ReusableFiberFuture<std::vector<std::uint8_t>>, kKappa * 2> u_futures;
+  // one per row of the bit matrix, registered for the longest supported code, of which the
+  // first code_bit_length are used
+  std::array<ReusableFiberFuture<communication::MessageBuffer>, kKappa * 4> u_futures;
 
   // matrix of the OT extension scheme
   std::shared_ptr<BitMatrix> V;
@@ -112,6 +115,8 @@ struct Kk13OtExtensionData : public FiberSetupWaitable {
 
   std::size_t party_id{std::numeric_limits<std::size_t>::max()};
   std::size_t base_ot_offset{std::numeric_limits<std::size_t>::max()};
+  // length of the code words and number of base OTs, see Configuration::GetKk13CodeBitLength
+  std::size_t code_bit_length{2 * kKappa};
   std::function<void(flatbuffers::FlatBufferBuilder&&)> send_function;
   communication::MessageManager& message_manager;
   std::shared_ptr<Logger> logger;
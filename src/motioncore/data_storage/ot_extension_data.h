@@ -35,8 +35,10 @@
 #include <unordered_set>
 #include <vector>
 
+#include "communication/message_buffer.h"
 #include "utility/bit_matrix.h"
 #include "utility/bit_vector.h"
+#include "utility/constants.h"
 #include "utility/block.h"
 
 namespace encrypto::motion {
@@ -73,7 +75,8 @@ struct OtExtensionSenderData : public FiberSetupWaitable {
   // width of the bit matrix
   std::atomic<std::size_t> bit_size{0};
 
-  std::array<ReusableFiberFuture<std::vector<std::uint8_t>>, 128> u_futures;
+  // one future per chunk of the bit matrix
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> u_futures;
   // XXX: can't we delete this after setup?
   std::shared_ptr<BitMatrix> V;
 
@@ -105,6 +108,10 @@ struct OtExtensionData {
 
   std::size_t party_id{std::numeric_limits<std::size_t>::max()};
   std::size_t base_ot_offset{std::numeric_limits<std::size_t>::max()};
+  // number of threads for transposing and hashing the OTs in the setup
+  std::size_t number_of_threads{1};
+  // number of OTs per chunk of the bit matrix, which needs to be equal at both parties
+  std::size_t chunk_size{kOtExtensionChunkSize};
   std::function<void(flatbuffers::FlatBufferBuilder&&)> send_function;
   communication::MessageManager& message_manager;
   std::shared_ptr<Logger> logger;
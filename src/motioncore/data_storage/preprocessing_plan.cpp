@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "preprocessing_plan.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sb_provider.h"
+#include "multiplication_triple/sp_provider.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// the magic, the version, and the numbers
+constexpr std::size_t kNumberOfValues{2 + 1 + 5 + 5 + 4};
+
+}  // namespace
+
+PreprocessingPlan PreprocessingPlan::FromProviders(const MtProvider& mt_provider,
+                                                   const SpProvider& sp_provider,
+                                                   const SbProvider& sb_provider) {
+  PreprocessingPlan plan;
+  plan.number_of_binary_mts = mt_provider.GetNumberOfMts<bool>();
+  plan.number_of_integer_mts = {
+      mt_provider.GetNumberOfMts<std::uint8_t>(), mt_provider.GetNumberOfMts<std::uint16_t>(),
+      mt_provider.GetNumberOfMts<std::uint32_t>(), mt_provider.GetNumberOfMts<std::uint64_t>(),
+      mt_provider.GetNumberOfMts<__uint128_t>()};
+  plan.number_of_sps = {
+      sp_provider.GetNumberOfSps<std::uint8_t>(), sp_provider.GetNumberOfSps<std::uint16_t>(),
+      sp_provider.GetNumberOfSps<std::uint32_t>(), sp_provider.GetNumberOfSps<std::uint64_t>(),
+      sp_provider.GetNumberOfSps<__uint128_t>()};
+  plan.number_of_sbs = {
+      sb_provider.GetNumberOfSbs<std::uint8_t>(), sb_provider.GetNumberOfSbs<std::uint16_t>(),
+      sb_provider.GetNumberOfSbs<std::uint32_t>(), sb_provider.GetNumberOfSbs<std::uint64_t>()};
+  return plan;
+}
+
+std::vector<std::uint8_t> PreprocessingPlan::Serialize() const {
+  std::vector<std::uint64_t> values(2);
+  std::memcpy(values.data(), kPreprocessingPlanMagic.data(), kPreprocessingPlanMagic.size());
+  values[1] = kPreprocessingPlanVersion;
+  values.push_back(number_of_binary_mts);
+  values.insert(values.end(), number_of_integer_mts.begin(), number_of_integer_mts.end());
+  values.insert(values.end(), number_of_sps.begin(), number_of_sps.end());
+  values.insert(values.end(), number_of_sbs.begin(), number_of_sbs.end());
+  assert(values.size() == kNumberOfValues);
+  std::vector<std::uint8_t> message(values.size() * sizeof(std::uint64_t));
+  std::memcpy(message.data(), values.data(), message.size());
+  return message;
+}
+
+PreprocessingPlan PreprocessingPlan::Deserialize(std::span<const std::uint8_t> message) {
+  if (message.size() != kNumberOfValues * sizeof(std::uint64_t)) {
+    throw std::runtime_error(fmt::format("Received a preprocessing plan of {} B, expected {} B",
+                                         message.size(), kNumberOfValues * sizeof(std::uint64_t)));
+  }
+  std::vector<std::uint64_t> values(kNumberOfValues);
+  std::memcpy(values.data(), message.data(), message.size());
+  if (std::memcmp(values.data(), kPreprocessingPlanMagic.data(), kPreprocessingPlanMagic.size()) !=
+      0) {
+    throw std::runtime_error("The message is no preprocessing plan");
+  }
+  if (values[1] != kPreprocessingPlanVersion) {
+    throw std::runtime_error(fmt::format("The preprocessing plan has version {}, expected {}",
+                                         values[1], kPreprocessingPlanVersion));
+  }
+  PreprocessingPlan plan;
+  auto value{values.begin() + 2};
+  plan.number_of_binary_mts = *value++;
+  for (auto& number : plan.number_of_integer_mts) number = *value++;
+  for (auto& number : plan.number_of_sps) number = *value++;
+  for (auto& number : plan.number_of_sbs) number = *value++;
+  return plan;
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,102 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+class MtProvider;
+class SpProvider;
+class SbProvider;
+
+// Numbers of MTs, SPs and SBs which a circuit requests from the providers during its construction.
+//
+// A plan is taken once from a dry run of a circuit of a fixed shape, i.e., after constructing the
+// circuit and before its preprocessing (see Backend::GetPreprocessingPlan), and can be serialized
+// and reused for all later runs of circuits of this shape. Priming the providers with the plan
+// before any gate is created (see Backend::Prime) fixes the amounts of material to generate, such
+// that the preprocessing can run while the circuit is constructed.
+//
+// Matrix MTs and the OTs which gates register directly are not part of a plan and need to be
+// requested before the preprocessing is started.
+struct PreprocessingPlan {
+  std::size_t number_of_binary_mts{0};
+  // MTs and SPs of 8, 16, 32, 64 and 128 bit
+  std::array<std::size_t, 5> number_of_integer_mts{};
+  std::array<std::size_t, 5> number_of_sps{};
+  // SBs of 8, 16, 32 and 64 bit
+  std::array<std::size_t, 4> number_of_sbs{};
+
+  // index of the 8, 16, 32, 64, and 128 bit types in the arrays
+  template <typename T>
+  static constexpr std::size_t GetTypeIndex() {
+    return static_cast<std::size_t>(std::countr_zero(sizeof(T)));
+  }
+
+  // the numbers requested from the providers so far
+  static PreprocessingPlan FromProviders(const MtProvider& mt_provider,
+                                         const SpProvider& sp_provider,
+                                         const SbProvider& sb_provider);
+
+  std::vector<std::uint8_t> Serialize() const;
+
+  // throws std::runtime_error if the message is no serialized plan of this version
+  static PreprocessingPlan Deserialize(std::span<const std::uint8_t> message);
+};
+
+inline constexpr std::array<char, 8> kPreprocessingPlanMagic{'M', 'O', 'T', 'I',
+                                                             'O', 'N', 'P', 'P'};
+inline constexpr std::uint64_t kPreprocessingPlanVersion{1};
+
+// Hands out the offset of the next n elements of one type of preprocessing material. Without a
+// plan, the number of elements to generate grows with the requests. If the provider was primed
+// with a plan, the requests need to fit into the planned number, since the generation may already
+// be running.
+inline std::size_t RequestPlannedElements(std::size_t& number_of_requested_elements,
+                                          std::size_t& number_of_elements, std::size_t n,
+                                          bool primed, std::string_view kind) {
+  if (primed && number_of_requested_elements + n > number_of_elements) {
+    throw std::logic_error(fmt::format("The circuit requests {} {}, but the preprocessing plan "
+                                       "only covers {}",
+                                       number_of_requested_elements + n, kind,
+                                       number_of_elements));
+  }
+  const std::size_t offset{number_of_requested_elements};
+  number_of_requested_elements += n;
+  if (!primed) {
+    number_of_elements = number_of_requested_elements;
+  }
+  return offset;
+}
+
+}  // namespace encrypto::motion
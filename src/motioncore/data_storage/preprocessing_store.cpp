@@ -0,0 +1,376 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "preprocessing_store.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+static_assert(sizeof(PreprocessingStoreHeader) == 40);
+static_assert(sizeof(PreprocessingStoreSection) == 40);
+
+constexpr std::size_t kRandomOtMessageSize{16};
+
+std::size_t AlignUp(std::size_t offset) {
+  return (offset + kPreprocessingStoreAlignment - 1) / kPreprocessingStoreAlignment *
+         kPreprocessingStoreAlignment;
+}
+
+std::size_t GetSectionSize(PreprocessingKind kind, std::size_t number_of_elements) {
+  switch (kind) {
+    case PreprocessingKind::kRandomOtSender:
+      return 2 * kRandomOtMessageSize * number_of_elements;
+    case PreprocessingKind::kRandomOtReceiver:
+      return kRandomOtMessageSize * number_of_elements + BitsToBytes(number_of_elements);
+    case PreprocessingKind::kBinaryMts:
+      return 3 * BitsToBytes(number_of_elements);
+    case PreprocessingKind::kIntegerMts8:
+      return 3 * sizeof(std::uint8_t) * number_of_elements;
+    case PreprocessingKind::kIntegerMts16:
+      return 3 * sizeof(std::uint16_t) * number_of_elements;
+    case PreprocessingKind::kIntegerMts32:
+      return 3 * sizeof(std::uint32_t) * number_of_elements;
+    case PreprocessingKind::kIntegerMts64:
+      return 3 * sizeof(std::uint64_t) * number_of_elements;
+    case PreprocessingKind::kGarbledCircuitGarbler:
+    case PreprocessingKind::kGarbledCircuitEvaluator:
+      return number_of_elements;
+  }
+  throw std::runtime_error(
+      fmt::format("Unknown kind {} of preprocessing material", static_cast<std::uint32_t>(kind)));
+}
+
+// copies the bits [first, first + count) of the bit array
+BitVector<> ExtractBits(const std::byte* bits, std::size_t first, std::size_t count) {
+  const std::size_t shift{first % 8};
+  BitVector<> bit_vector(bits + first / 8, shift + count);
+  return bit_vector.Subset(shift, shift + count);
+}
+
+// appends the bytes of a bit vector to the buffer
+void AppendBits(std::vector<std::byte>& buffer, const BitVector<>& bit_vector) {
+  const auto& data{bit_vector.GetData()};
+  buffer.insert(buffer.end(), data.begin(), data.begin() + BitsToBytes(bit_vector.GetSize()));
+}
+
+}  // namespace
+
+PreprocessingStore::PreprocessingStore(const std::filesystem::path& path,
+                                       std::uint64_t session_id, std::size_t my_id) {
+  file_descriptor_ = open(path.c_str(), O_RDWR);
+  if (file_descriptor_ == -1) {
+    throw std::runtime_error(fmt::format("cannot open preprocessing store {}: {}", path.string(),
+                                         std::strerror(errno)));
+  }
+  try {
+    // only one process may consume the material at a time
+    if (flock(file_descriptor_, LOCK_EX | LOCK_NB) == -1) {
+      throw std::runtime_error(fmt::format("cannot lock preprocessing store {}: {}",
+                                           path.string(), std::strerror(errno)));
+    }
+    struct stat file_status;
+    if (fstat(file_descriptor_, &file_status) == -1) {
+      throw std::runtime_error(fmt::format("cannot stat preprocessing store {}: {}", path.string(),
+                                           std::strerror(errno)));
+    }
+    size_ = file_status.st_size;
+    if (size_ < sizeof(PreprocessingStoreHeader)) {
+      throw std::runtime_error(
+          fmt::format("{} is too small to be a preprocessing store", path.string()));
+    }
+    void* address{
+        mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor_, 0)};
+    if (address == MAP_FAILED) {
+      throw std::runtime_error(fmt::format("cannot map preprocessing store {}: {}", path.string(),
+                                           std::strerror(errno)));
+    }
+    address_ = static_cast<std::byte*>(address);
+    header_ = reinterpret_cast<PreprocessingStoreHeader*>(address_);
+
+    if (header_->magic != kPreprocessingStoreMagic) {
+      throw std::runtime_error(fmt::format("{} is not a preprocessing store", path.string()));
+    }
+    if (header_->version != kPreprocessingStoreVersion) {
+      throw std::runtime_error(
+          fmt::format("Preprocessing store {} has version {}, but version {} is supported",
+                      path.string(), header_->version, kPreprocessingStoreVersion));
+    }
+    if (header_->session_id != session_id || header_->my_id != my_id) {
+      throw std::runtime_error(fmt::format(
+          "Preprocessing store {} belongs to Party#{} of session {} instead of Party#{} of "
+          "session {}",
+          path.string(), header_->my_id, header_->session_id, my_id, session_id));
+    }
+    const std::size_t table_end{sizeof(PreprocessingStoreHeader) +
+                                header_->number_of_sections * sizeof(PreprocessingStoreSection)};
+    if (table_end > size_) {
+      throw std::runtime_error(
+          fmt::format("Section table of preprocessing store {} is truncated", path.string()));
+    }
+    sections_ = std::span(
+        reinterpret_cast<PreprocessingStoreSection*>(address_ + sizeof(PreprocessingStoreHeader)),
+        header_->number_of_sections);
+    for (const auto& section : sections_) {
+      if (section.offset % kPreprocessingStoreAlignment != 0 || section.offset < table_end ||
+          section.offset + section.size > size_ ||
+          section.size != GetSectionSize(section.kind, section.number_of_elements) ||
+          section.number_of_consumed_elements > section.number_of_elements) {
+        throw std::runtime_error(
+            fmt::format("Preprocessing store {} contains an invalid section", path.string()));
+      }
+    }
+  } catch (...) {
+    if (address_) munmap(address_, size_);
+    close(file_descriptor_);
+    throw;
+  }
+}
+
+PreprocessingStore::~PreprocessingStore() {
+  munmap(address_, size_);
+  // closing the file also releases the lock
+  close(file_descriptor_);
+}
+
+const PreprocessingStoreSection* PreprocessingStore::FindSection(PreprocessingKind kind,
+                                                                 std::size_t party_id) const {
+  auto iterator{std::find_if(sections_.begin(), sections_.end(), [kind, party_id](auto& section) {
+    return section.kind == kind && section.party_id == party_id;
+  })};
+  return iterator == sections_.end() ? nullptr : &*iterator;
+}
+
+std::size_t PreprocessingStore::GetNumberOfAvailableElements(PreprocessingKind kind,
+                                                             std::size_t party_id) const {
+  auto section{FindSection(kind, party_id)};
+  return section ? section->number_of_elements - section->number_of_consumed_elements : 0;
+}
+
+std::pair<const std::byte*, PreprocessingStoreSection> PreprocessingStore::Consume(
+    PreprocessingKind kind, std::size_t party_id, std::size_t number_of_elements) {
+  std::scoped_lock lock(mutex_);
+  auto section{const_cast<PreprocessingStoreSection*>(FindSection(kind, party_id))};
+  const std::size_t available{GetNumberOfAvailableElements(kind, party_id)};
+  if (available < number_of_elements) {
+    throw std::runtime_error(fmt::format(
+        "Preprocessing store contains {} unused elements of kind {} for Party#{}, but {} are "
+        "required",
+        available, static_cast<std::uint32_t>(kind), party_id, number_of_elements));
+  }
+  if (number_of_elements == 0) {
+    return {nullptr, PreprocessingStoreSection{}};
+  }
+  const auto section_before{*section};
+  section->number_of_consumed_elements += number_of_elements;
+  // the consumption is written back before the material is used, so that it cannot be reused
+  // if we crash in between
+  const std::size_t table_end{sizeof(PreprocessingStoreHeader) +
+                              sections_.size() * sizeof(PreprocessingStoreSection)};
+  if (msync(address_, table_end, MS_SYNC) == -1) {
+    section->number_of_consumed_elements -= number_of_elements;
+    throw std::runtime_error(
+        fmt::format("cannot write back preprocessing store: {}", std::strerror(errno)));
+  }
+  return {address_ + section->offset, section_before};
+}
+
+std::span<const std::byte> PreprocessingStore::ConsumeRandomOtsSender(std::size_t party_id,
+                                                                      std::size_t number_of_ots) {
+  auto [data, section] = Consume(PreprocessingKind::kRandomOtSender, party_id, number_of_ots);
+  return std::span(data + 2 * kRandomOtMessageSize * section.number_of_consumed_elements,
+                   2 * kRandomOtMessageSize * number_of_ots);
+}
+
+RandomOtReceiverMaterial PreprocessingStore::ConsumeRandomOtsReceiver(std::size_t party_id,
+                                                                      std::size_t number_of_ots) {
+  auto [data, section] = Consume(PreprocessingKind::kRandomOtReceiver, party_id, number_of_ots);
+  if (number_of_ots == 0) return {};
+  const std::size_t first{section.number_of_consumed_elements};
+  return {std::span(data + kRandomOtMessageSize * first, kRandomOtMessageSize * number_of_ots),
+          ExtractBits(data + kRandomOtMessageSize * section.number_of_elements, first,
+                      number_of_ots)};
+}
+
+std::array<BitVector<>, 3> PreprocessingStore::ConsumeBinaryMts(std::size_t number_of_mts) {
+  auto [data, section] = Consume(PreprocessingKind::kBinaryMts, 0, number_of_mts);
+  if (number_of_mts == 0) return {};
+  const std::size_t first{section.number_of_consumed_elements};
+  const std::size_t bytes{BitsToBytes(section.number_of_elements)};
+  return {ExtractBits(data, first, number_of_mts), ExtractBits(data + bytes, first, number_of_mts),
+          ExtractBits(data + 2 * bytes, first, number_of_mts)};
+}
+
+std::span<const std::byte> PreprocessingStore::ConsumeGarbledCircuit(PreprocessingKind kind) {
+  assert(kind == PreprocessingKind::kGarbledCircuitGarbler ||
+         kind == PreprocessingKind::kGarbledCircuitEvaluator);
+  auto section{FindSection(kind, 0)};
+  if (section == nullptr || section->number_of_elements == 0 ||
+      section->number_of_consumed_elements != 0) {
+    throw std::runtime_error(
+        fmt::format("Preprocessing store contains no unused garbled circuit of kind {}",
+                    static_cast<std::uint32_t>(kind)));
+  }
+  auto [data, section_before] = Consume(kind, 0, section->number_of_elements);
+  return std::span(data, section_before.number_of_elements);
+}
+
+PreprocessingStoreWriter::PreprocessingStoreWriter(std::uint64_t session_id, std::size_t my_id,
+                                                   std::size_t number_of_parties)
+    : header_{kPreprocessingStoreMagic, kPreprocessingStoreVersion, 0, session_id, my_id,
+              number_of_parties} {
+  if (my_id >= number_of_parties) {
+    throw std::invalid_argument(
+        fmt::format("Party#{} does not exist among {} parties", my_id, number_of_parties));
+  }
+}
+
+void PreprocessingStoreWriter::AddRandomOtsSender(std::size_t party_id,
+                                                  std::span<const BitVector<>> outputs) {
+  std::vector<std::byte> data;
+  data.reserve(2 * kRandomOtMessageSize * outputs.size());
+  for (const auto& output : outputs) {
+    if (output.GetSize() != 2 * kRandomOtMessageSize * 8) {
+      throw std::invalid_argument("Only the outputs of 128 bit random OTs can be stored");
+    }
+    AppendBits(data, output);
+  }
+  AddSection(PreprocessingKind::kRandomOtSender, party_id, outputs.size(), std::move(data));
+}
+
+void PreprocessingStoreWriter::AddRandomOtsReceiver(std::size_t party_id,
+                                                    std::span<const BitVector<>> outputs,
+                                                    const BitVector<>& choices) {
+  if (choices.GetSize() != outputs.size()) {
+    throw std::invalid_argument("The number of choices and outputs of the random OTs differ");
+  }
+  std::vector<std::byte> data;
+  data.reserve(GetSectionSize(PreprocessingKind::kRandomOtReceiver, outputs.size()));
+  for (const auto& output : outputs) {
+    if (output.GetSize() != kRandomOtMessageSize * 8) {
+      throw std::invalid_argument("Only the outputs of 128 bit random OTs can be stored");
+    }
+    AppendBits(data, output);
+  }
+  AppendBits(data, choices);
+  AddSection(PreprocessingKind::kRandomOtReceiver, party_id, outputs.size(), std::move(data));
+}
+
+void PreprocessingStoreWriter::AddBinaryMts(const BitVector<>& a, const BitVector<>& b,
+                                            const BitVector<>& c) {
+  if (a.GetSize() != b.GetSize() || a.GetSize() != c.GetSize()) {
+    throw std::invalid_argument("The vectors of the multiplication triples differ in size");
+  }
+  std::vector<std::byte> data;
+  data.reserve(GetSectionSize(PreprocessingKind::kBinaryMts, a.GetSize()));
+  AppendBits(data, a);
+  AppendBits(data, b);
+  AppendBits(data, c);
+  AddSection(PreprocessingKind::kBinaryMts, 0, a.GetSize(), std::move(data));
+}
+
+void PreprocessingStoreWriter::AddGarbledCircuit(PreprocessingKind kind,
+                                                 std::vector<std::byte>&& data) {
+  if (kind != PreprocessingKind::kGarbledCircuitGarbler &&
+      kind != PreprocessingKind::kGarbledCircuitEvaluator) {
+    throw std::invalid_argument(
+        fmt::format("Kind {} of preprocessing material is no garbled circuit",
+                    static_cast<std::uint32_t>(kind)));
+  }
+  const std::size_t number_of_bytes{data.size()};
+  AddSection(kind, 0, number_of_bytes, std::move(data));
+}
+
+void PreprocessingStoreWriter::AddSection(PreprocessingKind kind, std::size_t party_id,
+                                          std::size_t number_of_elements,
+                                          std::vector<std::byte>&& data) {
+  if (party_id >= header_.number_of_parties) {
+    throw std::invalid_argument(fmt::format("Party#{} does not exist among {} parties", party_id,
+                                            header_.number_of_parties));
+  }
+  if (std::any_of(sections_.begin(), sections_.end(), [kind, party_id](auto& section) {
+        return section.kind == kind && section.party_id == party_id;
+      })) {
+    throw std::invalid_argument(
+        fmt::format("Preprocessing material of kind {} for Party#{} was already added",
+                    static_cast<std::uint32_t>(kind), party_id));
+  }
+  assert(data.size() == GetSectionSize(kind, number_of_elements));
+  sections_.push_back({kind, static_cast<std::uint32_t>(party_id), number_of_elements, 0,
+                       data.size(), 0});
+  data_.push_back(std::move(data));
+}
+
+void PreprocessingStoreWriter::Write(const std::filesystem::path& path) const {
+  auto header{header_};
+  header.number_of_sections = sections_.size();
+  auto sections{sections_};
+  std::size_t offset{AlignUp(sizeof(PreprocessingStoreHeader) +
+                             sections.size() * sizeof(PreprocessingStoreSection))};
+  for (auto& section : sections) {
+    section.offset = offset;
+    offset = AlignUp(offset + section.size);
+  }
+
+  auto temporary_path{path};
+  temporary_path += ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    // the material is secret, so only the owner may read it, which is set before it is written
+    std::filesystem::permissions(temporary_path, std::filesystem::perms::owner_read |
+                                                     std::filesystem::perms::owner_write);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sections.data()),
+               sections.size() * sizeof(PreprocessingStoreSection));
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+      // pad up to the aligned beginning of the section
+      const std::vector<char> padding(
+          sections[i].offset - static_cast<std::size_t>(file.tellp()), 0);
+      file.write(padding.data(), padding.size());
+      file.write(reinterpret_cast<const char*>(data_[i].data()), data_[i].size());
+    }
+    if (!file) {
+      throw std::runtime_error(
+          fmt::format("cannot write preprocessing store {}", temporary_path.string()));
+    }
+  }
+  std::filesystem::rename(temporary_path, path);
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,226 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion {
+
+// Kinds of preprocessing material in a PreprocessingStore
+enum class PreprocessingKind : std::uint32_t {
+  // random OTs in which we are the sender: the messages m_0 || m_1 (2 x 16 B) of every OT
+  kRandomOtSender = 0,
+  // random OTs in which we are the receiver: the messages m_c (16 B) of all OTs followed by the
+  // choice bits c
+  kRandomOtReceiver = 1,
+  // binary multiplication triples: the bits a, b and c of all triples
+  kBinaryMts = 2,
+  // integer multiplication triples: the arrays a, b and c of all triples
+  kIntegerMts8 = 3,
+  kIntegerMts16 = 4,
+  kIntegerMts32 = 5,
+  kIntegerMts64 = 6,
+  // a garbled circuit garbled ahead of time (see garbled_circuit::Provider), one element per byte,
+  // which can only be consumed as a whole: the secrets of the garbler
+  kGarbledCircuitGarbler = 7,
+  // and the public keys and garbled tables of the evaluator
+  kGarbledCircuitEvaluator = 8,
+};
+
+// Header of a store file
+struct PreprocessingStoreHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t number_of_sections;
+  std::uint64_t session_id;
+  std::uint64_t my_id;
+  std::uint64_t number_of_parties;
+};
+
+// Entry of the section table, which follows the header
+struct PreprocessingStoreSection {
+  PreprocessingKind kind;
+  // other party of the random OTs, 0 for the multiplication triples
+  std::uint32_t party_id;
+  std::uint64_t number_of_elements;
+  // position and size of the section data in the file in bytes
+  std::uint64_t offset;
+  std::uint64_t size;
+  // number of elements which have already been handed out and must never be used again
+  std::uint64_t number_of_consumed_elements;
+};
+
+inline constexpr std::array<char, 8> kPreprocessingStoreMagic{'M', 'O', 'T', 'I',
+                                                              'O', 'N', 'P', 'S'};
+inline constexpr std::uint32_t kPreprocessingStoreVersion{1};
+// the data of every section starts at a multiple of the alignment
+inline constexpr std::size_t kPreprocessingStoreAlignment{64};
+
+// Received random OTs taken from a PreprocessingStore
+struct RandomOtReceiverMaterial {
+  // 16 B message m_c of every OT
+  std::span<const std::byte> outputs;
+  BitVector<> choices;
+};
+
+// On-disk store of the preprocessing material of one party in one session, which is generated
+// ahead of time (e.g., with PreprocessingStoreWriter from the outputs of an earlier run) and
+// consumed by OtProviderFromFile and MtProviderFromFile.
+//
+// The file is memory-mapped and the sections are raw arrays, so that the material is read directly
+// from the mapping. Material is single use: every section has a persistent counter of the consumed
+// elements, which is advanced and flushed to the file before any material is handed out, and the
+// file is locked while it is open. Material of a store file is therefore never handed out twice,
+// even across processes. The parties need to consume their material in the same order, which is
+// the case if they run the same circuits.
+class PreprocessingStore {
+ public:
+  // Opens the store for party my_id in the session session_id
+  // throws std::runtime_error if the file cannot be opened, is locked by another process, or is not
+  // a valid store of this version, session and party
+  PreprocessingStore(const std::filesystem::path& path, std::uint64_t session_id,
+                     std::size_t my_id);
+  ~PreprocessingStore();
+
+  PreprocessingStore(const PreprocessingStore&) = delete;
+  PreprocessingStore& operator=(const PreprocessingStore&) = delete;
+
+  std::uint64_t GetSessionId() const noexcept { return header_->session_id; }
+  std::size_t GetMyId() const noexcept { return header_->my_id; }
+  std::size_t GetNumberOfParties() const noexcept { return header_->number_of_parties; }
+
+  // number of elements of the given kind which have not been consumed yet
+  std::size_t GetNumberOfAvailableElements(PreprocessingKind kind, std::size_t party_id = 0) const;
+
+  // The Consume* functions mark the next elements as consumed and return them
+  // throws std::runtime_error if less elements are available
+
+  // messages m_0 || m_1 (2 x 16 B) of every OT
+  std::span<const std::byte> ConsumeRandomOtsSender(std::size_t party_id,
+                                                    std::size_t number_of_ots);
+
+  RandomOtReceiverMaterial ConsumeRandomOtsReceiver(std::size_t party_id,
+                                                    std::size_t number_of_ots);
+
+  // vectors a, b, c of the triples
+  std::array<BitVector<>, 3> ConsumeBinaryMts(std::size_t number_of_mts);
+
+  // all bytes of the garbled circuit of the given kind, which can therefore only be used once
+  std::span<const std::byte> ConsumeGarbledCircuit(PreprocessingKind kind);
+
+  // arrays a, b, c of the triples
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  std::array<std::span<const T>, 3> ConsumeIntegerMts(std::size_t number_of_mts) {
+    auto [data, section] = Consume(GetIntegerMtsKind<T>(), 0, number_of_mts);
+    auto a{reinterpret_cast<const T*>(data)};
+    const std::size_t n{section.number_of_elements}, first{section.number_of_consumed_elements};
+    return {std::span(a + first, number_of_mts), std::span(a + n + first, number_of_mts),
+            std::span(a + 2 * n + first, number_of_mts)};
+  }
+
+  template <typename T>
+  static constexpr PreprocessingKind GetIntegerMtsKind() {
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+    if constexpr (sizeof(T) == 1) {
+      return PreprocessingKind::kIntegerMts8;
+    } else if constexpr (sizeof(T) == 2) {
+      return PreprocessingKind::kIntegerMts16;
+    } else if constexpr (sizeof(T) == 4) {
+      return PreprocessingKind::kIntegerMts32;
+    } else {
+      return PreprocessingKind::kIntegerMts64;
+    }
+  }
+
+ private:
+  const PreprocessingStoreSection* FindSection(PreprocessingKind kind, std::size_t party_id) const;
+
+  // returns the section data and a copy of the section entry before the consumption
+  std::pair<const std::byte*, PreprocessingStoreSection> Consume(PreprocessingKind kind,
+                                                                 std::size_t party_id,
+                                                                 std::size_t number_of_elements);
+
+  int file_descriptor_{-1};
+  std::byte* address_{nullptr};
+  std::size_t size_{0};
+  PreprocessingStoreHeader* header_{nullptr};
+  std::span<PreprocessingStoreSection> sections_;
+  std::mutex mutex_;
+};
+
+// Collects preprocessing material and writes it as a PreprocessingStore file
+class PreprocessingStoreWriter {
+ public:
+  PreprocessingStoreWriter(std::uint64_t session_id, std::size_t my_id,
+                           std::size_t number_of_parties);
+
+  // outputs as returned by ROtSender::GetOutputs for 128 bit OTs, i.e., m_0 || m_1
+  void AddRandomOtsSender(std::size_t party_id, std::span<const BitVector<>> outputs);
+
+  // outputs and choices as returned by ROtReceiver for 128 bit OTs
+  void AddRandomOtsReceiver(std::size_t party_id, std::span<const BitVector<>> outputs,
+                            const BitVector<>& choices);
+
+  void AddBinaryMts(const BitVector<>& a, const BitVector<>& b, const BitVector<>& c);
+
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  void AddIntegerMts(std::span<const T> a, std::span<const T> b, std::span<const T> c) {
+    if (a.size() != b.size() || a.size() != c.size()) {
+      throw std::invalid_argument("The vectors of the multiplication triples differ in size");
+    }
+    std::vector<std::byte> data(3 * a.size_bytes());
+    for (std::size_t i = 0; i < 3; ++i) {
+      const auto& source{i == 0 ? a : (i == 1 ? b : c)};
+      std::copy_n(reinterpret_cast<const std::byte*>(source.data()), source.size_bytes(),
+                  data.data() + i * source.size_bytes());
+    }
+    AddSection(PreprocessingStore::GetIntegerMtsKind<T>(), 0, a.size(), std::move(data));
+  }
+
+  // kind is kGarbledCircuitGarbler or kGarbledCircuitEvaluator
+  void AddGarbledCircuit(PreprocessingKind kind, std::vector<std::byte>&& data);
+
+  // writes the store atomically, i.e., to a temporary file which is then renamed to path, which
+  // only the owner may read and write
+  void Write(const std::filesystem::path& path) const;
+
+ private:
+  void AddSection(PreprocessingKind kind, std::size_t party_id, std::size_t number_of_elements,
+                  std::vector<std::byte>&& data);
+
+  PreprocessingStoreHeader header_;
+  std::vector<PreprocessingStoreSection> sections_;
+  std::vector<std::vector<std::byte>> data_;
+};
+
+}  // namespace encrypto::motion
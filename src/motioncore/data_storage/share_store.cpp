@@ -0,0 +1,257 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "share_store.h"
+
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "base/register.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
+#include "protocols/boolean_gmw/boolean_gmw_share.h"
+#include "protocols/boolean_gmw/boolean_gmw_wire.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+static_assert(sizeof(ShareStoreHeader) == 40);
+static_assert(sizeof(ShareStoreEntry) == 32);
+
+// the data of every share starts at a multiple of the alignment
+constexpr std::size_t kShareStoreAlignment{64};
+
+std::size_t AlignUp(std::size_t offset) {
+  return (offset + kShareStoreAlignment - 1) / kShareStoreAlignment * kShareStoreAlignment;
+}
+
+std::size_t GetShareSize(const ShareStoreEntry& entry) {
+  if (entry.protocol == MpcProtocol::kArithmeticGmw) {
+    return entry.number_of_simd_values * (entry.bit_length / 8);
+  }
+  return entry.bit_length * BitsToBytes(entry.number_of_simd_values);
+}
+
+bool IsValidEntry(const ShareStoreEntry& entry) {
+  switch (entry.protocol) {
+    case MpcProtocol::kArithmeticGmw:
+      return entry.bit_length == 8 || entry.bit_length == 16 || entry.bit_length == 32 ||
+             entry.bit_length == 64 || entry.bit_length == 128;
+    case MpcProtocol::kBooleanGmw:
+      return entry.bit_length > 0;
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+SharePointer LoadArithmeticGmwShare(Backend& backend, const std::byte* data,
+                                    std::size_t number_of_simd_values) {
+  // the data may be accessed in place since it is aligned
+  const auto values{reinterpret_cast<const T*>(data)};
+  auto wire{backend.GetRegister()->EmplaceWire<proto::arithmetic_gmw::Wire<T>>(
+      std::vector<T>(values, values + number_of_simd_values), backend)};
+  wire->SetOnlineFinished();
+  return std::make_shared<proto::arithmetic_gmw::Share<T>>(wire);
+}
+
+template <typename T>
+std::vector<std::byte> GetArithmeticGmwValues(const SharePointer& share) {
+  auto arithmetic_share{std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(share)};
+  assert(arithmetic_share);
+  auto wire{arithmetic_share->GetArithmeticWire()};
+  wire->GetIsReadyCondition().Wait();
+  const auto& values{wire->GetValues()};
+  const auto bytes{reinterpret_cast<const std::byte*>(values.data())};
+  return std::vector<std::byte>(bytes, bytes + values.size() * sizeof(T));
+}
+
+}  // namespace
+
+ShareStore::ShareStore(const std::filesystem::path& path, std::uint64_t session_id,
+                       std::size_t my_id)
+    : file_(path) {
+  const auto bytes{file_.GetBytes()};
+  if (bytes.size() < sizeof(ShareStoreHeader)) {
+    throw std::runtime_error(fmt::format("{} is too small to be a share store", path.string()));
+  }
+  const auto& header{GetHeader()};
+  if (header.magic != kShareStoreMagic) {
+    throw std::runtime_error(fmt::format("{} is not a share store", path.string()));
+  }
+  if (header.version != kShareStoreVersion) {
+    throw std::runtime_error(
+        fmt::format("Share store {} has version {}, but version {} is supported", path.string(),
+                    header.version, kShareStoreVersion));
+  }
+  if (header.session_id != session_id || header.my_id != my_id) {
+    throw std::runtime_error(fmt::format(
+        "Share store {} belongs to Party#{} of session {} instead of Party#{} of session {}",
+        path.string(), header.my_id, header.session_id, my_id, session_id));
+  }
+  const std::size_t table_end{sizeof(ShareStoreHeader) +
+                              header.number_of_shares * sizeof(ShareStoreEntry)};
+  if (table_end > bytes.size()) {
+    throw std::runtime_error(
+        fmt::format("Share table of share store {} is truncated", path.string()));
+  }
+  entries_ = std::span(
+      reinterpret_cast<const ShareStoreEntry*>(bytes.data() + sizeof(ShareStoreHeader)),
+      header.number_of_shares);
+  for (const auto& entry : entries_) {
+    if (!IsValidEntry(entry) || entry.offset % kShareStoreAlignment != 0 ||
+        entry.offset < table_end || entry.offset + entry.size > bytes.size() ||
+        entry.size != GetShareSize(entry)) {
+      throw std::runtime_error(
+          fmt::format("Share store {} contains an invalid share", path.string()));
+    }
+  }
+}
+
+const ShareStoreEntry& ShareStore::GetEntry(std::size_t index) const {
+  if (index >= entries_.size()) {
+    throw std::out_of_range(
+        fmt::format("Share store contains {} shares, but share #{} was requested", entries_.size(),
+                    index));
+  }
+  return entries_[index];
+}
+
+SharePointer ShareStore::Load(Backend& backend, std::size_t index) const {
+  const auto& entry{GetEntry(index)};
+  const std::byte* data{file_.GetBytes().data() + entry.offset};
+  const std::size_t number_of_simd_values{entry.number_of_simd_values};
+  if (entry.protocol == MpcProtocol::kBooleanGmw) {
+    const std::size_t wire_size{BitsToBytes(number_of_simd_values)};
+    std::vector<WirePointer> wires;
+    wires.reserve(entry.bit_length);
+    for (std::size_t i = 0; i < entry.bit_length; ++i) {
+      wires.emplace_back(backend.GetRegister()->EmplaceWire<proto::boolean_gmw::Wire>(
+          BitVector<>(data + i * wire_size, number_of_simd_values), backend));
+      wires.back()->SetOnlineFinished();
+    }
+    return std::make_shared<proto::boolean_gmw::Share>(wires);
+  }
+  switch (entry.bit_length) {
+    case 8:
+      return LoadArithmeticGmwShare<std::uint8_t>(backend, data, number_of_simd_values);
+    case 16:
+      return LoadArithmeticGmwShare<std::uint16_t>(backend, data, number_of_simd_values);
+    case 32:
+      return LoadArithmeticGmwShare<std::uint32_t>(backend, data, number_of_simd_values);
+    case 64:
+      return LoadArithmeticGmwShare<std::uint64_t>(backend, data, number_of_simd_values);
+    default:
+      return LoadArithmeticGmwShare<__uint128_t>(backend, data, number_of_simd_values);
+  }
+}
+
+ShareStoreWriter::ShareStoreWriter(std::uint64_t session_id, std::size_t my_id,
+                                   std::size_t number_of_parties)
+    : header_{kShareStoreMagic, kShareStoreVersion, 0, session_id, my_id, number_of_parties} {
+  if (my_id >= number_of_parties) {
+    throw std::invalid_argument(
+        fmt::format("Party#{} does not exist among {} parties", my_id, number_of_parties));
+  }
+}
+
+std::size_t ShareStoreWriter::Add(const SharePointer& share) {
+  ShareStoreEntry entry{share->GetProtocol(), static_cast<std::uint32_t>(share->GetBitLength()),
+                        share->GetNumberOfSimdValues(), 0, 0};
+  if (!IsValidEntry(entry)) {
+    throw std::invalid_argument(
+        fmt::format("Cannot store a share of {} with bit length {}",
+                    to_string(share->GetProtocol()), share->GetBitLength()));
+  }
+  std::vector<std::byte> data;
+  if (entry.protocol == MpcProtocol::kBooleanGmw) {
+    data.reserve(GetShareSize(entry));
+    for (const auto& wire : share->GetWires()) {
+      auto boolean_wire{std::dynamic_pointer_cast<const proto::boolean_gmw::Wire>(wire)};
+      assert(boolean_wire);
+      boolean_wire->GetIsReadyCondition().Wait();
+      const auto& values{boolean_wire->GetValues().GetData()};
+      data.insert(data.end(), values.begin(),
+                  values.begin() + BitsToBytes(entry.number_of_simd_values));
+    }
+  } else if (entry.bit_length == 8) {
+    data = GetArithmeticGmwValues<std::uint8_t>(share);
+  } else if (entry.bit_length == 16) {
+    data = GetArithmeticGmwValues<std::uint16_t>(share);
+  } else if (entry.bit_length == 32) {
+    data = GetArithmeticGmwValues<std::uint32_t>(share);
+  } else if (entry.bit_length == 64) {
+    data = GetArithmeticGmwValues<std::uint64_t>(share);
+  } else {
+    data = GetArithmeticGmwValues<__uint128_t>(share);
+  }
+  assert(data.size() == GetShareSize(entry));
+  entry.size = data.size();
+  entries_.push_back(entry);
+  data_.push_back(std::move(data));
+  return entries_.size() - 1;
+}
+
+void ShareStoreWriter::Write(const std::filesystem::path& path) const {
+  auto header{header_};
+  header.number_of_shares = entries_.size();
+  auto entries{entries_};
+  std::size_t offset{AlignUp(sizeof(ShareStoreHeader) + entries.size() * sizeof(ShareStoreEntry))};
+  for (auto& entry : entries) {
+    entry.offset = offset;
+    offset = AlignUp(offset + entry.size);
+  }
+
+  auto temporary_path{path};
+  temporary_path += ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    // the shares are secret, so only the owner may read them, which is set before they are written
+    std::filesystem::permissions(temporary_path, std::filesystem::perms::owner_read |
+                                                     std::filesystem::perms::owner_write);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               entries.size() * sizeof(ShareStoreEntry));
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      // pad up to the aligned beginning of the share
+      const std::vector<char> padding(entries[i].offset - static_cast<std::size_t>(file.tellp()),
+                                      0);
+      file.write(padding.data(), padding.size());
+      file.write(reinterpret_cast<const char*>(data_[i].data()), data_[i].size());
+    }
+    if (!file) {
+      throw std::runtime_error(fmt::format("cannot write share store {}", temporary_path.string()));
+    }
+  }
+  std::filesystem::rename(temporary_path, path);
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,124 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "utility/mapped_file.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+class Backend;
+class Share;
+using SharePointer = std::shared_ptr<Share>;
+
+// Header of a share store file
+struct ShareStoreHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t number_of_shares;
+  std::uint64_t session_id;
+  std::uint64_t my_id;
+  std::uint64_t number_of_parties;
+};
+
+// Entry of the share table, which follows the header
+struct ShareStoreEntry {
+  // kArithmeticGmw or kBooleanGmw
+  MpcProtocol protocol;
+  // bits of the integer type of an arithmetic share, number of wires of a Boolean share
+  std::uint32_t bit_length;
+  std::uint64_t number_of_simd_values;
+  // position and size of the share data in the file in bytes
+  std::uint64_t offset;
+  std::uint64_t size;
+};
+
+inline constexpr std::array<char, 8> kShareStoreMagic{'M', 'O', 'T', 'I', 'O', 'N', 'S', 'H'};
+inline constexpr std::uint32_t kShareStoreVersion{1};
+
+// On-disk store of the shares of one party, e.g., of the intermediate results of one stage of a
+// pipeline, which a later job loads as shares without sharing them again. The shares are raw
+// arrays in the native byte order: the values of an arithmetic GMW share and the SIMD bits of every
+// wire of a Boolean GMW share. The file is memory-mapped and, unlike a PreprocessingStore, can be
+// loaded any number of times. All parties need to load the shares of the same stage in the same
+// order.
+class ShareStore {
+ public:
+  // Opens the store of party my_id in the session session_id
+  // throws std::runtime_error if the file cannot be opened or is not a valid store of this version,
+  // session and party
+  ShareStore(const std::filesystem::path& path, std::uint64_t session_id, std::size_t my_id);
+
+  std::uint64_t GetSessionId() const noexcept { return GetHeader().session_id; }
+  std::size_t GetMyId() const noexcept { return GetHeader().my_id; }
+  std::size_t GetNumberOfParties() const noexcept { return GetHeader().number_of_parties; }
+
+  std::size_t GetNumberOfShares() const noexcept { return entries_.size(); }
+  // throws std::out_of_range if there is no share index
+  const ShareStoreEntry& GetEntry(std::size_t index) const;
+
+  // Creates share index in backend with wires that already hold their values, i.e., which is
+  // ready without any gate or communication
+  SharePointer Load(Backend& backend, std::size_t index) const;
+
+ private:
+  const ShareStoreHeader& GetHeader() const noexcept {
+    return *reinterpret_cast<const ShareStoreHeader*>(file_.GetBytes().data());
+  }
+
+  MappedFile file_;
+  std::span<const ShareStoreEntry> entries_;
+};
+
+// Collects the values of evaluated shares and writes them as a ShareStore file
+class ShareStoreWriter {
+ public:
+  ShareStoreWriter(std::uint64_t session_id, std::size_t my_id, std::size_t number_of_parties);
+
+  // Adds the values of an arithmetic or Boolean GMW share and returns its index in the store,
+  // waits until the share is evaluated
+  // throws std::invalid_argument for shares of other protocols
+  std::size_t Add(const SharePointer& share);
+
+  // writes the store atomically, i.e., to a temporary file which is then renamed to path, which
+  // only the owner may read and write
+  void Write(const std::filesystem::path& path) const;
+
+ private:
+  ShareStoreHeader header_;
+  std::vector<ShareStoreEntry> entries_;
+  std::vector<std::vector<std::byte>> data_;
+};
+
+}  // namespace encrypto::motion
@@ -22,22 +22,57 @@
 
 #include "gate_executor.h"
 
+#include <algorithm>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/fiber/fss.hpp>
+#include <fmt/format.h>
+
+#include "base/configuration.h"
 #include "base/register.h"
+#include "communication/communication_layer.h"
 #include "protocols/gate.h"
+#include "protocols/wire.h"
+#include "statistics/gate_profile.h"
 #include "statistics/run_time_statistics.h"
+#include "utility/contention_tracing.h"
 #include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
 #include "utility/logger.h"
 
 namespace encrypto::motion {
 
-GateExecutor::GateExecutor(Register& reg, std::function<void(void)> presetup_function,
+GateExecutor::GateExecutor(Register& reg, const Configuration& configuration,
+                           communication::CommunicationLayer& communication_layer,
+                           std::function<void(void)> presetup_function,
                            std::shared_ptr<Logger> logger)
     : register_(reg),
+      configuration_(configuration),
+      communication_layer_(communication_layer),
       presetup_function_(std::move(presetup_function)),
       logger_(std::move(logger)) {}
 
+GateExecutor::~GateExecutor() = default;
+
+// the gates of unmerged subcircuits are missing and their preprocessing requests are not made yet
+static void CheckNoPendingSubcircuits(const Register& register_reference) {
+  if (const auto n{register_reference.GetNumberOfPendingSubcircuits()}; n != 0) {
+    throw std::logic_error(
+        fmt::format("Cannot evaluate the circuit, {} subcircuits are not merged", n));
+  }
+}
+
 void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
+  CheckNoPendingSubcircuits(register_);
+  register_.EliminateDeadGates();
   statistics.RecordStart<RunTimeStatistics::StatisticsId::kEvaluate>();
+  StartContentionTracing();
 
   presetup_function_();
 
@@ -46,18 +81,32 @@ void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
         "Start evaluating the circuit gates sequentially (online after all finished setup)");
   }
 
-  // create a pool with std::thread::hardware_concurrency() no. of threads
-  // to execute fibers
-  FiberThreadPool fiber_pool(0, 2 * register_.GetTotalNumberOfGates());
+  // use the persistent pool if there is one, otherwise create a pool for this evaluation
+  std::unique_ptr<FiberThreadPool> own_fiber_pool;
+  auto& fiber_pool = AcquireFiberThreadPool(own_fiber_pool);
+  const auto number_of_steals = fiber_pool.get_number_of_steals();
+  const auto number_of_parks = fiber_pool.get_number_of_parks();
+  // computed once for both the evaluation order and the ready gate queue
+  const auto critical_path_lengths{configuration_.GetCriticalPathPriority()
+                                       ? ComputeCriticalPathLengths()
+                                       : std::vector<std::size_t>()};
+  auto ready_gate_queue = MakeReadyGateQueue(critical_path_lengths);
+  RegisterConsumers();
+  StartProfiling();
+  StartLayerOpenings();
 
   // ------------------------------ setup phase ------------------------------
   statistics.RecordStart<RunTimeStatistics::StatisticsId::kGatesSetup>();
 
   // Evaluate the setup phase of all the gates
   for (auto& gate : register_.GetGates()) {
+    if (gate->SetupIsReady()) {
+      // kept from the previous evaluation, see Register::ClearDownstreamGates
+      continue;
+    }
     if (gate->NeedsSetup()) {
       fiber_pool.post([&] {
-        gate->EvaluateSetup();
+        EvaluateGateSetup(*gate);
         gate->SetSetupIsReady();
         register_.IncrementEvaluatedGatesSetupCounter();
       });
@@ -76,17 +125,39 @@ void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
   // ------------------------------ online phase ------------------------------
   statistics.RecordStart<RunTimeStatistics::StatisticsId::kGatesOnline>();
 
-  // Evaluate the online phase of all the gates
-  for (auto& gate : register_.GetGates()) {
-    if (gate->NeedsOnline()) {
-      fiber_pool.post([&] {
-        gate->EvaluateOnline();
+  // the openings of a layer are batched once the inputs of its gates are ready
+  if (configuration_.GetDependencyDrivenScheduling() || configuration_.GetLayerWiseEvaluation()) {
+    // Post the online phase of a gate only after all of its input wires are online-ready
+    SetProcessingQueueFunction(fiber_pool, ready_gate_queue.get());
+    RegisterDependencies(false);
+    for (auto gate : GetEvaluationOrder(critical_path_lengths)) {
+      if (gate->OnlineIsReady()) {
+        continue;
+      }
+      if (gate->NeedsOnline()) {
+        // resolve the guard dependency
+        gate->IfReadyAddToProcessingQueue();
+      } else {
         gate->SetOnlineIsReady();
-        register_.IncrementEvaluatedGatesOnlineCounter();
-      });
-    } else {
-      // cannot be done earlier because output wires did not yet exist
-      gate->SetOnlineIsReady();
+      }
+    }
+  } else {
+    // Evaluate the online phase of all the gates
+    for (auto gate : GetEvaluationOrder(critical_path_lengths)) {
+      if (gate->OnlineIsReady()) {
+        continue;
+      }
+      if (gate->NeedsOnline()) {
+        fiber_pool.post([this, gate] {
+          EvaluateGateOnline(*gate);
+          gate->SetOnlineIsReady();
+          ReleaseInputWires(*gate);
+          register_.IncrementEvaluatedGatesOnlineCounter();
+        });
+      } else {
+        // cannot be done earlier because output wires did not yet exist
+        gate->SetOnlineIsReady();
+      }
     }
   }
 
@@ -98,45 +169,106 @@ void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
 
   // --------------------------------------------------------------------------
 
-  fiber_pool.join();
+  if (own_fiber_pool) {
+    fiber_pool.join();
+  } else {
+    // keep the persistent pool alive for the next evaluation
+    fiber_pool.wait_idle();
+  }
+  register_.SetProcessingQueueFunction(nullptr);
+  layer_openings_ = nullptr;
+  statistics.number_of_steals = fiber_pool.get_number_of_steals() - number_of_steals;
+  statistics.number_of_parks = fiber_pool.get_number_of_parks() - number_of_parks;
+  statistics.number_of_released_wire_bytes = number_of_released_wire_bytes_.exchange(0);
+  statistics.RecordPeakResidentSetSize();
+  FinishProfiling(statistics);
+  FinishContentionTracing(statistics);
+  RecordEvaluationMetrics(statistics);
 
   statistics.RecordEnd<RunTimeStatistics::StatisticsId::kEvaluate>();
 }
 
 void GateExecutor::Evaluate(RunTimeStatistics& statistics) {
+  CheckNoPendingSubcircuits(register_);
+  // before the gates are posted and the preprocessing counts their requests
+  register_.EliminateDeadGates();
   logger_->LogInfo(
       "Start evaluating the circuit gates in parallel (online as soon as some finished setup)");
 
   statistics.RecordStart<RunTimeStatistics::StatisticsId::kEvaluate>();
+  StartContentionTracing();
 
   // Run preprocessing setup in a separate thread
   auto preprocessing_future = std::async(std::launch::async, [this] { presetup_function_(); });
 
-  // create a pool with std::thread::hardware_concurrency() no. of threads
-  // to execute fibers
-  FiberThreadPool fiber_pool(0, register_.GetTotalNumberOfGates());
+  // use the persistent pool if there is one, otherwise create a pool for this evaluation
+  std::unique_ptr<FiberThreadPool> own_fiber_pool;
+  auto& fiber_pool = AcquireFiberThreadPool(own_fiber_pool);
+  const auto number_of_steals = fiber_pool.get_number_of_steals();
+  const auto number_of_parks = fiber_pool.get_number_of_parks();
+  // computed once for both the evaluation order and the ready gate queue
+  const auto critical_path_lengths{configuration_.GetCriticalPathPriority()
+                                       ? ComputeCriticalPathLengths()
+                                       : std::vector<std::size_t>()};
+  auto ready_gate_queue = MakeReadyGateQueue(critical_path_lengths);
+  RegisterConsumers();
+  StartProfiling();
+  StartLayerOpenings();
 
-  // Evaluate all the gates
-  for (auto& gate : register_.GetGates()) {
-    if (gate->NeedsSetup() || gate->NeedsOnline()) {
-      fiber_pool.post([&] {
-        gate->EvaluateSetup();
-        gate->SetSetupIsReady();
-        if (gate->NeedsSetup()) {
+  if (configuration_.GetDependencyDrivenScheduling() || configuration_.GetLayerWiseEvaluation()) {
+    // The setup phases are posted immediately, whereas the online phase of a gate is posted by
+    // the fiber resolving its last dependency, i.e., its own setup phase or an input wire.
+    SetProcessingQueueFunction(fiber_pool, ready_gate_queue.get());
+    RegisterDependencies(true);
+    for (auto gate : GetEvaluationOrder(critical_path_lengths)) {
+      if (gate->OnlineIsReady()) {
+        // kept from the previous evaluation, see Register::ClearDownstreamGates
+        continue;
+      }
+      if (gate->NeedsSetup()) {
+        fiber_pool.post([this, gate] {
+          EvaluateGateSetup(*gate);
+          gate->SetSetupIsReady();
           register_.IncrementEvaluatedGatesSetupCounter();
-        }
+          gate->IfReadyAddToProcessingQueue();
+        });
+      } else {
+        gate->SetSetupIsReady();
+      }
+      if (gate->NeedsSetup() || gate->NeedsOnline()) {
+        // resolve the guard dependency
+        gate->IfReadyAddToProcessingQueue();
+      } else {
+        gate->SetOnlineIsReady();
+      }
+    }
+  } else {
+    // Evaluate all the gates
+    for (auto gate : GetEvaluationOrder(critical_path_lengths)) {
+      if (gate->OnlineIsReady()) {
+        continue;
+      }
+      if (gate->NeedsSetup() || gate->NeedsOnline()) {
+        fiber_pool.post([this, gate] {
+          EvaluateGateSetup(*gate);
+          gate->SetSetupIsReady();
+          if (gate->NeedsSetup()) {
+            register_.IncrementEvaluatedGatesSetupCounter();
+          }
 
-        // XXX: maybe insert a 'yield' here?
-        gate->EvaluateOnline();
+          // XXX: maybe insert a 'yield' here?
+          EvaluateGateOnline(*gate);
+          gate->SetOnlineIsReady();
+          ReleaseInputWires(*gate);
+          if (gate->NeedsOnline()) {
+            register_.IncrementEvaluatedGatesOnlineCounter();
+          }
+        });
+      } else {
+        // cannot be done earlier because output wires did not yet exist
+        gate->SetSetupIsReady();
         gate->SetOnlineIsReady();
-        if (gate->NeedsOnline()) {
-          register_.IncrementEvaluatedGatesOnlineCounter();
-        }
-      });
-    } else {
-      // cannot be done earlier because output wires did not yet exist
-      gate->SetSetupIsReady();
-      gate->SetOnlineIsReady();
+      }
     }
   }
 
@@ -145,9 +277,496 @@ void GateExecutor::Evaluate(RunTimeStatistics& statistics) {
   // we have to wait until all gates are evaluated before we close the pool
   register_.CheckOnlineCondition();
   register_.GetGatesOnlineDoneCondition()->Wait();
-  fiber_pool.join();
+  if (own_fiber_pool) {
+    fiber_pool.join();
+  } else {
+    // keep the persistent pool alive for the next evaluation
+    fiber_pool.wait_idle();
+  }
+  register_.SetProcessingQueueFunction(nullptr);
+  layer_openings_ = nullptr;
+  statistics.number_of_steals = fiber_pool.get_number_of_steals() - number_of_steals;
+  statistics.number_of_parks = fiber_pool.get_number_of_parks() - number_of_parks;
+  statistics.number_of_released_wire_bytes = number_of_released_wire_bytes_.exchange(0);
+  statistics.RecordPeakResidentSetSize();
+  FinishProfiling(statistics);
+  FinishContentionTracing(statistics);
+  RecordEvaluationMetrics(statistics);
 
   statistics.RecordEnd<RunTimeStatistics::StatisticsId::kEvaluate>();
 }
 
+void GateExecutor::EvaluateGateSetup(Gate& gate) {
+  if ((!profiler_ && !metrics_) || !gate.NeedsSetup()) {
+    gate.EvaluateSetup();
+    return;
+  }
+  if (metrics_) {
+    metrics_->setup_started.Add();
+  }
+  if (profiler_) {
+    profiler_->Profile(gate, GateProfile::Phase::kSetup, [&gate] { gate.EvaluateSetup(); });
+  } else {
+    gate.EvaluateSetup();
+  }
+  if (metrics_) {
+    metrics_->setup_evaluated.Add();
+  }
+}
+
+void GateExecutor::EvaluateGateOnline(Gate& gate) {
+  if ((!profiler_ && !metrics_) || !gate.NeedsOnline()) {
+    gate.EvaluateOnline();
+    return;
+  }
+  if (metrics_) {
+    metrics_->online_started.Add();
+  }
+  if (profiler_) {
+    profiler_->Profile(gate, GateProfile::Phase::kOnline, [&gate] { gate.EvaluateOnline(); });
+  } else {
+    gate.EvaluateOnline();
+  }
+  if (metrics_) {
+    metrics_->online_evaluated.Add();
+  }
+}
+
+void GateExecutor::RegisterMetrics(MetricsRegistry& registry, const MetricLabels& labels) {
+  auto with_phase = [&labels](std::string phase) {
+    auto phase_labels{labels};
+    phase_labels.emplace_back("phase", std::move(phase));
+    return phase_labels;
+  };
+  constexpr std::string_view kStarted{"motion_gate_phases_started"};
+  constexpr std::string_view kStartedHelp{"Setup and online phases of gates started"};
+  constexpr std::string_view kEvaluated{"motion_gate_phases_evaluated"};
+  constexpr std::string_view kEvaluatedHelp{"Setup and online phases of gates evaluated"};
+  metrics_ = std::make_unique<Metrics>(Metrics{
+      .setup_started = registry.GetCounter(kStarted, kStartedHelp, with_phase("setup")),
+      .setup_evaluated = registry.GetCounter(kEvaluated, kEvaluatedHelp, with_phase("setup")),
+      .online_started = registry.GetCounter(kStarted, kStartedHelp, with_phase("online")),
+      .online_evaluated = registry.GetCounter(kEvaluated, kEvaluatedHelp, with_phase("online")),
+      .evaluations = registry.GetCounter("motion_evaluations", "Circuit evaluations", labels),
+      .steals = registry.GetCounter("motion_fiber_steals",
+                                    "Fibers stolen from other workers of the fiber pool", labels),
+      .parks = registry.GetCounter("motion_fiber_parks",
+                                   "Suspensions of fiber pool workers without work", labels)});
+}
+
+std::size_t GateExecutor::GetNumberOfRunningGatePhases() const {
+  if (!metrics_) {
+    return 0;
+  }
+  // read the evaluated phases first, such that each of them is also counted as started
+  const auto evaluated{metrics_->setup_evaluated.Get() + metrics_->online_evaluated.Get()};
+  const auto started{metrics_->setup_started.Get() + metrics_->online_started.Get()};
+  return started > evaluated ? started - evaluated : 0;
+}
+
+void GateExecutor::RecordEvaluationMetrics(const RunTimeStatistics& statistics) {
+  if (metrics_) {
+    metrics_->evaluations.Add();
+    metrics_->steals.Add(statistics.number_of_steals);
+    metrics_->parks.Add(statistics.number_of_parks);
+  }
+}
+
+void GateExecutor::StartProfiling() {
+  if (!configuration_.GetProfileGates()) {
+    profiler_ = nullptr;
+    return;
+  }
+  const auto& gates = register_.GetGates();
+  const auto layers = ComputeLayers();
+  std::unordered_map<const Wire*, std::int64_t> producers;
+  std::unordered_map<const Gate*, GateProfiler::GateInfo> gate_infos;
+  gate_infos.reserve(gates.size());
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    GateProfiler::GateInfo gate_info{.depth = layers[i], .parent_gate_ids = {}};
+    for (auto& wire : gates[i]->GetInputWires()) {
+      if (auto it = producers.find(wire.get()); it != producers.end()) {
+        gate_info.parent_gate_ids.push_back(it->second);
+      }
+    }
+    // a gate reading several wires of a parent depends on it only once
+    std::sort(gate_info.parent_gate_ids.begin(), gate_info.parent_gate_ids.end());
+    gate_info.parent_gate_ids.erase(
+        std::unique(gate_info.parent_gate_ids.begin(), gate_info.parent_gate_ids.end()),
+        gate_info.parent_gate_ids.end());
+    for (auto& wire : gates[i]->GetOutputWires()) {
+      producers[wire.get()] = gates[i]->GetId();
+    }
+    gate_infos.emplace(gates[i].get(), std::move(gate_info));
+  }
+  profiler_ = std::make_unique<GateProfiler>(std::move(gate_infos));
+}
+
+void GateExecutor::FinishProfiling(RunTimeStatistics& statistics) {
+  if (profiler_) {
+    statistics.gate_profile = std::make_shared<const GateProfile>(profiler_->TakeProfile());
+    profiler_ = nullptr;
+  }
+}
+
+void GateExecutor::StartContentionTracing() {
+  if (configuration_.GetTraceContention()) {
+    ContentionTracer::BeginSession();
+  }
+}
+
+void GateExecutor::FinishContentionTracing(RunTimeStatistics& statistics) {
+  if (!configuration_.GetTraceContention()) {
+    return;
+  }
+  auto report{std::make_shared<const ContentionReport>(ContentionTracer::EndSession())};
+  if (logger_) {
+    logger_->LogInfo("Contention report\n" + report->PrintTopN());
+  }
+  statistics.contention_report = std::move(report);
+}
+
+FiberThreadPool& GateExecutor::AcquireFiberThreadPool(
+    std::unique_ptr<FiberThreadPool>& own_fiber_pool) {
+  if (persistent_fiber_pool_) {
+    return *persistent_fiber_pool_;
+  }
+  // create a pool with the configured number of threads, but at least two, to execute fibers
+  own_fiber_pool = std::make_unique<FiberThreadPool>(
+      std::max<std::size_t>(configuration_.GetNumOfThreads(), 2), 0, true,
+      configuration_.GetPinWorkerThreads());
+  return *own_fiber_pool;
+}
+
+void GateExecutor::RegisterConsumers() {
+  if (!configuration_.GetReleaseWireValues()) {
+    return;
+  }
+  std::unordered_map<Wire*, std::size_t> number_of_consumers;
+  for (auto& gate : register_.GetGates()) {
+    if (gate->NeedsOnline()) {
+      for (auto& wire : gate->GetInputWires()) {
+        ++number_of_consumers[wire.get()];
+      }
+    }
+  }
+  for (auto& [wire, n] : number_of_consumers) {
+    wire->SetNumberOfConsumers(n);
+  }
+}
+
+void GateExecutor::ReleaseInputWires(Gate& gate) {
+  if (!configuration_.GetReleaseWireValues() || !gate.NeedsOnline()) {
+    return;
+  }
+  for (auto& wire : gate.GetInputWires()) {
+    if (wire->ConsumerFinished()) {
+      number_of_released_wire_bytes_ += wire->ReleaseValues();
+    }
+  }
+}
+
+void GateExecutor::RegisterDependencies(bool setup_is_dependency) {
+  for (auto& gate : register_.GetGates()) {
+    const bool needs_setup = setup_is_dependency && gate->NeedsSetup();
+    if ((!gate->NeedsOnline() && !needs_setup) || gate->OnlineIsReady()) {
+      continue;
+    }
+    const auto input_wires = gate->GetInputWires();
+    // the guard dependency prevents the gate from being posted while its wires are registered
+    gate->SetNumberOfUnreadyDependencies(input_wires.size() + (needs_setup ? 2 : 1));
+    for (auto& wire : input_wires) {
+      assert(wire);
+      if (!wire->RegisterWaitingGate(*gate)) {
+        // the wire is already online-ready
+        gate->IfReadyAddToProcessingQueue();
+      }
+    }
+  }
+}
+
+std::vector<std::size_t> GateExecutor::ComputeLayers() const {
+  const auto& gates = register_.GetGates();
+  std::vector<std::size_t> layers(gates.size(), 0);
+  // gates are registered after the gates producing their inputs, hence a single pass suffices
+  std::unordered_map<const Wire*, std::size_t> wire_layers;
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    std::size_t layer = 0;
+    for (auto& wire : gates[i]->GetInputWires()) {
+      // wires without a registered producer, e.g., the hidden wires of interactive gates, are
+      // treated as circuit inputs
+      if (auto it = wire_layers.find(wire.get()); it != wire_layers.end()) {
+        layer = std::max(layer, it->second + 1);
+      }
+    }
+    layers[i] = layer;
+    for (auto& wire : gates[i]->GetOutputWires()) {
+      wire_layers[wire.get()] = layer;
+    }
+  }
+  return layers;
+}
+
+std::vector<Gate*> GateExecutor::GetEvaluationOrder(
+    std::span<const std::size_t> critical_path_lengths) const {
+  const auto& gates = register_.GetGates();
+  std::vector<Gate*> order;
+  order.reserve(gates.size());
+  for (auto& gate : gates) {
+    order.emplace_back(gate.get());
+  }
+  const bool layer_wise = configuration_.GetLayerWiseEvaluation();
+  const bool critical_path_priority = !critical_path_lengths.empty();
+  if (layer_wise || critical_path_priority) {
+    assert(!critical_path_priority || critical_path_lengths.size() == gates.size());
+    const auto layers = layer_wise ? ComputeLayers() : std::vector<std::size_t>(gates.size(), 0);
+    std::vector<std::size_t> indices(gates.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(), [&](auto lhs, auto rhs) {
+      if (layers[lhs] != layers[rhs]) {
+        return layers[lhs] < layers[rhs];
+      }
+      return critical_path_priority && critical_path_lengths[lhs] > critical_path_lengths[rhs];
+    });
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      order[i] = gates[indices[i]].get();
+    }
+  }
+  return order;
+}
+
+std::vector<std::size_t> GateExecutor::ComputeCriticalPathLengths() const {
+  const auto& gates = register_.GetGates();
+  std::vector<std::size_t> lengths(gates.size(), 0);
+  // consumers are registered after the gates producing their inputs, hence visiting the gates in
+  // reverse order ensures that all consumers of a wire are known before its producer is visited
+  std::unordered_map<const Wire*, std::size_t> wire_lengths;
+  for (std::size_t i = gates.size(); i-- > 0;) {
+    std::size_t length = 0;
+    for (auto& wire : gates[i]->GetOutputWires()) {
+      if (auto it = wire_lengths.find(wire.get()); it != wire_lengths.end()) {
+        length = std::max(length, it->second);
+      }
+    }
+    lengths[i] = length + 1;
+    for (auto& wire : gates[i]->GetInputWires()) {
+      auto& wire_length = wire_lengths[wire.get()];
+      wire_length = std::max(wire_length, lengths[i]);
+    }
+  }
+  return lengths;
+}
+
+class GateExecutor::ReadyGateQueue {
+ public:
+  // priority of a gate: its critical path length, ties are broken by registration order
+  using Priority = std::pair<std::size_t, std::size_t>;
+
+  explicit ReadyGateQueue(std::unordered_map<const Gate*, Priority>&& priorities)
+      : priorities_(std::move(priorities)) {}
+
+  void Push(Gate& gate) {
+    std::scoped_lock lock(mutex_);
+    queue_.emplace(priorities_.at(&gate), &gate);
+  }
+
+  Gate& Pop() {
+    std::scoped_lock lock(mutex_);
+    assert(!queue_.empty());
+    auto gate = queue_.top().second;
+    queue_.pop();
+    return *gate;
+  }
+
+ private:
+  const std::unordered_map<const Gate*, Priority> priorities_;
+  std::priority_queue<std::pair<Priority, Gate*>> queue_;
+  // only held for the push/pop itself, hence it never blocks across a fiber switch
+  std::mutex mutex_;
+};
+
+std::unique_ptr<GateExecutor::ReadyGateQueue> GateExecutor::MakeReadyGateQueue(
+    std::span<const std::size_t> critical_path_lengths) const {
+  if (critical_path_lengths.empty()) {
+    return nullptr;
+  }
+  const auto& gates = register_.GetGates();
+  assert(critical_path_lengths.size() == gates.size());
+  const auto& lengths = critical_path_lengths;
+  std::unordered_map<const Gate*, ReadyGateQueue::Priority> priorities;
+  priorities.reserve(gates.size());
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    priorities.emplace(gates[i].get(), ReadyGateQueue::Priority{lengths[i], gates.size() - i});
+  }
+  return std::make_unique<ReadyGateQueue>(std::move(priorities));
+}
+
+class GateExecutor::LayerOpenings {
+ public:
+  LayerOpenings(communication::CommunicationLayer& communication_layer,
+                std::unordered_map<const Gate*, std::size_t>&& gate_layers,
+                std::span<const std::size_t> numbers_of_gates)
+      : gate_layers_(std::move(gate_layers)) {
+    for (auto number_of_gates : numbers_of_gates) {
+      layers_.emplace_back(communication_layer, number_of_gates);
+    }
+  }
+
+  bool Contains(const Gate& gate) const { return gate_layers_.contains(&gate); }
+
+  // Starts the online phase of the gate by start, which returns at its first suspension, and
+  // collects its openings into the batch of its layer, which is sent after the last of its gates
+  template <typename F>
+  void Open(const Gate& gate, F&& start) {
+    auto& layer{layers_[gate_layers_.at(&gate)]};
+    const auto input_wires{gate.GetInputWires()};
+    if (!std::all_of(input_wires.begin(), input_wires.end(),
+                     [](auto& wire) { return wire->GetIsReadyCondition().IsSet().load(); })) {
+      // waiting for an input, e.g., one without a registered producer, would hold back the layer
+      GateOpened(layer);
+      start();
+      return;
+    }
+    {
+      communication::MessageBatch::Scope scope(layer.batch);
+      start();
+    }
+    GateOpened(layer);
+  }
+
+ private:
+  struct Layer {
+    Layer(communication::CommunicationLayer& communication_layer, std::size_t number_of_gates)
+        : batch(communication_layer), number_of_pending_gates(number_of_gates) {}
+
+    communication::MessageBatch batch;
+    std::atomic<std::size_t> number_of_pending_gates;
+  };
+
+  static void GateOpened(Layer& layer) {
+    if (--layer.number_of_pending_gates == 0) {
+      layer.batch.Send();
+    }
+  }
+
+  const std::unordered_map<const Gate*, std::size_t> gate_layers_;
+  // a deque since the batches cannot be moved
+  std::deque<Layer> layers_;
+};
+
+void GateExecutor::StartLayerOpenings() {
+  if (!configuration_.GetLayerWiseEvaluation() || profiler_) {
+    layer_openings_ = nullptr;
+    return;
+  }
+  const auto& gates = register_.GetGates();
+  const auto layers = ComputeLayers();
+  std::unordered_map<const Gate*, std::size_t> gate_layers;
+  std::vector<std::size_t> numbers_of_gates;
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    auto& gate{*gates[i]};
+    // gates kept from the previous evaluation, see Register::ClearDownstreamGates, open nothing
+    if (!gate.OpensBeforeSuspending() || !gate.NeedsOnline() || gate.OnlineIsReady()) {
+      continue;
+    }
+    gate_layers.emplace(&gate, layers[i]);
+    if (numbers_of_gates.size() <= layers[i]) {
+      numbers_of_gates.resize(layers[i] + 1, 0);
+    }
+    ++numbers_of_gates[layers[i]];
+  }
+  layer_openings_ = std::make_unique<LayerOpenings>(communication_layer_, std::move(gate_layers),
+                                                    numbers_of_gates);
+}
+
+// Local gates that became ready while the current fiber evaluates an online task and that are
+// evaluated by that fiber after the task. Fiber-specific since fibers may migrate between threads.
+static boost::fibers::fiber_specific_ptr<std::vector<Gate*>> inline_gates(nullptr);
+
+void GateExecutor::SetProcessingQueueFunction(FiberThreadPool& fiber_pool,
+                                              ReadyGateQueue* ready_gate_queue) {
+  if (configuration_.GetInlineLocalGates()) {
+    register_.SetProcessingQueueFunction([this, &fiber_pool, ready_gate_queue](Gate& gate) {
+      if (gate.IsLocal() && inline_gates.get() != nullptr) {
+        inline_gates->push_back(&gate);
+      } else if (ready_gate_queue) {
+        ready_gate_queue->Push(gate);
+        fiber_pool.post([this, &fiber_pool, ready_gate_queue] {
+          EvaluateOnlineTask(ready_gate_queue->Pop(), fiber_pool);
+        });
+      } else {
+        fiber_pool.post([this, &fiber_pool, &gate] { EvaluateOnlineTask(gate, fiber_pool); });
+      }
+    });
+  } else if (ready_gate_queue) {
+    register_.SetProcessingQueueFunction([this, &fiber_pool, ready_gate_queue](Gate& gate) {
+      ready_gate_queue->Push(gate);
+      // there is one task per pushed gate, so the queue cannot be empty when the task runs
+      fiber_pool.post([this, &fiber_pool, ready_gate_queue] {
+        EvaluateOnlineTask(ready_gate_queue->Pop(), fiber_pool);
+      });
+    });
+  } else {
+    register_.SetProcessingQueueFunction([this, &fiber_pool](Gate& gate) {
+      fiber_pool.post([this, &fiber_pool, &gate] { EvaluateOnlineTask(gate, fiber_pool); });
+    });
+  }
+}
+
+void GateExecutor::FinishOnline(Gate& gate) {
+  gate.SetOnlineIsReady();
+  ReleaseInputWires(gate);
+  if (gate.NeedsOnline()) {
+    register_.IncrementEvaluatedGatesOnlineCounter();
+  }
+}
+
+void GateExecutor::StartOnlineCoroutine(Gate& gate, FiberThreadPool& fiber_pool) {
+  if (metrics_) {
+    metrics_->online_started.Add();
+  }
+  gate.EvaluateOnlineCoroutine().Start(
+      [&fiber_pool](std::coroutine_handle<> handle) {
+        fiber_pool.post([handle] { handle.resume(); });
+      },
+      [this, &gate](std::exception_ptr exception) {
+        // terminates like an exception that escapes the online phase in a fiber
+        if (exception) std::rethrow_exception(exception);
+        if (metrics_) {
+          metrics_->online_evaluated.Add();
+        }
+        FinishOnline(gate);
+      });
+}
+
+void GateExecutor::EvaluateOnlineTask(Gate& gate, FiberThreadPool& fiber_pool) {
+  auto evaluate_online = [this, &fiber_pool](Gate& g) {
+    // the profiler measures an online phase within a single fiber
+    if (layer_openings_ && layer_openings_->Contains(g)) {
+      layer_openings_->Open(g, [this, &g, &fiber_pool] { StartOnlineCoroutine(g, fiber_pool); });
+    } else if (configuration_.GetCoroutineOnlinePhases() && !profiler_ && !g.IsLocal() &&
+               g.NeedsOnline()) {
+      StartOnlineCoroutine(g, fiber_pool);
+    } else {
+      EvaluateGateOnline(g);
+      FinishOnline(g);
+    }
+  };
+  if (!configuration_.GetInlineLocalGates()) {
+    evaluate_online(gate);
+    return;
+  }
+  // collect the local gates resolved by this task and evaluate them iteratively instead of
+  // recursively to bound the fiber's stack usage
+  std::vector<Gate*> local_gates;
+  inline_gates.reset(&local_gates);
+  evaluate_online(gate);
+  while (!local_gates.empty()) {
+    auto local_gate = local_gates.back();
+    local_gates.pop_back();
+    evaluate_online(*local_gate);
+  }
+  inline_gates.reset(nullptr);
+}
+
 }  // namespace encrypto::motion
@@ -22,20 +22,39 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <span>
+#include <vector>
+
+#include "statistics/metrics.h"
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
 
 namespace encrypto::motion {
 
 struct RunTimeStatistics;
 
+class Configuration;
+class FiberThreadPool;
+class Gate;
+class GateProfiler;
 class Logger;
 class Register;
 
 // Evaluates all registered gates.
 class GateExecutor {
  public:
-  GateExecutor(Register&, std::function<void()> presetup_function, std::shared_ptr<Logger>);
+  GateExecutor(Register&, const Configuration&, communication::CommunicationLayer&,
+               std::function<void()> presetup_function, std::shared_ptr<Logger>);
+
+  ~GateExecutor();
 
   // Run the setup phases first for all gates before starting with the online
   // phases.
@@ -43,13 +62,122 @@ class GateExecutor {
   // Run setup and online phase of each gate as soon as possible.
   void Evaluate(RunTimeStatistics& statistics);
 
+  // Count the started and evaluated setup and online phases of the gates and the evaluations with
+  // their scheduler statistics in the registry, see MetricsRegistry. Must not be called during an
+  // evaluation.
+  void RegisterMetrics(MetricsRegistry& registry, const MetricLabels& labels);
+
+  // Number of setup and online phases that are being evaluated, i.e., of fibers evaluating a gate
+  // or blocked in it, if metrics are registered.
+  std::size_t GetNumberOfRunningGatePhases() const;
+
+  // Use the given pool for all following evaluations instead of creating and joining a new pool
+  // for each of them. The pool must outlive the evaluations, nullptr restores the default.
+  void SetPersistentFiberThreadPool(FiberThreadPool* fiber_pool) {
+    persistent_fiber_pool_ = fiber_pool;
+  }
+
  private:
+  // Registers each gate needing the online phase as a waiting gate of its input wires that are not
+  // online-ready yet. The number of unready dependencies of a gate comprises these wires, one
+  // guard dependency that is resolved after all gates were registered, and, if
+  // setup_is_dependency is true and the gate needs it, its own setup phase.
+  void RegisterDependencies(bool setup_is_dependency);
+
+  // Sets the number of consumers of each wire if releasing wire values is enabled.
+  void RegisterConsumers();
+
+  // Marks the gate as finished consumer of its input wires and releases the values of the wires
+  // without remaining consumers if releasing wire values is enabled.
+  void ReleaseInputWires(Gate& gate);
+
+  // Computes the layer of each gate, i.e., the length of the longest path from a gate without
+  // producing input gates. The result is indexed in the same way as Register::GetGates().
+  std::vector<std::size_t> ComputeLayers() const;
+
+  // Computes the length of the longest path from each gate to a gate without consumers, counted in
+  // gates including the gate itself. The result is indexed in the same way as Register::GetGates().
+  std::vector<std::size_t> ComputeCriticalPathLengths() const;
+
+  // Returns the registered gates in the order in which they are posted to the fiber pool, i.e.,
+  // ordered by layer if layer-wise evaluation is enabled, by decreasing critical path length if
+  // critical_path_lengths of ComputeCriticalPathLengths are given (within each layer if both
+  // are), and in registration order otherwise.
+  std::vector<Gate*> GetEvaluationOrder(std::span<const std::size_t> critical_path_lengths) const;
+
+  // Priority queue of gates whose online phase is ready to be evaluated.
+  class ReadyGateQueue;
+
+  // Returns a queue ordering the gates by the critical_path_lengths of ComputeCriticalPathLengths,
+  // or nullptr if they are empty, i.e., if critical path priority is disabled.
+  std::unique_ptr<ReadyGateQueue> MakeReadyGateQueue(
+      std::span<const std::size_t> critical_path_lengths) const;
+
+  // Batches of the openings of the gates of each layer, see Gate::OpensBeforeSuspending.
+  class LayerOpenings;
+
+  // Creates the batches of the openings of an evaluation if layer-wise evaluation is enabled and
+  // the gates are not profiled, since the profiler measures an online phase within a single fiber.
+  void StartLayerOpenings();
+
+  // Lets the register post the online phase of each gate whose dependencies are resolved to the
+  // fiber pool. If ready_gate_queue is given, each posted task evaluates the ready gate with the
+  // longest critical path instead of the gate that triggered it.
+  void SetProcessingQueueFunction(FiberThreadPool& fiber_pool, ReadyGateQueue* ready_gate_queue);
+
+  // Evaluates the online phase of the gate and, if inlining of local gates is enabled, of all the
+  // local gates that become ready as a consequence. If coroutine online phases are enabled, the
+  // online phase of an interactive gate is started as a coroutine, whose suspensions are resumed
+  // by new tasks of the fiber pool, instead. So is the online phase of a gate of the
+  // LayerOpenings, whose openings are sent with those of its layer.
+  void EvaluateOnlineTask(Gate& gate, FiberThreadPool& fiber_pool);
+
+  // Starts the online phase of the gate as a coroutine, which is finished by the task that
+  // completes it.
+  void StartOnlineCoroutine(Gate& gate, FiberThreadPool& fiber_pool);
+
+  // Marks the online phase of the gate as evaluated.
+  void FinishOnline(Gate& gate);
+
+  // Evaluate the setup or online phase of the gate and record it in the gate profile if profiling
+  // is enabled.
+  void EvaluateGateSetup(Gate& gate);
+  void EvaluateGateOnline(Gate& gate);
+
+  // Creates the profiler of an evaluation if gate profiling is enabled.
+  void StartProfiling();
+
+  // Stores the recorded gate profile, if any, in the statistics.
+  void FinishProfiling(RunTimeStatistics& statistics);
+
+  // Opens a ContentionTracer session for the evaluation including the preprocessing if contention
+  // tracing is enabled, and stores and logs its report when the evaluation finished.
+  void StartContentionTracing();
+  void FinishContentionTracing(RunTimeStatistics& statistics);
+
+  // Counts the finished evaluation in the registered metrics, if any.
+  void RecordEvaluationMetrics(const RunTimeStatistics& statistics);
+
+  FiberThreadPool& AcquireFiberThreadPool(std::unique_ptr<FiberThreadPool>& own_fiber_pool);
+
   Register& register_;
+  const Configuration& configuration_;
+  communication::CommunicationLayer& communication_layer_;
   // Presetup function is run prior to the setup function and is used to provide information about
   // objects that will be used in the setup phase, eg a multiplication triple registers an
   // oblivious transfer object and an OT provider registers base OT objects.
   std::function<void()> presetup_function_;
   std::shared_ptr<Logger> logger_;
+  FiberThreadPool* persistent_fiber_pool_ = nullptr;
+  std::atomic<std::size_t> number_of_released_wire_bytes_ = 0;
+  std::unique_ptr<GateProfiler> profiler_;
+  std::unique_ptr<LayerOpenings> layer_openings_;
+
+  struct Metrics {
+    MetricsCounter &setup_started, &setup_evaluated, &online_started, &online_evaluated;
+    MetricsCounter &evaluations, &steals, &parks;
+  };
+  std::unique_ptr<Metrics> metrics_;
 };
 
 }  // namespace encrypto::motion
@@ -0,0 +1,55 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "dabit_provider.h"
+
+#include "sb_provider.h"
+
+namespace encrypto::motion {
+
+template <typename T, typename>
+std::size_t DaBitProvider::RequestDaBits(std::size_t number_of_dabits) {
+  return sb_provider_.template RequestSbs<T>(number_of_dabits);
+}
+
+template <typename T, typename>
+DaBits<T> DaBitProvider::GetDaBits(std::size_t offset, std::size_t number_of_dabits) {
+  const auto sbs{sb_provider_.template GetSbsView<T>(offset, number_of_dabits)};
+  DaBits<T> dabits{std::vector<T>(sbs.begin(), sbs.end()), BitVector<>(number_of_dabits)};
+  for (std::size_t i = 0; i < number_of_dabits; ++i) {
+    if (sbs[i] & 1) dabits.boolean.Set(true, i);
+  }
+  return dabits;
+}
+
+// SBs only exist for up to 64 bit
+template std::size_t DaBitProvider::RequestDaBits<std::uint8_t>(std::size_t);
+template std::size_t DaBitProvider::RequestDaBits<std::uint16_t>(std::size_t);
+template std::size_t DaBitProvider::RequestDaBits<std::uint32_t>(std::size_t);
+template std::size_t DaBitProvider::RequestDaBits<std::uint64_t>(std::size_t);
+
+template DaBits<std::uint8_t> DaBitProvider::GetDaBits<std::uint8_t>(std::size_t, std::size_t);
+template DaBits<std::uint16_t> DaBitProvider::GetDaBits<std::uint16_t>(std::size_t, std::size_t);
+template DaBits<std::uint32_t> DaBitProvider::GetDaBits<std::uint32_t>(std::size_t, std::size_t);
+template DaBits<std::uint64_t> DaBitProvider::GetDaBits<std::uint64_t>(std::size_t, std::size_t);
+
+}  // namespace encrypto::motion
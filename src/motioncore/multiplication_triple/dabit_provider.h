@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion {
+
+class SbProvider;
+
+// Random bits b shared both in Z/2^kZ and in GF(2), which convert a Boolean GMW share of a bit x to
+// an arithmetic GMW share by opening x ^ b, see GmwToArithmeticGate
+template <typename T>
+struct DaBits {
+  // the arithmetic shares of the bits
+  std::vector<T> arithmetic;
+  // the XOR shares of the same bits
+  BitVector<> boolean;
+};
+
+// Provider for daBits, which are the SBs of the SbProvider: the least significant bits of the
+// arithmetic shares of a bit already are XOR shares of it, such that a daBit costs one SB and no
+// communication in addition to the SB
+class DaBitProvider {
+ public:
+  DaBitProvider(SbProvider& sb_provider) : sb_provider_(sb_provider) {}
+
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  std::size_t RequestDaBits(std::size_t number_of_dabits);
+
+  // waits for the SBs and returns the daBits [offset, offset + number_of_dabits)
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  DaBits<T> GetDaBits(std::size_t offset, std::size_t number_of_dabits);
+
+ private:
+  SbProvider& sb_provider_;
+};
+
+}  // namespace encrypto::motion
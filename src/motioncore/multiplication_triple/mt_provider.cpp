@@ -24,7 +24,16 @@
 
 #include "mt_provider.h"
 
+#include <future>
+
+#include <fmt/format.h>
+
+#include "base/third_party_dealer.h"
+#include "data_storage/preprocessing_store.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_flavors.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
 #include "oblivious_transfer/ot_flavors.h"
+#include "primitives/random/aes128_ctr_rng.h"
 #include "statistics/run_time_statistics.h"
 #include "utility/constants.h"
 #include "utility/logger.h"
@@ -32,25 +41,88 @@
 namespace encrypto::motion {
 
 bool MtProvider::NeedMts() const noexcept {
-  return 0 < (GetNumberOfMts<bool>() + GetNumberOfMts<std::uint8_t>() +
-              GetNumberOfMts<std::uint16_t>() + GetNumberOfMts<std::uint32_t>() +
-              GetNumberOfMts<std::uint64_t>());
+  bool need_mts = number_of_bit_mts_ > 0;
+  ForEachIntegerPool([&need_mts](auto, const auto& pool) {
+    need_mts = need_mts || pool.number_of_mts > 0 || !pool.matrix_mts.empty();
+  });
+  return need_mts;
+}
+
+bool MtProvider::NeedMatrixMts() const noexcept {
+  bool need_matrix_mts = false;
+  ForEachIntegerPool([&need_matrix_mts](auto, const auto& pool) {
+    need_matrix_mts = need_matrix_mts || !pool.matrix_mts.empty();
+  });
+  return need_matrix_mts;
+}
+
+std::size_t MtProvider::RequestBinaryMts(const std::size_t number_of_mts) {
+  return RequestPlannedElements(number_of_requested_bit_mts_, number_of_bit_mts_, number_of_mts,
+                                primed_, "binary MTs");
 }
 
-std::size_t MtProvider::RequestBinaryMts(const std::size_t number_of_mts) noexcept {
-  const auto offset = number_of_bit_mts_;
-  number_of_bit_mts_ += number_of_mts;
-  return offset;
+void MtProvider::Prime(const PreprocessingPlan& plan) {
+  number_of_bit_mts_ += plan.number_of_binary_mts;
+  ForEachIntegerPool([&plan](auto type, auto& pool) {
+    constexpr auto kIndex{PreprocessingPlan::GetTypeIndex<decltype(type)>()};
+    pool.number_of_mts += plan.number_of_integer_mts[kIndex];
+  });
+  primed_ = true;
 }
 
 // get bits [i, i+n] as vector
 BinaryMtVector MtProvider::GetBinary(const std::size_t offset, const std::size_t n) const {
-  assert(bit_mts_.a.GetSize() == bit_mts_.b.GetSize());
-  assert(bit_mts_.b.GetSize() == bit_mts_.c.GetSize());
-  WaitFinished();
-  return BinaryMtVector{bit_mts_.a.Subset(offset, offset + n),
-                        bit_mts_.b.Subset(offset, offset + n),
-                        bit_mts_.c.Subset(offset, offset + n)};
+  WaitForBinaryMts(offset, n);
+  if (!compact_) {
+    assert(bit_mts_.a.GetSize() == bit_mts_.b.GetSize());
+    assert(bit_mts_.b.GetSize() == bit_mts_.c.GetSize());
+    return BinaryMtVector{bit_mts_.a.Subset(offset, offset + n),
+                          bit_mts_.b.Subset(offset, offset + n),
+                          bit_mts_.c.Subset(offset, offset + n)};
+  }
+  // expand the bytes containing the bits [offset, offset + n)
+  const std::size_t begin_byte{offset / 8};
+  const std::size_t number_of_bytes{(offset + n + 7) / 8 - begin_byte};
+  std::vector<std::byte> buffer(number_of_bytes);
+  const auto expand = [&](bool is_b) {
+    ExpandShares(GetTypeIndex<bool>(), is_b, begin_byte, number_of_bytes, buffer.data());
+    return BitVector<>(buffer.data(), number_of_bytes * 8).Subset(offset % 8, offset % 8 + n);
+  };
+  return BinaryMtVector{expand(false), expand(true), bit_mts_.c.Subset(offset, offset + n)};
+}
+
+BinaryMtView MtProvider::GetBinaryView(const std::size_t offset, const std::size_t n) const {
+  WaitForBinaryMts(offset, n);
+  if (!compact_) {
+    return BinaryMtView(bit_mts_, offset, n);
+  }
+  auto mts{GetBinary(offset, n)};
+  return BinaryMtView(std::move(mts.a), std::move(mts.b), bit_mts_.c, offset);
+}
+
+void MtProvider::SampleShareKeys() {
+  for (auto& key : share_keys_) {
+    Aes128CtrRng::GetThreadInstance().RandomBytes(key.data(), key.size());
+  }
+}
+
+void MtProvider::ExpandShares(std::size_t type_index, bool is_b, std::size_t byte_offset,
+                              std::size_t number_of_bytes, std::byte* output) const {
+  if (number_of_bytes == 0) {
+    return;
+  }
+  constexpr std::size_t kBlockSize{Aes128CtrRng::kBlockSize};
+  Aes128CtrRng rng(share_keys_[2 * type_index + (is_b ? 1 : 0)].data());
+  rng.SetCounter(byte_offset / kBlockSize);
+  const std::size_t skip{byte_offset % kBlockSize};
+  const std::size_t number_of_blocks{(skip + number_of_bytes + kBlockSize - 1) / kBlockSize};
+  if (skip == 0 && number_of_bytes % kBlockSize == 0) {
+    rng.RandomBlocks(output, number_of_blocks);
+    return;
+  }
+  std::vector<std::byte> blocks(number_of_blocks * kBlockSize);
+  rng.RandomBlocks(blocks.data(), number_of_blocks);
+  std::copy_n(blocks.begin() + skip, number_of_bytes, output);
 }
 
 const BinaryMtVector& MtProvider::GetBinaryAll() const noexcept {
@@ -63,26 +135,60 @@ MtProvider::MtProvider(const std::size_t my_id, const std::size_t number_of_part
   finished_condition_ = std::make_shared<FiberCondition>([this]() { return finished_.load(); });
 }
 
+const BinaryMtVector& MtProvider::WaitForBinaryMts(std::size_t offset, std::size_t n) const {
+  WaitForMts(GetTypeIndex<bool>(), offset + n);
+  return bit_mts_;
+}
+
+void MtProvider::WaitForMts(std::size_t type_index, std::size_t end) const {
+  std::unique_lock lock(available_mutex_);
+  available_condition_.wait(lock, [this, type_index, end] {
+    return finished_ || number_of_available_mts_[type_index] >= end;
+  });
+}
+
+void MtProvider::SetFinished() {
+  {
+    std::scoped_lock lock(finished_condition_->GetMutex());
+    finished_ = true;
+  }
+  finished_condition_->NotifyAll();
+  {
+    // waiters of WaitForMts check finished_ while holding the mutex
+    std::scoped_lock lock(available_mutex_);
+  }
+  available_condition_.notify_all();
+}
+
 MtProviderFromOts::MtProviderFromOts(std::vector<std::unique_ptr<OtProvider>>& ot_providers,
                                      const std::size_t my_id, std::shared_ptr<Logger> logger,
                                      RunTimeStatistics& run_time_statistics)
     : MtProvider(my_id, ot_providers.size()),
       ot_providers_(ot_providers),
-      ots_receiver_8_(number_of_parties_),
-      ots_sender_8_(number_of_parties_),
-      ots_receiver_16_(number_of_parties_),
-      ots_sender_16_(number_of_parties_),
-      ots_receiver_32_(number_of_parties_),
-      ots_sender_32_(number_of_parties_),
-      ots_receiver_64_(number_of_parties_),
-      ots_sender_64_(number_of_parties_),
       bit_ots_receiver_(number_of_parties_),
       bit_ots_sender_(number_of_parties_),
+      kk13_bit_ots_receiver_(number_of_parties_),
+      kk13_bit_ots_sender_(number_of_parties_),
+      matrix_ots_receiver_(number_of_parties_),
+      matrix_ots_sender_(number_of_parties_),
       logger_(logger),
-      run_time_statistics_(run_time_statistics) {}
+      run_time_statistics_(run_time_statistics) {
+  boost::hana::for_each(boost::hana::keys(integer_ots_), [this](auto type) {
+    integer_ots_[type].receiver.resize(number_of_parties_);
+    integer_ots_[type].sender.resize(number_of_parties_);
+  });
+}
 
 MtProviderFromOts::~MtProviderFromOts() = default;
 
+void MtProviderFromOts::SetBatchSize(std::size_t batch_size) {
+  if (batch_size == 0 || batch_size % 128 != 0) {
+    throw std::invalid_argument(
+        fmt::format("MT batch size needs to be a positive multiple of 128, got {}", batch_size));
+  }
+  batch_size_ = batch_size;
+}
+
 void MtProviderFromOts::PreSetup() {
   if (!NeedMts()) {
     return;
@@ -101,6 +207,23 @@ void MtProviderFromOts::PreSetup() {
   }
 }
 
+// the OTs of packed MTs (see ForEachSegment) may use a smaller type than the MTs
+static void SendAcOtMessages(BasicOtSender& ot) {
+  if (auto ot_8 = dynamic_cast<AcOtSender<std::uint8_t>*>(&ot)) {
+    ot_8->SendMessages();
+  } else if (auto ot_16 = dynamic_cast<AcOtSender<std::uint16_t>*>(&ot)) {
+    ot_16->SendMessages();
+  } else if (auto ot_32 = dynamic_cast<AcOtSender<std::uint32_t>*>(&ot)) {
+    ot_32->SendMessages();
+  } else if (auto ot_64 = dynamic_cast<AcOtSender<std::uint64_t>*>(&ot)) {
+    ot_64->SendMessages();
+  } else {
+    auto ot_128 = dynamic_cast<AcOtSender<__uint128_t>*>(&ot);
+    assert(ot_128 != nullptr);
+    ot_128->SendMessages();
+  }
+}
+
 // needs completed OTExtension
 void MtProviderFromOts::Setup() {
   if (!NeedMts()) {
@@ -112,42 +235,20 @@ void MtProviderFromOts::Setup() {
   }
   run_time_statistics_.RecordStart<RunTimeStatistics::StatisticsId::kMtSetup>();
 
+  // The OTs with different parties are independent and are sent by one task per party. Since each
+  // task sends the messages of its party in order, the MT setup never competes with itself for the
+  // send queue of a party, and a slow party does not delay the messages to the others.
+  std::vector<std::future<void>> futures;
+  futures.reserve(number_of_parties_);
   for (auto i = 0ull; i < number_of_parties_; ++i) {
-    if (i == my_id_) {
-      continue;
-    }
-    for (auto& ot : ots_sender_8_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint8_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_8_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_16_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint16_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_16_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_32_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint32_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_32_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_64_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint64_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_64_.at(i)) ot->SendCorrections();
-
-    if (number_of_bit_mts_ > 0) {
-      assert(bit_ots_receiver_.at(i) != nullptr);
-      assert(bit_ots_sender_.at(i) != nullptr);
-      bit_ots_receiver_.at(i)->SendCorrections();
-      bit_ots_sender_.at(i)->SendMessages();
+    if (i != my_id_) {
+      futures.emplace_back(std::async(std::launch::async, [this, i] { SendOts(i); }));
     }
   }
+  for (auto& f : futures) f.get();
 
   ParseOutputs();
-  {
-    std::scoped_lock lock(finished_condition_->GetMutex());
-    finished_ = true;
-  }
-
-  finished_condition_->NotifyAll();
+  SetFinished();
 
   run_time_statistics_.RecordEnd<RunTimeStatistics::StatisticsId::kMtSetup>();
   if constexpr (kDebug) {
@@ -155,33 +256,141 @@ void MtProviderFromOts::Setup() {
   }
 }
 
-static void GenerateRandomTriplesBool(BinaryMtVector& bit_mts, std::size_t number_of_bit_mts) {
+void MtProviderFromOts::SendOts(std::size_t party_id) {
+  for (auto& ot : bit_ots_receiver_.at(party_id)) ot->SendCorrections();
+  for (auto& ot : bit_ots_sender_.at(party_id)) ot->SendMessages();
+  for (auto& ot : kk13_bit_ots_receiver_.at(party_id)) ot->SendCorrections();
+  for (auto& ot : kk13_bit_ots_sender_.at(party_id)) ot->SendMessages();
+  boost::hana::for_each(boost::hana::keys(integer_ots_), [this, party_id](auto type) {
+    for (auto& ot : integer_ots_[type].sender.at(party_id)) SendAcOtMessages(*ot);
+    for (auto& ot : integer_ots_[type].receiver.at(party_id)) ot->SendCorrections();
+  });
+  for (auto& ot : matrix_ots_sender_.at(party_id)) SendAcOtMessages(*ot);
+  for (auto& ot : matrix_ots_receiver_.at(party_id)) ot->SendCorrections();
+}
+
+static void GenerateRandomTriplesBool(BinaryMtVector& bit_mts, std::size_t number_of_bit_mts,
+                                      std::size_t number_of_threads) {
   if (number_of_bit_mts > 0u) {
-    bit_mts.a = BitVector<>::SecureRandom(number_of_bit_mts);
-    bit_mts.b = BitVector<>::SecureRandom(number_of_bit_mts);
+    bit_mts.a = BitVector<>::SecureRandom(number_of_bit_mts, number_of_threads);
+    bit_mts.b = BitVector<>::SecureRandom(number_of_bit_mts, number_of_threads);
     bit_mts.c = bit_mts.a & bit_mts.b;
   }
 }
 
 template <typename T>
-static void GenerateRandomTriples(IntegerMtVector<T>& mts, std::size_t number_of_mts) {
+static void GenerateRandomTriples(IntegerMtVector<T>& mts, std::size_t number_of_mts,
+                                  std::size_t number_of_threads) {
   if (number_of_mts > 0u) {
-    mts.a = RandomVector<T>(number_of_mts);
-    mts.b = RandomVector<T>(number_of_mts);
+    mts.a = RandomVector<T>(number_of_mts, number_of_threads);
+    mts.b = RandomVector<T>(number_of_mts, number_of_threads);
     mts.c.resize(number_of_mts);
     std::transform(mts.a.cbegin(), mts.a.cend(), mts.b.cbegin(), mts.c.begin(),
                    [](const auto& a_i, const auto& b_i) { return a_i * b_i; });
   }
 }
 
-static void RegisterHelperBool(OtProvider& ot_provider, std::unique_ptr<XcOtBitSender>& ots_sender,
-                               std::unique_ptr<XcOtBitReceiver>& ots_receiver,
-                               const BinaryMtVector& bit_mts, std::size_t number_of_bit_mts) {
-  ots_sender = ot_provider.RegisterSendXcOtBit(number_of_bit_mts);
-  ots_receiver = ot_provider.RegisterReceiveXcOtBit(number_of_bit_mts);
+static void RegisterHelperBool(OtProvider& ot_provider,
+                               std::list<std::unique_ptr<XcOtBitSender>>& ots_sender,
+                               std::list<std::unique_ptr<XcOtBitReceiver>>& ots_receiver,
+                               std::size_t max_batch_size, const BinaryMtVector& bit_mts,
+                               std::size_t number_of_bit_mts) {
+  for (std::size_t mt_id = 0; mt_id < number_of_bit_mts;) {
+    const auto batch_size = std::min(max_batch_size, number_of_bit_mts - mt_id);
+    auto ptr_send{ot_provider.RegisterSendXcOtBit(batch_size)};
+    auto ptr_receive{ot_provider.RegisterReceiveXcOtBit(batch_size)};
+    ptr_send->SetCorrelations(bit_mts.a.Subset(mt_id, mt_id + batch_size));
+    ptr_receive->SetChoices(bit_mts.b.Subset(mt_id, mt_id + batch_size));
+    ots_sender.emplace_back(std::move(ptr_send));
+    ots_receiver.emplace_back(std::move(ptr_receive));
+    mt_id += batch_size;
+  }
+}
+
+// number of binary MTs per Kk13 OT, such that the 16 messages of 4 bits fit into a std::uint64_t
+constexpr std::size_t kBitMtsPerKk13Ot{4};
+constexpr std::size_t kNumberOfKk13Messages{std::size_t(1) << kBitMtsPerKk13Ot};
+
+// bits [position, position + 4) of the bit vector data, where position is a multiple of 4
+static std::uint64_t GetNibble(const std::byte* data, std::size_t position) {
+  return (std::to_integer<std::uint64_t>(data[position / 8]) >> (position % 8)) & 0xF;
+}
+
+// xors the lowest min(4, number_of_bits) bits of value into bits [position, position + 4)
+static void XorNibble(std::byte* data, std::size_t position, std::uint64_t value,
+                      std::size_t number_of_bits) {
+  const std::uint64_t mask{number_of_bits >= 4 ? 0xF : (std::uint64_t(1) << number_of_bits) - 1};
+  data[position / 8] ^= std::byte((value & mask) << (position % 8));
+}
+
+// Each Kk13 OT computes the cross terms of 4 MTs: the receiver chooses the 4 bits of its a, and
+// the sender inputs r ^ (choice & b) for each of the 16 choices and keeps the random r as its
+// share, such that the receiver obtains r ^ (a & b). The sender's share is added to c right away.
+static void RegisterHelperBoolKk13(Kk13OtProvider& ot_provider,
+                                   std::list<std::unique_ptr<GKk13OtSender>>& ots_sender,
+                                   std::list<std::unique_ptr<GKk13OtReceiver>>& ots_receiver,
+                                   std::size_t max_batch_size, BinaryMtVector& bit_mts,
+                                   std::size_t number_of_bit_mts) {
+  const auto a{bit_mts.a.GetData().data()};
+  const auto b{bit_mts.b.GetData().data()};
+  const auto c{bit_mts.c.GetMutableData().data()};
+  for (std::size_t mt_id = 0; mt_id < number_of_bit_mts;) {
+    const auto batch_size = std::min(max_batch_size, number_of_bit_mts - mt_id);
+    const auto number_of_ots = (batch_size + kBitMtsPerKk13Ot - 1) / kBitMtsPerKk13Ot;
+    const auto r{BitVector<>::SecureRandom(number_of_ots * kBitMtsPerKk13Ot)};
+    std::vector<BitVector<>> inputs;
+    inputs.reserve(number_of_ots);
+    std::vector<std::uint8_t> choices(number_of_ots);
+    for (std::size_t k = 0; k < number_of_ots; ++k) {
+      // mt_id is a multiple of the batch size and hence byte-aligned
+      const auto position = mt_id + k * kBitMtsPerKk13Ot;
+      const auto b_k{GetNibble(b, position)};
+      const auto r_k{GetNibble(r.GetData().data(), k * kBitMtsPerKk13Ot)};
+      std::uint64_t messages{0};
+      for (std::uint64_t choice = 0; choice < kNumberOfKk13Messages; ++choice) {
+        messages |= (r_k ^ (choice & b_k)) << (choice * kBitMtsPerKk13Ot);
+      }
+      inputs.emplace_back(reinterpret_cast<const std::byte*>(&messages), 64);
+      choices[k] = static_cast<std::uint8_t>(GetNibble(a, position));
+      XorNibble(c, position, r_k, number_of_bit_mts - position);
+    }
+    auto ptr_send{
+        ot_provider.RegisterSendGOt(number_of_ots, kBitMtsPerKk13Ot, kNumberOfKk13Messages)};
+    auto ptr_receive{
+        ot_provider.RegisterReceiveGOt(number_of_ots, kBitMtsPerKk13Ot, kNumberOfKk13Messages)};
+    ptr_send->SetInputs(std::move(inputs));
+    ptr_receive->SetChoices(std::move(choices));
+    ots_sender.emplace_back(std::move(ptr_send));
+    ots_receiver.emplace_back(std::move(ptr_receive));
+    mt_id += batch_size;
+  }
+}
 
-  ots_sender->SetCorrelations(bit_mts.a);
-  ots_receiver->SetChoices(bit_mts.b);
+// Gilboa's multiplication uses one additively correlated OT per bit i of b with the correlation
+// a * 2^i. Since the result is only needed modulo 2^k for k = 8 * sizeof(T), the OT for bit i can
+// be computed in the smallest ring Z_{2^w} with w >= k - i and its outputs be shifted by k - w.
+// If packed is set, the bits are split into segments [begin, end) of equal w, otherwise there is a
+// single segment with w = k. f is called as f(W{}, begin, end) for each segment with W = uint<w>.
+template <typename T, typename F>
+static void ForEachSegment(bool packed, F&& f) {
+  constexpr std::size_t bit_size = sizeof(T) * 8;
+  std::size_t begin = 0;
+  for (std::size_t w = bit_size; begin < bit_size; w /= 2) {
+    const std::size_t end = (!packed || w == 8) ? bit_size : bit_size - w / 2;
+    // rings wider than T are never used, but would not compile
+    if (w == 8) {
+      f(std::uint8_t{}, begin, end);
+    } else if (w == 16) {
+      if constexpr (sizeof(T) >= 2) f(std::uint16_t{}, begin, end);
+    } else if (w == 32) {
+      if constexpr (sizeof(T) >= 4) f(std::uint32_t{}, begin, end);
+    } else if (w == 64) {
+      if constexpr (sizeof(T) >= 8) f(std::uint64_t{}, begin, end);
+    } else {
+      if constexpr (sizeof(T) >= 16) f(__uint128_t{}, begin, end);
+    }
+    begin = end;
+  }
 }
 
 template <typename T>
@@ -189,126 +398,398 @@ static void RegisterHelper(OtProvider& ot_provider,
                            std::list<std::unique_ptr<BasicOtSender>>& ots_sender,
                            std::list<std::unique_ptr<BasicOtReceiver>>& ots_receiver,
                            std::size_t max_batch_size, const IntegerMtVector<T>& mts,
-                           std::size_t number_of_mts) {
+                           std::size_t number_of_mts, bool packed) {
   constexpr std::size_t bit_size = sizeof(T) * 8;
 
   for (std::size_t mt_id = 0; mt_id < number_of_mts;) {
     const auto batch_size = std::min(max_batch_size, number_of_mts - mt_id);
-    auto ptr_send{ot_provider.RegisterSendAcOt(batch_size * bit_size, sizeof(T) * 8)};
-    auto ot_to_send = dynamic_cast<AcOtSender<T>*>(ptr_send.get());
-    std::vector<T> vector_to_send;
-    vector_to_send.reserve(batch_size * bit_size);
-    for (auto k = 0ull; k < batch_size; ++k) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        const T input = mts.a.at(mt_id + k) << bit_i;
-        vector_to_send.emplace_back(input);
+    ForEachSegment<T>(packed, [&](auto w_tag, std::size_t begin, std::size_t end) {
+      using W = decltype(w_tag);
+      constexpr std::size_t w = sizeof(W) * 8;
+      const auto segment_size = end - begin;
+
+      auto ptr_send{ot_provider.RegisterSendAcOt(batch_size * segment_size, w)};
+      auto ot_to_send = dynamic_cast<AcOtSender<W>*>(ptr_send.get());
+      std::vector<W> vector_to_send;
+      vector_to_send.reserve(batch_size * segment_size);
+      for (auto k = 0ull; k < batch_size; ++k) {
+        for (auto bit_i = begin; bit_i < end; ++bit_i) {
+          const T input = mts.a.at(mt_id + k) << (bit_i - (bit_size - w));
+          vector_to_send.emplace_back(static_cast<W>(input));
+        }
+      }
+      ot_to_send->SetCorrelations(std::move(vector_to_send));
+
+      auto ptr_receive{ot_provider.RegisterReceiveAcOt(batch_size * segment_size, w)};
+      auto ot_to_receive = dynamic_cast<AcOtReceiver<W>*>(ptr_receive.get());
+      BitVector<> choices;
+      choices.Reserve(batch_size * segment_size);
+      for (auto k = 0ull; k < batch_size; ++k) {
+        for (auto bit_i = begin; bit_i < end; ++bit_i) {
+          const bool choice = ((mts.b.at(mt_id + k) >> bit_i) & 1u) == 1;
+          choices.Append(choice);
+        }
+      }
+      ot_to_receive->SetChoices(std::move(choices));
+
+      ots_sender.emplace_back(std::move(ptr_send));
+      ots_receiver.emplace_back(std::move(ptr_receive));
+    });
+
+    mt_id += batch_size;
+  }
+}
+
+// The cross terms a_i * b_j of the matrix triples are computed with Gilboa's multiplication as
+// in RegisterHelper, but each OT multiplies a bit of an element b_j[l][m] with the whole column
+// a_i[.][l], i.e., it is an AC-OT with vectors of rows elements. OT (l * columns + m) * k + t
+// corresponds to bit t of b_j[l][m].
+template <typename T>
+void MtProviderFromOts::RegisterMatrixOts(std::vector<MatrixMt<T>>& matrix_mts) {
+  constexpr std::size_t bit_size = sizeof(T) * 8;
+
+  for (auto& mt : matrix_mts) {
+    mt.a = RandomVector<T>(mt.rows * mt.inner);
+    mt.b = RandomVector<T>(mt.inner * mt.columns);
+    mt.c.assign(mt.rows * mt.columns, 0);
+    for (std::size_t r = 0; r < mt.rows; ++r) {
+      for (std::size_t l = 0; l < mt.inner; ++l) {
+        for (std::size_t m = 0; m < mt.columns; ++m) {
+          mt.c[r * mt.columns + m] += mt.a[r * mt.inner + l] * mt.b[l * mt.columns + m];
+        }
       }
     }
-    ot_to_send->SetCorrelations(std::move(vector_to_send));
 
-    auto ptr_receive{ot_provider.RegisterReceiveAcOt(batch_size * bit_size, sizeof(T) * 8)};
-    auto ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(ptr_receive.get());
+    const auto number_of_ots = mt.inner * mt.columns * bit_size;
+    std::vector<T> correlations;
+    correlations.reserve(number_of_ots * mt.rows);
     BitVector<> choices;
-    choices.Reserve(batch_size * bit_size);
-    for (auto k = 0ull; k < batch_size; ++k) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        const bool choice = ((mts.b.at(mt_id + k) >> bit_i) & 1u) == 1;
-        choices.Append(choice);
+    choices.Reserve(number_of_ots);
+    for (std::size_t l = 0; l < mt.inner; ++l) {
+      for (std::size_t m = 0; m < mt.columns; ++m) {
+        for (std::size_t t = 0; t < bit_size; ++t) {
+          for (std::size_t r = 0; r < mt.rows; ++r) {
+            correlations.emplace_back(static_cast<T>(mt.a[r * mt.inner + l] << t));
+          }
+          choices.Append(((mt.b[l * mt.columns + m] >> t) & 1u) == 1);
+        }
       }
     }
-    ot_to_receive->SetChoices(std::move(choices));
 
-    ots_sender.emplace_back(std::move(ptr_send));
-    ots_receiver.emplace_back(std::move(ptr_receive));
+    for (auto i = 0ull; i < number_of_parties_; ++i) {
+      if (i == my_id_) {
+        continue;
+      }
+      auto ptr_send{ot_providers_.at(i)->RegisterSendAcOt(number_of_ots, bit_size, mt.rows)};
+      dynamic_cast<AcOtSender<T>*>(ptr_send.get())->SetCorrelations(correlations);
+      auto ptr_receive{ot_providers_.at(i)->RegisterReceiveAcOt(number_of_ots, bit_size, mt.rows)};
+      ptr_receive->SetChoices(choices);
+      matrix_ots_sender_.at(i).emplace_back(std::move(ptr_send));
+      matrix_ots_receiver_.at(i).emplace_back(std::move(ptr_receive));
+    }
+  }
+}
 
-    mt_id += batch_size;
+void MtProviderFromOts::GenerateCompactTriples() {
+  SampleShareKeys();
+  if (number_of_bit_mts_ > 0) {
+    std::vector<std::byte> buffer((number_of_bit_mts_ + 7) / 8);
+    ExpandShares(GetTypeIndex<bool>(), false, 0, buffer.size(), buffer.data());
+    bit_mts_.a = BitVector<>(buffer.data(), number_of_bit_mts_);
+    ExpandShares(GetTypeIndex<bool>(), true, 0, buffer.size(), buffer.data());
+    bit_mts_.b = BitVector<>(buffer.data(), number_of_bit_mts_);
+    bit_mts_.c = bit_mts_.a & bit_mts_.b;
   }
+  ForEachIntegerPool([this](auto type, auto& pool) {
+    using T = decltype(type);
+    auto& mts = pool.mts;
+    mts.a.resize(pool.number_of_mts);
+    mts.b.resize(pool.number_of_mts);
+    ExpandShares(GetTypeIndex<T>(), false, 0, pool.number_of_mts * sizeof(T),
+                 reinterpret_cast<std::byte*>(mts.a.data()));
+    ExpandShares(GetTypeIndex<T>(), true, 0, pool.number_of_mts * sizeof(T),
+                 reinterpret_cast<std::byte*>(mts.b.data()));
+    mts.c.resize(pool.number_of_mts);
+    std::transform(mts.a.cbegin(), mts.a.cend(), mts.b.cbegin(), mts.c.begin(),
+                   [](const auto& a_i, const auto& b_i) { return a_i * b_i; });
+  });
 }
 
 void MtProviderFromOts::RegisterOts() {
-  if (number_of_bit_mts_ > 0) {
-    GenerateRandomTriplesBool(bit_mts_, number_of_bit_mts_);
+  if (compact_) {
+    GenerateCompactTriples();
+  } else {
+    if (number_of_bit_mts_ > 0) {
+      GenerateRandomTriplesBool(bit_mts_, number_of_bit_mts_, number_of_threads_);
+    }
+    ForEachIntegerPool([this](auto, auto& pool) {
+      GenerateRandomTriples(pool.mts, pool.number_of_mts, number_of_threads_);
+    });
   }
-  GenerateRandomTriples<std::uint8_t>(mts8_, number_of_mts_8_);
-  GenerateRandomTriples<std::uint16_t>(mts16_, number_of_mts_16_);
-  GenerateRandomTriples<std::uint32_t>(mts32_, number_of_mts_32_);
-  GenerateRandomTriples<std::uint64_t>(mts64_, number_of_mts_64_);
 
   for (auto i = 0ull; i < number_of_parties_; ++i) {
     if (i == my_id_) {
       continue;
     }
-    if (number_of_bit_mts_ > 0) {
+    if (kk13_ot_providers_) {
+      RegisterHelperBoolKk13(*kk13_ot_providers_->at(i), kk13_bit_ots_sender_.at(i),
+                             kk13_bit_ots_receiver_.at(i), batch_size_, bit_mts_,
+                             number_of_bit_mts_);
+    } else {
       RegisterHelperBool(*ot_providers_.at(i), bit_ots_sender_.at(i), bit_ots_receiver_.at(i),
-                         bit_mts_, number_of_bit_mts_);
+                         batch_size_, bit_mts_, number_of_bit_mts_);
     }
-    RegisterHelper<std::uint8_t>(*ot_providers_.at(i), ots_sender_8_.at(i), ots_receiver_8_.at(i),
-                                 kMaxBatchSize, mts8_, number_of_mts_8_);
-    RegisterHelper<std::uint16_t>(*ot_providers_.at(i), ots_sender_16_.at(i),
-                                  ots_receiver_16_.at(i), kMaxBatchSize, mts16_, number_of_mts_16_);
-    RegisterHelper<std::uint32_t>(*ot_providers_.at(i), ots_sender_32_.at(i),
-                                  ots_receiver_32_.at(i), kMaxBatchSize, mts32_, number_of_mts_32_);
-    RegisterHelper<std::uint64_t>(*ot_providers_.at(i), ots_sender_64_.at(i),
-                                  ots_receiver_64_.at(i), kMaxBatchSize, mts64_, number_of_mts_64_);
+    ForEachIntegerPool([this, i](auto type, auto& pool) {
+      using T = decltype(type);
+      auto& ots = integer_ots_[boost::hana::type_c<T>];
+      RegisterHelper<T>(*ot_providers_.at(i), ots.sender.at(i), ots.receiver.at(i), batch_size_,
+                        pool.mts, pool.number_of_mts, ots.packed);
+    });
+  }
+
+  ForEachIntegerPool([this](auto, auto& pool) { RegisterMatrixOts(pool.matrix_mts); });
+
+  // the OTs hold copies of the needed parts of a and b, which can be expanded again on access
+  if (compact_) {
+    bit_mts_.a = BitVector<>();
+    bit_mts_.b = BitVector<>();
+    ForEachIntegerPool([](auto type, auto& pool) {
+      using T = decltype(type);
+      pool.mts.a = std::vector<T>();
+      pool.mts.b = std::vector<T>();
+    });
   }
 }
 
-static void ParseHelperBool(std::unique_ptr<XcOtBitSender>& ots_sender,
-                            std::unique_ptr<XcOtBitReceiver>& ots_receiver,
-                            BinaryMtVector& bit_mts) {
-  ots_sender->ComputeOutputs();
-  ots_receiver->ComputeOutputs();
-  const auto& output_sender = ots_sender->GetOutputs();
-  const auto& output_receiver = ots_receiver->GetOutputs();
-  bit_mts.c ^= output_sender;
-  bit_mts.c ^= output_receiver;
+// parses the batch of MTs starting at mt_id, which has to be at the front of the lists
+static void ParseHelperBool(std::list<std::unique_ptr<XcOtBitSender>>& ots_sender,
+                            std::list<std::unique_ptr<XcOtBitReceiver>>& ots_receiver,
+                            BinaryMtVector& bit_mts, std::size_t mt_id, std::size_t batch_size) {
+  auto& ot_to_send = *ots_sender.front();
+  auto& ot_to_receive = *ots_receiver.front();
+  ot_to_send.ComputeOutputs();
+  ot_to_receive.ComputeOutputs();
+  // mt_id is a multiple of the batch size and hence byte-aligned
+  BitSpan c(bit_mts.c.GetMutableData().data() + mt_id / 8, batch_size);
+  c ^= ot_to_send.GetOutputs();
+  c ^= ot_to_receive.GetOutputs();
+  ots_sender.pop_front();
+  ots_receiver.pop_front();
+}
+
+// parses the batch of MTs starting at mt_id, see RegisterHelperBoolKk13
+static void ParseHelperBoolKk13(std::list<std::unique_ptr<GKk13OtSender>>& ots_sender,
+                                std::list<std::unique_ptr<GKk13OtReceiver>>& ots_receiver,
+                                BinaryMtVector& bit_mts, std::size_t mt_id,
+                                std::size_t number_of_bit_mts) {
+  auto& ot_to_receive = *ots_receiver.front();
+  ot_to_receive.ComputeOutputs();
+  const auto outputs{ot_to_receive.GetOutputs()};
+  const auto c{bit_mts.c.GetMutableData().data()};
+  for (std::size_t k = 0; k < outputs.size(); ++k) {
+    const auto position = mt_id + k * kBitMtsPerKk13Ot;
+    XorNibble(c, position, GetNibble(outputs[k].GetData().data(), 0),
+              number_of_bit_mts - position);
+  }
+  ots_sender.pop_front();
+  ots_receiver.pop_front();
 }
 
 template <typename T>
 static void ParseHelper(std::list<std::unique_ptr<BasicOtSender>>& ots_sender,
                         std::list<std::unique_ptr<BasicOtReceiver>>& ots_receiver,
-                        std::size_t max_batch_size, IntegerMtVector<T>& mts,
-                        std::size_t number_of_mts) {
+                        IntegerMtVector<T>& mts, std::size_t mt_id, std::size_t batch_size,
+                        bool packed) {
   constexpr std::size_t bit_size = sizeof(T) * 8;
 
-  for (std::size_t mt_id = 0; mt_id < number_of_mts;) {
-    const auto batch_size = std::min(max_batch_size, number_of_mts - mt_id);
-    const auto& ot_to_send = dynamic_cast<AcOtSender<T>*>(ots_sender.front().get());
-    const auto& ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(ots_receiver.front().get());
+  ForEachSegment<T>(packed, [&](auto w_tag, std::size_t begin, std::size_t end) {
+    using W = decltype(w_tag);
+    constexpr std::size_t w = sizeof(W) * 8;
+    const auto segment_size = end - begin;
+
+    const auto& ot_to_send = dynamic_cast<AcOtSender<W>*>(ots_sender.front().get());
+    const auto& ot_to_receive = dynamic_cast<AcOtReceiver<W>*>(ots_receiver.front().get());
     ot_to_send->ComputeOutputs();
     const auto& output_sender = ot_to_send->GetOutputs();
     ot_to_receive->ComputeOutputs();
     const auto& output_receiver = ot_to_receive->GetOutputs();
     for (auto j = 0ull; j < batch_size; ++j) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        mts.c.at(mt_id + j) +=
-            output_receiver[j * bit_size + bit_i] - output_sender[j * bit_size + bit_i];
+      for (auto bit_i = 0ull; bit_i < segment_size; ++bit_i) {
+        const W share = output_receiver[j * segment_size + bit_i] -
+                        output_sender[j * segment_size + bit_i];
+        mts.c.at(mt_id + j) += static_cast<T>(static_cast<T>(share) << (bit_size - w));
       }
     }
     ots_sender.pop_front();
     ots_receiver.pop_front();
+  });
+}
+
+template <typename T>
+void MtProviderFromOts::ParseOutputs(IntegerMtOts<T>& ots, IntegerMtPool<T>& pool) {
+  // batch-major, such that each batch can be released as soon as all parties' outputs are in
+  for (std::size_t mt_id = 0; mt_id < pool.number_of_mts;) {
+    const auto batch_size = std::min(batch_size_, pool.number_of_mts - mt_id);
+    for (auto i = 0ull; i < number_of_parties_; ++i) {
+      if (i == my_id_) {
+        continue;
+      }
+      ParseHelper<T>(ots.sender.at(i), ots.receiver.at(i), pool.mts, mt_id, batch_size,
+                     ots.packed);
+    }
     mt_id += batch_size;
+    SetMtsAvailable<T>(mt_id);
+  }
+}
+
+template <typename T>
+void MtProviderFromOts::ParseMatrixOutputs(std::vector<MatrixMt<T>>& matrix_mts) {
+  constexpr std::size_t bit_size = sizeof(T) * 8;
+
+  for (auto& mt : matrix_mts) {
+    for (auto i = 0ull; i < number_of_parties_; ++i) {
+      if (i == my_id_) {
+        continue;
+      }
+      auto ot_to_send = dynamic_cast<AcOtSender<T>*>(matrix_ots_sender_.at(i).front().get());
+      auto ot_to_receive =
+          dynamic_cast<AcOtReceiver<T>*>(matrix_ots_receiver_.at(i).front().get());
+      ot_to_send->ComputeOutputs();
+      ot_to_receive->ComputeOutputs();
+      const auto& output_sender = ot_to_send->GetOutputs();
+      const auto& output_receiver = ot_to_receive->GetOutputs();
+      for (std::size_t l = 0; l < mt.inner; ++l) {
+        for (std::size_t m = 0; m < mt.columns; ++m) {
+          for (std::size_t t = 0; t < bit_size; ++t) {
+            const auto ot_offset = ((l * mt.columns + m) * bit_size + t) * mt.rows;
+            for (std::size_t r = 0; r < mt.rows; ++r) {
+              mt.c[r * mt.columns + m] +=
+                  output_receiver[ot_offset + r] - output_sender[ot_offset + r];
+            }
+          }
+        }
+      }
+      matrix_ots_sender_.at(i).pop_front();
+      matrix_ots_receiver_.at(i).pop_front();
+    }
   }
 }
 
 void MtProviderFromOts::ParseOutputs() {
-  for (auto i = 0ull; i < number_of_parties_; ++i) {
-    if (i == my_id_) {
-      continue;
+  // the MTs of each type and the matrix MTs are stored and computed with separate OTs, so their
+  // outputs can be parsed concurrently
+  std::vector<std::future<void>> futures;
+  if (number_of_bit_mts_ > 0) {
+    futures.emplace_back(std::async(std::launch::async, [this] { ParseBinaryOutputs(); }));
+  }
+  ForEachIntegerPool([this, &futures](auto type, auto& pool) {
+    if (pool.number_of_mts > 0) {
+      futures.emplace_back(std::async(std::launch::async, [this, &pool] {
+        ParseOutputs(integer_ots_[boost::hana::type_c<decltype(type)>], pool);
+      }));
+    }
+  });
+  if (NeedMatrixMts()) {
+    // the matrix OTs of all types share the same lists
+    futures.emplace_back(std::async(std::launch::async, [this] {
+      ForEachIntegerPool([this](auto, auto& pool) { ParseMatrixOutputs(pool.matrix_mts); });
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+void MtProviderFromOts::ParseBinaryOutputs() {
+  for (std::size_t mt_id = 0; mt_id < number_of_bit_mts_;) {
+    const auto batch_size = std::min(batch_size_, number_of_bit_mts_ - mt_id);
+    for (auto i = 0ull; i < number_of_parties_; ++i) {
+      if (i == my_id_) {
+        continue;
+      }
+      if (kk13_ot_providers_) {
+        ParseHelperBoolKk13(kk13_bit_ots_sender_.at(i), kk13_bit_ots_receiver_.at(i), bit_mts_,
+                            mt_id, number_of_bit_mts_);
+      } else {
+        ParseHelperBool(bit_ots_sender_.at(i), bit_ots_receiver_.at(i), bit_mts_, mt_id,
+                        batch_size);
+      }
     }
+    mt_id += batch_size;
+    SetMtsAvailable<bool>(mt_id);
+  }
+}
 
-    if (number_of_bit_mts_ > 0) {
-      ParseHelperBool(bit_ots_sender_.at(i), bit_ots_receiver_.at(i), bit_mts_);
+MtProviderFromFile::MtProviderFromFile(std::shared_ptr<PreprocessingStore> store,
+                                       const std::size_t my_id,
+                                       const std::size_t number_of_parties)
+    : MtProvider(my_id, number_of_parties), store_(std::move(store)) {}
+
+void MtProviderFromFile::PreSetup() {
+  if (NeedMatrixMts() || GetNumberOfMts<__uint128_t>() > 0) {
+    throw std::logic_error(
+        "MtProviderFromFile does not support matrix multiplication triples and 128 bit MTs");
+  }
+  auto check = [this](PreprocessingKind kind, std::size_t number_of_mts) {
+    if (store_->GetNumberOfAvailableElements(kind) < number_of_mts) {
+      throw std::runtime_error(
+          fmt::format("Preprocessing store does not contain {} MTs of kind {}", number_of_mts,
+                      static_cast<std::uint32_t>(kind)));
     }
-    ParseHelper<std::uint8_t>(ots_sender_8_.at(i), ots_receiver_8_.at(i), kMaxBatchSize, mts8_,
-                              number_of_mts_8_);
-    ParseHelper<std::uint16_t>(ots_sender_16_.at(i), ots_receiver_16_.at(i), kMaxBatchSize, mts16_,
-                               number_of_mts_16_);
-    ParseHelper<std::uint32_t>(ots_sender_32_.at(i), ots_receiver_32_.at(i), kMaxBatchSize, mts32_,
-                               number_of_mts_32_);
-    ParseHelper<std::uint64_t>(ots_sender_64_.at(i), ots_receiver_64_.at(i), kMaxBatchSize, mts64_,
-                               number_of_mts_64_);
+  };
+  check(PreprocessingKind::kBinaryMts, number_of_bit_mts_);
+  check(PreprocessingKind::kIntegerMts8, GetNumberOfMts<std::uint8_t>());
+  check(PreprocessingKind::kIntegerMts16, GetNumberOfMts<std::uint16_t>());
+  check(PreprocessingKind::kIntegerMts32, GetNumberOfMts<std::uint32_t>());
+  check(PreprocessingKind::kIntegerMts64, GetNumberOfMts<std::uint64_t>());
+}
+
+template <typename T>
+static void LoadIntegerMts(PreprocessingStore& store, IntegerMtPool<T>& pool) {
+  if (pool.number_of_mts == 0) return;
+  const auto [a, b, c] = store.ConsumeIntegerMts<T>(pool.number_of_mts);
+  pool.mts.a.assign(a.begin(), a.end());
+  pool.mts.b.assign(b.begin(), b.end());
+  pool.mts.c.assign(c.begin(), c.end());
+}
+
+void MtProviderFromFile::Setup() {
+  if (!NeedMts()) {
+    return;
+  }
+
+  if (number_of_bit_mts_ > 0) {
+    auto [a, b, c] = store_->ConsumeBinaryMts(number_of_bit_mts_);
+    bit_mts_ = BinaryMtVector{std::move(a), std::move(b), std::move(c)};
   }
+  LoadIntegerMts(*store_, GetIntegerPool<std::uint8_t>());
+  LoadIntegerMts(*store_, GetIntegerPool<std::uint16_t>());
+  LoadIntegerMts(*store_, GetIntegerPool<std::uint32_t>());
+  LoadIntegerMts(*store_, GetIntegerPool<std::uint64_t>());
+  SetFinished();
+}
+
+MtProviderFromThirdParty::MtProviderFromThirdParty(std::shared_ptr<ThirdPartyDealerClient> client)
+    : MtProvider(client->GetMyId(), client->GetNumberOfParties()), client_(std::move(client)) {}
+
+void MtProviderFromThirdParty::PreSetup() {
+  if (NeedMatrixMts() || GetNumberOfMts<__uint128_t>() > 0) {
+    throw std::logic_error(
+        "MtProviderFromThirdParty does not support matrix multiplication triples and 128 bit MTs");
+  }
+  client_->RequestMts(*this);
+}
+
+void MtProviderFromThirdParty::Setup() {
+  if (!NeedMts()) {
+    return;
+  }
+
+  auto& material{client_->GetMaterial()};
+  bit_mts_ = std::move(material.binary_mts);
+  GetIntegerPool<std::uint8_t>().mts = std::move(material.mts_8);
+  GetIntegerPool<std::uint16_t>().mts = std::move(material.mts_16);
+  GetIntegerPool<std::uint32_t>().mts = std::move(material.mts_32);
+  GetIntegerPool<std::uint64_t>().mts = std::move(material.mts_64);
+  SetFinished();
 }
 
 }  // namespace encrypto::motion
@@ -24,27 +24,134 @@
 
 #pragma once
 
+#include <array>
+#include <bit>
 #include <list>
+#include <span>
 
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/keys.hpp>
+
+#include "data_storage/preprocessing_plan.h"
 #include "oblivious_transfer/ot_flavors.h"
 #include "utility/bit_vector.h"
 #include "utility/fiber_condition.h"
 #include "utility/helpers.h"
+#include "utility/meta.hpp"
 
 namespace encrypto::motion {
 
 struct RunTimeStatistics;
+class GKk13OtReceiver;
+class GKk13OtSender;
+class Kk13OtProvider;
 class Logger;
+class PreprocessingStore;
+class ThirdPartyDealerClient;
 
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 struct IntegerMtVector {
   std::vector<T> a, b, c;  // c[i] = a[i] * b[i]
 };
 
+// Matrix multiplication triple of the given shape, where the matrices are stored row-major and
+// a is a rows x inner, b an inner x columns, and c = a * b a rows x columns matrix
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+struct MatrixMt {
+  std::size_t rows, inner, columns;
+  std::vector<T> a, b, c;
+};
+
 struct BinaryMtVector {
   BitVector<> a, b, c;  // c[i] = a[i] ^ b[i]
 };
 
+// Non-owning view of n integer MTs, whose spans point into the storage of the MtProvider, such that
+// the MTs are read in place. Only a and b of compact MTs are expanded into a buffer of the view,
+// which is why the view can be moved but not copied.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+class IntegerMtView {
+ public:
+  IntegerMtView(std::span<const T> a_view, std::span<const T> b_view, std::span<const T> c_view)
+      : a(a_view), b(b_view), c(c_view) {}
+
+  // a_and_b holds the n elements of a followed by the n elements of b, moving it into the view
+  // keeps its buffer
+  IntegerMtView(std::vector<T>&& a_and_b, std::span<const T> c_view)
+      : a(a_and_b.data(), c_view.size()),
+        b(a_and_b.data() + c_view.size(), c_view.size()),
+        c(c_view),
+        expanded_(std::move(a_and_b)) {}
+
+  IntegerMtView(const IntegerMtView&) = delete;
+  IntegerMtView(IntegerMtView&&) = default;
+
+  std::span<const T> a, b, c;
+
+ private:
+  std::vector<T> expanded_;
+};
+
+// View of n binary MTs, which reads the bits of a, b and c in place. Since a BitSpan needs to start
+// at a byte but the MTs of a gate may start at any bit, it consists of the vectors of the provider
+// and the offset of the MTs. Only a and b of compact MTs are expanded into the view.
+class BinaryMtView {
+ public:
+  BinaryMtView(const BinaryMtVector& mts, std::size_t offset, std::size_t size)
+      : a_(&mts.a), b_(&mts.b), c_(&mts.c), offset_(offset), c_offset_(offset), size_(size) {}
+
+  BinaryMtView(BitVector<>&& a, BitVector<>&& b, const BitVector<>& c, std::size_t offset)
+      : expanded_a_(std::move(a)),
+        expanded_b_(std::move(b)),
+        c_(&c),
+        offset_(0),
+        c_offset_(offset),
+        size_(expanded_a_.GetSize()) {}
+
+  std::size_t GetSize() const noexcept { return size_; }
+
+  // bits [begin, end) of the view of a, b, and c, respectively
+  BitVector<> SubsetA(std::size_t begin, std::size_t end) const {
+    return (a_ ? *a_ : expanded_a_).Subset(offset_ + begin, offset_ + end);
+  }
+  BitVector<> SubsetB(std::size_t begin, std::size_t end) const {
+    return (b_ ? *b_ : expanded_b_).Subset(offset_ + begin, offset_ + end);
+  }
+  BitVector<> SubsetC(std::size_t begin, std::size_t end) const {
+    return c_->Subset(c_offset_ + begin, c_offset_ + end);
+  }
+
+ private:
+  BitVector<> expanded_a_, expanded_b_;
+  // nullptr if a and b are expanded
+  const BitVector<>* a_{nullptr};
+  const BitVector<>* b_{nullptr};
+  const BitVector<>* c_;
+  std::size_t offset_, c_offset_, size_;
+};
+
+// All MTs of one bit length, i.e., the number of MTs to generate, which is known before they are
+// generated, the MTs themselves, and the requested matrix triples
+template <typename T>
+struct IntegerMtPool {
+  std::size_t number_of_mts{0};
+  // number of MTs requested by the gates, which may be less than number_of_mts if the provider was
+  // primed with a PreprocessingPlan
+  std::size_t number_of_requested_mts{0};
+  IntegerMtVector<T> mts;
+  std::vector<MatrixMt<T>> matrix_mts;
+};
+
+// The OTs for the integer MTs of one bit length, indexed by the other party
+template <typename T>
+struct IntegerMtOts {
+  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> receiver;
+  std::vector<std::list<std::unique_ptr<BasicOtSender>>> sender;
+  bool packed{false};
+};
+
 class MtProvider {
  public:
   virtual ~MtProvider() = default;
@@ -55,77 +162,112 @@ class MtProvider {
   std::size_t GetNumberOfMts() const noexcept {
     if constexpr (std::is_same_v<T, bool>) {
       return number_of_bit_mts_;
-    } else if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return number_of_mts_8_;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return number_of_mts_16_;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return number_of_mts_32_;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return number_of_mts_64_;
     } else {
-      throw std::runtime_error("Unknown type");
+      return GetIntegerPool<T>().number_of_mts;
     }
   }
 
-  std::size_t RequestBinaryMts(const std::size_t number_of_mts) noexcept;
+  // number of MTs of type T which have been generated so far, may be called concurrently
+  template <typename T>
+  std::size_t GetNumberOfAvailableMts() const {
+    std::scoped_lock lock(available_mutex_);
+    return number_of_available_mts_[GetTypeIndex<T>()];
+  }
+
+  // throws std::logic_error if the provider was primed with a plan which does not cover the MTs
+  std::size_t RequestBinaryMts(const std::size_t number_of_mts);
 
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
-  std::size_t RequestArithmeticMts(const std::size_t number_of_mts) noexcept {
-    std::size_t offset;
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      offset = number_of_mts_8_;
-      number_of_mts_8_ += number_of_mts;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      offset = number_of_mts_16_;
-      number_of_mts_16_ += number_of_mts;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      offset = number_of_mts_32_;
-      number_of_mts_32_ += number_of_mts;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      offset = number_of_mts_64_;
-      number_of_mts_64_ += number_of_mts;
-    } else {
-      throw std::runtime_error("Unknown type");
+  std::size_t RequestArithmeticMts(const std::size_t number_of_mts) {
+    auto& pool = GetIntegerPool<T>();
+    return RequestPlannedElements(pool.number_of_requested_mts, pool.number_of_mts, number_of_mts,
+                                  primed_, "integer MTs");
+  }
+
+  // Reserves the MTs of the plan in addition to the ones requested so far, after which requests
+  // need to fit into the reserved MTs (see PreprocessingPlan)
+  void Prime(const PreprocessingPlan& plan);
+
+  // Request a matrix triple for the product of a rows x inner and an inner x columns matrix, which
+  // costs inner * columns * 8 * sizeof(T) OTs of rows elements each instead of
+  // rows * inner * columns scalar MTs. Returns the id of the triple for GetMatrixMt.
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  std::size_t RequestMatrixMts(std::size_t rows, std::size_t inner, std::size_t columns) {
+    if (primed_) {
+      throw std::logic_error("Matrix MTs are not covered by a preprocessing plan");
     }
-    return offset;
+    auto& matrix_mts = GetIntegerPool<T>().matrix_mts;
+    matrix_mts.emplace_back(MatrixMt<T>{rows, inner, columns, {}, {}, {}});
+    return matrix_mts.size() - 1;
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  const MatrixMt<T>& GetMatrixMt(std::size_t id) const {
+    WaitFinished();
+    return GetIntegerPool<T>().matrix_mts.at(id);
   }
 
   // get bits [i, i+n] as vector
   BinaryMtVector GetBinary(const std::size_t offset, const std::size_t n = 1) const;
 
+  // Blocks until the binary MTs [offset, offset + n) are available and returns a view of them,
+  // which unlike GetBinary does not copy them
+  BinaryMtView GetBinaryView(const std::size_t offset, const std::size_t n) const;
+
   const BinaryMtVector& GetBinaryAll() const noexcept;
 
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   IntegerMtVector<T> GetInteger(const std::size_t offset, const std::size_t n = 1) const {
-    WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return GetInteger(mts8_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return GetInteger(mts16_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return GetInteger(mts32_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return GetInteger(mts64_, offset, n);
-    } else {
-      throw std::runtime_error("Unknown type");
+    const auto& mts{WaitForIntegerMts<T>(offset, n)};
+    if (!compact_) {
+      return GetInteger(mts, offset, n);
+    }
+    assert(offset + n <= mts.c.size());
+    IntegerMtVector<T> result{std::vector<T>(n), std::vector<T>(n),
+                              std::vector<T>(mts.c.begin() + offset, mts.c.begin() + offset + n)};
+    ExpandShares(GetTypeIndex<T>(), false, offset * sizeof(T), n * sizeof(T),
+                 reinterpret_cast<std::byte*>(result.a.data()));
+    ExpandShares(GetTypeIndex<T>(), true, offset * sizeof(T), n * sizeof(T),
+                 reinterpret_cast<std::byte*>(result.b.data()));
+    return result;
+  }
+
+  // Blocks until the integer MTs [offset, offset + n) are available and returns a view of them,
+  // which unlike GetInteger does not copy them
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  IntegerMtView<T> GetIntegerView(const std::size_t offset, const std::size_t n) const {
+    const auto& mts{WaitForIntegerMts<T>(offset, n)};
+    assert(offset + n <= mts.c.size());
+    const std::span<const T> c(mts.c.data() + offset, n);
+    if (!compact_) {
+      return IntegerMtView<T>(std::span<const T>(mts.a.data() + offset, n),
+                              std::span<const T>(mts.b.data() + offset, n), c);
     }
+    std::vector<T> a_and_b(2 * n);
+    ExpandShares(GetTypeIndex<T>(), false, offset * sizeof(T), n * sizeof(T),
+                 reinterpret_cast<std::byte*>(a_and_b.data()));
+    ExpandShares(GetTypeIndex<T>(), true, offset * sizeof(T), n * sizeof(T),
+                 reinterpret_cast<std::byte*>(a_and_b.data() + n));
+    return IntegerMtView<T>(std::move(a_and_b), c);
   }
 
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   const IntegerMtVector<T>& GetIntegerAll() const noexcept {
     WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return mts8_;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return mts16_;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return mts32_;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return mts64_;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetIntegerPool<T>().mts;
+  }
+
+  // Blocks until the binary MTs [offset, offset + n) are available and returns all binary MTs, of
+  // which only the available ones may be accessed before WaitFinished() returns. Providers which
+  // generate the MTs in chunks (see MtProviderFromOts) make them available before all are finished.
+  // For compact MTs (see IsCompact), a and b are empty here and need to be obtained by GetBinary.
+  const BinaryMtVector& WaitForBinaryMts(std::size_t offset, std::size_t n) const;
+
+  // Blocks until the integer MTs [offset, offset + n) are available, see WaitForBinaryMts
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  const IntegerMtVector<T>& WaitForIntegerMts(std::size_t offset, std::size_t n) const {
+    WaitForMts(GetTypeIndex<T>(), offset + n);
+    return GetIntegerPool<T>().mts;
   }
 
   virtual void PreSetup() = 0;
@@ -134,19 +276,60 @@ class MtProvider {
   // blocking wait
   void WaitFinished() const { finished_condition_->Wait(); }
 
+  // if only c of the binary and integer MTs is stored, while a and b are expanded from PRG keys by
+  // GetBinary and GetInteger, see MtProviderFromOts::SetCompactMts
+  bool IsCompact() const noexcept { return compact_; }
+
  protected:
   MtProvider(std::size_t my_id, std::size_t number_of_parties);
   MtProvider() = delete;
 
-  std::size_t number_of_bit_mts_{0}, number_of_mts_8_{0}, number_of_mts_16_{0},
-      number_of_mts_32_{0}, number_of_mts_64_{0};
+  template <typename T>
+  IntegerMtPool<T>& GetIntegerPool() noexcept {
+    return integer_pools_[boost::hana::type_c<T>];
+  }
+
+  template <typename T>
+  const IntegerMtPool<T>& GetIntegerPool() const noexcept {
+    return integer_pools_[boost::hana::type_c<T>];
+  }
+
+  // calls f(T{}, GetIntegerPool<T>()) for all bit lengths T in ascending order
+  template <typename F>
+  void ForEachIntegerPool(F&& f) {
+    boost::hana::for_each(boost::hana::keys(integer_pools_), [this, &f](auto type) {
+      using T = typename decltype(type)::type;
+      f(T{}, GetIntegerPool<T>());
+    });
+  }
+
+  template <typename F>
+  void ForEachIntegerPool(F&& f) const {
+    boost::hana::for_each(boost::hana::keys(integer_pools_), [this, &f](auto type) {
+      using T = typename decltype(type)::type;
+      f(T{}, GetIntegerPool<T>());
+    });
+  }
+
+  bool NeedMatrixMts() const noexcept;
+
+  // samples the keys of the PRG streams of a and b for all MT types
+  void SampleShareKeys();
+
+  // writes bytes [byte_offset, byte_offset + number_of_bytes) of the stream of a (or b if is_b is
+  // set) of the MTs with the given type index to output, where the element i of an integer type T
+  // are the bytes [i * sizeof(T), (i + 1) * sizeof(T)) and binary MT i is bit i
+  void ExpandShares(std::size_t type_index, bool is_b, std::size_t byte_offset,
+                    std::size_t number_of_bytes, std::byte* output) const;
+
+  std::size_t number_of_bit_mts_{0};
+  std::size_t number_of_requested_bit_mts_{0};
+  bool primed_{false};
+  bool compact_{false};
 
   BinaryMtVector bit_mts_;
 
-  IntegerMtVector<std::uint8_t> mts8_;
-  IntegerMtVector<std::uint16_t> mts16_;
-  IntegerMtVector<std::uint32_t> mts32_;
-  IntegerMtVector<std::uint64_t> mts64_;
+  IntegerTypeMap<IntegerMtPool> integer_pools_;
 
   const std::size_t my_id_;
   const std::size_t number_of_parties_;
@@ -154,7 +337,40 @@ class MtProvider {
   std::atomic<bool> finished_{false};
   std::shared_ptr<FiberCondition> finished_condition_;
 
+  // index of the MT type in number_of_available_mts_, where bool denotes the binary MTs
+  template <typename T>
+  static constexpr std::size_t GetTypeIndex() {
+    if constexpr (std::is_same_v<T, bool>) {
+      return 0;
+    } else {
+      return 1 + std::countr_zero(sizeof(T));
+    }
+  }
+
+  // marks the first number_of_mts MTs of type T as available, which may only increase
+  template <typename T>
+  void SetMtsAvailable(std::size_t number_of_mts) {
+    {
+      std::scoped_lock lock(available_mutex_);
+      number_of_available_mts_[GetTypeIndex<T>()] = number_of_mts;
+    }
+    available_condition_.notify_all();
+  }
+
+  // marks all MTs as available and wakes up all waiting fibers
+  void SetFinished();
+
  private:
+  void WaitForMts(std::size_t type_index, std::size_t end) const;
+
+  std::array<std::size_t, 6> number_of_available_mts_{};
+
+  // keys of the streams of a and b of compact MTs, the key of type index i for a (b) is at 2 * i
+  // (2 * i + 1)
+  std::array<std::array<std::byte, 16>, 12> share_keys_{};
+  mutable boost::fibers::mutex available_mutex_;
+  mutable boost::fibers::condition_variable_any available_condition_;
+
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   inline IntegerMtVector<T> GetInteger(const IntegerMtVector<T>& mts, const std::size_t offset,
                                        const std::size_t n) const {
@@ -162,9 +378,9 @@ class MtProvider {
     assert(mts.c.size() == mts.b.size());
     assert(offset + n <= mts.a.size());
 
-    return IntegerMtVector<T>{std::vector<T>(mts.a.begin() + offset, mts.a.begin + offset + n),
-                              std::vector<T>(mts.b.begin() + offset, mts.b.begin + offset + n),
-                              std::vector<T>(mts.c.begin() + offset, mts.c.begin + offset + n)};
+    return IntegerMtVector<T>{std::vector<T>(mts.a.begin() + offset, mts.a.begin() + offset + n),
+                              std::vector<T>(mts.b.begin() + offset, mts.b.begin() + offset + n),
+                              std::vector<T>(mts.c.begin() + offset, mts.c.begin() + offset + n)};
   }
 };
 
@@ -179,34 +395,113 @@ class MtProviderFromOts final : public MtProvider {
   // needs completed OTExtension
   void Setup() final override;
 
+  // Compute the OTs for the higher bits of b of the T-bit MTs in smaller rings (see ForEachSegment
+  // in mt_provider.cpp), which reduces the size of the OT messages by about a third for 32 and
+  // 64 bit. All parties need to choose the same, and this needs to be set before the PreSetup.
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  void SetPackedIntegerMts(bool value) {
+    integer_ots_[boost::hana::type_c<T>].packed = value;
+  }
+
+  // Store only c of the binary and integer MTs after the PreSetup and regenerate a and b from the
+  // keys of a PRG with Aes128CtrRng when the MTs are accessed with GetBinary and GetInteger, which
+  // reduces the memory of the stored MTs by two thirds. This needs to be set before the PreSetup.
+  void SetCompactMts(bool value) { compact_ = value; }
+
+  // Generate the binary MTs with 1-out-of-16 OTs of the given Kk13OtProviders, each of which
+  // yields the cross terms of 4 MTs, instead of one XcOtBit per MT. This reduces the
+  // communication per MT and direction from about 129 to 82 bits. All parties need to choose the
+  // same, and this needs to be set before the PreSetup, which then needs to precede the PreSetup of
+  // the Kk13OtProviders.
+  void SetKk13BinaryMts(std::vector<std::unique_ptr<Kk13OtProvider>>& kk13_ot_providers) {
+    kk13_ot_providers_ = &kk13_ot_providers;
+  }
+
+  // Set the number of MTs per batch, see kDefaultBatchSize. A larger batch needs fewer OT
+  // messages, while a smaller one makes the first MTs available earlier. All parties need to
+  // choose the same, and this needs to be set before the PreSetup.
+  void SetBatchSize(std::size_t batch_size);
+
+  // Set the number of threads that generate the random a and b of the MTs in the PreSetup.
+  void SetNumberOfThreads(std::size_t number_of_threads) { number_of_threads_ = number_of_threads; }
+
  private:
   void RegisterOts();
 
+  // generates a and b of all MTs from the keys of SampleShareKeys, see SetCompactMts
+  void GenerateCompactTriples();
+
+  // sends the corrections and messages of all OTs with the given party
+  void SendOts(std::size_t party_id);
+
   void ParseOutputs();
 
-  std::vector<std::unique_ptr<OtProvider>>& ot_providers_;
+  void ParseBinaryOutputs();
+
+  template <typename T>
+  void ParseOutputs(IntegerMtOts<T>& ots, IntegerMtPool<T>& pool);
+
+  template <typename T>
+  void RegisterMatrixOts(std::vector<MatrixMt<T>>& matrix_mts);
 
-  // use alternating party roles for load balancing
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_8_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_8_;
+  template <typename T>
+  void ParseMatrixOutputs(std::vector<MatrixMt<T>>& matrix_mts);
+
+  std::vector<std::unique_ptr<OtProvider>>& ot_providers_;
 
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_16_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_16_;
+  IntegerTypeMap<IntegerMtOts> integer_ots_;
 
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_32_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_32_;
+  std::vector<std::list<std::unique_ptr<XcOtBitReceiver>>> bit_ots_receiver_;
+  std::vector<std::list<std::unique_ptr<XcOtBitSender>>> bit_ots_sender_;
 
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_64_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_64_;
+  // only used if set with SetKk13BinaryMts
+  std::vector<std::unique_ptr<Kk13OtProvider>>* kk13_ot_providers_{nullptr};
+  std::vector<std::list<std::unique_ptr<GKk13OtReceiver>>> kk13_bit_ots_receiver_;
+  std::vector<std::list<std::unique_ptr<GKk13OtSender>>> kk13_bit_ots_sender_;
 
-  std::vector<std::unique_ptr<XcOtBitReceiver>> bit_ots_receiver_;
-  std::vector<std::unique_ptr<XcOtBitSender>> bit_ots_sender_;
+  // OTs of all matrix MTs, ordered by bit length and id
+  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> matrix_ots_receiver_;
+  std::vector<std::list<std::unique_ptr<BasicOtSender>>> matrix_ots_sender_;
 
-  // Should be divisible by 128
-  static inline constexpr std::size_t kMaxBatchSize{128 * 128};
+  // Should be divisible by 128. The MTs are computed and made available in batches of this size,
+  // so that gates using the first MTs can be evaluated before all MTs are finished.
+  static inline constexpr std::size_t kDefaultBatchSize{128 * 128};
+  std::size_t batch_size_{kDefaultBatchSize};
+  std::size_t number_of_threads_{1};
 
   std::shared_ptr<Logger> logger_;
   RunTimeStatistics& run_time_statistics_;
 };
 
+// Provider which takes the multiplication triples from a PreprocessingStore instead of generating
+// them with OTs
+class MtProviderFromFile final : public MtProvider {
+ public:
+  MtProviderFromFile(std::shared_ptr<PreprocessingStore> store, const std::size_t my_id,
+                     const std::size_t number_of_parties);
+
+  // fails early if the store does not contain enough triples
+  void PreSetup() final override;
+
+  void Setup() final override;
+
+ private:
+  std::shared_ptr<PreprocessingStore> store_;
+};
+
+// Provider which obtains the multiplication triples from a ThirdPartyDealer
+class MtProviderFromThirdParty final : public MtProvider {
+ public:
+  MtProviderFromThirdParty(std::shared_ptr<ThirdPartyDealerClient> client);
+
+  // registers the MTs with the client
+  void PreSetup() final override;
+
+  // needs a completed ThirdPartyDealerClient::Exchange
+  void Setup() final override;
+
+ private:
+  std::shared_ptr<ThirdPartyDealerClient> client_;
+};
+
 }  // namespace encrypto::motion
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -38,60 +39,75 @@ namespace encrypto::motion {
 
 namespace detail {
 
+// the arithmetic type in which operations on T are computed, which avoids the promotion of
+// small types to (signed) int
+template <typename T>
+using ArithmeticType = std::conditional_t<(sizeof(T) < sizeof(unsigned)), unsigned, T>;
+
+// mask of the k least significant bits
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+constexpr T LowBitMask(std::size_t k) {
+  return k >= sizeof(T) * 8 ? T(~T(0)) : T((T(1) << k) - 1);
+}
+
 // smallest square root of a mod 2^k
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
-T sqrt(size_t k, T a) {
+T sqrt(std::size_t k, T a) {
+  using W = ArithmeticType<T>;
   assert(k >= 3);
+  assert(k < sizeof(T) * 8);
   assert(a % 8 == 1);
-
-  if (a == 1) return 1;
-
-  std::array<T, 8> roots = {1, 3, 5, 7, 0, 0, 0, 0};
-  std::array<T, 8> new_roots = {0};
-  for (std::size_t j = 4; j < k + 1; ++j) {
-    for (std::size_t l = 0; l < 4; ++l) {
-      T r = roots[l];
-      T i = ((r * r - a) >> (j - 1)) & 1;
-      T nr = (r + (i << (j - 2))) & ((T(1) << j) - 1);
-      new_roots[l] = nr;
-      new_roots[l + 4] = (T(1) << j) - nr;
-    }
-
-    for (std::size_t l = 0; l < 8; ++l) {
-      T nr = new_roots[l];
-      for (size_t m = 0; m < 8; ++m) {
-        if (roots[m] == 0) {
-          roots[m] = nr;
-          break;
-        } else if (roots[m] == nr) {
-          break;
-        }
-      }
-    }
-    std::swap(roots, new_roots);
+  const W mask = LowBitMask<T>(k);
+
+  // Newton iteration for the inverse square root y, i.e., a * y^2 = 1 mod 2^p, where the
+  // precision p grows from 3 (since a = 1 mod 8) to 2p - 2 in each step
+  W y = 1;
+  for (std::size_t p = 3; p < k; p = 2 * p - 2) {
+    const W t = static_cast<T>(W(a) * y * y);
+    y = static_cast<T>(y * (static_cast<T>(W(3) - t) >> 1));
   }
-  T minimum = roots[0];
-  for (std::size_t l = 1; l < 4; ++l) {
-    if (roots[l] < minimum) minimum = roots[l];
-  }
-  return minimum;
+
+  // r = a * y is a square root, and the others are -r and +-r + 2^(k-1)
+  const W r = W(a) * y & mask;
+  const W half = W(1) << (k - 1);
+  return static_cast<T>(std::min({r, (0 - r) & mask, (r + half) & mask, (half - r) & mask}));
 }
 
 // inversion of a mod 2^k
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 T invert(std::size_t k, T a) {
+  using W = ArithmeticType<T>;
   assert((a & 1) == 1);
-  const T mask = (T(1) << k) - 1;
-  a &= mask;
-  T b = 1;
-  T X;
-  T result = 0;
-  for (std::size_t i = 0; i < k; ++i) {
-    X = b & 1;
-    b = (b - a * X) >> 1;
-    result |= X << i;
+
+  // Newton iteration, x is the inverse of a mod 2^p, where the precision p starts at 3 since
+  // a * a = 1 mod 8 and doubles in each step
+  W x = a;
+  for (std::size_t p = 3; p < k; p *= 2) {
+    x = static_cast<T>(x * static_cast<T>(W(2) - W(a) * x));
   }
-  return result;
+  return static_cast<T>(x & LowBitMask<T>(k));
+}
+
+// inverts the odd values[0, n) mod 2^k in place with Montgomery's trick, i.e., a single inversion
+// of the product of all values and 3 (n - 1) multiplications, prefix needs to hold n values
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+void BatchInvert(std::size_t k, T* values, std::size_t n, T* prefix) {
+  using W = ArithmeticType<T>;
+  if (n == 0) {
+    return;
+  }
+  prefix[0] = values[0];
+  for (std::size_t i = 1; i < n; ++i) {
+    prefix[i] = static_cast<T>(W(prefix[i - 1]) * values[i]);
+  }
+  W inverse = invert<T>(k, prefix[n - 1]);
+  const W mask = LowBitMask<T>(k);
+  for (std::size_t i = n - 1; i > 0; --i) {
+    const W value = values[i];
+    values[i] = static_cast<T>(inverse * prefix[i - 1] & mask);
+    inverse = static_cast<T>(inverse * value);
+  }
+  values[0] = static_cast<T>(inverse & mask);
 }
 
 template <typename T>
@@ -115,6 +131,9 @@ struct get_expanded_type<std::uint64_t> {
 template <typename T>
 using get_expanded_type_t = typename get_expanded_type<T>::type;
 
+// number of SBs whose square roots are inverted at once, see BatchInvert
+constexpr std::size_t kSbBatchSize = 1024;
+
 template <typename T>
 constexpr std::size_t GetBitSize() {
   return sizeof(T) * 8;
@@ -192,29 +211,33 @@ static void compute_sbs_phase_3(std::vector<U>& wb1, std::vector<U>& wb2, std::v
 
   constexpr U mod_mask = GetModMask<T>();
   constexpr U mod_mask_1 = mod_mask >> 1;
-  auto number_of_sbs = wb1.size();
+  const std::size_t number_of_sbs = wb1.size();
+  const std::size_t number_of_batches = (number_of_sbs + kSbBatchSize - 1) / kSbBatchSize;
+  const U offset = my_id == 0 ? 1 : 0;
+  sbs.resize(number_of_sbs);
+
+#pragma omp parallel for
+  for (std::size_t batch = 0; batch < number_of_batches; ++batch) {
+    const std::size_t begin = batch * kSbBatchSize;
+    const std::size_t size = std::min(kSbBatchSize, number_of_sbs - begin);
+    std::array<U, kSbBatchSize> prefix;
+
+    // compute c as smallest square root of a^2 mod 2^k+2
+    for (std::size_t i = begin; i < begin + size; ++i) {
+      wb2[i] = sqrt(GetBitSize<T>() + 2, U(wb2[i] & mod_mask)) & mod_mask_1;
+    }
 
-  // compute c as smallest square root of a^2 mod 2^k+2
-  std::transform(wb2.cbegin(), wb2.cend(), wb2.begin(),
-                 [mod_mask](auto asq) { return sqrt(GetBitSize<T>() + 2, U(asq & mod_mask)); });
+    // compute c^-1 mod 2^k+1 for the whole batch at once
+    BatchInvert<U>(GetBitSize<T>() + 1, wb2.data() + begin, size, prefix.data());
 
-  // compute d_i = c^-1 * a + 1 mod 2^k+1  (for party 0)
-  //         d_i = c^-1 * a     mod 2^k+1  (for all other parties)
-  if (my_id == 0) {
-    std::transform(wb1.cbegin(), wb1.cend(), wb2.cbegin(), wb1.begin(), [](U a_i, U c) {
-      return (invert<U>(GetBitSize<T>() + 1, U(c & mod_mask_1)) * a_i + 1) & mod_mask_1;
-    });
-  } else {
-    std::transform(wb1.cbegin(), wb1.cend(), wb2.cbegin(), wb1.begin(), [](auto a_i, auto c) {
-      return (invert<U>(GetBitSize<T>() + 1, U(c & mod_mask_1)) * a_i) & mod_mask_1;
-    });
+    // compute d_i = c^-1 * a + 1 mod 2^k+1  (for party 0)
+    //         d_i = c^-1 * a     mod 2^k+1  (for all other parties)
+    // and b_i = d_i / 2 as element of Z
+    for (std::size_t i = begin; i < begin + size; ++i) {
+      const U d_i = (ArithmeticType<U>(wb2[i]) * wb1[i] + offset) & mod_mask_1;
+      sbs[i] = static_cast<T>(d_i >> 1);
+    }
   }
-
-  // compute b_i = d_i / 2 as element of Z
-  sbs.clear();
-  sbs.reserve(number_of_sbs);
-  std::transform(wb1.cbegin(), wb1.cend(), std::back_inserter(sbs),
-                 [](auto& d_i) { return static_cast<T>(d_i >> 1); });
 }
 
 }  // namespace detail
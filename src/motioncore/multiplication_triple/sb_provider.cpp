@@ -40,7 +40,16 @@
 namespace encrypto::motion {
 
 bool SbProvider::NeedSbs() const noexcept {
-  return 0 < number_of_sbs_8_ + number_of_sbs_16_ + number_of_sbs_32_ + number_of_sbs_64_;
+  return 0 < GetNumberOfSbs<std::uint8_t>() + GetNumberOfSbs<std::uint16_t>() +
+                 GetNumberOfSbs<std::uint32_t>() + GetNumberOfSbs<std::uint64_t>();
+}
+
+void SbProvider::Prime(const PreprocessingPlan& plan) {
+  GetSbPool<std::uint8_t>().number_of_sbs += plan.number_of_sbs[0];
+  GetSbPool<std::uint16_t>().number_of_sbs += plan.number_of_sbs[1];
+  GetSbPool<std::uint32_t>().number_of_sbs += plan.number_of_sbs[2];
+  GetSbPool<std::uint64_t>().number_of_sbs += plan.number_of_sbs[3];
+  primed_ = true;
 }
 
 SbProvider::SbProvider(const std::size_t my_id) : my_id_(my_id) {
@@ -60,6 +69,11 @@ SbProviderFromSps::SbProviderFromSps(communication::CommunicationLayer& communic
 
 SbProviderFromSps::~SbProviderFromSps() {}
 
+void SbProviderFromSps::Prime(const PreprocessingPlan& plan) {
+  SbProvider::Prime(plan);
+  RegisterSps();
+}
+
 void SbProviderFromSps::PreSetup() {
   if (!NeedSbs()) {
     return;
@@ -70,7 +84,10 @@ void SbProviderFromSps::PreSetup() {
   }
   run_time_statistics_.RecordStart<RunTimeStatistics::StatisticsId::kSbPresetup>();
 
-  RegisterSps();
+  // the SPs of a primed provider are already registered
+  if (!primed_) {
+    RegisterSps();
+  }
   RegisterForMessages();
 
   run_time_statistics_.RecordEnd<RunTimeStatistics::StatisticsId::kSbPresetup>();
@@ -106,10 +123,14 @@ void SbProviderFromSps::Setup() {
 }
 
 void SbProviderFromSps::RegisterSps() {
-  offset_sps_16_ = sp_provider_->RequestSps<uint16_t>(number_of_sbs_8_);
-  offset_sps_32_ = sp_provider_->RequestSps<uint32_t>(number_of_sbs_16_);
-  offset_sps_64_ = sp_provider_->RequestSps<uint64_t>(number_of_sbs_32_);
-  offset_sps_128_ = sp_provider_->RequestSps<__uint128_t>(number_of_sbs_64_);
+  const auto number_of_sbs_8{GetNumberOfSbs<std::uint8_t>()};
+  const auto number_of_sbs_16{GetNumberOfSbs<std::uint16_t>()};
+  const auto number_of_sbs_32{GetNumberOfSbs<std::uint32_t>()};
+  const auto number_of_sbs_64{GetNumberOfSbs<std::uint64_t>()};
+  offset_sps_16_ = sp_provider_->RequestSps<uint16_t>(number_of_sbs_8);
+  offset_sps_32_ = sp_provider_->RequestSps<uint32_t>(number_of_sbs_16);
+  offset_sps_64_ = sp_provider_->RequestSps<uint64_t>(number_of_sbs_32);
+  offset_sps_128_ = sp_provider_->RequestSps<__uint128_t>(number_of_sbs_64);
 }
 
 void SbProviderFromSps::RegisterForMessages() {
@@ -146,11 +167,9 @@ static std::vector<std::uint8_t> Gather(const std::vector<std::uint16_t>& ds_8,
   return buffer;
 }
 
-static std::vector<std::uint8_t> Scatter(std::vector<std::uint16_t>& ds_8,
-                                         std::vector<std::uint32_t>& ds_16,
-                                         std::vector<std::uint64_t>& ds_32,
-                                         std::vector<__uint128_t>& ds_64,
-                                         const std::vector<std::uint8_t>& buffer) {
+static void Scatter(std::vector<std::uint16_t>& ds_8, std::vector<std::uint32_t>& ds_16,
+                    std::vector<std::uint64_t>& ds_32, std::vector<__uint128_t>& ds_64,
+                    const communication::MessageBuffer& buffer) {
   auto size_8 = GetByteSize(ds_8);
   auto size_16 = GetByteSize(ds_16);
   auto size_32 = GetByteSize(ds_32);
@@ -169,7 +188,6 @@ static std::vector<std::uint8_t> Scatter(std::vector<std::uint16_t>& ds_8,
   std::copy(start_16, start_16 + ds_16.size(), ds_16.begin());
   std::copy(start_32, start_32 + ds_32.size(), ds_32.begin());
   std::copy(start_64, start_64 + ds_64.size(), ds_64.begin());
-  return buffer;
 }
 
 // reconstruct all the shared values packed into one message
@@ -178,7 +196,7 @@ static void ReconstructionHelper(
     std::vector<std::uint64_t>& xs_32, std::vector<__uint128_t>& xs_64,
     std::size_t number_of_parties,
     std::function<void(const std::vector<uint8_t>&)> broadcast_function,
-    std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>>& futures) {
+    std::vector<ReusableFiberFuture<communication::MessageBuffer>>& futures) {
   // Gather all shared in a single buffer
   auto xs = Gather(xs_8, xs_16, xs_32, xs_64);
 
@@ -192,13 +210,13 @@ static void ReconstructionHelper(
   broadcast_function(xs);
 
   // collect the other shares
-  std::vector<std::vector<std::uint8_t>> received_xs;
+  std::vector<communication::MessageBuffer> received_xs;
   received_xs.reserve(number_of_parties - 1);
   std::transform(futures.begin(), futures.end(), std::back_inserter(received_xs), [](auto& f) {
     if (f.valid())
       return f.get();
     else
-      return std::vector<std::uint8_t>();
+      return communication::MessageBuffer();
   });
 
   // reconstruct the xs
@@ -221,10 +239,18 @@ static void ReconstructionHelper(
 }
 
 void SbProviderFromSps::ComputeSbs() noexcept {
-  auto sps_16 = sp_provider_->GetSps<std::uint16_t>(offset_sps_16_, number_of_sbs_8_);
-  auto sps_32 = sp_provider_->GetSps<std::uint32_t>(offset_sps_32_, number_of_sbs_16_);
-  auto sps_64 = sp_provider_->GetSps<std::uint64_t>(offset_sps_64_, number_of_sbs_32_);
-  auto sps_128 = sp_provider_->GetSps<__uint128_t>(offset_sps_128_, number_of_sbs_64_);
+  const auto number_of_sbs_8{GetNumberOfSbs<std::uint8_t>()};
+  const auto number_of_sbs_16{GetNumberOfSbs<std::uint16_t>()};
+  const auto number_of_sbs_32{GetNumberOfSbs<std::uint32_t>()};
+  const auto number_of_sbs_64{GetNumberOfSbs<std::uint64_t>()};
+  auto& sbs_8{GetSbPool<std::uint8_t>().sbs};
+  auto& sbs_16{GetSbPool<std::uint16_t>().sbs};
+  auto& sbs_32{GetSbPool<std::uint32_t>().sbs};
+  auto& sbs_64{GetSbPool<std::uint64_t>().sbs};
+  auto sps_16 = sp_provider_->GetSps<std::uint16_t>(offset_sps_16_, number_of_sbs_8);
+  auto sps_32 = sp_provider_->GetSps<std::uint32_t>(offset_sps_32_, number_of_sbs_16);
+  auto sps_64 = sp_provider_->GetSps<std::uint64_t>(offset_sps_64_, number_of_sbs_32);
+  auto sps_128 = sp_provider_->GetSps<__uint128_t>(offset_sps_128_, number_of_sbs_64);
 
   auto broadcast_mask = [this](const auto& buffer) {
     auto msg{communication::BuildMessage(communication::MessageType::kSharedBitsMask, buffer)};
@@ -237,13 +263,13 @@ void SbProviderFromSps::ComputeSbs() noexcept {
     communication_layer_.BroadcastMessage(msg.Release());
   };
 
-  auto [wb1_8, wb2_8] = detail::compute_sbs_phase_1<std::uint8_t>(number_of_sbs_8_, my_id_, sps_16);
+  auto [wb1_8, wb2_8] = detail::compute_sbs_phase_1<std::uint8_t>(number_of_sbs_8, my_id_, sps_16);
   auto [wb1_16, wb2_16] =
-      detail::compute_sbs_phase_1<std::uint16_t>(number_of_sbs_16_, my_id_, sps_32);
+      detail::compute_sbs_phase_1<std::uint16_t>(number_of_sbs_16, my_id_, sps_32);
   auto [wb1_32, wb2_32] =
-      detail::compute_sbs_phase_1<std::uint32_t>(number_of_sbs_32_, my_id_, sps_64);
+      detail::compute_sbs_phase_1<std::uint32_t>(number_of_sbs_32, my_id_, sps_64);
   auto [wb1_64, wb2_64] =
-      detail::compute_sbs_phase_1<std::uint64_t>(number_of_sbs_64_, my_id_, sps_128);
+      detail::compute_sbs_phase_1<std::uint64_t>(number_of_sbs_64, my_id_, sps_128);
   ReconstructionHelper(wb2_8, wb2_16, wb2_32, wb2_64, number_of_parties_, broadcast_mask,
                        mask_message_futures_);
   detail::compute_sbs_phase_2<std::uint8_t>(wb1_8, wb2_8, my_id_, sps_16);
@@ -252,10 +278,10 @@ void SbProviderFromSps::ComputeSbs() noexcept {
   detail::compute_sbs_phase_2<std::uint64_t>(wb1_64, wb2_64, my_id_, sps_128);
   ReconstructionHelper(wb2_8, wb2_16, wb2_32, wb2_64, number_of_parties_, broadcast_reconstruct,
                        reconstruct_message_futures_);
-  detail::compute_sbs_phase_3<std::uint8_t>(wb1_8, wb2_8, sbs_8_, my_id_);
-  detail::compute_sbs_phase_3<std::uint16_t>(wb1_16, wb2_16, sbs_16_, my_id_);
-  detail::compute_sbs_phase_3<std::uint32_t>(wb1_32, wb2_32, sbs_32_, my_id_);
-  detail::compute_sbs_phase_3<std::uint64_t>(wb1_64, wb2_64, sbs_64_, my_id_);
+  detail::compute_sbs_phase_3<std::uint8_t>(wb1_8, wb2_8, sbs_8, my_id_);
+  detail::compute_sbs_phase_3<std::uint16_t>(wb1_16, wb2_16, sbs_16, my_id_);
+  detail::compute_sbs_phase_3<std::uint32_t>(wb1_32, wb2_32, sbs_32, my_id_);
+  detail::compute_sbs_phase_3<std::uint64_t>(wb1_64, wb2_64, sbs_64, my_id_);
 }
 
 }  // namespace encrypto::motion
@@ -26,10 +26,14 @@
 
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <type_traits>
 #include <vector>
 
+#include "communication/message_buffer.h"
+#include "data_storage/preprocessing_plan.h"
 #include "utility/fiber_condition.h"
+#include "utility/meta.hpp"
 #include "utility/reusable_future.h"
 
 namespace encrypto::motion::communication {
@@ -45,6 +49,15 @@ class SpProvider;
 struct RunTimeStatistics;
 struct SharedBitsData;
 
+// All SBs of one bit length and their number, which is known before they are generated
+template <typename T>
+struct SbPool {
+  std::size_t number_of_sbs{0};
+  // less than number_of_sbs if the provider was primed with a PreprocessingPlan
+  std::size_t number_of_requested_sbs{0};
+  std::vector<T> sbs;
+};
+
 // Provider for Shared Bits (SBs),
 // sharings of a random bit 0 or 1 in Z/2^kZ
 class SbProvider {
@@ -53,70 +66,40 @@ class SbProvider {
 
   template <typename T>
   std::size_t GetNumberOfSbs() const noexcept {
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return number_of_sbs_8_;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return number_of_sbs_16_;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return number_of_sbs_32_;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return number_of_sbs_64_;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetSbPool<T>().number_of_sbs;
   }
 
+  // throws std::logic_error if the provider was primed with a plan which does not cover the SBs
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
-  std::size_t RequestSbs(const std::size_t number_of_sbs) noexcept {
-    std::size_t offset;
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      offset = number_of_sbs_8_;
-      number_of_sbs_8_ += number_of_sbs;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      offset = number_of_sbs_16_;
-      number_of_sbs_16_ += number_of_sbs;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      offset = number_of_sbs_32_;
-      number_of_sbs_32_ += number_of_sbs;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      offset = number_of_sbs_64_;
-      number_of_sbs_64_ += number_of_sbs;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
-    return offset;
+  std::size_t RequestSbs(const std::size_t number_of_sbs) {
+    auto& pool = GetSbPool<T>();
+    return RequestPlannedElements(pool.number_of_requested_sbs, pool.number_of_sbs, number_of_sbs,
+                                  primed_, "SBs");
   }
 
+  // Reserves the SBs of the plan in addition to the ones requested so far, after which requests
+  // need to fit into the reserved SBs (see PreprocessingPlan)
+  virtual void Prime(const PreprocessingPlan& plan);
+
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   std::vector<T> GetSbs(const std::size_t offset, const std::size_t n = 1) {
     WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return GetSbs(sbs_8_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return GetSbs(sbs_16_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return GetSbs(sbs_32_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return GetSbs(sbs_64_, offset, n);
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetSbs(GetSbPool<T>().sbs, offset, n);
+  }
+
+  // view of the SBs [offset, offset + n), which unlike GetSbs does not copy them
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  std::span<const T> GetSbsView(const std::size_t offset, const std::size_t n) {
+    WaitFinished();
+    const auto& sbs{GetSbPool<T>().sbs};
+    assert(offset + n <= sbs.size());
+    return std::span<const T>(sbs.data() + offset, n);
   }
 
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   const std::vector<T>& GetSbsAll() noexcept {
     WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return sbs_8_;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return sbs_16_;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return sbs_32_;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return sbs_64_;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetSbPool<T>().sbs;
   }
 
   virtual void PreSetup() = 0;
@@ -129,12 +112,19 @@ class SbProvider {
   SbProvider(const std::size_t my_id);
   SbProvider() = delete;
 
-  std::size_t number_of_sbs_8_{0}, number_of_sbs_16_{0}, number_of_sbs_32_{0}, number_of_sbs_64_{0};
+  template <typename T>
+  SbPool<T>& GetSbPool() noexcept {
+    return sb_pools_[boost::hana::type_c<T>];
+  }
 
-  std::vector<std::uint8_t> sbs_8_;
-  std::vector<std::uint16_t> sbs_16_;
-  std::vector<std::uint32_t> sbs_32_;
-  std::vector<std::uint64_t> sbs_64_;
+  template <typename T>
+  const SbPool<T>& GetSbPool() const noexcept {
+    return sb_pools_[boost::hana::type_c<T>];
+  }
+
+  // SBs of k bit are computed from SPs of 2k bit, so there are no 128 bit SBs
+  TypeMap<SbPool, std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t> sb_pools_;
+  bool primed_{false};
 
   const std::size_t my_id_;
 
@@ -157,6 +147,9 @@ class SbProviderFromSps final : public SbProvider {
                     RunTimeStatistics& run_time_statistics);
   ~SbProviderFromSps();
 
+  // also requests the SPs for all SBs, so the SP provider needs to be primed afterwards
+  void Prime(const PreprocessingPlan& plan) final override;
+
   void PreSetup() final override;
 
   // needs completed SPs
@@ -178,8 +171,8 @@ class SbProviderFromSps final : public SbProvider {
   std::size_t offset_sps_64_;
   std::size_t offset_sps_128_;
 
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> mask_message_futures_;
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> reconstruct_message_futures_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> mask_message_futures_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> reconstruct_message_futures_;
 
   const std::size_t kMaxBatchSize{10'000};
 
@@ -23,6 +23,7 @@
 // SOFTWARE.
 
 #include "sp_provider.h"
+#include "base/third_party_dealer.h"
 #include "oblivious_transfer/ot_provider.h"
 #include "statistics/run_time_statistics.h"
 #include "utility/constants.h"
@@ -31,8 +32,16 @@
 namespace encrypto::motion {
 
 bool SpProvider::NeedSps() const noexcept {
-  return 0 < number_of_sps_8_ + number_of_sps_16_ + number_of_sps_32_ + number_of_sps_64_ +
-                 number_of_sps_128_;
+  bool need_sps = false;
+  ForEachSpPool([&need_sps](auto, const auto& pool) { need_sps |= pool.number_of_sps > 0; });
+  return need_sps;
+}
+
+void SpProvider::Prime(const PreprocessingPlan& plan) {
+  ForEachSpPool([&plan](auto type, auto& pool) {
+    pool.number_of_sps += plan.number_of_sps[PreprocessingPlan::GetTypeIndex<decltype(type)>()];
+  });
+  primed_ = true;
 }
 
 SpProvider::SpProvider(const std::size_t my_id) : my_id_(my_id) {
@@ -44,18 +53,13 @@ SpProviderFromOts::SpProviderFromOts(std::vector<std::unique_ptr<OtProvider>>& o
                                      RunTimeStatistics& run_time_statistics)
     : SpProvider(my_id),
       ot_providers_(ot_providers),
-      ots_receiver_8_(ot_providers_.size()),
-      ots_sender_8_(ot_providers_.size()),
-      ots_receiver_16_(ot_providers_.size()),
-      ots_sender_16_(ot_providers_.size()),
-      ots_receiver_32_(ot_providers_.size()),
-      ots_sender_32_(ot_providers_.size()),
-      ots_receiver_64_(ot_providers_.size()),
-      ots_sender_64_(ot_providers_.size()),
-      ots_receiver_128_(ot_providers_.size()),
-      ots_sender_128_(ot_providers_.size()),
       logger_(logger),
-      run_time_statistics_(run_time_statistics) {}
+      run_time_statistics_(run_time_statistics) {
+  boost::hana::for_each(boost::hana::keys(ots_), [this](auto type) {
+    ots_[type].receiver.resize(ot_providers_.size());
+    ots_[type].sender.resize(ot_providers_.size());
+  });
+}
 
 void SpProviderFromOts::PreSetup() {
   if (!NeedSps()) {
@@ -90,26 +94,13 @@ void SpProviderFromOts::Setup() {
     if (i == my_id_) {
       continue;
     }
-    for (auto& ot : ots_sender_8_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint8_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_8_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_16_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint16_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_16_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_32_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint32_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_32_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_64_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint64_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_64_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_128_.at(i)) {
-      dynamic_cast<AcOtSender<__uint128_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_128_.at(i)) ot->SendCorrections();
+    boost::hana::for_each(boost::hana::keys(ots_), [this, i](auto type) {
+      using T = typename decltype(type)::type;
+      for (auto& ot : ots_[type].sender.at(i)) {
+        dynamic_cast<AcOtSender<T>*>(ot.get())->SendMessages();
+      }
+      for (auto& ot : ots_[type].receiver.at(i)) ot->SendCorrections();
+    });
   }
 
   ParseOutputs();
@@ -184,11 +175,7 @@ static void RegisterHelperReceptor(OtProvider& ot_provider,
 }
 
 void SpProviderFromOts::RegisterOts() {
-  GenerateRandomPairs<std::uint8_t>(sps_8_, number_of_sps_8_);
-  GenerateRandomPairs<std::uint16_t>(sps_16_, number_of_sps_16_);
-  GenerateRandomPairs<std::uint32_t>(sps_32_, number_of_sps_32_);
-  GenerateRandomPairs<std::uint64_t>(sps_64_, number_of_sps_64_);
-  GenerateRandomPairs<__uint128_t>(sps_128_, number_of_sps_128_);
+  ForEachSpPool([](auto, auto& pool) { GenerateRandomPairs(pool.sps, pool.number_of_sps); });
 
 #pragma omp parallel for num_threads(ot_providers_.size())
   for (std::size_t i = 0; i < ot_providers_.size(); ++i) {
@@ -196,29 +183,17 @@ void SpProviderFromOts::RegisterOts() {
       continue;
     }
 
-    if (i < my_id_) {
-      RegisterHelperSend<std::uint8_t>(*ot_providers_.at(i), ots_sender_8_.at(i), kMaxBatchSize,
-                                       sps_8_, number_of_sps_8_);
-      RegisterHelperSend<std::uint16_t>(*ot_providers_.at(i), ots_sender_16_.at(i), kMaxBatchSize,
-                                        sps_16_, number_of_sps_16_);
-      RegisterHelperSend<std::uint32_t>(*ot_providers_.at(i), ots_sender_32_.at(i), kMaxBatchSize,
-                                        sps_32_, number_of_sps_32_);
-      RegisterHelperSend<std::uint64_t>(*ot_providers_.at(i), ots_sender_64_.at(i), kMaxBatchSize,
-                                        sps_64_, number_of_sps_64_);
-      RegisterHelperSend<__uint128_t>(*ot_providers_.at(i), ots_sender_128_.at(i), kMaxBatchSize,
-                                      sps_128_, number_of_sps_128_);
-    } else if (i > my_id_) {
-      RegisterHelperReceptor<std::uint8_t>(*ot_providers_.at(i), ots_receiver_8_.at(i),
-                                           kMaxBatchSize, sps_8_, number_of_sps_8_);
-      RegisterHelperReceptor<std::uint16_t>(*ot_providers_.at(i), ots_receiver_16_.at(i),
-                                            kMaxBatchSize, sps_16_, number_of_sps_16_);
-      RegisterHelperReceptor<std::uint32_t>(*ot_providers_.at(i), ots_receiver_32_.at(i),
-                                            kMaxBatchSize, sps_32_, number_of_sps_32_);
-      RegisterHelperReceptor<std::uint64_t>(*ot_providers_.at(i), ots_receiver_64_.at(i),
-                                            kMaxBatchSize, sps_64_, number_of_sps_64_);
-      RegisterHelperReceptor<__uint128_t>(*ot_providers_.at(i), ots_receiver_128_.at(i),
-                                          kMaxBatchSize, sps_128_, number_of_sps_128_);
-    }
+    ForEachSpPool([this, i](auto type, const auto& pool) {
+      using T = decltype(type);
+      auto& ots = ots_[boost::hana::type_c<T>];
+      if (i < my_id_) {
+        RegisterHelperSend<T>(*ot_providers_.at(i), ots.sender.at(i), kMaxBatchSize, pool.sps,
+                              pool.number_of_sps);
+      } else {
+        RegisterHelperReceptor<T>(*ot_providers_.at(i), ots.receiver.at(i), kMaxBatchSize, pool.sps,
+                                  pool.number_of_sps);
+      }
+    });
   }
 }
 
@@ -270,29 +245,37 @@ void SpProviderFromOts::ParseOutputs() {
       continue;
     }
 
-    if (i < my_id_) {
-      ParseHelperSend<std::uint8_t>(ots_sender_8_.at(i), kMaxBatchSize, sps_8_, number_of_sps_8_);
-      ParseHelperSend<std::uint16_t>(ots_sender_16_.at(i), kMaxBatchSize, sps_16_,
-                                     number_of_sps_16_);
-      ParseHelperSend<std::uint32_t>(ots_sender_32_.at(i), kMaxBatchSize, sps_32_,
-                                     number_of_sps_32_);
-      ParseHelperSend<std::uint64_t>(ots_sender_64_.at(i), kMaxBatchSize, sps_64_,
-                                     number_of_sps_64_);
-      ParseHelperSend<__uint128_t>(ots_sender_128_.at(i), kMaxBatchSize, sps_128_,
-                                   number_of_sps_128_);
-    } else if (i > my_id_) {
-      ParseHelperReceive<std::uint8_t>(ots_receiver_8_.at(i), kMaxBatchSize, sps_8_,
-                                       number_of_sps_8_);
-      ParseHelperReceive<std::uint16_t>(ots_receiver_16_.at(i), kMaxBatchSize, sps_16_,
-                                        number_of_sps_16_);
-      ParseHelperReceive<std::uint32_t>(ots_receiver_32_.at(i), kMaxBatchSize, sps_32_,
-                                        number_of_sps_32_);
-      ParseHelperReceive<std::uint64_t>(ots_receiver_64_.at(i), kMaxBatchSize, sps_64_,
-                                        number_of_sps_64_);
-      ParseHelperReceive<__uint128_t>(ots_receiver_128_.at(i), kMaxBatchSize, sps_128_,
-                                      number_of_sps_128_);
-    }
+    ForEachSpPool([this, i](auto type, auto& pool) {
+      using T = decltype(type);
+      auto& ots = ots_[boost::hana::type_c<T>];
+      if (i < my_id_) {
+        ParseHelperSend<T>(ots.sender.at(i), kMaxBatchSize, pool.sps, pool.number_of_sps);
+      } else {
+        ParseHelperReceive<T>(ots.receiver.at(i), kMaxBatchSize, pool.sps, pool.number_of_sps);
+      }
+    });
   }
 }
 
+SpProviderFromThirdParty::SpProviderFromThirdParty(std::shared_ptr<ThirdPartyDealerClient> client)
+    : SpProvider(client->GetMyId()), client_(std::move(client)) {}
+
+void SpProviderFromThirdParty::PreSetup() { client_->RequestSps(*this); }
+
+void SpProviderFromThirdParty::Setup() {
+  if (!NeedSps()) {
+    return;
+  }
+
+  auto& material{client_->GetMaterial()};
+  ForEachSpPool([&material](auto type, auto& pool) {
+    pool.sps = std::move(material.GetSps<decltype(type)>());
+  });
+  {
+    std::scoped_lock lock(finished_condition_->GetMutex());
+    finished_ = true;
+  }
+  finished_condition_->NotifyAll();
+}
+
 }  // namespace encrypto::motion
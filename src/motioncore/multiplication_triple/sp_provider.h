@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -31,8 +32,13 @@
 #include <type_traits>
 #include <vector>
 
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/keys.hpp>
+
+#include "data_storage/preprocessing_plan.h"
 #include "oblivious_transfer/ot_flavors.h"
 #include "utility/fiber_condition.h"
+#include "utility/meta.hpp"
 
 namespace encrypto::motion {
 
@@ -41,12 +47,29 @@ class OtVectorSender;
 class OtVectorReceiver;
 struct RunTimeStatistics;
 class Logger;
+class ThirdPartyDealerClient;
 
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 struct SpVector {
   std::vector<T> a, c;  // c[i] = a[i]^2
 };
 
+// All SPs of one bit length and their number, which is known before they are generated
+template <typename T>
+struct SpPool {
+  std::size_t number_of_sps{0};
+  // less than number_of_sps if the provider was primed with a PreprocessingPlan
+  std::size_t number_of_requested_sps{0};
+  SpVector<T> sps;
+};
+
+// The OTs for the SPs of one bit length, indexed by the other party
+template <typename T>
+struct SpOts {
+  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> receiver;
+  std::vector<std::list<std::unique_ptr<BasicOtSender>>> sender;
+};
+
 // Provider for Square Pairs (SPs),
 // sharings of random (a, c) s.t. a^2 = c
 class SpProvider {
@@ -57,79 +80,31 @@ class SpProvider {
 
   template <typename T>
   std::size_t GetNumberOfSps() const noexcept {
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return number_of_sps_8_;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return number_of_sps_16_;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return number_of_sps_32_;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return number_of_sps_64_;
-    } else if constexpr (std::is_same_v<T, __uint128_t>) {
-      return number_of_sps_128_;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetSpPool<T>().number_of_sps;
   }
 
+  // throws std::logic_error if the provider was primed with a plan which does not cover the SPs
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
-  std::size_t RequestSps(const std::size_t number_of_sps) noexcept {
-    std::size_t offset;
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      offset = number_of_sps_8_;
-      number_of_sps_8_ += number_of_sps;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      offset = number_of_sps_16_;
-      number_of_sps_16_ += number_of_sps;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      offset = number_of_sps_32_;
-      number_of_sps_32_ += number_of_sps;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      offset = number_of_sps_64_;
-      number_of_sps_64_ += number_of_sps;
-    } else if constexpr (std::is_same_v<T, __uint128_t>) {
-      offset = number_of_sps_128_;
-      number_of_sps_128_ += number_of_sps;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
-    return offset;
+  std::size_t RequestSps(const std::size_t number_of_sps) {
+    auto& pool = GetSpPool<T>();
+    return RequestPlannedElements(pool.number_of_requested_sps, pool.number_of_sps, number_of_sps,
+                                  primed_, "SPs");
   }
 
+  // Reserves the SPs of the plan in addition to the ones requested so far, after which requests
+  // need to fit into the reserved SPs (see PreprocessingPlan)
+  void Prime(const PreprocessingPlan& plan);
+
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   SpVector<T> GetSps(const std::size_t offset, const std::size_t n = 1) {
     WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return GetSps(sps_8_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return GetSps(sps_16_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return GetSps(sps_32_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return GetSps(sps_64_, offset, n);
-    } else if constexpr (std::is_same_v<T, __uint128_t>) {
-      return GetSps(sps_128_, offset, n);
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetSps(GetSpPool<T>().sps, offset, n);
   }
 
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   const SpVector<T>& GetSpsAll() noexcept {
     WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return sps_8_;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return sps_16_;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return sps_32_;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return sps_64_;
-    } else if constexpr (std::is_same_v<T, __uint128_t>) {
-      return sps_128_;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetSpPool<T>().sps;
   }
 
   virtual void PreSetup() = 0;
@@ -142,14 +117,35 @@ class SpProvider {
   SpProvider(const std::size_t my_id);
   SpProvider() = delete;
 
-  std::size_t number_of_sps_8_{0}, number_of_sps_16_{0}, number_of_sps_32_{0}, number_of_sps_64_{0},
-      number_of_sps_128_{0};
+  template <typename T>
+  SpPool<T>& GetSpPool() noexcept {
+    return sp_pools_[boost::hana::type_c<T>];
+  }
+
+  template <typename T>
+  const SpPool<T>& GetSpPool() const noexcept {
+    return sp_pools_[boost::hana::type_c<T>];
+  }
+
+  // calls f(T{}, GetSpPool<T>()) for all bit lengths T in ascending order
+  template <typename F>
+  void ForEachSpPool(F&& f) {
+    boost::hana::for_each(boost::hana::keys(sp_pools_), [this, &f](auto type) {
+      using T = typename decltype(type)::type;
+      f(T{}, GetSpPool<T>());
+    });
+  }
+
+  template <typename F>
+  void ForEachSpPool(F&& f) const {
+    boost::hana::for_each(boost::hana::keys(sp_pools_), [this, &f](auto type) {
+      using T = typename decltype(type)::type;
+      f(T{}, GetSpPool<T>());
+    });
+  }
 
-  SpVector<std::uint8_t> sps_8_;
-  SpVector<std::uint16_t> sps_16_;
-  SpVector<std::uint32_t> sps_32_;
-  SpVector<std::uint64_t> sps_64_;
-  SpVector<__uint128_t> sps_128_;
+  IntegerTypeMap<SpPool> sp_pools_;
+  bool primed_{false};
 
   const std::size_t my_id_;
 
@@ -186,25 +182,27 @@ class SpProviderFromOts final : public SpProvider {
   std::vector<std::unique_ptr<OtProvider>>& ot_providers_;
 
   // use alternating party roles for load balancing
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_8_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_8_;
+  IntegerTypeMap<SpOts> ots_;
 
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_16_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_16_;
+  const std::size_t kMaxBatchSize{10'000};
 
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_32_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_32_;
+  std::shared_ptr<Logger> logger_;
+  RunTimeStatistics& run_time_statistics_;
+};
 
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_64_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_64_;
+// Provider which obtains the SPs from a ThirdPartyDealer
+class SpProviderFromThirdParty final : public SpProvider {
+ public:
+  SpProviderFromThirdParty(std::shared_ptr<ThirdPartyDealerClient> client);
 
-  std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_128_;
-  std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_128_;
+  // registers the SPs with the client
+  void PreSetup() final override;
 
-  const std::size_t kMaxBatchSize{10'000};
+  // needs a completed ThirdPartyDealerClient::Exchange
+  void Setup() final override;
 
-  std::shared_ptr<Logger> logger_;
-  RunTimeStatistics& run_time_statistics_;
+ private:
+  std::shared_ptr<ThirdPartyDealerClient> client_;
 };
 
 }  // namespace encrypto::motion
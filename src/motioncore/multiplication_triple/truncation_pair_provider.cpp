@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "truncation_pair_provider.h"
+
+#include <fmt/format.h>
+#include <stdexcept>
+
+#include "sb_provider.h"
+
+namespace encrypto::motion {
+
+template <typename T, typename>
+std::size_t TruncationPairProvider::RequestTruncationPairs(std::size_t number_of_pairs) {
+  // the pairs are indexed by their first SB
+  return sb_provider_.template RequestSbs<T>(number_of_pairs * sizeof(T) * 8);
+}
+
+template <typename T, typename>
+TruncationPairs<T> TruncationPairProvider::GetTruncationPairs(
+    std::size_t offset, std::size_t number_of_pairs, std::size_t number_of_fractional_bits) {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  if (number_of_fractional_bits + 1 >= kBitLength) {
+    throw std::invalid_argument(fmt::format("Cannot truncate {} of {} bits with truncation pairs",
+                                            number_of_fractional_bits, kBitLength));
+  }
+  const auto sbs{sb_provider_.template GetSbsView<T>(offset, number_of_pairs * kBitLength)};
+  TruncationPairs<T> pairs{std::vector<T>(number_of_pairs), std::vector<T>(number_of_pairs),
+                           std::vector<T>(number_of_pairs)};
+  for (std::size_t i = 0; i < number_of_pairs; ++i) {
+    const T* bits{sbs.data() + i * kBitLength};
+    T r{0}, truncated_r{0};
+    for (std::size_t j = 0; j + 1 < kBitLength; ++j) {
+      r += bits[j] << j;
+      if (j >= number_of_fractional_bits) truncated_r += bits[j] << (j - number_of_fractional_bits);
+    }
+    pairs.msb_of_r[i] = bits[kBitLength - 1];
+    pairs.r[i] = r + (bits[kBitLength - 1] << (kBitLength - 1));
+    pairs.truncated_r[i] = truncated_r;
+  }
+  return pairs;
+}
+
+// SBs only exist for up to 64 bit
+template std::size_t TruncationPairProvider::RequestTruncationPairs<std::uint8_t>(std::size_t);
+template std::size_t TruncationPairProvider::RequestTruncationPairs<std::uint16_t>(std::size_t);
+template std::size_t TruncationPairProvider::RequestTruncationPairs<std::uint32_t>(std::size_t);
+template std::size_t TruncationPairProvider::RequestTruncationPairs<std::uint64_t>(std::size_t);
+
+template TruncationPairs<std::uint8_t> TruncationPairProvider::GetTruncationPairs<std::uint8_t>(
+    std::size_t, std::size_t, std::size_t);
+template TruncationPairs<std::uint16_t> TruncationPairProvider::GetTruncationPairs<std::uint16_t>(
+    std::size_t, std::size_t, std::size_t);
+template TruncationPairs<std::uint32_t> TruncationPairProvider::GetTruncationPairs<std::uint32_t>(
+    std::size_t, std::size_t, std::size_t);
+template TruncationPairs<std::uint64_t> TruncationPairProvider::GetTruncationPairs<std::uint64_t>(
+    std::size_t, std::size_t, std::size_t);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace encrypto::motion {
+
+class SbProvider;
+
+// Shares of a random r in Z/2^kZ for the probabilistic truncation of an arithmetic GMW share by f
+// bits, see arithmetic_gmw::TruncationGate
+template <typename T>
+struct TruncationPairs {
+  std::vector<T> r;
+  // the lower k - 1 bits of r shifted right by f bits
+  std::vector<T> truncated_r;
+  // the most significant bit of r
+  std::vector<T> msb_of_r;
+};
+
+// Provider for truncation pairs, which are composed locally from the k shared bits of r, such
+// that they cost k SBs and no communication in addition to the SBs
+class TruncationPairProvider {
+ public:
+  TruncationPairProvider(SbProvider& sb_provider) : sb_provider_(sb_provider) {}
+
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  std::size_t RequestTruncationPairs(std::size_t number_of_pairs);
+
+  // waits for the SBs and composes the pairs [offset, offset + number_of_pairs) for the truncation
+  // by number_of_fractional_bits < k - 1 bits
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  TruncationPairs<T> GetTruncationPairs(std::size_t offset, std::size_t number_of_pairs,
+                                        std::size_t number_of_fractional_bits);
+
+ private:
+  SbProvider& sb_provider_;
+};
+
+}  // namespace encrypto::motion
@@ -26,6 +26,7 @@
 
 #include <span>
 
+#include "communication/message_buffer.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
 #include "utility/reusable_future.h"
@@ -46,7 +47,7 @@ class BasicKk13OtSender : public Kk13OtVector {
   Kk13OtExtensionData& data_;
 
   // future for the message containing client's corrections
-  ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // class capturing the common things among the receiver implementations
@@ -96,7 +97,7 @@ class BasicKk13OtReceiver : public Kk13OtVector {
   bool corrections_sent_ = false;
 
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 };
 
 // sender implementation of batched xor-correlated bit ots
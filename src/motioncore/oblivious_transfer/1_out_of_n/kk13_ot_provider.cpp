@@ -149,8 +149,10 @@ void Kk13OtProviderFromKk13OtExtension::SendSetup() {
   // index variable
   std::size_t i;
 
-  // security parameter
-  constexpr std::size_t kKappa_accent = 2 * kKappa;
+  // length of the code words and number of base OTs
+  const std::size_t kappa_accent{data_.code_bit_length};
+  // bounded by the code length and by the random choices of the receiver, which are bytes
+  const std::size_t max_number_of_messages_per_ot{std::min<std::size_t>(kappa_accent, 256)};
 
   // storage for sender and base OT receiver data
   const auto& base_ots_receiver_data =
@@ -176,17 +178,14 @@ void Kk13OtProviderFromKk13OtExtension::SendSetup() {
     if (number_of_messages[i] < 2) {
       throw std::runtime_error(
           fmt::format("Number of message {} must be at least 2", number_of_messages[i]));
-    } else if (number_of_messages[i] > kKappa_accent) {
+    } else if (number_of_messages[i] > max_number_of_messages_per_ot) {
       throw std::runtime_error(fmt::format("Number of message {} must be less than {}",
-                                           number_of_messages[i], kKappa_accent));
+                                           number_of_messages[i], max_number_of_messages_per_ot));
     }
   }
 
-  // bit size of the matrix rounded to bytes
-  const std::size_t byte_size = BitsToBytes(bit_size);
-
   // bit size rounded to blocks
-  const auto bit_size_padded = bit_size + kKappa_accent - (bit_size % kKappa_accent);
+  const auto bit_size_padded = bit_size + kappa_accent - (bit_size % kappa_accent);
 
   // generate X(a)
   std::vector<std::size_t> message_number(max_number_of_messages);
@@ -208,27 +207,26 @@ void Kk13OtProviderFromKk13OtExtension::SendSetup() {
   prg_mask.SetKey(key.data());
 
   auto x_a = MaskFunction(prg_mask, message_number, max_number_of_messages, max_number_of_messages,
-                          kKappa_accent);
+                          kappa_accent);
 
   // vector containing the matrix rows
-  std::vector<AlignedBitVector> v(kKappa_accent);
+  std::vector<AlignedBitVector> v(kappa_accent);
 
   // PRG which is used to expand the keys we got from the base OTs
   primitives::Prg prgs_variable_key;
   // fill the rows of the matrix
-  for (i = 0; i < kKappa_accent; ++i) {
+  for (i = 0; i < kappa_accent; ++i) {
     // use the key we got from the base OTs as seed
     prgs_variable_key.SetKey(base_ots_receiver_data.messages_c[data_.base_ot_offset + i].data());
     // change the offset in the output stream since we might have already used
     // the same base OTs previously
     prgs_variable_key.SetOffset(data_.base_ot_offset);
     // expand the seed such that it fills one row of the matrix
-    auto row(prgs_variable_key.Encrypt(byte_size));
-    v[i] = AlignedBitVector(std::move(row), bit_size);
+    v[i] = prgs_variable_key.KeyStreamBits<AlignedAllocator>(bit_size);
   }
 
   // receive the vectors u one by one from the receiver and xor them to the expanded keys
-  for (i = 0; i < data_.sender_data.u_futures.size(); ++i) {
+  for (i = 0; i < kappa_accent; ++i) {
     auto raw_message{data_.sender_data.u_futures[i].get()};
     if (base_ots_receiver_data.c[data_.base_ot_offset + i]) {
       BitSpan bit_span_u(const_cast<std::uint8_t*>(
@@ -243,7 +241,7 @@ void Kk13OtProviderFromKk13OtExtension::SendSetup() {
   data_.sender_data.u = {};
 
   // array with pointers to each row of the matrix
-  std::array<const std::byte*, kKappa_accent> pointers;
+  std::vector<const std::byte*> pointers(kappa_accent);
   for (i = 0u; i < pointers.size(); ++i) {
     pointers[i] = v[i].GetData().data();
   }
@@ -257,9 +255,9 @@ void Kk13OtProviderFromKk13OtExtension::SendSetup() {
   prg_fixed_key.SetKey(fixed_key_aes_key.data());
 
   // transpose the bit matrix
-  BitMatrix::SenderTranspose256AndEncrypt(
+  BitMatrix::SenderTransposeCodeAndEncrypt(
       pointers, data_.sender_data.y,
-      base_ots_receiver_data.c.Subset(data_.base_ot_offset, data_.base_ot_offset + kKappa_accent),
+      base_ots_receiver_data.c.Subset(data_.base_ot_offset, data_.base_ot_offset + kappa_accent),
       x_a, prg_fixed_key, bit_size_padded, data_.sender_data.bitlengths);
 
   // we are done with the setup for the sender side
@@ -271,8 +269,10 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
   // some index variables
   std::size_t i, j;
 
-  // security parameter and number of base OTs
-  constexpr std::size_t kKappa_accent = 2 * kKappa;
+  // length of the code words and number of base OTs
+  const std::size_t kappa_accent{data_.code_bit_length};
+  // bounded by the code length and by the random choices of the receiver, which are bytes
+  const std::size_t max_number_of_messages_per_ot{std::min<std::size_t>(kappa_accent, 256)};
 
   // number of OTs and width of the bit matrix
   const auto bit_size = receiver_provider_.GetTotalNumOts();
@@ -292,14 +292,14 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
     if (number_of_messages[i] < 2) {
       throw std::runtime_error(
           fmt::format("Number of message {} must be at least 2", number_of_messages[i]));
-    } else if (number_of_messages[i] > kKappa_accent) {
+    } else if (number_of_messages[i] > max_number_of_messages_per_ot) {
       throw std::runtime_error(fmt::format("Number of message {} must be less than {}",
-                                           number_of_messages[i], kKappa_accent));
+                                           number_of_messages[i], max_number_of_messages_per_ot));
     }
   }
 
   // rounded up to a multiple of the security parameter
-  auto bit_size_padded = bit_size + kKappa_accent - (bit_size % kKappa_accent);
+  auto bit_size_padded = bit_size + kappa_accent - (bit_size % kappa_accent);
 
   // convert to bytes
   const std::size_t byte_size = BitsToBytes(bit_size);
@@ -347,19 +347,23 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
   auto key = data_.receiver_data.key_future.get();
   prg_mask.SetKey(communication::GetMessage(key.data())->payload()->data());
 
-  // mask random choices as X(random_choices)
-  auto x_c =
-      MaskFunction(prg_mask, random_choices_64, max_number_of_messages, bit_size, kKappa_accent);
-
-  // transpose x_c
-  auto bm_xc = BitMatrix(std::move(x_c));
-  bm_xc.Transpose256Columns();
+  // mask random choices as X(random_choices) and transpose them, where the code words are the
+  // same as in MaskFunction
+  const auto code_words{prg_mask.Encrypt(max_number_of_messages * kappa_accent)};
+  std::vector<AlignedBitVector> x_c_transposed(kappa_accent, AlignedBitVector(bit_size_padded));
+  {
+    std::vector<std::byte*> rows(kappa_accent);
+    for (i = 0; i < rows.size(); ++i) {
+      rows[i] = x_c_transposed[i].GetMutableData().data();
+    }
+    BitMatrix::EncodeTransposeCode(code_words.data(), kappa_accent, random_choices_64, rows);
+  }
 
-  // create matrix with kKappa_accent rows
-  std::vector<AlignedBitVector> t_0(kKappa_accent);
+  // create matrix with kappa_accent rows
+  std::vector<AlignedBitVector> t_0(kappa_accent);
 
   // fill the rows of the matrix
-  for (i = 0; i < kKappa_accent; ++i) {
+  for (i = 0; i < kappa_accent; ++i) {
     // generate rows of the matrix using the corresponding 0 key
     // t_0[j] = Prg(s_{j,0})
     prg_variable_key.SetKey(base_ot_provider_.GetBaseOtsData(data_.party_id)
@@ -369,13 +373,13 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
     // the same base OTs previously
     prg_variable_key.SetOffset(data_.base_ot_offset);
     // expand the seed such that it fills one row of the matrix
-    auto row(prg_variable_key.Encrypt(byte_size));
-    t_0[i] = AlignedBitVector(std::move(row), bit_size);
+    t_0[i] = prg_variable_key.KeyStreamBits<AlignedAllocator>(bit_size);
 
     // take a copy of the row and XOR it with our choices
     auto t_1 = t_0[i];
     // t_1[j] = t_0[j] XOR X(c)
-    t_1 ^= bm_xc.GetMutableRow(i);
+    x_c_transposed[i].Resize(bit_size);
+    t_1 ^= x_c_transposed[i];
 
     // now mask the result with random stream expanded from the 1 key
     // t_1[j] = t_1[j] XOR Prg(s_{j,1})
@@ -383,7 +387,7 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
                                 .sender_data.messages_1[data_.base_ot_offset + i]
                                 .data());
     prg_variable_key.SetOffset(data_.sender_data.consumed_offset);
-    t_1 ^= AlignedBitVector(prg_variable_key.Encrypt(byte_size), bit_size);
+    t_1 ^= prg_variable_key.KeyStreamBits<AlignedAllocator>(bit_size);
 
     data_.send_function(communication::BuildMessage(
         communication::MessageType::kKK13OtExtensionReceiverMasks, i,
@@ -398,7 +402,7 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
     }
   }
 
-  std::array<const std::byte*, kKappa_accent> pointers;
+  std::vector<const std::byte*> pointers(kappa_accent);
   for (i = 0; i < pointers.size(); ++i) {
     pointers[i] = t_0[i].GetMutableData().data();
   }
@@ -407,8 +411,8 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
   prg_fixed_key.SetKey(fixed_key_aes_key.data());
 
   // transpose the bit matrix
-  BitMatrix::ReceiverTranspose256AndEncrypt(pointers, data_.receiver_data.outputs, prg_fixed_key,
-                                            bit_size_padded, data_.receiver_data.bitlengths);
+  BitMatrix::ReceiverTransposeCodeAndEncrypt(pointers, data_.receiver_data.outputs, prg_fixed_key,
+                                             bit_size_padded, data_.receiver_data.bitlengths);
 
   data_.receiver_data.SetSetupIsReady();
   SetSetupIsReady();
@@ -416,7 +420,7 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
 
 void Kk13OtProviderFromKk13OtExtension::PreSetup() {
   if (HasWork()) {
-    data_.base_ot_offset = base_ot_provider_.Request(kKappa * 2, data_.party_id);
+    data_.base_ot_offset = base_ot_provider_.Request(data_.code_bit_length, data_.party_id);
   }
 }
 
@@ -615,6 +619,12 @@ Kk13OtProviderManager::Kk13OtProviderManager(communication::CommunicationLayer&
 
 Kk13OtProviderManager::~Kk13OtProviderManager() {}
 
+void Kk13OtProviderManager::SetCodeBitLength(std::size_t code_bit_length) {
+  for (auto& data : data_) {
+    if (data) data->code_bit_length = code_bit_length;
+  }
+}
+
 bool Kk13OtProviderManager::HasWork() {
   for (auto& provider : providers_) {
     if (provider != nullptr && provider->GetPartyId() != communication_layer_.GetMyId() &&
@@ -272,6 +272,10 @@ class Kk13OtProviderManager {
     }
   }
 
+  /// \brief Sets the length of the code words of the OT extensions with all parties, which needs
+  /// to happen before PreSetup().
+  void SetCodeBitLength(std::size_t code_bit_length);
+
  private:
   communication::CommunicationLayer& communication_layer_;
   std::size_t number_of_parties_;
@@ -25,12 +25,18 @@
 #include "base_ot_provider.h"
 #include "ot_hl17.h"
 
+#include <algorithm>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
 #include "base/configuration.h"
 #include "base/register.h"
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/message_generated.h"
 #include "communication/message_manager.h"
 #include "data_storage/base_ot_data.h"
+#include "data_storage/preprocessing_store.h"
 #include "utility/fiber_condition.h"
 #include "utility/logger.h"
 
@@ -45,6 +51,7 @@ BaseOtProvider::BaseOtProvider(communication::CommunicationLayer& communication_
       data_(number_of_parties_),
       logger_(communication_layer_.GetLogger()) {
   number_of_ots_.resize(number_of_parties_ - 1, 0);
+  number_of_computed_ots_.resize(number_of_parties_ - 1, 0);
 }
 
 BaseOtProvider::~BaseOtProvider() {}
@@ -53,22 +60,17 @@ void BaseOtProvider::PreSetup() {
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
     if (party_id == my_id_) continue;
     std::size_t remapped_party_id{party_id > my_id_ ? party_id - 1 : party_id};
-    data_[party_id].receiver_futures.reserve(number_of_ots_[remapped_party_id]);
-    data_[party_id].sender_futures.reserve(number_of_ots_[remapped_party_id]);
-    for (std::size_t i = 0; i < number_of_ots_[remapped_party_id]; ++i) {
-      data_[party_id].receiver_futures.emplace_back(
-          communication_layer_.GetMessageManager().RegisterReceive(
-              party_id, communication::MessageType::kBaseROtMessageReceiver, i));
-      data_[party_id].sender_futures.emplace_back(
-          communication_layer_.GetMessageManager().RegisterReceive(
-              party_id, communication::MessageType::kBaseROtMessageSender, i));
-    }
+    if (number_of_ots_[remapped_party_id] == number_of_computed_ots_[remapped_party_id]) continue;
+    data_[party_id].receiver_future = communication_layer_.GetMessageManager().RegisterReceive(
+        party_id, communication::MessageType::kBaseROtMessageReceiver, 0);
+    data_[party_id].sender_future = communication_layer_.GetMessageManager().RegisterReceive(
+        party_id, communication::MessageType::kBaseROtMessageSender, 0);
   }
 }
 
 bool BaseOtProvider::HasWork() {
-  for (auto n : number_of_ots_) {
-    if (n != 0) return true;
+  for (std::size_t i = 0; i < number_of_ots_.size(); ++i) {
+    if (number_of_ots_[i] > number_of_computed_ots_[i]) return true;
   }
   return false;
 }
@@ -80,10 +82,7 @@ std::vector<std::size_t> BaseOtProvider::Request(std::size_t number_of_ots) {
     if (party_id == my_id_) {
       continue;
     }
-    std::size_t remapped_party_id{party_id > my_id_ ? party_id - 1 : party_id};
-    number_of_ots_.at(remapped_party_id) += number_of_ots;
-    offsets.at(party_id) = data_.at(party_id).total_number_ots;
-    data_.at(party_id).Add(number_of_ots);
+    offsets.at(party_id) = Request(number_of_ots, party_id);
   }
   return offsets;
 }
@@ -91,9 +90,13 @@ std::vector<std::size_t> BaseOtProvider::Request(std::size_t number_of_ots) {
 std::size_t BaseOtProvider::Request(std::size_t number_of_ots, std::size_t party_id) {
   assert(party_id < number_of_parties_);
   std::size_t remapped_party_id{party_id > my_id_ ? party_id - 1 : party_id};
+  const auto offset{number_of_ots_.at(remapped_party_id)};
   number_of_ots_.at(remapped_party_id) += number_of_ots;
-  auto offset = data_.at(party_id).total_number_ots;
-  data_.at(party_id).Add(number_of_ots);
+  // imported base OTs may already occupy the storage of the requested ones
+  auto& data{data_.at(party_id)};
+  if (number_of_ots_.at(remapped_party_id) > data.total_number_ots) {
+    data.Add(number_of_ots_.at(remapped_party_id) - data.total_number_ots);
+  }
   return offset;
 }
 
@@ -104,55 +107,70 @@ void BaseOtProvider::ComputeBaseOts() {
     }
   }
 
-  std::vector<std::future<void>> task_futures;
-  std::vector<std::unique_ptr<OtHL17>> base_ots;
-
-  task_futures.reserve(2 * (number_of_parties_ - 1));
-  base_ots.reserve(number_of_parties_);
-
+  std::vector<std::unique_ptr<OtHL17>> base_ots(number_of_parties_);
   for (auto i = 0ull; i < number_of_parties_; ++i) {
     if (i == my_id_) {
-      base_ots.emplace_back(nullptr);
       continue;
     }
-
     auto send_function = [this, i](flatbuffers::FlatBufferBuilder&& message) {
       communication_layer_.SendMessage(i, message.Release());
     };
+    base_ots.at(i) = std::make_unique<OtHL17>(send_function, data_.at(i));
+  }
 
-    auto& base_ots_data = data_.at(i);
-    base_ots.emplace_back(std::make_unique<OtHL17>(send_function, base_ots_data));
+  // Every phase only waits for messages that the other parties send in an earlier phase, so the
+  // phases run one after another for all parties, and the OTs of a phase run in parallel on the
+  // OpenMP thread pool instead of two threads per party.
+  // only the base OTs [offsets[i], number_of_ots_) requested since the last call are computed
+  std::vector<BitVector<>> choices(number_of_parties_);
+  std::vector<std::size_t> offsets(number_of_parties_);
+  for (auto i = 0ull; i < number_of_parties_; ++i) {
+    if (i == my_id_) {
+      continue;
+    }
     std::size_t remapped_party_id{i > my_id_ ? i - 1 : i};
+    offsets.at(i) = number_of_computed_ots_.at(remapped_party_id);
+    // imported base OTs may exceed the requested ones
+    const std::size_t number_of_ots{
+        std::max(number_of_ots_.at(remapped_party_id), offsets.at(i)) - offsets.at(i)};
+    choices.at(i) = BitVector<>::SecureRandom(number_of_ots);
+    base_ots[i]->SendSetup(number_of_ots);     // receiver base ots
+    base_ots[i]->ReceiveSetup(choices.at(i));  // sender base ots
+  }
 
-    task_futures.emplace_back(
-        std::async(std::launch::async, [this, &base_ots, i, remapped_party_id] {
-          auto choices = BitVector<>::SecureRandom(number_of_ots_.at(remapped_party_id));
-          auto chosen_messages = base_ots[i]->Receive(choices);  // sender base ots
-          auto& receiver_data = data_[i].GetReceiverData();
-          receiver_data.c = std::move(choices);
-          for (std::size_t i = 0; i < chosen_messages.size(); ++i) {
-            auto b = receiver_data.messages_c.at(i).begin();
-            std::copy(chosen_messages.at(i).begin(), chosen_messages.at(i).begin() + 16, b);
-          }
-        }));
-
-    task_futures.emplace_back(std::async(std::launch::async, [this, &base_ots, i,
-                                                              remapped_party_id] {
-      auto both_messages =
-          base_ots[i]->Send(number_of_ots_.at(remapped_party_id));  // receiver base ots
-      auto& sender_data = data_[i].GetSenderData();
-      for (std::size_t i = 0; i < both_messages.size(); ++i) {
-        auto b = sender_data.messages_0.at(i).begin();
-        std::copy(both_messages.at(i).first.begin(), both_messages.at(i).first.begin() + 16, b);
-      }
-      for (std::size_t i = 0; i < both_messages.size(); ++i) {
-        auto b = sender_data.messages_1.at(i).begin();
-        std::copy(both_messages.at(i).second.begin(), both_messages.at(i).second.begin() + 16, b);
-      }
-    }));
+  for (auto i = 0ull; i < number_of_parties_; ++i) {
+    if (i == my_id_) {
+      continue;
+    }
+    auto chosen_messages = base_ots[i]->ReceiveOnline();
+    auto& receiver_data = data_[i].GetReceiverData();
+    receiver_data.c.Append(choices.at(i));
+    for (std::size_t j = 0; j < chosen_messages.size(); ++j) {
+      auto b = receiver_data.messages_c.at(offsets.at(i) + j).begin();
+      std::copy(chosen_messages.at(j).begin(), chosen_messages.at(j).begin() + 16, b);
+    }
+  }
+
+  for (auto i = 0ull; i < number_of_parties_; ++i) {
+    if (i == my_id_) {
+      continue;
+    }
+    auto both_messages = base_ots[i]->SendOnline();
+    auto& sender_data = data_[i].GetSenderData();
+    for (std::size_t j = 0; j < both_messages.size(); ++j) {
+      auto b = sender_data.messages_0.at(offsets.at(i) + j).begin();
+      std::copy(both_messages.at(j).first.begin(), both_messages.at(j).first.begin() + 16, b);
+    }
+    for (std::size_t j = 0; j < both_messages.size(); ++j) {
+      auto b = sender_data.messages_1.at(offsets.at(i) + j).begin();
+      std::copy(both_messages.at(j).second.begin(), both_messages.at(j).second.begin() + 16, b);
+    }
+  }
+
+  for (std::size_t i = 0; i < number_of_computed_ots_.size(); ++i) {
+    number_of_computed_ots_[i] = std::max(number_of_computed_ots_[i], number_of_ots_[i]);
   }
 
-  std::for_each(task_futures.begin(), task_futures.end(), [](auto& f) { f.get(); });
   SetOnlineIsReady();
 
   if constexpr (kDebug) {
@@ -162,72 +180,66 @@ void BaseOtProvider::ComputeBaseOts() {
   }
 }
 
-void BaseOtProvider::ImportBaseOts([[maybe_unused]] std::size_t party_id,
-                                   [[maybe_unused]] const ReceiverMessage& messages) {
-  // TODO
-  throw std::runtime_error("Not completely implemented yet"); /*
-   auto& receiver_data = data_.at(party_id).GetReceiverData();
-   if (receiver_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Found previously computed receiver base OTs for Party#{}", party_id));
-
-   receiver_data.c = messages.c;
-   receiver_data.messages_c = messages.messages_c;
-
-   {
-     std::scoped_lock lock(receiver_data.is_ready_condition->GetMutex());
-     receiver_data.is_ready = true;
-   }
-   receiver_data.is_ready_condition->NotifyAll();*/
-}
+void BaseOtProvider::ImportBaseOts(PreprocessingStore& store) {
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) continue;
+    const std::size_t number_of_ots{
+        store.GetNumberOfAvailableElements(PreprocessingKind::kRandomOtSender, party_id)};
+    if (number_of_ots !=
+        store.GetNumberOfAvailableElements(PreprocessingKind::kRandomOtReceiver, party_id)) {
+      throw std::runtime_error(fmt::format(
+          "Preprocessing store contains different numbers of sender and receiver base OTs for "
+          "Party#{}",
+          party_id));
+    }
+    if (number_of_ots == 0) continue;
+    const auto sender_messages{store.ConsumeRandomOtsSender(party_id, number_of_ots)};
+    const auto receiver_messages{store.ConsumeRandomOtsReceiver(party_id, number_of_ots)};
 
-void BaseOtProvider::ImportBaseOts([[maybe_unused]] std::size_t party_id,
-                                   [[maybe_unused]] const SenderMessage& messages) {
-  // TODO
-  throw std::runtime_error("Not completely implemented yet"); /*
-   auto& sender_data = data_.at(party_id).GetSenderData();
-   if (sender_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Found previously computed sender base OTs for Party#{}", party_id));
-
-   sender_data.messages_0 = messages.messages_0;
-   sender_data.messages_1 = messages.messages_1;
-
-   {
-     std::scoped_lock lock(sender_data.is_ready_condition->GetMutex());
-     sender_data.is_ready = true;
-   }
-   sender_data.is_ready_condition->NotifyAll();*/
+    // the imported base OTs are placed behind the computed ones and serve the next requests
+    std::size_t remapped_party_id{party_id > my_id_ ? party_id - 1 : party_id};
+    auto& data{data_.at(party_id)};
+    const std::size_t offset{number_of_computed_ots_.at(remapped_party_id)};
+    if (offset + number_of_ots > data.total_number_ots) {
+      data.Add(offset + number_of_ots - data.total_number_ots);
+    }
+    auto& sender_data{data.GetSenderData()};
+    auto& receiver_data{data.GetReceiverData()};
+    // the store holds the 16 B messages m_0 || m_1 and m_c of every OT
+    constexpr std::size_t kMessageSize{16};
+    for (std::size_t i = 0; i < number_of_ots; ++i) {
+      std::copy_n(sender_messages.data() + 2 * i * kMessageSize, kMessageSize,
+                  sender_data.messages_0[offset + i].begin());
+      std::copy_n(sender_messages.data() + (2 * i + 1) * kMessageSize, kMessageSize,
+                  sender_data.messages_1[offset + i].begin());
+      std::copy_n(receiver_messages.outputs.data() + i * kMessageSize, kMessageSize,
+                  receiver_data.messages_c[offset + i].begin());
+    }
+    receiver_data.c.Append(receiver_messages.choices);
+    number_of_computed_ots_.at(remapped_party_id) += number_of_ots;
+  }
 }
 
-std::pair<ReceiverMessage, SenderMessage> BaseOtProvider::ExportBaseOts(
-    [[maybe_unused]] std::size_t party_id) {
-  // TODO
-  throw std::runtime_error("Not completely implemented yet"); /*
-   if (party_id == my_id_)
-     throw std::runtime_error("Base OTs export is only possible for other parties");
-
-   auto& base_ot_data = data_.at(party_id);
-   auto& receiver_data = base_ot_data.GetReceiverData();
-   auto& sender_data = base_ot_data.GetSenderData();
-
-   if (!receiver_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Trying to export non-existing receiver base OTs for Party#{}", party_id));
-
-   if (!sender_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Trying to export non-existing sender base OTs for Party#{}", party_id));
-
-   std::pair<ReceiverMessage, SenderMessage> base_ots;
-
-   std::get<0>(base_ots).c = receiver_data.c;
-   std::get<0>(base_ots).messages_c = receiver_data.messages_c;
-
-   std::get<1>(base_ots).messages_0 = sender_data.messages_0;
-   std::get<1>(base_ots).messages_1 = sender_data.messages_1;
-
-   return base_ots;*/
+void BaseOtProvider::ExportBaseOts(PreprocessingStoreWriter& writer, std::size_t party_id,
+                                   std::size_t offset, std::size_t number_of_ots) const {
+  std::size_t remapped_party_id{party_id > my_id_ ? party_id - 1 : party_id};
+  if (party_id == my_id_ ||
+      offset + number_of_ots > number_of_computed_ots_.at(remapped_party_id)) {
+    throw std::invalid_argument(
+        fmt::format("Base OTs [{}, {}) with Party#{} have not been computed", offset,
+                    offset + number_of_ots, party_id));
+  }
+  const auto& sender_data{data_.at(party_id).GetSenderData()};
+  const auto& receiver_data{data_.at(party_id).GetReceiverData()};
+  std::vector<BitVector<>> sender_outputs(number_of_ots), receiver_outputs(number_of_ots);
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    sender_outputs[i] = BitVector<>(sender_data.messages_0[offset + i].data(), kKappa);
+    sender_outputs[i].Append(sender_data.messages_1[offset + i].data(), kKappa);
+    receiver_outputs[i] = BitVector<>(receiver_data.messages_c[offset + i].data(), kKappa);
+  }
+  writer.AddRandomOtsSender(party_id, sender_outputs);
+  writer.AddRandomOtsReceiver(party_id, receiver_outputs,
+                              receiver_data.c.Subset(offset, offset + number_of_ots));
 }
 
 }  // namespace encrypto::motion
@@ -43,28 +43,29 @@ namespace encrypto::motion {
 
 class Configuration;
 class Logger;
+class PreprocessingStore;
+class PreprocessingStoreWriter;
 class Register;
 
-using BaseOtMessages = std::vector<std::array<std::byte, 16>>;
-
-struct SenderMessage {
-  BaseOtMessages messages_0;
-  BaseOtMessages messages_1;
-};
-
-struct ReceiverMessage {
-  BaseOtMessages messages_c;
-  BitVector<> c;
-};
-
 class BaseOtProvider : public FiberOnlineWaitable {
  public:
   BaseOtProvider(communication::CommunicationLayer&);
   ~BaseOtProvider();
+  /// \brief Computes the base OTs requested since the last call, such that base OTs which are
+  /// kept across evaluations are computed only once
   void ComputeBaseOts();
-  void ImportBaseOts(std::size_t party_id, const ReceiverMessage& messages);
-  void ImportBaseOts(std::size_t party_id, const SenderMessage& messages);
-  std::pair<ReceiverMessage, SenderMessage> ExportBaseOts(std::size_t party_id);
+
+  /// \brief Takes all random OTs of the store as computed base OTs, which are then handed out to
+  /// the next requests instead of computing new ones. The store marks them as consumed, so they are
+  /// never imported twice. Must be called before the base OTs are computed.
+  /// throws std::runtime_error if the store has different numbers of sender and receiver OTs
+  void ImportBaseOts(PreprocessingStore& store);
+
+  /// \brief Adds the base OTs [offset, offset + number_of_ots) with party_id to the writer. Only
+  /// base OTs which have not been used, e.g., ones refreshed by an OT extension, may be exported.
+  void ExportBaseOts(PreprocessingStoreWriter& writer, std::size_t party_id, std::size_t offset,
+                     std::size_t number_of_ots) const;
+
   BaseOtData& GetBaseOtsData(std::size_t party_id) { return data_.at(party_id); }
   const BaseOtData& GetBaseOtsData(std::size_t party_id) const { return data_.at(party_id); }
   void PreSetup();
@@ -77,7 +78,9 @@ class BaseOtProvider : public FiberOnlineWaitable {
   std::size_t Request(std::size_t number_of_ots, std::size_t party_id);
 
  private:
+  // requested and computed base OTs per other party, indexed without my_id_
   std::vector<std::size_t> number_of_ots_;
+  std::vector<std::size_t> number_of_computed_ots_;
   communication::CommunicationLayer& communication_layer_;
   std::size_t number_of_parties_;
   std::size_t my_id_;
@@ -24,8 +24,10 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <stdexcept>
 
 #include "base/backend.h"
 #include "communication/message.h"
@@ -48,16 +50,42 @@ OtHL17::OtHL17(std::function<void(flatbuffers::FlatBufferBuilder&&)> send,
 // * random oracle G: GG -> GG
 // * random oracle H: GG^3 -> K
 
-void HashPoint(curve25519::ge_p3& output, const curve25519::ge_p3& input) {
-  std::array<uint8_t, 32> hash_input;
-  std::vector<uint8_t> hash_output(EVP_MAX_MD_SIZE);
+// computes the digests of the messages of message_size bytes each, which are stored consecutively
+// in messages, in parallel and kBlake2bBatchSize at a time
+static std::vector<std::uint8_t> HashMessages(std::span<const std::uint8_t> messages,
+                                              std::size_t message_size) {
+  const std::size_t number_of_messages{messages.size() / message_size};
+  std::vector<std::uint8_t> digests(number_of_messages * kBlake2bDigestSize);
+  const std::size_t number_of_batches{(number_of_messages + kBlake2bBatchSize - 1) /
+                                      kBlake2bBatchSize};
+#pragma omp parallel for
+  for (std::size_t batch = 0; batch < number_of_batches; ++batch) {
+    const std::size_t first{batch * kBlake2bBatchSize};
+    const std::size_t batch_size{std::min(kBlake2bBatchSize, number_of_messages - first)};
+    std::array<const std::uint8_t*, kBlake2bBatchSize> message_pointers;
+    std::array<std::uint8_t*, kBlake2bBatchSize> digest_pointers;
+    for (std::size_t j = 0; j < batch_size; ++j) {
+      message_pointers[j] = messages.data() + (first + j) * message_size;
+      digest_pointers[j] = digests.data() + (first + j) * kBlake2bDigestSize;
+    }
+    Blake2bBatch(std::span(message_pointers.data(), batch_size), message_size,
+                 std::span(digest_pointers.data(), batch_size));
+  }
+  return digests;
+}
+
+// G(P) maps the digest of the encoding of P, which is modified, to a point
+static void DigestToPoint(curve25519::ge_p3& output, std::uint8_t digest[kBlake2bDigestSize]) {
+  curve25519::x25519_sc_reduce(digest);
+  curve25519::x25519_ge_scalarmult_base(&output, digest);
+}
 
-  curve25519::ge_p3_tobytes(hash_input.data(), &input);
-  Blake2b(hash_input.data(), hash_output.data(), hash_input.size());
-  hash_output.resize(32);
+// the first kOtKeySize bytes of a digest are the output of an OT
+constexpr std::size_t kOtKeySize{16};
 
-  curve25519::x25519_sc_reduce(hash_output.data());
-  curve25519::x25519_ge_scalarmult_base(&output, hash_output.data());
+static std::vector<std::byte> DigestToKey(const std::uint8_t* digest) {
+  const auto pointer{reinterpret_cast<const std::byte*>(digest)};
+  return std::vector<std::byte>(pointer, pointer + kOtKeySize);
 }
 
 void OtHL17::Send0(SenderState& state, std::span<std::uint8_t> message_output) {
@@ -72,73 +100,61 @@ void OtHL17::Send0(SenderState& state, std::span<std::uint8_t> message_output) {
 }
 
 void OtHL17::Send1(SenderState& state) {
-  // T = G(S)
-  HashPoint(state.T, state.S);
+  // T = G(S) has been computed in SendSetup
+
+  // y*T does not depend on R
+  curve25519::ge_p2 y_times_T_p2;
+  curve25519::x25519_ge_scalarmult(&y_times_T_p2, state.y, &state.T);
+  curve25519::x25519_ge_p2_to_p3(&state.y_times_T, &y_times_T_p2);
 }
 
-std::pair<std::vector<std::byte>, std::vector<std::byte>> OtHL17::Send2(
-    SenderState& state, std::span<const std::uint8_t> message_input) {
+void OtHL17::Send2(SenderState& state, std::span<std::uint8_t> hash_inputs,
+                   std::span<const std::uint8_t> message_input) {
   assert(message_input.size() == kCurve25519GeByteSize);
+  assert(hash_inputs.size() == 2 * kHashInputSize);
   // assert R in GG
   if (!x25519_ge_frombytes_vartime(&state.R, message_input.data())) {
     throw std::runtime_error("Base OT: R is not in G - abort");
   }
 
-  auto md_context = NewBlakeCtx();
-
-  auto output = std::make_pair<>(std::vector<std::byte>(EVP_MAX_MD_SIZE),
-                                 std::vector<std::byte>(EVP_MAX_MD_SIZE));
-  assert(output.first.size() == EVP_MAX_MD_SIZE);
-  assert(output.second.size() == EVP_MAX_MD_SIZE);
-
-  std::array<uint8_t, 3 * kCurve25519GeByteSize> hash_input;
-  curve25519::ge_p3_tobytes(hash_input.data(), &state.S);
-  curve25519::ge_p3_tobytes(hash_input.data() + 32, &state.R);
+  // the inputs of H(S, R, y*R) and H(S, R, y*R - y*T)
+  std::uint8_t* hash_input_0 = hash_inputs.data();
+  std::uint8_t* hash_input_1 = hash_inputs.data() + kHashInputSize;
+  curve25519::ge_p3_tobytes(hash_input_0, &state.S);
+  curve25519::ge_p3_tobytes(hash_input_0 + 32, &state.R);
+  std::copy_n(hash_input_0, 64, hash_input_1);
 
   // j = 0:
   // y*R
   curve25519::ge_p2 y_times_R_p2;
   curve25519::x25519_ge_scalarmult(&y_times_R_p2, state.y, &state.R);
-  curve25519::x25519_ge_tobytes(hash_input.data() + 64, &y_times_R_p2);
-
-  // H(S, R, y*R)
-  Blake2b(hash_input.data(), reinterpret_cast<uint8_t*>(output.first.data()), hash_input.size(),
-          md_context);
+  curve25519::x25519_ge_tobytes(hash_input_0 + 64, &y_times_R_p2);
+  curve25519::ge_p3 y_times_R_p3;
+  curve25519::x25519_ge_p2_to_p3(&y_times_R_p3, &y_times_R_p2);
 
   // j = 1:
-  // y*R + (-y)*T = y*(R - T)
-  {
-    curve25519::ge_cached T_cached;
-    curve25519::x25519_ge_p3_to_cached(&T_cached, &state.T);
-
-    curve25519::ge_p1p1 R_minus_T_p1p1;
-    curve25519::x25519_ge_sub(&R_minus_T_p1p1, &state.R, &T_cached);
-
-    curve25519::ge_p3 R_minus_T_p3;
-    curve25519::x25519_ge_p1p1_to_p3(&R_minus_T_p3, &R_minus_T_p1p1);
-
-    curve25519::ge_p2 y_times_R_minus_T_p2;
-    curve25519::x25519_ge_scalarmult(&y_times_R_minus_T_p2, state.y, &R_minus_T_p3);
-    curve25519::x25519_ge_tobytes(hash_input.data() + 64, &y_times_R_minus_T_p2);
-  }
+  // y*R + (-y)*T = y*(R - T), using the precomputed y*T
+  curve25519::ge_cached y_times_T_cached;
+  curve25519::x25519_ge_p3_to_cached(&y_times_T_cached, &state.y_times_T);
 
-  // H(S, R, y*R - y*T)
-  Blake2b(hash_input.data(), reinterpret_cast<uint8_t*>(output.second.data()), hash_input.size(),
-          md_context);
+  curve25519::ge_p1p1 y_times_R_minus_T_p1p1;
+  curve25519::x25519_ge_sub(&y_times_R_minus_T_p1p1, &y_times_R_p3, &y_times_T_cached);
 
-  output.first.resize(16);
-  output.second.resize(16);
-
-  return output;
+  curve25519::ge_p2 y_times_R_minus_T_p2;
+  curve25519::x25519_ge_p1p1_to_p2(&y_times_R_minus_T_p2, &y_times_R_minus_T_p1p1);
+  curve25519::x25519_ge_tobytes(hash_input_1 + 64, &y_times_R_minus_T_p2);
 }
 
 void OtHL17::Receive0(ReceiverState& state, bool choice) {
   state.choice = choice;
   // sample x <- Zp
   curve25519::sc_random(state.x);
+
+  // R = g^x does not depend on S
+  curve25519::x25519_ge_scalarmult_base(&state.R, state.x);
 }
 
-void OtHL17::Receive1(ReceiverState& state, std::span<std::uint8_t> message_output,
+void OtHL17::Receive1(ReceiverState& state, std::span<std::uint8_t> hash_input,
                       std::span<const std::uint8_t> message_input) {
   assert(message_input.size() == kCurve25519GeByteSize);
   // recv S
@@ -149,13 +165,12 @@ void OtHL17::Receive1(ReceiverState& state, std::span<std::uint8_t> message_outp
     throw std::runtime_error("Base OT: S is not in G - abort");
   }
 
-  // T = G(S)
-  HashPoint(state.T, state.S);
-
-  // R = T^c * g^x
+  // the input of T = G(S)
+  curve25519::ge_p3_tobytes(hash_input.data(), &state.S);
+}
 
-  // R = g^x
-  curve25519::x25519_ge_scalarmult_base(&state.R, state.x);
+void OtHL17::Receive2(ReceiverState& state, std::span<std::uint8_t> message_output) {
+  // R = T^c * g^x, where R = g^x has been computed in Receive0 and T = G(S) in ReceiveOnline
 
   // FIXME: not constant time
   // R = R * T
@@ -167,97 +182,168 @@ void OtHL17::Receive1(ReceiverState& state, std::span<std::uint8_t> message_outp
     curve25519::x25519_ge_p1p1_to_p3(&state.R, &R_p1p1);
   }
 
-  std::vector<std::byte> R_bytes(32);
   curve25519::ge_p3_tobytes(reinterpret_cast<std::uint8_t*>(message_output.data()), &state.R);
 }
 
-std::vector<std::byte> OtHL17::Receive2(ReceiverState& state) {
+void OtHL17::Receive3(ReceiverState& state, std::span<std::uint8_t> hash_input) {
   // k_R = H_(S,R)(S^x)
   //     = H_(S,R)(g^xy)
-
-  std::vector<std::byte> hash_output(EVP_MAX_MD_SIZE);
-
-  std::array<uint8_t, 3 * kCurve25519GeByteSize> hash_input;
+  assert(hash_input.size() == kHashInputSize);
   curve25519::ge_p3_tobytes(hash_input.data(), &state.S);
   curve25519::ge_p3_tobytes(hash_input.data() + kCurve25519GeByteSize, &state.R);
 
   curve25519::ge_p2 S_to_the_x;
   curve25519::x25519_ge_scalarmult(&S_to_the_x, state.x, &state.S);
   curve25519::x25519_ge_tobytes(hash_input.data() + 2 * kCurve25519GeByteSize, &S_to_the_x);
-
-  assert(hash_output.size() == EVP_MAX_MD_SIZE);
-  Blake2b(hash_input.data(), reinterpret_cast<uint8_t*>(hash_output.data()), hash_input.size());
-
-  hash_output.resize(16);
-  return hash_output;
 }
 
 std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> OtHL17::Send(
     size_t number_of_ots) {
-  std::vector<SenderState> states;
-  for (std::size_t i = 0; i < number_of_ots; ++i) {
-    states.emplace_back(i);
-  }
+  SendSetup(number_of_ots);
+  return SendOnline();
+}
 
-  auto& base_ots_sender = base_ots_data_.sender_data;
+std::vector<std::vector<std::byte>> OtHL17::Receive(const BitVector<>& choices) {
+  ReceiveSetup(choices);
+  return ReceiveOnline();
+}
 
-  std::vector<std::array<std::uint8_t, kCurve25519GeByteSize>> messages_s0(number_of_ots);
-  std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> output(number_of_ots);
+void OtHL17::SendSetup(std::size_t number_of_ots) {
+  sender_states_.clear();
+  sender_states_.reserve(number_of_ots);
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    sender_states_.emplace_back(i);
+  }
 
+  // all S are sent in a single message
+  std::vector<std::uint8_t> message_s0(number_of_ots * kCurve25519GeByteSize);
+#pragma omp parallel for
   for (std::size_t i = 0; i < number_of_ots; ++i) {
-    Send0(states[i], messages_s0[i]);
+    Send0(sender_states_[i],
+          std::span(message_s0.data() + i * kCurve25519GeByteSize, kCurve25519GeByteSize));
+  }
+  if (number_of_ots > 0) {
+    send_function_(communication::BuildMessage(communication::MessageType::kBaseROtMessageSender,
+                                               0, message_s0));
   }
 
+  // T = G(S), where message_s0 holds the encodings of S
+  auto digests{HashMessages(message_s0, kCurve25519GeByteSize)};
+#pragma omp parallel for
   for (std::size_t i = 0; i < number_of_ots; ++i) {
-    std::span s(reinterpret_cast<const std::uint8_t*>(messages_s0[i].data()),
-                messages_s0[i].size());
-    auto msg{communication::BuildMessage(communication::MessageType::kBaseROtMessageSender, i, s)};
-    send_function_(std::move(msg));
-    Send1(states[i]);
+    DigestToPoint(sender_states_[i].T, digests.data() + i * kBlake2bDigestSize);
+    Send1(sender_states_[i]);
   }
+}
 
+std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> OtHL17::SendOnline() {
+  const auto number_of_ots{sender_states_.size()};
+  std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> output(number_of_ots);
+  if (number_of_ots == 0) {
+    base_ots_data_.sender_data.SetOnlineIsReady();
+    return output;
+  }
+  auto raw_message{base_ots_data_.receiver_future.get()};
+  auto payload{communication::GetMessage(raw_message.data())->payload()};
+  if (payload == nullptr || payload->size() != number_of_ots * kCurve25519GeByteSize) {
+    throw std::runtime_error("Base OT: received message of wrong size - abort");
+  }
+
+  // exceptions must not escape the parallel region
+  std::atomic<bool> is_valid{true};
+  std::vector<std::uint8_t> hash_inputs(number_of_ots * 2 * kHashInputSize);
+#pragma omp parallel for
   for (std::size_t i = 0; i < number_of_ots; ++i) {
-    auto raw_message{base_ots_data_.receiver_futures[i].get()};
-    auto payload{communication::GetMessage(raw_message.data())->payload()};
-    output.at(i) = Send2(states.at(i), std::span(payload->data(), payload->size()));
+    try {
+      Send2(sender_states_[i],
+            std::span(hash_inputs.data() + i * 2 * kHashInputSize, 2 * kHashInputSize),
+            std::span(payload->data() + i * kCurve25519GeByteSize, kCurve25519GeByteSize));
+    } catch (std::runtime_error&) {
+      is_valid = false;
+    }
+  }
+  if (!is_valid) {
+    throw std::runtime_error("Base OT: R is not in G - abort");
   }
 
-  base_ots_sender.SetOnlineIsReady();
+  // the digests 2i and 2i + 1 are the outputs of the i-th OT
+  const auto digests{HashMessages(hash_inputs, kHashInputSize)};
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    output[i].first = DigestToKey(digests.data() + 2 * i * kBlake2bDigestSize);
+    output[i].second = DigestToKey(digests.data() + (2 * i + 1) * kBlake2bDigestSize);
+  }
 
+  base_ots_data_.sender_data.SetOnlineIsReady();
   return output;
 }
 
-std::vector<std::vector<std::byte>> OtHL17::Receive(const BitVector<>& choices) {
+void OtHL17::ReceiveSetup(const BitVector<>& choices) {
   const auto number_of_ots = choices.GetSize();
-  auto& base_ots_receiver = base_ots_data_.receiver_data;
-  std::vector<ReceiverState> states;
+  receiver_states_.clear();
+  receiver_states_.reserve(number_of_ots);
   for (std::size_t i = 0; i < number_of_ots; ++i) {
-    states.emplace_back(i);
+    receiver_states_.emplace_back(i);
   }
-  std::vector<std::array<std::uint8_t, kCurve25519GeByteSize>> messages_r1(number_of_ots);
-  std::vector<std::vector<std::byte>> output(number_of_ots);
 
+#pragma omp parallel for
   for (std::size_t i = 0; i < number_of_ots; ++i) {
-    Receive0(states.at(i), choices.Get(i));
+    Receive0(receiver_states_[i], choices.Get(i));
+  }
+}
+
+std::vector<std::vector<std::byte>> OtHL17::ReceiveOnline() {
+  const auto number_of_ots{receiver_states_.size()};
+  std::vector<std::vector<std::byte>> output(number_of_ots);
+  if (number_of_ots == 0) {
+    base_ots_data_.receiver_data.SetOnlineIsReady();
+    return output;
+  }
+  auto raw_message{base_ots_data_.sender_future.get()};
+  auto payload{communication::GetMessage(raw_message.data())->payload()};
+  if (payload == nullptr || payload->size() != number_of_ots * kCurve25519GeByteSize) {
+    throw std::runtime_error("Base OT: received message of wrong size - abort");
   }
 
+  std::vector<std::uint8_t> encoded_s(number_of_ots * kCurve25519GeByteSize);
+  std::atomic<bool> is_valid{true};
+#pragma omp parallel for
   for (std::size_t i = 0; i < number_of_ots; ++i) {
-    auto raw_message{base_ots_data_.sender_futures[i].get()};
-    auto payload{communication::GetMessage(raw_message.data())->payload()};
-    Receive1(states[i], messages_r1[i], std::span(payload->data(), payload->size()));
-    std::span s(reinterpret_cast<const std::uint8_t*>(messages_r1[i].data()),
-                messages_r1[i].size());
-    auto msg{
-        communication::BuildMessage(communication::MessageType::kBaseROtMessageReceiver, i, s)};
-    send_function_(std::move(msg));
+    try {
+      Receive1(receiver_states_[i],
+               std::span(encoded_s.data() + i * kCurve25519GeByteSize, kCurve25519GeByteSize),
+               std::span(payload->data() + i * kCurve25519GeByteSize, kCurve25519GeByteSize));
+    } catch (std::runtime_error&) {
+      is_valid = false;
+    }
+  }
+  if (!is_valid) {
+    throw std::runtime_error("Base OT: S is not in G - abort");
   }
 
+  // T = G(S), and all R are sent in a single message
+  auto digests{HashMessages(encoded_s, kCurve25519GeByteSize)};
+  std::vector<std::uint8_t> message_r1(number_of_ots * kCurve25519GeByteSize);
+#pragma omp parallel for
   for (std::size_t i = 0; i < number_of_ots; ++i) {
-    output.at(i) = Receive2(states.at(i));
+    DigestToPoint(receiver_states_[i].T, digests.data() + i * kBlake2bDigestSize);
+    Receive2(receiver_states_[i],
+             std::span(message_r1.data() + i * kCurve25519GeByteSize, kCurve25519GeByteSize));
   }
+  send_function_(communication::BuildMessage(communication::MessageType::kBaseROtMessageReceiver,
+                                             0, message_r1));
 
-  base_ots_receiver.SetOnlineIsReady();
+  std::vector<std::uint8_t> hash_inputs(number_of_ots * kHashInputSize);
+#pragma omp parallel for
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    Receive3(receiver_states_[i], std::span(hash_inputs.data() + i * kHashInputSize,
+                                            kHashInputSize));
+  }
+  digests = HashMessages(hash_inputs, kHashInputSize);
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    output[i] = DigestToKey(digests.data() + i * kBlake2bDigestSize);
+  }
 
+  base_ots_data_.receiver_data.SetOnlineIsReady();
   return output;
 }
 
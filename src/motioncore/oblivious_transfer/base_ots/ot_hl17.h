@@ -30,6 +30,7 @@
 #include <functional>
 #include <memory>
 #include <span>
+#include <vector>
 
 #include "primitives/curve25519/mycurve25519.h"
 
@@ -56,6 +57,18 @@ class OtHL17 final : public RandomOt {
    */
   std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> Send(size_t) override;
   std::vector<std::vector<std::byte>> Receive(const BitVector<>&) override;
+
+  /**
+   * Phases of the batch send/receive, which exchange a single message per direction.
+   * The setup phases do not wait for the other party, ReceiveOnline waits for the message sent in
+   * SendSetup, and SendOnline for the message sent in ReceiveOnline.  Hence, the phases of the
+   * instances for several parties can be run one after another without blocking each other.
+   * The OTs of a phase are computed in parallel.
+   */
+  void SendSetup(std::size_t number_of_ots);
+  std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> SendOnline();
+  void ReceiveSetup(const BitVector<>& choices);
+  std::vector<std::vector<std::byte>> ReceiveOnline();
   /**
    * Parallelized version of batch send/receive.
    * These methods will create a new thread pool.
@@ -83,6 +96,8 @@ class OtHL17 final : public RandomOt {
     curve25519::ge_p3 T;
     // // R
     curve25519::ge_p3 R;
+    // y*T, precomputed while waiting for R
+    curve25519::ge_p3 y_times_T;
   };
 
   struct ReceiverState {
@@ -105,22 +120,31 @@ class OtHL17 final : public RandomOt {
   };
 
   static constexpr size_t kCurve25519GeByteSize = 32;
+  // the inputs (S, R, P) of the random oracle H
+  static constexpr size_t kHashInputSize = 3 * kCurve25519GeByteSize;
+
+  std::vector<SenderState> sender_states_;
+  std::vector<ReceiverState> receiver_states_;
 
   /**
    * Parts of the sender side.
    */
   void Send0(SenderState& state, std::span<std::uint8_t> message_output);
   void Send1(SenderState& state);
-  std::pair<std::vector<std::byte>, std::vector<std::byte>> Send2(
-      SenderState& state, std::span<const std::uint8_t> message_input);
+  // writes the inputs of H for both outputs, which are hashed in batches by SendOnline
+  void Send2(SenderState& state, std::span<std::uint8_t> hash_inputs,
+             std::span<const std::uint8_t> message_input);
 
   /**
    * Parts of the receiver side.
    */
   void Receive0(ReceiverState& state, bool choice);
-  void Receive1(ReceiverState& state, std::span<std::uint8_t> message_output,
+  // writes the input of G(S), which is hashed in batches by ReceiveOnline and stored in state.T
+  void Receive1(ReceiverState& state, std::span<std::uint8_t> hash_input,
                 std::span<const std::uint8_t> message_input);
-  std::vector<std::byte> Receive2(ReceiverState& state);
+  void Receive2(ReceiverState& state, std::span<std::uint8_t> message_output);
+  // writes the input of H for the output
+  void Receive3(ReceiverState& state, std::span<std::uint8_t> hash_input);
 };
 
 }  // namespace encrypto::motion
@@ -0,0 +1,178 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "ot_batch.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "ot_flavors.h"
+#include "ot_provider.h"
+
+namespace encrypto::motion {
+
+template <typename T>
+AcOtBatch<T>::AcOtBatch(OtBatcher& batcher, std::size_t party_id, std::size_t vector_size)
+    : OtBatch(batcher, party_id),
+      vector_size_(vector_size),
+      outputs_condition_([this] { return outputs_computed_; }) {}
+
+template <typename T>
+AcOtBatch<T>::~AcOtBatch() = default;
+
+template <typename T>
+std::size_t AcOtBatch<T>::Add(std::size_t number_of_ots) {
+  if (sender_) {
+    throw std::logic_error(
+        fmt::format("Cannot add OTs to the AC-OT batch with party#{} after its registration",
+                    party_id_));
+  }
+  if (number_of_members_++ == 0) batcher_.Enqueue(shared_from_this());
+  const std::size_t offset{number_of_ots_};
+  number_of_ots_ += number_of_ots;
+  return offset;
+}
+
+template <typename T>
+void AcOtBatch<T>::Register(OtProvider& provider) {
+  sender_ = provider.RegisterSendAcOt(number_of_ots_, sizeof(T) * 8, vector_size_);
+  receiver_ = provider.RegisterReceiveAcOt(number_of_ots_, sizeof(T) * 8, vector_size_);
+  correlations_.resize(number_of_ots_ * vector_size_);
+  choices_ = BitVector<>(number_of_ots_);
+}
+
+template <typename T>
+void AcOtBatch<T>::Contribute(std::size_t offset, std::span<const T> correlations,
+                              const BitVector<>& choices) {
+  assert(sender_ && receiver_);
+  assert(correlations.size() == choices.GetSize() * vector_size_);
+  bool is_last_contribution;
+  {
+    std::scoped_lock lock(contribution_mutex_);
+    std::copy(correlations.begin(), correlations.end(),
+              correlations_.begin() + offset * vector_size_);
+    choices_.Copy(offset, offset + choices.GetSize(), choices);
+    is_last_contribution = ++number_of_contributions_ == number_of_members_;
+  }
+  // the fiber of the last member does the work of the whole batch
+  if (is_last_contribution) SendAndComputeOutputs();
+}
+
+template <typename T>
+void AcOtBatch<T>::SendAndComputeOutputs() {
+  auto sender{dynamic_cast<AcOtSender<T>*>(sender_.get())};
+  auto receiver{dynamic_cast<AcOtReceiver<T>*>(receiver_.get())};
+  assert(sender);
+  assert(receiver);
+
+  sender->WaitSetup();
+  sender->SetCorrelations(std::move(correlations_));
+  sender->SendMessages();
+
+  receiver->WaitSetup();
+  receiver->SetChoices(std::move(choices_));
+  receiver->SendCorrections();
+
+  sender->ComputeOutputs();
+  receiver->ComputeOutputs();
+
+  {
+    std::scoped_lock lock(outputs_condition_.GetMutex());
+    outputs_computed_ = true;
+  }
+  outputs_condition_.NotifyAll();
+}
+
+template <typename T>
+std::span<const T> AcOtBatch<T>::GetSenderOutputs(std::size_t offset,
+                                                  std::size_t number_of_ots) const {
+  const auto& outputs{dynamic_cast<AcOtSender<T>&>(*sender_).GetOutputs()};
+  return std::span<const T>(outputs).subspan(offset * vector_size_, number_of_ots * vector_size_);
+}
+
+template <typename T>
+std::span<const T> AcOtBatch<T>::GetReceiverOutputs(std::size_t offset,
+                                                    std::size_t number_of_ots) const {
+  const auto& outputs{dynamic_cast<AcOtReceiver<T>&>(*receiver_).GetOutputs()};
+  return std::span<const T>(outputs).subspan(offset * vector_size_, number_of_ots * vector_size_);
+}
+
+template class AcOtBatch<std::uint8_t>;
+template class AcOtBatch<std::uint16_t>;
+template class AcOtBatch<std::uint32_t>;
+template class AcOtBatch<std::uint64_t>;
+
+void OtBatcher::Open() {
+  std::scoped_lock lock(mutex_);
+  open_ = true;
+}
+
+void OtBatcher::Close() {
+  std::scoped_lock lock(mutex_);
+  open_ = false;
+  batches_.clear();
+}
+
+bool OtBatcher::IsOpen() const {
+  std::scoped_lock lock(mutex_);
+  return open_;
+}
+
+template <typename T>
+std::shared_ptr<AcOtBatch<T>> OtBatcher::GetAcOtBatch(std::size_t party_id,
+                                                      std::size_t vector_size) {
+  std::scoped_lock lock(mutex_);
+  if (!open_) return nullptr;
+  auto& batch{batches_[{party_id, sizeof(T) * 8, vector_size}]};
+  if (!batch) batch = std::make_shared<AcOtBatch<T>>(*this, party_id, vector_size);
+  return std::static_pointer_cast<AcOtBatch<T>>(batch);
+}
+
+template std::shared_ptr<AcOtBatch<std::uint8_t>> OtBatcher::GetAcOtBatch(std::size_t,
+                                                                          std::size_t);
+template std::shared_ptr<AcOtBatch<std::uint16_t>> OtBatcher::GetAcOtBatch(std::size_t,
+                                                                           std::size_t);
+template std::shared_ptr<AcOtBatch<std::uint32_t>> OtBatcher::GetAcOtBatch(std::size_t,
+                                                                           std::size_t);
+template std::shared_ptr<AcOtBatch<std::uint64_t>> OtBatcher::GetAcOtBatch(std::size_t,
+                                                                           std::size_t);
+
+void OtBatcher::RegisterBatches(OtProviderManager& manager) {
+  std::vector<std::shared_ptr<OtBatch>> pending_batches;
+  {
+    std::scoped_lock lock(mutex_);
+    pending_batches.swap(pending_batches_);
+  }
+  for (auto& batch : pending_batches) batch->Register(manager.GetProvider(batch->GetPartyId()));
+}
+
+void OtBatcher::Enqueue(std::shared_ptr<OtBatch> batch) {
+  std::scoped_lock lock(mutex_);
+  pending_batches_.emplace_back(std::move(batch));
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,150 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "utility/bit_vector.h"
+#include "utility/fiber_condition.h"
+
+namespace encrypto::motion {
+
+class BasicOtReceiver;
+class BasicOtSender;
+class OtBatcher;
+class OtProvider;
+class OtProviderManager;
+
+// OTs of many gates that share one OT vector per direction with a peer, such that the gates
+// exchange one sender message and one receiver correction per batch instead of one per gate
+class OtBatch : public std::enable_shared_from_this<OtBatch> {
+ public:
+  virtual ~OtBatch() = default;
+
+  OtBatch(const OtBatch&) = delete;
+
+  [[nodiscard]] std::size_t GetPartyId() const noexcept { return party_id_; }
+
+  // registers the OT vectors of all members with the provider for the peer
+  virtual void Register(OtProvider& provider) = 0;
+
+ protected:
+  OtBatch(OtBatcher& batcher, std::size_t party_id) : batcher_(batcher), party_id_(party_id) {}
+
+  OtBatcher& batcher_;
+  const std::size_t party_id_;
+};
+
+// Batch of AC-OTs in both directions, e.g., of HybridMultiplicationGates. Each member reserves its
+// OTs by Add() in construction order and contributes its correlations and choices in the online
+// phase. The last contribution sends the messages of the batch and computes the outputs of all
+// members, hence the members must not depend on each other.
+template <typename T>
+class AcOtBatch final : public OtBatch {
+ public:
+  AcOtBatch(OtBatcher& batcher, std::size_t party_id, std::size_t vector_size);
+
+  ~AcOtBatch() override;
+
+  // reserves number_of_ots OTs in each direction and returns the offset of the first one
+  std::size_t Add(std::size_t number_of_ots);
+
+  void Register(OtProvider& provider) override;
+
+  // contributes the correlations and choices of the OTs [offset, offset + choices.GetSize())
+  void Contribute(std::size_t offset, std::span<const T> correlations, const BitVector<>& choices);
+
+  // blocks until the outputs of all members have been computed
+  void WaitOutputs() const { outputs_condition_.Wait(); }
+
+  std::span<const T> GetSenderOutputs(std::size_t offset, std::size_t number_of_ots) const;
+  std::span<const T> GetReceiverOutputs(std::size_t offset, std::size_t number_of_ots) const;
+
+  [[nodiscard]] std::size_t GetNumberOfOts() const noexcept { return number_of_ots_; }
+  [[nodiscard]] std::size_t GetNumberOfMembers() const noexcept { return number_of_members_; }
+
+ private:
+  void SendAndComputeOutputs();
+
+  const std::size_t vector_size_;
+  std::size_t number_of_ots_{0};
+  std::size_t number_of_members_{0};
+
+  std::unique_ptr<BasicOtSender> sender_;
+  std::unique_ptr<BasicOtReceiver> receiver_;
+
+  std::mutex contribution_mutex_;
+  std::vector<T> correlations_;
+  BitVector<> choices_;
+  std::size_t number_of_contributions_{0};
+
+  bool outputs_computed_{false};
+  FiberCondition outputs_condition_;
+};
+
+// Groups the OTs of the gates that are created between Open() and Close() into one batch per peer
+// and kind of OTs. Gates that are created while the batcher is closed register their own OTs.
+class OtBatcher {
+ public:
+  OtBatcher() = default;
+
+  OtBatcher(const OtBatcher&) = delete;
+
+  // must be called at the same point of the circuit construction in all parties, and only
+  // mutually independent gates, e.g., of the same layer, may be created until Close()
+  void Open();
+
+  // the next Open() starts new batches
+  void Close();
+
+  bool IsOpen() const;
+
+  // returns the current batch of AC-OTs with peer party_id or nullptr if the batcher is closed
+  template <typename T>
+  std::shared_ptr<AcOtBatch<T>> GetAcOtBatch(std::size_t party_id, std::size_t vector_size = 1);
+
+  // registers the batches that got members since the last call in the order of their first
+  // members, which is called before the preprocessing
+  void RegisterBatches(OtProviderManager& manager);
+
+  // called by a batch when its first member is added
+  void Enqueue(std::shared_ptr<OtBatch> batch);
+
+ private:
+  mutable std::mutex mutex_;
+  bool open_{false};
+  // (party id, bit length, vector size) -> current batch
+  std::map<std::tuple<std::size_t, std::size_t, std::size_t>, std::shared_ptr<OtBatch>> batches_;
+  std::vector<std::shared_ptr<OtBatch>> pending_batches_;
+};
+
+}  // namespace encrypto::motion
@@ -151,7 +151,7 @@ void XcOtSender::ComputeOutputs() {
   outputs_.resize(number_of_ots_);
 
   // get the corrections bits
-  std::vector<std::uint8_t> raw_corrections{corrections_future_.get()};
+  auto raw_corrections{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(raw_corrections.data())->payload()->data());
   BitSpan corrections_span(pointer, number_of_ots_);
@@ -243,7 +243,7 @@ void FixedXcOt128Sender::ComputeOutputs() {
   outputs_.resize(number_of_ots_);
 
   // get the corrections bits
-  std::vector<std::uint8_t> corrections_message{corrections_future_.get()};
+  auto corrections_message{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(corrections_message.data())->payload()->data());
   BitSpan corrections_span{pointer, number_of_ots_};
@@ -331,7 +331,7 @@ void XcOtBitSender::ComputeOutputs() {
   outputs_.Resize(number_of_ots_);
 
   // get the corrections bits
-  std::vector<std::uint8_t> corrections_message{corrections_future_.get()};
+  auto corrections_message{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(corrections_message.data())->payload()->data());
   BitSpan corrections_span{pointer, number_of_ots_};
@@ -389,7 +389,7 @@ void XcOtBitReceiver::ComputeOutputs() {
     throw std::runtime_error("Choices in COT must be se(n)t before calling ComputeOutputs()");
   }
 
-  std::vector<std::uint8_t> sender_message{sender_message_future_.get()};
+  auto sender_message{sender_message_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(sender_message.data())->payload()->data());
   outputs_ = choices_ & BitSpan(pointer, choices_.GetSize());
@@ -426,7 +426,7 @@ void AcOtSender<T>::ComputeOutputs() {
   outputs_.resize(number_of_ots_ * vector_size_);
 
   // get the corrections bits
-  std::vector<std::uint8_t> corrections_message{corrections_future_.get()};
+  auto corrections_message{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(corrections_message.data())->payload()->data());
   BitSpan corrections_span{pointer, number_of_ots_};
@@ -574,7 +574,7 @@ GOt128Sender::GOt128Sender(std::size_t ot_id, std::size_t number_of_ots, OtExten
 void GOt128Sender::SendMessages() const {
   assert(data_.sender_data.IsSetupReady());
   Block128Vector buffer = std::move(inputs_);
-  std::vector<std::uint8_t> corrections_message{corrections_future_.get()};
+  auto corrections_message{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(corrections_message.data())->payload()->data());
   BitSpan corrections_span(pointer, number_of_ots_);
@@ -641,7 +641,7 @@ void GOtBitSender::SendMessages() const {
   assert(data_.sender_data.IsSetupReady());
   auto buffer = std::move(inputs_);
 
-  std::vector<std::uint8_t> corrections_message{corrections_future_.get()};
+  auto corrections_message{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(corrections_message.data())->payload()->data());
   BitSpan corrections_span{pointer, number_of_ots_};
@@ -682,7 +682,7 @@ void GOtBitReceiver::ComputeOutputs() {
   if (!corrections_sent_) {
     throw std::runtime_error("Choices in OT must be se(n)t before calling ComputeOutputs()");
   }
-  std::vector<std::uint8_t> sender_message = sender_message_future_.get();
+  auto sender_message = sender_message_future_.get();
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(sender_message.data())->payload()->data());
   BitSpan sender_message_span(pointer, 2 * number_of_ots_);
@@ -708,7 +708,7 @@ void GOtSender::SendMessages() const {
   assert(data_.sender_data.IsSetupReady());
   auto inputs = std::move(inputs_);
 
-  std::vector<std::uint8_t> corrections_message{corrections_future_.get()};
+  auto corrections_message{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(corrections_message.data())->payload()->data());
   BitSpan corrections_span(pointer, number_of_ots_);
@@ -757,7 +757,7 @@ void GOtReceiver::ComputeOutputs() {
   if (!corrections_sent_) {
     throw std::runtime_error("Choices in OT must be se(n)t before calling ComputeOutputs()");
   }
-  std::vector<std::uint8_t> sender_message{sender_message_future_.get()};
+  auto sender_message{sender_message_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(sender_message.data())->payload()->data());
   BitSpan sender_message_span(pointer, 2 * bitlength_ * number_of_ots_);
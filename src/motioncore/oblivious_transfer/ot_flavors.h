@@ -26,6 +26,7 @@
 
 #include <span>
 
+#include "communication/message_buffer.h"
 #include "communication/message_manager.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
@@ -142,7 +143,7 @@ class FixedXcOt128Sender : public BasicOtSender {
   bool outputs_computed_ = false;
 
   // future for the message containing client's corrections
-  ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // receiver implementation of batched xor-correlated 128 bit string OT with a
@@ -166,7 +167,7 @@ class FixedXcOt128Receiver : public BasicOtReceiver {
 
  private:
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 
   // the output for the receiver
   Block128Vector outputs_;
@@ -218,7 +219,7 @@ class XcOtBitSender : public BasicOtSender {
   bool outputs_computed_ = false;
 
   // future for the message containing client's corrections
-  ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // sender implementation of batched xor-correlated bit ots
@@ -265,7 +266,7 @@ class XcOtSender : public BasicOtSender {
   bool outputs_computed_ = false;
 
   // future for the message containing client's corrections
-  ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // receiver implementation of batched random generic ots
@@ -322,7 +323,7 @@ class XcOtBitReceiver : public BasicOtReceiver {
 
  private:
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 
   // the output for the receiver
   BitVector<> outputs_;
@@ -350,7 +351,7 @@ class XcOtReceiver : public BasicOtReceiver {
 
  private:
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 
   // the output for the receiver
   std::vector<BitVector<>> outputs_;
@@ -409,7 +410,7 @@ class AcOtSender : public BasicOtSender {
   bool outputs_computed_ = false;
 
   // future for the message containing client's corrections
-  ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // receiver implementation of batched additive-correlated ots
@@ -437,7 +438,7 @@ class AcOtReceiver : public BasicOtReceiver {
   const std::size_t vector_size_;
 
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 
   // the output for the receiver
   std::vector<T> outputs_;
@@ -465,7 +466,7 @@ class GOt128Sender : public BasicOtSender {
   Block128Vector inputs_;
 
   // future for the message containing client's corrections
-  mutable ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  mutable ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // receiver implementation of batched 128 bit string OT
@@ -486,7 +487,7 @@ class GOt128Receiver : public BasicOtReceiver {
 
  private:
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 
   // the output for the receiver
   Block128Vector outputs_;
@@ -514,7 +515,7 @@ class GOtBitSender : public BasicOtSender {
   BitVector<> inputs_;
 
   // future for the message containing client's corrections
-  mutable ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  mutable ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // sender implementation of batched string OT
@@ -539,7 +540,7 @@ class GOtSender : public BasicOtSender {
   std::vector<BitVector<>> inputs_;
 
   // future for the message containing client's corrections
-  mutable ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+  mutable ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
 };
 
 // receiver implementation of batched string OT
@@ -560,7 +561,7 @@ class GOtBitReceiver : public BasicOtReceiver {
 
  private:
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 
   // the output for the receiver
   BitVector<> outputs_;
@@ -588,7 +589,7 @@ class GOtReceiver : public BasicOtReceiver {
 
  private:
   // future for the sender's message
-  ReusableFiberFuture<std::vector<std::uint8_t>> sender_message_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_message_future_;
 
   // the output for the receiver
   std::vector<BitVector<>> outputs_;
@@ -24,7 +24,10 @@
 
 #include "ot_provider.h"
 #include "base_ots/base_ot_provider.h"
+#include "ot_batch.h"
 #include "ot_flavors.h"
+#include "random_ot_pool.h"
+#include "silent_ot/silent_ot_provider.h"
 
 #include "base/motion_base_provider.h"
 #include "communication/communication_layer.h"
@@ -32,6 +35,8 @@
 #include "communication/message_manager.h"
 #include "data_storage/base_ot_data.h"
 #include "data_storage/ot_extension_data.h"
+#include "base/third_party_dealer.h"
+#include "data_storage/preprocessing_store.h"
 #include "primitives/pseudo_random_generator.h"
 #include "utility/bit_matrix.h"
 #include "utility/config.h"
@@ -40,29 +45,29 @@
 
 namespace encrypto::motion {
 
-std::size_t OtProviderFromOtExtension::GetPartyId() { return data_.party_id; }
+std::size_t OtProviderFromRandomOts::GetPartyId() { return data_.party_id; }
 
-[[nodiscard]] std::unique_ptr<ROtSender> OtProviderFromOtExtension::RegisterSendROt(
+[[nodiscard]] std::unique_ptr<ROtSender> OtProviderFromRandomOts::RegisterSendROt(
     std::size_t number_of_ots, std::size_t bitlength) {
   return sender_provider_.RegisterROt(number_of_ots, bitlength);
 }
 
-[[nodiscard]] std::unique_ptr<XcOtSender> OtProviderFromOtExtension::RegisterSendXcOt(
+[[nodiscard]] std::unique_ptr<XcOtSender> OtProviderFromRandomOts::RegisterSendXcOt(
     std::size_t number_of_ots, std::size_t bitlength) {
   return sender_provider_.RegisterXcOt(number_of_ots, bitlength);
 }
 
 [[nodiscard]] std::unique_ptr<FixedXcOt128Sender>
-OtProviderFromOtExtension::RegisterSendFixedXcOt128(std::size_t number_of_ots) {
+OtProviderFromRandomOts::RegisterSendFixedXcOt128(std::size_t number_of_ots) {
   return sender_provider_.RegisterFixedXcOt128s(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<XcOtBitSender> OtProviderFromOtExtension::RegisterSendXcOtBit(
+[[nodiscard]] std::unique_ptr<XcOtBitSender> OtProviderFromRandomOts::RegisterSendXcOtBit(
     std::size_t number_of_ots) {
   return sender_provider_.RegisterXcOtBits(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<BasicOtSender> OtProviderFromOtExtension::RegisterSendAcOt(
+[[nodiscard]] std::unique_ptr<BasicOtSender> OtProviderFromRandomOts::RegisterSendAcOt(
     std::size_t number_of_ots, std::size_t bitlength, std::size_t vector_size) {
   switch (bitlength) {
     case 8:
@@ -80,42 +85,42 @@ OtProviderFromOtExtension::RegisterSendFixedXcOt128(std::size_t number_of_ots) {
   }
 }
 
-[[nodiscard]] std::unique_ptr<GOtSender> OtProviderFromOtExtension::RegisterSendGOt(
+[[nodiscard]] std::unique_ptr<GOtSender> OtProviderFromRandomOts::RegisterSendGOt(
     std::size_t number_of_ots, std::size_t bitlength) {
   return sender_provider_.RegisterGOt(number_of_ots, bitlength);
 }
 
-[[nodiscard]] std::unique_ptr<GOt128Sender> OtProviderFromOtExtension::RegisterSendGOt128(
+[[nodiscard]] std::unique_ptr<GOt128Sender> OtProviderFromRandomOts::RegisterSendGOt128(
     std::size_t number_of_ots) {
   return sender_provider_.RegisterGOt128(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<GOtBitSender> OtProviderFromOtExtension::RegisterSendGOtBit(
+[[nodiscard]] std::unique_ptr<GOtBitSender> OtProviderFromRandomOts::RegisterSendGOtBit(
     std::size_t number_of_ots) {
   return sender_provider_.RegisterGOtBit(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<ROtReceiver> OtProviderFromOtExtension::RegisterReceiveROt(
+[[nodiscard]] std::unique_ptr<ROtReceiver> OtProviderFromRandomOts::RegisterReceiveROt(
     std::size_t number_of_ots, std::size_t bitlength) {
   return receiver_provider_.RegisterROt(number_of_ots, bitlength);
 }
 
-[[nodiscard]] std::unique_ptr<XcOtReceiver> OtProviderFromOtExtension::RegisterReceiveXcOt(
+[[nodiscard]] std::unique_ptr<XcOtReceiver> OtProviderFromRandomOts::RegisterReceiveXcOt(
     std::size_t number_of_ots, std::size_t bitlength) {
   return receiver_provider_.RegisterXcOt(number_of_ots, bitlength);
 }
 
 [[nodiscard]] std::unique_ptr<FixedXcOt128Receiver>
-OtProviderFromOtExtension::RegisterReceiveFixedXcOt128(std::size_t number_of_ots) {
+OtProviderFromRandomOts::RegisterReceiveFixedXcOt128(std::size_t number_of_ots) {
   return receiver_provider_.RegisterFixedXcOt128s(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<XcOtBitReceiver> OtProviderFromOtExtension::RegisterReceiveXcOtBit(
+[[nodiscard]] std::unique_ptr<XcOtBitReceiver> OtProviderFromRandomOts::RegisterReceiveXcOtBit(
     std::size_t number_of_ots) {
   return receiver_provider_.RegisterXcOtBits(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<BasicOtReceiver> OtProviderFromOtExtension::RegisterReceiveAcOt(
+[[nodiscard]] std::unique_ptr<BasicOtReceiver> OtProviderFromRandomOts::RegisterReceiveAcOt(
     std::size_t number_of_ots, std::size_t bitlength, std::size_t vector_size) {
   switch (bitlength) {
     case 8:
@@ -133,36 +138,34 @@ OtProviderFromOtExtension::RegisterReceiveFixedXcOt128(std::size_t number_of_ots
   }
 }
 
-[[nodiscard]] std::unique_ptr<GOt128Receiver> OtProviderFromOtExtension::RegisterReceiveGOt128(
+[[nodiscard]] std::unique_ptr<GOt128Receiver> OtProviderFromRandomOts::RegisterReceiveGOt128(
     std::size_t number_of_ots) {
   return receiver_provider_.RegisterGOt128(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<GOtBitReceiver> OtProviderFromOtExtension::RegisterReceiveGOtBit(
+[[nodiscard]] std::unique_ptr<GOtBitReceiver> OtProviderFromRandomOts::RegisterReceiveGOtBit(
     std::size_t number_of_ots) {
   return receiver_provider_.RegisterGOtBit(number_of_ots);
 }
 
-[[nodiscard]] std::unique_ptr<GOtReceiver> OtProviderFromOtExtension::RegisterReceiveGOt(
+[[nodiscard]] std::unique_ptr<GOtReceiver> OtProviderFromRandomOts::RegisterReceiveGOt(
     std::size_t number_of_ots, std::size_t bitlength) {
   return receiver_provider_.RegisterGOt(number_of_ots, bitlength);
 }
 
+OtProviderFromRandomOts::OtProviderFromRandomOts(OtExtensionData& data, std::size_t party_id)
+    : OtProvider(),
+      data_(data),
+      receiver_provider_(data_, party_id),
+      sender_provider_(data_, party_id) {}
+
 OtProviderFromOtExtension::OtProviderFromOtExtension(OtExtensionData& data,
                                                      BaseOtProvider& base_ot_provider,
                                                      BaseProvider& motion_base_provider,
                                                      std::size_t party_id)
-    : OtProvider(),
-      data_(data),
+    : OtProviderFromRandomOts(data, party_id),
       base_ot_provider_(base_ot_provider),
-      motion_base_provider_(motion_base_provider),
-      receiver_provider_(data_, party_id),
-      sender_provider_(data_, party_id) {
-  for (std::size_t i = 0; i < data_.sender_data.u_futures.size(); ++i) {
-    data_.sender_data.u_futures[i] = data_.message_manager.RegisterReceive(
-        party_id, communication::MessageType::kOtExtensionReceiverMasks, i);
-  }
-}
+      motion_base_provider_(motion_base_provider) {}
 
 void OtProviderFromOtExtension::SetBaseOtOffset(std::size_t offset) {
   data_.base_ot_offset = offset;
@@ -171,9 +174,6 @@ void OtProviderFromOtExtension::SetBaseOtOffset(std::size_t offset) {
 std::size_t OtProviderFromOtExtension::GetBaseOtOffset() const { return data_.base_ot_offset; }
 
 void OtProviderFromOtExtension::SendSetup() {
-  // security parameter
-  constexpr std::size_t kKappa = 128;
-
   // storage for sender and base OT receiver data
   const auto& base_ots_receiver_data =
       base_ot_provider_.GetBaseOtsData(data_.party_id).GetReceiverData();
@@ -184,68 +184,79 @@ void OtProviderFromOtExtension::SendSetup() {
   if (bit_size == 0) return;  // no OTs needed
   data_.sender_data.bit_size = bit_size;
 
-  // XXX: index variable?
-  std::size_t i;
-
-  // bit size of the matrix rounded to bytes
-  // XXX: maybe round to blocks?
-  const std::size_t byte_size = BitsToBytes(bit_size);
-
-  // bit size rounded to blocks
-  const auto bit_size_padded = bit_size + kKappa - (bit_size % kKappa);
-
-  // vector containing the matrix rows
-  // XXX: note that rows/columns are swapped compared to the ALSZ paper
-  std::vector<AlignedBitVector> v(kKappa);
+  const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(fixed_key_aes_key.data());
 
   // PRG which is used to expand the keys we got from the base OTs
   primitives::Prg prgs_variable_key;
 
-  // fill the rows of the matrix, offset to differentiate other providers' base ots
-  for (i = 0; i < kKappa; ++i) {
-    // use the key we got from the base OTs as seed
-    prgs_variable_key.SetKey(base_ots_receiver_data.messages_c.at(data_.base_ot_offset + i).data());
-    // change the offset in the output stream since we might have already used
-    // the same base OTs previously
-    prgs_variable_key.SetOffset(data_.base_ot_offset);
-    // expand the seed such that it fills one row of the matrix
-    auto row(prgs_variable_key.Encrypt(byte_size));
-    v[i] = AlignedBitVector(std::move(row), bit_size_padded);
-  }
+  const auto choices{
+      base_ots_receiver_data.c.Subset(data_.base_ot_offset, data_.base_ot_offset + kKappa)};
+
+  // the matrix is processed in chunks of columns, such that only the rows of one chunk are kept in
+  // memory and a chunk is transposed while the receiver is still computing the next one
+  for (std::size_t chunk = 0; chunk < data_.sender_data.u_futures.size(); ++chunk) {
+    const std::size_t chunk_begin{chunk * data_.chunk_size};
+    const std::size_t chunk_size{std::min(data_.chunk_size, bit_size - chunk_begin)};
+
+    // bit size of the chunk rounded to bytes
+    const std::size_t byte_size = BitsToBytes(chunk_size);
+
+    // bit size rounded to blocks
+    const auto chunk_size_padded = chunk_size + kKappa - (chunk_size % kKappa);
+
+    // vector containing the matrix rows
+    // XXX: note that rows/columns are swapped compared to the ALSZ paper
+    std::vector<AlignedBitVector> v(kKappa);
+
+    // fill the rows of the matrix, offset to differentiate other providers' base ots
+    for (std::size_t i = 0; i < kKappa; ++i) {
+      // use the key we got from the base OTs as seed
+      prgs_variable_key.SetKey(
+          base_ots_receiver_data.messages_c.at(data_.base_ot_offset + i).data());
+      // change the offset in the output stream since we might have already used
+      // the same base OTs previously, and skip the blocks of the previous chunks
+      prgs_variable_key.SetOffset(data_.base_ot_offset + chunk_begin / kKappa);
+      // expand the seed such that it fills one row of the chunk
+      v[i] = prgs_variable_key.KeyStreamBits<AlignedAllocator>(chunk_size_padded);
+    }
 
-  // receive the vectors u one by one from the receiver
-  // and xor them to the expanded keys if the corresponding selection bit is 1
-  // transmitted one by one to prevent waiting for finishing all messages to start sending
-  // the vectors can be transmitted in the wrong order
+    // receive the vectors u of this chunk from the receiver
+    // and xor them to the expanded keys if the corresponding selection bit is 1
+    auto raw_message{data_.sender_data.u_futures[chunk].get()};
+    auto payload{communication::GetMessage(raw_message.data())->payload()};
+    if (payload->size() != kKappa * byte_size) {
+      throw std::runtime_error(
+          fmt::format("Received {} B of OT extension receiver masks from Party#{} instead of {} B",
+                      payload->size(), data_.party_id, kKappa * byte_size));
+    }
+    for (std::size_t i = 0; i < kKappa; ++i) {
+      if (choices.Get(i)) {
+        BitSpan bit_span_u(const_cast<std::uint8_t*>(payload->data() + i * byte_size),
+                           chunk_size);
+        BitSpan bit_span_v(v[i].GetMutableData().data(), chunk_size, true);
+        bit_span_v ^= bit_span_u;
+      }
+    }
 
-  for (i = 0; i < data_.sender_data.u_futures.size(); ++i) {
-    auto raw_message{data_.sender_data.u_futures[i].get()};
-    if (base_ots_receiver_data.c[data_.base_ot_offset + i]) {
-      BitSpan bit_span_u(const_cast<std::uint8_t*>(
-                             communication::GetMessage(raw_message.data())->payload()->data()),
-                         bit_size);
-      BitSpan bit_span_v(v[i].GetMutableData().data(), bit_size, true);
-      bit_span_v ^= bit_span_u;
+    // array with pointers to each row of the matrix
+    std::array<const std::byte*, kKappa> pointers;
+    for (std::size_t i = 0u; i < pointers.size(); ++i) {
+      pointers[i] = v[i].GetData().data();
     }
-  }
 
-  // array with pointers to each row of the matrix
-  std::array<const std::byte*, kKappa> pointers;
-  for (i = 0u; i < pointers.size(); ++i) {
-    pointers[i] = v[i].GetData().data();
+    // transpose the bit matrix of the chunk and hash its columns to the sender outputs
+    std::vector<BitVector<>> y0(chunk_size), y1(chunk_size);
+    const std::vector<std::size_t> bitlengths(
+        data_.sender_data.bitlengths.begin() + chunk_begin,
+        data_.sender_data.bitlengths.begin() + chunk_begin + chunk_size);
+    BitMatrix::SenderTranspose128AndEncrypt(pointers, y0, y1, choices, prg_fixed_key,
+                                            chunk_size_padded, bitlengths,
+                                            data_.number_of_threads, chunk_begin);
+    std::move(y0.begin(), y0.begin() + chunk_size, data_.sender_data.y0.begin() + chunk_begin);
+    std::move(y1.begin(), y1.begin() + chunk_size, data_.sender_data.y1.begin() + chunk_begin);
   }
-  const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
-
-  // for each (extended) OT i
-  primitives::Prg prg_fixed_key;
-  prg_fixed_key.SetKey(fixed_key_aes_key.data());
-
-  // transpose the bit matrix
-  // XXX: figure out how the result looks like
-  BitMatrix::SenderTranspose128AndEncrypt(
-      pointers, data_.sender_data.y0, data_.sender_data.y1,
-      base_ots_receiver_data.c.Subset(data_.base_ot_offset, data_.base_ot_offset + kKappa),
-      prg_fixed_key, bit_size_padded, data_.sender_data.bitlengths);
 
   // we are done with the setup for the sender side
   data_.sender_data.SetSetupIsReady();
@@ -253,23 +264,10 @@ void OtProviderFromOtExtension::SendSetup() {
 }
 
 void OtProviderFromOtExtension::ReceiveSetup() {
-  // some index variables
-  std::size_t i = 0, j = 0;
-  // security parameter and number of base OTs
-  constexpr std::size_t kKappa = 128;
   // number of OTs and width of the bit matrix
   const std::size_t bit_size = receiver_provider_.GetNumOts();
   if (bit_size == 0) return;  // nothing to do
 
-  // rounded up to a multiple of the security parameter
-  const auto bit_size_padded = bit_size + kKappa - (bit_size % kKappa);
-
-  // convert to bytes
-  const std::size_t byte_size = BitsToBytes(bit_size);
-  // XXX: if byte_size is 0 then bit_size was also zero (or an overflow happened
-  if (byte_size == 0) {
-    return;
-  }
   // storage for receiver and base OT sender data
   const auto& base_ots_sender_data =
       base_ot_provider_.GetBaseOtsData(data_.party_id).GetSenderData();
@@ -278,69 +276,265 @@ void OtProviderFromOtExtension::ReceiveSetup() {
   data_.receiver_data.random_choices =
       std::make_unique<AlignedBitVector>(AlignedBitVector::SecureRandom(bit_size));
 
-  // create matrix with kKappa rows
-  std::vector<AlignedBitVector> v(kKappa);
-
   // PRG we use with the fixed-key AES function
+  primitives::Prg prg_fixed_key;
+  const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
+  prg_fixed_key.SetKey(fixed_key_aes_key.data());
 
   // PRG which is used to expand the keys we got from the base OTs
-  primitives::Prg prg_fixed_key, prg_variable_key;
-
-  // fill the rows of the matrix, offset to differentiate other providers' base ots
-  for (i = 0; i < kKappa; ++i) {
-    // generate rows of the matrix using the corresponding 0 key
-    // T[j] = Prg(s_{j,0})
-    prg_variable_key.SetKey(base_ots_sender_data.messages_0.at(data_.base_ot_offset + i).data());
-    // change the offset in the output stream since we might have already used
-    // the same base OTs previously
-    prg_variable_key.SetOffset(data_.base_ot_offset);
-    // expand the seed such that it fills one row of the matrix
-    auto row(prg_variable_key.Encrypt(byte_size));
-    v.at(i) = AlignedBitVector(std::move(row), bit_size);
-    // take a copy of the row and XOR it with our choices
-    auto u = v.at(i);
-    // u_j = T[j] XOR r
-    u ^= *data_.receiver_data.random_choices;
-
-    // now mask the result with random stream expanded from the 1 key
-    // u_j = u_j XOR Prg(s_{j,1})
-    prg_variable_key.SetKey(base_ots_sender_data.messages_1.at(data_.base_ot_offset + i).data());
-    prg_variable_key.SetOffset(data_.base_ot_offset);
-    u ^= AlignedBitVector(prg_variable_key.Encrypt(byte_size), bit_size);
-
-    auto buffer_span{
-        std::span(reinterpret_cast<const std::uint8_t*>(u.GetData().data()), u.GetData().size())};
-    auto msg{communication::BuildMessage(communication::MessageType::kOtExtensionReceiverMasks, i,
-                                         buffer_span)};
-    // send this row
-    data_.send_function(std::move(msg));
-  }
-
-  // transpose matrix T
-  if (bit_size_padded != bit_size) {
-    for (i = 0u; i < v.size(); ++i) {
-      v.at(i).Resize(bit_size_padded, true);
-    }
-  }
-
-  std::array<const std::byte*, kKappa> pointers;
-  for (j = 0; j < pointers.size(); ++j) {
-    pointers.at(j) = v.at(j).GetMutableData().data();
-  }
+  primitives::Prg prg_variable_key;
+
+  // the matrix is processed in chunks of columns, and every chunk is sent as soon as it is
+  // computed, such that the sender can process it while we transpose it and compute the next one
+  const std::size_t number_of_chunks{(bit_size + data_.chunk_size - 1) / data_.chunk_size};
+  for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+    const std::size_t chunk_begin{chunk * data_.chunk_size};
+    const std::size_t chunk_size{std::min(data_.chunk_size, bit_size - chunk_begin)};
+
+    // rounded up to a multiple of the security parameter
+    const auto chunk_size_padded = chunk_size + kKappa - (chunk_size % kKappa);
+
+    // convert to bytes
+    const std::size_t byte_size = BitsToBytes(chunk_size);
+
+    const auto chunk_choices{
+        data_.receiver_data.random_choices->Subset(chunk_begin, chunk_begin + chunk_size)};
+
+    // create matrix with kKappa rows
+    std::vector<AlignedBitVector> v(kKappa);
+
+    // the rows u_j of the chunk, concatenated
+    std::vector<std::uint8_t> u_buffer(kKappa * byte_size);
+
+    // fill the rows of the matrix, offset to differentiate other providers' base ots
+    for (std::size_t i = 0; i < kKappa; ++i) {
+      // generate rows of the matrix using the corresponding 0 key
+      // T[j] = Prg(s_{j,0})
+      prg_variable_key.SetKey(base_ots_sender_data.messages_0.at(data_.base_ot_offset + i).data());
+      // change the offset in the output stream since we might have already used
+      // the same base OTs previously, and skip the blocks of the previous chunks
+      prg_variable_key.SetOffset(data_.base_ot_offset + chunk_begin / kKappa);
+      // expand the seed such that it fills one row of the chunk
+      v.at(i) = prg_variable_key.KeyStreamBits<AlignedAllocator>(chunk_size);
+      // take a copy of the row and XOR it with our choices
+      auto u = v.at(i);
+      // u_j = T[j] XOR r
+      u ^= chunk_choices;
+
+      // now mask the result with random stream expanded from the 1 key
+      // u_j = u_j XOR Prg(s_{j,1})
+      prg_variable_key.SetKey(base_ots_sender_data.messages_1.at(data_.base_ot_offset + i).data());
+      prg_variable_key.SetOffset(data_.base_ot_offset + chunk_begin / kKappa);
+      u ^= prg_variable_key.KeyStreamBits<AlignedAllocator>(chunk_size);
+
+      std::copy_n(reinterpret_cast<const std::uint8_t*>(u.GetData().data()), byte_size,
+                  u_buffer.data() + i * byte_size);
+    }
 
-  const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
-  prg_fixed_key.SetKey(fixed_key_aes_key.data());
-  BitMatrix::ReceiverTranspose128AndEncrypt(pointers, data_.receiver_data.outputs, prg_fixed_key,
-                                            bit_size_padded, data_.receiver_data.bitlengths);
+    // send the rows of this chunk
+    data_.send_function(communication::BuildMessage(
+        communication::MessageType::kOtExtensionReceiverMasks, chunk, u_buffer));
+
+    // transpose matrix T
+    for (std::size_t i = 0u; i < v.size(); ++i) {
+      v.at(i).Resize(chunk_size_padded, true);
+    }
+
+    std::array<const std::byte*, kKappa> pointers;
+    for (std::size_t j = 0; j < pointers.size(); ++j) {
+      pointers.at(j) = v.at(j).GetMutableData().data();
+    }
+
+    std::vector<BitVector<>> outputs(chunk_size);
+    const std::vector<std::size_t> bitlengths(
+        data_.receiver_data.bitlengths.begin() + chunk_begin,
+        data_.receiver_data.bitlengths.begin() + chunk_begin + chunk_size);
+    BitMatrix::ReceiverTranspose128AndEncrypt(pointers, outputs, prg_fixed_key, chunk_size_padded,
+                                              bitlengths, data_.number_of_threads, chunk_begin);
+    std::move(outputs.begin(), outputs.begin() + chunk_size,
+              data_.receiver_data.outputs.begin() + chunk_begin);
+  }
 
   data_.receiver_data.SetSetupIsReady();
   SetSetupIsReady();
 }
 
 void OtProviderFromOtExtension::PreSetup() {
-  if (HasWork()) {
+  // the base OTs are requested once and then refreshed by every setup (see RefreshBaseOts())
+  if (HasWork() && data_.base_ot_offset == std::numeric_limits<std::size_t>::max()) {
     data_.base_ot_offset = base_ot_provider_.Request(kKappa, data_.party_id);
+    if (refresh_sender_ot_id_ == std::numeric_limits<std::size_t>::max()) {
+      // the other party registers the same OTs in the opposite direction
+      refresh_sender_ot_id_ = sender_provider_.GetNumOts();
+      sender_provider_.RegisterROt(kKappa, kKappa);
+      refresh_receiver_ot_id_ = receiver_provider_.GetNumOts();
+      receiver_provider_.RegisterROt(kKappa, kKappa);
+    }
+  }
+  // the base OTs are used by the following setup
+  has_refreshed_base_ots_ = false;
+  // the receiver sends one message per chunk of the bit matrix
+  const std::size_t number_of_chunks{
+      (sender_provider_.GetNumOts() + data_.chunk_size - 1) / data_.chunk_size};
+  data_.sender_data.u_futures.resize(number_of_chunks);
+  for (std::size_t i = 0; i < number_of_chunks; ++i) {
+    data_.sender_data.u_futures[i] = data_.message_manager.RegisterReceive(
+        data_.party_id, communication::MessageType::kOtExtensionReceiverMasks, i);
+  }
+}
+
+void OtProviderFromOtExtension::RefreshBaseOts() {
+  if (!HasWork() || refresh_sender_ot_id_ == std::numeric_limits<std::size_t>::max()) {
+    return;
+  }
+  auto& base_ot_data{base_ot_provider_.GetBaseOtsData(data_.party_id)};
+  auto& base_ots_sender_data{base_ot_data.GetSenderData()};
+  auto& base_ots_receiver_data{base_ot_data.GetReceiverData()};
+  const std::size_t offset{data_.base_ot_offset};
+  const auto& random_choices{*data_.receiver_data.random_choices};
+  for (std::size_t i = 0; i < kKappa; ++i) {
+    // the OTs in which we are the sender provide the base OTs of our next ReceiveSetup()
+    const auto& y0{data_.sender_data.y0.at(refresh_sender_ot_id_ + i).GetData()};
+    const auto& y1{data_.sender_data.y1.at(refresh_sender_ot_id_ + i).GetData()};
+    std::copy_n(y0.begin(), 16, base_ots_sender_data.messages_0.at(offset + i).begin());
+    std::copy_n(y1.begin(), 16, base_ots_sender_data.messages_1.at(offset + i).begin());
+    // and the OTs in which we are the receiver the ones of our next SendSetup()
+    const auto& output{data_.receiver_data.outputs.at(refresh_receiver_ot_id_ + i).GetData()};
+    std::copy_n(output.begin(), 16, base_ots_receiver_data.messages_c.at(offset + i).begin());
+    base_ots_receiver_data.c.Set(random_choices.Get(refresh_receiver_ot_id_ + i), offset + i);
+  }
+  has_refreshed_base_ots_ = true;
+}
+
+void OtProviderFromOtExtension::ExportBaseOts(PreprocessingStoreWriter& writer) {
+  if (!has_refreshed_base_ots_) {
+    throw std::logic_error(fmt::format(
+        "The base OTs with Party#{} have been used since they were refreshed", data_.party_id));
+  }
+  base_ot_provider_.ExportBaseOts(writer, data_.party_id, data_.base_ot_offset, kKappa);
+  // the exported base OTs must not be used again by this process
+  data_.base_ot_offset = std::numeric_limits<std::size_t>::max();
+  has_refreshed_base_ots_ = false;
+}
+
+namespace {
+
+// expands a stored 128 bit random OT message to an OT message of the given bit length
+BitVector<> ExpandStoredOt(const std::byte* message, std::size_t bitlength) {
+  if (bitlength <= kKappa) {
+    BitVector<> output(message, kKappa);
+    output.Resize(bitlength);
+    return output;
+  }
+  primitives::Prg prg_variable_key;
+  prg_variable_key.SetKey(message);
+  return prg_variable_key.KeyStreamBits(bitlength);
+}
+
+}  // namespace
+
+OtProviderFromFile::OtProviderFromFile(OtExtensionData& data,
+                                       std::shared_ptr<PreprocessingStore> store,
+                                       std::size_t party_id)
+    : OtProviderFromRandomOts(data, party_id), store_(std::move(store)) {}
+
+void OtProviderFromFile::SendSetup() {
+  const std::size_t number_of_ots = sender_provider_.GetNumOts();
+  if (number_of_ots == 0) return;  // no OTs needed
+  data_.sender_data.bit_size = number_of_ots;
+
+  // the messages m_0 || m_1 of every OT
+  const auto messages{store_->ConsumeRandomOtsSender(data_.party_id, number_of_ots)};
+  auto& sender_data{data_.sender_data};
+#pragma omp parallel for num_threads(data_.number_of_threads)
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    const auto message{messages.data() + 2 * (kKappa / 8) * i};
+    sender_data.y0[i] = ExpandStoredOt(message, sender_data.bitlengths[i]);
+    sender_data.y1[i] = ExpandStoredOt(message + kKappa / 8, sender_data.bitlengths[i]);
+  }
+
+  data_.sender_data.SetSetupIsReady();
+  SetSetupIsReady();
+}
+
+void OtProviderFromFile::ReceiveSetup() {
+  const std::size_t number_of_ots = receiver_provider_.GetNumOts();
+  if (number_of_ots == 0) return;  // nothing to do
+
+  auto material{store_->ConsumeRandomOtsReceiver(data_.party_id, number_of_ots)};
+  auto& receiver_data{data_.receiver_data};
+  receiver_data.random_choices = std::make_unique<AlignedBitVector>(std::move(material.choices));
+#pragma omp parallel for num_threads(data_.number_of_threads)
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    receiver_data.outputs[i] =
+        ExpandStoredOt(material.outputs.data() + (kKappa / 8) * i, receiver_data.bitlengths[i]);
+  }
+
+  data_.receiver_data.SetSetupIsReady();
+  SetSetupIsReady();
+}
+
+void OtProviderFromFile::PreSetup() {
+  const std::size_t number_of_sender_ots{sender_provider_.GetNumOts()},
+      number_of_receiver_ots{receiver_provider_.GetNumOts()};
+  if (store_->GetNumberOfAvailableElements(PreprocessingKind::kRandomOtSender, data_.party_id) <
+          number_of_sender_ots ||
+      store_->GetNumberOfAvailableElements(PreprocessingKind::kRandomOtReceiver, data_.party_id) <
+          number_of_receiver_ots) {
+    throw std::runtime_error(fmt::format(
+        "Preprocessing store does not contain {} sender and {} receiver OTs with Party#{}",
+        number_of_sender_ots, number_of_receiver_ots, data_.party_id));
+  }
+}
+
+OtProviderFromThirdParty::OtProviderFromThirdParty(OtExtensionData& data,
+                                                   std::shared_ptr<ThirdPartyDealerClient> client,
+                                                   std::size_t party_id)
+    : OtProviderFromRandomOts(data, party_id), client_(std::move(client)) {}
+
+void OtProviderFromThirdParty::SendSetup() {
+  const std::size_t number_of_ots = sender_provider_.GetNumOts();
+  if (number_of_ots == 0) return;  // no OTs needed
+  data_.sender_data.bit_size = number_of_ots;
+
+  // the messages m_0 || m_1 of every OT
+  const auto& messages{client_->GetMaterial().ot_sender_messages.at(data_.party_id)};
+  assert(messages.size() == 2 * (kKappa / 8) * number_of_ots);
+  auto& sender_data{data_.sender_data};
+#pragma omp parallel for num_threads(data_.number_of_threads)
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    const auto message{messages.data() + 2 * (kKappa / 8) * i};
+    sender_data.y0[i] = ExpandStoredOt(message, sender_data.bitlengths[i]);
+    sender_data.y1[i] = ExpandStoredOt(message + kKappa / 8, sender_data.bitlengths[i]);
+  }
+
+  data_.sender_data.SetSetupIsReady();
+  SetSetupIsReady();
+}
+
+void OtProviderFromThirdParty::ReceiveSetup() {
+  const std::size_t number_of_ots = receiver_provider_.GetNumOts();
+  if (number_of_ots == 0) return;  // nothing to do
+
+  auto& material{client_->GetMaterial()};
+  const auto& messages{material.ot_receiver_messages.at(data_.party_id)};
+  assert(messages.size() == (kKappa / 8) * number_of_ots);
+  auto& receiver_data{data_.receiver_data};
+  receiver_data.random_choices = std::make_unique<AlignedBitVector>(
+      std::move(material.ot_receiver_choices.at(data_.party_id)));
+#pragma omp parallel for num_threads(data_.number_of_threads)
+  for (std::size_t i = 0; i < number_of_ots; ++i) {
+    receiver_data.outputs[i] =
+        ExpandStoredOt(messages.data() + (kKappa / 8) * i, receiver_data.bitlengths[i]);
   }
+
+  data_.receiver_data.SetSetupIsReady();
+  SetSetupIsReady();
+}
+
+void OtProviderFromThirdParty::PreSetup() {
+  client_->RequestRandomOts(data_.party_id, sender_provider_.GetNumOts(),
+                            receiver_provider_.GetNumOts());
 }
 
 OtVector::OtVector(const std::size_t ot_id, const std::size_t number_of_ots,
@@ -349,7 +543,7 @@ OtVector::OtVector(const std::size_t ot_id, const std::size_t number_of_ots,
 
 std::unique_ptr<ROtSender> OtProviderSender::RegisterROt(const std::size_t number_of_ots,
                                                          const std::size_t bitlength) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<ROtSender>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
@@ -363,7 +557,7 @@ std::unique_ptr<ROtSender> OtProviderSender::RegisterROt(const std::size_t numbe
 
 std::unique_ptr<XcOtSender> OtProviderSender::RegisterXcOt(const std::size_t number_of_ots,
                                                            const std::size_t bitlength) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<XcOtSender>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
@@ -377,7 +571,7 @@ std::unique_ptr<XcOtSender> OtProviderSender::RegisterXcOt(const std::size_t num
 
 std::unique_ptr<FixedXcOt128Sender> OtProviderSender::RegisterFixedXcOt128s(
     const std::size_t number_of_ots) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<FixedXcOt128Sender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
@@ -391,7 +585,7 @@ std::unique_ptr<FixedXcOt128Sender> OtProviderSender::RegisterFixedXcOt128s(
 }
 
 std::unique_ptr<XcOtBitSender> OtProviderSender::RegisterXcOtBits(const std::size_t number_of_ots) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<XcOtBitSender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
@@ -406,7 +600,7 @@ std::unique_ptr<XcOtBitSender> OtProviderSender::RegisterXcOtBits(const std::siz
 template <typename T>
 std::unique_ptr<AcOtSender<T>> OtProviderSender::RegisterAcOt(std::size_t number_of_ots,
                                                               std::size_t vector_size) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<AcOtSender<T>>(i, number_of_ots, vector_size, data_);
   if constexpr (kDebug) {
@@ -431,7 +625,7 @@ template std::unique_ptr<AcOtSender<__uint128_t>> OtProviderSender::RegisterAcOt
 
 std::unique_ptr<GOtSender> OtProviderSender::RegisterGOt(const std::size_t number_of_ots,
                                                          const std::size_t bitlength) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<GOtSender>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
@@ -444,7 +638,7 @@ std::unique_ptr<GOtSender> OtProviderSender::RegisterGOt(const std::size_t numbe
 }
 
 std::unique_ptr<GOt128Sender> OtProviderSender::RegisterGOt128(const std::size_t number_of_ots) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<GOt128Sender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
@@ -457,7 +651,7 @@ std::unique_ptr<GOt128Sender> OtProviderSender::RegisterGOt128(const std::size_t
 }
 
 std::unique_ptr<GOtBitSender> OtProviderSender::RegisterGOtBit(const std::size_t number_of_ots) {
-  const auto i = total_ots_count_;
+  const auto i = total_ots_count_.load();
   total_ots_count_ += number_of_ots;
   auto ot = std::make_unique<GOtBitSender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
@@ -623,8 +817,12 @@ OtProviderManager::OtProviderManager(communication::CommunicationLayer& communic
                                      BaseOtProvider& base_ot_provider,
                                      BaseProvider& motion_base_provider)
     : communication_layer_(communication_layer),
+      base_ot_provider_(base_ot_provider),
+      motion_base_provider_(motion_base_provider),
       providers_(communication_layer_.GetNumberOfParties()),
-      data_(communication_layer_.GetNumberOfParties()){
+      ot_batcher_(std::make_unique<OtBatcher>()),
+      data_(communication_layer_.GetNumberOfParties()),
+      random_ot_pools_(communication_layer_.GetNumberOfParties()) {
   auto my_id = communication_layer.GetMyId();
   for (std::size_t party_id = 0; party_id < providers_.size(); ++party_id) {
     if (party_id == my_id) {
@@ -638,11 +836,14 @@ OtProviderManager::OtProviderManager(communication::CommunicationLayer& communic
     data_.at(party_id)->party_id = party_id;
     providers_.at(party_id) = std::make_unique<OtProviderFromOtExtension>(
         *data_.at(party_id), base_ot_provider, motion_base_provider, party_id);
+    random_ot_pools_.at(party_id) = std::make_unique<RandomOtPool>(*this, *data_.at(party_id));
   }
 }
 
 OtProviderManager::~OtProviderManager() {}
 
+void OtProviderManager::RegisterOtBatches() { ot_batcher_->RegisterBatches(*this); }
+
 bool OtProviderManager::HasWork() {
   for (auto& provider : providers_) {
     if (provider != nullptr && (provider->GetPartyId() != communication_layer_.GetMyId()) &&
@@ -653,4 +854,84 @@ bool OtProviderManager::HasWork() {
   return false;
 }
 
+void OtProviderManager::SetNumberOfThreads(std::size_t number_of_threads) {
+  for (auto& data : data_) {
+    if (data) data->number_of_threads = number_of_threads;
+  }
+}
+
+void OtProviderManager::SetChunkSize(std::size_t chunk_size) {
+  if (chunk_size == 0 || chunk_size % kKappa != 0) {
+    throw std::invalid_argument(fmt::format(
+        "the OT extension chunk size {} is not a positive multiple of {}", chunk_size, kKappa));
+  }
+  for (auto& data : data_) {
+    if (data) data->chunk_size = chunk_size;
+  }
+}
+
+void OtProviderManager::RefreshBaseOts() {
+  for (auto& provider : providers_) {
+    if (auto ot_extension = dynamic_cast<OtProviderFromOtExtension*>(provider.get())) {
+      ot_extension->RefreshBaseOts();
+    }
+  }
+}
+
+bool OtProviderManager::ExportBaseOts(PreprocessingStoreWriter& writer) {
+  bool has_exported{false};
+  for (auto& provider : providers_) {
+    auto ot_extension = dynamic_cast<OtProviderFromOtExtension*>(provider.get());
+    if (ot_extension && ot_extension->HasRefreshedBaseOts()) {
+      ot_extension->ExportBaseOts(writer);
+      has_exported = true;
+    }
+  }
+  return has_exported;
+}
+
+void OtProviderManager::SetSilentOt(bool value) {
+  if (HasWork()) {
+    throw std::logic_error("The OT protocol cannot be changed after OTs have been registered");
+  }
+  for (std::size_t party_id = 0; party_id < providers_.size(); ++party_id) {
+    if (party_id == communication_layer_.GetMyId()) {
+      continue;
+    }
+    if (value) {
+      providers_.at(party_id) = std::make_unique<OtProviderFromSilentOt>(
+          *data_.at(party_id), base_ot_provider_, motion_base_provider_, party_id);
+    } else {
+      providers_.at(party_id) = std::make_unique<OtProviderFromOtExtension>(
+          *data_.at(party_id), base_ot_provider_, motion_base_provider_, party_id);
+    }
+  }
+}
+
+void OtProviderManager::SetPreprocessingStore(std::shared_ptr<PreprocessingStore> store) {
+  if (HasWork()) {
+    throw std::logic_error("The OT protocol cannot be changed after OTs have been registered");
+  }
+  for (std::size_t party_id = 0; party_id < providers_.size(); ++party_id) {
+    if (party_id == communication_layer_.GetMyId()) {
+      continue;
+    }
+    providers_.at(party_id) =
+        std::make_unique<OtProviderFromFile>(*data_.at(party_id), store, party_id);
+  }
+}
+
+void OtProviderManager::SetThirdPartyDealer(std::shared_ptr<ThirdPartyDealerClient> client) {
+  if (HasWork()) {
+    throw std::logic_error("The OT protocol cannot be changed after OTs have been registered");
+  }
+  for (std::size_t party_id = 0; party_id < providers_.size(); ++party_id) {
+    if (party_id == communication_layer_.GetMyId()) {
+      continue;
+    }
+    providers_.at(party_id) =
+        std::make_unique<OtProviderFromThirdParty>(*data_.at(party_id), client, party_id);
+  }
+}
+
 }  // namespace encrypto::motion
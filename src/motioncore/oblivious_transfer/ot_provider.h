@@ -26,6 +26,7 @@
 
 #include <array>
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 
@@ -48,6 +49,11 @@ struct OtExtensionReceiverData;
 struct OtExtensionSenderData;
 class Logger;
 class BaseProvider;
+class OtBatcher;
+class PreprocessingStore;
+class PreprocessingStoreWriter;
+class RandomOtPool;
+class ThirdPartyDealerClient;
 
 enum OtProtocol : unsigned int {
   kGOt = 0,   // general OT
@@ -123,14 +129,15 @@ class OtProviderSender : public FiberSetupWaitable {
   std::unique_ptr<GOt128Sender> RegisterGOt128(std::size_t number_of_ots);
   std::unique_ptr<GOtBitSender> RegisterGOtBit(std::size_t number_of_ots);
 
-  auto GetNumOts() const { return total_ots_count_; }
+  std::size_t GetNumOts() const { return total_ots_count_; }
 
   void Clear();
 
   void Reset();
 
  private:
-  std::size_t total_ots_count_{0};
+  // atomic since it may be read concurrently, e.g., by a MetricsRegistry collector
+  std::atomic<std::size_t> total_ots_count_{0};
 
   OtExtensionData& data_;
 
@@ -277,15 +284,13 @@ class OtProvider : public FiberSetupWaitable {
   OtProvider() = default;
 };
 
-class OtProviderFromFile : public OtProvider {
-  // TODO
-};
-
 class OtProviderFromBaseOTs : public OtProvider {
   // TODO
 };
 
-class OtProviderFromOtExtension final : public OtProvider {
+// Base class for providers which compute a batch of random OTs in their setup, and from which the
+// registered OT flavors are derived.  The random OTs are stored in the OtExtensionData.
+class OtProviderFromRandomOts : public OtProvider {
  public:
   [[nodiscard]] std::unique_ptr<ROtSender> RegisterSendROt(std::size_t number_of_ots,
                                                            std::size_t bitlength) override;
@@ -336,6 +341,24 @@ class OtProviderFromOtExtension final : public OtProvider {
   [[nodiscard]] std::unique_ptr<GOtBitReceiver> RegisterReceiveGOtBit(
       std::size_t number_of_ots) override;
 
+  std::size_t GetPartyId() final;
+
+  [[nodiscard]] std::size_t GetNumOtsReceiver() const final {
+    return receiver_provider_.GetNumOts();
+  }
+
+  [[nodiscard]] std::size_t GetNumOtsSender() const final { return sender_provider_.GetNumOts(); }
+
+ protected:
+  OtProviderFromRandomOts(OtExtensionData& data, std::size_t party_id);
+
+  OtExtensionData& data_;
+  OtProviderReceiver receiver_provider_;
+  OtProviderSender sender_provider_;
+};
+
+class OtProviderFromOtExtension final : public OtProviderFromRandomOts {
+ public:
   void SendSetup() final;
 
   void ReceiveSetup() final;
@@ -345,28 +368,68 @@ class OtProviderFromOtExtension final : public OtProvider {
   OtProviderFromOtExtension(OtExtensionData& data, BaseOtProvider& base_ot_provider, BaseProvider&,
                             std::size_t party_id);
 
-  std::size_t GetPartyId() final;
-
   void SetBaseOtOffset(std::size_t offset);
 
   std::size_t GetBaseOtOffset() const;
 
-  [[nodiscard]] std::size_t GetNumOtsReceiver() const final {
-    return receiver_provider_.GetNumOts();
-  }
+  // Replaces the kKappa base OTs of this provider by kKappa 128 bit random OTs of the finished
+  // setup, which are extended in both directions for this purpose only. The next setup, e.g.,
+  // after Backend::Clear(), then uses fresh base OTs without computing new ones.
+  void RefreshBaseOts();
 
-  [[nodiscard]] std::size_t GetNumOtsSender() const final { return sender_provider_.GetNumOts(); }
+  // Adds the refreshed base OTs to the writer and requests new base OTs for the next setup, such
+  // that the exported ones are never used in this process
+  // throws std::logic_error if the base OTs have not been refreshed since they were used
+  void ExportBaseOts(PreprocessingStoreWriter& writer);
+
+  bool HasRefreshedBaseOts() const noexcept { return has_refreshed_base_ots_; }
 
  private:
-  OtExtensionData& data_;
   BaseOtProvider& base_ot_provider_;
   BaseProvider& motion_base_provider_;
-  OtProviderReceiver receiver_provider_;
-  OtProviderSender sender_provider_;
+
+  // first OT of the kKappa random OTs of each direction from which the base OTs are refreshed
+  std::size_t refresh_sender_ot_id_{std::numeric_limits<std::size_t>::max()};
+  std::size_t refresh_receiver_ot_id_{std::numeric_limits<std::size_t>::max()};
+  bool has_refreshed_base_ots_{false};
 };
 
-class OtProviderFromThirdParty : public OtProvider {
-  // TODO
+// Provider which takes 128 bit random OTs from a PreprocessingStore instead of computing them. The
+// registered OT flavors are derived from them as from the OT extension, and OTs of more than 128
+// bit are obtained by expanding the stored messages with a PRG.
+class OtProviderFromFile final : public OtProviderFromRandomOts {
+ public:
+  OtProviderFromFile(OtExtensionData& data, std::shared_ptr<PreprocessingStore> store,
+                     std::size_t party_id);
+
+  void SendSetup() final;
+
+  void ReceiveSetup() final;
+
+  // fails early if the store does not contain enough OTs
+  void PreSetup() final;
+
+ private:
+  std::shared_ptr<PreprocessingStore> store_;
+};
+
+// Provider which obtains 128 bit random OTs from a ThirdPartyDealer and derives the registered OT
+// flavors from them as OtProviderFromFile
+class OtProviderFromThirdParty final : public OtProviderFromRandomOts {
+ public:
+  OtProviderFromThirdParty(OtExtensionData& data, std::shared_ptr<ThirdPartyDealerClient> client,
+                           std::size_t party_id);
+
+  // needs a completed ThirdPartyDealerClient::Exchange
+  void SendSetup() final;
+
+  void ReceiveSetup() final;
+
+  // registers the OTs with the client
+  void PreSetup() final;
+
+ private:
+  std::shared_ptr<ThirdPartyDealerClient> client_;
 };
 
 class OtProviderFromMultipleThirdParties : public OtProvider {
@@ -389,10 +452,50 @@ class OtProviderManager {
 
   bool HasWork();
 
+  // Shares the OT vectors between the gates that are created while it is open (see OtBatcher)
+  OtBatcher& GetOtBatcher() { return *ot_batcher_; }
+
+  // Registers the OTs of the batches, which needs to happen before HasWork() and PreSetup()
+  void RegisterOtBatches();
+
+  // Random OTs with the peer which are derandomized into any flavor on demand (see RandomOtPool)
+  RandomOtPool& GetRandomOtPool(std::size_t party_id) { return *random_ot_pools_.at(party_id); }
+
+  // Generate the OTs with a silent OT (see OtProviderFromSilentOt) instead of the IKNP OT
+  // extension, which needs to be selected before any OTs are registered
+  void SetSilentOt(bool value);
+
+  // Take the OTs from the store (see OtProviderFromFile) instead of generating them, which needs to
+  // be selected before any OTs are registered
+  void SetPreprocessingStore(std::shared_ptr<PreprocessingStore> store);
+
+  // Obtain the OTs from a trusted dealer (see OtProviderFromThirdParty) instead of generating them,
+  // which needs to be selected before any OTs are registered
+  void SetThirdPartyDealer(std::shared_ptr<ThirdPartyDealerClient> client);
+
+  // Set the number of threads which each provider uses for its setup
+  void SetNumberOfThreads(std::size_t number_of_threads);
+
+  // Set the number of OTs per chunk of the OT extension, a multiple of kKappa, which needs to be
+  // equal at all parties and set before the PreSetup
+  void SetChunkSize(std::size_t chunk_size);
+
+  // Refreshes the base OTs of the OT extension providers after their setup (see
+  // OtProviderFromOtExtension::RefreshBaseOts())
+  void RefreshBaseOts();
+
+  // Adds the refreshed base OTs of all OT extension providers to the writer (see
+  // OtProviderFromOtExtension::ExportBaseOts()) and returns whether there were any
+  bool ExportBaseOts(PreprocessingStoreWriter& writer);
+
  private:
   communication::CommunicationLayer& communication_layer_;
+  BaseOtProvider& base_ot_provider_;
+  BaseProvider& motion_base_provider_;
   std::vector<std::unique_ptr<OtProvider>> providers_;
+  std::unique_ptr<OtBatcher> ot_batcher_;
   std::vector<std::unique_ptr<OtExtensionData>> data_;
+  std::vector<std::unique_ptr<RandomOtPool>> random_ot_pools_;
 };
 
 }  // namespace encrypto::motion
@@ -0,0 +1,332 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "random_ot_pool.h"
+#include "ot_flavors.h"
+#include "ot_provider.h"
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+#include <fmt/format.h>
+
+#include "communication/message.h"
+#include "data_storage/ot_extension_data.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// the random strings are 128 bits and interpreted as elements of a ring by their lowest bytes
+template <typename T>
+T GetRingElement(const Block128& block) {
+  static_assert(sizeof(T) <= Block128::kBlockSize);
+  T value;
+  std::memcpy(&value, block.data(), sizeof(T));
+  return value;
+}
+
+std::span<const std::uint8_t> AsBytes(const Block128Vector& blocks) {
+  return std::span(reinterpret_cast<const std::uint8_t*>(blocks.data()),
+                   blocks.size() * Block128::kBlockSize);
+}
+
+const std::uint8_t* GetPayload(const communication::MessageBuffer& message,
+                               [[maybe_unused]] std::size_t expected_size) {
+  auto payload = communication::GetMessage(message.data())->payload();
+  assert(payload->size() == expected_size);
+  return payload->data();
+}
+
+}  // namespace
+
+// ---------- RandomOtPool ----------
+
+RandomOtPool::RandomOtPool(OtProviderManager& ot_provider_manager, OtExtensionData& data)
+    : ot_provider_manager_(ot_provider_manager), data_(data) {}
+
+RandomOtPool::~RandomOtPool() = default;
+
+void RandomOtPool::Reserve(std::size_t number_of_ots) {
+  if (number_of_ots == 0) {
+    return;
+  }
+  auto& provider = ot_provider_manager_.GetProvider(data_.party_id);
+  std::scoped_lock lock(mutex_);
+  sender_ots_.emplace_back(provider.RegisterSendROt(number_of_ots, 128));
+  receiver_ots_.emplace_back(provider.RegisterReceiveROt(number_of_ots, 128));
+  number_of_reserved_ots_ += number_of_ots;
+}
+
+std::size_t RandomOtPool::GetNumberOfAvailableSenderOts() const {
+  std::scoped_lock lock(mutex_);
+  return number_of_reserved_ots_ - sender_offset_;
+}
+
+std::size_t RandomOtPool::GetNumberOfAvailableReceiverOts() const {
+  std::scoped_lock lock(mutex_);
+  return number_of_reserved_ots_ - receiver_offset_;
+}
+
+std::unique_ptr<PooledOtSender> RandomOtPool::TakeSender(std::size_t number_of_ots) {
+  std::size_t offset;
+  {
+    std::scoped_lock lock(mutex_);
+    if (sender_offset_ + number_of_ots > number_of_reserved_ots_) {
+      throw std::out_of_range(
+          fmt::format("only {} of the {} requested sender OTs are left in the pool with party {}",
+                      number_of_reserved_ots_ - sender_offset_, number_of_ots, data_.party_id));
+    }
+    offset = sender_offset_;
+    sender_offset_ += number_of_ots;
+  }
+  return std::make_unique<PooledOtSender>(*this, offset, number_of_ots);
+}
+
+std::unique_ptr<PooledOtReceiver> RandomOtPool::TakeReceiver(std::size_t number_of_ots) {
+  std::size_t offset;
+  {
+    std::scoped_lock lock(mutex_);
+    if (receiver_offset_ + number_of_ots > number_of_reserved_ots_) {
+      throw std::out_of_range(
+          fmt::format("only {} of the {} requested receiver OTs are left in the pool with party {}",
+                      number_of_reserved_ots_ - receiver_offset_, number_of_ots, data_.party_id));
+    }
+    offset = receiver_offset_;
+    receiver_offset_ += number_of_ots;
+  }
+  return std::make_unique<PooledOtReceiver>(*this, offset, number_of_ots);
+}
+
+std::pair<Block128Vector, Block128Vector> RandomOtPool::GetSenderStrings(
+    std::size_t offset, std::size_t number_of_ots) {
+  // all OT vectors share the setup of the provider, where we must not wait with the mutex held
+  ROtSender* any_ot;
+  {
+    std::scoped_lock lock(mutex_);
+    any_ot = sender_ots_.back().get();
+  }
+  any_ot->WaitSetup();
+
+  std::scoped_lock lock(mutex_);
+  for (; number_of_flattened_sender_vectors_ < sender_ots_.size() &&
+         sender_strings_0_.size() < offset + number_of_ots;
+       ++number_of_flattened_sender_vectors_) {
+    auto& ot = *sender_ots_[number_of_flattened_sender_vectors_];
+    ot.ComputeOutputs();
+    auto outputs = ot.GetOutputs();
+    const auto old_size = sender_strings_0_.size();
+    sender_strings_0_.resize(old_size + outputs.size());
+    sender_strings_1_.resize(old_size + outputs.size());
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+      // each output is y_0 || y_1
+      const auto* pointer = outputs[i].GetData().data();
+      sender_strings_0_[old_size + i] = Block128::MakeFromMemory(pointer);
+      sender_strings_1_[old_size + i] = Block128::MakeFromMemory(pointer + Block128::kBlockSize);
+    }
+  }
+  assert(offset + number_of_ots <= sender_strings_0_.size());
+  return {Block128Vector(sender_strings_0_.data() + offset,
+                         sender_strings_0_.data() + offset + number_of_ots),
+          Block128Vector(sender_strings_1_.data() + offset,
+                         sender_strings_1_.data() + offset + number_of_ots)};
+}
+
+std::pair<BitVector<>, Block128Vector> RandomOtPool::GetReceiverStrings(
+    std::size_t offset, std::size_t number_of_ots) {
+  ROtReceiver* any_ot;
+  {
+    std::scoped_lock lock(mutex_);
+    any_ot = receiver_ots_.back().get();
+  }
+  any_ot->WaitSetup();
+
+  std::scoped_lock lock(mutex_);
+  for (; number_of_flattened_receiver_vectors_ < receiver_ots_.size() &&
+         receiver_strings_.size() < offset + number_of_ots;
+       ++number_of_flattened_receiver_vectors_) {
+    auto& ot = *receiver_ots_[number_of_flattened_receiver_vectors_];
+    ot.ComputeOutputs();
+    auto outputs = ot.GetOutputs();
+    const auto old_size = receiver_strings_.size();
+    receiver_strings_.resize(old_size + outputs.size());
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+      receiver_strings_[old_size + i] = Block128::MakeFromMemory(outputs[i].GetData().data());
+    }
+    receiver_choices_.Append(ot.GetChoices());
+  }
+  assert(offset + number_of_ots <= receiver_strings_.size());
+  return {receiver_choices_.Subset(offset, offset + number_of_ots),
+          Block128Vector(receiver_strings_.data() + offset,
+                         receiver_strings_.data() + offset + number_of_ots)};
+}
+
+// ---------- PooledOtSender ----------
+
+PooledOtSender::PooledOtSender(RandomOtPool& pool, std::size_t offset, std::size_t number_of_ots)
+    : pool_(pool),
+      offset_(offset),
+      number_of_ots_(number_of_ots),
+      corrections_future_(pool.data_.message_manager.RegisterReceive(
+          pool.data_.party_id, communication::MessageType::kPooledOtCorrections, offset)) {}
+
+void PooledOtSender::Derandomize() {
+  std::tie(strings_0_, strings_1_) = pool_.GetSenderStrings(offset_, number_of_ots_);
+  auto corrections_message{corrections_future_.get()};
+  BitSpan corrections(
+      const_cast<std::uint8_t*>(GetPayload(corrections_message, (number_of_ots_ + 7) / 8)),
+      number_of_ots_);
+  // after the swap, the receiver holds strings_0_[i] iff its choice is 0
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    if (corrections.Get(i)) std::swap(strings_0_[i], strings_1_[i]);
+  }
+}
+
+void PooledOtSender::SendGOts(std::span<const Block128> messages_0,
+                              std::span<const Block128> messages_1) {
+  assert(messages_0.size() == number_of_ots_ && messages_1.size() == number_of_ots_);
+  Derandomize();
+  Block128Vector buffer(2 * number_of_ots_);
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    buffer[2 * i] = messages_0[i] ^ strings_0_[i];
+    buffer[2 * i + 1] = messages_1[i] ^ strings_1_[i];
+  }
+  pool_.data_.send_function(communication::BuildMessage(
+      communication::MessageType::kPooledOtMessages, offset_, AsBytes(buffer)));
+}
+
+Block128Vector PooledOtSender::SendXcOts(std::span<const Block128> correlations) {
+  assert(correlations.size() == number_of_ots_);
+  Derandomize();
+  Block128Vector buffer(number_of_ots_);
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    buffer[i] = strings_0_[i] ^ strings_1_[i] ^ correlations[i];
+  }
+  pool_.data_.send_function(communication::BuildMessage(
+      communication::MessageType::kPooledOtMessages, offset_, AsBytes(buffer)));
+  return std::move(strings_0_);
+}
+
+template <typename T>
+std::vector<T> PooledOtSender::SendAcOts(std::span<const T> correlations) {
+  assert(correlations.size() == number_of_ots_);
+  Derandomize();
+  std::vector<T> outputs(number_of_ots_), buffer(number_of_ots_);
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    outputs[i] = GetRingElement<T>(strings_0_[i]);
+    buffer[i] = outputs[i] + correlations[i] - GetRingElement<T>(strings_1_[i]);
+  }
+  auto buffer_span{std::span(reinterpret_cast<const std::uint8_t*>(buffer.data()),
+                             buffer.size() * sizeof(T))};
+  pool_.data_.send_function(communication::BuildMessage(
+      communication::MessageType::kPooledOtMessages, offset_, buffer_span));
+  return outputs;
+}
+
+template std::vector<std::uint8_t> PooledOtSender::SendAcOts(std::span<const std::uint8_t>);
+template std::vector<std::uint16_t> PooledOtSender::SendAcOts(std::span<const std::uint16_t>);
+template std::vector<std::uint32_t> PooledOtSender::SendAcOts(std::span<const std::uint32_t>);
+template std::vector<std::uint64_t> PooledOtSender::SendAcOts(std::span<const std::uint64_t>);
+template std::vector<__uint128_t> PooledOtSender::SendAcOts(std::span<const __uint128_t>);
+
+// ---------- PooledOtReceiver ----------
+
+PooledOtReceiver::PooledOtReceiver(RandomOtPool& pool, std::size_t offset,
+                                   std::size_t number_of_ots)
+    : pool_(pool),
+      offset_(offset),
+      number_of_ots_(number_of_ots),
+      message_future_(pool.data_.message_manager.RegisterReceive(
+          pool.data_.party_id, communication::MessageType::kPooledOtMessages, offset)) {}
+
+void PooledOtReceiver::SetChoices(const BitVector<>& choices) {
+  if (choices.GetSize() != number_of_ots_) {
+    throw std::invalid_argument(fmt::format("expected {} choices for the pooled OTs, got {}",
+                                            number_of_ots_, choices.GetSize()));
+  }
+  BitVector<> random_choices;
+  std::tie(random_choices, strings_) = pool_.GetReceiverStrings(offset_, number_of_ots_);
+  choices_ = choices;
+  auto corrections = choices_ ^ random_choices;
+  auto buffer_span{std::span(reinterpret_cast<const std::uint8_t*>(corrections.GetData().data()),
+                             corrections.GetData().size())};
+  pool_.data_.send_function(communication::BuildMessage(
+      communication::MessageType::kPooledOtCorrections, offset_, buffer_span));
+}
+
+Block128Vector PooledOtReceiver::ReceiveGOts() {
+  if (choices_.GetSize() != number_of_ots_) {
+    throw std::runtime_error("Choices of pooled OTs must be set before receiving them");
+  }
+  auto message{message_future_.get()};
+  const auto* payload = GetPayload(message, 2 * number_of_ots_ * Block128::kBlockSize);
+  Block128Vector outputs(std::move(strings_));
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    const std::size_t index = 2 * i + (choices_.Get(i) ? 1 : 0);
+    outputs[i] ^= reinterpret_cast<const std::byte*>(payload + index * Block128::kBlockSize);
+  }
+  return outputs;
+}
+
+Block128Vector PooledOtReceiver::ReceiveXcOts() {
+  if (choices_.GetSize() != number_of_ots_) {
+    throw std::runtime_error("Choices of pooled OTs must be set before receiving them");
+  }
+  auto message{message_future_.get()};
+  const auto* payload = GetPayload(message, number_of_ots_ * Block128::kBlockSize);
+  Block128Vector outputs(std::move(strings_));
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    if (choices_.Get(i)) {
+      outputs[i] ^= reinterpret_cast<const std::byte*>(payload + i * Block128::kBlockSize);
+    }
+  }
+  return outputs;
+}
+
+template <typename T>
+std::vector<T> PooledOtReceiver::ReceiveAcOts() {
+  if (choices_.GetSize() != number_of_ots_) {
+    throw std::runtime_error("Choices of pooled OTs must be set before receiving them");
+  }
+  auto message{message_future_.get()};
+  const auto* payload = GetPayload(message, number_of_ots_ * sizeof(T));
+  std::vector<T> outputs(number_of_ots_);
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    outputs[i] = GetRingElement<T>(strings_[i]);
+    if (choices_.Get(i)) {
+      T correction;
+      std::memcpy(&correction, payload + i * sizeof(T), sizeof(T));
+      outputs[i] += correction;
+    }
+  }
+  return outputs;
+}
+
+template std::vector<std::uint8_t> PooledOtReceiver::ReceiveAcOts();
+template std::vector<std::uint16_t> PooledOtReceiver::ReceiveAcOts();
+template std::vector<std::uint32_t> PooledOtReceiver::ReceiveAcOts();
+template std::vector<std::uint64_t> PooledOtReceiver::ReceiveAcOts();
+template std::vector<__uint128_t> PooledOtReceiver::ReceiveAcOts();
+
+}  // namespace encrypto::motion
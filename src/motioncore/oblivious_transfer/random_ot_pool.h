@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "communication/message_manager.h"
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+
+namespace encrypto::motion {
+
+struct OtExtensionData;
+class OtProviderManager;
+class PooledOtReceiver;
+class PooledOtSender;
+class ROtReceiver;
+class ROtSender;
+
+// Pool of random 128 bit OTs in both directions with one peer, which are generated in bulk by the
+// OT provider and derandomized on demand into generic, XOR-correlated or additively-correlated OTs
+// (see PooledOtSender and PooledOtReceiver). Unlike the OT flavors, the consumers only need to
+// exist before the pool is exhausted, not before the setup. Both parties need to reserve the same
+// numbers of OTs and take them in the same order, the sender OTs of one party being the receiver
+// OTs of the other, and a taken OT needs to be taken by the peer before it derandomizes it since
+// its messages are only received if they are registered.
+class RandomOtPool {
+ public:
+  RandomOtPool(OtProviderManager& ot_provider_manager, OtExtensionData& data);
+
+  ~RandomOtPool();
+
+  RandomOtPool(const RandomOtPool&) = delete;
+
+  // registers number_of_ots random OTs in each direction with the OT provider, which needs to
+  // happen before the PreSetup of the provider
+  void Reserve(std::size_t number_of_ots);
+
+  // number of reserved sender OTs that are not taken yet, which equals that of the receiver OTs
+  // if both are taken alike
+  [[nodiscard]] std::size_t GetNumberOfAvailableSenderOts() const;
+  [[nodiscard]] std::size_t GetNumberOfAvailableReceiverOts() const;
+
+  // takes the next number_of_ots OTs of the pool, throws std::out_of_range if there are not enough
+  // of them left
+  [[nodiscard]] std::unique_ptr<PooledOtSender> TakeSender(std::size_t number_of_ots);
+  [[nodiscard]] std::unique_ptr<PooledOtReceiver> TakeReceiver(std::size_t number_of_ots);
+
+ private:
+  friend class PooledOtSender;
+  friend class PooledOtReceiver;
+
+  // copies both random strings of the sender OTs [offset, offset + number_of_ots), waits for the
+  // setup
+  std::pair<Block128Vector, Block128Vector> GetSenderStrings(std::size_t offset,
+                                                             std::size_t number_of_ots);
+
+  // copies the random choices and chosen strings of the receiver OTs [offset, offset +
+  // number_of_ots), waits for the setup
+  std::pair<BitVector<>, Block128Vector> GetReceiverStrings(std::size_t offset,
+                                                            std::size_t number_of_ots);
+
+  OtProviderManager& ot_provider_manager_;
+  OtExtensionData& data_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<ROtSender>> sender_ots_;
+  std::vector<std::unique_ptr<ROtReceiver>> receiver_ots_;
+  std::size_t number_of_reserved_ots_{0};
+  std::size_t sender_offset_{0};
+  std::size_t receiver_offset_{0};
+
+  // outputs of the first number_of_flattened_*_vectors_ OT vectors after the setup
+  std::size_t number_of_flattened_sender_vectors_{0};
+  std::size_t number_of_flattened_receiver_vectors_{0};
+  Block128Vector sender_strings_0_;
+  Block128Vector sender_strings_1_;
+  BitVector<> receiver_choices_;
+  Block128Vector receiver_strings_;
+};
+
+// sender side of OTs taken from a RandomOtPool, each object derandomizes its OTs exactly once into
+// one of the flavors after receiving the choice corrections d = b ^ c of the receiver
+class PooledOtSender {
+ public:
+  PooledOtSender(RandomOtPool& pool, std::size_t offset, std::size_t number_of_ots);
+
+  [[nodiscard]] std::size_t GetNumberOfOts() const noexcept { return number_of_ots_; }
+
+  // generic OTs, the receiver obtains messages_0[i] or messages_1[i]
+  void SendGOts(std::span<const Block128> messages_0, std::span<const Block128> messages_1);
+
+  // XOR-correlated OTs, returns x_0 where the receiver obtains x_0 or x_0 ^ correlations[i]
+  [[nodiscard]] Block128Vector SendXcOts(std::span<const Block128> correlations);
+
+  // additively-correlated OTs in the ring of T, returns x_0 where the receiver obtains x_0 or
+  // x_0 + correlations[i]
+  template <typename T>
+  [[nodiscard]] std::vector<T> SendAcOts(std::span<const T> correlations);
+
+ private:
+  // waits for the receiver's corrections and the random strings swapped by them
+  void Derandomize();
+
+  RandomOtPool& pool_;
+  const std::size_t offset_;
+  const std::size_t number_of_ots_;
+  ReusableFiberFuture<communication::MessageBuffer> corrections_future_;
+  Block128Vector strings_0_;
+  Block128Vector strings_1_;
+};
+
+// receiver side of OTs taken from a RandomOtPool, SetChoices() needs to be called before one of the
+// Receive* functions which matches the flavor chosen by the sender
+class PooledOtReceiver {
+ public:
+  PooledOtReceiver(RandomOtPool& pool, std::size_t offset, std::size_t number_of_ots);
+
+  [[nodiscard]] std::size_t GetNumberOfOts() const noexcept { return number_of_ots_; }
+
+  // sends the corrections of the random choices to the sender, waits for the setup
+  void SetChoices(const BitVector<>& choices);
+
+  [[nodiscard]] Block128Vector ReceiveGOts();
+
+  [[nodiscard]] Block128Vector ReceiveXcOts();
+
+  template <typename T>
+  [[nodiscard]] std::vector<T> ReceiveAcOts();
+
+ private:
+  RandomOtPool& pool_;
+  const std::size_t offset_;
+  const std::size_t number_of_ots_;
+  ReusableFiberFuture<communication::MessageBuffer> message_future_;
+  BitVector<> choices_;
+  Block128Vector strings_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,413 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "silent_ot_provider.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include "base/motion_base_provider.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "data_storage/base_ot_data.h"
+#include "data_storage/ot_extension_data.h"
+#include "oblivious_transfer/base_ots/base_ot_provider.h"
+#include "primitives/aes/aesni_primitives.h"
+#include "primitives/pseudo_random_generator.h"
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+#include "utility/constants.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// lower bound on the relative minimum distance of the expand-accumulate code, which determines
+// the weight of the noise for kKappa bits of security against linear attacks on LPN
+constexpr double kMinimumDistance{0.2};
+
+// tweaks of the TMMO function for the left and the right children in the GGM trees
+constexpr uint128_t kLeftChildTweak{0}, kRightChildTweak{1};
+
+// tweak of the TMMO function for masking the level sums, which is offset by the index of the COT
+constexpr uint128_t kLevelSumTweak{2};
+
+// number of OTs for which the positions in the code are generated at once
+constexpr std::size_t kCodeChunkSize{4096};
+
+bool GetBit(const Block128& block, std::size_t i) {
+  return (std::to_integer<unsigned>(block.byte_array[i / 8]) >> (i % 8)) & 1;
+}
+
+void SetBit(Block128& block, std::size_t i) {
+  block.byte_array[i / 8] |= std::byte(1 << (i % 8));
+}
+
+// transposes the kKappa rows of the bit matrix of the OT extension into one block per column
+Block128Vector TransposeRows(const std::vector<AlignedBitVector>& rows,
+                             std::size_t number_of_columns) {
+  auto columns{Block128Vector::MakeZero(number_of_columns)};
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    for (std::size_t j = 0; j < number_of_columns; ++j) {
+      if (rows[i].Get(j)) SetBit(columns[j], i);
+    }
+  }
+  return columns;
+}
+
+// expands the first number_of_parents nodes of a GGM tree in place to the next level, where node k
+// has the children 2k and 2k + 1. The parents are processed from the back, such that no parent is
+// overwritten before it is expanded.
+void ExpandLevel(const void* round_keys, Block128* nodes, std::size_t number_of_parents) {
+  std::array<Block128, 4> left, right;
+  left.fill(Block128::MakeZero());
+  right.fill(Block128::MakeZero());
+  for (std::size_t end = number_of_parents; end > 0;) {
+    const std::size_t begin{end - std::min<std::size_t>(end, left.size())};
+    std::copy(nodes + begin, nodes + end, left.begin());
+    std::copy(nodes + begin, nodes + end, right.begin());
+    AesniTmmoBatch4(round_keys, left.data(), kLeftChildTweak);
+    AesniTmmoBatch4(round_keys, right.data(), kRightChildTweak);
+    for (std::size_t i = end - begin; i-- > 0;) {
+      nodes[2 * (begin + i)] = left[i];
+      nodes[2 * (begin + i) + 1] = right[i];
+    }
+    end = begin;
+  }
+}
+
+// computes the prefix sums of the noise vector in place, which is the accumulating part of the code
+void Accumulate(Block128Vector& noise) {
+  for (std::size_t i = 1; i < noise.size(); ++i) {
+    noise[i] ^= noise[i - 1];
+  }
+}
+
+// calls function(i, positions) for each OT i with the kExpanderWeight positions of the
+// accumulated noise which are XORed into it. The positions are generated from the fixed AES key,
+// on which all parties agree, such that both parties of an OT use the same code.
+template <typename F>
+void ForEachCodeRow(std::size_t number_of_ots, std::size_t noise_length,
+                    const std::vector<std::uint8_t>& key, std::size_t number_of_threads,
+                    F&& function) {
+  constexpr auto kExpanderWeight{OtProviderFromSilentOt::kExpanderWeight};
+  const std::size_t number_of_chunks{(number_of_ots + kCodeChunkSize - 1) / kCodeChunkSize};
+#pragma omp parallel for num_threads(number_of_threads)
+  for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+    const std::size_t begin{chunk * kCodeChunkSize};
+    const std::size_t end{std::min(begin + kCodeChunkSize, number_of_ots)};
+    // one block of the key stream per position
+    primitives::Prg prg;
+    prg.SetKey(key.data());
+    prg.SetOffset(begin * kExpanderWeight);
+    const auto key_stream{prg.Encrypt((end - begin) * kExpanderWeight * Block128::kBlockSize)};
+    std::array<std::size_t, kExpanderWeight> positions;
+    for (std::size_t i = begin; i < end; ++i) {
+      for (std::size_t l = 0; l < kExpanderWeight; ++l) {
+        const auto offset{((i - begin) * kExpanderWeight + l) * Block128::kBlockSize};
+        positions[l] =
+            *reinterpret_cast<const std::uint64_t*>(key_stream.data() + offset) % noise_length;
+      }
+      function(i, positions);
+    }
+  }
+}
+
+// hashes a COT to the output of a random OT like the IKNP OT extension
+BitVector<> HashOutput(Block128 block, std::size_t bitlength, primitives::Prg& prg_fixed_key) {
+  prg_fixed_key.Mmo(block.data());
+  if (bitlength <= kKappa) {
+    BitVector<> output(block.data(), kKappa);
+    output.Resize(bitlength);
+    return output;
+  }
+  // string OT with bit length > 128 bit -> expand the seed
+  primitives::Prg prg_variable_key;
+  prg_variable_key.SetKey(block.data());
+  return prg_variable_key.KeyStreamBits(bitlength);
+}
+
+}  // namespace
+
+OtProviderFromSilentOt::OtProviderFromSilentOt(OtExtensionData& data,
+                                               BaseOtProvider& base_ot_provider,
+                                               BaseProvider& motion_base_provider,
+                                               std::size_t party_id)
+    : OtProviderFromRandomOts(data, party_id),
+      base_ot_provider_(base_ot_provider),
+      motion_base_provider_(motion_base_provider) {
+  receiver_masks_future_ = data_.message_manager.RegisterReceive(
+      party_id, communication::MessageType::kSilentOtReceiverMasks, 0);
+  sender_trees_future_ = data_.message_manager.RegisterReceive(
+      party_id, communication::MessageType::kSilentOtSenderTrees, 0);
+}
+
+std::size_t OtProviderFromSilentOt::GetNumberOfTrees() {
+  return static_cast<std::size_t>(
+      std::ceil(-static_cast<double>(kKappa) / std::log2(1 - 2 * kMinimumDistance)));
+}
+
+std::size_t OtProviderFromSilentOt::GetTreeDepth(std::size_t number_of_ots) {
+  const auto number_of_trees{GetNumberOfTrees()};
+  const auto leaves_per_tree{(kExpansionFactor * number_of_ots + number_of_trees - 1) /
+                             number_of_trees};
+  return std::max<std::size_t>(1, std::bit_width(leaves_per_tree - 1));
+}
+
+void OtProviderFromSilentOt::SendSetup() {
+  const std::size_t number_of_ots = sender_provider_.GetNumOts();
+  if (number_of_ots == 0) return;  // no OTs needed
+  data_.sender_data.bit_size = number_of_ots;
+
+  const auto number_of_trees{GetNumberOfTrees()};
+  const auto tree_depth{GetTreeDepth(number_of_ots)};
+  const std::size_t number_of_leaves{std::size_t(1) << tree_depth};
+  const std::size_t number_of_cots{number_of_trees * tree_depth};
+  const std::size_t byte_size{BitsToBytes(number_of_cots)};
+
+  const auto& base_ots_receiver_data =
+      base_ot_provider_.GetBaseOtsData(data_.party_id).GetReceiverData();
+
+  // bootstrap the COTs Q_j = T_j ^ b_j * Delta with the IKNP OT extension, where Delta consists
+  // of our choices in the base OTs
+  auto raw_message{receiver_masks_future_.get()};
+  auto payload{communication::GetMessage(raw_message.data())->payload()};
+  if (payload->size() != kKappa * byte_size) {
+    throw std::runtime_error(
+        fmt::format("Received {} B of silent OT receiver masks from Party#{} instead of {} B",
+                    payload->size(), data_.party_id, kKappa * byte_size));
+  }
+  std::vector<AlignedBitVector> rows(kKappa);
+  primitives::Prg prg_variable_key;
+  auto delta{Block128::MakeZero()};
+  for (std::size_t i = 0; i < kKappa; ++i) {
+    prg_variable_key.SetKey(base_ots_receiver_data.messages_c.at(data_.base_ot_offset + i).data());
+    prg_variable_key.SetOffset(data_.base_ot_offset);
+    rows[i] = prg_variable_key.KeyStreamBits<AlignedAllocator>(number_of_cots);
+    if (base_ots_receiver_data.c.Get(data_.base_ot_offset + i)) {
+      BitSpan bit_span_u(const_cast<std::uint8_t*>(payload->data() + i * byte_size),
+                         number_of_cots);
+      BitSpan bit_span_v(rows[i].GetMutableData().data(), number_of_cots, true);
+      bit_span_v ^= bit_span_u;
+      SetBit(delta, i);
+    }
+  }
+  const auto q{TransposeRows(rows, number_of_cots)};
+
+  const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(fixed_key_aes_key.data());
+
+  // masks of the left and the right level sums, of which the receiver can compute only the one
+  // given by its choice
+  Block128Vector masks(2 * number_of_cots);
+  for (std::size_t j = 0; j < number_of_cots; ++j) {
+    const auto q_xor_delta{q[j] ^ delta};
+    prg_fixed_key.FixedKeyAes(q[j].data(), kLevelSumTweak + j, masks[2 * j].data());
+    prg_fixed_key.FixedKeyAes(q_xor_delta.data(), kLevelSumTweak + j, masks[2 * j + 1].data());
+  }
+
+  // expand the GGM trees, whose leaves form the noise vector V
+  const std::size_t tree_message_size{2 * tree_depth + 1};
+  Block128Vector noise(number_of_trees * number_of_leaves);
+  Block128Vector tree_messages(number_of_trees * tree_message_size);
+  const auto round_keys{prg_fixed_key.GetRoundKeys()};
+#pragma omp parallel for num_threads(data_.number_of_threads)
+  for (std::size_t tree = 0; tree < number_of_trees; ++tree) {
+    auto leaves{noise.data() + tree * number_of_leaves};
+    auto tree_message{tree_messages.data() + tree * tree_message_size};
+    leaves[0].SetToRandom();
+    for (std::size_t level = 1; level <= tree_depth; ++level) {
+      ExpandLevel(round_keys, leaves, std::size_t(1) << (level - 1));
+      auto left_sum{Block128::MakeZero()}, right_sum{Block128::MakeZero()};
+      for (std::size_t k = 0; k < (std::size_t(1) << level); k += 2) {
+        left_sum ^= leaves[k];
+        right_sum ^= leaves[k + 1];
+      }
+      const auto cot{tree * tree_depth + level - 1};
+      tree_message[2 * (level - 1)] = left_sum ^ masks[2 * cot];
+      tree_message[2 * (level - 1) + 1] = right_sum ^ masks[2 * cot + 1];
+    }
+    // correction which shifts the punctured leaf of the receiver by Delta
+    auto correction{delta};
+    for (std::size_t k = 0; k < number_of_leaves; ++k) {
+      correction ^= leaves[k];
+    }
+    tree_message[2 * tree_depth] = correction;
+  }
+
+  auto message_span{std::span(reinterpret_cast<const std::uint8_t*>(tree_messages.data()),
+                              tree_messages.ByteSize())};
+  data_.send_function(
+      communication::BuildMessage(communication::MessageType::kSilentOtSenderTrees, 0,
+                                  message_span));
+
+  // compress V to the COTs Q_i and hash them to the random OTs
+  Accumulate(noise);
+  auto& y0{data_.sender_data.y0};
+  auto& y1{data_.sender_data.y1};
+  const auto& bitlengths{data_.sender_data.bitlengths};
+  ForEachCodeRow(number_of_ots, noise.size(), fixed_key_aes_key, data_.number_of_threads,
+                 [&](std::size_t i, const auto& positions) {
+                   auto q_i{Block128::MakeZero()};
+                   for (auto position : positions) q_i ^= noise[position];
+                   y0[i] = HashOutput(q_i, bitlengths[i], prg_fixed_key);
+                   y1[i] = HashOutput(q_i ^ delta, bitlengths[i], prg_fixed_key);
+                 });
+
+  // we are done with the setup for the sender side
+  data_.sender_data.SetSetupIsReady();
+  SetSetupIsReady();
+}
+
+void OtProviderFromSilentOt::ReceiveSetup() {
+  const std::size_t number_of_ots = receiver_provider_.GetNumOts();
+  if (number_of_ots == 0) return;  // nothing to do
+
+  const auto number_of_trees{GetNumberOfTrees()};
+  const auto tree_depth{GetTreeDepth(number_of_ots)};
+  const std::size_t number_of_leaves{std::size_t(1) << tree_depth};
+  const std::size_t number_of_cots{number_of_trees * tree_depth};
+  const std::size_t byte_size{BitsToBytes(number_of_cots)};
+
+  const auto& base_ots_sender_data =
+      base_ot_provider_.GetBaseOtsData(data_.party_id).GetSenderData();
+
+  // bootstrap the COTs T_j with random choices b_j with the IKNP OT extension
+  const auto choices{AlignedBitVector::SecureRandom(number_of_cots)};
+  std::vector<AlignedBitVector> rows(kKappa);
+  std::vector<std::uint8_t> receiver_masks(kKappa * byte_size);
+  primitives::Prg prg_variable_key;
+  for (std::size_t i = 0; i < kKappa; ++i) {
+    // T[i] = Prg(s_{i,0})
+    prg_variable_key.SetKey(base_ots_sender_data.messages_0.at(data_.base_ot_offset + i).data());
+    prg_variable_key.SetOffset(data_.base_ot_offset);
+    rows[i] = prg_variable_key.KeyStreamBits<AlignedAllocator>(number_of_cots);
+    // u_i = T[i] XOR b XOR Prg(s_{i,1})
+    auto u{rows[i] ^ choices};
+    prg_variable_key.SetKey(base_ots_sender_data.messages_1.at(data_.base_ot_offset + i).data());
+    prg_variable_key.SetOffset(data_.base_ot_offset);
+    u ^= prg_variable_key.KeyStreamBits<AlignedAllocator>(number_of_cots);
+    std::copy_n(reinterpret_cast<const std::uint8_t*>(u.GetData().data()), byte_size,
+                receiver_masks.data() + i * byte_size);
+  }
+  data_.send_function(communication::BuildMessage(
+      communication::MessageType::kSilentOtReceiverMasks, 0, receiver_masks));
+  const auto t{TransposeRows(rows, number_of_cots)};
+
+  const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(fixed_key_aes_key.data());
+
+  // masks of the level sums on the side of our choices
+  Block128Vector masks(number_of_cots);
+  for (std::size_t j = 0; j < number_of_cots; ++j) {
+    prg_fixed_key.FixedKeyAes(t[j].data(), kLevelSumTweak + j, masks[j].data());
+  }
+
+  const std::size_t tree_message_size{2 * tree_depth + 1};
+  auto raw_message{sender_trees_future_.get()};
+  auto payload{communication::GetMessage(raw_message.data())->payload()};
+  if (payload->size() != number_of_trees * tree_message_size * Block128::kBlockSize) {
+    throw std::runtime_error(
+        fmt::format("Received {} B of silent OT sender trees from Party#{} instead of {} B",
+                    payload->size(), data_.party_id,
+                    number_of_trees * tree_message_size * Block128::kBlockSize));
+  }
+  const Block128Vector tree_messages(number_of_trees * tree_message_size, payload->data());
+
+  // reconstruct the punctured GGM trees, whose leaves form the noise vector W = V ^ e * Delta,
+  // where the punctured leaf of each tree follows the negated choices
+  Block128Vector noise(number_of_trees * number_of_leaves);
+  std::vector<std::size_t> punctured_leaves(number_of_trees);
+  const auto round_keys{prg_fixed_key.GetRoundKeys()};
+#pragma omp parallel for num_threads(data_.number_of_threads)
+  for (std::size_t tree = 0; tree < number_of_trees; ++tree) {
+    auto leaves{noise.data() + tree * number_of_leaves};
+    auto tree_message{tree_messages.data() + tree * tree_message_size};
+    // index of the punctured node on the current level, which is zeroed
+    std::size_t path{0};
+    leaves[0].SetToZero();
+    for (std::size_t level = 1; level <= tree_depth; ++level) {
+      ExpandLevel(round_keys, leaves, std::size_t(1) << (level - 1));
+      // the level sum on the side of our choice yields the corresponding child of the punctured
+      // node
+      const auto cot{tree * tree_depth + level - 1};
+      const std::size_t choice{choices.Get(cot)};
+      const auto known_child{2 * path + choice};
+      auto sum{tree_message[2 * (level - 1) + choice] ^ masks[cot]};
+      for (std::size_t k = choice; k < (std::size_t(1) << level); k += 2) {
+        if (k != known_child) sum ^= leaves[k];
+      }
+      leaves[known_child] = sum;
+      path = 2 * path + (1 - choice);
+      leaves[path].SetToZero();
+    }
+    auto punctured_leaf{tree_message[2 * tree_depth]};
+    for (std::size_t k = 0; k < number_of_leaves; ++k) {
+      punctured_leaf ^= leaves[k];
+    }
+    leaves[path] = punctured_leaf;
+    punctured_leaves[tree] = tree * number_of_leaves + path;
+  }
+
+  // compress W to the COTs T_i and e to the choices r_i, and hash the COTs to the random OTs
+  Accumulate(noise);
+  BitVector<> accumulated_noise(noise.size());
+  // the prefix sums of e are one between every even and the following odd punctured leaf
+  for (std::size_t tree = 0; tree < number_of_trees; ++tree) {
+    const auto end{tree + 1 < number_of_trees ? punctured_leaves[tree + 1] : noise.size()};
+    if (tree % 2 == 0) {
+      for (auto k = punctured_leaves[tree]; k < end; ++k) accumulated_noise.Set(true, k);
+    }
+  }
+  auto random_choices{std::make_unique<AlignedBitVector>(number_of_ots)};
+  auto& outputs{data_.receiver_data.outputs};
+  const auto& bitlengths{data_.receiver_data.bitlengths};
+  ForEachCodeRow(number_of_ots, noise.size(), fixed_key_aes_key, data_.number_of_threads,
+                 [&](std::size_t i, const auto& positions) {
+                   auto t_i{Block128::MakeZero()};
+                   bool r_i{false};
+                   for (auto position : positions) {
+                     t_i ^= noise[position];
+                     r_i ^= accumulated_noise.Get(position);
+                   }
+                   random_choices->Set(r_i, i);
+                   outputs[i] = HashOutput(t_i, bitlengths[i], prg_fixed_key);
+                 });
+  data_.receiver_data.random_choices = std::move(random_choices);
+
+  data_.receiver_data.SetSetupIsReady();
+  SetSetupIsReady();
+}
+
+void OtProviderFromSilentOt::PreSetup() {
+  if (HasWork()) {
+    data_.base_ot_offset = base_ot_provider_.Request(kKappa, data_.party_id);
+  }
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+
+#include "communication/message_buffer.h"
+#include "oblivious_transfer/ot_provider.h"
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion {
+
+// Provides random OTs from a pseudorandom correlation generator (silent OT) in the style of
+// Boyle et al. (https://eprint.iacr.org/2019/1159) instead of the IKNP OT extension:
+//
+// 1. A few correlated OTs are bootstrapped from kKappa base OTs with the IKNP OT extension.
+// 2. They are used to compute t punctured GGM trees, which yields a correlation W = V ^ e * Delta
+//    for a vector e of regular noise of weight t and length N >= kExpansionFactor * n.
+// 3. Both parties compress their vectors locally with the transposed expand-accumulate code of
+//    Boyle et al. (https://eprint.iacr.org/2022/1014), i.e., accumulate and then XOR
+//    kExpanderWeight pseudorandom positions per OT, which yields n correlated OTs.
+// 4. The correlated OTs are hashed to random OTs like in the IKNP OT extension.
+//
+// The communication is logarithmic in the number of OTs n, and only one message is sent in
+// each direction.
+class OtProviderFromSilentOt final : public OtProviderFromRandomOts {
+ public:
+  // number of non-zero entries in every column of the expanding matrix of the code
+  static constexpr std::size_t kExpanderWeight{7};
+  // ratio between the length of the noise vector and the number of OTs
+  static constexpr std::size_t kExpansionFactor{2};
+
+  OtProviderFromSilentOt(OtExtensionData& data, BaseOtProvider& base_ot_provider, BaseProvider&,
+                         std::size_t party_id);
+
+  void SendSetup() final;
+
+  void ReceiveSetup() final;
+
+  void PreSetup() final;
+
+  // number of punctured GGM trees, i.e., the weight of the noise vector
+  static std::size_t GetNumberOfTrees();
+
+  // depth of the GGM trees for the given number of OTs
+  static std::size_t GetTreeDepth(std::size_t number_of_ots);
+
+ private:
+  BaseOtProvider& base_ot_provider_;
+  BaseProvider& motion_base_provider_;
+  ReusableFiberFuture<communication::MessageBuffer> receiver_masks_future_;
+  ReusableFiberFuture<communication::MessageBuffer> sender_trees_future_;
+};
+
+}  // namespace encrypto::motion
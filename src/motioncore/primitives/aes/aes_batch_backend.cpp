@@ -0,0 +1,159 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "aes_batch_backend.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "aesni_primitives.h"
+
+namespace encrypto::motion::primitives {
+
+namespace {
+
+// runs function(first, count) on consecutive chunks of [0, number_of_items) whose sizes are
+// multiples of granularity, using a thread for all but the first chunk
+template <typename Function>
+void ForEachChunk(std::size_t number_of_items, std::size_t granularity,
+                  std::size_t number_of_threads, std::size_t minimum_chunk_size,
+                  Function&& function) {
+  const std::size_t number_of_chunks{std::clamp<std::size_t>(
+      number_of_items / std::max<std::size_t>(minimum_chunk_size, 1), 1, number_of_threads)};
+  const std::size_t number_of_groups{number_of_items / granularity};
+  const std::size_t chunk_size{(number_of_groups + number_of_chunks - 1) / number_of_chunks *
+                               granularity};
+  if (number_of_chunks == 1 || chunk_size == 0) {
+    function(0, number_of_items);
+    return;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(number_of_chunks - 1);
+  for (std::size_t first = chunk_size; first < number_of_items; first += chunk_size) {
+    threads.emplace_back(
+        [&function, first, count = std::min(chunk_size, number_of_items - first)] {
+          function(first, count);
+        });
+  }
+  function(0, std::min(chunk_size, number_of_items));
+  for (auto& thread : threads) thread.join();
+}
+
+std::mutex aes_batch_backend_mutex;
+std::shared_ptr<AesBatchBackend> aes_batch_backend;
+
+}  // namespace
+
+ThreadedAesBatchBackend::ThreadedAesBatchBackend(std::size_t number_of_threads,
+                                                 std::size_t minimum_batch_size)
+    : number_of_threads_(number_of_threads), minimum_batch_size_(minimum_batch_size) {
+  if (number_of_threads_ == 0) {
+    throw std::invalid_argument("ThreadedAesBatchBackend needs at least one thread");
+  }
+}
+
+void ThreadedAesBatchBackend::Tmmo(const void* round_keys, void* const* inputs,
+                                   std::size_t number_of_blocks, __uint128_t tweak) {
+  ForEachChunk(number_of_blocks, 1, number_of_threads_, minimum_batch_size_,
+               [=](std::size_t first, std::size_t count) {
+                 AesniTmmoBatch(round_keys, inputs + first, count, tweak + first);
+               });
+}
+
+void ThreadedAesBatchBackend::TmmoContiguous(const void* round_keys, void* input,
+                                             std::size_t number_of_blocks, __uint128_t tweak,
+                                             std::size_t blocks_per_tweak) {
+  auto* blocks{static_cast<std::byte*>(input)};
+  // chunks start at a tweak boundary, such that each chunk continues the tweaks
+  ForEachChunk(number_of_blocks, blocks_per_tweak, number_of_threads_, minimum_batch_size_,
+               [=](std::size_t first, std::size_t count) {
+                 AesniTmmoBatchContiguous(round_keys, blocks + first * kAesBlockSize, count,
+                                          tweak + first / blocks_per_tweak, blocks_per_tweak);
+               });
+}
+
+void ThreadedAesBatchBackend::BmrDkc(const void* round_keys, const void* keys_a,
+                                     const void* keys_b, const std::uint64_t* gate_ids,
+                                     std::size_t number_of_tuples, std::size_t number_of_parties,
+                                     void* output) {
+  const auto* a{static_cast<const std::byte*>(keys_a)};
+  const auto* b{static_cast<const std::byte*>(keys_b)};
+  auto* out{static_cast<std::byte*>(output)};
+  // each tuple encrypts number_of_parties blocks
+  const std::size_t minimum_tuples{minimum_batch_size_ /
+                                   std::max<std::size_t>(number_of_parties, 1)};
+  ForEachChunk(number_of_tuples, 1, number_of_threads_, minimum_tuples,
+               [=](std::size_t first, std::size_t count) {
+                 AesniBmrDkcBatch(round_keys, a + first * kAesBlockSize,
+                                  b + first * kAesBlockSize, gate_ids + first, count,
+                                  number_of_parties,
+                                  out + first * number_of_parties * kAesBlockSize);
+               });
+}
+
+void SetAesBatchBackend(std::shared_ptr<AesBatchBackend> backend) {
+  std::scoped_lock lock(aes_batch_backend_mutex);
+  aes_batch_backend = std::move(backend);
+}
+
+std::shared_ptr<AesBatchBackend> GetAesBatchBackend() {
+  std::scoped_lock lock(aes_batch_backend_mutex);
+  return aes_batch_backend;
+}
+
+void AesBatchTmmo(const void* round_keys, void* const* inputs, std::size_t number_of_blocks,
+                  __uint128_t tweak) {
+  if (auto backend{GetAesBatchBackend()};
+      backend && number_of_blocks >= backend->GetMinimumBatchSize()) {
+    backend->Tmmo(round_keys, inputs, number_of_blocks, tweak);
+  } else {
+    AesniTmmoBatch(round_keys, inputs, number_of_blocks, tweak);
+  }
+}
+
+void AesBatchTmmoContiguous(const void* round_keys, void* input, std::size_t number_of_blocks,
+                            __uint128_t tweak, std::size_t blocks_per_tweak) {
+  if (auto backend{GetAesBatchBackend()};
+      backend && number_of_blocks >= backend->GetMinimumBatchSize()) {
+    backend->TmmoContiguous(round_keys, input, number_of_blocks, tweak, blocks_per_tweak);
+  } else {
+    AesniTmmoBatchContiguous(round_keys, input, number_of_blocks, tweak, blocks_per_tweak);
+  }
+}
+
+void AesBatchBmrDkc(const void* round_keys, const void* keys_a, const void* keys_b,
+                    const std::uint64_t* gate_ids, std::size_t number_of_tuples,
+                    std::size_t number_of_parties, void* output) {
+  if (auto backend{GetAesBatchBackend()};
+      backend && number_of_tuples * number_of_parties >= backend->GetMinimumBatchSize()) {
+    backend->BmrDkc(round_keys, keys_a, keys_b, gate_ids, number_of_tuples, number_of_parties,
+                    output);
+  } else {
+    AesniBmrDkcBatch(round_keys, keys_a, keys_b, gate_ids, number_of_tuples, number_of_parties,
+                     output);
+  }
+}
+
+}  // namespace encrypto::motion::primitives
@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace encrypto::motion::primitives {
+
+// Backend for the large batches of fixed-key AES hashes in garbling, in the garbled rows of BMR
+// AND gates and in the OT extension, which are independent for every block. The functions below
+// pass batches of at least GetMinimumBatchSize() blocks to the registered backend, e.g., an
+// accelerator that overlaps its host-device transfers of one chunk with the encryption of the
+// previous chunk, and compute smaller batches with the AES-NI primitives. The semantics of each
+// function equal those of the AES-NI primitive with the same name.
+class AesBatchBackend {
+ public:
+  virtual ~AesBatchBackend() = default;
+
+  virtual std::size_t GetMinimumBatchSize() const = 0;
+
+  // see AesniTmmoBatch
+  virtual void Tmmo(const void* round_keys, void* const* inputs, std::size_t number_of_blocks,
+                    __uint128_t tweak) = 0;
+
+  // see AesniTmmoBatchContiguous
+  virtual void TmmoContiguous(const void* round_keys, void* input, std::size_t number_of_blocks,
+                              __uint128_t tweak, std::size_t blocks_per_tweak) = 0;
+
+  // see AesniBmrDkcBatch
+  virtual void BmrDkc(const void* round_keys, const void* keys_a, const void* keys_b,
+                      const std::uint64_t* gate_ids, std::size_t number_of_tuples,
+                      std::size_t number_of_parties, void* output) = 0;
+};
+
+// Splits the batches into chunks of at least minimum_batch_size blocks that are computed with the
+// AES-NI primitives on number_of_threads threads
+class ThreadedAesBatchBackend : public AesBatchBackend {
+ public:
+  ThreadedAesBatchBackend(std::size_t number_of_threads, std::size_t minimum_batch_size = 1 << 14);
+
+  std::size_t GetMinimumBatchSize() const override { return minimum_batch_size_; }
+
+  void Tmmo(const void* round_keys, void* const* inputs, std::size_t number_of_blocks,
+            __uint128_t tweak) override;
+
+  void TmmoContiguous(const void* round_keys, void* input, std::size_t number_of_blocks,
+                      __uint128_t tweak, std::size_t blocks_per_tweak) override;
+
+  void BmrDkc(const void* round_keys, const void* keys_a, const void* keys_b,
+              const std::uint64_t* gate_ids, std::size_t number_of_tuples,
+              std::size_t number_of_parties, void* output) override;
+
+ private:
+  std::size_t number_of_threads_;
+  std::size_t minimum_batch_size_;
+};
+
+// registers the backend used by all parties of the process, or removes it if backend is empty
+void SetAesBatchBackend(std::shared_ptr<AesBatchBackend> backend);
+
+std::shared_ptr<AesBatchBackend> GetAesBatchBackend();
+
+void AesBatchTmmo(const void* round_keys, void* const* inputs, std::size_t number_of_blocks,
+                  __uint128_t tweak);
+
+void AesBatchTmmoContiguous(const void* round_keys, void* input, std::size_t number_of_blocks,
+                            __uint128_t tweak, std::size_t blocks_per_tweak);
+
+void AesBatchBmrDkc(const void* round_keys, const void* keys_a, const void* keys_b,
+                    const std::uint64_t* gate_ids, std::size_t number_of_tuples,
+                    std::size_t number_of_parties, void* output);
+
+}  // namespace encrypto::motion::primitives
@@ -25,6 +25,8 @@
 #include <algorithm>
 #include <array>
 
+#include "utility/bit_vector.h"
+
 template <int round_constant>
 static __m128i AesKeyExpand(__m128i xmm1) {
   // aeskeygenassist xmm3, xmm1, \rcon
@@ -89,126 +91,182 @@ void AesniKeyExpansion128(void* round_keys_input) {
   // movdqa 0xa0[rdi], xmm1
 }
 
-void AesniCtrStreamBlocks128(const void* round_keys_input, std::uint64_t* counter_input_pointer,
-                             void* output_input_pointer, std::size_t number_of_blocks) {
-  alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
-  alignas(16) std::array<__m128i, 4> wb;
-  auto counter = *counter_input_pointer;
-
-  // we assume the output buffer is aligned
-  auto output =
-      reinterpret_cast<__m128i*>(__builtin_assume_aligned(output_input_pointer, kAesBlockSize));
+// the counter occupies the low half of a block in AesniCtrStreamBlocks128 and the high half in
+// AesniCtrStreamBlocks128WithNonce, where the other half holds the nonce
+enum class CounterHalf { kLow, kHigh };
+
+// encrypts the counters counter, ..., counter + kBatchSize - 1 in parallel, where kBatchSize = 4
+// hides the latency of the aesenc instructions
+template <std::size_t kBatchSize, CounterHalf kCounterHalf>
+static inline void AesniCtrBatch(const std::array<__m128i, kAesNumRoundKeys128>& round_keys,
+                                 std::uint64_t nonce, std::uint64_t counter, __m128i* output) {
+  std::array<__m128i, kBatchSize> wb;
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    const auto block{kCounterHalf == CounterHalf::kLow ? _mm_set_epi64x(nonce, counter + j)
+                                                       : _mm_set_epi64x(counter + j, nonce)};
+    wb[j] = _mm_xor_si128(block, round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kBatchSize; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    _mm_storeu_si128(output + j, _mm_aesenclast_si128(wb[j], round_keys[10]));
+  }
+}
 
-  // copy the round keys onto the stack
-  // -> compiler will put them into registers
-  std::copy(reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)),
-            reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
-                kAesNumRoundKeys128,
-            round_keys.data());
+// encrypts the counters in batches of 16 blocks, i.e., four 512-bit registers of four blocks each,
+// and returns the number of blocks written, which is a multiple of 16
+template <CounterHalf kCounterHalf>
+__attribute__((target("avx512f,vaes"))) static std::size_t AesniCtrStreamVaes512(
+    const std::array<__m128i, kAesNumRoundKeys128>& round_keys_128, std::uint64_t nonce,
+    std::uint64_t counter, __m128i* output, std::size_t number_of_blocks) {
+  constexpr std::size_t kNumberOfRegisters{4}, kBatchSize{4 * kNumberOfRegisters};
+  std::array<__m512i, kAesNumRoundKeys128> round_keys;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    round_keys[r] = _mm512_broadcast_i32x4(round_keys_128[r]);
+  }
+  // the blocks of a register hold consecutive counters
+  __m512i counters, increment;
+  if constexpr (kCounterHalf == CounterHalf::kLow) {
+    counters = _mm512_set_epi64(nonce, counter + 3, nonce, counter + 2, nonce, counter + 1, nonce,
+                                counter);
+    increment = _mm512_set_epi64(0, 4, 0, 4, 0, 4, 0, 4);
+  } else {
+    counters = _mm512_set_epi64(counter + 3, nonce, counter + 2, nonce, counter + 1, nonce,
+                                counter, nonce);
+    increment = _mm512_set_epi64(4, 0, 4, 0, 4, 0, 4, 0);
+  }
 
-  // do as many blocks as possible in 4er batches
-  // since the aesenc instructions have a latency of 4
-  auto batch_blocks = number_of_blocks & (~0b11);
-  for (size_t i = 0; i < batch_blocks; i += 4) {
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_set_epi64x(0, counter + j);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_xor_si128(wb[j], round_keys[0]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[1]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[2]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[3]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[4]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[5]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[6]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[7]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[8]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[9]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenclast_si128(wb[j], round_keys[10]);
-    for (std::size_t j = 0; j < 4; ++j) output[i + j] = wb[j];
-    counter += 4;
+  std::array<__m512i, kNumberOfRegisters> wb;
+  std::size_t i{0};
+  for (; i + kBatchSize <= number_of_blocks; i += kBatchSize) {
+    for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+      wb[j] = _mm512_xor_si512(counters, round_keys[0]);
+      counters = _mm512_add_epi64(counters, increment);
+    }
+    for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+      for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+        wb[j] = _mm512_aesenc_epi128(wb[j], round_keys[r]);
+      }
+    }
+    for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+      _mm512_storeu_si512(output + i + 4 * j, _mm512_aesenclast_epi128(wb[j], round_keys[10]));
+    }
   }
+  return i;
+}
 
-  // do the remaining blocks
-  for (size_t i = batch_blocks; i < number_of_blocks; ++i) {
-    wb[0] = _mm_set_epi64x(0, counter);
-    wb[0] = _mm_xor_si128(wb[0], round_keys[0]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[1]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[2]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[3]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[4]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[5]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[6]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[7]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[8]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[9]);
-    wb[0] = _mm_aesenclast_si128(wb[0], round_keys[10]);
-    output[i] = wb[0];
-    ++counter;
+// encrypts the counters in batches of 8 blocks, i.e., four 256-bit registers of two blocks each,
+// for CPUs with VAES but without AVX-512, and returns the number of blocks written
+template <CounterHalf kCounterHalf>
+__attribute__((target("avx2,vaes"))) static std::size_t AesniCtrStreamVaes256(
+    const std::array<__m128i, kAesNumRoundKeys128>& round_keys_128, std::uint64_t nonce,
+    std::uint64_t counter, __m128i* output, std::size_t number_of_blocks) {
+  constexpr std::size_t kNumberOfRegisters{4}, kBatchSize{2 * kNumberOfRegisters};
+  std::array<__m256i, kAesNumRoundKeys128> round_keys;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    round_keys[r] = _mm256_broadcastsi128_si256(round_keys_128[r]);
+  }
+  __m256i counters, increment;
+  if constexpr (kCounterHalf == CounterHalf::kLow) {
+    counters = _mm256_set_epi64x(nonce, counter + 1, nonce, counter);
+    increment = _mm256_set_epi64x(0, 2, 0, 2);
+  } else {
+    counters = _mm256_set_epi64x(counter + 1, nonce, counter, nonce);
+    increment = _mm256_set_epi64x(2, 0, 2, 0);
   }
 
-  // write the new counter back
-  *counter_input_pointer = counter;
+  std::array<__m256i, kNumberOfRegisters> wb;
+  std::size_t i{0};
+  for (; i + kBatchSize <= number_of_blocks; i += kBatchSize) {
+    for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+      wb[j] = _mm256_xor_si256(counters, round_keys[0]);
+      counters = _mm256_add_epi64(counters, increment);
+    }
+    for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+      for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+        wb[j] = _mm256_aesenc_epi128(wb[j], round_keys[r]);
+      }
+    }
+    for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i + 2 * j),
+                          _mm256_aesenclast_epi128(wb[j], round_keys[10]));
+    }
+  }
+  return i;
 }
 
-void AesniCtrStreamBlocks128Unaligned(const void* round_keys_input,
-                                      std::uint64_t* counter_input_pointer,
-                                      void* output_input_pointer, std::size_t number_of_blocks) {
-  // almost the same code as in `AesniCtrStreamBlocks128`
+// the VAES kernels are used for at least kMinimumVaesBlocks blocks if the CPU supports VAES, where
+// the selected bitwise kernel determines the width, see encrypto::motion::SetBitwiseKernel
+constexpr std::size_t kMinimumVaesBlocks{16};
 
+template <CounterHalf kCounterHalf>
+static void AesniCtrStream(const void* round_keys_input, std::uint64_t nonce,
+                           std::uint64_t* counter_input_pointer, __m128i* output,
+                           std::size_t number_of_blocks) {
+  constexpr std::size_t kBatchSize{4};
   alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
-  alignas(16) std::array<__m128i, 4> wb;
-  auto counter = *counter_input_pointer;
-
-  // DIFFERENCE: we no longer assume that the output buffer is aligned
-  auto output = reinterpret_cast<__m128i*>(output_input_pointer);
+  const auto counter = *counter_input_pointer;
 
   // copy the round keys onto the stack
   // -> compiler will put them into registers
-  std::copy(reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)),
-            reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
+  std::copy(reinterpret_cast<const __m128i*>(
+                __builtin_assume_aligned(round_keys_input, kAesBlockSize)),
+            reinterpret_cast<const __m128i*>(
+                __builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
                 kAesNumRoundKeys128,
             round_keys.data());
 
-  // do as many blocks as possible in batches of 4
-  // since the aesenc instructions have a latency of 4
-  auto batch_blocks = number_of_blocks & (~0b11);
-  for (size_t i = 0; i < batch_blocks; i += 4) {
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_set_epi64x(0, counter + j);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_xor_si128(wb[j], round_keys[0]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[1]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[2]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[3]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[4]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[5]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[6]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[7]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[8]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[9]);
-    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenclast_si128(wb[j], round_keys[10]);
-    // DIFFERENCE: we need to use an explicit unaligned store here
-    for (std::size_t j = 0; j < 4; ++j) _mm_storeu_si128(&output[i + j], wb[j]);
-    counter += 4;
+  std::size_t i{0};
+  if (number_of_blocks >= kMinimumVaesBlocks) {
+    static const bool kHasVaes = __builtin_cpu_supports("vaes");
+    if (kHasVaes) {
+      switch (encrypto::motion::GetBitwiseKernel()) {
+        case encrypto::motion::BitwiseKernel::kAvx512:
+          i = AesniCtrStreamVaes512<kCounterHalf>(round_keys, nonce, counter, output,
+                                                  number_of_blocks);
+          break;
+        case encrypto::motion::BitwiseKernel::kAvx2:
+          i = AesniCtrStreamVaes256<kCounterHalf>(round_keys, nonce, counter, output,
+                                                  number_of_blocks);
+          break;
+        case encrypto::motion::BitwiseKernel::kSse:
+          break;
+      }
+    }
+  }
+  for (; i + kBatchSize <= number_of_blocks; i += kBatchSize) {
+    AesniCtrBatch<kBatchSize, kCounterHalf>(round_keys, nonce, counter + i, output + i);
   }
-
   // do the remaining blocks
-  for (size_t i = batch_blocks; i < number_of_blocks; ++i) {
-    wb[0] = _mm_set_epi64x(0, counter);
-    wb[0] = _mm_xor_si128(wb[0], round_keys[0]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[1]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[2]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[3]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[4]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[5]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[6]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[7]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[8]);
-    wb[0] = _mm_aesenc_si128(wb[0], round_keys[9]);
-    wb[0] = _mm_aesenclast_si128(wb[0], round_keys[10]);
-    // DIFFERENCE: we need to use an explicit unaligned store here
-    _mm_storeu_si128(&output[i], wb[0]);
-    ++counter;
+  for (; i < number_of_blocks; ++i) {
+    AesniCtrBatch<1, kCounterHalf>(round_keys, nonce, counter + i, output + i);
   }
 
   // write the new counter back
-  *counter_input_pointer = counter;
+  *counter_input_pointer = counter + number_of_blocks;
+}
+
+void AesniCtrStreamBlocks128(const void* round_keys, std::uint64_t* counter, void* output,
+                             std::size_t number_of_blocks) {
+  // we assume the output buffer is aligned
+  AesniCtrStream<CounterHalf::kLow>(
+      round_keys, 0, counter,
+      reinterpret_cast<__m128i*>(__builtin_assume_aligned(output, kAesBlockSize)),
+      number_of_blocks);
+}
+
+void AesniCtrStreamBlocks128Unaligned(const void* round_keys, std::uint64_t* counter, void* output,
+                                      std::size_t number_of_blocks) {
+  AesniCtrStream<CounterHalf::kLow>(round_keys, 0, counter, reinterpret_cast<__m128i*>(output),
+                                    number_of_blocks);
+}
+
+void AesniCtrStreamBlocks128WithNonce(const void* round_keys, std::uint64_t nonce,
+                                      std::uint64_t* counter, void* output,
+                                      std::size_t number_of_blocks) {
+  AesniCtrStream<CounterHalf::kHigh>(round_keys, nonce, counter,
+                                     reinterpret_cast<__m128i*>(output), number_of_blocks);
 }
 
 void AesniCtrStreamSingleBlock128Unaligned(const void* round_keys_input, std::uint64_t* counter,
@@ -382,6 +440,186 @@ void AesniTmmoBatch3(const void* round_keys_input, void* input, __uint128_t twea
   for (std::size_t j = 0; j < 3; ++j) input_pointer[j] = _mm_xor_si128(wb_2[j], wb_1[j]);
 }
 
+template <std::size_t kBatchSize>
+static void AesniTmmoScattered(const std::array<__m128i, kAesNumRoundKeys128>& round_keys,
+                               void* const* inputs, __uint128_t tweak) {
+  alignas(16) std::array<__m128i, kBatchSize> wb_1;
+  alignas(16) std::array<__m128i, kBatchSize> wb_2;
+
+  // compute wb_1 <- \pi(x)
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    wb_1[j] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inputs[j])),
+                            round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kBatchSize; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    wb_1[j] = _mm_aesenclast_si128(wb_1[j], round_keys[10]);
+  }
+
+  // compute wb_2 <- \pi(\pi(x) ^ i)
+  for (std::size_t j = 0; j < kBatchSize; ++j, ++tweak) {
+    wb_2[j] = _mm_xor_si128(wb_1[j], *reinterpret_cast<const __m128i*>(&tweak));
+    wb_2[j] = _mm_xor_si128(wb_2[j], round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kBatchSize; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    wb_2[j] = _mm_aesenclast_si128(wb_2[j], round_keys[10]);
+  }
+
+  // store \pi(\pi(x) ^ i) ^ \pi(x)
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(inputs[j]), _mm_xor_si128(wb_2[j], wb_1[j]));
+  }
+}
+
+void AesniTmmoBatch(const void* round_keys_input, void* const* inputs, std::size_t number_of_blocks,
+                    __uint128_t tweak) {
+  constexpr std::size_t kBatchSize{8};
+  alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
+
+  // copy the round keys onto the stack
+  // -> compiler will put them into registers
+  std::copy(reinterpret_cast<const __m128i*>(
+                __builtin_assume_aligned(round_keys_input, kAesBlockSize)),
+            reinterpret_cast<const __m128i*>(
+                __builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
+                kAesNumRoundKeys128,
+            round_keys.data());
+
+  std::size_t j = 0;
+  for (; j + kBatchSize <= number_of_blocks; j += kBatchSize) {
+    AesniTmmoScattered<kBatchSize>(round_keys, inputs + j, tweak + j);
+  }
+  // do the remaining blocks
+  for (; j < number_of_blocks; ++j) {
+    AesniTmmoScattered<1>(round_keys, inputs + j, tweak + j);
+  }
+}
+
+template <std::size_t kBatchSize>
+static void AesniTmmoContiguous(const std::array<__m128i, kAesNumRoundKeys128>& round_keys,
+                                __m128i* blocks, const __m128i* tweaks) {
+  alignas(16) std::array<__m128i, kBatchSize> wb_1;
+  alignas(16) std::array<__m128i, kBatchSize> wb_2;
+
+  // compute wb_1 <- \pi(x)
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    wb_1[j] = _mm_xor_si128(_mm_loadu_si128(blocks + j), round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kBatchSize; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    wb_1[j] = _mm_aesenclast_si128(wb_1[j], round_keys[10]);
+  }
+
+  // compute wb_2 <- \pi(\pi(x) ^ i)
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    wb_2[j] = _mm_xor_si128(_mm_xor_si128(wb_1[j], tweaks[j]), round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kBatchSize; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    wb_2[j] = _mm_aesenclast_si128(wb_2[j], round_keys[10]);
+  }
+
+  // store \pi(\pi(x) ^ i) ^ \pi(x)
+  for (std::size_t j = 0; j < kBatchSize; ++j) {
+    _mm_storeu_si128(blocks + j, _mm_xor_si128(wb_2[j], wb_1[j]));
+  }
+}
+
+#ifdef MOTION_AVX512_VAES
+// processes 4 * kNumberOfRegisters blocks, four per 512-bit register
+template <std::size_t kNumberOfRegisters>
+static void AesniTmmoContiguousVaes(const std::array<__m512i, kAesNumRoundKeys128>& round_keys,
+                                    __m128i* blocks, const __m128i* tweaks) {
+  std::array<__m512i, kNumberOfRegisters> wb_1;
+  std::array<__m512i, kNumberOfRegisters> wb_2;
+
+  // compute wb_1 <- \pi(x)
+  for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+    wb_1[j] = _mm512_xor_si512(_mm512_loadu_si512(blocks + 4 * j), round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+      wb_1[j] = _mm512_aesenc_epi128(wb_1[j], round_keys[r]);
+    }
+  }
+  for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+    wb_1[j] = _mm512_aesenclast_epi128(wb_1[j], round_keys[10]);
+  }
+
+  // compute wb_2 <- \pi(\pi(x) ^ i)
+  for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+    wb_2[j] = _mm512_xor_si512(_mm512_xor_si512(wb_1[j], _mm512_loadu_si512(tweaks + 4 * j)),
+                               round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+      wb_2[j] = _mm512_aesenc_epi128(wb_2[j], round_keys[r]);
+    }
+  }
+  for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+    wb_2[j] = _mm512_aesenclast_epi128(wb_2[j], round_keys[10]);
+  }
+
+  // store \pi(\pi(x) ^ i) ^ \pi(x)
+  for (std::size_t j = 0; j < kNumberOfRegisters; ++j) {
+    _mm512_storeu_si512(blocks + 4 * j, _mm512_xor_si512(wb_2[j], wb_1[j]));
+  }
+}
+#endif
+
+void AesniTmmoBatchContiguous(const void* round_keys_input, void* input,
+                              std::size_t number_of_blocks, __uint128_t tweak,
+                              std::size_t blocks_per_tweak) {
+  constexpr std::size_t kBatchSize{8};
+  constexpr std::size_t kVaesBatchSize{48};
+  alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
+  alignas(16) std::array<__uint128_t, kVaesBatchSize> tweaks;
+
+  // copy the round keys onto the stack
+  // -> compiler will put them into registers
+  std::copy(reinterpret_cast<const __m128i*>(
+                __builtin_assume_aligned(round_keys_input, kAesBlockSize)),
+            reinterpret_cast<const __m128i*>(
+                __builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
+                kAesNumRoundKeys128,
+            round_keys.data());
+  auto blocks{reinterpret_cast<__m128i*>(input)};
+  auto tweak_pointer{reinterpret_cast<const __m128i*>(tweaks.data())};
+
+  std::size_t j = 0;
+  auto compute_tweaks = [&](std::size_t batch_size) {
+    for (std::size_t k = 0; k < batch_size; ++k) tweaks[k] = tweak + (j + k) / blocks_per_tweak;
+  };
+#ifdef MOTION_AVX512_VAES
+  std::array<__m512i, kAesNumRoundKeys128> wide_round_keys;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    wide_round_keys[r] = _mm512_broadcast_i32x4(round_keys[r]);
+  }
+  for (; j + kVaesBatchSize <= number_of_blocks; j += kVaesBatchSize) {
+    compute_tweaks(kVaesBatchSize);
+    AesniTmmoContiguousVaes<kVaesBatchSize / 4>(wide_round_keys, blocks + j, tweak_pointer);
+  }
+#endif
+  for (; j + kBatchSize <= number_of_blocks; j += kBatchSize) {
+    compute_tweaks(kBatchSize);
+    AesniTmmoContiguous<kBatchSize>(round_keys, blocks + j, tweak_pointer);
+  }
+  // do the remaining blocks
+  for (; j < number_of_blocks; ++j) {
+    compute_tweaks(1);
+    AesniTmmoContiguous<1>(round_keys, blocks + j, tweak_pointer);
+  }
+}
+
 void AesniMmoSingle(const void* round_keys_input, void* input) {
   alignas(16) __m128i input_block;
   alignas(16) __m128i wb_1;
@@ -407,21 +645,21 @@ void AesniMmoSingle(const void* round_keys_input, void* input) {
   *input_pointer = _mm_xor_si128(wb_1, input_block);
 }
 
+// doubles the keys in each 64 bit lane and reduces by the modulus if the most significant bit is
+// set, without branching on the (secret) keys
 static __m128i AesniMixKeys(__m128i key_a, __m128i key_b) {
   const __m128i modulus = _mm_set_epi32(0, 0, 0, 0x87);
-  const __m128i msb_mask = _mm_set_epi32(0x80000000, 0, 0, 0);
+  const auto msb_to_mask = [](__m128i x) {
+    return _mm_shuffle_epi32(_mm_srai_epi32(x, 31), _MM_SHUFFLE(3, 3, 3, 3));
+  };
   __m128i mixed_keys = key_a;
-  int msb_zero = _mm_testz_si128(mixed_keys, msb_mask);
+  __m128i reduction = msb_to_mask(mixed_keys) & modulus;
   mixed_keys <<= 1;
-  if (!msb_zero) {
-    mixed_keys ^= modulus;
-  }
+  mixed_keys ^= reduction;
   mixed_keys ^= key_b;
-  msb_zero = _mm_testz_si128(mixed_keys, msb_mask);
+  reduction = msb_to_mask(mixed_keys) & modulus;
   mixed_keys <<= 1;
-  if (!msb_zero) {
-    mixed_keys ^= modulus;
-  }
+  mixed_keys ^= reduction;
   return mixed_keys;
 }
 
@@ -457,3 +695,66 @@ void AesniBmrDkc(const void* round_keys_input, const void* key_a, const void* ke
     out[party_id] ^= AesniXorEncrypt(round_keys, tmp);
   }
 }
+
+static void AesniXorEncryptBatch8(const __m128i* round_keys, const __m128i* inputs,
+                                  __m128i* out) {
+  __m128i wb_0 = _mm_xor_si128(inputs[0], round_keys[0]);
+  __m128i wb_1 = _mm_xor_si128(inputs[1], round_keys[0]);
+  __m128i wb_2 = _mm_xor_si128(inputs[2], round_keys[0]);
+  __m128i wb_3 = _mm_xor_si128(inputs[3], round_keys[0]);
+  __m128i wb_4 = _mm_xor_si128(inputs[4], round_keys[0]);
+  __m128i wb_5 = _mm_xor_si128(inputs[5], round_keys[0]);
+  __m128i wb_6 = _mm_xor_si128(inputs[6], round_keys[0]);
+  __m128i wb_7 = _mm_xor_si128(inputs[7], round_keys[0]);
+  for (std::size_t round_i = 1; round_i < 10; ++round_i) {
+    wb_0 = _mm_aesenc_si128(wb_0, round_keys[round_i]);
+    wb_1 = _mm_aesenc_si128(wb_1, round_keys[round_i]);
+    wb_2 = _mm_aesenc_si128(wb_2, round_keys[round_i]);
+    wb_3 = _mm_aesenc_si128(wb_3, round_keys[round_i]);
+    wb_4 = _mm_aesenc_si128(wb_4, round_keys[round_i]);
+    wb_5 = _mm_aesenc_si128(wb_5, round_keys[round_i]);
+    wb_6 = _mm_aesenc_si128(wb_6, round_keys[round_i]);
+    wb_7 = _mm_aesenc_si128(wb_7, round_keys[round_i]);
+  }
+  out[0] ^= _mm_aesenclast_si128(wb_0, round_keys[10]) ^ inputs[0];
+  out[1] ^= _mm_aesenclast_si128(wb_1, round_keys[10]) ^ inputs[1];
+  out[2] ^= _mm_aesenclast_si128(wb_2, round_keys[10]) ^ inputs[2];
+  out[3] ^= _mm_aesenclast_si128(wb_3, round_keys[10]) ^ inputs[3];
+  out[4] ^= _mm_aesenclast_si128(wb_4, round_keys[10]) ^ inputs[4];
+  out[5] ^= _mm_aesenclast_si128(wb_5, round_keys[10]) ^ inputs[5];
+  out[6] ^= _mm_aesenclast_si128(wb_6, round_keys[10]) ^ inputs[6];
+  out[7] ^= _mm_aesenclast_si128(wb_7, round_keys[10]) ^ inputs[7];
+}
+
+void AesniBmrDkcBatch(const void* round_keys_input, const void* keys_a, const void* keys_b,
+                      const std::uint64_t* gate_ids, std::size_t number_of_tuples,
+                      std::size_t number_of_parties, void* output_input_pointer) {
+  constexpr std::size_t kBatchSize{8};
+  auto keys_a_pointer =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(keys_a, kAesBlockSize));
+  auto keys_b_pointer =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(keys_b, kAesBlockSize));
+  auto round_keys =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize));
+  auto out =
+      reinterpret_cast<__m128i*>(__builtin_assume_aligned(output_input_pointer, kAesBlockSize));
+
+  // collect the inputs of consecutive output blocks, which belong to the parties of one or more
+  // tuples, and encrypt them together
+  alignas(kAesBlockSize) std::array<__m128i, kBatchSize> inputs;
+  std::size_t number_of_inputs{0};
+  for (std::size_t tuple_i = 0; tuple_i < number_of_tuples; ++tuple_i) {
+    const __m128i mixed_keys = AesniMixKeys(keys_a_pointer[tuple_i], keys_b_pointer[tuple_i]);
+    for (std::size_t party_i = 0; party_i < number_of_parties; ++party_i) {
+      inputs[number_of_inputs++] = mixed_keys ^ _mm_set_epi64x(gate_ids[tuple_i], party_i);
+      if (number_of_inputs == kBatchSize) {
+        AesniXorEncryptBatch8(round_keys, inputs.data(), out);
+        out += kBatchSize;
+        number_of_inputs = 0;
+      }
+    }
+  }
+  for (std::size_t input_i = 0; input_i < number_of_inputs; ++input_i) {
+    out[input_i] ^= AesniXorEncrypt(round_keys, inputs[input_i]);
+  }
+}
@@ -36,15 +36,25 @@ constexpr std::size_t kAesNumRoundKeys128 = 11;
 void AesniKeyExpansion128(void* round_keys);
 
 // generate number_of_blocks of random bytes using AES in counter mode
+// if the CPU supports VAES, at least 16 blocks are encrypted with four (AVX-512) or two (AVX2)
+// blocks per instruction, as selected by encrypto::motion::SetBitwiseKernel
 // * round_keys and output are 16B aligned
 void AesniCtrStreamBlocks128(const void* round_keys, std::uint64_t* counter, void* output,
                              std::size_t number_of_blocks);
 
-// generate number_of_blocks of random bytes using AES in counter mode
+// generate number_of_blocks of random bytes using AES in counter mode, see AesniCtrStreamBlocks128
 // * round_keys are 16B aligned
 void AesniCtrStreamBlocks128Unaligned(const void* round_keys, std::uint64_t* counter, void* output,
                                       std::size_t number_of_blocks);
 
+// generate number_of_blocks of random bytes using AES in counter mode on the blocks
+// nonce || counter, i.e., the low 8 bytes of a block hold the nonce and the high 8 bytes the
+// counter, such that the block of any counter value can be computed independently
+// * round_keys are 16B aligned
+void AesniCtrStreamBlocks128WithNonce(const void* round_keys, std::uint64_t nonce,
+                                      std::uint64_t* counter, void* output,
+                                      std::size_t number_of_blocks);
+
 // generate a single block of random bytes using AES in counter mode
 // * round_keys are 16B aligned
 void AesniCtrStreamSingleBlock128Unaligned(const void* round_keys, std::uint64_t* counter,
@@ -76,6 +86,24 @@ void AesniTmmoBatch6(const void* round_keys, void* input, __uint128_t tweak);
 // TODO tests
 void AesniTmmoBatch3(const void* round_keys, void* input, __uint128_t tweak);
 
+// Compute the fixed-key contruction TMMO^\pi from Guo et al.
+// (https://eprint.iacr.org/2019/074) inplace on the number_of_blocks blocks pointed to by inputs,
+// where the j-th block uses the tweak tweak + j. The blocks are processed in batches of eight to
+// hide the latency of the aesenc instructions.
+//
+// * round_keys are 16B aligned, the blocks may be unaligned
+void AesniTmmoBatch(const void* round_keys, void* const* inputs, std::size_t number_of_blocks,
+                    __uint128_t tweak);
+
+// Compute the fixed-key contruction TMMO^\pi from Guo et al.
+// (https://eprint.iacr.org/2019/074) inplace on number_of_blocks consecutive blocks, where the
+// j-th block uses the tweak tweak + j / blocks_per_tweak. If MOTION_AVX512_VAES is defined, the
+// blocks are processed in batches of 48 with four blocks per VAES instruction.
+//
+// * round_keys are 16B aligned, the blocks may be unaligned
+void AesniTmmoBatchContiguous(const void* round_keys, void* input, std::size_t number_of_blocks,
+                              __uint128_t tweak, std::size_t blocks_per_tweak);
+
 // Compute the fixed-key contruction MMO^\pi from Guo et al.
 // (https://eprint.iacr.org/2019/074).
 //
@@ -97,3 +125,13 @@ void AesniMmoSingle(const void* round_keys, void* input);
 // The output is xored into `output`.
 void AesniBmrDkc(const void* round_keys, const void* key_a, const void* key_b,
                  std::uint64_t gate_id, std::size_t number_of_parties, void* output);
+
+// Compute the DKC of AesniBmrDkc for `number_of_tuples` tuples
+// (keys_a[i], keys_b[i], gate_ids[i]), pipelining the AES invocations of several parties and
+// tuples.  The `number_of_parties` outputs of tuple i are xored into
+// output[i * number_of_parties, (i + 1) * number_of_parties).
+//
+// * round_keys, keys_a, keys_b and output are 16B aligned
+void AesniBmrDkcBatch(const void* round_keys, const void* keys_a, const void* keys_b,
+                      const std::uint64_t* gate_ids, std::size_t number_of_tuples,
+                      std::size_t number_of_parties, void* output);
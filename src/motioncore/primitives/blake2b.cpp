@@ -24,7 +24,15 @@
 
 #include "blake2b.h"
 
+#include <immintrin.h>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+#include "utility/bit_vector.h"
+
 namespace encrypto::motion {
+
 Blake2bCtx NewBlakeCtx() {
   return Blake2bCtx(EVP_MD_CTX_new(), [](EVP_MD_CTX* context) { EVP_MD_CTX_free(context); });
 }
@@ -62,4 +70,158 @@ void Blake2b(std::uint8_t* message, std::uint8_t digest[EVP_MAX_MD_SIZE], std::s
              Blake2bCtx& b) {
   Blake2b(message, digest, length, b.get());
 }
+
+#if (OPENSSL_VERSION_NUMBER >= 0x1010000fL)
+
+constexpr std::size_t kBlake2bBlockSize = 128;
+
+constexpr std::array<std::uint64_t, 8> kBlake2bIv = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+    0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+constexpr std::uint8_t kBlake2bSigma[12][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}};
+
+// transposes the 4x4 matrix of 64-bit words given by its rows, such that row i afterwards holds
+// the i-th words of the former rows
+__attribute__((target("avx2"))) static inline void Transpose4x4(std::array<__m256i, 4>& rows) {
+  const __m256i t0 = _mm256_unpacklo_epi64(rows[0], rows[1]);
+  const __m256i t1 = _mm256_unpackhi_epi64(rows[0], rows[1]);
+  const __m256i t2 = _mm256_unpacklo_epi64(rows[2], rows[3]);
+  const __m256i t3 = _mm256_unpackhi_epi64(rows[2], rows[3]);
+  rows[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+  rows[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+  rows[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+  rows[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+// the mixing function G of BLAKE2b applied to the words a, b, c and d of the working vector v with
+// the message words x and y in each lane
+__attribute__((target("avx2"))) static inline void Blake2bG(std::array<__m256i, 16>& v,
+                                                            std::size_t a, std::size_t b,
+                                                            std::size_t c, std::size_t d,
+                                                            __m256i x, __m256i y) {
+  const __m256i kRotate16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                                             2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+  const __m256i kRotate24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                                             3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+  v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), x);
+  v[d] = _mm256_shuffle_epi32(_mm256_xor_si256(v[d], v[a]), _MM_SHUFFLE(2, 3, 0, 1));
+  v[c] = _mm256_add_epi64(v[c], v[d]);
+  v[b] = _mm256_shuffle_epi8(_mm256_xor_si256(v[b], v[c]), kRotate24);
+  v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), y);
+  v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), kRotate16);
+  v[c] = _mm256_add_epi64(v[c], v[d]);
+  const __m256i t = _mm256_xor_si256(v[b], v[c]);
+  // rotation by 63 bits to the right
+  v[b] = _mm256_xor_si256(_mm256_srli_epi64(t, 63), _mm256_add_epi64(t, t));
+}
+
+// hashes 4 messages of the same length, where lane i of the registers belongs to messages[i]
+__attribute__((target("avx2"))) static void Blake2bBatch4(const std::uint8_t* const* messages,
+                                                          std::size_t length,
+                                                          std::uint8_t* const* digests) {
+  // the parameter block of an unkeyed hash with a digest of 64 bytes
+  std::array<__m256i, 8> h;
+  for (std::size_t j = 0; j < 8; ++j) h[j] = _mm256_set1_epi64x(kBlake2bIv[j]);
+  h[0] = _mm256_xor_si256(h[0], _mm256_set1_epi64x(0x01010000 ^ kBlake2bDigestSize));
+
+  const std::size_t number_of_blocks = length == 0 ? 1 : (length + kBlake2bBlockSize - 1) /
+                                                             kBlake2bBlockSize;
+  alignas(32) std::array<std::array<std::uint8_t, kBlake2bBlockSize>, 4> last_blocks;
+  for (std::size_t block = 0; block < number_of_blocks; ++block) {
+    const bool is_last = block + 1 == number_of_blocks;
+    const std::size_t offset = block * kBlake2bBlockSize;
+    std::array<const std::uint8_t*, 4> block_pointers;
+    for (std::size_t i = 0; i < 4; ++i) {
+      if (is_last) {
+        // the last block is padded with zeros
+        last_blocks[i].fill(0);
+        if (length > offset) {
+          std::memcpy(last_blocks[i].data(), messages[i] + offset, length - offset);
+        }
+        block_pointers[i] = last_blocks[i].data();
+      } else {
+        block_pointers[i] = messages[i] + offset;
+      }
+    }
+
+    // m[w] holds the w-th message words of the 4 blocks
+    std::array<__m256i, 16> m;
+    for (std::size_t w = 0; w < 16; w += 4) {
+      std::array<__m256i, 4> rows;
+      for (std::size_t i = 0; i < 4; ++i) {
+        rows[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block_pointers[i] + 8 * w));
+      }
+      Transpose4x4(rows);
+      std::copy(rows.begin(), rows.end(), m.begin() + w);
+    }
+
+    const std::uint64_t bytes_compressed = is_last ? length : offset + kBlake2bBlockSize;
+    std::array<__m256i, 16> v;
+    std::copy(h.begin(), h.end(), v.begin());
+    for (std::size_t j = 0; j < 8; ++j) v[8 + j] = _mm256_set1_epi64x(kBlake2bIv[j]);
+    v[12] = _mm256_xor_si256(v[12], _mm256_set1_epi64x(bytes_compressed));
+    if (is_last) v[14] = _mm256_xor_si256(v[14], _mm256_set1_epi64x(-1));
+
+    for (const auto& s : kBlake2bSigma) {
+      Blake2bG(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+      Blake2bG(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+      Blake2bG(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+      Blake2bG(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+      Blake2bG(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+      Blake2bG(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+      Blake2bG(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+      Blake2bG(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+    for (std::size_t j = 0; j < 8; ++j) {
+      h[j] = _mm256_xor_si256(h[j], _mm256_xor_si256(v[j], v[8 + j]));
+    }
+  }
+
+  // transpose the state back into the words of the digests
+  for (std::size_t w = 0; w < 8; w += 4) {
+    std::array<__m256i, 4> rows{h[w], h[w + 1], h[w + 2], h[w + 3]};
+    Transpose4x4(rows);
+    for (std::size_t i = 0; i < 4; ++i) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(digests[i] + 8 * w), rows[i]);
+    }
+  }
+}
+
+#endif
+
+void Blake2bBatch(std::span<const std::uint8_t* const> messages, std::size_t length,
+                  std::span<std::uint8_t* const> digests) {
+  assert(messages.size() == digests.size());
+  std::size_t i = 0;
+#if (OPENSSL_VERSION_NUMBER >= 0x1010000fL)
+  if (GetBitwiseKernel() != BitwiseKernel::kSse) {
+    for (; i + kBlake2bBatchSize <= messages.size(); i += kBlake2bBatchSize) {
+      Blake2bBatch4(messages.data() + i, length, digests.data() + i);
+    }
+  }
+#endif
+  // hash the remaining messages one by one
+  if (i < messages.size()) {
+    auto context = NewBlakeCtx();
+    std::array<std::uint8_t, EVP_MAX_MD_SIZE> digest;
+    for (; i < messages.size(); ++i) {
+      // Blake2b does not modify the message
+      Blake2b(const_cast<std::uint8_t*>(messages[i]), digest.data(), length, context);
+      std::copy_n(digest.begin(), kBlake2bDigestSize, digests[i]);
+    }
+  }
+}
 }  // namespace encrypto::motion
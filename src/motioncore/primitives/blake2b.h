@@ -27,6 +27,7 @@
 #include <functional>
 #include <memory>
 #include <cstdint>
+#include <span>
 
 #include <openssl/evp.h>
 
@@ -42,4 +43,17 @@ void Blake2b(std::uint8_t* message, std::uint8_t digest[EVP_MAX_MD_SIZE], std::s
 void Blake2b(std::uint8_t* message, std::uint8_t digest[EVP_MAX_MD_SIZE], std::size_t length,
              Blake2bCtx& b);
 
+/// number of messages that Blake2bBatch hashes in parallel, one per 64-bit lane of an AVX2 register
+constexpr std::size_t kBlake2bBatchSize = 4;
+
+/// byte length of the digests of Blake2b and Blake2bBatch
+constexpr std::size_t kBlake2bDigestSize = 64;
+
+/// \brief Computes the digests of messages[i] of length bytes each into digests[i], which point to
+/// kBlake2bDigestSize bytes. The digests are the same as those of Blake2b, but the messages are
+/// hashed kBlake2bBatchSize at a time with AVX2 unless the SSE bitwise kernel is selected, see
+/// SetBitwiseKernel.
+void Blake2bBatch(std::span<const std::uint8_t* const> messages, std::size_t length,
+                  std::span<std::uint8_t* const> digests);
+
 }  // namespace encrypto::motion
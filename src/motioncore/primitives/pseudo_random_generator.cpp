@@ -26,6 +26,7 @@
 
 #include <cstdint>
 
+#include "aes/aes_batch_backend.h"
 #include "aes/aesni_primitives.h"
 
 namespace encrypto::motion::primitives {
@@ -47,27 +48,21 @@ void Prg::SetKey(const std::byte* key) { SetKey(reinterpret_cast<const std::uint
 std::vector<std::byte> Prg::Encrypt(const std::size_t bytes) {
   const unsigned int remainder = (bytes & 15u) > 0 ? 1 : 0;
   const std::size_t number_of_blocks = (bytes / 16) + remainder + 1;
-  const std::size_t byte_length = number_of_blocks * AES_BLOCK_SIZE;
-  int length = static_cast<int>(bytes);
-
-  // Asserting that conversion of (possibly larger) unsigned to signed integral value is safe here.
-  assert(length > 0 && "assigning bytes to int should yield a positive value");
-  assert(static_cast<std::size_t>(length) == bytes &&
-         "converting length back to std::size_t should yield a value equal to bytes");
-
-  std::vector<std::byte> output(byte_length), input(byte_length, std::byte(0));
-
-  for (auto i = 0ull; i < input.size() / AES_BLOCK_SIZE; ++i) {
-    *reinterpret_cast<uint64_t*>(input.data() + i * AES_BLOCK_SIZE) = i + offset_;
-  }
+  std::vector<std::byte> output(number_of_blocks * AES_BLOCK_SIZE);
+  std::uint64_t counter{offset_};
+  AesniCtrStreamBlocks128Unaligned(round_keys_.data(), &counter, output.data(), number_of_blocks);
+  return output;
+}
 
-  if (1 != EVP_EncryptUpdate(ctx_.get(), reinterpret_cast<std::uint8_t*>(output.data()), &length,
-                             reinterpret_cast<std::uint8_t*>(input.data()),
-                             number_of_blocks * AES_BLOCK_SIZE)) {
-    throw std::runtime_error("Could not EVP_EncryptUpdate");
+void Prg::KeyStream(std::span<std::byte> output) const {
+  const std::size_t number_of_blocks{output.size() / AES_BLOCK_SIZE};
+  std::uint64_t counter{offset_};
+  AesniCtrStreamBlocks128Unaligned(round_keys_.data(), &counter, output.data(), number_of_blocks);
+  if (const std::size_t remaining_bytes{output.size() % AES_BLOCK_SIZE}; remaining_bytes > 0) {
+    std::array<std::byte, AES_BLOCK_SIZE> last_block;
+    AesniCtrStreamSingleBlock128Unaligned(round_keys_.data(), &counter, last_block.data());
+    std::copy_n(last_block.data(), remaining_bytes, output.end() - remaining_bytes);
   }
-
-  return output;
 }
 
 std::vector<std::byte> Prg::Encrypt(const std::byte* input, const std::size_t bytes) {
@@ -148,4 +143,9 @@ void Prg::FixedKeyAes(const std::byte* input, const uint128_t tweak, std::byte*
 
 void Prg::Mmo(std::byte* input) { AesniMmoSingle(round_keys_.data(), input); }
 
+void Prg::Tmmo(std::byte* const* inputs, std::size_t number_of_blocks,
+               const uint128_t tweak) const {
+  AesBatchTmmo(round_keys_.data(), reinterpret_cast<void* const*>(inputs), number_of_blocks, tweak);
+}
+
 }  // namespace encrypto::motion::primitives
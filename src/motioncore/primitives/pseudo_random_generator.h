@@ -26,12 +26,14 @@
 
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include <openssl/aes.h>
 #include <openssl/evp.h>
 
 #include "aes/aesni_primitives.h"
+#include "utility/bit_vector.h"
 #include "utility/helpers.h"
 
 using uint128_t = __uint128_t;
@@ -55,8 +57,24 @@ class Prg {
     return new_offset;
   }
 
+  // returns the key stream AES_k(offset + i) for i = 0, 1, ... of at least bytes bytes
   std::vector<std::byte> Encrypt(const std::size_t bytes);
 
+  // fills output with the first output.size() bytes of the key stream of Encrypt(output.size())
+  // without allocating a buffer
+  void KeyStream(std::span<std::byte> output) const;
+
+  // returns the first number_of_bits bits of the key stream, i.e.,
+  // BitVector<Allocator>(Encrypt(BitsToBytes(number_of_bits)), number_of_bits)
+  template <typename Allocator = std::allocator<std::byte>>
+  BitVector<Allocator> KeyStreamBits(std::size_t number_of_bits) const {
+    BitVector<Allocator> output(BitsToBytes(number_of_bits) * 8);
+    KeyStream(output.GetMutableData());
+    // clears the bits beyond number_of_bits in the last byte
+    output.Resize(number_of_bits);
+    return output;
+  }
+
   std::vector<std::byte> Encrypt(const std::byte* input, const std::size_t bytes);
 
   std::vector<std::byte> FixedKeyAes(const std::byte* x, const std::uint64_t i,
@@ -65,6 +83,10 @@ class Prg {
   std::vector<std::byte> FixedKeyAes(const std::byte* x, const uint128_t i);
   void Mmo(std::byte* input);
 
+  // Apply TMMO^\pi with the tweak tweak + j inplace to the AES_BLOCK_SIZE bytes pointed to by
+  // inputs[j] for all j < number_of_blocks, see AesniTmmoBatch
+  void Tmmo(std::byte* const* inputs, std::size_t number_of_blocks, const uint128_t tweak) const;
+
   // Implementation of TMMO^\pi
   // of https://eprint.iacr.org/2019/074
   // with input x and tweak i
@@ -22,11 +22,13 @@
 
 #include "aes128_ctr_rng.h"
 
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <openssl/rand.h>
 
 #include "primitives/aes/aesni_primitives.h"
+#include "utility/helpers.h"
 
 namespace encrypto::motion {
 
@@ -39,6 +41,10 @@ struct Aes128CtrRng::Aes128CtrRngState {
 
 Aes128CtrRng::Aes128CtrRng() : state_(std::make_unique<Aes128CtrRngState>()) { SampleKey(); }
 
+Aes128CtrRng::Aes128CtrRng(const std::byte* key) : state_(std::make_unique<Aes128CtrRngState>()) {
+  SetKey(key);
+}
+
 Aes128CtrRng::~Aes128CtrRng() = default;
 
 void Aes128CtrRng::SampleKey() {
@@ -55,6 +61,14 @@ void Aes128CtrRng::SampleKey() {
   state_->counter = 0;
 }
 
+void Aes128CtrRng::SetKey(const std::byte* key) {
+  std::copy(key, key + kAesBlockSize, state_->round_keys.data());
+  AesniKeyExpansion128(state_->round_keys.data());
+  state_->counter = 0;
+}
+
+void Aes128CtrRng::SetCounter(std::uint64_t block_index) { state_->counter = block_index; }
+
 void Aes128CtrRng::RandomBlocksAligned(std::byte* output, std::size_t number_of_blocks) {
   std::byte* aligned_output = reinterpret_cast<std::byte*>(__builtin_assume_aligned(output, 16));
   AesniCtrStreamBlocks128(state_->round_keys.data(), &state_->counter, aligned_output,
@@ -67,9 +81,25 @@ void Aes128CtrRng::RandomBlocks(std::byte* output, std::size_t number_of_blocks)
 }
 
 void Aes128CtrRng::RandomBytes(std::byte* output, std::size_t number_of_bytes) {
+  ParallelRandomBytes(output, number_of_bytes, 1);
+}
+
+void Aes128CtrRng::ParallelRandomBytes(std::byte* output, std::size_t number_of_bytes,
+                                       std::size_t number_of_threads) {
   std::size_t number_of_blocks = number_of_bytes / kAesBlockSize;
   std::size_t remaining_bytes = number_of_bytes % kAesBlockSize;
-  RandomBlocks(output, number_of_blocks);
+  const std::uint64_t first_counter{state_->counter};
+  const std::byte* round_keys{state_->round_keys.data()};
+  // only as many threads as get kParallelBlocks blocks each
+  number_of_threads = std::clamp<std::size_t>(number_of_blocks / kParallelBlocks, 1,
+                                              std::max<std::size_t>(number_of_threads, 1));
+  ParallelForRanges(number_of_blocks, number_of_threads, 1,
+                    [first_counter, round_keys, output](std::size_t begin, std::size_t end) {
+                      std::uint64_t counter{first_counter + begin};
+                      AesniCtrStreamBlocks128Unaligned(round_keys, &counter,
+                                                       output + begin * kAesBlockSize, end - begin);
+                    });
+  state_->counter = first_counter + number_of_blocks;
   std::array<std::byte, kAesBlockSize> extra_block;
   AesniCtrStreamSingleBlock128Unaligned(state_->round_keys.data(), &state_->counter,
                                         extra_block.data());
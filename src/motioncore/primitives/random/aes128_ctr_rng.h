@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include "rng.h"
 
@@ -32,6 +33,10 @@ namespace encrypto::motion {
 class Aes128CtrRng : public Rng {
  public:
   Aes128CtrRng();
+
+  // initialize the PRG with the given key of kBlockSize bytes, such that its stream is reproducible
+  explicit Aes128CtrRng(const std::byte* key);
+
   virtual ~Aes128CtrRng();
 
   // delete copy/move constructors/assignment operators
@@ -43,9 +48,22 @@ class Aes128CtrRng : public Rng {
   // (re)initialize the PRG with a randomly chosen key
   virtual void SampleKey() override;
 
+  // (re)initialize the PRG with the given key of kBlockSize bytes
+  void SetKey(const std::byte* key);
+
+  // continue the stream at the given block, i.e., the next block is AES_key(block_index)
+  void SetCounter(std::uint64_t block_index);
+
   // fill the output buffer with number_of_bytes random bytes
   virtual void RandomBytes(std::byte* output, std::size_t number_of_bytes) override;
 
+  // fill the output buffer with the same number_of_bytes random bytes as RandomBytes, where
+  // the blocks are split evenly into disjoint ranges of the counter, which up to number_of_threads
+  // OpenMP threads encrypt concurrently with the same key, but only as many threads as get
+  // kParallelBlocks blocks each
+  virtual void ParallelRandomBytes(std::byte* output, std::size_t number_of_bytes,
+                                   std::size_t number_of_threads) override;
+
   // fill the output buffer with number_of_blocks random blocks of size kBlockSize
   virtual void RandomBlocks(std::byte* output, std::size_t number_of_blocks) override;
 
@@ -57,6 +75,9 @@ class Aes128CtrRng : public Rng {
 
   static constexpr std::size_t kBlockSize = 16;
 
+  // minimum number of blocks for which ParallelRandomBytes uses another thread
+  static constexpr std::size_t kParallelBlocks = std::size_t(1) << 12;
+
  private:
   struct Aes128CtrRngState;
   std::unique_ptr<Aes128CtrRngState> state_;
@@ -38,6 +38,13 @@ class Rng {
   // fill the output buffer with number_of_bytes random bytes
   virtual void RandomBytes(std::byte* output, std::size_t number_of_bytes) = 0;
 
+  // fill the output buffer with number_of_bytes random bytes using up to number_of_threads
+  // threads, which by default generates them sequentially
+  virtual void ParallelRandomBytes(std::byte* output, std::size_t number_of_bytes,
+                                   [[maybe_unused]] std::size_t number_of_threads) {
+    RandomBytes(output, number_of_bytes);
+  }
+
   // fill the output buffer with number_of_blocks random blocks of size kBlockSize
   virtual void RandomBlocks(std::byte* output, std::size_t number_of_blocks) = 0;
 
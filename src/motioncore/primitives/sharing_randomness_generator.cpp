@@ -23,19 +23,17 @@
 // SOFTWARE.
 
 #include "sharing_randomness_generator.h"
-#include "blake2b.h"
 
 #include <openssl/aes.h>
+#include <cstring>
 
+#include "aes/aesni_primitives.h"
 #include "utility/helpers.h"
 
 namespace encrypto::motion::primitives {
 
 SharingRandomnessGenerator::SharingRandomnessGenerator(std::size_t party_id)
-    : party_id_(party_id), context_arithmetic_(MakeCipherCtx()), context_boolean_(MakeCipherCtx()) {
-  if (!context_arithmetic_ || !context_boolean_) {
-    throw(std::runtime_error(fmt::format("Could not initialize EVP context")));
-  }
+    : party_id_(party_id) {
   initialized_condition_ = std::make_unique<FiberCondition>([this]() { return initialized_; });
 }
 
@@ -43,23 +41,16 @@ void SharingRandomnessGenerator::Initialize(
     const std::uint8_t seed[SharingRandomnessGenerator::kMasterSeedByteLength]) {
   std::copy(seed, seed + kMasterSeedByteLength, std::begin(master_seed_));
 
-  {
-    auto digest = HashKey(master_seed_, KeyType::kArithmeticGmwKey);
-    std::copy(digest.data(), digest.data() + kAesKeySize, raw_key_arithmetic_);
-  }
-  {
-    auto digest = HashKey(master_seed_, KeyType::kArithmeticGmwNonce);
-    std::copy(digest.data(), digest.data() + AES_BLOCK_SIZE / 2, aes_ctr_nonce_arithmetic_);
-  }
-  {
-    auto digest = HashKey(master_seed_, KeyType::kBooleanGmwKey);
-    std::copy(digest.data(), digest.data() + kAesKeySize, raw_key_boolean_);
-  }
-  {
-    auto digest = HashKey(master_seed_, KeyType::kBooleanGmwNonce);
-    std::copy(digest.data(), digest.data() + AES_BLOCK_SIZE / 2, aes_ctr_nonce_boolean_);
-  }
+  const auto digests = HashKeys(master_seed_);
+  std::copy_n(digests[KeyType::kArithmeticGmwKey].data(), kAesKeySize, raw_key_arithmetic_);
+  std::copy_n(digests[KeyType::kArithmeticGmwNonce].data(), AES_BLOCK_SIZE / 2,
+              aes_ctr_nonce_arithmetic_);
+  std::copy_n(digests[KeyType::kBooleanGmwKey].data(), kAesKeySize, raw_key_boolean_);
+  std::copy_n(digests[KeyType::kBooleanGmwNonce].data(), AES_BLOCK_SIZE / 2,
+              aes_ctr_nonce_boolean_);
 
+  std::memcpy(&nonce_arithmetic_, aes_ctr_nonce_arithmetic_, sizeof(nonce_arithmetic_));
+  std::memcpy(&nonce_boolean_, aes_ctr_nonce_boolean_, sizeof(nonce_boolean_));
   prg_a.SetKey(raw_key_arithmetic_);
   prg_b.SetKey(raw_key_boolean_);
 
@@ -70,121 +61,117 @@ void SharingRandomnessGenerator::Initialize(
   initialized_condition_->NotifyAll();
 }
 
+// encrypts the blocks nonce || first_block, ..., nonce || (first_block + number_of_blocks - 1)
+static void EncryptCounters(const Prg& prg, std::uint64_t nonce, std::uint64_t first_block,
+                            void* output, std::size_t number_of_blocks) {
+  AesniCtrStreamBlocks128WithNonce(prg.GetRoundKeys(), nonce, &first_block, output,
+                                   number_of_blocks);
+}
+
 BitVector<> SharingRandomnessGenerator::GetBits(const std::size_t gate_id,
                                                 const std::size_t number_of_bits) {
-  std::scoped_lock lock(random_bits_mutex_);
-
   if (number_of_bits == 0) {
     return {};  // return an empty vector if number_of_gates is zero
   }
 
-  while (!initialized_) {
-    initialized_condition_->Wait();
-  }
-
-  constexpr std::size_t kBitsInCiphertext = AES_BLOCK_SIZE * 8;
-  constexpr std::size_t kCipherTextsInBatch = 100;
-  // initialization for the encryption is costly, so perform random bit generation in a batch
-  constexpr std::size_t kBitsInBatch = kBitsInCiphertext * kCipherTextsInBatch;
-  constexpr std::size_t kBytesInBatch = kBitsInBatch / 8;
-
-  while (random_bits_.GetSize() < (gate_id - random_bits_offset_ + number_of_bits)) {
-    std::vector<std::byte> input(kBytesInBatch + AES_BLOCK_SIZE),
-        output(kBytesInBatch + AES_BLOCK_SIZE);
-    for (auto offset = random_bits_.GetSize() / kAesBlockSize; offset < kCipherTextsInBatch;
-         ++offset) {
-      auto pointer = reinterpret_cast<std::uint8_t*>(input.data()) + offset * kAesBlockSize;
-      // copy nonce
-      std::copy(std::begin(aes_ctr_nonce_boolean_), std::end(aes_ctr_nonce_boolean_), pointer);
-      // copy counter value
-      *reinterpret_cast<uint64_t*>(pointer + kAesBlockSize / 2) = offset;
-    }
-
-    // encrypt as in CTR mode, but without sequentially incrementing the counter
-    // after each encryption
-    std::vector<std::byte> output_bytes =
-        prg_b.Encrypt(input.data(), kCipherTextsInBatch * AES_BLOCK_SIZE);
+  initialized_condition_->Wait();
 
-    for (auto i = 0ull; i < kBytesInBatch; ++i) {
-      output_bytes.push_back(std::byte(output.at(i)));
-    }
-    auto randomness = BitVector(std::move(output_bytes), kBitsInBatch);
-    random_bits_.Append(randomness);
+  constexpr std::size_t kBitsInBlock = kAesBlockSize * 8;
+  const std::size_t first_block = gate_id / kBitsInBlock;
+  const std::size_t number_of_blocks =
+      (gate_id + number_of_bits + kBitsInBlock - 1) / kBitsInBlock - first_block;
+
+  if (number_of_blocks > kLookaheadBlocks) {
+    BitVector<> bits(number_of_blocks * kBitsInBlock);
+    EncryptCounters(prg_b, nonce_boolean_, first_block, bits.GetMutableData().data(),
+                    number_of_blocks);
+    const std::size_t from = gate_id - first_block * kBitsInBlock;
+    return bits.Subset(from, from + number_of_bits);
   }
 
-  const auto requested = gate_id - random_bits_offset_ + number_of_bits;
-  if (requested > random_bits_used_) {
-    random_bits_used_ = requested;
+  std::scoped_lock lock(random_bits_mutex_);
+  if (gate_id < random_bits_begin_ ||
+      gate_id + number_of_bits > random_bits_begin_ + random_bits_.GetSize()) {
+    if (random_bits_.GetSize() != kLookaheadBlocks * kBitsInBlock) {
+      random_bits_ = BitVector<>(kLookaheadBlocks * kBitsInBlock);
+    }
+    EncryptCounters(prg_b, nonce_boolean_, first_block, random_bits_.GetMutableData().data(),
+                    kLookaheadBlocks);
+    random_bits_begin_ = first_block * kBitsInBlock;
   }
-
-  assert(gate_id >= random_bits_offset_);
-  return random_bits_.Subset(gate_id - random_bits_offset_,
-                             gate_id + number_of_bits - random_bits_offset_);
+  const std::size_t from = gate_id - random_bits_begin_;
+  return random_bits_.Subset(from, from + number_of_bits);
 }
 
-std::vector<std::uint8_t> SharingRandomnessGenerator::HashKey(
-    const std::uint8_t seed[kMasterSeedByteLength], const KeyType key_type) {
-  std::vector<std::uint8_t> seed_padded(seed, seed + kMasterSeedByteLength);
-  std::uint32_t key_type32 = key_type;
-  const uint8_t* key_type_pointer = reinterpret_cast<const std::uint8_t*>(&key_type32);
-  seed_padded.insert(seed_padded.begin(), key_type_pointer, key_type_pointer + sizeof(key_type32));
-  EVP_MD_CTX* md_context = EVP_MD_CTX_new();
-  std::uint8_t digest[EVP_MAX_MD_SIZE];
-  unsigned int md_length;
-
-#if (OPENSSL_VERSION_NUMBER < 0x1010000fL)
-  EVP_DigestInit_ex(md_context, EVP_sha512(), NULL);
-#else
-  EVP_DigestInit_ex(md_context, EVP_blake2b512(), NULL);
-#endif
-
-  EVP_DigestUpdate(md_context, seed_padded.data(), seed_padded.size());
-  EVP_DigestFinal_ex(md_context, digest, &md_length);
-  EVP_MD_CTX_free(md_context);
-
-  return std::vector<std::uint8_t>(digest, digest + kAesKeySize);
+std::array<std::array<std::uint8_t, kBlake2bDigestSize>,
+           SharingRandomnessGenerator::kInvalidKeyType>
+SharingRandomnessGenerator::HashKeys(const std::uint8_t seed[kMasterSeedByteLength]) {
+  constexpr std::size_t kInputSize = sizeof(std::uint32_t) + kMasterSeedByteLength;
+  std::array<std::array<std::uint8_t, kInputSize>, kInvalidKeyType> inputs;
+  std::array<std::array<std::uint8_t, kBlake2bDigestSize>, kInvalidKeyType> digests;
+  std::array<const std::uint8_t*, kInvalidKeyType> input_pointers;
+  std::array<std::uint8_t*, kInvalidKeyType> digest_pointers;
+  for (std::uint32_t key_type = 0; key_type < kInvalidKeyType; ++key_type) {
+    std::memcpy(inputs[key_type].data(), &key_type, sizeof(key_type));
+    std::copy_n(seed, kMasterSeedByteLength, inputs[key_type].data() + sizeof(key_type));
+    input_pointers[key_type] = inputs[key_type].data();
+    digest_pointers[key_type] = digests[key_type].data();
+  }
+  Blake2bBatch(input_pointers, kInputSize, digest_pointers);
+  return digests;
 }
 
 std::vector<std::uint8_t> SharingRandomnessGenerator::GetSeed() {
   return std::vector<std::uint8_t>(master_seed_, master_seed_ + sizeof(master_seed_));
 }
 
-void SharingRandomnessGenerator::ClearBitPool() { random_bits_ = BitVector<>(); }
+void SharingRandomnessGenerator::ClearBitPool() {
+  std::scoped_lock lock(random_bits_mutex_);
+  random_bits_ = BitVector<>();
+  random_bits_begin_ = 0;
+}
+
+void SharingRandomnessGenerator::ResetBitPool() { ClearBitPool(); }
+
+void SharingRandomnessGenerator::UpdateArithmeticWindow(std::size_t gate_id,
+                                                        std::size_t number_of_gates) {
+  assert(number_of_gates <= kLookaheadBlocks);
+  const std::size_t window_size = arithmetic_window_.size() / 2;
+  if (window_size > 0 && gate_id >= arithmetic_window_begin_ &&
+      gate_id + number_of_gates <= arithmetic_window_begin_ + window_size) {
+    return;
+  }
+  arithmetic_window_.resize(2 * kLookaheadBlocks);
+  EncryptCounters(prg_a, nonce_arithmetic_, gate_id, arithmetic_window_.data(), kLookaheadBlocks);
+  arithmetic_window_begin_ = gate_id;
+}
 
-void SharingRandomnessGenerator::ResetBitPool() {
-  if (random_bits_used_ == random_bits_.GetSize()) {
-    random_bits_.Clear();
+// combines the block AES_k(nonce || gate_id) xored with the gate_id, which is the actual input to
+// AES-CTR, and reduces it to the ring of T
+template <typename T>
+static T CombineBlock(const std::uint64_t* block, std::uint64_t gate_id) {
+  // computes ((block[0] << 64) ^ block[1] ^ gate_id) % max(T) without a 128-bit division
+  const std::uint64_t high = block[0], low = block[1] ^ gate_id;
+  if constexpr (sizeof(T) == sizeof(uint128_t)) {
+    const uint128_t result = (uint128_t(high) << 64) | low;
+    return result == std::numeric_limits<uint128_t>::max() ? 0 : result;
   } else {
-    random_bits_ = random_bits_.Subset(random_bits_used_, random_bits_.GetSize() - 1);
+    // 2^64 = 1 mod max(T), so the halves are added with an end-around carry
+    std::uint64_t sum = high + low;
+    sum += sum < low;
+    constexpr std::uint64_t kModulus = std::numeric_limits<T>::max();
+    return static_cast<T>(sum % kModulus);  // static-cast the result to the smaller ring
   }
-  random_bits_offset_ += random_bits_used_;
-  random_bits_used_ = 0;
 }
 
 template <typename T>
 T SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id) {
   initialized_condition_->Wait();
 
-  std::byte input[AES_BLOCK_SIZE];
-
-  std::copy(std::begin(aes_ctr_nonce_arithmetic_), std::end(aes_ctr_nonce_arithmetic_),
-            reinterpret_cast<std::uint8_t*>(input));
-  std::copy(reinterpret_cast<const std::byte*>(&gate_id),
-            reinterpret_cast<const std::byte*>(&gate_id) + sizeof(gate_id),
-            input + SharingRandomnessGenerator::kCounterOffset);
-
-  auto output = prg_a.Encrypt(input, AES_BLOCK_SIZE);
-
-  // combine resulting randomness xored with the gate_id, which is the actual
-  // input to AES-CTR
-  __uint128_t result = reinterpret_cast<std::uint64_t*>(output.data())[0],
-              modulus = std::numeric_limits<T>::max();
-  result <<= 64;
-  result ^= reinterpret_cast<std::uint64_t*>(output.data())[1] ^ gate_id;
-  result %= modulus;
-
-  return static_cast<T>(result);  // static-cast the result to the smaller
-                                  // ring
+  std::scoped_lock lock(arithmetic_window_mutex_);
+  UpdateArithmeticWindow(gate_id, 1);
+  return CombineBlock<T>(arithmetic_window_.data() + 2 * (gate_id - arithmetic_window_begin_),
+                         gate_id);
 }
 
 template std::uint8_t SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id);
@@ -202,34 +189,22 @@ std::vector<T> SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id,
 
   initialized_condition_->Wait();
 
-  // Pre-initialize output vector
-  std::vector<T> results;
-  results.reserve(number_of_gates);
-
-  auto size_in_bytes = AES_BLOCK_SIZE * (number_of_gates);
-  std::vector<std::byte> input(size_in_bytes + AES_BLOCK_SIZE);
-
-  auto gate_id_copy = gate_id;
-  for (auto i = 0u; i < number_of_gates; ++i, ++gate_id_copy) {
-    std::copy(std::begin(aes_ctr_nonce_arithmetic_), std::end(aes_ctr_nonce_arithmetic_),
-              reinterpret_cast<std::uint8_t*>(input.data()) + i * AES_BLOCK_SIZE);
-    std::copy(reinterpret_cast<std::byte*>(&gate_id_copy),
-              reinterpret_cast<std::byte*>(&gate_id_copy) + sizeof(gate_id_copy),
-              input.data() + i * AES_BLOCK_SIZE + SharingRandomnessGenerator::kCounterOffset);
-  }
+  std::vector<T> results(number_of_gates);
+  auto combine = [&results, gate_id](const std::uint64_t* blocks) {
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      results[i] = CombineBlock<T>(blocks + 2 * i, gate_id + i);
+    }
+  };
 
-  auto output = prg_a.Encrypt(input.data(), number_of_gates * AES_BLOCK_SIZE);
-  __uint128_t modulus = std::numeric_limits<T>::max(), single_result;
-  // combine resulting randomness xored with the gate_id, which is the actual
-  // input to AES-CTR
-  for (auto i = 0u; i < number_of_gates; ++i) {
-    single_result = reinterpret_cast<std::uint64_t*>(output.data())[i * 2];
-    single_result <<= 64;
-    single_result ^= reinterpret_cast<std::uint64_t*>(output.data())[i * 2 + 1] ^ gate_id++;
-    single_result %= modulus;
-    results.push_back(static_cast<T>(single_result));  // static-cast the result to the smaller ring
+  if (number_of_gates > kLookaheadBlocks) {
+    std::vector<std::uint64_t> blocks(2 * number_of_gates);
+    EncryptCounters(prg_a, nonce_arithmetic_, gate_id, blocks.data(), number_of_gates);
+    combine(blocks.data());
+  } else {
+    std::scoped_lock lock(arithmetic_window_mutex_);
+    UpdateArithmeticWindow(gate_id, number_of_gates);
+    combine(arithmetic_window_.data() + 2 * (gate_id - arithmetic_window_begin_));
   }
-
   return results;
 }
 
@@ -244,4 +219,65 @@ template std::vector<std::uint64_t> SharingRandomnessGenerator::GetUnsigned(
 template std::vector<uint128_t> SharingRandomnessGenerator::GetUnsigned(
     std::size_t gate_id, std::size_t number_of_gates);
 
+template <typename T>
+std::vector<T> SharingRandomnessGenerator::GetUnsignedStream(std::size_t gate_id,
+                                                             std::size_t number_of_values) {
+  std::vector<T> results(number_of_values);
+  GetUnsignedStream<T>(gate_id, std::span<T>(results));
+  return results;
+}
+
+template std::vector<std::uint8_t> SharingRandomnessGenerator::GetUnsignedStream(
+    std::size_t gate_id, std::size_t number_of_values);
+template std::vector<std::uint16_t> SharingRandomnessGenerator::GetUnsignedStream(
+    std::size_t gate_id, std::size_t number_of_values);
+template std::vector<std::uint32_t> SharingRandomnessGenerator::GetUnsignedStream(
+    std::size_t gate_id, std::size_t number_of_values);
+template std::vector<std::uint64_t> SharingRandomnessGenerator::GetUnsignedStream(
+    std::size_t gate_id, std::size_t number_of_values);
+template std::vector<uint128_t> SharingRandomnessGenerator::GetUnsignedStream(
+    std::size_t gate_id, std::size_t number_of_values);
+
+template <typename T>
+void SharingRandomnessGenerator::GetUnsignedStream(std::size_t gate_id, std::span<T> output) {
+  if (output.empty()) {
+    return;
+  }
+
+  // the upper half of the 64-bit counter identifies the gate, the lower half the block
+  constexpr std::size_t kBlockIndexBits = 32;
+  const std::size_t number_of_bytes = output.size_bytes();
+  const std::size_t number_of_blocks = (number_of_bytes + kAesBlockSize - 1) / kAesBlockSize;
+  if (gate_id >= (std::size_t(1) << (64 - kBlockIndexBits)) ||
+      number_of_blocks > (std::size_t(1) << kBlockIndexBits)) {
+    throw std::invalid_argument(
+        fmt::format("Cannot expand {} random bytes for gate #{}", number_of_bytes, gate_id));
+  }
+
+  initialized_condition_->Wait();
+
+  std::uint64_t counter = static_cast<std::uint64_t>(gate_id) << kBlockIndexBits;
+  auto output_pointer = reinterpret_cast<std::byte*>(output.data());
+  const std::size_t number_of_full_blocks = number_of_bytes / kAesBlockSize;
+  AesniCtrStreamBlocks128Unaligned(prg_a.GetRoundKeys(), &counter, output_pointer,
+                                   number_of_full_blocks);
+  if (const std::size_t remainder = number_of_bytes % kAesBlockSize; remainder > 0) {
+    std::array<std::byte, kAesBlockSize> last_block;
+    AesniCtrStreamSingleBlock128Unaligned(prg_a.GetRoundKeys(), &counter, last_block.data());
+    std::memcpy(output_pointer + number_of_full_blocks * kAesBlockSize, last_block.data(),
+                remainder);
+  }
+}
+
+template void SharingRandomnessGenerator::GetUnsignedStream(std::size_t gate_id,
+                                                            std::span<std::uint8_t> output);
+template void SharingRandomnessGenerator::GetUnsignedStream(std::size_t gate_id,
+                                                            std::span<std::uint16_t> output);
+template void SharingRandomnessGenerator::GetUnsignedStream(std::size_t gate_id,
+                                                            std::span<std::uint32_t> output);
+template void SharingRandomnessGenerator::GetUnsignedStream(std::size_t gate_id,
+                                                            std::span<std::uint64_t> output);
+template void SharingRandomnessGenerator::GetUnsignedStream(std::size_t gate_id,
+                                                            std::span<uint128_t> output);
+
 }  // namespace encrypto::motion::primitives
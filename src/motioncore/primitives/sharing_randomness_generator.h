@@ -24,8 +24,10 @@
 
 #pragma once
 
+#include <array>
 #include <boost/fiber/mutex.hpp>
 #include <limits>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -41,6 +43,7 @@ static auto& EVP_MD_CTX_free = EVP_MD_CTX_destroy;
 
 #include <fmt/format.h>
 
+#include "blake2b.h"
 #include "pseudo_random_generator.h"
 #include "utility/bit_vector.h"
 #include "utility/constants.h"
@@ -77,30 +80,49 @@ class SharingRandomnessGenerator {
 
   SharingRandomnessGenerator() = delete;
 
+  /// \brief Returns the random value of T for gate_id, which is derived from the block
+  /// AES_k(nonce || gate_id), i.e., the blocks of the gate ids are independent of each other and
+  /// of the order in which they are requested.
   template <typename T>
   T GetUnsigned(const std::size_t gate_id);
 
+  /// \brief Returns the random values GetUnsigned(gate_id + i) for i < number_of_gates.
   template <typename T>
   std::vector<T> GetUnsigned(std::size_t gate_id, std::size_t number_of_gates);
 
+  /// \brief Expands number_of_values random values of T for gate_id in a single pass of AES-NI in
+  /// counter mode. In contrast to GetUnsigned(gate_id, number_of_gates), which encrypts one block
+  /// per value and derives the values of a gate from the gate ids gate_id, gate_id + 1,
+  /// ..., the values are packed into the consecutive blocks of a stream that is separate for each
+  /// gate id. Both variants are not interchangeable, i.e., all parties sharing the randomness need
+  /// to use the same one for a gate.
+  template <typename T>
+  std::vector<T> GetUnsignedStream(std::size_t gate_id, std::size_t number_of_values);
+
+  /// \brief Fills output with the random values of GetUnsignedStream(gate_id, output.size()).
+  template <typename T>
+  void GetUnsignedStream(std::size_t gate_id, std::span<T> output);
+
+  /// \brief Returns the random bits gate_id, ..., gate_id + number_of_bits - 1, where bit i is
+  /// bit i % 128 of the block AES_k(nonce || i / 128).
   BitVector<> GetBits(std::size_t gate_id, std::size_t number_of_bits);
 
+  /// \brief Releases the lookahead window of the random bits. Since the bits are addressed by
+  /// their absolute position, this does not change the output of GetBits.
   void ClearBitPool();
 
   void ResetBitPool();
 
+  /// Number of AES blocks that are precomputed for the requests of few values or bits, which are
+  /// then served from the window as long as the gate ids are ascending, e.g., for input gates.
+  /// Larger requests are encrypted directly into the output.
+  static constexpr std::size_t kLookaheadBlocks = 128;
+
  private:
   static constexpr std::size_t kCounterOffset =
       AES_BLOCK_SIZE / 2;  /// Byte length of the AES-CTR nonce
   std::int64_t party_id_ = -1;
 
-  /// AES context, created only once and reused further
-  using EvpCipherCtxPointer = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
-  static constexpr auto MakeCipherCtx = []() {
-    return EvpCipherCtxPointer(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
-  };
-  EvpCipherCtxPointer context_arithmetic_, context_boolean_;
-
   std::uint8_t master_seed_[SharingRandomnessGenerator::kMasterSeedByteLength] = {0};
   std::uint8_t raw_key_arithmetic_[kAesKeySize] = {0};
   std::uint8_t raw_key_boolean_[kAesKeySize] = {0};  /// AES key in raw std::uint8_t format
@@ -108,6 +130,10 @@ class SharingRandomnessGenerator {
   std::uint8_t aes_ctr_nonce_boolean_[AES_BLOCK_SIZE / 2] = {0};  /// Raw AES CTR nonce that is used
   /// in the left part of IV
 
+  /// the nonces in the format of AesniCtrStreamBlocks128WithNonce
+  std::uint64_t nonce_arithmetic_ = 0, nonce_boolean_ = 0;
+
+  /// the AES-NI round keys of prg_a and prg_b are used in fixed-key counter mode
   primitives::Prg prg_a, prg_b;
 
   enum KeyType : unsigned int {
@@ -118,15 +144,27 @@ class SharingRandomnessGenerator {
     kInvalidKeyType = 4
   };
 
-  // use a seed to generate randomness for a new key
-  std::vector<std::uint8_t> HashKey(const std::uint8_t seed[kAesKeySize], const KeyType key_type);
+  // use a seed to generate randomness for the keys and nonces of all key types at once, where the
+  // digest of key type t is the hash of t || seed
+  std::array<std::array<std::uint8_t, kBlake2bDigestSize>, kInvalidKeyType> HashKeys(
+      const std::uint8_t seed[kMasterSeedByteLength]);
 
   bool initialized_ = false;
 
-  BitVector<> random_bits_;
+  // moves the arithmetic window to gate_id unless it contains the gate ids gate_id, ...,
+  // gate_id + number_of_gates - 1, where number_of_gates <= kLookaheadBlocks
+  void UpdateArithmeticWindow(std::size_t gate_id, std::size_t number_of_gates);
 
-  std::size_t random_bits_offset_ = 0;
-  std::size_t random_bits_used_ = 0;
+  /// the blocks AES_k(nonce || i) for the gate ids i starting at arithmetic_window_begin_, given as
+  /// two 64-bit words per block
+  std::vector<std::uint64_t> arithmetic_window_;
+  std::size_t arithmetic_window_begin_ = 0;
+
+  boost::fibers::mutex arithmetic_window_mutex_;
+
+  /// the random bits starting at bit random_bits_begin_, which is a multiple of the block size
+  BitVector<> random_bits_;
+  std::size_t random_bits_begin_ = 0;
 
   boost::fibers::mutex random_bits_mutex_;
 
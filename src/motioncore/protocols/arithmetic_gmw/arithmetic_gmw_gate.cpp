@@ -26,7 +26,11 @@
 
 #include <flatbuffers/flatbuffers.h>
 #include <fmt/format.h>
+#include <bit>
 #include <cmath>
+#include <cstring>
+#include <functional>
+#include <numeric>
 #include <span>
 
 #include "base/backend.h"
@@ -36,15 +40,78 @@
 #include "communication/message_manager.h"
 #include "multiplication_triple/mt_provider.h"
 #include "multiplication_triple/sp_provider.h"
+#include "multiplication_triple/truncation_pair_provider.h"
+#include "oblivious_transfer/ot_provider.h"
 #include "primitives/sharing_randomness_generator.h"
+#include "protocols/opening.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_share.h"
+#include "utility/constants.h"
 #include "utility/fiber_condition.h"
 #include "utility/helpers.h"
 #include "utility/logger.h"
 
 namespace encrypto::motion::proto::arithmetic_gmw {
 
+template <typename T>
+static std::span<const std::uint8_t> AsBytes(const std::vector<T>& values) {
+  return std::span(reinterpret_cast<const std::uint8_t*>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+static const flatbuffers::Vector<std::uint8_t>& GetOpeningPayload(
+    communication::MessageType message_type, std::size_t message_id,
+    const communication::MessageBuffer& opening_message, const std::vector<T>& values) {
+  const auto& fb_vector{*communication::GetMessage(opening_message.data())->payload()};
+  if (fb_vector.size() != values.size() * sizeof(T)) {
+    throw std::runtime_error(fmt::format("{} message #{} has {} B instead of {} B",
+                                         communication::to_string(message_type), message_id,
+                                         fb_vector.size(), values.size() * sizeof(T)));
+  }
+  return fb_vector;
+}
+
+// adds the shares of another party in opening_message to values
+template <typename T>
+static void AddMaskedInputs(communication::MessageType message_type, std::size_t message_id,
+                            const communication::MessageBuffer& opening_message,
+                            std::vector<T>& values, std::size_t number_of_threads = 1) {
+  const auto& fb_vector{GetOpeningPayload(message_type, message_id, opening_message, values)};
+  // the payload is not necessarily aligned for T
+  const std::span<const std::uint8_t> bytes(fb_vector.Data(), fb_vector.size());
+  const std::span<T> accumulator(values);
+  ParallelForRanges(values.size(), number_of_threads, 1, [&](std::size_t begin, std::size_t end) {
+    AddBytesToVector<T>(accumulator.subspan(begin, end - begin),
+                        bytes.subspan(begin * sizeof(T), (end - begin) * sizeof(T)));
+  });
+}
+
+// replaces values by the values that the king opened in opening_message
+template <typename T>
+static void CopyOpenedValues(communication::MessageType message_type, std::size_t message_id,
+                             const communication::MessageBuffer& opening_message,
+                             std::vector<T>& values) {
+  const auto& fb_vector{GetOpeningPayload(message_type, message_id, opening_message, values)};
+  std::memcpy(values.data(), fb_vector.Data(), fb_vector.size());
+}
+
+// Opens the shares in values, see protocols/opening.h
+template <typename T>
+static void OpenMaskedInputs(
+    communication::CommunicationLayer& communication_layer, std::optional<std::size_t> king,
+    communication::MessageType message_type, std::size_t message_id, std::vector<T>& values,
+    std::vector<ReusableFiberFuture<communication::MessageBuffer>>& opening_futures) {
+  SendShareOfOpening(communication_layer, king, message_type, message_id, AsBytes(values));
+  if (ReceivesOpenedValue(communication_layer, king)) {
+    CopyOpenedValues(message_type, message_id, opening_futures.at(0).get(), values);
+    return;
+  }
+  for (auto& future : opening_futures) {
+    AddMaskedInputs(message_type, message_id, future.get(), values);
+  }
+  FinishOpening(communication_layer, king, message_type, message_id, AsBytes(values));
+}
+
 template <typename T>
 InputGate<T>::InputGate(std::span<const T> input, std::size_t input_owner, Backend& backend)
     : Base(backend), input_(std::vector(input.begin(), input.end())) {
@@ -59,11 +126,25 @@ InputGate<T>::InputGate(std::vector<T>&& input, std::size_t input_owner, Backend
   InitializationHelper();
 }
 
+template <typename T>
+InputGate<T>::InputGate(std::size_t number_of_simd, std::size_t input_owner, Backend& backend)
+    : Base(backend), input_(number_of_simd) {
+  input_owner_id_ = input_owner;
+  if (input_owner == GetCommunicationLayer().GetMyId()) {
+    ReusableFiberPromise<std::vector<T>> promise;
+    auto future{promise.get_future()};
+    input_promise_future_.emplace(std::move(promise), std::move(future));
+  }
+  InitializationHelper();
+}
+
 template <typename T>
 void InputGate<T>::InitializationHelper() {
   static_assert(!std::is_same_v<T, bool>);
 
-  arithmetic_sharing_id_ = GetRegister().NextArithmeticSharingId(input_.size());
+  GetRegister().RunInConstructionOrder(*this, [this] {
+    arithmetic_sharing_id_ = GetRegister().NextArithmeticSharingId(input_.size());
+  });
   if constexpr (kVerboseDebug) {
     GetLogger().LogTrace(
         fmt::format("Created an arithmetic_gmw::InputGate with global id {}", gate_id_));
@@ -83,6 +164,10 @@ template <typename T>
 void InputGate<T>::EvaluateOnline() {
   // nothing to setup, no need to wait/check
   GetBaseProvider().WaitSetup();
+  if (input_promise_future_.has_value()) {
+    input_ = input_promise_future_->second.get();
+    assert(input_.size() == output_wires_.at(0)->GetNumberOfSimdValues());
+  }
 
   auto& communication_layer = GetCommunicationLayer();
   auto my_id = communication_layer.GetMyId();
@@ -155,12 +240,122 @@ arithmetic_gmw::WirePointer<T> InputGate<T>::GetOutputArithmeticWire() {
   return result;
 }
 
+template <typename T>
+ReusableFiberPromise<std::vector<T>>& InputGate<T>::GetInputPromise() {
+  if (!input_promise_future_.has_value()) {
+    throw std::logic_error(
+        fmt::format("arithmetic_gmw::InputGate#{} has no deferred input of party#{}", gate_id_,
+                    GetCommunicationLayer().GetMyId()));
+  }
+  return input_promise_future_->first;
+}
+
 template class InputGate<std::uint8_t>;
 template class InputGate<std::uint16_t>;
 template class InputGate<std::uint32_t>;
 template class InputGate<std::uint64_t>;
 template class InputGate<__uint128_t>;
 
+template <typename T>
+InputColumnGate<T>::InputColumnGate(std::span<const T> input,
+                                    std::shared_ptr<const void> input_storage,
+                                    std::size_t input_owner, Backend& backend)
+    : Base(backend),
+      input_(input),
+      input_storage_(std::move(input_storage)),
+      number_of_values_(input.size()) {
+  input_owner_id_ = input_owner;
+  if (input_owner != GetCommunicationLayer().GetMyId()) {
+    throw std::invalid_argument(
+        fmt::format("Party#{} cannot provide the values of the input column of party#{}",
+                    GetCommunicationLayer().GetMyId(), input_owner));
+  }
+  InitializationHelper();
+}
+
+template <typename T>
+InputColumnGate<T>::InputColumnGate(std::size_t number_of_values, std::size_t input_owner,
+                                    Backend& backend)
+    : Base(backend), number_of_values_(number_of_values) {
+  input_owner_id_ = input_owner;
+  if (input_owner == GetCommunicationLayer().GetMyId()) {
+    throw std::invalid_argument(
+        fmt::format("Party#{} needs to provide the values of its input column", input_owner));
+  }
+  InitializationHelper();
+}
+
+template <typename T>
+void InputColumnGate<T>::InitializationHelper() {
+  static_assert(!std::is_same_v<T, bool>);
+
+  // the values of the column are derived from a single stream, which needs only one id
+  GetRegister().RunInConstructionOrder(
+      *this, [this] { arithmetic_sharing_id_ = GetRegister().NextArithmeticSharingId(1); });
+  output_wires_ = {
+      GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_, number_of_values_)};
+
+  GetLogger().LogDebug(fmt::format(
+      "Allocate an arithmetic_gmw::InputColumnGate with following properties: uint{}_t type, gate "
+      "id {}, owner {}, {} values",
+      sizeof(T) * 8, gate_id_, input_owner_id_, number_of_values_));
+}
+
+template <typename T>
+void InputColumnGate<T>::EvaluateOnline() {
+  GetBaseProvider().WaitSetup();
+
+  auto& communication_layer = GetCommunicationLayer();
+  const auto my_id = communication_layer.GetMyId();
+  const auto number_of_parties = communication_layer.GetNumberOfParties();
+
+  auto wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(wire);
+  auto& values = wire->GetMutableValues();
+  values.resize(number_of_values_);
+
+  if (static_cast<std::size_t>(input_owner_id_) == my_id) {
+    // values = sum of the other parties' shares, expanded in place for the first party
+    bool first{true};
+    std::vector<T> randomness;
+    for (auto party_id = 0u; party_id < number_of_parties; ++party_id) {
+      if (party_id == my_id) continue;
+      auto& randomness_generator = GetBaseProvider().GetMyRandomnessGenerator(party_id);
+      if (first) {
+        randomness_generator.template GetUnsignedStream<T>(arithmetic_sharing_id_,
+                                                           std::span<T>(values));
+        first = false;
+      } else {
+        randomness.resize(number_of_values_);
+        randomness_generator.template GetUnsignedStream<T>(arithmetic_sharing_id_,
+                                                           std::span<T>(randomness));
+        for (std::size_t j = 0; j < number_of_values_; ++j) values[j] += randomness[j];
+      }
+    }
+    for (std::size_t j = 0; j < number_of_values_; ++j) values[j] = input_[j] - values[j];
+  } else {
+    auto& randomness_generator = GetBaseProvider().GetTheirRandomnessGenerator(input_owner_id_);
+    randomness_generator.template GetUnsignedStream<T>(arithmetic_sharing_id_,
+                                                       std::span<T>(values));
+  }
+
+  GetLogger().LogDebug(
+      fmt::format("Evaluated arithmetic_gmw::InputColumnGate with id#{}", gate_id_));
+}
+
+template <typename T>
+arithmetic_gmw::SharePointer<T> InputColumnGate<T>::GetOutputAsArithmeticShare() {
+  auto wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(wire);
+  return std::make_shared<arithmetic_gmw::Share<T>>(wire);
+}
+
+template class InputColumnGate<std::uint8_t>;
+template class InputColumnGate<std::uint16_t>;
+template class InputColumnGate<std::uint32_t>;
+template class InputColumnGate<std::uint64_t>;
+template class InputColumnGate<__uint128_t>;
+
 template <typename T>
 OutputGate<T>::OutputGate(const arithmetic_gmw::WirePointer<T>& parent, std::size_t output_owner)
     : Base(parent->GetBackend()) {
@@ -197,8 +392,9 @@ OutputGate<T>::OutputGate(const arithmetic_gmw::WirePointer<T>& parent, std::siz
   // Tell the DataStorages that we want to receive OutputMessages from the
   // other parties.
   if (is_my_output_) {
-    output_message_futures_ = GetCommunicationLayer().GetMessageManager().RegisterReceiveAll(
-        communication::MessageType::kOutputMessage, gate_id_);
+    const auto king{output_owner_ == kAll ? GetOpeningKing(gate_id_) : std::nullopt};
+    output_message_futures_ = RegisterOpening(
+        communication_layer, king, communication::MessageType::kOutputMessage, gate_id_);
   }
 
   if constexpr (kDebug) {
@@ -240,6 +436,7 @@ void OutputGate<T>::EvaluateOnline() {
   arithmetic_wire->GetIsReadyCondition().Wait();
   // initialize output with local share
   auto output = arithmetic_wire->GetValues();
+  const auto king{output_owner_ == kAll ? GetOpeningKing(gate_id_) : std::nullopt};
 
   // we need to send shares to one other party:
   if (!is_my_output_) {
@@ -248,16 +445,23 @@ void OutputGate<T>::EvaluateOnline() {
         communication::BuildMessage(communication::MessageType::kOutputMessage, gate_id_, payload)};
     communication_layer.SendMessage(output_owner_, msg.Release());
   }
-  // we need to send shares to all other parties:
+  // we need to send shares to all other parties or to the king:
   else if (output_owner_ == kAll) {
-    auto payload = ToByteVector<T>(output);
-    auto msg{
-        communication::BuildMessage(communication::MessageType::kOutputMessage, gate_id_, payload)};
-    communication_layer.BroadcastMessage(msg.Release());
+    SendShareOfOpening(communication_layer, king, communication::MessageType::kOutputMessage,
+                       gate_id_, AsBytes(output));
   }
 
+  // the king sent the reconstructed value
+  if (ReceivesOpenedValue(communication_layer, king)) {
+    auto arithmetic_output_wire =
+        std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+    assert(arithmetic_output_wire);
+    CopyOpenedValues(communication::MessageType::kOutputMessage, gate_id_,
+                     output_message_futures_.at(0).get(), output);
+    arithmetic_output_wire->GetMutableValues() = output;
+  }
   // we receive shares from other parties
-  if (is_my_output_) {
+  else if (is_my_output_) {
     // collect shares from all parties
     std::vector<std::vector<T>> shared_outputs;
     shared_outputs.reserve(number_of_parties);
@@ -289,6 +493,8 @@ void OutputGate<T>::EvaluateOnline() {
         std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
     assert(arithmetic_output_wire);
     arithmetic_output_wire->GetMutableValues() = output;
+    FinishOpening(communication_layer, king, communication::MessageType::kOutputMessage, gate_id_,
+                  AsBytes(output));
 
     if constexpr (kVerboseDebug) {
       std::string shares{""};
@@ -323,6 +529,87 @@ template class OutputGate<std::uint32_t>;
 template class OutputGate<std::uint64_t>;
 template class OutputGate<__uint128_t>;
 
+template <typename T>
+RevealGate<T>::RevealGate(std::span<const motion::SharePointer> parents)
+    : NInputGate(parents.front()->GetBackend()) {
+  parents_.reserve(parents.size());
+  for (const auto& parent : parents) {
+    auto arithmetic_parent = std::dynamic_pointer_cast<arithmetic_gmw::Share<T>>(parent);
+    if (!arithmetic_parent) {
+      throw std::invalid_argument(
+          fmt::format("Arithmetic reveal gate expects arithmetic GMW shares of uint{}_t, got a "
+                      "share of type {}",
+                      sizeof(T) * 8, to_string(parent->GetProtocol())));
+    }
+    parents_.emplace_back(arithmetic_parent->GetArithmeticWire());
+  }
+
+  output_wires_.reserve(parents_.size());
+  for (const auto& wire : parents_) {
+    output_wires_.emplace_back(GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
+        backend_, wire->GetNumberOfSimdValues()));
+  }
+
+  output_message_futures_ =
+      RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                      communication::MessageType::kOutputMessage, gate_id_);
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+        fmt::format("Allocate an arithmetic_gmw::RevealGate with id#{} for {} uint{}_t shares",
+                    gate_id_, parents.size(), sizeof(T) * 8));
+  }
+}
+
+template <typename T>
+void RevealGate<T>::EvaluateOnline() {
+  auto& communication_layer = GetCommunicationLayer();
+
+  // the shares of all wires are sent in a single message
+  std::vector<T> values;
+  for (const auto& wire : parents_) {
+    auto arithmetic_wire = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(wire);
+    assert(arithmetic_wire);
+    arithmetic_wire->GetIsReadyCondition().Wait();
+    const auto& wire_values{arithmetic_wire->GetValues()};
+    values.insert(values.end(), wire_values.begin(), wire_values.end());
+  }
+  OpenMaskedInputs(communication_layer, GetOpeningKing(gate_id_),
+                   communication::MessageType::kOutputMessage, gate_id_, values,
+                   output_message_futures_);
+
+  auto begin{values.begin()};
+  for (auto& wire : output_wires_) {
+    auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(wire);
+    assert(arithmetic_wire);
+    const auto end{begin + arithmetic_wire->GetNumberOfSimdValues()};
+    arithmetic_wire->GetMutableValues().assign(begin, end);
+    begin = end;
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Evaluated arithmetic_gmw::RevealGate with id#{}", gate_id_));
+  }
+}
+
+template <typename T>
+std::vector<motion::SharePointer> RevealGate<T>::GetOutputAsShares() const {
+  std::vector<motion::SharePointer> outputs;
+  outputs.reserve(output_wires_.size());
+  for (const auto& wire : output_wires_) {
+    auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(wire);
+    assert(arithmetic_wire);
+    outputs.emplace_back(std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire));
+  }
+  return outputs;
+}
+
+template class RevealGate<std::uint8_t>;
+template class RevealGate<std::uint16_t>;
+template class RevealGate<std::uint32_t>;
+template class RevealGate<std::uint64_t>;
+template class RevealGate<__uint128_t>;
+
 template <typename T>
 AdditionGate<T>::AdditionGate(const arithmetic_gmw::WirePointer<T>& a,
                               const arithmetic_gmw::WirePointer<T>& b)
@@ -357,11 +644,10 @@ void AdditionGate<T>::EvaluateOnline() {
   assert(wire_a);
   assert(wire_b);
 
-  std::vector<T> output;
-  output = RestrictAddVectors<T>(wire_a->GetValues(), wire_b->GetValues());
-
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
-  arithmetic_wire->GetMutableValues() = std::move(output);
+  auto& output{arithmetic_wire->GetMutableValues()};
+  output.resize(wire_a->GetNumberOfSimdValues());
+  AddVectors<T>(wire_a->GetValues(), wire_b->GetValues(), output);
 
   GetLogger().LogDebug(fmt::format("Evaluated arithmetic_gmw::AdditionGate with id#{}", gate_id_));
 }
@@ -414,10 +700,10 @@ void SubtractionGate<T>::EvaluateOnline() {
   assert(wire_a);
   assert(wire_b);
 
-  std::vector<T> output = SubVectors<T>(wire_a->GetValues(), wire_b->GetValues());
-
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
-  arithmetic_wire->GetMutableValues() = std::move(output);
+  auto& output{arithmetic_wire->GetMutableValues()};
+  output.resize(wire_a->GetNumberOfSimdValues());
+  SubVectors<T>(wire_a->GetValues(), wire_b->GetValues(), output);
 
   GetLogger().LogDebug(
       fmt::format("Evaluated arithmetic_gmw::SubtractionGate with id#{}", gate_id_));
@@ -446,19 +732,17 @@ MultiplicationGate<T>::MultiplicationGate(const arithmetic_gmw::WirePointer<T>&
 
   assert(parent_a_.at(0)->GetNumberOfSimdValues() == parent_b_.at(0)->GetNumberOfSimdValues());
 
-  d_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_,
-                                                                   a->GetNumberOfSimdValues());
-  e_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_,
-                                                                   a->GetNumberOfSimdValues());
-
-  d_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(d_);
-  e_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(e_);
+  openings_.resize(2 * a->GetNumberOfSimdValues());
+  opening_futures_ = RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                                     communication::MessageType::kBeaverOpening, gate_id_);
 
   output_wires_ = {GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
       backend_, a->GetNumberOfSimdValues())};
 
   number_of_mts_ = parent_a_.at(0)->GetNumberOfSimdValues();
-  mt_offset_ = GetMtProvider().template RequestArithmeticMts<T>(number_of_mts_);
+  GetRegister().RunInConstructionOrder(
+      *this,
+      [this] { mt_offset_ = GetMtProvider().template RequestArithmeticMts<T>(number_of_mts_); });
 
   auto gate_info =
       fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
@@ -471,79 +755,73 @@ template <typename T>
 void MultiplicationGate<T>::EvaluateSetup() {}
 
 template <typename T>
-void MultiplicationGate<T>::EvaluateOnline() {
+GateTask MultiplicationGate<T>::EvaluateOnlineCoroutine() {
   // nothing to setup, no need to wait/check
   parent_a_.at(0)->GetIsReadyCondition().Wait();
   parent_b_.at(0)->GetIsReadyCondition().Wait();
 
   auto& mt_provider = GetMtProvider();
-  mt_provider.WaitFinished();
-  const auto& mts = mt_provider.template GetIntegerAll<T>();
-  {
-    const auto x = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
-    assert(x);
-    d_->GetMutableValues() = std::vector<T>(
-        mts.a.begin() + mt_offset_, mts.a.begin() + mt_offset_ + x->GetNumberOfSimdValues());
-    T* __restrict__ d_v = d_->GetMutableValues().data();
-    const T* __restrict__ x_v = x->GetValues().data();
-    const auto number_of_simd_values{x->GetNumberOfSimdValues()};
-
-    std::transform(x_v, x_v + number_of_simd_values, d_v, d_v,
-                   [](const T& a, const T& b) { return a + b; });
-    d_->SetOnlineFinished();
-
-    const auto y = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
-    assert(y);
-    e_->GetMutableValues() = std::vector<T>(
-        mts.b.begin() + mt_offset_, mts.b.begin() + mt_offset_ + x->GetNumberOfSimdValues());
-    T* __restrict__ e_v = e_->GetMutableValues().data();
-    const T* __restrict__ y_v = y->GetValues().data();
-    std::transform(y_v, y_v + number_of_simd_values, e_v, e_v,
-                   [](const T& a, const T& b) { return a + b; });
-    e_->SetOnlineFinished();
-  }
-
-  d_output_->WaitOnline();
-  e_output_->WaitOnline();
+  // only waits for the MTs of this gate, the remaining ones may still be computed
+  const auto mts = mt_provider.template GetIntegerView<T>(mt_offset_, number_of_mts_);
 
-  const auto& d_clear = d_output_->GetOutputWires().at(0);
-  const auto& e_clear = e_output_->GetOutputWires().at(0);
-
-  d_clear->GetIsReadyCondition().Wait();
-  e_clear->GetIsReadyCondition().Wait();
-
-  const auto d_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(d_clear);
   const auto x_i_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
-  const auto e_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(e_clear);
   const auto y_i_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
-
-  assert(d_w);
   assert(x_i_w);
-  assert(e_w);
   assert(y_i_w);
+  const auto number_of_simd_values{x_i_w->GetNumberOfSimdValues()};
+
+  // d = x + a and e = y + b are opened together
+  const std::size_t number_of_threads{GetNumberOfParallelThreads(number_of_simd_values)};
+  const std::span<T> openings(openings_);
+  const std::span<const T> x(x_i_w->GetValues()), y(y_i_w->GetValues());
+  ParallelForRanges(number_of_simd_values, number_of_threads, 1,
+                    [&](std::size_t begin, std::size_t end) {
+                      const std::size_t n{end - begin};
+                      AddVectors<T>(x.subspan(begin, n), mts.a.subspan(begin, n),
+                                    openings.subspan(begin, n));
+                      AddVectors<T>(y.subspan(begin, n), mts.b.subspan(begin, n),
+                                    openings.subspan(number_of_simd_values + begin, n));
+                    });
+  auto& communication_layer = GetCommunicationLayer();
+  const auto king{GetOpeningKing(gate_id_)};
+  SendShareOfOpening(communication_layer, king, communication::MessageType::kBeaverOpening,
+                     gate_id_, AsBytes(openings_));
+  if (ReceivesOpenedValue(communication_layer, king)) {
+    CopyOpenedValues(communication::MessageType::kBeaverOpening, gate_id_,
+                     co_await opening_futures_.at(0), openings_);
+  } else {
+    for (auto& future : opening_futures_) {
+      AddMaskedInputs(communication::MessageType::kBeaverOpening, gate_id_, co_await future,
+                      openings_, number_of_threads);
+    }
+    FinishOpening(communication_layer, king, communication::MessageType::kBeaverOpening, gate_id_,
+                  AsBytes(openings_));
+  }
 
   auto output = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(output);
-  output->GetMutableValues() =
-      std::vector<T>(mts.c.begin() + mt_offset_,
-                     mts.c.begin() + mt_offset_ + parent_a_.at(0)->GetNumberOfSimdValues());
+  output->GetMutableValues().assign(mts.c.begin(), mts.c.end());
 
-  const T* __restrict__ d{d_w->GetValues().data()};
+  const T* __restrict__ d{openings_.data()};
   const T* __restrict__ s_x{x_i_w->GetValues().data()};
-  const T* __restrict__ e{e_w->GetValues().data()};
+  const T* __restrict__ e{openings_.data() + number_of_simd_values};
   const T* __restrict__ s_y{y_i_w->GetValues().data()};
   T* __restrict__ output_pointer{output->GetMutableValues().data()};
 
-  if (GetCommunicationLayer().GetMyId() ==
-      (gate_id_ % GetCommunicationLayer().GetNumberOfParties())) {
-    for (auto i = 0ull; i < output->GetNumberOfSimdValues(); ++i) {
-      output_pointer[i] += (d[i] * s_y[i]) + (e[i] * s_x[i]) - (e[i] * d[i]);
-    }
-  } else {
-    for (auto i = 0ull; i < output->GetNumberOfSimdValues(); ++i) {
-      output_pointer[i] += (d[i] * s_y[i]) + (e[i] * s_x[i]);
-    }
-  }
+  const bool subtracts_product{GetCommunicationLayer().GetMyId() ==
+                               (gate_id_ % GetCommunicationLayer().GetNumberOfParties())};
+  ParallelForRanges(number_of_simd_values, number_of_threads, 1,
+                    [=](std::size_t begin, std::size_t end) {
+                      if (subtracts_product) {
+                        for (auto i = begin; i < end; ++i) {
+                          output_pointer[i] += (d[i] * s_y[i]) + (e[i] * s_x[i]) - (e[i] * d[i]);
+                        }
+                      } else {
+                        for (auto i = begin; i < end; ++i) {
+                          output_pointer[i] += (d[i] * s_y[i]) + (e[i] * s_x[i]);
+                        }
+                      }
+                    });
 
   GetLogger().LogDebug(
       fmt::format("Evaluated arithmetic_gmw::MultiplicationGate with id#{}", gate_id_));
@@ -561,7 +839,146 @@ template class MultiplicationGate<std::uint8_t>;
 template class MultiplicationGate<std::uint16_t>;
 template class MultiplicationGate<std::uint32_t>;
 template class MultiplicationGate<std::uint64_t>;
-// template class MultiplicationGate<__uint128_t>; not yet supported
+template class MultiplicationGate<__uint128_t>;
+
+template <typename T>
+MatrixMultiplicationGate<T>::MatrixMultiplicationGate(const arithmetic_gmw::WirePointer<T>& a,
+                                                      const arithmetic_gmw::WirePointer<T>& b,
+                                                      std::size_t rows, std::size_t inner,
+                                                      std::size_t columns)
+    : TwoGate(a->GetBackend()), rows_(rows), inner_(inner), columns_(columns) {
+  if (a->GetNumberOfSimdValues() != rows * inner || b->GetNumberOfSimdValues() != inner * columns) {
+    throw std::invalid_argument(fmt::format(
+        "Matrices with {} and {} elements do not have the shapes {}x{} and {}x{}",
+        a->GetNumberOfSimdValues(), b->GetNumberOfSimdValues(), rows, inner, inner, columns));
+  }
+  parent_a_ = {std::static_pointer_cast<motion::Wire>(a)};
+  parent_b_ = {std::static_pointer_cast<motion::Wire>(b)};
+
+  openings_.resize(rows * inner + inner * columns);
+  opening_futures_ = RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                                     communication::MessageType::kBeaverOpening, gate_id_);
+
+  output_wires_ = {
+      GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_, rows * columns)};
+
+  GetRegister().RunInConstructionOrder(*this, [this, rows, inner, columns] {
+    matrix_mt_id_ = GetMtProvider().template RequestMatrixMts<T>(rows, inner, columns);
+  });
+
+  auto gate_info = fmt::format("uint{}_t type, gate id {}, shape {}x{}x{}, parents: {}, {}",
+                               sizeof(T) * 8, gate_id_, rows, inner, columns,
+                               parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
+  GetLogger().LogDebug(fmt::format(
+      "Created an arithmetic_gmw::MatrixMultiplicationGate with following properties: {}",
+      gate_info));
+}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateSetup() {}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateOnline() {
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
+
+  const auto& mt = GetMtProvider().template GetMatrixMt<T>(matrix_mt_id_);
+  const auto x = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
+  const auto y = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
+  assert(x);
+  assert(y);
+
+  // mask the inputs with the matrices of the triple and open both in one message
+  const std::span<T> openings(openings_);
+  AddVectors<T>(x->GetValues(), mt.a, openings.first(rows_ * inner_));
+  AddVectors<T>(y->GetValues(), mt.b, openings.subspan(rows_ * inner_));
+  OpenMaskedInputs(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                   communication::MessageType::kBeaverOpening, gate_id_, openings_,
+                   opening_futures_);
+
+  // x * y = c + d * y + x * e - d * e
+  auto output = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(output);
+  output->GetMutableValues() = mt.c;
+  T* output_pointer{output->GetMutableValues().data()};
+  const T* d{openings_.data()};
+  const T* e{openings_.data() + rows_ * inner_};
+  AddMatrixProduct(d, y->GetValues().data(), output_pointer, rows_, inner_, columns_);
+  AddMatrixProduct(x->GetValues().data(), e, output_pointer, rows_, inner_, columns_);
+  if (GetCommunicationLayer().GetMyId() ==
+      (gate_id_ % GetCommunicationLayer().GetNumberOfParties())) {
+    std::vector<T> d_times_e(rows_ * columns_, 0);
+    AddMatrixProduct(d, e, d_times_e.data(), rows_, inner_, columns_);
+    SubVectors<T>(output->GetValues(), d_times_e, output->GetMutableValues());
+  }
+
+  GetLogger().LogDebug(
+      fmt::format("Evaluated arithmetic_gmw::MatrixMultiplicationGate with id#{}", gate_id_));
+}
+
+template <typename T>
+arithmetic_gmw::SharePointer<T> MatrixMultiplicationGate<T>::GetOutputAsArithmeticShare() {
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(arithmetic_wire);
+  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  return result;
+}
+
+template class MatrixMultiplicationGate<std::uint8_t>;
+template class MatrixMultiplicationGate<std::uint16_t>;
+template class MatrixMultiplicationGate<std::uint32_t>;
+template class MatrixMultiplicationGate<std::uint64_t>;
+
+template <typename T>
+RowSumGate<T>::RowSumGate(const arithmetic_gmw::WirePointer<T>& a, std::size_t rows)
+    : OneGate(a->GetBackend()), rows_(rows) {
+  if (rows_ == 0 || a->GetNumberOfSimdValues() % rows_ != 0) {
+    throw std::invalid_argument(
+        fmt::format("RowSumGate: cannot split {} SIMD values into {} rows",
+                    a->GetNumberOfSimdValues(), rows_));
+  }
+  columns_ = a->GetNumberOfSimdValues() / rows_;
+  parent_ = {std::static_pointer_cast<motion::Wire>(a)};
+
+  output_wires_ = {GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_, rows_)};
+
+  auto gate_info =
+      fmt::format("uint{}_t type, gate id {}, {} x {} matrix, parent: {}", sizeof(T) * 8,
+                  gate_id_, rows_, columns_, parent_.at(0)->GetWireId());
+  GetLogger().LogDebug(fmt::format(
+      "Created an arithmetic_gmw::RowSumGate with following properties: {}", gate_info));
+}
+
+template <typename T>
+void RowSumGate<T>::EvaluateOnline() {
+  parent_.at(0)->GetIsReadyCondition().Wait();
+
+  auto wire_a = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_.at(0));
+  assert(wire_a);
+  const auto& values{wire_a->GetValues()};
+
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  auto& output{arithmetic_wire->GetMutableValues()};
+  output.assign(rows_, 0);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    output[i] = std::accumulate(values.begin() + i * columns_, values.begin() + (i + 1) * columns_,
+                                T(0));
+  }
+
+  GetLogger().LogDebug(fmt::format("Evaluated arithmetic_gmw::RowSumGate with id#{}", gate_id_));
+}
+
+template <typename T>
+arithmetic_gmw::SharePointer<T> RowSumGate<T>::GetOutputAsArithmeticShare() {
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(arithmetic_wire);
+  return std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+}
+
+template class RowSumGate<std::uint8_t>;
+template class RowSumGate<std::uint16_t>;
+template class RowSumGate<std::uint32_t>;
+template class RowSumGate<std::uint64_t>;
 
 template <typename T>
 HybridMultiplicationGate<T>::HybridMultiplicationGate(const boolean_gmw::WirePointer& bit,
@@ -581,13 +998,22 @@ HybridMultiplicationGate<T>::HybridMultiplicationGate(const boolean_gmw::WirePoi
   const std::size_t number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
   const std::size_t my_id = GetCommunicationLayer().GetMyId();
 
-  for (std::size_t i = 0; i < number_of_parties; ++i) {
-    if (i == my_id) continue;
-    ot_sender_ =
-        GetOtProvider(i).RegisterSendAcOt(parent_a_[0]->GetNumberOfSimdValues(), sizeof(T) * 8);
-    ot_receiver_ =
-        GetOtProvider(i).RegisterReceiveAcOt(parent_a_[0]->GetNumberOfSimdValues(), sizeof(T) * 8);
-  }
+  // joining the batch needs to happen at construction time, since it may be closed afterwards
+  ot_batch_ = backend_.GetOtProviderManager().GetOtBatcher().template GetAcOtBatch<T>(1 - my_id);
+
+  GetRegister().RunInConstructionOrder(*this, [this, number_of_parties, my_id] {
+    if (ot_batch_) {
+      ot_batch_offset_ = ot_batch_->Add(parent_a_[0]->GetNumberOfSimdValues());
+      return;
+    }
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      if (i == my_id) continue;
+      ot_sender_ =
+          GetOtProvider(i).RegisterSendAcOt(parent_a_[0]->GetNumberOfSimdValues(), sizeof(T) * 8);
+      ot_receiver_ = GetOtProvider(i).RegisterReceiveAcOt(parent_a_[0]->GetNumberOfSimdValues(),
+                                                          sizeof(T) * 8);
+    }
+  });
 
   auto gate_info =
       fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
@@ -627,6 +1053,20 @@ void HybridMultiplicationGate<T>::EvaluateOnline() {
     a_out->GetMutableValues().emplace_back(bv[i] ? av[i] : static_cast<T>(0));
   }
 
+  if (ot_batch_) {
+    const std::size_t number_of_simd{parent_a_[0]->GetNumberOfSimdValues()};
+    ot_batch_->Contribute(ot_batch_offset_, ot_data, bv);
+    ot_batch_->WaitOutputs();
+    const auto sender_output{ot_batch_->GetSenderOutputs(ot_batch_offset_, number_of_simd)};
+    const auto receiver_output{ot_batch_->GetReceiverOutputs(ot_batch_offset_, number_of_simd)};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+      a_out->GetMutableValues()[simd_i] += receiver_output[simd_i] - sender_output[simd_i];
+    }
+    GetLogger().LogDebug(
+        fmt::format("Evaluated arithmetic_gmw::HybridMultiplicationGate with id#{}", gate_id_));
+    return;
+  }
+
   // AcOt Send and Recieve
 
   auto casted_ot_sender{dynamic_cast<AcOtSender<T>*>(ot_sender_.get())};
@@ -672,19 +1112,137 @@ template class HybridMultiplicationGate<std::uint32_t>;
 template class HybridMultiplicationGate<std::uint64_t>;
 // template class HybridMultiplicationGate<__uint128_t>; not yet supported
 
+template <typename T>
+BitInjectionGate<T>::BitInjectionGate(const boolean_gmw::WirePointer& bit,
+                                      std::span<const arithmetic_gmw::WirePointer<T>> values)
+    : NInputGate(bit->GetBackend()),
+      number_of_values_(values.size()),
+      number_of_simd_(bit->GetNumberOfSimdValues()) {
+  if (GetCommunicationLayer().GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("arithmetic_gmw::BitInjectionGate requires 2 parties, got {}",
+                    GetCommunicationLayer().GetNumberOfParties()));
+  }
+  if (values.empty()) {
+    throw std::invalid_argument("arithmetic_gmw::BitInjectionGate requires at least one value");
+  }
+  parents_.reserve(1 + number_of_values_);
+  parents_.emplace_back(bit);
+  output_wires_.reserve(number_of_values_);
+  for (const auto& value : values) {
+    if (value->GetNumberOfSimdValues() != number_of_simd_) {
+      throw std::invalid_argument(fmt::format(
+          "arithmetic_gmw::BitInjectionGate: the bit has {} SIMD values, but a value has {}",
+          number_of_simd_, value->GetNumberOfSimdValues()));
+    }
+    parents_.emplace_back(value);
+    output_wires_.emplace_back(
+        GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_, number_of_simd_));
+  }
+
+  const std::size_t other_id{1 - GetCommunicationLayer().GetMyId()};
+  GetRegister().RunInConstructionOrder(*this, [this, other_id] {
+    ot_sender_ = GetOtProvider(other_id).RegisterSendAcOt(number_of_simd_, sizeof(T) * 8,
+                                                          number_of_values_);
+    ot_receiver_ = GetOtProvider(other_id).RegisterReceiveAcOt(number_of_simd_, sizeof(T) * 8,
+                                                               number_of_values_);
+  });
+
+  GetLogger().LogDebug(fmt::format(
+      "Created an arithmetic_gmw::BitInjectionGate with following properties: uint{}_t type, "
+      "gate id {}, bit: {}, {} values",
+      sizeof(T) * 8, gate_id_, bit->GetWireId(), number_of_values_));
+}
+
+template <typename T>
+void BitInjectionGate<T>::EvaluateOnline() {
+  for (const auto& parent : parents_) parent->GetIsReadyCondition().Wait();
+
+  const auto bit_wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parents_.at(0));
+  assert(bit_wire);
+  const auto& bits{bit_wire->GetValues()};
+
+  // the correlations of SIMD value i are (-1)^<b_i> * <v_j,i> for j = 1, ..., m
+  std::vector<T> correlations(number_of_simd_ * number_of_values_);
+  for (std::size_t j = 0; j < number_of_values_; ++j) {
+    const auto value_wire =
+        std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parents_.at(1 + j));
+    assert(value_wire);
+    const auto& values{value_wire->GetValues()};
+    for (std::size_t i = 0; i < number_of_simd_; ++i) {
+      correlations[i * number_of_values_ + j] = bits.Get(i) ? -values[i] : values[i];
+    }
+  }
+
+  auto ot_sender{dynamic_cast<AcOtSender<T>*>(ot_sender_.get())};
+  auto ot_receiver{dynamic_cast<AcOtReceiver<T>*>(ot_receiver_.get())};
+  assert(ot_sender);
+  assert(ot_receiver);
+
+  ot_sender->WaitSetup();
+  ot_sender->SetCorrelations(std::move(correlations));
+  ot_sender->SendMessages();
+
+  ot_receiver->WaitSetup();
+  ot_receiver->SetChoices(bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->ComputeOutputs();
+  ot_receiver->ComputeOutputs();
+  const auto& sender_outputs{ot_sender->GetOutputs()};
+  const auto& receiver_outputs{ot_receiver->GetOutputs()};
+
+  // <b_i> * <v_j,i> + the received minus the sent share of the cross terms
+  for (std::size_t j = 0; j < number_of_values_; ++j) {
+    const auto value_wire =
+        std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parents_.at(1 + j));
+    const auto& values{value_wire->GetValues()};
+    auto output_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(j));
+    assert(output_wire);
+    auto& output{output_wire->GetMutableValues()};
+    output.resize(number_of_simd_);
+    for (std::size_t i = 0; i < number_of_simd_; ++i) {
+      const std::size_t k{i * number_of_values_ + j};
+      output[i] = (bits.Get(i) ? values[i] : T(0)) + receiver_outputs[k] - sender_outputs[k];
+    }
+  }
+
+  GetLogger().LogDebug(
+      fmt::format("Evaluated arithmetic_gmw::BitInjectionGate with id#{}", gate_id_));
+}
+
+template <typename T>
+std::vector<arithmetic_gmw::SharePointer<T>> BitInjectionGate<T>::GetOutputAsArithmeticShares()
+    const {
+  std::vector<arithmetic_gmw::SharePointer<T>> result;
+  result.reserve(number_of_values_);
+  for (const auto& wire : output_wires_) {
+    auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(wire);
+    assert(arithmetic_wire);
+    result.emplace_back(std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire));
+  }
+  return result;
+}
+
+template class BitInjectionGate<std::uint8_t>;
+template class BitInjectionGate<std::uint16_t>;
+template class BitInjectionGate<std::uint32_t>;
+template class BitInjectionGate<std::uint64_t>;
+
 template <typename T>
 SquareGate<T>::SquareGate(const arithmetic_gmw::WirePointer<T>& a) : OneGate(a->GetBackend()) {
   parent_ = {std::static_pointer_cast<motion::Wire>(a)};
 
-  d_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_,
-                                                                   a->GetNumberOfSimdValues());
-  d_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(d_);
+  openings_.resize(a->GetNumberOfSimdValues());
+  opening_futures_ = RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                                     communication::MessageType::kBeaverOpening, gate_id_);
 
   output_wires_ = {GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
       backend_, a->GetNumberOfSimdValues())};
 
   number_of_sps_ = parent_.at(0)->GetNumberOfSimdValues();
-  sp_offset_ = GetSpProvider().template RequestSps<T>(number_of_sps_);
+  GetRegister().RunInConstructionOrder(
+      *this, [this] { sp_offset_ = GetSpProvider().template RequestSps<T>(number_of_sps_); });
 
   auto gate_info = fmt::format("uint{}_t type, gate id {}, parent: {}", sizeof(T) * 8, gate_id_,
                                parent_.at(0)->GetWireId());
@@ -703,30 +1261,13 @@ void SquareGate<T>::EvaluateOnline() {
   auto& sp_provider = GetSpProvider();
   sp_provider.WaitFinished();
   const auto& sps = sp_provider.template GetSpsAll<T>();
-  {
-    const auto x = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_.at(0));
-    assert(x);
-    d_->GetMutableValues() = std::vector<T>(
-        sps.a.begin() + sp_offset_, sps.a.begin() + sp_offset_ + x->GetNumberOfSimdValues());
-    T* __restrict__ d_v{d_->GetMutableValues().data()};
-    const T* __restrict__ x_v{x->GetValues().data()};
-    const auto number_of_simd_values{x->GetNumberOfSimdValues()};
-    std::transform(x_v, x_v + number_of_simd_values, d_v, d_v,
-                   [](const T& a, const T& b) { return a + b; });
-    d_->SetOnlineFinished();
-  }
-
-  d_output_->WaitOnline();
-
-  const auto& d_clear = d_output_->GetOutputWires().at(0);
-
-  d_clear->GetIsReadyCondition().Wait();
-
-  const auto d_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(d_clear);
   const auto x_i_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_.at(0));
-
-  assert(d_w);
   assert(x_i_w);
+  AddVectors<T>(x_i_w->GetValues(), std::span(sps.a).subspan(sp_offset_, openings_.size()),
+                openings_);
+  OpenMaskedInputs(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                   communication::MessageType::kBeaverOpening, gate_id_, openings_,
+                   opening_futures_);
 
   auto output = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(output);
@@ -734,7 +1275,7 @@ void SquareGate<T>::EvaluateOnline() {
       std::vector<T>(sps.c.begin() + sp_offset_,
                      sps.c.begin() + sp_offset_ + parent_.at(0)->GetNumberOfSimdValues());
 
-  const T* __restrict__ d{d_w->GetValues().data()};
+  const T* __restrict__ d{openings_.data()};
   const T* __restrict__ s_x{x_i_w->GetValues().data()};
   T* __restrict__ output_pointer{output->GetMutableValues().data()};
   if (GetCommunicationLayer().GetMyId() ==
@@ -766,262 +1307,502 @@ template class SquareGate<std::uint64_t>;
 template class SquareGate<__uint128_t>;
 
 template <typename T>
-GreaterThanGate<T>::GreaterThanGate(arithmetic_gmw::WirePointer<T>& a,
-                                    arithmetic_gmw::WirePointer<T>& b, std::size_t l_s)
-    : TwoGate(a->GetBackend()), chunk_bit_length_(l_s) {
-  parent_a_ = {std::static_pointer_cast<motion::Wire>(a)};
-  parent_b_ = {std::static_pointer_cast<motion::Wire>(b)};
-
-  assert(parent_a_.at(0)->GetNumberOfSimdValues() == parent_b_.at(0)->GetNumberOfSimdValues());
+MultiInputMultiplicationGate<T>::MultiInputMultiplicationGate(
+    std::span<const arithmetic_gmw::WirePointer<T>> inputs)
+    : NInputGate(inputs.front()->GetBackend()),
+      number_of_inputs_(inputs.size()),
+      number_of_simd_(inputs.front()->GetNumberOfSimdValues()) {
+  if (number_of_inputs_ < 2 || number_of_inputs_ > kMaxMultiplicationFanIn) {
+    throw std::invalid_argument(
+        fmt::format("Multi-input multiplication gates have 2 to {} inputs, got {}",
+                    kMaxMultiplicationFanIn, number_of_inputs_));
+  }
+  for (const auto& input : inputs) {
+    if (input->GetNumberOfSimdValues() != number_of_simd_) {
+      throw std::invalid_argument(fmt::format(
+          "Inputs of a multi-input multiplication gate have {} and {} SIMD values",
+          number_of_simd_, input->GetNumberOfSimdValues()));
+    }
+    parents_.emplace_back(std::static_pointer_cast<motion::Wire>(input));
+  }
 
-  // the plaintext numbers have to be smaller than 2^{bit_length - 1}
-  assert(parent_a_.at(0)->GetBitLength() == parent_b_.at(0)->GetBitLength());
-  auto bit_length = parent_a_.at(0)->GetBitLength();
+  const std::size_t number_of_subsets{std::size_t(1) << number_of_inputs_};
+  mask_products_.resize(number_of_subsets * number_of_simd_);
+  openings_.resize(number_of_inputs_ * number_of_simd_);
 
-  const auto& communication_layer = GetCommunicationLayer();
-  number_of_parties_ = communication_layer.GetNumberOfParties();
-  number_of_simd_ = parent_a_.at(0)->GetNumberOfSimdValues();
-  my_id_ = communication_layer.GetMyId();
+  // the setup phase computes the products of the subsets of size 2, ..., k in one round each
+  auto& communication_layer = GetCommunicationLayer();
+  for (std::size_t round = 0; round + 1 < number_of_inputs_; ++round) {
+    const std::size_t message_id{gate_id_ * kMaxMultiplicationFanIn + round};
+    setup_futures_.emplace_back(RegisterOpening(communication_layer, GetOpeningKing(message_id),
+                                                communication::MessageType::kMultiInputMaskProducts,
+                                                message_id));
+  }
+  opening_futures_ = RegisterOpening(communication_layer, GetOpeningKing(gate_id_),
+                                     communication::MessageType::kBeaverOpening, gate_id_);
 
   output_wires_ = {
-      GetRegister().template EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_)};
+      GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_, number_of_simd_)};
 
-  auto number_of_intermediate_iterations = 0u;  // how many times while-loop will run
-  auto ot_bit_length = chunk_bit_length_ - 1;
-  if (my_id_ == 0) {
-    // register party 0 as receiver for 1ooN-OT
-    if (bit_length > chunk_bit_length_) {
-      number_of_intermediate_iterations = std::ceil(
-          static_cast<float>(bit_length - 1 - chunk_bit_length_) / (chunk_bit_length_ - 1));
-      ot_1oon_receiver_.push_back(
-          GetKk13OtProvider(1).RegisterReceiveGOtBit(number_of_simd_, pow(2, chunk_bit_length_)));
-    }
+  // one triple per SIMD value for every subset with at least two elements
+  number_of_mts_ = (number_of_subsets - number_of_inputs_ - 1) * number_of_simd_;
+  GetRegister().RunInConstructionOrder(
+      *this,
+      [this] { mt_offset_ = GetMtProvider().template RequestArithmeticMts<T>(number_of_mts_); });
+
+  auto gate_info = fmt::format("uint{}_t type, gate id {}, {} inputs", sizeof(T) * 8, gate_id_,
+                               number_of_inputs_);
+  GetLogger().LogDebug(fmt::format(
+      "Created an arithmetic_gmw::MultiInputMultiplicationGate with following properties: {}",
+      gate_info));
+}
+
+template <typename T>
+void MultiInputMultiplicationGate<T>::EvaluateSetup() {
+  const std::size_t n{number_of_simd_};
+  const std::size_t number_of_subsets{std::size_t(1) << number_of_inputs_};
+
+  // the masks a_i of the inputs are the products of the singletons
+  for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+    const auto mask{RandomVector<T>(n)};
+    std::copy(mask.begin(), mask.end(), mask_products_.begin() + (std::size_t(1) << i) * n);
+  }
 
-    for (auto i = 0u; i < number_of_intermediate_iterations; i++) {
-      // number of messages of the last iterations
-      if (i == number_of_intermediate_iterations - 1) {
-        ot_bit_length =
-            bit_length - 2 - number_of_intermediate_iterations * (chunk_bit_length_ - 1);
+  auto& communication_layer = GetCommunicationLayer();
+  const bool subtracts_product{communication_layer.GetMyId() ==
+                               gate_id_ % communication_layer.GetNumberOfParties()};
+  const auto mts = GetMtProvider().template GetIntegerView<T>(mt_offset_, number_of_mts_);
+  std::size_t mt_index{0};
+  std::vector<std::size_t> subsets;
+  std::vector<T> masked_factors;
+  for (std::size_t size = 2; size <= number_of_inputs_; ++size) {
+    // a_S = a_{S \ {j}} * a_j for the largest element j of S
+    subsets.clear();
+    for (std::size_t subset = 1; subset < number_of_subsets; ++subset) {
+      if (static_cast<std::size_t>(std::popcount(subset)) == size) subsets.emplace_back(subset);
+    }
+    const std::size_t m{subsets.size() * n};
+    masked_factors.resize(2 * m);
+    for (std::size_t s = 0; s < subsets.size(); ++s) {
+      const std::size_t largest{std::size_t(1) << (std::bit_width(subsets[s]) - 1)};
+      const T* x{mask_products_.data() + (subsets[s] ^ largest) * n};
+      const T* y{mask_products_.data() + largest * n};
+      for (std::size_t v = 0; v < n; ++v) {
+        masked_factors[s * n + v] = x[v] + mts.a[mt_index + s * n + v];
+        masked_factors[m + s * n + v] = y[v] + mts.b[mt_index + s * n + v];
       }
-      ot_1oon_receiver_.push_back(
-          GetKk13OtProvider(1).RegisterReceiveGOtBit(number_of_simd_, 2 * pow(2, ot_bit_length)));
     }
-  } else {
-    // register party 1 as sender for 1ooN-OT
-    if (bit_length > chunk_bit_length_) {
-      number_of_intermediate_iterations = std::ceil(
-          static_cast<float>(bit_length - 1 - chunk_bit_length_) / (chunk_bit_length_ - 1));
-      ot_1oon_sender_.push_back(
-          GetKk13OtProvider(0).RegisterSendGOtBit(number_of_simd_, pow(2, chunk_bit_length_)));
+    const std::size_t message_id{gate_id_ * kMaxMultiplicationFanIn + size - 2};
+    OpenMaskedInputs(communication_layer, GetOpeningKing(message_id),
+                     communication::MessageType::kMultiInputMaskProducts, message_id,
+                     masked_factors, setup_futures_.at(size - 2));
+    for (std::size_t s = 0; s < subsets.size(); ++s) {
+      const std::size_t largest{std::size_t(1) << (std::bit_width(subsets[s]) - 1)};
+      const T* x{mask_products_.data() + (subsets[s] ^ largest) * n};
+      const T* y{mask_products_.data() + largest * n};
+      T* product{mask_products_.data() + subsets[s] * n};
+      for (std::size_t v = 0; v < n; ++v) {
+        const T d{masked_factors[s * n + v]};
+        const T e{masked_factors[m + s * n + v]};
+        product[v] = mts.c[mt_index + s * n + v] + d * y[v] + e * x[v];
+        if (subtracts_product) product[v] -= d * e;
+      }
     }
+    mt_index += m;
+  }
+  assert(mt_index == number_of_mts_);
+
+  GetLogger().LogDebug(fmt::format(
+      "Evaluated setup of arithmetic_gmw::MultiInputMultiplicationGate with id#{}", gate_id_));
+}
 
-    for (auto i = 0u; i < number_of_intermediate_iterations; i++) {
-      // number of messages of the last iterations
-      if (i == number_of_intermediate_iterations - 1) {
-        ot_bit_length =
-            bit_length - 2 - number_of_intermediate_iterations * (chunk_bit_length_ - 1);
+template <typename T>
+void MultiInputMultiplicationGate<T>::EvaluateOnline() {
+  WaitSetup();
+  for (auto& wire : parents_) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  const std::size_t n{number_of_simd_};
+  for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+    const auto x = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parents_.at(i));
+    assert(x);
+    AddVectors<T>(x->GetValues(), std::span(mask_products_).subspan((std::size_t(1) << i) * n, n),
+                  std::span(openings_).subspan(i * n, n));
+  }
+  auto& communication_layer = GetCommunicationLayer();
+  OpenMaskedInputs(communication_layer, GetOpeningKing(gate_id_),
+                   communication::MessageType::kBeaverOpening, gate_id_, openings_,
+                   opening_futures_);
+
+  auto output = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(output);
+  auto& output_values{output->GetMutableValues()};
+  output_values.resize(n);
+
+  const bool adds_product{communication_layer.GetMyId() ==
+                          gate_id_ % communication_layer.GetNumberOfParties()};
+  const std::size_t number_of_subsets{std::size_t(1) << number_of_inputs_};
+  const std::size_t all_inputs{number_of_subsets - 1};
+  // products of the opened d_i of all subsets
+  std::vector<T> opened_products(number_of_subsets);
+  opened_products[0] = 1;
+  for (std::size_t v = 0; v < n; ++v) {
+    for (std::size_t subset = 1; subset < number_of_subsets; ++subset) {
+      opened_products[subset] = opened_products[subset & (subset - 1)] *
+                                openings_[std::countr_zero(subset) * n + v];
+    }
+    T sum{adds_product ? opened_products[all_inputs] : T(0)};
+    for (std::size_t subset = 1; subset < number_of_subsets; ++subset) {
+      const T term = mask_products_[subset * n + v] * opened_products[all_inputs ^ subset];
+      if (std::popcount(subset) % 2 == 1) {
+        sum -= term;
+      } else {
+        sum += term;
       }
-      ot_1oon_sender_.push_back(
-          GetKk13OtProvider(0).RegisterSendGOtBit(number_of_simd_, 2 * pow(2, ot_bit_length)));
     }
+    output_values[v] = sum;
   }
 
-  auto gate_info =
-      fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
-                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
   GetLogger().LogDebug(fmt::format(
-      "Created an arithmetic_gmw::GreaterThanGate with following properties: {}", gate_info));
+      "Evaluated arithmetic_gmw::MultiInputMultiplicationGate with id#{}", gate_id_));
 }
 
 template <typename T>
-void GreaterThanGate<T>::RunSender1ooNOt(encrypto::motion::BitVector<> messages,
-                                         std::size_t ot_index) {
-  ot_1oon_sender_[ot_index]->WaitSetup();
-
-  ot_1oon_sender_[ot_index]->SetInputs(messages);
-  ot_1oon_sender_[ot_index]->SendMessages();
+arithmetic_gmw::SharePointer<T> MultiInputMultiplicationGate<T>::GetOutputAsArithmeticShare() {
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(arithmetic_wire);
+  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  return result;
 }
 
+template class MultiInputMultiplicationGate<std::uint8_t>;
+template class MultiInputMultiplicationGate<std::uint16_t>;
+template class MultiInputMultiplicationGate<std::uint32_t>;
+template class MultiInputMultiplicationGate<std::uint64_t>;
+template class MultiInputMultiplicationGate<__uint128_t>;
+
 template <typename T>
-BitVector<> GreaterThanGate<T>::RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index,
-                                               std::size_t ot_index) {
-  ot_1oon_receiver_[ot_index]->WaitSetup();
+TruncationGate<T>::TruncationGate(const arithmetic_gmw::WirePointer<T>& parent,
+                                  std::size_t number_of_fractional_bits)
+    : OneGate(parent->GetBackend()), number_of_fractional_bits_(number_of_fractional_bits) {
+  parent_ = {std::static_pointer_cast<motion::Wire>(parent)};
+
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  if (number_of_fractional_bits_ + 2 > kBitLength) {
+    throw std::invalid_argument(
+        fmt::format("Cannot truncate {} bits of a {}-bit arithmetic GMW share, at most {} bits",
+                    number_of_fractional_bits_, kBitLength, kBitLength - 2));
+  }
 
-  ot_1oon_receiver_[ot_index]->SetChoices(selection_index);
-  ot_1oon_receiver_[ot_index]->SendCorrections();
+  const std::size_t number_of_simd{parent->GetNumberOfSimdValues()};
+  openings_.resize(number_of_simd);
+  opening_futures_ = RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                                     communication::MessageType::kTruncationOpening, gate_id_);
 
-  ot_1oon_receiver_[ot_index]->ComputeOutputs();
-  return ot_1oon_receiver_[ot_index]->GetOutputs();
+  output_wires_ = {
+      GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_, number_of_simd)};
+
+  GetRegister().RunInConstructionOrder(*this, [this, number_of_simd] {
+    truncation_pair_offset_ =
+        GetTruncationPairProvider().template RequestTruncationPairs<T>(number_of_simd);
+  });
+
+  auto gate_info = fmt::format("uint{}_t type, gate id {}, parent: {}, fractional bits: {}",
+                               kBitLength, gate_id_, parent_.at(0)->GetWireId(),
+                               number_of_fractional_bits_);
+  GetLogger().LogDebug(fmt::format(
+      "Created an arithmetic_gmw::TruncationGate with following properties: {}", gate_info));
 }
 
 template <typename T>
-void GreaterThanGate<T>::EvaluateOnline() {
-  WaitSetup();
-  assert(setup_is_ready_);
+void TruncationGate<T>::EvaluateSetup() {}
 
-  parent_a_.at(0)->GetIsReadyCondition().Wait();
-  parent_b_.at(0)->GetIsReadyCondition().Wait();
+template <typename T>
+void TruncationGate<T>::EvaluateOnline() {
+  parent_.at(0)->GetIsReadyCondition().Wait();
 
-  auto bit_length = parent_a_.at(0)->GetBitLength();
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  const std::size_t f{number_of_fractional_bits_};
+  const std::size_t number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
+  const auto x_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_.at(0));
+  assert(x_w);
+  const auto pairs{GetTruncationPairProvider().template GetTruncationPairs<T>(
+      truncation_pair_offset_, number_of_simd, f)};
+
+  // shifting x by 2^(k - 2) makes it non-negative, such that c = x + 2^(k - 2) + r only wraps
+  // around 2^(k - 1) iff the MSB of c differs from the MSB of r
+  const bool is_designated{GetCommunicationLayer().GetMyId() ==
+                           (gate_id_ % GetCommunicationLayer().GetNumberOfParties())};
+  const T offset{static_cast<T>(T(1) << (kBitLength - 2))};
+  for (std::size_t i = 0; i < number_of_simd; ++i) {
+    openings_[i] = x_w->GetValues()[i] + pairs.r[i] + (is_designated ? offset : T(0));
+  }
+  OpenMaskedInputs(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                   communication::MessageType::kTruncationOpening, gate_id_, openings_,
+                   opening_futures_);
 
-  const auto a = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
-  const auto b = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
-  assert(a);
-  assert(b);
+  auto output = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(output);
+  auto& output_values{output->GetMutableValues()};
+  output_values.resize(number_of_simd);
+  const T low_mask{static_cast<T>((T(1) << (kBitLength - 1)) - 1)};
+  const T truncated_offset{static_cast<T>(T(1) << (kBitLength - 2 - f))};
+  const T msb_weight{static_cast<T>(T(1) << (kBitLength - 1 - f))};
+  for (std::size_t i = 0; i < number_of_simd; ++i) {
+    const T c{openings_[i]};
+    const T c_msb{static_cast<T>(c >> (kBitLength - 1))};
+    // share of the wrap-around bit c_msb XOR msb(r) = c_msb + msb(r) * (1 - 2 * c_msb)
+    const T wrap_around = pairs.msb_of_r[i] * static_cast<T>(1 - 2 * c_msb);
+    T result = msb_weight * wrap_around - pairs.truncated_r[i];
+    if (is_designated) {
+      result += msb_weight * c_msb + static_cast<T>((c & low_mask) >> f) - truncated_offset;
+    }
+    output_values[i] = result;
+  }
 
-  auto a_values = a->GetValues();
-  auto b_values = b->GetValues();
+  GetLogger().LogDebug(
+      fmt::format("Evaluated arithmetic_gmw::TruncationGate with id#{}", gate_id_));
+}
 
-  // some variables for the protocol
-  std::size_t number_of_messages, ot_index = 0;
-  BitVector<> r, c(number_of_simd_), messages;
-  std::vector<std::uint8_t> selection_index(number_of_simd_);
+template <typename T>
+arithmetic_gmw::SharePointer<T> TruncationGate<T>::GetOutputAsArithmeticShare() {
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(arithmetic_wire);
+  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  return result;
+}
 
-  // step 3
-  std::vector<T> delta(number_of_simd_);
-  std::vector<BitSpan> delta_bs(number_of_simd_);
-  for (auto i = 0u; i < number_of_simd_; i++) {
-    delta.at(i) = b_values.at(i) - a_values.at(i);
-    delta_bs.at(i) = BitSpan(reinterpret_cast<std::byte*>(&delta.at(i)), sizeof(delta.at(i)) * 8);
-  }
+// truncation pairs are composed from SBs, which are only available for up to 64 bit
+template class TruncationGate<std::uint8_t>;
+template class TruncationGate<std::uint16_t>;
+template class TruncationGate<std::uint32_t>;
+template class TruncationGate<std::uint64_t>;
+
+// Appends n OT messages, where message j is (j >= threshold) ^ flip
+static void AppendThresholdMessages(BitVector<>& messages, std::size_t n, std::size_t threshold,
+                                    bool flip) {
+  messages.Append(BitVector<>(threshold, flip));
+  messages.Append(BitVector<>(n - threshold, !flip));
+}
 
-  // step 4
-  std::size_t bit_length_last = 0;
+// Appends n OT messages, where message j is (enabled && j == position) ^ flip
+static void AppendIndicatorMessages(BitVector<>& messages, std::size_t n, std::size_t position,
+                                    bool enabled, bool flip) {
+  BitVector<> these_messages(n, flip);
+  if (enabled) these_messages.Set(!flip, position);
+  messages.Append(these_messages);
+}
 
-  // step 5
-  if (bit_length > chunk_bit_length_) {
-    number_of_messages = pow(2, chunk_bit_length_);
+template <typename T>
+ComparisonGate<T>::ComparisonGate(const arithmetic_gmw::WirePointer<T>& a,
+                                  const arithmetic_gmw::WirePointer<T>& b,
+                                  ComparisonType comparison_type, std::size_t chunk_bit_length)
+    : NInputGate(a->GetBackend()),
+      comparison_type_(comparison_type),
+      chunk_bit_length_(chunk_bit_length) {
+  parents_ = {std::static_pointer_cast<motion::Wire>(a), std::static_pointer_cast<motion::Wire>(b)};
+  assert(a->GetNumberOfSimdValues() == b->GetNumberOfSimdValues());
+  InitializationHelper();
+}
 
-    // step 8
-    if (my_id_ == 1) {
-      r = BitVector<>::SecureRandom(number_of_simd_);
-    }
+template <typename T>
+ComparisonGate<T>::ComparisonGate(const arithmetic_gmw::WirePointer<T>& a,
+                                  std::vector<T> constant_b, ComparisonType comparison_type,
+                                  std::size_t chunk_bit_length)
+    : NInputGate(a->GetBackend()),
+      comparison_type_(comparison_type),
+      chunk_bit_length_(chunk_bit_length),
+      constant_b_(std::move(constant_b)) {
+  parents_ = {std::static_pointer_cast<motion::Wire>(a)};
+  if (constant_b_.size() == 1) {
+    constant_b_.resize(a->GetNumberOfSimdValues(), constant_b_.front());
+  } else if (constant_b_.size() != a->GetNumberOfSimdValues()) {
+    throw std::invalid_argument(
+        fmt::format("ComparisonGate: got {} constants for {} SIMD values", constant_b_.size(),
+                    a->GetNumberOfSimdValues()));
+  }
+  InitializationHelper();
+}
+
+template <typename T>
+void ComparisonGate<T>::InitializationHelper() {
+  const auto& communication_layer = GetCommunicationLayer();
+  if (communication_layer.GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("ComparisonGate: comparisons of arithmetic GMW shares need 2 parties, got {}",
+                    communication_layer.GetNumberOfParties()));
+  }
+  // the selection index of the 1-out-of-N OT is one byte
+  if (chunk_bit_length_ < 2 || chunk_bit_length_ > 8) {
+    throw std::invalid_argument(fmt::format(
+        "ComparisonGate: chunks need to have 2 to 8 bits, got {}", chunk_bit_length_));
+  }
+  number_of_simd_ = parents_.at(0)->GetNumberOfSimdValues();
+  my_id_ = communication_layer.GetMyId();
 
-    for (auto i = 0u; i < number_of_simd_; i++) {
-      auto delta_subset = delta_bs.at(i).Subset(0, chunk_bit_length_);
-      auto delta_subset_value = static_cast<std::uint8_t>(delta_subset.GetMutableData()[0]);
+  output_wires_ = {
+      GetRegister().template EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_)};
 
+  // order comparisons compute the carry into the most significant bit of delta, equality compares
+  // all bits
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  const std::size_t number_of_bits{comparison_type_ == ComparisonType::kEqual ? kBitLength
+                                                                              : kBitLength - 1};
+  chunk_sizes_ = {std::min(chunk_bit_length_, number_of_bits)};
+  for (std::size_t done = chunk_sizes_.front(); done < number_of_bits;) {
+    // the following chunks have one selection bit less for the bit of the previous chunk
+    chunk_sizes_.emplace_back(std::min(chunk_bit_length_ - 1, number_of_bits - done));
+    done += chunk_sizes_.back();
+  }
+  GetRegister().RunInConstructionOrder(*this, [this] {
+    for (std::size_t i = 0; i < chunk_sizes_.size(); ++i) {
+      const std::size_t number_of_messages{(i == 0 ? 1u : 2u) *
+                                           (std::size_t(1) << chunk_sizes_[i])};
       if (my_id_ == 0) {
-        // step 6
-        selection_index.at(i) = delta_subset_value;
+        ot_1oon_receiver_.push_back(
+            GetKk13OtProvider(1).RegisterReceiveGOtBit(number_of_simd_, number_of_messages));
       } else {
-        // step 7 : check whether (j + delta_subset_value) > number_of_messages for j from 1 to
-        // number_of_messages
-        auto number_of_zeros = number_of_messages - delta_subset_value;
-        auto number_of_ones = delta_subset_value;
-
-        BitVector<> this_ot_messages = BitVector<>(number_of_zeros, false);
-        this_ot_messages.Append(BitVector<>(number_of_ones, true));
-
-        this_ot_messages ^= BitVector<>(number_of_messages, r.Get(i));
-        messages.Append(this_ot_messages);
+        ot_1oon_sender_.push_back(
+            GetKk13OtProvider(0).RegisterSendGOtBit(number_of_simd_, number_of_messages));
       }
     }
+  });
 
-    // step 9
-    if (my_id_ == 0) {
-      c = RunReceiver1ooNOt(selection_index, ot_index);
-    } else {
-      RunSender1ooNOt(messages, ot_index);
-    }
+  auto gate_info = fmt::format("uint{}_t type, gate id {}, a {} b, parents: {}{}", kBitLength,
+                               gate_id_, to_string(comparison_type_), parents_.at(0)->GetWireId(),
+                               parents_.size() == 2
+                                   ? fmt::format(", {}", parents_.at(1)->GetWireId())
+                                   : std::string(" and a constant"));
+  GetLogger().LogDebug(fmt::format(
+      "Created an arithmetic_gmw::ComparisonGate with following properties: {}", gate_info));
+}
 
-    // step 10
-    bit_length_last = chunk_bit_length_;
-  }
+template <typename T>
+void ComparisonGate<T>::RunSender1ooNOt(encrypto::motion::BitVector<> messages,
+                                        std::size_t ot_index) {
+  ot_1oon_sender_[ot_index]->WaitSetup();
 
-  // step 11
-  while (bit_length_last < bit_length - 1) {
-    ot_index++;
-    messages.Clear();
+  ot_1oon_sender_[ot_index]->SetInputs(messages);
+  ot_1oon_sender_[ot_index]->SendMessages();
+}
 
-    // step 12
-    auto bit_length_difference = std::min(chunk_bit_length_ - 1, bit_length - bit_length_last - 1);
-    number_of_messages = pow(2, bit_length_difference);
+template <typename T>
+BitVector<> ComparisonGate<T>::RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index,
+                                              std::size_t ot_index) {
+  ot_1oon_receiver_[ot_index]->WaitSetup();
 
-    // step 13
-    auto bit_length_next = bit_length_last + bit_length_difference;
+  ot_1oon_receiver_[ot_index]->SetChoices(selection_index);
+  ot_1oon_receiver_[ot_index]->SendCorrections();
 
-    // step 20 : save randomized r in another variable, because r is still needed in step 19
-    BitVector<> r_for_xor;
-    if (my_id_ == 1) {
-      r_for_xor = BitVector<>::SecureRandom(number_of_simd_);
-    }
+  ot_1oon_receiver_[ot_index]->ComputeOutputs();
+  return ot_1oon_receiver_[ot_index]->GetOutputs();
+}
 
-    for (auto i = 0u; i < number_of_simd_; i++) {
-      auto delta_subset = delta_bs.at(i).Subset(bit_length_last, bit_length_next);
-      auto delta_subset_value = static_cast<std::uint8_t>(delta_subset.GetMutableData()[0]);
+template <typename T>
+void ComparisonGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
 
-      if (my_id_ == 0) {
-        // step 14
-        selection_index.at(i) = delta_subset_value;
+  for (auto& wire : parents_) {
+    wire->GetIsReadyCondition().Wait();
+  }
 
-        // step 15
-        selection_index.at(i) += (c.Get(i) ? number_of_messages : 0);
-      } else {
-        // step 16-19 : check whether (j + delta_subset_value) > number_of_messages and/or (j +
-        // delta_subset_value + 1) > number_of_messages for j from 1 to number_of_messages and
-        // append to messages according to r
-        auto number_of_zeros = number_of_messages - delta_subset_value;
-        auto number_of_ones = delta_subset_value;
-
-        BitVector<> this_ot_messages;
-        if (!r.Get(i)) {
-          this_ot_messages = BitVector<>(number_of_zeros, false);
-          this_ot_messages.Append(BitVector<>(number_of_ones, true));
-          this_ot_messages.Append(BitVector<>(number_of_zeros - 1, false));
-          this_ot_messages.Append(BitVector<>(number_of_ones + 1, true));
-        } else {
-          this_ot_messages = BitVector<>(number_of_zeros - 1, false);
-          this_ot_messages.Append(BitVector<>(number_of_ones + 1, true));
-          this_ot_messages.Append(BitVector<>(number_of_zeros, false));
-          this_ot_messages.Append(BitVector<>(number_of_ones, true));
-        }
+  const auto a = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parents_.at(0));
+  assert(a);
+  const auto& a_values{a->GetValues()};
+  std::vector<T> b_values(number_of_simd_, 0);
+  if (parents_.size() == 2) {
+    const auto b = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parents_.at(1));
+    assert(b);
+    b_values = b->GetValues();
+  } else if (my_id_ == 0) {
+    b_values = constant_b_;
+  }
 
-        this_ot_messages ^= BitVector<>(2 * number_of_messages, r_for_xor.Get(i));
-        messages.Append(this_ot_messages);
-      }
-    }
+  // the shares of delta, where party 1 uses -delta for equality, such that delta == 0 iff both
+  // parties hold the same value
+  const bool is_equality{comparison_type_ == ComparisonType::kEqual};
+  const bool delta_is_b_minus_a{comparison_type_ == ComparisonType::kGreaterThan ||
+                                comparison_type_ == ComparisonType::kLessThanOrEqual};
+  std::vector<T> delta(number_of_simd_);
+  for (std::size_t i = 0; i < number_of_simd_; ++i) {
+    delta[i] = delta_is_b_minus_a ? T(b_values[i] - a_values[i]) : T(a_values[i] - b_values[i]);
+    if (is_equality && my_id_ == 1) delta[i] = T(0) - delta[i];
+  }
 
-    // step 21
+  // c are party 0's and r are party 1's shares of the carry or equality bit of the chunks so far
+  BitVector<> c, r;
+  std::vector<std::uint8_t> selection_index(number_of_simd_);
+  std::size_t bit_offset{0};
+  for (std::size_t ot_index = 0; ot_index < chunk_sizes_.size(); ++ot_index) {
+    const std::size_t number_of_messages{std::size_t(1) << chunk_sizes_[ot_index]};
+    const T mask{static_cast<T>(number_of_messages - 1)};
     if (my_id_ == 0) {
+      for (std::size_t i = 0; i < number_of_simd_; ++i) {
+        const std::size_t chunk{static_cast<std::size_t>((delta[i] >> bit_offset) & mask)};
+        selection_index[i] = static_cast<std::uint8_t>(
+            chunk + (ot_index > 0 && c.Get(i) ? number_of_messages : 0));
+      }
       c = RunReceiver1ooNOt(selection_index, ot_index);
     } else {
+      auto r_next{BitVector<>::SecureRandom(number_of_simd_)};
+      BitVector<> messages;
+      for (std::size_t i = 0; i < number_of_simd_; ++i) {
+        const std::size_t chunk{static_cast<std::size_t>((delta[i] >> bit_offset) & mask)};
+        const bool flip{r_next.Get(i)};
+        // the selection bit of party 0 for the previous bit is its share c of it
+        for (std::size_t c_i = 0; c_i < (ot_index == 0 ? 1u : 2u); ++c_i) {
+          const bool previous_bit{ot_index > 0 && ((c_i == 1) != r.Get(i))};
+          if (is_equality) {
+            AppendIndicatorMessages(messages, number_of_messages, chunk,
+                                    ot_index == 0 || previous_bit, flip);
+          } else {
+            // the carry of party 0's chunk j + chunk + previous carry
+            AppendThresholdMessages(messages, number_of_messages,
+                                    number_of_messages - chunk - (previous_bit ? 1 : 0), flip);
+          }
+        }
+      }
       RunSender1ooNOt(messages, ot_index);
+      r = std::move(r_next);
     }
-
-    // step 22
-    bit_length_last = bit_length_next;
-
-    r = r_for_xor;
+    bit_offset += chunk_sizes_[ot_index];
   }
 
-  // step 23
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  const bool invert{comparison_type_ == ComparisonType::kGreaterThanOrEqual ||
+                    comparison_type_ == ComparisonType::kLessThanOrEqual};
   BitVector<> output_vector(number_of_simd_);
-  for (auto i = 0u; i < number_of_simd_; i++) {
-    auto output = ((my_id_ == 0) ? c.Get(i) : r.Get(i)) != delta_bs.at(i).Get(bit_length - 1);
+  for (std::size_t i = 0; i < number_of_simd_; ++i) {
+    bool output{my_id_ == 0 ? c.Get(i) : r.Get(i)};
+    if (!is_equality) {
+      // the sign of delta is the carry XOR the most significant bits of both shares
+      output ^= ((delta[i] >> (kBitLength - 1)) & 1) == 1;
+      if (invert && my_id_ == 0) output = !output;
+    }
     output_vector.Set(output, i);
   }
 
-  // place the output in output_wires_
   auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(0));
   assert(output_wire);
-  output_wire->GetMutableValues() = output_vector;
+  output_wire->GetMutableValues() = std::move(output_vector);
 
   GetLogger().LogDebug(
-      fmt::format("Evaluated arithmetic_gmw::GreaterThanGate with id#{}", gate_id_));
+      fmt::format("Evaluated arithmetic_gmw::ComparisonGate with id#{}", gate_id_));
 }
 
 template <typename T>
-const boolean_gmw::SharePointer GreaterThanGate<T>::GetOutputAsGmwShare() {
+const boolean_gmw::SharePointer ComparisonGate<T>::GetOutputAsGmwShare() {
   auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
 
-template class GreaterThanGate<std::uint8_t>;
-template class GreaterThanGate<std::uint16_t>;
-template class GreaterThanGate<std::uint32_t>;
-template class GreaterThanGate<std::uint64_t>;
-template class GreaterThanGate<__uint128_t>;
+template class ComparisonGate<std::uint8_t>;
+template class ComparisonGate<std::uint16_t>;
+template class ComparisonGate<std::uint32_t>;
+template class ComparisonGate<std::uint64_t>;
+template class ComparisonGate<__uint128_t>;
 
 }  // namespace encrypto::motion::proto::arithmetic_gmw
@@ -28,12 +28,17 @@
 #include "arithmetic_gmw_wire.h"
 
 #include <memory>
+#include <optional>
 #include <span>
+#include <utility>
+#include <vector>
 
 #include "base/motion_base_provider.h"
+#include "communication/message_buffer.h"
 #include "multiplication_triple/mt_provider.h"
 #include "multiplication_triple/sp_provider.h"
 #include "oblivious_transfer/1_out_of_n/kk13_ot_flavors.h"
+#include "oblivious_transfer/ot_batch.h"
 #include "protocols/gate.h"
 #include "utility/reusable_future.h"
 
@@ -67,6 +72,9 @@ class InputGate final : public motion::InputGate {
  public:
   InputGate(std::span<const T> input, std::size_t input_owner, Backend& backend);
   InputGate(std::vector<T>&& input, std::size_t input_owner, Backend& backend);
+  // number_of_simd values whose owner passes them later via GetInputPromise(), e.g., after the
+  // setup phase
+  InputGate(std::size_t number_of_simd, std::size_t input_owner, Backend& backend);
 
   void InitializationHelper();
 
@@ -78,15 +86,62 @@ class InputGate final : public motion::InputGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsReEvaluable() const override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the case we need it
   // multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
   arithmetic_gmw::WirePointer<T> GetOutputArithmeticWire();
 
+  // throws std::logic_error if the gate has no deferred input of this party
+  ReusableFiberPromise<std::vector<T>>& GetInputPromise();
+
  private:
   std::size_t arithmetic_sharing_id_;
 
   std::vector<T> input_;
+
+  // only exists for deferred inputs of this party, which replace input_ in the online phase
+  std::optional<
+      std::pair<ReusableFiberPromise<std::vector<T>>, ReusableFiberFuture<std::vector<T>>>>
+      input_promise_future_;
+};
+
+// Shares a whole column of values, e.g., of 10^7 elements, as one gate, whose randomness is
+// expanded from the sharing seeds in a single AES-CTR stream instead of per value. The input owner
+// reads its values in place from a buffer, e.g., a memory-mapped file or the data buffer of an
+// Arrow array, and the other parties only provide the number of values, such that the column is
+// never copied into a std::vector before it is shared.
+template <typename T>
+class InputColumnGate final : public motion::InputGate {
+  using Base = motion::InputGate;
+
+ public:
+  // the input owner's column, which stays valid as long as input_storage is alive, e.g., the
+  // MappedFile it is mapped from
+  InputColumnGate(std::span<const T> input, std::shared_ptr<const void> input_storage,
+                  std::size_t input_owner, Backend& backend);
+  // the column of number_of_values values of another party
+  InputColumnGate(std::size_t number_of_values, std::size_t input_owner, Backend& backend);
+
+  ~InputColumnGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
+
+ private:
+  void InitializationHelper();
+
+  std::span<const T> input_;
+  std::shared_ptr<const void> input_storage_;
+  std::size_t number_of_values_;
+  // the id of the randomness stream of the column
+  std::size_t arithmetic_sharing_id_;
 };
 
 template <typename T>
@@ -105,6 +160,8 @@ class OutputGate final : public motion::OutputGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsReEvaluable() const override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the  case we need it
   // multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
@@ -113,11 +170,38 @@ class OutputGate final : public motion::OutputGate {
   // indicates whether this party obtains the output
   bool is_my_output_ = false;
 
-  std::vector<motion::ReusableFiberFuture<std::vector<std::uint8_t>>> output_message_futures_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> output_message_futures_;
 
   std::mutex m;
 };
 
+// Reveals several arithmetic GMW shares to all parties at once, e.g., the outputs of an
+// Unsimdify, with a single kOutputMessage per party instead of one OutputGate and message per
+// share.
+template <typename T>
+class RevealGate final : public motion::NInputGate {
+ public:
+  RevealGate(std::span<const motion::SharePointer> parents);
+
+  ~RevealGate() final = default;
+
+  void EvaluateSetup() final override {}
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsOutput() const override { return true; }
+
+  // the revealed values of the parents in the same order
+  std::vector<motion::SharePointer> GetOutputAsShares() const;
+
+  RevealGate() = delete;
+  RevealGate(const Gate&) = delete;
+
+ private:
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> output_message_futures_;
+};
+
 template <typename T>
 class AdditionGate final : public motion::TwoGate {
  public:
@@ -129,6 +213,8 @@ class AdditionGate final : public motion::TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the case we need it
   // multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
@@ -148,6 +234,8 @@ class SubtractionGate final : public motion::TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the case we need it
   // multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
@@ -164,9 +252,11 @@ class MultiplicationGate final : public motion::TwoGate {
   ~MultiplicationGate() final = default;
 
   void EvaluateSetup() final override;
-  void EvaluateOnline() final override;
+  void EvaluateOnline() final override { EvaluateOnlineCoroutine().Run(); }
+  GateTask EvaluateOnlineCoroutine() final override;
 
   bool NeedsSetup() const override { return false; }
+  bool OpensBeforeSuspending() const final override { return true; }
 
   // perhaps, we should return a copy of the pointer and not move it for the case we need it
   // multiple times
@@ -176,12 +266,68 @@ class MultiplicationGate final : public motion::TwoGate {
   MultiplicationGate(Gate&) = delete;
 
  private:
-  arithmetic_gmw::WirePointer<T> d_, e_;
-  std::shared_ptr<OutputGate<T>> d_output_, e_output_;
+  // the masked inputs [d || e], which are opened in a single kBeaverOpening message per party
+  std::vector<T> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
 
   std::size_t number_of_mts_, mt_offset_;
 };
 
+// Product of a rows x inner matrix a and an inner x columns matrix b, which are given row-major as
+// the SIMD values of the wires. Uses a matrix triple (see MtProvider::RequestMatrixMts), such that
+// only the masked matrices d = a + A and e = b + B are opened instead of one pair per scalar
+// product.
+template <typename T>
+class MatrixMultiplicationGate final : public motion::TwoGate {
+ public:
+  MatrixMultiplicationGate(const arithmetic_gmw::WirePointer<T>& a,
+                           const arithmetic_gmw::WirePointer<T>& b, std::size_t rows,
+                           std::size_t inner, std::size_t columns);
+  ~MatrixMultiplicationGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
+
+  MatrixMultiplicationGate() = delete;
+  MatrixMultiplicationGate(Gate&) = delete;
+
+ private:
+  // the masked inputs [d || e], which are opened in a single kBeaverOpening message per party
+  std::vector<T> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
+
+  std::size_t rows_, inner_, columns_, matrix_mt_id_;
+};
+
+// Sums of the rows of a rows x columns matrix, which is given row-major as the SIMD values of the
+// wire, i.e., the output SIMD value i is the sum of the input SIMD values i * columns, ...,
+// (i + 1) * columns - 1. The sums are computed locally on the shares.
+template <typename T>
+class RowSumGate final : public motion::OneGate {
+ public:
+  RowSumGate(const arithmetic_gmw::WirePointer<T>& a, std::size_t rows);
+  ~RowSumGate() final = default;
+
+  void EvaluateSetup() final override {}
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const override { return true; }
+
+  arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
+
+  RowSumGate() = delete;
+  RowSumGate(Gate&) = delete;
+
+ private:
+  std::size_t rows_, columns_;
+};
+
 // Multiplication of an arithmetic share with a boolean bit.
 // Based on [ST21]: https://iacr.org/2021/029.pdf
 template <typename T>
@@ -208,6 +354,43 @@ class HybridMultiplicationGate final : public motion::TwoGate {
  private:
   std::unique_ptr<BasicOtReceiver> ot_receiver_;
   std::unique_ptr<BasicOtSender> ot_sender_;
+
+  // if the gate is created while the OtBatcher is open, it shares the OTs of this batch instead
+  std::shared_ptr<AcOtBatch<T>> ot_batch_;
+  std::size_t ot_batch_offset_{0};
+};
+
+// Bit injection b * v_j of a Boolean GMW bit b into m >= 1 arithmetic GMW values v_1, ..., v_m,
+// e.g., the differences a - b of the multiplexers s ? a : b = b + s * (a - b). As in
+// HybridMultiplicationGate, each party sends the AC-OT correlations (-1)^<b> * <v_j> chosen by the
+// share of b of the other party, but all m values of a SIMD value share one AC-OT of vector size m
+// instead of one OT per value, such that the preprocessing needs 2 instead of 2m random OTs.
+template <typename T>
+class BitInjectionGate final : public motion::NInputGate {
+ public:
+  BitInjectionGate(const boolean_gmw::WirePointer& bit,
+                   std::span<const arithmetic_gmw::WirePointer<T>> values);
+
+  ~BitInjectionGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  // the products b * v_j in the order of the values
+  std::vector<arithmetic_gmw::SharePointer<T>> GetOutputAsArithmeticShares() const;
+
+  BitInjectionGate() = delete;
+
+  BitInjectionGate(Gate&) = delete;
+
+ private:
+  std::size_t number_of_values_, number_of_simd_;
+
+  std::unique_ptr<BasicOtReceiver> ot_receiver_;
+  std::unique_ptr<BasicOtSender> ot_sender_;
 };
 
 template <typename T>
@@ -229,23 +412,91 @@ class SquareGate final : public motion::OneGate {
   SquareGate(Gate&) = delete;
 
  private:
-  arithmetic_gmw::WirePointer<T> d_;
-  std::shared_ptr<OutputGate<T>> d_output_;
+  // the masked input d, which is opened in a single kBeaverOpening message per party
+  std::vector<T> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
 
   std::size_t number_of_sps_, sp_offset_;
 };
 
+// Product of k = 2, ..., kMaxMultiplicationFanIn wires in a single online round. The setup phase
+// computes shares of the products a_S of the random masks a_i of the inputs for all subsets S of
+// the inputs with Beaver triples in k - 1 rounds. The online phase opens d_i = x_i + a_i for all
+// inputs in one kBeaverOpening message and obtains the product of the x_i = d_i - a_i as the
+// linear combination sum_S (-1)^|S| * a_S * prod_{i not in S} d_i.
 template <typename T>
-class GreaterThanGate final : public motion::TwoGate {
+class MultiInputMultiplicationGate final : public motion::NInputGate {
  public:
-  GreaterThanGate(arithmetic_gmw::WirePointer<T>& a, arithmetic_gmw::WirePointer<T>& b,
-                  std::size_t l_s);
+  MultiInputMultiplicationGate(std::span<const arithmetic_gmw::WirePointer<T>> inputs);
+  ~MultiInputMultiplicationGate() final = default;
 
-  ~GreaterThanGate() override {}
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
 
-  void RunSender1ooNOt(encrypto::motion::BitVector<> messages, std::size_t ot_index);
+  arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
 
-  BitVector<> RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index, std::size_t ot_index);
+  MultiInputMultiplicationGate() = delete;
+  MultiInputMultiplicationGate(Gate&) = delete;
+
+ private:
+  std::size_t number_of_inputs_, number_of_simd_, mt_offset_, number_of_mts_;
+
+  // shares of the mask products a_S for all subsets S given as bit masks, |S| > 0, where the
+  // SIMD values of a_S start at mask_products_[S * number_of_simd_]
+  std::vector<T> mask_products_;
+  std::vector<std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>>>
+      setup_futures_;
+
+  // the masked inputs [d_1 || ... || d_k]
+  std::vector<T> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
+};
+
+// Probabilistic truncation of a two's complement value x with |x| < 2^(k - 2) by f < k - 2 bits
+// in a single round: opens c = x + 2^(k - 2) + r for a truncation pair r (see
+// TruncationPairProvider) and yields floor(x / 2^f) + u with u = 0 or u = 1. Supports up to 64 bit.
+template <typename T>
+class TruncationGate final : public motion::OneGate {
+ public:
+  TruncationGate(const arithmetic_gmw::WirePointer<T>& parent,
+                 std::size_t number_of_fractional_bits);
+  ~TruncationGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
+
+  TruncationGate() = delete;
+  TruncationGate(Gate&) = delete;
+
+ private:
+  std::size_t number_of_fractional_bits_, truncation_pair_offset_;
+
+  std::vector<T> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
+};
+
+// Two-party comparison a OP b of arithmetic GMW shares in constant rounds based on chunked
+// 1-out-of-N OTs (ESORICS'22): party 0 selects with its share of the difference delta, party 1
+// provides the OT messages for each chunk of chunk_bit_length bits, and the carry or equality bit
+// of the previous chunk is passed on as additional selection bit. The output is a Boolean GMW
+// share. Order comparisons compute the sign of delta = b - a (or a - b), such that the plaintexts
+// have to be smaller than 2^(k - 1), whereas equality tests delta = a - b == 0 for any input.
+// The constant variant compares against the public values of b, which are folded into the share
+// of party 0 instead of being shared.
+template <typename T>
+class ComparisonGate final : public motion::NInputGate {
+ public:
+  ComparisonGate(const arithmetic_gmw::WirePointer<T>& a, const arithmetic_gmw::WirePointer<T>& b,
+                 ComparisonType comparison_type, std::size_t chunk_bit_length = 7);
+
+  ComparisonGate(const arithmetic_gmw::WirePointer<T>& a, std::vector<T> constant_b,
+                 ComparisonType comparison_type, std::size_t chunk_bit_length = 7);
+
+  ~ComparisonGate() final = default;
 
   bool NeedsSetup() const override { return false; }
 
@@ -255,11 +506,22 @@ class GreaterThanGate final : public motion::TwoGate {
 
   const boolean_gmw::SharePointer GetOutputAsGmwShare();
 
-  GreaterThanGate() = delete;
-  GreaterThanGate(Gate&) = delete;
+  ComparisonGate() = delete;
+  ComparisonGate(Gate&) = delete;
 
  private:
-  std::size_t number_of_parties_, number_of_simd_, my_id_, chunk_bit_length_;
+  void InitializationHelper();
+
+  void RunSender1ooNOt(encrypto::motion::BitVector<> messages, std::size_t ot_index);
+
+  BitVector<> RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index, std::size_t ot_index);
+
+  ComparisonType comparison_type_;
+  std::size_t number_of_simd_, my_id_, chunk_bit_length_;
+  // the public values of b of the constant variant, one per SIMD value
+  std::vector<T> constant_b_;
+  // the numbers of bits of delta processed in each OT
+  std::vector<std::size_t> chunk_sizes_;
 
   std::vector<std::unique_ptr<GKk13OtBitReceiver>> ot_1oon_receiver_;
   std::vector<std::unique_ptr<GKk13OtBitSender>> ot_1oon_sender_;
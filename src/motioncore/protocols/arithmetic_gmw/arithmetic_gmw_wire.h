@@ -58,6 +58,12 @@ class Wire final : public motion::Wire {
 
   bool IsConstant() const noexcept final { return false; }
 
+  std::size_t ReleaseValues() final {
+    const auto number_of_bytes = values_.capacity() * sizeof(T);
+    std::vector<T>().swap(values_);
+    return number_of_bytes;
+  }
+
  private:
   std::vector<T> values_;
 };
@@ -22,6 +22,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <mutex>
 #include <type_traits>
 
@@ -34,6 +35,31 @@
 
 namespace encrypto::motion::proto::astra {
 
+// registers the batched messages of a multiplication or dot product gate of the given depth:
+// party 0 sends gamma_ab_2 to party 2 in the setup phase, and parties 1 and 2 exchange their
+// shares of the masked output in the online phase
+static void RegisterBatchedMessages(Backend& backend, communication::MessageType setup_type,
+                                    communication::MessageType online_type, std::size_t depth,
+                                    std::size_t number_of_bytes, Provider::Slot& setup_slot,
+                                    Provider::Slot& online_send_slot,
+                                    Provider::Slot& online_receive_slot) {
+  auto& provider{backend.GetAstraProvider()};
+  switch (backend.GetCommunicationLayer().GetMyId()) {
+    case 0:
+      setup_slot = provider.RegisterSend(2, setup_type, depth, number_of_bytes);
+      break;
+    case 1:
+      online_send_slot = provider.RegisterSend(2, online_type, depth, number_of_bytes);
+      online_receive_slot = provider.RegisterReceive(2, online_type, depth, number_of_bytes);
+      break;
+    case 2:
+      setup_slot = provider.RegisterReceive(0, setup_type, depth, number_of_bytes);
+      online_send_slot = provider.RegisterSend(1, online_type, depth, number_of_bytes);
+      online_receive_slot = provider.RegisterReceive(1, online_type, depth, number_of_bytes);
+      break;
+  }
+}
+
 template <typename T>
 InputGate<T>::InputGate(std::vector<T> input, std::size_t input_owner, Backend& backend)
     : Base(backend) {
@@ -64,6 +90,16 @@ InputGate<T>::InputGate(std::vector<T> input, std::size_t input_owner, Backend&
   }
 }
 
+template <typename T>
+InputGate<T>::InputGate(std::size_t number_of_simd, std::size_t input_owner, Backend& backend)
+    : InputGate(std::vector<T>(number_of_simd), input_owner, backend) {
+  if (input_owner == GetCommunicationLayer().GetMyId()) {
+    motion::ReusableFiberPromise<std::vector<T>> promise;
+    auto future{promise.get_future()};
+    input_promise_future_.emplace(std::move(promise), std::move(future));
+  }
+}
+
 template <typename T>
 void InputGate<T>::EvaluateSetup() {
   auto my_id = GetCommunicationLayer().GetMyId();
@@ -79,8 +115,8 @@ void InputGate<T>::EvaluateSetup() {
         case 0: {
           auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
           auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
-          std::vector<T> randoms1 = rng1.template GetUnsigned<T>(gate_id_, values.size());
-          std::vector<T> randoms2 = rng2.template GetUnsigned<T>(gate_id_, values.size());
+          std::vector<T> randoms1 = rng1.template GetUnsignedStream<T>(gate_id_, values.size());
+          std::vector<T> randoms2 = rng2.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms1.size() == values.size());
           assert(randoms2.size() == values.size());
 
@@ -93,7 +129,7 @@ void InputGate<T>::EvaluateSetup() {
         }
         case 1: {
           auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
-          std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, values.size());
+          std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms0.size() == values.size());
 
           for (auto i = 0u; i != values.size(); ++i) {
@@ -104,7 +140,7 @@ void InputGate<T>::EvaluateSetup() {
         }
         case 2: {
           auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
-          std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, values.size());
+          std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms0.size() == values.size());
 
           for (auto i = 0u; i != values.size(); ++i) {
@@ -120,9 +156,9 @@ void InputGate<T>::EvaluateSetup() {
         case 0: {
           auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
           auto& rng_global = GetBaseProvider().GetGlobalRandomnessGenerator();
-          std::vector<T> randoms1 = rng1.template GetUnsigned<T>(gate_id_, values.size());
+          std::vector<T> randoms1 = rng1.template GetUnsignedStream<T>(gate_id_, values.size());
           std::vector<T> randoms_global =
-              rng_global.template GetUnsigned<T>(gate_id_, values.size());
+              rng_global.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms1.size() == values.size());
           assert(randoms_global.size() == values.size());
 
@@ -136,9 +172,9 @@ void InputGate<T>::EvaluateSetup() {
         case 1: {
           auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
           auto& rng_global = GetBaseProvider().GetGlobalRandomnessGenerator();
-          std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, values.size());
+          std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, values.size());
           std::vector<T> randoms_global =
-              rng_global.template GetUnsigned<T>(gate_id_, values.size());
+              rng_global.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms0.size() == values.size());
           assert(randoms_global.size() == values.size());
 
@@ -152,7 +188,7 @@ void InputGate<T>::EvaluateSetup() {
         case 2: {
           auto& rng_global = GetBaseProvider().GetGlobalRandomnessGenerator();
           std::vector<T> randoms_global =
-              rng_global.template GetUnsigned<T>(gate_id_, values.size());
+              rng_global.template GetUnsignedStream<T>(gate_id_, values.size());
 
           for (auto i = 0u; i != values.size(); ++i) {
             auto& v = values[i];
@@ -168,8 +204,8 @@ void InputGate<T>::EvaluateSetup() {
           auto& rng_global = GetBaseProvider().GetGlobalRandomnessGenerator();
           auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
           std::vector<T> randoms_global =
-              rng_global.template GetUnsigned<T>(gate_id_, values.size());
-          std::vector<T> randoms2 = rng2.template GetUnsigned<T>(gate_id_, values.size());
+              rng_global.template GetUnsignedStream<T>(gate_id_, values.size());
+          std::vector<T> randoms2 = rng2.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms_global.size() == values.size());
           assert(randoms2.size() == values.size());
 
@@ -183,7 +219,7 @@ void InputGate<T>::EvaluateSetup() {
         case 1: {
           auto& rng_global = GetBaseProvider().GetGlobalRandomnessGenerator();
           std::vector<T> randoms_global =
-              rng_global.template GetUnsigned<T>(gate_id_, values.size());
+              rng_global.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms_global.size() == values.size());
 
           for (auto i = 0u; i != values.size(); ++i) {
@@ -196,8 +232,8 @@ void InputGate<T>::EvaluateSetup() {
           auto& rng_global = GetBaseProvider().GetGlobalRandomnessGenerator();
           auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
           std::vector<T> randoms_global =
-              rng_global.template GetUnsigned<T>(gate_id_, values.size());
-          std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, values.size());
+              rng_global.template GetUnsignedStream<T>(gate_id_, values.size());
+          std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, values.size());
           assert(randoms_global.size() == values.size());
           assert(randoms0.size() == values.size());
 
@@ -227,6 +263,11 @@ void InputGate<T>::EvaluateOnline() {
   auto my_id = communication_layer.GetMyId();
 
   if (static_cast<std::size_t>(input_owner_id_) == my_id) {
+    if (input_promise_future_.has_value()) {
+      const auto input{input_promise_future_->second.get()};
+      assert(input.size() == values.size());
+      for (auto i = 0u; i != values.size(); ++i) values[i].value = input[i];
+    }
     std::vector<T> buffer(values.size());
     for (auto i = 0u; i != values.size(); ++i) {
       auto& v = values[i];
@@ -268,6 +309,16 @@ astra::SharePointer<T> InputGate<T>::GetOutputAsAstraShare() {
   return std::make_shared<astra::Share<T>>(wire);
 }
 
+template <typename T>
+motion::ReusableFiberPromise<std::vector<T>>& InputGate<T>::GetInputPromise() {
+  if (!input_promise_future_.has_value()) {
+    throw std::logic_error(
+        fmt::format("astra::InputGate#{} has no deferred input of party#{}", gate_id_,
+                    GetCommunicationLayer().GetMyId()));
+  }
+  return input_promise_future_->first;
+}
+
 template class InputGate<std::uint8_t>;
 template class InputGate<std::uint16_t>;
 template class InputGate<std::uint32_t>;
@@ -440,6 +491,8 @@ AdditionGate<T>::AdditionGate(const astra::WirePointer<T>& a, const astra::WireP
 
   std::vector<typename astra::Wire<T>::value_type> v(parent_a_.at(0)->GetNumberOfSimdValues());
   auto w = GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v));
+  w->SetMultiplicativeDepth(
+      std::max(a->GetMultiplicativeDepth(), b->GetMultiplicativeDepth()));
   output_wires_ = {std::move(w)};
 
   if constexpr (kDebug) {
@@ -564,6 +617,8 @@ SubtractionGate<T>::SubtractionGate(const astra::WirePointer<T>& a, const astra:
 
   std::vector<typename astra::Wire<T>::value_type> v(parent_a_.at(0)->GetNumberOfSimdValues());
   auto w = GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v));
+  w->SetMultiplicativeDepth(
+      std::max(a->GetMultiplicativeDepth(), b->GetMultiplicativeDepth()));
   output_wires_ = {std::move(w)};
 
   if constexpr (kDebug) {
@@ -687,19 +742,14 @@ MultiplicationGate<T>::MultiplicationGate(const astra::WirePointer<T>& a,
 
   std::vector<typename astra::Wire<T>::value_type> v(parent_a_.at(0)->GetNumberOfSimdValues());
   auto w = GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v));
+  const std::size_t depth{std::max(a->GetMultiplicativeDepth(), b->GetMultiplicativeDepth()) + 1};
+  w->SetMultiplicativeDepth(depth);
   output_wires_ = {std::move(w)};
 
-  std::size_t my_id{GetCommunicationLayer().GetMyId()};
-  auto& message_manager{backend_.GetCommunicationLayer().GetMessageManager()};
-  if (my_id == 1) {
-    multiply_future_online_ = message_manager.RegisterReceive(
-        2, communication::MessageType::kAstraOnlineMultiplyGate, gate_id_);
-  } else if (my_id == 2) {
-    multiply_future_setup_ = message_manager.RegisterReceive(
-        0, communication::MessageType::kAstraSetupMultiplyGate, gate_id_);
-    multiply_future_online_ = message_manager.RegisterReceive(
-        1, communication::MessageType::kAstraOnlineMultiplyGate, gate_id_);
-  }
+  RegisterBatchedMessages(backend_, communication::MessageType::kAstraSetupMultiplyGate,
+                          communication::MessageType::kAstraOnlineMultiplyGate, depth,
+                          parent_a_.at(0)->GetNumberOfSimdValues() * sizeof(T), setup_slot_,
+                          online_send_slot_, online_receive_slot_);
 
   if constexpr (kDebug) {
     auto gate_info =
@@ -730,8 +780,8 @@ void MultiplicationGate<T>::EvaluateSetup() {
     case 0: {
       auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
       auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
-      std::vector<T> randoms1 = rng1.template GetUnsigned<T>(gate_id_, 2 * out_values.size());
-      std::vector<T> randoms2 = rng2.template GetUnsigned<T>(gate_id_, out_values.size());
+      std::vector<T> randoms1 = rng1.template GetUnsignedStream<T>(gate_id_, 2 * out_values.size());
+      std::vector<T> randoms2 = rng2.template GetUnsignedStream<T>(gate_id_, out_values.size());
       assert(randoms1.size() == 2 * out_values.size());
       assert(randoms2.size() == out_values.size());
 
@@ -760,15 +810,12 @@ void MultiplicationGate<T>::EvaluateSetup() {
       }
       assert(message_gamma_ab_2.size() == out_values.size());
 
-      auto payload = ToByteVector<T>(message_gamma_ab_2);
-      auto message{communication::BuildMessage(communication::MessageType::kAstraSetupMultiplyGate,
-                                               gate_id_, payload)};
-      communication_layer.SendMessage(2, message.Release());
+      GetAstraProvider().Send(setup_slot_, ToByteVector<T>(message_gamma_ab_2));
       break;
     }
     case 1: {
       auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
-      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, 2 * out_values.size());
+      std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, 2 * out_values.size());
       assert(randoms0.size() == 2 * out_values.size());
 
       for (auto i = 0u; i != out_values.size(); ++i) {
@@ -781,12 +828,11 @@ void MultiplicationGate<T>::EvaluateSetup() {
     }
     case 2: {
       auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
-      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, out_values.size());
+      std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, out_values.size());
       assert(randoms0.size() == out_values.size());
 
-      const auto message{multiply_future_setup_.get()};
-      const auto payload{communication::GetMessage(message.data())->payload()};
-      std::vector<T> message_gamma_ab_2 = FromByteVector<T>({payload->Data(), payload->size()});
+      std::vector<T> message_gamma_ab_2 =
+          FromByteVector<T>(GetAstraProvider().Receive(setup_slot_));
       assert(message_gamma_ab_2.size() == out_values.size());
 
       for (auto i = 0u; i != out_values.size(); ++i) {
@@ -841,15 +887,8 @@ void MultiplicationGate<T>::EvaluateOnline() {
         }
         assert(message_values.size() == out_values.size());
 
-        {
-          auto payload = ToByteVector<T>(message_values);
-          auto message{communication::BuildMessage(
-              communication::MessageType::kAstraOnlineMultiplyGate, gate_id_, payload)};
-          communication_layer.SendMessage(2, message.Release());
-        }
-        const auto multiply_message{multiply_future_online_.get()};
-        const auto payload{communication::GetMessage(multiply_message.data())->payload()};
-        message_values = FromByteVector<T>({payload->Data(), payload->size()});
+        GetAstraProvider().Send(online_send_slot_, ToByteVector<T>(message_values));
+        message_values = FromByteVector<T>(GetAstraProvider().Receive(online_receive_slot_));
         assert(message_values.size() == out_values.size());
 
         for (auto i = 0u; i != out_values.size(); ++i) {
@@ -875,16 +914,8 @@ void MultiplicationGate<T>::EvaluateOnline() {
         }
         assert(message_values.size() == out_values.size());
 
-        {
-          auto payload = ToByteVector<T>(message_values);
-          auto message{communication::BuildMessage(
-              communication::MessageType::kAstraOnlineMultiplyGate, gate_id_, payload)};
-          communication_layer.SendMessage(1, message.Release());
-        }
-
-        const auto message{multiply_future_online_.get()};
-        const auto payload{communication::GetMessage(message.data())->payload()};
-        message_values = FromByteVector<T>({payload->Data(), payload->size()});
+        GetAstraProvider().Send(online_send_slot_, ToByteVector<T>(message_values));
+        message_values = FromByteVector<T>(GetAstraProvider().Receive(online_receive_slot_));
         assert(message_values.size() == out_values.size());
 
         for (auto i = 0u; i != out_values.size(); ++i) {
@@ -924,19 +955,16 @@ DotProductGate<T>::DotProductGate(std::vector<motion::WirePointer> vector_a,
 
   std::vector<typename astra::Wire<T>::value_type> v(number_of_simd_values);
   auto w = GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v));
+  const std::size_t depth{
+      std::max(GetMaximumMultiplicativeDepth(parent_a_), GetMaximumMultiplicativeDepth(parent_b_)) +
+      1};
+  w->SetMultiplicativeDepth(depth);
   output_wires_ = {std::move(w)};
 
-  std::size_t my_id{GetCommunicationLayer().GetMyId()};
-  auto& message_manager{GetCommunicationLayer().GetMessageManager()};
-  if (my_id == 1) {
-    dot_product_future_online_ = message_manager.RegisterReceive(
-        2, communication::MessageType::kAstraOnlineDotProductGate, gate_id_);
-  } else if (my_id == 2) {
-    dot_product_future_setup_ = message_manager.RegisterReceive(
-        0, communication::MessageType::kAstraSetupDotProductGate, gate_id_);
-    dot_product_future_online_ = message_manager.RegisterReceive(
-        1, communication::MessageType::kAstraOnlineDotProductGate, gate_id_);
-  }
+  RegisterBatchedMessages(backend_, communication::MessageType::kAstraSetupDotProductGate,
+                          communication::MessageType::kAstraOnlineDotProductGate, depth,
+                          number_of_simd_values * sizeof(T), setup_slot_, online_send_slot_,
+                          online_receive_slot_);
 }
 
 template <typename T>
@@ -962,8 +990,8 @@ void DotProductGate<T>::EvaluateSetup() {
     case 0: {
       auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
       auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
-      std::vector<T> randoms1 = rng1.template GetUnsigned<T>(gate_id_, 2 * out_values.size());
-      std::vector<T> randoms2 = rng2.template GetUnsigned<T>(gate_id_, out_values.size());
+      std::vector<T> randoms1 = rng1.template GetUnsignedStream<T>(gate_id_, 2 * out_values.size());
+      std::vector<T> randoms2 = rng2.template GetUnsignedStream<T>(gate_id_, out_values.size());
       assert(randoms1.size() == 2 * out_values.size());
       assert(randoms2.size() == out_values.size());
 
@@ -997,15 +1025,12 @@ void DotProductGate<T>::EvaluateSetup() {
       }
       assert(message_gamma_ab_2.size() == out_values.size());
 
-      auto payload = ToByteVector<T>(message_gamma_ab_2);
-      auto message{communication::BuildMessage(
-          communication::MessageType::kAstraSetupDotProductGate, gate_id_, payload)};
-      communication_layer.SendMessage(2, std::move(message.Release()));
+      GetAstraProvider().Send(setup_slot_, ToByteVector<T>(message_gamma_ab_2));
       break;
     }
     case 1: {
       auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
-      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, 2 * out_values.size());
+      std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, 2 * out_values.size());
       assert(randoms0.size() == 2 * out_values.size());
 
       for (auto i = 0u; i != out_values.size(); ++i) {
@@ -1018,12 +1043,11 @@ void DotProductGate<T>::EvaluateSetup() {
     }
     case 2: {
       auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
-      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, out_values.size());
+      std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, out_values.size());
       assert(randoms0.size() == out_values.size());
 
-      const auto message{dot_product_future_setup_.get()};
-      const auto payload{communication::GetMessage(message.data())->payload()};
-      std::vector<T> message_gamma_ab_2 = FromByteVector<T>({payload->Data(), payload->size()});
+      std::vector<T> message_gamma_ab_2 =
+          FromByteVector<T>(GetAstraProvider().Receive(setup_slot_));
       assert(message_gamma_ab_2.size() == out_values.size());
       for (auto i = 0u; i != out_values.size(); ++i) {
         auto& out = out_values[i];
@@ -1090,29 +1114,8 @@ void DotProductGate<T>::EvaluateOnline() {
     }
     assert(message_values.size() == out_values.size());
 
-    {
-      auto payload = ToByteVector<T>(message_values);
-
-      auto message{communication::BuildMessage(
-          communication::MessageType::kAstraOnlineDotProductGate, gate_id_, payload)};
-      switch (my_id) {
-        case 1: {
-          communication_layer.SendMessage(2, message.Release());
-          break;
-        }
-        case 2: {
-          communication_layer.SendMessage(1, message.Release());
-          break;
-        }
-        default: {
-          assert(false);
-        }
-      }
-    }
-
-    const auto message{dot_product_future_online_.get()};
-    const auto payload{communication::GetMessage(message.data())->payload()};
-    message_values = FromByteVector<T>({payload->Data(), payload->size()});
+    GetAstraProvider().Send(online_send_slot_, ToByteVector<T>(message_values));
+    message_values = FromByteVector<T>(GetAstraProvider().Receive(online_receive_slot_));
     assert(message_values.size() == out_values.size());
 
     for (auto i = 0u; i != out_values.size(); ++i) {
@@ -1136,4 +1139,769 @@ template class DotProductGate<std::uint32_t>;
 template class DotProductGate<std::uint64_t>;
 template class DotProductGate<__uint128_t>;
 
+// copies one component, e.g., &Wire<T>::Data::value, of the values of an Astra wire into a
+// contiguous vector, which is negated if negate is set, for the matrix kernels
+template <typename T>
+static std::vector<T> GetComponent(const std::vector<typename astra::Wire<T>::Data>& values,
+                                   T astra::Wire<T>::Data::*component, bool negate = false) {
+  std::vector<T> result(values.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    result[i] = negate ? T(-(values[i].*component)) : values[i].*component;
+  }
+  return result;
+}
+
+template <typename T>
+MatrixMultiplicationGate<T>::MatrixMultiplicationGate(const astra::WirePointer<T>& a,
+                                                      const astra::WirePointer<T>& b,
+                                                      std::size_t rows, std::size_t inner,
+                                                      std::size_t columns)
+    : TwoGate(a->GetBackend()), rows_(rows), inner_(inner), columns_(columns) {
+  if (a->GetNumberOfSimdValues() != rows * inner || b->GetNumberOfSimdValues() != inner * columns) {
+    throw std::invalid_argument(fmt::format(
+        "Matrices with {} and {} elements do not have the shapes {}x{} and {}x{}",
+        a->GetNumberOfSimdValues(), b->GetNumberOfSimdValues(), rows, inner, inner, columns));
+  }
+  parent_a_ = {std::static_pointer_cast<motion::Wire>(a)};
+  parent_b_ = {std::static_pointer_cast<motion::Wire>(b)};
+
+  std::vector<typename astra::Wire<T>::value_type> v(rows * columns);
+  auto w = GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v));
+  const std::size_t depth{std::max(a->GetMultiplicativeDepth(), b->GetMultiplicativeDepth()) + 1};
+  w->SetMultiplicativeDepth(depth);
+  output_wires_ = {std::move(w)};
+
+  RegisterBatchedMessages(backend_, communication::MessageType::kAstraSetupDotProductGate,
+                          communication::MessageType::kAstraOnlineDotProductGate, depth,
+                          rows * columns * sizeof(T), setup_slot_, online_send_slot_,
+                          online_receive_slot_);
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("uint{}_t type, gate id {}, shape {}x{}x{}, parents: {}, {}",
+                                 sizeof(T) * 8, gate_id_, rows, inner, columns,
+                                 parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
+    GetLogger().LogDebug(fmt::format(
+        "Created an astra::MatrixMultiplicationGate with following properties: {}", gate_info));
+  }
+}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateSetup() {
+  auto my_id = GetCommunicationLayer().GetMyId();
+  auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+  assert(out_wire);
+  auto a_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_a_.at(0));
+  assert(a_wire);
+  auto b_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_b_.at(0));
+  assert(b_wire);
+
+  a_wire->GetSetupReadyCondition()->Wait();
+  b_wire->GetSetupReadyCondition()->Wait();
+
+  auto& out_values = out_wire->GetMutableValues();
+
+  switch (my_id) {
+    case 0: {
+      auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
+      auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
+      std::vector<T> randoms1 = rng1.template GetUnsignedStream<T>(gate_id_, 2 * out_values.size());
+      std::vector<T> randoms2 = rng2.template GetUnsignedStream<T>(gate_id_, out_values.size());
+      assert(randoms1.size() == 2 * out_values.size());
+      assert(randoms2.size() == out_values.size());
+
+      for (auto i = 0u; i != out_values.size(); ++i) {
+        auto& out = out_values[i];
+        out.lambda1 = randoms1[i];
+        out.lambda2 = randoms2[i];
+      }
+
+      // gamma_ab = lambda_a * lambda_b for the matrices lambda = lambda1 + lambda2
+      auto lambda_a = GetComponent<T>(a_wire->GetValues(), &Wire<T>::Data::lambda1);
+      AddToVector<T>(lambda_a, GetComponent<T>(a_wire->GetValues(), &Wire<T>::Data::lambda2));
+      auto lambda_b = GetComponent<T>(b_wire->GetValues(), &Wire<T>::Data::lambda1);
+      AddToVector<T>(lambda_b, GetComponent<T>(b_wire->GetValues(), &Wire<T>::Data::lambda2));
+      std::vector<T> message_gamma_ab_2(out_values.size(), 0);
+      AddMatrixProduct(lambda_a.data(), lambda_b.data(), message_gamma_ab_2.data(), rows_, inner_,
+                       columns_);
+      SubVectors<T>(message_gamma_ab_2, std::span(randoms1).subspan(out_values.size()),
+                    message_gamma_ab_2);
+
+      GetAstraProvider().Send(setup_slot_, ToByteVector<T>(message_gamma_ab_2));
+      break;
+    }
+    case 1: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, 2 * out_values.size());
+      assert(randoms0.size() == 2 * out_values.size());
+
+      for (auto i = 0u; i != out_values.size(); ++i) {
+        auto& out = out_values[i];
+        out.lambda1 = randoms0[i];
+        // We store gamma_ab_1 in the free out.lambda2 space
+        out.lambda2 = randoms0[i + out_values.size()];
+      }
+      break;
+    }
+    case 2: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      std::vector<T> randoms0 = rng0.template GetUnsignedStream<T>(gate_id_, out_values.size());
+      assert(randoms0.size() == out_values.size());
+
+      std::vector<T> message_gamma_ab_2 =
+          FromByteVector<T>(GetAstraProvider().Receive(setup_slot_));
+      assert(message_gamma_ab_2.size() == out_values.size());
+
+      for (auto i = 0u; i != out_values.size(); ++i) {
+        auto& out = out_values[i];
+        out.lambda2 = randoms0[i];
+        // We store gamma_ab_2 in the free out.lambda1 space
+        out.lambda1 = message_gamma_ab_2[i];
+      }
+      break;
+    }
+  }
+
+  out_wire->SetSetupIsReady();
+}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateOnline() {
+  auto my_id = GetCommunicationLayer().GetMyId();
+  WaitSetup();
+  assert(setup_is_ready_);
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
+
+  if (my_id != 0) {
+    auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+    assert(out_wire);
+    auto a_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_a_.at(0));
+    assert(a_wire);
+    auto b_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_b_.at(0));
+    assert(b_wire);
+
+    auto& out_values = out_wire->GetMutableValues();
+    const auto& a_values = a_wire->GetValues();
+    const auto& b_values = b_wire->GetValues();
+
+    // party 1 computes -(m_a * lambda1_b) - lambda1_a * m_b and party 2 computes
+    // m_a * (m_b - lambda2_b) - lambda2_a * m_b, each with two matrix products
+    const auto m_b = GetComponent<T>(b_values, &Wire<T>::Data::value);
+    std::vector<T> message_values(out_values.size(), 0);
+    if (my_id == 1) {
+      const auto m_a = GetComponent<T>(a_values, &Wire<T>::Data::value, true);
+      const auto lambda_a = GetComponent<T>(a_values, &Wire<T>::Data::lambda1, true);
+      const auto lambda_b = GetComponent<T>(b_values, &Wire<T>::Data::lambda1);
+      AddMatrixProduct(m_a.data(), lambda_b.data(), message_values.data(), rows_, inner_,
+                       columns_);
+      AddMatrixProduct(lambda_a.data(), m_b.data(), message_values.data(), rows_, inner_,
+                       columns_);
+    } else {
+      const auto m_a = GetComponent<T>(a_values, &Wire<T>::Data::value);
+      const auto lambda_a = GetComponent<T>(a_values, &Wire<T>::Data::lambda2, true);
+      auto m_b_minus_lambda_b = GetComponent<T>(b_values, &Wire<T>::Data::lambda2, true);
+      AddToVector<T>(m_b_minus_lambda_b, m_b);
+      AddMatrixProduct(m_a.data(), m_b_minus_lambda_b.data(), message_values.data(), rows_,
+                       inner_, columns_);
+      AddMatrixProduct(lambda_a.data(), m_b.data(), message_values.data(), rows_, inner_,
+                       columns_);
+    }
+    // add the share of lambda_out and gamma_ab, which are stored in lambda1 and lambda2
+    for (auto i = 0u; i != out_values.size(); ++i) {
+      auto& out = out_values[i];
+      out.value = message_values[i] + out.lambda1 + out.lambda2;
+      message_values[i] = out.value;
+    }
+
+    GetAstraProvider().Send(online_send_slot_, ToByteVector<T>(message_values));
+    message_values = FromByteVector<T>(GetAstraProvider().Receive(online_receive_slot_));
+    assert(message_values.size() == out_values.size());
+
+    for (auto i = 0u; i != out_values.size(); ++i) {
+      out_values[i].value += message_values[i];
+    }
+  }
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+        fmt::format("Evaluated astra::MatrixMultiplicationGate with id#{}", gate_id_));
+  }
+}
+
+template <typename T>
+astra::SharePointer<T> MatrixMultiplicationGate<T>::GetOutputAsAstraShare() {
+  auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+  assert(wire);
+  return std::make_shared<astra::Share<T>>(wire);
+}
+
+template class MatrixMultiplicationGate<std::uint8_t>;
+template class MatrixMultiplicationGate<std::uint16_t>;
+template class MatrixMultiplicationGate<std::uint32_t>;
+template class MatrixMultiplicationGate<std::uint64_t>;
+template class MatrixMultiplicationGate<__uint128_t>;
+
+// draws number_of_wires BitVectors of number_of_simd random bits each from the stream of gate_id,
+// i.e., the same bits as the party holding the other end of rng
+static std::vector<BitVector<>> GetRandomBits(primitives::SharingRandomnessGenerator& rng,
+                                              std::size_t gate_id, std::size_t number_of_wires,
+                                              std::size_t number_of_simd) {
+  const auto bytes{rng.GetUnsignedStream<std::uint8_t>(
+      gate_id, BitsToBytes(number_of_wires * number_of_simd))};
+  const BitVector<> bits(reinterpret_cast<const std::byte*>(bytes.data()),
+                         number_of_wires * number_of_simd);
+  std::vector<BitVector<>> result;
+  result.reserve(number_of_wires);
+  for (std::size_t i = 0; i != number_of_wires; ++i) {
+    result.emplace_back(bits.Subset(i * number_of_simd, (i + 1) * number_of_simd));
+  }
+  return result;
+}
+
+// splits the concatenated bits of number_of_wires wires with number_of_simd values each
+static std::vector<BitVector<>> SplitBits(std::span<const std::uint8_t> message,
+                                          std::size_t number_of_wires,
+                                          std::size_t number_of_simd) {
+  if (message.size() != BitsToBytes(number_of_wires * number_of_simd)) {
+    throw std::runtime_error(fmt::format("Astra Boolean message has {} B instead of {} B",
+                                         message.size(),
+                                         BitsToBytes(number_of_wires * number_of_simd)));
+  }
+  const BitVector<> bits(reinterpret_cast<const std::byte*>(message.data()),
+                         number_of_wires * number_of_simd);
+  std::vector<BitVector<>> result;
+  result.reserve(number_of_wires);
+  for (std::size_t i = 0; i != number_of_wires; ++i) {
+    result.emplace_back(bits.Subset(i * number_of_simd, (i + 1) * number_of_simd));
+  }
+  return result;
+}
+
+static std::span<const std::uint8_t> AsBytes(const BitVector<>& bits) {
+  const auto& data{bits.GetData()};
+  return {reinterpret_cast<const std::uint8_t*>(data.data()), data.size()};
+}
+
+static astra::BooleanWirePointer AsBooleanWire(const motion::WirePointer& wire) {
+  auto boolean_wire{std::dynamic_pointer_cast<astra::BooleanWire>(wire)};
+  assert(boolean_wire);
+  return boolean_wire;
+}
+
+static std::vector<motion::WirePointer> EmplaceBooleanWires(Backend& backend,
+                                                            std::size_t number_of_wires,
+                                                            std::size_t number_of_simd,
+                                                            std::size_t multiplicative_depth) {
+  std::vector<motion::WirePointer> wires;
+  wires.reserve(number_of_wires);
+  for (std::size_t i = 0; i != number_of_wires; ++i) {
+    auto wire{backend.GetRegister()->EmplaceWire<astra::BooleanWire>(backend, number_of_simd)};
+    wire->SetMultiplicativeDepth(multiplicative_depth);
+    wires.emplace_back(std::move(wire));
+  }
+  return wires;
+}
+
+static void CheckBooleanAstraShare(const motion::SharePointer& share, std::string_view gate) {
+  assert(share);
+  if (share->GetProtocol() != MpcProtocol::kAstra ||
+      share->GetCircuitType() != CircuitType::kBoolean) {
+    throw std::invalid_argument(fmt::format("{} expects a Boolean astra share, got a {} share",
+                                            gate, to_string(share->GetProtocol())));
+  }
+}
+
+BooleanInputGate::BooleanInputGate(std::span<const BitVector<>> input, std::size_t input_owner,
+                                   Backend& backend)
+    : Base(backend) {
+  input_owner_id_ = input_owner;
+  if (input.empty()) {
+    throw std::invalid_argument("astra::BooleanInputGate expects at least one input wire");
+  }
+  const std::size_t number_of_simd{input[0].GetSize()};
+  if (!std::all_of(input.begin(), input.end(), [number_of_simd](const auto& bits) {
+        return bits.GetSize() == number_of_simd;
+      })) {
+    throw std::invalid_argument(
+        "astra::BooleanInputGate expects the same number of SIMD values on all wires");
+  }
+
+  auto my_id = static_cast<std::int64_t>(GetCommunicationLayer().GetMyId());
+  output_wires_ = EmplaceBooleanWires(backend_, input.size(), number_of_simd, 0);
+  if (my_id == input_owner_id_) {
+    for (std::size_t i = 0; i != input.size(); ++i) {
+      AsBooleanWire(output_wires_[i])->GetMutableValues() = input[i];
+    }
+  }
+
+  if (my_id != input_owner_id_ && my_id != 0) {
+    input_future_ = GetCommunicationLayer().GetMessageManager().RegisterReceive(
+        input_owner_id_, communication::MessageType::kAstraInputGate, gate_id_);
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format(
+        "Allocate an astra::BooleanInputGate with following properties: {} wires, gate id {}, "
+        "owner {}",
+        output_wires_.size(), gate_id_, input_owner_id_));
+  }
+}
+
+BooleanInputGate::BooleanInputGate(std::size_t number_of_wires, std::size_t number_of_simd,
+                                   std::size_t input_owner, Backend& backend)
+    : BooleanInputGate(std::vector<BitVector<>>(number_of_wires, BitVector<>(number_of_simd)),
+                       input_owner, backend) {
+  if (input_owner == GetCommunicationLayer().GetMyId()) {
+    motion::ReusableFiberPromise<std::vector<BitVector<>>> promise;
+    auto future{promise.get_future()};
+    input_promise_future_.emplace(std::move(promise), std::move(future));
+  }
+}
+
+void BooleanInputGate::EvaluateSetup() {
+  auto my_id = static_cast<std::int64_t>(GetCommunicationLayer().GetMyId());
+  auto& base_provider{GetBaseProvider()};
+  base_provider.WaitSetup();
+
+  const std::size_t number_of_wires{output_wires_.size()};
+  const std::size_t number_of_simd{output_wires_[0]->GetNumberOfSimdValues()};
+  // lambda_i is known to party 0, party i and the input owner, i.e., it is drawn from the global
+  // generator if the input owner is party 3 - i and from the generator of parties 0 and i otherwise
+  auto mask_generator = [&](std::int64_t i) -> primitives::SharingRandomnessGenerator& {
+    if (input_owner_id_ == 3 - i) return base_provider.GetGlobalRandomnessGenerator();
+    return my_id == 0 ? base_provider.GetMyRandomnessGenerator(i)
+                      : base_provider.GetTheirRandomnessGenerator(0);
+  };
+
+  if (my_id != 2 || input_owner_id_ == 2) {
+    auto lambda1s{GetRandomBits(mask_generator(1), gate_id_, number_of_wires, number_of_simd)};
+    for (std::size_t i = 0; i != number_of_wires; ++i) {
+      AsBooleanWire(output_wires_[i])->GetMutableLambda1() = std::move(lambda1s[i]);
+    }
+  }
+  if (my_id != 1 || input_owner_id_ == 1) {
+    auto lambda2s{GetRandomBits(mask_generator(2), gate_id_, number_of_wires, number_of_simd)};
+    for (std::size_t i = 0; i != number_of_wires; ++i) {
+      AsBooleanWire(output_wires_[i])->GetMutableLambda2() = std::move(lambda2s[i]);
+    }
+  }
+  for (auto& wire : output_wires_) AsBooleanWire(wire)->SetSetupIsReady();
+}
+
+void BooleanInputGate::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+
+  auto& communication_layer = GetCommunicationLayer();
+  auto my_id = static_cast<std::int64_t>(communication_layer.GetMyId());
+
+  if (input_owner_id_ == my_id) {
+    if (input_promise_future_.has_value()) {
+      auto input{input_promise_future_->second.get()};
+      assert(input.size() == output_wires_.size());
+      for (std::size_t i = 0; i != input.size(); ++i) {
+        assert(input[i].GetSize() == output_wires_[i]->GetNumberOfSimdValues());
+        AsBooleanWire(output_wires_[i])->GetMutableValues() = std::move(input[i]);
+      }
+    }
+    BitVector<> message;
+    for (auto& wire : output_wires_) {
+      auto boolean_wire{AsBooleanWire(wire)};
+      auto masked_values{boolean_wire->GetValues() ^ boolean_wire->GetLambda1() ^
+                         boolean_wire->GetLambda2()};
+      message.Append(masked_values);
+      // party 0 does not hold the masked values
+      boolean_wire->GetMutableValues() =
+          my_id == 0 ? BitVector<>(masked_values.GetSize()) : std::move(masked_values);
+    }
+
+    auto payload{AsBytes(message)};
+    auto message_buffer{communication::BuildMessage(communication::MessageType::kAstraInputGate,
+                                                    gate_id_, payload)};
+    if (my_id == 0) {
+      communication_layer.BroadcastMessage(message_buffer.Release());
+    } else if (my_id == 1) {
+      communication_layer.SendMessage(2, message_buffer.Release());
+    } else if (my_id == 2) {
+      communication_layer.SendMessage(1, message_buffer.Release());
+    }
+  } else if (my_id != 0) {
+    const auto input_message{input_future_.get()};
+    const auto payload{communication::GetMessage(input_message.data())->payload()};
+    auto values{SplitBits({payload->data(), payload->size()}, output_wires_.size(),
+                          output_wires_[0]->GetNumberOfSimdValues())};
+    for (std::size_t i = 0; i != output_wires_.size(); ++i) {
+      AsBooleanWire(output_wires_[i])->GetMutableValues() = std::move(values[i]);
+    }
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Evaluated astra::BooleanInputGate with id#{}", gate_id_));
+  }
+}
+
+astra::BooleanSharePointer BooleanInputGate::GetOutputAsAstraShare() {
+  return std::make_shared<astra::BooleanShare>(output_wires_);
+}
+
+motion::ReusableFiberPromise<std::vector<BitVector<>>>& BooleanInputGate::GetInputPromise() {
+  if (!input_promise_future_.has_value()) {
+    throw std::logic_error(
+        fmt::format("astra::BooleanInputGate#{} has no deferred input of party#{}", gate_id_,
+                    GetCommunicationLayer().GetMyId()));
+  }
+  return input_promise_future_->first;
+}
+
+BooleanOutputGate::BooleanOutputGate(const motion::SharePointer& parent, std::size_t output_owner)
+    : Base(parent->GetBackend()) {
+  CheckBooleanAstraShare(parent, "astra::BooleanOutputGate");
+  auto my_id{static_cast<std::int64_t>(GetCommunicationLayer().GetMyId())};
+
+  parent_ = parent->GetWires();
+  output_owner_ = output_owner;
+  output_wires_ =
+      EmplaceBooleanWires(backend_, parent_.size(), parent->GetNumberOfSimdValues(), 0);
+
+  if (output_owner_ == my_id || output_owner_ == kAll) {
+    output_future_ = GetCommunicationLayer().GetMessageManager().RegisterReceive(
+        (my_id + 1) % 3, communication::MessageType::kAstraOutputGate, gate_id_);
+  }
+}
+
+void BooleanOutputGate::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+  for (auto& wire : parent_) wire->GetIsReadyCondition().Wait();
+
+  auto& communication_layer = GetCommunicationLayer();
+  auto my_id = static_cast<std::int64_t>(communication_layer.GetMyId());
+
+  // party 0 sends lambda1 to party 2, party 1 sends the masked values to party 0 and party 2 sends
+  // lambda2 to party 1, such that each party receives the part of the sharing it does not know
+  const std::int64_t receiver{(my_id + 2) % 3};
+  if (output_owner_ == receiver || output_owner_ == kAll) {
+    BitVector<> message;
+    for (auto& wire : parent_) {
+      auto in_wire{AsBooleanWire(wire)};
+      message.Append(my_id == 0   ? in_wire->GetLambda1()
+                     : my_id == 1 ? in_wire->GetValues()
+                                  : in_wire->GetLambda2());
+    }
+    auto message_buffer{communication::BuildMessage(communication::MessageType::kAstraOutputGate,
+                                                    gate_id_, AsBytes(message))};
+    communication_layer.SendMessage(receiver, message_buffer.Release());
+  }
+
+  if (output_owner_ == my_id || output_owner_ == kAll) {
+    const auto output_message{output_future_.get()};
+    const auto payload{communication::GetMessage(output_message.data())->payload()};
+    auto received{SplitBits({payload->data(), payload->size()}, parent_.size(),
+                            parent_[0]->GetNumberOfSimdValues())};
+    for (std::size_t i = 0; i != parent_.size(); ++i) {
+      auto in_wire{AsBooleanWire(parent_[i])};
+      auto& out = AsBooleanWire(output_wires_[i])->GetMutableValues();
+      switch (my_id) {
+        case 0:
+          out = received[i] ^ in_wire->GetLambda1() ^ in_wire->GetLambda2();
+          break;
+        case 1:
+          out = in_wire->GetValues() ^ in_wire->GetLambda1() ^ received[i];
+          break;
+        case 2:
+          out = in_wire->GetValues() ^ received[i] ^ in_wire->GetLambda2();
+          break;
+      }
+    }
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Evaluated astra::BooleanOutputGate with id#{}", gate_id_));
+  }
+}
+
+astra::BooleanSharePointer BooleanOutputGate::GetOutputAsAstraShare() {
+  return std::make_shared<astra::BooleanShare>(output_wires_);
+}
+
+XorGate::XorGate(const motion::SharePointer& a, const motion::SharePointer& b)
+    : TwoGate(a->GetBackend()) {
+  CheckBooleanAstraShare(a, "astra::XorGate");
+  CheckBooleanAstraShare(b, "astra::XorGate");
+  parent_a_ = a->GetWires();
+  parent_b_ = b->GetWires();
+  assert(parent_a_.size() == parent_b_.size());
+  assert(a->GetNumberOfSimdValues() == b->GetNumberOfSimdValues());
+
+  output_wires_ = EmplaceBooleanWires(backend_, parent_a_.size(), a->GetNumberOfSimdValues(), 0);
+  for (std::size_t i = 0; i != output_wires_.size(); ++i) {
+    AsBooleanWire(output_wires_[i])
+        ->SetMultiplicativeDepth(std::max(AsBooleanWire(parent_a_[i])->GetMultiplicativeDepth(),
+                                          AsBooleanWire(parent_b_[i])->GetMultiplicativeDepth()));
+  }
+}
+
+void XorGate::EvaluateSetup() {
+  for (std::size_t i = 0; i != output_wires_.size(); ++i) {
+    auto a_wire{AsBooleanWire(parent_a_[i])};
+    auto b_wire{AsBooleanWire(parent_b_[i])};
+    auto out_wire{AsBooleanWire(output_wires_[i])};
+    a_wire->GetSetupReadyCondition()->Wait();
+    b_wire->GetSetupReadyCondition()->Wait();
+    out_wire->GetMutableLambda1() = a_wire->GetLambda1() ^ b_wire->GetLambda1();
+    out_wire->GetMutableLambda2() = a_wire->GetLambda2() ^ b_wire->GetLambda2();
+    out_wire->SetSetupIsReady();
+  }
+}
+
+void XorGate::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+  for (std::size_t i = 0; i != output_wires_.size(); ++i) {
+    parent_a_[i]->GetIsReadyCondition().Wait();
+    parent_b_[i]->GetIsReadyCondition().Wait();
+    AsBooleanWire(output_wires_[i])->GetMutableValues() =
+        AsBooleanWire(parent_a_[i])->GetValues() ^ AsBooleanWire(parent_b_[i])->GetValues();
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Evaluated astra::XorGate with id#{}", gate_id_));
+  }
+}
+
+astra::BooleanSharePointer XorGate::GetOutputAsAstraShare() {
+  return std::make_shared<astra::BooleanShare>(output_wires_);
+}
+
+InvGate::InvGate(const motion::SharePointer& parent) : OneGate(parent->GetBackend()) {
+  CheckBooleanAstraShare(parent, "astra::InvGate");
+  parent_ = parent->GetWires();
+
+  output_wires_ = EmplaceBooleanWires(backend_, parent_.size(), parent->GetNumberOfSimdValues(), 0);
+  for (std::size_t i = 0; i != output_wires_.size(); ++i) {
+    AsBooleanWire(output_wires_[i])
+        ->SetMultiplicativeDepth(AsBooleanWire(parent_[i])->GetMultiplicativeDepth());
+  }
+}
+
+void InvGate::EvaluateSetup() {
+  for (std::size_t i = 0; i != output_wires_.size(); ++i) {
+    auto in_wire{AsBooleanWire(parent_[i])};
+    auto out_wire{AsBooleanWire(output_wires_[i])};
+    in_wire->GetSetupReadyCondition()->Wait();
+    out_wire->GetMutableLambda1() = in_wire->GetLambda1();
+    out_wire->GetMutableLambda2() = in_wire->GetLambda2();
+    out_wire->SetSetupIsReady();
+  }
+}
+
+void InvGate::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+  const bool holds_values{GetCommunicationLayer().GetMyId() != 0};
+  for (std::size_t i = 0; i != output_wires_.size(); ++i) {
+    parent_[i]->GetIsReadyCondition().Wait();
+    const auto& in_values{AsBooleanWire(parent_[i])->GetValues()};
+    AsBooleanWire(output_wires_[i])->GetMutableValues() = holds_values ? ~in_values : in_values;
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Evaluated astra::InvGate with id#{}", gate_id_));
+  }
+}
+
+astra::BooleanSharePointer InvGate::GetOutputAsAstraShare() {
+  return std::make_shared<astra::BooleanShare>(output_wires_);
+}
+
+AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
+    : TwoGate(a->GetBackend()) {
+  CheckBooleanAstraShare(a, "astra::AndGate");
+  CheckBooleanAstraShare(b, "astra::AndGate");
+  parent_a_ = a->GetWires();
+  parent_b_ = b->GetWires();
+  assert(parent_a_.size() == parent_b_.size());
+  assert(a->GetNumberOfSimdValues() == b->GetNumberOfSimdValues());
+
+  std::size_t depth{0};
+  for (std::size_t i = 0; i != parent_a_.size(); ++i) {
+    depth = std::max({depth, AsBooleanWire(parent_a_[i])->GetMultiplicativeDepth(),
+                      AsBooleanWire(parent_b_[i])->GetMultiplicativeDepth()});
+  }
+  ++depth;
+  const std::size_t number_of_simd{a->GetNumberOfSimdValues()};
+  output_wires_ = EmplaceBooleanWires(backend_, parent_a_.size(), number_of_simd, depth);
+
+  RegisterBatchedMessages(backend_, communication::MessageType::kAstraSetupAndGate,
+                          communication::MessageType::kAstraOnlineAndGate, depth,
+                          BitsToBytes(parent_a_.size() * number_of_simd), setup_slot_,
+                          online_send_slot_, online_receive_slot_);
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format(
+        "Created an astra::AndGate with following properties: {} wires, gate id {}, depth {}",
+        parent_a_.size(), gate_id_, depth));
+  }
+}
+
+void AndGate::EvaluateSetup() {
+  auto my_id = GetCommunicationLayer().GetMyId();
+  const std::size_t number_of_wires{output_wires_.size()};
+  const std::size_t number_of_simd{output_wires_[0]->GetNumberOfSimdValues()};
+  for (std::size_t i = 0; i != number_of_wires; ++i) {
+    AsBooleanWire(parent_a_[i])->GetSetupReadyCondition()->Wait();
+    AsBooleanWire(parent_b_[i])->GetSetupReadyCondition()->Wait();
+  }
+
+  switch (my_id) {
+    case 0: {
+      auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
+      auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
+      // lambda_z_1 of all wires followed by gamma_ab_1 of all wires
+      auto randoms1{GetRandomBits(rng1, gate_id_, 2 * number_of_wires, number_of_simd)};
+      auto randoms2{GetRandomBits(rng2, gate_id_, number_of_wires, number_of_simd)};
+
+      BitVector<> message_gamma_ab_2;
+      for (std::size_t i = 0; i != number_of_wires; ++i) {
+        auto a_wire{AsBooleanWire(parent_a_[i])};
+        auto b_wire{AsBooleanWire(parent_b_[i])};
+        auto out_wire{AsBooleanWire(output_wires_[i])};
+        out_wire->GetMutableLambda1() = std::move(randoms1[i]);
+        out_wire->GetMutableLambda2() = std::move(randoms2[i]);
+
+        auto gamma_ab{(a_wire->GetLambda1() ^ a_wire->GetLambda2()) &
+                      (b_wire->GetLambda1() ^ b_wire->GetLambda2())};
+        message_gamma_ab_2.Append(gamma_ab ^ randoms1[number_of_wires + i]);
+      }
+      GetAstraProvider().Send(setup_slot_, AsBytes(message_gamma_ab_2));
+      break;
+    }
+    case 1: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      auto randoms0{GetRandomBits(rng0, gate_id_, 2 * number_of_wires, number_of_simd)};
+      gamma_.assign(std::make_move_iterator(randoms0.begin() + number_of_wires),
+                    std::make_move_iterator(randoms0.end()));
+      for (std::size_t i = 0; i != number_of_wires; ++i) {
+        AsBooleanWire(output_wires_[i])->GetMutableLambda1() = std::move(randoms0[i]);
+      }
+      break;
+    }
+    case 2: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      auto randoms0{GetRandomBits(rng0, gate_id_, number_of_wires, number_of_simd)};
+      gamma_ = SplitBits(GetAstraProvider().Receive(setup_slot_), number_of_wires, number_of_simd);
+      for (std::size_t i = 0; i != number_of_wires; ++i) {
+        AsBooleanWire(output_wires_[i])->GetMutableLambda2() = std::move(randoms0[i]);
+      }
+      break;
+    }
+  }
+
+  for (auto& wire : output_wires_) AsBooleanWire(wire)->SetSetupIsReady();
+}
+
+void AndGate::EvaluateOnline() {
+  auto my_id = GetCommunicationLayer().GetMyId();
+  WaitSetup();
+  assert(setup_is_ready_);
+  const std::size_t number_of_wires{output_wires_.size()};
+  for (std::size_t i = 0; i != number_of_wires; ++i) {
+    parent_a_[i]->GetIsReadyCondition().Wait();
+    parent_b_[i]->GetIsReadyCondition().Wait();
+  }
+
+  if (my_id != 0) {
+    BitVector<> message_values;
+    for (std::size_t i = 0; i != number_of_wires; ++i) {
+      auto a_wire{AsBooleanWire(parent_a_[i])};
+      auto b_wire{AsBooleanWire(parent_b_[i])};
+      auto out_wire{AsBooleanWire(output_wires_[i])};
+      const auto& a_values{a_wire->GetValues()};
+      const auto& b_values{b_wire->GetValues()};
+      auto& out_values{out_wire->GetMutableValues()};
+      if (my_id == 1) {
+        out_values = (a_values & b_wire->GetLambda1()) ^ (b_values & a_wire->GetLambda1()) ^
+                     out_wire->GetLambda1() ^ gamma_[i];
+      } else {
+        out_values = (a_values & b_values) ^ (a_values & b_wire->GetLambda2()) ^
+                     (b_values & a_wire->GetLambda2()) ^ out_wire->GetLambda2() ^ gamma_[i];
+      }
+      message_values.Append(out_values);
+    }
+
+    GetAstraProvider().Send(online_send_slot_, AsBytes(message_values));
+    auto received{SplitBits(GetAstraProvider().Receive(online_receive_slot_), number_of_wires,
+                            output_wires_[0]->GetNumberOfSimdValues())};
+    for (std::size_t i = 0; i != number_of_wires; ++i) {
+      AsBooleanWire(output_wires_[i])->GetMutableValues() ^= received[i];
+    }
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Evaluated astra::AndGate with id#{}", gate_id_));
+  }
+}
+
+astra::BooleanSharePointer AndGate::GetOutputAsAstraShare() {
+  return std::make_shared<astra::BooleanShare>(output_wires_);
+}
+
+template <typename T>
+BooleanOperandsGate<T>::BooleanOperandsGate(const astra::WirePointer<T>& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = {parent};
+  output_wires_ = EmplaceBooleanWires(backend_, 3 * sizeof(T) * 8, parent->GetNumberOfSimdValues(),
+                                      parent->GetMultiplicativeDepth());
+}
+
+template <typename T>
+void BooleanOperandsGate<T>::EvaluateSetup() {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  auto my_id = GetCommunicationLayer().GetMyId();
+  auto in_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_.at(0));
+  assert(in_wire);
+  in_wire->GetSetupReadyCondition()->Wait();
+
+  // party 1 only knows lambda1 and party 2 only knows lambda2, the other masks of the arithmetic
+  // wire may hold the shares of gamma_ab of a multiplication gate
+  const auto& in_values{in_wire->GetValues()};
+  for (std::size_t j = 0; j != kBitLength; ++j) {
+    auto& lambda1s{AsBooleanWire(output_wires_[kBitLength + j])->GetMutableLambda1()};
+    auto& lambda2s{AsBooleanWire(output_wires_[2 * kBitLength + j])->GetMutableLambda2()};
+    for (std::size_t i = 0; i != in_values.size(); ++i) {
+      if (my_id != 2) lambda1s.Set(((in_values[i].lambda1 >> j) & 1) == 1, i);
+      if (my_id != 1) lambda2s.Set(((in_values[i].lambda2 >> j) & 1) == 1, i);
+    }
+  }
+  for (auto& wire : output_wires_) AsBooleanWire(wire)->SetSetupIsReady();
+}
+
+template <typename T>
+void BooleanOperandsGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+  parent_.at(0)->GetIsReadyCondition().Wait();
+  if (GetCommunicationLayer().GetMyId() == 0) return;
+
+  auto in_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_.at(0));
+  assert(in_wire);
+  const auto& in_values{in_wire->GetValues()};
+  for (std::size_t j = 0; j != sizeof(T) * 8; ++j) {
+    auto& values{AsBooleanWire(output_wires_[j])->GetMutableValues()};
+    for (std::size_t i = 0; i != in_values.size(); ++i) {
+      values.Set(((in_values[i].value >> j) & 1) == 1, i);
+    }
+  }
+}
+
+template <typename T>
+astra::BooleanSharePointer BooleanOperandsGate<T>::GetOutputAsAstraShare() {
+  return std::make_shared<astra::BooleanShare>(output_wires_);
+}
+
+template class BooleanOperandsGate<std::uint8_t>;
+template class BooleanOperandsGate<std::uint16_t>;
+template class BooleanOperandsGate<std::uint32_t>;
+template class BooleanOperandsGate<std::uint64_t>;
+template class BooleanOperandsGate<__uint128_t>;
+
 }  // namespace encrypto::motion::proto::astra
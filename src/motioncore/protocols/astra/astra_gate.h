@@ -23,11 +23,20 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include "base/backend.h"
 #include "base/register.h"
 #include "communication/communication_layer.h"
 #include "communication/message.h"
+#include "communication/message_buffer.h"
+#include "protocols/astra/astra_provider.h"
+#include "protocols/astra/astra_share.h"
 #include "protocols/astra/astra_wire.h"
+#include "utility/bit_vector.h"
+#include "utility/reusable_future.h"
 
 namespace encrypto::motion::proto::astra { 
     
@@ -39,6 +48,9 @@ class InputGate final : public motion::InputGate {
 
  public:
   InputGate(std::vector<T> input, std::size_t input_owner, Backend& backend);
+  // number_of_simd values whose owner passes them later via GetInputPromise(), e.g., after the
+  // setup phase
+  InputGate(std::size_t number_of_simd, std::size_t input_owner, Backend& backend);
 
   ~InputGate() final = default;
 
@@ -46,9 +58,15 @@ class InputGate final : public motion::InputGate {
   void EvaluateOnline() final override;
   
   astra::SharePointer<T> GetOutputAsAstraShare();
+
+  // throws std::logic_error if the gate has no deferred input of this party
+  motion::ReusableFiberPromise<std::vector<T>>& GetInputPromise();
   
  private:
-  motion::ReusableFiberFuture<std::vector<std::uint8_t>> input_future_;
+  motion::ReusableFiberFuture<communication::MessageBuffer> input_future_;
+  std::optional<std::pair<motion::ReusableFiberPromise<std::vector<T>>,
+                          motion::ReusableFiberFuture<std::vector<T>>>>
+      input_promise_future_;
 };
 
 template <typename T>
@@ -70,7 +88,7 @@ class OutputGate final : public motion::OutputGate {
   astra::SharePointer<T> GetOutputAsAstraShare();
   
  private:
-  motion::ReusableFiberFuture<std::vector<std::uint8_t>> output_future_;
+  motion::ReusableFiberFuture<communication::MessageBuffer> output_future_;
 };
 
 template<typename T>
@@ -118,8 +136,9 @@ class MultiplicationGate final : public TwoGate {
   astra::SharePointer<T> GetOutputAsAstraShare();
   
  private:
-  motion::ReusableFiberFuture<std::vector<std::uint8_t>> multiply_future_setup_;
-  motion::ReusableFiberFuture<std::vector<std::uint8_t>> multiply_future_online_;
+  // the gamma_ab_2 message from party 0 to party 2 and the online messages between parties 1 and
+  // 2, which are batched with the messages of the gates of the same multiplicative depth
+  astra::Provider::Slot setup_slot_, online_send_slot_, online_receive_slot_;
 };
 
 template<typename T>
@@ -138,9 +157,152 @@ class DotProductGate final : public TwoGate {
   astra::SharePointer<T> GetOutputAsAstraShare();
   
  private:
-  motion::ReusableFiberFuture<std::vector<std::uint8_t>> dot_product_future_setup_;
-  motion::ReusableFiberFuture<std::vector<std::uint8_t>> dot_product_future_online_;
+  // the gamma_ab_2 message from party 0 to party 2 and the online messages between parties 1 and
+  // 2, which are batched with the messages of the gates of the same multiplicative depth
+  astra::Provider::Slot setup_slot_, online_send_slot_, online_receive_slot_;
 };
 
-    
-} //namespace encrypto::motion::proto::astra
\ No newline at end of file
+// Product of a rows x inner matrix a and an inner x columns matrix b, which are given row-major as
+// the SIMD values of the wires like for arithmetic_gmw::MatrixMultiplicationGate. The local
+// products are computed with the blocked kernel AddMatrixProduct, and each phase sends the
+// rows x columns values of the matrix in the message batches of the dot product gates.
+template <typename T>
+class MatrixMultiplicationGate final : public TwoGate {
+  using Base = motion::TwoGate;
+
+ public:
+  MatrixMultiplicationGate(const astra::WirePointer<T>& a, const astra::WirePointer<T>& b,
+                           std::size_t rows, std::size_t inner, std::size_t columns);
+
+  ~MatrixMultiplicationGate() final = default;
+
+  MatrixMultiplicationGate(MatrixMultiplicationGate&) = delete;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  astra::SharePointer<T> GetOutputAsAstraShare();
+
+ private:
+  astra::Provider::Slot setup_slot_, online_send_slot_, online_receive_slot_;
+  std::size_t rows_, inner_, columns_;
+};
+
+// Input gate of a Boolean Astra share with one wire per bit of input, where the parties that are
+// not the input owner pass zero BitVectors of the same sizes
+class BooleanInputGate final : public motion::InputGate {
+  using Base = motion::InputGate;
+
+ public:
+  BooleanInputGate(std::span<const BitVector<>> input, std::size_t input_owner, Backend& backend);
+  // the wires of an input whose owner passes it later via GetInputPromise()
+  BooleanInputGate(std::size_t number_of_wires, std::size_t number_of_simd,
+                   std::size_t input_owner, Backend& backend);
+
+  ~BooleanInputGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  astra::BooleanSharePointer GetOutputAsAstraShare();
+
+  // throws std::logic_error if the gate has no deferred input of this party
+  motion::ReusableFiberPromise<std::vector<BitVector<>>>& GetInputPromise();
+
+ private:
+  motion::ReusableFiberFuture<communication::MessageBuffer> input_future_;
+  std::optional<std::pair<motion::ReusableFiberPromise<std::vector<BitVector<>>>,
+                          motion::ReusableFiberFuture<std::vector<BitVector<>>>>>
+      input_promise_future_;
+};
+
+class BooleanOutputGate final : public motion::OutputGate {
+  using Base = motion::OutputGate;
+
+ public:
+  BooleanOutputGate(const motion::SharePointer& parent, std::size_t output_owner = kAll);
+
+  ~BooleanOutputGate() final = default;
+
+  void EvaluateSetup() final override {}
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  astra::BooleanSharePointer GetOutputAsAstraShare();
+
+ private:
+  motion::ReusableFiberFuture<communication::MessageBuffer> output_future_;
+};
+
+// XOR of two Boolean Astra shares, which XORs the masked values and the masks locally
+class XorGate final : public TwoGate {
+ public:
+  XorGate(const motion::SharePointer& a, const motion::SharePointer& b);
+
+  ~XorGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  bool IsLocal() const override { return true; }
+
+  astra::BooleanSharePointer GetOutputAsAstraShare();
+};
+
+// NOT of a Boolean Astra share, which inverts the masked values locally
+class InvGate final : public OneGate {
+ public:
+  InvGate(const motion::SharePointer& parent);
+
+  ~InvGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  bool IsLocal() const override { return true; }
+
+  astra::BooleanSharePointer GetOutputAsAstraShare();
+};
+
+// AND of two Boolean Astra shares, i.e., the multiplication gate over GF(2) with the same setup
+// message from party 0 to party 2 and the same online messages between parties 1 and 2
+class AndGate final : public TwoGate {
+ public:
+  AndGate(const motion::SharePointer& a, const motion::SharePointer& b);
+
+  ~AndGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  astra::BooleanSharePointer GetOutputAsAstraShare();
+
+ private:
+  // the share gamma_ab_1 or gamma_ab_2 of lambda_a & lambda_b of parties 1 and 2
+  std::vector<BitVector<>> gamma_;
+  astra::Provider::Slot setup_slot_, online_send_slot_, online_receive_slot_;
+};
+
+// Splits an arithmetic Astra share of x = m_x - lambda1 - lambda2 into the Boolean Astra shares of
+// the bits of m_x, lambda1 and lambda2 without interaction: the bits of m_x are the masked values
+// of parties 1 and 2 with zero masks, and the bits of lambda1 and lambda2 are the masks lambda1 and
+// lambda2 of zero masked values, respectively. The output wires are the sizeof(T) * 8 bits of m_x
+// followed by the bits of lambda1 and lambda2, least significant bit first, whose difference the
+// bit decomposition computes with a Boolean adder.
+template <typename T>
+class BooleanOperandsGate final : public OneGate {
+ public:
+  BooleanOperandsGate(const astra::WirePointer<T>& parent);
+
+  ~BooleanOperandsGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  bool IsLocal() const override { return true; }
+
+  astra::BooleanSharePointer GetOutputAsAstraShare();
+};
+
+}  // namespace encrypto::motion::proto::astra
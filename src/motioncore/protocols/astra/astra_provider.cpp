@@ -0,0 +1,145 @@
+// MIT License
+//
+// Copyright (c) 2022 Oliver Schick
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "astra_provider.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+
+namespace encrypto::motion::proto::astra {
+
+Provider::Provider(communication::CommunicationLayer& communication_layer)
+    : communication_layer_(communication_layer) {}
+
+Provider::~Provider() = default;
+
+std::size_t Provider::GetMessageId(std::size_t multiplicative_depth) {
+  maximum_multiplicative_depth_ = std::max(maximum_multiplicative_depth_, multiplicative_depth);
+  return message_id_offset_ + multiplicative_depth;
+}
+
+Provider::Slot Provider::RegisterSend(std::size_t receiver_id,
+                                      communication::MessageType message_type,
+                                      std::size_t multiplicative_depth,
+                                      std::size_t number_of_bytes) {
+  std::scoped_lock lock(registration_mutex_);
+  const BatchKey key{receiver_id, message_type, multiplicative_depth};
+  auto [iterator, is_new] = send_batch_indices_.try_emplace(key, send_batches_.size());
+  if (is_new) {
+    auto& batch{send_batches_.emplace_back(std::make_unique<SendBatch>())};
+    batch->receiver_id = receiver_id;
+    batch->message_type = message_type;
+    batch->message_id = GetMessageId(multiplicative_depth);
+  }
+  auto& batch{*send_batches_[iterator->second]};
+  const Slot slot{iterator->second, batch.number_of_bytes, number_of_bytes};
+  batch.number_of_bytes += number_of_bytes;
+  ++batch.number_of_contributors;
+  ++batch.number_of_missing_contributors;
+  return slot;
+}
+
+Provider::Slot Provider::RegisterReceive(std::size_t sender_id,
+                                         communication::MessageType message_type,
+                                         std::size_t multiplicative_depth,
+                                         std::size_t number_of_bytes) {
+  std::scoped_lock lock(registration_mutex_);
+  const BatchKey key{sender_id, message_type, multiplicative_depth};
+  auto [iterator, is_new] = receive_batch_indices_.try_emplace(key, receive_batches_.size());
+  if (is_new) {
+    auto& batch{receive_batches_.emplace_back(std::make_unique<ReceiveBatch>())};
+    batch->future = communication_layer_.GetMessageManager().RegisterReceive(
+        sender_id, message_type, GetMessageId(multiplicative_depth));
+  }
+  auto& batch{*receive_batches_[iterator->second]};
+  const Slot slot{iterator->second, batch.number_of_bytes, number_of_bytes};
+  batch.number_of_bytes += number_of_bytes;
+  return slot;
+}
+
+void Provider::Send(const Slot& slot, std::span<const std::uint8_t> message) {
+  assert(message.size() == slot.number_of_bytes);
+  auto& batch{*send_batches_.at(slot.batch)};
+  {
+    std::scoped_lock lock(batch.mutex);
+    // the buffer is released after sending and allocated again if the gates are evaluated again
+    batch.buffer.resize(batch.number_of_bytes);
+    std::copy(message.begin(), message.end(), batch.buffer.begin() + slot.offset);
+    assert(batch.number_of_missing_contributors > 0);
+    if (--batch.number_of_missing_contributors > 0) return;
+  }
+  // all other contributors have finished writing, since each gate contributes exactly once
+  auto built_message{
+      communication::BuildMessage(batch.message_type, batch.message_id, batch.buffer)};
+  std::vector<std::uint8_t>().swap(batch.buffer);
+  communication_layer_.SendMessage(batch.receiver_id, built_message.Release());
+}
+
+std::span<const std::uint8_t> Provider::Receive(const Slot& slot) {
+  auto& batch{*receive_batches_.at(slot.batch)};
+  std::scoped_lock lock(batch.mutex);
+  if (!batch.is_received) {
+    batch.message = batch.future.get();
+    batch.is_received = true;
+  }
+  const auto payload{communication::GetMessage(batch.message.data())->payload()};
+  if (payload->size() != batch.number_of_bytes) {
+    throw std::runtime_error(fmt::format("Received an Astra batch of {} bytes, expected {} bytes",
+                                         payload->size(), batch.number_of_bytes));
+  }
+  return {payload->Data() + slot.offset, slot.number_of_bytes};
+}
+
+void Provider::Clear() {
+  std::scoped_lock lock(registration_mutex_);
+  for (auto& batch : send_batches_) {
+    batch->number_of_missing_contributors = batch->number_of_contributors;
+  }
+  for (auto& batch : receive_batches_) {
+    batch->message = communication::MessageBuffer();
+    batch->is_received = false;
+  }
+}
+
+void Provider::Reset() {
+  std::scoped_lock lock(registration_mutex_);
+  if (!send_batches_.empty() || !receive_batches_.empty()) {
+    message_id_offset_ += maximum_multiplicative_depth_ + 1;
+  }
+  maximum_multiplicative_depth_ = 0;
+  send_batch_indices_.clear();
+  receive_batch_indices_.clear();
+  send_batches_.clear();
+  receive_batches_.clear();
+}
+
+}  // namespace encrypto::motion::proto::astra
@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2022 Oliver Schick
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <boost/fiber/mutex.hpp>
+
+#include "communication/message_buffer.h"
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+enum class MessageType : uint8_t;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion::proto::astra {
+
+// Batches the messages of the Astra multiplication, dot product and AND gates. The gates of the
+// same multiplicative depth write their messages of each phase to a shared buffer per peer and
+// message type, which is sent as a single message once the last of them contributed, instead of
+// sending one message per gate. The gates register their slots in their constructors, such that
+// the batches are the same on all parties.
+class Provider {
+ public:
+  using future_type = ReusableFiberFuture<communication::MessageBuffer>;
+
+  // the position of the message of a gate in a batch
+  struct Slot {
+    std::size_t batch;
+    std::size_t offset;
+    std::size_t number_of_bytes;
+  };
+
+  Provider(communication::CommunicationLayer& communication_layer);
+
+  ~Provider();
+
+  // registers a message of number_of_bytes bytes to receiver_id in the batch of message_type and
+  // multiplicative_depth
+  Slot RegisterSend(std::size_t receiver_id, communication::MessageType message_type,
+                    std::size_t multiplicative_depth, std::size_t number_of_bytes);
+
+  // registers a message of number_of_bytes bytes from sender_id in the batch of message_type and
+  // multiplicative_depth
+  Slot RegisterReceive(std::size_t sender_id, communication::MessageType message_type,
+                       std::size_t multiplicative_depth, std::size_t number_of_bytes);
+
+  // writes the message of a gate to its slot and sends the batch after the last contribution
+  void Send(const Slot& slot, std::span<const std::uint8_t> message);
+
+  // waits for the batch of the slot and returns the message of the gate, which stays valid until
+  // the next Clear() or Reset()
+  std::span<const std::uint8_t> Receive(const Slot& slot);
+
+  // prepares the registered batches for evaluating the same gates again
+  void Clear();
+
+  // removes all batches for a new circuit
+  void Reset();
+
+ private:
+  using BatchKey = std::tuple<std::size_t, communication::MessageType, std::size_t>;
+
+  struct SendBatch {
+    std::size_t receiver_id;
+    communication::MessageType message_type;
+    std::size_t message_id;
+    std::size_t number_of_bytes{0};
+    std::size_t number_of_contributors{0};
+    std::size_t number_of_missing_contributors{0};
+    std::vector<std::uint8_t> buffer;
+    std::mutex mutex;
+  };
+
+  struct ReceiveBatch {
+    std::size_t number_of_bytes{0};
+    future_type future;
+    communication::MessageBuffer message;
+    bool is_received{false};
+    boost::fibers::mutex mutex;
+  };
+
+  std::size_t GetMessageId(std::size_t multiplicative_depth);
+
+  communication::CommunicationLayer& communication_layer_;
+
+  std::mutex registration_mutex_;
+  std::map<BatchKey, std::size_t> send_batch_indices_, receive_batch_indices_;
+  std::vector<std::unique_ptr<SendBatch>> send_batches_;
+  std::vector<std::unique_ptr<ReceiveBatch>> receive_batches_;
+
+  // the batches of the multiplicative depth d use the message id offset + d, where the offset is
+  // increased in Reset() to not reuse the message ids of the previous circuit
+  std::size_t message_id_offset_{0};
+  std::size_t maximum_multiplicative_depth_{0};
+};
+
+}  // namespace encrypto::motion::proto::astra
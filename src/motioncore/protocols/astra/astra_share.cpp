@@ -123,4 +123,43 @@ template class Share<std::uint32_t>;
 template class Share<std::uint64_t>;
 template class Share<__uint128_t>;
 
+BooleanShare::BooleanShare(const std::vector<motion::WirePointer>& wires)
+    : motion::BooleanShare(wires.at(0)->GetBackend()) {
+  for (const auto& wire : wires) {
+    if (!std::dynamic_pointer_cast<astra::BooleanWire>(wire)) {
+      throw(std::runtime_error(
+          "Trying to create a Boolean astra share from wires that are not Boolean astra wires"));
+    }
+    if (wire->GetNumberOfSimdValues() != wires.at(0)->GetNumberOfSimdValues()) {
+      throw(std::runtime_error(
+          "Trying to create a Boolean astra share from wires with different numbers of SIMD "
+          "values"));
+    }
+  }
+  wires_ = wires;
+}
+
+std::size_t BooleanShare::GetNumberOfSimdValues() const noexcept {
+  return wires_.at(0)->GetNumberOfSimdValues();
+}
+
+std::vector<std::shared_ptr<motion::Share>> BooleanShare::Split() const noexcept {
+  std::vector<std::shared_ptr<motion::Share>> v;
+  v.reserve(wires_.size());
+  for (const auto& w : wires_) {
+    const std::vector<motion::WirePointer> w_v = {w};
+    v.emplace_back(std::make_shared<BooleanShare>(w_v));
+  }
+  return v;
+}
+
+std::shared_ptr<motion::Share> BooleanShare::GetWire(std::size_t i) const {
+  if (i >= wires_.size()) {
+    throw std::out_of_range(
+        fmt::format("Trying to access wire #{} out of {} wires", i, wires_.size()));
+  }
+  std::vector<motion::WirePointer> result = {wires_[i]};
+  return std::make_shared<BooleanShare>(result);
+}
+
 }  // namespace encrypto::motion::proto::astra
@@ -74,4 +74,32 @@ class Share final : public motion::Share {
 template <typename T>
 using SharePointer = std::shared_ptr<Share<T>>;
 
+// a share of one or more Boolean Astra wires, e.g., the bits of an integer
+class BooleanShare final : public motion::BooleanShare {
+ public:
+  BooleanShare(const std::vector<motion::WirePointer>& wires);
+
+  ~BooleanShare() override = default;
+
+  std::size_t GetNumberOfSimdValues() const noexcept final;
+
+  MpcProtocol GetProtocol() const noexcept final { return MpcProtocol::kAstra; }
+
+  CircuitType GetCircuitType() const noexcept final { return CircuitType::kBoolean; }
+
+  const std::vector<motion::WirePointer>& GetWires() const noexcept final { return wires_; }
+
+  std::vector<motion::WirePointer>& GetMutableWires() noexcept final { return wires_; }
+
+  std::size_t GetBitLength() const noexcept final { return wires_.size(); }
+
+  std::vector<std::shared_ptr<motion::Share>> Split() const noexcept final;
+
+  std::shared_ptr<motion::Share> GetWire(std::size_t i) const override;
+
+  BooleanShare(BooleanShare&) = delete;
+};
+
+using BooleanSharePointer = std::shared_ptr<BooleanShare>;
+
 }  // namespace encrypto::motion::proto::astra
\ No newline at end of file
@@ -23,13 +23,13 @@
 
 #include "astra_wire.h"
 
+#include <algorithm>
+
 namespace encrypto::motion::proto::astra {
 
 template<typename T>
 Wire<T>::Wire(Backend& backend, std::vector<Data> values)
-  : Base(backend, values.size()), values_{std::move(values)}, 
-    setup_ready_condition_{std::make_unique<FiberCondition>([this]() { return setup_ready_.load(); })} {   
-}
+  : Base(backend, values.size()), values_{std::move(values)} {}
 
 template<typename T>
 Wire<T>::Wire(Backend& backend, std::size_t number_of_simd)
@@ -40,5 +40,58 @@ template class Wire<std::uint16_t>;
 template class Wire<std::uint32_t>;
 template class Wire<std::uint64_t>;
 template class Wire<__uint128_t>;
+
+BooleanWire::BooleanWire(Backend& backend, std::size_t number_of_simd)
+    : Base(backend, number_of_simd),
+      values_(number_of_simd),
+      lambda1_(number_of_simd),
+      lambda2_(number_of_simd) {}
+
+// calls function with the Boolean Astra wire or the arithmetic Astra wire of the matching bit
+// length if wire is an Astra wire
+template <typename Function>
+static void VisitAstraWire(const motion::WirePointer& wire, Function function) {
+  if (wire->GetProtocol() != MpcProtocol::kAstra) return;
+  if (wire->GetCircuitType() == CircuitType::kBoolean) {
+    function(*std::dynamic_pointer_cast<BooleanWire>(wire));
+    return;
+  }
+  switch (wire->GetBitLength()) {
+    case 8:
+      function(*std::dynamic_pointer_cast<Wire<std::uint8_t>>(wire));
+      break;
+    case 16:
+      function(*std::dynamic_pointer_cast<Wire<std::uint16_t>>(wire));
+      break;
+    case 32:
+      function(*std::dynamic_pointer_cast<Wire<std::uint32_t>>(wire));
+      break;
+    case 64:
+      function(*std::dynamic_pointer_cast<Wire<std::uint64_t>>(wire));
+      break;
+    case 128:
+      function(*std::dynamic_pointer_cast<Wire<__uint128_t>>(wire));
+      break;
+  }
+}
+
+std::size_t GetMaximumMultiplicativeDepth(std::span<const motion::WirePointer> wires) {
+  std::size_t maximum_depth{0};
+  for (const auto& wire : wires) {
+    VisitAstraWire(wire, [&maximum_depth](const auto& astra_wire) {
+      maximum_depth = std::max(maximum_depth, astra_wire.GetMultiplicativeDepth());
+    });
+  }
+  return maximum_depth;
+}
+
+void SetMultiplicativeDepth(std::span<const motion::WirePointer> wires,
+                            std::size_t multiplicative_depth) {
+  for (const auto& wire : wires) {
+    VisitAstraWire(wire, [multiplicative_depth](auto& astra_wire) {
+      astra_wire.SetMultiplicativeDepth(multiplicative_depth);
+    });
+  }
+}
     
 } // namespace encrypto::motion::proto::astra
\ No newline at end of file
@@ -23,7 +23,10 @@
 
 #pragma once
 
+#include <span>
+
 #include "protocols/wire.h"
+#include "utility/bit_vector.h"
 
 namespace encrypto::motion::proto::astra {
     
@@ -61,24 +64,84 @@ class Wire final : public motion::Wire {
   
   std::vector<Data>& GetMutableValues() { return values_; }
 
-  void SetSetupIsReady() {
-    {
-      std::scoped_lock lock(setup_ready_condition_->GetMutex());
-      setup_ready_ = true;
-    }
-    setup_ready_condition_->NotifyAll();
-  }
+  void SetSetupIsReady() { setup_ready_.Set(); }
+
+  const FiberSignal* GetSetupReadyCondition() const { return &setup_ready_; }
+
+  // the number of multiplications on the longest path from the inputs to this wire, which
+  // determines the message batches of the multiplications using this wire, see astra::Provider
+  std::size_t GetMultiplicativeDepth() const { return multiplicative_depth_; }
 
-  const auto& GetSetupReadyCondition() const { return setup_ready_condition_; }
+  void SetMultiplicativeDepth(std::size_t multiplicative_depth) {
+    multiplicative_depth_ = multiplicative_depth;
+  }
   
  private:
   std::vector<Data> values_;
 
-  std::atomic<bool> setup_ready_{false};
-  std::unique_ptr<FiberCondition> setup_ready_condition_;
+  FiberSignal setup_ready_;
+  std::size_t multiplicative_depth_{0};
 };
 
 template<typename T>
 using WirePointer = std::shared_ptr<astra::Wire<T>>;
+
+// A Boolean Astra wire holds one bit per SIMD value, which is shared like the arithmetic values
+// over GF(2): parties 1 and 2 know the masked value m = x ^ lambda1 ^ lambda2, party i in {1, 2}
+// knows lambda_i and party 0 knows both masks. The masks a party does not know are zero.
+class BooleanWire final : public motion::BooleanWire {
+  using Base = motion::BooleanWire;
+
+ public:
+  BooleanWire(Backend& backend, std::size_t number_of_simd);
+
+  ~BooleanWire() = default;
+
+  MpcProtocol GetProtocol() const final { return MpcProtocol::kAstra; }
+
+  bool IsConstant() const noexcept final { return false; }
+
+  std::size_t GetBitLength() const final { return 1; }
+
+  const BitVector<>& GetValues() const { return values_; }
+
+  BitVector<>& GetMutableValues() { return values_; }
+
+  const BitVector<>& GetLambda1() const { return lambda1_; }
+
+  BitVector<>& GetMutableLambda1() { return lambda1_; }
+
+  const BitVector<>& GetLambda2() const { return lambda2_; }
+
+  BitVector<>& GetMutableLambda2() { return lambda2_; }
+
+  void SetSetupIsReady() { setup_ready_.Set(); }
+
+  const FiberSignal* GetSetupReadyCondition() const { return &setup_ready_; }
+
+  // the number of interactive layers on the longest path from the inputs to this wire, see
+  // Wire<T>::GetMultiplicativeDepth
+  std::size_t GetMultiplicativeDepth() const { return multiplicative_depth_; }
+
+  void SetMultiplicativeDepth(std::size_t multiplicative_depth) {
+    multiplicative_depth_ = multiplicative_depth;
+  }
+
+ private:
+  BitVector<> values_, lambda1_, lambda2_;
+
+  FiberSignal setup_ready_;
+  std::size_t multiplicative_depth_{0};
+};
+
+using BooleanWirePointer = std::shared_ptr<astra::BooleanWire>;
+
+// returns the largest multiplicative depth of the arithmetic Astra wires of any bit length and the
+// Boolean Astra wires in wires
+std::size_t GetMaximumMultiplicativeDepth(std::span<const motion::WirePointer> wires);
+
+// sets the multiplicative depth of the arithmetic and Boolean Astra wires in wires
+void SetMultiplicativeDepth(std::span<const motion::WirePointer> wires,
+                            std::size_t multiplicative_depth);
     
 } // namespace encrypto::motion::proto::astra
\ No newline at end of file
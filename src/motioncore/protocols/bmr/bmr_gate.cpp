@@ -26,13 +26,16 @@
 #include "bmr_provider.h"
 #include "bmr_wire.h"
 
+#include <algorithm>
 #include <span>
 
 #include "base/backend.h"
+#include "base/configuration.h"
 #include "base/motion_base_provider.h"
 #include "communication/communication_layer.h"
 #include "communication/message.h"
 #include "oblivious_transfer/ot_flavors.h"
+#include "primitives/aes/aes_batch_backend.h"
 #include "primitives/aes/aesni_primitives.h"
 #include "primitives/pseudo_random_generator.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
@@ -185,7 +188,7 @@ void InputGate::EvaluateOnline() {
     for (std::size_t i = 0; i < output_wires_.size(); ++i) {
       auto wire = std::dynamic_pointer_cast<bmr::Wire>(output_wires_[i]);
       assert(wire);
-      wire->GetMutablePublicValues() = input[i] ^ wire->GetPermutationBits();
+      XorInto(wire->GetMutablePublicValues(), input[i], wire->GetPermutationBits());
       buffer.Append(wire->GetPublicValues());
     }
     std::span payload(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
@@ -196,7 +199,7 @@ void InputGate::EvaluateOnline() {
   }
   // otherwise receive the public values from the party that provides the input
   else {
-    std::vector<std::uint8_t> public_values_message{received_public_values_.get()};
+    auto public_values_message{received_public_values_.get()};
     auto pointer{const_cast<std::uint8_t*>(
         communication::GetMessage(public_values_message.data())->payload()->data())};
     BitSpan public_values_span(pointer, output_wires_.size() * number_of_simd_);
@@ -260,8 +263,7 @@ void InputGate::EvaluateOnline() {
       assert(received_public_keys_.size() == number_of_parties - 1);
       // other party: we copy the received keys to the right position
       std::size_t party_i_remapped{party_i > my_id ? party_i - 1 : party_i};
-      std::vector<std::uint8_t> received_keys_message{
-          received_public_keys_[party_i_remapped].get()};
+      auto received_keys_message{received_public_keys_[party_i_remapped].get()};
       const std::uint8_t* received_keys_pointer{
           communication::GetMessage(received_keys_message.data())->payload()->data()};
       assert(communication::GetMessage(received_keys_message.data())->payload()->size() ==
@@ -425,7 +427,7 @@ void OutputGate::EvaluateOnline() {
       assert(input_wire->GetPublicValues().GetSize() == gmw_wire->GetValues().GetSize());
       // compute the real values as XOR of the public values from the bmr::Wire
       // with the reconstructed permutation bits from the boolean_gmw::Wire
-      output_.at(i) = input_wire->GetPublicValues() ^ gmw_wire->GetValues();
+      XorInto(output_.at(i), input_wire->GetPublicValues(), gmw_wire->GetValues());
       auto output_wire = std::dynamic_pointer_cast<bmr::Wire>(output_wires_.at(i));
       assert(output_wire);
       output_wire->GetMutablePublicValues() = output_.at(i);
@@ -492,8 +494,8 @@ void XorGate::EvaluateSetup() {
     bmr_b->GetSetupReadyCondition()->Wait();
 
     // use freeXOR garbling
-    bmr_output->GetMutablePermutationBits() =
-        bmr_a->GetPermutationBits() ^ bmr_b->GetPermutationBits();
+    XorInto(bmr_output->GetMutablePermutationBits(), bmr_a->GetPermutationBits(),
+            bmr_b->GetPermutationBits());
     bmr_output->GetMutableSecretKeys() = bmr_a->GetSecretKeys() ^ bmr_b->GetSecretKeys();
     bmr_output->SetSetupIsReady();
   }
@@ -524,7 +526,8 @@ void XorGate::EvaluateOnline() {
 
     // perform freeXOR evaluation
     bmr_output->GetMutablePublicKeys() = wire_a->GetPublicKeys() ^ wire_b->GetPublicKeys();
-    bmr_output->GetMutablePublicValues() = wire_a->GetPublicValues() ^ wire_b->GetPublicValues();
+    XorInto(bmr_output->GetMutablePublicValues(), wire_a->GetPublicValues(),
+            wire_b->GetPublicValues());
   }
 
   if constexpr (kDebug) {
@@ -712,7 +715,16 @@ AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
   garbled_tables_.SetToZero();
 
   // store futures for the (partial) garbled tables we will receive during garbling
-  received_garbled_rows_ = backend_.GetBmrProvider().RegisterForGarbledRows(gate_id_);
+  if (GetConfiguration().GetAggregateBmrGarbledTables()) {
+    // spread the load of aggregating over the parties
+    garbled_tables_aggregator_id_ = gate_id_ % number_of_parties;
+  }
+  if (!garbled_tables_aggregator_id_ || *garbled_tables_aggregator_id_ == my_id) {
+    received_garbled_rows_ = backend_.GetBmrProvider().RegisterForGarbledRows(gate_id_);
+  } else {
+    received_garbled_rows_.emplace_back(backend_.GetBmrProvider().RegisterForAggregatedGarbledRows(
+        *garbled_tables_aggregator_id_, gate_id_));
+  }
 
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {}, parents: {}, {}", gate_id_,
@@ -805,7 +817,7 @@ void AndGate::EvaluateSetup() {
 
     for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
       if (party_i == my_id) {
-        choices.at(party_i).at(wire_i) = a_permutation_bits & b_permutation_bits;
+        AndInto(choices.at(party_i).at(wire_i), a_permutation_bits, b_permutation_bits);
         continue;
       }
 
@@ -853,7 +865,7 @@ void AndGate::EvaluateSetup() {
       sender_ot_1->ComputeOutputs();
       const auto& sender_bitvector = sender_ot_1->GetOutputs();
 
-      choices.at(party_i).at(wire_i) = receiver_bitvector ^ sender_bitvector;
+      XorInto(choices.at(party_i).at(wire_i), receiver_bitvector, sender_bitvector);
 
       if constexpr (kVerboseDebug) {
         const auto& receiver_bitvector_check = receiver_ot_1->GetChoices();
@@ -885,13 +897,15 @@ void AndGate::EvaluateSetup() {
     const auto& b_permutation_bits = bmr_b->GetPermutationBits();
 
     assert(choices.at(0).at(wire_i).GetSize() == number_of_simd);
+    // \lambda_w^i ^ \lambda_uv^i, XORed with the bulk kernels instead of bit by bit
+    motion::BitVector<> lambdas{out_permutation_bits};
+    for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
+      lambdas ^= choices.at(party_i).at(wire_i);
+    }
     auto& aggregated_choices_fw = aggregated_choices.at(wire_i);
     aggregated_choices_fw = motion::BitVector<>(3 * number_of_simd, false);
     for (auto bit_i = 0ull; bit_i < number_of_simd; ++bit_i) {
-      bool bit_value = out_permutation_bits.Get(bit_i);  // \lambda_w^i
-      for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-        bit_value ^= choices.at(party_i).at(wire_i).Get(bit_i);  // \lambda_uv^i
-      }
+      const bool bit_value{lambdas.Get(bit_i)};
       aggregated_choices_fw.Set(bit_value, bit_i * 3);
       aggregated_choices_fw.Set(bit_value ^ a_permutation_bits[bit_i], bit_i * 3 + 1);
       aggregated_choices_fw.Set(bit_value ^ b_permutation_bits[bit_i], bit_i * 3 + 2);
@@ -916,6 +930,7 @@ void AndGate::EvaluateSetup() {
 
   // Compute garbled rows
   // First, set rows to PRG outputs XOR key
+  const std::size_t number_of_threads{GetConfiguration().GetNumOfThreads()};
   for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
     auto bmr_output{std::dynamic_pointer_cast<bmr::Wire>(output_wires_.at(wire_i))};
     assert(bmr_output);
@@ -924,24 +939,43 @@ void AndGate::EvaluateSetup() {
     assert(bmr_a);
     assert(bmr_b);
 
+    // the rows of all SIMD values are consecutive in the garbled tables, so their DKC inputs are
+    // collected row by row and encrypted in chunks on several threads
+    const std::size_t number_of_rows{4 * number_of_simd};
+    Block128Vector keys_a(number_of_rows), keys_b(number_of_rows);
+    std::vector<std::uint64_t> gate_ids(number_of_rows);
     for (auto simd_i = 0ull; simd_i < number_of_simd; ++simd_i) {
       const auto& key_a_0{bmr_a->GetSecretKeys().at(simd_i)};
-      const auto& key_a_1{key_a_0 ^ R};
       const auto& key_b_0{bmr_b->GetSecretKeys().at(simd_i)};
-      const auto& key_b_1{key_b_0 ^ R};
+      keys_a[4 * simd_i] = keys_a[4 * simd_i + 1] = key_a_0;
+      keys_a[4 * simd_i + 2] = keys_a[4 * simd_i + 3] = key_a_0 ^ R;
+      keys_b[4 * simd_i] = keys_b[4 * simd_i + 2] = key_b_0;
+      keys_b[4 * simd_i + 1] = keys_b[4 * simd_i + 3] = key_b_0 ^ R;
 
       // TODO: fix gate id computation
       const auto gate_id = static_cast<uint64_t>(bmr_output->GetWireId() + simd_i);
+      std::fill_n(gate_ids.begin() + 4 * simd_i, 4, gate_id);
+    }
+    // a registered batch backend takes all rows of the wire at once
+    if (const auto backend{primitives::GetAesBatchBackend()};
+        backend && number_of_rows * number_of_parties >= backend->GetMinimumBatchSize()) {
+      backend->BmrDkc(aes_round_keys, keys_a[0].data(), keys_b[0].data(), gate_ids.data(),
+                      number_of_rows, number_of_parties,
+                      &garbled_tables_[GetGarbledTableIndex(wire_i, 0, 0, 0)]);
+    } else {
+      constexpr std::size_t kRowsPerChunk{1024};
+      const std::size_t number_of_chunks{(number_of_rows + kRowsPerChunk - 1) / kRowsPerChunk};
+#pragma omp parallel for num_threads(number_of_threads) if (number_of_chunks > 1)
+      for (std::size_t chunk_i = 0; chunk_i < number_of_chunks; ++chunk_i) {
+        const std::size_t first_row{chunk_i * kRowsPerChunk};
+        AesniBmrDkcBatch(aes_round_keys, keys_a[first_row].data(), keys_b[first_row].data(),
+                         gate_ids.data() + first_row,
+                         std::min(kRowsPerChunk, number_of_rows - first_row), number_of_parties,
+                         &garbled_tables_[GetGarbledTableIndex(wire_i, 0, first_row, 0)]);
+      }
+    }
 
-      AesniBmrDkc(aes_round_keys, key_a_0.data(), key_b_0.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 0, 0)]);
-      AesniBmrDkc(aes_round_keys, key_a_0.data(), key_b_1.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 1, 0)]);
-      AesniBmrDkc(aes_round_keys, key_a_1.data(), key_b_0.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 2, 0)]);
-      AesniBmrDkc(aes_round_keys, key_a_1.data(), key_b_1.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 3, 0)]);
-
+    for (auto simd_i = 0ull; simd_i < number_of_simd; ++simd_i) {
       const auto& key_w_0 = bmr_output->GetSecretKeys()[simd_i];
       garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 0, my_id)] ^= key_w_0;
       garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 1, my_id)] ^= key_w_0;
@@ -1038,23 +1072,49 @@ void AndGate::EvaluateSetup() {
   }
 
   // send out our partial garbled tables
+  // (only to the aggregator if the garbled tables are aggregated)
   std::span send_message_buffer(reinterpret_cast<const std::uint8_t*>(garbled_tables_.data()),
                                 garbled_tables_.ByteSize());
-  auto msg{communication::BuildMessage(communication::MessageType::kBmrAndGate, gate_id_,
-                                       send_message_buffer)};
-  communication_layer.BroadcastMessage(msg.Release());
+  const bool is_aggregator{!garbled_tables_aggregator_id_ ||
+                           *garbled_tables_aggregator_id_ == my_id};
+  if (!garbled_tables_aggregator_id_ || !is_aggregator) {
+    auto msg{communication::BuildMessage(communication::MessageType::kBmrAndGate, gate_id_,
+                                         send_message_buffer)};
+    if (is_aggregator) {
+      communication_layer.BroadcastMessage(msg.Release());
+    } else {
+      communication_layer.SendMessage(*garbled_tables_aggregator_id_, msg.Release());
+    }
+  }
 
   // finalize garbled tables
-  for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-    if (party_i == my_id) continue;
-    auto remapped_party_i{party_i > my_id ? party_i - 1 : party_i};
-    std::vector<std::uint8_t> garbled_rows_message = received_garbled_rows_[remapped_party_i].get();
+  if (is_aggregator) {
+    for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
+      if (party_i == my_id) continue;
+      auto remapped_party_i{party_i > my_id ? party_i - 1 : party_i};
+      auto garbled_rows_message = received_garbled_rows_[remapped_party_i].get();
+      auto pointer{reinterpret_cast<const std::byte*>(
+          communication::GetMessage(garbled_rows_message.data())->payload()->data())};
+      assert(communication::GetMessage(garbled_rows_message.data())->payload()->size() ==
+             garbled_tables_.size() * kKappa / 8);
+      std::transform(pointer, pointer + garbled_tables_.size() * Block128::size(),
+                     garbled_tables_[0].data(), garbled_tables_[0].data(),
+                     std::bit_xor<std::byte>());
+    }
+    if (garbled_tables_aggregator_id_) {
+      // publish the reconstructed garbled tables
+      auto aggregated_msg{communication::BuildMessage(
+          communication::MessageType::kBmrAndGateAggregated, gate_id_, send_message_buffer)};
+      communication_layer.BroadcastMessage(aggregated_msg.Release());
+    }
+  } else {
+    auto garbled_rows_message = received_garbled_rows_.at(0).get();
     auto pointer{reinterpret_cast<const std::byte*>(
         communication::GetMessage(garbled_rows_message.data())->payload()->data())};
     assert(communication::GetMessage(garbled_rows_message.data())->payload()->size() ==
            garbled_tables_.size() * kKappa / 8);
-    std::transform(pointer, pointer + garbled_tables_.size() * Block128::size(),
-                   garbled_tables_[0].data(), garbled_tables_[0].data(), std::bit_xor<std::byte>());
+    std::copy(pointer, pointer + garbled_tables_.size() * Block128::size(),
+              garbled_tables_[0].data());
   }
 
   // mark this gate as setup-ready to proceed with the online phase
@@ -27,8 +27,10 @@
 #include "bmr_share.h"
 
 #include <future>
+#include <optional>
 #include <span>
 
+#include "communication/message_buffer.h"
 #include "protocols/boolean_gmw/boolean_gmw_gate.h"
 #include "protocols/gate.h"
 #include "utility/bit_vector.h"
@@ -77,8 +79,8 @@ class InputGate final : public motion::InputGate {
  protected:
   std::size_t number_of_simd_{0};  ///< Number of parallel values on wires
   std::size_t bit_size_{0};        ///< Number of wires
-  ReusableFiberFuture<std::vector<std::uint8_t>> received_public_values_;
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> received_public_keys_;
+  ReusableFiberFuture<communication::MessageBuffer> received_public_values_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> received_public_keys_;
   ReusableFiberFuture<std::vector<BitVector<>>> input_future_;
   ReusableFiberPromise<std::vector<BitVector<>>> input_promise_;
 };
@@ -177,7 +179,13 @@ class AndGate final : public TwoGate {
   std::vector<std::vector<std::unique_ptr<motion::XcOtBitReceiver>>> receiver_ots_1_;
   std::vector<std::vector<std::unique_ptr<motion::FixedXcOt128Receiver>>> receiver_ots_kappa_;
 
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> received_garbled_rows_;
+  // the shares of the garbled tables of the other parties, or only the reconstructed garbled
+  // tables if they are aggregated by another party
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> received_garbled_rows_;
+
+  // the party reconstructing the garbled tables if Configuration::SetAggregateBmrGarbledTables()
+  // is set, else every party reconstructs them from the shares of all parties
+  std::optional<std::size_t> garbled_tables_aggregator_id_;
 
   // buffer to store all garbled tables for all wires
   // structure: wires X (simd X (row_00 || row_01 || row_10 || row_11))
@@ -46,4 +46,11 @@ std::vector<Provider::future_type> Provider::RegisterForGarbledRows(std::size_t
   return futures;
 }
 
+Provider::future_type Provider::RegisterForAggregatedGarbledRows(std::size_t aggregator_id,
+                                                                 std::size_t gate_id) {
+  assert(aggregator_id != my_id_);
+  return communication_layer_.GetMessageManager().RegisterReceive(
+      aggregator_id, communication::MessageType::kBmrAndGateAggregated, gate_id);
+}
+
 }  // namespace encrypto::motion::proto::bmr
@@ -25,6 +25,7 @@
 #include <memory>
 #include <vector>
 
+#include "communication/message_buffer.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
 #include "utility/reusable_future.h"
@@ -41,7 +42,7 @@ struct Data;
 
 class Provider {
  public:
-  using future_type = ReusableFiberFuture<std::vector<std::uint8_t>>;
+  using future_type = ReusableFiberFuture<communication::MessageBuffer>;
   Provider(communication::CommunicationLayer& communication_layer);
   ~Provider();
   const Block128& GetGlobalOffset() const { return global_offset_; }
@@ -49,6 +50,7 @@ class Provider {
   std::vector<future_type> RegisterForInputPublicValues(std::size_t gate_id);
   std::vector<future_type> RegisterForInputKeys(std::size_t gate_id);
   std::vector<future_type> RegisterForGarbledRows(std::size_t gate_id);
+  future_type RegisterForAggregatedGarbledRows(std::size_t aggregator_id, std::size_t gate_id);
 
  private:
   communication::CommunicationLayer& communication_layer_;
@@ -56,8 +56,6 @@ Wire::Wire(bool value, Backend& backend)
 void Wire::InitializationHelperBmr() {
   const auto number_of_parties = backend_.GetCommunicationLayer().GetNumberOfParties();
   public_keys_.resize(number_of_simd_ * number_of_parties);
-
-  setup_ready_cond_ = std::make_unique<FiberCondition>([this]() { return setup_ready_.load(); });
 }
 
 void Wire::GenerateRandomPrivateKeys() { secret_0_keys_.SetToRandom(); }
@@ -27,7 +27,7 @@
 #include "protocols/wire.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
-#include "utility/fiber_condition.h"
+#include "utility/fiber_signal.h"
 
 namespace encrypto::motion::proto::bmr {
 
@@ -71,20 +71,14 @@ class Wire final : public BooleanWire {
 
   void GenerateRandomPermutationBits();
 
-  void SetSetupIsReady() {
-    {
-      std::scoped_lock lock(setup_ready_cond_->GetMutex());
-      setup_ready_ = true;
-    }
-    setup_ready_cond_->NotifyAll();
-  }
+  void SetSetupIsReady() { setup_ready_.Set(); }
 
-  const auto& GetSetupReadyCondition() const { return setup_ready_cond_; }
+  const FiberSignal* GetSetupReadyCondition() const { return &setup_ready_; }
 
   bool IsConstant() const noexcept final { return false; }
 
  protected:
-  void DynamicClear() final { setup_ready_ = false; }
+  void DynamicClear() final { setup_ready_.Reset(); }
 
  private:
   void InitializationHelperBmr();
@@ -102,8 +96,7 @@ class Wire final : public BooleanWire {
   // by concatenating each of m parties' public keys, i.e., K = (k_1 || k_2 || ... || k_m).
   Block128Vector public_keys_;
 
-  std::atomic<bool> setup_ready_{false};
-  std::unique_ptr<FiberCondition> setup_ready_cond_;
+  FiberSignal setup_ready_;
 };
 
 using WirePointer = std::shared_ptr<Wire>;
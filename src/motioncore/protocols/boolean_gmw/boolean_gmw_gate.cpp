@@ -26,6 +26,11 @@
 #include "boolean_gmw_wire.h"
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <random>
 #include <span>
 
 #include "base/backend.h"
@@ -34,11 +39,64 @@
 #include "communication/message.h"
 #include "communication/message_manager.h"
 #include "multiplication_triple/mt_provider.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
+#include "primitives/pseudo_random_generator.h"
+#include "primitives/random/default_rng.h"
 #include "primitives/sharing_randomness_generator.h"
+#include "protocols/opening.h"
+#include "utility/constants.h"
 #include "utility/helpers.h"
 
 namespace encrypto::motion::proto::boolean_gmw {
 
+static std::span<const std::uint8_t> AsBytes(const BitVector<>& values) {
+  const auto& bytes{values.GetData()};
+  return std::span(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+}
+
+// values ^= bytes, with the bytes split over number_of_threads threads
+static void XorBytesInto(BitVector<>& values, const std::byte* bytes,
+                         std::size_t number_of_threads) {
+  std::byte* values_bytes{values.GetMutableData().data()};
+  ParallelForRanges(values.GetData().size(), number_of_threads, 1,
+                    [values_bytes, bytes](std::size_t begin, std::size_t end) {
+                      for (std::size_t k = begin; k < end; ++k) values_bytes[k] ^= bytes[k];
+                    });
+}
+
+static const flatbuffers::Vector<std::uint8_t>& GetOpeningPayload(
+    communication::MessageType message_type, std::size_t message_id,
+    const communication::MessageBuffer& opening_message, const BitVector<>& values) {
+  const auto& payload{*communication::GetMessage(opening_message.data())->payload()};
+  if (payload.size() != values.GetData().size()) {
+    throw std::runtime_error(fmt::format("{} message #{} has {} B instead of {} B",
+                                         communication::to_string(message_type), message_id,
+                                         payload.size(), values.GetData().size()));
+  }
+  return payload;
+}
+
+// XORs the masked bits of another party in opening_message into values
+static void XorMaskedBits(communication::MessageType message_type, std::size_t message_id,
+                          const communication::MessageBuffer& opening_message,
+                          BitVector<>& values, std::size_t number_of_threads = 1) {
+  const auto& payload{GetOpeningPayload(message_type, message_id, opening_message, values)};
+  if (number_of_threads > 1) {
+    XorBytesInto(values, reinterpret_cast<const std::byte*>(payload.data()), number_of_threads);
+  } else {
+    values ^= BitSpan(const_cast<std::uint8_t*>(payload.data()), values.GetSize());
+  }
+}
+
+// replaces values by the bits that the king opened in opening_message
+static void CopyOpenedBits(communication::MessageType message_type, std::size_t message_id,
+                           const communication::MessageBuffer& opening_message,
+                           BitVector<>& values) {
+  const auto& payload{GetOpeningPayload(message_type, message_id, opening_message, values)};
+  std::copy_n(reinterpret_cast<const std::byte*>(payload.data()), payload.size(),
+              values.GetMutableData().data());
+}
+
 InputGate::InputGate(std::span<const BitVector<>> input, std::size_t party_id, Backend& backend)
     : InputGate::Base(backend), input_(std::vector(input.begin(), input.end())) {
   input_owner_id_ = party_id;
@@ -53,6 +111,20 @@ InputGate::InputGate(std::vector<BitVector<>>&& input, std::size_t party_id, Bac
   InitializationHelper();
 }
 
+InputGate::InputGate(std::size_t number_of_wires, std::size_t number_of_simd,
+                     std::size_t party_id, Backend& backend)
+    : InputGate::Base(backend),
+      input_(number_of_wires, BitVector<>(number_of_simd)),
+      bits_(number_of_simd) {
+  input_owner_id_ = party_id;
+  if (party_id == GetCommunicationLayer().GetMyId()) {
+    ReusableFiberPromise<std::vector<BitVector<>>> promise;
+    auto future{promise.get_future()};
+    input_promise_future_.emplace(std::move(promise), std::move(future));
+  }
+  InitializationHelper();
+}
+
 void InputGate::InitializationHelper() {
   auto& communication_layer = GetCommunicationLayer();
   auto& _register = GetRegister();
@@ -67,7 +139,9 @@ void InputGate::InitializationHelper() {
   // assert SIMD lengths of all wires are equal
   assert(BitVector<>::IsEqualSizeDimensions(input_));
 
-  boolean_sharing_id_ = _register.NextBooleanGmwSharingId(input_.size() * bits_);
+  _register.RunInConstructionOrder(*this, [this, &_register] {
+    boolean_sharing_id_ = _register.NextBooleanGmwSharingId(input_.size() * bits_);
+  });
 
   if constexpr (kVerboseDebug) {
     GetLogger().LogTrace(fmt::format("Created a BooleanGmwInputGate with global id {}", gate_id_));
@@ -90,6 +164,12 @@ void InputGate::EvaluateSetup() {}
 void InputGate::EvaluateOnline() {
   // nothing to setup, no need to wait/check
   GetBaseProvider().WaitSetup();
+  if (input_promise_future_.has_value()) {
+    input_ = input_promise_future_->second.get();
+    assert(input_.size() == output_wires_.size());
+    assert(std::all_of(input_.begin(), input_.end(),
+                       [this](const BitVector<>& bits) { return bits.GetSize() == bits_; }));
+  }
 
   auto& communication_layer = GetCommunicationLayer();
   auto my_id = communication_layer.GetMyId();
@@ -149,6 +229,15 @@ void InputGate::EvaluateOnline() {
   }
 }
 
+ReusableFiberPromise<std::vector<BitVector<>>>& InputGate::GetInputPromise() {
+  if (!input_promise_future_.has_value()) {
+    throw std::logic_error(
+        fmt::format("boolean_gmw::InputGate#{} has no deferred input of party#{}", gate_id_,
+                    GetCommunicationLayer().GetMyId()));
+  }
+  return input_promise_future_->first;
+}
+
 const boolean_gmw::SharePointer InputGate::GetOutputAsGmwShare() {
   auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
   assert(result);
@@ -196,8 +285,9 @@ OutputGate::OutputGate(const motion::SharePointer& parent, std::size_t output_ow
   // Tell the DataStorages that we want to receive OutputMessages from the
   // other parties.
   if (is_my_output_) {
-    output_message_futures_ = GetCommunicationLayer().GetMessageManager().RegisterReceiveAll(
-        communication::MessageType::kOutputMessage, gate_id_);
+    const auto king{output_owner_ == kAll ? GetOpeningKing(gate_id_) : std::nullopt};
+    output_message_futures_ = RegisterOpening(
+        communication_layer, king, communication::MessageType::kOutputMessage, gate_id_);
   }
 
   if constexpr (kDebug) {
@@ -232,6 +322,7 @@ void OutputGate::EvaluateOnline() {
   }
 
   const std::size_t bit_size = output.at(0).GetSize();
+  const auto king{output_owner_ == kAll ? GetOpeningKing(gate_id_) : std::nullopt};
 
   // we need to send shares
   if (!is_my_output_ || output_owner_ == kAll) {
@@ -247,18 +338,27 @@ void OutputGate::EvaluateOnline() {
           communication::BuildMessage(communication::MessageType::kOutputMessage, gate_id_, s)};
       communication_layer.SendMessage(output_owner_, msg.Release());
     }
-    // we need to send shares to all other parties:
+    // we need to send shares to all other parties or to the king:
     else if (output_owner_ == kAll) {
-      std::span s(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
-                  buffer.GetData().size());
-      auto msg{
-          communication::BuildMessage(communication::MessageType::kOutputMessage, gate_id_, s)};
-      communication_layer.BroadcastMessage(msg.Release());
+      SendShareOfOpening(communication_layer, king, communication::MessageType::kOutputMessage,
+                         gate_id_, AsBytes(buffer));
     }
   }
 
+  // the king sent the reconstructed value
+  if (ReceivesOpenedValue(communication_layer, king)) {
+    const auto output_message = output_message_futures_.at(0).get();
+    auto message = communication::GetMessage(output_message.data());
+    BitSpan bit_span(const_cast<std::uint8_t*>(message->payload()->data()),
+                     bit_size * number_of_wires);
+    for (std::size_t i = 0; i < output_wires_.size(); ++i) {
+      auto wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
+      assert(wire);
+      wire->GetMutableValues() = bit_span.Subset(i * bit_size, (i + 1) * bit_size);
+    }
+  }
   // we receive shares from other parties
-  if (is_my_output_) {
+  else if (is_my_output_) {
     // collect shares from all parties
     std::vector<std::vector<BitVector<>>> shared_outputs(number_of_parties);
     for (std::size_t i = 0; i < number_of_parties; ++i) {
@@ -278,12 +378,7 @@ void OutputGate::EvaluateOnline() {
       // handle each wire
       for (std::size_t j = 0; j < number_of_wires; ++j) {
         // copy the subset to a bit vector
-        auto subset_bv = bit_span.Subset(j * bit_size, (j + 1) * bit_size);
-        // steal the data
-        auto byte_vector = std::move(subset_bv.GetMutableData());
-        // ... and construct a new BitVector
-        shared_outputs.at(i).emplace_back(std::move(byte_vector),
-                                          parent_.at(0)->GetNumberOfSimdValues());
+        shared_outputs.at(i).emplace_back(bit_span.Subset(j * bit_size, (j + 1) * bit_size));
       }
       assert(shared_outputs.at(i).size() == number_of_wires);
     }
@@ -303,6 +398,13 @@ void OutputGate::EvaluateOnline() {
       assert(wire);
       wire->GetMutableValues() = output.at(i);
     }
+    if (king) {
+      BitVector<> opened_values;
+      opened_values.Reserve(bit_size * number_of_wires);
+      for (auto& o : output) opened_values.Append(o);
+      FinishOpening(communication_layer, king, communication::MessageType::kOutputMessage,
+                    gate_id_, AsBytes(opened_values));
+    }
 
     if constexpr (kVerboseDebug) {
       std::string shares{""};
@@ -336,6 +438,87 @@ const motion::SharePointer OutputGate::GetOutputAsShare() const {
   return result;
 }
 
+RevealGate::RevealGate(std::span<const motion::SharePointer> parents)
+    : NInputGate(parents.front()->GetBackend()) {
+  wire_offsets_.reserve(parents.size() + 1);
+  for (const auto& parent : parents) {
+    if (parent->GetProtocol() != MpcProtocol::kBooleanGmw) {
+      throw std::invalid_argument(
+          fmt::format("Boolean reveal gate expects Boolean GMW shares, got a share of type {}",
+                      to_string(parent->GetProtocol())));
+    }
+    wire_offsets_.push_back(parents_.size());
+    for (const auto& wire : parent->GetWires()) parents_.emplace_back(wire);
+  }
+  wire_offsets_.push_back(parents_.size());
+
+  output_wires_.reserve(parents_.size());
+  for (const auto& wire : parents_) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, wire->GetNumberOfSimdValues()));
+  }
+
+  output_message_futures_ =
+      RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                      communication::MessageType::kOutputMessage, gate_id_);
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Created a BooleanGMW RevealGate with id#{} for {} shares",
+                                     gate_id_, parents.size()));
+  }
+}
+
+void RevealGate::EvaluateOnline() {
+  auto& communication_layer = GetCommunicationLayer();
+
+  // the shares of all wires are sent in a single message
+  BitVector<> values;
+  for (const auto& wire : parents_) {
+    auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(wire);
+    assert(gmw_wire);
+    gmw_wire->GetIsReadyCondition().Wait();
+    values.Append(gmw_wire->GetValues());
+  }
+  const auto king{GetOpeningKing(gate_id_)};
+  SendShareOfOpening(communication_layer, king, communication::MessageType::kOutputMessage,
+                     gate_id_, AsBytes(values));
+
+  if (ReceivesOpenedValue(communication_layer, king)) {
+    CopyOpenedBits(communication::MessageType::kOutputMessage, gate_id_,
+                   output_message_futures_.at(0).get(), values);
+  } else {
+    for (auto& future : output_message_futures_) {
+      XorMaskedBits(communication::MessageType::kOutputMessage, gate_id_, future.get(), values);
+    }
+    FinishOpening(communication_layer, king, communication::MessageType::kOutputMessage, gate_id_,
+                  AsBytes(values));
+  }
+
+  std::size_t offset = 0;
+  for (auto& wire : output_wires_) {
+    auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(wire);
+    assert(gmw_wire);
+    const auto number_of_simd{gmw_wire->GetNumberOfSimdValues()};
+    gmw_wire->GetMutableValues() = values.Subset(offset, offset + number_of_simd);
+    offset += number_of_simd;
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format("Evaluated Boolean RevealGate with id#{}", gate_id_));
+  }
+}
+
+std::vector<motion::SharePointer> RevealGate::GetOutputAsShares() const {
+  std::vector<motion::SharePointer> outputs;
+  outputs.reserve(wire_offsets_.size() - 1);
+  for (std::size_t i = 0; i + 1 < wire_offsets_.size(); ++i) {
+    std::vector<motion::WirePointer> wires(output_wires_.begin() + wire_offsets_[i],
+                                           output_wires_.begin() + wire_offsets_[i + 1]);
+    outputs.emplace_back(std::make_shared<boolean_gmw::Share>(wires));
+  }
+  return outputs;
+}
+
 XorGate::XorGate(const motion::SharePointer& a, const motion::SharePointer& b)
     : TwoGate(a->GetBackend()) {
   parent_a_ = a->GetWires();
@@ -381,11 +564,9 @@ void XorGate::EvaluateOnline() {
     assert(wire_a);
     assert(wire_b);
 
-    auto output = wire_a->GetValues() ^ wire_b->GetValues();
-
     auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
     assert(gmw_wire);
-    gmw_wire->GetMutableValues() = std::move(output);
+    XorInto(gmw_wire->GetMutableValues(), wire_a->GetValues(), wire_b->GetValues());
     assert(gmw_wire->GetValues().GetSize() == parent_a_.at(0)->GetNumberOfSimdValues());
   }
 
@@ -464,6 +645,22 @@ const motion::SharePointer InvGate::GetOutputAsShare() const {
   return result;
 }
 
+// Opens the masked inputs of a Beaver multiplication in values, see protocols/opening.h
+static void OpenMaskedBits(
+    communication::CommunicationLayer& communication_layer, std::optional<std::size_t> king,
+    communication::MessageType message_type, std::size_t message_id, BitVector<>& values,
+    std::vector<ReusableFiberFuture<communication::MessageBuffer>>& opening_futures) {
+  SendShareOfOpening(communication_layer, king, message_type, message_id, AsBytes(values));
+  if (ReceivesOpenedValue(communication_layer, king)) {
+    CopyOpenedBits(message_type, message_id, opening_futures.at(0).get(), values);
+    return;
+  }
+  for (auto& future : opening_futures) {
+    XorMaskedBits(message_type, message_id, future.get(), values);
+  }
+  FinishOpening(communication_layer, king, message_type, message_id, AsBytes(values));
+}
+
 AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
     : TwoGate(a->GetBackend()) {
   parent_a_ = a->GetWires();
@@ -476,25 +673,6 @@ AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
   auto number_of_wires = parent_a_.size();
   auto number_of_simd_values = a->GetNumberOfSimdValues();
 
-  std::vector<motion::WirePointer> dummy_wires_e(number_of_wires), dummy_wires_d(number_of_wires);
-
-  auto& _register = GetRegister();
-
-  for (auto& w : dummy_wires_d) {
-    w = _register.EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_values);
-  }
-
-  for (auto& w : dummy_wires_e) {
-    w = _register.EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_values);
-  }
-
-  // TODO: replace Gate objects with Futures from CommunicationManager
-  d_ = std::make_shared<boolean_gmw::Share>(dummy_wires_d);
-  e_ = std::make_shared<boolean_gmw::Share>(dummy_wires_e);
-
-  d_output_ = _register.EmplaceGate<OutputGate>(d_);
-  e_output_ = _register.EmplaceGate<OutputGate>(e_);
-
   // create output wires
   output_wires_.reserve(number_of_wires);
   for (size_t i = 0; i < number_of_wires; ++i) {
@@ -502,9 +680,12 @@ AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
         GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_values));
   }
 
-  auto& mt_provider = backend_.GetMtProvider();
   mt_bitlen_ = parent_a_.size() * parent_a_.at(0)->GetNumberOfSimdValues();
-  mt_offset_ = mt_provider.RequestBinaryMts(mt_bitlen_);
+  GetRegister().RunInConstructionOrder(
+      *this, [this] { mt_offset_ = GetMtProvider().RequestBinaryMts(mt_bitlen_); });
+
+  opening_futures_ = RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                                     communication::MessageType::kBeaverOpening, gate_id_);
 
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {}, parents: {}, {}", gate_id_,
@@ -516,7 +697,7 @@ AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
 
 void AndGate::EvaluateSetup() {}
 
-void AndGate::EvaluateOnline() {
+GateTask AndGate::EvaluateOnlineCoroutine() {
   // nothing to setup, no need to wait/check
   for (auto& wire : parent_a_) {
     wire->GetIsReadyCondition().Wait();
@@ -527,74 +708,77 @@ void AndGate::EvaluateOnline() {
   }
 
   auto& mt_provider = GetMtProvider();
-  mt_provider.WaitFinished();
-  const auto& mts = mt_provider.GetBinaryAll();
-
-  auto& d_mutable_wires = d_->GetMutableWires();
-  for (auto i = 0ull; i < d_mutable_wires.size(); ++i) {
-    auto d = std::dynamic_pointer_cast<boolean_gmw::Wire>(d_mutable_wires.at(i));
-    const auto x = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_a_.at(i));
-    assert(d);
-    assert(x);
-    d->GetMutableValues() = mts.a.Subset(mt_offset_ + i * x->GetNumberOfSimdValues(),
-                                         mt_offset_ + (i + 1) * x->GetNumberOfSimdValues());
-    d->GetMutableValues() ^= x->GetValues();
-    d->SetOnlineFinished();
-  }
-
-  auto& e_mutable_wires = e_->GetMutableWires();
-  for (auto i = 0ull; i < e_mutable_wires.size(); ++i) {
-    auto e = std::dynamic_pointer_cast<boolean_gmw::Wire>(e_mutable_wires.at(i));
-    const auto y = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_b_.at(i));
-    assert(e);
-    assert(y);
-    e->GetMutableValues() = mts.b.Subset(mt_offset_ + i * y->GetNumberOfSimdValues(),
-                                         mt_offset_ + (i + 1) * y->GetNumberOfSimdValues());
-    e->GetMutableValues() ^= y->GetValues();
-    e->SetOnlineFinished();
-  }
-
-  d_output_->WaitOnline();
-  e_output_->WaitOnline();
-
-  const auto& d_clear = d_output_->GetOutputWires();
-  const auto& e_clear = e_output_->GetOutputWires();
-
-  for (auto& wire : d_clear) {
-    wire->GetIsReadyCondition().Wait();
+  // only waits for the MTs of this gate, the remaining ones may still be computed
+  const auto mts = mt_provider.GetBinaryView(mt_offset_, mt_bitlen_);
+
+  // [d || e] = [a || b] ^ [x || y] of all wires is opened in one message
+  BitVector<> inputs;
+  for (const auto& wire : parent_a_) {
+    inputs.Append(std::dynamic_pointer_cast<const boolean_gmw::Wire>(wire)->GetValues());
   }
-  for (auto& wire : e_clear) {
-    wire->GetIsReadyCondition().Wait();
+  for (const auto& wire : parent_b_) {
+    inputs.Append(std::dynamic_pointer_cast<const boolean_gmw::Wire>(wire)->GetValues());
   }
+  const std::size_t number_of_threads{GetNumberOfParallelThreads(mt_bitlen_)};
+  openings_ = mts.SubsetA(0, mt_bitlen_);
+  openings_.Append(mts.SubsetB(0, mt_bitlen_));
+  // both are [a || b] of all wires with the same layout
+  XorBytesInto(openings_, inputs.GetData().data(), number_of_threads);
 
-  for (auto i = 0ull; i < d_clear.size(); ++i) {
-    const auto d_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(d_clear.at(i));
+  auto& communication_layer = GetCommunicationLayer();
+  const auto king{GetOpeningKing(gate_id_)};
+  SendShareOfOpening(communication_layer, king, communication::MessageType::kBeaverOpening,
+                     gate_id_, AsBytes(openings_));
+  if (ReceivesOpenedValue(communication_layer, king)) {
+    CopyOpenedBits(communication::MessageType::kBeaverOpening, gate_id_,
+                   co_await opening_futures_.at(0), openings_);
+  } else {
+    for (auto& future : opening_futures_) {
+      XorMaskedBits(communication::MessageType::kBeaverOpening, gate_id_, co_await future,
+                    openings_, number_of_threads);
+    }
+    FinishOpening(communication_layer, king, communication::MessageType::kBeaverOpening, gate_id_,
+                  AsBytes(openings_));
+  }
+
+  const bool xors_product{communication_layer.GetMyId() ==
+                          (gate_id_ % communication_layer.GetNumberOfParties())};
+  const auto number_of_simd_values{parent_a_.at(0)->GetNumberOfSimdValues()};
+  for (auto i = 0ull; i < parent_a_.size(); ++i) {
     const auto x_i_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_a_.at(i));
-    const auto e_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(e_clear.at(i));
     const auto y_i_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_b_.at(i));
 
-    assert(d_w);
     assert(x_i_w);
-    assert(e_w);
     assert(y_i_w);
 
     auto output = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
     assert(output);
     output->GetMutableValues() =
-        mts.c.Subset(mt_offset_ + i * parent_a_.at(0)->GetNumberOfSimdValues(),
-                     mt_offset_ + (i + 1) * parent_a_.at(0)->GetNumberOfSimdValues());
+        mts.SubsetC(i * number_of_simd_values, (i + 1) * number_of_simd_values);
 
-    const auto& d = d_w->GetValues();
+    const auto d{openings_.Subset(i * number_of_simd_values, (i + 1) * number_of_simd_values)};
     const auto& x_i = x_i_w->GetValues();
-    const auto& e = e_w->GetValues();
+    const auto e{openings_.Subset(mt_bitlen_ + i * number_of_simd_values,
+                                  mt_bitlen_ + (i + 1) * number_of_simd_values)};
     const auto& y_i = y_i_w->GetValues();
 
-    if (GetCommunicationLayer().GetMyId() ==
-        (gate_id_ % GetCommunicationLayer().GetNumberOfParties())) {
-      output->GetMutableValues() ^= (d & y_i) ^ (e & x_i) ^ (e & d);
-    } else {
-      output->GetMutableValues() ^= (d & y_i) ^ (e & x_i);
-    }
+    // the bytes of the SIMD values are split into ranges of whole bytes
+    auto& output_values{output->GetMutableValues()};
+    ParallelForRanges(
+        BitsToBytes(number_of_simd_values), number_of_threads, 1,
+        [&](std::size_t begin, std::size_t end) {
+          const std::size_t bit_size{std::min(number_of_simd_values, 8 * end) - 8 * begin};
+          const auto range = [begin, bit_size](const BitVector<>& values) {
+            return BitSpan(const_cast<std::byte*>(values.GetData().data()) + begin, bit_size);
+          };
+          auto output_range{range(output_values)};
+          if (xors_product) {
+            XorAndInto(output_range, range(d), range(y_i), range(e), range(x_i), range(e),
+                       range(d));
+          } else {
+            XorAndInto(output_range, range(d), range(y_i), range(e), range(x_i));
+          }
+        });
   }
 
   if constexpr (kVerboseDebug) {
@@ -614,6 +798,481 @@ const motion::SharePointer AndGate::GetOutputAsShare() const {
   return result;
 }
 
+MultiInputAndGate::MultiInputAndGate(std::span<const motion::SharePointer> inputs)
+    : NInputGate(inputs.front()->GetBackend()),
+      number_of_inputs_(inputs.size()),
+      number_of_wires_(inputs.front()->GetBitLength()),
+      number_of_simd_(inputs.front()->GetNumberOfSimdValues()),
+      input_bitlen_(number_of_wires_ * number_of_simd_) {
+  if (number_of_inputs_ < 2 || number_of_inputs_ > kMaxMultiplicationFanIn) {
+    throw std::invalid_argument(fmt::format("Multi-input AND gates have 2 to {} inputs, got {}",
+                                            kMaxMultiplicationFanIn, number_of_inputs_));
+  }
+  for (const auto& input : inputs) {
+    if (input->GetBitLength() != number_of_wires_ ||
+        input->GetNumberOfSimdValues() != number_of_simd_) {
+      throw std::invalid_argument(fmt::format(
+          "Inputs of a multi-input AND gate have {} and {} wires with {} and {} SIMD values",
+          number_of_wires_, input->GetBitLength(), number_of_simd_,
+          input->GetNumberOfSimdValues()));
+    }
+    // the wires of input i are parents_[i * number_of_wires_, (i + 1) * number_of_wires_)
+    for (const auto& wire : input->GetWires()) parents_.emplace_back(wire);
+  }
+
+  const std::size_t number_of_subsets{std::size_t(1) << number_of_inputs_};
+  mask_products_.resize(number_of_subsets);
+
+  // the setup phase computes the products of the subsets of size 2, ..., k in one round each
+  auto& communication_layer = GetCommunicationLayer();
+  for (std::size_t round = 0; round + 1 < number_of_inputs_; ++round) {
+    const std::size_t message_id{gate_id_ * kMaxMultiplicationFanIn + round};
+    setup_futures_.emplace_back(RegisterOpening(communication_layer, GetOpeningKing(message_id),
+                                                communication::MessageType::kMultiInputMaskProducts,
+                                                message_id));
+  }
+  opening_futures_ = RegisterOpening(communication_layer, GetOpeningKing(gate_id_),
+                                     communication::MessageType::kBeaverOpening, gate_id_);
+
+  output_wires_.reserve(number_of_wires_);
+  for (std::size_t i = 0; i < number_of_wires_; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_));
+  }
+
+  // one triple per bit for every subset with at least two elements
+  number_of_mts_ = (number_of_subsets - number_of_inputs_ - 1) * input_bitlen_;
+  GetRegister().RunInConstructionOrder(
+      *this, [this] { mt_offset_ = GetMtProvider().RequestBinaryMts(number_of_mts_); });
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, {} inputs with {} wires", gate_id_,
+                                 number_of_inputs_, number_of_wires_);
+    GetLogger().LogDebug(fmt::format(
+        "Created a BooleanGMW multi-input AND gate with following properties: {}", gate_info));
+  }
+}
+
+void MultiInputAndGate::EvaluateSetup() {
+  const std::size_t l{input_bitlen_};
+  const std::size_t number_of_subsets{std::size_t(1) << number_of_inputs_};
+
+  // the masks a_i of the inputs are the products of the singletons
+  for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+    mask_products_[std::size_t(1) << i] = BitVector<>::SecureRandom(l);
+  }
+
+  auto& communication_layer = GetCommunicationLayer();
+  const bool xors_product{communication_layer.GetMyId() ==
+                          gate_id_ % communication_layer.GetNumberOfParties()};
+  const auto mts = GetMtProvider().GetBinaryView(mt_offset_, number_of_mts_);
+  std::size_t mt_index{0};
+  std::vector<std::size_t> subsets;
+  for (std::size_t size = 2; size <= number_of_inputs_; ++size) {
+    // a_S = a_{S \ {j}} & a_j for the largest element j of S
+    subsets.clear();
+    for (std::size_t subset = 1; subset < number_of_subsets; ++subset) {
+      if (static_cast<std::size_t>(std::popcount(subset)) == size) subsets.emplace_back(subset);
+    }
+    const std::size_t m{subsets.size() * l};
+    BitVector<> masked_factors, masked_second_factors;
+    for (std::size_t s = 0; s < subsets.size(); ++s) {
+      const std::size_t largest{std::size_t(1) << (std::bit_width(subsets[s]) - 1)};
+      const std::size_t begin{mt_index + s * l};
+      auto masked_factor{mts.SubsetA(begin, begin + l)};
+      masked_factor ^= mask_products_[subsets[s] ^ largest];
+      masked_factors.Append(masked_factor);
+      auto masked_second_factor{mts.SubsetB(begin, begin + l)};
+      masked_second_factor ^= mask_products_[largest];
+      masked_second_factors.Append(masked_second_factor);
+    }
+    masked_factors.Append(masked_second_factors);
+    const std::size_t message_id{gate_id_ * kMaxMultiplicationFanIn + size - 2};
+    OpenMaskedBits(communication_layer, GetOpeningKing(message_id),
+                   communication::MessageType::kMultiInputMaskProducts, message_id, masked_factors,
+                   setup_futures_.at(size - 2));
+    for (std::size_t s = 0; s < subsets.size(); ++s) {
+      const std::size_t largest{std::size_t(1) << (std::bit_width(subsets[s]) - 1)};
+      const std::size_t begin{mt_index + s * l};
+      const auto& x{mask_products_[subsets[s] ^ largest]};
+      const auto& y{mask_products_[largest]};
+      const auto d{masked_factors.Subset(s * l, (s + 1) * l)};
+      const auto e{masked_factors.Subset(m + s * l, m + (s + 1) * l)};
+      auto product{mts.SubsetC(begin, begin + l)};
+      if (xors_product) {
+        XorAndInto(product, d, y, e, x, d, e);
+      } else {
+        XorAndInto(product, d, y, e, x);
+      }
+      mask_products_[subsets[s]] = std::move(product);
+    }
+    mt_index += m;
+  }
+  assert(mt_index == number_of_mts_);
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace(
+        fmt::format("Evaluated setup of BooleanGMW multi-input AND Gate with id#{}", gate_id_));
+  }
+}
+
+void MultiInputAndGate::EvaluateOnline() {
+  WaitSetup();
+  for (auto& wire : parents_) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  const std::size_t l{input_bitlen_};
+  BitVector<> inputs;
+  for (const auto& wire : parents_) {
+    inputs.Append(std::dynamic_pointer_cast<const boolean_gmw::Wire>(wire)->GetValues());
+  }
+  openings_ = BitVector<>();
+  for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+    openings_.Append(mask_products_[std::size_t(1) << i]);
+  }
+  openings_ ^= inputs;
+  auto& communication_layer = GetCommunicationLayer();
+  OpenMaskedBits(communication_layer, GetOpeningKing(gate_id_),
+                 communication::MessageType::kBeaverOpening, gate_id_, openings_,
+                 opening_futures_);
+
+  // products of the opened d_i of all subsets
+  const std::size_t number_of_subsets{std::size_t(1) << number_of_inputs_};
+  const std::size_t all_inputs{number_of_subsets - 1};
+  std::vector<BitVector<>> opened_products(number_of_subsets);
+  opened_products[0] = BitVector<>(l, true);
+  for (std::size_t subset = 1; subset < number_of_subsets; ++subset) {
+    const std::size_t lowest = std::countr_zero(subset);
+    AndInto(opened_products[subset], opened_products[subset & (subset - 1)],
+            openings_.Subset(lowest * l, (lowest + 1) * l));
+  }
+  const bool xors_product{communication_layer.GetMyId() ==
+                          gate_id_ % communication_layer.GetNumberOfParties()};
+  BitVector<> output{xors_product ? opened_products[all_inputs] : BitVector<>(l)};
+  for (std::size_t subset = 1; subset < number_of_subsets; ++subset) {
+    XorAndInto(output, mask_products_[subset], opened_products[all_inputs ^ subset]);
+  }
+
+  for (std::size_t i = 0; i < number_of_wires_; ++i) {
+    auto wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
+    assert(wire);
+    wire->GetMutableValues() = output.Subset(i * number_of_simd_, (i + 1) * number_of_simd_);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace(
+        fmt::format("Evaluated BooleanGMW multi-input AND Gate with id#{}", gate_id_));
+  }
+}
+
+const boolean_gmw::SharePointer MultiInputAndGate::GetOutputAsGmwShare() const {
+  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer MultiInputAndGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
+InnerProductGate::InnerProductGate(std::span<const motion::SharePointer> a,
+                                   std::span<const motion::SharePointer> b)
+    : NInputGate(a.front()->GetBackend()),
+      number_of_terms_(a.size()),
+      number_of_wires_(a.front()->GetBitLength()),
+      number_of_simd_(a.front()->GetNumberOfSimdValues()),
+      input_bitlen_(number_of_wires_ * number_of_simd_) {
+  if (b.size() != number_of_terms_) {
+    throw std::invalid_argument(fmt::format(
+        "Inner product of vectors with {} and {} shares", number_of_terms_, b.size()));
+  }
+  // the wires of a_i are parents_[i * number_of_wires_, (i + 1) * number_of_wires_), followed by
+  // the wires of b_1, ..., b_n
+  for (const auto& inputs : {a, b}) {
+    for (const auto& input : inputs) {
+      if (input->GetBitLength() != number_of_wires_ ||
+          input->GetNumberOfSimdValues() != number_of_simd_) {
+        throw std::invalid_argument(fmt::format(
+            "Inputs of an inner product gate have {} and {} wires with {} and {} SIMD values",
+            number_of_wires_, input->GetBitLength(), number_of_simd_,
+            input->GetNumberOfSimdValues()));
+      }
+      for (const auto& wire : input->GetWires()) parents_.emplace_back(wire);
+    }
+  }
+
+  output_wires_.reserve(number_of_wires_);
+  for (std::size_t i = 0; i < number_of_wires_; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_));
+  }
+
+  number_of_mts_ = number_of_terms_ * input_bitlen_;
+  GetRegister().RunInConstructionOrder(
+      *this, [this] { mt_offset_ = GetMtProvider().RequestBinaryMts(number_of_mts_); });
+
+  opening_futures_ = RegisterOpening(GetCommunicationLayer(), GetOpeningKing(gate_id_),
+                                     communication::MessageType::kBeaverOpening, gate_id_);
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+        fmt::format("Created a BooleanGMW inner product gate with id#{} of {} terms", gate_id_,
+                    number_of_terms_));
+  }
+}
+
+void InnerProductGate::EvaluateOnline() {
+  for (auto& wire : parents_) {
+    wire->GetIsReadyCondition().Wait();
+  }
+  const auto mts = GetMtProvider().GetBinaryView(mt_offset_, number_of_mts_);
+
+  // [d_1 || ... || e_n] = [a_1 || ... || b_n] ^ [x_1 || ... || y_n]
+  BitVector<> inputs;
+  for (const auto& wire : parents_) {
+    inputs.Append(std::dynamic_pointer_cast<const boolean_gmw::Wire>(wire)->GetValues());
+  }
+  openings_ = mts.SubsetA(0, number_of_mts_);
+  openings_.Append(mts.SubsetB(0, number_of_mts_));
+  openings_ ^= inputs;
+  auto& communication_layer = GetCommunicationLayer();
+  OpenMaskedBits(communication_layer, GetOpeningKing(gate_id_),
+                 communication::MessageType::kBeaverOpening, gate_id_, openings_,
+                 opening_futures_);
+
+  // XOR_i a_i & b_i = XOR_i z_i ^ (d_i & b_i) ^ (e_i & a_i) ^ (d_i & e_i)
+  const std::size_t l{input_bitlen_};
+  const bool xors_product{communication_layer.GetMyId() ==
+                          gate_id_ % communication_layer.GetNumberOfParties()};
+  BitVector<> output{mts.SubsetC(0, l)};
+  for (std::size_t i = 1; i < number_of_terms_; ++i) output ^= mts.SubsetC(i * l, (i + 1) * l);
+  for (std::size_t i = 0; i < number_of_terms_; ++i) {
+    const auto d{openings_.Subset(i * l, (i + 1) * l)};
+    const auto e{openings_.Subset(number_of_mts_ + i * l, number_of_mts_ + (i + 1) * l)};
+    const auto a{inputs.Subset(i * l, (i + 1) * l)};
+    const auto b{inputs.Subset(number_of_mts_ + i * l, number_of_mts_ + (i + 1) * l)};
+    if (xors_product) {
+      XorAndInto(output, d, b, e, a, d, e);
+    } else {
+      XorAndInto(output, d, b, e, a);
+    }
+  }
+
+  for (std::size_t i = 0; i < number_of_wires_; ++i) {
+    auto wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
+    assert(wire);
+    wire->GetMutableValues() = output.Subset(i * number_of_simd_, (i + 1) * number_of_simd_);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace(
+        fmt::format("Evaluated BooleanGMW inner product Gate with id#{}", gate_id_));
+  }
+}
+
+const boolean_gmw::SharePointer InnerProductGate::GetOutputAsGmwShare() const {
+  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer InnerProductGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
+// the message id of the openings of layer > 0 of a CircuitGate
+static std::size_t CircuitLayerMessageId(std::size_t gate_id, std::size_t layer) {
+  assert(layer < (std::size_t(1) << 32));
+  return (gate_id << 32) | layer;
+}
+
+CircuitGate::CircuitGate(const motion::SharePointer& input, const AlgorithmDescription& algorithm)
+    : CircuitGate(input, std::make_shared<const FlatCircuit>(
+                             FlatCircuit::FromAlgorithmDescription(algorithm))) {}
+
+CircuitGate::CircuitGate(const motion::SharePointer& input,
+                         std::shared_ptr<const FlatCircuit> circuit)
+    : NInputGate(input->GetBackend()),
+      circuit_(std::move(circuit)),
+      number_of_simd_(input->GetNumberOfSimdValues()) {
+  parents_ = input->GetWires();
+
+  if (parents_.size() != circuit_->number_of_input_wires) {
+    throw std::invalid_argument(
+        fmt::format("CircuitGate: expected a share of bit length {}, got a share of bit length {}",
+                    circuit_->number_of_input_wires, parents_.size()));
+  }
+
+  const std::size_t number_of_layers{circuit_->GetNumberOfLayers()};
+  number_of_mts_ = circuit_->number_of_interactive_operations * number_of_simd_;
+  GetRegister().RunInConstructionOrder(
+      *this, [this] { mt_offset_ = GetMtProvider().RequestBinaryMts(number_of_mts_); });
+  std::size_t mt_begin{0};
+  mt_begins_.resize(number_of_layers);
+  or_masks_.resize(number_of_layers);
+  opening_futures_.resize(number_of_layers);
+  for (std::size_t l = 1; l < number_of_layers; ++l) {
+    mt_begins_[l] = mt_begin;
+    const std::size_t number_of_operations{circuit_->GetNumberOfInteractiveOperations(l)};
+    mt_begin += number_of_operations * number_of_simd_;
+    for (std::size_t j = 0; j < number_of_operations; ++j) {
+      if (circuit_->opcodes[circuit_->layer_begins[l] + j] != FlatCircuit::Opcode::kOr) continue;
+      if (or_masks_[l].Empty()) or_masks_[l] = BitVector<>(number_of_operations * number_of_simd_);
+      for (std::size_t k = 0; k < number_of_simd_; ++k) {
+        or_masks_[l].Set(true, j * number_of_simd_ + k);
+      }
+    }
+    const std::size_t message_id{CircuitLayerMessageId(gate_id_, l)};
+    opening_futures_[l] =
+        RegisterOpening(GetCommunicationLayer(), GetOpeningKing(message_id),
+                        communication::MessageType::kCircuitLayerOpening, message_id);
+  }
+
+  output_wires_.reserve(circuit_->number_of_output_wires);
+  for (std::size_t i = 0; i < circuit_->number_of_output_wires; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_));
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+        fmt::format("Created a BooleanGMW circuit gate with id#{} of {} operations in {} layers",
+                    gate_id_, circuit_->GetNumberOfOperations(), number_of_layers));
+  }
+}
+
+void CircuitGate::EvaluateSetup() {}
+
+void CircuitGate::EvaluateOnline() {
+  const FlatCircuit& circuit{*circuit_};
+  // the packed SIMD values of wire w are values[w * stride, (w + 1) * stride), whose padding bits
+  // stay 0
+  const std::size_t stride{BitsToBytes(number_of_simd_)};
+  std::vector<std::byte> values(circuit.number_of_wires * stride);
+  const auto row{[&values, stride](std::size_t wire) { return values.data() + wire * stride; }};
+  for (std::size_t i = 0; i < parents_.size(); ++i) {
+    auto wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parents_.at(i));
+    assert(wire);
+    wire->GetIsReadyCondition().Wait();
+    std::copy_n(wire->GetValues().GetData().data(), stride, row(i));
+  }
+  // the mask of INV, whose padding bits are 0
+  std::vector<std::byte> ones(stride, std::byte(0xFF));
+  if (number_of_simd_ % 8 != 0) ones.back() = std::byte((1u << (number_of_simd_ % 8)) - 1);
+
+  // copies the SIMD values of the wires into the bits [i * simd, (i + 1) * simd) of bits and back
+  const auto gather{[&](std::span<const std::uint32_t> wires, BitVector<>& bits,
+                        std::size_t offset) {
+    for (std::size_t i = 0; i < wires.size(); ++i) {
+      const std::size_t position{offset + i * number_of_simd_};
+      if (position % 8 == 0) {
+        std::copy_n(row(wires[i]), stride, bits.GetMutableData().data() + position / 8);
+      } else {
+        const std::byte* source{row(wires[i])};
+        for (std::size_t k = 0; k < number_of_simd_; ++k) {
+          if (bool((source[k / 8] >> (k % 8)) & std::byte(1))) bits.Set(true, position + k);
+        }
+      }
+    }
+  }};
+  const auto scatter{[&](const BitVector<>& bits, std::span<const std::uint32_t> wires) {
+    for (std::size_t i = 0; i < wires.size(); ++i) {
+      const std::size_t position{i * number_of_simd_};
+      std::byte* destination{row(wires[i])};
+      if (position % 8 == 0) {
+        std::copy_n(bits.GetData().data() + position / 8, stride, destination);
+        // the last byte also contains the bits of the next wire
+        destination[stride - 1] &= ones.back();
+      } else {
+        for (std::size_t k = 0; k < number_of_simd_; ++k) {
+          if (bits.Get(position + k)) destination[k / 8] |= std::byte(1) << (k % 8);
+        }
+      }
+    }
+  }};
+
+  auto& communication_layer = GetCommunicationLayer();
+  const bool is_designated{communication_layer.GetMyId() ==
+                           (gate_id_ % communication_layer.GetNumberOfParties())};
+  for (std::size_t l = 0; l < circuit.GetNumberOfLayers(); ++l) {
+    const std::size_t begin{circuit.layer_begins[l]}, local_begin{circuit.local_begins[l]},
+        end{circuit.layer_begins[l + 1]};
+    if (local_begin > begin) {
+      // [d || e] = [a || b] ^ [x || y] of all operations of the layer is opened in one message
+      const std::size_t number_of_operations{local_begin - begin};
+      const std::size_t n{number_of_operations * number_of_simd_};
+      const std::span<const std::uint32_t> parents_a(circuit.parents_a.data() + begin,
+                                                     number_of_operations);
+      const std::span<const std::uint32_t> parents_b(circuit.parents_b.data() + begin,
+                                                     number_of_operations);
+      BitVector<> inputs(2 * n);
+      gather(parents_a, inputs, 0);
+      gather(parents_b, inputs, n);
+      const auto mts{GetMtProvider().GetBinaryView(mt_offset_ + mt_begins_[l], n)};
+      BitVector<> openings{mts.SubsetA(0, n)};
+      openings.Append(mts.SubsetB(0, n));
+      openings ^= inputs;
+      const std::size_t message_id{CircuitLayerMessageId(gate_id_, l)};
+      OpenMaskedBits(communication_layer, GetOpeningKing(message_id),
+                     communication::MessageType::kCircuitLayerOpening, message_id, openings,
+                     opening_futures_[l]);
+
+      const auto x{inputs.Subset(0, n)}, y{inputs.Subset(n, 2 * n)};
+      const auto d{openings.Subset(0, n)}, e{openings.Subset(n, 2 * n)};
+      auto products{mts.SubsetC(0, n)};
+      if (is_designated) {
+        XorAndInto(products, d, y, e, x, d, e);
+      } else {
+        XorAndInto(products, d, y, e, x);
+      }
+      // x | y = x ^ y ^ (x & y)
+      if (!or_masks_[l].Empty()) XorAndInto(products, x, or_masks_[l], y, or_masks_[l]);
+      scatter(products, std::span<const std::uint32_t>(circuit.outputs.data() + begin,
+                                                       number_of_operations));
+    }
+    for (std::size_t i = local_begin; i < end; ++i) {
+      const std::byte* a{row(circuit.parents_a[i])};
+      std::byte* output{row(circuit.outputs[i])};
+      if (circuit.opcodes[i] == FlatCircuit::Opcode::kXor) {
+        const std::byte* b{row(circuit.parents_b[i])};
+        for (std::size_t k = 0; k < stride; ++k) output[k] = a[k] ^ b[k];
+      } else if (is_designated) {
+        for (std::size_t k = 0; k < stride; ++k) output[k] = a[k] ^ ones[k];
+      } else {
+        std::copy_n(a, stride, output);
+      }
+    }
+  }
+
+  const std::size_t first_output_wire{circuit.number_of_wires - output_wires_.size()};
+  for (std::size_t i = 0; i < output_wires_.size(); ++i) {
+    auto output = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_[i]);
+    assert(output);
+    output->GetMutableValues() = BitVector<>(row(first_output_wire + i), number_of_simd_);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace(fmt::format("Evaluated BooleanGMW circuit gate with id#{}", gate_id_));
+  }
+}
+
+const boolean_gmw::SharePointer CircuitGate::GetOutputAsGmwShare() const {
+  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer CircuitGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
 MuxGate::MuxGate(const motion::SharePointer& a, const motion::SharePointer& b,
                  const motion::SharePointer& c)
     : ThreeGate(a->GetBackend()) {
@@ -645,12 +1304,15 @@ MuxGate::MuxGate(const motion::SharePointer& a, const motion::SharePointer& b,
   ot_sender_.resize(number_of_parties);
   ot_receiver_.resize(number_of_parties);
 
-  for (std::size_t i = 0; i < number_of_parties; ++i) {
-    if (i == my_id) continue;
-    ot_sender_.at(i) = GetOtProvider(i).RegisterSendXcOt(number_of_simd_values, number_of_bits);
-    ot_receiver_.at(i) =
-        GetOtProvider(i).RegisterReceiveXcOt(number_of_simd_values, number_of_bits);
-  }
+  GetRegister().RunInConstructionOrder(*this, [this, number_of_parties, my_id,
+                                               number_of_simd_values, number_of_bits] {
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      if (i == my_id) continue;
+      ot_sender_.at(i) = GetOtProvider(i).RegisterSendXcOt(number_of_simd_values, number_of_bits);
+      ot_receiver_.at(i) =
+          GetOtProvider(i).RegisterReceiveXcOt(number_of_simd_values, number_of_bits);
+    }
+  });
 
   if constexpr (kDebug) {
     auto gate_info =
@@ -697,7 +1359,8 @@ void MuxGate::EvaluateOnline() {
       a.Append(wire_a->GetValues()[simd_i]);
       b.Append(wire_b->GetValues()[simd_i]);
     }
-    xored_vector.emplace_back(a ^ b);
+    a ^= b;
+    xored_vector.emplace_back(std::move(a));
   }
   auto gmw_wire_selection_bits =
       std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_c_.at(0));
@@ -764,4 +1427,595 @@ const motion::SharePointer MuxGate::GetOutputAsShare() const {
   return result;
 }
 
+LookupTableGate::LookupTableGate(const motion::SharePointer& input,
+                                 std::span<const BitVector<>> table)
+    : NInputGate(input->GetBackend()), number_of_simd_(input->GetNumberOfSimdValues()) {
+  parents_ = input->GetWires();
+
+  const auto& communication_layer = GetCommunicationLayer();
+  if (communication_layer.GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("LookupTableGate: lookup tables of Boolean GMW shares need 2 parties, got {}",
+                    communication_layer.GetNumberOfParties()));
+  }
+  // the choice of the 1-out-of-N OT is one byte
+  const std::size_t input_bit_length{parents_.size()};
+  if (input_bit_length == 0 || input_bit_length > 8) {
+    throw std::invalid_argument(fmt::format(
+        "LookupTableGate: the input needs to have 1 to 8 bits, got {}", input_bit_length));
+  }
+  const std::size_t number_of_entries{std::size_t(1) << input_bit_length};
+  if (table.size() != number_of_entries) {
+    throw std::invalid_argument(
+        fmt::format("LookupTableGate: a table of a {}-bit input needs {} entries, got {}",
+                    input_bit_length, number_of_entries, table.size()));
+  }
+  output_bit_length_ = table.front().GetSize();
+  table_.Reserve(number_of_entries * output_bit_length_);
+  for (const auto& entry : table) {
+    if (entry.GetSize() != output_bit_length_ || output_bit_length_ == 0) {
+      throw std::invalid_argument(fmt::format(
+          "LookupTableGate: the entries need to have the same non-zero number of bits, got {} and "
+          "{}",
+          output_bit_length_, entry.GetSize()));
+    }
+    table_.Append(entry);
+  }
+
+  output_wires_.reserve(output_bit_length_);
+  for (std::size_t i = 0; i < output_bit_length_; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_));
+  }
+
+  GetRegister().RunInConstructionOrder(*this, [this, number_of_entries] {
+    if (GetCommunicationLayer().GetMyId() == 0) {
+      ot_receiver_ = GetKk13OtProvider(1).RegisterReceiveGOt(number_of_simd_, output_bit_length_,
+                                                             number_of_entries);
+    } else {
+      ot_sender_ = GetKk13OtProvider(0).RegisterSendGOt(number_of_simd_, output_bit_length_,
+                                                        number_of_entries);
+    }
+  });
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, {} to {} bits, parent: {}", gate_id_,
+                                 input_bit_length, output_bit_length_, parents_.at(0)->GetWireId());
+    GetLogger().LogDebug(fmt::format(
+        "Created a BooleanGMW LookupTableGate with following properties: {}", gate_info));
+  }
+}
+
+void LookupTableGate::EvaluateOnline() {
+  for (auto& wire : parents_) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  // the share of the table index of each SIMD value
+  std::vector<std::uint8_t> index_shares(number_of_simd_, 0);
+  for (std::size_t bit_i = 0; bit_i < parents_.size(); ++bit_i) {
+    auto wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parents_.at(bit_i));
+    assert(wire);
+    const auto& values{wire->GetValues()};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      if (values.Get(simd_i)) index_shares[simd_i] |= std::uint8_t(1) << bit_i;
+    }
+  }
+
+  // the output shares of all SIMD values, SIMD value i at [i * m, (i + 1) * m)
+  BitVector<> outputs;
+  if (ot_receiver_) {
+    ot_receiver_->WaitSetup();
+    ot_receiver_->SetChoices(std::move(index_shares));
+    ot_receiver_->SendCorrections();
+    ot_receiver_->ComputeOutputs();
+    outputs.Reserve(number_of_simd_ * output_bit_length_);
+    for (const auto& output : ot_receiver_->GetOutputs()) outputs.Append(output);
+  } else {
+    outputs = BitVector<>::SecureRandom(number_of_simd_ * output_bit_length_);
+    const std::size_t number_of_entries{std::size_t(1) << parents_.size()};
+    std::vector<BitVector<>> messages(number_of_simd_);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      const auto mask{outputs.Subset(simd_i * output_bit_length_,
+                                     (simd_i + 1) * output_bit_length_)};
+      messages[simd_i].Reserve(number_of_entries * output_bit_length_);
+      // party 0 with index share j obtains T[j ^ x_1] ^ r
+      for (std::size_t j = 0; j < number_of_entries; ++j) {
+        const std::size_t entry{j ^ index_shares[simd_i]};
+        messages[simd_i].Append(
+            table_.Subset(entry * output_bit_length_, (entry + 1) * output_bit_length_) ^ mask);
+      }
+    }
+    ot_sender_->WaitSetup();
+    ot_sender_->SetInputs(std::move(messages));
+    ot_sender_->SendMessages();
+  }
+
+  for (std::size_t bit_i = 0; bit_i < output_bit_length_; ++bit_i) {
+    auto wire_output = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(bit_i));
+    assert(wire_output);
+    BitVector<> values(number_of_simd_);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      values.Set(outputs.Get(simd_i * output_bit_length_ + bit_i), simd_i);
+    }
+    wire_output->GetMutableValues() = std::move(values);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace(fmt::format("Evaluated BooleanGMW LookupTableGate with id#{}", gate_id_));
+  }
+}
+
+const boolean_gmw::SharePointer LookupTableGate::GetOutputAsGmwShare() const {
+  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer LookupTableGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
+ObliviousReadGate::ObliviousReadGate(const motion::SharePointer& index,
+                                     const motion::SharePointer& elements,
+                                     std::size_t number_of_elements)
+    : NInputGate(index->GetBackend()),
+      number_of_elements_(number_of_elements),
+      index_bit_length_(index->GetBitLength()),
+      number_of_simd_(index->GetNumberOfSimdValues()) {
+  const auto& communication_layer = GetCommunicationLayer();
+  if (communication_layer.GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("ObliviousReadGate: oblivious reads need 2 parties, got {}",
+                    communication_layer.GetNumberOfParties()));
+  }
+  if (number_of_elements_ == 0 || elements->GetBitLength() % number_of_elements_ != 0 ||
+      elements->GetNumberOfSimdValues() != number_of_simd_) {
+    throw std::invalid_argument(fmt::format(
+        "ObliviousReadGate: cannot split {} wires of {} SIMD values into {} elements of {} SIMD "
+        "values",
+        elements->GetBitLength(), elements->GetNumberOfSimdValues(), number_of_elements_,
+        number_of_simd_));
+  }
+  element_bit_length_ = elements->GetBitLength() / number_of_elements_;
+  // the 2^w entries of the padded array have to fit into memory
+  if (index_bit_length_ == 0 || index_bit_length_ > 32 ||
+      (std::size_t(1) << index_bit_length_) < number_of_elements_) {
+    throw std::invalid_argument(
+        fmt::format("ObliviousReadGate: a {}-bit index cannot address {} elements",
+                    index_bit_length_, number_of_elements_));
+  }
+  parents_ = index->GetWires();
+  const auto& element_wires{elements->GetWires()};
+  parents_.insert(parents_.end(), element_wires.begin(), element_wires.end());
+
+  const std::size_t first_digit_bit_length{(index_bit_length_ - 1) % 8 + 1};
+  digit_bit_lengths_.push_back(first_digit_bit_length);
+  for (std::size_t i = first_digit_bit_length; i < index_bit_length_; i += 8) {
+    digit_bit_lengths_.push_back(8);
+  }
+
+  output_wires_.reserve(element_bit_length_);
+  for (std::size_t i = 0; i < element_bit_length_; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_));
+  }
+
+  GetRegister().RunInConstructionOrder(*this, [this] {
+    auto& ot_provider{GetKk13OtProvider(1 - GetCommunicationLayer().GetMyId())};
+    std::size_t remaining_bit_length{index_bit_length_};
+    for (const std::size_t digit_bit_length : digit_bit_lengths_) {
+      remaining_bit_length -= digit_bit_length;
+      const std::size_t entry_bit_length{(std::size_t(1) << remaining_bit_length) *
+                                         element_bit_length_};
+      const std::size_t number_of_entries{std::size_t(1) << digit_bit_length};
+      ot_receivers_.emplace_back(
+          ot_provider.RegisterReceiveGOt(number_of_simd_, entry_bit_length, number_of_entries));
+      ot_senders_.emplace_back(
+          ot_provider.RegisterSendGOt(number_of_simd_, entry_bit_length, number_of_entries));
+    }
+  });
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, {} elements of {} bits, {}-bit index", gate_id_,
+                                 number_of_elements_, element_bit_length_, index_bit_length_);
+    GetLogger().LogDebug(fmt::format(
+        "Created a BooleanGMW ObliviousReadGate with following properties: {}", gate_info));
+  }
+}
+
+void ObliviousReadGate::EvaluateOnline() {
+  for (auto& wire : parents_) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  auto get_values = [this](std::size_t wire_i) -> const BitVector<>& {
+    auto wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parents_.at(wire_i));
+    assert(wire);
+    return wire->GetValues();
+  };
+  std::vector<std::uint64_t> index_shares(number_of_simd_, 0);
+  for (std::size_t bit_i = 0; bit_i < index_bit_length_; ++bit_i) {
+    const auto& values{get_values(bit_i)};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      if (values.Get(simd_i)) index_shares[simd_i] |= std::uint64_t(1) << bit_i;
+    }
+  }
+  // the shares of the padded arrays of all SIMD values, element j at [j * m, (j + 1) * m)
+  std::vector<BitVector<>> subarrays(
+      number_of_simd_, BitVector<>((std::size_t(1) << index_bit_length_) * element_bit_length_));
+  for (std::size_t bit_i = 0; bit_i < number_of_elements_ * element_bit_length_; ++bit_i) {
+    const auto& values{get_values(index_bit_length_ + bit_i)};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      if (values.Get(simd_i)) subarrays[simd_i].Set(true, bit_i);
+    }
+  }
+
+  std::size_t remaining_bit_length{index_bit_length_};
+  for (std::size_t digit_i = 0; digit_i < digit_bit_lengths_.size(); ++digit_i) {
+    remaining_bit_length -= digit_bit_lengths_[digit_i];
+    const std::size_t entry_bit_length{(std::size_t(1) << remaining_bit_length) *
+                                       element_bit_length_};
+    const std::size_t number_of_entries{std::size_t(1) << digit_bit_lengths_[digit_i]};
+    std::vector<std::uint8_t> digit_shares(number_of_simd_);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      digit_shares[simd_i] = static_cast<std::uint8_t>(
+          (index_shares[simd_i] >> remaining_bit_length) & (number_of_entries - 1));
+    }
+
+    auto& ot_receiver{ot_receivers_[digit_i]};
+    ot_receiver->WaitSetup();
+    ot_receiver->SetChoices(digit_shares);
+    ot_receiver->SendCorrections();
+
+    // the other party with digit share c obtains entry c ^ d of the subarray ^ r for our share d
+    std::vector<BitVector<>> masks(number_of_simd_), messages(number_of_simd_);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      masks[simd_i] = BitVector<>::SecureRandom(entry_bit_length);
+      messages[simd_i].Reserve(number_of_entries * entry_bit_length);
+      for (std::size_t c = 0; c < number_of_entries; ++c) {
+        const std::size_t entry{c ^ digit_shares[simd_i]};
+        messages[simd_i].Append(subarrays[simd_i].Subset(entry * entry_bit_length,
+                                                         (entry + 1) * entry_bit_length) ^
+                                masks[simd_i]);
+      }
+    }
+    auto& ot_sender{ot_senders_[digit_i]};
+    ot_sender->WaitSetup();
+    ot_sender->SetInputs(std::move(messages));
+    ot_sender->SendMessages();
+
+    ot_receiver->ComputeOutputs();
+    const auto outputs{ot_receiver->GetOutputs()};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      subarrays[simd_i] = outputs[simd_i] ^ masks[simd_i];
+    }
+  }
+
+  for (std::size_t bit_i = 0; bit_i < element_bit_length_; ++bit_i) {
+    auto wire_output = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(bit_i));
+    assert(wire_output);
+    BitVector<> values(number_of_simd_);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_; ++simd_i) {
+      values.Set(subarrays[simd_i].Get(bit_i), simd_i);
+    }
+    wire_output->GetMutableValues() = std::move(values);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace(
+        fmt::format("Evaluated BooleanGMW ObliviousReadGate with id#{}", gate_id_));
+  }
+}
+
+const boolean_gmw::SharePointer ObliviousReadGate::GetOutputAsGmwShare() const {
+  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer ObliviousReadGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
+// 1-out-of-16 random OTs on the 4-bit chunks of the 64-bit elements
+constexpr std::size_t kPsiChunkBitLength{4};
+constexpr std::size_t kPsiNumberOfMessages{std::size_t(1) << kPsiChunkBitLength};
+constexpr std::size_t kPsiNumberOfChunks{64 / kPsiChunkBitLength};
+// the OT messages of a bin are XORed and hashed to the OPRF value at the bin
+constexpr std::size_t kPsiMessageByteLength{16};
+constexpr std::size_t kPsiNumberOfHashFunctions{3};
+constexpr std::size_t kPsiMaxNumberOfEvictions{1000};
+constexpr std::size_t kPsiMaxNumberOfSalts{8};
+
+// 1.27 n bins for 3-way cuckoo hashing as in Pinkas et al. and a few more for small sets
+static std::size_t PsiNumberOfBins(std::size_t number_of_elements) {
+  return number_of_elements + (27 * number_of_elements + 99) / 100 + 16;
+}
+
+// the finalizer of SplitMix64, a bijection of the 64-bit values
+static std::uint64_t PsiMix(std::uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+// the public hash function k of the cuckoo table, which is chosen by the salt of the receiver
+static std::size_t PsiBin(std::uint64_t element, std::uint64_t salt, std::size_t k,
+                          std::size_t number_of_bins) {
+  return PsiMix(element ^ PsiMix(salt + k)) % number_of_bins;
+}
+
+// places the elements in the bins of the cuckoo table by a random walk, bins[b] is the index of
+// the element in bin b or set.size() for an empty bin and hash_indices[b] the hash function of the
+// element. Returns false if an element could not be placed after kPsiMaxNumberOfEvictions.
+static bool PsiCuckooHash(std::span<const std::uint64_t> set, std::uint64_t salt,
+                          std::vector<std::size_t>& bins, std::vector<std::uint8_t>& hash_indices) {
+  const std::size_t empty_bin{set.size()};
+  std::fill(bins.begin(), bins.end(), empty_bin);
+  std::minstd_rand random(static_cast<std::uint32_t>(salt));
+  for (std::size_t i = 0; i < set.size(); ++i) {
+    std::size_t element{i};
+    for (std::size_t evictions = 0;; ++evictions) {
+      std::array<std::size_t, kPsiNumberOfHashFunctions> candidates;
+      bool is_placed{false};
+      for (std::size_t k = 0; k < kPsiNumberOfHashFunctions && !is_placed; ++k) {
+        candidates[k] = PsiBin(set[element], salt, k, bins.size());
+        if (bins[candidates[k]] == empty_bin) {
+          bins[candidates[k]] = element;
+          hash_indices[candidates[k]] = static_cast<std::uint8_t>(k);
+          is_placed = true;
+        }
+      }
+      if (is_placed) break;
+      if (evictions == kPsiMaxNumberOfEvictions) return false;
+      // the evicted element is placed in one of its other bins next
+      const std::size_t k{random() % kPsiNumberOfHashFunctions};
+      std::swap(element, bins[candidates[k]]);
+      hash_indices[candidates[k]] = static_cast<std::uint8_t>(k);
+    }
+  }
+  return true;
+}
+
+static std::uint8_t PsiChunk(std::uint64_t element, std::size_t chunk_i) {
+  return (element >> (chunk_i * kPsiChunkBitLength)) & (kPsiNumberOfMessages - 1);
+}
+
+static __uint128_t PsiLoadMessage(const std::byte* bytes) {
+  __uint128_t message;
+  std::memcpy(&message, bytes, sizeof(message));
+  return message;
+}
+
+// the first 64 bits of TMMO of the XOR of the OT messages of bin b with the tweak 3 b + k, where
+// k keeps the values of an element that two hash functions map to the same bin distinct
+static std::uint64_t PsiOprfValue(const primitives::Prg& prg_fixed_key, __uint128_t messages_xor,
+                                  std::size_t bin, std::size_t hash_index) {
+  std::byte* block{reinterpret_cast<std::byte*>(&messages_xor)};
+  prg_fixed_key.Tmmo(&block, 1, bin * kPsiNumberOfHashFunctions + hash_index);
+  std::uint64_t value;
+  std::memcpy(&value, block, sizeof(value));
+  return value;
+}
+
+PsiGate::PsiGate(std::span<const std::uint64_t> set, std::size_t receiver_set_size,
+                 std::size_t sender_set_size, Backend& backend)
+    : NInputGate(backend),
+      set_(set.begin(), set.end()),
+      receiver_set_size_(receiver_set_size),
+      sender_set_size_(sender_set_size),
+      number_of_bins_(PsiNumberOfBins(receiver_set_size)) {
+  auto& communication_layer = GetCommunicationLayer();
+  if (communication_layer.GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("PsiGate: private set intersection needs 2 parties, got {}",
+                    communication_layer.GetNumberOfParties()));
+  }
+  const std::size_t my_id{communication_layer.GetMyId()};
+  const std::size_t my_set_size{my_id == 0 ? receiver_set_size_ : sender_set_size_};
+  if (receiver_set_size_ == 0 || set_.size() != my_set_size) {
+    throw std::invalid_argument(
+        fmt::format("PsiGate: party#{} needs a set of {} elements, got {}, and the receiver's set "
+                    "must not be empty",
+                    my_id, my_set_size, set_.size()));
+  }
+  std::vector<std::uint64_t> sorted_set(set_);
+  std::sort(sorted_set.begin(), sorted_set.end());
+  if (const auto duplicate{std::adjacent_find(sorted_set.begin(), sorted_set.end())};
+      duplicate != sorted_set.end()) {
+    throw std::invalid_argument(fmt::format(
+        "PsiGate: the set of party#{} contains the element {} twice", my_id, *duplicate));
+  }
+
+  output_wires_.emplace_back(
+      GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, receiver_set_size_));
+
+  auto& message_manager{communication_layer.GetMessageManager()};
+  if (my_id == 0) {
+    message_future_ = message_manager.RegisterReceive(
+        1, communication::MessageType::kPsiSenderValues, gate_id_);
+  } else {
+    message_future_ = message_manager.RegisterReceive(
+        0, communication::MessageType::kPsiOprfOffsets, gate_id_);
+  }
+
+  GetRegister().RunInConstructionOrder(*this, [this, my_id] {
+    const std::size_t number_of_ots{number_of_bins_ * kPsiNumberOfChunks};
+    if (my_id == 0) {
+      ot_receiver_ = GetKk13OtProvider(1).RegisterReceiveROt(
+          number_of_ots, 8 * kPsiMessageByteLength, kPsiNumberOfMessages);
+    } else {
+      ot_sender_ = GetKk13OtProvider(0).RegisterSendROt(number_of_ots, 8 * kPsiMessageByteLength,
+                                                        kPsiNumberOfMessages);
+    }
+  });
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, {} and {} elements, {} bins", gate_id_,
+                                 receiver_set_size_, sender_set_size_, number_of_bins_);
+    GetLogger().LogDebug(
+        fmt::format("Created a BooleanGMW PsiGate with following properties: {}", gate_info));
+  }
+}
+
+void PsiGate::EvaluateOnline() {
+  GetBaseProvider().WaitSetup();
+  if (GetCommunicationLayer().GetMyId() == 0) {
+    EvaluateReceiver();
+  } else {
+    EvaluateSender();
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace(fmt::format("Evaluated BooleanGMW PsiGate with id#{}", gate_id_));
+  }
+}
+
+void PsiGate::EvaluateReceiver() {
+  // a fresh salt is drawn until all elements fit into the table
+  std::vector<std::size_t> bins(number_of_bins_);
+  std::vector<std::uint8_t> hash_indices(number_of_bins_, 0);
+  std::uint64_t salt;
+  DefaultRng rng;
+  for (std::size_t attempt = 0;; ++attempt) {
+    if (attempt == kPsiMaxNumberOfSalts) {
+      throw std::runtime_error(
+          fmt::format("PsiGate#{}: cuckoo hashing of {} elements into {} bins failed {} times",
+                      gate_id_, receiver_set_size_, number_of_bins_, attempt));
+    }
+    rng.RandomBytes(reinterpret_cast<std::byte*>(&salt), sizeof(salt));
+    if (PsiCuckooHash(set_, salt, bins, hash_indices)) break;
+  }
+
+  ot_receiver_->WaitSetup();
+  ot_receiver_->ComputeOutputs();
+  const auto& choices{ot_receiver_->GetChoices()};
+  const auto outputs{ot_receiver_->GetOutputs()};
+
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(GetBaseProvider().GetAesFixedKey().data());
+
+  // the offsets d = x_c - r of the chunks x_c and the random choices r, which are uniform for the
+  // element 0 of the empty bins whose OPRF values are not used
+  std::vector<std::uint8_t> payload(sizeof(salt) + number_of_bins_ * kPsiNumberOfChunks);
+  std::memcpy(payload.data(), &salt, sizeof(salt));
+  std::uint8_t* offsets{payload.data() + sizeof(salt)};
+  std::vector<std::uint64_t> values(receiver_set_size_);
+  ParallelForRanges(
+      number_of_bins_, GetNumberOfParallelThreads(number_of_bins_), 1,
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t bin_i = begin; bin_i < end; ++bin_i) {
+          const bool is_empty{bins[bin_i] == set_.size()};
+          const std::uint64_t element{is_empty ? 0 : set_[bins[bin_i]]};
+          __uint128_t messages_xor{0};
+          for (std::size_t chunk_i = 0; chunk_i < kPsiNumberOfChunks; ++chunk_i) {
+            const std::size_t ot_i{bin_i * kPsiNumberOfChunks + chunk_i};
+            offsets[ot_i] =
+                (PsiChunk(element, chunk_i) - choices[ot_i]) & (kPsiNumberOfMessages - 1);
+            messages_xor ^= PsiLoadMessage(outputs[ot_i].GetData().data());
+          }
+          if (!is_empty) {
+            values[bins[bin_i]] =
+                PsiOprfValue(prg_fixed_key, messages_xor, bin_i, hash_indices[bin_i]);
+          }
+        }
+      });
+  GetCommunicationLayer().SendMessage(
+      1, communication::BuildMessage(communication::MessageType::kPsiOprfOffsets, gate_id_,
+                                     payload)
+             .Release());
+
+  const auto message{message_future_.get()};
+  const auto sender_payload{communication::GetMessage(message.data())->payload()};
+  const std::size_t number_of_values{kPsiNumberOfHashFunctions * sender_set_size_};
+  if (sender_payload->size() != number_of_values * sizeof(std::uint64_t)) {
+    throw std::runtime_error(fmt::format("PsiGate#{}: expected {} OPRF values of the sender, got "
+                                         "{} bytes",
+                                         gate_id_, number_of_values, sender_payload->size()));
+  }
+  std::vector<std::uint64_t> sender_values(number_of_values);
+  std::memcpy(sender_values.data(), sender_payload->data(), sender_payload->size());
+
+  BitVector<> intersection(receiver_set_size_);
+  for (std::size_t i = 0; i < receiver_set_size_; ++i) {
+    if (std::binary_search(sender_values.begin(), sender_values.end(), values[i])) {
+      intersection.Set(true, i);
+    }
+  }
+  auto wire_output = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(0));
+  assert(wire_output);
+  wire_output->GetMutableValues() = std::move(intersection);
+}
+
+void PsiGate::EvaluateSender() {
+  const auto message{message_future_.get()};
+  const auto payload{communication::GetMessage(message.data())->payload()};
+  std::uint64_t salt;
+  if (payload->size() != sizeof(salt) + number_of_bins_ * kPsiNumberOfChunks) {
+    throw std::runtime_error(
+        fmt::format("PsiGate#{}: expected the OPRF offsets of {} bins, got {} bytes", gate_id_,
+                    number_of_bins_, payload->size()));
+  }
+  std::memcpy(&salt, payload->data(), sizeof(salt));
+  const std::uint8_t* offsets{payload->data() + sizeof(salt)};
+
+  ot_sender_->WaitSetup();
+  ot_sender_->ComputeOutputs();
+  const auto outputs{ot_sender_->GetOutputs()};
+
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(GetBaseProvider().GetAesFixedKey().data());
+
+  // the receiver obtained message r = x_c - d of the OT of chunk x_c
+  std::vector<std::uint64_t> values(kPsiNumberOfHashFunctions * sender_set_size_);
+  ParallelForRanges(
+      sender_set_size_, GetNumberOfParallelThreads(sender_set_size_), 1,
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+          for (std::size_t k = 0; k < kPsiNumberOfHashFunctions; ++k) {
+            const std::size_t bin_i{PsiBin(set_[i], salt, k, number_of_bins_)};
+            __uint128_t messages_xor{0};
+            for (std::size_t chunk_i = 0; chunk_i < kPsiNumberOfChunks; ++chunk_i) {
+              const std::size_t ot_i{bin_i * kPsiNumberOfChunks + chunk_i};
+              const std::size_t message_i{(PsiChunk(set_[i], chunk_i) - offsets[ot_i]) &
+                                          (kPsiNumberOfMessages - 1)};
+              messages_xor ^= PsiLoadMessage(outputs[ot_i].GetData().data() +
+                                             message_i * kPsiMessageByteLength);
+            }
+            values[i * kPsiNumberOfHashFunctions + k] =
+                PsiOprfValue(prg_fixed_key, messages_xor, bin_i, k);
+          }
+        }
+      });
+  // sorted values do not reveal which element they belong to
+  std::sort(values.begin(), values.end());
+  GetCommunicationLayer().SendMessage(
+      0, communication::BuildMessage(
+             communication::MessageType::kPsiSenderValues, gate_id_,
+             std::span(reinterpret_cast<const std::uint8_t*>(values.data()),
+                       values.size() * sizeof(std::uint64_t)))
+             .Release());
+
+  auto wire_output = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(0));
+  assert(wire_output);
+  wire_output->GetMutableValues() = BitVector<>(receiver_set_size_);
+}
+
+const boolean_gmw::SharePointer PsiGate::GetOutputAsGmwShare() const {
+  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer PsiGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
 }  // namespace encrypto::motion::proto::boolean_gmw
@@ -26,8 +26,14 @@
 
 #include "boolean_gmw_share.h"
 
+#include <optional>
 #include <span>
+#include <utility>
 
+#include "algorithm/algorithm_description.h"
+#include "algorithm/flat_circuit.h"
+#include "communication/message_buffer.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_flavors.h"
 #include "oblivious_transfer/ot_flavors.h"
 #include "protocols/gate.h"
 #include "utility/bit_vector.h"
@@ -43,6 +49,11 @@ class InputGate final : public motion::InputGate {
 
   InputGate(std::vector<BitVector<>>&& input, std::size_t party_id, Backend& backend);
 
+  /// \brief Allocates the wires without the input values, which party_id passes later via
+  /// GetInputPromise(), e.g., after the setup phase. The online phase waits for them.
+  InputGate(std::size_t number_of_wires, std::size_t number_of_simd, std::size_t party_id,
+            Backend& backend);
+
   void InitializationHelper();
 
   ~InputGate() final = default;
@@ -53,12 +64,23 @@ class InputGate final : public motion::InputGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsReEvaluable() const override { return true; }
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare();
 
+  /// \throws std::logic_error if the gate was not constructed for the deferred inputs of this
+  /// party
+  ReusableFiberPromise<std::vector<BitVector<>>>& GetInputPromise();
+
  protected:
   /// two-dimensional vector for storing the raw inputs
   std::vector<BitVector<>> input_;
 
+  /// only exists for deferred inputs of this party, which replace input_ in the online phase
+  std::optional<std::pair<ReusableFiberPromise<std::vector<BitVector<>>>,
+                          ReusableFiberFuture<std::vector<BitVector<>>>>>
+      input_promise_future_;
+
   std::size_t bits_;                ///< Number of parallel values on wires
   std::size_t boolean_sharing_id_;  ///< Sharing ID for Boolean GMW for generating
   ///< correlated randomness using AES CTR
@@ -80,6 +102,8 @@ class OutputGate final : public motion::OutputGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsReEvaluable() const override { return true; }
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
 
   const motion::SharePointer GetOutputAsShare() const;
@@ -88,11 +112,41 @@ class OutputGate final : public motion::OutputGate {
   // indicates whether this party obtains the output
   bool is_my_output_ = false;
 
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> output_message_futures_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> output_message_futures_;
 
   std::mutex m_;
 };
 
+// Reveals several Boolean GMW shares to all parties at once, e.g., the outputs of an Unsimdify,
+// with a single kOutputMessage per party instead of one OutputGate and message per share.
+class RevealGate final : public NInputGate {
+ public:
+  RevealGate(std::span<const motion::SharePointer> parents);
+
+  ~RevealGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsOutput() const override { return true; }
+
+  // the revealed values of the parents in the same order
+  std::vector<motion::SharePointer> GetOutputAsShares() const;
+
+  RevealGate() = delete;
+
+  RevealGate(const Gate&) = delete;
+
+ private:
+  // the wires of parent i start at wire_offsets_[i]
+  std::vector<std::size_t> wire_offsets_;
+
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> output_message_futures_;
+};
+
 class XorGate final : public TwoGate {
  public:
   XorGate(const motion::SharePointer& a, const motion::SharePointer& b);
@@ -105,6 +159,8 @@ class XorGate final : public TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const override { return true; }
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
 
   const motion::SharePointer GetOutputAsShare() const;
@@ -126,6 +182,8 @@ class InvGate final : public OneGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const override { return true; }
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
 
   const motion::SharePointer GetOutputAsShare() const;
@@ -143,10 +201,14 @@ class AndGate final : public TwoGate {
 
   void EvaluateSetup() final override;
 
-  void EvaluateOnline() final override;
+  void EvaluateOnline() final override { EvaluateOnlineCoroutine().Run(); }
+
+  GateTask EvaluateOnlineCoroutine() final override;
 
   bool NeedsSetup() const override { return false; }
 
+  bool OpensBeforeSuspending() const final override { return true; }
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
 
   const motion::SharePointer GetOutputAsShare() const;
@@ -159,8 +221,127 @@ class AndGate final : public TwoGate {
   std::size_t mt_offset_;
   std::size_t mt_bitlen_;
 
-  std::shared_ptr<motion::Share> d_, e_;
-  std::shared_ptr<OutputGate> d_output_, e_output_;
+  // the masked inputs [d || e], which are opened in a single kBeaverOpening message per party
+  BitVector<> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
+};
+
+// AND of k = 2, ..., kMaxMultiplicationFanIn shares with the same number of wires in a single
+// online round, see arithmetic_gmw::MultiInputMultiplicationGate. The setup phase computes shares
+// of the ANDs a_S of the random masks of the inputs for all subsets S, such that the online phase
+// only opens d_i = x_i ^ a_i and computes the XOR of a_S & AND_{i not in S} d_i over all S.
+class MultiInputAndGate final : public NInputGate {
+ public:
+  MultiInputAndGate(std::span<const motion::SharePointer> inputs);
+
+  ~MultiInputAndGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  MultiInputAndGate() = delete;
+
+  MultiInputAndGate(const Gate&) = delete;
+
+ private:
+  std::size_t number_of_inputs_, number_of_wires_, number_of_simd_;
+  // number of bits of each input, i.e., wires * SIMD values
+  std::size_t input_bitlen_;
+  std::size_t mt_offset_, number_of_mts_;
+
+  // shares of the mask products a_S for all subsets S given as bit masks, |S| > 0
+  std::vector<BitVector<>> mask_products_;
+  std::vector<std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>>>
+      setup_futures_;
+
+  // the masked inputs [d_1 || ... || d_k]
+  BitVector<> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
+};
+
+// Inner product XOR_i (a_i & b_i) of two vectors of n shares with the same number of wires and
+// SIMD values, e.g., for Hamming-distance-style matching. The n pairs d_i, e_i are opened in one
+// kBeaverOpening message as in AndGate, but the products are folded into a single output share
+// using the inner-product triple (x_1, ..., x_n, y_1, ..., y_n, XOR_i z_i) of n binary MTs.
+class InnerProductGate final : public NInputGate {
+ public:
+  InnerProductGate(std::span<const motion::SharePointer> a,
+                   std::span<const motion::SharePointer> b);
+
+  ~InnerProductGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  InnerProductGate() = delete;
+
+  InnerProductGate(const Gate&) = delete;
+
+ private:
+  std::size_t number_of_terms_, number_of_wires_, number_of_simd_;
+  // number of bits of each input, i.e., wires * SIMD values
+  std::size_t input_bitlen_;
+  std::size_t mt_offset_, number_of_mts_;
+
+  // the masked inputs [d_1 || ... || d_n || e_1 || ... || e_n]
+  BitVector<> openings_;
+  std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
+};
+
+// Evaluates a whole Boolean AlgorithmDescription, e.g., a Bristol circuit, as a single gate on
+// the wires of a share instead of one gate object per primitive operation. The circuit is stored
+// as a FlatCircuit, whose layers are evaluated on one contiguous buffer of the packed SIMD values
+// of all wires: XOR and INV are evaluated locally by an interpreter loop over the operation
+// arrays, and the masked inputs of all AND and OR operations of a layer are opened in a single
+// kCircuitLayerOpening message per party and multiplied at once.
+class CircuitGate final : public NInputGate {
+ public:
+  CircuitGate(const motion::SharePointer& input, const AlgorithmDescription& algorithm);
+
+  // evaluates a FlatCircuit that may be shared with other gates, e.g., of a CircuitTemplate
+  CircuitGate(const motion::SharePointer& input, std::shared_ptr<const FlatCircuit> circuit);
+
+  ~CircuitGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  std::size_t GetNumberOfLayers() const { return circuit_->GetNumberOfLayers(); }
+
+  CircuitGate() = delete;
+
+  CircuitGate(const Gate&) = delete;
+
+ private:
+  std::shared_ptr<const FlatCircuit> circuit_;
+  std::size_t number_of_simd_;
+  std::size_t mt_offset_, number_of_mts_;
+
+  // the MTs of the interactive operations of layer l start at mt_begins_[l]
+  std::vector<std::size_t> mt_begins_;
+  // per layer, the bits of its OR operations in the products of the layer, empty without ORs
+  std::vector<BitVector<>> or_masks_;
+  std::vector<std::vector<motion::ReusableFiberFuture<communication::MessageBuffer>>>
+      opening_futures_;
 };
 
 class MuxGate final : public ThreeGate {
@@ -193,4 +374,122 @@ class MuxGate final : public ThreeGate {
   std::vector<std::unique_ptr<XcOtSender>> ot_sender_;
 };
 
+// Evaluates a public lookup table T: {0,1}^k -> {0,1}^m with 1 <= k <= 8 on a two-party Boolean
+// GMW share x = x_0 ^ x_1 of k wires, e.g., an S-box, with a single 1-out-of-2^k OT per SIMD value
+// instead of a circuit of AND gates. Party 1 chooses a random output share r and sends the messages
+// T[j ^ x_1] ^ r for all j, of which party 0 obtains message x_0 = T[x] ^ r as its output share.
+// table[x] holds the m bits of output wires 0, ..., m - 1, where bit i of x is input wire i.
+class LookupTableGate final : public NInputGate {
+ public:
+  LookupTableGate(const motion::SharePointer& input, std::span<const BitVector<>> table);
+
+  ~LookupTableGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  LookupTableGate() = delete;
+
+  LookupTableGate(const Gate&) = delete;
+
+ private:
+  std::size_t number_of_simd_, output_bit_length_;
+  // the m bits of all 2^k entries of the table, entry x at [x * m, (x + 1) * m)
+  BitVector<> table_;
+
+  std::unique_ptr<GKk13OtReceiver> ot_receiver_;
+  std::unique_ptr<GKk13OtSender> ot_sender_;
+};
+
+// Reads the element at a secret index x of an array of n elements of m bits, given as the wires
+// of x followed by the wires of the elements, with 1-out-of-N OTs instead of AND gates in two-party
+// Boolean GMW, see LookupTableGate for public tables. The w index bits are split into digits of at
+// most 8 bits, most significant digit first. Per digit, each party p sends the entries of its
+// share of the current subarray, shifted by its share of the digit and masked with r_p, of which
+// the other party obtains the entry of the secret digit with its share as choice. The received
+// entry XOR r_p is a share of the subarray of the next digit. A read needs two OTs per digit and
+// SIMD value and sends about 2 * 2^w * m bits, where the entries n, ..., 2^w - 1 are 0.
+class ObliviousReadGate final : public NInputGate {
+ public:
+  ObliviousReadGate(const motion::SharePointer& index, const motion::SharePointer& elements,
+                    std::size_t number_of_elements);
+
+  ~ObliviousReadGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  ObliviousReadGate() = delete;
+
+  ObliviousReadGate(const Gate&) = delete;
+
+ private:
+  std::size_t number_of_elements_, element_bit_length_, index_bit_length_, number_of_simd_;
+  // the bit lengths of the digits, the most significant digit first
+  std::vector<std::size_t> digit_bit_lengths_;
+
+  std::vector<std::unique_ptr<GKk13OtReceiver>> ot_receivers_;
+  std::vector<std::unique_ptr<GKk13OtSender>> ot_senders_;
+};
+
+// Private set intersection of the distinct 64-bit elements of the receiver, party 0, and of the
+// sender, party 1, based on an OPRF from 1-out-of-16 random KK13 OTs as in Pinkas et al. (USENIX
+// Security 2015). The receiver places its elements in a cuckoo table of about 1.27 n_0 bins with
+// three hash functions, each bin b obtains the OPRF value F_b(x) = H_b(XOR_c m_{b,c}[x_c]) of its
+// element x of the 4-bit chunks x_c, where m_{b,c} are the 16 random messages of the OT of chunk c
+// of bin b. The sender sends the sorted values F_b(y) of all bins b of its elements y, such that
+// the receiver learns which of its elements are in the intersection and the sender learns nothing.
+// The output is a Boolean GMW share of one wire with n_0 SIMD values, whose SIMD value i is
+// [x_i in the intersection] for element i of the receiver's set, for further computation, e.g.,
+// the cardinality or sums over the intersection. The receiver holds these bits and the sender 0.
+// The OPRF values have 64 bits, i.e., about 3 n_0 n_1 / 2^64 false positives are expected.
+class PsiGate final : public NInputGate {
+ public:
+  // set is the set of this party, receiver_set_size and sender_set_size are the public set sizes
+  PsiGate(std::span<const std::uint64_t> set, std::size_t receiver_set_size,
+          std::size_t sender_set_size, Backend& backend);
+
+  ~PsiGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  PsiGate() = delete;
+
+  PsiGate(const Gate&) = delete;
+
+ private:
+  void EvaluateReceiver();
+
+  void EvaluateSender();
+
+  std::vector<std::uint64_t> set_;
+  std::size_t receiver_set_size_, sender_set_size_, number_of_bins_;
+
+  std::unique_ptr<RKk13OtReceiver> ot_receiver_;
+  std::unique_ptr<RKk13OtSender> ot_sender_;
+  ReusableFiberFuture<communication::MessageBuffer> message_future_;
+};
+
 }  // namespace encrypto::motion::proto::boolean_gmw
\ No newline at end of file
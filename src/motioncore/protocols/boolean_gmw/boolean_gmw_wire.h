@@ -61,6 +61,12 @@ class Wire final : public BooleanWire {
 
   bool IsConstant() const noexcept final { return false; }
 
+  std::size_t ReleaseValues() final {
+    const auto number_of_bytes = values_.GetData().capacity();
+    values_ = BitVector<>();
+    return number_of_bytes;
+  }
+
  private:
   BitVector<> values_;
 };
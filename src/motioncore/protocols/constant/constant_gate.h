@@ -160,6 +160,8 @@ class ConstantArithmeticAdditionGate final : public TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the
   // case we need it multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare() {
@@ -238,6 +240,8 @@ class ConstantArithmeticMultiplicationGate final : public TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the
   // case we need it multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare() {
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2019 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
+#include "protocols/boolean_gmw/boolean_gmw_share.h"
+#include "protocols/boolean_gmw/boolean_gmw_wire.h"
+#include "protocols/gate.h"
+#include "protocols/share.h"
+#include "utility/bit_vector.h"
+#include "utility/constants.h"
+#include "utility/logger.h"
+
+namespace encrypto::motion {
+
+// First step of the conversion of an arithmetic GMW share x = x_0 + ... + x_n-1 in Z/2^kZ into a
+// Boolean GMW share. Each party p locally shares the bits of its arithmetic share x_p, i.e., it
+// outputs n operands of k Boolean GMW wires, where operand p is x_p at party p and 0 elsewhere.
+// The operands are added by a Boolean circuit afterwards, see
+// algorithm::KoggeStoneAdditionCircuit. The gate needs no interaction.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+class ArithmeticGmwToBooleanGmwGate final : public OneGate {
+ public:
+  ArithmeticGmwToBooleanGmwGate(const SharePointer& parent) : OneGate(parent->GetBackend()) {
+    parent_ = parent->GetWires();
+    if (parent_.size() != 1) {
+      throw std::invalid_argument(fmt::format(
+          "Cannot convert an arithmetic GMW share with {} wires to Boolean GMW", parent_.size()));
+    }
+    assert(parent_.at(0)->GetProtocol() == MpcProtocol::kArithmeticGmw);
+    assert(parent_.at(0)->GetBitLength() == sizeof(T) * 8);
+
+    const auto number_of_simd{parent->GetNumberOfSimdValues()};
+    const auto number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
+    constexpr auto bit_size = sizeof(T) * 8;
+
+    // create the output wires, bit_size wires per party
+    output_wires_.reserve(number_of_parties * bit_size);
+    for (std::size_t i = 0; i < number_of_parties * bit_size; ++i) {
+      output_wires_.emplace_back(
+          GetRegister().template EmplaceWire<proto::boolean_gmw::Wire>(backend_, number_of_simd));
+    }
+
+    if constexpr (kDebug) {
+      auto gate_info = fmt::format("gate id {}, parent wire: {}, output wires: ", gate_id_,
+                                   parent_.at(0)->GetWireId());
+      for (const auto& wire : output_wires_) {
+        gate_info.append(fmt::format("{} ", wire->GetWireId()));
+      }
+      GetLogger().LogDebug(fmt::format(
+          "Created an Arithmetic GMW to Boolean GMW conversion gate with following properties: {}",
+          gate_info));
+    }
+  }
+
+  ~ArithmeticGmwToBooleanGmwGate() final = default;
+
+  void EvaluateSetup() final {}
+
+  void EvaluateOnline() final {
+    // nothing to setup, no need to wait/check
+    auto arithmetic_input{
+        std::dynamic_pointer_cast<const proto::arithmetic_gmw::Wire<T>>(parent_.at(0))};
+    assert(arithmetic_input);
+    arithmetic_input->GetIsReadyCondition().Wait();
+
+    const auto& values{arithmetic_input->GetValues()};
+    const auto number_of_simd{values.size()};
+    constexpr auto bit_size = sizeof(T) * 8;
+    const auto my_id{GetCommunicationLayer().GetMyId()};
+
+    // the operands of the other parties are shared as zeros
+    for (auto& wire : output_wires_) {
+      auto gmw_output{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(wire)};
+      assert(gmw_output);
+      gmw_output->GetMutableValues() = BitVector<>(number_of_simd, false);
+    }
+    for (std::size_t bit_i = 0; bit_i < bit_size; ++bit_i) {
+      auto gmw_output{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(
+          output_wires_.at(my_id * bit_size + bit_i))};
+      auto& bits{gmw_output->GetMutableValues()};
+      for (std::size_t j = 0; j < number_of_simd; ++j) {
+        bits.Set(((values[j] >> bit_i) & 1) == 1, j);
+      }
+    }
+
+    GetLogger().LogDebug(fmt::format("Evaluated A2BGate with id#{}", gate_id_));
+  }
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const override { return true; }
+
+  const proto::boolean_gmw::SharePointer GetOutputAsGmwShare() const {
+    auto result = std::make_shared<proto::boolean_gmw::Share>(output_wires_);
+    assert(result);
+    return result;
+  }
+
+  const SharePointer GetOutputAsShare() const {
+    return std::static_pointer_cast<Share>(GetOutputAsGmwShare());
+  }
+
+  ArithmeticGmwToBooleanGmwGate() = delete;
+
+  ArithmeticGmwToBooleanGmwGate(const Gate&) = delete;
+};
+
+}  // namespace encrypto::motion
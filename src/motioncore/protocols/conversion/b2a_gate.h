@@ -22,9 +22,14 @@
 
 #pragma once
 
+#include <span>
+#include <stdexcept>
 #include <type_traits>
 #include "base/register.h"
-#include "multiplication_triple/sb_provider.h"
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "multiplication_triple/dabit_provider.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
 #include "protocols/boolean_gmw/boolean_gmw_gate.h"
 #include "protocols/boolean_gmw/boolean_gmw_share.h"
@@ -37,6 +42,10 @@
 
 namespace encrypto::motion {
 
+// Converts a Boolean GMW share of l <= k bits x_0, ..., x_l-1 into an arithmetic GMW share of
+// the zero-extended value x = sum_i 2^i x_i in Z/2^kZ. The bits are masked with daBits b_i, and
+// t_i = x_i ^ b_i of all l bits and SIMD values is opened in a single kDaBitOpening message per
+// party, such that x = sum_i 2^i (t_i + b_i - 2 t_i b_i) is computed locally.
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 class GmwToArithmeticGate final : public OneGate {
  public:
@@ -45,8 +54,12 @@ class GmwToArithmeticGate final : public OneGate {
     const auto number_of_simd{parent->GetNumberOfSimdValues()};
     constexpr auto bit_size = sizeof(T) * 8;
 
-    // check that we have enough input wires to represent an element of T
-    assert(parent_.size() == bit_size);
+    // check that the input wires fit into an element of T
+    if (parent_.empty() || parent_.size() > bit_size) {
+      throw std::invalid_argument(fmt::format(
+          "Cannot convert {} Boolean GMW wires to a {}-bit arithmetic GMW share", parent_.size(),
+          bit_size));
+    }
     for ([[maybe_unused]] const auto& wire : parent_) {
       assert(wire->GetBitLength() == 1);
       assert(wire->GetNumberOfSimdValues() == number_of_simd);
@@ -57,19 +70,14 @@ class GmwToArithmeticGate final : public OneGate {
     output_wires_.emplace_back(GetRegister().template EmplaceWire<proto::arithmetic_gmw::Wire<T>>(
         backend_, number_of_simd));
 
-    std::vector<WirePointer> dummy_wires;
-    dummy_wires.reserve(number_of_simd);
-    for (std::size_t i = 0; i < bit_size; ++i) {
-      dummy_wires.emplace_back(
-          GetRegister().template EmplaceWire<proto::boolean_gmw::Wire>(backend_, number_of_simd));
-    }
-    ts_ = std::make_shared<proto::boolean_gmw::Share>(dummy_wires);
-    // also create an output gate for the ts
-    ts_output_ = GetRegister().template EmplaceGate<proto::boolean_gmw::OutputGate>(ts_);
+    // register the required number of daBits
+    number_of_dabits_ = number_of_simd * parent_.size();
+    GetRegister().RunInConstructionOrder(*this, [this] {
+      dabit_offset_ = GetDaBitProvider().template RequestDaBits<T>(number_of_dabits_);
+    });
 
-    // register the required number of shared bits
-    number_of_sbs_ = number_of_simd * bit_size;
-    sb_offset_ = GetSbProvider().template RequestSbs<T>(number_of_sbs_);
+    opening_futures_ = GetCommunicationLayer().GetMessageManager().RegisterReceiveAll(
+        communication::MessageType::kDaBitOpening, gate_id_);
 
     if constexpr (kDebug) {
       auto gate_info = fmt::format("gate id {}, parent wires: ", gate_id_);
@@ -93,53 +101,45 @@ class GmwToArithmeticGate final : public OneGate {
       wire->GetIsReadyCondition().Wait();
     }
 
-    // wait for the SbProvider to finish
-    auto& sb_provider = GetSbProvider();
-    sb_provider.WaitFinished();
-
+    // waits for the SBs the daBits are made of
+    const auto dabits{
+        GetDaBitProvider().template GetDaBits<T>(dabit_offset_, number_of_dabits_)};
     const auto number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
-    constexpr auto bit_size = sizeof(T) * 8;
 
-    // mask the input bits with the shared bits
-    // and assign the result to t
-    const auto& sbs = sb_provider.template GetSbsAll<T>();
-    auto& ts_wires = ts_->GetMutableWires();
-    for (std::size_t wire_i = 0; wire_i < bit_size; ++wire_i) {
-      auto t_wire = std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(ts_wires.at(wire_i));
-      auto parent_gmw_wire =
-          std::dynamic_pointer_cast<const proto::boolean_gmw::Wire>(parent_.at(wire_i));
-      t_wire->GetMutableValues() = parent_gmw_wire->GetValues();
-      // xor them with the shared bits
-      for (std::size_t j = 0; j < number_of_simd; ++j) {
-        auto b = t_wire->GetValues().Get(j);
-        bool sb = sbs.at(sb_offset_ + wire_i * number_of_simd + j) & 1;
-        t_wire->GetMutableValues().Set(b ^ sb, j);
+    // t = x ^ b of all wires is opened in one message
+    BitVector<> ts;
+    for (const auto& wire : parent_) {
+      ts.Append(std::dynamic_pointer_cast<const proto::boolean_gmw::Wire>(wire)->GetValues());
+    }
+    ts ^= dabits.boolean;
+
+    auto& communication_layer = GetCommunicationLayer();
+    const auto& bytes{ts.GetData()};
+    communication_layer.BroadcastMessage(
+        communication::BuildMessage(
+            communication::MessageType::kDaBitOpening, gate_id_,
+            std::span(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size()))
+            .Release());
+    for (auto& future : opening_futures_) {
+      const auto opening_message{future.get()};
+      const auto& payload{*communication::GetMessage(opening_message.data())->payload()};
+      if (payload.size() != bytes.size()) {
+        throw std::runtime_error(
+            fmt::format("kDaBitOpening message #{} has {} B instead of {} B", gate_id_,
+                        payload.size(), bytes.size()));
       }
-      t_wire->SetOnlineFinished();
+      ts ^= BitSpan(const_cast<std::uint8_t*>(payload.data()), ts.GetSize());
     }
 
-    // reconstruct t
-    ts_output_->WaitOnline();
-    const auto& ts_clear = ts_output_->GetOutputWires();
-    std::vector<std::shared_ptr<proto::boolean_gmw::Wire>> ts_clear_b;
-    ts_clear_b.reserve(ts_clear.size());
-    std::transform(ts_clear.cbegin(), ts_clear.cend(), std::back_inserter(ts_clear_b),
-                   [](auto& w) { return std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(w); });
-
     auto output = std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<T>>(output_wires_.at(0));
     output->GetMutableValues().resize(number_of_simd);
+    const bool is_first_party{communication_layer.GetMyId() == 0};
     for (std::size_t j = 0; j < number_of_simd; ++j) {
       T output_value = 0;
-      for (std::size_t wire_i = 0; wire_i < bit_size; ++wire_i) {
-        if (GetCommunicationLayer().GetMyId() == 0) {
-          T t(ts_clear_b.at(wire_i)->GetValues().Get(j));         // the masked bit
-          T r(sbs.at(sb_offset_ + wire_i * number_of_simd + j));  // the arithmetically shared bit
-          output_value += T(t + r - 2 * t * r) << wire_i;
-        } else {
-          T t(ts_clear_b.at(wire_i)->GetValues().Get(j));         // the masked bit
-          T r(sbs.at(sb_offset_ + wire_i * number_of_simd + j));  // the arithmetically shared bit
-          output_value += T(r - 2 * t * r) << wire_i;
-        }
+      for (std::size_t wire_i = 0; wire_i < parent_.size(); ++wire_i) {
+        T t(ts.Get(wire_i * number_of_simd + j));             // the masked bit
+        T b(dabits.arithmetic[wire_i * number_of_simd + j]);  // the arithmetic daBit share
+        output_value += T((is_first_party ? t : T(0)) + b - 2 * t * b) << wire_i;
       }
       output->GetMutableValues().at(j) = output_value;
     }
@@ -166,10 +166,9 @@ class GmwToArithmeticGate final : public OneGate {
   GmwToArithmeticGate(const Gate&) = delete;
 
  private:
-  std::size_t number_of_sbs_;
-  std::size_t sb_offset_;
-  proto::boolean_gmw::SharePointer ts_;
-  std::shared_ptr<proto::boolean_gmw::OutputGate> ts_output_;
+  std::size_t number_of_dabits_;
+  std::size_t dabit_offset_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> opening_futures_;
 };
 
 }  // namespace encrypto::motion
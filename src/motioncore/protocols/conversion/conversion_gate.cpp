@@ -29,14 +29,21 @@
 #include "base/backend.h"
 #include "communication/communication_layer.h"
 #include "communication/message.h"
+#include "oblivious_transfer/ot_flavors.h"
+#include "oblivious_transfer/ot_provider.h"
 #include "protocols/bmr/bmr_gate.h"
 #include "protocols/bmr/bmr_provider.h"
 #include "protocols/bmr/bmr_share.h"
 #include "protocols/bmr/bmr_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_share.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
+#include "protocols/garbled_circuit/garbled_circuit_constants.h"
+#include "protocols/garbled_circuit/garbled_circuit_provider.h"
+#include "protocols/garbled_circuit/garbled_circuit_share.h"
+#include "protocols/garbled_circuit/garbled_circuit_wire.h"
 #include "secure_type/secure_unsigned_integer.h"
 #include "utility/bit_vector.h"
+#include "utility/block.h"
 #include "utility/constants.h"
 #include "utility/fiber_condition.h"
 
@@ -410,4 +417,177 @@ const SharePointer ArithmeticGmwToBmrGate::GetOutputAsShare() const {
   return result;
 }
 
+GarbledCircuitToBooleanGmwGate::GarbledCircuitToBooleanGmwGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() > 0);
+  for ([[maybe_unused]] const auto& wire : parent_)
+    assert(wire->GetProtocol() == MpcProtocol::kGarbledCircuit);
+
+  output_wires_.reserve(parent_.size());
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    output_wires_.emplace_back(GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(
+        backend_, parent->GetNumberOfSimdValues()));
+  }
+}
+
+void GarbledCircuitToBooleanGmwGate::EvaluateSetup() {}
+
+void GarbledCircuitToBooleanGmwGate::EvaluateOnline() {
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format(
+        "Start evaluating online phase of GC to Boolean GMW Gate with id#{}", gate_id_));
+  }
+
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    auto gc_input{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(parent_[i])};
+    assert(gc_input);
+    auto gmw_output{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_[i])};
+    assert(gmw_output);
+    gc_input->GetIsReadyCondition().Wait();
+    gmw_output->GetMutableValues() = gc_input->CopyPermutationBits();
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format(
+        "Finished evaluating online phase of GC to Boolean GMW Gate with id#{}", gate_id_));
+  }
+}
+
+const proto::boolean_gmw::SharePointer GarbledCircuitToBooleanGmwGate::GetOutputAsGmwShare()
+    const {
+  auto result = std::make_shared<proto::boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const SharePointer GarbledCircuitToBooleanGmwGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
+BooleanGmwToGarbledCircuitGate::BooleanGmwToGarbledCircuitGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()),
+      is_garbler_(GetCommunicationLayer().GetMyId() ==
+                  static_cast<std::size_t>(GarbledCircuitRole::kGarbler)) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() > 0);
+  for ([[maybe_unused]] const auto& wire : parent_)
+    assert(wire->GetProtocol() == MpcProtocol::kBooleanGmw);
+  const std::size_t number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
+  if (number_of_parties != 2) {
+    throw std::invalid_argument(fmt::format(
+        "Boolean GMW to GC conversion requires 2 parties, got {}", number_of_parties));
+  }
+
+  const std::size_t number_of_simd{parent->GetNumberOfSimdValues()};
+  const std::size_t number_of_labels{parent_.size() * number_of_simd};
+  output_wires_.reserve(parent_.size());
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<proto::garbled_circuit::Wire>(backend_, number_of_simd));
+  }
+
+  if (is_garbler_) {
+    auto& provider{dynamic_cast<proto::garbled_circuit::ThreeHalvesGarblerProvider&>(
+        GetGarbledCircuitProvider())};
+    first_label_index_ = provider.ReserveInputLabels(number_of_labels);
+    ot_sender_ = GetOtProvider(static_cast<std::size_t>(GarbledCircuitRole::kEvaluator))
+                     .RegisterSendGOt128(number_of_labels);
+  } else {
+    ot_receiver_ = GetOtProvider(static_cast<std::size_t>(GarbledCircuitRole::kGarbler))
+                       .RegisterReceiveGOt128(number_of_labels);
+  }
+}
+
+BooleanGmwToGarbledCircuitGate::~BooleanGmwToGarbledCircuitGate() = default;
+
+void BooleanGmwToGarbledCircuitGate::EvaluateSetup() {
+  if (!is_garbler_) return;
+  auto& provider{dynamic_cast<proto::garbled_circuit::ThreeHalvesGarblerProvider&>(
+      GetGarbledCircuitProvider())};
+  const std::size_t number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+  for (std::size_t i = 0; i < output_wires_.size(); ++i) {
+    auto gc_output{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(output_wires_[i])};
+    assert(gc_output);
+    provider.GenerateInputLabels(first_label_index_ + i * number_of_simd,
+                                 gc_output->GetMutableKeys());
+    // keep the bits at the positions of the control bits 0 as for the labels of input gates
+    for (auto& key : gc_output->GetMutableKeys()) {
+      BitSpan key_span(key.data(), kKappa);
+      key_span.Set(false, 0);
+      key_span.Set(false, proto::garbled_circuit::kGarbledRowBitSize);
+    }
+    gc_output->SetSetupIsReady();
+  }
+}
+
+void BooleanGmwToGarbledCircuitGate::EvaluateOnline() {
+  WaitSetup();
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format(
+        "Start evaluating online phase of Boolean GMW to GC Gate with id#{}", gate_id_));
+  }
+  for (auto& wire : parent_) wire->GetIsReadyCondition().Wait();
+
+  const std::size_t number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+  if (is_garbler_) {
+    auto& provider{dynamic_cast<proto::garbled_circuit::ThreeHalvesGarblerProvider&>(
+        GetGarbledCircuitProvider())};
+    const Block128& offset{provider.GetOffset()};
+    // the pair of labels for the evaluator's choice bits 0 and 1
+    Block128Vector labels(2 * parent_.size() * number_of_simd);
+    for (std::size_t i = 0; i < parent_.size(); ++i) {
+      auto gmw_input{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(parent_[i])};
+      auto gc_output{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(output_wires_[i])};
+      assert(gmw_input);
+      assert(gc_output);
+      const auto& bits{gmw_input->GetValues()};
+      const auto keys{gc_output->GetKeys()};
+      for (std::size_t j = 0; j < number_of_simd; ++j) {
+        const Block128 key_of_bit{bits.Get(j) ? keys[j] ^ offset : keys[j]};
+        labels[2 * (i * number_of_simd + j)] = key_of_bit;
+        labels[2 * (i * number_of_simd + j) + 1] = key_of_bit ^ offset;
+      }
+    }
+    ot_sender_->WaitSetup();
+    ot_sender_->SetInputs(std::move(labels));
+    ot_sender_->SendMessages();
+  } else {
+    BitVector<> choices;
+    choices.Reserve(parent_.size() * number_of_simd);
+    for (const auto& wire : parent_) {
+      auto gmw_input{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(wire)};
+      assert(gmw_input);
+      choices.Append(gmw_input->GetValues());
+    }
+    ot_receiver_->WaitSetup();
+    ot_receiver_->SetChoices(std::move(choices));
+    ot_receiver_->SendCorrections();
+    ot_receiver_->ComputeOutputs();
+    const Block128Vector& output_labels{ot_receiver_->GetOutputs()};
+    for (std::size_t i = 0; i < output_wires_.size(); ++i) {
+      auto gc_output{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(output_wires_[i])};
+      assert(gc_output);
+      std::copy(output_labels.begin() + i * number_of_simd,
+                output_labels.begin() + (i + 1) * number_of_simd,
+                gc_output->GetMutableKeys().begin());
+    }
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(fmt::format(
+        "Finished evaluating online phase of Boolean GMW to GC Gate with id#{}", gate_id_));
+  }
+}
+
+const SharePointer BooleanGmwToGarbledCircuitGate::GetOutputAsShare() const {
+  auto result = std::make_shared<proto::garbled_circuit::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
 }  // namespace encrypto::motion
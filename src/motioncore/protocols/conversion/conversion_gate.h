@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "communication/message_buffer.h"
 #include "protocols/gate.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
@@ -45,6 +46,8 @@ using SharePointer = std::shared_ptr<Share>;
 
 namespace encrypto::motion {
 
+class GOt128Receiver;
+class GOt128Sender;
 class Share;
 using SharePointer = std::shared_ptr<Share>;
 
@@ -90,8 +93,8 @@ class BooleanGmwToBmrGate final : public OneGate {
   BooleanGmwToBmrGate(const Gate&) = delete;
 
  private:
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> received_public_values_;
-  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> received_public_keys_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> received_public_values_;
+  std::vector<ReusableFiberFuture<communication::MessageBuffer>> received_public_keys_;
 };
 
 class ArithmeticGmwToBmrGate final : public OneGate {
@@ -118,4 +121,60 @@ class ArithmeticGmwToBmrGate final : public OneGate {
   ReusableFiberPromise<std::vector<BitVector<>>>* input_promise_;
 };
 
+// Y2B: converts the labels of a two-party garbled circuit share into Boolean GMW shares without
+// interaction. The garbler's zero label and the evaluator's label of a wire differ in the
+// permutation bit iff the value is 1, since the permutation bit of the global offset is 1, so the
+// permutation bits of the parties' labels are Boolean GMW shares of the value.
+class GarbledCircuitToBooleanGmwGate final : public OneGate {
+ public:
+  GarbledCircuitToBooleanGmwGate(const SharePointer& parent);
+
+  ~GarbledCircuitToBooleanGmwGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const override { return true; }
+
+  const proto::boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const SharePointer GetOutputAsShare() const;
+
+  GarbledCircuitToBooleanGmwGate() = delete;
+
+  GarbledCircuitToBooleanGmwGate(const Gate&) = delete;
+};
+
+// B2Y: converts two-party Boolean GMW shares into a garbled circuit share. The garbler generates
+// fresh zero labels k_0 in the setup phase, and the evaluator obtains k_0 ^ (g ^ e) * offset by a
+// single GOt128 with its share e as choice bit, where the garbler offers k_0 ^ g * offset and
+// k_0 ^ (1 - g) * offset for its share g.
+class BooleanGmwToGarbledCircuitGate final : public OneGate {
+ public:
+  BooleanGmwToGarbledCircuitGate(const SharePointer& parent);
+
+  ~BooleanGmwToGarbledCircuitGate() final;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return is_garbler_; }
+
+  const SharePointer GetOutputAsShare() const;
+
+  BooleanGmwToGarbledCircuitGate() = delete;
+
+  BooleanGmwToGarbledCircuitGate(const Gate&) = delete;
+
+ private:
+  const bool is_garbler_;
+  std::size_t first_label_index_{0};
+  std::unique_ptr<GOt128Sender> ot_sender_;
+  std::unique_ptr<GOt128Receiver> ot_receiver_;
+};
+
 }  // namespace encrypto::motion
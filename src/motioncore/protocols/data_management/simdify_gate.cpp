@@ -37,22 +37,32 @@
 #include "protocols/constant/constant_share.h"
 #include "protocols/constant/constant_wire.h"
 #include "protocols/share.h"
+#include "protocols/share_view.h"
 #include "utility/constants.h"
 #include "utility/logger.h"
 
 namespace encrypto::motion {
 
-SimdifyGate::SimdifyGate(std::span<SharePointer> parents)
-    : OneGate(parents[0]->GetBackend()), number_of_input_shares_(parents.size()) {
-  const std::size_t number_of_input_wires{parents[0]->GetWires().size()};
+static std::vector<ShareView> ViewAll(std::span<SharePointer> shares) {
+  std::vector<ShareView> views;
+  views.reserve(shares.size());
+  for (const auto& share : shares) views.emplace_back(*share);
+  return views;
+}
+
+SimdifyGate::SimdifyGate(std::span<SharePointer> parents) : SimdifyGate(ViewAll(parents)) {}
+
+SimdifyGate::SimdifyGate(std::span<const ShareView> parents)
+    : OneGate(parents[0].GetShare().GetBackend()), number_of_input_shares_(parents.size()) {
+  const std::size_t number_of_input_wires{parents[0].GetNumberOfWires()};
 
   for (std::size_t i = 0; i < parents.size(); ++i) {
-    output_number_of_simd_values_ += parents[i]->GetNumberOfSimdValues();
+    output_number_of_simd_values_ += parents[i].GetNumberOfSimdValues();
   }
 
   if constexpr (kDebug) {
     for (std::size_t i = 1; i < parents.size(); ++i) {
-      if (number_of_input_wires != parents[i]->GetWires().size()) {
+      if (number_of_input_wires != parents[i].GetNumberOfWires()) {
         throw std::invalid_argument(fmt::format(
             "Input shares in SimdifyGate#{} have inconsistent number of wires", gate_id_));
       }
@@ -61,7 +71,7 @@ SimdifyGate::SimdifyGate(std::span<SharePointer> parents)
 
   parent_.reserve(number_of_input_wires * parents.size());
   for (auto& parent : parents) {
-    parent_.insert(parent_.end(), parent->GetWires().begin(), parent->GetWires().end());
+    parent_.insert(parent_.end(), parent.GetWires().begin(), parent.GetWires().end());
   }
 
   const MpcProtocol protocol{parent_[0]->GetProtocol()};
@@ -69,7 +79,7 @@ SimdifyGate::SimdifyGate(std::span<SharePointer> parents)
     for (std::size_t j = 0; j < parents.size(); ++j) {
       const std::size_t tmp_number_of_simd =
           parent_[j * number_of_input_wires]->GetNumberOfSimdValues();
-      for (std::size_t i = 1; i < parents[j]->GetWires().size(); ++i) {
+      for (std::size_t i = 1; i < parents[j].GetNumberOfWires(); ++i) {
         if (parent_[j * number_of_input_wires + i]->GetNumberOfSimdValues() != tmp_number_of_simd) {
           throw std::invalid_argument(fmt::format(
               "Input wires have different numbers of SIMD values in SimdifyGate#{}", GetId()));
@@ -201,6 +211,11 @@ SimdifyGate::SimdifyGate(std::span<SharePointer> parents)
         throw std::invalid_argument(fmt::format("Unrecognized MpcProtocol in SimdifyGate"));
     }
   }
+  if (protocol == MpcProtocol::kAstra) {
+    // rearranging the values does not add a multiplication layer
+    proto::astra::SetMultiplicativeDepth(output_wires_,
+                                         proto::astra::GetMaximumMultiplicativeDepth(parent_));
+  }
 }
 
 void SimdifyGate::EvaluateSetup() {
@@ -36,6 +36,7 @@ namespace encrypto::motion {
 class Share;
 using SharePointer = std::shared_ptr<Share>;
 
+class ShareView;
 class ShareWrapper;
 
 /// \brief yields a share that constitutes a concatenation of the parent in terms of their SIMD
@@ -49,6 +50,9 @@ class SimdifyGate final : public OneGate {
  public:
   SimdifyGate(std::span<SharePointer> parents);
 
+  /// \brief composes the viewed wires, which need not be all wires of their shares.
+  SimdifyGate(std::span<const ShareView> parents);
+
   ~SimdifyGate() = default;
 
   void EvaluateSetup() override;
@@ -56,6 +56,14 @@ SubsetGate::SubsetGate(const SharePointer& parent, std::vector<std::size_t>&& po
   }
   const std::size_t number_of_simd{parent_[0]->GetNumberOfSimdValues()};
   const MpcProtocol protocol{parent_[0]->GetProtocol()};
+  for (const std::size_t position_id : position_ids_) {
+    if (position_id >= number_of_simd) {
+      throw std::out_of_range(
+          fmt::format("Trying to access SIMD value #{} out of {} SIMD values in SubsetGate#{}",
+                      position_id, number_of_simd, gate_id_));
+    }
+  }
+  ranges_ = ToSubsetRanges(position_ids_);
   if constexpr (kDebug) {
     for (std::size_t i = 1; i < parent_.size(); ++i) {
       if (parent_[i]->GetNumberOfSimdValues() != number_of_simd) {
@@ -169,22 +177,76 @@ SubsetGate::SubsetGate(const SharePointer& parent, std::vector<std::size_t>&& po
 SubsetGate::SubsetGate(const SharePointer& parent, std::span<const std::size_t> position_ids)
     : SubsetGate(parent, std::vector<std::size_t>(position_ids.begin(), position_ids.end())) {}
 
-template <typename Allocator>
-void BitVectorSubsetImplementation(const BitVector<Allocator>& in, BitVector<Allocator>& out,
-                                   std::span<const std::size_t> position_ids) {
-  out.Resize(position_ids.size());
-  for (std::size_t i = 0; i < position_ids.size(); ++i) {
-    if constexpr (kDebug) {
-      if (position_ids[i] >= in.GetSize()) {
-        throw std::out_of_range(
-            fmt::format("Trying to access SIMD value #{} out of {} SIMD values in SubsetGate",
-                        position_ids[i], in.GetSize()));
+std::vector<SubsetRange> ToSubsetRanges(std::span<const std::size_t> position_ids) {
+  std::vector<SubsetRange> ranges;
+  std::size_t i{0};
+  while (i < position_ids.size()) {
+    SubsetRange range{.from = position_ids[i], .stride = 1, .length = 1};
+    if (i + 1 < position_ids.size() && position_ids[i + 1] >= position_ids[i]) {
+      const std::size_t stride{position_ids[i + 1] - position_ids[i]};
+      // a pair of positions only starts a strided range if the stride continues, such that the
+      // following positions may start a consecutive run instead
+      const bool stride_continues{i + 2 < position_ids.size() &&
+                                  position_ids[i + 2] == position_ids[i + 1] + stride};
+      if (stride == 1 || stride_continues) {
+        range.stride = stride;
+        while (i + range.length < position_ids.size() &&
+               position_ids[i + range.length] == range.from + range.length * stride) {
+          ++range.length;
+        }
       }
     }
-    out.Set(in[position_ids[i]], i);
+    i += range.length;
+    ranges.emplace_back(range);
   }
+  if (2 * ranges.size() > position_ids.size()) ranges.clear();
+  return ranges;
 }
 
+// shorter runs are cheaper to copy bit by bit than by shifting words
+constexpr std::size_t kMinimumWordCopyLength{64};
+
+// ORs the bits of in at position(i) for i < number_of_bits into the zero-initialized bits
+// [out_position, out_position + number_of_bits) of out without the bounds checks of BitVector::Set
+template <typename PositionFunction>
+void GatherBits(const std::byte* in, std::byte* out, std::size_t out_position,
+                std::size_t number_of_bits, PositionFunction position) {
+  for (std::size_t i = 0; i < number_of_bits; ++i) {
+    const std::size_t in_position{position(i)}, bit_position{out_position + i};
+    const auto bit{(in[in_position / 8] >> (in_position % 8)) & std::byte(1)};
+    out[bit_position / 8] |= bit << (bit_position % 8);
+  }
+}
+
+template <typename Allocator>
+BitVector<Allocator> BitVectorSubset(const BitVector<Allocator>& in,
+                                     std::span<const std::size_t> position_ids,
+                                     std::span<const SubsetRange> ranges) {
+  if (ranges.empty()) return in.Gather(position_ids);
+  BitVector<Allocator> out(position_ids.size());
+  const std::byte* in_data{in.GetData().data()};
+  std::byte* out_data{out.GetMutableData().data()};
+  std::size_t position{0};
+  for (const auto& range : ranges) {
+    const std::size_t from{range.from}, stride{range.stride}, length{range.length};
+    if (stride == 1 && length >= kMinimumWordCopyLength) {
+      out.Copy(position, position + length, in, from);
+    } else {
+      GatherBits(in_data, out_data, position, length,
+                 [from, stride](std::size_t i) { return from + i * stride; });
+    }
+    position += length;
+  }
+  return out;
+}
+
+template BitVector<StdAllocator> BitVectorSubset(const BitVector<StdAllocator>& in,
+                                                 std::span<const std::size_t> position_ids,
+                                                 std::span<const SubsetRange> ranges);
+template BitVector<AlignedAllocator> BitVectorSubset(const BitVector<AlignedAllocator>& in,
+                                                     std::span<const std::size_t> position_ids,
+                                                     std::span<const SubsetRange> ranges);
+
 void SubsetGate::EvaluateSetup() {
   if constexpr (kDebug) {
     GetLogger().LogDebug(
@@ -198,14 +260,11 @@ void SubsetGate::EvaluateSetup() {
       assert(out);
       in->GetSetupReadyCondition()->Wait();
 
-      for (std::size_t j = 0; j < parent_.size(); ++j) {
-        BitVectorSubsetImplementation(in->GetPermutationBits(), out->GetMutablePermutationBits(),
-                                      position_ids_);
-        out->GetMutableSecretKeys().resize(position_ids_.size());
-        for (std::size_t k = 0; k < position_ids_.size(); ++k) {
-          out->GetMutableSecretKeys()[k] = in->GetSecretKeys()[position_ids_[k]];
-        }
-      }
+      out->GetMutablePermutationBits() =
+          BitVectorSubset(in->GetPermutationBits(), position_ids_, ranges_);
+      out->GetMutableSecretKeys().resize(position_ids_.size());
+      CopySubset(in->GetSecretKeys().begin(), out->GetMutableSecretKeys().begin(), position_ids_,
+                 ranges_);
       out->SetSetupIsReady();
     }
   }
@@ -213,37 +272,30 @@ void SubsetGate::EvaluateSetup() {
 
 template <typename WireType>
 void ArithmeticSubsetOnlineImplementation(WirePointer parent_wire, WirePointer output_wire,
-                                          std::span<const std::size_t> position_ids) {
+                                          std::span<const std::size_t> position_ids,
+                                          std::span<const SubsetRange> ranges) {
   auto in = std::dynamic_pointer_cast<WireType>(parent_wire);
   assert(in);
   auto out = std::dynamic_pointer_cast<WireType>(output_wire);
   assert(out);
   out->GetMutableValues().resize(position_ids.size());
-
-  for (std::size_t i = 0; i < position_ids.size(); ++i) {
-    if constexpr (kDebug) {
-      if (position_ids[i] >= in->GetValues().size()) {
-        throw std::out_of_range(
-            fmt::format("Trying to access SIMD value #{} out of {} SIMD values in SubsetGate",
-                        position_ids[i], in->GetValues().size()));
-      }
-    }
-    out->GetMutableValues()[i] = in->GetValues()[position_ids[i]];
-  }
+  CopySubset(in->GetValues().begin(), out->GetMutableValues().begin(), position_ids, ranges);
 }
 
 template <typename T>
 void ArithmeticGmwSubsetOnline(WirePointer parent_wire, WirePointer output_wire,
-                               std::span<const std::size_t> position_ids) {
+                               std::span<const std::size_t> position_ids,
+                               std::span<const SubsetRange> ranges) {
   ArithmeticSubsetOnlineImplementation<proto::arithmetic_gmw::Wire<T>>(parent_wire, output_wire,
-                                                                       position_ids);
+                                                                       position_ids, ranges);
 }
 
 template <typename T>
 void ArithmeticConstantSubsetOnline(WirePointer parent_wire, WirePointer output_wire,
-                                    std::span<const std::size_t> position_ids) {
+                                    std::span<const std::size_t> position_ids,
+                                    std::span<const SubsetRange> ranges) {
   ArithmeticSubsetOnlineImplementation<proto::ConstantArithmeticWire<T>>(parent_wire, output_wire,
-                                                                         position_ids);
+                                                                         position_ids, ranges);
 }
 
 void SubsetGate::EvaluateOnline() {
@@ -260,22 +312,23 @@ void SubsetGate::EvaluateOnline() {
     case encrypto::motion::MpcProtocol::kArithmeticConstant: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          ArithmeticConstantSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticConstantSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0], position_ids_,
+                                                       ranges_);
           break;
         }
         case 16: {
-          ArithmeticConstantSubsetOnline<std::uint16_t>(parent_[0], output_wires_[0],
-                                                        position_ids_);
+          ArithmeticConstantSubsetOnline<std::uint16_t>(parent_[0], output_wires_[0], position_ids_,
+                                                        ranges_);
           break;
         }
         case 32: {
-          ArithmeticConstantSubsetOnline<std::uint32_t>(parent_[0], output_wires_[0],
-                                                        position_ids_);
+          ArithmeticConstantSubsetOnline<std::uint32_t>(parent_[0], output_wires_[0], position_ids_,
+                                                        ranges_);
           break;
         }
         case 64: {
-          ArithmeticConstantSubsetOnline<std::uint64_t>(parent_[0], output_wires_[0],
-                                                        position_ids_);
+          ArithmeticConstantSubsetOnline<std::uint64_t>(parent_[0], output_wires_[0], position_ids_,
+                                                        ranges_);
           break;
         }
         default:
@@ -288,19 +341,23 @@ void SubsetGate::EvaluateOnline() {
     case encrypto::motion::MpcProtocol::kArithmeticGmw: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          ArithmeticGmwSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0], position_ids_,
+                                                  ranges_);
           break;
         }
         case 16: {
-          ArithmeticGmwSubsetOnline<std::uint16_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint16_t>(parent_[0], output_wires_[0], position_ids_,
+                                                   ranges_);
           break;
         }
         case 32: {
-          ArithmeticGmwSubsetOnline<std::uint32_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint32_t>(parent_[0], output_wires_[0], position_ids_,
+                                                   ranges_);
           break;
         }
         case 64: {
-          ArithmeticGmwSubsetOnline<std::uint64_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint64_t>(parent_[0], output_wires_[0], position_ids_,
+                                                   ranges_);
           break;
         }
         default:
@@ -317,14 +374,11 @@ void SubsetGate::EvaluateOnline() {
         assert(in);
         auto out = std::dynamic_pointer_cast<proto::bmr::Wire>(output_wires_[i]);
         assert(out);
-        BitVectorSubsetImplementation(in->GetPublicValues(), out->GetMutablePublicValues(),
-                                      position_ids_);
+        out->GetMutablePublicValues() =
+            BitVectorSubset(in->GetPublicValues(), position_ids_, ranges_);
         out->GetMutablePublicKeys().resize(position_ids_.size() * number_of_parties);
-        for (std::size_t j = 0; j < position_ids_.size(); ++j) {
-          std::copy_n(in->GetPublicKeys().begin() + position_ids_[j] * number_of_parties,
-                      number_of_parties,
-                      out->GetMutablePublicKeys().begin() + j * number_of_parties);
-        }
+        CopySubset(in->GetPublicKeys().begin(), out->GetMutablePublicKeys().begin(), position_ids_,
+                   ranges_, number_of_parties);
       }
       break;
     }
@@ -334,8 +388,7 @@ void SubsetGate::EvaluateOnline() {
         assert(in);
         auto out = std::dynamic_pointer_cast<proto::ConstantBooleanWire>(output_wires_[i]);
         assert(out);
-        out->GetMutableValues().Resize(in->GetValues().GetSize());
-        BitVectorSubsetImplementation(in->GetValues(), out->GetMutableValues(), position_ids_);
+        out->GetMutableValues() = BitVectorSubset(in->GetValues(), position_ids_, ranges_);
       }
       break;
     }
@@ -345,8 +398,7 @@ void SubsetGate::EvaluateOnline() {
         assert(in);
         auto out = std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_[i]);
         assert(out);
-        out->GetMutableValues().Resize(in->GetValues().GetSize());
-        BitVectorSubsetImplementation(in->GetValues(), out->GetMutableValues(), position_ids_);
+        out->GetMutableValues() = BitVectorSubset(in->GetValues(), position_ids_, ranges_);
       }
       break;
     }
@@ -24,10 +24,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <span>
 #include <vector>
 
 #include "protocols/gate.h"
+#include "utility/bit_vector.h"
 
 namespace encrypto::motion {
 
@@ -36,10 +38,55 @@ using SharePointer = std::shared_ptr<Share>;
 
 class ShareWrapper;
 
+/// \brief the positions from, from + stride, ..., from + (length - 1) * stride of a subset.
+struct SubsetRange {
+  std::size_t from{0}, stride{1}, length{1};
+};
+
+/// \brief compresses position ids into runs of equidistant positions, e.g., {3, 4, 5, 7, 7, 7}
+/// into the ranges {.from = 3, .stride = 1, .length = 3} and {.from = 7, .stride = 0, .length = 3}.
+/// \returns no ranges if they would not have at least 2 positions on average, e.g., for random
+/// positions, which are gathered faster one by one.
+std::vector<SubsetRange> ToSubsetRanges(std::span<const std::size_t> position_ids);
+
+/// \brief returns the bits of in at position_ids, which are given by ranges from ToSubsetRanges.
+/// Runs of consecutive positions are copied word-wise instead of bit by bit.
+template <typename Allocator>
+BitVector<Allocator> BitVectorSubset(const BitVector<Allocator>& in,
+                                     std::span<const std::size_t> position_ids,
+                                     std::span<const SubsetRange> ranges);
+
+/// \brief copies the values at position_ids, which are given by ranges from ToSubsetRanges, from
+/// in to out, where each position consists of block_size consecutive values, e.g., the keys of
+/// all parties in a BMR wire. Runs of consecutive positions are copied at once.
+/// \returns the end of the output range
+template <typename InputIterator, typename OutputIterator>
+OutputIterator CopySubset(InputIterator in, OutputIterator out,
+                          std::span<const std::size_t> position_ids,
+                          std::span<const SubsetRange> ranges, std::size_t block_size = 1) {
+  if (ranges.empty()) {
+    for (const std::size_t position_id : position_ids) {
+      out = std::copy_n(in + position_id * block_size, block_size, out);
+    }
+    return out;
+  }
+  for (const auto& range : ranges) {
+    if (range.stride == 1) {
+      out = std::copy_n(in + range.from * block_size, range.length * block_size, out);
+    } else {
+      for (std::size_t i = 0; i < range.length; ++i) {
+        out = std::copy_n(in + (range.from + i * range.stride) * block_size, block_size, out);
+      }
+    }
+  }
+  return out;
+}
+
 /// \brief obtains a subset of SIMD values of a share at provided position ids.
 /// Repeated position ids are allowed, meaning that the number of SIMD values of the output share
 /// may be greater than the number of SIMD values of the parent share. Each of the position ids must
 /// be smaller than the number of SIMD values of the parent share.
+/// Runs of equidistant position ids are detected at construction, see ToSubsetRanges.
 class SubsetGate final : public OneGate {
  public:
   SubsetGate(const SharePointer& parent, std::span<const std::size_t> position_ids);
@@ -60,6 +107,7 @@ class SubsetGate final : public OneGate {
 
  private:
   const std::vector<std::size_t> position_ids_;
+  std::vector<SubsetRange> ranges_;
 };
 
 }  // namespace encrypto::motion
\ No newline at end of file
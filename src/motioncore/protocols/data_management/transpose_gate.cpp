@@ -0,0 +1,206 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "transpose_gate.h"
+
+#include "base/backend.h"
+#include "base/configuration.h"
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "protocols/boolean_gmw/boolean_gmw_share.h"
+#include "protocols/boolean_gmw/boolean_gmw_wire.h"
+#include "protocols/constant/constant_share.h"
+#include "protocols/constant/constant_wire.h"
+#include "protocols/garbled_circuit/garbled_circuit_share.h"
+#include "protocols/garbled_circuit/garbled_circuit_wire.h"
+#include "protocols/share.h"
+#include "utility/bit_matrix.h"
+#include "utility/constants.h"
+#include "utility/logger.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// the parent's wires are the rows of a bit matrix whose columns are the output wires
+template <typename WireType>
+void TransposeBits(std::span<const WirePointer> parent_wires, std::span<WirePointer> output_wires) {
+  std::vector<AlignedBitVector> rows;
+  rows.reserve(parent_wires.size());
+  for (const auto& wire : parent_wires) {
+    auto in{std::dynamic_pointer_cast<WireType>(wire)};
+    assert(in);
+    rows.emplace_back(in->GetValues().GetData().data(), in->GetValues().GetSize());
+  }
+  BitMatrix matrix(std::move(rows));
+  matrix.Transpose();
+  for (std::size_t j = 0; j < output_wires.size(); ++j) {
+    const auto& row{matrix.GetRow(j)};
+    auto out{std::dynamic_pointer_cast<WireType>(output_wires[j])};
+    assert(out);
+    out->GetMutableValues() = BitVector<>(row.GetData().data(), row.GetSize());
+  }
+}
+
+}  // namespace
+
+TransposeGate::TransposeGate(const SharePointer& parent) : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  if constexpr (kDebug) {
+    if (parent_.empty()) {
+      throw std::invalid_argument(
+          fmt::format("Input share in TransposeGate#{} has no wires", gate_id_));
+    }
+  }
+  const MpcProtocol protocol{parent_[0]->GetProtocol()};
+  const std::size_t number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+  if constexpr (kDebug) {
+    for (std::size_t i = 1; i < parent_.size(); ++i) {
+      if (parent_[i]->GetNumberOfSimdValues() != number_of_simd) {
+        throw std::invalid_argument(fmt::format(
+            "Input wires have different numbers of SIMD values in TransposeGate#{}", GetId()));
+      }
+    }
+  }
+
+  // Register output wires.
+  output_wires_.reserve(number_of_simd);
+  for (std::size_t i = 0; i < number_of_simd; ++i) {
+    switch (protocol) {
+      case MpcProtocol::kBooleanConstant: {
+        output_wires_.emplace_back(
+            GetRegister().EmplaceWire<proto::ConstantBooleanWire>(backend_, parent_.size()));
+        break;
+      }
+      case MpcProtocol::kBooleanGmw: {
+        output_wires_.emplace_back(
+            GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(backend_, parent_.size()));
+        break;
+      }
+      case MpcProtocol::kGarbledCircuit: {
+        output_wires_.emplace_back(
+            GetRegister().EmplaceWire<proto::garbled_circuit::Wire>(backend_, parent_.size()));
+        break;
+      }
+      default:
+        throw std::invalid_argument(fmt::format(
+            "TransposeGate#{} supports only Boolean GMW, Boolean constant and garbled circuit "
+            "shares, got protocol {}",
+            GetId(), to_string(protocol)));
+    }
+  }
+  is_garbler_ = protocol == MpcProtocol::kGarbledCircuit &&
+                GetCommunicationLayer().GetMyId() ==
+                    static_cast<std::size_t>(GarbledCircuitRole::kGarbler);
+}
+
+void TransposeGate::TransposeLabels() {
+  const std::size_t number_of_simd{output_wires_.size()};
+  std::vector<std::span<const Block128>> parent_keys;
+  parent_keys.reserve(parent_.size());
+  for (const auto& wire : parent_) {
+    auto gc_wire{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(wire)};
+    assert(gc_wire);
+    parent_keys.emplace_back(gc_wire->GetKeys());
+  }
+  for (std::size_t j = 0; j < number_of_simd; ++j) {
+    auto out{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(output_wires_[j])};
+    assert(out);
+    const auto keys{out->GetMutableKeys()};
+    for (std::size_t i = 0; i < parent_.size(); ++i) keys[i] = parent_keys[i][j];
+  }
+}
+
+void TransposeGate::EvaluateSetup() {
+  if (!is_garbler_) {
+    if constexpr (kDebug) {
+      GetLogger().LogDebug(
+          fmt::format("Nothing to do in the setup phase of TransposeGate with id#{}", gate_id_));
+    }
+    return;
+  }
+  for (auto& wire : parent_) {
+    auto gc_wire{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(wire)};
+    assert(gc_wire);
+    gc_wire->WaitSetup();
+  }
+  TransposeLabels();
+  for (auto& wire : output_wires_) {
+    auto gc_wire{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(wire)};
+    assert(gc_wire);
+    gc_wire->SetSetupIsReady();
+  }
+}
+
+void TransposeGate::EvaluateOnline() {
+  WaitSetup();
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+        fmt::format("Start evaluating online phase of TransposeGate with id#{}", gate_id_));
+  }
+  for (auto& wire : parent_) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  const MpcProtocol protocol{parent_[0]->GetProtocol()};
+  if (protocol == MpcProtocol::kGarbledCircuit) {
+    // the garbler's labels were transposed in the setup phase
+    if (!is_garbler_) TransposeLabels();
+  } else if (protocol == MpcProtocol::kBooleanGmw) {
+    TransposeBits<proto::boolean_gmw::Wire>(parent_, output_wires_);
+  } else {
+    TransposeBits<proto::ConstantBooleanWire>(parent_, output_wires_);
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+        fmt::format("Evaluated online phase of TransposeGate with id#{}", gate_id_));
+  }
+}
+
+SharePointer TransposeGate::GetOutputAsShare() const {
+  SharePointer result{nullptr};
+  switch (parent_[0]->GetProtocol()) {
+    case MpcProtocol::kBooleanConstant: {
+      result = std::make_shared<proto::ConstantBooleanShare>(output_wires_);
+      break;
+    }
+    case MpcProtocol::kBooleanGmw: {
+      result = std::make_shared<proto::boolean_gmw::Share>(output_wires_);
+      break;
+    }
+    case MpcProtocol::kGarbledCircuit: {
+      result = std::make_shared<proto::garbled_circuit::Share>(output_wires_);
+      break;
+    }
+    default:
+      throw std::invalid_argument(fmt::format("Unrecognized MpcProtocol in TransposeGate"));
+  }
+  assert(result);
+  return result;
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,71 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "protocols/gate.h"
+
+namespace encrypto::motion {
+
+class Share;
+using SharePointer = std::shared_ptr<Share>;
+
+/// \brief transposes the wires x SIMD values layout of a Boolean share, i.e., the output has as
+/// many wires as the parent has SIMD values and as many SIMD values as the parent has wires, where
+/// SIMD value i of output wire j is SIMD value j of parent wire i. This converts, e.g., n l-bit
+/// integers into l integers of n bits in one gate instead of n * l single-bit shares.
+/// The transposition is local: Boolean GMW and constant bits are transposed with
+/// BitMatrix::Transpose in the online phase, and the labels of garbled circuit wires are
+/// transposed by the garbler in the setup phase and by the evaluator in the online phase.
+///
+/// \throws invalid_argument if the parent is neither a Boolean GMW, Boolean constant nor garbled
+/// circuit share.
+class TransposeGate final : public OneGate {
+ public:
+  TransposeGate(const SharePointer& parent);
+
+  ~TransposeGate() = default;
+
+  void EvaluateSetup() override;
+
+  void EvaluateOnline() override;
+
+  bool NeedsSetup() const override { return is_garbler_; }
+
+  bool IsLocal() const override { return true; }
+
+  SharePointer GetOutputAsShare() const;
+
+  TransposeGate() = delete;
+
+  TransposeGate(const Gate&) = delete;
+
+ private:
+  // transposes the labels of the parent's garbled circuit wires into the output wires
+  void TransposeLabels();
+
+  bool is_garbler_{false};
+};
+
+}  // namespace encrypto::motion
@@ -189,6 +189,11 @@ UnsimdifyGate::UnsimdifyGate(const SharePointer& parent) : OneGate(parent->GetBa
         throw std::invalid_argument(fmt::format("Unrecognized MpcProtocol in UnsimdifyGate"));
     }
   }
+  if (protocol == MpcProtocol::kAstra) {
+    // rearranging the values does not add a multiplication layer
+    proto::astra::SetMultiplicativeDepth(output_wires_,
+                                         proto::astra::GetMaximumMultiplicativeDepth(parent_));
+  }
 }
 
 void UnsimdifyGate::EvaluateSetup() {
@@ -207,7 +212,7 @@ void UnsimdifyGate::EvaluateSetup() {
             std::dynamic_pointer_cast<proto::bmr::Wire>(output_wires_[j * parent_.size() + i]);
         assert(out);
 
-        out->GetMutablePermutationBits() = in->GetPermutationBits().Subset(j, j + 1);
+        out->GetMutablePermutationBits() = BitVector<>(1, in->GetPermutationBits().Get(j));
         out->GetMutableSecretKeys().resize(1);
         out->GetMutableSecretKeys()[0] = in->GetSecretKeys()[j];
         out->SetSetupIsReady();
@@ -342,7 +347,7 @@ void UnsimdifyGate::EvaluateOnline() {
           auto out =
               std::dynamic_pointer_cast<proto::bmr::Wire>(output_wires_[j * parent_.size() + i]);
           assert(out);
-          out->GetMutablePublicValues() = in->GetPublicValues().Subset(j, j + 1);
+          out->GetMutablePublicValues() = BitVector<>(1, in->GetPublicValues().Get(j));
           out->GetMutablePublicKeys().resize(number_of_parties);
           std::copy_n(in->GetPublicKeys().begin() + j * number_of_parties, number_of_parties,
                       out->GetMutablePublicKeys().begin());
@@ -358,7 +363,7 @@ void UnsimdifyGate::EvaluateOnline() {
           auto out = std::dynamic_pointer_cast<proto::ConstantBooleanWire>(
               output_wires_[j * parent_.size() + i]);
           assert(out);
-          out->GetMutableValues() = in->GetValues().Subset(j, j + 1);
+          out->GetMutableValues() = BitVector<>(1, in->GetValues().Get(j));
         }
       }
       break;
@@ -371,7 +376,7 @@ void UnsimdifyGate::EvaluateOnline() {
           auto out = std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(
               output_wires_[j * parent_.size() + i]);
           assert(out);
-          out->GetMutableValues() = in->GetValues().Subset(j, j + 1);
+          out->GetMutableValues() = BitVector<>(1, in->GetValues().Get(j));
         }
       }
       break;
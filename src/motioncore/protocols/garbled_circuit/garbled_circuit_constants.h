@@ -37,4 +37,11 @@ static constexpr std::size_t kGarbledRowByteSize{kGarbledRowBitSize / 8};
 static constexpr std::size_t kGarbledTableBitSize{kGarbledRowBitSize * 3};
 static constexpr std::size_t kGarbledTableByteSize{kGarbledTableBitSize / 8};
 
+// the half-gates tables consist of the full rows of the garbler and the evaluator half gate
+static constexpr std::size_t kHalfGatesTableByteSize{2 * kKappa / 8};
+
+// number of SIMD lanes whose hashes are computed in one batch, i.e., 96 blocks when garbling and
+// 48 blocks when evaluating, which fill two or one batches of the VAES implementation
+static constexpr std::size_t kLanesPerHashBatch{16};
+
 }  // namespace encrypto::motion::proto::garbled_circuit
@@ -24,6 +24,9 @@
 
 #include "garbled_circuit_gate.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "communication/garbled_circuit_message.h"
 #include "communication/message.h"
 #include "garbled_circuit_constants.h"
@@ -31,9 +34,35 @@
 #include "oblivious_transfer/ot_provider.h"
 #include "protocols/constant/constant_share.h"
 #include "utility/block.h"
+#include "utility/helpers.h"
 
 namespace encrypto::motion::proto::garbled_circuit {
 
+namespace {
+
+// creates the output wires of a gate, whose labels are allocated adjacently in the label arena
+std::vector<motion::WirePointer> MakeOutputWires(Backend& backend, Register& gate_register,
+                                                 std::size_t number_of_wires,
+                                                 std::size_t number_of_simd) {
+  auto labels{backend.GetGarbledCircuitProvider().GetLabelArena().Allocate(number_of_wires *
+                                                                           number_of_simd)};
+  std::vector<motion::WirePointer> wires(number_of_wires);
+  for (std::size_t wire_i = 0; wire_i < number_of_wires; ++wire_i) {
+    wires[wire_i] = gate_register.EmplaceWire<garbled_circuit::Wire>(
+        ArenaLabels{labels.chunk, labels.labels.subspan(wire_i * number_of_simd, number_of_simd)},
+        backend);
+  }
+  return wires;
+}
+
+// prefetches the first labels of a wire, which are needed by the next gate evaluation
+void PrefetchLabels(const motion::WirePointer& wire) {
+  auto gc_wire{std::static_pointer_cast<garbled_circuit::Wire>(wire)};
+  __builtin_prefetch(gc_wire->GetKeys().data());
+}
+
+}  // namespace
+
 InputGate::InputGate(std::size_t input_owner_id, std::size_t number_of_wires,
                      std::size_t number_of_simd, Backend& backend)
     : Base(backend),
@@ -78,6 +107,9 @@ const SharePointer InputGate::GetOutputAsGarbledCircuitShare() {
 InputGateGarbler::InputGateGarbler(std::size_t input_owner_id, std::size_t number_of_wires,
                                    std::size_t number_of_simd, Backend& backend)
     : Base(input_owner_id, number_of_wires, number_of_simd, backend) {
+  first_label_index_ =
+      dynamic_cast<ThreeHalvesGarblerProvider&>(backend.GetGarbledCircuitProvider())
+          .ReserveInputLabels(number_of_wires * number_of_simd);
   // If this is not the garbler's input, the evaluator obtains the label via OT, so register the
   // sender OT object.
   if (!is_my_input_) {
@@ -101,10 +133,12 @@ InputGateGarbler::InputGateGarbler(std::vector<BitVector<>>&& input, std::size_t
 }
 
 void InputGateGarbler::EvaluateSetup() {
-  for (auto& wire : output_wires_) {
-    auto gc_wire = std::dynamic_pointer_cast<garbled_circuit::Wire>(wire);
+  auto& provider{dynamic_cast<ThreeHalvesGarblerProvider&>(GetGarbledCircuitProvider())};
+  for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
+    auto gc_wire = std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i]);
     assert(gc_wire);
-    gc_wire->GetMutableKeys() = Block128Vector::MakeRandom(number_of_simd_);
+    provider.GenerateInputLabels(first_label_index_ + wire_i * number_of_simd_,
+                                 gc_wire->GetMutableKeys());
     // set the bits at positions where we will store the r vector to 0
     for (auto& key : gc_wire->GetMutableKeys()) {
       BitSpan key_span(key.data(), kKappa);
@@ -130,29 +164,20 @@ void InputGateGarbler::EvaluateOnline() {
             "Optional input promise/future must be instantiated for evaluator's input gates");
       }
     }
-    auto zero = Block128::MakeZero();
     // send the labels corresponding to the inputs to the evaluator
     std::vector<BitVector<>> inputs{input_promise_future_->second.get()};
-    std::vector<std::uint8_t> input_labels(Block128::kBlockSize * number_of_wires_ *
-                                           number_of_simd_);
+    Block128Vector input_labels(number_of_wires_ * number_of_simd_);
     for (std::size_t wire_i = 0; wire_i < number_of_wires_; ++wire_i) {
       auto gc_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i])};
       assert(gc_wire);
-      for (std::size_t simd_j = 0; simd_j < number_of_simd_; ++simd_j) {
-        const Block128& offset_or_zero = inputs[wire_i][simd_j] ? offset : zero;
-        const auto lhs_data{std::assume_aligned<Block128::kBlockSize>(
-            reinterpret_cast<const std::uint8_t* __restrict__>(offset_or_zero.data()))};
-        const auto rhs_data{std::assume_aligned<Block128::kBlockSize>(
-            reinterpret_cast<const std::uint8_t* __restrict__>(gc_wire->GetKeys()[simd_j].data()))};
-        auto output_data{reinterpret_cast<std::uint8_t* __restrict__>(
-            input_labels.data() + Block128::kBlockSize * (number_of_simd_ * wire_i + simd_j))};
-        std::transform(lhs_data, lhs_data + Block128::kBlockSize, rhs_data, output_data,
-                       [](const std::uint8_t& lhs, const std::uint8_t& rhs) { return lhs ^ rhs; });
-      }
+      SelectXorBlocks(inputs[wire_i].GetData().data(), gc_wire->GetKeys().data(), offset,
+                      input_labels.data() + number_of_simd_ * wire_i, number_of_simd_);
     }
     // Send garbler's input labels to the evaluator.
     flatbuffers::FlatBufferBuilder builder{communication::BuildMessage(
-        communication::MessageType::kGarbledCircuitInput, gate_id_, input_labels)};
+        communication::MessageType::kGarbledCircuitInput, gate_id_,
+        std::span(reinterpret_cast<const std::uint8_t*>(input_labels.data()),
+                  input_labels.ByteSize()))};
 
     backend_.GetCommunicationLayer().SendMessage(
         static_cast<std::size_t>(GarbledCircuitRole::kEvaluator), builder.Release());
@@ -224,24 +249,23 @@ void InputGateEvaluator::EvaluateOnline() {
     ot_receiver->ComputeOutputs();
     const Block128Vector& output_labels{ot_receiver->GetOutputs()};
     for (std::size_t wire_i = 0; wire_i < number_of_wires_; ++wire_i) {
-      Block128Vector labels(output_labels.begin() + wire_i * number_of_simd_,
-                            output_labels.begin() + (wire_i + 1) * number_of_simd_);
       auto gc_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i])};
-      gc_wire->GetMutableKeys() = std::move(labels);
+      std::copy(output_labels.begin() + wire_i * number_of_simd_,
+                output_labels.begin() + (wire_i + 1) * number_of_simd_,
+                gc_wire->GetMutableKeys().begin());
     }
   } else {  // garbler's input
-    auto& label_future{std::get<ReusableFiberFuture<std::vector<std::uint8_t>>>(label_source_)};
+    auto& label_future{std::get<ReusableFiberFuture<communication::MessageBuffer>>(label_source_)};
     auto labels_msg{label_future.get()};
     const auto payload = communication::GetMessage(labels_msg.data())->payload();
     assert(payload->size() == (Block128::kBlockSize * number_of_wires_ * number_of_simd_));
 
     for (std::size_t wire_i = 0; wire_i < number_of_wires_; ++wire_i) {
-      const auto wire_block_ptr{reinterpret_cast<const Block128*>(
-          payload->data() + wire_i * Block128::kBlockSize * number_of_simd_)};
+      const auto wire_labels{payload->data() + wire_i * Block128::kBlockSize * number_of_simd_};
       auto gc_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i])};
       assert(gc_wire);
-      gc_wire->GetMutableKeys().resize(number_of_simd_);
-      std::copy_n(wire_block_ptr, number_of_simd_, gc_wire->GetMutableKeys().data());
+      std::memcpy(gc_wire->GetMutableKeys().data(), wire_labels,
+                  Block128::kBlockSize * number_of_simd_);
     }
   }
 }
@@ -250,18 +274,24 @@ OutputGate::OutputGate(motion::SharePointer parent, std::size_t output_owner)
     : Base(parent->GetBackend()),
       output_owner_(output_owner),
       everyones_output_(output_owner == kAll),
-      my_output_(everyones_output_ || (output_owner == GetCommunicationLayer().GetMyId())) {
+      my_output_(everyones_output_ || (output_owner == GetCommunicationLayer().GetMyId())),
+      is_garbler_(GetCommunicationLayer().GetMyId() ==
+                  static_cast<std::size_t>(GarbledCircuitRole::kGarbler)) {
   parent_ = parent->GetWires();
   output_wires_.resize(parent_.size());
   for (auto& wire : output_wires_) {
     wire = GetRegister().EmplaceWire<ConstantBooleanWire>(backend_,
                                                           parent_[0]->GetNumberOfSimdValues());
   }
-  if (my_output_) {
-    std::size_t other_party_id{1 - GetCommunicationLayer().GetMyId()};
+  constexpr auto kEvaluatorId{static_cast<std::size_t>(GarbledCircuitRole::kEvaluator)};
+  if (everyones_output_ || output_owner == kEvaluatorId) {
+    decoding_position_ = GetGarbledCircuitProvider().GetGarbledTableStream().Reserve(
+        BitsToBytes(parent_.size() * parent_[0]->GetNumberOfSimdValues()));
+  }
+  if (my_output_ && is_garbler_) {
     output_future_ = std::optional{GetCommunicationLayer().GetMessageManager().RegisterReceive(
-        other_party_id, communication::MessageType::kGarbledCircuitOutput,
-        static_cast<std::size_t>(gate_id_))};
+        static_cast<std::size_t>(GarbledCircuitRole::kEvaluator),
+        communication::MessageType::kGarbledCircuitOutput, static_cast<std::size_t>(gate_id_))};
   }
 }
 
@@ -271,14 +301,28 @@ const std::shared_ptr<ConstantBooleanShare> OutputGate::GetOutputAsConstantShare
   return result;
 }
 
-void OutputGate::EvaluateSetup() {}
+void OutputGate::EvaluateSetup() {
+  // the garbler's zero labels are known after the setup phase, so their permutation bits are sent
+  // to the evaluator along with the garbled tables
+  BitVector<> permutation_bits;
+  permutation_bits.Reserve(parent_.size() * parent_[0]->GetNumberOfSimdValues());
+  for (std::size_t wire_i = 0; wire_i < parent_.size(); ++wire_i) {
+    auto gc_parent_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_[wire_i])};
+    assert(gc_parent_wire);
+    gc_parent_wire->WaitSetup();
+    permutation_bits.Append(gc_parent_wire->CopyPermutationBits());
+  }
+  auto& garbled_table_stream{GetGarbledCircuitProvider().GetGarbledTableStream()};
+  std::copy(permutation_bits.GetData().begin(), permutation_bits.GetData().end(),
+            garbled_table_stream.GetMutableTables(*decoding_position_));
+  garbled_table_stream.FinishTables(*decoding_position_);
+}
 
 void OutputGate::EvaluateOnline() {
   for (auto& wire : parent_) wire->GetIsReadyCondition().Wait();
 
-  // if not this party's output or everyone gets the outputs, parse and send the permutation bits to
-  // the other party.
-  if ((!my_output_) || everyones_output_) {
+  // if the garbler gets the output, the evaluator sends its permutation bits to the garbler
+  if (!is_garbler_ && (!my_output_ || everyones_output_)) {
     BitVector<> permutation_bits;
     permutation_bits.Reserve(parent_.size() * parent_[0]->GetNumberOfSimdValues());
     for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
@@ -290,17 +334,28 @@ void OutputGate::EvaluateOnline() {
         communication::MessageType::kGarbledCircuitOutput, gate_id_,
         std::span(reinterpret_cast<const std::uint8_t*>(permutation_bits.GetData().data()),
                   permutation_bits.GetData().size()))};
-    auto other_partys_id{static_cast<std::size_t>(1) - GetCommunicationLayer().GetMyId()};
-    GetCommunicationLayer().SendMessage(other_partys_id, fbb.Release());
+    GetCommunicationLayer().SendMessage(static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
+                                        fbb.Release());
   }
-  // if this party gets the output, wait for the other party's permutation bits to get transmitted
-  // and xor them with own permutation bits, which yields the plaintext result.
+  // if this party gets the output, xor the other party's permutation bits with the own
+  // permutation bits, which yields the plaintext result. The evaluator reads the garbler's bits
+  // from the garbled table stream, which usually arrived in the setup phase already.
   if (my_output_) {
-    assert(output_future_.has_value());
-    auto permutation_bits_msg{output_future_->get()};
-    auto permutation_bits = communication::GetMessage(permutation_bits_msg.data())->payload();
     std::size_t number_of_simd{parent_[0]->GetNumberOfSimdValues()};
-    BitSpan permutation_bits_span(const_cast<std::uint8_t*>(permutation_bits->data()),
+    communication::MessageBuffer permutation_bits_message;
+    const std::uint8_t* permutation_bits;
+    auto& garbled_table_stream{GetGarbledCircuitProvider().GetGarbledTableStream()};
+    if (is_garbler_) {
+      assert(output_future_.has_value());
+      permutation_bits_message = output_future_->get();
+      permutation_bits =
+          communication::GetMessage(permutation_bits_message.data())->payload()->data();
+    } else {
+      assert(decoding_position_.has_value());
+      permutation_bits = reinterpret_cast<const std::uint8_t*>(
+          garbled_table_stream.GetTables(*decoding_position_));
+    }
+    BitSpan permutation_bits_span(const_cast<std::uint8_t*>(permutation_bits),
                                   number_of_simd * output_wires_.size());
     for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
       auto gc_parent_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_[wire_i])};
@@ -311,6 +366,7 @@ void OutputGate::EvaluateOnline() {
       output_wire->GetMutableValues() ^=
           permutation_bits_span.Subset(wire_i * number_of_simd, (wire_i + 1) * number_of_simd);
     }
+    if (!is_garbler_) garbled_table_stream.ReleaseTables(*decoding_position_);
   }
 }
 
@@ -319,11 +375,8 @@ XorGate::XorGate(motion::SharePointer parent_a, motion::SharePointer parent_b)
   parent_a_ = parent_a->GetWires();
   parent_b_ = parent_b->GetWires();
   assert(parent_a_.size() == parent_b_.size());
-  output_wires_.resize(parent_a_.size());
-  for (auto& wire : output_wires_) {
-    wire = GetRegister().EmplaceWire<garbled_circuit::Wire>(backend_,
-                                                            parent_a_[0]->GetNumberOfSimdValues());
-  }
+  output_wires_ = MakeOutputWires(backend_, GetRegister(), parent_a_.size(),
+                                  parent_a_[0]->GetNumberOfSimdValues());
 }
 
 SharePointer XorGate::GetOutputAsGarbledCircuitShare() const {
@@ -349,7 +402,9 @@ void XorGateGarbler::EvaluateSetup() {
     assert(gc_wire_out);
     gc_wire_a->WaitSetup();
     gc_wire_b->WaitSetup();
-    gc_wire_out->GetMutableKeys() = gc_wire_a->GetKeys() ^ gc_wire_b->GetKeys();
+    const auto keys_a{gc_wire_a->GetKeys()};
+    XorBlocks(keys_a.data(), gc_wire_b->GetKeys().data(), gc_wire_out->GetMutableKeys().data(),
+              keys_a.size());
     gc_wire_out->SetSetupIsReady();
   }
 }
@@ -372,17 +427,16 @@ void XorGateEvaluator::EvaluateOnline() {
     assert(gc_wire_out);
     gc_wire_a->GetIsReadyCondition().Wait();
     gc_wire_b->GetIsReadyCondition().Wait();
-    gc_wire_out->GetMutableKeys() = gc_wire_a->GetKeys() ^ gc_wire_b->GetKeys();
+    const auto keys_a{gc_wire_a->GetKeys()};
+    XorBlocks(keys_a.data(), gc_wire_b->GetKeys().data(), gc_wire_out->GetMutableKeys().data(),
+              keys_a.size());
   }
 }
 
 InvGate::InvGate(motion::SharePointer parent) : Base(parent->GetBackend()) {
   parent_ = parent->GetWires();
-  output_wires_.resize(parent_.size());
-  for (auto& wire : output_wires_) {
-    wire = GetRegister().EmplaceWire<garbled_circuit::Wire>(backend_,
-                                                            parent_[0]->GetNumberOfSimdValues());
-  }
+  output_wires_ =
+      MakeOutputWires(backend_, GetRegister(), parent_.size(), parent_[0]->GetNumberOfSimdValues());
 }
 
 SharePointer InvGate::GetOutputAsGarbledCircuitShare() const {
@@ -409,8 +463,8 @@ void InvGateGarbler::EvaluateSetup() {
     assert(gc_wire_in);
     assert(gc_wire_out);
     gc_wire_in->WaitSetup();
-    gc_wire_out->GetMutableKeys() = gc_wire_in->GetKeys();
-    for (auto& key : gc_wire_out->GetMutableKeys()) key ^= offset;
+    const auto keys_in{gc_wire_in->GetKeys()};
+    XorBlocks(keys_in.data(), offset, gc_wire_out->GetMutableKeys().data(), keys_in.size());
     gc_wire_out->SetSetupIsReady();
   }
 }
@@ -430,7 +484,7 @@ void InvGateEvaluator::EvaluateOnline() {
     assert(gc_wire_in);
     assert(gc_wire_out);
     gc_wire_in->GetIsReadyCondition().Wait();
-    gc_wire_out->GetMutableKeys() = gc_wire_in->GetKeys();
+    std::ranges::copy(gc_wire_in->GetKeys(), gc_wire_out->GetMutableKeys().begin());
   }
 }
 
@@ -441,11 +495,17 @@ AndGate::AndGate(motion::SharePointer parent_a, motion::SharePointer parent_b)
   parent_b_ = parent_b->GetWires();
 
   assert(parent_a_.size() == parent_b_.size());
-  output_wires_.resize(parent_a_.size());
-  for (auto& wire : output_wires_) {
-    wire = GetRegister().EmplaceWire<garbled_circuit::Wire>(backend_,
-                                                            parent_a_[0]->GetNumberOfSimdValues());
-  }
+  output_wires_ = MakeOutputWires(backend_, GetRegister(), parent_a_.size(),
+                                  parent_a_[0]->GetNumberOfSimdValues());
+
+  // the size of the tables depends on the garbling scheme
+  auto& provider{GetGarbledCircuitProvider()};
+  std::size_t total_number_of_wires{parent_a_.size() * parent_a_[0]->GetNumberOfSimdValues()};
+  tables_byte_size_ = total_number_of_wires * provider.GetGarbledTableByteSize();
+  first_table_index_ = provider.ReserveGarbledTables(total_number_of_wires);
+  table_stream_position_ = provider.GetGarbledTableStream().Reserve(
+      tables_byte_size_ +
+      BitsToBytes(total_number_of_wires * provider.GetGarbledControlBitsBitSize()));
 }
 
 SharePointer AndGate::GetOutputAsGarbledCircuitShare() const {
@@ -465,13 +525,17 @@ void AndGateGarbler::EvaluateSetup() {
   auto& provider{dynamic_cast<ThreeHalvesGarblerProvider&>(GetGarbledCircuitProvider())};
   provider.WaitSetup();
   std::size_t number_of_simd{parent_a_[0]->GetNumberOfSimdValues()};
-  std::size_t total_number_of_wires{parent_a_.size() * number_of_simd};
-  std::size_t tables_byte_size{total_number_of_wires * kGarbledTableByteSize};
-  // avoid using std::vector to not initialize the memory
-  std::size_t payload_size{
-      BitsToBytes(total_number_of_wires * (kGarbledTableBitSize + kGarbledControlBitsBitSize))};
-  auto garbled_tables_and_control_bits{std::make_unique<std::byte[]>(payload_size)};
-  std::byte* control_bits{(garbled_tables_and_control_bits.get()) + tables_byte_size};
+  auto& garbled_table_stream{provider.GetGarbledTableStream()};
+  std::byte* garbled_tables{garbled_table_stream.GetMutableTables(table_stream_position_)};
+  std::byte* control_bits{garbled_tables + tables_byte_size_};
+
+  const std::size_t number_of_tables{output_wires_.size() * number_of_simd};
+  const std::size_t number_of_threads{GetNumberOfParallelThreads(number_of_tables)};
+  if (number_of_threads > 1) {
+    GarbleInParallel(provider, garbled_tables, control_bits, number_of_threads);
+    garbled_table_stream.FinishTables(table_stream_position_);
+    return;
+  }
 
   // Remark: it's not necessary to wait for the provider's setup phase, since all the required
   // information (hash and aes key) is generated in the constructor.
@@ -490,34 +554,61 @@ void AndGateGarbler::EvaluateSetup() {
                                       gc_wire_out->GetWireId())};
       GetLogger().LogDebug(std::move(message));
     }
-    gc_wire_out->GetMutableKeys().resize(number_of_simd);
     provider.Garble(gc_wire_a->GetKeys(), gc_wire_b->GetKeys(), gc_wire_out->GetMutableKeys(),
-                    garbled_tables_and_control_bits.get(), control_bits, wire_i * number_of_simd,
-                    gate_id_ + wire_i);
+                    garbled_tables, control_bits, wire_i * number_of_simd, gate_id_ + wire_i,
+                    first_table_index_ + wire_i * number_of_simd);
     gc_wire_out->SetSetupIsReady();
   }
 
-  auto builder{communication::BuildMessage(
-      communication::MessageType::kGarbledCircuitGarbledTables, gate_id_,
-      std::span(reinterpret_cast<const std::uint8_t*>(garbled_tables_and_control_bits.get()),
-                payload_size))};
-  backend_.GetCommunicationLayer().SendMessage(
-      static_cast<std::size_t>(GarbledCircuitRole::kEvaluator), builder.Release());
+  // the chunk containing the tables is sent as soon as all of its gates are garbled
+  garbled_table_stream.FinishTables(table_stream_position_);
+}
+
+void AndGateGarbler::GarbleInParallel(ThreeHalvesGarblerProvider& provider,
+                                      std::byte* garbled_tables, std::byte* control_bits,
+                                      std::size_t number_of_threads) {
+  std::vector<garbled_circuit::Wire*> wires_a, wires_b, wires_out;
+  for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
+    wires_a.emplace_back(dynamic_cast<garbled_circuit::Wire*>(parent_a_[wire_i].get()));
+    wires_b.emplace_back(dynamic_cast<garbled_circuit::Wire*>(parent_b_[wire_i].get()));
+    wires_out.emplace_back(dynamic_cast<garbled_circuit::Wire*>(output_wires_[wire_i].get()));
+    assert(wires_a.back() && wires_b.back() && wires_out.back());
+    // the worker threads do not run fibers, so they cannot wait themselves
+    wires_a.back()->WaitSetup();
+    wires_b.back()->WaitSetup();
+  }
+
+  // The tables of all wires are split into contiguous segments of the buffer, one per thread. The
+  // segments start at multiples of 8 tables, such that no two threads write into the same byte of
+  // the bit-packed garbled control bits.
+  const std::size_t number_of_simd{parent_a_[0]->GetNumberOfSimdValues()};
+  ParallelForRanges(
+      output_wires_.size() * number_of_simd, number_of_threads, 8,
+      [&](std::size_t begin, std::size_t end) {
+        while (begin < end) {
+          const std::size_t wire_i{begin / number_of_simd}, simd_i{begin % number_of_simd};
+          const std::size_t count{std::min(end - begin, number_of_simd - simd_i)};
+          provider.Garble(wires_a[wire_i]->GetKeys().subspan(simd_i, count),
+                          wires_b[wire_i]->GetKeys().subspan(simd_i, count),
+                          wires_out[wire_i]->GetMutableKeys().subspan(simd_i, count),
+                          garbled_tables, control_bits, begin, gate_id_ + wire_i + simd_i,
+                          first_table_index_ + begin);
+          begin += count;
+        }
+      });
+  for (auto wire : wires_out) wire->SetSetupIsReady();
 }
 
 void AndGateGarbler::EvaluateOnline() {}
 
 AndGateEvaluator::AndGateEvaluator(motion::SharePointer parent_a, motion::SharePointer parent_b)
-    : Base(parent_a, parent_b) {
-  garbled_tables_msg_future_ = GetCommunicationLayer().GetMessageManager().RegisterReceive(
-      static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
-      communication::MessageType::kGarbledCircuitGarbledTables, gate_id_);
-}
+    : Base(parent_a, parent_b) {}
 
 void AndGateEvaluator::EvaluateSetup() {
   auto& provider{dynamic_cast<ThreeHalvesEvaluatorProvider&>(GetGarbledCircuitProvider())};
   provider.WaitSetup();
-  garbled_tables_msg_future_.wait(); }
+  garbled_tables_ = provider.GetGarbledTableStream().GetTables(table_stream_position_);
+}
 
 void AndGateEvaluator::EvaluateOnline() {
   auto& provider{dynamic_cast<ThreeHalvesEvaluatorProvider&>(GetGarbledCircuitProvider())};
@@ -525,8 +616,6 @@ void AndGateEvaluator::EvaluateOnline() {
   for (auto& wire : parent_b_) wire->GetIsReadyCondition().Wait();
   std::size_t number_of_simd{parent_a_[0]->GetNumberOfSimdValues()};
 
-  auto garbled_tables_msg{garbled_tables_msg_future_.get()};
-  auto garbled_tables{communication::GetMessage(garbled_tables_msg.data())->payload()};
   for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
     auto gc_wire_a{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_a_[wire_i])};
     auto gc_wire_b{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_b_[wire_i])};
@@ -540,13 +629,21 @@ void AndGateEvaluator::EvaluateOnline() {
                                       gc_wire_out->GetWireId())};
       GetLogger().LogDebug(std::move(message));
     }
-    gc_wire_out->GetMutableKeys().resize(number_of_simd);
-    std::size_t tables_size{output_wires_.size() * number_of_simd * kGarbledTableByteSize};
+    // the labels of the next wires are usually adjacent to the ones of this wire, so prefetching
+    // them while this wire is evaluated hides the latency of the first accesses
+    if (wire_i + 1 < output_wires_.size()) {
+      PrefetchLabels(parent_a_[wire_i + 1]);
+      PrefetchLabels(parent_b_[wire_i + 1]);
+    }
     provider.Evaluate(gc_wire_a->GetKeys(), gc_wire_b->GetKeys(), gc_wire_out->GetMutableKeys(),
-                      reinterpret_cast<const std::byte*>(garbled_tables->data()),
-                      reinterpret_cast<const std::byte*>(garbled_tables->data() + tables_size),
-                      wire_i * number_of_simd, gate_id_ + wire_i);
+                      garbled_tables_, garbled_tables_ + tables_byte_size_,
+                      wire_i * number_of_simd, gate_id_ + wire_i,
+                      first_table_index_ + wire_i * number_of_simd);
   }
+
+  // the chunk containing the tables is freed as soon as all of its gates are evaluated
+  provider.GetGarbledTableStream().ReleaseTables(table_stream_position_);
+  garbled_tables_ = nullptr;
 }
 
 }  // namespace encrypto::motion::proto::garbled_circuit
\ No newline at end of file
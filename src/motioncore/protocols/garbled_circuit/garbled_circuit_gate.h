@@ -32,6 +32,8 @@
 #include "communication/communication_layer.h"
 #include "garbled_circuit_share.h"
 #include "garbled_circuit_wire.h"
+#include "garbled_table_stream.h"
+#include "communication/message_buffer.h"
 #include "protocols/gate.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
@@ -53,6 +55,8 @@ class ConstantBooleanShare;
 
 namespace encrypto::motion::proto::garbled_circuit {
 
+class ThreeHalvesGarblerProvider;
+
 class InputGate : public motion::InputGate {
  public:
   using Base = motion::InputGate;
@@ -120,6 +124,8 @@ class InputGateGarbler final : public garbled_circuit::InputGate {
  private:
   /// Promise is only required if the gate for own input is created.
   std::unique_ptr<GOt128Sender> ots_for_evaluators_inputs_{nullptr};
+  // index of the first zero label among all input labels of the circuit
+  std::size_t first_label_index_;
 };
 
 class InputGateEvaluator final : public garbled_circuit::InputGate {
@@ -159,7 +165,7 @@ class InputGateEvaluator final : public garbled_circuit::InputGate {
   /// If this is the evaluator's input, the input label is obtained via OT. If this is the garbler's
   /// input, the corresponding label is simply transmitted to the evaluator by the garbler and
   /// retrieved by the evaluator from the future object.
-  std::variant<ReusableFiberFuture<std::vector<std::uint8_t>>, std::unique_ptr<GOt128Receiver>>
+  std::variant<ReusableFiberFuture<communication::MessageBuffer>, std::unique_ptr<GOt128Receiver>>
       label_source_;
 };
 
@@ -177,7 +183,9 @@ class OutputGate : public motion::OutputGate {
 
   ~OutputGate() override = default;
 
-  bool NeedsSetup() const override { return false; }
+  /// \brief Only the garbler needs the setup phase to write the decoding information of the
+  /// evaluator into the garbled table stream.
+  bool NeedsSetup() const override { return is_garbler_ && decoding_position_.has_value(); }
 
   /// \brief Evaluates the setup phase.
   void EvaluateSetup() override;
@@ -192,9 +200,16 @@ class OutputGate : public motion::OutputGate {
   const bool everyones_output_;
   /// Flag indicating if this party is the output owner.
   const bool my_output_;
-  /// The output owner retrieves the cleartext output via the output future registered in
-  /// MessageHandler.
-  std::optional<ReusableFiberFuture<std::vector<std::uint8_t>>> output_future_;
+  /// Flag indicating if this party is the garbler.
+  const bool is_garbler_;
+  /// If the evaluator obtains the output, the permutation bits of the garbler's zero labels are
+  /// transferred at this position of the garbled table stream, i.e., together with the garbled
+  /// tables in the setup phase, so that the evaluator decodes the output as soon as the labels
+  /// are evaluated.
+  std::optional<GarbledTableStreamPosition> decoding_position_;
+  /// If the garbler obtains the output, it retrieves the evaluator's permutation bits via the
+  /// output future registered in MessageHandler.
+  std::optional<ReusableFiberFuture<communication::MessageBuffer>> output_future_;
 };
 
 class XorGate : public motion::TwoGate {
@@ -315,6 +330,12 @@ class AndGate : public motion::TwoGate {
 
  protected:
   AndGate(motion::SharePointer parent_a, motion::SharePointer parent_b);
+
+  // garbled tables of all wires, followed by their garbled control bits
+  std::size_t tables_byte_size_;
+  GarbledTableStreamPosition table_stream_position_;
+  // index of the first table among all garbled tables of the circuit
+  std::size_t first_table_index_;
 };
 
 //  /// Index that is used as a tweak in the (T)MMO construction. The wire id cannot be used for
@@ -336,6 +357,12 @@ class AndGateGarbler final : public AndGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+
+ private:
+  // garbles the tables of all wires over number_of_threads OpenMP threads, see
+  // Configuration::SetParallelGateThreshold
+  void GarbleInParallel(ThreeHalvesGarblerProvider& provider, std::byte* garbled_tables,
+                        std::byte* control_bits, std::size_t number_of_threads);
 };
 
 class AndGateEvaluator final : public AndGate {
@@ -353,7 +380,7 @@ class AndGateEvaluator final : public AndGate {
   void EvaluateOnline() override;
 
  private:
-  ReusableFiberFuture<std::vector<std::uint8_t>> garbled_tables_msg_future_;
+  const std::byte* garbled_tables_{nullptr};
 };
 
 }  // namespace encrypto::motion::proto::garbled_circuit
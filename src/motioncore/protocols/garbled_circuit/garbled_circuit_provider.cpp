@@ -24,17 +24,55 @@
 
 #include "garbled_circuit_provider.h"
 
+#include <cstring>
+
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/garbled_circuit_message_generated.h"
 #include "communication/garbled_circuit_message.h"
 #include "garbled_circuit_constants.h"
 #include "garbled_circuit_utility.h"
 #include "garbled_circuit_wire.h"
+#include "data_storage/preprocessing_store.h"
+#include "primitives/aes/aes_batch_backend.h"
+#include "primitives/random/aes128_ctr_rng.h"
+#include "primitives/random/default_rng.h"
 
 namespace encrypto::motion::proto::garbled_circuit {
 
+namespace {
+
+// layout of the secrets of the garbler in a stored garbled circuit
+struct StoredGarblerCircuit {
+  Block128 key_offset;
+  Block128 aes_key;
+  Block128 hash_key;
+  Block128 wire_mapping_seed;
+  Block128 input_label_seed;
+  std::uint64_t number_of_garbled_tables;
+  std::uint64_t number_of_input_labels;
+  std::uint64_t number_of_table_bytes;
+};
+
+// layout of the header of the evaluator's stored garbled circuit, which is followed by the stream
+// of garbled tables
+struct StoredEvaluatorCircuit {
+  Block128 aes_key;
+  Block128 hash_key;
+  std::uint64_t number_of_garbled_tables;
+  std::uint64_t number_of_table_bytes;
+};
+
+template <typename T>
+std::vector<std::byte> ToBytes(const T& value) {
+  std::vector<std::byte> bytes(sizeof(T));
+  std::memcpy(bytes.data(), &value, sizeof(T));
+  return bytes;
+}
+
+}  // namespace
+
 Provider::Provider(communication::CommunicationLayer& communication_layer)
-    : communication_layer_(communication_layer) {
+    : communication_layer_(communication_layer), garbled_table_stream_(communication_layer) {
   if (communication_layer_.GetNumberOfParties() != 2) {
     throw std::invalid_argument(
         fmt::format("Garbled circuits can only be run with exactly two parties but #parties={}",
@@ -42,12 +80,38 @@ Provider::Provider(communication::CommunicationLayer& communication_layer)
   }
 }
 
+void Provider::CheckStoredGarbledCircuit() {
+  if (stored_circuit_is_evaluated_) {
+    throw std::logic_error("A stored garbled circuit can only be evaluated once");
+  }
+  if (number_of_garbled_tables_ != stored_number_of_garbled_tables_ ||
+      garbled_table_stream_.GetNumberOfBytes() != stored_number_of_table_bytes_) {
+    throw std::runtime_error(fmt::format(
+        "The stored garbled circuit has {} tables of {} B, but the circuit has {} tables of {} B",
+        stored_number_of_garbled_tables_, stored_number_of_table_bytes_, number_of_garbled_tables_,
+        garbled_table_stream_.GetNumberOfBytes()));
+  }
+  stored_circuit_is_evaluated_ = true;
+}
+
 void ThreeHalvesGarblerProvider::Setup() {
   if constexpr (kDebug) {
     communication_layer_.GetLogger()->LogDebug(
         "Started evaluating setup phase of ThreeHalvesGarblerProvider");
   }
 
+  // the evaluator got the keys with the stored garbled circuit
+  if (stored_circuit_) {
+    CheckStoredGarbledCircuit();
+    if (number_of_input_labels_ != stored_number_of_input_labels_) {
+      throw std::runtime_error(
+          fmt::format("The stored garbled circuit has {} input labels, but the circuit has {}",
+                      stored_number_of_input_labels_, number_of_input_labels_));
+    }
+    SetSetupIsReady();
+    return;
+  }
+
   flatbuffers::FlatBufferBuilder builder{
       encrypto::motion::communication::BuildGarbledCircuitSetupMessage(
           std::span(round_keys_.data(), Block128::kBlockSize),
@@ -69,6 +133,13 @@ void ThreeHalvesEvaluatorProvider::Setup() {
         "Started evaluating setup phase of ThreeHalvesEvaluatorProvider");
   }
 
+  // the keys were loaded with the stored garbled circuit
+  if (stored_circuit_) {
+    CheckStoredGarbledCircuit();
+    SetSetupIsReady();
+    return;
+  }
+
   auto public_data_msg{three_halves_public_data_future_.get()};
   auto payload{communication::GetMessage(public_data_msg.data())->payload()};
   auto setup_msg{flatbuffers::GetRoot<communication::GarbledCircuitSetupMessage>(payload->data())};
@@ -89,14 +160,21 @@ void ThreeHalvesEvaluatorProvider::Setup() {
 }
 
 std::unique_ptr<garbled_circuit::Provider> Provider::MakeProvider(
-    communication::CommunicationLayer& communication_layer) {
+    communication::CommunicationLayer& communication_layer, GarbledCircuitScheme scheme) {
   assert(communication_layer.GetMyId() == static_cast<std::size_t>(GarbledCircuitRole::kGarbler) ||
          communication_layer.GetMyId() == static_cast<std::size_t>(GarbledCircuitRole::kEvaluator));
-  if (communication_layer.GetMyId() == static_cast<std::size_t>(GarbledCircuitRole::kGarbler)) {
-    return std::make_unique<ThreeHalvesGarblerProvider>(communication_layer);
-  } else {
-    return std::make_unique<ThreeHalvesEvaluatorProvider>(communication_layer);
+  const bool is_garbler{communication_layer.GetMyId() ==
+                        static_cast<std::size_t>(GarbledCircuitRole::kGarbler)};
+  switch (scheme) {
+    case GarbledCircuitScheme::kThreeHalves:
+      if (is_garbler) return std::make_unique<ThreeHalvesGarblerProvider>(communication_layer);
+      return std::make_unique<ThreeHalvesEvaluatorProvider>(communication_layer);
+    case GarbledCircuitScheme::kHalfGates:
+      if (is_garbler) return std::make_unique<HalfGatesGarblerProvider>(communication_layer);
+      return std::make_unique<HalfGatesEvaluatorProvider>(communication_layer);
   }
+  throw std::invalid_argument(
+      fmt::format("Unknown garbled circuit scheme {}", static_cast<unsigned int>(scheme)));
 }
 
 std::shared_ptr<garbled_circuit::InputGate> Provider::MakeInputGate(std::size_t input_owner_id,
@@ -125,6 +203,32 @@ void Provider::AesNiFixedKeyForThreeHalvesGatesBatch3(std::span<const std::byte>
   AesniTmmoBatch3(round_keys.data(), input.data(), gate_index);
 }
 
+void Provider::AesNiFixedKeyForThreeHalvesGatesLanes(std::span<const std::byte> round_keys,
+                                                     const Block128& hash_key,
+                                                     std::size_t gate_index,
+                                                     std::size_t blocks_per_lane,
+                                                     std::span<Block128> input) {
+  assert(blocks_per_lane == 3 || blocks_per_lane == 6);
+  assert(input.size() % blocks_per_lane == 0);
+  for (auto& block : input) block ^= hash_key;
+  // the batched primitives use the tweaks 3 * gate_index - 3 to 3 * gate_index - 1 for one lane
+  __uint128_t tweak{gate_index};
+  primitives::AesBatchTmmoContiguous(round_keys.data(), input.data(), input.size(),
+                                     3 * tweak - 3, blocks_per_lane / 3);
+}
+
+void Provider::AesNiFixedKeyForHalfGatesLanes(std::size_t table_index,
+                                              std::size_t blocks_per_tweak,
+                                              std::span<Block128> input) {
+  assert(blocks_per_tweak == 1 || blocks_per_tweak == 2);
+  assert(input.size() % (2 * blocks_per_tweak) == 0);
+  for (auto& block : input) block ^= public_data_.hash_key;
+  // the two half gates of a table use different tweaks
+  __uint128_t tweak{table_index};
+  primitives::AesBatchTmmoContiguous(round_keys_.data(), input.data(), input.size(), 2 * tweak,
+                                     blocks_per_tweak);
+}
+
 std::shared_ptr<garbled_circuit::AndGate> ThreeHalvesGarblerProvider::MakeAndGate(
     motion::SharePointer parent_a, motion::SharePointer parent_b) {
   assert(parent_a->GetBackend().GetCommunicationLayer().GetMyId() ==
@@ -169,7 +273,12 @@ std::shared_ptr<garbled_circuit::XorGate> ThreeHalvesEvaluatorProvider::MakeXorG
 
 ThreeHalvesGarblerProvider::ThreeHalvesGarblerProvider(
     communication::CommunicationLayer& communication_layer)
-    : Provider(communication_layer), random_key_offset_(Block128::MakeRandom()) {
+    : Provider(communication_layer) {
+  SampleKeys();
+}
+
+void ThreeHalvesGarblerProvider::SampleKeys() {
+  random_key_offset_ = Block128::MakeRandom();
   BitSpan random_key_offset_span(random_key_offset_.data(), kKappa);
   // Set 1 at the position of the permutation bit.
   random_key_offset_span.Set(true, kKappa - 1);
@@ -182,6 +291,144 @@ ThreeHalvesGarblerProvider::ThreeHalvesGarblerProvider(
   AesniKeyExpansion128(round_keys_.data());
 }
 
+void ThreeHalvesGarblerProvider::GenerateInputLabels(std::size_t first_label,
+                                                     std::span<Block128> labels) const {
+  if (!is_deterministic_) {
+    DefaultRng::GetThreadInstance().RandomBlocksAligned(labels.data()->data(), labels.size());
+    return;
+  }
+  Aes128CtrRng rng(input_label_seed_.data());
+  rng.SetCounter(first_label);
+  rng.RandomBlocks(labels.data()->data(), labels.size());
+}
+
+BitVector<> ThreeHalvesGarblerProvider::GenerateWireMappingRandomness(
+    std::size_t first_table, std::size_t number_of_tables) const {
+  if (!is_deterministic_) return BitVector<>::SecureRandom(2 * number_of_tables);
+  // two random bits per table
+  constexpr std::size_t kBlockBitSize{8 * Aes128CtrRng::kBlockSize};
+  const std::size_t first_bit{2 * first_table}, last_bit{2 * (first_table + number_of_tables)};
+  const std::size_t first_block{first_bit / kBlockBitSize};
+  const std::size_t number_of_blocks{(last_bit + kBlockBitSize - 1) / kBlockBitSize - first_block};
+  std::vector<std::byte> random_bytes(number_of_blocks * Aes128CtrRng::kBlockSize);
+  Aes128CtrRng rng(wire_mapping_seed_.data());
+  rng.SetCounter(first_block);
+  rng.RandomBlocks(random_bytes.data(), number_of_blocks);
+  const std::size_t offset{first_bit - first_block * kBlockBitSize};
+  BitVector<> random_bits(random_bytes.data(), number_of_blocks * kBlockBitSize);
+  return random_bits.Subset(offset, offset + 2 * number_of_tables);
+}
+
+void ThreeHalvesGarblerProvider::StoreGarbledCircuit(const std::vector<GatePointer>& gates,
+                                                     PreprocessingStoreWriter& garbler_store,
+                                                     PreprocessingStoreWriter& evaluator_store) {
+  if (stored_circuit_) {
+    throw std::logic_error("A loaded garbled circuit cannot be garbled ahead of time");
+  }
+  for (const auto& gate : gates) {
+    auto gate_pointer{gate.get()};
+    if (!dynamic_cast<InputGateGarbler*>(gate_pointer) &&
+        !dynamic_cast<AndGateGarbler*>(gate_pointer) &&
+        !dynamic_cast<XorGateGarbler*>(gate_pointer) &&
+        !dynamic_cast<InvGateGarbler*>(gate_pointer) &&
+        !dynamic_cast<garbled_circuit::OutputGate*>(gate_pointer)) {
+      throw std::logic_error(fmt::format(
+          "Gate#{} is no garbled circuit gate and cannot be garbled ahead of time", gate->GetId()));
+    }
+  }
+
+  // every stored circuit gets fresh keys and seeds
+  SampleKeys();
+  wire_mapping_seed_ = Block128::MakeRandom();
+  input_label_seed_ = Block128::MakeRandom();
+  is_deterministic_ = true;
+  garbled_table_stream_.StartRecording();
+  // the keys are sent with the stored circuit instead of the setup message
+  SetSetupIsReady();
+
+  // gates are created after their parents, so they can be garbled in this order
+  for (const auto& gate : gates) {
+    if (!gate->NeedsSetup()) continue;
+    gate->EvaluateSetup();
+    gate->SetSetupIsReady();
+  }
+  auto garbled_tables{garbled_table_stream_.TakeRecordedTables()};
+
+  StoredGarblerCircuit garbler_circuit{random_key_offset_,
+                                       *reinterpret_cast<const Block128*>(round_keys_.data()),
+                                       public_data_.hash_key,
+                                       wire_mapping_seed_,
+                                       input_label_seed_,
+                                       number_of_garbled_tables_,
+                                       number_of_input_labels_,
+                                       garbled_tables.size()};
+  garbler_store.AddGarbledCircuit(PreprocessingKind::kGarbledCircuitGarbler,
+                                  ToBytes(garbler_circuit));
+
+  StoredEvaluatorCircuit evaluator_circuit{*reinterpret_cast<const Block128*>(round_keys_.data()),
+                                           public_data_.hash_key, number_of_garbled_tables_,
+                                           garbled_tables.size()};
+  auto evaluator_bytes{ToBytes(evaluator_circuit)};
+  evaluator_bytes.insert(evaluator_bytes.end(), garbled_tables.begin(), garbled_tables.end());
+  evaluator_store.AddGarbledCircuit(PreprocessingKind::kGarbledCircuitEvaluator,
+                                    std::move(evaluator_bytes));
+}
+
+void ThreeHalvesGarblerProvider::LoadGarbledCircuit(std::shared_ptr<PreprocessingStore> store) {
+  if (number_of_garbled_tables_ != 0 || number_of_input_labels_ != 0 || stored_circuit_) {
+    throw std::logic_error(
+        "A stored garbled circuit needs to be loaded once before any gates are created");
+  }
+  auto data{store->ConsumeGarbledCircuit(PreprocessingKind::kGarbledCircuitGarbler)};
+  if (data.size() != sizeof(StoredGarblerCircuit)) {
+    throw std::runtime_error(
+        fmt::format("The stored garbled circuit of the garbler has {} B instead of {} B",
+                    data.size(), sizeof(StoredGarblerCircuit)));
+  }
+  StoredGarblerCircuit garbler_circuit;
+  std::memcpy(static_cast<void*>(&garbler_circuit), data.data(), sizeof(garbler_circuit));
+
+  random_key_offset_ = garbler_circuit.key_offset;
+  std::copy_n(garbler_circuit.aes_key.data(), kAesKeySize128, round_keys_.data());
+  AesniKeyExpansion128(round_keys_.data());
+  public_data_.hash_key = garbler_circuit.hash_key;
+  wire_mapping_seed_ = garbler_circuit.wire_mapping_seed;
+  input_label_seed_ = garbler_circuit.input_label_seed;
+  is_deterministic_ = true;
+  stored_number_of_garbled_tables_ = garbler_circuit.number_of_garbled_tables;
+  stored_number_of_input_labels_ = garbler_circuit.number_of_input_labels;
+  stored_number_of_table_bytes_ = garbler_circuit.number_of_table_bytes;
+  // the evaluator already has the garbled tables
+  garbled_table_stream_.UseStoredTables();
+  stored_circuit_ = std::move(store);
+}
+
+void ThreeHalvesEvaluatorProvider::LoadGarbledCircuit(std::shared_ptr<PreprocessingStore> store) {
+  if (number_of_garbled_tables_ != 0 || stored_circuit_) {
+    throw std::logic_error(
+        "A stored garbled circuit needs to be loaded once before any gates are created");
+  }
+  auto data{store->ConsumeGarbledCircuit(PreprocessingKind::kGarbledCircuitEvaluator)};
+  StoredEvaluatorCircuit evaluator_circuit;
+  if (data.size() >= sizeof(evaluator_circuit)) {
+    std::memcpy(static_cast<void*>(&evaluator_circuit), data.data(), sizeof(evaluator_circuit));
+  }
+  if (data.size() < sizeof(evaluator_circuit) ||
+      data.size() != sizeof(evaluator_circuit) + evaluator_circuit.number_of_table_bytes) {
+    throw std::runtime_error(fmt::format(
+        "The stored garbled circuit of the evaluator has an invalid size of {} B", data.size()));
+  }
+
+  public_data_.aes_key = evaluator_circuit.aes_key;
+  public_data_.hash_key = evaluator_circuit.hash_key;
+  std::copy_n(public_data_.aes_key.data(), kAesKeySize128, round_keys_.data());
+  AesniKeyExpansion128(round_keys_.data());
+  stored_number_of_garbled_tables_ = evaluator_circuit.number_of_garbled_tables;
+  stored_number_of_table_bytes_ = evaluator_circuit.number_of_table_bytes;
+  garbled_table_stream_.UseStoredTables(data.subspan(sizeof(evaluator_circuit)));
+  stored_circuit_ = std::move(store);
+}
+
 inline void Xor64BitsIntoLeft(void* result, const void* x) {
   *reinterpret_cast<std::uint64_t* __restrict__>(__builtin_assume_aligned(result, 8)) ^=
       *reinterpret_cast<const std::uint64_t* __restrict__>(__builtin_assume_aligned(x, 8));
@@ -260,18 +507,51 @@ inline void CopyControlBitsToZerothPositions(std::array<std::uint64_t, 8>& R_tim
   SetZerothBit(R_times_wires[7], GetBit<7>(compressed_wire_mapping));
 }
 
-void ThreeHalvesGarblerProvider::Garble(const Block128Vector& keys_a, const Block128Vector& keys_b,
-                                        Block128Vector& keys_out, std::byte* garbled_tables,
+void ThreeHalvesGarblerProvider::Garble(std::span<const Block128> keys_a,
+                                        std::span<const Block128> keys_b,
+                                        std::span<Block128> keys_out, std::byte* garbled_tables,
                                         std::byte* garbled_control_bits, std::size_t table_offset,
-                                        std::size_t gate_index) {
+                                        std::size_t gate_index, std::size_t table_index) {
   static_assert(kGarbledControlBitsBitSize == 5, "Garbling may not work for other bit-lengths");
   static_assert(kGarbledRowBitSize == 64, "Garbling may not work for other bit-lengths");
   const std::size_t number_of_simd{keys_a.size()};
-  keys_out.resize(number_of_simd);
+  assert(keys_out.size() == number_of_simd);
 
-  auto randomness_pool_for_R{BitVector<>::SecureRandom(2 * number_of_simd)};
+  auto randomness_pool_for_R{GenerateWireMappingRandomness(table_index, number_of_simd)};
+
+  // the hashes of kLanesPerHashBatch lanes are computed in one call to keep the AES units busy
+  constexpr std::size_t kBlocksPerLane{6};
+  std::array<Block128, kBlocksPerLane * kLanesPerHashBatch> hash_batch;
 
   for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+    const std::size_t lane_in_batch{simd_i % kLanesPerHashBatch};
+    if (lane_in_batch == 0) {
+      const std::size_t batch_size{std::min(kLanesPerHashBatch, number_of_simd - simd_i)};
+      // Compute H(A_0), H(A_1), H(B_0), H(B_1), H(A_0 ^ B_0), H(A_0 ^ B_1) for the whole batch
+      for (std::size_t k = 0; k < batch_size; ++k) {
+        const Block128& key_a{keys_a[simd_i + k]};
+        const Block128& key_b{keys_b[simd_i + k]};
+        Block128 key_a_0{GetBit<7>(key_a.data()[Block128::kBlockSize - 1])
+                             ? key_a ^ random_key_offset_
+                             : key_a};
+        Block128 key_b_0{GetBit<7>(key_b.data()[Block128::kBlockSize - 1])
+                             ? key_b ^ random_key_offset_
+                             : key_b};
+        auto hash_inputs{hash_batch.data() + k * kBlocksPerLane};
+        hash_inputs[0] = key_a_0;
+        hash_inputs[1] = key_a_0 ^ random_key_offset_;
+        hash_inputs[2] = key_b_0;
+        hash_inputs[3] = key_b_0 ^ random_key_offset_;
+        hash_inputs[4] = key_a_0 ^ key_b_0;
+        hash_inputs[5] = hash_inputs[4] ^ random_key_offset_;
+      }
+      // compute AES in-place
+      AesNiFixedKeyForThreeHalvesGatesLanes(
+          round_keys_, public_data_.hash_key, gate_index + simd_i, kBlocksPerLane,
+          std::span(hash_batch.data(), batch_size * kBlocksPerLane));
+    }
+    auto hash_inputs{hash_batch.data() + lane_in_batch * kBlocksPerLane};
+
     bool p_a{GetBit<7>(keys_a[simd_i].data()[Block128::kBlockSize - 1])};
     bool p_b{GetBit<7>(keys_b[simd_i].data()[Block128::kBlockSize - 1])};
     // compute "zero keys"
@@ -408,15 +688,6 @@ void ThreeHalvesGarblerProvider::Garble(const Block128Vector& keys_a, const Bloc
     Xor64BitsIntoLeft(&result[3], &R_times_wires[1], &R_times_wires[2], &R_times_wires[3]);
     Xor64BitsIntoLeft(&result[4], &R_times_wires[6]);
 
-    // Compute H(A_0), H(A_1), H(B_0), H(B_1), H(A_0 ^ B_0), H(A_0 ^ B_1)
-    std::array<Block128, 6> hash_inputs = {
-        key_a_0,           key_a_0 ^ random_key_offset_,
-        key_b_0,           key_b_0 ^ random_key_offset_,
-        key_a_0 ^ key_b_0, key_a_0 ^ key_b_0 ^ random_key_offset_};
-    // compute AES in-place
-    AesNiFixedKeyForThreeHalvesGatesBatch6(round_keys_, public_data_.hash_key, gate_index + simd_i,
-                                           hash_inputs);
-
     // V^-1 * M * H = | 1 0 | 0 0 | 1 0 |  * H = | H(A_0) ^ H(A_0 ^ B_0)                |
     //                | 0 0 | 1 0 | 1 0 |        | H(B_0) ^ H(A_0 ^ B_0)                |
     //                | 1 1 | 0 0 | 0 0 |        | H(A_0) ^ H(A_0 ^ offset)             |
@@ -474,14 +745,38 @@ inline std::byte ExtractGarbledControlBits(const std::byte* data, std::size_t bi
   return z;
 }
 
-void ThreeHalvesEvaluatorProvider::Evaluate(const Block128Vector& keys_a,
-                                            const Block128Vector& keys_b, Block128Vector& keys_out,
+void ThreeHalvesEvaluatorProvider::Evaluate(std::span<const Block128> keys_a,
+                                            std::span<const Block128> keys_b,
+                                            std::span<Block128> keys_out,
                                             const std::byte* garbled_tables,
                                             const std::byte* garbled_control_bits,
-                                            std::size_t table_offset, std::size_t gate_index) {
+                                            std::size_t table_offset, std::size_t gate_index,
+                                            [[maybe_unused]] std::size_t table_index) {
   const std::size_t number_of_simd{keys_a.size()};
-  keys_out.resize(number_of_simd);
+  assert(keys_out.size() == number_of_simd);
+
+  // the hashes of kLanesPerHashBatch lanes are computed in one call to keep the AES units busy
+  constexpr std::size_t kBlocksPerLane{3};
+  std::array<Block128, kBlocksPerLane * kLanesPerHashBatch> hash_batch;
+
   for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+    const std::size_t lane_in_batch{simd_i % kLanesPerHashBatch};
+    if (lane_in_batch == 0) {
+      const std::size_t batch_size{std::min(kLanesPerHashBatch, number_of_simd - simd_i)};
+      // Compute H = H(A), H(B), H(A ^ B) for the whole batch
+      for (std::size_t k = 0; k < batch_size; ++k) {
+        auto hash_inputs{hash_batch.data() + k * kBlocksPerLane};
+        hash_inputs[0] = keys_a[simd_i + k];
+        hash_inputs[1] = keys_b[simd_i + k];
+        hash_inputs[2] = keys_a[simd_i + k] ^ keys_b[simd_i + k];
+      }
+      // compute AES in-place
+      AesNiFixedKeyForThreeHalvesGatesLanes(
+          round_keys_, public_data_.hash_key, gate_index + simd_i, kBlocksPerLane,
+          std::span(hash_batch.data(), batch_size * kBlocksPerLane));
+    }
+    auto hash_inputs{hash_batch.data() + lane_in_batch * kBlocksPerLane};
+
     std::byte z{ExtractGarbledControlBits(garbled_control_bits,
                                           (table_offset + simd_i) * kGarbledControlBitsBitSize)};
 
@@ -540,13 +835,6 @@ void ThreeHalvesEvaluatorProvider::Evaluate(const Block128Vector& keys_a,
         break;
     }
 
-    // Compute H = H(A), H(B), H(A ^ B)
-    std::array<Block128, 3> hash_inputs = {keys_a[simd_i], keys_b[simd_i],
-                                           keys_a[simd_i] ^ keys_b[simd_i]};
-    // compute AES in-place
-    AesNiFixedKeyForThreeHalvesGatesBatch3(round_keys_, public_data_.hash_key, gate_index + simd_i,
-                                           hash_inputs);
-
     // Inline computation of | 1 0 1 | * H
     //                       | 0 1 1 |
 
@@ -614,4 +902,110 @@ ThreeHalvesEvaluatorProvider::ThreeHalvesEvaluatorProvider(
       communication::MessageType::kGarbledCircuitSetup, 0);
 }
 
+HalfGatesGarblerProvider::HalfGatesGarblerProvider(
+    communication::CommunicationLayer& communication_layer)
+    : ThreeHalvesGarblerProvider(communication_layer) {}
+
+void HalfGatesGarblerProvider::Garble(std::span<const Block128> keys_a,
+                                      std::span<const Block128> keys_b,
+                                      std::span<Block128> keys_out, std::byte* garbled_tables,
+                                      [[maybe_unused]] std::byte* garbled_control_bits,
+                                      std::size_t table_offset,
+                                      [[maybe_unused]] std::size_t gate_index,
+                                      std::size_t table_index) {
+  const std::size_t number_of_simd{keys_a.size()};
+  assert(keys_out.size() == number_of_simd);
+
+  // the hashes of kLanesPerHashBatch lanes are computed in one call to keep the AES units busy
+  constexpr std::size_t kBlocksPerLane{4};
+  std::array<Block128, kBlocksPerLane * kLanesPerHashBatch> hash_batch;
+
+  for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+    const std::size_t lane_in_batch{simd_i % kLanesPerHashBatch};
+    if (lane_in_batch == 0) {
+      const std::size_t batch_size{std::min(kLanesPerHashBatch, number_of_simd - simd_i)};
+      // Compute H(A_0), H(A_1) and H(B_0), H(B_1) with the next tweak for the whole batch
+      for (std::size_t k = 0; k < batch_size; ++k) {
+        auto hash_inputs{hash_batch.data() + k * kBlocksPerLane};
+        hash_inputs[0] = keys_a[simd_i + k];
+        hash_inputs[1] = keys_a[simd_i + k] ^ random_key_offset_;
+        hash_inputs[2] = keys_b[simd_i + k];
+        hash_inputs[3] = keys_b[simd_i + k] ^ random_key_offset_;
+      }
+      AesNiFixedKeyForHalfGatesLanes(table_index + simd_i, 2,
+                                     std::span(hash_batch.data(), batch_size * kBlocksPerLane));
+    }
+    auto hashes{hash_batch.data() + lane_in_batch * kBlocksPerLane};
+
+    const Block128& key_a_0{keys_a[simd_i]};
+    bool p_a{GetBit<7>(key_a_0.data()[Block128::kBlockSize - 1])};
+    bool p_b{GetBit<7>(keys_b[simd_i].data()[Block128::kBlockSize - 1])};
+
+    // garbler half gate: T_G = H(A_0) ^ H(A_1) ^ p_b * offset, W_G = H(A_0) ^ p_a * T_G
+    Block128 table_garbler{hashes[0] ^ hashes[1]};
+    if (p_b) table_garbler ^= random_key_offset_;
+    Block128 key_garbler{hashes[0]};
+    if (p_a) key_garbler ^= table_garbler;
+
+    // evaluator half gate: T_E = H(B_0) ^ H(B_1) ^ A_0, W_E = H(B_0) ^ p_b * (T_E ^ A_0)
+    Block128 table_evaluator{hashes[2] ^ hashes[3] ^ key_a_0};
+    Block128 key_evaluator{hashes[2]};
+    if (p_b) key_evaluator ^= hashes[2] ^ hashes[3];
+
+    keys_out[simd_i] = key_garbler ^ key_evaluator;
+    auto table{garbled_tables + (table_offset + simd_i) * kHalfGatesTableByteSize};
+    std::copy_n(table_garbler.data(), Block128::kBlockSize, table);
+    std::copy_n(table_evaluator.data(), Block128::kBlockSize, table + Block128::kBlockSize);
+  }
+}
+
+HalfGatesEvaluatorProvider::HalfGatesEvaluatorProvider(
+    communication::CommunicationLayer& communication_layer)
+    : ThreeHalvesEvaluatorProvider(communication_layer) {}
+
+void HalfGatesEvaluatorProvider::Evaluate(std::span<const Block128> keys_a,
+                                          std::span<const Block128> keys_b,
+                                          std::span<Block128> keys_out,
+                                          const std::byte* garbled_tables,
+                                          [[maybe_unused]] const std::byte* garbled_control_bits,
+                                          std::size_t table_offset,
+                                          [[maybe_unused]] std::size_t gate_index,
+                                          std::size_t table_index) {
+  const std::size_t number_of_simd{keys_a.size()};
+  assert(keys_out.size() == number_of_simd);
+
+  // the hashes of kLanesPerHashBatch lanes are computed in one call to keep the AES units busy
+  constexpr std::size_t kBlocksPerLane{2};
+  std::array<Block128, kBlocksPerLane * kLanesPerHashBatch> hash_batch;
+
+  for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+    const std::size_t lane_in_batch{simd_i % kLanesPerHashBatch};
+    if (lane_in_batch == 0) {
+      const std::size_t batch_size{std::min(kLanesPerHashBatch, number_of_simd - simd_i)};
+      // Compute H(A), H(B) with the tweaks of the garbler for the whole batch
+      for (std::size_t k = 0; k < batch_size; ++k) {
+        hash_batch[k * kBlocksPerLane] = keys_a[simd_i + k];
+        hash_batch[k * kBlocksPerLane + 1] = keys_b[simd_i + k];
+      }
+      AesNiFixedKeyForHalfGatesLanes(table_index + simd_i, 1,
+                                     std::span(hash_batch.data(), batch_size * kBlocksPerLane));
+    }
+    auto hashes{hash_batch.data() + lane_in_batch * kBlocksPerLane};
+
+    const Block128& key_a{keys_a[simd_i]};
+    bool s_a{GetBit<7>(key_a.data()[Block128::kBlockSize - 1])};
+    bool s_b{GetBit<7>(keys_b[simd_i].data()[Block128::kBlockSize - 1])};
+    Block128 table_garbler, table_evaluator;
+    auto table{garbled_tables + (table_offset + simd_i) * kHalfGatesTableByteSize};
+    std::copy_n(table, Block128::kBlockSize, table_garbler.data());
+    std::copy_n(table + Block128::kBlockSize, Block128::kBlockSize, table_evaluator.data());
+
+    // W = H(A) ^ s_a * T_G ^ H(B) ^ s_b * (T_E ^ A)
+    Block128 key{hashes[0] ^ hashes[1]};
+    if (s_a) key ^= table_garbler;
+    if (s_b) key ^= table_evaluator ^ key_a;
+    keys_out[simd_i] = key;
+  }
+}
+
 }  // namespace encrypto::motion::proto::garbled_circuit
@@ -27,9 +27,13 @@
 #include <memory>
 #include <unordered_map>
 
+#include "communication/message_buffer.h"
 #include "communication/message_manager.h"
+#include "garbled_circuit_constants.h"
 #include "garbled_circuit_gate.h"
 #include "garbled_circuit_wire.h"
+#include "garbled_table_stream.h"
+#include "wire_label_arena.h"
 #include "primitives/aes/aesni_primitives.h"
 #include "primitives/random/default_rng.h"
 #include "utility/block.h"
@@ -40,6 +44,8 @@
 namespace encrypto::motion {
 
 class Backend;
+class PreprocessingStore;
+class PreprocessingStoreWriter;
 
 namespace communication {
 class CommunicationLayer;
@@ -73,9 +79,16 @@ class Provider : public FiberSetupWaitable {
   bool HasWork() { return true; }
 
   /// \brief Depending on the party's id (obtained from the \p communication_layer) creates either a
-  /// ThreeHalvesGarblerProvider or a ThreeHalvesEvaluatorProvider static_casted to their parent.
+  /// garbler or an evaluator provider of the \p scheme static_casted to their parent.
   static std::unique_ptr<garbled_circuit::Provider> MakeProvider(
-      communication::CommunicationLayer& communication_layer);
+      communication::CommunicationLayer& communication_layer,
+      GarbledCircuitScheme scheme = GarbledCircuitScheme::kThreeHalves);
+
+  virtual GarbledCircuitScheme GetScheme() const { return GarbledCircuitScheme::kThreeHalves; }
+
+  // the size of the garbled table and of the garbled control bits of one AND gate in the scheme
+  virtual std::size_t GetGarbledTableByteSize() const { return kGarbledTableByteSize; }
+  virtual std::size_t GetGarbledControlBitsBitSize() const { return kGarbledControlBitsBitSize; }
 
   /// \brief Constructs an Input gate. An InputGateGarbled is constructed for garbler and an
   /// InputGateEvaluator for the evaluator. The result is static_pointer_cast'ed to
@@ -101,11 +114,60 @@ class Provider : public FiberSetupWaitable {
                                               const Block128& hash_key, std::size_t gate_index,
                                               std::span<Block128> input);
 
+  // Hashes the blocks of several consecutive SIMD lanes at once, where the k-th group of
+  // blocks_per_lane (3 or 6) blocks is hashed as by AesNiFixedKeyForThreeHalvesGatesBatch3/6 with
+  // the gate index gate_index + k
+  void AesNiFixedKeyForThreeHalvesGatesLanes(std::span<const std::byte> round_keys,
+                                             const Block128& hash_key, std::size_t gate_index,
+                                             std::size_t blocks_per_lane,
+                                             std::span<Block128> input);
+
+  // Hashes the blocks of several consecutive SIMD lanes of half-gates, where each group of
+  // blocks_per_tweak (1 or 2) blocks uses the next tweak, starting at 2 * table_index
+  void AesNiFixedKeyForHalfGatesLanes(std::size_t table_index, std::size_t blocks_per_tweak,
+                                      std::span<Block128> input);
+
+  GarbledTableStream& GetGarbledTableStream() { return garbled_table_stream_; }
+
+  // the labels of the wires of the gates are allocated from the label arena
+  LabelArena& GetLabelArena() { return label_arena_; }
+
+  /// \brief Reserves the garbled tables of number_of_tables AND gates, i.e., wires times SIMD
+  /// values, and returns the index of the first one.
+  std::size_t ReserveGarbledTables(std::size_t number_of_tables) {
+    std::size_t first_table{number_of_garbled_tables_};
+    number_of_garbled_tables_ += number_of_tables;
+    return first_table;
+  }
+
+  /// \brief Evaluates the garbled circuit that was garbled ahead of time by
+  /// ThreeHalvesGarblerProvider::StoreGarbledCircuit() instead of garbling it now, so that the
+  /// garbled tables are not transferred and the online phase is pure evaluation. The artifact of
+  /// this party is consumed from the store, so it is never used again, and the circuit can only be
+  /// evaluated once. Needs to be called before any gates are created, and the same circuit needs
+  /// to be constructed afterwards.
+  /// throws std::runtime_error if the store contains no unused garbled circuit
+  virtual void LoadGarbledCircuit(std::shared_ptr<PreprocessingStore> store) = 0;
+
  protected:
+  // throws if the circuit constructed since LoadGarbledCircuit() does not match the stored one or
+  // if the stored circuit was already evaluated
+  void CheckStoredGarbledCircuit();
+
   communication::CommunicationLayer& communication_layer_;
 
+  GarbledTableStream garbled_table_stream_;
+
+  LabelArena label_arena_;
+
   std::size_t number_of_garbled_tables_{0};
 
+  // the garbled circuit loaded by LoadGarbledCircuit()
+  std::shared_ptr<PreprocessingStore> stored_circuit_;
+  std::size_t stored_number_of_garbled_tables_{0};
+  std::size_t stored_number_of_table_bytes_{0};
+  bool stored_circuit_is_evaluated_{false};
+
   alignas(kAesBlockSize) std::array<std::byte, kAesRoundKeysSize128> round_keys_;
 
   ThreeHalvesGarblingPublicData public_data_;
@@ -113,7 +175,7 @@ class Provider : public FiberSetupWaitable {
   std::atomic<bool> preprocessing_done_{false};
 };
 
-class ThreeHalvesGarblerProvider final : public Provider {
+class ThreeHalvesGarblerProvider : public Provider {
  public:
   ThreeHalvesGarblerProvider(communication::CommunicationLayer& communication_layer);
 
@@ -131,19 +193,60 @@ class ThreeHalvesGarblerProvider final : public Provider {
   std::shared_ptr<garbled_circuit::XorGate> MakeXorGate(motion::SharePointer parent_a,
                                                         motion::SharePointer parent_b) override;
 
-  void Garble(const Block128Vector& keys_a, const Block128Vector& keys_b, Block128Vector& keys_out,
-              std::byte*, std::byte* garbled_control_bits,
-              std::size_t table_offset, std::size_t gate_index);
+  // garbles the tables table_offset, ... of the buffers, whose randomness is determined by their
+  // index table_index, ... among all tables (see ReserveGarbledTables())
+  virtual void Garble(std::span<const Block128> keys_a, std::span<const Block128> keys_b,
+                      std::span<Block128> keys_out, std::byte* garbled_tables,
+                      std::byte* garbled_control_bits, std::size_t table_offset,
+                      std::size_t gate_index, std::size_t table_index);
 
   void AesNiFixedKeyForThreeHalvesGatesBatch6(std::span<const std::byte> round_keys,
                                               const Block128& hash_key, std::size_t gate_index,
                                               std::span<Block128> input);
 
- private:
+  /// \brief Reserves number_of_labels zero labels of the input wires and returns the index of the
+  /// first one.
+  std::size_t ReserveInputLabels(std::size_t number_of_labels) {
+    std::size_t first_label{number_of_input_labels_};
+    number_of_input_labels_ += number_of_labels;
+    return first_label;
+  }
+
+  /// \brief Generates the zero labels first_label, ... of the input wires into \p labels, which
+  /// are reproducible for garbled circuits that are stored ahead of time.
+  void GenerateInputLabels(std::size_t first_label, std::span<Block128> labels) const;
+
+  /// \brief Garbles the circuit of the gates without any communication and adds the secrets of
+  /// the garbler to garbler_store and the public keys and garbled tables to evaluator_store, which
+  /// the parties then load by LoadGarbledCircuit() to evaluate the circuit once. The circuit may
+  /// only consist of garbled circuit gates, and the backend must not be run afterwards.
+  /// throws std::logic_error if the circuit contains other gates
+  void StoreGarbledCircuit(const std::vector<GatePointer>& gates,
+                           PreprocessingStoreWriter& garbler_store,
+                           PreprocessingStoreWriter& evaluator_store);
+
+  void LoadGarbledCircuit(std::shared_ptr<PreprocessingStore> store) override;
+
+ protected:
   Block128 random_key_offset_;
+
+ private:
+  void SampleKeys();
+
+  // generates the random choices of the wire mappings of the tables first_table, ...
+  BitVector<> GenerateWireMappingRandomness(std::size_t first_table,
+                                            std::size_t number_of_tables) const;
+
+  std::size_t number_of_input_labels_{0};
+  std::size_t stored_number_of_input_labels_{0};
+  // if set, the randomness of the wire mappings and input labels is derived from the seeds, which
+  // allows to garble a circuit ahead of time and to reproduce the labels later
+  bool is_deterministic_{false};
+  Block128 wire_mapping_seed_;
+  Block128 input_label_seed_;
 };
 
-class ThreeHalvesEvaluatorProvider final : public Provider {
+class ThreeHalvesEvaluatorProvider : public Provider {
  public:
   ThreeHalvesEvaluatorProvider(communication::CommunicationLayer& communication_layer);
 
@@ -151,10 +254,12 @@ class ThreeHalvesEvaluatorProvider final : public Provider {
 
   void Setup() override;
 
-  void Evaluate(const Block128Vector& keys_a, const Block128Vector& keys_b,
-                Block128Vector& keys_out, const std::byte* garbled_tables,
-                const std::byte* garbled_control_bits, std::size_t table_offset,
-                std::size_t gate_index);
+  // evaluates the tables table_offset, ... of the buffers, which have the index table_index, ...
+  // among all tables
+  virtual void Evaluate(std::span<const Block128> keys_a, std::span<const Block128> keys_b,
+                        std::span<Block128> keys_out, const std::byte* garbled_tables,
+                        const std::byte* garbled_control_bits, std::size_t table_offset,
+                        std::size_t gate_index, std::size_t table_index);
 
   std::shared_ptr<garbled_circuit::AndGate> MakeAndGate(motion::SharePointer parent_a,
                                                         motion::SharePointer parent_b) override;
@@ -164,8 +269,50 @@ class ThreeHalvesEvaluatorProvider final : public Provider {
   std::shared_ptr<garbled_circuit::XorGate> MakeXorGate(motion::SharePointer parent_a,
                                                         motion::SharePointer parent_b) override;
 
+  void LoadGarbledCircuit(std::shared_ptr<PreprocessingStore> store) override;
+
  private:
-  ReusableFiberFuture<std::vector<std::uint8_t>> three_halves_public_data_future_;
+  ReusableFiberFuture<communication::MessageBuffer> three_halves_public_data_future_;
+};
+
+// Garbles the AND gates with half-gates and shares the keys, the free-XOR offset and the setup
+// with the three-halves garbler, which trades 0.5 kappa bits more per AND gate for 2 hashes less.
+class HalfGatesGarblerProvider final : public ThreeHalvesGarblerProvider {
+ public:
+  HalfGatesGarblerProvider(communication::CommunicationLayer& communication_layer);
+
+  ~HalfGatesGarblerProvider() override = default;
+
+  GarbledCircuitScheme GetScheme() const override { return GarbledCircuitScheme::kHalfGates; }
+
+  std::size_t GetGarbledTableByteSize() const override { return kHalfGatesTableByteSize; }
+
+  std::size_t GetGarbledControlBitsBitSize() const override { return 0; }
+
+  // garbled_control_bits and gate_index are unused, the tweaks of the hashes are derived from the
+  // unique table_index
+  void Garble(std::span<const Block128> keys_a, std::span<const Block128> keys_b,
+              std::span<Block128> keys_out, std::byte* garbled_tables,
+              std::byte* garbled_control_bits, std::size_t table_offset, std::size_t gate_index,
+              std::size_t table_index) override;
+};
+
+class HalfGatesEvaluatorProvider final : public ThreeHalvesEvaluatorProvider {
+ public:
+  HalfGatesEvaluatorProvider(communication::CommunicationLayer& communication_layer);
+
+  ~HalfGatesEvaluatorProvider() override = default;
+
+  GarbledCircuitScheme GetScheme() const override { return GarbledCircuitScheme::kHalfGates; }
+
+  std::size_t GetGarbledTableByteSize() const override { return kHalfGatesTableByteSize; }
+
+  std::size_t GetGarbledControlBitsBitSize() const override { return 0; }
+
+  void Evaluate(std::span<const Block128> keys_a, std::span<const Block128> keys_b,
+                std::span<Block128> keys_out, const std::byte* garbled_tables,
+                const std::byte* garbled_control_bits, std::size_t table_offset,
+                std::size_t gate_index, std::size_t table_index) override;
 };
 
 }  // namespace encrypto::motion::proto::garbled_circuit
@@ -26,10 +26,12 @@
 
 #include "base/backend.h"
 #include "base/register.h"
+#include "garbled_circuit_provider.h"
 
 namespace encrypto::motion::proto::garbled_circuit {
 
-Wire::Wire(Backend& backend, size_t number_of_simd) : BooleanWire(backend, number_of_simd) {}
+Wire::Wire(Backend& backend, size_t number_of_simd)
+    : Wire(backend.GetGarbledCircuitProvider().GetLabelArena().Allocate(number_of_simd), backend) {}
 
 Wire::Wire(Block128Vector&& wire_labels, Backend& backend)
     : BooleanWire(backend, wire_labels.size()), wire_labels_(std::move(wire_labels)) {}
@@ -37,11 +39,17 @@ Wire::Wire(Block128Vector&& wire_labels, Backend& backend)
 Wire::Wire(const Block128Vector& wire_labels, Backend& backend)
     : BooleanWire(backend, wire_labels.size()), wire_labels_(wire_labels) {}
 
+Wire::Wire(ArenaLabels&& labels, Backend& backend)
+    : BooleanWire(backend, labels.labels.size()),
+      wire_labels_(labels.labels, std::move(labels.chunk)) {}
+
+void Wire::SetKeys(Block128Vector&& values) { wire_labels_ = std::move(values); }
+
 BitVector<> Wire::CopyPermutationBits() const {
   return encrypto::motion::proto::garbled_circuit::CopyPermutationBits(wire_labels_);
 }
 
-BitVector<> CopyPermutationBits(const Block128Vector& keys) {
+BitVector<> CopyPermutationBits(std::span<const Block128> keys) {
   // copy MSB of each key buffer to the output buffer
   BitVector<> permutation_bits;
   permutation_bits.Resize(keys.size(), true);
@@ -30,6 +30,7 @@
 #include "utility/bit_vector.h"
 #include "utility/block.h"
 #include "utility/fiber_waitable.h"
+#include "wire_label_arena.h"
 
 namespace encrypto::motion {
 
@@ -41,12 +42,16 @@ namespace encrypto::motion::proto::garbled_circuit {
 
 class Wire final : public BooleanWire, public FiberSetupWaitable {
  public:
+  // allocates the labels of the wire in the LabelArena of the garbled circuit provider
   Wire(Backend& backend, size_t number_of_simd);
 
   explicit Wire(Block128Vector&& values, Backend& backend);
 
   explicit Wire(const Block128Vector& values, Backend& backend);
 
+  // the labels of the wire are stored in a LabelArena
+  explicit Wire(ArenaLabels&& labels, Backend& backend);
+
   ~Wire() final = default;
 
   MpcProtocol GetProtocol() const final { return MpcProtocol::kGarbledCircuit; }
@@ -57,21 +62,29 @@ class Wire final : public BooleanWire, public FiberSetupWaitable {
 
   std::size_t GetBitLength() const final { return 1; }
 
-  const Block128Vector& GetKeys() const noexcept { return wire_labels_; }
+  std::span<const Block128> GetKeys() const noexcept {
+    return {wire_labels_.data(), wire_labels_.size()};
+  }
+
+  std::span<Block128> GetMutableKeys() noexcept {
+    return {wire_labels_.data(), wire_labels_.size()};
+  }
 
-  Block128Vector& GetMutableKeys() noexcept { return wire_labels_; }
+  // replaces the labels of the wire by values owned by the wire
+  void SetKeys(Block128Vector&& values);
 
   BitVector<> CopyPermutationBits() const;
 
   bool IsConstant() const noexcept final { return false; }
 
  private:
-  /// Generated wire labels of the garbler or evaluated/obtained wire labels of the evaluator.
+  /// Generated wire labels of the garbler or evaluated/obtained wire labels of the evaluator,
+  /// which are usually borrowed from a chunk of the LabelArena.
   Block128Vector wire_labels_;
 };
 
 using WirePointer = std::shared_ptr<Wire>;
 
-BitVector<> CopyPermutationBits(const Block128Vector& keys);
+BitVector<> CopyPermutationBits(std::span<const Block128> keys);
 
 }  // namespace encrypto::motion::proto::garbled_circuit
\ No newline at end of file
@@ -0,0 +1,183 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "garbled_table_stream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion::proto::garbled_circuit {
+
+// the tables of every gate start at an 8-byte aligned offset, since the garbled rows are
+// accessed as std::uint64_t
+constexpr std::size_t kTableAlignment{8};
+
+GarbledTableStream::GarbledTableStream(communication::CommunicationLayer& communication_layer,
+                                       std::size_t chunk_byte_size)
+    : communication_layer_(communication_layer),
+      chunk_byte_size_(chunk_byte_size),
+      is_garbler_(communication_layer.GetMyId() ==
+                  static_cast<std::size_t>(GarbledCircuitRole::kGarbler)) {
+  if (chunk_byte_size_ == 0) {
+    throw std::invalid_argument("Chunks of the garbled table stream must not be empty");
+  }
+}
+
+GarbledTableStreamPosition GarbledTableStream::Reserve(std::size_t number_of_bytes) {
+  number_of_bytes = (number_of_bytes + kTableAlignment - 1) / kTableAlignment * kTableAlignment;
+  if (chunks_.empty() || (chunks_.back().number_of_bytes > 0 &&
+                          chunks_.back().number_of_bytes + number_of_bytes > chunk_byte_size_)) {
+    const std::size_t stream_byte_offset{GetNumberOfBytes()};
+    auto& chunk{chunks_.emplace_back()};
+    chunk.stream_byte_offset = stream_byte_offset;
+    if (!is_garbler_ && mode_ == Mode::kMessages) {
+      chunk.message_future = communication_layer_.GetMessageManager().RegisterReceive(
+          static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
+          communication::MessageType::kGarbledCircuitTableStream, chunks_.size() - 1);
+    }
+  }
+  auto& chunk{chunks_.back()};
+  GarbledTableStreamPosition position{chunks_.size() - 1, chunk.number_of_bytes};
+  chunk.number_of_bytes += number_of_bytes;
+  ++chunk.number_of_gates;
+  ++chunk.number_of_pending_gates;
+  return position;
+}
+
+std::byte* GarbledTableStream::GetMutableTables(const GarbledTableStreamPosition& position) {
+  assert(is_garbler_);
+  auto& chunk{chunks_.at(position.chunk_index)};
+  std::scoped_lock lock(chunk.mutex);
+  if (mode_ == Mode::kMessages) {
+    // the gates garble directly into the message, which saves copying the chunk when it is sent
+    if (!chunk.outgoing_message) {
+      chunk.outgoing_message.emplace(communication::MessageType::kGarbledCircuitTableStream,
+                                     position.chunk_index, chunk.number_of_bytes);
+      // zero-initialized, since the control bits are OR'ed into the buffer
+      std::ranges::fill(chunk.outgoing_message->GetPayload(), std::uint8_t(0));
+    }
+    return reinterpret_cast<std::byte*>(chunk.outgoing_message->GetPayload().data()) +
+           position.byte_offset;
+  }
+  if (!chunk.tables) {
+    // value-initialized, since the control bits are OR'ed into the buffer
+    chunk.tables = std::make_unique<std::byte[]>(chunk.number_of_bytes);
+  }
+  return chunk.tables.get() + position.byte_offset;
+}
+
+void GarbledTableStream::FinishTables(const GarbledTableStreamPosition& position) {
+  assert(is_garbler_);
+  auto& chunk{chunks_.at(position.chunk_index)};
+  if (chunk.number_of_pending_gates.fetch_sub(1) != 1) return;
+
+  flatbuffers::FlatBufferBuilder builder;
+  {
+    std::scoped_lock lock(chunk.mutex);
+    if (mode_ != Mode::kMessages) {
+      if (mode_ == Mode::kRecording) {
+        std::copy_n(chunk.tables.get(), chunk.number_of_bytes,
+                    recorded_tables_.data() + chunk.stream_byte_offset);
+      }
+      chunk.tables.reset();
+      chunk.number_of_pending_gates = chunk.number_of_gates;
+      return;
+    }
+    assert(chunk.outgoing_message);
+    builder = std::move(*chunk.outgoing_message).Finish();
+    chunk.outgoing_message.reset();
+    // prepare the chunk for the next evaluation of the circuit
+    chunk.number_of_pending_gates = chunk.number_of_gates;
+  }
+  communication_layer_.SendMessage(static_cast<std::size_t>(GarbledCircuitRole::kEvaluator),
+                                   builder.Release());
+}
+
+const std::byte* GarbledTableStream::GetTables(const GarbledTableStreamPosition& position) {
+  assert(!is_garbler_);
+  auto& chunk{chunks_.at(position.chunk_index)};
+  if (mode_ == Mode::kStored) {
+    if (chunk.stream_byte_offset + chunk.number_of_bytes > stored_tables_.size()) {
+      throw std::runtime_error(
+          fmt::format("The stored garbled tables have {} B, but the circuit has at least {} B",
+                      stored_tables_.size(), chunk.stream_byte_offset + chunk.number_of_bytes));
+    }
+    return stored_tables_.data() + chunk.stream_byte_offset + position.byte_offset;
+  }
+  std::scoped_lock lock(chunk.mutex);
+  if (chunk.received_tables == nullptr) {
+    chunk.message = chunk.message_future.get();
+    auto payload{communication::GetMessage(chunk.message.data())->payload()};
+    if (payload->size() != chunk.number_of_bytes) {
+      throw std::runtime_error(
+          fmt::format("Chunk {} of the garbled table stream has {} B, but {} B were expected",
+                      position.chunk_index, payload->size(), chunk.number_of_bytes));
+    }
+    chunk.received_tables = reinterpret_cast<const std::byte*>(payload->data());
+  }
+  return chunk.received_tables + position.byte_offset;
+}
+
+void GarbledTableStream::ReleaseTables(const GarbledTableStreamPosition& position) {
+  assert(!is_garbler_);
+  if (mode_ == Mode::kStored) return;
+  auto& chunk{chunks_.at(position.chunk_index)};
+  if (chunk.number_of_pending_gates.fetch_sub(1) != 1) return;
+
+  std::scoped_lock lock(chunk.mutex);
+  chunk.received_tables = nullptr;
+  chunk.message = communication::MessageBuffer();
+  // prepare the chunk for the next evaluation of the circuit
+  chunk.number_of_pending_gates = chunk.number_of_gates;
+}
+
+void GarbledTableStream::StartRecording() {
+  if (!is_garbler_) throw std::logic_error("Only the garbler can record garbled tables");
+  mode_ = Mode::kRecording;
+  recorded_tables_.assign(GetNumberOfBytes(), std::byte(0));
+}
+
+std::vector<std::byte> GarbledTableStream::TakeRecordedTables() {
+  if (mode_ != Mode::kRecording) throw std::logic_error("No garbled tables were recorded");
+  mode_ = Mode::kMessages;
+  return std::move(recorded_tables_);
+}
+
+void GarbledTableStream::UseStoredTables(std::span<const std::byte> tables) {
+  if (!chunks_.empty()) {
+    throw std::logic_error(
+        "Stored garbled tables need to be set before any garbled tables are reserved");
+  }
+  mode_ = Mode::kStored;
+  stored_tables_ = tables;
+}
+
+}  // namespace encrypto::motion::proto::garbled_circuit
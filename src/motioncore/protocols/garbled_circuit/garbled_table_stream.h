@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <boost/fiber/mutex.hpp>
+
+#include "communication/message.h"
+#include "communication/message_buffer.h"
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion::proto::garbled_circuit {
+
+// Position of the garbled tables of one AND gate in the garbled table stream
+struct GarbledTableStreamPosition {
+  std::size_t chunk_index;
+  std::size_t byte_offset;
+};
+
+// Channel for the garbled tables of all AND gates of a circuit.
+//
+// Both parties reserve the tables of the AND gates in the order of their construction, which
+// assigns every gate a range of bytes in one of a sequence of chunks of about chunk_byte_size
+// bytes. The garbler writes the tables of a gate directly into its chunk and sends the chunk as a
+// single kGarbledCircuitTableStream message as soon as all gates of the chunk are garbled. The
+// evaluator reads the tables of a gate from the received chunk and frees the chunk as soon as all
+// of its gates are evaluated. Hence, only the chunks in flight are kept in memory and only one
+// message per chunk instead of one per gate is sent.
+//
+// For garbled circuits that are garbled ahead of time, the garbler records the whole stream
+// instead of sending it, and later both parties only reserve the same positions again: the
+// evaluator then reads the tables from the recorded stream and nothing is sent.
+class GarbledTableStream {
+ public:
+  static constexpr std::size_t kDefaultChunkByteSize{std::size_t(1) << 20};
+
+  GarbledTableStream(communication::CommunicationLayer& communication_layer,
+                     std::size_t chunk_byte_size = kDefaultChunkByteSize);
+
+  GarbledTableStream(const GarbledTableStream&) = delete;
+
+  // Reserves number_of_bytes bytes for the tables of the next AND gate. Gates that do not fit
+  // into the current chunk start a new one. Must be called in the same order by both parties
+  // before the circuit is evaluated.
+  GarbledTableStreamPosition Reserve(std::size_t number_of_bytes);
+
+  // Garbler: returns the zero-initialized bytes reserved at position
+  std::byte* GetMutableTables(const GarbledTableStreamPosition& position);
+
+  // Garbler: marks the tables at position as garbled and sends the chunk if it is complete
+  void FinishTables(const GarbledTableStreamPosition& position);
+
+  // Evaluator: waits for the chunk containing position and returns the bytes reserved there
+  const std::byte* GetTables(const GarbledTableStreamPosition& position);
+
+  // Evaluator: marks the tables at position as evaluated and frees the chunk if it is complete
+  void ReleaseTables(const GarbledTableStreamPosition& position);
+
+  // Garbler: collects the chunks instead of sending them, see TakeRecordedTables()
+  void StartRecording();
+
+  // Garbler: returns the recorded stream and stops recording
+  std::vector<std::byte> TakeRecordedTables();
+
+  // Uses a stream that was transferred ahead of time instead of messages: the garbler drops its
+  // chunks and the evaluator reads them from tables, which need to stay valid meanwhile. Needs to
+  // be called before the first Reserve().
+  void UseStoredTables(std::span<const std::byte> tables = {});
+
+  std::size_t GetNumberOfChunks() const { return chunks_.size(); }
+
+  // number of bytes reserved so far
+  std::size_t GetNumberOfBytes() const {
+    return chunks_.empty() ? 0 : chunks_.back().stream_byte_offset + chunks_.back().number_of_bytes;
+  }
+
+ private:
+  enum class Mode { kMessages, kRecording, kStored };
+
+  struct Chunk {
+    // offset of the chunk within the whole stream
+    std::size_t stream_byte_offset{0};
+    std::size_t number_of_bytes{0};
+    std::size_t number_of_gates{0};
+    // gates of the chunk that were not garbled or evaluated in the current run
+    std::atomic<std::size_t> number_of_pending_gates{0};
+    boost::fibers::mutex mutex;
+    // garbler: tables of the chunk, allocated when the first gate of the chunk is garbled, either
+    // as the payload of the outgoing chunk message or, if the chunk is not sent, as bytes
+    std::optional<communication::OutgoingMessage> outgoing_message;
+    std::unique_ptr<std::byte[]> tables;
+    // evaluator: received chunk message
+    ReusableFiberFuture<communication::MessageBuffer> message_future;
+    communication::MessageBuffer message;
+    const std::byte* received_tables{nullptr};
+  };
+
+  communication::CommunicationLayer& communication_layer_;
+  std::size_t chunk_byte_size_;
+  bool is_garbler_;
+  Mode mode_{Mode::kMessages};
+  std::vector<std::byte> recorded_tables_;
+  std::span<const std::byte> stored_tables_;
+  // deque keeps the references to the chunks stable when new chunks are reserved
+  std::deque<Chunk> chunks_;
+};
+
+}  // namespace encrypto::motion::proto::garbled_circuit
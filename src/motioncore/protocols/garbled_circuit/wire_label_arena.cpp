@@ -0,0 +1,43 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "wire_label_arena.h"
+
+namespace encrypto::motion::proto::garbled_circuit {
+
+ArenaLabels LabelArena::Allocate(std::size_t number_of_labels) {
+  number_of_labels_ += number_of_labels;
+  // labels that exceed the chunk size get a chunk of their own, which keeps the current chunk
+  if (number_of_labels > chunk_size_) {
+    auto chunk{std::make_shared<Block128Vector>(number_of_labels)};
+    return {chunk, std::span(chunk->data(), number_of_labels)};
+  }
+  if (!chunk_ || chunk_offset_ + number_of_labels > chunk_->size()) {
+    chunk_ = std::make_shared<Block128Vector>(chunk_size_);
+    chunk_offset_ = 0;
+  }
+  ArenaLabels result{chunk_, std::span(chunk_->data() + chunk_offset_, number_of_labels)};
+  chunk_offset_ += number_of_labels;
+  return result;
+}
+
+}  // namespace encrypto::motion::proto::garbled_circuit
@@ -0,0 +1,71 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#include "utility/block.h"
+
+namespace encrypto::motion::proto::garbled_circuit {
+
+// Labels of a wire that are stored in a LabelArena
+struct ArenaLabels {
+  // keeps the chunk alive as long as the labels are used
+  std::shared_ptr<Block128Vector> chunk;
+  std::span<Block128> labels;
+};
+
+// Storage of the wire labels of all gates of a circuit.
+//
+// The labels of the gates are allocated in the order of the construction of the gates, which
+// assigns every gate a range of labels in one of a sequence of large chunks. Hence, the labels of
+// the gates of a layer are mostly adjacent in memory, which allows the evaluation loops to stream
+// and prefetch them, and no labels are allocated in the setup and online phases. A chunk is freed
+// as soon as all wires using its labels are destroyed.
+//
+// Not thread-safe, the labels are allocated while the circuit is constructed.
+class LabelArena {
+ public:
+  static constexpr std::size_t kDefaultChunkSize{std::size_t(1) << 14};
+
+  LabelArena(std::size_t chunk_size = kDefaultChunkSize) : chunk_size_(chunk_size) {}
+
+  LabelArena(const LabelArena&) = delete;
+
+  // Allocates number_of_labels adjacent uninitialized labels. Labels that do not fit into the
+  // current chunk start a new one, labels that exceed the chunk size get a chunk of their own.
+  ArenaLabels Allocate(std::size_t number_of_labels);
+
+  // the number of labels allocated so far
+  std::size_t GetNumberOfLabels() const { return number_of_labels_; }
+
+ private:
+  std::size_t chunk_size_;
+  std::shared_ptr<Block128Vector> chunk_;
+  std::size_t chunk_offset_{0};
+  std::size_t number_of_labels_{0};
+};
+
+}  // namespace encrypto::motion::proto::garbled_circuit
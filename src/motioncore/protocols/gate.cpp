@@ -26,7 +26,9 @@
 #include "wire.h"
 
 #include "base/backend.h"
+#include "base/configuration.h"
 #include "base/register.h"
+#include "communication/communication_layer.h"
 #include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
 #include "oblivious_transfer/ot_provider.h"
 #include "utility/condition.h"
@@ -34,6 +36,11 @@
 
 namespace encrypto::motion {
 
+GateTask Gate::EvaluateOnlineCoroutine() {
+  EvaluateOnline();
+  co_return;
+}
+
 void Gate::SetSetupIsReady() {
   {
     std::scoped_lock lock(setup_is_ready_condition_.GetMutex());
@@ -56,9 +63,24 @@ void Gate::SetOnlineIsReady() {
   online_is_ready_condition_.NotifyAll();
 }
 
-void Gate::WaitSetup() const { setup_is_ready_condition_.Wait(); }
+void Gate::WaitSetup(std::source_location location) const {
+  if (setup_is_ready_) return;
+  ProfiledWait profiled_wait(ProfiledWait::Kind::kDependency);
+  setup_is_ready_condition_.Wait(location);
+}
 
-void Gate::WaitOnline() const { online_is_ready_condition_.Wait(); }
+void Gate::WaitOnline(std::source_location location) const {
+  if (online_is_ready_) return;
+  ProfiledWait profiled_wait(ProfiledWait::Kind::kDependency);
+  online_is_ready_condition_.Wait(location);
+}
+
+void Gate::IfReadyAddToProcessingQueue() {
+  assert(number_of_unready_dependencies_ > 0);
+  if (--number_of_unready_dependencies_ == 0) {
+    GetRegister().AddToProcessingQueue(*this);
+  }
+}
 
 void Gate::Clear() {
   setup_is_ready_ = false;
@@ -67,7 +89,7 @@ void Gate::Clear() {
 
 Gate::Gate(Backend& backend)
     : backend_(backend),
-      gate_id_(backend.GetRegister()->NextGateId()),
+      gate_id_(static_cast<std::int32_t>(backend.GetRegister()->NextGateId())),
       setup_is_ready_condition_([this] { return setup_is_ready_.load(); }),
       online_is_ready_condition_([this] { return online_is_ready_.load(); }) {}
 
@@ -79,6 +101,24 @@ Register& Gate::GetRegister() { return *backend_.GetRegister(); }
 
 Configuration& Gate::GetConfiguration() { return *backend_.GetConfiguration(); }
 
+std::size_t Gate::GetNumberOfParallelThreads(std::size_t number_of_values) {
+  const auto& configuration{GetConfiguration()};
+  const auto threshold{configuration.GetParallelGateThreshold()};
+  if (threshold == 0 || number_of_values < threshold) {
+    return 1;
+  }
+  return configuration.GetNumOfThreads();
+}
+
+std::optional<std::size_t> Gate::GetOpeningKing(std::size_t message_id) {
+  const auto number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
+  // with two parties, the king would forward the single share it received
+  if (!GetConfiguration().GetKingOpenings() || number_of_parties <= 2) {
+    return std::nullopt;
+  }
+  return message_id % number_of_parties;
+}
+
 Logger& Gate::GetLogger() { return *backend_.GetLogger(); }
 
 BaseProvider& Gate::GetBaseProvider() { return backend_.GetBaseProvider(); }
@@ -89,8 +129,16 @@ SpProvider& Gate::GetSpProvider() { return backend_.GetSpProvider(); }
 
 SbProvider& Gate::GetSbProvider() { return backend_.GetSbProvider(); }
 
+TruncationPairProvider& Gate::GetTruncationPairProvider() {
+  return backend_.GetTruncationPairProvider();
+}
+
+DaBitProvider& Gate::GetDaBitProvider() { return backend_.GetDaBitProvider(); }
+
 OtProvider& Gate::GetOtProvider(const std::size_t i) { return backend_.GetOtProvider(i); }
 
+proto::astra::Provider& Gate::GetAstraProvider() { return backend_.GetAstraProvider(); }
+
 proto::garbled_circuit::Provider& Gate::GetGarbledCircuitProvider() {
   return backend_.GetGarbledCircuitProvider();
 }
@@ -27,10 +27,13 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <source_location>
 #include <unordered_set>
 #include <vector>
 
 #include "utility/fiber_condition.h"
+#include "utility/gate_task.h"
 #include "utility/typedefs.h"
 
 namespace encrypto::motion::communication {
@@ -51,9 +54,14 @@ class OtProvider;
 class Register;
 class SbProvider;
 class SpProvider;
+class TruncationPairProvider;
+class DaBitProvider;
 class Wire;
 using WirePointer = std::shared_ptr<Wire>;
 
+namespace proto::astra {
+class Provider;
+}
 namespace proto::garbled_circuit {
 class Provider;
 }
@@ -76,6 +84,11 @@ class Gate {
 
   virtual void EvaluateOnline() = 0;
 
+  /// \brief Returns the online phase as a coroutine, which co_awaits the messages of the other
+  ///        parties instead of blocking its fiber if Configuration::SetCoroutineOnlinePhases is
+  ///        enabled. The default coroutine runs EvaluateOnline() without suspending.
+  virtual GateTask EvaluateOnlineCoroutine();
+
   const std::vector<WirePointer>& GetOutputWires() const { return output_wires_; }
 
   void Clear();
@@ -84,24 +97,59 @@ class Gate {
 
   virtual bool NeedsOnline() const { return true; }
 
+  /// \brief Returns true if the online phase is a cheap local computation without communication,
+  ///        which may be evaluated inline by the fiber that completes the gate's last input.
+  virtual bool IsLocal() const { return false; }
+
+  /// \brief Returns true if the gate produces a result for the user, e.g., an output gate, such
+  ///        that Register::EliminateDeadGates keeps it and the gates it depends on.
+  virtual bool IsOutput() const { return false; }
+
+  /// \brief Returns true if the gate can be evaluated again after Register::ClearDownstreamGates
+  ///        without fresh preprocessing material, e.g., local gates and the input and output
+  ///        gates of GMW, whose sharing randomness and message futures are reusable.
+  virtual bool IsReEvaluable() const { return IsLocal(); }
+
+  /// \brief Returns true if EvaluateOnlineCoroutine() sends its openings, e.g., the masked inputs
+  ///        of a multiplication, before its first suspension without waiting for other parties,
+  ///        such that the GateExecutor can batch them with the openings of the other gates of
+  ///        the layer, see Configuration::SetLayerWiseEvaluation.
+  virtual bool OpensBeforeSuspending() const { return false; }
+
   void SetSetupIsReady();
 
   void SetOnlineIsReady();
 
-  void WaitSetup() const;
+  void WaitSetup(std::source_location location = std::source_location::current()) const;
 
-  void WaitOnline() const;
+  void WaitOnline(std::source_location location = std::source_location::current()) const;
 
   bool SetupIsReady() const { return setup_is_ready_; }
 
+  bool OnlineIsReady() const { return online_is_ready_; }
+
   std::int64_t GetId() const { return gate_id_; }
 
+  /// \brief Returns the wires which the online phase of this gate depends on.
+  virtual std::vector<WirePointer> GetInputWires() const { return {}; }
+
+  /// \brief Sets the number of dependencies, e.g., input wires, that need to be resolved before
+  ///        the gate is added to the processing queue of the Register.
+  void SetNumberOfUnreadyDependencies(std::size_t number_of_dependencies) {
+    number_of_unready_dependencies_ = number_of_dependencies;
+  }
+
+  /// \brief Resolves one dependency and adds the gate to the processing queue as soon as all
+  ///        of its dependencies are resolved.
+  void IfReadyAddToProcessingQueue();
+
   Gate(Gate&) = delete;
 
  protected:
   std::vector<WirePointer> output_wires_;
   Backend& backend_;
-  std::int64_t gate_id_ = -1;
+  // 32 bits suffice for the dense ids of an epoch, see Register::kMaxNumberOfIds
+  std::int32_t gate_id_ = -1;
 
   std::atomic<bool> setup_is_ready_ = false;
   std::atomic<bool> online_is_ready_ = false;
@@ -115,18 +163,27 @@ class Gate {
 
   Register& GetRegister();
   Configuration& GetConfiguration();
+  // threads to split the computation of a gate with number_of_values values over, see
+  // Configuration::SetParallelGateThreshold
+  std::size_t GetNumberOfParallelThreads(std::size_t number_of_values);
+  // party that reconstructs the opening with message_id or std::nullopt if all parties broadcast
+  // their shares, see Configuration::SetKingOpenings
+  std::optional<std::size_t> GetOpeningKing(std::size_t message_id);
   Logger& GetLogger();
   BaseProvider& GetBaseProvider();
   MtProvider& GetMtProvider();
   SpProvider& GetSpProvider();
   SbProvider& GetSbProvider();
+  TruncationPairProvider& GetTruncationPairProvider();
+  DaBitProvider& GetDaBitProvider();
   communication::CommunicationLayer& GetCommunicationLayer();
   OtProvider& GetOtProvider(std::size_t i);
+  proto::astra::Provider& GetAstraProvider();
   proto::garbled_circuit::Provider& GetGarbledCircuitProvider();
   Kk13OtProvider& GetKk13OtProvider(std::size_t i);
 
  private:
-  void IfReadyAddToProcessingQueue();
+  std::atomic<std::size_t> number_of_unready_dependencies_ = 0;
 
   std::mutex mutex_;
 };
@@ -151,6 +208,8 @@ class OneGate : public Gate {
 
   const std::vector<WirePointer>& GetParent() const { return parent_; }
 
+  std::vector<WirePointer> GetInputWires() const override { return parent_; }
+
  protected:
   std::vector<WirePointer> parent_;
 
@@ -199,6 +258,8 @@ class OutputGate : public OneGate {
 
   OutputGate(Backend& backend) : OneGate(backend) {}
 
+  bool IsOutput() const override { return true; }
+
   static constexpr std::size_t kAll{std::numeric_limits<std::int64_t>::max()};
 
  protected:
@@ -229,6 +290,14 @@ class TwoGate : public Gate {
 
   const std::vector<WirePointer>& GetParentA() const { return parent_a_; }
   const std::vector<WirePointer>& GetParentB() const { return parent_b_; }
+
+  std::vector<WirePointer> GetInputWires() const override {
+    std::vector<WirePointer> input_wires;
+    input_wires.reserve(parent_a_.size() + parent_b_.size());
+    input_wires.insert(input_wires.end(), parent_a_.begin(), parent_a_.end());
+    input_wires.insert(input_wires.end(), parent_b_.begin(), parent_b_.end());
+    return input_wires;
+  }
 };
 
 //
@@ -255,6 +324,15 @@ class ThreeGate : public Gate {
   const std::vector<WirePointer>& GetParentA() const { return parent_a_; }
   const std::vector<WirePointer>& GetParentB() const { return parent_b_; }
   const std::vector<WirePointer>& GetParentC() const { return parent_c_; }
+
+  std::vector<WirePointer> GetInputWires() const override {
+    std::vector<WirePointer> input_wires;
+    input_wires.reserve(parent_a_.size() + parent_b_.size() + parent_c_.size());
+    input_wires.insert(input_wires.end(), parent_a_.begin(), parent_a_.end());
+    input_wires.insert(input_wires.end(), parent_b_.begin(), parent_b_.end());
+    input_wires.insert(input_wires.end(), parent_c_.begin(), parent_c_.end());
+    return input_wires;
+  }
 };
 
 //
@@ -277,6 +355,8 @@ class NInputGate : public Gate {
   ~NInputGate() override = default;
 
   const std::vector<WirePointer>& GetParents() const { return parents_; }
+
+  std::vector<WirePointer> GetInputWires() const override { return parents_; }
 };
 
 }  // namespace encrypto::motion
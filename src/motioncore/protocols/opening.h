@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+
+namespace encrypto::motion {
+
+// Openings of GMW shares, in which every party contributes its share of a value that all parties
+// learn. Without a king, every party broadcasts its share. With a king (see
+// Gate::GetOpeningKing), the parties send their shares only to the king, which reconstructs the
+// value and broadcasts it with the same message type and id.
+
+// registers the shares of all other parties or, if another party is the king, the opened value
+inline std::vector<ReusableFiberFuture<communication::MessageBuffer>> RegisterOpening(
+    communication::CommunicationLayer& communication_layer, std::optional<std::size_t> king,
+    communication::MessageType message_type, std::size_t message_id) {
+  auto& message_manager{communication_layer.GetMessageManager()};
+  if (king && *king != communication_layer.GetMyId()) {
+    std::vector<ReusableFiberFuture<communication::MessageBuffer>> futures;
+    futures.emplace_back(message_manager.RegisterReceive(*king, message_type, message_id));
+    return futures;
+  }
+  return message_manager.RegisterReceiveAll(message_type, message_id);
+}
+
+// if the party receives the opened value instead of the shares of the other parties
+inline bool ReceivesOpenedValue(const communication::CommunicationLayer& communication_layer,
+                                std::optional<std::size_t> king) {
+  return king && *king != communication_layer.GetMyId();
+}
+
+// sends the share of this party to the parties that reconstruct the value, the king keeps it
+inline void SendShareOfOpening(communication::CommunicationLayer& communication_layer,
+                               std::optional<std::size_t> king,
+                               communication::MessageType message_type, std::size_t message_id,
+                               std::span<const std::uint8_t> share) {
+  if (!king) {
+    communication_layer.BroadcastMessage(
+        communication::BuildMessage(message_type, message_id, share).Release());
+  } else if (*king != communication_layer.GetMyId()) {
+    communication_layer.SendMessage(
+        *king, communication::BuildMessage(message_type, message_id, share).Release());
+  }
+}
+
+// the king broadcasts the value it reconstructed from the shares
+inline void FinishOpening(communication::CommunicationLayer& communication_layer,
+                          std::optional<std::size_t> king, communication::MessageType message_type,
+                          std::size_t message_id, std::span<const std::uint8_t> value) {
+  if (king && *king == communication_layer.GetMyId()) {
+    communication_layer.BroadcastMessage(
+        communication::BuildMessage(message_type, message_id, value).Release());
+  }
+}
+
+}  // namespace encrypto::motion
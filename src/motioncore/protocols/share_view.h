@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <span>
+
+#include "share.h"
+#include "wire.h"
+
+namespace encrypto::motion {
+
+/// \brief non-owning view of the wires [begin, end) of a share, e.g., of a single bit of a
+/// Boolean share. Unlike ShareWrapper::Split and ShareWrapper::GetWire, taking a view allocates
+/// no Share and touches no reference counts, hence circuits may be constructed on the bit level
+/// from views and turned into shares by the gate factories, see ShareWrapper::Concatenate and
+/// ShareWrapper::Simdify. A view is only valid as long as the viewed share is alive.
+class ShareView {
+ public:
+  ShareView() = default;
+
+  explicit ShareView(const Share& share) : share_(&share), wires_(share.GetWires()) {}
+
+  ShareView(const Share& share, std::size_t begin, std::size_t end)
+      : share_(&share), wires_(std::span(share.GetWires()).subspan(begin, end - begin)) {
+    assert(begin <= end && end <= share.GetWires().size());
+  }
+
+  /// \brief true if the view references a share, cf. ShareWrapper::Get.
+  explicit operator bool() const noexcept { return share_ != nullptr; }
+
+  const Share& GetShare() const {
+    assert(share_);
+    return *share_;
+  }
+
+  std::span<const WirePointer> GetWires() const noexcept { return wires_; }
+
+  std::size_t GetNumberOfWires() const noexcept { return wires_.size(); }
+
+  std::size_t GetNumberOfSimdValues() const {
+    assert(!wires_.empty());
+    return wires_.front()->GetNumberOfSimdValues();
+  }
+
+  MpcProtocol GetProtocol() const { return GetShare().GetProtocol(); }
+
+  /// \brief yields the view of wire #i of this view.
+  ShareView GetWire(std::size_t i) const { return Subview(i, i + 1); }
+
+  /// \brief yields the view of the wires [begin, end) of this view.
+  ShareView Subview(std::size_t begin, std::size_t end) const {
+    assert(begin <= end && end <= wires_.size());
+    ShareView result;
+    result.share_ = share_;
+    result.wires_ = wires_.subspan(begin, end - begin);
+    return result;
+  }
+
+ private:
+  const Share* share_{nullptr};
+  std::span<const WirePointer> wires_;
+};
+
+}  // namespace encrypto::motion
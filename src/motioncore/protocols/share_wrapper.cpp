@@ -24,13 +24,22 @@
 
 #include "share_wrapper.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
 #include <typeinfo>
 
 #include "algorithm/algorithm_description.h"
+#include "algorithm/boolean_algorithms.h"
+#include "algorithm/circuit_optimizer.h"
+#include "algorithm/circuit_template.h"
 #include "algorithm/low_depth_reduce.h"
+#include "algorithm/protocol_assignment.h"
 #include "base/backend.h"
+#include "base/configuration.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
@@ -46,15 +55,20 @@
 #include "protocols/constant/constant_gate.h"
 #include "protocols/constant/constant_share.h"
 #include "protocols/constant/constant_wire.h"
+#include "protocols/conversion/a2b_gate.h"
 #include "protocols/conversion/b2a_gate.h"
 #include "protocols/conversion/conversion_gate.h"
 #include "protocols/data_management/simdify_gate.h"
 #include "protocols/data_management/subset_gate.h"
+#include "protocols/data_management/transpose_gate.h"
 #include "protocols/data_management/unsimdify_gate.h"
 #include "protocols/garbled_circuit/garbled_circuit_provider.h"
 #include "secure_type/secure_unsigned_integer.h"
 #include "share.h"
+#include "share_view.h"
 #include "utility/bit_vector.h"
+#include "utility/constants.h"
+#include "utility/helpers.h"
 
 namespace encrypto::motion {
 
@@ -86,6 +100,11 @@ ShareWrapper ShareWrapper::operator~() const {
       auto inv_gate = share_->GetBackend().GetGarbledCircuitProvider().MakeInvGate(share_);
       return ShareWrapper(inv_gate->GetOutputAsShare());
     }
+    case MpcProtocol::kAstra: {
+      auto inv_gate =
+          share_->GetBackend().GetRegister()->EmplaceGate<proto::astra::InvGate>(share_);
+      return ShareWrapper(inv_gate->GetOutputAsAstraShare());
+    }
     default:
       throw std::runtime_error(
           fmt::format("Unknown protocol for constructing an INV gate with id {}",
@@ -128,6 +147,11 @@ ShareWrapper ShareWrapper::operator^(const ShareWrapper& other) const {
       auto xor_gate = share_->GetBackend().GetGarbledCircuitProvider().MakeXorGate(share_, *other);
       return ShareWrapper(xor_gate->GetOutputAsShare());
     }
+    case MpcProtocol::kAstra: {
+      auto xor_gate =
+          share_->GetBackend().GetRegister()->EmplaceGate<proto::astra::XorGate>(share_, *other);
+      return ShareWrapper(xor_gate->GetOutputAsAstraShare());
+    }
     default:
       throw std::runtime_error(
           fmt::format("Unknown protocol for constructing an XOR gate with id {}",
@@ -167,6 +191,11 @@ ShareWrapper ShareWrapper::operator&(const ShareWrapper& other) const {
       auto and_gate = share_->GetBackend().GetGarbledCircuitProvider().MakeAndGate(share_, *other);
       return ShareWrapper(and_gate->GetOutputAsShare());
     }
+    case MpcProtocol::kAstra: {
+      auto and_gate =
+          share_->GetBackend().GetRegister()->EmplaceGate<proto::astra::AndGate>(share_, *other);
+      return ShareWrapper(and_gate->GetOutputAsAstraShare());
+    }
     default:
       throw std::runtime_error(
           fmt::format("Unknown protocol for constructing an AND gate with id {}",
@@ -290,6 +319,8 @@ ShareWrapper ShareWrapper::operator*(const ShareWrapper& other) const {
       return Square<std::uint32_t>(share_);
     } else if (share_->GetBitLength() == 64u) {
       return Square<std::uint64_t>(share_);
+    } else if (share_->GetBitLength() == 128u) {
+      return Square<__uint128_t>(share_);
     } else {
       throw std::bad_cast();
     }
@@ -302,12 +333,67 @@ ShareWrapper ShareWrapper::operator*(const ShareWrapper& other) const {
       return Mul<std::uint32_t>(share_, *other);
     } else if (share_->GetBitLength() == 64u) {
       return Mul<std::uint64_t>(share_, *other);
+    } else if (share_->GetBitLength() == 128u) {
+      return Mul<__uint128_t>(share_, *other);
     } else {
       throw std::bad_cast();
     }
   }
 }
 
+ShareWrapper ShareWrapper::Truncate(std::size_t number_of_fractional_bits) const {
+  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::runtime_error("Truncation is only supported for arithmetic GMW shares");
+  }
+  if (share_->GetBitLength() == 8u) {
+    return Truncate<std::uint8_t>(share_, number_of_fractional_bits);
+  } else if (share_->GetBitLength() == 16u) {
+    return Truncate<std::uint16_t>(share_, number_of_fractional_bits);
+  } else if (share_->GetBitLength() == 32u) {
+    return Truncate<std::uint32_t>(share_, number_of_fractional_bits);
+  } else if (share_->GetBitLength() == 64u) {
+    return Truncate<std::uint64_t>(share_, number_of_fractional_bits);
+  } else {
+    throw std::bad_cast();
+  }
+}
+
+ShareWrapper ShareWrapper::BitDecomposition() const {
+  if (share_->GetProtocol() != MpcProtocol::kAstra ||
+      share_->GetCircuitType() != CircuitType::kArithmetic) {
+    throw std::invalid_argument("Bit decomposition is only supported for arithmetic Astra shares");
+  }
+  if (share_->GetBitLength() == 8u) {
+    return AstraBitDecomposition<std::uint8_t>(false);
+  } else if (share_->GetBitLength() == 16u) {
+    return AstraBitDecomposition<std::uint16_t>(false);
+  } else if (share_->GetBitLength() == 32u) {
+    return AstraBitDecomposition<std::uint32_t>(false);
+  } else if (share_->GetBitLength() == 64u) {
+    return AstraBitDecomposition<std::uint64_t>(false);
+  } else {
+    throw std::bad_cast();
+  }
+}
+
+ShareWrapper ShareWrapper::Msb() const {
+  if (share_->GetProtocol() != MpcProtocol::kAstra ||
+      share_->GetCircuitType() != CircuitType::kArithmetic) {
+    throw std::invalid_argument("MSB extraction is only supported for arithmetic Astra shares");
+  }
+  if (share_->GetBitLength() == 8u) {
+    return AstraBitDecomposition<std::uint8_t>(true);
+  } else if (share_->GetBitLength() == 16u) {
+    return AstraBitDecomposition<std::uint16_t>(true);
+  } else if (share_->GetBitLength() == 32u) {
+    return AstraBitDecomposition<std::uint32_t>(true);
+  } else if (share_->GetBitLength() == 64u) {
+    return AstraBitDecomposition<std::uint64_t>(true);
+  } else {
+    throw std::bad_cast();
+  }
+}
+
 ShareWrapper ShareWrapper::operator==(const ShareWrapper& other) const {
   if (other->GetBitLength() != share_->GetBitLength()) {
     share_->GetBackend().GetLogger()->LogError(
@@ -319,40 +405,46 @@ ShareWrapper ShareWrapper::operator==(const ShareWrapper& other) const {
         "Comparing shared bit strings of bit length 0 is not allowed");
   }
 
-  auto result = ~(*this ^ other);  // XNOR
-  const auto bitlength = result->GetBitLength();
+  const auto is_arithmetic = [](const SharePointer& share) {
+    return share->GetProtocol() == MpcProtocol::kArithmeticGmw ||
+           share->GetProtocol() == MpcProtocol::kArithmeticConstant;
+  };
+  if (is_arithmetic(share_) && is_arithmetic(*other) &&
+      !(share_->IsConstant() && other->IsConstant())) {
+    // a constant-round equality test of the arithmetic values instead of an XNOR of their bits
+    return Compare(other, ComparisonType::kEqual);
+  }
 
-  if (bitlength == 1) {
-    return result;
-  } else if (IsPowerOfTwo(bitlength)) {
-    return LowDepthReduce(result.Split(), std::bit_and<>());
-  } else {  // bitlength is not a power of 2
-    while (result->GetBitLength() != 1) {
-      std::queue<ShareWrapper> q;
-      std::vector<ShareWrapper> output;
-      std::size_t offset{0};
-      const auto inner_bitlength{result->GetBitLength()};
-      output.reserve(std::ceil(std::log2(inner_bitlength)));
-      const auto split = result.Split();
-      for (auto i = 1ull; i <= inner_bitlength; i *= 2) {
-        if ((inner_bitlength & i) == i) {
-          const auto _begin = split.begin() + offset;
-          const auto _end = split.begin() + offset + i;
-          q.push(ShareWrapper::Concatenate(_begin, _end));
-          offset += i;
-        }
-      }
-      while (!q.empty()) {
-        output.emplace_back(LowDepthReduce(q.front().Split(), std::bit_and<>()));
-        q.pop();
-      }
-      result = ShareWrapper::Concatenate(output);
-    }
+  auto result = ~(*this ^ other);  // XNOR
+  if (result->GetBitLength() == 1) {
     return result;
   }
+  // the AND of all bits, which Boolean GMW evaluates with multi-input AND gates
+  return And(result.Split());
 }
 
 ShareWrapper ShareWrapper::operator>(const ShareWrapper& other) const {
+  return Compare(other, ComparisonType::kGreaterThan);
+}
+
+ShareWrapper ShareWrapper::operator>=(const ShareWrapper& other) const {
+  return Compare(other, ComparisonType::kGreaterThanOrEqual);
+}
+
+ShareWrapper ShareWrapper::operator<(const ShareWrapper& other) const {
+  return Compare(other, ComparisonType::kLessThan);
+}
+
+ShareWrapper ShareWrapper::operator<=(const ShareWrapper& other) const {
+  return Compare(other, ComparisonType::kLessThanOrEqual);
+}
+
+ShareWrapper ShareWrapper::IsInRange(const ShareWrapper& lower, const ShareWrapper& upper) const {
+  return (*this >= lower) & (*this <= upper);
+}
+
+ShareWrapper ShareWrapper::Compare(const ShareWrapper& other,
+                                   ComparisonType comparison_type) const {
   if (other->GetBitLength() != share_->GetBitLength()) {
     share_->GetBackend().GetLogger()->LogError(
         fmt::format("Comparing shares of different bit lengths: this {} bits vs other "
@@ -364,19 +456,24 @@ ShareWrapper ShareWrapper::operator>(const ShareWrapper& other) const {
 
   assert(*other);
   assert(share_);
-  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw ||
-      other->GetProtocol() != MpcProtocol::kArithmeticGmw) {
-    throw std::runtime_error("GreaterThan operation is only supported for arithmetic GMW shares");
+  const bool this_is_supported{share_->GetProtocol() == MpcProtocol::kArithmeticGmw ||
+                               share_->GetProtocol() == MpcProtocol::kArithmeticConstant};
+  const bool other_is_supported{other->GetProtocol() == MpcProtocol::kArithmeticGmw ||
+                                other->GetProtocol() == MpcProtocol::kArithmeticConstant};
+  if (!this_is_supported || !other_is_supported || (share_->IsConstant() && other->IsConstant())) {
+    throw std::runtime_error(fmt::format(
+        "Comparison {} is only supported for arithmetic GMW shares and arithmetic constants",
+        to_string(comparison_type)));
   }
 
   if (share_->GetBitLength() == 8u) {
-    return GreaterThan<std::uint8_t>(share_, *other);
+    return Compare<std::uint8_t>(share_, *other, comparison_type);
   } else if (share_->GetBitLength() == 16u) {
-    return GreaterThan<std::uint16_t>(share_, *other);
+    return Compare<std::uint16_t>(share_, *other, comparison_type);
   } else if (share_->GetBitLength() == 32u) {
-    return GreaterThan<std::uint32_t>(share_, *other);
+    return Compare<std::uint32_t>(share_, *other, comparison_type);
   } else if (share_->GetBitLength() == 64u) {
-    return GreaterThan<std::uint64_t>(share_, *other);
+    return Compare<std::uint64_t>(share_, *other, comparison_type);
   } else {
     throw std::bad_cast();
   }
@@ -386,15 +483,19 @@ ShareWrapper ShareWrapper::Mux(const ShareWrapper& a, const ShareWrapper& b) con
   assert(*a);
   assert(*b);
   assert(share_);
-  assert(share_->GetProtocol() == a->GetProtocol());
-  assert(share_->GetProtocol() == b->GetProtocol());
+  assert(a->GetProtocol() == b->GetProtocol());
   assert(a->GetBitLength() == b->GetBitLength());
-  assert(share_->GetBitLength() == 1);
 
-  if (share_->GetProtocol() == MpcProtocol::kArithmeticGmw) {
-    // TODO implement
-    throw std::runtime_error("C-OT-based Mux for Arithmetic GMW shares is not implemented yet");
+  if (a->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    // b + s * (a - b), where a Boolean selection bit is injected with a single AC-OT
+    const auto difference{a - b};
+    if (share_->GetProtocol() == MpcProtocol::kBooleanGmw) {
+      return b + BitInjection(std::span(&difference, 1)).at(0);
+    }
+    return b + *this * difference;
   }
+  assert(share_->GetProtocol() == a->GetProtocol());
+  assert(share_->GetBitLength() == 1);
 
   if (share_->GetProtocol() == MpcProtocol::kBooleanGmw) {
     auto this_gmw = std::dynamic_pointer_cast<proto::boolean_gmw::Share>(share_);
@@ -421,11 +522,100 @@ ShareWrapper ShareWrapper::Mux(const ShareWrapper& a, const ShareWrapper& b) con
   }
 }
 
+std::vector<ShareWrapper> ShareWrapper::BitInjection(std::span<const ShareWrapper> values) const {
+  assert(share_);
+  if (share_->GetProtocol() != MpcProtocol::kBooleanGmw || share_->GetBitLength() != 1) {
+    throw std::invalid_argument(fmt::format(
+        "ShareWrapper::BitInjection: expected a Boolean GMW bit, got a {} share of {} wires",
+        to_string(share_->GetProtocol()), share_->GetBitLength()));
+  }
+  if (values.empty()) {
+    throw std::invalid_argument("ShareWrapper::BitInjection: no values to multiply");
+  }
+  switch (values.front()->GetBitLength()) {
+    case 8u:
+      return BitInjection<std::uint8_t>(values);
+    case 16u:
+      return BitInjection<std::uint16_t>(values);
+    case 32u:
+      return BitInjection<std::uint32_t>(values);
+    case 64u:
+      return BitInjection<std::uint64_t>(values);
+    default:
+      throw std::bad_cast();
+  }
+}
+
+ShareWrapper ShareWrapper::Lut(std::span<const BitVector<>> table) const {
+  assert(share_);
+  if (share_->GetProtocol() != MpcProtocol::kBooleanGmw) {
+    throw std::invalid_argument(
+        fmt::format("ShareWrapper::Lut: expected a Boolean GMW share, got a {} share",
+                    to_string(share_->GetProtocol())));
+  }
+  auto lut_gate =
+      share_->GetRegister()->EmplaceGate<proto::boolean_gmw::LookupTableGate>(share_, table);
+  return ShareWrapper(lut_gate->GetOutputAsShare());
+}
+
+std::vector<std::vector<ShareWrapper>> Vectorize(
+    std::span<const std::vector<ShareWrapper>> iterations,
+    const std::function<std::vector<ShareWrapper>(std::span<const ShareWrapper>)>& body) {
+  if (iterations.empty()) throw std::invalid_argument("Vectorize: no iterations");
+  const std::size_t number_of_operands{iterations[0].size()};
+  std::vector<std::size_t> simd_begins{0};
+  simd_begins.reserve(iterations.size() + 1);
+  for (const auto& operands : iterations) {
+    if (operands.size() != number_of_operands || operands.empty()) {
+      throw std::invalid_argument(
+          fmt::format("Vectorize: iterations with {} and {} operands", number_of_operands,
+                      operands.size()));
+    }
+    const std::size_t number_of_simd{operands[0]->GetNumberOfSimdValues()};
+    for (const auto& operand : operands) {
+      if (operand->GetNumberOfSimdValues() != number_of_simd) {
+        throw std::invalid_argument(
+            fmt::format("Vectorize: operands of an iteration with {} and {} SIMD values",
+                        number_of_simd, operand->GetNumberOfSimdValues()));
+      }
+    }
+    simd_begins.push_back(simd_begins.back() + number_of_simd);
+  }
+
+  std::vector<ShareWrapper> packed_operands;
+  packed_operands.reserve(number_of_operands);
+  for (std::size_t k = 0; k < number_of_operands; ++k) {
+    std::vector<ShareWrapper> operand_k;
+    operand_k.reserve(iterations.size());
+    for (const auto& operands : iterations) operand_k.push_back(operands[k]);
+    packed_operands.push_back(ShareWrapper::Simdify(std::move(operand_k)));
+  }
+  const auto packed_outputs{body(packed_operands)};
+
+  std::vector<std::vector<ShareWrapper>> outputs(iterations.size());
+  for (const auto& packed_output : packed_outputs) {
+    if (packed_output->GetNumberOfSimdValues() != simd_begins.back()) {
+      throw std::invalid_argument(
+          fmt::format("Vectorize: an output has {} instead of {} SIMD values",
+                      packed_output->GetNumberOfSimdValues(), simd_begins.back()));
+    }
+    SimdBatch batch(packed_output, std::vector<std::size_t>(simd_begins));
+    auto instances{batch.Unsimdify()};
+    for (std::size_t i = 0; i < iterations.size(); ++i) {
+      outputs[i].push_back(std::move(instances[i]));
+    }
+  }
+  return outputs;
+}
+
 ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b) {
   assert(a.size() == b.size());
   assert(a.size() > 0);
   assert(*a[0]);
   assert(*b[0]);
+  if (a[0]->GetProtocol() == MpcProtocol::kBooleanGmw) {
+    return ShareWrapper::BooleanGmwInnerProduct(a, b);
+  }
   assert(a[0]->GetCircuitType() == b[0]->GetCircuitType());
   assert(a[0]->GetBitLength() == b[0]->GetBitLength());
   for (auto i = 1u; i != a.size(); ++i) {
@@ -458,6 +648,7 @@ ShareWrapper ShareWrapper::Convert() const {
   constexpr auto kArithmeticGmw = MpcProtocol::kArithmeticGmw;
   constexpr auto kBooleanGmw = MpcProtocol::kBooleanGmw;
   constexpr auto kBmr = MpcProtocol::kBmr;
+  constexpr auto kGarbledCircuit = MpcProtocol::kGarbledCircuit;
   if (share_->GetProtocol() == P) {
     throw std::runtime_error("Trying to convert share to MpcProtocol it is already in");
   }
@@ -467,21 +658,45 @@ ShareWrapper ShareWrapper::Convert() const {
   if constexpr (P == kArithmeticGmw) {
     if (share_->GetProtocol() == kBooleanGmw) {  // kBooleanGmw -> kArithmeticGmw
       return BooleanGmwToArithmeticGmw();
-    } else {  // kBmr --(over kBooleanGmw)--> kArithmeticGmw
+    } else {  // kBmr/kGarbledCircuit --(over kBooleanGmw)--> kArithmeticGmw
       return this->Convert<kBooleanGmw>().Convert<kArithmeticGmw>();
     }
   } else if constexpr (P == kBooleanGmw) {
-    if (share_->GetProtocol() == kArithmeticGmw) {  // kArithmeticGmw --(over kBmr)--> kBooleanGmw
-      return this->Convert<kBmr>().Convert<kBooleanGmw>();
+    if (share_->GetProtocol() == kArithmeticGmw) {  // kArithmeticGmw -> kBooleanGmw
+      switch (share_->GetBitLength()) {
+        case 8u:
+          return ArithmeticGmwToBooleanGmw<std::uint8_t>();
+        case 16u:
+          return ArithmeticGmwToBooleanGmw<std::uint16_t>();
+        case 32u:
+          return ArithmeticGmwToBooleanGmw<std::uint32_t>();
+        case 64u:
+          return ArithmeticGmwToBooleanGmw<std::uint64_t>();
+        default:
+          throw std::runtime_error(
+              fmt::format("Invalid bit length {} of an arithmetic GMW share",
+                          share_->GetBitLength()));
+      }
+    } else if (share_->GetProtocol() == kGarbledCircuit) {  // kGarbledCircuit -> kBooleanGmw
+      return GarbledCircuitToBooleanGmw();
     } else {  // kBmr -> kBooleanGmw
       return BmrToBooleanGmw();
     }
   } else if constexpr (P == kBmr) {
     if (share_->GetProtocol() == kArithmeticGmw) {  // kArithmeticGmw -> kBmr
       return ArithmeticGmwToBmr();
+    } else if (share_->GetProtocol() == kGarbledCircuit) {
+      // kGarbledCircuit --(over kBooleanGmw)--> kBmr
+      return this->Convert<kBooleanGmw>().Convert<kBmr>();
     } else {  // kBooleanGmw -> kBmr
       return BooleanGmwToBmr();
     }
+  } else if constexpr (P == kGarbledCircuit) {
+    if (share_->GetProtocol() == kBooleanGmw) {  // kBooleanGmw -> kGarbledCircuit
+      return BooleanGmwToGarbledCircuit();
+    } else {  // kArithmeticGmw/kBmr --(over kBooleanGmw)--> kGarbledCircuit
+      return this->Convert<kBooleanGmw>().Convert<kGarbledCircuit>();
+    }
   } else {
     throw std::runtime_error("Unknown MpcProtocol");
   }
@@ -491,6 +706,7 @@ ShareWrapper ShareWrapper::Convert() const {
 template ShareWrapper ShareWrapper::Convert<MpcProtocol::kArithmeticGmw>() const;
 template ShareWrapper ShareWrapper::Convert<MpcProtocol::kBooleanGmw>() const;
 template ShareWrapper ShareWrapper::Convert<MpcProtocol::kBmr>() const;
+template ShareWrapper ShareWrapper::Convert<MpcProtocol::kGarbledCircuit>() const;
 
 ShareWrapper ShareWrapper::ArithmeticGmwToBmr() const {
   auto arithmetic_gmw_to_bmr_gate{
@@ -498,9 +714,30 @@ ShareWrapper ShareWrapper::ArithmeticGmwToBmr() const {
   return ShareWrapper(arithmetic_gmw_to_bmr_gate->GetOutputAsShare());
 }
 
+// Each party locally shares the bits of its arithmetic share, and the n operands are added by a
+// Kogge-Stone adder tree, which is evaluated as a single CircuitGate, i.e., with one message per
+// AND layer instead of garbling a circuit for the detour over BMR.
+template <typename T>
+ShareWrapper ShareWrapper::ArithmeticGmwToBooleanGmw() const {
+  auto local_sharing_gate{
+      share_->GetRegister()->EmplaceGate<ArithmeticGmwToBooleanGmwGate<T>>(share_)};
+  const std::size_t number_of_parties{
+      share_->GetBackend().GetCommunicationLayer().GetNumberOfParties()};
+  const ShareWrapper local_sharings(local_sharing_gate->GetOutputAsShare());
+  return local_sharings.Evaluate(
+      algorithm::KoggeStoneAdditionCircuit(number_of_parties, sizeof(T) * 8));
+}
+
 ShareWrapper ShareWrapper::BooleanGmwToArithmeticGmw() const {
-  const auto bitlength = share_->GetBitLength();
-  switch (bitlength) {
+  return BitsToArithmeticGmw(share_->GetBitLength());
+}
+
+ShareWrapper ShareWrapper::BitsToArithmeticGmw(std::size_t bit_length) const {
+  assert(share_);
+  if (share_->GetProtocol() != MpcProtocol::kBooleanGmw) {
+    throw std::invalid_argument("BitsToArithmeticGmw expects a Boolean GMW share");
+  }
+  switch (bit_length) {
     case 8u: {
       auto boolean_gmw_to_arithmetic_gmw_gate{
           share_->GetRegister()->EmplaceGate<GmwToArithmeticGate<std::uint8_t>>(share_)};
@@ -522,7 +759,7 @@ ShareWrapper ShareWrapper::BooleanGmwToArithmeticGmw() const {
       return ShareWrapper(boolean_gmw_to_arithmetic_gmw_gate->GetOutputAsShare());
     }
     default:
-      throw std::runtime_error(fmt::format("Invalid bitlength {}", bitlength));
+      throw std::runtime_error(fmt::format("Invalid bitlength {}", bit_length));
   }
 }
 
@@ -541,6 +778,20 @@ ShareWrapper ShareWrapper::BmrToBooleanGmw() const {
   return ShareWrapper(bmr_to_boolean_gmw_gate->GetOutputAsShare());
 }
 
+// B2Y, which costs one GOt128 per bit
+ShareWrapper ShareWrapper::BooleanGmwToGarbledCircuit() const {
+  auto boolean_gmw_to_gc_gate{
+      share_->GetRegister()->EmplaceGate<BooleanGmwToGarbledCircuitGate>(share_)};
+  return ShareWrapper(boolean_gmw_to_gc_gate->GetOutputAsShare());
+}
+
+// Y2B, which is local
+ShareWrapper ShareWrapper::GarbledCircuitToBooleanGmw() const {
+  auto gc_to_boolean_gmw_gate{
+      share_->GetRegister()->EmplaceGate<GarbledCircuitToBooleanGmwGate>(share_)};
+  return ShareWrapper(gc_to_boolean_gmw_gate->GetOutputAsShare());
+}
+
 ShareWrapper ShareWrapper::Out(std::size_t output_owner) const {
   assert(share_);
   auto& backend = share_->GetBackend();
@@ -571,6 +822,10 @@ ShareWrapper ShareWrapper::Out(std::size_t output_owner) const {
       }
     } break;
     case MpcProtocol::kAstra: {
+      if (share_->GetCircuitType() == CircuitType::kBoolean) {
+        result = backend.AstraBooleanOutput(share_, output_owner);
+        break;
+      }
       switch (share_->GetBitLength()) {
         case 8u: {
           result = backend.AstraOutput<std::uint8_t>(share_, output_owner);
@@ -624,30 +879,9 @@ std::vector<ShareWrapper> ShareWrapper::Split() const {
   return result;
 }
 
-ShareWrapper ShareWrapper::GetWire(std::size_t i) const { return ShareWrapper(share_->GetWire(i)); }
-
-ShareWrapper ShareWrapper::Concatenate(std::span<const ShareWrapper> input) {
-  if (input.empty()) throw std::runtime_error("ShareWrapper cannot be empty");
-  {
-    const auto protocol = input[0]->GetProtocol();
-    for (auto i = 1ull; i < input.size(); ++i) {
-      if (input[i]->GetProtocol() != protocol) {
-        throw std::runtime_error("Trying to join shares of different types");
-      }
-    }
-  }
-  std::vector<SharePointer> unwrapped_shares;
-  unwrapped_shares.reserve(input.size());
-  for (const auto& s : input) unwrapped_shares.emplace_back(*s);
-
-  std::size_t bit_size_wires{0};
-  for (const auto& s : input) bit_size_wires += s->GetBitLength();
-
-  std::vector<WirePointer> wires;
-  wires.reserve(bit_size_wires);
-  for (const auto& s : input)
-    for (const auto& w : s->GetWires()) wires.emplace_back(w);
-  switch (input[0]->GetProtocol()) {
+// creates the share of the protocol that holds the wires
+static ShareWrapper ShareFromWires(MpcProtocol protocol, std::vector<WirePointer>&& wires) {
+  switch (protocol) {
     case MpcProtocol::kArithmeticGmw: {
       switch (wires.at(0)->GetBitLength()) {
         case 8: {
@@ -669,6 +903,9 @@ ShareWrapper ShareWrapper::Concatenate(std::span<const ShareWrapper> input) {
       }
     }
     case MpcProtocol::kAstra: {
+      if (wires.at(0)->GetCircuitType() == CircuitType::kBoolean) {
+        return ShareWrapper(std::make_shared<proto::astra::BooleanShare>(wires));
+      }
       switch (wires.at(0)->GetBitLength()) {
         case 8: {
           return ShareWrapper(std::make_shared<proto::astra::Share<std::uint8_t>>(wires.at(0)));
@@ -703,7 +940,217 @@ ShareWrapper ShareWrapper::Concatenate(std::span<const ShareWrapper> input) {
   }
 }
 
+ShareWrapper ShareWrapper::GetWire(std::size_t i) const { return ShareWrapper(share_->GetWire(i)); }
+
+ShareView ShareWrapper::View() const { return ShareView(*share_); }
+
+ShareView ShareWrapper::View(std::size_t begin, std::size_t end) const {
+  if (begin > end || end > share_->GetWires().size()) {
+    throw std::out_of_range(
+        fmt::format("ShareWrapper::View: wires [{}, {}) of a share with {} wires", begin, end,
+                    share_->GetWires().size()));
+  }
+  return ShareView(*share_, begin, end);
+}
+
+ShareWrapper ShareWrapper::Concatenate(std::span<const ShareWrapper> input) {
+  if (input.empty()) throw std::runtime_error("ShareWrapper cannot be empty");
+  {
+    const auto protocol = input[0]->GetProtocol();
+    for (auto i = 1ull; i < input.size(); ++i) {
+      if (input[i]->GetProtocol() != protocol) {
+        throw std::runtime_error("Trying to join shares of different types");
+      }
+    }
+  }
+  std::vector<SharePointer> unwrapped_shares;
+  unwrapped_shares.reserve(input.size());
+  for (const auto& s : input) unwrapped_shares.emplace_back(*s);
+
+  std::size_t bit_size_wires{0};
+  for (const auto& s : input) bit_size_wires += s->GetBitLength();
+
+  std::vector<WirePointer> wires;
+  wires.reserve(bit_size_wires);
+  for (const auto& s : input)
+    for (const auto& w : s->GetWires()) wires.emplace_back(w);
+  return ShareFromWires(input[0]->GetProtocol(), std::move(wires));
+}
+
+ShareWrapper ShareWrapper::Concatenate(std::span<const ShareView> input) {
+  if (input.empty()) throw std::runtime_error("ShareWrapper cannot be empty");
+  const auto protocol = input[0].GetProtocol();
+  std::size_t number_of_wires{0};
+  for (const auto& view : input) {
+    if (view.GetProtocol() != protocol) {
+      throw std::runtime_error("Trying to join shares of different types");
+    }
+    number_of_wires += view.GetNumberOfWires();
+  }
+  const auto& first_share{input[0].GetShare()};
+  if (input.size() == 1 && number_of_wires == first_share.GetWires().size()) {
+    return ShareWrapper(std::const_pointer_cast<Share>(first_share.shared_from_this()));
+  }
+  std::vector<WirePointer> wires;
+  wires.reserve(number_of_wires);
+  for (const auto& view : input) {
+    wires.insert(wires.end(), view.GetWires().begin(), view.GetWires().end());
+  }
+  return ShareFromWires(protocol, std::move(wires));
+}
+
 ShareWrapper ShareWrapper::Evaluate(const AlgorithmDescription& algorithm) const {
+  // the algorithm is optimized once for all chunks
+  std::optional<AlgorithmDescription> optimized_algorithm;
+  if (share_->GetBackend().GetConfiguration()->GetOptimizeAlgorithms()) {
+    optimized_algorithm = OptimizeIfConfigured(algorithm);
+  }
+  const auto& evaluated_algorithm{optimized_algorithm ? *optimized_algorithm : algorithm};
+  return EvaluateInChunks([&evaluated_algorithm](const ShareWrapper& chunk) {
+    return chunk.EvaluateUnoptimized(evaluated_algorithm);
+  });
+}
+
+ShareWrapper ShareWrapper::Evaluate(const AlgorithmDescription& algorithm,
+                                    const ProtocolCostModel& cost_model) const {
+  const auto protocol{share_->GetProtocol()};
+  if (protocol != MpcProtocol::kBooleanGmw && protocol != MpcProtocol::kBmr) {
+    throw std::invalid_argument(
+        fmt::format("ShareWrapper::Evaluate: protocols can only be assigned to Boolean GMW or BMR "
+                    "inputs, got a share in {}",
+                    to_string(protocol)));
+  }
+  const auto optimized_algorithm{OptimizeIfConfigured(algorithm)};
+  const std::size_t number_of_parties{
+      share_->GetBackend().GetCommunicationLayer().GetNumberOfParties()};
+  const auto assignment{AssignProtocols(optimized_algorithm, protocol, number_of_parties,
+                                        share_->GetNumberOfSimdValues(), cost_model)};
+  share_->GetRegister()->GetLogger()->LogInfo(fmt::format(
+      "ShareWrapper::Evaluate: assigned protocols with {} switches, estimated {} s instead of {} s "
+      "in {}",
+      assignment.number_of_protocol_switches, assignment.estimated_time.count(),
+      assignment.estimated_time_in_input_protocol.count(), to_string(protocol)));
+  return EvaluateUnoptimized(optimized_algorithm, assignment.gate_protocols);
+}
+
+ShareWrapper ShareWrapper::Evaluate(const CircuitTemplate& circuit_template) const {
+  return EvaluateInChunks([&circuit_template](const ShareWrapper& chunk) {
+    if (chunk->GetProtocol() == MpcProtocol::kBooleanGmw) {
+      auto circuit_gate{chunk->GetRegister()->EmplaceGate<proto::boolean_gmw::CircuitGate>(
+          chunk.Get(), circuit_template.GetFlatCircuit())};
+      return ShareWrapper(circuit_gate->GetOutputAsShare());
+    }
+    return chunk.EvaluateUnoptimized(circuit_template.GetAlgorithmDescription());
+  });
+}
+
+std::vector<ShareWrapper> ShareWrapper::Evaluate(const CircuitTemplate& circuit_template,
+                                                 std::span<const ShareWrapper> inputs) {
+  const bool all_boolean_gmw{std::all_of(inputs.begin(), inputs.end(), [](const auto& input) {
+    return input->GetProtocol() == MpcProtocol::kBooleanGmw;
+  })};
+  std::vector<ShareWrapper> outputs;
+  outputs.reserve(inputs.size());
+  if (inputs.size() < 2 || !all_boolean_gmw) {
+    for (const auto& input : inputs) outputs.emplace_back(input.Evaluate(circuit_template));
+    return outputs;
+  }
+  auto output{Simdify(inputs).Evaluate(circuit_template)};
+  std::vector<std::size_t> positions;
+  for (std::size_t i = 0, begin = 0; i < inputs.size(); ++i) {
+    positions.resize(inputs[i]->GetNumberOfSimdValues());
+    std::iota(positions.begin(), positions.end(), begin);
+    begin += positions.size();
+    outputs.emplace_back(output.Subset(positions));
+  }
+  return outputs;
+}
+
+SimdBatch ShareWrapper::EvaluateBatch(const AlgorithmDescription& algorithm,
+                                      std::span<const ShareWrapper> inputs) {
+  if (inputs.empty()) throw std::invalid_argument("Empty inputs in ShareWrapper::EvaluateBatch");
+  std::vector<std::size_t> simd_begins;
+  simd_begins.reserve(inputs.size() + 1);
+  simd_begins.push_back(0);
+  for (const auto& input : inputs) {
+    simd_begins.push_back(simd_begins.back() + input->GetNumberOfSimdValues());
+  }
+  return SimdBatch(Simdify(inputs).Evaluate(algorithm), std::move(simd_begins));
+}
+
+SimdBatch::SimdBatch(const ShareWrapper& share, std::vector<std::size_t>&& simd_begins)
+    : share_(share), simd_begins_(std::move(simd_begins)) {
+  if (simd_begins_.empty() || simd_begins_.back() != share_->GetNumberOfSimdValues()) {
+    throw std::invalid_argument(
+        fmt::format("SimdBatch: the instances do not cover the {} SIMD values of the share",
+                    share_->GetNumberOfSimdValues()));
+  }
+  instances_.resize(simd_begins_.size() - 1);
+}
+
+const ShareWrapper& SimdBatch::GetInstance(std::size_t i) {
+  auto& instance{instances_.at(i)};
+  if (!instance.Get()) {
+    std::vector<std::size_t> positions(simd_begins_[i + 1] - simd_begins_[i]);
+    std::iota(positions.begin(), positions.end(), simd_begins_[i]);
+    instance = share_.Subset(positions);
+  }
+  return instance;
+}
+
+std::vector<ShareWrapper> SimdBatch::Unsimdify() {
+  const bool none_requested{std::none_of(instances_.begin(), instances_.end(),
+                                         [](const auto& instance) { return instance.Get(); })};
+  if (none_requested && simd_begins_.back() == instances_.size()) {
+    instances_ = share_.Unsimdify();
+    return instances_;
+  }
+  for (std::size_t i = 0; i < instances_.size(); ++i) GetInstance(i);
+  return instances_;
+}
+
+AlgorithmDescription ShareWrapper::OptimizeIfConfigured(
+    const AlgorithmDescription& algorithm) const {
+  if (!share_->GetBackend().GetConfiguration()->GetOptimizeAlgorithms()) return algorithm;
+  AlgorithmOptimizationStatistics statistics;
+  auto optimized_algorithm{OptimizeAlgorithmDescription(algorithm, &statistics)};
+  share_->GetRegister()->GetLogger()->LogInfo(fmt::format(
+      "ShareWrapper::Evaluate: optimized algorithm from {} AND gates of {} gates to {} AND gates "
+      "of {} gates",
+      statistics.number_of_and_gates_before, statistics.number_of_gates_before,
+      statistics.number_of_and_gates_after, statistics.number_of_gates_after));
+  return optimized_algorithm;
+}
+
+ShareWrapper ShareWrapper::EvaluateInChunks(
+    const std::function<ShareWrapper(const ShareWrapper&)>& evaluate) const {
+  const std::size_t chunk_size{share_->GetBackend().GetConfiguration()->GetSimdChunkSize()};
+  const std::size_t number_of_simd{share_->GetNumberOfSimdValues()};
+  // the protocols whose shares can be split by SubsetGates and stitched by a SimdifyGate
+  const auto protocol{share_->GetProtocol()};
+  const bool can_be_chunked{protocol == MpcProtocol::kArithmeticGmw ||
+                            protocol == MpcProtocol::kBooleanGmw || protocol == MpcProtocol::kBmr};
+  if (chunk_size == 0 || number_of_simd <= chunk_size || !can_be_chunked) return evaluate(*this);
+
+  // the gates of the chunks are independent and posted in construction order, such that the setup
+  // and the communication of a chunk overlap with the online phase of the previous ones
+  ShareWrapper input{*this};
+  std::vector<ShareWrapper> outputs;
+  outputs.reserve((number_of_simd + chunk_size - 1) / chunk_size);
+  std::vector<std::size_t> positions;
+  for (std::size_t begin = 0; begin < number_of_simd; begin += chunk_size) {
+    positions.resize(std::min(chunk_size, number_of_simd - begin));
+    std::iota(positions.begin(), positions.end(), begin);
+    outputs.emplace_back(evaluate(input.Subset(positions)));
+  }
+  share_->GetRegister()->GetLogger()->LogDebug(
+      fmt::format("ShareWrapper::Evaluate: split {} SIMD values into {} chunks", number_of_simd,
+                  outputs.size()));
+  return Simdify(outputs);
+}
+
+ShareWrapper ShareWrapper::EvaluateUnoptimized(const AlgorithmDescription& algorithm,
+                                               std::span<const MpcProtocol> gate_protocols) const {
   std::size_t number_of_input_wires = algorithm.number_of_input_wires_parent_a;
   if (algorithm.number_of_input_wires_parent_b)
     number_of_input_wires += *algorithm.number_of_input_wires_parent_b;
@@ -714,6 +1161,13 @@ ShareWrapper ShareWrapper::Evaluate(const AlgorithmDescription& algorithm) const
         number_of_input_wires, share_->GetBitLength()));
   }
 
+  // Boolean GMW evaluates the whole circuit in a single gate
+  if (gate_protocols.empty() && share_->GetProtocol() == MpcProtocol::kBooleanGmw) {
+    auto circuit_gate{
+        share_->GetRegister()->EmplaceGate<proto::boolean_gmw::CircuitGate>(share_, algorithm)};
+    return ShareWrapper(circuit_gate->GetOutputAsShare());
+  }
+
   auto share_split_in_wires{Split()};
   std::vector<std::shared_ptr<ShareWrapper>> pointers_to_wires_of_split_share;
   pointers_to_wires_of_split_share.reserve(share_split_in_wires.size());
@@ -725,35 +1179,59 @@ ShareWrapper ShareWrapper::Evaluate(const AlgorithmDescription& algorithm) const
   assert((algorithm.number_of_gates + number_of_input_wires) ==
          pointers_to_wires_of_split_share.size());
 
+  if (!gate_protocols.empty() && gate_protocols.size() != algorithm.gates.size()) {
+    throw std::invalid_argument(
+        fmt::format("ShareWrapper::Evaluate: got protocols for {} gates, but the algorithm has {} "
+                    "gates",
+                    gate_protocols.size(), algorithm.gates.size()));
+  }
+  // wires converted to the protocol of a gate that uses them, which are converted only once
+  std::vector<std::shared_ptr<ShareWrapper>> converted_wires(
+      gate_protocols.empty() ? 0 : algorithm.number_of_wires);
+  auto wire_in = [&](std::size_t wire, MpcProtocol protocol) -> const ShareWrapper& {
+    const auto& share_wrapper{*pointers_to_wires_of_split_share.at(wire)};
+    if (gate_protocols.empty() || share_wrapper.Get()->GetProtocol() == protocol) {
+      return share_wrapper;
+    }
+    auto& converted_wire{converted_wires.at(wire)};
+    if (!converted_wire) {
+      converted_wire = std::make_shared<ShareWrapper>(
+          protocol == MpcProtocol::kBmr ? share_wrapper.Convert<MpcProtocol::kBmr>()
+                                        : share_wrapper.Convert<MpcProtocol::kBooleanGmw>());
+    }
+    return *converted_wire;
+  };
+
   for (std::size_t wire_i = number_of_input_wires, gate_i = 0; wire_i < algorithm.number_of_wires;
        ++wire_i, ++gate_i) {
     const auto& gate = algorithm.gates.at(gate_i);
     const auto type = gate.type;
+    const auto protocol{gate_protocols.empty() ? share_->GetProtocol() : gate_protocols[gate_i]};
     switch (type) {
       case PrimitiveOperationType::kXor: {
         assert(gate.parent_b);
         pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(*pointers_to_wires_of_split_share.at(gate.parent_a) ^
-                                           *pointers_to_wires_of_split_share.at(*gate.parent_b));
+            std::make_shared<ShareWrapper>(wire_in(gate.parent_a, protocol) ^
+                                           wire_in(*gate.parent_b, protocol));
         break;
       }
       case PrimitiveOperationType::kAnd: {
         assert(gate.parent_b);
         pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(*pointers_to_wires_of_split_share.at(gate.parent_a) &
-                                           *pointers_to_wires_of_split_share.at(*gate.parent_b));
+            std::make_shared<ShareWrapper>(wire_in(gate.parent_a, protocol) &
+                                           wire_in(*gate.parent_b, protocol));
         break;
       }
       case PrimitiveOperationType::kOr: {
         assert(gate.parent_b);
         pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(*pointers_to_wires_of_split_share.at(gate.parent_a) |
-                                           *pointers_to_wires_of_split_share.at(*gate.parent_b));
+            std::make_shared<ShareWrapper>(wire_in(gate.parent_a, protocol) |
+                                           wire_in(*gate.parent_b, protocol));
         break;
       }
       case PrimitiveOperationType::kInv: {
         pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(~*pointers_to_wires_of_split_share.at(gate.parent_a));
+            std::make_shared<ShareWrapper>(~wire_in(gate.parent_a, protocol));
         break;
       }
       default:
@@ -765,7 +1243,7 @@ ShareWrapper ShareWrapper::Evaluate(const AlgorithmDescription& algorithm) const
   output.reserve(pointers_to_wires_of_split_share.size() - algorithm.number_of_output_wires);
   for (auto i = pointers_to_wires_of_split_share.size() - algorithm.number_of_output_wires;
        i < pointers_to_wires_of_split_share.size(); i++) {
-    output.emplace_back(*pointers_to_wires_of_split_share.at(i));
+    output.emplace_back(wire_in(i, share_->GetProtocol()));
   }
 
   return ShareWrapper::Concatenate(output);
@@ -795,6 +1273,13 @@ struct is_specialization : std::false_type {};
 template <template <typename...> class Ref, typename... Args>
 struct is_specialization<Ref<Args...>, Ref> : std::true_type {};
 
+void ShareWrapper::WaitOnline() const {
+  assert(share_);
+  for (const auto& wire : share_->GetWires()) {
+    wire->GetIsReadyCondition().Wait();
+  }
+}
+
 template <typename T>
 T ShareWrapper::As() const {
   ShareConsistencyCheck();
@@ -899,6 +1384,10 @@ bool ShareWrapper::As<bool>() const {
     auto gc_wire = std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(share_->GetWires()[0]);
     assert(gc_wire);
     return gc_wire->CopyPermutationBits()[0];
+  } else if (share_->GetProtocol() == MpcProtocol::kAstra) {
+    auto astra_wire = std::dynamic_pointer_cast<proto::astra::BooleanWire>(share_->GetWires()[0]);
+    assert(astra_wire);
+    return astra_wire->GetValues()[0];
   } else {
     throw std::invalid_argument("Unsupported Boolean protocol in ShareWrapper::As()");
   }
@@ -929,6 +1418,10 @@ BitVector<> ShareWrapper::As() const {
     auto gc_wire = std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(share_->GetWires()[0]);
     assert(gc_wire);
     return gc_wire->CopyPermutationBits();
+  } else if (share_->GetProtocol() == MpcProtocol::kAstra) {
+    auto astra_wire = std::dynamic_pointer_cast<proto::astra::BooleanWire>(share_->GetWires()[0]);
+    assert(astra_wire);
+    return astra_wire->GetValues();
   } else {
     throw std::invalid_argument("Unsupported Boolean protocol in ShareWrapper::As()");
   }
@@ -954,6 +1447,53 @@ template std::vector<std::uint16_t> ShareWrapper::As() const;
 template std::vector<std::uint32_t> ShareWrapper::As() const;
 template std::vector<std::uint64_t> ShareWrapper::As() const;
 
+template <typename T>
+void ShareWrapper::WriteTo(std::span<T> output) const {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  using U = std::make_unsigned_t<T>;
+  ShareConsistencyCheck();
+  if (share_->GetCircuitType() != CircuitType::kArithmetic) {
+    throw std::invalid_argument(
+        "Trying to ShareWrapper::WriteTo() an arithmetic output with non-arithmetic input");
+  }
+  if (share_->GetNumberOfSimdValues() != output.size()) {
+    throw std::invalid_argument(
+        fmt::format("Trying to ShareWrapper::WriteTo() {} values into a buffer of {} values",
+                    share_->GetNumberOfSimdValues(), output.size()));
+  }
+  const auto write_values = [&output](const auto& values) {
+    std::transform(values.begin(), values.end(), output.begin(),
+                   [](U value) { return static_cast<T>(value); });
+  };
+  if (share_->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    auto arithmetic_gmw_wire =
+        std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<U>>(share_->GetWires()[0]);
+    assert(arithmetic_gmw_wire);
+    write_values(arithmetic_gmw_wire->GetValues());
+  } else if (share_->GetProtocol() == MpcProtocol::kArithmeticConstant) {
+    auto constant_arithmetic_wire =
+        std::dynamic_pointer_cast<proto::ConstantArithmeticWire<U>>(share_->GetWires()[0]);
+    assert(constant_arithmetic_wire);
+    write_values(constant_arithmetic_wire->GetValues());
+  } else if (share_->GetProtocol() == MpcProtocol::kAstra) {
+    auto astra_wire = std::dynamic_pointer_cast<proto::astra::Wire<U>>(share_->GetWires()[0]);
+    assert(astra_wire);
+    const auto& values = astra_wire->GetValues();
+    for (std::size_t i = 0; i < output.size(); ++i) output[i] = static_cast<T>(values[i].value);
+  } else {
+    throw std::invalid_argument("Unsupported arithmetic protocol in ShareWrapper::WriteTo()");
+  }
+}
+
+template void ShareWrapper::WriteTo(std::span<std::uint8_t> output) const;
+template void ShareWrapper::WriteTo(std::span<std::uint16_t> output) const;
+template void ShareWrapper::WriteTo(std::span<std::uint32_t> output) const;
+template void ShareWrapper::WriteTo(std::span<std::uint64_t> output) const;
+template void ShareWrapper::WriteTo(std::span<std::int8_t> output) const;
+template void ShareWrapper::WriteTo(std::span<std::int16_t> output) const;
+template void ShareWrapper::WriteTo(std::span<std::int32_t> output) const;
+template void ShareWrapper::WriteTo(std::span<std::int64_t> output) const;
+
 template <typename T>
 ShareWrapper ShareWrapper::Add(SharePointer share, SharePointer other) const {
   assert(share->GetProtocol() == other->GetProtocol() ||
@@ -1140,41 +1680,92 @@ ShareWrapper ShareWrapper::Mul(SharePointer share, SharePointer other) const {
   }
 }
 
+// the comparison of b and a that is equivalent to the comparison of a and b
+static ComparisonType MirrorComparison(ComparisonType comparison_type) {
+  switch (comparison_type) {
+    case ComparisonType::kGreaterThan:
+      return ComparisonType::kLessThan;
+    case ComparisonType::kGreaterThanOrEqual:
+      return ComparisonType::kLessThanOrEqual;
+    case ComparisonType::kLessThan:
+      return ComparisonType::kGreaterThan;
+    case ComparisonType::kLessThanOrEqual:
+      return ComparisonType::kGreaterThanOrEqual;
+    default:
+      return comparison_type;
+  }
+}
+
 template <typename T>
-ShareWrapper ShareWrapper::GreaterThan(SharePointer share, SharePointer other) const {
-  if (share_->GetCircuitType() != CircuitType::kArithmetic) {
-    throw std::invalid_argument("Trying to ShareWrapper::GreaterThan() with non-Arithmetic inputs");
-  } else if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+ShareWrapper ShareWrapper::Compare(SharePointer share, SharePointer other,
+                                   ComparisonType comparison_type) const {
+  if (share->IsConstant()) {
+    std::swap(share, other);
+    comparison_type = MirrorComparison(comparison_type);
+  }
+  if (share->GetProtocol() != MpcProtocol::kArithmeticGmw) {
     throw std::invalid_argument(
-        "ShareWrapper::GreaterThan() is implemented only for the arithmetic GMW protocol");
+        "ShareWrapper::Compare() is implemented only for the arithmetic GMW protocol");
   }
 
   auto this_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(share);
   assert(this_a);
   auto this_wire_a = this_a->GetArithmeticWire();
 
-  auto other_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(other);
-  assert(other_a);
-  auto other_wire_a = other_a->GetArithmeticWire();
-
-  std::size_t l_s = 7;
-
-  auto greater_than_gate =
-      share_->GetRegister()->template EmplaceGate<proto::arithmetic_gmw::GreaterThanGate<T>>(
-          this_wire_a, other_wire_a, l_s);
-  auto result = std::static_pointer_cast<Share>(greater_than_gate->GetOutputAsGmwShare());
+  constexpr std::size_t kChunkBitLength{7};
+  std::shared_ptr<proto::arithmetic_gmw::ComparisonGate<T>> comparison_gate;
+  if (other->IsConstant()) {
+    // the public values are folded into the shares instead of being shared first
+    auto constant_wire =
+        std::dynamic_pointer_cast<proto::ConstantArithmeticWire<T>>(other->GetWires()[0]);
+    assert(constant_wire);
+    comparison_gate =
+        share_->GetRegister()->template EmplaceGate<proto::arithmetic_gmw::ComparisonGate<T>>(
+            this_wire_a, constant_wire->GetValues(), comparison_type, kChunkBitLength);
+  } else {
+    auto other_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(other);
+    assert(other_a);
+    auto other_wire_a = other_a->GetArithmeticWire();
+    comparison_gate =
+        share_->GetRegister()->template EmplaceGate<proto::arithmetic_gmw::ComparisonGate<T>>(
+            this_wire_a, other_wire_a, comparison_type, kChunkBitLength);
+  }
+  auto result = std::static_pointer_cast<Share>(comparison_gate->GetOutputAsGmwShare());
 
   return ShareWrapper(result);
 }
 
-template ShareWrapper ShareWrapper::GreaterThan<std::uint8_t>(SharePointer share,
-                                                              SharePointer other) const;
-template ShareWrapper ShareWrapper::GreaterThan<std::uint16_t>(SharePointer share,
-                                                               SharePointer other) const;
-template ShareWrapper ShareWrapper::GreaterThan<std::uint32_t>(SharePointer share,
-                                                               SharePointer other) const;
-template ShareWrapper ShareWrapper::GreaterThan<std::uint64_t>(SharePointer share,
-                                                               SharePointer other) const;
+template ShareWrapper ShareWrapper::Compare<std::uint8_t>(SharePointer share, SharePointer other,
+                                                          ComparisonType comparison_type) const;
+template ShareWrapper ShareWrapper::Compare<std::uint16_t>(SharePointer share, SharePointer other,
+                                                           ComparisonType comparison_type) const;
+template ShareWrapper ShareWrapper::Compare<std::uint32_t>(SharePointer share, SharePointer other,
+                                                           ComparisonType comparison_type) const;
+template ShareWrapper ShareWrapper::Compare<std::uint64_t>(SharePointer share, SharePointer other,
+                                                           ComparisonType comparison_type) const;
+
+template <typename T>
+std::vector<ShareWrapper> ShareWrapper::BitInjection(std::span<const ShareWrapper> values) const {
+  auto bit_wire{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(share_->GetWires().at(0))};
+  assert(bit_wire);
+  std::vector<proto::arithmetic_gmw::WirePointer<T>> value_wires;
+  value_wires.reserve(values.size());
+  for (const auto& value : values) {
+    auto agmw_share{std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(*value)};
+    if (!agmw_share) {
+      throw std::invalid_argument(
+          fmt::format("ShareWrapper::BitInjection: expected {}-bit arithmetic GMW values, got a "
+                      "{}-bit {} share",
+                      sizeof(T) * 8, value->GetBitLength(), to_string(value->GetProtocol())));
+    }
+    value_wires.emplace_back(agmw_share->GetArithmeticWire());
+  }
+  auto bit_injection_gate{
+      share_->GetRegister()->EmplaceGate<proto::arithmetic_gmw::BitInjectionGate<T>>(
+          bit_wire, value_wires)};
+  const auto products{bit_injection_gate->GetOutputAsArithmeticShares()};
+  return std::vector<ShareWrapper>(products.begin(), products.end());
+}
 
 template <typename T>
 ShareWrapper ShareWrapper::HybridMul(SharePointer share_bit, SharePointer share_integer) const {
@@ -1211,6 +1802,111 @@ ShareWrapper ShareWrapper::Square(SharePointer share) const {
   return ShareWrapper(result);
 }
 
+template <typename T>
+ShareWrapper ShareWrapper::Truncate(SharePointer share,
+                                    std::size_t number_of_fractional_bits) const {
+  auto this_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(share);
+  assert(this_a);
+  auto this_wire_a = this_a->GetArithmeticWire();
+
+  auto truncation_gate =
+      share_->GetRegister()->EmplaceGate<proto::arithmetic_gmw::TruncationGate<T>>(
+          this_wire_a, number_of_fractional_bits);
+  auto result = std::static_pointer_cast<Share>(truncation_gate->GetOutputAsArithmeticShare());
+  return ShareWrapper(result);
+}
+
+// computes the bits of x = m - lambda1 - lambda2 from the Boolean Astra shares of the bits of m,
+// lambda1 and lambda2 given by BooleanOperandsGate, where x = m + ~lambda1 + ~lambda2 + 2 in two's
+// complement. A carry-save layer reduces the three summands to s + 2 * c + 2, which is added with
+// a Kogge-Stone parallel-prefix adder, or, for the MSB only, with a tree of the group generates
+// and propagates that skips the propagates of the groups containing the least significant bit.
+template <typename T>
+ShareWrapper ShareWrapper::AstraBitDecomposition(bool only_msb) const {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  auto astra_share = std::dynamic_pointer_cast<proto::astra::Share<T>>(share_);
+  assert(astra_share);
+  auto operands_gate = share_->GetRegister()->EmplaceGate<proto::astra::BooleanOperandsGate<T>>(
+      astra_share->GetAstraWire());
+  const auto operands{ShareWrapper(operands_gate->GetOutputAsAstraShare()).Split()};
+
+  // concatenates the single-wire shares bits[from, to)
+  auto wires = [](const std::vector<ShareWrapper>& bits, std::size_t from, std::size_t to) {
+    return Concatenate(std::span(bits).subspan(from, to - from));
+  };
+
+  const auto m{wires(operands, 0, kBitLength)};
+  const auto not_lambda1{~wires(operands, kBitLength, 2 * kBitLength)};
+  const auto not_lambda2{~wires(operands, 2 * kBitLength, 3 * kBitLength)};
+  const auto m_xor_not_lambda2{m ^ not_lambda2};
+  const auto s{(m_xor_not_lambda2 ^ not_lambda1).Split()};
+  const auto c{(((m_xor_not_lambda2 & (not_lambda1 ^ not_lambda2)) ^ not_lambda2)).Split()};
+
+  // adds the bits s[1, k) and c[0, k - 1) with the carry-in 1 of the summand 2, whose generates
+  // and propagates are only needed for the positions [0, k - 2), where G[0] includes the carry-in
+  const std::size_t n{kBitLength - 1}, number_of_groups{kBitLength - 2};
+  const auto p{(wires(s, 1, kBitLength) ^ wires(c, 0, n)).Split()};
+  auto g{(wires(s, 1, n) & wires(c, 0, number_of_groups)).Split()};
+  g[0] = g[0] ^ p[0];
+  auto generates{std::move(g)};
+  auto propagates{std::vector<ShareWrapper>(p.begin(), p.begin() + number_of_groups)};
+
+  if (only_msb) {
+    while (generates.size() > 1) {
+      // combines the groups 2i and 2i + 1 into (G_2i+1 ^ P_2i+1 & G_2i, P_2i+1 & P_2i), where the
+      // group 0 containing the least significant bit needs no propagate
+      const std::size_t number_of_pairs{generates.size() / 2};
+      std::vector<ShareWrapper> lhs, rhs, higher_generates;
+      for (std::size_t i = 0; i != number_of_pairs; ++i) {
+        lhs.emplace_back(propagates[2 * i + 1]);
+        rhs.emplace_back(generates[2 * i]);
+        higher_generates.emplace_back(generates[2 * i + 1]);
+      }
+      for (std::size_t i = 1; i != number_of_pairs; ++i) {
+        lhs.emplace_back(propagates[2 * i + 1]);
+        rhs.emplace_back(propagates[2 * i]);
+      }
+      const auto products{(Concatenate(lhs) & Concatenate(rhs)).Split()};
+      const auto combined_generates{
+          (Concatenate(higher_generates) ^ wires(products, 0, number_of_pairs)).Split()};
+
+      std::vector<ShareWrapper> next_generates, next_propagates;
+      for (std::size_t i = 0; i != number_of_pairs; ++i) {
+        next_generates.emplace_back(combined_generates[i]);
+        next_propagates.emplace_back(i == 0 ? propagates[0] : products[number_of_pairs + i - 1]);
+      }
+      if (generates.size() % 2 == 1) {
+        next_generates.emplace_back(generates.back());
+        next_propagates.emplace_back(propagates.back());
+      }
+      generates = std::move(next_generates);
+      propagates = std::move(next_propagates);
+    }
+    return p[n - 1] ^ generates[0];
+  }
+
+  for (std::size_t d = 1; d < number_of_groups; d *= 2) {
+    // G_j = G_j ^ P_j & G_j-d for j >= d and P_j = P_j & P_j-d for j >= 2d
+    const std::size_t number_of_propagates{number_of_groups > 2 * d ? number_of_groups - 2 * d
+                                                                     : 0};
+    std::vector<ShareWrapper> lhs(propagates.begin() + d, propagates.end());
+    std::vector<ShareWrapper> rhs(generates.begin(), generates.end() - d);
+    lhs.insert(lhs.end(), propagates.end() - number_of_propagates, propagates.end());
+    rhs.insert(rhs.end(), propagates.begin() + d, propagates.begin() + d + number_of_propagates);
+    const auto products{(Concatenate(lhs) & Concatenate(rhs)).Split()};
+    const auto updated_generates{
+        (wires(generates, d, number_of_groups) ^ wires(products, 0, number_of_groups - d)).Split()};
+    std::copy(updated_generates.begin(), updated_generates.end(), generates.begin() + d);
+    std::copy(products.begin() + (number_of_groups - d), products.end(),
+              propagates.end() - number_of_propagates);
+  }
+
+  std::vector<ShareWrapper> bits{s[0], ~p[0]};
+  const auto upper_bits{(wires(p, 1, n) ^ wires(generates, 0, n - 1)).Split()};
+  bits.insert(bits.end(), upper_bits.begin(), upper_bits.end());
+  return Concatenate(bits);
+}
+
 template ShareWrapper ShareWrapper::Mul<std::uint8_t>(SharePointer share, SharePointer other) const;
 template ShareWrapper ShareWrapper::Mul<std::uint16_t>(SharePointer share,
                                                        SharePointer other) const;
@@ -1218,6 +1914,8 @@ template ShareWrapper ShareWrapper::Mul<std::uint32_t>(SharePointer share,
                                                        SharePointer other) const;
 template ShareWrapper ShareWrapper::Mul<std::uint64_t>(SharePointer share,
                                                        SharePointer other) const;
+template ShareWrapper ShareWrapper::Mul<__uint128_t>(SharePointer share,
+                                                     SharePointer other) const;
 
 template ShareWrapper ShareWrapper::HybridMul<std::uint8_t>(SharePointer share,
                                                             SharePointer other) const;
@@ -1227,6 +1925,150 @@ template ShareWrapper ShareWrapper::HybridMul<std::uint32_t>(SharePointer share,
                                                              SharePointer other) const;
 template ShareWrapper ShareWrapper::HybridMul<std::uint64_t>(SharePointer share,
                                                              SharePointer other) const;
+ShareWrapper MatrixMultiplication(const ShareWrapper& a, const ShareWrapper& b, std::size_t rows,
+                                  std::size_t inner, std::size_t columns) {
+  assert(*a);
+  assert(*b);
+  assert(a->GetBitLength() == b->GetBitLength());
+  if (a->GetProtocol() != b->GetProtocol() || (a->GetProtocol() != MpcProtocol::kArithmeticGmw &&
+                                                a->GetProtocol() != MpcProtocol::kAstra)) {
+    throw std::invalid_argument("MatrixMultiplication requires arithmetic GMW or Astra shares");
+  }
+
+  switch (a->GetBitLength()) {
+    case 8u:
+      return a.MatrixMultiplication<std::uint8_t>(b, rows, inner, columns);
+    case 16u:
+      return a.MatrixMultiplication<std::uint16_t>(b, rows, inner, columns);
+    case 32u:
+      return a.MatrixMultiplication<std::uint32_t>(b, rows, inner, columns);
+    case 64u:
+      return a.MatrixMultiplication<std::uint64_t>(b, rows, inner, columns);
+    default:
+      throw std::bad_cast();
+  }
+}
+
+// reduces the inputs with operation applied to groups of up to kMaxMultiplicationFanIn shares
+template <typename MultiInputOperation>
+static ShareWrapper ReduceInGroups(std::vector<ShareWrapper> layer,
+                                   MultiInputOperation operation) {
+  while (layer.size() > 1) {
+    std::vector<ShareWrapper> next_layer;
+    next_layer.reserve(DivideAndCeil(layer.size(), kMaxMultiplicationFanIn));
+    for (std::size_t i = 0; i < layer.size(); i += kMaxMultiplicationFanIn) {
+      const std::size_t group_size{std::min(kMaxMultiplicationFanIn, layer.size() - i)};
+      if (group_size == 1) {
+        next_layer.emplace_back(layer[i]);
+      } else {
+        next_layer.emplace_back(
+            operation(std::span<const ShareWrapper>(layer).subspan(i, group_size)));
+      }
+    }
+    layer = std::move(next_layer);
+  }
+  return layer.at(0);
+}
+
+static bool AreNonConstantSharesOf(std::span<const ShareWrapper> inputs, MpcProtocol protocol) {
+  return std::all_of(inputs.begin(), inputs.end(), [protocol](const ShareWrapper& input) {
+    return input->GetProtocol() == protocol && !input->IsConstant();
+  });
+}
+
+ShareWrapper And(std::span<const ShareWrapper> inputs) {
+  if (inputs.empty()) throw std::invalid_argument("Empty inputs in And");
+  std::vector<ShareWrapper> layer(inputs.begin(), inputs.end());
+  if (!AreNonConstantSharesOf(inputs, MpcProtocol::kBooleanGmw)) {
+    return LowDepthReduce(std::move(layer), std::bit_and<>{});
+  }
+  return ReduceInGroups(std::move(layer), ShareWrapper::MultiInputAnd);
+}
+
+ShareWrapper Product(std::span<const ShareWrapper> inputs) {
+  if (inputs.empty()) throw std::invalid_argument("Empty inputs in Product");
+  std::vector<ShareWrapper> layer(inputs.begin(), inputs.end());
+  if (!AreNonConstantSharesOf(inputs, MpcProtocol::kArithmeticGmw)) {
+    return LowDepthReduce(std::move(layer), std::multiplies<>{});
+  }
+  switch (inputs[0]->GetBitLength()) {
+    case 8u:
+      return ReduceInGroups(std::move(layer), ShareWrapper::MultiInputMul<std::uint8_t>);
+    case 16u:
+      return ReduceInGroups(std::move(layer), ShareWrapper::MultiInputMul<std::uint16_t>);
+    case 32u:
+      return ReduceInGroups(std::move(layer), ShareWrapper::MultiInputMul<std::uint32_t>);
+    case 64u:
+      return ReduceInGroups(std::move(layer), ShareWrapper::MultiInputMul<std::uint64_t>);
+    case 128u:
+      return ReduceInGroups(std::move(layer), ShareWrapper::MultiInputMul<__uint128_t>);
+    default:
+      throw std::bad_cast();
+  }
+}
+
+ShareWrapper ShareWrapper::MultiInputAnd(std::span<const ShareWrapper> inputs) {
+  std::vector<SharePointer> shares;
+  shares.reserve(inputs.size());
+  for (const auto& input : inputs) shares.emplace_back(input.share_);
+  auto and_gate =
+      inputs[0]->GetRegister()->EmplaceGate<proto::boolean_gmw::MultiInputAndGate>(shares);
+  return ShareWrapper(and_gate->GetOutputAsShare());
+}
+
+ShareWrapper ShareWrapper::BooleanGmwInnerProduct(std::span<ShareWrapper> a,
+                                                  std::span<ShareWrapper> b) {
+  std::vector<SharePointer> shares_a, shares_b;
+  shares_a.reserve(a.size());
+  shares_b.reserve(b.size());
+  for (const auto& share : a) shares_a.emplace_back(share.share_);
+  for (const auto& share : b) shares_b.emplace_back(share.share_);
+  auto inner_product_gate =
+      a[0]->GetRegister()->EmplaceGate<proto::boolean_gmw::InnerProductGate>(shares_a, shares_b);
+  return ShareWrapper(inner_product_gate->GetOutputAsShare());
+}
+
+template <typename T>
+ShareWrapper ShareWrapper::MultiInputMul(std::span<const ShareWrapper> inputs) {
+  std::vector<proto::arithmetic_gmw::WirePointer<T>> wires;
+  wires.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    auto share = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(input.share_);
+    assert(share);
+    wires.emplace_back(share->GetArithmeticWire());
+  }
+  auto multiplication_gate =
+      inputs[0]->GetRegister()->EmplaceGate<proto::arithmetic_gmw::MultiInputMultiplicationGate<T>>(
+          wires);
+  return ShareWrapper(
+      std::static_pointer_cast<Share>(multiplication_gate->GetOutputAsArithmeticShare()));
+}
+
+template <typename T>
+ShareWrapper ShareWrapper::MatrixMultiplication(const ShareWrapper& other, std::size_t rows,
+                                                std::size_t inner, std::size_t columns) const {
+  if (share_->GetProtocol() == MpcProtocol::kAstra) {
+    auto this_a = std::dynamic_pointer_cast<proto::astra::Share<T>>(share_);
+    assert(this_a);
+    auto other_a = std::dynamic_pointer_cast<proto::astra::Share<T>>(other.share_);
+    assert(other_a);
+    auto matrix_multiplication_gate =
+        share_->GetRegister()->EmplaceGate<proto::astra::MatrixMultiplicationGate<T>>(
+            this_a->GetAstraWire(), other_a->GetAstraWire(), rows, inner, columns);
+    return ShareWrapper(
+        std::static_pointer_cast<Share>(matrix_multiplication_gate->GetOutputAsAstraShare()));
+  }
+  auto this_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(share_);
+  assert(this_a);
+  auto other_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(other.share_);
+  assert(other_a);
+  auto matrix_multiplication_gate =
+      share_->GetRegister()->EmplaceGate<proto::arithmetic_gmw::MatrixMultiplicationGate<T>>(
+          this_a->GetArithmeticWire(), other_a->GetArithmeticWire(), rows, inner, columns);
+  return ShareWrapper(
+      std::static_pointer_cast<Share>(matrix_multiplication_gate->GetOutputAsArithmeticShare()));
+}
+
 template <typename T>
 ShareWrapper ShareWrapper::DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b) const {
   switch (a[0]->GetProtocol()) {
@@ -1269,11 +2111,17 @@ ShareWrapper ShareWrapper::Subset(std::vector<std::size_t>&& positions) {
 }
 
 ShareWrapper ShareWrapper::Subset(std::span<const std::size_t> positions) {
+  // the identity subset references the wires of this share instead of copying them
+  const std::size_t number_of_simd{share_->GetNumberOfSimdValues()};
+  bool is_identity{positions.size() == number_of_simd};
+  for (std::size_t i = 0; is_identity && i < positions.size(); ++i) is_identity = positions[i] == i;
+  if (is_identity) return *this;
   auto subset_gate = share_->GetRegister()->EmplaceGate<SubsetGate>(share_, positions);
   return ShareWrapper(subset_gate->GetOutputAsShare());
 }
 
 std::vector<ShareWrapper> ShareWrapper::Unsimdify() {
+  if (share_->GetNumberOfSimdValues() == 1) return {*this};
   auto unsimdify_gate = share_->GetRegister()->EmplaceGate<UnsimdifyGate>(share_);
   std::vector<SharePointer> shares{unsimdify_gate->GetOutputAsVectorOfShares()};
   std::vector<ShareWrapper> result(shares.size());
@@ -1282,6 +2130,11 @@ std::vector<ShareWrapper> ShareWrapper::Unsimdify() {
   return result;
 }
 
+ShareWrapper ShareWrapper::TransposeWiresSimd() const {
+  auto transpose_gate = share_->GetRegister()->EmplaceGate<TransposeGate>(share_);
+  return ShareWrapper(transpose_gate->GetOutputAsShare());
+}
+
 ShareWrapper ShareWrapper::Simdify(std::span<const ShareWrapper> input) {
   std::vector<SharePointer> input_as_shares;
   input_as_shares.reserve(input.size());
@@ -1291,10 +2144,19 @@ ShareWrapper ShareWrapper::Simdify(std::span<const ShareWrapper> input) {
 
 ShareWrapper ShareWrapper::Simdify(std::span<SharePointer> input) {
   if (input.empty()) throw std::invalid_argument("Empty inputs in ShareWrapper::Simdify");
+  if (input.size() == 1) return ShareWrapper(input[0]);
   auto simdify_gate = input[0]->GetRegister()->EmplaceGate<SimdifyGate>(input);
   return simdify_gate->GetOutputAsShare();
 }
 
 ShareWrapper ShareWrapper::Simdify(std::vector<ShareWrapper>&& input) { return Simdify(input); }
 
+ShareWrapper ShareWrapper::Simdify(std::span<const ShareView> input) {
+  if (input.empty()) throw std::invalid_argument("Empty inputs in ShareWrapper::Simdify");
+  if (input.size() == 1) return Concatenate(input);
+  auto simdify_gate =
+      input[0].GetShare().GetBackend().GetRegister()->EmplaceGate<SimdifyGate>(input);
+  return simdify_gate->GetOutputAsShare();
+}
+
 }  // namespace encrypto::motion
@@ -24,20 +24,27 @@
 
 #pragma once
 
+#include <functional>
 #include <limits>
 #include <memory>
 #include <span>
 #include <vector>
 
+#include "utility/bit_vector.h"
 #include "utility/typedefs.h"
 
 namespace encrypto::motion {
 
 struct AlgorithmDescription;
+class CircuitTemplate;
+struct ProtocolCostModel;
 
 class Share;
 using SharePointer = std::shared_ptr<Share>;
 
+class ShareView;
+class SimdBatch;
+
 class ShareWrapper {
  public:
   ShareWrapper() : share_(nullptr){};
@@ -94,18 +101,79 @@ class ShareWrapper {
   
   friend ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b);
 
+  friend ShareWrapper MatrixMultiplication(const ShareWrapper& a, const ShareWrapper& b,
+                                           std::size_t rows, std::size_t inner,
+                                           std::size_t columns);
+
+  friend ShareWrapper And(std::span<const ShareWrapper> inputs);
+
+  friend ShareWrapper Product(std::span<const ShareWrapper> inputs);
+
+
+  /// \brief probabilistically truncates f = number_of_fractional_bits bits of an arithmetic GMW
+  /// share of a two's complement value x with |x| < 2^(k - 2) for k = 8, 16, 32, 64 in a single
+  /// round, i.e., yields floor(x / 2^f) or floor(x / 2^f) + 1. Throws if the share is not an
+  /// arithmetic GMW share or if f > k - 2.
+  ShareWrapper Truncate(std::size_t number_of_fractional_bits) const;
+
+  /// \brief decomposes an arithmetic Astra share of x in Z_{2^k} into a Boolean Astra share of the
+  /// k bits of x, least significant bit first, without leaving the Astra protocol. The bits of the
+  /// masked value and the masks are subtracted with a parallel-prefix adder in O(log k) rounds of
+  /// batched AND gates. Throws if the share is not an arithmetic Astra share.
+  ShareWrapper BitDecomposition() const;
+
+  /// \brief computes a Boolean Astra share of the most significant bit of an arithmetic Astra
+  /// share, i.e., of x < 0 for x in two's complement, with the carry tree of BitDecomposition().
+  /// Throws if the share is not an arithmetic Astra share.
+  ShareWrapper Msb() const;
 
   ShareWrapper operator==(const ShareWrapper& other) const;
 
   ShareWrapper operator>(const ShareWrapper& other) const;
 
+  ShareWrapper operator>=(const ShareWrapper& other) const;
+
+  ShareWrapper operator<(const ShareWrapper& other) const;
+
+  ShareWrapper operator<=(const ShareWrapper& other) const;
+
+  /// \brief checks lower <= *this <= upper with two comparisons and an AND. The comparisons of
+  /// arithmetic GMW shares require 2 parties and values smaller than 2^(k - 1).
+  ShareWrapper IsInRange(const ShareWrapper& lower, const ShareWrapper& upper) const;
+
   // use this as the selection bit
   // returns this ? a : b
+  // for arithmetic GMW shares a and b, this is a Boolean GMW bit, see BitInjection, or an
+  // arithmetic GMW share of 0 or 1
   ShareWrapper Mux(const ShareWrapper& a, const ShareWrapper& b) const;
 
+  /// \brief multiplies this two-party Boolean GMW bit with each of the arithmetic GMW shares in
+  /// values with one additively correlated OT per SIMD value and party for all values, e.g., to
+  /// select several values with the same bit. The shares in values must have the same bit length
+  /// and number of SIMD values as this bit.
+  /// \throws invalid_argument if this is not a Boolean GMW share of one wire or values is empty.
+  std::vector<ShareWrapper> BitInjection(std::span<const ShareWrapper> values) const;
+
+  /// \brief evaluates the public lookup table T: {0,1}^k -> {0,1}^m for k = 1, ..., 8 on this
+  /// k-bit share with a single 1-out-of-2^k OT per SIMD value, e.g., an S-box, instead of a circuit
+  /// of AND gates. table[x] holds the m output bits of the input x, whose bit i is wire i.
+  /// \throws invalid_argument if this->share_ is not a two-party Boolean GMW share, or if the table
+  /// does not have 2^k entries of the same non-zero number of bits.
+  ShareWrapper Lut(std::span<const BitVector<>> table) const;
+
+  /// \brief converts this share into protocol P. Two-party garbled circuit shares are converted
+  /// into Boolean GMW shares locally (Y2B) and back by one GOt128 per bit (B2Y), conversions
+  /// between garbled circuits and the other protocols go over Boolean GMW.
   template <MpcProtocol P>
   ShareWrapper Convert() const;
 
+  /// \brief converts a Boolean GMW share of l <= k bits into an arithmetic GMW share of the
+  /// zero-extended l-bit values in Z/2^kZ for k = bit_length = 8, 16, 32, 64, e.g., a comparison
+  /// bit that is multiplied with a k-bit value. The l bits are masked with daBits and opened in
+  /// one message per party. Convert<MpcProtocol::kArithmeticGmw>() is the case l = k.
+  /// \throws invalid_argument if the share is not a Boolean GMW share or l > k.
+  ShareWrapper BitsToArithmeticGmw(std::size_t bit_length) const;
+
   SharePointer& Get() { return share_; }
 
   const SharePointer& Get() const { return share_; }
@@ -125,6 +193,13 @@ class ShareWrapper {
   /// \throws if i is out of range.
   ShareWrapper GetWire(std::size_t i) const;
 
+  /// \brief yields a view of all wires of share_, which allocates no share, see ShareView.
+  ShareView View() const;
+
+  /// \brief yields a view of the wires [begin, end) of share_, see ShareView.
+  /// \throws out_of_range if end is larger than the number of wires or begin is larger than end.
+  ShareView View(std::size_t begin, std::size_t end) const;
+
   /// \brief concatenates wires in multiple shares in one share.
   /// \throws if wires have different numbers of SIMD values.
   static ShareWrapper Concatenate(std::vector<ShareWrapper>&& input) { return Concatenate(input); }
@@ -141,6 +216,11 @@ class ShareWrapper {
   /// numbers of SIMD values.
   static ShareWrapper Concatenate(std::span<const ShareWrapper> input);
 
+  /// \brief concatenates the wires of multiple views in one share, which is the only share that
+  /// is created. A single view of all wires of a share yields that share.
+  /// \throws if the views have different protocols.
+  static ShareWrapper Concatenate(std::span<const ShareView> input);
+
   /// \brief evaluates AlgorithmDescription also on this->share_ as input.
   /// \returns the output share of the evaluated circuit as ShareWrapper.
   ShareWrapper Evaluate(const std::shared_ptr<const AlgorithmDescription>& algo) const {
@@ -148,9 +228,44 @@ class ShareWrapper {
   }
 
   /// \brief constructs a circuit from AlgorithmDescription algo and sets this->share_ as input.
+  /// The circuit is optimized first if Configuration::SetOptimizeAlgorithms() is set. Shares with
+  /// more SIMD values than Configuration::GetSimdChunkSize() are split into chunks, which are
+  /// evaluated by separate circuits and stitched back into a single output share.
   /// \returns a share over the output wires of the constructed circuit.
   ShareWrapper Evaluate(const AlgorithmDescription& algo) const;
 
+  /// \brief constructs a circuit from the Boolean AlgorithmDescription algo with this->share_ as
+  /// input like Evaluate(const AlgorithmDescription&), but evaluates every layer of AND gates in
+  /// Boolean GMW or BMR as chosen by AssignProtocols() for cost_model and inserts the conversions
+  /// between them.
+  /// \returns a share over the output wires in the protocol of this->share_.
+  /// \throws invalid_argument if this->share_ is neither a Boolean GMW nor a BMR share.
+  ShareWrapper Evaluate(const AlgorithmDescription& algo,
+                        const ProtocolCostModel& cost_model) const;
+
+  /// \brief instantiates circuit_template with this->share_ as input. The template is neither
+  /// optimized nor converted again, and a Boolean GMW instance is a single CircuitGate sharing the
+  /// FlatCircuit of the template. Large shares are split into chunks as by
+  /// Evaluate(const AlgorithmDescription&).
+  /// \returns a share over the output wires of the instance.
+  ShareWrapper Evaluate(const CircuitTemplate& circuit_template) const;
+
+  /// \brief instantiates circuit_template once for each share in inputs. Boolean GMW inputs are
+  /// evaluated as SIMD values of a single instance, such that the number of gates and
+  /// preprocessing requests does not grow with the number of instances.
+  /// \returns the output share of each instance with the SIMD values of its input.
+  static std::vector<ShareWrapper> Evaluate(const CircuitTemplate& circuit_template,
+                                            std::span<const ShareWrapper> inputs);
+
+  /// \brief evaluates the AlgorithmDescription algorithm once on all inputs, which are packed into
+  /// the SIMD values of a single share by Simdify(), e.g., a batch of AES encryptions is a single
+  /// instance of the circuit instead of one per input. The inputs may have several SIMD values
+  /// each.
+  /// \returns the outputs, which are only split into the instances when they are requested.
+  /// \throws invalid_argument if inputs is empty or if the inputs cannot be simdified.
+  static SimdBatch EvaluateBatch(const AlgorithmDescription& algorithm,
+                                 std::span<const ShareWrapper> inputs);
+
   /// \brief constructs a SubsetGate that returns values stored at positions in this->share_.
   /// Internally calls ShareWrapper Subset(std::span<std::size_t> positions).
   ShareWrapper Subset(std::vector<std::size_t>&& positions);
@@ -161,6 +276,7 @@ class ShareWrapper {
   /// order. Repetitions of the positions as well as the number of output SIMD values being greater
   /// the the number of the input SIMD values is allowed, e.g., subset of {0,0} of a share with only
   /// 1 SIMD value would yield an output share that stores the same value as SIMD twice.
+  /// If positions is the identity, this share is returned without a gate.
   /// \throws out_of_range if at least one of the indices in positions is out of range.
   ShareWrapper Subset(std::span<const std::size_t> positions);
 
@@ -170,11 +286,21 @@ class ShareWrapper {
   /// std::vector {s_0, s_1, s_2} as separate shares with exactly one SIMD value in each share.
   /// \throws invalid_argument if any of the shares internally has an inconsistent number of SIMD
   /// values across the wires.
+  /// A share with exactly one SIMD value is returned as it is without a gate.
   /// \throws invalid_argument if this->share_ is "empty", i.e., contains 0 SIMD values.
   std::vector<ShareWrapper> Unsimdify();
 
+  /// \brief constructs a TransposeGate that swaps the wires and SIMD values of this->share_, i.e.,
+  /// l wires with s SIMD values each become s wires with l SIMD values each, where SIMD value i of
+  /// output wire j is SIMD value j of wire i of this->share_. This converts, e.g., s l-bit values
+  /// into l values of s bits in a single local gate.
+  /// \throws invalid_argument if this->share_ is neither a Boolean GMW, Boolean constant nor a
+  /// garbled circuit share.
+  ShareWrapper TransposeWiresSimd() const;
+
   /// \brief constructs a SimdifyGate that composes the shares in input into a "larger" share with
-  /// all the input shares as SIMD values in one share.
+  /// all the input shares as SIMD values in one share. A single input share is returned as it is
+  /// without a gate.
   /// \throws invalid_argument the shares in input are "empty", i.e., contain 0 SIMD values.
   /// \throws invalid_argument if any of the shares have inconsistent number of wires.
   /// \throws invalid_argument if any of the shares internally has an inconsistent number of SIMD
@@ -189,6 +315,10 @@ class ShareWrapper {
   /// Simdify(std::span<SharePointer> input) on the result.
   static ShareWrapper Simdify(std::vector<ShareWrapper>&& input);
 
+  /// \brief constructs a SimdifyGate on the viewed wires without creating a share per view, see
+  /// Simdify(std::span<SharePointer> input).
+  static ShareWrapper Simdify(std::span<const ShareView> input);
+
   /// \brief converts the information on the wires to T.
   /// Boolean and arithmetic GMW returns the secret-shared values on the wires.
   /// BMR returns "public values", which is also the place where the plaintext results from the
@@ -200,9 +330,32 @@ class ShareWrapper {
   template <typename T>
   T As() const;
 
+  /// \brief Writes the values of As<std::vector<T>>() of an arithmetic share into a caller-provided
+  /// buffer of the same size, e.g., of an output column, without allocating a std::vector. Signed
+  /// integers are written in two's complement. Throws std::invalid_argument if the share holds a
+  /// different number of values.
+  template <typename T>
+  void WriteTo(std::span<T> output) const;
+
+  /// \brief blocks until all wires of the share were evaluated, e.g., to consume the outputs of
+  /// one part of a circuit while Party::RunAsync() still evaluates the rest.
+  void WaitOnline() const;
+
  private:
   SharePointer share_;
 
+  // evaluates the algorithm as it is, where gate i is evaluated in gate_protocols[i] if given
+  ShareWrapper EvaluateUnoptimized(const AlgorithmDescription& algorithm,
+                                   std::span<const MpcProtocol> gate_protocols = {}) const;
+
+  // optimizes the algorithm if Configuration::SetOptimizeAlgorithms() is set
+  AlgorithmDescription OptimizeIfConfigured(const AlgorithmDescription& algorithm) const;
+
+  // applies evaluate to SubsetGates of Configuration::GetSimdChunkSize() SIMD values each and
+  // simdifies the outputs, or to this share if it is not larger than a chunk
+  ShareWrapper EvaluateInChunks(
+      const std::function<ShareWrapper(const ShareWrapper&)>& evaluate) const;
+
   template <typename T>
   ShareWrapper Add(SharePointer share, SharePointer other) const;
 
@@ -216,25 +369,112 @@ class ShareWrapper {
   ShareWrapper HybridMul(SharePointer share, SharePointer other) const;
 
   template <typename T>
-  ShareWrapper GreaterThan(SharePointer share, SharePointer other) const;
+  std::vector<ShareWrapper> BitInjection(std::span<const ShareWrapper> values) const;
+
+  ShareWrapper Compare(const ShareWrapper& other, ComparisonType comparison_type) const;
+
+  template <typename T>
+  ShareWrapper Compare(SharePointer share, SharePointer other,
+                       ComparisonType comparison_type) const;
 
   template <typename T>
   ShareWrapper Square(SharePointer share) const;
+
+  template <typename T>
+  ShareWrapper Truncate(SharePointer share, std::size_t number_of_fractional_bits) const;
+
+  template <typename T>
+  ShareWrapper AstraBitDecomposition(bool only_msb) const;
   
   template <typename T>
   ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b) const;
 
+  template <typename T>
+  ShareWrapper MatrixMultiplication(const ShareWrapper& other, std::size_t rows, std::size_t inner,
+                                    std::size_t columns) const;
+
+  static ShareWrapper MultiInputAnd(std::span<const ShareWrapper> inputs);
+
+  static ShareWrapper BooleanGmwInnerProduct(std::span<ShareWrapper> a,
+                                             std::span<ShareWrapper> b);
+
+  template <typename T>
+  static ShareWrapper MultiInputMul(std::span<const ShareWrapper> inputs);
+
   ShareWrapper ArithmeticGmwToBmr() const;
 
+  template <typename T>
+  ShareWrapper ArithmeticGmwToBooleanGmw() const;
+
   ShareWrapper BooleanGmwToArithmeticGmw() const;
 
   ShareWrapper BooleanGmwToBmr() const;
 
   ShareWrapper BmrToBooleanGmw() const;
 
+  ShareWrapper BooleanGmwToGarbledCircuit() const;
+
+  ShareWrapper GarbledCircuitToBooleanGmw() const;
+
   void ShareConsistencyCheck() const;
 };
 
+// The outputs of several instances of a circuit that were evaluated as the SIMD values of a single
+// share by ShareWrapper::EvaluateBatch(). The output of an instance is split off by a SubsetGate
+// only when it is requested, and GetShare() returns the outputs of all instances as one share,
+// e.g., as input of another batched evaluation.
+class SimdBatch {
+ public:
+  // the SIMD values of instance i are [simd_begins[i], simd_begins[i + 1]) of share
+  SimdBatch(const ShareWrapper& share, std::vector<std::size_t>&& simd_begins);
+
+  std::size_t GetNumberOfInstances() const { return instances_.size(); }
+
+  const ShareWrapper& GetShare() const { return share_; }
+
+  // returns the output of instance i with the SIMD values of its input
+  // \throws out_of_range if i >= GetNumberOfInstances()
+  const ShareWrapper& GetInstance(std::size_t i);
+
+  // returns the outputs of all instances, which are split by a single UnsimdifyGate if every
+  // instance has one SIMD value and none was requested before
+  std::vector<ShareWrapper> Unsimdify();
+
+ private:
+  ShareWrapper share_;
+  std::vector<std::size_t> simd_begins_;
+  // the instances that were requested so far, the others hold no share
+  std::vector<ShareWrapper> instances_;
+};
+
+// Vector region of a loop whose iterations perform the same operations on different shares, e.g.,
+// one comparison per row. Operand k of all iterations, iterations[i][k], is packed into one share
+// by Simdify, body records the operations of an iteration once on the packed operands, and its
+// outputs are split into the iterations again, i.e., the i-th result holds the outputs of
+// iteration i with its SIMD values. body must not depend on the values of a single iteration and
+// its constants need the number of SIMD values of the packed operands, e.g., as a further operand.
+// \throws invalid_argument if iterations is empty, the iterations have different numbers of
+// operands, the operands of an iteration have different numbers of SIMD values, or an output of
+// body does not have the SIMD values of the packed operands.
+std::vector<std::vector<ShareWrapper>> Vectorize(
+    std::span<const std::vector<ShareWrapper>> iterations,
+    const std::function<std::vector<ShareWrapper>(std::span<const ShareWrapper>)>& body);
+
+// sum_i a_i * b_i of Astra shares or, for Boolean GMW shares, XOR_i (a_i & b_i) in a single gate
 ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b);
 
+// Product of the rows x inner matrix a and the inner x columns matrix b, whose elements are the
+// SIMD values of the arithmetic GMW or Astra shares in row-major order
+ShareWrapper MatrixMultiplication(const ShareWrapper& a, const ShareWrapper& b, std::size_t rows,
+                                  std::size_t inner, std::size_t columns);
+
+// AND of all inputs, which have the same numbers of wires and SIMD values. Boolean GMW evaluates it
+// with multi-input AND gates of up to kMaxMultiplicationFanIn inputs, i.e., in a single round for
+// up to kMaxMultiplicationFanIn inputs, other protocols with a tree of two-input AND gates.
+ShareWrapper And(std::span<const ShareWrapper> inputs);
+
+// Product of all inputs, which is evaluated with multi-input multiplication gates of up to
+// kMaxMultiplicationFanIn inputs in arithmetic GMW and with a tree of multiplications otherwise
+ShareWrapper Product(std::span<const ShareWrapper> inputs);
+
 }  // namespace encrypto::motion
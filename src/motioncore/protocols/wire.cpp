@@ -29,7 +29,6 @@
 
 #include "base/backend.h"
 #include "base/register.h"
-#include "utility/fiber_condition.h"
 
 namespace encrypto::motion {
 
@@ -37,8 +36,7 @@ std::size_t Wire::GetNumberOfSimdValues() const { return number_of_simd_; }
 
 Wire::Wire(Backend& backend, std::size_t number_of_simd)
     : backend_(backend),
-      number_of_simd_(number_of_simd),
-      is_done_condition_([this]() { return IsReady().load(); }) {
+      number_of_simd_(number_of_simd) {
   InitializationHelper();
 }
 
@@ -46,18 +44,31 @@ Wire::~Wire() { assert(wire_id_ >= 0); }
 
 void Wire::SetOnlineFinished() {
   assert(wire_id_ >= 0);
+  if (!is_done_.Set()) {
+    throw(std::runtime_error(
+        fmt::format("Marking wire #{} as \"online phase ready\" twice", wire_id_)));
+  }
+  // gates registered before the flag was set are collected here, later ones see the flag
+  std::vector<Gate*> waiting_gates;
   {
-    std::scoped_lock lock(is_done_condition_.GetMutex());
-    if (is_done_) {
-      throw(std::runtime_error(
-          fmt::format("Marking wire #{} as \"online phase ready\" twice", wire_id_)));
-    }
-    is_done_ = true;
+    std::scoped_lock lock(mutex_);
+    waiting_gates.swap(waiting_gates_);
+  }
+  for (auto gate : waiting_gates) {
+    gate->IfReadyAddToProcessingQueue();
+  }
+}
+
+bool Wire::RegisterWaitingGate(Gate& gate) {
+  std::scoped_lock lock(mutex_);
+  if (is_done_.IsSet()) {
+    return false;
   }
-  is_done_condition_.NotifyAll();
+  waiting_gates_.push_back(&gate);
+  return true;
 }
 
-const std::atomic<bool>& Wire::IsReady() const noexcept { return is_done_; }
+const std::atomic<bool>& Wire::IsReady() const noexcept { return is_done_.IsSet(); }
 
 std::string Wire::PrintIds(const std::vector<std::shared_ptr<Wire>>& wires) {
   std::string result;
@@ -68,6 +79,8 @@ std::string Wire::PrintIds(const std::vector<std::shared_ptr<Wire>>& wires) {
   return result;
 }
 
-void Wire::InitializationHelper() { wire_id_ = backend_.GetRegister()->NextWireId(); }
+void Wire::InitializationHelper() {
+  wire_id_ = static_cast<std::int32_t>(backend_.GetRegister()->NextWireId());
+}
 
 }  // namespace encrypto::motion
@@ -25,18 +25,18 @@
 #pragma once
 
 #include <atomic>
+#include <cassert>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
-#include "utility/fiber_condition.h"
+#include "utility/fiber_signal.h"
 #include "utility/typedefs.h"
 
 namespace encrypto::motion {
 
-class FiberCondition;
 class Backend;
 
 class Gate;  // forward declaration
@@ -56,7 +56,12 @@ class Wire {
 
   const std::atomic<bool>& IsReady() const noexcept;
 
-  const FiberCondition& GetIsReadyCondition() const noexcept { return is_done_condition_; }
+  const FiberSignal& GetIsReadyCondition() const noexcept { return is_done_; }
+
+  /// \brief Registers a gate that is notified via Gate::IfReadyAddToProcessingQueue as soon as
+  ///        this wire becomes online-ready.
+  /// \returns false if the wire is already online-ready and the gate was not registered.
+  bool RegisterWaitingGate(Gate& gate);
 
   std::size_t GetWireId() const { return static_cast<std::size_t>(wire_id_); }
 
@@ -67,12 +72,30 @@ class Wire {
   virtual std::size_t GetBitLength() const = 0;
 
   void Clear() {
-    is_done_ = false;
+    is_done_.Reset();
+    waiting_gates_.clear();
     DynamicClear();
   }
 
   virtual bool IsConstant() const noexcept = 0;
 
+  /// \brief Frees the memory of the values stored on this wire, e.g., after all gates consuming
+  ///        them have finished their online phase.
+  /// \returns the number of bytes that were released.
+  virtual std::size_t ReleaseValues() { return 0; }
+
+  /// \brief Sets the number of gates whose online phase reads the values of this wire.
+  void SetNumberOfConsumers(std::size_t number_of_consumers) {
+    number_of_unfinished_consumers_ = number_of_consumers;
+  }
+
+  /// \brief Marks one consumer as finished.
+  /// \returns true if it was the last unfinished consumer.
+  bool ConsumerFinished() {
+    assert(number_of_unfinished_consumers_ > 0);
+    return --number_of_unfinished_consumers_ == 0;
+  }
+
   Wire(const Wire&) = delete;
 
  protected:
@@ -83,11 +106,14 @@ class Wire {
 
   // is ready flag is needed for callbacks, i.e.,
   // gates will wait for wires to be evaluated to proceed with their evaluation
-  std::atomic<bool> is_done_ = false;
+  FiberSignal is_done_;
+
+  // gates that are notified when this wire becomes online-ready; protected by mutex_
+  std::vector<Gate*> waiting_gates_;
 
-  FiberCondition is_done_condition_;
+  std::atomic<std::size_t> number_of_unfinished_consumers_ = 0;
 
-  std::int64_t wire_id_ = -1;
+  std::int32_t wire_id_ = -1;
 
   Wire(Backend& backend, std::size_t number_of_simd);
 
@@ -0,0 +1,173 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "secure_array.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+#include "algorithm/array_circuits.h"
+#include "algorithm/circuit_template.h"
+#include "base/backend.h"
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "protocols/boolean_gmw/boolean_gmw_gate.h"
+#include "protocols/share.h"
+
+namespace encrypto::motion {
+
+// the circuits of an array access only depend on the dimensions of the array
+static const CircuitTemplate& GetArrayCircuit(bool write, std::size_t number_of_elements,
+                                              std::size_t element_bit_length,
+                                              std::size_t index_bit_length) {
+  static std::mutex mutex;
+  static std::map<std::tuple<bool, std::size_t, std::size_t, std::size_t>,
+                  std::unique_ptr<const CircuitTemplate>>
+      cache;
+  std::scoped_lock lock(mutex);
+  auto& circuit{cache[{write, number_of_elements, element_bit_length, index_bit_length}]};
+  if (!circuit) {
+    circuit = std::make_unique<const CircuitTemplate>(
+        write ? algorithm::ArrayWriteCircuit(number_of_elements, element_bit_length,
+                                             index_bit_length)
+              : algorithm::ArrayReadCircuit(number_of_elements, element_bit_length,
+                                            index_bit_length));
+  }
+  return *circuit;
+}
+
+SecureArray::SecureArray(std::span<const ShareWrapper> elements)
+    : number_of_elements_(elements.size()) {
+  if (elements.empty()) throw std::invalid_argument("SecureArray expects at least one element");
+  const auto& first{elements.front()};
+  if (first->GetCircuitType() != CircuitType::kBoolean || first->GetBitLength() == 0) {
+    throw std::invalid_argument(
+        fmt::format("SecureArray expects Boolean shares, got {} wires in {}",
+                    first->GetBitLength(), to_string(first->GetProtocol())));
+  }
+  for (const auto& element : elements) {
+    if (element->GetProtocol() != first->GetProtocol() ||
+        element->GetBitLength() != first->GetBitLength() ||
+        element->GetNumberOfSimdValues() != first->GetNumberOfSimdValues()) {
+      throw std::invalid_argument(fmt::format(
+          "SecureArray expects elements of {} wires with {} SIMD values in {}, got {} wires with "
+          "{} SIMD values in {}",
+          first->GetBitLength(), first->GetNumberOfSimdValues(), to_string(first->GetProtocol()),
+          element->GetBitLength(), element->GetNumberOfSimdValues(),
+          to_string(element->GetProtocol())));
+    }
+  }
+  element_bit_length_ = first->GetBitLength();
+  index_bit_length_ = std::max<std::size_t>(std::bit_width(number_of_elements_ - 1), 1);
+  elements_ = ShareWrapper::Concatenate(elements);
+}
+
+ShareWrapper SecureArray::GetIndexBits(const ShareWrapper& index) const {
+  if (index->GetProtocol() != elements_->GetProtocol() ||
+      index->GetBitLength() < index_bit_length_ ||
+      index->GetNumberOfSimdValues() != elements_->GetNumberOfSimdValues()) {
+    throw std::invalid_argument(fmt::format(
+        "SecureArray of {} elements expects an index of at least {} wires with {} SIMD values in "
+        "{}, got {} wires with {} SIMD values in {}",
+        number_of_elements_, index_bit_length_, elements_->GetNumberOfSimdValues(),
+        to_string(elements_->GetProtocol()), index->GetBitLength(),
+        index->GetNumberOfSimdValues(), to_string(index->GetProtocol())));
+  }
+  if (index->GetBitLength() == index_bit_length_) return index;
+  const auto bits{index.Split()};
+  return ShareWrapper::Concatenate(bits.begin(), bits.begin() + index_bit_length_);
+}
+
+void SecureArray::CheckValue(const ShareWrapper& value) const {
+  if (value->GetProtocol() != elements_->GetProtocol() ||
+      value->GetBitLength() != element_bit_length_ ||
+      value->GetNumberOfSimdValues() != elements_->GetNumberOfSimdValues()) {
+    throw std::invalid_argument(fmt::format(
+        "SecureArray expects a value of {} wires with {} SIMD values in {}, got {} wires with {} "
+        "SIMD values in {}",
+        element_bit_length_, elements_->GetNumberOfSimdValues(),
+        to_string(elements_->GetProtocol()), value->GetBitLength(),
+        value->GetNumberOfSimdValues(), to_string(value->GetProtocol())));
+  }
+}
+
+ShareWrapper SecureArray::Read(const ShareWrapper& index) const {
+  const auto index_bits{GetIndexBits(index)};
+  // the 2^w entries of the padded array are shared for small w
+  if (elements_->GetProtocol() == MpcProtocol::kBooleanGmw && index_bit_length_ <= 16 &&
+      elements_->GetBackend().GetCommunicationLayer().GetNumberOfParties() == 2) {
+    auto read_gate{elements_->GetRegister()->EmplaceGate<proto::boolean_gmw::ObliviousReadGate>(
+        index_bits.Get(), elements_.Get(), number_of_elements_)};
+    return ShareWrapper(read_gate->GetOutputAsShare());
+  }
+  const auto& circuit{
+      GetArrayCircuit(false, number_of_elements_, element_bit_length_, index_bit_length_)};
+  return ShareWrapper::Concatenate(std::vector{index_bits, elements_}).Evaluate(circuit);
+}
+
+ShareWrapper SecureArray::Read(std::size_t index) const {
+  if (index >= number_of_elements_) {
+    throw std::out_of_range(fmt::format("SecureArray: index {} of an array of {} elements", index,
+                                        number_of_elements_));
+  }
+  const auto wires{elements_.Split()};
+  const auto begin{wires.begin() + index * element_bit_length_};
+  return ShareWrapper::Concatenate(begin, begin + element_bit_length_);
+}
+
+void SecureArray::Write(const ShareWrapper& index, const ShareWrapper& value) {
+  const auto index_bits{GetIndexBits(index)};
+  CheckValue(value);
+  const auto& circuit{
+      GetArrayCircuit(true, number_of_elements_, element_bit_length_, index_bit_length_)};
+  elements_ =
+      ShareWrapper::Concatenate(std::vector{index_bits, value, elements_}).Evaluate(circuit);
+}
+
+void SecureArray::Write(std::size_t index, const ShareWrapper& value) {
+  if (index >= number_of_elements_) {
+    throw std::out_of_range(fmt::format("SecureArray: index {} of an array of {} elements", index,
+                                        number_of_elements_));
+  }
+  CheckValue(value);
+  auto wires{elements_.Split()};
+  const auto value_wires{value.Split()};
+  std::copy(value_wires.begin(), value_wires.end(), wires.begin() + index * element_bit_length_);
+  elements_ = ShareWrapper::Concatenate(wires);
+}
+
+std::vector<ShareWrapper> SecureArray::GetElements() const {
+  std::vector<ShareWrapper> result;
+  result.reserve(number_of_elements_);
+  for (std::size_t j = 0; j < number_of_elements_; ++j) result.emplace_back(Read(j));
+  return result;
+}
+
+}  // namespace encrypto::motion
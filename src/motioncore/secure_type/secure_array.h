@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion {
+
+/// \brief an array of n Boolean shares of l wires each in one protocol, e.g., of
+/// SecureUnsignedIntegers, that can be read and written at secret indices. The SIMD values of the
+/// shares are independent arrays. A secret index is the share of an unsigned integer of which
+/// only the lower w = max(bit_width(n - 1), 1) bits are used, the indices n, ..., 2^w - 1 read 0
+/// and do not change the array.
+///
+/// A secret read of up to 2^16 elements in two-party Boolean GMW is a
+/// proto::boolean_gmw::ObliviousReadGate with 1-out-of-N OTs and without AND gates. Otherwise,
+/// reads and writes are linear scans over all elements, see algorithm::ArrayReadCircuit and
+/// algorithm::ArrayWriteCircuit, i.e., about n * l AND gates.
+/// Oblivious RAM with sublinear accesses would need positions that are revealed during the online
+/// phase and thus gates that are created at runtime, which the circuits of MOTION do not support.
+class SecureArray {
+ public:
+  SecureArray() = default;
+
+  /// \throws invalid_argument if elements is empty or the elements are not Boolean shares of the
+  /// same protocol, number of wires and number of SIMD values.
+  SecureArray(std::span<const ShareWrapper> elements);
+
+  SecureArray(std::vector<ShareWrapper>&& elements)
+      : SecureArray(std::span<const ShareWrapper>(elements)) {}
+
+  std::size_t GetSize() const { return number_of_elements_; }
+
+  std::size_t GetElementBitLength() const { return element_bit_length_; }
+
+  /// \brief returns the element at the secret index.
+  /// \throws invalid_argument if index is not a share of the protocol and number of SIMD values of
+  /// the elements with at least w wires.
+  ShareWrapper Read(const ShareWrapper& index) const;
+
+  /// \brief returns the element at the public index without communication.
+  /// \throws out_of_range if index >= GetSize().
+  ShareWrapper Read(std::size_t index) const;
+
+  /// \brief replaces the element at the secret index by value.
+  /// \throws invalid_argument like Read and if value does not have the wires and SIMD values of the
+  /// elements.
+  void Write(const ShareWrapper& index, const ShareWrapper& value);
+
+  /// \brief replaces the element at the public index by value without communication.
+  /// \throws out_of_range if index >= GetSize() and invalid_argument like Write.
+  void Write(std::size_t index, const ShareWrapper& value);
+
+  /// \brief returns the current elements.
+  std::vector<ShareWrapper> GetElements() const;
+
+ private:
+  // returns the lower index_bit_length_ wires of index
+  ShareWrapper GetIndexBits(const ShareWrapper& index) const;
+
+  void CheckValue(const ShareWrapper& value) const;
+
+  std::size_t number_of_elements_ = 0, element_bit_length_ = 0, index_bit_length_ = 0;
+  // the wires of all elements, element j at j * l, ..., (j + 1) * l - 1
+  ShareWrapper elements_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "secure_fixed_point.h"
+
+#include <fmt/format.h>
+#include <stdexcept>
+#include <typeinfo>
+
+#include "protocols/share.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+static void CheckFractionalBits(std::size_t a, std::size_t b) {
+  if (a != b) {
+    throw std::invalid_argument(
+        fmt::format("Fixed-point numbers with {} and {} fractional bits cannot be combined", a, b));
+  }
+}
+
+SecureFixedPoint SecureFixedPoint::operator+(const SecureFixedPoint& other) const {
+  CheckFractionalBits(number_of_fractional_bits_, other.number_of_fractional_bits_);
+  return SecureFixedPoint(share_ + other.share_, number_of_fractional_bits_);
+}
+
+SecureFixedPoint SecureFixedPoint::operator-(const SecureFixedPoint& other) const {
+  CheckFractionalBits(number_of_fractional_bits_, other.number_of_fractional_bits_);
+  return SecureFixedPoint(share_ - other.share_, number_of_fractional_bits_);
+}
+
+SecureFixedPoint SecureFixedPoint::operator*(const SecureFixedPoint& other) const {
+  CheckFractionalBits(number_of_fractional_bits_, other.number_of_fractional_bits_);
+  return SecureFixedPoint((share_ * other.share_).Truncate(number_of_fractional_bits_),
+                          number_of_fractional_bits_);
+}
+
+SecureFixedPoint SecureFixedPoint::Out(std::size_t output_owner) const {
+  return SecureFixedPoint(share_.Out(output_owner), number_of_fractional_bits_);
+}
+
+template <typename U, typename T>
+static T Decode(const ShareWrapper& share, std::size_t number_of_fractional_bits) {
+  if constexpr (std::is_same_v<T, double>) {
+    return FromFixedPoint<U>(share.As<U>(), number_of_fractional_bits);
+  } else {
+    const auto values{share.As<std::vector<U>>()};
+    T result;
+    result.reserve(values.size());
+    for (const auto& value : values) {
+      result.emplace_back(FromFixedPoint<U>(value, number_of_fractional_bits));
+    }
+    return result;
+  }
+}
+
+template <typename T>
+T SecureFixedPoint::As() const {
+  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::invalid_argument("Unsupported protocol for SecureFixedPoint::As()");
+  }
+  switch (share_->GetBitLength()) {
+    case 8u:
+      return Decode<std::uint8_t, T>(share_, number_of_fractional_bits_);
+    case 16u:
+      return Decode<std::uint16_t, T>(share_, number_of_fractional_bits_);
+    case 32u:
+      return Decode<std::uint32_t, T>(share_, number_of_fractional_bits_);
+    case 64u:
+      return Decode<std::uint64_t, T>(share_, number_of_fractional_bits_);
+    default:
+      throw std::bad_cast();
+  }
+}
+
+template double SecureFixedPoint::As() const;
+template std::vector<double> SecureFixedPoint::As() const;
+
+}  // namespace encrypto::motion
@@ -0,0 +1,97 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion {
+
+/// \brief implements signed fixed-point arithmetic on arithmetic GMW shares of 8, 16, 32, and 64
+/// bits in the two's complement representation of x * 2^f for f fractional bits. Multiplications
+/// stay in the arithmetic domain: the product is truncated in a single round by
+/// ShareWrapper::Truncate, such that the result may be off by one in the last fractional bit. The
+/// absolute value of all intermediate results, including the products before truncation, must be
+/// smaller than 2^(k - 2).
+class SecureFixedPoint {
+ public:
+  SecureFixedPoint() = default;
+  SecureFixedPoint(ShareWrapper share, std::size_t number_of_fractional_bits)
+      : share_(share), number_of_fractional_bits_(number_of_fractional_bits) {}
+  SecureFixedPoint(SharePointer share, std::size_t number_of_fractional_bits)
+      : share_(share), number_of_fractional_bits_(number_of_fractional_bits) {}
+
+  virtual ~SecureFixedPoint() = default;
+
+  SecureFixedPoint& operator=(const SecureFixedPoint& other) = default;
+
+  SecureFixedPoint& operator=(SecureFixedPoint&& other) = default;
+
+  ShareWrapper& Get() { return share_; }
+
+  const ShareWrapper& Get() const { return share_; }
+
+  ShareWrapper& operator->() { return share_; }
+
+  const ShareWrapper& operator->() const { return share_; }
+
+  std::size_t GetNumberOfFractionalBits() const { return number_of_fractional_bits_; }
+
+  SecureFixedPoint operator+(const SecureFixedPoint& other) const;
+
+  SecureFixedPoint& operator+=(const SecureFixedPoint& other) {
+    *this = *this + other;
+    return *this;
+  }
+
+  SecureFixedPoint operator-(const SecureFixedPoint& other) const;
+
+  SecureFixedPoint& operator-=(const SecureFixedPoint& other) {
+    *this = *this - other;
+    return *this;
+  }
+
+  /// \brief multiplies the shares and truncates the 2f fractional bits of the product to f bits.
+  SecureFixedPoint operator*(const SecureFixedPoint& other) const;
+
+  SecureFixedPoint& operator*=(const SecureFixedPoint& other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  /// \brief constructs an output gate, which reconstructs the cleartext result. The default
+  /// parameter for the output owner corresponds to all parties being the output owners.
+  /// Uses ShareWrapper::Out.
+  SecureFixedPoint Out(std::size_t output_owner = std::numeric_limits<std::int64_t>::max()) const;
+
+  /// \brief decodes the output to T = double or T = std::vector<double>.
+  template <typename T>
+  T As() const;
+
+ private:
+  ShareWrapper share_;
+  std::size_t number_of_fractional_bits_{0};
+};
+
+}  // namespace encrypto::motion
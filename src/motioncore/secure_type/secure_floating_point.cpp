@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "secure_floating_point.h"
+
+#include <fmt/format.h>
+#include <bit>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include "algorithm/circuit_template.h"
+#include "algorithm/floating_point_circuits.h"
+#include "protocols/share.h"
+
+namespace encrypto::motion {
+
+// the circuits do not depend on a backend and are generated and optimized once per process
+static const CircuitTemplate& GetFloatingPointCircuit(FloatingPointOperationType type,
+                                                      MpcProtocol protocol) {
+  static std::mutex mutex;
+  static std::map<std::pair<FloatingPointOperationType, algorithm::IntegerCircuitOptimization>,
+                  std::unique_ptr<const CircuitTemplate>>
+      cache;
+  const auto optimization{protocol == MpcProtocol::kBmr || protocol == MpcProtocol::kGarbledCircuit
+                              ? algorithm::IntegerCircuitOptimization::kSize
+                              : algorithm::IntegerCircuitOptimization::kDepth};
+  std::scoped_lock lock(mutex);
+  auto& circuit{cache[{type, optimization}]};
+  if (!circuit) {
+    circuit = std::make_unique<const CircuitTemplate>(
+        algorithm::FloatingPointCircuit(type, optimization), true);
+  }
+  return *circuit;
+}
+
+SecureFloatingPoint::SecureFloatingPoint(ShareWrapper share) : share_(std::move(share)) {
+  if (share_->GetCircuitType() != CircuitType::kBoolean || share_->GetBitLength() != 32) {
+    throw std::invalid_argument(
+        fmt::format("SecureFloatingPoint expects a Boolean share of 32 wires, got {} wires in {}",
+                    share_->GetBitLength(), to_string(share_->GetProtocol())));
+  }
+}
+
+ShareWrapper SecureFloatingPoint::Evaluate(FloatingPointOperationType type,
+                                           const SecureFloatingPoint* other) const {
+  const auto& circuit{GetFloatingPointCircuit(type, share_->GetProtocol())};
+  if (other == nullptr) return share_.Evaluate(circuit);
+  return ShareWrapper::Concatenate(std::vector{share_, other->share_}).Evaluate(circuit);
+}
+
+SecureFloatingPoint SecureFloatingPoint::operator+(const SecureFloatingPoint& other) const {
+  return Evaluate(FloatingPointOperationType::kAdd, &other);
+}
+
+SecureFloatingPoint SecureFloatingPoint::operator-(const SecureFloatingPoint& other) const {
+  return Evaluate(FloatingPointOperationType::kSub, &other);
+}
+
+SecureFloatingPoint SecureFloatingPoint::operator*(const SecureFloatingPoint& other) const {
+  return Evaluate(FloatingPointOperationType::kMul, &other);
+}
+
+SecureFloatingPoint SecureFloatingPoint::operator/(const SecureFloatingPoint& other) const {
+  return Evaluate(FloatingPointOperationType::kDiv, &other);
+}
+
+SecureFloatingPoint SecureFloatingPoint::Sqrt() const {
+  return Evaluate(FloatingPointOperationType::kSqrt);
+}
+
+ShareWrapper SecureFloatingPoint::operator<(const SecureFloatingPoint& other) const {
+  return Evaluate(FloatingPointOperationType::kLt, &other);
+}
+
+ShareWrapper SecureFloatingPoint::operator<=(const SecureFloatingPoint& other) const {
+  return Evaluate(FloatingPointOperationType::kLe, &other);
+}
+
+ShareWrapper SecureFloatingPoint::operator==(const SecureFloatingPoint& other) const {
+  return Evaluate(FloatingPointOperationType::kEq, &other);
+}
+
+SecureFloatingPoint SecureFloatingPoint::Out(std::size_t output_owner) const {
+  return SecureFloatingPoint(share_.Out(output_owner));
+}
+
+template <typename T>
+T SecureFloatingPoint::As() const {
+  const auto output{share_.As<std::vector<BitVector<>>>()};
+  if constexpr (std::is_same_v<T, float>) {
+    return std::bit_cast<float>(ToOutput<std::uint32_t>(output));
+  } else {
+    const auto values{ToVectorOutput<std::uint32_t>(output)};
+    T result;
+    result.reserve(values.size());
+    for (const auto value : values) result.emplace_back(std::bit_cast<float>(value));
+    return result;
+  }
+}
+
+template float SecureFloatingPoint::As() const;
+template std::vector<float> SecureFloatingPoint::As() const;
+
+}  // namespace encrypto::motion
@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion {
+
+/// \brief implements IEEE-754 single-precision arithmetic on Boolean shares of 32 wires, i.e.,
+/// in Boolean GMW, BMR and garbled circuits, whose SIMD values are independent numbers. Every
+/// operation is a single instance of a circuit from algorithm::FloatingPointCircuit for all SIMD
+/// values, which is size-optimized for BMR and garbled circuits and depth-optimized otherwise.
+/// Results are rounded to nearest even, and subnormal numbers are flushed to zero.
+class SecureFloatingPoint {
+ public:
+  SecureFloatingPoint() = default;
+
+  /// \throws invalid_argument if share is not a Boolean share of 32 wires.
+  SecureFloatingPoint(ShareWrapper share);
+
+  SecureFloatingPoint(SharePointer share) : SecureFloatingPoint(ShareWrapper(std::move(share))) {}
+
+  SecureFloatingPoint(const SecureFloatingPoint& other) = default;
+
+  SecureFloatingPoint(SecureFloatingPoint&& other) = default;
+
+  virtual ~SecureFloatingPoint() = default;
+
+  SecureFloatingPoint& operator=(const SecureFloatingPoint& other) = default;
+
+  SecureFloatingPoint& operator=(SecureFloatingPoint&& other) = default;
+
+  ShareWrapper& Get() { return share_; }
+
+  const ShareWrapper& Get() const { return share_; }
+
+  ShareWrapper& operator->() { return share_; }
+
+  const ShareWrapper& operator->() const { return share_; }
+
+  SecureFloatingPoint operator+(const SecureFloatingPoint& other) const;
+
+  SecureFloatingPoint& operator+=(const SecureFloatingPoint& other) {
+    *this = *this + other;
+    return *this;
+  }
+
+  SecureFloatingPoint operator-(const SecureFloatingPoint& other) const;
+
+  SecureFloatingPoint& operator-=(const SecureFloatingPoint& other) {
+    *this = *this - other;
+    return *this;
+  }
+
+  SecureFloatingPoint operator*(const SecureFloatingPoint& other) const;
+
+  SecureFloatingPoint& operator*=(const SecureFloatingPoint& other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  SecureFloatingPoint operator/(const SecureFloatingPoint& other) const;
+
+  SecureFloatingPoint& operator/=(const SecureFloatingPoint& other) {
+    *this = *this / other;
+    return *this;
+  }
+
+  /// \brief the square root, which is NaN for negative numbers except -0.
+  SecureFloatingPoint Sqrt() const;
+
+  /// \brief the comparisons return a share of a single wire, which is 0 if a number is NaN.
+  ShareWrapper operator<(const SecureFloatingPoint& other) const;
+
+  ShareWrapper operator>(const SecureFloatingPoint& other) const { return other < *this; }
+
+  ShareWrapper operator<=(const SecureFloatingPoint& other) const;
+
+  ShareWrapper operator>=(const SecureFloatingPoint& other) const { return other <= *this; }
+
+  ShareWrapper operator==(const SecureFloatingPoint& other) const;
+
+  /// \brief constructs an output gate, which reconstructs the cleartext result. The default
+  /// parameter for the output owner corresponds to all parties being the output owners.
+  /// Uses ShareWrapper::Out.
+  SecureFloatingPoint Out(
+      std::size_t output_owner = std::numeric_limits<std::int64_t>::max()) const;
+
+  /// \brief decodes the output to T = float or T = std::vector<float>.
+  template <typename T>
+  T As() const;
+
+ private:
+  ShareWrapper share_;
+
+  // evaluates the circuit of type on the concatenation of this and other, or only on this for
+  // kSqrt
+  ShareWrapper Evaluate(FloatingPointOperationType type,
+                        const SecureFloatingPoint* other = nullptr) const;
+};
+
+}  // namespace encrypto::motion
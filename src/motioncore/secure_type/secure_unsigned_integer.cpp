@@ -25,9 +25,11 @@
 #include "secure_unsigned_integer.h"
 
 #include <fmt/format.h>
+#include <cmath>
 #include <iterator>
 
 #include "algorithm/algorithm_description.h"
+#include "algorithm/integer_circuits.h"
 #include "base/backend.h"
 #include "base/register.h"
 #include "protocols/data_management/unsimdify_gate.h"
@@ -36,6 +38,85 @@
 
 namespace encrypto::motion {
 
+namespace {
+
+algorithm::IntegerCircuitOptimization GetOptimization(MpcProtocol protocol) {
+  return protocol == MpcProtocol::kBmr || protocol == MpcProtocol::kGarbledCircuit
+             ? algorithm::IntegerCircuitOptimization::kSize
+             : algorithm::IntegerCircuitOptimization::kDepth;
+}
+
+std::string_view to_string(algorithm::IntegerCircuitOptimization optimization) {
+  return optimization == algorithm::IntegerCircuitOptimization::kSize ? "size" : "depth";
+}
+
+// the public value for each SIMD value of share as an arithmetic GMW constant
+template <typename T>
+ShareWrapper Constant(const ShareWrapper& share, T value) {
+  return ShareWrapper(share->GetBackend().ConstantArithmeticGmwInput(
+      std::vector<T>(share->GetNumberOfSimdValues(), value)));
+}
+
+// corrects an estimate q' in [a / b, a / b + 2] of the quotient of a and b with remainder
+// t = a - (q' - 2) * b, i.e., q = q' - 2 + (t >= b) + (t >= 2b)
+template <typename T>
+ShareWrapper CorrectQuotient(const ShareWrapper& estimate, const ShareWrapper& remainder,
+                             const ShareWrapper& divisor, const ShareWrapper& twice_divisor) {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  return estimate + (remainder >= divisor).BitsToArithmeticGmw(kBitLength) +
+         (remainder >= twice_divisor).BitsToArithmeticGmw(kBitLength) +
+         Constant(estimate, static_cast<T>(-2));
+}
+
+// computes a / b for arithmetic GMW shares of a, b < 2^(f - 3) with f = (k - 3) / 2 fractional
+// bits. b is scaled by a power of two s to x in [1/2, 1), whose reciprocal is approximated by
+// the linear w = 2.9142 - 2x and refined by Newton-Raphson iterations w = w * (2 - x * w). Each
+// iteration squares the relative error of at most 0.086, until the truncated estimate a * s * w
+// of the quotient is precise enough for CorrectQuotient.
+template <typename T>
+ShareWrapper NewtonRaphsonDivision(const ShareWrapper& a, const ShareWrapper& b,
+                                   const ShareWrapper& scale) {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  constexpr std::size_t f{(kBitLength - 3) / 2};
+  std::size_t number_of_iterations{1};
+  while ((7u << number_of_iterations) < 2 * f) ++number_of_iterations;
+
+  const auto s{scale.BitsToArithmeticGmw(kBitLength)};
+  const auto x{b * s};
+  auto w{Constant(a, static_cast<T>(std::llround(2.9142 * (T(1) << f)))) +
+         x * Constant(a, static_cast<T>(-2))};
+  for (std::size_t i = 0; i < number_of_iterations; ++i) {
+    const auto y{(x * w).Truncate(f)};
+    const auto z{Constant(a, static_cast<T>(T(1) << (f + 1))) +
+                 y * Constant(a, static_cast<T>(-1))};
+    w = (w * z).Truncate(f);
+  }
+  // rounds the reciprocal up, such that the truncations cannot make the estimate too small
+  const auto reciprocal{((w + Constant(a, T(4))) * s).Truncate(f) + Constant(a, T(1))};
+  const auto estimate{(a * reciprocal).Truncate(f)};
+  const auto twice_b{b + b};
+  const auto remainder{a + twice_b + estimate * b * Constant(a, static_cast<T>(-1))};
+  return CorrectQuotient<T>(estimate, remainder, b, twice_b);
+}
+
+// computes a / d for an arithmetic GMW share of a < 2^f with f = (k - 1) / 2 and public d by the
+// truncated product of a and ceil(2^f / d)
+template <typename T>
+ShareWrapper DivisionByConstant(const ShareWrapper& a, T d) {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  constexpr std::size_t f{(kBitLength - 1) / 2};
+  if (d == 1) return a;
+  if (d >> f != 0) return a * Constant(a, T(0));
+  const T magic_number{static_cast<T>(((T(1) << f) + d - 1) / d)};
+  const auto estimate{(a * Constant(a, magic_number)).Truncate(f)};
+  const auto remainder{a + Constant(a, static_cast<T>(2 * d)) +
+                       estimate * Constant(a, static_cast<T>(-d))};
+  return CorrectQuotient<T>(estimate, remainder, Constant(a, d),
+                            Constant(a, static_cast<T>(2 * d)));
+}
+
+}  // namespace
+
 SecureUnsignedInteger::SecureUnsignedInteger(const SharePointer& other)
     : share_(std::make_unique<ShareWrapper>(other)),
       logger_(share_.get()->Get()->GetRegister()->GetLogger()) {}
@@ -49,30 +130,7 @@ SecureUnsignedInteger SecureUnsignedInteger::operator+(const SecureUnsignedInteg
     // use primitive operation in arithmetic GMW
     return *share_ + *other.share_;
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> addition_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kAdd, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kAdd, bitlength, "_depth");
-
-    if ((addition_algorithm = share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      addition_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(addition_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
+    const auto addition_algorithm{GetIntegerCircuit(IntegerOperationType::kAdd)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(addition_algorithm));
   }
@@ -83,31 +141,7 @@ SecureUnsignedInteger SecureUnsignedInteger::operator-(const SecureUnsignedInteg
     // use primitive operation in arithmetic GMW
     return *share_ - *other.share_;
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> subtraction_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kSub, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kSub, bitlength, "_depth");
-
-    if ((subtraction_algorithm =
-             share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      subtraction_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(subtraction_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
+    const auto subtraction_algorithm{GetIntegerCircuit(IntegerOperationType::kSub)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(subtraction_algorithm));
   }
@@ -118,31 +152,7 @@ SecureUnsignedInteger SecureUnsignedInteger::operator*(const SecureUnsignedInteg
     // use primitive operation in arithmetic GMW
     return *share_ * *other.share_;
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> multiplication_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kMul, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kMul, bitlength, "_depth");
-
-    if ((multiplication_algorithm =
-             share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      multiplication_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(multiplication_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
+    const auto multiplication_algorithm{GetIntegerCircuit(IntegerOperationType::kMul)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(multiplication_algorithm));
   }
@@ -150,38 +160,70 @@ SecureUnsignedInteger SecureUnsignedInteger::operator*(const SecureUnsignedInteg
 
 SecureUnsignedInteger SecureUnsignedInteger::operator/(const SecureUnsignedInteger& other) const {
   if (share_->Get()->GetCircuitType() != CircuitType::kBoolean) {
-    // use primitive operation in arithmetic GMW
-    throw std::runtime_error("Integer division is not implemented for arithmetic GMW");
-  } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> division_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kDiv, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kDiv, bitlength, "_depth");
-
-    if ((division_algorithm = share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
+    const auto bit_length{share_->Get()->GetBitLength()};
+    if (share_->Get()->GetProtocol() != MpcProtocol::kArithmeticGmw ||
+        (bit_length != 32 && bit_length != 64)) {
+      throw std::runtime_error(fmt::format(
+          "Integer division is only implemented for 32 and 64 bit arithmetic GMW shares, got {} "
+          "bit {} shares",
+          bit_length, to_string(share_->Get()->GetProtocol())));
+    }
+    // the scale of the divisor is computed from its bits in Boolean GMW
+    const std::size_t f{(bit_length - 3) / 2};
+    const auto normalization_algorithm{
+        GetCircuit(fmt::format("NORMALIZE{}_{}", f, bit_length), [bit_length, f] {
+          return algorithm::IntegerNormalizationCircuit(
+              bit_length, f, algorithm::IntegerCircuitOptimization::kDepth);
+        })};
+    const auto scale{
+        other.share_->Convert<MpcProtocol::kBooleanGmw>().Evaluate(normalization_algorithm)};
+    if (bit_length == 32) {
+      return NewtonRaphsonDivision<std::uint32_t>(*share_, *other.share_, scale);
     } else {
-      division_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(division_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
+      return NewtonRaphsonDivision<std::uint64_t>(*share_, *other.share_, scale);
     }
+  } else {  // BooleanCircuitType
+    const auto division_algorithm{GetIntegerCircuit(IntegerOperationType::kDiv)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(division_algorithm));
   }
 }
 
+SecureUnsignedInteger SecureUnsignedInteger::operator/(std::uint64_t divisor) const {
+  const auto bit_length{share_->Get()->GetBitLength()};
+  if (divisor == 0 || (bit_length < 64 && divisor >> bit_length != 0)) {
+    throw std::invalid_argument(
+        fmt::format("Invalid divisor {} of a {} bit integer", divisor, bit_length));
+  }
+  if (share_->Get()->GetCircuitType() != CircuitType::kBoolean) {
+    if (share_->Get()->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+      throw std::runtime_error(
+          fmt::format("Integer division by a constant is not implemented for {}",
+                      to_string(share_->Get()->GetProtocol())));
+    }
+    switch (bit_length) {
+      case 8u:
+        return DivisionByConstant(*share_, static_cast<std::uint8_t>(divisor));
+      case 16u:
+        return DivisionByConstant(*share_, static_cast<std::uint16_t>(divisor));
+      case 32u:
+        return DivisionByConstant(*share_, static_cast<std::uint32_t>(divisor));
+      case 64u:
+        return DivisionByConstant(*share_, divisor);
+      default:
+        throw std::bad_cast();
+    }
+  } else {  // BooleanCircuitType
+    const auto optimization{GetOptimization(share_->Get()->GetProtocol())};
+    const auto division_algorithm{GetCircuit(
+        fmt::format("DIV_CONST{}_{}_{}", divisor, bit_length, to_string(optimization)),
+        [divisor, bit_length, optimization] {
+          return algorithm::IntegerDivisionByConstantCircuit(divisor, bit_length, optimization);
+        })};
+    return SecureUnsignedInteger(share_->Evaluate(division_algorithm));
+  }
+}
+
 ShareWrapper SecureUnsignedInteger::operator>(const SecureUnsignedInteger& other) const {
   if (share_->Get()->GetCircuitType() == CircuitType::kArithmetic) {
     if (share_->Get()->GetProtocol() == MpcProtocol::kArithmeticGmw) {
@@ -190,31 +232,7 @@ ShareWrapper SecureUnsignedInteger::operator>(const SecureUnsignedInteger& other
     // use primitive operation in arithmetic GMW
     throw std::runtime_error("Integer comparison is not implemented for arithmetic GMW");
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> is_greater_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kGt, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kGt, bitlength, "_depth");
-
-    if ((is_greater_algorithm =
-             share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      is_greater_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(is_greater_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
+    const auto is_greater_algorithm{GetIntegerCircuit(IntegerOperationType::kGt)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return share_input.Evaluate(is_greater_algorithm).Split().at(0);
   }
@@ -222,7 +240,9 @@ ShareWrapper SecureUnsignedInteger::operator>(const SecureUnsignedInteger& other
 
 ShareWrapper SecureUnsignedInteger::operator==(const SecureUnsignedInteger& other) const {
   if (share_->Get()->GetCircuitType() != CircuitType::kBoolean) {
-    // use primitive operation in arithmetic GMW
+    if (share_->Get()->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+      return *share_ == *other.share_;
+    }
     throw std::runtime_error("Integer comparison is not implemented for arithmetic GMW");
   } else {  // BooleanCircuitType
     if constexpr (kDebug) {
@@ -236,41 +256,60 @@ ShareWrapper SecureUnsignedInteger::operator==(const SecureUnsignedInteger& othe
   }
 }
 
-std::string SecureUnsignedInteger::ConstructPath(const IntegerOperationType type,
-                                                 const std::size_t bitlength,
-                                                 std::string suffix) const {
-  std::string operation_type_string;
-  switch (type) {
-    case IntegerOperationType::kAdd: {
-      operation_type_string = "add";
-      break;
-    }
-    case IntegerOperationType::kDiv: {
-      operation_type_string = "div";
-      break;
-    }
-    case IntegerOperationType::kGt: {
-      operation_type_string = "gt";
-      break;
-    }
-    case IntegerOperationType::kEq: {
-      operation_type_string = "eq";
-      break;
-    }
-    case IntegerOperationType::kMul: {
-      operation_type_string = "mul";
-      break;
-    }
-    case IntegerOperationType::kSub: {
-      operation_type_string = "sub";
-      break;
+ShareWrapper SecureUnsignedInteger::operator<(const SecureUnsignedInteger& other) const {
+  if (share_->Get()->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    return *share_ < *other.share_;
+  }
+  return other > *this;
+}
+
+ShareWrapper SecureUnsignedInteger::operator>=(const SecureUnsignedInteger& other) const {
+  if (share_->Get()->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    return *share_ >= *other.share_;
+  }
+  return ~(other > *this);
+}
+
+ShareWrapper SecureUnsignedInteger::operator<=(const SecureUnsignedInteger& other) const {
+  if (share_->Get()->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    return *share_ <= *other.share_;
+  }
+  return ~(*this > other);
+}
+
+ShareWrapper SecureUnsignedInteger::IsInRange(const SecureUnsignedInteger& lower,
+                                              const SecureUnsignedInteger& upper) const {
+  return (*this >= lower) & (*this <= upper);
+}
+
+std::shared_ptr<AlgorithmDescription> SecureUnsignedInteger::GetIntegerCircuit(
+    IntegerOperationType type) const {
+  const auto optimization{GetOptimization(share_->Get()->GetProtocol())};
+  const auto bitlength{share_->Get()->GetBitLength()};
+  return GetCircuit(fmt::format("{}{}_{}", to_string(type), bitlength, to_string(optimization)),
+                    [type, bitlength, optimization] {
+                      return algorithm::IntegerCircuit(type, bitlength, optimization);
+                    });
+}
+
+std::shared_ptr<AlgorithmDescription> SecureUnsignedInteger::GetCircuit(
+    const std::string& name, const std::function<AlgorithmDescription()>& generate) const {
+  const auto& register_pointer{share_->Get()->GetRegister()};
+  if (auto cached_algorithm{register_pointer->GetCachedAlgorithmDescription(name)}) {
+    if constexpr (kDebug) {
+      logger_->LogDebug(fmt::format("Found in cache Boolean integer circuit {}", name));
     }
-    default:
-      throw std::runtime_error(
-          fmt::format("Invalid integer operation required: {}", to_string(type)));
+    return cached_algorithm;
+  }
+  auto algorithm{std::make_shared<AlgorithmDescription>(generate())};
+  if (!register_pointer->AddCachedAlgorithmDescription(name, algorithm)) {
+    // another thread generated the same circuit first
+    return register_pointer->GetCachedAlgorithmDescription(name);
+  }
+  if constexpr (kDebug) {
+    logger_->LogDebug(fmt::format("Generated Boolean integer circuit {}", name));
   }
-  return fmt::format("{}/circuits/int/int_{}{}{}.bristol", kRootDir, operation_type_string,
-                     bitlength, suffix);
+  return algorithm;
 }
 
 SecureUnsignedInteger SecureUnsignedInteger::Simdify(std::span<SecureUnsignedInteger> input) {
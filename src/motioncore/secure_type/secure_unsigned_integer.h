@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
+
 #include "protocols/share_wrapper.h"
 
 namespace encrypto::motion {
@@ -93,6 +96,12 @@ class SecureUnsignedInteger {
     return *this;
   }
 
+  /// \brief computes *this / other rounded down. Boolean shares evaluate the generated division
+  /// circuit. Arithmetic GMW shares of k = 32 or 64 bits compute the quotient in the arithmetic
+  /// domain by a Newton-Raphson approximation of the reciprocal of other with f = (k - 3) / 2
+  /// fractional bits and probabilistic truncations, followed by two comparisons that correct the
+  /// last bit. This requires two parties, 0 < other < 2^(f - 3) and *this < 2^(f - 3), i.e.,
+  /// 2^11 for 32 bit and 2^27 for 64 bit integers, since the k-bit ring has to hold the products.
   SecureUnsignedInteger operator/(const SecureUnsignedInteger& other) const;
 
   SecureUnsignedInteger& operator/=(const SecureUnsignedInteger& other) {
@@ -100,10 +109,33 @@ class SecureUnsignedInteger {
     return *this;
   }
 
+  /// \brief computes *this / divisor rounded down for a public divisor. Boolean shares evaluate
+  /// a multiplication by the magic number of the divisor, see
+  /// algorithm::IntegerDivisionByConstantCircuit. Arithmetic GMW shares multiply by the rounded up
+  /// 2^f / divisor, truncate f = (k - 1) / 2 bits and correct the result by two comparisons, which
+  /// requires two parties and *this < 2^f.
+  /// \throws std::invalid_argument if divisor is 0 or does not fit into the bit length.
+  SecureUnsignedInteger operator/(std::uint64_t divisor) const;
+
+  SecureUnsignedInteger& operator/=(std::uint64_t divisor) {
+    *this = *this / divisor;
+    return *this;
+  }
+
   ShareWrapper operator>(const SecureUnsignedInteger& other) const;
 
   ShareWrapper operator==(const SecureUnsignedInteger& other) const;
 
+  ShareWrapper operator<(const SecureUnsignedInteger& other) const;
+
+  ShareWrapper operator>=(const SecureUnsignedInteger& other) const;
+
+  ShareWrapper operator<=(const SecureUnsignedInteger& other) const;
+
+  /// \brief checks lower <= *this <= upper
+  ShareWrapper IsInRange(const SecureUnsignedInteger& lower,
+                         const SecureUnsignedInteger& upper) const;
+
   /// \brief internally extracts the ShareWrapper/SharePointer from input and
   /// calls ShareWrapper::Simdify(std::span<SharePointer> input)
   static SecureUnsignedInteger Simdify(std::span<SecureUnsignedInteger> input);
@@ -139,8 +171,15 @@ class SecureUnsignedInteger {
   std::shared_ptr<ShareWrapper> share_{nullptr};
   std::shared_ptr<Logger> logger_{nullptr};
 
-  std::string ConstructPath(const IntegerOperationType type, const std::size_t bitlength,
-                            std::string suffix = "") const;
+  // returns the generated Boolean circuit of type for the bit length of this integer, which is
+  // size-optimized for BMR and garbled circuits and depth-optimized otherwise. The circuit is
+  // generated once per backend and cached in its Register.
+  std::shared_ptr<AlgorithmDescription> GetIntegerCircuit(IntegerOperationType type) const;
+
+  // returns the circuit of the given name from the cache of the Register or caches the circuit
+  // returned by generate
+  std::shared_ptr<AlgorithmDescription> GetCircuit(
+      const std::string& name, const std::function<AlgorithmDescription()>& generate) const;
 };
 
 }  // namespace encrypto::motion
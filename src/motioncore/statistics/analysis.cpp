@@ -22,12 +22,14 @@
 
 #include "analysis.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <sstream>
 
 #include <fmt/format.h>
 
+#include "communication/message.h"
 #include "communication/transport.h"
 #include "utility/runtime_info.h"
 #include "utility/version.h"
@@ -130,6 +132,18 @@ void AccumulatedCommunicationStatistics::Add(const communication::TransportStati
   accumulators_[kIdxNumberOfMessagesReceived](statistics.number_of_messages_received);
   accumulators_[kIdxNumberOfBytesSent](statistics.number_of_bytes_sent);
   accumulators_[kIdxNumberOfBytesReceived](statistics.number_of_bytes_received);
+  accumulators_[kIdxNumberOfSendCalls](statistics.number_of_send_calls);
+  accumulators_[kIdxNumberOfUncompressedBytesSent](statistics.number_of_uncompressed_bytes_sent);
+  accumulators_[kIdxNumberOfCompressedBytesSent](statistics.number_of_compressed_bytes_sent);
+  accumulators_[kIdxNumberOfUncompressedBytesReceived](
+      statistics.number_of_uncompressed_bytes_received);
+  accumulators_[kIdxNumberOfCompressedBytesReceived](
+      statistics.number_of_compressed_bytes_received);
+  accumulators_[kIdxMaxNumberOfQueuedBytes](statistics.max_number_of_queued_bytes);
+  accumulators_[kIdxNumberOfBlockedSends](statistics.number_of_blocked_sends);
+  for (const auto& [message_type, message_type_statistics] : statistics.message_type_statistics) {
+    message_type_statistics_[message_type] += message_type_statistics;
+  }
   ++count_;
 }
 
@@ -140,32 +154,87 @@ void AccumulatedCommunicationStatistics::Add(
   }
 }
 
+double AccumulatedCommunicationStatistics::GetCompressionRatio(std::size_t uncompressed_index,
+                                                              std::size_t compressed_index) const {
+  const auto compressed{boost::accumulators::sum(accumulators_[compressed_index])};
+  if (compressed == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(boost::accumulators::sum(accumulators_[uncompressed_index])) /
+         compressed;
+}
+
 std::string AccumulatedCommunicationStatistics::PrintHumanReadable() const {
   std::stringstream ss;
   constexpr unsigned kMiB = 1024 * 1024;
 
   ss << "Communication with each other party:\n"
-     << fmt::format("Sent: {:0.3f} MiB in {:d} messages\n",
+     << fmt::format("Sent: {:0.3f} MiB in {:d} messages ({:d} write calls)\n",
                     boost::accumulators::mean(accumulators_[kIdxNumberOfBytesSent]) / kMiB,
                     static_cast<std::size_t>(
-                        boost::accumulators::mean(accumulators_[kIdxNumberOfMessagesSent])))
+                        boost::accumulators::mean(accumulators_[kIdxNumberOfMessagesSent])),
+                    static_cast<std::size_t>(
+                        boost::accumulators::mean(accumulators_[kIdxNumberOfSendCalls])))
      << fmt::format("Received: {:0.3f} MiB in {:d} messages\n",
                     boost::accumulators::mean(accumulators_[kIdxNumberOfBytesReceived]) / kMiB,
                     static_cast<std::size_t>(
-                        boost::accumulators::mean(accumulators_[kIdxNumberOfMessagesReceived])));
+                        boost::accumulators::mean(accumulators_[kIdxNumberOfMessagesReceived])))
+     << fmt::format("Compression ratio of compressed messages: {:0.3f} sent, {:0.3f} received\n",
+                    GetCompressionRatio(kIdxNumberOfUncompressedBytesSent,
+                                        kIdxNumberOfCompressedBytesSent),
+                    GetCompressionRatio(kIdxNumberOfUncompressedBytesReceived,
+                                        kIdxNumberOfCompressedBytesReceived))
+     << fmt::format("Send queue: {:0.3f} MiB high-water mark, {:d} blocked sends\n",
+                    boost::accumulators::mean(accumulators_[kIdxMaxNumberOfQueuedBytes]) / kMiB,
+                    static_cast<std::size_t>(
+                        boost::accumulators::mean(accumulators_[kIdxNumberOfBlockedSends])));
   return ss.str();
 }
 
 boost::json::object AccumulatedCommunicationStatistics::ToJson() const {
+  // like the totals, the traffic per message type is given per other party, while the latency
+  // histograms count all messages
+  boost::json::object message_types;
+  for (const auto& [message_type, statistics] : message_type_statistics_) {
+    // omit the empty buckets of the largest latencies
+    const auto& histogram{statistics.send_latency_histogram};
+    const auto last_bucket{std::find_if(histogram.rbegin(), histogram.rend(),
+                                        [](std::size_t count) { return count != 0; })
+                               .base()};
+    boost::json::array send_latency_histogram;
+    std::for_each(histogram.begin(), last_bucket,
+                  [&send_latency_histogram](std::size_t count) {
+                    send_latency_histogram.emplace_back(count);
+                  });
+    boost::json::object message_type_object;
+    message_type_object["bytes_sent"] = statistics.number_of_bytes_sent / count_;
+    message_type_object["num_messages_sent"] = statistics.number_of_messages_sent / count_;
+    message_type_object["bytes_received"] = statistics.number_of_bytes_received / count_;
+    message_type_object["num_messages_received"] = statistics.number_of_messages_received / count_;
+    message_type_object["send_latency_histogram_us"] = std::move(send_latency_histogram);
+    message_types[communication::to_string(
+        static_cast<communication::MessageType>(message_type))] = std::move(message_type_object);
+  }
   return {
       {"bytes_sent",
        static_cast<std::size_t>(boost::accumulators::mean(accumulators_[kIdxNumberOfBytesSent]))},
       {"num_messages_sent", static_cast<std::size_t>(boost::accumulators::mean(
                                 accumulators_[kIdxNumberOfMessagesSent]))},
+      {"num_send_calls", static_cast<std::size_t>(
+                             boost::accumulators::mean(accumulators_[kIdxNumberOfSendCalls]))},
       {"bytes_received", static_cast<std::size_t>(
                              boost::accumulators::mean(accumulators_[kIdxNumberOfBytesReceived]))},
       {"num_messages_received", static_cast<std::size_t>(boost::accumulators::mean(
-                                    accumulators_[kIdxNumberOfMessagesReceived]))}};
+                                    accumulators_[kIdxNumberOfMessagesReceived]))},
+      {"compression_ratio_sent",
+       GetCompressionRatio(kIdxNumberOfUncompressedBytesSent, kIdxNumberOfCompressedBytesSent)},
+      {"compression_ratio_received", GetCompressionRatio(kIdxNumberOfUncompressedBytesReceived,
+                                                         kIdxNumberOfCompressedBytesReceived)},
+      {"max_queued_bytes", static_cast<std::size_t>(boost::accumulators::mean(
+                               accumulators_[kIdxMaxNumberOfQueuedBytes]))},
+      {"num_blocked_sends", static_cast<std::size_t>(boost::accumulators::mean(
+                                accumulators_[kIdxNumberOfBlockedSends]))},
+      {"message_types", std::move(message_types)}};
 }
 
 std::string PrintMotionInfo() {
@@ -30,10 +30,12 @@
 #include <boost/accumulators/statistics/variance.hpp>
 #include <boost/json.hpp>
 #include <list>
+#include <map>
 #include "run_time_statistics.h"
 
 namespace encrypto::motion::communication {
 
+struct MessageTypeStatistics;
 struct TransportStatistics;
 
 }  // namespace encrypto::motion::communication
@@ -72,6 +74,13 @@ class AccumulatedCommunicationStatistics {
   static constexpr std::size_t kIdxNumberOfMessagesReceived = 1;
   static constexpr std::size_t kIdxNumberOfBytesSent = 2;
   static constexpr std::size_t kIdxNumberOfBytesReceived = 3;
+  static constexpr std::size_t kIdxNumberOfSendCalls = 4;
+  static constexpr std::size_t kIdxNumberOfUncompressedBytesSent = 5;
+  static constexpr std::size_t kIdxNumberOfCompressedBytesSent = 6;
+  static constexpr std::size_t kIdxNumberOfUncompressedBytesReceived = 7;
+  static constexpr std::size_t kIdxNumberOfCompressedBytesReceived = 8;
+  static constexpr std::size_t kIdxMaxNumberOfQueuedBytes = 9;
+  static constexpr std::size_t kIdxNumberOfBlockedSends = 10;
 
   void Add(const communication::TransportStatistics& statistics);
 
@@ -82,8 +91,13 @@ class AccumulatedCommunicationStatistics {
   boost::json::object ToJson() const;
 
  private:
+  // ratio of the sizes of the compressed messages before and after compression, 1 if there are none
+  double GetCompressionRatio(std::size_t uncompressed_index, std::size_t compressed_index) const;
+
   std::size_t count_ = 0;
-  std::array<AccumulatorType, 4> accumulators_;
+  std::array<AccumulatorType, 11> accumulators_;
+  // sums over all added statistics indexed by the MessageType value
+  std::map<std::size_t, communication::MessageTypeStatistics> message_type_statistics_;
 };
 
 std::string PrintStatistics(const std::string& experiment_name, const AccumulatedRunTimeStatistics&,
@@ -0,0 +1,262 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "cost_estimate.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <sstream>
+#include <typeinfo>
+#include <unordered_map>
+
+#include <boost/core/demangle.hpp>
+#include <fmt/format.h>
+
+#include "base/register.h"
+#include "gate_profile.h"
+#include "protocols/gate.h"
+#include "protocols/garbled_circuit/garbled_circuit_constants.h"
+#include "protocols/wire.h"
+#include "utility/constants.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+double ToMilliseconds(std::chrono::duration<double> duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// adds the costs of the arithmetic GMW gates of ring T
+template <typename T>
+void AddArithmeticGmwCosts(std::map<std::string, GateCost>& gate_costs) {
+  const auto type{boost::core::demangle(typeid(T).name())};
+  const auto bytes{static_cast<double>(sizeof(T))};
+  for (std::string_view gate : {"InputGate", "OutputGate", "RevealGate"}) {
+    gate_costs[fmt::format("arithmetic_gmw::{}<{}>", gate, type)] = {1, bytes};
+  }
+  for (std::string_view gate : {"AdditionGate", "SubtractionGate"}) {
+    gate_costs[fmt::format("arithmetic_gmw::{}<{}>", gate, type)] = {};
+  }
+  // the masked inputs d and e, respectively only d
+  gate_costs[fmt::format("arithmetic_gmw::MultiplicationGate<{}>", type)] = {1, 2 * bytes};
+  gate_costs[fmt::format("arithmetic_gmw::SquareGate<{}>", type)] = {1, bytes};
+  // one AC-OT correlation and one correction bit
+  gate_costs[fmt::format("arithmetic_gmw::HybridMultiplicationGate<{}>", type)] = {1,
+                                                                                   bytes + 0.125};
+}
+
+std::string GetProtocolName(std::string_view gate_type) {
+  const auto separator{gate_type.find("::")};
+  return std::string(separator == std::string_view::npos ? std::string_view("other")
+                                                         : gate_type.substr(0, separator));
+}
+
+}  // namespace
+
+CostModel CostModel::Default() {
+  namespace gc = proto::garbled_circuit;
+  CostModel model;
+  auto& costs{model.gate_costs};
+  for (std::string_view gate : {"XorGate", "InvGate"}) {
+    costs[fmt::format("boolean_gmw::{}", gate)] = {};
+    costs[fmt::format("bmr::{}", gate)] = {};
+    costs[fmt::format("garbled_circuit::{}Garbler", gate)] = {};
+    costs[fmt::format("garbled_circuit::{}Evaluator", gate)] = {};
+  }
+  for (std::string_view gate : {"InputGate", "OutputGate", "RevealGate"}) {
+    costs[fmt::format("boolean_gmw::{}", gate)] = {1, 0.125};
+  }
+  costs["boolean_gmw::AndGate"] = {1, 0.25};
+  // the public values, then the keys of the active labels
+  costs["bmr::InputGate"] = {2, 0.125 + kKappa / 8};
+  costs["bmr::OutputGate"] = {1, 0.125};
+  // four rows of the garbled table with one key of each of the two parties per row
+  costs["bmr::AndGate"] = {.setup_bytes_per_value = 4 * 2 * kKappa / 8};
+  // the labels, for the inputs of the evaluator after an OT
+  costs["garbled_circuit::InputGateGarbler"] = {1, kKappa / 8};
+  costs["garbled_circuit::InputGateEvaluator"] = {2, kKappa / 8};
+  costs["garbled_circuit::OutputGate"] = {1, 0.125};
+  costs["garbled_circuit::AndGateGarbler"] = {
+      .setup_bytes_per_value = (gc::kGarbledTableBitSize + gc::kGarbledControlBitsBitSize) / 8.0};
+  costs["garbled_circuit::AndGateEvaluator"] = {};
+  AddArithmeticGmwCosts<std::uint8_t>(costs);
+  AddArithmeticGmwCosts<std::uint16_t>(costs);
+  AddArithmeticGmwCosts<std::uint32_t>(costs);
+  AddArithmeticGmwCosts<std::uint64_t>(costs);
+  return model;
+}
+
+void CostModel::Calibrate(const boost::json::object& benchmark_output) {
+  constexpr std::string_view kPrefix{"BM_GateCost/"};
+  for (const auto& benchmark : benchmark_output.at("benchmarks").as_array()) {
+    const auto& object{benchmark.as_object()};
+    const auto aggregate_name{object.if_contains("aggregate_name")};
+    if (aggregate_name != nullptr && aggregate_name->as_string() != "mean") continue;
+    const std::string_view name{object.at("run_name").as_string()};
+    if (!name.starts_with(kPrefix)) continue;
+    auto& cost{gate_costs[std::string(name.substr(kPrefix.size()))]};
+    if (const auto compute{object.if_contains("compute_ns_per_value")}) {
+      cost.compute_time_per_value = std::chrono::duration<double, std::nano>(
+          compute->to_number<double>());
+    }
+    if (const auto bytes{object.if_contains("online_bytes_per_value")}) {
+      cost.online_bytes_per_value = bytes->to_number<double>();
+    }
+  }
+}
+
+CostEstimate EstimateCosts(const Register& register_, const PreprocessingPlan& preprocessing,
+                           std::size_t number_of_ots, std::size_t number_of_parties,
+                           const CostModel& model) {
+  CostEstimate estimate;
+  estimate.preprocessing = preprocessing;
+  estimate.number_of_ots = number_of_ots;
+  const auto number_of_peers{static_cast<double>(number_of_parties - 1)};
+
+  std::set<std::string> unknown_gate_types;
+  // rounds after which each wire is available, gates are registered after their parents
+  std::unordered_map<const Wire*, std::size_t> wire_rounds;
+  for (const auto& gate : register_.GetGates()) {
+    std::size_t rounds{0};
+    for (const auto& wire : gate->GetInputWires()) {
+      if (auto it{wire_rounds.find(wire.get())}; it != wire_rounds.end()) {
+        rounds = std::max(rounds, it->second);
+      }
+    }
+    std::size_t number_of_values{0};
+    for (const auto& wire : gate->GetOutputWires()) {
+      number_of_values += wire->GetNumberOfSimdValues();
+    }
+
+    const auto gate_type{GetGateType(*gate)};
+    auto& protocol_costs{estimate.protocols[GetProtocolName(gate_type)]};
+    ++protocol_costs.number_of_gates;
+    protocol_costs.number_of_values += number_of_values;
+    if (auto it{model.gate_costs.find(gate_type)}; it != model.gate_costs.end()) {
+      const auto& cost{it->second};
+      rounds += cost.online_rounds;
+      const auto number_of_sent_values{static_cast<double>(number_of_values) * number_of_peers};
+      protocol_costs.online_bytes += cost.online_bytes_per_value * number_of_sent_values;
+      protocol_costs.setup_bytes += cost.setup_bytes_per_value * number_of_sent_values;
+      protocol_costs.compute_time += cost.compute_time_per_value * number_of_values;
+    } else {
+      unknown_gate_types.insert(gate_type);
+    }
+    for (const auto& wire : gate->GetOutputWires()) {
+      wire_rounds[wire.get()] = rounds;
+    }
+    estimate.online_rounds = std::max(estimate.online_rounds, rounds);
+  }
+  estimate.unknown_gate_types.assign(unknown_gate_types.begin(), unknown_gate_types.end());
+
+  std::chrono::duration<double> compute_time{0};
+  for (const auto& [protocol, costs] : estimate.protocols) {
+    estimate.online_bytes_per_party += costs.online_bytes;
+    estimate.setup_bytes_per_party += costs.setup_bytes;
+    compute_time += costs.compute_time;
+  }
+
+  // a party is the receiver of half of the directly registered OTs and of about one OT per bit of
+  // an MT, SP, or SB with each peer
+  double number_of_ots_per_peer{static_cast<double>(preprocessing.number_of_binary_mts)};
+  for (std::size_t i = 0; i < preprocessing.number_of_integer_mts.size(); ++i) {
+    const std::size_t bit_length{std::size_t(8) << i};
+    number_of_ots_per_peer += static_cast<double>(
+        bit_length * (preprocessing.number_of_integer_mts[i] + preprocessing.number_of_sps[i]));
+    if (i < preprocessing.number_of_sbs.size()) {
+      number_of_ots_per_peer += static_cast<double>(bit_length * preprocessing.number_of_sbs[i]);
+    }
+  }
+  estimate.preprocessing_bytes_per_party =
+      (number_of_ots / 2.0 + number_of_ots_per_peer * number_of_peers) * model.bytes_per_ot;
+
+  const auto bytes_per_party{estimate.online_bytes_per_party + estimate.setup_bytes_per_party +
+                             estimate.preprocessing_bytes_per_party};
+  const auto number_of_rounds{
+      (bytes_per_party > 0 ? model.preprocessing_rounds : std::size_t(0)) + estimate.online_rounds};
+  const std::chrono::duration<double> transfer_time{bytes_per_party / model.network.bandwidth};
+  estimate.estimated_time =
+      model.network.round_trip_time * static_cast<double>(number_of_rounds) + transfer_time +
+      compute_time;
+  return estimate;
+}
+
+std::string CostEstimate::PrintHumanReadable() const {
+  std::stringstream stream;
+  stream << fmt::format("estimated time {:.3f} ms, {} online rounds\n",
+                        ToMilliseconds(estimated_time), online_rounds);
+  stream << fmt::format("bytes sent per party: online {:.0f}, setup {:.0f}, preprocessing {:.0f}\n",
+                        online_bytes_per_party, setup_bytes_per_party,
+                        preprocessing_bytes_per_party);
+  std::size_t number_of_integer_mts{0}, number_of_sps{0}, number_of_sbs{0};
+  for (auto n : preprocessing.number_of_integer_mts) number_of_integer_mts += n;
+  for (auto n : preprocessing.number_of_sps) number_of_sps += n;
+  for (auto n : preprocessing.number_of_sbs) number_of_sbs += n;
+  stream << fmt::format("{} binary MTs, {} integer MTs, {} SPs, {} SBs, {} OTs\n",
+                        preprocessing.number_of_binary_mts, number_of_integer_mts, number_of_sps,
+                        number_of_sbs, number_of_ots);
+  for (const auto& [protocol, costs] : protocols) {
+    stream << fmt::format(
+        "{}: {} gates, {} values, online {:.0f} bytes, setup {:.0f} bytes, compute {:.3f} ms\n",
+        protocol, costs.number_of_gates, costs.number_of_values, costs.online_bytes,
+        costs.setup_bytes, ToMilliseconds(costs.compute_time));
+  }
+  if (!unknown_gate_types.empty()) {
+    stream << "gate types without costs:";
+    for (const auto& type : unknown_gate_types) stream << ' ' << type;
+    stream << '\n';
+  }
+  return stream.str();
+}
+
+boost::json::object CostEstimate::ToJson() const {
+  boost::json::object protocols_object;
+  for (const auto& [protocol, costs] : protocols) {
+    protocols_object.emplace(
+        protocol, boost::json::object({{"gates", costs.number_of_gates},
+                                       {"values", costs.number_of_values},
+                                       {"online_bytes", costs.online_bytes},
+                                       {"setup_bytes", costs.setup_bytes},
+                                       {"compute_ms", ToMilliseconds(costs.compute_time)}}));
+  }
+  boost::json::array integer_mts, sps, sbs, unknown_types;
+  for (auto n : preprocessing.number_of_integer_mts) integer_mts.push_back(n);
+  for (auto n : preprocessing.number_of_sps) sps.push_back(n);
+  for (auto n : preprocessing.number_of_sbs) sbs.push_back(n);
+  for (const auto& type : unknown_gate_types) unknown_types.emplace_back(type);
+  return boost::json::object({{"online_rounds", online_rounds},
+                              {"online_bytes_per_party", online_bytes_per_party},
+                              {"setup_bytes_per_party", setup_bytes_per_party},
+                              {"preprocessing_bytes_per_party", preprocessing_bytes_per_party},
+                              {"binary_mts", preprocessing.number_of_binary_mts},
+                              {"integer_mts", std::move(integer_mts)},
+                              {"sps", std::move(sps)},
+                              {"sbs", std::move(sbs)},
+                              {"ots", number_of_ots},
+                              {"estimated_time_ms", ToMilliseconds(estimated_time)},
+                              {"unknown_gate_types", std::move(unknown_types)},
+                              {"protocols", std::move(protocols_object)}});
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "algorithm/protocol_assignment.h"
+#include "data_storage/preprocessing_plan.h"
+
+namespace encrypto::motion {
+
+class Register;
+
+// Costs of one gate type per value, i.e., per SIMD value of each output wire. The bytes are those
+// the party that sends the most, e.g., the input owner or the garbler, sends to each other party.
+struct GateCost {
+  // rounds of communication that the online phase adds to each path through the gate
+  std::size_t online_rounds{0};
+  double online_bytes_per_value{0};
+  // e.g., garbled tables
+  double setup_bytes_per_value{0};
+  // of both phases
+  std::chrono::duration<double> compute_time_per_value{0};
+};
+
+// Costs of the gates and the network from which EstimateCosts() extrapolates the costs of a circuit
+struct CostModel {
+  ProtocolCostModel network;
+  // bytes of one OT extension row, which the receiver of an OT sends
+  double bytes_per_ot{16};
+  // rounds of the base OTs and the OT extension
+  std::size_t preprocessing_rounds{3};
+  // by gate type as returned by GetGateType(), e.g., "boolean_gmw::AndGate"
+  std::map<std::string, GateCost> gate_costs;
+
+  // Costs of the common gates of the Boolean and arithmetic GMW, BMR, and garbled circuit
+  // protocols for two parties as derived from their messages, without compute times
+  static CostModel Default();
+
+  // Takes the costs measured by the BM_GateCost benchmarks from the JSON output of Google Benchmark
+  // (--benchmark_out_format=json), i.e., the counter "compute_ns_per_value" and, if present,
+  // "online_bytes_per_value" of the runs named "BM_GateCost/<gate type>". The rounds are kept, and
+  // other benchmarks and aggregates other than the mean are ignored.
+  void Calibrate(const boost::json::object& benchmark_output);
+};
+
+// Costs of a circuit estimated by EstimateCosts() without evaluating it
+struct CostEstimate {
+  struct ProtocolCosts {
+    std::size_t number_of_gates{0};
+    std::size_t number_of_values{0};
+    // that a party sends to all other parties
+    double online_bytes{0}, setup_bytes{0};
+    std::chrono::duration<double> compute_time{0};
+  };
+
+  // Prints the totals followed by the costs of each protocol.
+  std::string PrintHumanReadable() const;
+
+  // {"online_rounds", "online_bytes_per_party", "setup_bytes_per_party",
+  // "preprocessing_bytes_per_party", "binary_mts", "integer_mts", "sps", "sbs", "ots",
+  // "estimated_time_ms", "unknown_gate_types", "protocols": {protocol: {"gates", "values",
+  // "online_bytes", "setup_bytes", "compute_ms"}}}
+  boost::json::object ToJson() const;
+
+  // by the namespace of the gate types, e.g., "boolean_gmw"
+  std::map<std::string, ProtocolCosts> protocols;
+  // of the longest path through the circuit
+  std::size_t online_rounds{0};
+  // that a party sends to all other parties
+  double online_bytes_per_party{0}, setup_bytes_per_party{0}, preprocessing_bytes_per_party{0};
+  PreprocessingPlan preprocessing;
+  // that the gates registered directly, as senders and receivers with all peers
+  std::size_t number_of_ots{0};
+  std::chrono::duration<double> estimated_time{0};
+  // gate types without costs in the model, whose gates are only counted
+  std::vector<std::string> unknown_gate_types;
+};
+
+// Walks the gates of the register with the costs of the model. The circuit needs to be
+// constructed, with its MTs, SPs, SBs and OTs requested from the providers, but neither crypto
+// nor communication is run. The time is estimated as the rounds of the preprocessing and the
+// online phase times the round trip time plus the bytes of a party divided by the bandwidth and
+// the compute times of all gates, i.e., without overlap and parallelism.
+CostEstimate EstimateCosts(const Register& register_, const PreprocessingPlan& preprocessing,
+                           std::size_t number_of_ots, std::size_t number_of_parties,
+                           const CostModel& model);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,199 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "critical_path.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+namespace {
+
+double ToMilliseconds(CriticalPath::Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::size_t ToIndex(GateProfile::Phase phase) { return static_cast<std::size_t>(phase); }
+
+// Splits the part of the phase after begin as described at ComputeCriticalPath.
+CriticalPath::Step MakeStep(const GateProfile::Event& event, std::size_t event_index,
+                            GateProfile::TimePoint begin) {
+  CriticalPath::Step step{.event_index = event_index};
+  const auto start{std::max(event.start, begin)};
+  step.scheduling = start - begin;
+  auto remaining{event.end - start};
+  auto take = [&remaining](CriticalPath::Duration duration) {
+    const auto taken{std::clamp(duration, CriticalPath::Duration{0}, remaining)};
+    remaining -= taken;
+    return taken;
+  };
+  if (event.phase == GateProfile::Phase::kSetup) {
+    step.preprocessing = take(remaining);
+  } else {
+    step.network = take(event.wait_times.messages);
+    step.preprocessing = take(event.wait_times.preprocessing);
+    step.compute = take(event.GetComputeTime());
+    step.scheduling += remaining;
+  }
+  return step;
+}
+
+}  // namespace
+
+CriticalPath ComputeCriticalPath(const GateProfile& profile) {
+  CriticalPath path;
+  const auto& events{profile.events};
+  if (events.empty()) {
+    return path;
+  }
+
+  // the events of each phase indexed by gate id
+  std::array<std::unordered_map<std::int64_t, std::size_t>, 2> event_indices;
+  // the setup phases ordered by their end
+  std::vector<std::size_t> setup_indices;
+  auto first_start{GateProfile::TimePoint::max()};
+  std::size_t last{0};
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    event_indices[ToIndex(events[i].phase)].emplace(events[i].gate_id, i);
+    if (events[i].phase == GateProfile::Phase::kSetup) {
+      setup_indices.push_back(i);
+    }
+    first_start = std::min(first_start, events[i].start);
+    if (events[i].end > events[last].end) {
+      last = i;
+    }
+  }
+  std::sort(setup_indices.begin(), setup_indices.end(),
+            [&events](auto lhs, auto rhs) { return events[lhs].end < events[rhs].end; });
+
+  // predecessors finish strictly before their successors, hence the walk terminates
+  auto find_predecessor = [&](const GateProfile::Event& event) {
+    std::optional<std::size_t> predecessor;
+    auto consider = [&](const std::unordered_map<std::int64_t, std::size_t>& indices,
+                        std::int64_t gate_id) {
+      if (auto it = indices.find(gate_id); it != indices.end()) {
+        const auto& candidate{events[it->second]};
+        if (candidate.end < event.end &&
+            (!predecessor || candidate.end > events[*predecessor].end)) {
+          predecessor = it->second;
+        }
+      }
+    };
+    for (auto parent_gate_id : event.parent_gate_ids) {
+      consider(event_indices[ToIndex(event.phase)], parent_gate_id);
+    }
+    if (event.phase == GateProfile::Phase::kOnline) {
+      consider(event_indices[ToIndex(GateProfile::Phase::kSetup)], event.gate_id);
+      if (!predecessor) {
+        // the setup phase that finished last before the online phase started
+        auto it = std::partition_point(
+            setup_indices.begin(), setup_indices.end(),
+            [&events, &event](auto index) { return events[index].end <= event.start; });
+        if (it != setup_indices.begin()) {
+          predecessor = *std::prev(it);
+        }
+      }
+    }
+    return predecessor;
+  };
+
+  for (std::optional<std::size_t> current{last}; current;) {
+    const auto& event{events[*current]};
+    const auto predecessor{find_predecessor(event)};
+    const auto begin{predecessor ? events[*predecessor].end : first_start};
+    path.steps.emplace_back(MakeStep(event, *current, begin));
+    current = predecessor;
+  }
+  std::reverse(path.steps.begin(), path.steps.end());
+
+  path.latency = events[last].end - first_start;
+  for (const auto& step : path.steps) {
+    path.compute += step.compute;
+    path.network += step.network;
+    path.preprocessing += step.preprocessing;
+    path.scheduling += step.scheduling;
+  }
+  return path;
+}
+
+std::string CriticalPath::PrintHumanReadable(const GateProfile& profile) const {
+  const auto latency_ms{ToMilliseconds(latency)};
+  auto print = [latency_ms](std::string_view name, Duration duration) {
+    const auto milliseconds{ToMilliseconds(duration)};
+    const auto percentage{latency_ms > 0 ? 100 * milliseconds / latency_ms : 0.0};
+    return fmt::format("{:<20}{:10.3f} ms {:6.2f} %\n", name, milliseconds, percentage);
+  };
+
+  // time on the path per phase and gate type, sorted by decreasing time
+  std::map<std::string, Duration> gate_type_durations;
+  for (const auto& step : steps) {
+    const auto& event{profile.events.at(step.event_index)};
+    gate_type_durations[fmt::format("{} {}", event.gate_type, to_string(event.phase))] +=
+        step.compute + step.network + step.preprocessing + step.scheduling;
+  }
+  std::vector<std::pair<std::string, Duration>> sorted_durations(gate_type_durations.begin(),
+                                                                 gate_type_durations.end());
+  std::stable_sort(sorted_durations.begin(), sorted_durations.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+
+  std::stringstream ss;
+  ss << fmt::format("Critical Path       {} phases\n", steps.size()) << print("Latency", latency)
+     << print("Compute", compute) << print("Network", network)
+     << print("Preprocessing", preprocessing) << print("Scheduling", scheduling)
+     << "-------------------------\n";
+  constexpr std::size_t kNumberOfGateTypes = 5;
+  for (std::size_t i = 0; i < std::min(kNumberOfGateTypes, sorted_durations.size()); ++i) {
+    ss << print(sorted_durations[i].first, sorted_durations[i].second);
+  }
+  return ss.str();
+}
+
+boost::json::object CriticalPath::ToJson(const GateProfile& profile) const {
+  boost::json::array steps_array;
+  for (const auto& step : steps) {
+    const auto& event{profile.events.at(step.event_index)};
+    steps_array.emplace_back(
+        boost::json::object({{"gate_type", event.gate_type},
+                             {"gate_id", event.gate_id},
+                             {"phase", to_string(event.phase)},
+                             {"depth", event.depth},
+                             {"compute_ms", ToMilliseconds(step.compute)},
+                             {"network_ms", ToMilliseconds(step.network)},
+                             {"preprocessing_ms", ToMilliseconds(step.preprocessing)},
+                             {"scheduling_ms", ToMilliseconds(step.scheduling)}}));
+  }
+  return boost::json::object({{"latency_ms", ToMilliseconds(latency)},
+                              {"compute_ms", ToMilliseconds(compute)},
+                              {"network_ms", ToMilliseconds(network)},
+                              {"preprocessing_ms", ToMilliseconds(preprocessing)},
+                              {"scheduling_ms", ToMilliseconds(scheduling)},
+                              {"steps", std::move(steps_array)}});
+}
+
+}  // namespace encrypto::motion
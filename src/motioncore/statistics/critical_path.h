@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "gate_profile.h"
+
+namespace encrypto::motion {
+
+// The chain of gate phases of an evaluation that determined its latency, reconstructed from a
+// GateProfile by ComputeCriticalPath. The latency from the start of the first recorded phase to
+// the end of the last one is split into the time spent computing, waiting on messages, waiting on
+// preprocessed data, and in the scheduler between a phase becoming ready and starting.
+struct CriticalPath {
+  using Duration = GateProfile::Duration;
+
+  struct Step {
+    std::size_t event_index;  // into GateProfile::events
+    Duration compute{0}, network{0}, preprocessing{0}, scheduling{0};
+  };
+
+  // Prints the composition of the latency and the gate types on the path with the most time.
+  std::string PrintHumanReadable(const GateProfile& profile) const;
+
+  // {"latency_ms", "compute_ms", "network_ms", "preprocessing_ms", "scheduling_ms",
+  // "steps": [{"gate_type", "gate_id", "phase", "depth", "compute_ms", ...}, ...]}
+  boost::json::object ToJson(const GateProfile& profile) const;
+
+  // from the first to the last phase on the path
+  std::vector<Step> steps;
+  Duration latency{0}, compute{0}, network{0}, preprocessing{0}, scheduling{0};
+};
+
+// Walks back from the phase that finished last to the first one. The predecessor of a phase is
+// the dependency that finished last among the same phase of the parent gates and, for an online
+// phase, the setup phase of the same gate. An online phase without such dependencies, e.g., of an
+// input gate with Configuration::SetOnlineAfterSetup, follows the setup phase that finished last
+// before it started. The part of a phase after its predecessor finished is attributed to its
+// message waits, then its preprocessing waits, then its compute time, and any remainder, e.g., an
+// earlier wait on another dependency, to scheduling, as is the gap before the phase started.
+// Setup phases are attributed to preprocessing as a whole. Message waits are where the round trips
+// of the network become visible to a party, hence they are reported as network time.
+CriticalPath ComputeCriticalPath(const GateProfile& profile);
+
+}  // namespace encrypto::motion
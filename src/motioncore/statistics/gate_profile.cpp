@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gate_profile.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+
+#include <boost/core/demangle.hpp>
+#include <fmt/format.h>
+
+#include "protocols/gate.h"
+
+namespace encrypto::motion {
+
+std::string to_string(GateProfile::Phase phase) {
+  switch (phase) {
+    case GateProfile::Phase::kSetup:
+      return "setup";
+    case GateProfile::Phase::kOnline:
+      return "online";
+  }
+  throw std::invalid_argument("Unknown GateProfile::Phase");
+}
+
+namespace {
+
+double ToMilliseconds(GateProfile::Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+double ToMicroseconds(GateProfile::Duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+struct AccumulatedTimes {
+  void Add(const GateProfile::Event& event) {
+    ++count;
+    total += event.end - event.start;
+    compute += event.GetComputeTime();
+    dependency_wait += event.wait_times.dependencies;
+    message_wait += event.wait_times.messages;
+    preprocessing_wait += event.wait_times.preprocessing;
+  }
+
+  boost::json::object ToJson() const {
+    return boost::json::object({{"count", count},
+                                {"total_ms", ToMilliseconds(total)},
+                                {"compute_ms", ToMilliseconds(compute)},
+                                {"dependency_wait_ms", ToMilliseconds(dependency_wait)},
+                                {"message_wait_ms", ToMilliseconds(message_wait)},
+                                {"preprocessing_wait_ms", ToMilliseconds(preprocessing_wait)}});
+  }
+
+  std::size_t count = 0;
+  GateProfile::Duration total{0}, compute{0}, dependency_wait{0}, message_wait{0},
+      preprocessing_wait{0};
+};
+
+struct GateTypeTimes {
+  AccumulatedTimes times;
+  std::map<std::size_t, AccumulatedTimes> depths;
+};
+
+// accumulated times indexed by phase and gate type, ordered for a deterministic output
+using AggregatedTimes = std::map<GateProfile::Phase, std::map<std::string, GateTypeTimes>>;
+
+AggregatedTimes Aggregate(const std::vector<GateProfile::Event>& events) {
+  AggregatedTimes aggregated;
+  for (const auto& event : events) {
+    auto& gate_type_times{aggregated[event.phase][event.gate_type]};
+    gate_type_times.times.Add(event);
+    gate_type_times.depths[event.depth].Add(event);
+  }
+  return aggregated;
+}
+
+}  // namespace
+
+// strips the namespaces shared by all gates
+std::string GetGateType(const Gate& gate) {
+  auto name{boost::core::demangle(typeid(gate).name())};
+  for (std::string_view prefix : {"encrypto::motion::proto::", "encrypto::motion::"}) {
+    if (name.starts_with(prefix)) {
+      return name.substr(prefix.size());
+    }
+  }
+  return name;
+}
+
+boost::json::object GateProfile::ToJson() const {
+  boost::json::object result({{"setup", boost::json::object()}, {"online", boost::json::object()}});
+  for (const auto& [phase, gate_types] : Aggregate(events)) {
+    auto& phase_object{result.at(to_string(phase)).as_object()};
+    for (const auto& [gate_type, gate_type_times] : gate_types) {
+      auto gate_type_object{gate_type_times.times.ToJson()};
+      boost::json::object depths;
+      for (const auto& [depth, times] : gate_type_times.depths) {
+        depths.emplace(std::to_string(depth), times.ToJson());
+      }
+      gate_type_object.emplace("depths", std::move(depths));
+      phase_object.emplace(gate_type, std::move(gate_type_object));
+    }
+  }
+  return result;
+}
+
+std::string GateProfile::ToChromeTrace() const {
+  TimePoint first_start{TimePoint::max()};
+  for (const auto& event : events) {
+    first_start = std::min(first_start, event.start);
+  }
+  // the rows of the trace are numbered by the order in which the threads appear
+  std::unordered_map<std::thread::id, std::size_t> thread_numbers;
+  boost::json::array trace_events;
+  trace_events.reserve(events.size());
+  for (const auto& event : events) {
+    const auto thread_number{thread_numbers.try_emplace(event.thread_id, thread_numbers.size())};
+    trace_events.emplace_back(boost::json::object(
+        {{"name", event.gate_type},
+         {"cat", to_string(event.phase)},
+         {"ph", "X"},
+         {"ts", ToMicroseconds(event.start - first_start)},
+         {"dur", ToMicroseconds(event.end - event.start)},
+         {"pid", 0},
+         {"tid", thread_number.first->second},
+         {"args", boost::json::object(
+                      {{"gate_id", event.gate_id},
+                       {"depth", event.depth},
+                       {"compute_us", ToMicroseconds(event.GetComputeTime())},
+                       {"dependency_wait_us", ToMicroseconds(event.wait_times.dependencies)},
+                       {"message_wait_us", ToMicroseconds(event.wait_times.messages)},
+                       {"preprocessing_wait_us",
+                        ToMicroseconds(event.wait_times.preprocessing)}})}}));
+  }
+  return boost::json::serialize(
+      boost::json::object({{"traceEvents", std::move(trace_events)}, {"displayTimeUnit", "ms"}}));
+}
+
+std::string GateProfile::ToFoldedStacks() const {
+  std::stringstream ss;
+  auto print = [&ss](std::string_view stack, std::string_view part, Duration duration) {
+    // flamegraph.pl expects integral sample counts
+    if (const auto microseconds{std::chrono::duration_cast<std::chrono::microseconds>(duration)};
+        microseconds.count() > 0) {
+      ss << fmt::format("{};{} {}\n", stack, part, microseconds.count());
+    }
+  };
+  for (const auto& [phase, gate_types] : Aggregate(events)) {
+    for (const auto& [gate_type, gate_type_times] : gate_types) {
+      for (const auto& [depth, times] : gate_type_times.depths) {
+        const auto stack{fmt::format("{};{};depth {}", to_string(phase), gate_type, depth)};
+        print(stack, "compute", times.compute);
+        print(stack, "dependency wait", times.dependency_wait);
+        print(stack, "message wait", times.message_wait);
+        print(stack, "preprocessing wait", times.preprocessing_wait);
+      }
+    }
+  }
+  return ss.str();
+}
+
+GateProfile GateProfiler::TakeProfile() {
+  std::scoped_lock lock(mutex_);
+  return std::exchange(profile_, GateProfile());
+}
+
+void GateProfiler::Add(const Gate& gate, GateProfile::Event&& event) {
+  event.gate_type = GetGateType(gate);
+  event.gate_id = gate.GetId();
+  if (auto it = gate_infos_.find(&gate); it != gate_infos_.end()) {
+    event.depth = it->second.depth;
+    event.parent_gate_ids = it->second.parent_gate_ids;
+  } else {
+    event.depth = 0;
+  }
+  std::scoped_lock lock(mutex_);
+  profile_.events.emplace_back(std::move(event));
+}
+
+}  // namespace encrypto::motion
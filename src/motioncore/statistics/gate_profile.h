@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "utility/profiled_wait.h"
+
+namespace encrypto::motion {
+
+class Gate;
+
+// Wall times of the setup and online phases of the individual gates of an evaluation, recorded by
+// the GateExecutor if Configuration::SetProfileGates is enabled. The wall time of a phase is split
+// into the time the evaluating fiber waited on parent wires and gates, on messages, and on
+// preprocessed data such as MTs, and the remaining compute time.
+struct GateProfile {
+  using ClockType = std::chrono::steady_clock;
+  using TimePoint = std::chrono::time_point<ClockType>;
+  using Duration = ClockType::duration;
+
+  enum class Phase : std::uint8_t { kSetup, kOnline };
+
+  struct Event {
+    std::string gate_type;  // e.g., "boolean_gmw::AndGate"
+    std::int64_t gate_id;
+    std::size_t depth;  // length of the longest path from a gate without producing input gates
+    std::vector<std::int64_t> parent_gate_ids;  // of the gates producing the input wires
+    Phase phase;
+    std::thread::id thread_id;  // of the thread that started the phase
+    TimePoint start, end;
+    WaitTimes wait_times;
+
+    Duration GetComputeTime() const {
+      return end - start - wait_times.dependencies - wait_times.messages -
+             wait_times.preprocessing;
+    }
+  };
+
+  // Aggregates the events per phase by gate type and, for each type, by depth:
+  // {"setup": {type: {"count", "total_ms", "compute_ms", "dependency_wait_ms", "message_wait_ms",
+  // "preprocessing_wait_ms", "depths": {depth: {...}}}}, "online": {...}}
+  boost::json::object ToJson() const;
+
+  // Serializes the events in the Chrome trace event format, e.g., for chrome://tracing, Perfetto,
+  // or speedscope, as one complete event per phase of a gate on the row of its thread.
+  std::string ToChromeTrace() const;
+
+  // Serializes the aggregated times in the folded stack format "phase;type;depth d;part time" of
+  // flamegraph.pl and inferno with the times given in microseconds.
+  std::string ToFoldedStacks() const;
+
+  std::vector<Event> events;
+};
+
+std::string to_string(GateProfile::Phase phase);
+
+// type of the gate without the namespaces shared by all gates, e.g., boolean_gmw::AndGate for
+// encrypto::motion::proto::boolean_gmw::AndGate
+std::string GetGateType(const Gate& gate);
+
+// Records the GateProfile of an evaluation and is shared by all fibers evaluating gates.
+class GateProfiler {
+ public:
+  struct GateInfo {
+    std::size_t depth;
+    std::vector<std::int64_t> parent_gate_ids;
+  };
+
+  explicit GateProfiler(std::unordered_map<const Gate*, GateInfo>&& gate_infos)
+      : gate_infos_(std::move(gate_infos)) {}
+
+  // Calls evaluate(), which evaluates the given phase of the gate, and records it as an event.
+  template <typename Function>
+  void Profile(const Gate& gate, GateProfile::Phase phase, Function&& evaluate) {
+    GateProfile::Event event;
+    event.phase = phase;
+    event.thread_id = std::this_thread::get_id();
+    auto previous_wait_times{SetFiberWaitTimes(&event.wait_times)};
+    event.start = GateProfile::ClockType::now();
+    evaluate();
+    event.end = GateProfile::ClockType::now();
+    SetFiberWaitTimes(previous_wait_times);
+    Add(gate, std::move(event));
+  }
+
+  // Returns the recorded events and clears them.
+  GateProfile TakeProfile();
+
+ private:
+  void Add(const Gate& gate, GateProfile::Event&& event);
+
+  const std::unordered_map<const Gate*, GateInfo> gate_infos_;
+  std::mutex mutex_;
+  GateProfile profile_;
+};
+
+}  // namespace encrypto::motion
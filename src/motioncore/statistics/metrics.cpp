@@ -0,0 +1,309 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "metrics.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+using boost::asio::ip::tcp;
+
+namespace encrypto::motion {
+
+namespace detail {
+
+std::size_t GetMetricShard() noexcept {
+  static std::atomic<std::size_t> next_shard{0};
+  thread_local const std::size_t shard{next_shard.fetch_add(1, std::memory_order_relaxed) %
+                                       kNumberOfMetricShards};
+  return shard;
+}
+
+}  // namespace detail
+
+std::uint64_t MetricsCounter::Get() const noexcept {
+  return std::accumulate(shards_.begin(), shards_.end(), std::uint64_t(0),
+                         [](std::uint64_t sum, const Shard& shard) {
+                           return sum + shard.value.load(std::memory_order_relaxed);
+                         });
+}
+
+std::array<std::uint64_t, MetricsHistogram::kNumberOfBuckets> MetricsHistogram::GetBuckets()
+    const noexcept {
+  std::array<std::uint64_t, kNumberOfBuckets> buckets{};
+  for (const auto& shard : shards_) {
+    for (std::size_t i = 0; i < kNumberOfBuckets; ++i) {
+      buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+  return buckets;
+}
+
+std::uint64_t MetricsHistogram::GetSum() const noexcept {
+  return std::accumulate(shards_.begin(), shards_.end(), std::uint64_t(0),
+                         [](std::uint64_t sum, const Shard& shard) {
+                           return sum + shard.sum.load(std::memory_order_relaxed);
+                         });
+}
+
+namespace {
+
+// {name="value",...} with the escaping of the OpenMetrics text format, empty without labels
+std::string FormatLabels(const MetricLabels& labels) {
+  if (labels.empty()) {
+    return {};
+  }
+  std::string result{"{"};
+  for (std::size_t i = 0; i < labels.size(); ++i) {
+    if (i > 0) {
+      result += ',';
+    }
+    result += labels[i].first;
+    result += "=\"";
+    for (auto c : labels[i].second) {
+      switch (c) {
+        case '\\':
+          result += "\\\\";
+          break;
+        case '"':
+          result += "\\\"";
+          break;
+        case '\n':
+          result += "\\n";
+          break;
+        default:
+          result += c;
+      }
+    }
+    result += '"';
+  }
+  result += '}';
+  return result;
+}
+
+std::string MakeKey(std::string_view name, const MetricLabels& labels) {
+  return fmt::format("{}{}", name, FormatLabels(labels));
+}
+
+}  // namespace
+
+MetricsSnapshot::Family& MetricsSnapshot::GetFamily(std::string_view name, std::string_view type,
+                                                    std::string_view help) {
+  auto it = families_.find(name);
+  if (it == families_.end()) {
+    it = families_.emplace(std::string(name), Family{std::string(type), std::string(help), {}})
+             .first;
+  } else if (it->second.type != type) {
+    throw std::invalid_argument(
+        fmt::format("Metric {} is a {} and cannot be a {}", name, it->second.type, type));
+  }
+  return it->second;
+}
+
+void MetricsSnapshot::AddCounter(std::string_view name, std::string_view help,
+                                 const MetricLabels& labels, std::uint64_t value) {
+  GetFamily(name, "counter", help)
+      .lines.emplace_back(fmt::format("{}_total{} {}", name, FormatLabels(labels), value));
+}
+
+void MetricsSnapshot::AddGauge(std::string_view name, std::string_view help,
+                               const MetricLabels& labels, double value) {
+  GetFamily(name, "gauge", help)
+      .lines.emplace_back(fmt::format("{}{} {}", name, FormatLabels(labels), value));
+}
+
+void MetricsSnapshot::AddHistogram(std::string_view name, std::string_view help,
+                                   const MetricLabels& labels, const MetricsHistogram& histogram) {
+  auto& family{GetFamily(name, "histogram", help)};
+  const auto buckets{histogram.GetBuckets()};
+  std::uint64_t count{0};
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    count += buckets[i];
+    auto bucket_labels{labels};
+    // bucket i < kNumberOfBuckets - 1 contains the values of bit width i, i.e., at most 2^i - 1
+    bucket_labels.emplace_back("le", i + 1 < buckets.size()
+                                         ? std::to_string((std::uint64_t(1) << i) - 1)
+                                         : std::string("+Inf"));
+    family.lines.emplace_back(
+        fmt::format("{}_bucket{} {}", name, FormatLabels(bucket_labels), count));
+  }
+  family.lines.emplace_back(fmt::format("{}_sum{} {}", name, FormatLabels(labels),
+                                        histogram.GetSum()));
+  family.lines.emplace_back(fmt::format("{}_count{} {}", name, FormatLabels(labels), count));
+}
+
+std::string MetricsSnapshot::ToOpenMetrics() const {
+  std::string result;
+  for (const auto& [name, family] : families_) {
+    result += fmt::format("# TYPE {} {}\n# HELP {} {}\n", name, family.type, name, family.help);
+    for (const auto& line : family.lines) {
+      result += line;
+      result += '\n';
+    }
+  }
+  result += "# EOF\n";
+  return result;
+}
+
+MetricsCollectorHandle& MetricsCollectorHandle::operator=(MetricsCollectorHandle&& other) noexcept {
+  if (this != &other) {
+    Reset();
+    registry_ = std::move(other.registry_);
+    id_ = other.id_;
+    other.registry_.reset();
+  }
+  return *this;
+}
+
+void MetricsCollectorHandle::Reset() noexcept {
+  if (auto registry{registry_.lock()}) {
+    registry->RemoveCollector(id_);
+  }
+  registry_.reset();
+}
+
+MetricsCounter& MetricsRegistry::GetCounter(std::string_view name, std::string_view help,
+                                            const MetricLabels& labels) {
+  std::scoped_lock lock(mutex_);
+  auto [it, inserted] = counters_.try_emplace(MakeKey(name, labels));
+  if (inserted) {
+    it->second = {std::string(name), std::string(help), labels,
+                  std::make_unique<MetricsCounter>()};
+  }
+  return *it->second.metric;
+}
+
+MetricsHistogram& MetricsRegistry::GetHistogram(std::string_view name, std::string_view help,
+                                                const MetricLabels& labels) {
+  std::scoped_lock lock(mutex_);
+  auto [it, inserted] = histograms_.try_emplace(MakeKey(name, labels));
+  if (inserted) {
+    it->second = {std::string(name), std::string(help), labels,
+                  std::make_unique<MetricsHistogram>()};
+  }
+  return *it->second.metric;
+}
+
+MetricsCollectorHandle MetricsRegistry::AddCollector(Collector collector) {
+  std::scoped_lock lock(mutex_);
+  const auto id{next_collector_id_++};
+  collectors_.emplace(id, std::move(collector));
+  return MetricsCollectorHandle(weak_from_this(), id);
+}
+
+void MetricsRegistry::RemoveCollector(std::size_t id) {
+  // waits for a running Collect(), such that the collector does not outlive its component
+  std::scoped_lock lock(mutex_);
+  collectors_.erase(id);
+}
+
+MetricsSnapshot MetricsRegistry::Collect() const {
+  MetricsSnapshot snapshot;
+  std::scoped_lock lock(mutex_);
+  for (const auto& [key, entry] : counters_) {
+    snapshot.AddCounter(entry.name, entry.help, entry.labels, entry.metric->Get());
+  }
+  for (const auto& [key, entry] : histograms_) {
+    snapshot.AddHistogram(entry.name, entry.help, entry.labels, *entry.metric);
+  }
+  for (const auto& [id, collector] : collectors_) {
+    collector(snapshot);
+  }
+  return snapshot;
+}
+
+struct MetricsHttpServer::Implementation {
+  Implementation(std::shared_ptr<const MetricsRegistry> r, std::string_view address,
+                 std::uint16_t port)
+      : registry(std::move(r)),
+        acceptor(io_context, tcp::endpoint(boost::asio::ip::make_address(address), port)) {}
+
+  void Accept() {
+    acceptor.async_accept([this](boost::system::error_code error, tcp::socket socket) {
+      if (error) {
+        // the acceptor was closed
+        return;
+      }
+      Serve(std::make_shared<Connection>(std::move(socket)));
+      Accept();
+    });
+  }
+
+  struct Connection {
+    explicit Connection(tcp::socket&& s) : socket(std::move(s)) {}
+
+    tcp::socket socket;
+    boost::asio::streambuf request;
+    std::string response;
+  };
+
+  void Serve(std::shared_ptr<Connection> connection) {
+    // the request itself is irrelevant, we only wait for the end of its header
+    boost::asio::async_read_until(
+        connection->socket, connection->request, "\r\n\r\n",
+        [this, connection](boost::system::error_code error, std::size_t) {
+          if (error) {
+            return;
+          }
+          const auto body{registry->ToOpenMetrics()};
+          connection->response = fmt::format(
+              "HTTP/1.1 200 OK\r\n"
+              "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+              "Content-Length: {}\r\nConnection: close\r\n\r\n{}",
+              body.size(), body);
+          boost::asio::async_write(connection->socket,
+                                   boost::asio::buffer(connection->response),
+                                   [connection](boost::system::error_code, std::size_t) {
+                                     boost::system::error_code ignored;
+                                     connection->socket.shutdown(tcp::socket::shutdown_both,
+                                                                 ignored);
+                                   });
+        });
+  }
+
+  std::shared_ptr<const MetricsRegistry> registry;
+  boost::asio::io_context io_context;
+  tcp::acceptor acceptor;
+};
+
+MetricsHttpServer::MetricsHttpServer(std::shared_ptr<const MetricsRegistry> registry,
+                                     std::string_view address, std::uint16_t port)
+    : implementation_(std::make_unique<Implementation>(std::move(registry), address, port)),
+      port_(implementation_->acceptor.local_endpoint().port()) {
+  implementation_->Accept();
+  thread_ = std::thread([this] { implementation_->io_context.run(); });
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+  implementation_->io_context.stop();
+  thread_.join();
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,220 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace encrypto::motion {
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+namespace detail {
+
+constexpr std::size_t kNumberOfMetricShards = 16;
+
+// the shard of the calling thread, threads are assigned to the shards round robin
+std::size_t GetMetricShard() noexcept;
+
+}  // namespace detail
+
+// Monotonic counter that can be incremented concurrently without contention: each thread adds to
+// its own cache line with a relaxed atomic addition, and Get() sums the shards.
+class MetricsCounter {
+ public:
+  void Add(std::uint64_t value = 1) noexcept {
+    shards_[detail::GetMetricShard()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  std::uint64_t Get() const noexcept;
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<std::uint64_t> value{0};
+  };
+  std::array<Shard, detail::kNumberOfMetricShards> shards_;
+};
+
+// Histogram of unsigned values, e.g., message sizes in bytes, with the power-of-two buckets
+// [0, 0], [1, 1], [2, 3], ..., [2^30, 2^31 - 1], and [2^31, inf), sharded like MetricsCounter.
+class MetricsHistogram {
+ public:
+  static constexpr std::size_t kNumberOfBuckets = 33;
+
+  void Observe(std::uint64_t value) noexcept {
+    auto& shard{shards_[detail::GetMetricShard()]};
+    const auto bucket{std::min<std::size_t>(std::bit_width(value), kNumberOfBuckets - 1)};
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  // number of observed values per bucket, not cumulative
+  std::array<std::uint64_t, kNumberOfBuckets> GetBuckets() const noexcept;
+
+  std::uint64_t GetSum() const noexcept;
+
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<std::uint64_t>, kNumberOfBuckets> buckets{};
+    std::atomic<std::uint64_t> sum{0};
+  };
+  std::array<Shard, detail::kNumberOfMetricShards> shards_;
+};
+
+// Values of the metrics at the time of a scrape grouped into families by name.
+class MetricsSnapshot {
+ public:
+  // counters are exposed with the suffix _total
+  void AddCounter(std::string_view name, std::string_view help, const MetricLabels& labels,
+                  std::uint64_t value);
+
+  void AddGauge(std::string_view name, std::string_view help, const MetricLabels& labels,
+                double value);
+
+  void AddHistogram(std::string_view name, std::string_view help, const MetricLabels& labels,
+                    const MetricsHistogram& histogram);
+
+  // serializes the snapshot in the OpenMetrics text format, which Prometheus scrapes
+  std::string ToOpenMetrics() const;
+
+ private:
+  struct Family {
+    std::string type, help;
+    std::vector<std::string> lines;
+  };
+
+  Family& GetFamily(std::string_view name, std::string_view type, std::string_view help);
+
+  std::map<std::string, Family, std::less<>> families_;
+};
+
+class MetricsRegistry;
+
+// Removes its collector from the registry when it is destroyed, unless the registry is gone.
+class MetricsCollectorHandle {
+ public:
+  MetricsCollectorHandle() = default;
+  MetricsCollectorHandle(std::weak_ptr<MetricsRegistry> registry, std::size_t id)
+      : registry_(std::move(registry)), id_(id) {}
+
+  MetricsCollectorHandle(MetricsCollectorHandle&& other) noexcept
+      : registry_(std::move(other.registry_)), id_(other.id_) {
+    other.registry_.reset();
+  }
+
+  MetricsCollectorHandle& operator=(MetricsCollectorHandle&& other) noexcept;
+
+  ~MetricsCollectorHandle() { Reset(); }
+
+  void Reset() noexcept;
+
+ private:
+  std::weak_ptr<MetricsRegistry> registry_;
+  std::size_t id_ = 0;
+};
+
+// Registry of the always-on metrics of long-lived parties. Hot paths increment MetricsCounters and
+// MetricsHistograms obtained once from the registry, while levels such as pool sizes and queue
+// depths are only read by collectors when the metrics are scraped, hence components without a
+// registry do not pay for the metrics at all. A registry is shared by the components exposing
+// metrics, e.g., via Backend::RegisterMetrics, and must be created by std::make_shared.
+class MetricsRegistry : public std::enable_shared_from_this<MetricsRegistry> {
+ public:
+  using Collector = std::function<void(MetricsSnapshot&)>;
+
+  // Returns the counter with the given name and labels, which is created on first use and lives
+  // as long as the registry.
+  MetricsCounter& GetCounter(std::string_view name, std::string_view help,
+                             const MetricLabels& labels = {});
+
+  MetricsHistogram& GetHistogram(std::string_view name, std::string_view help,
+                                 const MetricLabels& labels = {});
+
+  // The collector is called on each scrape until the handle is destroyed. It may be called
+  // concurrently to the component it reads and must synchronize accordingly, but must not use the
+  // registry itself, which is locked during the collection.
+  [[nodiscard]] MetricsCollectorHandle AddCollector(Collector collector);
+
+  MetricsSnapshot Collect() const;
+
+  std::string ToOpenMetrics() const { return Collect().ToOpenMetrics(); }
+
+ private:
+  friend class MetricsCollectorHandle;
+
+  void RemoveCollector(std::size_t id);
+
+  template <typename Metric>
+  struct Entry {
+    std::string name, help;
+    MetricLabels labels;
+    std::unique_ptr<Metric> metric;
+  };
+
+  mutable std::mutex mutex_;
+  // indexed by the name and the serialized labels
+  std::map<std::string, Entry<MetricsCounter>, std::less<>> counters_;
+  std::map<std::string, Entry<MetricsHistogram>, std::less<>> histograms_;
+  std::map<std::size_t, Collector> collectors_;
+  std::size_t next_collector_id_ = 0;
+};
+
+// Serves the metrics of a registry in the OpenMetrics text format via HTTP, e.g., for scraping by
+// Prometheus, on a thread of its own. Every request is answered with the current metrics
+// regardless of its path.
+class MetricsHttpServer {
+ public:
+  // port 0 selects a free port, see GetPort
+  MetricsHttpServer(std::shared_ptr<const MetricsRegistry> registry, std::string_view address,
+                    std::uint16_t port);
+
+  ~MetricsHttpServer();
+
+  MetricsHttpServer(const MetricsHttpServer&) = delete;
+  MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+  std::uint16_t GetPort() const noexcept { return port_; }
+
+ private:
+  struct Implementation;
+
+  std::unique_ptr<Implementation> implementation_;
+  std::uint16_t port_;
+  std::thread thread_;
+};
+
+}  // namespace encrypto::motion
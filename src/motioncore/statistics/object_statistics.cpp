@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "object_statistics.h"
+
+#include <utility>
+
+#include <boost/core/demangle.hpp>
+#include <fmt/format.h>
+
+#include "utility/allocation_counter.h"
+#include "utility/object_arena.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// bytes of the scopes that were finished in the innermost open scope of the calling thread
+thread_local ObjectStatistics nested_statistics;
+
+std::string GetClassName(std::type_index type) {
+  auto name{boost::core::demangle(type.name())};
+  for (std::string_view prefix : {"encrypto::motion::proto::", "encrypto::motion::"}) {
+    if (name.starts_with(prefix)) {
+      return name.substr(prefix.size());
+    }
+  }
+  return name;
+}
+
+}  // namespace
+
+ObjectStatistics& ObjectStatistics::operator+=(const ObjectStatistics& other) noexcept {
+  number_of_objects += other.number_of_objects;
+  arena_bytes += other.arena_bytes;
+  heap_bytes += other.heap_bytes;
+  return *this;
+}
+
+ObjectStatistics ObjectStatisticsMap::GetTotal() const {
+  ObjectStatistics total;
+  for (const auto& [name, statistics] : *this) total += statistics;
+  return total;
+}
+
+std::string ObjectStatisticsMap::PrintHumanReadable() const {
+  std::string result{fmt::format("{:<48} {:>10} {:>14} {:>14} {:>10}\n", "class", "objects",
+                                 "arena bytes", "heap bytes", "bytes/obj")};
+  const auto print_row = [&result](std::string_view name, const ObjectStatistics& statistics) {
+    result += fmt::format("{:<48} {:>10} {:>14} {:>14} {:>10.1f}\n", name,
+                          statistics.number_of_objects, statistics.arena_bytes,
+                          statistics.heap_bytes,
+                          statistics.number_of_objects == 0
+                              ? 0.0
+                              : static_cast<double>(statistics.GetBytes()) /
+                                    statistics.number_of_objects);
+  };
+  for (const auto& [name, statistics] : *this) print_row(name, statistics);
+  print_row("total", GetTotal());
+  return result;
+}
+
+boost::json::object ObjectStatisticsMap::ToJson() const {
+  boost::json::object result;
+  for (const auto& [name, statistics] : *this) {
+    result[name] = boost::json::object{{"objects", statistics.number_of_objects},
+                                       {"arena_bytes", statistics.arena_bytes},
+                                       {"heap_bytes", statistics.heap_bytes}};
+  }
+  return result;
+}
+
+ObjectAccounting::Scope::Scope(ObjectAccounting& accounting, const ObjectArena& arena) noexcept
+    : accounting_(accounting),
+      arena_(arena),
+      arena_bytes_begin_(arena.GetNumberOfAllocatedBytes()),
+      heap_bytes_begin_(GetThreadAllocatedBytes()),
+      enclosing_nested_statistics_(std::exchange(nested_statistics, {})) {}
+
+ObjectAccounting::Scope::~Scope() {
+  if (!finished_) {
+    // the construction threw, its bytes are accounted for the enclosing scope
+    nested_statistics = enclosing_nested_statistics_;
+  }
+}
+
+void ObjectAccounting::Scope::Finish(std::type_index type) {
+  const ObjectStatistics total{
+      .number_of_objects = 0,
+      .arena_bytes = arena_.GetNumberOfAllocatedBytes() - arena_bytes_begin_,
+      .heap_bytes = GetThreadAllocatedBytes() - heap_bytes_begin_};
+  const ObjectStatistics own{.number_of_objects = 1,
+                             .arena_bytes = total.arena_bytes - nested_statistics.arena_bytes,
+                             .heap_bytes = total.heap_bytes - nested_statistics.heap_bytes};
+  // the enclosing scope excludes this object including its nested objects
+  nested_statistics = enclosing_nested_statistics_;
+  nested_statistics += total;
+  finished_ = true;
+  std::scoped_lock lock(accounting_.mutex_);
+  accounting_.statistics_[type] += own;
+}
+
+ObjectStatisticsMap ObjectAccounting::GetStatistics() const {
+  ObjectStatisticsMap result;
+  std::scoped_lock lock(mutex_);
+  for (const auto& [type, statistics] : statistics_) result[GetClassName(type)] += statistics;
+  return result;
+}
+
+void ObjectAccounting::Clear() {
+  std::scoped_lock lock(mutex_);
+  statistics_.clear();
+}
+
+}  // namespace encrypto::motion
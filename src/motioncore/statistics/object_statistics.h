@@ -0,0 +1,106 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+#include <boost/json.hpp>
+
+namespace encrypto::motion {
+
+class ObjectArena;
+
+// Number and memory of the gates or wires of one class that were constructed by
+// Register::EmplaceGate and Register::EmplaceWire while the object accounting was enabled. The
+// bytes of an object exclude those of the gates and wires constructed by its constructor, e.g., of
+// the output wires of a gate, which are accounted for their own classes.
+struct ObjectStatistics {
+  std::size_t number_of_objects{0};
+  // bytes of the objects and their shared_ptr control blocks in the arena of the register
+  std::size_t arena_bytes{0};
+  // bytes allocated from the heap during the construction, e.g., for the values of a wire, if the
+  // application reports its allocations by CountThreadAllocation()
+  std::size_t heap_bytes{0};
+
+  std::size_t GetBytes() const noexcept { return arena_bytes + heap_bytes; }
+
+  ObjectStatistics& operator+=(const ObjectStatistics& other) noexcept;
+};
+
+// object statistics by class name without the namespace encrypto::motion::proto, e.g.,
+// boolean_gmw::AndGate
+struct ObjectStatisticsMap : std::map<std::string, ObjectStatistics> {
+  ObjectStatistics GetTotal() const;
+
+  std::string PrintHumanReadable() const;
+
+  boost::json::object ToJson() const;
+};
+
+// Opt-in accounting of the objects constructed by a Register, see Register::SetObjectAccounting.
+class ObjectAccounting {
+ public:
+  // Measures the construction of one object in an arena. Scopes may be nested on a thread, e.g.,
+  // while a gate constructs its output wires, and the bytes of the inner scopes are subtracted
+  // from the outer one.
+  class Scope {
+   public:
+    Scope(ObjectAccounting& accounting, const ObjectArena& arena) noexcept;
+
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+
+    // records the object constructed in the scope
+    void Finish(std::type_index type);
+
+   private:
+    ObjectAccounting& accounting_;
+    const ObjectArena& arena_;
+    std::size_t arena_bytes_begin_, heap_bytes_begin_;
+    // bytes of the scopes nested into the enclosing scope before this one
+    ObjectStatistics enclosing_nested_statistics_;
+    bool finished_{false};
+  };
+
+  void SetEnabled(bool value) noexcept { enabled_.store(value, std::memory_order_relaxed); }
+
+  bool IsEnabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+  ObjectStatisticsMap GetStatistics() const;
+
+  void Clear();
+
+ private:
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mutex_;
+  std::unordered_map<std::type_index, ObjectStatistics> statistics_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "performance_comparison.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/math/distributions/students_t.hpp>
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+PerformanceSample PerformanceSample::FromUncorrectedStandardDeviation(double mean,
+                                                                      double standard_deviation,
+                                                                      std::size_t repetitions) {
+  const double bessel_correction{
+      repetitions > 1 ? static_cast<double>(repetitions) / (repetitions - 1) : 1.0};
+  return {.mean = mean,
+          .variance = standard_deviation * standard_deviation * bessel_correction,
+          .repetitions = repetitions};
+}
+
+double ComputeWelchTTestPValue(const PerformanceSample& a, const PerformanceSample& b) {
+  if (a.repetitions < 2 || b.repetitions < 2) return 1.0;
+  const double a_variance_of_mean{a.variance / a.repetitions};
+  const double b_variance_of_mean{b.variance / b.repetitions};
+  const double variance_of_difference{a_variance_of_mean + b_variance_of_mean};
+  if (variance_of_difference == 0.0) {
+    // deterministic measurements
+    return a.mean == b.mean ? 1.0 : 0.0;
+  }
+  const double t{std::abs(a.mean - b.mean) / std::sqrt(variance_of_difference)};
+  // Welch-Satterthwaite equation
+  const double degrees_of_freedom{
+      variance_of_difference * variance_of_difference /
+      (a_variance_of_mean * a_variance_of_mean / (a.repetitions - 1) +
+       b_variance_of_mean * b_variance_of_mean / (b.repetitions - 1))};
+  const boost::math::students_t distribution(degrees_of_freedom);
+  return 2.0 * boost::math::cdf(boost::math::complement(distribution, t));
+}
+
+std::vector<PerformanceChange> ComparePerformance(const PerformanceSamples& baseline,
+                                                  const PerformanceSamples& current,
+                                                  const PerformanceComparisonOptions& options) {
+  std::vector<PerformanceChange> changes;
+  for (const auto& [name, current_sample] : current) {
+    const auto baseline_iterator{baseline.find(name)};
+    if (baseline_iterator == baseline.end()) continue;
+    const auto& baseline_sample{baseline_iterator->second};
+    PerformanceChange change{.name = name,
+                             .baseline = baseline_sample,
+                             .current = current_sample,
+                             .relative_change = 0.0,
+                             .p_value = ComputeWelchTTestPValue(baseline_sample, current_sample),
+                             .verdict = PerformanceChange::Verdict::kUnchanged};
+    if (baseline_sample.mean != 0.0) {
+      change.relative_change = (current_sample.mean - baseline_sample.mean) / baseline_sample.mean;
+    }
+    if (change.p_value < options.significance_level &&
+        std::abs(change.relative_change) >= options.minimum_relative_change) {
+      change.verdict = change.relative_change > 0.0 ? PerformanceChange::Verdict::kRegression
+                                                    : PerformanceChange::Verdict::kImprovement;
+    }
+    changes.push_back(std::move(change));
+  }
+  return changes;
+}
+
+std::string PrintPerformanceChanges(const std::vector<PerformanceChange>& changes) {
+  std::string result;
+  const auto print_changes = [&changes, &result](PerformanceChange::Verdict verdict,
+                                                 std::string_view title) {
+    std::vector<const PerformanceChange*> selected;
+    for (const auto& change : changes) {
+      if (change.verdict == verdict) selected.push_back(&change);
+    }
+    // the largest changes first
+    std::sort(selected.begin(), selected.end(), [](auto a, auto b) {
+      return std::abs(a->relative_change) > std::abs(b->relative_change);
+    });
+    result += fmt::format("{} ({})\n", title, selected.size());
+    for (const auto change : selected) {
+      result += fmt::format("  {:+7.1f}%  {:>14.4g} -> {:<14.4g} p = {:.2g}  {}\n",
+                            100.0 * change->relative_change, change->baseline.mean,
+                            change->current.mean, change->p_value, change->name);
+    }
+  };
+  print_changes(PerformanceChange::Verdict::kRegression, "Regressions");
+  print_changes(PerformanceChange::Verdict::kImprovement, "Improvements");
+  const auto number_of_unchanged{
+      std::count_if(changes.begin(), changes.end(), [](const auto& change) {
+        return change.verdict == PerformanceChange::Verdict::kUnchanged;
+      })};
+  result += fmt::format("Unchanged ({})\n", number_of_unchanged);
+  return result;
+}
+
+}  // namespace encrypto::motion
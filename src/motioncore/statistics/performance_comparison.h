@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace encrypto::motion {
+
+/// \brief The mean and the unbiased variance of the repeated measurements of a benchmark, e.g., of
+///        its run time, where lower values are better.
+struct PerformanceSample {
+  double mean = 0.0;
+  double variance = 0.0;
+  std::size_t repetitions = 0;
+
+  /// \brief Converts the uncorrected standard deviation of AccumulatedRunTimeStatistics::ToJson to
+  ///        the unbiased variance.
+  static PerformanceSample FromUncorrectedStandardDeviation(double mean, double standard_deviation,
+                                                            std::size_t repetitions);
+};
+
+using PerformanceSamples = std::map<std::string, PerformanceSample>;
+
+struct PerformanceComparisonOptions {
+  /// changes with a larger p-value of Welch's t-test are considered noise
+  double significance_level = 0.01;
+  /// changes of the mean by less than this fraction are not reported even if they are significant
+  double minimum_relative_change = 0.05;
+};
+
+struct PerformanceChange {
+  enum class Verdict { kUnchanged, kRegression, kImprovement };
+
+  std::string name;
+  PerformanceSample baseline;
+  PerformanceSample current;
+  /// (current mean - baseline mean) / baseline mean
+  double relative_change;
+  /// two-sided p-value of Welch's t-test of equal means, 1 with less than two repetitions
+  double p_value;
+  Verdict verdict;
+};
+
+/// \brief Returns the two-sided p-value of Welch's t-test whether the samples have the same mean.
+double ComputeWelchTTestPValue(const PerformanceSample& a, const PerformanceSample& b);
+
+/// \brief Compares the benchmarks contained in both \p baseline and \p current.
+std::vector<PerformanceChange> ComparePerformance(const PerformanceSamples& baseline,
+                                                  const PerformanceSamples& current,
+                                                  const PerformanceComparisonOptions& options = {});
+
+/// \brief Prints the regressions and improvements followed by the number of unchanged benchmarks.
+std::string PrintPerformanceChanges(const std::vector<PerformanceChange>& changes);
+
+}  // namespace encrypto::motion
@@ -22,6 +22,7 @@
 
 #include "run_time_statistics.h"
 #include <fmt/format.h>
+#include <sys/resource.h>
 #include <cmath>
 #include <sstream>
 #include <string>
@@ -33,6 +34,14 @@ static double ToMilliseconds(const RunTimeStatistics::TimePointPair& tpp) {
   return milliseconds.count();
 }
 
+void RunTimeStatistics::RecordPeakResidentSetSize() {
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // ru_maxrss is given in kilobytes
+    peak_resident_set_size = static_cast<std::size_t>(usage.ru_maxrss);
+  }
+}
+
 const RunTimeStatistics::TimePointPair& RunTimeStatistics::Get(StatisticsId id) const {
   return data.at(static_cast<std::size_t>(id));
 }
@@ -76,7 +85,10 @@ std::string RunTimeStatistics::PrintHumanReadable() const {
                     At(milliseconds, StatisticsId::kGatesOnline), width)
      << fmt::format("-------------------------\n")
      << fmt::format("Circuit Evaluation  {:{}.3f} ms\n", At(milliseconds, StatisticsId::kEvaluate),
-                    width);
+                    width)
+     << fmt::format("Fiber Steals/Parks  {} / {}\n", number_of_steals, number_of_parks)
+     << fmt::format("Released Wire Data  {} B\n", number_of_released_wire_bytes)
+     << fmt::format("Peak RSS            {} KiB\n", peak_resident_set_size);
   return ss.str();
 }
 
@@ -24,11 +24,16 @@
 
 #include <array>
 #include <chrono>
+#include <memory>
 #include <string>
 #include <utility>
 
 namespace encrypto::motion {
 
+struct ContentionReport;
+struct GateProfile;
+struct TuningDecision;
+
 struct RunTimeStatistics {
   using ClockType = std::chrono::steady_clock;
   using TimePoint = std::chrono::time_point<ClockType>;
@@ -70,6 +75,27 @@ struct RunTimeStatistics {
   std::string PrintHumanReadable() const;
 
   std::array<TimePointPair, static_cast<std::size_t>(StatisticsId::kMax) + 1> data;
+
+  // scheduler statistics of the fiber pool evaluating the gates
+  std::size_t number_of_steals = 0;
+  std::size_t number_of_parks = 0;
+
+  // memory statistics of the evaluation
+  std::size_t number_of_released_wire_bytes = 0;
+  std::size_t peak_resident_set_size = 0;  // in KiB, for the whole process
+
+  void RecordPeakResidentSetSize();
+
+  // times of the individual gates, only recorded if Configuration::SetProfileGates is enabled
+  std::shared_ptr<const GateProfile> gate_profile;
+
+  // where fibers blocked during the evaluation, only recorded if Configuration::SetTraceContention
+  // is enabled
+  std::shared_ptr<const ContentionReport> contention_report;
+
+  // the configuration chosen before the evaluation, only recorded if Configuration::SetAutoTune is
+  // enabled
+  std::shared_ptr<const TuningDecision> tuning_decision;
 };
 
 }  // namespace encrypto::motion
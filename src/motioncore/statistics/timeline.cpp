@@ -0,0 +1,207 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "timeline.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#include <boost/json.hpp>
+#include <fmt/format.h>
+
+#include "communication/message.h"
+#include "gate_profile.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+using StatisticsId = RunTimeStatistics::StatisticsId;
+
+constexpr std::array<const char*, static_cast<std::size_t>(StatisticsId::kMax)> kPhaseNames{
+    "MT Presetup",   "MT Setup",           "SB Presetup",             "SB Setup",
+    "SP Presetup",   "SP Setup",           "OT Extension Setup",      "KK13 OT Extension Setup",
+    "Preprocessing", "Gates Setup",        "Gates Online",            "Circuit Evaluation",
+    "Base OTs"};
+
+// rows of the messages exchanged with party i are kMessageRowOffset + i
+constexpr std::size_t kMessageRowOffset{1000};
+
+// the same on all parties, unlike std::hash, and small enough to be represented exactly in JSON
+std::uint64_t GetFlowId(std::size_t sender_id, std::size_t receiver_id,
+                        communication::MessageType message_type, std::uint64_t message_id,
+                        std::size_t occurrence) {
+  std::uint64_t hash{0xcbf29ce484222325};
+  for (auto value : {std::uint64_t(sender_id), std::uint64_t(receiver_id),
+                     std::uint64_t(message_type), message_id, std::uint64_t(occurrence)}) {
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+      hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 0x100000001b3;
+    }
+  }
+  return hash & ((std::uint64_t(1) << 53) - 1);
+}
+
+boost::json::object MakeThreadName(std::size_t party_id, std::size_t row, std::string name) {
+  return boost::json::object({{"name", "thread_name"},
+                              {"ph", "M"},
+                              {"pid", party_id},
+                              {"tid", row},
+                              {"args", boost::json::object({{"name", std::move(name)}})}});
+}
+
+}  // namespace
+
+std::string PartyTimeline::ToChromeTrace() const {
+  const auto to_microseconds = [this](auto time) {
+    return std::chrono::duration<double, std::micro>(time.time_since_epoch() - clock_offset)
+        .count();
+  };
+  const auto to_duration = [](auto duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+
+  boost::json::array trace_events;
+  trace_events.emplace_back(boost::json::object(
+      {{"name", "process_name"},
+       {"ph", "M"},
+       {"pid", party_id},
+       {"args", boost::json::object({{"name", fmt::format("party {}", party_id)}})}}));
+  trace_events.emplace_back(MakeThreadName(party_id, 0, "phases"));
+
+  std::unordered_map<std::thread::id, std::size_t> thread_numbers;
+  for (std::size_t run = 0; run < statistics.size(); ++run) {
+    const auto& run_statistics{statistics[run]};
+    for (std::size_t id = 0; id < kPhaseNames.size(); ++id) {
+      const auto& [start, end]{run_statistics.data[id]};
+      // phases that did not take place in this run
+      if (start == RunTimeStatistics::TimePoint{} || end < start) continue;
+      trace_events.emplace_back(
+          boost::json::object({{"name", kPhaseNames[id]},
+                               {"cat", "phase"},
+                               {"ph", "X"},
+                               {"ts", to_microseconds(start)},
+                               {"dur", to_duration(end - start)},
+                               {"pid", party_id},
+                               {"tid", 0},
+                               {"args", boost::json::object({{"run", run}})}}));
+    }
+    if (!run_statistics.gate_profile) continue;
+    for (const auto& event : run_statistics.gate_profile->events) {
+      const auto [thread_number, is_new]{
+          thread_numbers.try_emplace(event.thread_id, thread_numbers.size() + 1)};
+      if (is_new) {
+        trace_events.emplace_back(MakeThreadName(party_id, thread_number->second,
+                                                 fmt::format("gates {}", thread_number->second)));
+      }
+      trace_events.emplace_back(boost::json::object(
+          {{"name", event.gate_type},
+           {"cat", to_string(event.phase)},
+           {"ph", "X"},
+           {"ts", to_microseconds(event.start)},
+           {"dur", to_duration(event.end - event.start)},
+           {"pid", party_id},
+           {"tid", thread_number->second},
+           {"args", boost::json::object(
+                        {{"run", run},
+                         {"gate_id", event.gate_id},
+                         {"compute_us", to_duration(event.GetComputeTime())},
+                         {"message_wait_us", to_duration(event.wait_times.messages)}})}}));
+    }
+  }
+
+  using Direction = communication::MessageTrace::Direction;
+  // the n-th message of a type and id from a sender to a receiver is the n-th one received
+  std::map<std::tuple<std::size_t, Direction, communication::MessageType, std::uint64_t>,
+           std::size_t>
+      occurrences;
+  std::vector<bool> has_message_row;
+  for (const auto& event : message_trace.events) {
+    const bool is_sent{event.direction == Direction::kSent};
+    const auto row{kMessageRowOffset + event.party_id};
+    if (has_message_row.size() <= event.party_id) has_message_row.resize(event.party_id + 1);
+    if (!has_message_row[event.party_id]) {
+      has_message_row[event.party_id] = true;
+      trace_events.emplace_back(
+          MakeThreadName(party_id, row, fmt::format("messages with party {}", event.party_id)));
+    }
+    const auto ts{to_microseconds(event.time)};
+    trace_events.emplace_back(boost::json::object(
+        {{"name", communication::to_string(event.message_type)},
+         {"cat", is_sent ? "sent" : "received"},
+         {"ph", "X"},
+         {"ts", ts},
+         {"dur", 0},
+         {"pid", party_id},
+         {"tid", row},
+         {"args", boost::json::object({{"message_id", event.message_id},
+                                       {"bytes", event.number_of_bytes}})}}));
+    const auto occurrence{occurrences[{event.party_id, event.direction, event.message_type,
+                                       event.message_id}]++};
+    const auto sender_id{is_sent ? party_id : event.party_id};
+    const auto receiver_id{is_sent ? event.party_id : party_id};
+    boost::json::object flow({{"name", "message"},
+                              {"cat", "message"},
+                              {"ph", is_sent ? "s" : "f"},
+                              {"id", GetFlowId(sender_id, receiver_id, event.message_type,
+                                               event.message_id, occurrence)},
+                              {"ts", ts},
+                              {"pid", party_id},
+                              {"tid", row}});
+    // bind the end of the flow to the event of the receive
+    if (!is_sent) flow.emplace("bp", "e");
+    trace_events.emplace_back(std::move(flow));
+  }
+
+  return boost::json::serialize(
+      boost::json::object({{"traceEvents", std::move(trace_events)}, {"displayTimeUnit", "ms"}}));
+}
+
+std::string MergeChromeTraces(std::span<const std::string> traces) {
+  std::vector<boost::json::object> events;
+  double first_ts{std::numeric_limits<double>::max()};
+  for (const auto& trace : traces) {
+    for (const auto& event : boost::json::parse(trace).as_object().at("traceEvents").as_array()) {
+      const auto& object{events.emplace_back(event.as_object())};
+      if (const auto ts{object.if_contains("ts")}) {
+        first_ts = std::min(first_ts, ts->to_number<double>());
+      }
+    }
+  }
+  boost::json::array trace_events;
+  trace_events.reserve(events.size());
+  for (auto& event : events) {
+    if (const auto ts{event.if_contains("ts")}) {
+      event["ts"] = ts->to_number<double>() - first_ts;
+    }
+    trace_events.emplace_back(std::move(event));
+  }
+  return boost::json::serialize(
+      boost::json::object({{"traceEvents", std::move(trace_events)}, {"displayTimeUnit", "ms"}}));
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,60 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "communication/message_trace.h"
+#include "run_time_statistics.h"
+
+namespace encrypto::motion {
+
+// What one party recorded during its evaluations, which is merged with the timelines of the other
+// parties into a single trace to see, e.g., how the garbling of party 0 lines up with the waiting
+// of party 1. See Configuration::SetRecordTimeline and Backend::TakeTimeline.
+struct PartyTimeline {
+  std::size_t party_id{0};
+  // clock of this party minus the clock of party 0 at the same instant, which is subtracted from
+  // all times of this party, see CommunicationLayer::EstimateClockOffsets
+  std::chrono::nanoseconds clock_offset{0};
+  std::vector<RunTimeStatistics> statistics;
+  communication::MessageTrace message_trace;
+
+  // Serializes the timeline in the Chrome trace event format with the times on the clock of party
+  // 0 in microseconds since its epoch. The party is the process of the trace with a row for the
+  // phases of the evaluations, one row per thread evaluating gates if they were profiled (see
+  // Configuration::SetProfileGates), and one row per other party for the messages exchanged with
+  // it. Sent and received messages are connected by flow events, which only match up once the
+  // traces of both parties are merged by MergeChromeTraces.
+  std::string ToChromeTrace() const;
+};
+
+// Merges the Chrome traces of PartyTimeline::ToChromeTrace of all parties into one timeline which
+// starts at 0.
+std::string MergeChromeTraces(std::span<const std::string> traces);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,46 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+
+namespace encrypto::motion {
+
+namespace detail {
+
+inline thread_local std::size_t thread_allocated_bytes{0};
+
+}  // namespace detail
+
+// Counts heap allocations of the calling thread for the object accounting of the Register (see
+// ObjectAccounting). The library does not replace the global operator new, since this is up to the
+// application, e.g., a benchmark, whose replacement reports each allocation with this function.
+inline void CountThreadAllocation(std::size_t bytes) noexcept {
+  detail::thread_allocated_bytes += bytes;
+}
+
+// bytes reported by CountThreadAllocation() in the calling thread, 0 if the application does not
+// report its allocations
+inline std::size_t GetThreadAllocatedBytes() noexcept { return detail::thread_allocated_bytes; }
+
+}  // namespace encrypto::motion
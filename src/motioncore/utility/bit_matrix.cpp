@@ -26,124 +26,247 @@
 
 #include <immintrin.h>
 #include <omp.h>
+#include <boost/align/aligned_allocator.hpp>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
+#include <fmt/format.h>
+
 #include "helpers.h"
 #include "primitives/pseudo_random_generator.h"
 
 namespace encrypto::motion {
 
-void BitMatrix::Transpose() {
-  std::size_t number_of_rows = data_.size();
-  if (number_of_rows == 0 || number_of_columns_ == 0 ||
-      (number_of_rows == 1 && number_of_columns_ == 1)) {
-    return;
-  } else if (number_of_rows == 1) {
-    for (auto i = 1ull; i < number_of_columns_; ++i) {
-      data_.emplace_back(1, data_.at(0).Get(i));
-    }
-    data_.at(0).Resize(1, true);
-    return;
-  } else if (number_of_columns_ == 1) {
-    for (auto i = 1ull; i < number_of_rows; ++i) {
-      data_.at(0).Append(data_.at(i));
-    }
-    data_.resize(1);
-    return;
-  }
+namespace {
 
-  const std::size_t block_size_unpadded = std::min(number_of_rows, number_of_columns_);
-  const std::size_t block_size = static_cast<std::size_t>(pow(2, ceil(log2(block_size_unpadded))));
-  const std::size_t initial_number_of_columns = number_of_columns_;
-  const std::size_t initial_number_of_rows = data_.size();
+// The bit-sliced transpositions process 8 columns of a group of rows at a time: one byte of each
+// row is loaded into a vector register, then each movemask extracts the most significant bits,
+// i.e., one column of these rows, after which the register is shifted by one bit.
 
-  // pad to the block size
-  if (number_of_columns_ % block_size > 0u) {
-    for (auto& block_vector : data_) {
-      block_vector.Resize(number_of_columns_ + block_size - (number_of_columns_ % block_size),
-                          true);
+template <std::size_t kNumberOfRows>
+void TransposeBlockSse(const std::array<const std::byte*, kNumberOfRows>& matrix,
+                       std::size_t column_begin, std::size_t column_end,
+                       std::byte* const* columns) {
+  auto inp = [&matrix](auto r, auto c) {
+    return reinterpret_cast<const std::uint8_t* __restrict__>(
+        __builtin_assume_aligned(matrix[r], 16))[c / 8];
+  };
+  for (std::size_t r = 0; r < kNumberOfRows; r += 16) {
+    for (auto c = column_begin; c < column_end; c += 8) {
+      __m128i vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
+                                 inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
+                                 inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
+                                 inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
+      for (int i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
+        *reinterpret_cast<std::uint16_t* __restrict__>(columns[c - column_begin + 7 - i] + r / 8) =
+            _mm_movemask_epi8(vec);
+      }
     }
   }
+}
 
-  if (data_.size() % block_size > 0u) {
-    AlignedBitVector tmp(data_.at(0).GetSize());
-    data_.resize(data_.size() + block_size - (data_.size() % block_size), tmp);
+template <std::size_t kNumberOfRows>
+__attribute__((target("avx2"))) void TransposeBlockAvx2(
+    const std::array<const std::byte*, kNumberOfRows>& matrix, std::size_t column_begin,
+    std::size_t column_end, std::byte* const* columns) {
+  alignas(32) std::array<std::uint8_t, 32> bytes;
+  for (std::size_t r = 0; r < kNumberOfRows; r += bytes.size()) {
+    for (auto c = column_begin; c < column_end; c += 8) {
+      for (std::size_t k = 0; k < bytes.size(); ++k) {
+        bytes[k] = std::to_integer<std::uint8_t>(matrix[r + k][c / 8]);
+      }
+      __m256i vec = _mm256_load_si256(reinterpret_cast<const __m256i*>(bytes.data()));
+      for (int i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
+        *reinterpret_cast<std::uint32_t* __restrict__>(columns[c - column_begin + 7 - i] + r / 8) =
+            static_cast<std::uint32_t>(_mm256_movemask_epi8(vec));
+      }
+    }
   }
+}
 
-  // move the first blocks manually to reduce the memory overhead - prevent padding to a square
-  if (number_of_columns_ > number_of_rows) {
-    for (auto i = block_size; i < number_of_columns_; i += block_size) {
-#pragma omp for
-      for (auto j = 0ull; j < block_size; ++j) {
-        data_.emplace_back(data_.at(j).Subset(i, i + block_size));
+template <std::size_t kNumberOfRows>
+__attribute__((target("avx512f,avx512bw"))) void TransposeBlockAvx512(
+    const std::array<const std::byte*, kNumberOfRows>& matrix, std::size_t column_begin,
+    std::size_t column_end, std::byte* const* columns) {
+  alignas(64) std::array<std::uint8_t, 64> bytes;
+  for (std::size_t r = 0; r < kNumberOfRows; r += bytes.size()) {
+    for (auto c = column_begin; c < column_end; c += 8) {
+      for (std::size_t k = 0; k < bytes.size(); ++k) {
+        bytes[k] = std::to_integer<std::uint8_t>(matrix[r + k][c / 8]);
       }
-    }
-#pragma omp for
-    for (auto i = 0ull; i < block_size; ++i) {
-      data_.at(i).Resize(block_size, true);
-    }
-  } else if (number_of_columns_ < number_of_rows) {
-    for (auto i = block_size; i < data_.size(); i += block_size) {
-#pragma omp for
-      for (auto j = 0ull; j < block_size; ++j) {
-        data_.at(j).Append(data_.at(i + j));
+      __m512i vec = _mm512_load_si512(bytes.data());
+      for (int i = 0; i < 8; vec = _mm512_slli_epi64(vec, 1), ++i) {
+        *reinterpret_cast<std::uint64_t* __restrict__>(columns[c - column_begin + 7 - i] + r / 8) =
+            _mm512_movepi8_mask(vec);
       }
     }
-    data_.resize(block_size);
   }
+}
 
-  TransposeInternal();
+BitMatrix::TransposeKernel DetectTransposeKernel() {
+  if (BitMatrix::IsSupported(BitMatrix::TransposeKernel::kAvx512)) {
+    return BitMatrix::TransposeKernel::kAvx512;
+  }
+  if (BitMatrix::IsSupported(BitMatrix::TransposeKernel::kAvx2)) {
+    return BitMatrix::TransposeKernel::kAvx2;
+  }
+  return BitMatrix::TransposeKernel::kSse;
+}
 
-  // remove padding
-  data_.resize(initial_number_of_columns);
+std::atomic<BitMatrix::TransposeKernel>& GetSelectedTransposeKernel() {
+  static std::atomic<BitMatrix::TransposeKernel> kernel{DetectTransposeKernel()};
+  return kernel;
+}
 
-  for (auto& block_vector : data_) {
-    block_vector.Resize(initial_number_of_rows, true);
+// Transposes the columns [column_begin, column_end) of the matrix, where column_end - column_begin
+// must be a multiple of 8, and writes kNumberOfRows / 8 bytes to columns[c - column_begin] for
+// every column c
+template <std::size_t kNumberOfRows>
+void TransposeBlock(const std::array<const std::byte*, kNumberOfRows>& matrix,
+                    std::size_t column_begin, std::size_t column_end, std::byte* const* columns) {
+  switch (GetSelectedTransposeKernel().load(std::memory_order_relaxed)) {
+    case BitMatrix::TransposeKernel::kAvx512:
+      TransposeBlockAvx512(matrix, column_begin, column_end, columns);
+      break;
+    case BitMatrix::TransposeKernel::kAvx2:
+      TransposeBlockAvx2(matrix, column_begin, column_end, columns);
+      break;
+    default:
+      TransposeBlockSse(matrix, column_begin, column_end, columns);
   }
+}
 
-  number_of_columns_ = initial_number_of_rows;
+// The general transposition recursively halves the longer side of the matrix at a multiple of 64
+// until a block has at most 64 rows and 64 columns, which is then transposed in registers. Hence,
+// the blocks of the recursion fit into ever smaller cache levels independently of their sizes,
+// and no padding to a power of two is needed.
+constexpr std::size_t kWordBits{64};
+
+// Transposes the 64x64 bit matrix given by the words of block, where bit j of block[i] is the bit
+// in row i and column j, by swapping the off-diagonal half blocks of ever smaller sizes
+void Transpose64x64(std::array<std::uint64_t, kWordBits>& block) {
+  std::uint64_t mask{0x00000000FFFFFFFF};
+  for (std::size_t j = 32; j > 0; j >>= 1, mask ^= mask << j) {
+    for (std::size_t k = 0; k < kWordBits; k = ((k | j) + 1) & ~j) {
+      const std::uint64_t t{((block[k] >> j) ^ block[k | j]) & mask};
+      block[k] ^= t << j;
+      block[k | j] ^= t;
+    }
+  }
 }
 
-void BitMatrix::TransposeInternal() {
-  for (auto block_size = std::min(data_.size(), data_.at(0).GetSize()); block_size > 1u;
-       block_size /= 2) {
-    const auto subblock_size = block_size / 2;
-    for (auto column_i = 0ull; column_i + subblock_size < data_.at(0).GetSize();
-         column_i += block_size) {
-      for (auto row_i = 0ull; row_i + subblock_size < data_.size(); row_i += block_size) {
-        auto subblock_1_row_offset = row_i + subblock_size;
-        auto subblock_1_column_offset = column_i;
-
-        auto subblock_2_row_offset = row_i;
-        auto subblock_2_column_offset = column_i + subblock_size;
-
-        if (subblock_size > 1u) {
-          for (auto i = 0ull; i < subblock_size; ++i) {
-            BitVector block_1 =
-                data_.at(subblock_1_row_offset + i)
-                    .Subset(subblock_1_column_offset, subblock_1_column_offset + subblock_size);
-            BitVector block_2 =
-                data_.at(subblock_2_row_offset + i)
-                    .Subset(subblock_2_column_offset, subblock_2_column_offset + subblock_size);
-
-            data_.at(subblock_2_row_offset + i)
-                .Copy(subblock_2_column_offset, subblock_2_column_offset + subblock_size, block_1);
-
-            data_.at(subblock_1_row_offset + i)
-                .Copy(subblock_1_column_offset, subblock_1_column_offset + subblock_size, block_2);
-          }
-        } else {
-          bool bit_1 = Get(subblock_1_row_offset, subblock_1_column_offset);
-          bool bit_2 = Get(subblock_2_row_offset, subblock_2_column_offset);
-          Set(subblock_1_row_offset, subblock_1_column_offset, bit_2);
-          Set(subblock_2_row_offset, subblock_2_column_offset, bit_1);
-        }
-      }
+// Transposes the block of rows [row_begin, row_end) and columns [column_begin, column_end) of the
+// matrix given by its rows into the columns of the transposed matrix
+void TransposeRecursive(std::span<const std::byte* const> rows, std::span<std::byte* const> columns,
+                        std::size_t row_begin, std::size_t row_end, std::size_t column_begin,
+                        std::size_t column_end) {
+  const std::size_t number_of_rows{row_end - row_begin};
+  const std::size_t number_of_columns{column_end - column_begin};
+  if (number_of_rows > kWordBits || number_of_columns > kWordBits) {
+    if (number_of_rows >= number_of_columns) {
+      const std::size_t middle{row_begin +
+                               (number_of_rows / 2 + kWordBits - 1) / kWordBits * kWordBits};
+      TransposeRecursive(rows, columns, row_begin, middle, column_begin, column_end);
+      TransposeRecursive(rows, columns, middle, row_end, column_begin, column_end);
+    } else {
+      const std::size_t middle{column_begin +
+                               (number_of_columns / 2 + kWordBits - 1) / kWordBits * kWordBits};
+      TransposeRecursive(rows, columns, row_begin, row_end, column_begin, middle);
+      TransposeRecursive(rows, columns, row_begin, row_end, middle, column_end);
+    }
+    return;
+  }
+
+  // row_begin and column_begin are multiples of 64, so only the last block of a row or column
+  // has less than 8 bytes
+  std::array<std::uint64_t, kWordBits> block{};
+  const std::size_t column_bytes{(number_of_columns + 7) / 8};
+  for (std::size_t i = 0; i < number_of_rows; ++i) {
+    const std::byte* source{rows[row_begin + i] + column_begin / 8};
+    if (number_of_columns == kWordBits) {
+      std::memcpy(&block[i], source, sizeof(std::uint64_t));
+    } else {
+      std::memcpy(&block[i], source, column_bytes);
+      block[i] &= (std::uint64_t(1) << number_of_columns) - 1;
+    }
+  }
+  Transpose64x64(block);
+  const std::size_t row_bytes{(number_of_rows + 7) / 8};
+  for (std::size_t j = 0; j < number_of_columns; ++j) {
+    std::byte* destination{columns[column_begin + j] + row_begin / 8};
+    if (number_of_rows == kWordBits) {
+      std::memcpy(destination, &block[j], sizeof(std::uint64_t));
+    } else {
+      std::memcpy(destination, &block[j], row_bytes);
     }
   }
 }
 
+}  // namespace
+
+bool BitMatrix::IsSupported(TransposeKernel kernel) {
+  __builtin_cpu_init();
+  switch (kernel) {
+    case TransposeKernel::kSse:
+      return true;
+    case TransposeKernel::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case TransposeKernel::kAvx512:
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+  }
+  return false;
+}
+
+BitMatrix::TransposeKernel BitMatrix::GetTransposeKernel() {
+  return GetSelectedTransposeKernel().load();
+}
+
+void BitMatrix::SetTransposeKernel(TransposeKernel kernel) {
+  if (!IsSupported(kernel)) {
+    throw std::invalid_argument(fmt::format("Transpose kernel {} is not supported by this CPU",
+                                            static_cast<unsigned int>(kernel)));
+  }
+  GetSelectedTransposeKernel().store(kernel);
+}
+
+void BitMatrix::Transpose() {
+  const std::size_t number_of_rows{data_.size()};
+  if (number_of_rows == 0 || number_of_columns_ == 0 ||
+      (number_of_rows == 1 && number_of_columns_ == 1)) {
+    return;
+  }
+
+  std::vector<AlignedBitVector> transposed(number_of_columns_);
+  std::vector<const std::byte*> rows(number_of_rows);
+  std::vector<std::byte*> columns(number_of_columns_);
+  for (std::size_t i = 0; i < number_of_rows; ++i) {
+    rows[i] = data_[i].GetData().data();
+  }
+  for (std::size_t j = 0; j < number_of_columns_; ++j) {
+    transposed[j] = AlignedBitVector(number_of_rows);
+    columns[j] = transposed[j].GetMutableData().data();
+  }
+
+  // the threads transpose disjoint stripes of columns, i.e., write disjoint rows of the result
+  const std::size_t number_of_threads{static_cast<std::size_t>(omp_get_max_threads())};
+  const std::size_t number_of_words{(number_of_columns_ + kWordBits - 1) / kWordBits};
+  const std::size_t stripe_size{(number_of_words + number_of_threads - 1) / number_of_threads *
+                                kWordBits};
+  const std::size_t number_of_stripes{(number_of_columns_ + stripe_size - 1) / stripe_size};
+  constexpr std::size_t kMinimumParallelBits{1 << 20};
+#pragma omp parallel for num_threads(number_of_threads) \
+    if (number_of_stripes > 1 && number_of_rows * number_of_columns_ >= kMinimumParallelBits)
+  for (std::size_t s = 0; s < number_of_stripes; ++s) {
+    TransposeRecursive(rows, columns, 0, number_of_rows, s * stripe_size,
+                       std::min((s + 1) * stripe_size, number_of_columns_));
+  }
+
+  data_ = std::move(transposed);
+  number_of_columns_ = number_of_rows;
+}
+
 void BitMatrix::Transpose128Rows() {
   if constexpr (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__) {
     throw std::runtime_error("Little endian encoding is required for BitMatrix::Transpose128");
@@ -200,60 +323,10 @@ void BitMatrix::Transpose128Rows() {
 }
 
 void BitMatrix::Transpose256Columns() {
-  std::size_t number_of_rows = data_.size();
-  if (number_of_rows == 0 || number_of_columns_ != 256) {
-    return;
-  } else if (number_of_rows == 1) {
-    for (std::size_t i = 1; i < number_of_columns_; i++) {
-      data_.emplace_back(1, data_.at(0).Get(i));
-    }
-    data_.at(0).Resize(1, true);
+  if (number_of_columns_ != 256) {
     return;
   }
-
-  constexpr std::size_t block_size = 256;
-  const std::size_t initial_number_of_columns = number_of_columns_;
-  const std::size_t initial_number_of_rows = data_.size();
-
-  if (data_.size() % block_size > 0u) {
-    AlignedBitVector tmp(block_size);
-    data_.resize(data_.size() + block_size - (data_.size() % block_size), tmp);
-  }
-
-  std::size_t i, j;
-
-  // move the first blocks manually to reduce the memory overhead - prevent padding to a square
-  if (number_of_columns_ > number_of_rows) {
-    for (i = block_size; i < number_of_columns_; i += block_size) {
-#pragma omp for
-      for (j = 0; j < block_size; ++j) {
-        data_.emplace_back(data_.at(j).Subset(i, i + block_size));
-      }
-    }
-#pragma omp for
-    for (i = 0; i < block_size; ++i) {
-      data_.at(i).Resize(block_size, true);
-    }
-  } else if (number_of_columns_ < number_of_rows) {
-    for (i = block_size; i < data_.size(); i += block_size) {
-#pragma omp for
-      for (j = 0; j < block_size; ++j) {
-        data_.at(j).Append(data_.at(i + j));
-      }
-    }
-    data_.resize(block_size);
-  }
-
-  TransposeInternal();
-
-  // remove padding
-  data_.resize(initial_number_of_columns);
-
-  for (auto& block_vector : data_) {
-    block_vector.Resize(initial_number_of_rows, true);
-  }
-
-  number_of_columns_ = initial_number_of_rows;
+  Transpose();
 }
 
 void BitMatrix::Transpose128RowsInternal() {
@@ -469,34 +542,23 @@ void BitMatrix::Transpose128x128InPlace(std::array<std::uint64_t*, 128>& rows_64
 
 void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix,
                                          std::size_t number_of_colums) {
-  auto inp = [&matrix](auto r, auto c) {
-    return reinterpret_cast<const std::uint8_t* __restrict__>(
-        __builtin_assume_aligned(matrix.at(r), 16))[c / 8];
-  };
-
   constexpr std::uint64_t kNumberOfRows = 128;
   std::vector<std::uint8_t, boost::alignment::aligned_allocator<std::uint8_t, 16>> output(
       ((kNumberOfRows * number_of_colums) + 7) / 8, 0);
 
-  auto out = [&output](auto r, auto c) { return &output[(r)*kNumberOfRows / 8 + (c) / 8]; };
-
-  uint64_t rr, cc;
-  int i;
-
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
-  // Do the main body in 16x8 blocks:
-  for (rr = 0; rr <= kNumberOfRows - 16; rr += 16) {
-    for (cc = 0; cc < number_of_colums; cc += 8) {
-      vec = _mm_set_epi8(inp(rr + 15, cc), inp(rr + 14, cc), inp(rr + 13, cc), inp(rr + 12, cc),
-                         inp(rr + 11, cc), inp(rr + 10, cc), inp(rr + 9, cc), inp(rr + 8, cc),
-                         inp(rr + 7, cc), inp(rr + 6, cc), inp(rr + 5, cc), inp(rr + 4, cc),
-                         inp(rr + 3, cc), inp(rr + 2, cc), inp(rr + 1, cc), inp(rr + 0, cc));
-      for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-        *(uint16_t* __restrict__)out(cc + 7 - i, rr) = _mm_movemask_epi8(vec);
-      }
-    }
+  std::array<const std::byte*, kNumberOfRows> rows;
+  std::copy(matrix.begin(), matrix.end(), rows.begin());
+
+  // column j of the matrix is stored in the 16 bytes of the output starting at offset 16 j
+  std::vector<std::byte*> columns(number_of_colums);
+  for (std::size_t j = 0; j < number_of_colums; ++j) {
+    columns[j] = reinterpret_cast<std::byte*>(output.data()) + j * kNumberOfRows / 8;
+  }
+  for (std::size_t c = 0; c < number_of_colums; c += kNumberOfRows) {
+    TransposeBlock(rows, c, std::min<std::size_t>(c + kNumberOfRows, number_of_colums),
+                   columns.data() + c);
   }
 
   for (auto j = 0ull; j < number_of_colums; ++j) {
@@ -514,12 +576,9 @@ void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix,
 void BitMatrix::SenderTranspose128AndEncrypt(
     const std::array<const std::byte*, 128>& matrix, std::vector<BitVector<>>& y0,
     std::vector<BitVector<>>& y1, const BitVector<> choices, primitives::Prg& prg_fixed_key,
-    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths) {
+    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths,
+    const std::size_t number_of_threads, const std::size_t tweak_offset) {
   constexpr std::size_t kKappa{128}, kNumberOfRows{128};
-  auto inp = [&matrix](auto r, auto c) {
-    return reinterpret_cast<const std::uint8_t* __restrict__>(
-        __builtin_assume_aligned(matrix.at(r), 16))[c / 8];
-  };
   assert(y0.size() == y1.size());
 
   const std::size_t original_size{y0.size()}, difference{number_of_colums - original_size};
@@ -528,57 +587,52 @@ void BitMatrix::SenderTranspose128AndEncrypt(
     y1.resize(number_of_colums);
   }
 
-  for (auto& block_vector : y0)
-    block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
-  primitives::Prg prg_var_key;
-  // process 128x128 blocks
-  while (c < number_of_colums) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(y0[c + 7 - i].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
-      }
-    }
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      auto& out0 = y0[c_old];
-      auto& out1 = y1[c_old];
+  const std::size_t number_of_blocks{(number_of_colums + kKappa - 1) / kKappa};
+
+  // process 128x128 blocks, which are independent of each other
+#pragma omp parallel for num_threads(number_of_threads) schedule(static)
+  for (std::size_t block = 0; block < number_of_blocks; ++block) {
+    const std::size_t block_begin{block * kKappa};
+    const std::size_t block_end{std::min(block_begin + kKappa, number_of_colums)};
+    std::array<std::byte*, kNumberOfRows> columns;
+    for (auto c = block_begin; c < block_end; ++c) {
+      y0[c] = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
+      columns[c - block_begin] = y0[c].GetMutableData().data();
+    }
+    TransposeBlock(matrix, block_begin, block_end, columns.data());
+    // hash the outputs with fixed-key AES in batches, using the index of the OT as tweak
+    const std::size_t number_of_hashes{std::max(std::min(block_end, original_size), block_begin) -
+                                       block_begin};
+    std::array<std::byte*, kNumberOfRows> columns_1;
+    for (std::size_t i = 0; i < number_of_hashes; ++i) {
+      y1[block_begin + i] = choices ^ y0[block_begin + i];
+      assert(y1[block_begin + i].GetSize() == 128);
+      columns_1[i] = y1[block_begin + i].GetMutableData().data();
+    }
+    prg_fixed_key.Tmmo(columns.data(), number_of_hashes, tweak_offset + block_begin);
+    prg_fixed_key.Tmmo(columns_1.data(), number_of_hashes, tweak_offset + block_begin);
+    primitives::Prg prg_var_key;
+    for (auto c = block_begin; c < block_begin + number_of_hashes; ++c) {
+      auto& out0 = y0[c];
+      auto& out1 = y1[c];
 
       // bit length of the OT
-      const auto bitlength = bitlengths[c_old];
+      const auto bitlength = bitlengths[c];
 
-      out1 = choices ^ out0;
-      assert(out0.GetSize() == 128);
-      assert(out1.GetSize() == 128);
       // compute the sender outputs
       if (bitlength <= kKappa) {
         // the bit length is smaller than 128 bit
-        prg_fixed_key.Mmo(out0.GetMutableData().data());
-        prg_fixed_key.Mmo(out1.GetMutableData().data());
         out0.Resize(bitlength);
         out1.Resize(bitlength);
       } else {
         // string OT with bit length > 128 bit
         // -> do seed compression and send later only 128 bit seeds
-        prg_fixed_key.Mmo(out0.GetMutableData().data());
-        prg_fixed_key.Mmo(out1.GetMutableData().data());
         prg_var_key.SetKey(out0.GetData().data());
-        out0 = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+        out0 = prg_var_key.KeyStreamBits(bitlength);
         prg_var_key.SetKey(out1.GetData().data());
-        out1 = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+        out1 = prg_var_key.KeyStreamBits(bitlength);
       }
     }
   }
@@ -588,70 +642,66 @@ void BitMatrix::ReceiverTranspose128AndEncrypt(const std::array<const std::byte*
                                                std::vector<BitVector<>>& output,
                                                primitives::Prg& prg_fixed_key,
                                                const std::size_t number_of_colums,
-                                               const std::vector<std::size_t>& bitlengths) {
+                                               const std::vector<std::size_t>& bitlengths,
+                                               const std::size_t number_of_threads,
+                                               const std::size_t tweak_offset) {
   constexpr std::size_t kKappa{128}, kNumberOfRows{128};
-  auto inp = [&matrix](auto r, auto c) {
-    return reinterpret_cast<const std::uint8_t* __restrict__>(
-        __builtin_assume_aligned(matrix.at(r), 16))[c / 8];
-  };
 
   const std::size_t original_size{output.size()}, difference{number_of_colums - original_size};
   if (difference) {
     output.resize(number_of_colums);
   }
 
-  for (auto& block_vector : output)
-    block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
-  primitives::Prg prg_var_key;
-  // process 128x128 blocks
-  while (c < number_of_colums) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(output[c + 7 - i].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
-      }
-    }
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      auto& o = output[c_old];
+  const std::size_t number_of_blocks{(number_of_colums + kKappa - 1) / kKappa};
+
+  // process 128x128 blocks, which are independent of each other
+#pragma omp parallel for num_threads(number_of_threads) schedule(static)
+  for (std::size_t block = 0; block < number_of_blocks; ++block) {
+    const std::size_t block_begin{block * kKappa};
+    const std::size_t block_end{std::min(block_begin + kKappa, number_of_colums)};
+    std::array<std::byte*, kNumberOfRows> columns;
+    for (auto c = block_begin; c < block_end; ++c) {
+      output[c] = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
+      columns[c - block_begin] = output[c].GetMutableData().data();
+    }
+    TransposeBlock(matrix, block_begin, block_end, columns.data());
+    // hash the outputs with fixed-key AES in batches, using the index of the OT as tweak
+    const std::size_t number_of_hashes{std::max(std::min(block_end, original_size), block_begin) -
+                                       block_begin};
+    prg_fixed_key.Tmmo(columns.data(), number_of_hashes, tweak_offset + block_begin);
+    primitives::Prg prg_var_key;
+    for (auto c = block_begin; c < block_begin + number_of_hashes; ++c) {
+      auto& o = output[c];
       assert(o.GetSize() == 128);
-      const std::size_t bitlength = bitlengths[c_old];
+      const std::size_t bitlength = bitlengths[c];
 
       if (bitlength <= kKappa) {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
         o.Resize(bitlength);
       } else {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
         prg_var_key.SetKey(o.GetData().data());
-        o = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+        o = prg_var_key.KeyStreamBits(bitlength);
       }
     }
   }
 }
 
-void BitMatrix::SenderTranspose256AndEncrypt(
-    const std::array<const std::byte*, 256>& matrix, std::vector<std::vector<BitVector<>>>& y,
-    const BitVector<> choices, std::vector<AlignedBitVector> x_a, primitives::Prg& prg_fixed_key,
-    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths) {
+namespace {
+
+// the KK13 transposes for code words of kCodeBitLength bits, whose outputs are hashed in
+// kCodeBitLength / 128 blocks of 128 bits each
+template <std::size_t kCodeBitLength>
+void SenderTransposeCode(std::span<const std::byte* const> matrix_rows,
+                         std::vector<std::vector<BitVector<>>>& y, const BitVector<>& choices,
+                         const std::vector<AlignedBitVector>& x_a, primitives::Prg& prg_fixed_key,
+                         const std::size_t number_of_colums,
+                         const std::vector<std::size_t>& bitlengths) {
   std::size_t n;
-  constexpr std::size_t kKappa{256}, kNumberOfRows{256};
-  auto inp = [&matrix](auto r, auto c) {
-    return reinterpret_cast<const std::uint8_t* __restrict__>(
-        __builtin_assume_aligned(matrix.at(r), 16))[c / 8];
-  };
+  constexpr std::size_t kNumberOfRows{kCodeBitLength};
+  constexpr std::size_t kNumberOfHashBlocks{kCodeBitLength / (8 * kAesBlockSize)};
+  std::array<const std::byte*, kNumberOfRows> matrix;
+  std::copy(matrix_rows.begin(), matrix_rows.end(), matrix.begin());
 
   const std::size_t original_size = y.at(0).size();
   for (n = 1; n < y.size(); n++) {
@@ -671,123 +721,231 @@ void BitMatrix::SenderTranspose256AndEncrypt(
     choices_and_x_a.push_back(choices & x_a.at(n));
   }
 
-  for (auto& block_vector : y.at(0))
-    block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
   primitives::Prg prg_var_key;
-  // process 256x256 blocks
-  while (c < number_of_colums) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 256 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(
-              y.at(0)[c + 7 - i].GetMutableData().data() + r / 8) = _mm_movemask_epi8(vec);
+  // the transposed block, from which the outputs for all messages are computed directly
+  alignas(kAesBlockSize) std::array<std::array<std::uint64_t, kCodeBitLength / 64>, kNumberOfRows>
+      block;
+  std::array<std::byte*, kNumberOfRows> columns;
+  for (std::size_t i = 0; i < kNumberOfRows; ++i) {
+    columns[i] = reinterpret_cast<std::byte*>(block[i].data());
+  }
+  std::array<std::byte*, kNumberOfHashBlocks * kNumberOfRows> hash_blocks;
+  // process square blocks of the matrix
+  for (std::size_t c = 0; c < number_of_colums; c += kNumberOfRows) {
+    const std::size_t block_end{std::min(c + kNumberOfRows, number_of_colums)};
+    TransposeBlock(matrix, c, block_end, columns.data());
+    const std::size_t number_of_hashes{std::max(std::min(block_end, original_size), c) - c};
+    for (n = 0; n < y.size(); n++) {
+      // y_n = V' ^ (X(n) & r), written in one pass over each transposed row
+      const auto mask{reinterpret_cast<const std::uint64_t*>(choices_and_x_a[n].GetData().data())};
+      for (std::size_t i = 0; i < number_of_hashes; ++i) {
+        auto& output{y[n][c + i]};
+        output = BitVector<>(kCodeBitLength);
+        const auto output_words{reinterpret_cast<std::uint64_t*>(output.GetMutableData().data())};
+        for (std::size_t w = 0; w < kCodeBitLength / 64; ++w) {
+          output_words[w] = block[i][w] ^ mask[w];
+        }
+        for (std::size_t k = 0; k < kNumberOfHashBlocks; ++k) {
+          hash_blocks[kNumberOfHashBlocks * i + k] =
+              output.GetMutableData().data() + k * kAesBlockSize;
         }
       }
+      // hash the 128-bit blocks of the outputs with fixed-key AES in batches, using the index of
+      // the OT times the number of blocks plus the index of the block as tweak
+      prg_fixed_key.Tmmo(hash_blocks.data(), kNumberOfHashBlocks * number_of_hashes,
+                         kNumberOfHashBlocks * c);
     }
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      //  copy the content of y[0] to all y[n]
-      for (n = 0; n < y.size() - 1; n++) {
-        y.at(n + 1)[c_old] = y.at(n)[c_old];
-      }
-
-      for (n = 0; n < y.size(); n++) {
-        y.at(n)[c_old] ^= choices_and_x_a.at(n);
-        assert(y.at(n)[c_old].GetSize() == 256);
-      }
-
+    for (auto c_old = c; c_old < c + number_of_hashes; ++c_old) {
       // bit length of the OT
       const auto bitlength = bitlengths[c_old];
 
       // compute the sender outputs
-      if (bitlength <= kKappa) {
+      if (bitlength <= kCodeBitLength) {
         for (n = 0; n < y.size(); n++) {
-          // the bit length is smaller than 256 bit
-          prg_fixed_key.Mmo(y.at(n)[c_old].GetMutableData().data());
+          // the bit length is smaller than the code
           y.at(n)[c_old].Resize(bitlength);
         }
       } else {
-        // string OT with bit length > 256 bit
-        // -> do seed compression and send later only 256 bit seeds
+        // string OT with a longer bit length
+        // -> do seed compression and send later only the seeds
         for (n = 0; n < y.size(); n++) {
-          prg_fixed_key.Mmo(y.at(n)[c_old].GetMutableData().data());
           prg_var_key.SetKey(y.at(n)[c_old].GetData().data());
-          y.at(n)[c_old] = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+          y.at(n)[c_old] = prg_var_key.KeyStreamBits(bitlength);
         }
       }
     }
   }
 }
 
-void BitMatrix::ReceiverTranspose256AndEncrypt(const std::array<const std::byte*, 256>& matrix,
-                                               std::vector<BitVector<>>& output,
-                                               primitives::Prg& prg_fixed_key,
-                                               const std::size_t number_of_columns,
-                                               const std::vector<std::size_t>& bitlengths) {
-  constexpr std::size_t kKappa{256}, kNumberOfRows{256};
-  auto inp = [&matrix](auto r, auto c) {
-    return reinterpret_cast<const std::uint8_t* __restrict__>(
-        __builtin_assume_aligned(matrix.at(r), 16))[c / 8];
-  };
+template <std::size_t kCodeBitLength>
+void ReceiverTransposeCode(std::span<const std::byte* const> matrix_rows,
+                           std::vector<BitVector<>>& output, primitives::Prg& prg_fixed_key,
+                           const std::size_t number_of_columns,
+                           const std::vector<std::size_t>& bitlengths) {
+  constexpr std::size_t kNumberOfRows{kCodeBitLength};
+  constexpr std::size_t kNumberOfHashBlocks{kCodeBitLength / (8 * kAesBlockSize)};
+  std::array<const std::byte*, kNumberOfRows> matrix;
+  std::copy(matrix_rows.begin(), matrix_rows.end(), matrix.begin());
 
   const std::size_t original_size{output.size()}, difference{number_of_columns - original_size};
   if (difference) {
     output.resize(number_of_columns);
   }
 
-  for (auto& block_vector : output)
-    block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
   assert(kNumberOfRows % 8 == 0 && number_of_columns % 8 == 0);
 
-  __m128i vec;
   primitives::Prg prg_var_key;
-  // process 256x256 blocks
-  while (c < number_of_columns) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 256 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(output[c + 7 - i].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
+  std::array<std::byte*, kNumberOfRows> columns;
+  std::array<std::byte*, kNumberOfHashBlocks * kNumberOfRows> hash_blocks;
+  // process square blocks of the matrix
+  for (std::size_t c = 0; c < number_of_columns; c += kNumberOfRows) {
+    const std::size_t block_end{std::min(c + kNumberOfRows, number_of_columns)};
+    for (auto c_old = c; c_old < block_end; ++c_old) {
+      output[c_old] = BitVector(std::vector<std::byte>(kCodeBitLength / 8), kCodeBitLength);
+      columns[c_old - c] = output[c_old].GetMutableData().data();
+    }
+    TransposeBlock(matrix, c, block_end, columns.data());
+    // hash the 128-bit blocks of the outputs with fixed-key AES in batches, using the index of the
+    // OT times the number of blocks plus the index of the block as tweak
+    const std::size_t number_of_hashes{std::max(std::min(block_end, original_size), c) - c};
+    for (std::size_t i = 0; i < number_of_hashes; ++i) {
+      for (std::size_t k = 0; k < kNumberOfHashBlocks; ++k) {
+        hash_blocks[kNumberOfHashBlocks * i + k] = columns[i] + k * kAesBlockSize;
       }
     }
-    for (; c_old < c && c_old < original_size; ++c_old) {
+    prg_fixed_key.Tmmo(hash_blocks.data(), kNumberOfHashBlocks * number_of_hashes,
+                       kNumberOfHashBlocks * c);
+    for (auto c_old = c; c_old < c + number_of_hashes; ++c_old) {
       auto& o = output[c_old];
-      assert(o.GetSize() == 256);
+      assert(o.GetSize() == kCodeBitLength);
       const std::size_t bitlength = bitlengths[c_old];
 
-      if (bitlength <= kKappa) {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
+      if (bitlength <= kCodeBitLength) {
         o.Resize(bitlength);
       } else {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
         prg_var_key.SetKey(o.GetData().data());
-        o = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+        o = prg_var_key.KeyStreamBits(bitlength);
       }
     }
   }
 }
 
+template <std::size_t kCodeBitLength>
+void EncodeTransposeCode(const std::byte* code_words, std::size_t code_word_stride,
+                         std::span<const std::size_t> inputs, std::span<std::byte* const> rows) {
+  constexpr std::size_t kBlockSize{kCodeBitLength};
+  // code word of the padding inputs
+  alignas(kAesBlockSize) static constexpr std::array<std::byte, kBlockSize / 8> kZero{};
+  assert(code_word_stride % kAesBlockSize == 0);
+
+  std::array<const std::byte*, kBlockSize> block;
+  std::array<std::byte*, kBlockSize> columns;
+  for (std::size_t c = 0; c < inputs.size(); c += kBlockSize) {
+    // the code words of the block form a square matrix, whose columns are the rows of the output
+    for (std::size_t i = 0; i < kBlockSize; ++i) {
+      block[i] =
+          c + i < inputs.size() ? code_words + code_word_stride * inputs[c + i] : kZero.data();
+    }
+    for (std::size_t j = 0; j < kBlockSize; ++j) {
+      columns[j] = rows[j] + c / 8;
+    }
+    TransposeBlock(block, 0, kBlockSize, columns.data());
+  }
+}
+
+[[noreturn]] void ThrowUnsupportedCodeBitLength(std::size_t code_bit_length) {
+  throw std::invalid_argument(fmt::format(
+      "BitMatrix: codes of {} bits are not supported, only 128, 256 or 512 bits are",
+      code_bit_length));
+}
+
+}  // namespace
+
+void BitMatrix::SenderTransposeCodeAndEncrypt(
+    std::span<const std::byte* const> matrix, std::vector<std::vector<BitVector<>>>& y,
+    const BitVector<>& choices, const std::vector<AlignedBitVector>& x_a,
+    primitives::Prg& prg_fixed_key, const std::size_t number_of_columns,
+    const std::vector<std::size_t>& bitlengths) {
+  switch (matrix.size()) {
+    case 128:
+      SenderTransposeCode<128>(matrix, y, choices, x_a, prg_fixed_key, number_of_columns,
+                               bitlengths);
+      break;
+    case 256:
+      SenderTransposeCode<256>(matrix, y, choices, x_a, prg_fixed_key, number_of_columns,
+                               bitlengths);
+      break;
+    case 512:
+      SenderTransposeCode<512>(matrix, y, choices, x_a, prg_fixed_key, number_of_columns,
+                               bitlengths);
+      break;
+    default:
+      ThrowUnsupportedCodeBitLength(matrix.size());
+  }
+}
+
+void BitMatrix::ReceiverTransposeCodeAndEncrypt(std::span<const std::byte* const> matrix,
+                                                std::vector<BitVector<>>& output,
+                                                primitives::Prg& prg_fixed_key,
+                                                const std::size_t number_of_columns,
+                                                const std::vector<std::size_t>& bitlengths) {
+  switch (matrix.size()) {
+    case 128:
+      ReceiverTransposeCode<128>(matrix, output, prg_fixed_key, number_of_columns, bitlengths);
+      break;
+    case 256:
+      ReceiverTransposeCode<256>(matrix, output, prg_fixed_key, number_of_columns, bitlengths);
+      break;
+    case 512:
+      ReceiverTransposeCode<512>(matrix, output, prg_fixed_key, number_of_columns, bitlengths);
+      break;
+    default:
+      ThrowUnsupportedCodeBitLength(matrix.size());
+  }
+}
+
+void BitMatrix::EncodeTransposeCode(const std::byte* code_words, std::size_t code_word_stride,
+                                    std::span<const std::size_t> inputs,
+                                    std::span<std::byte* const> rows) {
+  switch (rows.size()) {
+    case 128:
+      encrypto::motion::EncodeTransposeCode<128>(code_words, code_word_stride, inputs, rows);
+      break;
+    case 256:
+      encrypto::motion::EncodeTransposeCode<256>(code_words, code_word_stride, inputs, rows);
+      break;
+    case 512:
+      encrypto::motion::EncodeTransposeCode<512>(code_words, code_word_stride, inputs, rows);
+      break;
+    default:
+      ThrowUnsupportedCodeBitLength(rows.size());
+  }
+}
+
+void BitMatrix::SenderTranspose256AndEncrypt(
+    const std::array<const std::byte*, 256>& matrix, std::vector<std::vector<BitVector<>>>& y,
+    const BitVector<> choices, std::vector<AlignedBitVector> x_a, primitives::Prg& prg_fixed_key,
+    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths) {
+  SenderTransposeCodeAndEncrypt(matrix, y, choices, x_a, prg_fixed_key, number_of_colums,
+                                bitlengths);
+}
+
+void BitMatrix::ReceiverTranspose256AndEncrypt(const std::array<const std::byte*, 256>& matrix,
+                                               std::vector<BitVector<>>& output,
+                                               primitives::Prg& prg_fixed_key,
+                                               const std::size_t number_of_columns,
+                                               const std::vector<std::size_t>& bitlengths) {
+  ReceiverTransposeCodeAndEncrypt(matrix, output, prg_fixed_key, number_of_columns, bitlengths);
+}
+
+void BitMatrix::EncodeTranspose256(const std::byte* code_words, std::size_t code_word_stride,
+                                   std::span<const std::size_t> inputs,
+                                   const std::array<std::byte*, 256>& rows) {
+  EncodeTransposeCode(code_words, code_word_stride, inputs, rows);
+}
+
 bool BitMatrix::operator==(const BitMatrix& other) const {
   if (other.data_.size() != data_.size()) {
     return false;
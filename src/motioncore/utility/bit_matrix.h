@@ -30,6 +30,7 @@
 #include <stdlib.h>
 #include <cassert>
 #include <memory>
+#include <span>
 
 namespace encrypto::motion::primitives {
 
@@ -41,6 +42,20 @@ namespace encrypto::motion {
 
 class BitMatrix {
  public:
+  /// \brief Instruction set extensions for which kernels of the bit-sliced transpositions exist.
+  enum class TransposeKernel : unsigned int { kSse = 0, kAvx2 = 1, kAvx512 = 2 };
+
+  /// \brief Returns whether the CPU which we are running on supports \p kernel.
+  static bool IsSupported(TransposeKernel kernel);
+
+  /// \brief Returns the kernel used by the bit-sliced transpositions, which is by default the
+  /// fastest kernel supported by the CPU.
+  static TransposeKernel GetTransposeKernel();
+
+  /// \brief Selects the kernel used by the bit-sliced transpositions, e.g., for benchmarks.
+  /// \throws std::invalid_argument if the CPU does not support \p kernel.
+  static void SetTransposeKernel(TransposeKernel kernel);
+
   BitMatrix() = default;
 
   /// \brief Construct a \p rows x \p columns BitMatrix with all bits set to \p value.
@@ -187,6 +202,8 @@ class BitMatrix {
   /// \param prg_fixed_key
   /// \param number_of_columns
   /// \param bitlengths
+  /// \param number_of_threads Number of threads among which the 128x128 blocks are distributed.
+  /// \param tweak_offset Index of the first column among all OTs, used as tweak of the hash.
   /// \pre - All rows must be of size equal to number_of_columns
   ///      - const std::byte* in matrix is (number_of_columns)-bit aligned
   ///      - y0 and y1 must be of equal size
@@ -195,7 +212,9 @@ class BitMatrix {
                                            std::vector<BitVector<>>& y1, const BitVector<> choices,
                                            primitives::Prg& prg_fixed_key,
                                            const std::size_t number_of_columns,
-                                           const std::vector<std::size_t>& bitlengths);
+                                           const std::vector<std::size_t>& bitlengths,
+                                           const std::size_t number_of_threads = 1,
+                                           const std::size_t tweak_offset = 0);
 
   /// \brief Transposes a matrix of 128 rows and arbitrary column size and encrypts it for the
   /// recipient role.
@@ -205,13 +224,17 @@ class BitMatrix {
   /// \param prg_fixed_key
   /// \param number_of_columns
   /// \param bitlengths
+  /// \param number_of_threads Number of threads among which the 128x128 blocks are distributed.
+  /// \param tweak_offset Index of the first column among all OTs, used as tweak of the hash.
   /// \pre - All rows must be of size equal to number_of_columns
   ///      - const std::byte* in matrix is (number_of_columns)-bit aligned
   static void ReceiverTranspose128AndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                              std::vector<BitVector<>>& output,
                                              primitives::Prg& prg_fixed_key,
                                              const std::size_t number_of_columns,
-                                             const std::vector<std::size_t>& bitlengths);
+                                             const std::vector<std::size_t>& bitlengths,
+                                             const std::size_t number_of_threads = 1,
+                                             const std::size_t tweak_offset = 0);
 
   /// \brief Transposes a matrix of 256 rows and arbitrary column size and encrypts it for the
   /// sender role.
@@ -245,6 +268,45 @@ class BitMatrix {
                                              const std::size_t number_of_columns,
                                              const std::vector<std::size_t>& bitlengths);
 
+  /// \brief Encodes inputs with a code of 256-bit code words and writes the transposed code-word
+  /// matrix, i.e., row j holds bit j of the code words of all inputs. This equals building a
+  /// matrix of the code words codes[inputs[i]] and calling Transpose256Columns(), but the code
+  /// words are gathered by pointer instead of being copied and the transpose uses the bit-sliced
+  /// kernels.
+  /// \param code_words The code word of input a starts at code_words + a * code_word_stride.
+  /// \param code_word_stride Distance of successive code words in bytes.
+  /// \param inputs
+  /// \param[out] rows The 256 rows of the transposed matrix.
+  /// \pre - Each row has space for inputs.size() bits rounded up to a multiple of 256
+  ///      - code_words and code_word_stride are multiples of 16
+  static void EncodeTranspose256(const std::byte* code_words, std::size_t code_word_stride,
+                                 std::span<const std::size_t> inputs,
+                                 const std::array<std::byte*, 256>& rows);
+
+  /// \brief Generalizes SenderTranspose256AndEncrypt() to codes of matrix.size() bits.
+  /// \throws std::invalid_argument if matrix.size() is not 128, 256 or 512.
+  static void SenderTransposeCodeAndEncrypt(std::span<const std::byte* const> matrix,
+                                            std::vector<std::vector<BitVector<>>>& y,
+                                            const BitVector<>& choices,
+                                            const std::vector<AlignedBitVector>& x_a,
+                                            primitives::Prg& prg_fixed_key,
+                                            const std::size_t number_of_columns,
+                                            const std::vector<std::size_t>& bitlengths);
+
+  /// \brief Generalizes ReceiverTranspose256AndEncrypt() to codes of matrix.size() bits.
+  /// \throws std::invalid_argument if matrix.size() is not 128, 256 or 512.
+  static void ReceiverTransposeCodeAndEncrypt(std::span<const std::byte* const> matrix,
+                                              std::vector<BitVector<>>& output,
+                                              primitives::Prg& prg_fixed_key,
+                                              const std::size_t number_of_columns,
+                                              const std::vector<std::size_t>& bitlengths);
+
+  /// \brief Generalizes EncodeTranspose256() to codes of rows.size() bits.
+  /// \throws std::invalid_argument if rows.size() is not 128, 256 or 512.
+  static void EncodeTransposeCode(const std::byte* code_words, std::size_t code_word_stride,
+                                  std::span<const std::size_t> inputs,
+                                  std::span<std::byte* const> rows);
+
   /// \brief Compare with another BitMatrix for equality
   /// \param other
   bool operator==(const BitMatrix& other) const;
@@ -264,9 +326,6 @@ class BitMatrix {
 
   std::size_t number_of_columns_ = 0;
 
-  // blockwise inplace
-  void TransposeInternal();
-
   // blockwise inplace
   void Transpose128RowsInternal();
 
@@ -24,7 +24,12 @@
 
 #include "bit_vector.h"
 
+#include <immintrin.h>
+#include <atomic>
 #include <bit>
+#include <cstring>
+#include <functional>
+#include <numeric>
 #include <span>
 
 #include "primitives/random/default_rng.h"
@@ -35,6 +40,367 @@ auto constexpr NumberOfBitsToNumberOfBytes(std::size_t number_of_bits) {
   return (number_of_bits + 7) >> 3;
 }
 
+namespace {
+
+// The bulk kernels below process one vector register of the selected instruction set extension at
+// a time and the remaining bytes as 64-bit words and single bytes, hence they need no alignment.
+// Inputs below kMinimumDispatchBytes are always processed by the SSE kernels.
+
+constexpr std::size_t kMinimumDispatchBytes{64};
+
+enum class BinaryOperation { kXor, kAnd, kOr };
+
+inline std::uint64_t LoadWord(const std::byte* pointer) noexcept {
+  std::uint64_t word;
+  std::memcpy(&word, pointer, sizeof(word));
+  return word;
+}
+
+template <BinaryOperation kOperation, typename T>
+inline T Apply(T a, T b) noexcept {
+  if constexpr (kOperation == BinaryOperation::kXor) {
+    return a ^ b;
+  } else if constexpr (kOperation == BinaryOperation::kAnd) {
+    return a & b;
+  } else {
+    return a | b;
+  }
+}
+
+// result[i] = result[i] op input[i] for i in [begin, byte_size)
+template <BinaryOperation kOperation>
+void BinarySse(const std::byte* input, std::byte* result, std::size_t begin,
+               std::size_t byte_size) noexcept {
+  std::size_t i{begin};
+  for (; i + sizeof(__m128i) <= byte_size; i += sizeof(__m128i)) {
+    const __m128i a{_mm_loadu_si128(reinterpret_cast<const __m128i*>(result + i))};
+    const __m128i b{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i))};
+    __m128i c;
+    if constexpr (kOperation == BinaryOperation::kXor) {
+      c = _mm_xor_si128(a, b);
+    } else if constexpr (kOperation == BinaryOperation::kAnd) {
+      c = _mm_and_si128(a, b);
+    } else {
+      c = _mm_or_si128(a, b);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), c);
+  }
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    const std::uint64_t word{Apply<kOperation>(LoadWord(result + i), LoadWord(input + i))};
+    std::memcpy(result + i, &word, sizeof(word));
+  }
+  for (; i < byte_size; ++i) result[i] = Apply<kOperation>(result[i], input[i]);
+}
+
+template <BinaryOperation kOperation>
+__attribute__((target("avx2"))) inline void BinaryAvx2Register(const std::byte* input,
+                                                               std::byte* result) noexcept {
+  const __m256i a{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(result))};
+  const __m256i b{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input))};
+  __m256i c;
+  if constexpr (kOperation == BinaryOperation::kXor) {
+    c = _mm256_xor_si256(a, b);
+  } else if constexpr (kOperation == BinaryOperation::kAnd) {
+    c = _mm256_and_si256(a, b);
+  } else {
+    c = _mm256_or_si256(a, b);
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(result), c);
+}
+
+template <BinaryOperation kOperation>
+__attribute__((target("avx2"))) void BinaryAvx2(const std::byte* input, std::byte* result,
+                                                std::size_t byte_size) noexcept {
+  constexpr std::size_t kRegisterSize{sizeof(__m256i)};
+  std::size_t i{0};
+  for (; i + 4 * kRegisterSize <= byte_size; i += 4 * kRegisterSize) {
+    for (std::size_t j = 0; j < 4 * kRegisterSize; j += kRegisterSize) {
+      BinaryAvx2Register<kOperation>(input + i + j, result + i + j);
+    }
+  }
+  for (; i + kRegisterSize <= byte_size; i += kRegisterSize) {
+    BinaryAvx2Register<kOperation>(input + i, result + i);
+  }
+  BinarySse<kOperation>(input, result, i, byte_size);
+}
+
+// the bytes outside of mask are neither read nor written
+template <BinaryOperation kOperation>
+__attribute__((target("avx512f,avx512bw"))) inline void BinaryAvx512Register(
+    const std::byte* input, std::byte* result, __mmask64 mask = ~__mmask64(0)) noexcept {
+  const __m512i a{_mm512_maskz_loadu_epi8(mask, result)};
+  const __m512i b{_mm512_maskz_loadu_epi8(mask, input)};
+  __m512i c;
+  if constexpr (kOperation == BinaryOperation::kXor) {
+    c = _mm512_xor_si512(a, b);
+  } else if constexpr (kOperation == BinaryOperation::kAnd) {
+    c = _mm512_and_si512(a, b);
+  } else {
+    c = _mm512_or_si512(a, b);
+  }
+  _mm512_mask_storeu_epi8(result, mask, c);
+}
+
+template <BinaryOperation kOperation>
+__attribute__((target("avx512f,avx512bw"))) void BinaryAvx512(const std::byte* input,
+                                                              std::byte* result,
+                                                              std::size_t byte_size) noexcept {
+  constexpr std::size_t kRegisterSize{sizeof(__m512i)};
+  std::size_t i{0};
+  for (; i + 4 * kRegisterSize <= byte_size; i += 4 * kRegisterSize) {
+    for (std::size_t j = 0; j < 4 * kRegisterSize; j += kRegisterSize) {
+      BinaryAvx512Register<kOperation>(input + i + j, result + i + j);
+    }
+  }
+  for (; i + kRegisterSize <= byte_size; i += kRegisterSize) {
+    BinaryAvx512Register<kOperation>(input + i, result + i);
+  }
+  if (i < byte_size) {
+    BinaryAvx512Register<kOperation>(input + i, result + i,
+                                     (__mmask64(1) << (byte_size - i)) - 1);
+  }
+}
+
+std::size_t PopCountSse(const std::byte* data, std::size_t begin,
+                           std::size_t byte_size) noexcept {
+  std::size_t count{0}, i{begin};
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    count += std::popcount(LoadWord(data + i));
+  }
+  for (; i < byte_size; ++i) count += std::popcount(std::to_integer<std::uint8_t>(data[i]));
+  return count;
+}
+
+// Counts the bits of the low and high nibbles of each byte with a lookup table in a shuffle and
+// sums the counts of 8 bytes with a sum of absolute differences, see W. Mula, N. Kurz and D.
+// Lemire, "Faster Population Counts Using AVX2 Instructions".
+__attribute__((target("avx2"))) std::size_t PopCountAvx2(const std::byte* data,
+                                                         std::size_t byte_size) noexcept {
+  const __m256i lookup{_mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2,
+                                        1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4)};
+  const __m256i low_mask{_mm256_set1_epi8(0x0F)};
+  __m256i counts{_mm256_setzero_si256()};
+  std::size_t i{0};
+  for (; i + sizeof(__m256i) <= byte_size; i += sizeof(__m256i)) {
+    const __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))};
+    const __m256i low{_mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask))};
+    const __m256i high{
+        _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask))};
+    counts = _mm256_add_epi64(
+        counts, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+  }
+  const std::size_t count{static_cast<std::size_t>(
+      _mm256_extract_epi64(counts, 0) + _mm256_extract_epi64(counts, 1) +
+      _mm256_extract_epi64(counts, 2) + _mm256_extract_epi64(counts, 3))};
+  return count + PopCountSse(data, i, byte_size);
+}
+
+__attribute__((target("avx512f,avx512bw"))) std::size_t PopCountAvx512(
+    const std::byte* data, std::size_t byte_size) noexcept {
+  const __m512i lookup{_mm512_broadcast_i32x4(
+      _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4))};
+  const __m512i low_mask{_mm512_set1_epi8(0x0F)};
+  __m512i counts{_mm512_setzero_si512()};
+  std::size_t i{0};
+  for (; i + sizeof(__m512i) <= byte_size; i += sizeof(__m512i)) {
+    const __m512i v{_mm512_loadu_si512(data + i)};
+    const __m512i low{_mm512_shuffle_epi8(lookup, _mm512_and_si512(v, low_mask))};
+    const __m512i high{
+        _mm512_shuffle_epi8(lookup, _mm512_and_si512(_mm512_srli_epi16(v, 4), low_mask))};
+    counts = _mm512_add_epi64(
+        counts, _mm512_sad_epu8(_mm512_add_epi8(low, high), _mm512_setzero_si512()));
+  }
+  const std::size_t count{static_cast<std::size_t>(_mm512_reduce_add_epi64(counts))};
+  return count + PopCountSse(data, i, byte_size);
+}
+
+// XOR of all 64-bit words of the data, where the remaining bytes are XORed into the low byte,
+// i.e., the parity of the result is the parity of the data
+std::uint64_t XorFoldSse(const std::byte* data, std::size_t begin,
+                            std::size_t byte_size) noexcept {
+  std::uint64_t fold{0};
+  std::size_t i{begin};
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    fold ^= LoadWord(data + i);
+  }
+  for (; i < byte_size; ++i) fold ^= std::to_integer<std::uint8_t>(data[i]);
+  return fold;
+}
+
+__attribute__((target("avx2"))) std::uint64_t XorFoldAvx2(const std::byte* data,
+                                                          std::size_t byte_size) noexcept {
+  __m256i fold{_mm256_setzero_si256()};
+  std::size_t i{0};
+  for (; i + sizeof(__m256i) <= byte_size; i += sizeof(__m256i)) {
+    fold =
+        _mm256_xor_si256(fold, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+  }
+  return static_cast<std::uint64_t>(_mm256_extract_epi64(fold, 0) ^ _mm256_extract_epi64(fold, 1) ^
+                                    _mm256_extract_epi64(fold, 2) ^ _mm256_extract_epi64(fold, 3)) ^
+         XorFoldSse(data, i, byte_size);
+}
+
+__attribute__((target("avx512f,avx512bw"))) std::uint64_t XorFoldAvx512(
+    const std::byte* data, std::size_t byte_size) noexcept {
+  __m512i fold{_mm512_setzero_si512()};
+  std::size_t i{0};
+  for (; i + sizeof(__m512i) <= byte_size; i += sizeof(__m512i)) {
+    fold = _mm512_xor_si512(fold, _mm512_loadu_si512(data + i));
+  }
+  alignas(sizeof(__m512i)) std::array<std::uint64_t, sizeof(__m512i) / sizeof(std::uint64_t)> lanes;
+  _mm512_store_si512(lanes.data(), fold);
+  return std::accumulate(lanes.cbegin(), lanes.cend(), XorFoldSse(data, i, byte_size),
+                         std::bit_xor<>());
+}
+
+// Returns the index of the first byte that differs from value, or byte_size if there is none.
+std::size_t FindFirstDifferentSse(const std::byte* data, std::size_t begin,
+                                     std::size_t byte_size, std::byte value) noexcept {
+  const std::uint64_t broadcast{std::to_integer<std::uint8_t>(value) * 0x0101010101010101ull};
+  std::size_t i{begin};
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    if (const std::uint64_t difference{LoadWord(data + i) ^ broadcast}; difference != 0) {
+      return i + std::countr_zero(difference) / 8;
+    }
+  }
+  for (; i < byte_size; ++i) {
+    if (data[i] != value) return i;
+  }
+  return byte_size;
+}
+
+__attribute__((target("avx2"))) std::size_t FindFirstDifferentAvx2(const std::byte* data,
+                                                                   std::size_t byte_size,
+                                                                   std::byte value) noexcept {
+  const __m256i broadcast{_mm256_set1_epi8(std::to_integer<char>(value))};
+  std::size_t i{0};
+  for (; i + sizeof(__m256i) <= byte_size; i += sizeof(__m256i)) {
+    const __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))};
+    const auto equal{
+        static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, broadcast)))};
+    if (equal != ~std::uint32_t(0)) return i + std::countr_one(equal);
+  }
+  return FindFirstDifferentSse(data, i, byte_size, value);
+}
+
+__attribute__((target("avx512f,avx512bw"))) std::size_t FindFirstDifferentAvx512(
+    const std::byte* data, std::size_t byte_size, std::byte value) noexcept {
+  const __m512i broadcast{_mm512_set1_epi8(std::to_integer<char>(value))};
+  std::size_t i{0};
+  for (; i + sizeof(__m512i) <= byte_size; i += sizeof(__m512i)) {
+    const __mmask64 different{_mm512_cmpneq_epi8_mask(_mm512_loadu_si512(data + i), broadcast)};
+    if (different != 0) return i + std::countr_zero(different);
+  }
+  return FindFirstDifferentSse(data, i, byte_size, value);
+}
+
+// VPOPCNTQ of AVX512_VPOPCNTDQ, which is used by the AVX-512 kernel if it is supported
+__attribute__((target("avx512f,avx512vpopcntdq"))) std::size_t PopCountAvx512Vpopcnt(
+    const std::byte* data, std::size_t byte_size) noexcept {
+  __m512i counts{_mm512_setzero_si512()};
+  std::size_t i{0};
+  for (; i + sizeof(__m512i) <= byte_size; i += sizeof(__m512i)) {
+    counts = _mm512_add_epi64(counts, _mm512_popcnt_epi64(_mm512_loadu_si512(data + i)));
+  }
+  const std::size_t count{static_cast<std::size_t>(_mm512_reduce_add_epi64(counts))};
+  return count + PopCountSse(data, i, byte_size);
+}
+
+BitwiseKernel DetectBitwiseKernel() {
+  if (IsSupported(BitwiseKernel::kAvx512)) return BitwiseKernel::kAvx512;
+  if (IsSupported(BitwiseKernel::kAvx2)) return BitwiseKernel::kAvx2;
+  return BitwiseKernel::kSse;
+}
+
+// A namespace-scope variable avoids the guard of a function-local static in every operation. It
+// is zero-initialized to kSse before its dynamic initialization, so BitVectors used during the
+// static initialization of other translation units use the SSE kernels.
+std::atomic<BitwiseKernel> selected_bitwise_kernel{DetectBitwiseKernel()};
+
+inline BitwiseKernel GetKernelFor(std::size_t byte_size) {
+  if (byte_size < kMinimumDispatchBytes) return BitwiseKernel::kSse;
+  return selected_bitwise_kernel.load(std::memory_order_relaxed);
+}
+
+template <BinaryOperation kOperation>
+inline void Binary(const std::byte* input, std::byte* result, std::size_t byte_size) noexcept {
+  switch (GetKernelFor(byte_size)) {
+    case BitwiseKernel::kAvx512:
+      BinaryAvx512<kOperation>(input, result, byte_size);
+      break;
+    case BitwiseKernel::kAvx2:
+      BinaryAvx2<kOperation>(input, result, byte_size);
+      break;
+    default:
+      BinarySse<kOperation>(input, result, 0, byte_size);
+  }
+}
+
+std::size_t PopCount(const std::byte* data, std::size_t byte_size) noexcept {
+  switch (GetKernelFor(byte_size)) {
+    case BitwiseKernel::kAvx512: {
+      static const bool kHasVpopcnt = __builtin_cpu_supports("avx512vpopcntdq");
+      return kHasVpopcnt ? PopCountAvx512Vpopcnt(data, byte_size) : PopCountAvx512(data, byte_size);
+    }
+    case BitwiseKernel::kAvx2:
+      return PopCountAvx2(data, byte_size);
+    default:
+      return PopCountSse(data, 0, byte_size);
+  }
+}
+
+bool Parity(const std::byte* data, std::size_t byte_size) noexcept {
+  std::uint64_t fold;
+  switch (GetKernelFor(byte_size)) {
+    case BitwiseKernel::kAvx512:
+      fold = XorFoldAvx512(data, byte_size);
+      break;
+    case BitwiseKernel::kAvx2:
+      fold = XorFoldAvx2(data, byte_size);
+      break;
+    default:
+      fold = XorFoldSse(data, 0, byte_size);
+  }
+  return std::popcount(fold) & 1;
+}
+
+std::size_t FindFirstDifferent(const std::byte* data, std::size_t byte_size,
+                               std::byte value) noexcept {
+  switch (GetKernelFor(byte_size)) {
+    case BitwiseKernel::kAvx512:
+      return FindFirstDifferentAvx512(data, byte_size, value);
+    case BitwiseKernel::kAvx2:
+      return FindFirstDifferentAvx2(data, byte_size, value);
+    default:
+      return FindFirstDifferentSse(data, 0, byte_size, value);
+  }
+}
+
+}  // namespace
+
+bool IsSupported(BitwiseKernel kernel) {
+  __builtin_cpu_init();
+  switch (kernel) {
+    case BitwiseKernel::kSse:
+      return true;
+    case BitwiseKernel::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case BitwiseKernel::kAvx512:
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+  }
+  return false;
+}
+
+BitwiseKernel GetBitwiseKernel() { return selected_bitwise_kernel.load(); }
+
+void SetBitwiseKernel(BitwiseKernel kernel) {
+  if (!IsSupported(kernel)) {
+    throw std::invalid_argument(fmt::format("Bitwise kernel {} is not supported by this CPU",
+                                            static_cast<unsigned int>(kernel)));
+  }
+  selected_bitwise_kernel.store(kernel);
+}
+
 // TODO: migrate BitVector functions to the functions below
 
 inline void TruncateToFitImplementation(std::byte* pointer, const std::size_t bit_size) {
@@ -102,54 +468,108 @@ inline bool AlignedEqualImplementation(const T* pointer1, const U* pointer2,
 
 template <typename T, typename U>
 inline void XorImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{reinterpret_cast<const std::byte*>(input)};
-  auto result_cast{reinterpret_cast<std::byte*>(result)};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a ^ b; });
+  Binary<BinaryOperation::kXor>(reinterpret_cast<const std::byte*>(input),
+                                  reinterpret_cast<std::byte*>(result), byte_size);
 }
 
-// TODO: check how good this is vectorized
+// the kernels use unaligned loads, which are as fast as aligned ones on aligned data
 template <typename T, typename U>
 inline void AlignedXorImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment))};
-  auto result_cast{reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment))};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a ^ b; });
+  XorImplementation(input, result, byte_size);
 }
 
 template <typename T, typename U>
 inline void AndImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{reinterpret_cast<const std::byte*>(input)};
-  auto result_cast{reinterpret_cast<std::byte*>(result)};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a & b; });
+  Binary<BinaryOperation::kAnd>(reinterpret_cast<const std::byte*>(input),
+                                  reinterpret_cast<std::byte*>(result), byte_size);
 }
 
 template <typename T, typename U>
 inline void AlignedAndImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment))};
-  auto result_cast{reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment))};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a & b; });
+  AndImplementation(input, result, byte_size);
 }
 
 template <typename T, typename U>
 inline void OrImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{reinterpret_cast<const std::byte*>(input)};
-  auto result_cast{reinterpret_cast<std::byte*>(result)};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a | b; });
+  Binary<BinaryOperation::kOr>(reinterpret_cast<const std::byte*>(input),
+                                  reinterpret_cast<std::byte*>(result), byte_size);
 }
 
 template <typename T, typename U>
 inline void AlignedOrImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment))};
-  auto result_cast{reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment))};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a | b; });
+  OrImplementation(input, result, byte_size);
+}
+
+// Returns the number_of_bits <= 64 bits of source starting at bit position as the low bits of a
+// word, reading only the bytes that contain these bits. The word is assembled from up to 9 bytes
+// with a funnel shift.
+inline std::uint64_t LoadBits(const std::byte* source, std::size_t position,
+                              std::size_t number_of_bits) noexcept {
+  assert(number_of_bits > 0 && number_of_bits <= 64);
+  const std::byte* first{source + position / 8};
+  const std::size_t bit_offset{position % 8};
+  const std::size_t number_of_bytes{(bit_offset + number_of_bits + 7) / 8};
+  std::uint64_t low{0};
+  if (number_of_bytes >= sizeof(low)) {
+    std::memcpy(&low, first, sizeof(low));
+  } else {
+    // short copies, e.g., of the bits of a few SIMD values, are faster without a call to memcpy
+    for (std::size_t i = 0; i < number_of_bytes; ++i) {
+      low |= std::to_integer<std::uint64_t>(first[i]) << (8 * i);
+    }
+  }
+  std::uint64_t word{low >> bit_offset};
+  if (number_of_bytes > sizeof(low)) {
+    word |= std::to_integer<std::uint64_t>(first[sizeof(low)]) << (64 - bit_offset);
+  }
+  return number_of_bits == 64 ? word : word & ((std::uint64_t(1) << number_of_bits) - 1);
+}
+
+// Copies the bits [source_from, source_from + number_of_bits) of source to the bits
+// [destination_from, destination_from + number_of_bits) of destination and leaves the other bits
+// of destination unchanged. After aligning the destination to a byte, 64 bits are copied at a time
+// instead of shifting and masking each byte.
+inline void CopyBitsImplementation(const std::byte* source, std::size_t source_from,
+                                   std::byte* destination, std::size_t destination_from,
+                                   std::size_t number_of_bits) noexcept {
+  if (number_of_bits == 0) return;
+  destination += destination_from / 8;
+  if (const std::size_t bit_offset{destination_from % 8}; bit_offset != 0) {
+    const std::size_t head_size{std::min(number_of_bits, 8 - bit_offset)};
+    const std::byte mask{TruncationBitMask[head_size] << bit_offset};
+    const std::byte head{std::byte(LoadBits(source, source_from, head_size) << bit_offset)};
+    *destination = (*destination & ~mask) | head;
+    ++destination;
+    source_from += head_size;
+    number_of_bits -= head_size;
+  }
+  if (source_from % 8 == 0) {
+    std::memcpy(destination, source + source_from / 8, number_of_bits / 8);
+  } else {
+    // each word of the destination is the funnel shift of the 9 source bytes that contain its bits
+    const std::byte* source_bytes{source + source_from / 8};
+    const std::size_t bit_offset{source_from % 8};
+    for (std::size_t i = 0; i + 64 <= number_of_bits; i += 64, source_bytes += 8) {
+      std::uint64_t low;
+      std::memcpy(&low, source_bytes, sizeof(low));
+      const std::uint64_t high{std::to_integer<std::uint64_t>(source_bytes[8])};
+      const std::uint64_t word{(low >> bit_offset) | (high << (64 - bit_offset))};
+      std::memcpy(destination + i / 8, &word, sizeof(word));
+    }
+    if (const std::size_t remaining_bytes{number_of_bits % 64 / 8}; remaining_bytes > 0) {
+      const std::size_t position{number_of_bits / 64 * 64};
+      const std::uint64_t word{LoadBits(source, source_from + position, remaining_bytes * 8)};
+      for (std::size_t i = 0; i < remaining_bytes; ++i) {
+        destination[position / 8 + i] = std::byte(word >> (8 * i));
+      }
+    }
+  }
+  if (const std::size_t tail_size{number_of_bits % 8}; tail_size != 0) {
+    const std::size_t position{number_of_bits - tail_size};
+    const std::byte tail{std::byte(LoadBits(source, source_from + position, tail_size))};
+    const std::byte mask{TruncationBitMask[tail_size]};
+    destination[position / 8] = (destination[position / 8] & ~mask) | tail;
+  }
 }
 
 inline void CopyImplementation(const std::size_t from, const std::size_t to,
@@ -159,62 +579,7 @@ inline void CopyImplementation(const std::size_t from, const std::size_t to,
         "Got `from`={} and `to`={} in Copy, but `from` should be greater than or equal to `to`",
         from, to));
   }
-
-  if (from == to) {
-    return;
-  }
-
-  const auto number_of_bits = to - from;
-
-  const auto destination_to_offset = to % 8;
-  const auto destination_from_offset = from % 8;
-  const auto from_bytes = from / 8;
-
-  if (destination_from_offset + number_of_bits < 8) {
-    const auto mask = TruncationBitMask[number_of_bits] << destination_from_offset;
-    destination[from_bytes] &= ~mask;
-    destination[from_bytes] |= (source[0] << destination_from_offset) & mask;
-  } else if ((from % 8) == 0) {
-    const auto number_of_bytes = BitsToBytes(number_of_bits);
-    const bool has_remainder = destination_to_offset > 0;
-    for (std::size_t i = 0; i < number_of_bytes - (has_remainder ? 1 : 0); ++i) {
-      destination[from_bytes + i] = source[i];
-    }
-    if (destination_to_offset > 0) {
-      const auto mask = TruncationBitMask[destination_to_offset];
-      destination[from_bytes + number_of_bytes - 1] &= ~mask;
-      destination[from_bytes + number_of_bytes - 1] |= source[number_of_bytes - 1] & mask;
-    }
-  } else {
-    const auto number_of_bytes = BitsToBytes(destination_from_offset + number_of_bits);
-    const auto number_of_complete_bytes =
-        BitsToBytes(number_of_bits - (8 - destination_from_offset) - destination_to_offset);
-    const auto destination_from_offset = from % 8;
-
-    destination[from_bytes] &= TruncationBitMask[destination_from_offset];
-    destination[from_bytes] |= source[0] << destination_from_offset;
-
-    for (std::size_t byte_i = 1; byte_i <= number_of_complete_bytes; ++byte_i) {
-      std::byte lower_part{source[byte_i - 1] >> (8 - destination_from_offset)};
-      std::byte upper_part{source[byte_i] << destination_from_offset};
-      destination[from_bytes + byte_i] = lower_part | upper_part;
-    }
-
-    if (destination_to_offset > 0) {
-      destination[from_bytes + number_of_bytes - 1] &= ~TruncationBitMask[destination_to_offset];
-      std::size_t mask_index{destination_to_offset > destination_from_offset
-                                 ? destination_from_offset
-                                 : destination_to_offset};
-      std::byte mask1{TruncationBitMask[mask_index]};
-      destination[from_bytes + number_of_bytes - 1] |=
-          (source[number_of_bytes - 2] >> (8 - destination_from_offset)) & mask1;
-      if (destination_to_offset > destination_from_offset) {
-        std::byte mask2{TruncationBitMask[destination_to_offset - destination_from_offset]};
-        destination[from_bytes + number_of_bytes - 1] |= (source[number_of_bytes - 1] & mask2)
-                                                         << destination_from_offset;
-      }
-    }
-  }
+  CopyBitsImplementation(source, 0, destination, from, to - from);
 }
 
 template <typename Allocator>
@@ -226,47 +591,12 @@ inline BitVector<Allocator> SubsetImplementation(const std::size_t from, const s
   if (from == to) return result;
 
   result.Resize(to - from);
-
-  const auto from_bit_offset = from % 8;
-
-  if (from_bit_offset == 0u) {
-    std::copy(source + (from / 8), source + (BitsToBytes(to)), result.GetMutableData().data());
-  } else if (from_bit_offset + result.GetSize() <= 8u) {
-    result.GetMutableData()[0] = source[from / 8];
-    result.GetMutableData()[0] >>= from_bit_offset;
-  } else {
-    auto new_byte_offset = 0ull;
-    auto bit_counter = 0ull;
-    const auto max = result.GetSize();
-    for (; bit_counter < max; ++new_byte_offset) {
-      auto left_part = source[(from / 8) + new_byte_offset] >> from_bit_offset;
-      result.GetMutableData()[new_byte_offset] |= left_part;
-      bit_counter += 8 - from_bit_offset;
-      if (bit_counter < max) {
-        auto right_part = source[(from / 8) + new_byte_offset + 1] << (8 - from_bit_offset);
-        result.GetMutableData()[new_byte_offset] |= right_part;
-        bit_counter += from_bit_offset;
-      }
-    }
-  }
-
-  TruncateToFitImplementation(result.GetMutableData().data(), result.GetSize());
-
+  CopyBitsImplementation(source, from, result.GetMutableData().data(), 0, to - from);
   return result;
 }
 
 std::size_t HammingWeightImplementation(std::span<const std::byte> data) {
-  std::size_t count = 0;
-  if (data.empty()) return count;
-
-  std::size_t i = 0;
-  for (; i + 8 < data.size(); i += 8) {
-    count += std::popcount(*reinterpret_cast<std::uint64_t const*>(&data[i]));
-  }
-  for (; i < data.size(); ++i) {
-    count += std::popcount(static_cast<std::uint8_t>(data[i]));
-  }
-  return count;
+  return PopCount(data.data(), data.size());
 }
 
 template <typename Allocator>
@@ -316,8 +646,7 @@ BitVector<Allocator>::BitVector(std::vector<std::byte, Allocator>&& data,
   if (byte_size > data.size()) {
     throw std::out_of_range(fmt::format("BitVector: accessing {} of {}", byte_size, data.size()));
   }
-  data_vector_ = std::move(data);
-  data_vector_.resize(byte_size);
+  data_vector_.assign(data.cbegin(), data.cbegin() + byte_size);
   TruncateToFit();
 }
 
@@ -541,9 +870,7 @@ BitVector<Allocator>& BitVector<Allocator>::operator&=(
 
   Resize(max_bit_size, true);
 
-  for (auto i = 0ull; i < min_byte_size; ++i) {
-    data_vector_.at(i) &= other.GetData().at(i);
-  }
+  AndImplementation(other.GetData().data(), data_vector_.data(), min_byte_size);
   return *this;
 }
 
@@ -575,9 +902,7 @@ BitVector<Allocator>& BitVector<Allocator>::operator^=(
     const BitVector<OtherAllocator>& other) noexcept {
   auto min_byte_size = std::min(data_vector_.size(), other.data_vector_.size());
 
-  std::transform(data_vector_.cbegin(), data_vector_.cbegin() + min_byte_size,
-                 other.data_vector_.cbegin(), data_vector_.begin(),
-                 [](auto a, auto b) { return a ^ b; });
+  XorImplementation(other.data_vector_.data(), data_vector_.data(), min_byte_size);
 
   return *this;
 }
@@ -614,9 +939,7 @@ BitVector<Allocator>& BitVector<Allocator>::operator|=(
 
   Resize(max_bit_size, true);
 
-  for (auto i = 0ull; i < min_byte_size; ++i) {
-    data_vector_.at(i) |= other.GetData().at(i);
-  }
+  OrImplementation(other.GetData().data(), data_vector_.data(), min_byte_size);
 
   if (min_byte_size == max_byte_size) {
     for (auto i = min_byte_size; i < max_byte_size; ++i) {
@@ -699,7 +1022,7 @@ void BitVector<Allocator>::Append(BitVector&& other) noexcept {
 template <typename Allocator>
 void BitVector<Allocator>::Append(const BitSpan& bit_span) {
   if (bit_span.GetSize() > 0u) {
-    Append(bit_span.GetData());
+    Append(bit_span.GetData(), bit_span.GetSize());
     // Need to truncate because the buffer is not owned and we do not know what bits are behind
     // the assigned range
     TruncateToFit();
@@ -752,6 +1075,25 @@ void BitVector<Allocator>::Copy(const std::size_t dest_from, const BitVector& ot
   Copy(dest_from, dest_from + other.GetSize(), other);
 }
 
+template <typename Allocator>
+void BitVector<Allocator>::Copy(const std::size_t dest_from, const std::size_t dest_to,
+                                const BitVector& other, const std::size_t other_from) {
+  if (dest_from > dest_to || other_from + (dest_to - dest_from) > other.GetSize()) {
+    throw std::out_of_range(
+        fmt::format("Attempting to copy bits [{}, {}) but source provides only {} bits",
+                    other_from, other_from + (dest_to - dest_from), other.GetSize()));
+  }
+
+  if (dest_to > bit_size_) {
+    throw std::out_of_range(
+        fmt::format("Attempting to copy bits to position {} but destination can hold only {} bits",
+                    dest_to, bit_size_));
+  }
+
+  CopyBitsImplementation(other.data_vector_.data(), other_from, data_vector_.data(), dest_from,
+                         dest_to - dest_from);
+}
+
 template <typename Allocator>
 BitVector<Allocator> BitVector<Allocator>::Subset(std::size_t from, std::size_t to) const {
   if (from > bit_size_ || to > bit_size_) {
@@ -763,6 +1105,21 @@ BitVector<Allocator> BitVector<Allocator>::Subset(std::size_t from, std::size_t
   return SubsetImplementation<Allocator>(from, to, data_vector_.data());
 }
 
+template <typename Allocator>
+BitVector<Allocator> BitVector<Allocator>::Gather(std::span<const std::size_t> positions) const {
+  BitVector result(positions.size());
+  const std::byte* in{data_vector_.data()};
+  std::byte* out{result.data_vector_.data()};
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    const std::size_t position{positions[i]};
+    if (position >= bit_size_) {
+      throw std::out_of_range(fmt::format("BitVector: accessing {} of {}", position, bit_size_));
+    }
+    out[i / 8] |= ((in[position / 8] >> (position % 8)) & std::byte(1)) << (i % 8);
+  }
+  return result;
+}
+
 template <typename Allocator>
 std::string BitVector<Allocator>::AsString() const noexcept {
   std::string result;
@@ -802,12 +1159,13 @@ BitVector<Allocator> BitVector<Allocator>::RandomSeeded(const std::size_t size,
 }
 
 template <typename Allocator>
-BitVector<Allocator> BitVector<Allocator>::SecureRandom(const std::size_t bit_size) noexcept {
+BitVector<Allocator> BitVector<Allocator>::SecureRandom(
+    const std::size_t bit_size, const std::size_t number_of_threads) noexcept {
   auto byte_size = BitsToBytes(bit_size);
   BitVector bit_vector(bit_size);
 
   auto& rng = DefaultRng::GetThreadInstance();
-  rng.RandomBytes(bit_vector.data_vector_.data(), byte_size);
+  rng.ParallelRandomBytes(bit_vector.data_vector_.data(), byte_size, number_of_threads);
   bit_vector.TruncateToFit();
 
   return bit_vector;
@@ -815,19 +1173,14 @@ BitVector<Allocator> BitVector<Allocator>::SecureRandom(const std::size_t bit_si
 
 template <typename Allocator>
 bool BitVector<Allocator>::AndReduceBitVector(const BitVector& bit_vector) {
-  if (bit_vector.GetSize() == 0) {
-    return true;
-  } else {
-    std::size_t remaining_bit_size = bit_vector.bit_size_;
-    std::size_t i = 0;
-    while (remaining_bit_size > 0) {
-      std::size_t remainder = remaining_bit_size >= 8u ? 8 : remaining_bit_size;
-      remaining_bit_size -= remainder;
-      std::byte mask = remainder == 8 ? std::byte(0xFF) : TruncationBitMask[remainder];
-      if (bit_vector.data_vector_[i++] != mask) return false;
-    }
-    return true;
+  const std::size_t number_of_full_bytes{bit_vector.bit_size_ / 8};
+  const std::size_t remainder{bit_vector.bit_size_ % 8};
+  if (FindFirstDifferent(bit_vector.data_vector_.data(), number_of_full_bytes, std::byte(0xFF)) !=
+      number_of_full_bytes) {
+    return false;
   }
+  return remainder == 0 ||
+         bit_vector.data_vector_[number_of_full_bytes] == TruncationBitMask[remainder];
 }
 
 template <typename Allocator>
@@ -849,32 +1202,7 @@ BitVector<Allocator> BitVector<Allocator>::AndBitVectors(
 
 template <typename Allocator>
 bool BitVector<Allocator>::OrReduceBitVector(const BitVector& bit_vector) {
-  if (bit_vector.GetSize() == 0) {
-    return {};
-  } else if (bit_vector.GetSize() == 1) {
-    return bit_vector.Get(0);
-  } else if (bit_vector.GetSize() <= 64) {
-    bool result = bit_vector.Get(0);
-    for (auto i = 1ull; i < bit_vector.GetSize(); ++i) {
-      result |= bit_vector.Get(i);
-    }
-    return result;
-  } else {
-    auto raw_vector = bit_vector.GetData();
-    std::byte b = raw_vector.at(0);
-
-    for (auto i = 1ull; i < raw_vector.size(); ++i) {
-      b |= raw_vector.at(i);
-    }
-    BitVector tmp({b}, 8);
-    bool result = tmp.Get(0);
-
-    for (auto i = 1; i < 8; ++i) {
-      result |= tmp.Get(i);
-    }
-
-    return result;
-  }
+  return bit_vector.FindFirstSet() != bit_vector.GetSize();
 }
 
 template <typename Allocator>
@@ -927,32 +1255,7 @@ std::vector<BitVector<Allocator>> BitVector<Allocator>::AndBitVectors(
 
 template <typename Allocator>
 bool BitVector<Allocator>::XorReduceBitVector(const BitVector& bit_vector) {
-  if (bit_vector.GetSize() == 0) {
-    return {};
-  } else if (bit_vector.GetSize() == 1) {
-    return bit_vector.Get(0);
-  } else if (bit_vector.GetSize() <= 64) {
-    bool result = bit_vector.Get(0);
-    for (auto i = 1ull; i < bit_vector.GetSize(); ++i) {
-      result ^= bit_vector.Get(i);
-    }
-    return result;
-  } else {
-    auto raw_vector = bit_vector.GetData();
-    std::byte b = raw_vector.at(0);
-
-    for (auto i = 1ull; i < raw_vector.size(); ++i) {
-      b ^= raw_vector.at(i);
-    }
-    BitVector tmp({b}, 8);
-    bool result = tmp.Get(0);
-
-    for (auto i = 1; i < 8; ++i) {
-      result ^= tmp.Get(i);
-    }
-
-    return result;
-  }
+  return bit_vector.Parity();
 }
 
 template <typename Allocator>
@@ -1042,7 +1345,26 @@ void BitVector<Allocator>::BoundsCheckInRange([[maybe_unused]] const std::size_t
 
 template <typename Allocator>
 std::size_t BitVector<Allocator>::HammingWeight() const {
-  return HammingWeightImplementation(data_vector_);
+  return PopCount();
+}
+
+template <typename Allocator>
+std::size_t BitVector<Allocator>::PopCount() const noexcept {
+  // the bits beyond bit_size_ in the last byte are always zero
+  return motion::PopCount(data_vector_.data(), data_vector_.size());
+}
+
+template <typename Allocator>
+bool BitVector<Allocator>::Parity() const noexcept {
+  return motion::Parity(data_vector_.data(), data_vector_.size());
+}
+
+template <typename Allocator>
+std::size_t BitVector<Allocator>::FindFirstSet() const noexcept {
+  const std::size_t byte_index{
+      FindFirstDifferent(data_vector_.data(), data_vector_.size(), std::byte(0))};
+  if (byte_index == data_vector_.size()) return bit_size_;
+  return byte_index * 8 + std::countr_zero(std::to_integer<std::uint8_t>(data_vector_[byte_index]));
 }
 
 template class BitVector<StdAllocator>;
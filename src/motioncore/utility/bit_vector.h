@@ -24,18 +24,21 @@
 
 #pragma once
 
+#include <array>
+#include <cassert>
 #include <cstddef>
 #include <iostream>
 #include <memory>
 #include <random>
+#include <span>
 #include <string>
 #include <vector>
 
 #include <fmt/format.h>
-#include <boost/align/aligned_allocator.hpp>
-
 #include "config.h"
 #include "helpers.h"
+#include "huge_page_allocator.h"
+#include "small_byte_vector.h"
 
 namespace encrypto::motion {
 
@@ -54,10 +57,26 @@ constexpr std::byte TruncationBitMask[] = {
     std::byte(0b00000000), std::byte(0b00000001), std::byte(0b00000011), std::byte(0b00000111),
     std::byte(0b00001111), std::byte(0b00011111), std::byte(0b00111111), std::byte(0b01111111)};
 
+/// \brief Instruction set extensions for which kernels of the bulk operations of BitVector and
+/// BitSpan exist, i.e., of the bitwise XOR, AND and OR, the reductions, PopCount, Parity and
+/// FindFirstSet.
+enum class BitwiseKernel : unsigned int { kSse = 0, kAvx2 = 1, kAvx512 = 2 };
+
+/// \brief Returns whether the CPU which we are running on supports \p kernel.
+bool IsSupported(BitwiseKernel kernel);
+
+/// \brief Returns the kernel used by the bulk operations, which is by default the fastest kernel
+/// supported by the CPU.
+BitwiseKernel GetBitwiseKernel();
+
+/// \brief Selects the kernel used by the bulk operations, e.g., for benchmarks.
+/// \throws std::invalid_argument if the CPU does not support \p kernel.
+void SetBitwiseKernel(BitwiseKernel kernel);
+
 class BitSpan;
 
 using StdAllocator = std::allocator<std::byte>;
-using AlignedAllocator = boost::alignment::aligned_allocator<std::byte, kAlignment>;
+using AlignedAllocator = HugePageAllocator<std::byte, kAlignment>;
 
 /// \brief Class representing a series of bits and providing single bit access.
 template <typename Allocator = std::allocator<std::byte>>
@@ -151,8 +170,10 @@ class BitVector {
   explicit BitVector(const std::vector<std::byte, OtherAllocator>& data,
                      std::size_t number_of_bits);
 
-  /// \brief Initialize by moving content of std::vector (requires same allocator).
+  /// \brief Initialize with the content of std::vector (requires same allocator).
   /// \param data
+  /// \note The bytes are copied, since a BitVector stores few bytes inline and hence cannot
+  ///       adopt the buffer of a std::vector.
   /// \param number_of_bits Expected number of bits.
   /// \pre \p data must be of size equal to \p number_of_bits.
   explicit BitVector(std::vector<std::byte, Allocator>&& data, std::size_t number_of_bits);
@@ -241,10 +262,20 @@ class BitVector {
   /// \throws an std::out_of_range exception if this is smaller than other.
   void Copy(const std::size_t dest_from, const BitVector& other);
 
+  /// \brief copies the bits [other_from, other_from + dest_to - dest_from) from other to the bits
+  /// [dest_from, dest_to) in this.
+  /// \throws an std::out_of_range exception if accessing invalid positions in this or other.
+  void Copy(const std::size_t dest_from, const std::size_t dest_to, const BitVector& other,
+            const std::size_t other_from);
+
   /// \brief Returns a new BitVector containing the bits of this BitVector between positions \p from
   /// and \p to. \param from \param to
   BitVector Subset(std::size_t from, std::size_t to) const;
 
+  /// \brief Returns a new BitVector whose i-th bit is the bit of this BitVector at positions[i].
+  /// \throws an std::out_of_range exception if a position is not smaller than GetSize().
+  BitVector Gather(std::span<const std::size_t> positions) const;
+
   /// \brief Returns a string representation of this BitVector.
   std::string AsString() const noexcept;
 
@@ -351,7 +382,10 @@ class BitVector {
 
   /// \brief Returns a random BitVector.
   /// \param size The size of the returned BitVector.
-  static BitVector SecureRandom(const std::size_t size) noexcept;
+  /// \param number_of_threads The threads to generate large BitVectors with, see
+  ///        Aes128CtrRng::ParallelRandomBytes.
+  static BitVector SecureRandom(const std::size_t size,
+                                const std::size_t number_of_threads = 1) noexcept;
 
   /// \brief Returns a random BitVector using an input seed.
   /// Internally uses Mersenne twister, do not use as cryptographic randomness!
@@ -414,10 +448,25 @@ class BitVector {
   /// \brief Returns true if Allocator is aligned allocator.
   static constexpr bool IsAligned() noexcept { return std::is_same_v<Allocator, AlignedAllocator>; }
 
+  /// \brief Returns the number of set bits, same as PopCount.
   std::size_t HammingWeight() const;
 
+  /// \brief Returns the number of set bits.
+  std::size_t PopCount() const noexcept;
+
+  /// \brief Returns the XOR of all bits, i.e., whether the number of set bits is odd.
+  bool Parity() const noexcept;
+
+  /// \brief Returns the position of the first set bit, or GetSize() if no bit is set.
+  std::size_t FindFirstSet() const noexcept;
+
  private:
-  std::vector<std::byte, Allocator> data_vector_;
+  // the data of up to kInlineBytes bytes, i.e., 8 * kInlineBytes SIMD values of a wire, is stored
+  // inline without a heap allocation
+  static constexpr std::size_t kInlineBytes{16};
+  SmallByteVector<Allocator, kInlineBytes,
+                  std::is_same_v<Allocator, AlignedAllocator> ? kAlignment : alignof(std::uint64_t)>
+      data_vector_;
 
   std::size_t bit_size_;
 
@@ -799,4 +848,79 @@ class BitSpan {
 /// \brief Output string representation of BitVector to std::ostream.
 std::ostream& operator<<(std::ostream& os, const BitSpan& bit_span);
 
+namespace detail {
+
+template <typename Allocator>
+const std::byte* GetBytes(const BitVector<Allocator>& bit_vector) noexcept {
+  return bit_vector.GetData().data();
+}
+
+inline const std::byte* GetBytes(const BitSpan& bit_span) noexcept { return bit_span.GetData(); }
+
+// resizes a BitVector destination to bit_size bits, a BitSpan destination must have this size
+template <typename Allocator>
+std::byte* GetDestinationBytes(BitVector<Allocator>& destination, std::size_t bit_size) noexcept {
+  if (destination.GetSize() != bit_size) destination.Resize(bit_size);
+  return destination.GetMutableData().data();
+}
+
+inline std::byte* GetDestinationBytes(BitSpan& destination,
+                                      [[maybe_unused]] std::size_t bit_size) noexcept {
+  assert(destination.GetSize() == bit_size);
+  return destination.GetMutableData();
+}
+
+template <typename Operand, typename... Operands>
+std::size_t GetOperandSize(const Operand& operand, [[maybe_unused]] const Operands&... operands) {
+  assert(((operands.GetSize() == operand.GetSize()) && ...));
+  return operand.GetSize();
+}
+
+}  // namespace detail
+
+// Fused kernels for chains of bitwise operations on BitVectors and BitSpans of equal size, which
+// compute the whole expression in a single pass over the bytes instead of allocating a temporary
+// BitVector per operator. The destination may be one of the operands.
+
+/// \brief destination = operands[0] ^ operands[1] ^ ...
+template <typename Destination, typename... Operands>
+void XorInto(Destination& destination, const Operands&... operands) {
+  static_assert(sizeof...(Operands) > 0);
+  const std::size_t bit_size{detail::GetOperandSize(operands...)};
+  const std::array<const std::byte*, sizeof...(Operands)> inputs{detail::GetBytes(operands)...};
+  std::byte* output{detail::GetDestinationBytes(destination, bit_size)};
+  for (std::size_t k = 0; k < BitsToBytes(bit_size); ++k) {
+    std::byte result{inputs[0][k]};
+    for (std::size_t j = 1; j < inputs.size(); ++j) result ^= inputs[j][k];
+    output[k] = result;
+  }
+}
+
+/// \brief destination = a & b
+template <typename Destination, typename A, typename B>
+void AndInto(Destination& destination, const A& a, const B& b) {
+  const std::size_t bit_size{detail::GetOperandSize(a, b)};
+  const std::byte* a_bytes{detail::GetBytes(a)};
+  const std::byte* b_bytes{detail::GetBytes(b)};
+  std::byte* output{detail::GetDestinationBytes(destination, bit_size)};
+  for (std::size_t k = 0; k < BitsToBytes(bit_size); ++k) output[k] = a_bytes[k] & b_bytes[k];
+}
+
+/// \brief destination ^= (operands[0] & operands[1]) ^ (operands[2] & operands[3]) ^ ..., e.g.,
+/// for the Beaver products c ^ (d & y) ^ (e & x) of Boolean GMW. destination must have the size of
+/// the operands.
+template <typename Destination, typename... Operands>
+void XorAndInto(Destination& destination, const Operands&... operands) {
+  static_assert(sizeof...(Operands) > 0 && sizeof...(Operands) % 2 == 0);
+  const std::size_t bit_size{detail::GetOperandSize(operands...)};
+  assert(destination.GetSize() == bit_size);
+  const std::array<const std::byte*, sizeof...(Operands)> inputs{detail::GetBytes(operands)...};
+  std::byte* output{detail::GetDestinationBytes(destination, bit_size)};
+  for (std::size_t k = 0; k < BitsToBytes(bit_size); ++k) {
+    std::byte result{output[k]};
+    for (std::size_t j = 0; j < inputs.size(); j += 2) result ^= inputs[j][k] & inputs[j + 1][k];
+    output[k] = result;
+  }
+}
+
 }  // namespace encrypto::motion
@@ -22,13 +22,239 @@
 
 #include "block.h"
 #include <algorithm>
+#include <immintrin.h>
 #include <boost/algorithm/hex.hpp>
 #include <cassert>
+#include "bit_vector.h"
 #include "primitives/random/default_rng.h"
 
 
 namespace encrypto::motion {
 
+namespace {
+
+// The bulk kernels process 1, 2 or 4 blocks per register with SSE, AVX2 and AVX-512, respectively,
+// and the remaining blocks with SSE. They use unaligned loads and stores, since the blocks of a
+// wire may start at any block boundary of a label chunk. Inputs of less than kMinimumDispatchBlocks
+// blocks are always processed by the SSE kernels.
+
+constexpr std::size_t kMinimumDispatchBlocks{4};
+
+BitwiseKernel SelectKernel(std::size_t number_of_blocks) {
+  if (number_of_blocks < kMinimumDispatchBlocks) return BitwiseKernel::kSse;
+  return GetBitwiseKernel();
+}
+
+inline __m128i Load(const Block128* block) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+}
+
+inline void Store(Block128* block, __m128i value) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(block), value);
+}
+
+// bit i of the bit string, where bit 0 is the least significant bit of the first byte as in
+// BitVector
+inline bool GetBit(const std::byte* bits, std::size_t i) {
+  return std::to_integer<unsigned>(bits[i / 8] >> (i % 8)) & 1u;
+}
+
+// doubling modulo x^128 + x^7 + x^2 + x + 1 of the little-endian 128-bit integers in each lane:
+// the carries of the 64-bit halves are swapped, the carry out of the low half moves to the high
+// half and the carry out of the high half is reduced into the low half
+constexpr std::uint64_t kReductionLow{0x87}, kReductionHigh{1};
+
+void XorBlocksSse(const Block128* a, const Block128* b, Block128* out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) Store(out + i, _mm_xor_si128(Load(a + i), Load(b + i)));
+}
+
+__attribute__((target("avx2"))) void XorBlocksAvx2(const Block128* a, const Block128* b,
+                                                   Block128* out, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m256i x{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i))};
+    const __m256i y{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i))};
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(x, y));
+  }
+  XorBlocksSse(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void XorBlocksAvx512(const Block128* a, const Block128* b,
+                                                        Block128* out, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m512i x{_mm512_loadu_si512(a + i)}, y{_mm512_loadu_si512(b + i)};
+    _mm512_storeu_si512(out + i, _mm512_xor_si512(x, y));
+  }
+  XorBlocksSse(a + i, b + i, out + i, n - i);
+}
+
+void XorConstantSse(const Block128* a, const Block128& b, Block128* out, std::size_t n) {
+  const __m128i y{Load(&b)};
+  for (std::size_t i = 0; i < n; ++i) Store(out + i, _mm_xor_si128(Load(a + i), y));
+}
+
+__attribute__((target("avx2"))) void XorConstantAvx2(const Block128* a, const Block128& b,
+                                                     Block128* out, std::size_t n) {
+  const __m256i y{_mm256_broadcastsi128_si256(Load(&b))};
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m256i x{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i))};
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(x, y));
+  }
+  XorConstantSse(a + i, b, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void XorConstantAvx512(const Block128* a, const Block128& b,
+                                                          Block128* out, std::size_t n) {
+  const __m512i y{_mm512_broadcast_i32x4(Load(&b))};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm512_storeu_si512(out + i, _mm512_xor_si512(_mm512_loadu_si512(a + i), y));
+  }
+  XorConstantSse(a + i, b, out + i, n - i);
+}
+
+void SelectXorSse(const std::byte* bits, std::size_t first_bit, const Block128* a,
+                  const Block128& b, Block128* out, std::size_t n) {
+  const __m128i y{Load(&b)};
+  for (std::size_t i = 0; i < n; ++i) {
+    const __m128i mask{_mm_set1_epi64x(-static_cast<long long>(GetBit(bits, first_bit + i)))};
+    Store(out + i, _mm_xor_si128(Load(a + i), _mm_and_si128(mask, y)));
+  }
+}
+
+__attribute__((target("avx2"))) void SelectXorAvx2(const std::byte* bits, const Block128* a,
+                                                   const Block128& b, Block128* out,
+                                                   std::size_t n) {
+  const __m256i y{_mm256_broadcastsi128_si256(Load(&b))};
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const long long bit_0{-static_cast<long long>(GetBit(bits, i))};
+    const long long bit_1{-static_cast<long long>(GetBit(bits, i + 1))};
+    const __m256i mask{_mm256_set_epi64x(bit_1, bit_1, bit_0, bit_0)};
+    const __m256i x{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i))};
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_xor_si256(x, _mm256_and_si256(mask, y)));
+  }
+  SelectXorSse(bits, i, a + i, b, out + i, n - i);
+}
+
+// spreads bit k of a nibble to the bits 2k and 2k + 1 of a mask of the 64-bit lanes of 4 blocks
+constexpr std::array<std::uint8_t, 16> kNibbleToLaneMask{0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33,
+                                                         0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF,
+                                                         0xF0, 0xF3, 0xFC, 0xFF};
+
+__attribute__((target("avx512f"))) void SelectXorAvx512(const std::byte* bits, const Block128* a,
+                                                        const Block128& b, Block128* out,
+                                                        std::size_t n) {
+  const __m512i y{_mm512_broadcast_i32x4(Load(&b))};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // i is a multiple of 4, i.e., the 4 bits are a nibble of one byte
+    const unsigned nibble{std::to_integer<unsigned>(bits[i / 8] >> (i % 8)) & 0xFu};
+    const __m512i x{_mm512_loadu_si512(a + i)};
+    _mm512_storeu_si512(out + i, _mm512_mask_xor_epi64(x, kNibbleToLaneMask[nibble], x, y));
+  }
+  SelectXorSse(bits, i, a + i, b, out + i, n - i);
+}
+
+void DoubleBlocksSse(const Block128* a, Block128* out, std::size_t n) {
+  const __m128i reduction{_mm_set_epi64x(kReductionHigh, kReductionLow)};
+  for (std::size_t i = 0; i < n; ++i) {
+    const __m128i x{Load(a + i)};
+    const __m128i carries{_mm_shuffle_epi32(_mm_srli_epi64(x, 63), _MM_SHUFFLE(1, 0, 3, 2))};
+    const __m128i masks{_mm_sub_epi64(_mm_setzero_si128(), carries)};
+    Store(out + i, _mm_xor_si128(_mm_slli_epi64(x, 1), _mm_and_si128(masks, reduction)));
+  }
+}
+
+__attribute__((target("avx2"))) void DoubleBlocksAvx2(const Block128* a, Block128* out,
+                                                      std::size_t n) {
+  const __m256i reduction{
+      _mm256_set_epi64x(kReductionHigh, kReductionLow, kReductionHigh, kReductionLow)};
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m256i x{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i))};
+    const __m256i carries{
+        _mm256_shuffle_epi32(_mm256_srli_epi64(x, 63), _MM_SHUFFLE(1, 0, 3, 2))};
+    const __m256i masks{_mm256_sub_epi64(_mm256_setzero_si256(), carries)};
+    const __m256i doubled{
+        _mm256_xor_si256(_mm256_slli_epi64(x, 1), _mm256_and_si256(masks, reduction))};
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), doubled);
+  }
+  DoubleBlocksSse(a + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void DoubleBlocksAvx512(const Block128* a, Block128* out,
+                                                           std::size_t n) {
+  const __m512i reduction{_mm512_broadcast_i32x4(_mm_set_epi64x(kReductionHigh, kReductionLow))};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m512i x{_mm512_loadu_si512(a + i)};
+    const __m512i carries{_mm512_shuffle_epi32(_mm512_srli_epi64(x, 63), _MM_PERM_BADC)};
+    const __m512i masks{_mm512_sub_epi64(_mm512_setzero_si512(), carries)};
+    _mm512_storeu_si512(out + i, _mm512_xor_si512(_mm512_slli_epi64(x, 1),
+                                                  _mm512_and_si512(masks, reduction)));
+  }
+  DoubleBlocksSse(a + i, out + i, n - i);
+}
+
+}  // namespace
+
+void XorBlocks(const Block128* a, const Block128* b, Block128* out, std::size_t n) {
+  switch (SelectKernel(n)) {
+    case BitwiseKernel::kAvx512:
+      XorBlocksAvx512(a, b, out, n);
+      break;
+    case BitwiseKernel::kAvx2:
+      XorBlocksAvx2(a, b, out, n);
+      break;
+    default:
+      XorBlocksSse(a, b, out, n);
+  }
+}
+
+void XorBlocks(const Block128* a, const Block128& b, Block128* out, std::size_t n) {
+  switch (SelectKernel(n)) {
+    case BitwiseKernel::kAvx512:
+      XorConstantAvx512(a, b, out, n);
+      break;
+    case BitwiseKernel::kAvx2:
+      XorConstantAvx2(a, b, out, n);
+      break;
+    default:
+      XorConstantSse(a, b, out, n);
+  }
+}
+
+void SelectXorBlocks(const std::byte* bits, const Block128* a, const Block128& b, Block128* out,
+                     std::size_t n) {
+  switch (SelectKernel(n)) {
+    case BitwiseKernel::kAvx512:
+      SelectXorAvx512(bits, a, b, out, n);
+      break;
+    case BitwiseKernel::kAvx2:
+      SelectXorAvx2(bits, a, b, out, n);
+      break;
+    default:
+      SelectXorSse(bits, 0, a, b, out, n);
+  }
+}
+
+void DoubleBlocks(const Block128* a, Block128* out, std::size_t n) {
+  switch (SelectKernel(n)) {
+    case BitwiseKernel::kAvx512:
+      DoubleBlocksAvx512(a, out, n);
+      break;
+    case BitwiseKernel::kAvx2:
+      DoubleBlocksAvx2(a, out, n);
+      break;
+    default:
+      DoubleBlocksSse(a, out, n);
+  }
+}
+
 void Block128::SetToRandom() {
   auto& rng = DefaultRng::GetThreadInstance();
   rng.RandomBlocksAligned(byte_array.data(), 1);
@@ -46,7 +272,7 @@ std::string Block128::AsString() const {
 
 void Block128Vector::SetToRandom() {
   auto& rng = DefaultRng::GetThreadInstance();
-  rng.RandomBlocksAligned(reinterpret_cast<std::byte*>(block_vector.data()), block_vector.size());
+  rng.RandomBlocksAligned(reinterpret_cast<std::byte*>(data()), size());
 }
 
 }  // namespace encrypto::motion
@@ -24,9 +24,16 @@
 
 #include <algorithm>
 #include <array>
-#include <boost/align/aligned_allocator.hpp>
+#include <cassert>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 #include "config.h"
+#include "huge_page_allocator.h"
+#include "object_arena.h"
 
 namespace encrypto::motion {
 
@@ -166,34 +173,63 @@ struct Block128 {
   alignas(kBlockAlignment) std::array<std::byte, 16> byte_array;
 };
 
+// Bulk operations on n contiguous blocks, e.g., the labels of the SIMD values of a wire, which
+// process 1, 2 or 4 blocks per instruction with the SSE, AVX2 or AVX-512 kernel selected by
+// SetBitwiseKernel() in bit_vector.h. The blocks need no alignment beyond that of Block128, and
+// out may be equal to an input but must not overlap it otherwise.
+
+/// \brief Computes out[i] = a[i] ^ b[i] for i < n.
+void XorBlocks(const Block128* a, const Block128* b, Block128* out, std::size_t n);
+
+/// \brief Computes out[i] = a[i] ^ b for i < n, e.g., to apply the free-XOR offset.
+void XorBlocks(const Block128* a, const Block128& b, Block128* out, std::size_t n);
+
+/// \brief Computes out[i] = a[i] ^ b if bit i of \p bits is set and out[i] = a[i] otherwise for
+/// i < n without branching on the bits, where bit i is stored as in BitVector.
+void SelectXorBlocks(const std::byte* bits, const Block128* a, const Block128& b, Block128* out,
+                     std::size_t n);
+
+/// \brief Computes out[i] = 2 * a[i] for i < n, i.e., shifts the little-endian 128-bit integer
+/// a[i] to the left by one bit and reduces modulo x^128 + x^7 + x^2 + x + 1, without branching on
+/// the blocks.
+void DoubleBlocks(const Block128* a, Block128* out, std::size_t n);
+
 // XXX this should be a class due to its many functions (see
 // https://google.github.io/styleguide/cppguide.html#Structs_vs._Classes).
 /// \brief Vector of 128 bit / 16 B blocks.
+///
+/// The blocks are either owned by the vector or borrowed from memory that is kept alive by an
+/// owner, e.g., an ObjectArena or a chunk of wire labels, such that many small vectors do not
+/// need to be allocated individually. Copies of a vector always own their blocks.
 struct Block128Vector {
   static constexpr std::size_t kBlockAlignment = kAlignment;
-  using Allocator = boost::alignment::aligned_allocator<Block128, kBlockAlignment>;
+  using Allocator = HugePageAllocator<Block128, kBlockAlignment>;
   using Container = std::vector<Block128, Allocator>;
 
   // create an empty vector
   Block128Vector() = default;
 
-  // XXX Copy and move constructors/assignments can be defaulted.
   // XXX Ássignments do not check for self-assignment.
 
   // copy constructor
-  Block128Vector(const Block128Vector& other) : block_vector(other.block_vector) {}
+  Block128Vector(const Block128Vector& other) : Block128Vector(other.begin(), other.end()) {}
 
   // move constructor
-  Block128Vector(Block128Vector&& other) : block_vector(std::move(other.block_vector)) {}
+  Block128Vector(Block128Vector&& other) noexcept
+      : block_vector_(std::move(other.block_vector_)),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        owner_(std::move(other.owner_)) {}
 
   // copy assignment
-  Block128Vector& operator=(const Block128Vector& other) {
-    block_vector = other.block_vector;
-    return *this;
-  }
+  Block128Vector& operator=(const Block128Vector& other) { return *this = Block128Vector(other); }
+
   // move assignment
-  Block128Vector& operator=(Block128Vector&& other) {
-    block_vector = std::move(other.block_vector);
+  Block128Vector& operator=(Block128Vector&& other) noexcept {
+    block_vector_ = std::move(other.block_vector_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    owner_ = std::move(other.owner_);
     return *this;
   }
 
@@ -202,80 +238,127 @@ struct Block128Vector {
 
   /// \brief Creates uninitialized vector of size elements.
   /// \param size
-  Block128Vector(std::size_t size) : block_vector(size) {}
+  Block128Vector(std::size_t size) : block_vector_(size), size_(size) {
+    data_ = block_vector_.data();
+  }
 
   /// \brief Creates initialized vector of size elements with given value.
   /// \param size
   /// \param value
-  Block128Vector(std::size_t size, const Block128& value) : block_vector(size, value) {}
+  Block128Vector(std::size_t size, const Block128& value)
+      : block_vector_(size, value), size_(size) {
+    data_ = block_vector_.data();
+  }
 
   /// \brief Creates initialized vector of \p size elements read from memory.
   /// \param size
   /// \param pointer Pointer to memory.
-  Block128Vector(std::size_t size, const void* __restrict__ pointer) : block_vector(size) {
+  Block128Vector(std::size_t size, const void* __restrict__ pointer) : Block128Vector(size) {
     auto input = reinterpret_cast<const std::byte*>(pointer);
-    auto buffer = reinterpret_cast<std::byte*>(block_vector[0].data());
+    auto buffer = reinterpret_cast<std::byte*>(data());
     std::copy(input, input + 16 * size, buffer);
   }
 
-  /// \brief Creates initialized vector of \p size elements read from memory.
+  /// \brief Creates initialized vector of the elements in [\p source_begin, \p source_end).
+  /// \param source_begin
+  /// \param source_end
+  Block128Vector(const Block128* source_begin, const Block128* source_end)
+      : Block128Vector(static_cast<std::size_t>(source_end - source_begin)) {
+    std::copy(source_begin, source_end, data());
+  }
+
+  /// \brief Creates uninitialized vector of \p size elements allocated from \p arena, which is
+  /// kept alive by the vector.
   /// \param size
-  /// \param pointer Pointer to memory.
-  Block128Vector(Container::const_iterator source_begin, const Container::const_iterator source_end)
-      : block_vector(std::distance(source_begin, source_end)) {
-    auto this_begin = block_vector.begin();
-    while (source_begin != source_end) {
-      *this_begin = *source_begin;
-      std::advance(source_begin, 1);
-      std::advance(this_begin, 1);
-    }
+  /// \param arena
+  Block128Vector(std::size_t size, std::shared_ptr<ObjectArena> arena)
+      : data_(static_cast<Block128*>(
+            arena->Allocate(size * sizeof(Block128), Block128::kBlockAlignment))),
+        size_(size),
+        owner_(std::move(arena)) {}
+
+  /// \brief Creates a vector of the elements in \p blocks without copying them.
+  /// \param blocks
+  /// \param owner Keeps the memory of \p blocks alive as long as the vector uses it.
+  /// \pre \p owner is not null.
+  Block128Vector(std::span<Block128> blocks, std::shared_ptr<const void> owner)
+      : data_(blocks.data()), size_(blocks.size()), owner_(std::move(owner)) {
+    assert(owner_);
   }
 
+  /// \brief Returns whether the elements are borrowed from the memory of an owner.
+  bool IsBorrowed() const noexcept { return owner_ != nullptr; }
+
   /// \brief Access Block128 at \p index. Throws an exception if index is out of bounds.
   /// \param index
-  Block128& at(std::size_t index) { return block_vector.at(index); };
-  const Block128& at(std::size_t index) const { return block_vector.at(index); };
+  Block128& at(std::size_t index) {
+    CheckIndex(index);
+    return data_[index];
+  }
+  const Block128& at(std::size_t index) const {
+    CheckIndex(index);
+    return data_[index];
+  }
 
   /// \brief Get pointer to the first Block128.
-  Block128* data() { return block_vector.data(); }
+  Block128* data() { return data_; }
 
   /// \brief Get const pointer to the first Block128.
-  const Block128* data() const { return block_vector.data(); }
+  const Block128* data() const { return data_; }
 
   /// \brief Get size of Block128Vector.
-  std::size_t size() const { return block_vector.size(); };
+  std::size_t size() const { return size_; };
 
   /// \brief Get size of the Block128Vector content in bytes.
-  std::size_t ByteSize() const { return block_vector.size() * Block128::size(); };
+  std::size_t ByteSize() const { return size_ * Block128::size(); };
 
   /// \brief Resize the Block128Vector to contain \p new_size elements.
-  ///        New elements are left uninitialized.
+  ///        New elements are left uninitialized. Borrowed elements are copied to memory owned by
+  ///        the vector if \p new_size exceeds their number.
   /// \param new_size
-  void resize(std::size_t new_size) { block_vector.resize(new_size); }
+  void resize(std::size_t new_size) {
+    if (IsBorrowed()) {
+      if (new_size > size_) {
+        Container block_vector(new_size);
+        std::copy(data_, data_ + size_, block_vector.data());
+        block_vector_ = std::move(block_vector);
+        data_ = block_vector_.data();
+        owner_.reset();
+      }
+    } else {
+      block_vector_.resize(new_size);
+      data_ = block_vector_.data();
+    }
+    size_ = new_size;
+  }
 
   /// \brief Resize the Block128Vector to contain \p new_size elements.
   ///        New elements are set to \p value.
   /// \param new_size
   /// \param value
-  void resize(std::size_t new_size, const Block128& value) { block_vector.resize(new_size, value); }
+  void resize(std::size_t new_size, const Block128& value) {
+    const std::size_t old_size{size_};
+    resize(new_size);
+    if (new_size > old_size) std::fill(data_ + old_size, data_ + new_size, value);
+  }
 
   /// \brief Returns an iterator to the first element of the Block128Vector.
-  auto begin() { return block_vector.begin(); }
+  Block128* begin() { return data_; }
 
   /// \brief Returns a const iterator to the first element of the Block128Vector.
-  auto begin() const { return block_vector.begin(); }
+  const Block128* begin() const { return data_; }
 
   /// \brief Returns an iterator to the element following the last element of the Block128Vector.
-  auto end() { return block_vector.end(); }
+  Block128* end() { return data_ + size_; }
 
   /// \brief Returns a const iterator to the element following the last element of the
   /// Block128Vector.
-  auto end() const { return block_vector.end(); }
+  const Block128* end() const { return data_ + size_; }
 
   /// \brief Set all Block128 in this vector to zero.
   void SetToZero() {
     auto start = reinterpret_cast<std::byte* __restrict__>(
-        __builtin_assume_aligned(data(), kBlockAlignment));
+        __builtin_assume_aligned(data(), Block128::kBlockAlignment));
     std::fill(start, start + ByteSize(), std::byte(0x00));
   }
 
@@ -288,11 +371,7 @@ struct Block128Vector {
   /// \pre \p other is has the same size as this Block128Vector.
   Block128Vector& operator^=(const Block128Vector& __restrict__ other) {
     assert(size() == other.size());
-    auto k0 = reinterpret_cast<std::byte* __restrict__>(
-        __builtin_assume_aligned(block_vector.data(), kBlockAlignment));
-    auto k1 = reinterpret_cast<const std::byte* __restrict__>(
-        __builtin_assume_aligned(other.block_vector.data(), kBlockAlignment));
-    std::transform(k0, k0 + 16 * size(), k1, k0, [](auto a, auto b) { return a ^ b; });
+    XorBlocks(data(), other.data(), data(), size());
     return *this;
   }
 
@@ -303,31 +382,23 @@ struct Block128Vector {
   Block128Vector operator^(const Block128Vector& __restrict__ other) const {
     assert(size() == other.size());
     Block128Vector result(size());
-    auto k0 = reinterpret_cast<const std::byte* __restrict__>(
-        __builtin_assume_aligned(block_vector.data(), kBlockAlignment));
-    auto k1 = reinterpret_cast<const std::byte* __restrict__>(
-        __builtin_assume_aligned(other.block_vector.data(), kBlockAlignment));
-    auto kout = reinterpret_cast<std::byte* __restrict__>(
-        __builtin_assume_aligned(result.block_vector.data(), kBlockAlignment));
-    std::transform(k0, k0 + 16 * size(), k1, kout, [](auto a, auto b) { return a ^ b; });
+    XorBlocks(data(), other.data(), result.data(), size());
     return result;
   }
 
   /// \brief Access Block128 at \p index. Undefined behaviour if index is out of bounds.
   /// \param index
-  Block128& operator[](std::size_t index) { return block_vector[index]; };
+  Block128& operator[](std::size_t index) { return data_[index]; };
 
   /// \brief Access Block128 at \p index. Undefined behaviour if index is out of bounds.
   /// \param index
-  const Block128& operator[](std::size_t index) const { return block_vector[index]; };
+  const Block128& operator[](std::size_t index) const { return data_[index]; };
 
   /// \brief Creates a zero-filled vector of \p size elements.
   /// \param size
   static Block128Vector MakeZero(std::size_t size) {
     auto result = Block128Vector(size);
-    auto start = reinterpret_cast<std::byte* __restrict__>(
-        __builtin_assume_aligned(result.data(), kBlockAlignment));
-    std::fill(start, start + result.ByteSize(), std::byte(0x00));
+    result.SetToZero();
     return result;
   }
 
@@ -339,8 +410,20 @@ struct Block128Vector {
     return result;
   }
 
-  // underlying vector of blocks
-  Container block_vector;
+ private:
+  void CheckIndex(std::size_t index) const {
+    if (index >= size_) {
+      throw std::out_of_range("Block128Vector::at: index " + std::to_string(index) +
+                              " is out of range for size " + std::to_string(size_));
+    }
+  }
+
+  // the owned blocks, which are empty if the blocks are borrowed
+  Container block_vector_;
+  Block128* data_{nullptr};
+  std::size_t size_{0};
+  // keeps borrowed blocks alive, null if the blocks are owned
+  std::shared_ptr<const void> owner_;
 };
 
 }  // namespace encrypto::motion
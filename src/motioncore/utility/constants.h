@@ -57,9 +57,27 @@ constexpr std::size_t kMessageSizeBytelen{sizeof(std::uint32_t)};
 // 2^31, approx. 2 GB
 constexpr std::uint32_t kMaxMessageSize{std::numeric_limits<std::uint32_t>::max() / 2};
 
+// Prepend a compact frame header to messages carrying bulk payloads, e.g., OT extension messages,
+// such that the receiver can route them without verifying and parsing the flatbuffer.
+constexpr bool kFrameBulkMessages{true};
+
+// Drive the communication with all parties from a single event loop instead of a send and a
+// receive thread per party if all transports support asynchronous operations.
+constexpr bool kEventDrivenCommunication{true};
+
 // symmetric security parameter
 constexpr std::size_t kKappa{128};
 
+// default number of OTs in a chunk of the OT extension, which is computed, sent, transposed, and
+// hashed separately, such that the memory needed for the bit matrix is bounded, see
+// OtProviderManager::SetChunkSize
+constexpr std::size_t kOtExtensionChunkSize{std::size_t(1) << 20};
+static_assert(kOtExtensionChunkSize % kKappa == 0);
+
+// maximum number of inputs of a multi-input AND or multiplication gate, which holds shares of the
+// products of all 2^k subsets of the masks of its k inputs
+constexpr std::size_t kMaxMultiplicationFanIn{4};
+
 // stack size for fibers
 // Increase the fiber stack size when in debug mode because it requires storing additional debugging
 // information, which, however, would be an unnecessary memory overhead when built in release mode,
@@ -79,4 +97,7 @@ enum class FiberStackAllocator {
 // standard allocator for fiber stacks
 constexpr FiberStackAllocator kFiberStackAllocator{FiberStackAllocator::kFixedSize};
 
+// number of tasks a FiberThreadPool buffers before posting blocks, independent of the circuit size
+constexpr std::size_t kFiberTaskQueueCapacity{64};
+
 }  // namespace encrypto::motion
@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "contention_tracing.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <tuple>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+namespace {
+
+// file names and function names of std::source_location have static storage duration, the same
+// call site in an inline function may be seen with different pointers from different translation
+// units, hence the key compares the strings
+using SiteKey = std::tuple<WaitPrimitive, std::string_view, std::uint_least32_t, std::string_view>;
+
+std::mutex contention_mutex;
+std::size_t number_of_open_sessions = 0;
+std::map<SiteKey, ContentionSite> contention_sites;
+
+ContentionSite& GetSite(WaitPrimitive primitive, const std::source_location& location) {
+  SiteKey key{primitive, location.file_name(), location.line(), location.function_name()};
+  auto [iterator, inserted] = contention_sites.try_emplace(key);
+  if (inserted) {
+    iterator->second.primitive = primitive;
+    iterator->second.file_name = location.file_name();
+    iterator->second.line = location.line();
+    iterator->second.function_name = location.function_name();
+  }
+  return iterator->second;
+}
+
+double ToMilliseconds(ContentionSite::Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace
+
+std::string to_string(WaitPrimitive primitive) {
+  switch (primitive) {
+    case WaitPrimitive::kFiberCondition:
+      return "FiberCondition";
+    case WaitPrimitive::kFiberSignal:
+      return "FiberSignal";
+    case WaitPrimitive::kReusableFiberFuture:
+      return "ReusableFiberFuture";
+    case WaitPrimitive::kSynchronizedQueue:
+      return "SynchronizedQueue";
+    case WaitPrimitive::kSynchronizedFiberQueue:
+      return "SynchronizedFiberQueue";
+    case WaitPrimitive::kLockedFiberQueue:
+      return "LockedFiberQueue";
+    case WaitPrimitive::kMpscFiberQueue:
+      return "MpscFiberQueue";
+  }
+  return "InvalidWaitPrimitive";
+}
+
+std::string ContentionReport::PrintTopN(std::size_t n) const {
+  std::vector<const ContentionSite*> waits, wake_ups;
+  for (const auto& site : sites) {
+    if (site.number_of_waits > 0) waits.push_back(&site);
+    if (site.number_of_wake_ups > 0) wake_ups.push_back(&site);
+  }
+  std::sort(waits.begin(), waits.end(), [](auto a, auto b) {
+    return a->total_wait_time > b->total_wait_time;
+  });
+  std::sort(wake_ups.begin(), wake_ups.end(), [](auto a, auto b) {
+    return a->number_of_woken_waiters > b->number_of_woken_waiters;
+  });
+  const auto print_site = [](const ContentionSite& site) {
+    return fmt::format("{:<24} {}:{} {}\n", to_string(site.primitive), site.file_name, site.line,
+                       site.function_name);
+  };
+
+  std::string result{fmt::format("Waits, top {} of {} call sites by total wait time\n",
+                                 std::min(n, waits.size()), waits.size())};
+  result += fmt::format("{:>12} {:>10} {:>12}  {}\n", "total ms", "waits", "max ms", "site");
+  for (std::size_t i = 0; i < std::min(n, waits.size()); ++i) {
+    result += fmt::format("{:>12.3f} {:>10} {:>12.3f}  ", ToMilliseconds(waits[i]->total_wait_time),
+                          waits[i]->number_of_waits, ToMilliseconds(waits[i]->max_wait_time));
+    result += print_site(*waits[i]);
+  }
+  result += fmt::format("Wake-ups, top {} of {} call sites by woken waiters\n",
+                        std::min(n, wake_ups.size()), wake_ups.size());
+  result += fmt::format("{:>12} {:>10}  {}\n", "woken", "notifies", "site");
+  for (std::size_t i = 0; i < std::min(n, wake_ups.size()); ++i) {
+    result += fmt::format("{:>12} {:>10}  ", wake_ups[i]->number_of_woken_waiters,
+                          wake_ups[i]->number_of_wake_ups);
+    result += print_site(*wake_ups[i]);
+  }
+  return result;
+}
+
+void ContentionTracer::BeginSession() {
+  std::scoped_lock lock(contention_mutex);
+  if (number_of_open_sessions++ == 0) {
+    contention_sites.clear();
+    enabled_ = true;
+  }
+}
+
+ContentionReport ContentionTracer::EndSession() {
+  std::scoped_lock lock(contention_mutex);
+  ContentionReport report;
+  report.sites.reserve(contention_sites.size());
+  for (const auto& [key, site] : contention_sites) report.sites.push_back(site);
+  if (number_of_open_sessions > 0 && --number_of_open_sessions == 0) {
+    enabled_ = false;
+  }
+  return report;
+}
+
+void ContentionTracer::RecordWait(WaitPrimitive primitive, const std::source_location& location,
+                                  Duration duration) {
+  std::scoped_lock lock(contention_mutex);
+  auto& site{GetSite(primitive, location)};
+  ++site.number_of_waits;
+  site.total_wait_time += duration;
+  site.max_wait_time = std::max(site.max_wait_time, duration);
+}
+
+void ContentionTracer::RecordWakeUp(WaitPrimitive primitive, const std::source_location& location,
+                                    std::size_t number_of_woken_waiters) {
+  std::scoped_lock lock(contention_mutex);
+  auto& site{GetSite(primitive, location)};
+  ++site.number_of_wake_ups;
+  site.number_of_woken_waiters += number_of_woken_waiters;
+}
+
+}  // namespace encrypto::motion
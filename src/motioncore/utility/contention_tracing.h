@@ -0,0 +1,138 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <source_location>
+#include <string>
+#include <vector>
+
+namespace encrypto::motion {
+
+/// \brief The synchronization primitives whose waits are traced by ContentionTracer.
+enum class WaitPrimitive : std::uint8_t {
+  kFiberCondition,
+  kFiberSignal,
+  kReusableFiberFuture,
+  kSynchronizedQueue,
+  kSynchronizedFiberQueue,
+  kLockedFiberQueue,
+  kMpscFiberQueue
+};
+
+std::string to_string(WaitPrimitive primitive);
+
+/// \brief The waits and wake-ups at one call site of a primitive during a tracing session.
+struct ContentionSite {
+  using Duration = std::chrono::steady_clock::duration;
+
+  WaitPrimitive primitive;
+  std::string file_name;
+  std::uint_least32_t line;
+  std::string function_name;
+
+  /// waits that actually blocked, waits on values that are already ready are not recorded
+  std::size_t number_of_waits = 0;
+  Duration total_wait_time{0};
+  Duration max_wait_time{0};
+
+  /// notifications that found blocked waiters and the number of waiters they woke
+  std::size_t number_of_wake_ups = 0;
+  std::size_t number_of_woken_waiters = 0;
+};
+
+/// \brief The contention recorded by ContentionTracer between BeginSession() and EndSession().
+struct ContentionReport {
+  std::vector<ContentionSite> sites;
+
+  /// \brief Prints the \p n call sites with the longest total wait time and the \p n call sites
+  ///        whose notifications woke the most waiters.
+  std::string PrintTopN(std::size_t n = 10) const;
+};
+
+/// \brief Process-wide tracing of where fibers and threads block on FiberCondition, FiberSignal,
+///        ReusableFiberFuture and the synchronized queues, keyed by primitive and call site.
+///        Since the primitives do not know their party, the waits of all parties of a process are
+///        recorded while any session is open, e.g., of both parties of a local test.
+///        Disabled, a traced wait or notification costs a relaxed atomic load.
+class ContentionTracer {
+ public:
+  using Duration = ContentionSite::Duration;
+
+  static bool IsEnabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+  /// \brief Enables the tracing, the first open session clears the records of previous sessions.
+  static void BeginSession();
+
+  /// \brief Returns the records so far, the last open session disables the tracing.
+  static ContentionReport EndSession();
+
+  static void RecordWait(WaitPrimitive primitive, const std::source_location& location,
+                         Duration duration);
+
+  static void RecordWakeUp(WaitPrimitive primitive, const std::source_location& location,
+                           std::size_t number_of_woken_waiters);
+
+ private:
+  static inline std::atomic<bool> enabled_{false};
+};
+
+/// \brief Records the time between its construction and destruction as a wait at \p location
+///        if tracing is enabled. Only used where the caller actually blocks.
+class TracedWait {
+ public:
+  TracedWait(WaitPrimitive primitive, const std::source_location& location)
+      : primitive_(primitive), location_(location), traced_(ContentionTracer::IsEnabled()) {
+    if (traced_) [[unlikely]] {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  TracedWait(const TracedWait&) = delete;
+  TracedWait& operator=(const TracedWait&) = delete;
+
+  ~TracedWait() {
+    if (traced_) [[unlikely]] {
+      ContentionTracer::RecordWait(primitive_, location_,
+                                   std::chrono::steady_clock::now() - start_);
+    }
+  }
+
+ private:
+  WaitPrimitive primitive_;
+  std::source_location location_;
+  bool traced_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/// \brief Records a notification at \p location that wakes \p number_of_woken_waiters.
+inline void TraceWakeUp(WaitPrimitive primitive, const std::source_location& location,
+                        std::size_t number_of_woken_waiters) {
+  if (number_of_woken_waiters > 0 && ContentionTracer::IsEnabled()) [[unlikely]] {
+    ContentionTracer::RecordWakeUp(primitive, location, number_of_woken_waiters);
+  }
+}
+
+}  // namespace encrypto::motion
@@ -26,7 +26,13 @@
 
 #include <boost/fiber/condition_variable.hpp>
 #include <boost/fiber/mutex.hpp>
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <source_location>
+
+#include "contention_tracing.h"
+#include "profiled_wait.h"
 
 namespace encrypto::motion {
 
@@ -50,9 +56,14 @@ class FiberCondition {
   // }
 
   /// \brief Blocks until fiber is notified and condition_function_ returns true.
-  void Wait() const {
+  void Wait(std::source_location location = std::source_location::current()) const {
     std::unique_lock<decltype(mutex_)> lock(mutex_);
+    if (condition_function_()) return;
+    ProfiledWait profiled_wait(ProfiledWait::Kind::kPreprocessing);
+    TracedWait traced_wait(WaitPrimitive::kFiberCondition, location);
+    number_of_waiters_.fetch_add(1, std::memory_order_relaxed);
     condition_variable_.wait(lock, condition_function_);
+    number_of_waiters_.fetch_sub(1, std::memory_order_relaxed);
   }
 
   /// \brief Blocks until fiber is notified and condition_function_ returns true
@@ -65,10 +76,18 @@ class FiberCondition {
   }
 
   /// \brief Unblocks one thread waiting for condition_variable_.
-  void NotifyOne() const noexcept { condition_variable_.notify_one(); }
+  void NotifyOne(std::source_location location = std::source_location::current()) const noexcept {
+    TraceWakeUp(WaitPrimitive::kFiberCondition, location,
+                std::min<std::size_t>(1, number_of_waiters_.load(std::memory_order_relaxed)));
+    condition_variable_.notify_one();
+  }
 
   /// \brief Unblocks all threads waiting for condition_variable_.
-  void NotifyAll() const noexcept { condition_variable_.notify_all(); }
+  void NotifyAll(std::source_location location = std::source_location::current()) const noexcept {
+    TraceWakeUp(WaitPrimitive::kFiberCondition, location,
+                number_of_waiters_.load(std::memory_order_relaxed));
+    condition_variable_.notify_all();
+  }
 
   /// \brief Get the mutex.
   /// \note The variables that the condition function depends on shall
@@ -79,6 +98,8 @@ class FiberCondition {
   mutable boost::fibers::condition_variable condition_variable_;
   mutable boost::fibers::mutex mutex_;
   const std::function<bool()> condition_function_;
+  // fibers blocked in Wait(), only used for tracing the number of woken waiters
+  mutable std::atomic<std::size_t> number_of_waiters_{0};
 };
 
 }  // namespace encrypto::motion
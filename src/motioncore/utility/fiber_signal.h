@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <source_location>
+
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+
+#include "contention_tracing.h"
+#include "profiled_wait.h"
+
+namespace encrypto::motion {
+
+/// \brief One-shot readiness flag that fibers can wait on.
+///
+/// In contrast to FiberCondition, the signal only consists of an atomic flag and a pointer to its
+/// waiters. Wait() returns without locking if the signal is already set, and the fiber mutex and
+/// condition variable are only allocated when a fiber actually has to block.
+class FiberSignal {
+ public:
+  FiberSignal() = default;
+  FiberSignal(const FiberSignal&) = delete;
+  FiberSignal& operator=(const FiberSignal&) = delete;
+
+  ~FiberSignal() { delete waiters_.load(); }
+
+  const std::atomic<bool>& IsSet() const noexcept { return is_set_; }
+
+  /// \brief Blocks until the signal is set.
+  void Wait(std::source_location location = std::source_location::current()) const {
+    if (is_set_.load()) return;
+    ProfiledWait profiled_wait(ProfiledWait::Kind::kDependency);
+    TracedWait traced_wait(WaitPrimitive::kFiberSignal, location);
+    auto& waiters{GetWaiters()};
+    std::unique_lock lock(waiters.mutex);
+    ++waiters.number_of_waiters;
+    waiters.condition_variable.wait(lock, [this] { return is_set_.load(); });
+    --waiters.number_of_waiters;
+  }
+
+  /// \brief Sets the signal and wakes up all waiting fibers.
+  /// \returns false if the signal was already set.
+  bool Set(std::source_location location = std::source_location::current()) {
+    if (is_set_.exchange(true)) return false;
+    // Wait() registers its waiters before checking the flag, so either the waiting fiber sees the
+    // flag or we see its waiters here. Locking the mutex makes sure a fiber that has checked the
+    // flag is already blocked on the condition variable before it is notified.
+    if (auto waiters{waiters_.load()}; waiters != nullptr) {
+      std::size_t number_of_waiters;
+      {
+        std::scoped_lock lock(waiters->mutex);
+        number_of_waiters = waiters->number_of_waiters;
+      }
+      TraceWakeUp(WaitPrimitive::kFiberSignal, location, number_of_waiters);
+      waiters->condition_variable.notify_all();
+    }
+    return true;
+  }
+
+  /// \brief Resets the signal, e.g., for reusing a circuit. Must not race with Wait().
+  void Reset() noexcept { is_set_ = false; }
+
+ private:
+  struct Waiters {
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable condition_variable;
+    // guarded by mutex, only used for tracing
+    std::size_t number_of_waiters = 0;
+  };
+
+  Waiters& GetWaiters() const {
+    auto waiters{waiters_.load()};
+    if (waiters == nullptr) {
+      auto new_waiters{new Waiters};
+      if (waiters_.compare_exchange_strong(waiters, new_waiters)) {
+        waiters = new_waiters;
+      } else {
+        delete new_waiters;
+      }
+    }
+    return *waiters;
+  }
+
+  std::atomic<bool> is_set_{false};
+  mutable std::atomic<Waiters*> waiters_{nullptr};
+};
+
+}  // namespace encrypto::motion
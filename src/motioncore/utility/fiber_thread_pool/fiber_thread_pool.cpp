@@ -22,6 +22,7 @@
 
 #include <fmt/format.h>
 #include <algorithm>
+#include <bit>
 #include <boost/context/fixedsize_stack.hpp>
 #include <boost/context/protected_fixedsize_stack.hpp>
 #include <boost/fiber/barrier.hpp>
@@ -31,6 +32,7 @@
 #include <boost/fiber/operations.hpp>
 #include <cassert>
 #include <iostream>
+#include <numeric>
 #include <thread>
 
 #include "pooled_work_stealing.hpp"
@@ -41,20 +43,25 @@
 
 namespace encrypto::motion {
 
-FiberThreadPool::FiberThreadPool(std::size_t number_of_workers, std::size_t number_of_tasks,
-                                 bool suspend_scheduler)
+FiberThreadPool::FiberThreadPool(std::size_t number_of_workers, std::size_t task_queue_capacity,
+                                 bool suspend_scheduler, bool pin_threads,
+                                 FiberStackAllocator stack_allocator)
     : number_of_workers_(number_of_workers > 0 ? number_of_workers
                          : std::thread::hardware_concurrency()),
       running_(false),
       suspend_scheduler_(suspend_scheduler),
-      task_queue_(std::make_unique<boost::fibers::buffered_channel<task_t>>(64)),
+      pin_threads_(pin_threads),
+      stack_allocator_(stack_allocator),
+      // the channel requires a power of two of at least 2
+      task_queue_(std::make_unique<boost::fibers::buffered_channel<task_t>>(std::bit_ceil(
+          std::max<std::size_t>(task_queue_capacity > 0 ? task_queue_capacity
+                                                        : kFiberTaskQueueCapacity,
+                                2)))),
       worker_barrier_(std::make_unique<boost::fibers::barrier>(number_of_workers_)) {
     if (number_of_workers_ == 1) {
         throw std::invalid_argument("FiberThreadPool needs at least two worker threads");
     }
 
-    (void)number_of_tasks;
-
     // create the worker threads
     create_threads();
 }
@@ -107,12 +114,29 @@ static void worker_fctn(std::shared_ptr<pool_ctx> pool_ctx,
 void FiberThreadPool::create_threads() {
     assert(worker_threads_.empty());
 
+    // assign the workers to logical cpus such that one NUMA node is filled after another
+    std::vector<std::size_t> worker_cpus;
+    std::vector<std::uint32_t> worker_numa_nodes;
+    if (pin_threads_) {
+        const auto cpu_numa_nodes = GetCpuNumaNodes();
+        std::vector<std::size_t> cpus(cpu_numa_nodes.size());
+        std::iota(cpus.begin(), cpus.end(), 0);
+        std::stable_sort(cpus.begin(), cpus.end(), [&cpu_numa_nodes](auto lhs, auto rhs) {
+            return cpu_numa_nodes[lhs] < cpu_numa_nodes[rhs];
+        });
+        for (std::size_t i = 0; i < number_of_workers_; ++i) {
+            worker_cpus.push_back(cpus[i % cpus.size()]);
+            worker_numa_nodes.push_back(cpu_numa_nodes[worker_cpus.back()]);
+        }
+    }
+
     // create a pool context which is used to coordinate the worker threads'
     // schedulers
-    pool_ctx_ = pooled_work_stealing::create_pool_ctx(number_of_workers_, suspend_scheduler_);
+    pool_ctx_ = pooled_work_stealing::create_pool_ctx(number_of_workers_, suspend_scheduler_,
+                                                      std::move(worker_numa_nodes));
 
     std::function<decltype(worker_fctn<boost::context::fixedsize_stack>)> worker_function;
-    switch (kFiberStackAllocator) {
+    switch (stack_allocator_) {
     case FiberStackAllocator::kFixedSize:
         worker_function = worker_fctn<boost::context::fixedsize_stack>;
         break;
@@ -133,6 +157,9 @@ void FiberThreadPool::create_threads() {
         if constexpr (kDebug) {
             ThreadSetName(t, fmt::format("pool-worker-{}", i));
         }
+        if (pin_threads_) {
+            ThreadSetAffinity(t, worker_cpus[i]);
+        }
     }
     running_ = true;
 }
@@ -145,9 +172,29 @@ void FiberThreadPool::join() {
     running_ = false;
 }
 
+std::size_t FiberThreadPool::get_number_of_steals() const {
+    return pooled_work_stealing::get_number_of_steals(*pool_ctx_);
+}
+
+std::size_t FiberThreadPool::get_number_of_parks() const {
+    return pooled_work_stealing::get_number_of_parks(*pool_ctx_);
+}
+
 void FiberThreadPool::post(std::function<void()> fctn) {
     assert(running_);
-    task_queue_->push(fctn);
+    number_of_pending_tasks_.fetch_add(1);
+    task_queue_->push([this, fctn = std::move(fctn)] {
+        fctn();
+        if (number_of_pending_tasks_.fetch_sub(1) == 1) {
+            std::scoped_lock lock(idle_mutex_);
+            idle_condition_.notify_all();
+        }
+    });
+}
+
+void FiberThreadPool::wait_idle() {
+    std::unique_lock lock(idle_mutex_);
+    idle_condition_.wait(lock, [this] { return number_of_pending_tasks_ == 0; });
 }
 
 }  // namespace encrypto::motion
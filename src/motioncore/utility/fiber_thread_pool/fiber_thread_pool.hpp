@@ -21,11 +21,16 @@
 #ifndef FIBER_THREAD_POOL_HPP
 #define FIBER_THREAD_POOL_HPP
 
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
+#include "utility/constants.h"
+
 namespace boost::fibers {
 
 class barrier;
@@ -46,20 +51,32 @@ public:
     // - number_of_workers
     //   if 0 then the value of std::thread::hardware_concurrency() is used
     //   else it must be at least 2
-    // - number_of_tasks
-    //   number of tasks that are to be expected
+    // - task_queue_capacity
+    //   number of posted tasks that may wait for a worker, rounded up to a power of two,
+    //   if 0 then kFiberTaskQueueCapacity is used
     // - suspend_scheduler
     //   suspend if there is no work to be done
-    FiberThreadPool(std::size_t number_of_workers, std::size_t number_of_tasks = 0,
-                    bool suspend_scheduler = true);
+    // - pin_threads
+    //   pin each worker to a logical cpu, filling one NUMA node after another, and let the
+    //   workers steal from workers of their own node first
+    // - stack_allocator
+    //   allocator for the fibers' stacks, kPooledFixedSize keeps freed stacks for reuse
+    FiberThreadPool(std::size_t number_of_workers, std::size_t task_queue_capacity = 0,
+                    bool suspend_scheduler = true, bool pin_threads = false,
+                    FiberStackAllocator stack_allocator = kFiberStackAllocator);
 
     // Destructor, calls join() if necessary
     ~FiberThreadPool();
 
     // Post a new task to the pool's queue.
-    // This may block if the task queue is currently full
+    // This blocks the calling thread or fiber while the task queue is full, so the memory of the
+    // queue does not grow with the number of posted tasks
     void post(task_t task);
 
+    // Block until all previously posted tasks have been completed.  The pool
+    // stays open such that it can be reused for further tasks.
+    void wait_idle();
+
     // Close the pool.  No new tasks can be posted to the pool.
     // Note: Be sure that all previously posted tasks has been completed before
     // you call this method.
@@ -69,12 +86,22 @@ public:
     // No new fibers must be created during this call.
     void join_fibers();
 
+    // Number of fibers stolen from other workers and number of times a worker suspended
+    // because it had no work, accumulated since the pool was created.
+    std::size_t get_number_of_steals() const;
+    std::size_t get_number_of_parks() const;
+
 private:
     void create_threads();
 
     std::size_t number_of_workers_;
     bool running_;
     bool suspend_scheduler_;
+    bool pin_threads_;
+    FiberStackAllocator stack_allocator_;
+    std::atomic<std::size_t> number_of_pending_tasks_{0};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_condition_;
     std::unique_ptr<boost::fibers::buffered_channel<task_t>> task_queue_;
     std::unique_ptr<boost::fibers::barrier> worker_barrier_;
     std::vector<std::thread> worker_threads_;
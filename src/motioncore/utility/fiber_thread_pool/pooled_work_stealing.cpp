@@ -19,32 +19,57 @@
 // clang-format off
 
 struct pool_ctx {
-    pool_ctx(std::uint32_t thread_count, bool suspend)
+    pool_ctx(std::uint32_t thread_count, bool suspend, std::vector<std::uint32_t> numa_nodes)
         : thread_count_(thread_count),
           suspend_(suspend),
           counter_(0),
           schedulers_(thread_count, nullptr),
+          numa_nodes_(numa_nodes.empty() ? std::vector<std::uint32_t>(thread_count, 0)
+                                         : std::move(numa_nodes)),
           barrier_(thread_count) {
         BOOST_ASSERT(thread_count > 1);
+        BOOST_ASSERT(numa_nodes_.size() == thread_count);
     }
     const std::uint32_t thread_count_;
     const bool suspend_;
     std::atomic<std::uint32_t> counter_;
     std::vector<pooled_work_stealing*> schedulers_;
+    const std::vector<std::uint32_t> numa_nodes_;
+    std::atomic<std::uint64_t> number_of_steals_{0};
+    std::atomic<std::uint64_t> number_of_parks_{0};
     boost::barrier barrier_;
 };
 
 std::shared_ptr<pool_ctx> pooled_work_stealing::create_pool_ctx(std::uint32_t thread_count,
-        bool suspend) {
-    auto ctx = std::make_shared<pool_ctx>(thread_count, suspend);
+        bool suspend, std::vector<std::uint32_t> numa_nodes) {
+    auto ctx = std::make_shared<pool_ctx>(thread_count, suspend, std::move(numa_nodes));
     return ctx;
 }
 
+std::uint64_t pooled_work_stealing::get_number_of_steals(pool_ctx const& ctx) noexcept {
+    return ctx.number_of_steals_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t pooled_work_stealing::get_number_of_parks(pool_ctx const& ctx) noexcept {
+    return ctx.number_of_parks_.load(std::memory_order_relaxed);
+}
+
 pooled_work_stealing::pooled_work_stealing(std::shared_ptr<pool_ctx> pool_ctx)
     : pool_ctx_{pool_ctx},
       id_{pool_ctx_->counter_++},
       thread_count_{pool_ctx_->thread_count_},
       suspend_{pool_ctx_->suspend_} {
+    for (std::uint32_t id = 0; id < thread_count_; ++id) {
+        if (id == id_) {
+            continue;
+        }
+        if (pool_ctx_->numa_nodes_[id] == pool_ctx_->numa_nodes_[id_]) {
+            local_victims_.push_back(id);
+        }
+        else {
+            remote_victims_.push_back(id);
+        }
+    }
     pool_ctx_->schedulers_[id_] = this;
     pool_ctx_->barrier_.wait();
 }
@@ -71,25 +96,13 @@ boost::fibers::context* pooled_work_stealing::pick_next() noexcept {
         }
     }
     else {
-        std::uint32_t id = 0;
-        std::size_t count = 0, size = pool_ctx_->schedulers_.size();
-        static thread_local std::minstd_rand generator{std::random_device{}()};
-        std::uniform_int_distribution<std::uint32_t> distribution{
-            0, static_cast<std::uint32_t>(thread_count_ - 1)};
-        do {
-            do {
-                ++count;
-                // random selection of one logical cpu
-                // that belongs to the local NUMA node
-                id = distribution(generator);
-                // prevent stealing from own scheduler
-            }
-            while (id == id_);
-            // steal context from other scheduler
-            victim = pool_ctx_->schedulers_[id]->steal();
+        // prefer fibers of schedulers on the same NUMA node to keep their data in local memory
+        victim = steal_from_(local_victims_);
+        if (nullptr == victim) {
+            victim = steal_from_(remote_victims_);
         }
-        while (nullptr == victim && count < size);
         if (nullptr != victim) {
+            pool_ctx_->number_of_steals_.fetch_add(1, std::memory_order_relaxed);
             boost::context::detail::prefetch_range(victim, sizeof(boost::fibers::context));
             BOOST_ASSERT(!victim->is_context(boost::fibers::type::pinned_context));
             boost::fibers::context::active()->attach(victim);
@@ -98,9 +111,28 @@ boost::fibers::context* pooled_work_stealing::pick_next() noexcept {
     return victim;
 }
 
+boost::fibers::context* pooled_work_stealing::steal_from_(
+    std::vector<std::uint32_t> const& victims) noexcept {
+    if (victims.empty()) {
+        return nullptr;
+    }
+    static thread_local std::minstd_rand generator{std::random_device{}()};
+    std::uniform_int_distribution<std::size_t> distribution{0, victims.size() - 1};
+    // try each candidate once, starting at a random one
+    const std::size_t offset = distribution(generator);
+    for (std::size_t i = 0; i < victims.size(); ++i) {
+        auto id = victims[(offset + i) % victims.size()];
+        if (auto victim = pool_ctx_->schedulers_[id]->steal(); nullptr != victim) {
+            return victim;
+        }
+    }
+    return nullptr;
+}
+
 void pooled_work_stealing::suspend_until(
     std::chrono::steady_clock::time_point const& time_point) noexcept {
     if (suspend_) {
+        pool_ctx_->number_of_parks_.fetch_add(1, std::memory_order_relaxed);
         if ((std::chrono::steady_clock::time_point::max)() == time_point) {
             std::unique_lock<std::mutex> lk{mtx_};
             cnd_.wait(lk, [this]() {
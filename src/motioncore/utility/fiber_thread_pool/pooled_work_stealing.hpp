@@ -37,6 +37,9 @@ class pooled_work_stealing : public boost::fibers::algo::algorithm {
 
     std::uint32_t id_;
     std::uint32_t thread_count_;
+    // other schedulers on the same NUMA node and on different nodes, stolen from in this order
+    std::vector<std::uint32_t> local_victims_;
+    std::vector<std::uint32_t> remote_victims_;
 #ifdef BOOST_FIBERS_USE_SPMC_QUEUE
     boost::fibers::detail::context_spmc_queue rqueue_ {};
 #else
@@ -49,8 +52,16 @@ class pooled_work_stealing : public boost::fibers::algo::algorithm {
 
     static void init_(std::uint32_t, std::vector<boost::intrusive_ptr<pooled_work_stealing>>&);
 
+    boost::fibers::context* steal_from_(std::vector<std::uint32_t> const&) noexcept;
+
 public:
-    static std::shared_ptr<pool_ctx> create_pool_ctx(std::uint32_t, bool = false);
+    // numa_nodes optionally assigns a NUMA node to each scheduler, which is used to steal from
+    // schedulers on the same node first
+    static std::shared_ptr<pool_ctx> create_pool_ctx(std::uint32_t, bool = false,
+                                                     std::vector<std::uint32_t> numa_nodes = {});
+    // number of successful steals and suspensions of all schedulers of the pool
+    static std::uint64_t get_number_of_steals(pool_ctx const&) noexcept;
+    static std::uint64_t get_number_of_parks(pool_ctx const&) noexcept;
     pooled_work_stealing(std::shared_ptr<pool_ctx>);
     ~pooled_work_stealing();
 
@@ -24,38 +24,22 @@
 
 #include "fiber_waitable.h"
 
-#include "fiber_condition.h"
-
 namespace encrypto::motion {
 
-FiberSetupWaitable::FiberSetupWaitable() {
-  setup_ready_condition_ =
-      std::make_unique<FiberCondition>([this]() { return setup_ready_.load(); });
+void FiberSetupWaitable::WaitSetup(std::source_location location) const {
+  setup_ready_.Wait(location);
 }
 
-void FiberSetupWaitable::WaitSetup() const { setup_ready_condition_->Wait(); }
-
-void FiberSetupWaitable::SetSetupIsReady() {
-  {
-    std::scoped_lock lock(setup_ready_condition_->GetMutex());
-    setup_ready_.store(true);
-  }
-  setup_ready_condition_->NotifyAll();
+void FiberSetupWaitable::SetSetupIsReady(std::source_location location) {
+  setup_ready_.Set(location);
 }
 
-FiberOnlineWaitable::FiberOnlineWaitable() {
-  online_ready_condition_ =
-      std::make_unique<FiberCondition>([this]() { return online_ready_.load(); });
+void FiberOnlineWaitable::WaitOnline(std::source_location location) const {
+  online_ready_.Wait(location);
 }
 
-void FiberOnlineWaitable::WaitOnline() const { online_ready_condition_->Wait(); }
-
-void FiberOnlineWaitable::SetOnlineIsReady() {
-  {
-    std::scoped_lock lock(online_ready_condition_->GetMutex());
-    online_ready_.store(true);
-  }
-  online_ready_condition_->NotifyAll();
+void FiberOnlineWaitable::SetOnlineIsReady(std::source_location location) {
+  online_ready_.Set(location);
 }
 
 }  // namespace encrypto::motion
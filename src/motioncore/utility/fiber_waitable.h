@@ -24,45 +24,38 @@
 
 #pragma once
 
-#include <atomic>
-#include <memory>
+#include <source_location>
 
-namespace encrypto::motion {
+#include "fiber_signal.h"
 
-class FiberCondition;
+namespace encrypto::motion {
 
 class FiberSetupWaitable {
  public:
-  FiberSetupWaitable();
+  void WaitSetup(std::source_location location = std::source_location::current()) const;
 
-  void WaitSetup() const;
+  void SetSetupIsReady(std::source_location location = std::source_location::current());
 
-  void SetSetupIsReady();
+  bool IsSetupReady() { return setup_ready_.IsSet(); }
 
-  bool IsSetupReady() { return setup_ready_; }
-
-  void ResetSetupIsReady() { setup_ready_.store(false); }
+  void ResetSetupIsReady() { setup_ready_.Reset(); }
 
  protected:
-  std::atomic<bool> setup_ready_{false};
-  std::shared_ptr<FiberCondition> setup_ready_condition_;
+  FiberSignal setup_ready_;
 };
 
 class FiberOnlineWaitable {
  public:
-  FiberOnlineWaitable();
-
-  void WaitOnline() const;
+  void WaitOnline(std::source_location location = std::source_location::current()) const;
 
-  void SetOnlineIsReady();
+  void SetOnlineIsReady(std::source_location location = std::source_location::current());
 
-  bool IsOnlineReady() { return online_ready_; }
+  bool IsOnlineReady() { return online_ready_.IsSet(); }
 
-  void ResetOnlineIsReady() { online_ready_.store(false); }
+  void ResetOnlineIsReady() { online_ready_.Reset(); }
 
  protected:
-  std::atomic<bool> online_ready_{false};
-  std::shared_ptr<FiberCondition> online_ready_condition_;
+  FiberSignal online_ready_;
 };
 
 }  // namespace encrypto::motion
@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+
+namespace encrypto::motion {
+
+// Coroutine of the online phase of a gate, see Gate::EvaluateOnlineCoroutine. It is created
+// suspended and started once with Start or Run. Its co_await expressions on ReusableFuture suspend
+// the coroutine until the value is set and let the scheduler of Start resume it, e.g., as a new
+// task of the fiber pool, or block in place if the coroutine is run without a scheduler.
+class GateTask {
+ public:
+  // resumes a suspended coroutine
+  using Scheduler = std::function<void(std::coroutine_handle<>)>;
+  // called with the exception of the coroutine, if any, after the coroutine finished
+  using Completion = std::function<void(std::exception_ptr)>;
+
+  class promise_type {
+   public:
+    GateTask get_return_object() noexcept {
+      return GateTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // destroys the frame before calling the completion, which may destroy the gate
+    struct FinalAwaiter {
+      bool await_ready() const noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+        auto completion{std::move(handle.promise().completion_)};
+        auto exception{std::move(handle.promise().exception_)};
+        handle.destroy();
+        if (completion) completion(std::move(exception));
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    // empty if awaits have to block instead of suspending the coroutine
+    const Scheduler& GetScheduler() const noexcept { return scheduler_; }
+
+   private:
+    friend GateTask;
+
+    Scheduler scheduler_;
+    Completion completion_;
+    std::exception_ptr exception_;
+  };
+
+  GateTask(GateTask&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+  GateTask(const GateTask&) = delete;
+
+  GateTask& operator=(GateTask&& other) noexcept {
+    if (this != &other) {
+      if (handle_) handle_.destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  GateTask& operator=(const GateTask&) = delete;
+
+  ~GateTask() {
+    if (handle_) handle_.destroy();
+  }
+
+  // runs the coroutine in the calling thread until it finishes or suspends, after which the
+  // scheduler resumes it, and hands over the ownership of the coroutine frame
+  void Start(Scheduler scheduler, Completion completion) && {
+    auto handle{std::exchange(handle_, nullptr)};
+    handle.promise().scheduler_ = std::move(scheduler);
+    handle.promise().completion_ = std::move(completion);
+    handle.resume();
+  }
+
+  // runs the coroutine to completion in the calling thread, i.e., its awaits block, and rethrows
+  // its exception
+  void Run() && {
+    std::exception_ptr exception;
+    std::move(*this).Start(nullptr, [&exception](std::exception_ptr e) { exception = e; });
+    if (exception) std::rethrow_exception(exception);
+  }
+
+ private:
+  explicit GateTask(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+}  // namespace encrypto::motion
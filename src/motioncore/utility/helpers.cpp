@@ -33,22 +33,29 @@ namespace encrypto::motion {
 /// \brief Returns a vector of \p length random unsigned integral values.
 /// \tparam UnsignedIntegralType
 /// \param length
+/// \param number_of_threads
 template <typename UnsignedIntegralType>
-std::vector<UnsignedIntegralType> RandomVector(std::size_t length) {
+std::vector<UnsignedIntegralType> RandomVector(std::size_t length,
+                                               std::size_t number_of_threads) {
   const auto byte_size = sizeof(UnsignedIntegralType) * length;
   std::vector<UnsignedIntegralType> vec(length);
 
   auto& rng = DefaultRng::GetThreadInstance();
-  rng.RandomBytes(reinterpret_cast<std::byte*>(vec.data()), byte_size);
+  rng.ParallelRandomBytes(reinterpret_cast<std::byte*>(vec.data()), byte_size, number_of_threads);
 
   return vec;
 }
 
-template std::vector<std::uint8_t> RandomVector<std::uint8_t>(std::size_t length);
-template std::vector<std::uint16_t> RandomVector<std::uint16_t>(std::size_t length);
-template std::vector<std::uint32_t> RandomVector<std::uint32_t>(std::size_t length);
-template std::vector<std::uint64_t> RandomVector<std::uint64_t>(std::size_t length);
-template std::vector<__uint128_t> RandomVector<__uint128_t>(std::size_t length);
+template std::vector<std::uint8_t> RandomVector<std::uint8_t>(std::size_t length,
+                                                              std::size_t number_of_threads);
+template std::vector<std::uint16_t> RandomVector<std::uint16_t>(std::size_t length,
+                                                                std::size_t number_of_threads);
+template std::vector<std::uint32_t> RandomVector<std::uint32_t>(std::size_t length,
+                                                                std::size_t number_of_threads);
+template std::vector<std::uint64_t> RandomVector<std::uint64_t>(std::size_t length,
+                                                                std::size_t number_of_threads);
+template std::vector<__uint128_t> RandomVector<__uint128_t>(std::size_t length,
+                                                            std::size_t number_of_threads);
 
 std::size_t DivideAndCeil(std::size_t dividend, std::size_t divisor) {
   assert(divisor != 0);
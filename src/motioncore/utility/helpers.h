@@ -29,8 +29,10 @@
 #include <algorithm>
 #include <bit>
 #include <cassert>
+#include <cmath>
 #include <concepts>
 #include <cstdint>
+#include <cstring>
 #include <random>
 #include <span>
 #include <string>
@@ -46,8 +48,11 @@ namespace encrypto::motion {
 /// \brief Returns a vector of \p length random unsigned integral values.
 /// \tparam UnsignedIntegralType
 /// \param length
+/// \param number_of_threads threads to generate large vectors with, see
+///        Aes128CtrRng::ParallelRandomBytes
 template <typename UnsignedIntegralType>
-std::vector<UnsignedIntegralType> RandomVector(std::size_t length);
+std::vector<UnsignedIntegralType> RandomVector(std::size_t length,
+                                               std::size_t number_of_threads = 1);
 
 /// \brief Converts a vector of unsigned integral values to a vector of uint8_t
 /// \tparam UnsignedIntegralType
@@ -75,6 +80,178 @@ inline std::vector<UnsignedIntegralType> FromByteVector(std::span<const std::uin
   return result;
 }
 
+// The output-parameter kernels below are vectorized with omp simd, which lets the compiler emit
+// the widest vector instructions of the target (-march=native, i.e., AVX2 or AVX-512) for all lane
+// widths, including 8 and 64 bit multiplications without a native instruction. omp simd only
+// asserts that there are no loop-carried dependencies, so result may be identical to a or b.
+
+/// \brief Writes the sum of each element in \p a and \p b to \p result.
+/// \pre \p a, \p b, and \p result must be of equal size, \p result may be \p a or \p b but
+///      must not partially overlap them.
+template <typename T>
+inline void AddVectors(std::span<const T> a, std::span<const T> b, std::span<T> result) {
+  assert(a.size() == b.size());
+  assert(a.size() == result.size());
+  const T* a_pointer{a.data()};
+  const T* b_pointer{b.data()};
+  T* result_pointer{result.data()};
+#pragma omp simd
+  for (std::size_t j = 0; j < result.size(); ++j) {
+    result_pointer[j] = a_pointer[j] + b_pointer[j];
+  }
+}
+
+/// \brief Writes the difference of each element in \p a and \p b to \p result.
+/// \pre \p a, \p b, and \p result must be of equal size, \p result may be \p a or \p b but
+///      must not partially overlap them.
+template <typename T>
+inline void SubVectors(std::span<const T> a, std::span<const T> b, std::span<T> result) {
+  assert(a.size() == b.size());
+  assert(a.size() == result.size());
+  const T* a_pointer{a.data()};
+  const T* b_pointer{b.data()};
+  T* result_pointer{result.data()};
+#pragma omp simd
+  for (std::size_t j = 0; j < result.size(); ++j) {
+    result_pointer[j] = a_pointer[j] - b_pointer[j];
+  }
+}
+
+/// \brief Writes the product of each element in \p a and \p b to \p result.
+/// \pre \p a, \p b, and \p result must be of equal size, \p result may be \p a or \p b but
+///      must not partially overlap them.
+template <typename T>
+inline void MultiplyVectors(std::span<const T> a, std::span<const T> b, std::span<T> result) {
+  assert(a.size() == b.size());
+  assert(a.size() == result.size());
+  const T* a_pointer{a.data()};
+  const T* b_pointer{b.data()};
+  T* result_pointer{result.data()};
+#pragma omp simd
+  for (std::size_t j = 0; j < result.size(); ++j) {
+    result_pointer[j] = a_pointer[j] * b_pointer[j];
+  }
+}
+
+/// \brief Adds each element in \p b to the element at the same position in \p accumulator.
+/// \pre \p accumulator and \p b must be of equal size.
+template <typename T>
+inline void AddToVector(std::span<T> accumulator, std::span<const T> b) {
+  AddVectors<T>(accumulator, b, accumulator);
+}
+
+/// \brief Adds the product of the row-major \p rows x \p inner matrix \p a and \p inner x
+///        \p columns matrix \p b to the row-major \p rows x \p columns matrix \p c.
+///        The product is computed in blocks of kInnerBlockSize rows and kColumnBlockSize columns
+///        of \p b, which stay in the L1 cache while all rows of \p a are multiplied with them, and
+///        the innermost loop is a vectorized multiply-add over contiguous columns. Products with
+///        fewer columns, e.g., matrix-vector products, are vectorized along the inner dimension
+///        instead, where the transposed \p b keeps the dot products contiguous.
+/// \pre \p c must not overlap \p a or \p b.
+template <typename T>
+inline void AddMatrixProduct(const T* a, const T* b, T* c, std::size_t rows, std::size_t inner,
+                             std::size_t columns) {
+  constexpr std::size_t kInnerBlockSize{64}, kColumnBlockSize{256 / sizeof(T)};
+  // fewer columns than fit into a 256-bit vector register
+  constexpr std::size_t kMinimumNumberOfColumns{32 / sizeof(T)};
+  if (columns < kMinimumNumberOfColumns) {
+    std::vector<T> b_transposed(columns > 1 ? inner * columns : 0);
+    const T* b_columns{b};
+    if (columns > 1) {
+      for (std::size_t l = 0; l < inner; ++l) {
+        for (std::size_t m = 0; m < columns; ++m) {
+          b_transposed[m * inner + l] = b[l * columns + m];
+        }
+      }
+      b_columns = b_transposed.data();
+    }
+    for (std::size_t r = 0; r < rows; ++r) {
+      const T* a_row{a + r * inner};
+      for (std::size_t m = 0; m < columns; ++m) {
+        const T* b_column{b_columns + m * inner};
+        T sum{0};
+#pragma omp simd reduction(+ : sum)
+        for (std::size_t l = 0; l < inner; ++l) {
+          sum += a_row[l] * b_column[l];
+        }
+        c[r * columns + m] += sum;
+      }
+    }
+    return;
+  }
+  for (std::size_t column_begin = 0; column_begin < columns; column_begin += kColumnBlockSize) {
+    const std::size_t column_end{std::min(column_begin + kColumnBlockSize, columns)};
+    for (std::size_t inner_begin = 0; inner_begin < inner; inner_begin += kInnerBlockSize) {
+      const std::size_t inner_end{std::min(inner_begin + kInnerBlockSize, inner)};
+      for (std::size_t r = 0; r < rows; ++r) {
+        T* c_row{c + r * columns};
+        for (std::size_t l = inner_begin; l < inner_end; ++l) {
+          const T a_rl{a[r * inner + l]};
+          const T* b_row{b + l * columns};
+#pragma omp simd
+          for (std::size_t m = column_begin; m < column_end; ++m) {
+            c_row[m] += a_rl * b_row[m];
+          }
+        }
+      }
+    }
+  }
+}
+
+/// \brief Adds the values of type T serialized in \p bytes, which need not be aligned for T, to
+///        the elements at the same positions in \p accumulator.
+///        For rings smaller than 64 bit, 64-bit words of several lanes are added at once (SWAR):
+///        the lanes are added without their high bits, such that the carries do not cross the
+///        lane boundaries, and the high bits are xored in afterwards.
+/// \pre \p bytes must hold exactly accumulator.size() values.
+template <typename T>
+inline void AddBytesToVector(std::span<T> accumulator, std::span<const std::uint8_t> bytes) {
+  assert(bytes.size() == accumulator.size() * sizeof(T));
+  std::size_t offset{0};
+  if constexpr (std::is_unsigned_v<T> && sizeof(T) < sizeof(std::uint64_t)) {
+    constexpr std::uint64_t kHighBits{(~std::uint64_t(0) / static_cast<T>(~T(0))) *
+                                      (std::uint64_t(1) << (sizeof(T) * 8 - 1))};
+    auto destination{reinterpret_cast<std::uint8_t*>(accumulator.data())};
+    for (; offset + sizeof(std::uint64_t) <= bytes.size(); offset += sizeof(std::uint64_t)) {
+      std::uint64_t a, b;
+      std::memcpy(&a, destination + offset, sizeof(a));
+      std::memcpy(&b, bytes.data() + offset, sizeof(b));
+      const std::uint64_t sum{((a & ~kHighBits) + (b & ~kHighBits)) ^ ((a ^ b) & kHighBits)};
+      std::memcpy(destination + offset, &sum, sizeof(sum));
+    }
+  }
+  for (std::size_t i = offset / sizeof(T); i < accumulator.size(); ++i) {
+    T value;
+    std::memcpy(&value, bytes.data() + i * sizeof(T), sizeof(T));
+    accumulator[i] += value;
+  }
+}
+
+/// \brief Calls \p function(begin, end) for the ranges that split [0, \p size) evenly among
+///        \p number_of_threads OpenMP threads, e.g., the SIMD values of a very wide gate, see
+///        Configuration::SetParallelGateThreshold. The beginning of each range is a multiple of
+///        \p alignment. With a single thread, \p function(0, \p size) runs on the calling thread.
+template <typename Function>
+inline void ParallelForRanges(std::size_t size, std::size_t number_of_threads,
+                              std::size_t alignment, Function&& function) {
+  assert(alignment > 0);
+  // rounded up to the alignment, such that a single range remains for small sizes
+  const std::size_t range_size{
+      number_of_threads <= 1
+          ? size
+          : ((size + number_of_threads - 1) / number_of_threads + alignment - 1) / alignment *
+                alignment};
+  if (range_size >= size) {
+    function(std::size_t(0), size);
+    return;
+  }
+  const std::size_t number_of_ranges{(size + range_size - 1) / range_size};
+#pragma omp parallel for num_threads(number_of_threads)
+  for (std::size_t i = 0; i < number_of_ranges; ++i) {
+    function(i * range_size, std::min(size, (i + 1) * range_size));
+  }
+}
+
 /// \brief Adds each element in \p a and \p b and returns the result.
 /// \tparam T type of the elements in the vectors. T must provide the += operator.
 /// \param a
@@ -84,14 +261,8 @@ inline std::vector<UnsignedIntegralType> FromByteVector(std::span<const std::uin
 template <typename T>
 inline std::vector<T> AddVectors(std::span<const T> a, std::span<const T> b) {
   assert(a.size() == b.size());
-  if (a.size() == 0) {
-    return {};
-  }  // if empty input vector
-  std::vector<T> result(a.begin(), a.end());
-#pragma omp simd
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result[j] += b[j];  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  AddVectors<T>(a, b, result);
   return result;
 }
 
@@ -107,10 +278,8 @@ inline std::vector<T> SubVectors(std::span<const T> a, std::span<const T> b) {
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result(a.begin(), a.end());
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result[j] -= b[j];  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  SubVectors<T>(a, b, result);
   return result;
 }
 
@@ -126,11 +295,8 @@ inline std::vector<T> MultiplyVectors(std::span<const T> a, std::span<const T> b
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result(a.begin(), a.end());
-
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result[j] *= b[j];  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  MultiplyVectors<T>(a, b, result);
   return result;
 }
 
@@ -151,9 +317,7 @@ inline std::vector<T> AddVectors(std::span<const std::vector<T>> vectors) {
   for (auto i = 1ull; i < vectors.size(); ++i) {
     auto& inner_vector = vectors[i];
     assert(inner_vector.size() == result.size());  // expect the vectors to be of the same size
-    for (auto j = 0ull; j < result.size(); ++j) {
-      result[j] += inner_vector[j];  // TODO: implement using AVX2 and AVX512
-    }
+    AddToVector<T>(result, inner_vector);
   }
   return result;
 }
@@ -185,11 +349,7 @@ inline std::vector<T> RestrictAddVectors(std::span<const T> a, std::span<const T
     return {};
   }  // if empty input vector
   std::vector<T> result(a.size());
-  const T* __restrict__ a_pointer{a.data()};
-  const T* __restrict__ b_pointer{b.data()};
-  T* __restrict__ result_pointer{result.data()};
-  std::transform(a_pointer, a_pointer + a.size(), b_pointer, result_pointer,
-                 [](const T& a_value, const T& b_value) { return a_value + b_value; });
+  AddVectors<T>(a, b, result);
   return result;
 }
 
@@ -207,11 +367,7 @@ inline std::vector<T> RestrictSubVectors(std::span<const T> a, std::span<const T
     return {};
   }  // if empty input vector
   std::vector<T> result(a.size());
-  const T* __restrict__ a_pointer{a.data()};
-  const T* __restrict__ b_pointer{b.data()};
-  T* __restrict__ result_pointer{result.data()};
-  std::transform(a_pointer, a_pointer + a.size(), b_pointer, result_pointer,
-                 [](const T& a_value, const T& b_value) { return a_value - b_value; });
+  SubVectors<T>(a, b, result);
   return result;
 }
 
@@ -229,11 +385,7 @@ inline std::vector<T> RestrictMulVectors(std::span<const T> a, std::span<const T
     return {};
   }  // if empty input vector
   std::vector<T> result(a.size());
-  const T* __restrict__ a_pointer{a.data()};
-  const T* __restrict__ b_pointer{b.data()};
-  T* __restrict__ result_pointer{result.data()};
-  std::transform(a_pointer, a_pointer + a.size(), b_pointer, result_pointer,
-                 [](const T& a_value, const T& b_value) { return a_value * b_value; });
+  MultiplyVectors<T>(a, b, result);
   return result;
 }
 
@@ -288,6 +440,24 @@ inline T MulReduction(std::span<const T> values) {
   }
 }
 
+/// \brief Writes the sum of each row in a matrix to \p sum, see the allocating version below.
+///        The rows are accumulated one after the other, such that each step is a vectorized
+///        AddToVector over contiguous memory.
+/// \pre All vectors in \p values and \p sum must be of equal size.
+template <typename T>
+inline void RowSumReduction(std::span<const std::vector<T>> values, std::span<T> sum) {
+  if (values.size() == 0) {
+    std::fill(sum.begin(), sum.end(), T(0));
+    return;
+  }
+  assert(values[0].size() == sum.size());
+  std::copy(values[0].begin(), values[0].end(), sum.begin());
+  for (auto i = 1ull; i < values.size(); ++i) {
+    assert(values[i].size() == sum.size());
+    AddToVector<T>(sum, values[i]);
+  }
+}
+
 /// \brief Returns the sum of each row in a matrix.
 /// \tparam T type of the elements in the vectors. T must provide the += operator.
 /// \param values A vector of vectors.
@@ -304,16 +474,8 @@ inline std::vector<T> RowSumReduction(std::span<const std::vector<T>> values) {
     return {};
   } else {
     std::vector<T> sum(values[0].size());
-    for (auto i = 1ull; i < values.size(); ++i) {
-      assert(values[0].size() == values[i].size());
-    }
-
-    for (auto i = 0ull; i < sum.size(); ++i) {
-      for (auto j = 0ull; j < values.size(); ++j) {
-        sum[i] += values[j][i];
-      }
-    }
-    return std::move(sum);
+    RowSumReduction<T>(values, sum);
+    return sum;
   }
 }
 
@@ -540,4 +702,19 @@ auto FromTwosComplement(const std::vector<T>& input) {
   return result;
 }
 
+// encodes x as two's complement fixed-point number with number_of_fractional_bits fractional bits,
+// i.e., as round(x * 2^number_of_fractional_bits) modulo 2^k
+template <std::unsigned_integral T>
+T ToFixedPoint(double x, std::size_t number_of_fractional_bits) {
+  using S = typename std::make_signed_t<T>;
+  return std::bit_cast<T>(
+      static_cast<S>(std::llround(std::ldexp(x, static_cast<int>(number_of_fractional_bits)))));
+}
+
+template <std::unsigned_integral T>
+double FromFixedPoint(T x, std::size_t number_of_fractional_bits) {
+  return std::ldexp(static_cast<double>(FromTwosComplement(x)),
+                    -static_cast<int>(number_of_fractional_bits));
+}
+
 }  // namespace encrypto::motion
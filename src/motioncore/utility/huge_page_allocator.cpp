@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "huge_page_allocator.h"
+
+#include <sys/mman.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace encrypto::motion {
+
+namespace {
+
+// Large buffers are allocated with operator new aligned to kHugePageSize, such that freed buffers
+// are reused by the heap as before, and transparent huge pages are requested by madvise. Only
+// explicit huge pages need their own mappings, whose lengths are stored until they are unmapped.
+
+constexpr std::size_t kGiganticPageSize{std::size_t(1) << 30};
+
+std::atomic<HugePageMode> huge_page_mode{HugePageMode::kNone};
+
+std::mutex explicit_mappings_mutex;
+std::unordered_map<void*, std::size_t> explicit_mappings;
+
+constexpr std::size_t RoundUp(std::size_t value, std::size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// maps explicit huge pages of page_size bytes or returns nullptr if none are available
+void* MapExplicitHugePages(std::size_t bytes, std::size_t page_size) {
+#ifdef MAP_HUGETLB
+  const std::size_t length{RoundUp(bytes, page_size)};
+  const int page_size_flag{(page_size == kGiganticPageSize ? 30 : 21) << MAP_HUGE_SHIFT};
+  void* pointer{mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | page_size_flag, -1, 0)};
+  if (pointer == MAP_FAILED) return nullptr;
+  std::scoped_lock lock(explicit_mappings_mutex);
+  explicit_mappings.emplace(pointer, length);
+  return pointer;
+#else
+  return nullptr;
+#endif
+}
+
+}  // namespace
+
+void SetHugePageMode(HugePageMode mode) noexcept { huge_page_mode.store(mode); }
+
+HugePageMode GetHugePageMode() noexcept { return huge_page_mode.load(); }
+
+void* AllocateHugePages(std::size_t bytes, std::size_t alignment) {
+  if (bytes < kHugePageSize) return ::operator new(bytes, std::align_val_t(alignment));
+
+  const HugePageMode mode{huge_page_mode.load(std::memory_order_relaxed)};
+  if (mode == HugePageMode::kExplicit) {
+    if (bytes >= kGiganticPageSize) {
+      if (void* pointer{MapExplicitHugePages(bytes, kGiganticPageSize)}) return pointer;
+    }
+    if (void* pointer{MapExplicitHugePages(bytes, kHugePageSize)}) return pointer;
+  }
+  void* pointer{::operator new(bytes, std::align_val_t(std::max(alignment, kHugePageSize)))};
+#ifdef MADV_HUGEPAGE
+  // only the huge pages that lie completely in the buffer can be advised
+  if (mode != HugePageMode::kNone) {
+    madvise(pointer, bytes / kHugePageSize * kHugePageSize, MADV_HUGEPAGE);
+  }
+#endif
+  return pointer;
+}
+
+void DeallocateHugePages(void* pointer, std::size_t bytes, std::size_t alignment) noexcept {
+  if (bytes < kHugePageSize) {
+    ::operator delete(pointer, std::align_val_t(alignment));
+    return;
+  }
+  {
+    std::scoped_lock lock(explicit_mappings_mutex);
+    if (auto iterator{explicit_mappings.find(pointer)}; iterator != explicit_mappings.end()) {
+      munmap(pointer, iterator->second);
+      explicit_mappings.erase(iterator);
+      return;
+    }
+  }
+  ::operator delete(pointer, std::align_val_t(std::max(alignment, kHugePageSize)));
+}
+
+}  // namespace encrypto::motion
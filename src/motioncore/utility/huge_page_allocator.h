@@ -0,0 +1,108 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace encrypto::motion {
+
+/// \brief Page sizes for the large buffers of HugePageAllocator, e.g., the OT extension matrices
+/// and the preprocessed correlations.
+enum class HugePageMode : unsigned int {
+  /// normal pages
+  kNone = 0,
+  /// transparent huge pages, i.e., the buffers are aligned to 2 MiB and madvise(MADV_HUGEPAGE) asks
+  /// the kernel to back them with huge pages where possible
+  kTransparent = 1,
+  /// explicit huge pages of 1 GiB for buffers of at least 1 GiB and of 2 MiB otherwise, which need
+  /// to be reserved by the administrator, e.g., via /proc/sys/vm/nr_hugepages, and fall back to
+  /// transparent huge pages if none are available
+  kExplicit = 2
+};
+
+/// \brief Selects the pages of the buffers allocated from now on by all HugePageAllocators of the
+/// process, see Configuration::SetHugePageMode.
+void SetHugePageMode(HugePageMode mode) noexcept;
+
+/// \brief Returns the pages used for new buffers by HugePageAllocators, kNone by default.
+HugePageMode GetHugePageMode() noexcept;
+
+/// Buffers of at least kHugePageSize bytes are large and may be backed by huge pages.
+constexpr std::size_t kHugePageSize{std::size_t(1) << 21};
+
+/// \brief Allocates \p bytes bytes aligned to \p alignment, where large buffers are aligned to
+/// kHugePageSize and backed by pages as selected by SetHugePageMode.
+/// \throws std::bad_alloc
+void* AllocateHugePages(std::size_t bytes, std::size_t alignment);
+
+/// \brief Frees a buffer of AllocateHugePages with the same \p bytes and \p alignment.
+void DeallocateHugePages(void* pointer, std::size_t bytes, std::size_t alignment) noexcept;
+
+/// \brief Allocator of buffers aligned to kAlignment, which can be backed by huge pages to avoid
+/// TLB misses when large buffers are accessed with large strides, e.g., in the transpositions of
+/// OT extension. It is stateless and the page size is a process-wide setting, hence it is a
+/// drop-in for other aligned allocators, e.g., of AlignedBitVector and Block128Vector.
+template <typename T, std::size_t kAlignment>
+class HugePageAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = HugePageAllocator<U, kAlignment>;
+  };
+
+  HugePageAllocator() noexcept = default;
+
+  template <typename U>
+  HugePageAllocator(const HugePageAllocator<U, kAlignment>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+    return static_cast<T*>(AllocateHugePages(n * sizeof(T), kAlignmentOfT));
+  }
+
+  void deallocate(T* pointer, std::size_t n) noexcept {
+    DeallocateHugePages(pointer, n * sizeof(T), kAlignmentOfT);
+  }
+
+  template <typename U>
+  bool operator==(const HugePageAllocator<U, kAlignment>&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const HugePageAllocator<U, kAlignment>&) const noexcept {
+    return false;
+  }
+
+ private:
+  static constexpr std::size_t kAlignmentOfT{std::max(kAlignment, alignof(T))};
+};
+
+}  // namespace encrypto::motion
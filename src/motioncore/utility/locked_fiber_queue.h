@@ -25,11 +25,15 @@
 
 #include <boost/fiber/condition_variable.hpp>
 #include <boost/fiber/mutex.hpp>
+#include <algorithm>
 #include <future>
 #include <iostream>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <source_location>
+
+#include "contention_tracing.h"
 
 namespace encrypto::motion {
 
@@ -58,49 +62,64 @@ class LockedFiberQueue {
   /**
    * Close the queue.
    */
-  void close() noexcept {
+  void close(std::source_location location = std::source_location::current()) noexcept {
+    std::size_t number_of_waiters;
     {
       std::scoped_lock lock(mutex_);
       closed_ = true;
+      number_of_waiters = number_of_waiters_;
     }
+    TraceWakeUp(WaitPrimitive::kLockedFiberQueue, location, number_of_waiters);
     condition_variable_.notify_all();
   }
 
   /**
    * Adds a new element to the queue.
    */
-  void enqueue(const T& item) {
+  void enqueue(const T& item, std::source_location location = std::source_location::current()) {
     if (closed_) {
       throw std::logic_error("Tried to enqueue in closed LockedFiberQueue");
     }
+    std::size_t number_of_waiters;
     {
       std::scoped_lock lock(mutex_);
       queue_.push(item);
+      number_of_waiters = number_of_waiters_;
     }
+    TraceWakeUp(WaitPrimitive::kLockedFiberQueue, location,
+                std::min<std::size_t>(1, number_of_waiters));
     condition_variable_.notify_one();
   }
 
-  void enqueue(T&& item) {
+  void enqueue(T&& item, std::source_location location = std::source_location::current()) {
     if (closed_) {
       throw std::logic_error("Tried to enqueue in closed LockedFiberQueue");
     }
+    std::size_t number_of_waiters;
     {
       std::scoped_lock lock(mutex_);
       queue_.push(std::move(item));
+      number_of_waiters = number_of_waiters_;
     }
+    TraceWakeUp(WaitPrimitive::kLockedFiberQueue, location,
+                std::min<std::size_t>(1, number_of_waiters));
     condition_variable_.notify_one();
   }
 
   /**
    * Receives an element from the queue.
    */
-  std::optional<T> dequeue() noexcept {
+  std::optional<T> dequeue(
+      std::source_location location = std::source_location::current()) noexcept {
     std::unique_lock lock(mutex_);
     if (queue_.empty() && closed_) {
       return std::nullopt;
     }
     if (queue_.empty() && !closed_) {
+      TracedWait traced_wait(WaitPrimitive::kLockedFiberQueue, location);
+      ++number_of_waiters_;
       condition_variable_.wait(lock, [this] { return !this->queue_.empty() || this->closed_; });
+      --number_of_waiters_;
     }
     if (queue_.empty()) {
       return std::nullopt;
@@ -114,6 +133,8 @@ class LockedFiberQueue {
  private:
   bool closed_ = false;
   std::queue<T> queue_;
+  // number of blocked consumers, guarded by mutex_ and only used for tracing
+  std::size_t number_of_waiters_ = 0;
   mutable boost::fibers::mutex mutex_;
   boost::fibers::condition_variable_any condition_variable_;
 };
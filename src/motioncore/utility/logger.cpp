@@ -26,6 +26,7 @@
 
 #include "logger.h"
 
+#include <boost/log/attributes/constant.hpp>
 #include <boost/log/attributes/scoped_attribute.hpp>
 #include <boost/log/core/core.hpp>
 #include <boost/log/expressions.hpp>
@@ -39,10 +40,12 @@
 #include <boost/log/utility/setup/file.hpp>
 
 #include <fmt/format.h>
+#include <boost/date_time/c_local_time_adjustor.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/log/support/date_time.hpp>
 #include <chrono>
 #include <ctime>
+#include <vector>
 
 #include "utility/constants.h"
 
@@ -53,13 +56,42 @@ namespace sinks = boost::log::sinks;
 namespace expr = boost::log::expressions;
 
 BOOST_LOG_ATTRIBUTE_KEYWORD(id_channel, "Channel", std::size_t)
+// the time at which a message of the fast path was logged, which is earlier than its TimeStamp
+BOOST_LOG_ATTRIBUTE_KEYWORD(capture_time, "CaptureTime", boost::posix_time::ptime)
 
 namespace encrypto::motion {
 
+namespace {
+
+constexpr auto kFlushInterval{std::chrono::milliseconds(10)};
+
+std::atomic<std::uint64_t> next_logger_serial_number{1};
+
+// the ring buffer of the last Logger the calling thread used the fast path of
+struct ThreadBufferCache {
+  std::uint64_t serial_number = 0;
+  detail::LogRingBuffer* buffer = nullptr;
+};
+
+thread_local ThreadBufferCache thread_buffer_cache;
+
+boost::posix_time::ptime ToLocalTime(std::chrono::system_clock::time_point time) {
+  const auto microseconds{
+      std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count()};
+  const boost::posix_time::ptime utc{
+      boost::posix_time::from_time_t(microseconds / 1'000'000) +
+      boost::posix_time::microseconds(microseconds % 1'000'000)};
+  return boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(utc);
+}
+
+}  // namespace
+
 std::mutex Logger::boost_log_core_mutex_;
 
 Logger::Logger(std::size_t my_id, boost::log::trivial::severity_level severity_level)
-    : my_id_(my_id) {
+    : my_id_(my_id),
+      severity_level_(severity_level),
+      serial_number_(next_logger_serial_number.fetch_add(1, std::memory_order_relaxed)) {
   // immediately write messages to the log file to see them also if the
   // execution stalls
   constexpr auto kAutoFlush = kDebug ? true : false;
@@ -73,9 +105,12 @@ Logger::Logger(std::size_t my_id, boost::log::trivial::severity_level severity_l
   g_file_sink_ = logging::add_file_log(
       keywords::file_name = filename,
       keywords::format =
-          (expr::stream << expr::format_date_time<boost::posix_time::ptime>("TimeStamp",
-                                                                            "%Y-%m-%d %H:%M:%S.%f")
-                        << ": <" << logging::trivial::severity << "> " << expr::smessage),
+          (expr::stream
+           << expr::if_(expr::has_attr(capture_time))
+                  [expr::stream << expr::format_date_time(capture_time, "%Y-%m-%d %H:%M:%S.%f")]
+                      .else_[expr::stream << expr::format_date_time<boost::posix_time::ptime>(
+                                 "TimeStamp", "%Y-%m-%d %H:%M:%S.%f")]
+           << ": <" << logging::trivial::severity << "> " << expr::smessage),
       keywords::filter = id_channel == my_id_, keywords::auto_flush = kAutoFlush,
       keywords::open_mode = std::ios_base::app | std::ios_base::out,
       keywords::rotation_size = 100 * kMb);
@@ -85,9 +120,18 @@ Logger::Logger(std::size_t my_id, boost::log::trivial::severity_level severity_l
   logging::core::get()->set_filter(logging::trivial::severity >= severity_level);
   logging::add_common_attributes();
   logger_ = std::make_unique<LoggerType>(keywords::channel = my_id);
+  buffered_logger_ = std::make_unique<LoggerType>(keywords::channel = my_id);
+  flush_thread_ = std::thread([this] { FlushLoop(); });
 }
 
 Logger::~Logger() {
+  {
+    std::scoped_lock lock(flush_thread_mutex_);
+    stop_flush_thread_ = true;
+  }
+  flush_thread_condition_.notify_one();
+  flush_thread_.join();
+  Flush();
   std::lock_guard<std::mutex> lock(boost_log_core_mutex_);
   logging::core::get()->remove_sink(g_file_sink_);
   g_file_sink_.reset();
@@ -171,6 +215,50 @@ void Logger::LogError(std::string&& message) {
   }
 }
 
+void Logger::Flush() {
+  std::vector<detail::LogRingBuffer::Entry> entries;
+  std::scoped_lock flush_lock(flush_mutex_);
+  {
+    std::scoped_lock lock(buffers_mutex_);
+    for (auto& [thread_id, buffer] : buffers_) {
+      buffer->PopAll([&entries](const auto& entry) { entries.push_back(entry); });
+    }
+  }
+  if (entries.empty()) return;
+  // the messages of different threads are interleaved in the order they were logged
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const auto& a, const auto& b) { return a.time < b.time; });
+  std::scoped_lock lock(write_mutex_);
+  for (const auto& entry : entries) {
+    BOOST_LOG_SCOPED_LOGGER_ATTR(*buffered_logger_, "CaptureTime",
+                                 boost::log::attributes::constant<boost::posix_time::ptime>(
+                                     ToLocalTime(entry.time)));
+    BOOST_LOG_SEV(*buffered_logger_, entry.severity_level)
+        << std::string_view(entry.message.data(), entry.size);
+  }
+}
+
+detail::LogRingBuffer& Logger::GetThreadBuffer() {
+  if (thread_buffer_cache.serial_number == serial_number_) [[likely]] {
+    return *thread_buffer_cache.buffer;
+  }
+  std::scoped_lock lock(buffers_mutex_);
+  auto& buffer{buffers_[std::this_thread::get_id()]};
+  if (!buffer) buffer = std::make_unique<detail::LogRingBuffer>();
+  thread_buffer_cache = {serial_number_, buffer.get()};
+  return *buffer;
+}
+
+void Logger::FlushLoop() {
+  std::unique_lock lock(flush_thread_mutex_);
+  while (!stop_flush_thread_) {
+    flush_thread_condition_.wait_for(lock, kFlushInterval, [this] { return stop_flush_thread_; });
+    lock.unlock();
+    Flush();
+    lock.lock();
+  }
+}
+
 void Logger::SetEnabled(bool enable) {
   logging_enabled_ = enable;
   std::lock_guard<std::mutex> lock(boost_log_core_mutex_);
@@ -24,19 +24,74 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/text_file_backend.hpp>
 #include <boost/log/sources/severity_channel_logger.hpp>
 #include <boost/log/trivial.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <fmt/format.h>
 
 namespace encrypto::motion {
 
 using LoggerType =
     boost::log::sources::severity_channel_logger<boost::log::trivial::severity_level, std::size_t>;
 
+namespace detail {
+
+// Lock-free ring buffer of formatted log messages with a single producer, the thread owning it,
+// and a single consumer, the thread flushing the messages of a Logger.
+class LogRingBuffer {
+ public:
+  static constexpr std::size_t kCapacity{512};
+  // longer messages are truncated
+  static constexpr std::size_t kMessageSize{232};
+
+  struct Entry {
+    std::chrono::system_clock::time_point time;
+    boost::log::trivial::severity_level severity_level;
+    std::size_t size;
+    std::array<char, kMessageSize> message;
+  };
+
+  // returns the entry to be written next or nullptr if the buffer is full
+  Entry* BeginPush() noexcept {
+    const auto head{head_.load(std::memory_order_relaxed)};
+    if (head - tail_.load(std::memory_order_acquire) == kCapacity) return nullptr;
+    return &entries_[head % kCapacity];
+  }
+
+  // publishes the entry returned by BeginPush() to the consumer
+  void EndPush() noexcept {
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // calls function for all published entries and frees them
+  template <typename Function>
+  void PopAll(Function&& function) {
+    auto tail{tail_.load(std::memory_order_relaxed)};
+    const auto head{head_.load(std::memory_order_acquire)};
+    for (; tail != head; ++tail) function(entries_[tail % kCapacity]);
+    tail_.store(tail, std::memory_order_release);
+  }
+
+ private:
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  std::array<Entry, kCapacity> entries_;
+};
+
+}  // namespace detail
+
 class Logger {
  public:
   // multiple instantiations of Logger in one application will cause duplicates
@@ -65,18 +120,103 @@ class Logger {
 
   void LogError(std::string&& message);
 
+  // Fast path for hot code: the severity level is checked before formatting, and the message is
+  // formatted into a lock-free ring buffer of the calling thread without allocating, which a
+  // background thread of the Logger writes to the log file. In contrast to the overloads taking a
+  // string, the messages are only filtered by the severity level at run time, not by kDebug, such
+  // that logging may stay enabled in release builds. If the buffer of the thread is full, the
+  // message is written synchronously.
+
+  template <typename Argument, typename... Arguments>
+  void Log(boost::log::trivial::severity_level severity_level,
+           fmt::format_string<Argument, Arguments...> format, Argument&& argument,
+           Arguments&&... arguments) {
+    if (!ShouldLog(severity_level)) [[likely]] {
+      return;
+    }
+    auto& buffer{GetThreadBuffer()};
+    auto entry{buffer.BeginPush()};
+    if (entry == nullptr) [[unlikely]] {
+      // keeps the order of the messages of this thread
+      Flush();
+      entry = buffer.BeginPush();
+    }
+    const auto result{fmt::format_to_n(entry->message.data(), entry->message.size(), format,
+                                       std::forward<Argument>(argument),
+                                       std::forward<Arguments>(arguments)...)};
+    entry->size = std::min(result.size, entry->message.size());
+    entry->severity_level = severity_level;
+    entry->time = std::chrono::system_clock::now();
+    buffer.EndPush();
+  }
+
+  template <typename Argument, typename... Arguments>
+  void LogTrace(fmt::format_string<Argument, Arguments...> format, Argument&& argument,
+                Arguments&&... arguments) {
+    Log(boost::log::trivial::trace, format, std::forward<Argument>(argument),
+        std::forward<Arguments>(arguments)...);
+  }
+
+  template <typename Argument, typename... Arguments>
+  void LogDebug(fmt::format_string<Argument, Arguments...> format, Argument&& argument,
+                Arguments&&... arguments) {
+    Log(boost::log::trivial::debug, format, std::forward<Argument>(argument),
+        std::forward<Arguments>(arguments)...);
+  }
+
+  template <typename Argument, typename... Arguments>
+  void LogInfo(fmt::format_string<Argument, Arguments...> format, Argument&& argument,
+               Arguments&&... arguments) {
+    Log(boost::log::trivial::info, format, std::forward<Argument>(argument),
+        std::forward<Arguments>(arguments)...);
+  }
+
+  template <typename Argument, typename... Arguments>
+  void LogError(fmt::format_string<Argument, Arguments...> format, Argument&& argument,
+                Arguments&&... arguments) {
+    Log(boost::log::trivial::error, format, std::forward<Argument>(argument),
+        std::forward<Arguments>(arguments)...);
+  }
+
+  /// \brief Returns true if messages of the severity level are written.
+  bool ShouldLog(boost::log::trivial::severity_level severity_level) const noexcept {
+    return severity_level >= severity_level_ && logging_enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Writes the messages of the ring buffers of all threads to the log file.
+  void Flush();
+
   bool IsEnabled() { return logging_enabled_; }
 
   void SetEnabled(bool enable = true);
 
  private:
+  detail::LogRingBuffer& GetThreadBuffer();
+
+  // writes the buffered messages every kFlushInterval until the Logger is destroyed
+  void FlushLoop();
+
   boost::shared_ptr<boost::log::sinks::synchronous_sink<boost::log::sinks::text_file_backend>>
       g_file_sink_;
   std::unique_ptr<LoggerType> logger_;
   const std::size_t my_id_;
+  const boost::log::trivial::severity_level severity_level_;
   std::atomic<bool> logging_enabled_ = true;
   std::mutex write_mutex_;
 
+  // identifies the Logger in the buffer caches of the threads, since addresses may be reused
+  const std::uint64_t serial_number_;
+  // the ring buffers of the threads that used the fast path
+  std::mutex buffers_mutex_;
+  std::unordered_map<std::thread::id, std::unique_ptr<detail::LogRingBuffer>> buffers_;
+  // writes the buffered messages with the time they were logged, see Flush()
+  std::unique_ptr<LoggerType> buffered_logger_;
+  std::mutex flush_mutex_;
+  std::mutex flush_thread_mutex_;
+  std::condition_variable flush_thread_condition_;
+  bool stop_flush_thread_ = false;
+  std::thread flush_thread_;
+
   // aquire this on calls to boost::log::core
   static std::mutex boost_log_core_mutex_;
 
@@ -0,0 +1,69 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace encrypto::motion {
+
+MappedFile::MappedFile(const std::filesystem::path& path) : path_(path) {
+  const int file_descriptor{open(path.c_str(), O_RDONLY)};
+  if (file_descriptor == -1) {
+    throw std::runtime_error(
+        fmt::format("cannot open {}: {}", path.string(), std::strerror(errno)));
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) == -1) {
+    const int error{errno};
+    close(file_descriptor);
+    throw std::runtime_error(
+        fmt::format("cannot stat {}: {}", path.string(), std::strerror(error)));
+  }
+  size_ = file_status.st_size;
+  // empty files cannot be mapped
+  if (size_ > 0) {
+    void* address{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0)};
+    if (address == MAP_FAILED) {
+      const int error{errno};
+      close(file_descriptor);
+      throw std::runtime_error(
+          fmt::format("cannot map {}: {}", path.string(), std::strerror(error)));
+    }
+    address_ = address;
+    madvise(address_, size_, MADV_SEQUENTIAL);
+  }
+  // the mapping stays valid after the file is closed
+  close(file_descriptor);
+}
+
+MappedFile::~MappedFile() {
+  if (address_) munmap(address_, size_);
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,69 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+// Read-only memory mapping of a whole file, e.g., a column of input values, which is read from the
+// front to the back. The pages are loaded on demand and the mapping is released on destruction,
+// such that the file never needs to be copied into memory as a whole.
+class MappedFile {
+ public:
+  // throws std::runtime_error if the file cannot be mapped
+  explicit MappedFile(const std::filesystem::path& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const std::filesystem::path& GetPath() const noexcept { return path_; }
+
+  std::span<const std::byte> GetBytes() const noexcept {
+    return {static_cast<const std::byte*>(address_), size_};
+  }
+
+  // interprets the file as an array of T in the native byte order, throws std::runtime_error if
+  // its size is not a multiple of sizeof(T)
+  template <typename T>
+  std::span<const T> GetValues() const {
+    if (size_ % sizeof(T) != 0) {
+      throw std::runtime_error(fmt::format("{} of {} bytes is not an array of {}-byte values",
+                                           path_.string(), size_, sizeof(T)));
+    }
+    return {static_cast<const T*>(address_), size_ / sizeof(T)};
+  }
+
+ private:
+  std::filesystem::path path_;
+  void* address_{nullptr};
+  std::size_t size_{0};
+};
+
+}  // namespace encrypto::motion
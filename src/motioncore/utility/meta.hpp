@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <boost/hana/at_key.hpp>
 #include <boost/hana/map.hpp>
 #include <boost/hana/tuple.hpp>
@@ -33,19 +35,8 @@ namespace encrypto::motion {
 // e.g. TypeMap<std::vector, int, std::string> maps
 // - int (as type) to an std::vector<int> instance, and
 // - std::string to an std::vector<int> instance.
-// Note: latest clang does not support lambdas in unevaluated environments yet.
-
-#if __cplusplus > 201703L && !defined(__clang__)  // C++20
-
-template <template <typename> class Value, typename... Ts>
-using TypeMap = decltype([] {
-  return boost::hana::unpack(boost::hana::tuple_t<Ts...>, [](auto... t) {
-    return boost::hana::make_map(
-        boost::hana::make_pair(decltype(t)(), Value<typename decltype(t)::type>())...);
-  });
-}());
-
-#else  // C++17
+// Note: TypeMap is not defined as decltype of a lambda (C++20), since GCC fails to use such an
+// alias in dependent contexts, e.g., TypeMap<Value, T> inside another alias template.
 
 namespace detail {
 
@@ -62,6 +53,9 @@ auto MakeTypeMap() {
 template <template <typename> class Value, typename... Ts>
 using TypeMap = decltype(detail::MakeTypeMap<Value, Ts...>());
 
-#endif
+// maps each unsigned integer type of the arithmetic sharings (8 to 128 bit) to a Value<T>
+template <template <typename> class Value>
+using IntegerTypeMap =
+    TypeMap<Value, std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t, __uint128_t>;
 
 }  // namespace encrypto::motion
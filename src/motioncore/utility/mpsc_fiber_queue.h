@@ -0,0 +1,233 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <queue>
+#include <source_location>
+#include <stdexcept>
+#include <thread>
+
+#include "contention_tracing.h"
+
+namespace encrypto::motion {
+
+/**
+ * Closable multi-producer/single-consumer queue for elements of type T.
+ *
+ * Producers enqueue without locking into an intrusive linked list of nodes (Vyukov's MPSC queue):
+ * each enqueue exchanges the head pointer and links the previous head to the new node.  The
+ * consumer takes nodes from the tail, which only it writes, so that producers and the consumer
+ * do not share a lock or a cache line.  A consumer that finds the queue empty parks on a fiber
+ * condition variable, which producers only notify if the consumer announced that it waits.
+ *
+ * The interface is the subset of SynchronizedFiberQueue used by a single consumer, i.e., only one
+ * thread or fiber at a time may call the dequeue functions.
+ */
+template <typename T>
+class MpscFiberQueue {
+ public:
+  MpscFiberQueue() : head_(&stub_), tail_(&stub_) {}
+
+  MpscFiberQueue(const MpscFiberQueue&) = delete;
+  MpscFiberQueue& operator=(const MpscFiberQueue&) = delete;
+
+  ~MpscFiberQueue() {
+    while (Pop().has_value()) {
+    }
+    if (tail_ != &stub_) {
+      delete tail_;
+    }
+  }
+
+  /**
+   * Check if queue is empty, may miss elements of enqueues in progress.
+   */
+  bool empty() const noexcept { return tail_->next.load(std::memory_order_acquire) == nullptr; }
+
+  /**
+   * Number of elements in the queue, may be outdated when it returns.
+   */
+  std::size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+  /**
+   * Check if queue is closed.
+   */
+  bool IsClosed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+  /**
+   * Check if queue is closed and empty, must be called by the consumer.
+   */
+  bool IsClosedAndEmpty() const noexcept {
+    return IsClosed() && size_.load(std::memory_order_acquire) == 0;
+  }
+
+  /**
+   * Close the queue.
+   */
+  void close(std::source_location location = std::source_location::current()) noexcept {
+    closed_.store(true, std::memory_order_seq_cst);
+    WakeUpConsumer(location);
+  }
+
+  /**
+   * Add a new element to the queue.
+   */
+  void enqueue(const T& item, std::source_location location = std::source_location::current()) {
+    enqueue(T(item), location);
+  }
+
+  void enqueue(T&& item, std::source_location location = std::source_location::current()) {
+    if (IsClosed()) {
+      throw std::logic_error("Tried to enqueue in closed MpscFiberQueue");
+    }
+    auto node{new Node{.next = nullptr, .item = std::move(item)}};
+    size_.fetch_add(1, std::memory_order_relaxed);
+    auto previous{head_.exchange(node, std::memory_order_acq_rel)};
+    // the consumer cannot pass the previous node until it is linked
+    previous->next.store(node, std::memory_order_seq_cst);
+    if (consumer_is_waiting_.load(std::memory_order_seq_cst)) {
+      WakeUpConsumer(location);
+    }
+  }
+
+  /**
+   * Extract an element from the queue, must be called by the consumer.
+   */
+  std::optional<T> dequeue(
+      std::source_location location = std::source_location::current()) noexcept {
+    if (auto item{Pop()}; item.has_value()) {
+      return item;
+    }
+    if (!Wait(location)) {
+      return std::nullopt;
+    }
+    return Pop();
+  }
+
+  /**
+   * Extract all elements of the queue, must be called by the consumer.
+   */
+  std::optional<std::queue<T>> BatchDequeue(
+      std::source_location location = std::source_location::current()) noexcept {
+    auto output{TryBatchDequeue()};
+    if (!output.empty()) {
+      return output;
+    }
+    if (!Wait(location)) {
+      return std::nullopt;
+    }
+    return TryBatchDequeue();
+  }
+
+  /**
+   * Extract all elements of the queue without waiting, the result is empty if the queue is.
+   */
+  std::queue<T> TryBatchDequeue() noexcept {
+    std::queue<T> output;
+    for (auto item{Pop()}; item.has_value(); item = Pop()) {
+      output.push(std::move(*item));
+    }
+    return output;
+  }
+
+ private:
+  static constexpr std::size_t kCacheLineSize{64};
+  // yields of the consumer before it parks
+  static constexpr std::size_t kNumberOfSpins{64};
+
+  struct Node {
+    std::atomic<Node*> next;
+    std::optional<T> item;
+  };
+
+  // takes the element after the tail, whose node becomes the new tail
+  std::optional<T> Pop() noexcept {
+    auto next{tail_->next.load(std::memory_order_acquire)};
+    if (next == nullptr) {
+      return std::nullopt;
+    }
+    auto item{std::move(next->item)};
+    next->item.reset();
+    if (tail_ != &stub_) {
+      delete tail_;
+    }
+    tail_ = next;
+    size_.fetch_sub(1, std::memory_order_release);
+    return item;
+  }
+
+  // parks the consumer until an element is linked or the queue is closed, false if it is closed
+  // and empty
+  bool Wait(const std::source_location& location) noexcept {
+    const auto ready = [this] {
+      return tail_->next.load(std::memory_order_seq_cst) != nullptr ||
+             closed_.load(std::memory_order_seq_cst);
+    };
+    // producers that enqueue in bursts are often faster than parking and waking up
+    for (std::size_t i = 0; i < kNumberOfSpins && !ready(); ++i) {
+      std::this_thread::yield();
+    }
+    if (!ready()) {
+      std::unique_lock lock(mutex_);
+      consumer_is_waiting_.store(true, std::memory_order_seq_cst);
+      if (!ready()) {
+        TracedWait traced_wait(WaitPrimitive::kMpscFiberQueue, location);
+        condition_variable_.wait(lock, ready);
+      }
+      consumer_is_waiting_.store(false, std::memory_order_relaxed);
+    }
+    // an enqueue that raced with close has exchanged the head but not linked its node yet
+    while (empty() && size_.load(std::memory_order_acquire) > 0) {
+      std::this_thread::yield();
+    }
+    return !empty();
+  }
+
+  void WakeUpConsumer(const std::source_location& location) noexcept {
+    // the lock orders the notification after the check of the waiting consumer
+    std::scoped_lock lock(mutex_);
+    TraceWakeUp(WaitPrimitive::kMpscFiberQueue, location, 1);
+    condition_variable_.notify_one();
+  }
+
+  // written by the producers
+  alignas(kCacheLineSize) std::atomic<Node*> head_;
+  std::atomic<std::size_t> size_{0};
+  // written by the consumer
+  alignas(kCacheLineSize) Node* tail_;
+  Node stub_{.next = nullptr, .item = std::nullopt};
+  alignas(kCacheLineSize) std::atomic<bool> consumer_is_waiting_{false};
+  std::atomic<bool> closed_{false};
+  boost::fibers::mutex mutex_;
+  boost::fibers::condition_variable condition_variable_;
+};
+
+}  // namespace encrypto::motion
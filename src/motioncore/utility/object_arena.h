@@ -0,0 +1,131 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace encrypto::motion {
+
+// Monotonic arena for objects that are allocated while a circuit is constructed, e.g., the gates
+// and wires of a Register. Allocations bump a pointer into geometrically growing buffers instead
+// of calling malloc per object, and the buffers are released wholesale as soon as the arena and
+// all objects allocated from it are destroyed, since every allocation holds a reference to the
+// arena through its ArenaAllocator.
+//
+// Not thread-safe, the objects are allocated while the circuit is constructed. Deallocations,
+// which may happen from any thread, are no-ops.
+//
+// A recycling arena instead keeps the deallocated blocks in free lists per size and alignment,
+// i.e., per class of the objects, and hands them out again to later allocations of the same
+// size, such that an arena which outlives its circuits (see Register::SetObjectRecycling) stops
+// growing once it has seen the largest circuit. Allocations and deallocations of a recycling arena
+// are serialized by a mutex.
+class ObjectArena {
+ public:
+  static constexpr std::size_t kDefaultInitialSize{std::size_t(1) << 16};
+
+  ObjectArena(std::size_t initial_size = kDefaultInitialSize, bool recycling = false)
+      : resource_(initial_size), recycling_(recycling) {}
+
+  ObjectArena(const ObjectArena&) = delete;
+
+  void* Allocate(std::size_t bytes, std::size_t alignment) {
+    if (!recycling_) [[likely]] {
+      number_of_allocated_bytes_ += bytes;
+      return resource_.allocate(bytes, alignment);
+    }
+    std::scoped_lock lock(mutex_);
+    number_of_allocated_bytes_ += bytes;
+    if (auto iterator{free_lists_.find({bytes, alignment})};
+        iterator != free_lists_.end() && !iterator->second.empty()) {
+      auto pointer{iterator->second.back()};
+      iterator->second.pop_back();
+      number_of_recycled_bytes_ += bytes;
+      return pointer;
+    }
+    return resource_.allocate(bytes, alignment);
+  }
+
+  void Deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+    if (!recycling_) [[likely]] {
+      return;
+    }
+    std::scoped_lock lock(mutex_);
+    free_lists_[{bytes, alignment}].push_back(pointer);
+  }
+
+  [[nodiscard]] bool IsRecycling() const noexcept { return recycling_; }
+
+  // bytes requested from the arena so far, excluding the padding for the alignment
+  std::size_t GetNumberOfAllocatedBytes() const noexcept { return number_of_allocated_bytes_; }
+
+  // the part of the requested bytes that was served from the free lists
+  std::size_t GetNumberOfRecycledBytes() const noexcept { return number_of_recycled_bytes_; }
+
+ private:
+  std::pmr::monotonic_buffer_resource resource_;
+  std::size_t number_of_allocated_bytes_{0};
+  const bool recycling_;
+  std::mutex mutex_;
+  std::map<std::pair<std::size_t, std::size_t>, std::vector<void*>> free_lists_;
+  std::size_t number_of_recycled_bytes_{0};
+};
+
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  ArenaAllocator(std::shared_ptr<ObjectArena> arena) noexcept : arena_(std::move(arena)) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.GetArena()) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, std::size_t n) noexcept {
+    arena_->Deallocate(pointer, n * sizeof(T), alignof(T));
+  }
+
+  const std::shared_ptr<ObjectArena>& GetArena() const noexcept { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const noexcept {
+    return arena_ == other.GetArena();
+  }
+
+ private:
+  std::shared_ptr<ObjectArena> arena_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,40 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiled_wait.h"
+
+#include <boost/fiber/fss.hpp>
+
+namespace encrypto::motion {
+
+// fiber-specific since fibers may migrate between threads while they are blocked
+static boost::fibers::fiber_specific_ptr<WaitTimes> fiber_wait_times(nullptr);
+
+WaitTimes* SetFiberWaitTimes(WaitTimes* wait_times) {
+  auto previous{fiber_wait_times.release()};
+  fiber_wait_times.reset(wait_times);
+  return previous;
+}
+
+WaitTimes* GetFiberWaitTimes() { return fiber_wait_times.get(); }
+
+}  // namespace encrypto::motion
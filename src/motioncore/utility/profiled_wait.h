@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#pragma once
+
+#include <chrono>
+
+namespace encrypto::motion {
+
+/// \brief Time a fiber was blocked while evaluating the setup or online phase of a gate.
+struct WaitTimes {
+  using Duration = std::chrono::steady_clock::duration;
+
+  /// waiting on parent wires and gates, i.e., on FiberSignals and the conditions of gates
+  Duration dependencies{0};
+  /// waiting on futures, i.e., on received messages and the results of OTs
+  Duration messages{0};
+  /// waiting on other FiberConditions, i.e., on MTs, SPs, SBs, OTs, and base OTs
+  Duration preprocessing{0};
+  /// set during a ProfiledWait, such that nested waits are only accounted once
+  bool waiting = false;
+};
+
+/// \brief Sets the accumulator of the wait times of the calling fiber, nullptr disables the
+///        accounting. Returns the previous accumulator.
+WaitTimes* SetFiberWaitTimes(WaitTimes* wait_times);
+
+/// \brief Returns the accumulator of the wait times of the calling fiber or nullptr.
+WaitTimes* GetFiberWaitTimes();
+
+/// \brief Adds the time between its construction and destruction to the wait times of the calling
+///        fiber if there are any. Only used where a fiber actually blocks, hence the lookup of the
+///        fiber-specific accumulator does not slow down waits on values that are already ready.
+///        A ProfiledWait inside another one, e.g., the FiberCondition of a gate, is ignored.
+class ProfiledWait {
+ public:
+  enum class Kind { kDependency, kMessage, kPreprocessing };
+
+  explicit ProfiledWait(Kind kind) : wait_times_(GetFiberWaitTimes()), kind_(kind) {
+    if (wait_times_ == nullptr) return;
+    if (wait_times_->waiting) {
+      wait_times_ = nullptr;
+      return;
+    }
+    wait_times_->waiting = true;
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  ProfiledWait(const ProfiledWait&) = delete;
+  ProfiledWait& operator=(const ProfiledWait&) = delete;
+
+  ~ProfiledWait() {
+    if (wait_times_ == nullptr) return;
+    const auto duration{std::chrono::steady_clock::now() - start_};
+    switch (kind_) {
+      case Kind::kDependency:
+        wait_times_->dependencies += duration;
+        break;
+      case Kind::kMessage:
+        wait_times_->messages += duration;
+        break;
+      case Kind::kPreprocessing:
+        wait_times_->preprocessing += duration;
+        break;
+    }
+    wait_times_->waiting = false;
+  }
+
+ private:
+  WaitTimes* wait_times_;
+  Kind kind_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace encrypto::motion
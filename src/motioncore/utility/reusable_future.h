@@ -30,9 +30,16 @@
 
 #include <boost/fiber/future.hpp>
 #include <condition_variable>
+#include <coroutine>
+#include <functional>
 #include <future>
 #include <mutex>
+#include <source_location>
 #include <type_traits>
+#include <utility>
+
+#include "contention_tracing.h"
+#include "profiled_wait.h"
 
 namespace encrypto::motion {
 
@@ -52,7 +59,9 @@ class ReusableSharedState {
 
   // set value
   template <typename Argument>
-  void set(Argument&& argument) {
+  void set(Argument&& argument, const std::source_location& location) {
+    std::size_t number_of_waiters;
+    std::function<void()> continuation;
     {
       std::scoped_lock lock(mutex_);
       if (contains_value_) {
@@ -61,11 +70,26 @@ class ReusableSharedState {
       // construct R from argument in the pre-allocated value_storage
       new (&value_storage_) R(std::forward<Argument>(argument));
       contains_value_ = true;
+      number_of_waiters = number_of_waiters_;
+      continuation = std::exchange(continuation_, nullptr);
+    }
+    if constexpr (kTraced) {
+      TraceWakeUp(WaitPrimitive::kReusableFiberFuture, location, number_of_waiters);
     }
     condition_variable_.notify_all();
+    if (continuation) continuation();
+  }
+
+  // registers the function that the next set() calls after storing the value, e.g., to resume
+  // a suspended coroutine, unless there already is a value, in which case false is returned
+  bool set_continuation(std::function<void()> continuation) {
+    std::scoped_lock lock(mutex_);
+    if (contains_value_) return false;
+    continuation_ = std::move(continuation);
+    return true;
   }
 
-  // remove value if present
+  // remove value and continuation if present
   void reset() noexcept {
     std::unique_lock lock(mutex_);
     if (contains_value_) {
@@ -73,18 +97,19 @@ class ReusableSharedState {
       delete_helper();
       contains_value_ = false;
     }
+    continuation_ = nullptr;
   }
 
   // wait until there is a value
-  void wait() const noexcept {
+  void wait(const std::source_location& location) const noexcept {
     std::unique_lock lock(mutex_);
-    wait_helper(lock);
+    wait_helper(lock, location);
   }
 
   // move value out of the shared state
-  R move() noexcept {
+  R move(const std::source_location& location) noexcept {
     std::unique_lock lock(mutex_);
-    wait_helper(lock);
+    wait_helper(lock, location);
     contains_value_ = false;
     return std::move(*reinterpret_cast<R*>(&value_storage_));
   }
@@ -96,20 +121,39 @@ class ReusableSharedState {
   }
 
  private:
+  // only fibers evaluate gates, see GateProfile
+  static constexpr bool kTraced =
+      std::is_same_v<ConditionVariableType, boost::fibers::condition_variable>;
+
   // storage for the value
   std::aligned_storage_t<sizeof(R), std::alignment_of_v<R>> value_storage_;
 
   // status: true -> there is a value in the shared state
   bool contains_value_;
 
+  // number of blocked waiters, only used for tracing
+  mutable std::size_t number_of_waiters_ = 0;
+
+  // called by the next set(), see set_continuation
+  std::function<void()> continuation_;
+
   // synchronization stuff
   mutable MutexType mutex_;
   mutable ConditionVariableType condition_variable_;
 
   // helper functions
-  void wait_helper(std::unique_lock<decltype(mutex_)>& lock) const noexcept {
+  void wait_helper(std::unique_lock<decltype(mutex_)>& lock,
+                   [[maybe_unused]] const std::source_location& location) const noexcept {
     if (!contains_value_) {
-      condition_variable_.wait(lock, [this] { return contains_value_; });
+      if constexpr (kTraced) {
+        ProfiledWait profiled_wait(ProfiledWait::Kind::kMessage);
+        TracedWait traced_wait(WaitPrimitive::kReusableFiberFuture, location);
+        ++number_of_waiters_;
+        condition_variable_.wait(lock, [this] { return contains_value_; });
+        --number_of_waiters_;
+      } else {
+        condition_variable_.wait(lock, [this] { return contains_value_; });
+      }
     }
   }
 
@@ -152,11 +196,11 @@ class ReusableFuture {
   }
 
   // retrieve the stored value
-  R get() {
+  R get(std::source_location location = std::source_location::current()) {
     if (!shared_state_) {
       throw std::future_error(std::future_errc::no_state);
     }
-    return shared_state_->move();
+    return shared_state_->move(location);
   }
 
   // swap two futures
@@ -166,10 +210,37 @@ class ReusableFuture {
   bool valid() const noexcept { return shared_state_ != nullptr; }
 
   // wait until the future gets ready
-  void wait() const { shared_state_->wait(); }
+  void wait(std::source_location location = std::source_location::current()) const {
+    shared_state_->wait(location);
+  }
 
   // TODO: wait_for, wait_until
 
+  // Awaits the value in a coroutine whose promise provides the scheduler that resumes it after
+  // the value is set, see GateTask. Blocks like get() if the scheduler is empty.
+  class Awaiter {
+   public:
+    explicit Awaiter(ReusableFuture& future) noexcept : future_(future) {}
+
+    bool await_ready() const { return future_.shared_state_->contains_value(); }
+
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) {
+      const auto& scheduler{handle.promise().GetScheduler()};
+      if (!scheduler) return false;
+      // the scheduler lives in the suspended coroutine frame
+      return future_.shared_state_->set_continuation(
+          [handle, &scheduler] { scheduler(std::coroutine_handle<>(handle)); });
+    }
+
+    R await_resume() { return future_.get(); }
+
+   private:
+    ReusableFuture& future_;
+  };
+
+  Awaiter operator co_await() noexcept { return Awaiter(*this); }
+
  private:
   // allow ReusablePromise to use the following constructor
   friend ReusablePromise<R, MutexType, ConditionVariableType>;
@@ -223,19 +294,19 @@ class ReusablePromise {
   }
 
   // set value of the shared state
-  void set_value(const R& value) {
+  void set_value(const R& value, std::source_location location = std::source_location::current()) {
     if (!shared_state_) {
       throw std::future_error(std::future_errc::no_state);
     }
-    shared_state_->set(value);
+    shared_state_->set(value, location);
   }
 
   // set value of the shared state
-  void set_value(R&& value) {
+  void set_value(R&& value, std::source_location location = std::source_location::current()) {
     if (!shared_state_) {
       throw std::future_error(std::future_errc::no_state);
     }
-    shared_state_->set(std::move(value));
+    shared_state_->set(std::move(value), location);
   }
 
   // returns future associated with the shared state of the promise
@@ -250,6 +321,18 @@ class ReusablePromise {
     return ReusableFuture(shared_state_);
   }
 
+  // Empties the shared state and allows to retrieve a future for it again if the future
+  // retrieved before was destroyed, which reuses the shared state instead of allocating a new
+  // promise. Returns false and leaves the promise unchanged if that future still exists.
+  bool renew() noexcept {
+    if (!shared_state_ || shared_state_.use_count() != 1) {
+      return false;
+    }
+    shared_state_->reset();
+    future_retrieved_ = false;
+    return true;
+  }
+
   // swaps this future with another
   void swap(ReusablePromise& other) noexcept {
     std::swap(shared_state_, other.shared_state_);
@@ -25,6 +25,7 @@
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <string_view>
 
 // So that 'DWORD' in boost/process/detail/windows/handles.hpp is declared
 #ifdef __MINGW32__
@@ -103,4 +104,20 @@ std::string GetUsername() {
   return username;
 }
 
+std::string GetCpuModel() {
+#ifndef __MINGW32__
+  std::ifstream f("/proc/cpuinfo");
+  constexpr std::string_view kModelName{"model name"};
+  for (std::string line; std::getline(f, line);) {
+    if (line.starts_with(kModelName)) {
+      if (const auto colon{line.find(':')}; colon != std::string::npos) {
+        const auto begin{line.find_first_not_of(' ', colon + 1)};
+        return begin == std::string::npos ? std::string() : line.substr(begin);
+      }
+    }
+  }
+#endif
+  return "N/A";
+}
+
 }  // namespace encrypto::motion
@@ -41,4 +41,7 @@ std::string GetHostname();
 // Get this user's name via `whoami`
 std::string GetUsername();
 
+// Read the model name of the first cpu from /proc/cpuinfo, or N/A if it is not available
+std::string GetCpuModel();
+
 }  // namespace encrypto::motion
@@ -0,0 +1,223 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+/// \brief Contiguous byte container with the interface of std::vector<std::byte, Allocator> that
+///        stores up to kInlineCapacity bytes inline, i.e., without a heap allocation.
+///
+/// BitVector uses it for its data such that the BitVectors of wires with few SIMD values never
+/// allocate. Heap storage is obtained from Allocator, and the inline buffer has kInlineAlignment,
+/// so the data of an AlignedBitVector stays aligned either way. In contrast to std::vector, moving
+/// a SmallByteVector that stores its bytes inline copies them, i.e., pointers into the data of a
+/// small vector do not survive a move.
+template <typename Allocator, std::size_t kInlineCapacity,
+          std::size_t kInlineAlignment = alignof(std::max_align_t)>
+class SmallByteVector {
+  using AllocatorTraits = std::allocator_traits<Allocator>;
+
+ public:
+  using value_type = std::byte;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::byte&;
+  using const_reference = const std::byte&;
+  using pointer = std::byte*;
+  using const_pointer = const std::byte*;
+  using iterator = std::byte*;
+  using const_iterator = const std::byte*;
+
+  SmallByteVector() noexcept = default;
+
+  explicit SmallByteVector(size_type size, std::byte value = std::byte(0)) { resize(size, value); }
+
+  template <typename InputIterator>
+  SmallByteVector(InputIterator first, InputIterator last) {
+    assign(first, last);
+  }
+
+  SmallByteVector(const SmallByteVector& other) { assign(other.begin(), other.end()); }
+
+  SmallByteVector(SmallByteVector&& other) noexcept { MoveFrom(other); }
+
+  ~SmallByteVector() { Deallocate(); }
+
+  SmallByteVector& operator=(const SmallByteVector& other) {
+    if (this != &other) assign(other.begin(), other.end());
+    return *this;
+  }
+
+  SmallByteVector& operator=(SmallByteVector&& other) noexcept {
+    if (this != &other) {
+      Deallocate();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  template <typename InputIterator>
+  void assign(InputIterator first, InputIterator last) {
+    const auto size{static_cast<size_type>(std::distance(first, last))};
+    // the source may be this vector, so the old data is kept until it is copied
+    if (size > capacity_) {
+      auto new_data{Allocate(size)};
+      std::copy(first, last, new_data);
+      Deallocate();
+      data_ = new_data;
+      capacity_ = size;
+    } else {
+      std::copy(first, last, data());
+    }
+    size_ = size;
+  }
+
+  void assign(size_type size, std::byte value) {
+    clear();
+    resize(size, value);
+  }
+
+  std::byte* data() noexcept { return data_ ? data_ : inline_data_; }
+  const std::byte* data() const noexcept { return data_ ? data_ : inline_data_; }
+
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return capacity_; }
+  bool empty() const noexcept { return size_ == 0; }
+  // true if the bytes are stored in the inline buffer
+  bool IsInline() const noexcept { return data_ == nullptr; }
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + size_; }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + size_; }
+  const_iterator cbegin() const noexcept { return data(); }
+  const_iterator cend() const noexcept { return data() + size_; }
+
+  std::byte& operator[](size_type position) noexcept { return data()[position]; }
+  const std::byte& operator[](size_type position) const noexcept { return data()[position]; }
+
+  std::byte& at(size_type position) {
+    BoundsCheck(position);
+    return data()[position];
+  }
+  const std::byte& at(size_type position) const {
+    BoundsCheck(position);
+    return data()[position];
+  }
+
+  std::byte& back() noexcept { return data()[size_ - 1]; }
+  const std::byte& back() const noexcept { return data()[size_ - 1]; }
+
+  void reserve(size_type capacity) {
+    if (capacity > capacity_) Reallocate(std::max(capacity, 2 * capacity_));
+  }
+
+  /// \brief Resizes to size bytes, new bytes are set to value like in std::vector::resize.
+  void resize(size_type size, std::byte value = std::byte(0)) {
+    reserve(size);
+    if (size > size_) std::fill(data() + size_, data() + size, value);
+    size_ = size;
+  }
+
+  void push_back(std::byte value) {
+    reserve(size_ + 1);
+    data()[size_++] = value;
+  }
+
+  std::byte& emplace_back(std::byte value) {
+    push_back(value);
+    return back();
+  }
+
+  void clear() noexcept { size_ = 0; }
+
+  friend bool operator==(const SmallByteVector& a, const SmallByteVector& b) noexcept {
+    return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+  }
+
+ private:
+  std::byte* Allocate(size_type capacity) {
+    Allocator allocator;
+    return AllocatorTraits::allocate(allocator, capacity);
+  }
+
+  void Deallocate() noexcept {
+    if (data_) {
+      Allocator allocator;
+      AllocatorTraits::deallocate(allocator, data_, capacity_);
+      data_ = nullptr;
+      capacity_ = kInlineCapacity;
+    }
+  }
+
+  void Reallocate(size_type capacity) {
+    assert(capacity > kInlineCapacity);
+    auto new_data{Allocate(capacity)};
+    std::memcpy(new_data, data(), size_);
+    Deallocate();
+    data_ = new_data;
+    capacity_ = capacity;
+  }
+
+  void MoveFrom(SmallByteVector& other) noexcept {
+    size_ = other.size_;
+    if (other.data_) {
+      data_ = other.data_;
+      capacity_ = other.capacity_;
+      other.data_ = nullptr;
+      other.capacity_ = kInlineCapacity;
+    } else {
+      std::memcpy(inline_data_, other.inline_data_, size_);
+    }
+    other.size_ = 0;
+  }
+
+  void BoundsCheck(size_type position) const {
+    if (position >= size_) {
+      throw std::out_of_range(
+          fmt::format("SmallByteVector: accessing position {} of {}", position, size_));
+    }
+  }
+
+  // nullptr if the bytes are stored in inline_data_
+  std::byte* data_{nullptr};
+  size_type size_{0};
+  size_type capacity_{kInlineCapacity};
+  alignas(kInlineAlignment) std::byte inline_data_[kInlineCapacity];
+};
+
+}  // namespace encrypto::motion
@@ -34,11 +34,16 @@
 #undef GetMessage
 #endif
 
+#include <algorithm>
 #include <future>
 #include <iostream>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <source_location>
+#include <type_traits>
+
+#include "contention_tracing.h"
 
 namespace encrypto::motion {
 
@@ -67,6 +72,14 @@ class BasicSynchronizedQueue {
     return queue_.empty();
   }
 
+  /**
+   * Number of elements in the queue.
+   */
+  std::size_t size() const noexcept {
+    std::scoped_lock lock(mutex_);
+    return queue_.size();
+  }
+
   /**
    * Check if queue is closed.
    */
@@ -86,49 +99,62 @@ class BasicSynchronizedQueue {
   /**
    * Close the queue.
    */
-  void close() noexcept {
+  void close(std::source_location location = std::source_location::current()) noexcept {
+    std::size_t number_of_waiters;
     {
       std::scoped_lock lock(mutex_);
       closed_ = true;
+      number_of_waiters = number_of_waiters_;
     }
+    TraceWakeUp(kPrimitive, location, number_of_waiters);
     condition_variable_.notify_all();
   }
 
   /**
    * Add a new element to the queue.
    */
-  void enqueue(const T& item) {
+  void enqueue(const T& item, std::source_location location = std::source_location::current()) {
     if (closed_) {
       throw std::logic_error("Tried to enqueue in closed BasicSynchronizedQueue");
     }
+    std::size_t number_of_waiters;
     {
       std::scoped_lock lock(mutex_);
       queue_.push(item);
+      number_of_waiters = number_of_waiters_;
     }
+    TraceWakeUp(kPrimitive, location, std::min<std::size_t>(1, number_of_waiters));
     condition_variable_.notify_one();
   }
 
-  void enqueue(T&& item) {
+  void enqueue(T&& item, std::source_location location = std::source_location::current()) {
     if (closed_) {
       throw std::logic_error("Tried to enqueue in closed BasicSynchronizedQueue");
     }
+    std::size_t number_of_waiters;
     {
       std::scoped_lock lock(mutex_);
       queue_.push(std::move(item));
+      number_of_waiters = number_of_waiters_;
     }
+    TraceWakeUp(kPrimitive, location, std::min<std::size_t>(1, number_of_waiters));
     condition_variable_.notify_one();
   }
 
   /**
    * Extract an element from the queue.
    */
-  std::optional<T> dequeue() noexcept {
+  std::optional<T> dequeue(
+      std::source_location location = std::source_location::current()) noexcept {
     std::unique_lock lock(mutex_);
     if (queue_.empty() && closed_) {
       return std::nullopt;
     }
     if (queue_.empty() && !closed_) {
+      TracedWait traced_wait(kPrimitive, location);
+      ++number_of_waiters_;
       condition_variable_.wait(lock, [this] { return !this->queue_.empty() || this->closed_; });
+      --number_of_waiters_;
     }
     if (queue_.empty()) {
       assert(closed_);
@@ -143,14 +169,18 @@ class BasicSynchronizedQueue {
   /**
    * Extract all elements of the queue.
    */
-  std::optional<std::queue<T>> BatchDequeue() noexcept {
+  std::optional<std::queue<T>> BatchDequeue(
+      std::source_location location = std::source_location::current()) noexcept {
     std::queue<T> output;
     std::unique_lock lock(mutex_);
     if (queue_.empty() && closed_) {
       return std::nullopt;
     }
     if (queue_.empty() && !closed_) {
+      TracedWait traced_wait(kPrimitive, location);
+      ++number_of_waiters_;
       condition_variable_.wait(lock, [this] { return !this->queue_.empty() || this->closed_; });
+      --number_of_waiters_;
     }
     if (queue_.empty()) {
       return std::nullopt;
@@ -160,9 +190,26 @@ class BasicSynchronizedQueue {
     return std::optional<std::queue<T>>(std::move(output));
   }
 
+  /**
+   * Extract all elements of the queue without waiting, the result is empty if the queue is.
+   */
+  std::queue<T> TryBatchDequeue() noexcept {
+    std::queue<T> output;
+    std::scoped_lock lock(mutex_);
+    std::swap(queue_, output);
+    return output;
+  }
+
  private:
+  static constexpr WaitPrimitive kPrimitive{
+      std::is_same_v<ConditionVariableType, boost::fibers::condition_variable>
+          ? WaitPrimitive::kSynchronizedFiberQueue
+          : WaitPrimitive::kSynchronizedQueue};
+
   bool closed_ = false;
   std::queue<T> queue_;
+  // number of blocked consumers, guarded by mutex_ and only used for tracing
+  std::size_t number_of_waiters_ = 0;
   mutable MutexType mutex_;
   ConditionVariableType condition_variable_;
 };
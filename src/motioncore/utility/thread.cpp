@@ -20,10 +20,15 @@
 
 #include "thread.h"
 #include <pthread.h>
+#include <sched.h>
 #include <cassert>
+#include <filesystem>
+#include <stdexcept>
 #include <string>
 #include <thread>
 
+#include <fmt/format.h>
+
 namespace encrypto::motion {
 
 void ThreadSetName(std::thread& thread, const std::string& name) {
@@ -32,4 +37,35 @@ void ThreadSetName(std::thread& thread, const std::string& name) {
   pthread_setname_np(handle, name.c_str());
 }
 
+void ThreadSetAffinity(std::thread& thread, std::size_t cpu) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set) != 0) {
+    throw std::runtime_error(fmt::format("Could not pin thread to cpu {}", cpu));
+  }
+}
+
+std::vector<std::uint32_t> GetCpuNumaNodes() {
+  std::vector<std::uint32_t> numa_nodes(std::thread::hardware_concurrency(), 0);
+  for (std::size_t cpu = 0; cpu < numa_nodes.size(); ++cpu) {
+    // the cpu's directory contains a link named node<id> to its NUMA node
+    std::error_code error_code;
+    std::filesystem::directory_iterator directory(
+        fmt::format("/sys/devices/system/cpu/cpu{}", cpu), error_code);
+    if (error_code) {
+      continue;
+    }
+    for (const auto& entry : directory) {
+      const auto name = entry.path().filename().string();
+      if (name.size() > 4 && name.starts_with("node") &&
+          name.find_first_not_of("0123456789", 4) == std::string::npos) {
+        numa_nodes[cpu] = static_cast<std::uint32_t>(std::stoul(name.substr(4)));
+        break;
+      }
+    }
+  }
+  return numa_nodes;
+}
+
 }  // namespace encrypto::motion
@@ -20,8 +20,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace encrypto::motion {
 
@@ -29,4 +32,11 @@ namespace encrypto::motion {
 // - name.size() <= 16
 void ThreadSetName(std::thread& thread, const std::string& name);
 
+// Pins a given thread to the logical cpu with the given id using pthread_setaffinity_np.
+void ThreadSetAffinity(std::thread& thread, std::size_t cpu);
+
+// Returns the NUMA node of each logical cpu in 0, ..., std::thread::hardware_concurrency() - 1
+// as reported by sysfs. If the topology is not available, all cpus are assigned to node 0.
+std::vector<std::uint32_t> GetCpuNumaNodes();
+
 }  // namespace encrypto::motion
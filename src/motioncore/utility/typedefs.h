@@ -135,6 +135,81 @@ inline std::string to_string(IntegerOperationType p) {
   }
 }
 
+// Operations on IEEE-754 single-precision numbers, see algorithm::FloatingPointCircuit
+enum class FloatingPointOperationType : unsigned int {
+  kAdd,
+  kDiv,
+  kEq,
+  kLe,
+  kLt,
+  kMul,
+  kSqrt,
+  kSub,
+  kInvalid
+};
+
+inline std::string to_string(FloatingPointOperationType p) {
+  switch (p) {
+    case FloatingPointOperationType::kAdd: {
+      return "FLOAT_ADD";
+    }
+    case FloatingPointOperationType::kDiv: {
+      return "FLOAT_DIV";
+    }
+    case FloatingPointOperationType::kEq: {
+      return "FLOAT_EQ";
+    }
+    case FloatingPointOperationType::kLe: {
+      return "FLOAT_LE";
+    }
+    case FloatingPointOperationType::kLt: {
+      return "FLOAT_LT";
+    }
+    case FloatingPointOperationType::kMul: {
+      return "FLOAT_MUL";
+    }
+    case FloatingPointOperationType::kSqrt: {
+      return "FLOAT_SQRT";
+    }
+    case FloatingPointOperationType::kSub: {
+      return "FLOAT_SUB";
+    }
+    default:
+      throw std::invalid_argument("Invalid FloatingPointOperationType");
+  }
+}
+
+// Comparisons a OP b of arithmetic shares, see arithmetic_gmw::ComparisonGate
+enum class ComparisonType : unsigned int {
+  kGreaterThan,
+  kGreaterThanOrEqual,
+  kLessThan,
+  kLessThanOrEqual,
+  kEqual
+};
+
+inline std::string to_string(ComparisonType type) {
+  switch (type) {
+    case ComparisonType::kGreaterThan: {
+      return ">";
+    }
+    case ComparisonType::kGreaterThanOrEqual: {
+      return ">=";
+    }
+    case ComparisonType::kLessThan: {
+      return "<";
+    }
+    case ComparisonType::kLessThanOrEqual: {
+      return "<=";
+    }
+    case ComparisonType::kEqual: {
+      return "==";
+    }
+    default:
+      throw std::invalid_argument("Invalid ComparisonType");
+  }
+}
+
 enum class MpcProtocol : unsigned int {
   // MPC protocols
   kArithmeticGmw,
@@ -188,4 +263,24 @@ enum class GarbledCircuitRole : unsigned int {
   kInvalid = 2  // for checking whether the value is valid
 };
 
+// the garbling scheme of the AND gates in garbled circuits: three-halves (Rosulek and Roy,
+// https://eprint.iacr.org/2021/749) sends 1.5 kappa bits per AND gate and needs 6 hashes for
+// garbling, half-gates (Zahur et al., https://eprint.iacr.org/2014/756) sends 2 kappa bits but
+// needs only 4 hashes
+enum class GarbledCircuitScheme : unsigned int { kThreeHalves = 0, kHalfGates = 1 };
+
+inline std::string to_string(GarbledCircuitScheme scheme) {
+  switch (scheme) {
+    case GarbledCircuitScheme::kThreeHalves: {
+      return "ThreeHalves";
+    }
+    case GarbledCircuitScheme::kHalfGates: {
+      return "HalfGates";
+    }
+    default:
+      return std::string("InvalidGarbledCircuitScheme with value ") +
+             std::to_string(static_cast<int>(scheme));
+  }
+}
+
 }  // namespace encrypto::motion
@@ -0,0 +1,131 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <gtest/gtest.h>
+
+#include <openssl/evp.h>
+
+#include <array>
+#include <future>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "algorithm/aes128.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+#include "test_constants.h"
+
+namespace {
+
+using encrypto::motion::MpcProtocol;
+
+std::vector<std::uint8_t> EncryptInTheClear(const std::array<std::uint8_t, 16>& key,
+                                            const std::vector<std::uint8_t>& block) {
+  std::vector<std::uint8_t> ciphertext(block.size());
+  auto context{EVP_CIPHER_CTX_new()};
+  EVP_EncryptInit_ex(context, EVP_aes_128_ecb(), nullptr, key.data(), nullptr);
+  EVP_CIPHER_CTX_set_padding(context, 0);
+  int length{0};
+  EVP_EncryptUpdate(context, ciphertext.data(), &length, block.data(),
+                    static_cast<int>(block.size()));
+  EVP_CIPHER_CTX_free(context);
+  return ciphertext;
+}
+
+// encrypts two batches of counter blocks under a key of party 0 with the same expanded key
+template <MpcProtocol P>
+void TestAes128Ctr(std::size_t number_of_parties) {
+  constexpr std::array<std::size_t, 2> kBatchSizes{1, 20};
+  std::mt19937 random(number_of_parties);
+  std::array<std::uint8_t, 16> key, initial_counter_block;
+  for (auto& byte : key) byte = static_cast<std::uint8_t>(random());
+  for (auto& byte : initial_counter_block) byte = static_cast<std::uint8_t>(random());
+  // the counter overflows into the upper bytes
+  initial_counter_block[15] = 0xfe;
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      auto& party{parties[party_id]};
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      const auto key_wires{encrypto::motion::algorithm::Aes128CounterBlocks(key, 0, 1)};
+      const encrypto::motion::algorithm::Aes128CtrKeystream keystream(
+          party->In<P>(std::span<const encrypto::motion::BitVector<>>(key_wires), 0));
+      std::vector<encrypto::motion::ShareWrapper> outputs;
+      std::size_t first_counter{0};
+      for (const std::size_t batch_size : kBatchSizes) {
+        const auto counter_blocks{encrypto::motion::algorithm::Aes128CounterBlocks(
+            initial_counter_block, first_counter, batch_size)};
+        encrypto::motion::ShareWrapper counters{
+            party->In<P>(std::span<const encrypto::motion::BitVector<>>(counter_blocks), 1)};
+        outputs.emplace_back(keystream.Encrypt(counters).Out());
+        first_counter += batch_size;
+      }
+      party->Run();
+      first_counter = 0;
+      for (std::size_t i = 0; i < kBatchSizes.size(); ++i) {
+        const auto counter_blocks{encrypto::motion::algorithm::Aes128Blocks(
+            encrypto::motion::algorithm::Aes128CounterBlocks(initial_counter_block,
+                                                             first_counter, kBatchSizes[i]))};
+        const auto keystream_blocks{encrypto::motion::algorithm::Aes128Blocks(
+            outputs[i].As<std::vector<encrypto::motion::BitVector<>>>())};
+        ASSERT_EQ(keystream_blocks.size(), kBatchSizes[i]);
+        for (std::size_t j = 0; j < kBatchSizes[i]; ++j) {
+          EXPECT_EQ(keystream_blocks[j], EncryptInTheClear(key, counter_blocks[j]));
+        }
+        first_counter += kBatchSizes[i];
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(Aes128, CounterBlocks) {
+  std::array<std::uint8_t, 16> initial_counter_block{};
+  initial_counter_block[14] = 0xff;
+  initial_counter_block[15] = 0xff;
+  const auto blocks{encrypto::motion::algorithm::Aes128Blocks(
+      encrypto::motion::algorithm::Aes128CounterBlocks(initial_counter_block, 1, 2))};
+  ASSERT_EQ(blocks.size(), 2);
+  std::vector<std::uint8_t> expected(16, 0);
+  expected[13] = 1;
+  EXPECT_EQ(blocks[0], expected);
+  expected[15] = 1;
+  EXPECT_EQ(blocks[1], expected);
+  EXPECT_THROW(encrypto::motion::algorithm::Aes128CounterBlocks(
+                   std::span<const std::uint8_t>(initial_counter_block).first(8), 0, 1),
+               std::invalid_argument);
+}
+
+TEST(Aes128, BooleanGmwCtrKeystreamMatchesOpenSsl) { TestAes128Ctr<MpcProtocol::kBooleanGmw>(2); }
+
+TEST(Aes128, BmrCtrKeystreamMatchesOpenSsl) { TestAes128Ctr<MpcProtocol::kBmr>(3); }
+
+}  // namespace
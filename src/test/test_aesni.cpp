@@ -20,11 +20,16 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 #include "test_constants.h"
 
+#include "primitives/aes/aes_batch_backend.h"
 #include "primitives/aes/aesni_primitives.h"
+#include "primitives/pseudo_random_generator.h"
+#include "utility/bit_vector.h"
 
 // Test vectors from NIST FIPS 197, Appendix A
 
@@ -131,6 +136,96 @@ TEST(AesNi128, CtrStreamBlockwise) {
   EXPECT_EQ(output, kExpectedOutput);
 }
 
+TEST(AesNi128, CtrStreamKernels) {
+  using encrypto::motion::BitwiseKernel;
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  // the lengths cover VAES batches, SSE batches and single blocks, and the counter wraps around
+  constexpr std::size_t kMaximumBlocks{300};
+  constexpr std::uint64_t kFirstCounter{~std::uint64_t(0) - 100};
+  std::vector<std::uint8_t> expected((kMaximumBlocks + 1) * kAesBlockSize);
+  std::uint64_t counter{kFirstCounter};
+  for (std::size_t n = 0; n < kMaximumBlocks; ++n) {
+    AesniCtrStreamSingleBlock128Unaligned(round_keys.data(), &counter,
+                                          expected.data() + n * kAesBlockSize);
+  }
+
+  const auto default_kernel{encrypto::motion::GetBitwiseKernel()};
+  for (auto kernel : {BitwiseKernel::kSse, BitwiseKernel::kAvx2, BitwiseKernel::kAvx512}) {
+    if (!encrypto::motion::IsSupported(kernel)) continue;
+    encrypto::motion::SetBitwiseKernel(kernel);
+    for (std::size_t n : {0, 1, 7, 8, 9, 63, 64, 65, 100, 129, 300}) {
+      alignas(kAesBlockSize) std::array<std::uint8_t, (kMaximumBlocks + 1) * kAesBlockSize> output;
+      counter = kFirstCounter;
+      AesniCtrStreamBlocks128(round_keys.data(), &counter, output.data(), n);
+      EXPECT_EQ(counter, kFirstCounter + n);
+      EXPECT_TRUE(std::equal(output.begin(), output.begin() + n * kAesBlockSize, expected.begin()));
+
+      counter = kFirstCounter;
+      AesniCtrStreamBlocks128Unaligned(round_keys.data(), &counter, output.data() + 1, n);
+      EXPECT_EQ(counter, kFirstCounter + n);
+      EXPECT_TRUE(
+          std::equal(output.begin() + 1, output.begin() + 1 + n * kAesBlockSize, expected.begin()));
+    }
+  }
+  encrypto::motion::SetBitwiseKernel(default_kernel);
+}
+
+TEST(AesNi128, CtrStreamWithNonce) {
+  using encrypto::motion::BitwiseKernel;
+  std::array<std::byte, kAesKeySize128> key;
+  for (std::size_t j = 0; j < key.size(); ++j) key[j] = std::byte(j * 7);
+  encrypto::motion::primitives::Prg prg;
+  prg.SetKey(key.data());
+
+  // the blocks nonce || counter are encrypted independently as the reference
+  constexpr std::size_t kMaximumBlocks{300};
+  constexpr std::uint64_t kNonce{0x0123456789abcdef}, kFirstCounter{1000};
+  std::vector<std::byte> input(kMaximumBlocks * kAesBlockSize);
+  for (std::size_t i = 0; i < kMaximumBlocks; ++i) {
+    const std::uint64_t counter{kFirstCounter + i};
+    std::memcpy(input.data() + i * kAesBlockSize, &kNonce, sizeof(kNonce));
+    std::memcpy(input.data() + i * kAesBlockSize + sizeof(kNonce), &counter, sizeof(counter));
+  }
+  const auto expected{prg.Encrypt(input.data(), input.size())};
+
+  const auto default_kernel{encrypto::motion::GetBitwiseKernel()};
+  for (auto kernel : {BitwiseKernel::kSse, BitwiseKernel::kAvx2, BitwiseKernel::kAvx512}) {
+    if (!encrypto::motion::IsSupported(kernel)) continue;
+    encrypto::motion::SetBitwiseKernel(kernel);
+    for (std::size_t n : {0, 1, 7, 8, 9, 63, 64, 65, 100, 129, 300}) {
+      std::vector<std::byte> output(n * kAesBlockSize + 1);
+      std::uint64_t counter{kFirstCounter};
+      AesniCtrStreamBlocks128WithNonce(prg.GetRoundKeys(), kNonce, &counter, output.data() + 1, n);
+      EXPECT_EQ(counter, kFirstCounter + n);
+      EXPECT_TRUE(std::equal(output.begin() + 1, output.end(), expected.begin()));
+    }
+  }
+  encrypto::motion::SetBitwiseKernel(default_kernel);
+}
+
+TEST(Prg, KeyStream) {
+  std::array<std::byte, kAesKeySize128> key;
+  for (std::size_t j = 0; j < key.size(); ++j) key[j] = std::byte(j * 11);
+  encrypto::motion::primitives::Prg prg;
+  prg.SetKey(key.data());
+  prg.SetOffset(5);
+  for (std::size_t bytes : {1, 15, 16, 17, 1000, 4096}) {
+    const auto expected{prg.Encrypt(bytes)};
+    std::vector<std::byte> output(bytes);
+    prg.KeyStream(output);
+    EXPECT_TRUE(std::equal(output.begin(), output.end(), expected.begin()));
+
+    const auto bits{8 * bytes - 3};
+    const encrypto::motion::BitVector<> expected_bits(prg.Encrypt(bytes), bits);
+    EXPECT_EQ(prg.KeyStreamBits(bits), expected_bits);
+  }
+}
+
 TEST(AesNi128, TmmoBatch4) {
   std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
                                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
@@ -157,6 +252,65 @@ TEST(AesNi128, TmmoBatch4) {
   EXPECT_EQ(output, kExpectedOutput);
 }
 
+TEST(AesNi128, TmmoBatchScattered) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  // more blocks than one batch, each in a separate (unaligned) buffer
+  constexpr std::size_t kNumberOfBlocks{11};
+  std::array<std::array<std::uint8_t, kAesBlockSize + 1>, kNumberOfBlocks> buffers;
+  std::array<void*, kNumberOfBlocks> inputs;
+  for (std::size_t j = 0; j < kNumberOfBlocks; ++j) {
+    std::fill(buffers[j].begin(), buffers[j].end(), static_cast<std::uint8_t>(0x41 + j));
+    inputs[j] = buffers[j].data() + 1;
+  }
+  const auto expected_buffers{buffers};
+  __uint128_t tweak = 0xdeadbeefdeadcafe;
+  tweak <<= 64;
+  tweak |= 0xbeefcafecafebeef;
+  AesniTmmoBatch(round_keys.data(), inputs.data(), kNumberOfBlocks, tweak);
+
+  for (std::size_t j = 0; j < kNumberOfBlocks; ++j) {
+    alignas(kAesBlockSize) std::array<std::uint8_t, 4 * kAesBlockSize> expected;
+    for (std::size_t k = 0; k < 4; ++k) {
+      std::copy(expected_buffers[j].begin() + 1, expected_buffers[j].end(),
+                expected.begin() + k * kAesBlockSize);
+    }
+    AesniTmmoBatch4(round_keys.data(), expected.data(), tweak + j);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.begin() + kAesBlockSize,
+                           buffers[j].begin() + 1));
+    EXPECT_EQ(buffers[j][0], expected_buffers[j][0]);
+  }
+}
+
+TEST(AesNi128, TmmoBatchContiguous) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  // enough lanes of six blocks to cover a VAES batch, an SSE batch and single blocks
+  constexpr std::size_t kNumberOfLanes{11};
+  alignas(kAesBlockSize) std::array<std::uint8_t, 6 * kNumberOfLanes * kAesBlockSize> blocks;
+  for (std::size_t j = 0; j < blocks.size(); ++j) blocks[j] = static_cast<std::uint8_t>(j * 7);
+  auto expected{blocks};
+  __uint128_t tweak = 0xdeadbeefdeadcafe;
+  tweak <<= 64;
+  tweak |= 0xbeefcafecafebeef;
+
+  // AesniTmmoBatch6 uses the tweaks 3 * tweak - 3, 3 * tweak - 2 and 3 * tweak - 1 on pairs of
+  // blocks, so consecutive lanes continue the tweaks of the previous lane
+  AesniTmmoBatchContiguous(round_keys.data(), blocks.data(), 6 * kNumberOfLanes, 3 * tweak - 3, 2);
+  for (std::size_t k = 0; k < kNumberOfLanes; ++k) {
+    AesniTmmoBatch6(round_keys.data(), expected.data() + 6 * k * kAesBlockSize, tweak + k);
+  }
+  EXPECT_EQ(blocks, expected);
+}
+
 TEST(AesNi128, MmoSingle) {
   std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
                                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
@@ -173,3 +327,91 @@ TEST(AesNi128, MmoSingle) {
   AesniMmoSingle(round_keys.data(), output.data());
   EXPECT_EQ(output, kExpectedOutput);
 }
+
+TEST(AesNi128, BmrDkcBatch) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  // the number of blocks covers a batch and a remainder
+  constexpr std::size_t kNumberOfTuples{5}, kNumberOfParties{3};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kNumberOfTuples * kAesBlockSize> keys_a, keys_b;
+  for (std::size_t j = 0; j < keys_a.size(); ++j) {
+    keys_a[j] = static_cast<std::uint8_t>(j * 7);
+    keys_b[j] = static_cast<std::uint8_t>(j * 13 + 1);
+  }
+  const std::array<std::uint64_t, kNumberOfTuples> gate_ids = {42, 43, 44, 7, 1ull << 40};
+  alignas(kAesBlockSize)
+      std::array<std::uint8_t, kNumberOfTuples * kNumberOfParties * kAesBlockSize> output;
+  for (std::size_t j = 0; j < output.size(); ++j) output[j] = static_cast<std::uint8_t>(j);
+  auto expected{output};
+
+  AesniBmrDkcBatch(round_keys.data(), keys_a.data(), keys_b.data(), gate_ids.data(),
+                   kNumberOfTuples, kNumberOfParties, output.data());
+  for (std::size_t j = 0; j < kNumberOfTuples; ++j) {
+    AesniBmrDkc(round_keys.data(), keys_a.data() + j * kAesBlockSize,
+                keys_b.data() + j * kAesBlockSize, gate_ids[j], kNumberOfParties,
+                expected.data() + j * kNumberOfParties * kAesBlockSize);
+  }
+  EXPECT_EQ(output, expected);
+}
+
+TEST(AesNi128, ThreadedBatchBackendMatchesPrimitives) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+  __uint128_t tweak = 0xdeadbeefdeadcafe;
+  tweak <<= 64;
+  tweak |= 0xbeefcafecafebeef;
+
+  // a small minimum batch size splits the batches into uneven chunks on three threads
+  encrypto::motion::primitives::SetAesBatchBackend(
+      std::make_shared<encrypto::motion::primitives::ThreadedAesBatchBackend>(3, 5));
+
+  constexpr std::size_t kNumberOfBlocks{6 * 11};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kNumberOfBlocks * kAesBlockSize> blocks;
+  for (std::size_t j = 0; j < blocks.size(); ++j) blocks[j] = static_cast<std::uint8_t>(j * 7);
+  auto expected{blocks};
+  encrypto::motion::primitives::AesBatchTmmoContiguous(round_keys.data(), blocks.data(),
+                                                       kNumberOfBlocks, tweak, 2);
+  AesniTmmoBatchContiguous(round_keys.data(), expected.data(), kNumberOfBlocks, tweak, 2);
+  EXPECT_EQ(blocks, expected);
+
+  auto scattered{blocks};
+  std::array<void*, kNumberOfBlocks> inputs;
+  for (std::size_t j = 0; j < kNumberOfBlocks; ++j) {
+    inputs[j] = scattered.data() + (kNumberOfBlocks - 1 - j) * kAesBlockSize;
+  }
+  encrypto::motion::primitives::AesBatchTmmo(round_keys.data(), inputs.data(), kNumberOfBlocks,
+                                             tweak);
+  for (std::size_t j = 0; j < kNumberOfBlocks; ++j) {
+    inputs[j] = blocks.data() + (kNumberOfBlocks - 1 - j) * kAesBlockSize;
+  }
+  AesniTmmoBatch(round_keys.data(), inputs.data(), kNumberOfBlocks, tweak);
+  EXPECT_EQ(scattered, blocks);
+
+  constexpr std::size_t kNumberOfTuples{13}, kNumberOfParties{3};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kNumberOfTuples * kAesBlockSize> keys_a, keys_b;
+  for (std::size_t j = 0; j < keys_a.size(); ++j) {
+    keys_a[j] = static_cast<std::uint8_t>(j * 7);
+    keys_b[j] = static_cast<std::uint8_t>(j * 13 + 1);
+  }
+  std::array<std::uint64_t, kNumberOfTuples> gate_ids;
+  for (std::size_t j = 0; j < kNumberOfTuples; ++j) gate_ids[j] = 42 + j / 4;
+  alignas(kAesBlockSize)
+      std::array<std::uint8_t, kNumberOfTuples * kNumberOfParties * kAesBlockSize> output;
+  for (std::size_t j = 0; j < output.size(); ++j) output[j] = static_cast<std::uint8_t>(j);
+  auto expected_output{output};
+  encrypto::motion::primitives::AesBatchBmrDkc(round_keys.data(), keys_a.data(), keys_b.data(),
+                                               gate_ids.data(), kNumberOfTuples,
+                                               kNumberOfParties, output.data());
+  AesniBmrDkcBatch(round_keys.data(), keys_a.data(), keys_b.data(), gate_ids.data(),
+                   kNumberOfTuples, kNumberOfParties, expected_output.data());
+  EXPECT_EQ(output, expected_output);
+
+  encrypto::motion::primitives::SetAesBatchBackend(nullptr);
+}
@@ -23,15 +23,30 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 #include <future>
+#include <numeric>
+#include <sstream>
 
+#include "algorithm/arithmetic_circuit.h"
+#include "algorithm/low_depth_reduce.h"
+#include "base/backend.h"
+#include "base/motion_base_provider.h"
 #include "base/party.h"
+#include "communication/communication_layer.h"
+#include "communication/dummy_transport.h"
+#include "communication/recording_transport.h"
+#include "oblivious_transfer/ot_batch.h"
+#include "oblivious_transfer/ot_provider.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
 #include "protocols/share_wrapper.h"
+#include "secure_type/secure_fixed_point.h"
 #include "secure_type/secure_signed_integer.h"
 #include "test_constants.h"
 #include "test_helpers.h"
+#include "utility/mapped_file.h"
 
 
 namespace {
@@ -97,6 +112,44 @@ TEST(ArithmeticGmw, InputOutput_1_1K_Simd_2_3_4_5_10_parties) {
   }
 }
 
+TEST(ArithmeticGmw, DeferredInput_100_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  const auto input_0{::RandomVector<std::uint32_t>(kNumberOfSimd)};
+  const auto input_1{::RandomVector<std::uint32_t>(kNumberOfSimd)};
+  std::vector<std::uint32_t> expected(kNumberOfSimd);
+  for (std::size_t i = 0; i < kNumberOfSimd; ++i) expected[i] = input_0[i] * input_1[i];
+  const std::vector<std::uint32_t> zeros(kNumberOfSimd, 0);
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(true);
+    }
+    std::vector<std::future<void>> futures;
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+        auto& party{motion_parties.at(party_id)};
+        auto [share_0, promise]{party->DeferredIn<kArithmeticGmw, std::uint32_t>(0, kNumberOfSimd)};
+        EXPECT_EQ(promise != nullptr, party_id == 0);
+        encrypto::motion::ShareWrapper share_1{
+            party->In<kArithmeticGmw>(party_id == 1 ? input_1 : zeros, 1)};
+        auto share_output{(encrypto::motion::ShareWrapper(share_0) * share_1).Out()};
+
+        // the multiplication triples are generated before party 0 provides its input
+        auto running{party->RunAsync()};
+        if (promise != nullptr) promise->set_value(input_0);
+        running.get();
+
+        EXPECT_EQ(share_output.As<std::vector<std::uint32_t>>(), expected);
+        party->Finish();
+      }));
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
 TEST(ArithmeticGmw, Addition_1_1K_Simd_2_3_4_5_10_parties) {
   constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
   std::srand(std::time(nullptr));
@@ -488,6 +541,441 @@ TEST(ArithmeticGmw, Multiplication_1_100_Simd_2_3_parties) {
   }
 }
 
+TEST(ArithmeticGmw, MultiInputMultiplication_10_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{10};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    // 2 to 4 inputs use a single gate, 5 and 9 inputs a tree of them
+    for (std::size_t number_of_inputs : {2u, 3u, 4u, 5u, 9u}) {
+      for (auto number_of_parties : {2u, 3u}) {
+        std::vector<std::vector<T>> inputs(number_of_inputs);
+        for (auto& input : inputs) input = ::RandomVector<T>(kNumberOfSimd);
+        const std::vector<T> expected_result = RowMulReduction<T>(inputs);
+
+        std::vector<PartyPointer> motion_parties(
+            std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+        for (auto& party : motion_parties) {
+          party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+          party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+        }
+        std::vector<std::future<void>> futures;
+        for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+          futures.emplace_back(std::async(std::launch::async, [party_id, number_of_parties,
+                                                               &motion_parties, &inputs,
+                                                               &expected_result] {
+            auto& party = motion_parties.at(party_id);
+            std::vector<ShareWrapper> share_inputs;
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+              const std::size_t input_owner{i % number_of_parties};
+              share_inputs.emplace_back(party->In<kArithmeticGmw>(
+                  party_id == input_owner ? inputs.at(i) : std::vector<T>(kNumberOfSimd, 0),
+                  input_owner));
+            }
+            auto share_output = Product(share_inputs).Out();
+
+            party->Run();
+
+            EXPECT_EQ(share_output.As<std::vector<T>>(), expected_result);
+            party->Finish();
+          }));
+        }
+        for (auto& f : futures) f.get();
+      }
+    }
+  };
+  template_test(static_cast<std::uint8_t>(0));
+  template_test(static_cast<std::uint16_t>(0));
+  template_test(static_cast<std::uint32_t>(0));
+  template_test(static_cast<std::uint64_t>(0));
+}
+
+TEST(ArithmeticGmw, InputColumn_1K_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfValues{1000};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::vector<T> column = ::RandomVector<T>(kNumberOfValues);
+      const std::vector<T> other_input = ::RandomVector<T>(kNumberOfValues);
+      const auto path{std::filesystem::temp_directory_path() /
+                      fmt::format("motion_input_column_{}.bin", sizeof(T))};
+      std::ofstream(path, std::ios::binary)
+          .write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+      std::vector<T> expected_result(kNumberOfValues);
+      for (std::size_t i = 0; i < kNumberOfValues; ++i) {
+        expected_result[i] = column[i] + other_input[i];
+      }
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      }
+      // the last party owns the column and the first one the other input
+      const std::size_t column_owner{number_of_parties - 1};
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, column_owner, &path,
+                                                             &motion_parties, &other_input,
+                                                             &expected_result] {
+          auto& party = motion_parties.at(party_id);
+          auto& backend{*party->GetBackend()};
+          ShareWrapper share_column{
+              party_id == column_owner
+                  ? backend.ArithmeticGmwInputColumn<T>(column_owner, path)
+                  : backend.ArithmeticGmwInputColumn<T>(column_owner, kNumberOfValues)};
+          ShareWrapper share_other_input{party->In<kArithmeticGmw>(
+              party_id == 0 ? other_input : std::vector<T>(kNumberOfValues, 0), 0)};
+          auto share_output = (share_column + share_other_input).Out();
+
+          party->Run();
+
+          EXPECT_EQ(share_output.As<std::vector<T>>(), expected_result);
+          party->Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+      std::filesystem::remove(path);
+    }
+  };
+  template_test(static_cast<std::uint8_t>(0));
+  template_test(static_cast<std::uint16_t>(0));
+  template_test(static_cast<std::uint32_t>(0));
+  template_test(static_cast<std::uint64_t>(0));
+}
+
+TEST(ArithmeticGmw, ChunkedInputColumn_1K_Simd_2_3_parties) {
+  constexpr std::size_t kNumberOfValues{1000}, kChunkSize{300};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::vector<T> column = ::RandomVector<T>(kNumberOfValues);
+      const auto path{std::filesystem::temp_directory_path() /
+                      fmt::format("motion_chunked_input_column_{}.bin", sizeof(T))};
+      std::ofstream(path, std::ios::binary)
+          .write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      }
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(
+            std::async(std::launch::async, [party_id, &path, &motion_parties, &column] {
+              auto& party = motion_parties.at(party_id);
+              auto& backend{*party->GetBackend()};
+              std::shared_ptr<const MappedFile> file;
+              if (party_id == 0) file = std::make_shared<const MappedFile>(path);
+              // the revealed column is written chunk by chunk into the output buffer
+              std::vector<T> output(kNumberOfValues);
+              for (std::size_t begin = 0; begin < kNumberOfValues; begin += kChunkSize) {
+                const std::size_t chunk_size{
+                    begin + kChunkSize < kNumberOfValues ? kChunkSize : kNumberOfValues - begin};
+                ShareWrapper share_chunk{
+                    party_id == 0 ? backend.ArithmeticGmwInputColumn<T>(
+                                        0, file->GetValues<T>().subspan(begin, chunk_size), file)
+                                  : backend.ArithmeticGmwInputColumn<T>(0, chunk_size)};
+                auto share_output = share_chunk.Out();
+
+                party->Run();
+
+                share_output.WriteTo(std::span<T>(output).subspan(begin, chunk_size));
+                party->Reset();
+              }
+              EXPECT_EQ(output, column);
+              party->Finish();
+            }));
+      }
+      for (auto& f : futures) f.get();
+      std::filesystem::remove(path);
+    }
+  };
+  template_test(static_cast<std::uint8_t>(0));
+  template_test(static_cast<std::uint32_t>(0));
+  template_test(static_cast<std::uint64_t>(0));
+}
+
+TEST(ArithmeticGmw, SimdReduceAndScan_13_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{13};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::vector<T> input{::RandomVector<T>(kNumberOfSimd)};
+      const T expected_product{std::accumulate(input.begin(), input.end(), T(1),
+                                               [](T a, T b) { return static_cast<T>(a * b); })};
+      std::vector<T> expected_sums(kNumberOfSimd);
+      std::inclusive_scan(input.begin(), input.end(), expected_sums.begin(),
+                          [](T a, T b) { return static_cast<T>(a + b); });
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      }
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, &motion_parties, &input,
+                                                             &expected_product, &expected_sums] {
+          auto& party = motion_parties.at(party_id);
+          ShareWrapper share_input{party->In<kArithmeticGmw>(
+              party_id == 0 ? input : std::vector<T>(kNumberOfSimd, 0), 0)};
+          // each level of the tree and of the prefix network is a single multiplication or
+          // addition gate on all SIMD values
+          auto share_product{SimdLowDepthReduce(share_input, std::multiplies<>()).Out()};
+          auto share_sums{Scan(share_input, std::plus<>()).Out()};
+
+          party->Run();
+
+          EXPECT_EQ(share_product.As<std::vector<T>>(), std::vector<T>{expected_product});
+          EXPECT_EQ(share_sums.As<std::vector<T>>(), expected_sums);
+          party->Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+    }
+  };
+  template_test(static_cast<std::uint8_t>(0));
+  template_test(static_cast<std::uint16_t>(0));
+  template_test(static_cast<std::uint32_t>(0));
+  template_test(static_cast<std::uint64_t>(0));
+}
+
+// a linear layer of 3 neurons on 4 inputs x0, ..., x3 with the weights in wires 4, ..., 15 and
+// further operations on its outputs
+constexpr char kArithmeticCircuit[]{R"(10 26
+16 10
+DOT 4 0 1 2 3 4 5 6 7 16
+DOT 4 0 1 2 3 8 9 10 11 17
+DOT 4 0 1 2 3 12 13 14 15 18
+ADD 0 1 19
+SUB 2 3 20
+
+MUL 0 1 21
+CMUL 3 7 22
+MUL 16 17 23
+CMUL 18 5 24
+ADD 19 20 25
+)"};
+
+TEST(ArithmeticAlgorithmDescription, LoadsAndLayersText) {
+  std::istringstream stream(kArithmeticCircuit);
+  const auto circuit{ArithmeticAlgorithmDescription::FromText(stream)};
+  EXPECT_EQ(circuit.number_of_input_wires, 16);
+  EXPECT_EQ(circuit.number_of_output_wires, 10);
+  ASSERT_EQ(circuit.operations.size(), 10);
+  EXPECT_TRUE(circuit.operations[0].type == ArithmeticOperationType::kDot);
+  EXPECT_EQ(circuit.operations[0].input_wires.size(), 8);
+  EXPECT_EQ(circuit.operations[6].constant, 7);
+  const auto layers{circuit.ComputeLayers()};
+  ASSERT_EQ(layers.size(), 2);
+  EXPECT_EQ(layers[0], (std::vector<std::size_t>{0, 1, 2, 3, 4, 5, 6}));
+  EXPECT_EQ(layers[1], (std::vector<std::size_t>{7, 8, 9}));
+
+  for (const char* malformed : {"1 3\n2 1\nPOW 0 1 2\n", "1 3\n2 1\nADD 0 2 2\n",
+                                "1 3\n2 1\nADD 0 1\n", "2 3\n2 1\nADD 0 1 2\n",
+                                "1 3\n2 1\nADD 0 1 1\n"}) {
+    std::istringstream malformed_stream(malformed);
+    EXPECT_THROW(ArithmeticAlgorithmDescription::FromText(malformed_stream), std::runtime_error);
+  }
+}
+
+TEST(ArithmeticGmw, ArithmeticCircuit_3_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{3};
+  std::istringstream stream(kArithmeticCircuit);
+  const auto circuit{ArithmeticAlgorithmDescription::FromText(stream)};
+  auto template_test = [&circuit](auto template_variable) {
+    using T = decltype(template_variable);
+    for (auto number_of_parties : {2u, 3u}) {
+      std::vector<std::vector<T>> inputs(circuit.number_of_input_wires);
+      for (auto& input : inputs) input = ::RandomVector<T>(kNumberOfSimd);
+      std::vector<std::vector<T>> expected(circuit.number_of_output_wires,
+                                           std::vector<T>(kNumberOfSimd));
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        auto x = [&inputs, i](std::size_t wire) { return inputs[wire][i]; };
+        for (std::size_t neuron = 0; neuron < 3; ++neuron) {
+          T sum{0};
+          for (std::size_t j = 0; j < 4; ++j) sum += T(x(j) * x(4 + 4 * neuron + j));
+          expected[neuron][i] = sum;
+        }
+        expected[3][i] = T(x(0) + x(1));
+        expected[4][i] = T(x(2) - x(3));
+        expected[5][i] = T(x(0) * x(1));
+        expected[6][i] = T(x(3) * 7);
+        expected[7][i] = T(expected[0][i] * expected[1][i]);
+        expected[8][i] = T(expected[2][i] * 5);
+        expected[9][i] = T(expected[3][i] + expected[4][i]);
+      }
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      }
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, &motion_parties, &inputs,
+                                                             &expected, &circuit] {
+          auto& party = motion_parties.at(party_id);
+          std::vector<ShareWrapper> shares;
+          for (const auto& input : inputs) {
+            shares.emplace_back(party->In<kArithmeticGmw>(
+                party_id == 0 ? input : std::vector<T>(kNumberOfSimd, 0), 0));
+          }
+          const auto& register_pointer{party->GetBackend()->GetRegister()};
+          const std::size_t number_of_gates{register_pointer->GetGates().size()};
+          const auto results{algorithm::EvaluateArithmeticCircuit(circuit, shares)};
+          // the dot products of the linear layer are a single multiplication, i.e., there is one
+          // multiplication per layer that multiplies shares
+          std::size_t number_of_multiplications{0};
+          const auto& gates{register_pointer->GetGates()};
+          for (std::size_t i = number_of_gates; i < gates.size(); ++i) {
+            if (dynamic_cast<const proto::arithmetic_gmw::MultiplicationGate<T>*>(gates[i].get())) {
+              ++number_of_multiplications;
+            }
+          }
+          EXPECT_EQ(number_of_multiplications, 3);
+          std::vector<ShareWrapper> outputs;
+          for (const auto& result : results) outputs.emplace_back(result.Out());
+
+          party->Run();
+
+          ASSERT_EQ(outputs.size(), expected.size());
+          for (std::size_t i = 0; i < outputs.size(); ++i) {
+            EXPECT_EQ(outputs[i].As<std::vector<T>>(), expected[i]);
+          }
+          party->Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+    }
+  };
+  template_test(static_cast<std::uint8_t>(0));
+  template_test(static_cast<std::uint32_t>(0));
+  template_test(static_cast<std::uint64_t>(0));
+}
+
+TEST(ArithmeticGmw, MatrixMultiplication_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kRows = 3, kInner = 4, kColumns = 5;
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::vector<T> a = ::RandomVector<T>(kRows * kInner);
+      const std::vector<T> b = ::RandomVector<T>(kInner * kColumns);
+      std::vector<T> expected_result(kRows * kColumns, 0);
+      for (std::size_t r = 0; r < kRows; ++r) {
+        for (std::size_t l = 0; l < kInner; ++l) {
+          for (std::size_t m = 0; m < kColumns; ++m) {
+            expected_result.at(r * kColumns + m) += a.at(r * kInner + l) * b.at(l * kColumns + m);
+          }
+        }
+      }
+      const std::size_t b_owner = number_of_parties - 1;
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+      }
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, b_owner, &motion_parties,
+                                                             &a, &b, &expected_result] {
+          auto& party = motion_parties.at(party_id);
+          ShareWrapper share_a = party->In<kArithmeticGmw>(
+              party_id == 0 ? a : std::vector<T>(kRows * kInner, 0), 0);
+          ShareWrapper share_b = party->In<kArithmeticGmw>(
+              party_id == b_owner ? b : std::vector<T>(kInner * kColumns, 0), b_owner);
+          auto share_output =
+              MatrixMultiplication(share_a, share_b, kRows, kInner, kColumns).Out();
+
+          party->Run();
+
+          EXPECT_EQ(share_output.As<std::vector<T>>(), expected_result);
+          party->Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+    }
+  };
+  for (auto i = 0ull; i < kTestIterations; ++i) {
+    template_test(static_cast<std::uint8_t>(0));
+    template_test(static_cast<std::uint16_t>(0));
+    template_test(static_cast<std::uint32_t>(0));
+    template_test(static_cast<std::uint64_t>(0));
+  }
+}
+
+TEST(ArithmeticGmw, FixedPointMultiplication_10_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{10};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    constexpr std::size_t kBitLength{sizeof(T) * 8};
+    constexpr std::size_t kNumberOfFractionalBits{kBitLength / 4};
+    // the products of the encodings must be smaller than 2^(k - 2) in absolute value
+    constexpr std::int64_t kBound{std::int64_t(1) << ((kBitLength - 3) / 2)};
+    for (auto number_of_parties : {2u, 3u}) {
+      std::uniform_int_distribution<std::int64_t> dist(-kBound, kBound);
+      std::vector<T> a(kNumberOfSimd), b(kNumberOfSimd);
+      std::vector<std::int64_t> expected_result(kNumberOfSimd);
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        const std::int64_t a_i{dist(random_value)}, b_i{dist(random_value)};
+        a.at(i) = static_cast<T>(a_i);
+        b.at(i) = static_cast<T>(b_i);
+        expected_result.at(i) = (a_i * b_i) >> kNumberOfFractionalBits;
+      }
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+      }
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, number_of_parties,
+                                                             &motion_parties, &a, &b,
+                                                             &expected_result] {
+          auto& party = motion_parties.at(party_id);
+          const std::vector<T> zeros(kNumberOfSimd, 0);
+          encrypto::motion::SecureFixedPoint share_a(
+              party->In<kArithmeticGmw>(party_id == 0 ? a : zeros, 0), kNumberOfFractionalBits);
+          encrypto::motion::SecureFixedPoint share_b(
+              party->In<kArithmeticGmw>(party_id == number_of_parties - 1 ? b : zeros,
+                                        number_of_parties - 1),
+              kNumberOfFractionalBits);
+          auto share_output = (share_a * share_b).Out();
+
+          party->Run();
+
+          const auto result{share_output.As<std::vector<double>>()};
+          ASSERT_EQ(result.size(), expected_result.size());
+          for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+            // the probabilistic truncation is off by at most one in the last bit
+            const std::int64_t encoded_result{std::llround(
+                std::ldexp(result.at(i), static_cast<int>(kNumberOfFractionalBits)))};
+            EXPECT_GE(encoded_result, expected_result.at(i));
+            EXPECT_LE(encoded_result, expected_result.at(i) + 1);
+          }
+          party->Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+    }
+  };
+  template_test(static_cast<std::uint8_t>(0));
+  template_test(static_cast<std::uint16_t>(0));
+  template_test(static_cast<std::uint32_t>(0));
+  template_test(static_cast<std::uint64_t>(0));
+}
+
 TEST(ArithmeticGmw, ConstantMultiplication_1_1K_Simd_2_3_4_5_10_parties) {
   constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
   constexpr auto kArithmeticConstant = encrypto::motion::MpcProtocol::kArithmeticConstant;
@@ -692,6 +1180,87 @@ TYPED_TEST(ArithmeticGmwTest, GreaterThan_1_1000_Simd_2_parties) {
   }
 }
 
+TYPED_TEST(ArithmeticGmwTest, Comparisons_1000_Simd_2_parties) {
+  using T = TypeParam;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr auto kArithmeticConstant = encrypto::motion::MpcProtocol::kArithmeticConstant;
+  constexpr std::size_t kNumberOfParties{2}, kNumberOfSimd{1000};
+  const std::vector<T> kZeroV(kNumberOfSimd, 0);
+
+  // order comparisons require values smaller than 2^{bit_length - 1}, every other pair is equal
+  std::mt19937_64 gen(std::random_device{}());
+  std::uniform_int_distribution<T> dist(0, std::numeric_limits<T>::max() >> 1);
+  std::vector<T> a(kNumberOfSimd), b(kNumberOfSimd), constant(kNumberOfSimd);
+  for (auto i = 0u; i < kNumberOfSimd; ++i) {
+    a.at(i) = dist(gen);
+    b.at(i) = i % 2 == 0 ? a.at(i) : dist(gen);
+    constant.at(i) = i % 4 == 0 ? a.at(i) : dist(gen);
+  }
+  const T lower{static_cast<T>(std::numeric_limits<T>::max() >> 3)};
+  const T upper{static_cast<T>(std::numeric_limits<T>::max() >> 2)};
+
+  try {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+    }
+
+    std::vector<std::thread> threads(kNumberOfParties);
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      threads.at(party_id) = std::thread([party_id, &motion_parties, &a, &b, &constant, &kZeroV,
+                                          lower, upper]() {
+        auto& party{motion_parties.at(party_id)};
+        encrypto::motion::ShareWrapper share_a =
+            party->In<kArithmeticGmw>(party_id == 0 ? a : kZeroV, 0);
+        encrypto::motion::ShareWrapper share_b =
+            party->In<kArithmeticGmw>(party_id == 1 ? b : kZeroV, 1);
+        encrypto::motion::ShareWrapper share_constant = party->In<kArithmeticConstant>(constant);
+        encrypto::motion::ShareWrapper share_lower =
+            party->In<kArithmeticConstant>(std::vector<T>(a.size(), lower));
+        encrypto::motion::ShareWrapper share_upper =
+            party->In<kArithmeticConstant>(std::vector<T>(a.size(), upper));
+
+        std::vector<encrypto::motion::ShareWrapper> outputs{
+            (share_a == share_b).Out(),
+            (share_a < share_b).Out(),
+            (share_a <= share_b).Out(),
+            (share_a >= share_b).Out(),
+            (share_a == share_constant).Out(),
+            (share_constant > share_a).Out(),
+            (share_a <= share_constant).Out(),
+            share_a.IsInRange(share_lower, share_upper).Out()};
+
+        party->Run();
+
+        std::vector<BitVector<>> results;
+        for (auto& output : outputs) {
+          results.push_back(output.As<std::vector<BitVector<>>>().at(0));
+        }
+        for (auto i = 0u; i < a.size(); ++i) {
+          EXPECT_EQ(results.at(0).Get(i), a.at(i) == b.at(i));
+          EXPECT_EQ(results.at(1).Get(i), a.at(i) < b.at(i));
+          EXPECT_EQ(results.at(2).Get(i), a.at(i) <= b.at(i));
+          EXPECT_EQ(results.at(3).Get(i), a.at(i) >= b.at(i));
+          EXPECT_EQ(results.at(4).Get(i), a.at(i) == constant.at(i));
+          EXPECT_EQ(results.at(5).Get(i), constant.at(i) > a.at(i));
+          EXPECT_EQ(results.at(6).Get(i), a.at(i) <= constant.at(i));
+          EXPECT_EQ(results.at(7).Get(i), lower <= a.at(i) && a.at(i) <= upper);
+        }
+
+        party->Finish();
+      });
+    }
+
+    for (auto& t : threads) {
+      t.join();
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
 class PartyGenerator {
  protected:
   void GenerateParties(bool online_after_setup) {
@@ -833,6 +1402,113 @@ TYPED_TEST(TypedHybridAgmwTest, HybridMultiplication_1_1K_Simd_2_parties) {
   for (auto& future : futures) future.get();
 }
 
+TYPED_TEST(TypedHybridAgmwTest, BatchedHybridMultiplication_2_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  std::vector<std::future<void>> futures;
+
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [this, party_id]() {
+      auto& party{this->parties_.at(party_id)};
+      const std::vector<TypeParam> dummy_values(this->values_1k_.size(), 0);
+      const encrypto::motion::BitVector<> dummy_bits(this->bits_1k_.GetSize(), false);
+      encrypto::motion::ShareWrapper share_value_1{
+          party->template In<kArithmeticGmw>(party_id == 0 ? this->value_ : 0, 0)};
+      encrypto::motion::ShareWrapper share_values_1K{party->template In<kArithmeticGmw>(
+          party_id == 0 ? this->values_1k_ : dummy_values, 0)};
+      encrypto::motion::ShareWrapper share_bit_1{
+          party->template In<kBooleanGmw>(party_id == 1 ? this->bit_ : false, 1)};
+      encrypto::motion::ShareWrapper share_bits_1K{
+          party->template In<kBooleanGmw>(party_id == 1 ? this->bits_1k_ : dummy_bits, 1)};
+
+      // both products share one AC-OT vector in each direction
+      auto& ot_batcher{party->GetBackend()->GetOtProviderManager().GetOtBatcher()};
+      ot_batcher.Open();
+      auto share_mul_1{share_bit_1 * share_value_1};
+      auto share_mul_1K{share_bits_1K * share_values_1K};
+      ot_batcher.Close();
+      // depends on a batched product, hence it registers its own OTs
+      auto share_mul_1K_twice{share_bits_1K * share_mul_1K};
+
+      auto share_output_1{share_mul_1.Out()};
+      auto share_output_1K{share_mul_1K.Out()};
+      auto share_output_1K_twice{share_mul_1K_twice.Out()};
+
+      party->Run();
+
+      EXPECT_EQ(share_output_1.As<TypeParam>(), this->bit_ ? this->value_ : 0);
+      const auto result_1K{share_output_1K.As<std::vector<TypeParam>>()};
+      const auto result_1K_twice{share_output_1K_twice.As<std::vector<TypeParam>>()};
+      ASSERT_EQ(result_1K.size(), this->values_1k_.size());
+      ASSERT_EQ(result_1K_twice.size(), this->values_1k_.size());
+      for (std::size_t i = 0; i < this->values_1k_.size(); ++i) {
+        const TypeParam expected_result{this->bits_1k_[i] ? this->values_1k_[i] : TypeParam(0)};
+        EXPECT_EQ(result_1K[i], expected_result);
+        EXPECT_EQ(result_1K_twice[i], expected_result);
+      }
+
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TYPED_TEST(TypedHybridAgmwTest, BitInjectionAndMux_1K_Simd_2_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  // the second values are the first ones in reverse order
+  const std::vector<TypeParam> other_values_1k(this->values_1k_.rbegin(), this->values_1k_.rend());
+  std::vector<TypeParam> selection_values_1k(this->values_1k_.size());
+  for (std::size_t i = 0; i < selection_values_1k.size(); ++i) {
+    selection_values_1k[i] = this->bits_1k_[i];
+  }
+  std::vector<std::future<void>> futures;
+
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [this, party_id, &other_values_1k,
+                                                      &selection_values_1k]() {
+      auto& party{this->parties_.at(party_id)};
+      const std::vector<TypeParam> dummy_values(this->values_1k_.size(), 0);
+      const encrypto::motion::BitVector<> dummy_bits(this->bits_1k_.GetSize(), false);
+      encrypto::motion::ShareWrapper share_values{party->template In<kArithmeticGmw>(
+          party_id == 0 ? this->values_1k_ : dummy_values, 0)};
+      encrypto::motion::ShareWrapper share_other_values{
+          party->template In<kArithmeticGmw>(party_id == 1 ? other_values_1k : dummy_values, 1)};
+      encrypto::motion::ShareWrapper share_bits{
+          party->template In<kBooleanGmw>(party_id == 1 ? this->bits_1k_ : dummy_bits, 1)};
+      encrypto::motion::ShareWrapper share_selection_values{party->template In<kArithmeticGmw>(
+          party_id == 1 ? selection_values_1k : dummy_values, 1)};
+
+      const auto products{share_bits.BitInjection(
+          std::vector<encrypto::motion::ShareWrapper>{share_values, share_other_values})};
+      ASSERT_EQ(products.size(), 2u);
+      auto share_output_product{products.at(0).Out()};
+      auto share_output_other_product{products.at(1).Out()};
+      auto share_output_mux{share_bits.Mux(share_values, share_other_values).Out()};
+      auto share_output_arithmetic_mux{
+          share_selection_values.Mux(share_values, share_other_values).Out()};
+
+      party->Run();
+
+      const auto product{share_output_product.As<std::vector<TypeParam>>()};
+      const auto other_product{share_output_other_product.As<std::vector<TypeParam>>()};
+      const auto mux{share_output_mux.As<std::vector<TypeParam>>()};
+      const auto arithmetic_mux{share_output_arithmetic_mux.As<std::vector<TypeParam>>()};
+      ASSERT_EQ(product.size(), this->values_1k_.size());
+      for (std::size_t i = 0; i < this->values_1k_.size(); ++i) {
+        const bool bit{this->bits_1k_[i]};
+        EXPECT_EQ(product[i], bit ? this->values_1k_[i] : 0);
+        EXPECT_EQ(other_product[i], bit ? other_values_1k[i] : 0);
+        EXPECT_EQ(mux[i], bit ? this->values_1k_[i] : other_values_1k[i]);
+        EXPECT_EQ(arithmetic_mux[i], bit ? this->values_1k_[i] : other_values_1k[i]);
+      }
+
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
 template <typename T>
 class TypedSignedAgmwTest : public testing::Test,
                             public PartyGenerator,
@@ -897,4 +1573,128 @@ TYPED_TEST(TypedSignedAgmwTest, SignedSubtraction_1K_Simd_2_parties) {
   for (auto& future : futures) future.get();
 }
 
+TEST(ArithmeticGmw, MultiplicationSplitsWideGatesOverThreads) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfParties{3};
+  std::mt19937_64 random(0);
+  std::vector<std::uint16_t> input_a(10'001), input_b(10'001);
+  for (auto& value : input_a) value = static_cast<std::uint16_t>(random());
+  for (auto& value : input_b) value = static_cast<std::uint16_t>(random());
+  const std::vector<std::uint16_t> dummy_input(input_a.size(), 0);
+  auto motion_parties{MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetParallelGateThreshold(1'000);
+    party->GetConfiguration()->SetNumOfThreads(4);
+  }
+
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      auto& party{*motion_parties.at(party_id)};
+      encrypto::motion::ShareWrapper share_a{
+          party.In<kArithmeticGmw>(party_id == 0 ? input_a : dummy_input, 0)};
+      encrypto::motion::ShareWrapper share_b{
+          party.In<kArithmeticGmw>(party_id == 1 ? input_b : dummy_input, 1)};
+      auto share_output{(share_a * share_b).Out()};
+      party.Run();
+      const auto output{share_output.As<std::vector<std::uint16_t>>()};
+      ASSERT_EQ(output.size(), input_a.size());
+      for (std::size_t i = 0; i < output.size(); ++i) {
+        EXPECT_EQ(output[i], static_cast<std::uint16_t>(input_a[i] * input_b[i]));
+      }
+      party.Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(ArithmeticGmw, KingOpenings_10_Simd_3_4_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{10};
+  std::mt19937_64 random(0);
+  std::vector<std::vector<std::uint32_t>> inputs(3, std::vector<std::uint32_t>(kNumberOfSimd));
+  for (auto& input : inputs) {
+    for (auto& value : input) value = static_cast<std::uint32_t>(random());
+  }
+  const std::vector<std::uint32_t> dummy_input(kNumberOfSimd, 0);
+  for (std::size_t number_of_parties : {3u, 4u}) {
+    auto motion_parties{MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetKingOpenings(true);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+        auto& party{*motion_parties.at(party_id)};
+        std::vector<encrypto::motion::ShareWrapper> shares;
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+          shares.emplace_back(party.In<kArithmeticGmw>(party_id == i ? inputs[i] : dummy_input, i));
+        }
+        auto share_product{(shares[0] * shares[1]).Out()};
+        auto share_multi_input_product{Product(shares).Out()};
+        auto share_output_0{(shares[0] * shares[2]).Out(0)};
+        party.Run();
+        const auto product{share_product.As<std::vector<std::uint32_t>>()};
+        const auto multi_input_product{share_multi_input_product.As<std::vector<std::uint32_t>>()};
+        for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+          EXPECT_EQ(product[i], inputs[0][i] * inputs[1][i]);
+          EXPECT_EQ(multi_input_product[i], inputs[0][i] * inputs[1][i] * inputs[2][i]);
+        }
+        if (party_id == 0) {
+          const auto output_0{share_output_0.As<std::vector<std::uint32_t>>()};
+          for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+            EXPECT_EQ(output_0[i], inputs[0][i] * inputs[2][i]);
+          }
+        }
+        party.Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+}
+
+TEST(ArithmeticGmw, ReplayedTrafficOfOneParty) {
+  namespace communication = encrypto::motion::communication;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::uint32_t kInput0{1234}, kInput1{5678};
+  auto evaluate = [](encrypto::motion::Party& party, std::size_t party_id) {
+    party.GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    encrypto::motion::ShareWrapper input_0{
+        party.In<kArithmeticGmw>(party_id == 0 ? kInput0 : 0u, 0)};
+    encrypto::motion::ShareWrapper input_1{
+        party.In<kArithmeticGmw>(party_id == 1 ? kInput1 : 0u, 1)};
+    auto output{(input_0 + input_1).Out()};
+    party.Run();
+    const auto result{output.As<std::uint32_t>()};
+    party.Finish();
+    return result;
+  };
+
+  // record what party 1 receives from party 0
+  auto [transport_01, transport_10] = communication::DummyTransport::MakeTransportPair();
+  std::vector<std::unique_ptr<communication::Transport>> transports_0(2), transports_1(2);
+  transports_0.at(1) = std::move(transport_01);
+  transports_1.at(0) = std::move(transport_10);
+  const auto recordings{communication::MakeRecordingTransports(transports_1)};
+  auto party_0{std::make_unique<encrypto::motion::Party>(
+      std::make_unique<communication::CommunicationLayer>(0, std::move(transports_0)))};
+  auto party_1{std::make_unique<encrypto::motion::Party>(
+      std::make_unique<communication::CommunicationLayer>(1, std::move(transports_1)))};
+  auto future_0{std::async(std::launch::async, [&] { return evaluate(*party_0, 0); })};
+  EXPECT_EQ(evaluate(*party_1, 1), kInput0 + kInput1);
+  EXPECT_EQ(future_0.get(), kInput0 + kInput1);
+  const auto seeds{party_1->GetBackend()->GetBaseProvider().GetSeeds()};
+
+  // party 1 alone with the recorded traffic and seeds computes the same output
+  std::vector<std::unique_ptr<communication::Transport>> replay_transports(2);
+  replay_transports.at(0) = std::make_unique<communication::ReplayTransport>(*recordings.at(0));
+  auto replayed_party_1{std::make_unique<encrypto::motion::Party>(
+      std::make_unique<communication::CommunicationLayer>(1, std::move(replay_transports)))};
+  replayed_party_1->GetBackend()->GetBaseProvider().SetSeeds(seeds);
+  EXPECT_EQ(evaluate(*replayed_party_1, 1), kInput0 + kInput1);
+}
+
 }  // namespace
\ No newline at end of file
@@ -24,8 +24,15 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <sstream>
 
+#include "algorithm/arithmetic_circuit.h"
+#include "base/backend.h"
 #include "base/party.h"
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/transport.h"
+#include "protocols/astra/astra_gate.h"
 #include "protocols/share_wrapper.h"
 #include "test_constants.h"
 #include "test_helpers.h"
@@ -279,6 +286,41 @@ TYPED_TEST(AstraTest, Multiplication) {
   for (auto& f : futures) f.get();
 }
 
+TYPED_TEST(AstraTest, DeferredInputs) {
+  this->GenerateDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      auto& party{this->parties_[party_id]};
+      std::array<mo::ShareWrapper, 3> inputs;
+      std::array<mo::ReusableFiberPromise<std::vector<TypeParam>>*, 3> promises;
+      for (std::size_t input_owner = 0; input_owner < this->number_of_parties_; ++input_owner) {
+        auto [share, promise]{
+            party->template DeferredIn<kAstra, TypeParam>(input_owner, this->number_of_simd_)};
+        EXPECT_EQ(promise != nullptr, input_owner == party_id);
+        inputs[input_owner] = share;
+        promises[input_owner] = promise;
+      }
+      auto [boolean_share, boolean_promise]{party->template In<kAstra>(1, 2, 10)};
+      auto share_output_mul{(inputs[0] * inputs[1] * inputs[2]).Out()};
+      auto share_output_boolean{mo::ShareWrapper(boolean_share).Out()};
+
+      // the inputs arrive after the setup phase started
+      auto running{party->RunAsync()};
+      promises[party_id]->set_value(this->inputs_simd_[party_id]);
+      const std::vector<mo::BitVector<>> bits{mo::BitVector<>(10, true), mo::BitVector<>(10)};
+      if (party_id == 1) boolean_promise->set_value(bits);
+      running.get();
+
+      EXPECT_EQ(share_output_mul.template As<std::vector<TypeParam>>(),
+                mo::RowMulReduction<TypeParam>(this->inputs_simd_));
+      EXPECT_EQ(share_output_boolean.template As<std::vector<mo::BitVector<>>>(), bits);
+      party->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
 TYPED_TEST(AstraTest, DotPdoruct) {
   this->GenerateDotProductInputs();
   this->ShareDotProductInputs();
@@ -311,4 +353,255 @@ TYPED_TEST(AstraTest, DotPdoruct) {
     });
   }
   for (auto& f : futures) f.get();
-}
\ No newline at end of file
+}
+
+TYPED_TEST(AstraTest, MatrixMultiplication) {
+  // a matrix-vector product and shapes which span several blocks of the kernel
+  constexpr std::array<std::array<std::size_t, 3>, 3> kShapes{
+      {{8, 100, 1}, {3, 4, 5}, {5, 70, 40}}};
+  std::vector<std::array<std::vector<TypeParam>, 2>> inputs;
+  std::vector<std::vector<TypeParam>> expected_results;
+  for (const auto& [rows, inner, columns] : kShapes) {
+    inputs.push_back({::RandomVector<TypeParam>(rows * inner),
+                      ::RandomVector<TypeParam>(inner * columns)});
+    auto& expected_result{expected_results.emplace_back(rows * columns, 0)};
+    for (std::size_t r = 0; r < rows; ++r) {
+      for (std::size_t l = 0; l < inner; ++l) {
+        for (std::size_t m = 0; m < columns; ++m) {
+          expected_result[r * columns + m] +=
+              inputs.back()[0][r * inner + l] * inputs.back()[1][l * columns + m];
+        }
+      }
+    }
+  }
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id, &kShapes, &inputs, &expected_results]() {
+      auto& party{this->parties_[party_id]};
+      std::vector<mo::ShareWrapper> share_outputs;
+      for (std::size_t i = 0; i < kShapes.size(); ++i) {
+        const auto& [rows, inner, columns] = kShapes[i];
+        mo::ShareWrapper a = party->template In<kAstra>(
+            party_id == 0 ? inputs[i][0] : std::vector<TypeParam>(rows * inner, 0), 0);
+        mo::ShareWrapper b = party->template In<kAstra>(
+            party_id == 2 ? inputs[i][1] : std::vector<TypeParam>(inner * columns, 0), 2);
+        share_outputs.push_back(mo::MatrixMultiplication(a, b, rows, inner, columns).Out());
+      }
+
+      party->Run();
+
+      for (std::size_t i = 0; i < kShapes.size(); ++i) {
+        EXPECT_EQ(share_outputs[i].template As<std::vector<TypeParam>>(), expected_results[i]);
+      }
+      party->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, BatchedMultiplicationLayers) {
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      // multiplicative depths 1, 2 and 3, where the SIMD and non-SIMD gates share the batches
+      std::vector<mo::ShareWrapper> share_outputs;
+      for (const auto& inputs : {this->shared_inputs_single_[party_id],
+                                 this->shared_inputs_simd_[party_id]}) {
+        auto share_xy = inputs[0] * inputs[1];
+        auto share_yz = inputs[1] * inputs[2];
+        auto share_xyyz = share_xy * share_yz;
+        auto share_xyz_plus_z = (share_xy + inputs[1]) * inputs[2];
+        share_outputs.emplace_back((share_xyyz * inputs[0]).Out());
+        share_outputs.emplace_back(share_xyz_plus_z.Out());
+      }
+
+      this->parties_[party_id]->Run();
+
+      const auto expected = [](TypeParam x, TypeParam y, TypeParam z) {
+        return std::pair<TypeParam, TypeParam>(x * y * y * z * x, (x * y + y) * z);
+      };
+      const auto& x{this->inputs_single_};
+      const auto [expected_deep, expected_shallow] = expected(x[0], x[1], x[2]);
+      EXPECT_EQ(share_outputs[0].template As<TypeParam>(), expected_deep);
+      EXPECT_EQ(share_outputs[1].template As<TypeParam>(), expected_shallow);
+      const auto results_deep = share_outputs[2].template As<std::vector<TypeParam>>();
+      const auto results_shallow = share_outputs[3].template As<std::vector<TypeParam>>();
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        const auto& v{this->inputs_simd_};
+        const auto [simd_deep, simd_shallow] = expected(v[0][i], v[1][i], v[2][i]);
+        EXPECT_EQ(results_deep[i], simd_deep);
+        EXPECT_EQ(results_shallow[i], simd_shallow);
+      }
+
+      // one message per multiplication layer instead of one per gate
+      if (party_id == 2) {
+        auto& communication_layer{this->parties_[party_id]->GetBackend()->GetCommunicationLayer()};
+        const auto statistics{communication_layer.GetTransportStatistics()};
+        const auto count = [](const auto& party_statistics, mo::communication::MessageType type) {
+          return party_statistics.message_type_statistics.at(static_cast<std::size_t>(type))
+              .number_of_messages_received;
+        };
+        EXPECT_EQ(count(statistics.at(0), mo::communication::MessageType::kAstraSetupMultiplyGate),
+                  3u);
+        EXPECT_EQ(count(statistics.at(1), mo::communication::MessageType::kAstraOnlineMultiplyGate),
+                  3u);
+      }
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, ArithmeticCircuitLinearLayer) {
+  // a linear layer of 3 neurons on 4 inputs with the weights in wires 4, ..., 15, whose outputs
+  // are multiplied
+  std::istringstream stream(R"(4 20
+16 2
+DOT 4 0 1 2 3 4 5 6 7 16
+DOT 4 0 1 2 3 8 9 10 11 17
+DOT 4 0 1 2 3 12 13 14 15 18
+MUL 16 17 19
+)");
+  const auto circuit{mo::ArithmeticAlgorithmDescription::FromText(stream)};
+  std::mt19937_64 mt(this->seed_);
+  std::uniform_int_distribution<TypeParam> dist;
+  std::vector<TypeParam> inputs(circuit.number_of_input_wires);
+  for (auto& input : inputs) input = dist(mt);
+  std::array<TypeParam, 3> neurons{0, 0, 0};
+  for (std::size_t neuron = 0; neuron < 3; ++neuron) {
+    for (std::size_t j = 0; j < 4; ++j) neurons[neuron] += inputs[j] * inputs[4 + 4 * neuron + j];
+  }
+
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id, &circuit, &inputs, &neurons]() {
+      auto& party{this->parties_[party_id]};
+      std::vector<mo::ShareWrapper> shares;
+      for (auto input : inputs) {
+        shares.emplace_back(party->template In<kAstra>(party_id == 0 ? input : TypeParam(0), 0));
+      }
+      const auto& register_pointer{party->GetBackend()->GetRegister()};
+      const std::size_t number_of_gates{register_pointer->GetGates().size()};
+      const auto results{mo::algorithm::EvaluateArithmeticCircuit(circuit, shares)};
+      // the dot products of the layer are a single DotProductGate
+      const auto& gates{register_pointer->GetGates()};
+      EXPECT_EQ(std::count_if(gates.begin() + number_of_gates, gates.end(),
+                              [](const auto& gate) {
+                                return dynamic_cast<const mo::proto::astra::DotProductGate<
+                                           TypeParam>*>(gate.get()) != nullptr;
+                              }),
+                1);
+      auto share_neuron{results[0].Out()}, share_product{results[1].Out()};
+
+      party->Run();
+
+      EXPECT_EQ(share_neuron.template As<TypeParam>(), neurons[2]);
+      EXPECT_EQ(share_product.template As<TypeParam>(), TypeParam(neurons[0] * neurons[1]));
+      party->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, BooleanOperations) {
+  this->GenerateDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      std::array<mo::ShareWrapper, 3> inputs;
+      for (std::size_t input_owner = 0; input_owner < this->number_of_parties_; ++input_owner) {
+        const auto bits{mo::ToInput<TypeParam>(party_id == input_owner
+                                                   ? this->inputs_simd_[input_owner]
+                                                   : this->zeros_simd_)};
+        inputs[input_owner] = this->parties_[party_id]->template In<kAstra>(bits, input_owner);
+      }
+      // both AND gates are in the first multiplicative layer
+      auto share_output_mixed = ((inputs[0] ^ inputs[1]) & ~inputs[2]).Out();
+      auto share_output_and = (inputs[0] & inputs[1]).Out(0);
+
+      this->parties_[party_id]->Run();
+
+      const auto to_values = [this](const std::vector<mo::BitVector<>>& bits) {
+        std::vector<TypeParam> values(this->number_of_simd_, 0);
+        for (std::size_t j = 0; j < bits.size(); ++j) {
+          for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] |= static_cast<TypeParam>(bits[j].Get(i)) << j;
+          }
+        }
+        return values;
+      };
+      const auto& v{this->inputs_simd_};
+      const auto mixed{to_values(share_output_mixed.template As<std::vector<mo::BitVector<>>>())};
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        EXPECT_EQ(mixed[i], static_cast<TypeParam>((v[0][i] ^ v[1][i]) & ~v[2][i]));
+      }
+      if (party_id == 0) {
+        const auto conjunction{
+            to_values(share_output_and.template As<std::vector<mo::BitVector<>>>())};
+        for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+          EXPECT_EQ(conjunction[i], static_cast<TypeParam>(v[0][i] & v[1][i]));
+        }
+      }
+
+      // the AND gates of one layer share their setup message
+      if (party_id == 2) {
+        auto& communication_layer{this->parties_[party_id]->GetBackend()->GetCommunicationLayer()};
+        const auto statistics{communication_layer.GetTransportStatistics()};
+        EXPECT_EQ(statistics.at(0)
+                      .message_type_statistics
+                      .at(static_cast<std::size_t>(
+                          mo::communication::MessageType::kAstraSetupAndGate))
+                      .number_of_messages_received,
+                  1u);
+      }
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, BitDecompositionAndMsb) {
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      // the product exercises the masks of a multiplication gate
+      std::vector<mo::ShareWrapper> share_bits, share_msbs;
+      for (const auto& inputs : {this->shared_inputs_single_[party_id],
+                                 this->shared_inputs_simd_[party_id]}) {
+        auto share_x = inputs[0] - inputs[1] * inputs[2];
+        share_bits.emplace_back(share_x.BitDecomposition().Out());
+        share_msbs.emplace_back(share_x.Msb().Out());
+      }
+
+      this->parties_[party_id]->Run();
+
+      static constexpr std::size_t kBitLength{sizeof(TypeParam) * 8};
+      const auto check = [](const mo::ShareWrapper& bits, const mo::ShareWrapper& msb,
+                            const std::vector<TypeParam>& expected) {
+        const auto bit_vectors{bits.template As<std::vector<mo::BitVector<>>>()};
+        ASSERT_EQ(bit_vectors.size(), kBitLength);
+        const auto msbs{msb.template As<mo::BitVector<>>()};
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+          for (std::size_t j = 0; j < kBitLength; ++j) {
+            EXPECT_EQ(bit_vectors[j].Get(i), ((expected[i] >> j) & 1) == 1);
+          }
+          EXPECT_EQ(msbs.Get(i), ((expected[i] >> (kBitLength - 1)) & 1) == 1);
+        }
+      };
+      const auto& x{this->inputs_single_};
+      check(share_bits[0], share_msbs[0], {static_cast<TypeParam>(x[0] - x[1] * x[2])});
+      std::vector<TypeParam> expected_simd(this->number_of_simd_);
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        const auto& v{this->inputs_simd_};
+        expected_simd[i] = static_cast<TypeParam>(v[0][i] - v[1][i] * v[2][i]);
+      }
+      check(share_bits[1], share_msbs[1], expected_simd);
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
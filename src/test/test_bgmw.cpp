@@ -22,12 +22,29 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <array>
+#include <functional>
+#include <future>
+#include <thread>
+#include <tuple>
+
 #include <gtest/gtest.h>
+#include "algorithm/algorithm_description.h"
+#include "algorithm/circuit_template.h"
+#include "algorithm/low_depth_reduce.h"
+#include "base/backend.h"
 #include "base/party.h"
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "communication/transport.h"
+#include "multiplication_triple/mt_provider.h"
 #include "protocols/boolean_gmw/boolean_gmw_gate.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
 #include "protocols/share_wrapper.h"
 #include "secure_type/secure_signed_integer.h"
+#include "statistics/critical_path.h"
+#include "statistics/gate_profile.h"
+#include "statistics/run_time_statistics.h"
 #include "test_constants.h"
 #include "test_helpers.h"
 
@@ -93,6 +110,43 @@ TEST(BooleanGmw, InputOutput_1_1K_Simd_2_3_4_5_10_parties) {
   }
 }
 
+TEST(BooleanGmw, DeferredInput_3_bit_100_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfWires{3}, kNumberOfSimd{100};
+  std::vector<encrypto::motion::BitVector<>> input_a, input_b, expected;
+  for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+    input_a.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    input_b.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    expected.emplace_back(input_a.back() & input_b.back());
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd));
+  for (std::size_t number_of_parties : {2u, 3u}) {
+    auto motion_parties{MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(true);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      auto [share_a, promise]{party->In<kBooleanGmw>(0, kNumberOfWires, kNumberOfSimd)};
+      EXPECT_EQ(promise != nullptr, party_id == 0);
+      encrypto::motion::ShareWrapper share_b{
+          party->In<kBooleanGmw>(party_id == 1 ? input_b : dummy_input, 1)};
+      auto share_output{(encrypto::motion::ShareWrapper(share_a) & share_b).Out()};
+
+      // the AND gate's setup runs before party 0 provides its input
+      auto running{party->RunAsync()};
+      if (promise != nullptr) promise->set_value(input_a);
+      running.get();
+
+      EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected);
+      party->Finish();
+    }
+  }
+}
+
 TEST(BooleanGmw, Inv_1K_Simd_2_3_4_5_10_parties) {
   for (auto i = 0ull; i < kTestIterations; ++i) {
     constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
@@ -289,6 +343,39 @@ TEST(BooleanGmw, Mux_1K_Simd_2_3_parties) {
   }
 }
 
+TEST(BooleanGmw, AndSplitsWideGatesOverThreads) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties{3};
+  // not a multiple of 8, such that the last range ends within a byte
+  const auto input_a{encrypto::motion::BitVector<>::SecureRandom(10'001)};
+  const auto input_b{encrypto::motion::BitVector<>::SecureRandom(10'001)};
+  const encrypto::motion::BitVector<> dummy_input(input_a.GetSize(), false);
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetParallelGateThreshold(1'000);
+    party->GetConfiguration()->SetNumOfThreads(4);
+  }
+
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      auto& party{*motion_parties.at(party_id)};
+      encrypto::motion::ShareWrapper share_a{
+          party.In<kBooleanGmw>(party_id == 0 ? input_a : dummy_input, 0)};
+      encrypto::motion::ShareWrapper share_b{
+          party.In<kBooleanGmw>(party_id == 1 ? input_b : dummy_input, 1)};
+      auto share_output{(share_a & share_b).Out()};
+      party.Run();
+      const auto output{share_output.As<encrypto::motion::BitVector<>>()};
+      EXPECT_TRUE(output == (input_a & input_b));
+      party.Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
 TEST(BooleanGmw, Mux_1K_Simd_64_wireshare_2_3_parties) {
   constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
   std::srand(std::time(nullptr));
@@ -707,6 +794,1299 @@ TEST(BooleanGmw, And_64_bit_10_Simd_2_3_parties) {
   }
 }
 
+TEST(BooleanGmw, MultiInputAnd_8_bit_10_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfWires{8}, kNumberOfSimd{10};
+  // 2 to 4 inputs use a single gate, 5 and 9 inputs a tree of them
+  for (std::size_t number_of_inputs : {2u, 3u, 4u, 5u, 9u}) {
+    for (auto number_of_parties : {2u, 3u}) {
+      std::vector<std::vector<encrypto::motion::BitVector<>>> inputs(number_of_inputs);
+      std::vector<encrypto::motion::BitVector<>> expected_result(
+          kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd, true));
+      for (auto& input : inputs) {
+        for (std::size_t j = 0; j < kNumberOfWires; ++j) {
+          input.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+          expected_result.at(j) &= input.back();
+        }
+      }
+      const std::vector<encrypto::motion::BitVector<>> dummy_input(
+          kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetOnlineAfterSetup(number_of_inputs % 2 == 1);
+      }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        std::vector<encrypto::motion::ShareWrapper> share_inputs;
+        for (std::size_t i = 0; i < number_of_inputs; ++i) {
+          const std::size_t input_owner{i % number_of_parties};
+          share_inputs.emplace_back(motion_parties.at(party_id)->In<kBooleanGmw>(
+              party_id == input_owner ? inputs.at(i) : dummy_input, input_owner));
+        }
+        auto share_output = encrypto::motion::And(share_inputs).Out();
+
+        motion_parties.at(party_id)->Run();
+
+        EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_result);
+        motion_parties.at(party_id)->Finish();
+      }
+    }
+  }
+}
+
+TEST(BooleanGmw, CircuitGate_Bristol_10_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd{10};
+  const std::string circuits{std::string(encrypto::motion::kRootDir) + "/circuits/"};
+  for (const auto& path : {"int/int_add8_depth.bristol", "advanced/aes_128.bristol"}) {
+    const auto algorithm{AlgorithmDescription::FromBristol(circuits + path)};
+    const std::size_t number_of_inputs{algorithm.number_of_input_wires_parent_a +
+                                       algorithm.number_of_input_wires_parent_b.value_or(0)};
+    std::vector<encrypto::motion::BitVector<>> inputs;
+    for (std::size_t i = 0; i < number_of_inputs; ++i) {
+      inputs.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    }
+    // evaluate the circuit in the clear on all SIMD values at once
+    std::vector<encrypto::motion::BitVector<>> wires(algorithm.number_of_wires);
+    std::copy(inputs.begin(), inputs.end(), wires.begin());
+    for (const auto& gate : algorithm.gates) {
+      const auto& a{wires.at(gate.parent_a)};
+      switch (gate.type) {
+        case PrimitiveOperationType::kXor:
+          wires.at(gate.output_wire) = a ^ wires.at(*gate.parent_b);
+          break;
+        case PrimitiveOperationType::kAnd:
+          wires.at(gate.output_wire) = a & wires.at(*gate.parent_b);
+          break;
+        case PrimitiveOperationType::kOr:
+          wires.at(gate.output_wire) = a | wires.at(*gate.parent_b);
+          break;
+        case PrimitiveOperationType::kInv:
+          wires.at(gate.output_wire) = ~a;
+          break;
+        default:
+          FAIL() << "unsupported gate in " << path;
+      }
+    }
+    const std::vector<encrypto::motion::BitVector<>> expected_result(
+        wires.end() - algorithm.number_of_output_wires, wires.end());
+    const std::vector<encrypto::motion::BitVector<>> dummy_input(
+        number_of_inputs, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+    for (auto number_of_parties : {2u, 3u}) {
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetOnlineAfterSetup(number_of_parties == 3);
+      }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        auto& party{motion_parties.at(party_id)};
+        encrypto::motion::ShareWrapper share_input{
+            party->In<kBooleanGmw>(party_id == 0 ? inputs : dummy_input, 0)};
+        const auto& register_pointer{party->GetBackend()->GetRegister()};
+        const std::size_t number_of_gates{register_pointer->GetTotalNumberOfGates()};
+        auto share_output{share_input.Evaluate(algorithm)};
+        // the whole circuit is a single gate
+        EXPECT_EQ(register_pointer->GetTotalNumberOfGates(), number_of_gates + 1);
+        auto share_result{share_output.Out()};
+
+        party->Run();
+
+        EXPECT_EQ(share_result.As<std::vector<encrypto::motion::BitVector<>>>(), expected_result);
+        party->Finish();
+      }
+    }
+  }
+}
+
+TEST(BooleanGmw, SimdChunking_Bristol_10_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd{10}, kChunkSize{4};
+  const auto algorithm{AlgorithmDescription::FromBristol(std::string(encrypto::motion::kRootDir) +
+                                                         "/circuits/int/int_add8_depth.bristol")};
+  const encrypto::motion::CircuitTemplate circuit_template(algorithm, true);
+  std::vector<encrypto::motion::BitVector<>> inputs;
+  for (std::size_t i = 0; i < 16; ++i) {
+    inputs.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      16, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+  // the 8-bit sums of the two inputs of each SIMD value
+  std::vector<encrypto::motion::BitVector<>> expected_result(
+      8, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+  for (std::size_t j = 0; j < kNumberOfSimd; ++j) {
+    std::uint8_t a{0}, b{0};
+    for (std::size_t i = 0; i < 8; ++i) {
+      a |= static_cast<std::uint8_t>(inputs.at(i).Get(j)) << i;
+      b |= static_cast<std::uint8_t>(inputs.at(8 + i).Get(j)) << i;
+    }
+    const std::uint8_t sum = a + b;
+    for (std::size_t i = 0; i < 8; ++i) expected_result.at(i).Set(((sum >> i) & 1) == 1, j);
+  }
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetSimdChunkSize(kChunkSize);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      encrypto::motion::ShareWrapper share_input{
+          party->In<kBooleanGmw>(party_id == 0 ? inputs : dummy_input, 0)};
+      const auto& register_pointer{party->GetBackend()->GetRegister()};
+      const std::size_t number_of_gates{register_pointer->GetTotalNumberOfGates()};
+      auto share_output{share_input.Evaluate(algorithm)};
+      // a SubsetGate and a CircuitGate for each of the 3 chunks and a SimdifyGate
+      EXPECT_EQ(register_pointer->GetTotalNumberOfGates(), number_of_gates + 7);
+      auto share_template_output{share_input.Evaluate(circuit_template)};
+      EXPECT_EQ(share_output->GetNumberOfSimdValues(), kNumberOfSimd);
+      auto share_result{share_output.Out()};
+      auto share_template_result{share_template_output.Out()};
+
+      party->Run();
+
+      EXPECT_EQ(share_result.As<std::vector<encrypto::motion::BitVector<>>>(), expected_result);
+      EXPECT_EQ(share_template_result.As<std::vector<encrypto::motion::BitVector<>>>(),
+                expected_result);
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, CircuitTemplate_Instances_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  const auto algorithm{AlgorithmDescription::FromBristol(std::string(encrypto::motion::kRootDir) +
+                                                         "/circuits/int/int_add8_depth.bristol")};
+  const encrypto::motion::CircuitTemplate circuit_template(algorithm, true);
+  const std::size_t number_of_inputs{circuit_template.GetNumberOfInputWires()};
+  // the 8-bit sum of the two inputs of SIMD value j, the inputs are given as 16 wires
+  const auto add{[](const std::vector<encrypto::motion::BitVector<>>& inputs, std::size_t j) {
+    std::uint8_t a{0}, b{0};
+    for (std::size_t i = 0; i < 8; ++i) {
+      a |= static_cast<std::uint8_t>(inputs.at(i).Get(j)) << i;
+      b |= static_cast<std::uint8_t>(inputs.at(8 + i).Get(j)) << i;
+    }
+    return static_cast<std::uint8_t>(a + b);
+  }};
+  const std::array<std::size_t, 3> kNumbersOfSimd{1, 3, 6};
+  std::vector<std::vector<encrypto::motion::BitVector<>>> inputs, dummy_inputs;
+  for (auto number_of_simd : kNumbersOfSimd) {
+    auto& input{inputs.emplace_back()};
+    for (std::size_t i = 0; i < number_of_inputs; ++i) {
+      input.emplace_back(encrypto::motion::BitVector<>::SecureRandom(number_of_simd));
+    }
+    dummy_inputs.emplace_back(number_of_inputs,
+                              encrypto::motion::BitVector<>(number_of_simd, false));
+  }
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      std::vector<encrypto::motion::ShareWrapper> share_inputs;
+      for (std::size_t k = 0; k < kNumbersOfSimd.size(); ++k) {
+        share_inputs.emplace_back(
+            party->In<kBooleanGmw>(party_id == 0 ? inputs[k] : dummy_inputs[k], 0));
+      }
+      const auto& register_pointer{party->GetBackend()->GetRegister()};
+      const std::size_t number_of_gates{register_pointer->GetTotalNumberOfGates()};
+      const auto share_outputs{
+          encrypto::motion::ShareWrapper::Evaluate(circuit_template, share_inputs)};
+      // a SimdifyGate, a single CircuitGate and one SubsetGate per instance
+      EXPECT_EQ(register_pointer->GetTotalNumberOfGates(),
+                number_of_gates + 2 + kNumbersOfSimd.size());
+      const auto single_output{share_inputs[1].Evaluate(circuit_template)};
+      std::vector<encrypto::motion::ShareWrapper> share_results;
+      for (const auto& share_output : share_outputs) share_results.emplace_back(share_output.Out());
+      const auto single_result{single_output.Out()};
+
+      party->Run();
+
+      for (std::size_t k = 0; k < kNumbersOfSimd.size(); ++k) {
+        const auto result{share_results[k].As<std::vector<encrypto::motion::BitVector<>>>()};
+        EXPECT_EQ(result.size(), 8);
+        for (std::size_t j = 0; j < kNumbersOfSimd[k]; ++j) {
+          const auto sum{add(inputs[k], j)};
+          for (std::size_t i = 0; i < 8; ++i) EXPECT_EQ(result[i].Get(j), ((sum >> i) & 1) == 1);
+        }
+      }
+      EXPECT_EQ(single_result.As<std::vector<encrypto::motion::BitVector<>>>(),
+                share_results[1].As<std::vector<encrypto::motion::BitVector<>>>());
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, EvaluateBatch_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  const auto algorithm{AlgorithmDescription::FromBristol(std::string(encrypto::motion::kRootDir) +
+                                                         "/circuits/int/int_add8_depth.bristol")};
+  constexpr std::size_t kNumberOfInstances{4};
+  const std::size_t number_of_inputs{algorithm.number_of_input_wires_parent_a +
+                                     algorithm.number_of_input_wires_parent_b.value_or(0)};
+  std::vector<std::vector<encrypto::motion::BitVector<>>> inputs(kNumberOfInstances);
+  for (auto& input : inputs) {
+    for (std::size_t i = 0; i < number_of_inputs; ++i) {
+      input.emplace_back(encrypto::motion::BitVector<>::SecureRandom(1));
+    }
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      number_of_inputs, encrypto::motion::BitVector<>(1, false));
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      std::vector<encrypto::motion::ShareWrapper> share_inputs;
+      for (const auto& input : inputs) {
+        share_inputs.emplace_back(party->In<kBooleanGmw>(party_id == 0 ? input : dummy_input, 0));
+      }
+      const auto& register_pointer{party->GetBackend()->GetRegister()};
+      const std::size_t number_of_gates{register_pointer->GetTotalNumberOfGates()};
+      auto batch{encrypto::motion::ShareWrapper::EvaluateBatch(algorithm, share_inputs)};
+      // a SimdifyGate and a single CircuitGate, the instances are not split yet
+      EXPECT_EQ(register_pointer->GetTotalNumberOfGates(), number_of_gates + 2);
+      EXPECT_EQ(batch.GetNumberOfInstances(), kNumberOfInstances);
+      EXPECT_EQ(batch.GetShare()->GetNumberOfSimdValues(), kNumberOfInstances);
+      // a single UnsimdifyGate splits all instances
+      const auto share_outputs{batch.Unsimdify()};
+      EXPECT_EQ(register_pointer->GetTotalNumberOfGates(), number_of_gates + 3);
+      EXPECT_TRUE(batch.GetInstance(1).Get() == share_outputs[1].Get());
+      std::vector<encrypto::motion::ShareWrapper> share_results;
+      for (const auto& share_output : share_outputs) share_results.emplace_back(share_output.Out());
+
+      party->Run();
+
+      for (std::size_t k = 0; k < kNumberOfInstances; ++k) {
+        std::uint8_t a{0}, b{0};
+        for (std::size_t i = 0; i < 8; ++i) {
+          a |= static_cast<std::uint8_t>(inputs[k].at(i).Get(0)) << i;
+          b |= static_cast<std::uint8_t>(inputs[k].at(8 + i).Get(0)) << i;
+        }
+        const auto sum{static_cast<std::uint8_t>(a + b)};
+        const auto result{share_results[k].As<std::vector<encrypto::motion::BitVector<>>>()};
+        EXPECT_EQ(result.size(), 8);
+        for (std::size_t i = 0; i < 8; ++i) EXPECT_EQ(result.at(i).Get(0), ((sum >> i) & 1) == 1);
+      }
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, SimdReduceAndScan_8_bit_13_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd{13};
+  std::vector<encrypto::motion::BitVector<>> input(8);
+  for (auto& wire : input) wire = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      8, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      encrypto::motion::ShareWrapper share_input{
+          party->In<kBooleanGmw>(party_id == 0 ? input : dummy_input, 0)};
+      auto share_or{SimdLowDepthReduce(share_input, std::bit_or<>()).Out()};
+      auto share_ands{Scan(share_input, std::bit_and<>()).Out()};
+
+      party->Run();
+
+      const auto result_or{share_or.As<std::vector<encrypto::motion::BitVector<>>>()};
+      const auto result_ands{share_ands.As<std::vector<encrypto::motion::BitVector<>>>()};
+      EXPECT_EQ(result_or.size(), 8);
+      EXPECT_EQ(result_ands.size(), 8);
+      for (std::size_t i = 0; i < std::min<std::size_t>({result_or.size(), result_ands.size(), 8});
+           ++i) {
+        bool expected_or{false}, expected_and{true};
+        for (std::size_t j = 0; j < kNumberOfSimd; ++j) {
+          expected_or |= input[i].Get(j);
+          expected_and &= input[i].Get(j);
+          EXPECT_EQ(result_ands[i].Get(j), expected_and);
+        }
+        EXPECT_EQ(result_or[i].GetSize(), 1);
+        EXPECT_EQ(result_or[i].Get(0), expected_or);
+      }
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, ParallelSubcircuitConstruction_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSubcircuits{4}, kNumberOfRounds{16};
+  std::vector<encrypto::motion::BitVector<>> x(8), y(8);
+  for (std::size_t i = 0; i < 8; ++i) {
+    x[i] = encrypto::motion::BitVector<>::SecureRandom(10);
+    y[i] = encrypto::motion::BitVector<>::SecureRandom(10);
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      8, encrypto::motion::BitVector<>(10, false));
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      const auto& register_pointer{party->GetBackend()->GetRegister()};
+      encrypto::motion::ShareWrapper share_x{
+          party->In<kBooleanGmw>(party_id == 0 ? x : dummy_input, 0)};
+      encrypto::motion::ShareWrapper share_y{
+          party->In<kBooleanGmw>(party_id == 0 ? y : dummy_input, 0)};
+
+      // subcircuit k computes z = (z & y) ^ x starting at z = x for k + 1 rounds
+      std::vector<std::unique_ptr<encrypto::motion::Subcircuit>> subcircuits;
+      for (std::size_t k = 0; k < kNumberOfSubcircuits; ++k) {
+        subcircuits.emplace_back(register_pointer->ReserveSubcircuit(
+            2 * kNumberOfRounds, 2 * 8 * kNumberOfRounds));
+      }
+      const std::size_t number_of_gates{register_pointer->GetTotalNumberOfGates()};
+      std::vector<encrypto::motion::ShareWrapper> results(kNumberOfSubcircuits);
+      std::vector<std::thread> threads;
+      for (std::size_t k = 0; k < kNumberOfSubcircuits; ++k) {
+        threads.emplace_back([&, k] {
+          encrypto::motion::Subcircuit::Scope scope(*subcircuits[k]);
+          auto z{share_x};
+          for (std::size_t round = 0; round <= k; ++round) z = (z & share_y) ^ share_x;
+          results[k] = z;
+        });
+      }
+      for (auto& thread : threads) thread.join();
+      EXPECT_EQ(register_pointer->GetNumberOfPendingSubcircuits(), kNumberOfSubcircuits);
+      EXPECT_EQ(subcircuits[2]->GetNumberOfGates(), 2 * 3);
+
+      // exceeding the reserved ids fails without affecting other subcircuits
+      auto empty_subcircuit{register_pointer->ReserveSubcircuit(0, 0)};
+      {
+        encrypto::motion::Subcircuit::Scope scope(*empty_subcircuit);
+        EXPECT_THROW(share_x ^ share_y, std::length_error);
+      }
+      // subcircuits are merged in the order of their reservation
+      EXPECT_THROW(register_pointer->MergeSubcircuit(std::move(empty_subcircuit)),
+                   std::logic_error);
+      EXPECT_TRUE(empty_subcircuit != nullptr);
+      for (auto& subcircuit : subcircuits) register_pointer->MergeSubcircuit(std::move(subcircuit));
+      EXPECT_EQ(register_pointer->GetNumberOfPendingSubcircuits(), 1);
+      register_pointer->MergeSubcircuit(std::move(empty_subcircuit));
+      EXPECT_EQ(register_pointer->GetNumberOfPendingSubcircuits(), 0);
+
+      // the gates are ordered by their reserved ids and can be found by them
+      const auto& gates{register_pointer->GetGates()};
+      for (std::size_t i = 1; i < gates.size(); ++i) {
+        EXPECT_LT(gates[i - 1]->GetId(), gates[i]->GetId());
+      }
+      const std::size_t first_gate_of_subcircuit_1{number_of_gates - 3 * 2 * kNumberOfRounds};
+      EXPECT_EQ(register_pointer->GetGate(first_gate_of_subcircuit_1)->GetId(),
+                static_cast<std::int64_t>(first_gate_of_subcircuit_1));
+
+      std::vector<encrypto::motion::ShareWrapper> share_outputs;
+      for (auto& result : results) share_outputs.emplace_back(result.Out());
+
+      party->Run();
+
+      for (std::size_t k = 0; k < kNumberOfSubcircuits; ++k) {
+        const auto output{share_outputs[k].As<std::vector<encrypto::motion::BitVector<>>>()};
+        EXPECT_EQ(output.size(), 8);
+        for (std::size_t i = 0; i < std::min<std::size_t>(output.size(), 8); ++i) {
+          auto expected{x[i]};
+          for (std::size_t round = 0; round <= k; ++round) expected = (expected & y[i]) ^ x[i];
+          EXPECT_TRUE(output[i] == expected);
+        }
+      }
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, DeadGateElimination_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfWires{8}, kNumberOfSimd{10};
+  std::vector<encrypto::motion::BitVector<>> x(kNumberOfWires), y(kNumberOfWires);
+  for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+    x[i] = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+    y[i] = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      const auto& register_pointer{party->GetBackend()->GetRegister()};
+      register_pointer->SetDeadGateElimination(true);
+      encrypto::motion::ShareWrapper share_x{
+          party->In<kBooleanGmw>(party_id == 0 ? x : dummy_input, 0)};
+      encrypto::motion::ShareWrapper share_y{
+          party->In<kBooleanGmw>(party_id == 0 ? y : dummy_input, 0)};
+
+      // the XOR and both ANDs of the unused value are removed together with their MTs
+      auto unused{((share_x ^ share_y) & share_x) & share_y};
+      auto share_output{(share_x & share_y).Out()};
+      EXPECT_EQ(register_pointer->GetGates().size(), 7);
+
+      party->Run();
+
+      EXPECT_EQ(register_pointer->GetNumberOfEliminatedGates(), 3);
+      EXPECT_EQ(register_pointer->GetGates().size(), 4);
+      EXPECT_EQ(party->GetBackend()->GetMtProvider().GetNumberOfMts<bool>(),
+                kNumberOfWires * kNumberOfSimd);
+      const auto output{share_output.As<std::vector<encrypto::motion::BitVector<>>>()};
+      EXPECT_EQ(output.size(), kNumberOfWires);
+      for (std::size_t i = 0; i < std::min(output.size(), kNumberOfWires); ++i) {
+        EXPECT_TRUE(output[i] == (x[i] & y[i]));
+      }
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, LookupTable_4_and_8_bit_20_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd{20};
+  // the 4-bit S-box of PRESENT and a random table of 8 to 3 bits
+  constexpr std::array<std::uint8_t, 16> kSbox{0xC, 0x5, 0x6, 0xB, 0x9, 0x0, 0xA, 0xD,
+                                               0x3, 0xE, 0xF, 0x8, 0x4, 0x7, 0x1, 0x2};
+  std::vector<encrypto::motion::BitVector<>> sbox_table, random_table;
+  for (auto entry : kSbox) {
+    encrypto::motion::BitVector<> bits;
+    for (std::size_t bit_i = 0; bit_i < 4; ++bit_i) bits.Append(((entry >> bit_i) & 1) == 1);
+    sbox_table.emplace_back(std::move(bits));
+  }
+  for (std::size_t i = 0; i < 256; ++i) {
+    random_table.emplace_back(encrypto::motion::BitVector<>::SecureRandom(3));
+  }
+  std::vector<encrypto::motion::BitVector<>> x(8);
+  for (auto& wire : x) wire = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      8, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+  auto index = [&x](std::size_t number_of_bits, std::size_t simd_i) {
+    std::size_t result{0};
+    for (std::size_t bit_i = 0; bit_i < number_of_bits; ++bit_i) {
+      if (x[bit_i].Get(simd_i)) result |= std::size_t(1) << bit_i;
+    }
+    return result;
+  };
+
+  std::vector<PartyPointer> motion_parties(std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    auto& party{motion_parties.at(party_id)};
+    encrypto::motion::ShareWrapper share_x{party->In<kBooleanGmw>(party_id == 0 ? x : dummy_input,
+                                                                  0)};
+    auto bits{share_x.Split()};
+    auto share_x_4{encrypto::motion::ShareWrapper::Concatenate(
+        std::vector<encrypto::motion::ShareWrapper>(bits.begin(), bits.begin() + 4))};
+    auto sbox_output{share_x_4.Lut(sbox_table).Out()};
+    auto random_output{share_x.Lut(random_table).Out()};
+
+    party->Run();
+
+    const auto sbox_values{sbox_output.As<std::vector<encrypto::motion::BitVector<>>>()};
+    const auto random_values{random_output.As<std::vector<encrypto::motion::BitVector<>>>()};
+    EXPECT_EQ(sbox_values.size(), 4);
+    EXPECT_EQ(random_values.size(), 3);
+    for (std::size_t simd_i = 0; simd_i < kNumberOfSimd; ++simd_i) {
+      for (std::size_t bit_i = 0; bit_i < std::min<std::size_t>(sbox_values.size(), 4); ++bit_i) {
+        EXPECT_EQ(sbox_values[bit_i].Get(simd_i), sbox_table[index(4, simd_i)].Get(bit_i));
+      }
+      for (std::size_t bit_i = 0; bit_i < std::min<std::size_t>(random_values.size(), 3);
+           ++bit_i) {
+        EXPECT_EQ(random_values[bit_i].Get(simd_i), random_table[index(8, simd_i)].Get(bit_i));
+      }
+    }
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, SchedulingModes_And_Xor_64_bit_10_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  std::srand(std::time(nullptr));
+  // {dependency-driven scheduling, layer-wise evaluation, critical path priority,
+  //  inline local gates, online after setup, coroutine online phases}
+  const std::array<std::tuple<bool, bool, bool, bool, bool, bool>, 17> kSchedulingModes{
+      {{true, false, false, false, false, false},
+       {true, false, false, false, true, false},
+       {false, true, false, false, false, false},
+       {false, true, false, false, true, false},
+       {true, true, false, false, false, false},
+       {true, true, false, false, true, false},
+       {false, false, true, false, false, false},
+       {false, false, true, false, true, false},
+       {true, false, true, false, false, false},
+       {true, false, true, false, true, false},
+       {true, false, false, true, false, false},
+       {true, false, false, true, true, false},
+       {true, false, true, true, false, false},
+       {true, false, true, true, true, false},
+       {true, false, false, false, false, true},
+       {true, false, false, true, true, true},
+       {true, false, true, true, false, true}}};
+  for (auto [dependency_driven, layer_wise, critical_path_priority, inline_local_gates,
+             online_after_setup, coroutine_online_phases] : kSchedulingModes) {
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::size_t output_owner = std::rand() % number_of_parties;
+      std::vector<std::vector<encrypto::motion::BitVector<>>> global_input_10_64_bit(
+          number_of_parties);
+      for (auto& bv_v : global_input_10_64_bit) {
+        bv_v.resize(64);
+        for (auto& bv : bv_v) {
+          bv = encrypto::motion::BitVector<>::SecureRandom(10);
+        }
+      }
+      std::vector<encrypto::motion::BitVector<>> dummy_input_10_64_bit(
+          64, encrypto::motion::BitVector<>(10, false));
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetOnlineAfterSetup(online_after_setup);
+        party->GetConfiguration()->SetDependencyDrivenScheduling(dependency_driven);
+        party->GetConfiguration()->SetLayerWiseEvaluation(layer_wise);
+        party->GetConfiguration()->SetCriticalPathPriority(critical_path_priority);
+        party->GetConfiguration()->SetInlineLocalGates(inline_local_gates);
+        party->GetConfiguration()->SetCoroutineOnlinePhases(coroutine_online_phases);
+      }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        std::vector<encrypto::motion::ShareWrapper> share_input;
+
+        for (auto j = 0ull; j < number_of_parties; ++j) {
+          if (j == motion_parties.at(party_id)->GetConfiguration()->GetMyId()) {
+            share_input.push_back(
+                motion_parties.at(party_id)->In<kBooleanGmw>(global_input_10_64_bit.at(j), j));
+          } else {
+            share_input.push_back(
+                motion_parties.at(party_id)->In<kBooleanGmw>(dummy_input_10_64_bit, j));
+          }
+        }
+
+        // (in_0 & in_1 & ... & in_n-1) ^ in_0
+        auto share_and = share_input.at(0) & share_input.at(1);
+        for (auto j = 2ull; j < number_of_parties; ++j) {
+          share_and = share_and & share_input.at(j);
+        }
+        auto share_output = (share_and ^ share_input.at(0)).Out(output_owner);
+
+        motion_parties.at(party_id)->Run();
+
+        if (party_id == output_owner) {
+          for (auto j = 0ull; j < global_input_10_64_bit.size(); ++j) {
+            auto wire_single =
+                std::dynamic_pointer_cast<encrypto::motion::proto::boolean_gmw::Wire>(
+                    share_output->GetWires().at(j));
+            assert(wire_single);
+
+            std::vector<encrypto::motion::BitVector<>> global_input_single;
+            for (auto k = 0ull; k < number_of_parties; ++k) {
+              global_input_single.push_back(global_input_10_64_bit.at(k).at(j));
+            }
+
+            EXPECT_EQ(wire_single->GetValues(),
+                      encrypto::motion::BitVector<>::AndBitVectors(global_input_single) ^
+                          global_input_single.at(0));
+          }
+        }
+
+        motion_parties.at(party_id)->Finish();
+      }
+    }
+  }
+}
+
+TEST(BooleanGmw, LayerWiseEvaluation_And_64_bit_10_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfLayers = 3;
+  constexpr std::size_t kNumberOfGatesPerLayer = 4;
+  namespace mo_comm = encrypto::motion::communication;
+  for (auto number_of_parties : {2u, 3u}) {
+    const std::vector<encrypto::motion::BitVector<>> input_a(
+        64, encrypto::motion::BitVector<>::SecureRandom(10));
+    const std::vector<encrypto::motion::BitVector<>> input_b(
+        64, encrypto::motion::BitVector<>::SecureRandom(10));
+    std::vector<encrypto::motion::BitVector<>> expected;
+    for (std::size_t i = 0; i < input_a.size(); ++i) {
+      expected.emplace_back(input_a.at(i) & input_b.at(i));
+    }
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetLayerWiseEvaluation(true);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      encrypto::motion::ShareWrapper share_a{party->In<kBooleanGmw>(input_a, 0)};
+      encrypto::motion::ShareWrapper share_b{party->In<kBooleanGmw>(input_b, 1)};
+      // independent AND gates in each layer, all of which compute a & b
+      std::vector<encrypto::motion::ShareWrapper> shares(kNumberOfGatesPerLayer, share_a);
+      for (std::size_t layer = 0; layer < kNumberOfLayers; ++layer) {
+        for (auto& share : shares) {
+          share = share & share_b;
+        }
+      }
+      std::vector<encrypto::motion::ShareWrapper> share_outputs;
+      for (auto& share : shares) {
+        share_outputs.emplace_back(share.Out());
+      }
+      party->Run();
+      for (auto& share_output : share_outputs) {
+        EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected);
+      }
+      party->Finish();
+
+      // one message per layer and party instead of one per gate
+      const auto sent = [](const mo_comm::TransportStatistics& statistics,
+                           mo_comm::MessageType type) -> std::size_t {
+        const auto it{statistics.message_type_statistics.find(static_cast<std::size_t>(type))};
+        return it == statistics.message_type_statistics.end() ? 0
+                                                              : it->second.number_of_messages_sent;
+      };
+      for (const auto& statistics :
+           party->GetBackend()->GetCommunicationLayer().GetTransportStatistics()) {
+        EXPECT_EQ(sent(statistics, mo_comm::MessageType::kMessageBatch), kNumberOfLayers);
+        EXPECT_EQ(sent(statistics, mo_comm::MessageType::kBeaverOpening), 0u);
+      }
+    }
+  }
+}
+
+TEST(BooleanGmw, GateProfile_And_64_bit_10_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties = 2;
+  const std::vector<encrypto::motion::BitVector<>> input(
+      64, encrypto::motion::BitVector<>::SecureRandom(10));
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetProfileGates(true);
+  }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    auto& party{motion_parties.at(party_id)};
+    encrypto::motion::ShareWrapper share_a{party->In<kBooleanGmw>(input, 0)};
+    encrypto::motion::ShareWrapper share_b{party->In<kBooleanGmw>(input, 1)};
+    auto share_output = (share_a & share_b).Out();
+    party->Run();
+    EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), input);
+
+    const auto& gate_profile{party->GetBackend()->GetRunTimeStatistics().back().gate_profile};
+    EXPECT_TRUE(gate_profile != nullptr);
+    if (gate_profile) {
+      for (const auto& event : gate_profile->events) {
+        EXPECT_GE(event.gate_id, 0);
+        EXPECT_GE(event.GetComputeTime().count(), 0);
+      }
+
+      const auto json{gate_profile->ToJson()};
+      const auto& and_gate{json.at("online").as_object().at("boolean_gmw::AndGate").as_object()};
+      EXPECT_EQ(and_gate.at("count").as_uint64(), 1);
+      EXPECT_EQ(and_gate.at("depths").as_object().at("1").as_object().at("count").as_uint64(), 1);
+      EXPECT_EQ(json.at("online")
+                    .as_object()
+                    .at("boolean_gmw::OutputGate")
+                    .as_object()
+                    .at("depths")
+                    .as_object()
+                    .count("2"),
+                1);
+
+      const auto trace{boost::json::parse(gate_profile->ToChromeTrace())};
+      EXPECT_EQ(trace.as_object().at("traceEvents").as_array().size(), gate_profile->events.size());
+      EXPECT_NE(gate_profile->ToFoldedStacks().find("online;boolean_gmw::AndGate;depth 1;"),
+                std::string::npos);
+
+      // the output gate finishes last and is reached via the AND gate
+      const auto critical_path{ComputeCriticalPath(*gate_profile)};
+      EXPECT_GE(critical_path.steps.size(), 2);
+      EXPECT_EQ(gate_profile->events.at(critical_path.steps.at(0).event_index).gate_type.find(
+                    "boolean_gmw::InputGate"),
+                0);
+      EXPECT_EQ(gate_profile->events.at(critical_path.steps.back().event_index).gate_type,
+                "boolean_gmw::OutputGate");
+      EXPECT_EQ(critical_path.compute + critical_path.network + critical_path.preprocessing +
+                    critical_path.scheduling,
+                critical_path.latency);
+    }
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, RunAsync_StreamBatchOutputs_64_bit_10_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfBatches = 3;
+  std::srand(std::time(nullptr));
+  for (auto number_of_parties : {2u, 3u}) {
+    const std::size_t output_owner = std::rand() % number_of_parties;
+    // global_input[batch][party][bit]
+    std::vector<std::vector<std::vector<encrypto::motion::BitVector<>>>> global_input(
+        kNumberOfBatches,
+        std::vector<std::vector<encrypto::motion::BitVector<>>>(number_of_parties));
+    for (auto& batch : global_input) {
+      for (auto& bv_v : batch) {
+        bv_v.resize(64);
+        for (auto& bv : bv_v) {
+          bv = encrypto::motion::BitVector<>::SecureRandom(10);
+        }
+      }
+    }
+    std::vector<encrypto::motion::BitVector<>> dummy_input(
+        64, encrypto::motion::BitVector<>(10, false));
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetDependencyDrivenScheduling(true);
+      // only the values of the output gates are read after the evaluation
+      party->GetConfiguration()->SetReleaseWireValues(true);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      std::vector<encrypto::motion::ShareWrapper> share_output;
+      for (std::size_t batch = 0; batch < kNumberOfBatches; ++batch) {
+        std::vector<encrypto::motion::ShareWrapper> share_input;
+        for (auto j = 0ull; j < number_of_parties; ++j) {
+          if (j == party_id) {
+            share_input.push_back(
+                motion_parties.at(party_id)->In<kBooleanGmw>(global_input.at(batch).at(j), j));
+          } else {
+            share_input.push_back(motion_parties.at(party_id)->In<kBooleanGmw>(dummy_input, j));
+          }
+        }
+        auto share_and = share_input.at(0) & share_input.at(1);
+        for (auto j = 2ull; j < number_of_parties; ++j) {
+          share_and = share_and & share_input.at(j);
+        }
+        share_output.push_back(share_and.Out(output_owner));
+      }
+
+      auto evaluation_future = motion_parties.at(party_id)->RunAsync();
+
+      // consume the outputs batch by batch while the evaluation may still be running
+      for (std::size_t batch = 0; batch < kNumberOfBatches; ++batch) {
+        share_output.at(batch).WaitOnline();
+        if (party_id == output_owner) {
+          for (auto j = 0ull; j < 64; ++j) {
+            auto wire_single =
+                std::dynamic_pointer_cast<encrypto::motion::proto::boolean_gmw::Wire>(
+                    share_output.at(batch)->GetWires().at(j));
+            assert(wire_single);
+            std::vector<encrypto::motion::BitVector<>> global_input_single;
+            for (auto k = 0ull; k < number_of_parties; ++k) {
+              global_input_single.push_back(global_input.at(batch).at(k).at(j));
+            }
+            EXPECT_EQ(wire_single->GetValues(),
+                      encrypto::motion::BitVector<>::AndBitVectors(global_input_single));
+          }
+        }
+      }
+
+      evaluation_future.get();
+      EXPECT_GT(motion_parties.at(party_id)
+                    ->GetBackend()
+                    ->GetRunTimeStatistics()
+                    .back()
+                    .number_of_released_wire_bytes,
+                0);
+      motion_parties.at(party_id)->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, SubmitBatch_And_64_bit_10_Simd_2_3_parties) {
+  constexpr std::size_t kNumberOfBatches = 3;
+  std::srand(std::time(nullptr));
+  for (auto number_of_parties : {2u, 3u}) {
+    const std::size_t output_owner = std::rand() % number_of_parties;
+    // global_input[batch][party][bit]
+    std::vector<std::vector<std::vector<encrypto::motion::BitVector<>>>> global_input(
+        kNumberOfBatches,
+        std::vector<std::vector<encrypto::motion::BitVector<>>>(number_of_parties));
+    for (auto& batch : global_input) {
+      for (auto& bv_v : batch) {
+        bv_v.resize(64);
+        for (auto& bv : bv_v) {
+          bv = encrypto::motion::BitVector<>::SecureRandom(10);
+        }
+      }
+    }
+    const std::vector<encrypto::motion::BitVector<>> dummy_input(
+        64, encrypto::motion::BitVector<>(10, false));
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& backend{*motion_parties.at(party_id)->GetBackend()};
+      // the batches are submitted one by one, each is preprocessed while the previous ones are
+      // evaluated
+      std::vector<std::shared_future<encrypto::motion::Backend::EvaluatedBatch>> batches;
+      for (std::size_t batch = 0; batch < kNumberOfBatches; ++batch) {
+        batches.emplace_back(backend.SubmitBatch([&](encrypto::motion::Backend& batch_backend) {
+          std::vector<encrypto::motion::ShareWrapper> share_input;
+          for (auto j = 0ull; j < number_of_parties; ++j) {
+            share_input.emplace_back(batch_backend.BooleanGmwInput(
+                j, j == party_id ? global_input.at(batch).at(j) : dummy_input));
+          }
+          auto share_and = share_input.at(0) & share_input.at(1);
+          for (auto j = 2ull; j < number_of_parties; ++j) {
+            share_and = share_and & share_input.at(j);
+          }
+          return std::vector<encrypto::motion::SharePointer>{share_and.Out(output_owner).Get()};
+        }));
+      }
+
+      // consume the outputs batch by batch while the following batches may still be evaluated
+      for (std::size_t batch = 0; batch < kNumberOfBatches; ++batch) {
+        const auto& evaluated_batch{batches.at(batch).get()};
+        EXPECT_NE(evaluated_batch.backend.get(), &backend);
+        if (party_id == output_owner) {
+          for (auto j = 0ull; j < 64; ++j) {
+            auto wire_single =
+                std::dynamic_pointer_cast<encrypto::motion::proto::boolean_gmw::Wire>(
+                    evaluated_batch.outputs.at(0)->GetWires().at(j));
+            assert(wire_single);
+            std::vector<encrypto::motion::BitVector<>> global_input_single;
+            for (auto k = 0ull; k < number_of_parties; ++k) {
+              global_input_single.push_back(global_input.at(batch).at(k).at(j));
+            }
+            EXPECT_EQ(wire_single->GetValues(),
+                      encrypto::motion::BitVector<>::AndBitVectors(global_input_single));
+          }
+        }
+      }
+      batches.clear();
+      motion_parties.at(party_id)->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, BackgroundPreprocessing_And_64_bit_10_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties = 2;
+  constexpr std::size_t kNumberOfQueries = 2;
+  std::srand(std::time(nullptr));
+  const std::size_t output_owner = std::rand() % kNumberOfParties;
+  // global_input[query][party][bit]
+  std::vector<std::vector<std::vector<encrypto::motion::BitVector<>>>> global_input(
+      kNumberOfQueries,
+      std::vector<std::vector<encrypto::motion::BitVector<>>>(kNumberOfParties));
+  for (auto& query : global_input) {
+    for (auto& bv_v : query) {
+      bv_v.resize(64);
+      for (auto& bv : bv_v) {
+        bv = encrypto::motion::BitVector<>::SecureRandom(10);
+      }
+    }
+  }
+  std::vector<encrypto::motion::BitVector<>> dummy_input(64,
+                                                          encrypto::motion::BitVector<>(10, false));
+
+  // one independent set of parties per query
+  std::vector<std::vector<PartyPointer>> motion_parties;
+  for (std::size_t query = 0; query < kNumberOfQueries; ++query) {
+    motion_parties.emplace_back(MakeLocallyConnectedParties(kNumberOfParties, kPortOffset));
+    for (auto& party : motion_parties.back()) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+  }
+#pragma omp parallel for num_threads(kNumberOfParties + 1)
+  for (auto party_id = 0u; party_id < kNumberOfParties; ++party_id) {
+    std::vector<encrypto::motion::ShareWrapper> share_output;
+    for (std::size_t query = 0; query < kNumberOfQueries; ++query) {
+      auto& party = motion_parties.at(query).at(party_id);
+      std::vector<encrypto::motion::ShareWrapper> share_input;
+      for (auto j = 0ull; j < kNumberOfParties; ++j) {
+        if (j == party_id) {
+          share_input.push_back(party->In<kBooleanGmw>(global_input.at(query).at(j), j));
+        } else {
+          share_input.push_back(party->In<kBooleanGmw>(dummy_input, j));
+        }
+      }
+      share_output.push_back((share_input.at(0) & share_input.at(1)).Out(output_owner));
+    }
+
+    // the preprocessing of the second query overlaps with the evaluation of the first one
+    motion_parties.at(1).at(party_id)->StartPreprocessing();
+    for (std::size_t query = 0; query < kNumberOfQueries; ++query) {
+      motion_parties.at(query).at(party_id)->Run();
+      if (party_id == output_owner) {
+        for (auto j = 0ull; j < 64; ++j) {
+          auto wire_single = std::dynamic_pointer_cast<encrypto::motion::proto::boolean_gmw::Wire>(
+              share_output.at(query)->GetWires().at(j));
+          assert(wire_single);
+          EXPECT_EQ(wire_single->GetValues(), global_input.at(query).at(0).at(j) &
+                                                  global_input.at(query).at(1).at(j));
+        }
+      }
+      motion_parties.at(query).at(party_id)->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, DownstreamGates_Xor_64_bit_10_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties = 2;
+  std::vector<encrypto::motion::BitVector<>> input(64, encrypto::motion::BitVector<>(10, false));
+
+  std::vector<PartyPointer> motion_parties(
+      MakeLocallyConnectedParties(kNumberOfParties, kPortOffset));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  }
+#pragma omp parallel for num_threads(kNumberOfParties + 1)
+  for (auto party_id = 0u; party_id < kNumberOfParties; ++party_id) {
+    auto& party = motion_parties.at(party_id);
+    // gates 0, 1 and 2
+    encrypto::motion::ShareWrapper a(party->In<kBooleanGmw>(input, 0));
+    encrypto::motion::ShareWrapper b(party->In<kBooleanGmw>(input, 1));
+    encrypto::motion::ShareWrapper c(party->In<kBooleanGmw>(input, 0));
+    // gates 3, 4 and 5
+    auto a_xor_b = a ^ b;
+    auto a_xor_b_xor_c = a_xor_b ^ c;
+    auto b_xor_c = b ^ c;
+    // gates 6 and 7
+    a_xor_b_xor_c.Out();
+    b_xor_c.Out();
+
+    auto& register_pointer = party->GetBackend()->GetRegister();
+    const auto& gates = register_pointer->GetGates();
+    EXPECT_EQ(gates.size(), 8);
+    auto get_ids = [](const std::vector<encrypto::motion::GatePointer>& gate_vector) {
+      std::vector<std::int64_t> ids;
+      for (auto& gate : gate_vector) {
+        ids.emplace_back(gate->GetId());
+      }
+      return ids;
+    };
+    const std::vector<std::int64_t> expected_ids_0{0, 3, 4, 6};
+    const std::vector<std::int64_t> expected_ids_5{5, 7};
+    EXPECT_EQ(get_ids(register_pointer->GetDownstreamGates({gates.at(0)})), expected_ids_0);
+    EXPECT_EQ(get_ids(register_pointer->GetDownstreamGates({gates.at(5)})), expected_ids_5);
+
+    party->Run();
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, ClearDownstream_Xor_And_2_bit_10_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties = 2, kNumberOfWires = 2, kNumberOfSimd = 10;
+  std::vector<encrypto::motion::BitVector<>> input_a_0, input_a_1, input_b, input_c;
+  for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+    input_a_0.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    input_a_1.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    input_b.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    input_c.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd));
+  auto apply = [](const auto& lhs, const auto& rhs, auto operation) {
+    std::vector<encrypto::motion::BitVector<>> result;
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+      result.emplace_back(operation(lhs[i], rhs[i]));
+    }
+    return result;
+  };
+  const auto expected_xor_0{apply(input_a_0, input_b, std::bit_xor<>())};
+  const auto expected_xor_1{apply(input_a_1, input_b, std::bit_xor<>())};
+  const auto expected_and{apply(input_b, input_c, std::bit_and<>())};
+
+  std::vector<PartyPointer> motion_parties(
+      MakeLocallyConnectedParties(kNumberOfParties, kPortOffset));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  }
+#pragma omp parallel for num_threads(kNumberOfParties + 1)
+  for (auto party_id = 0u; party_id < kNumberOfParties; ++party_id) {
+    auto& party = motion_parties.at(party_id);
+    auto [share_a, promise]{party->In<kBooleanGmw>(0, kNumberOfWires, kNumberOfSimd)};
+    encrypto::motion::ShareWrapper a(share_a);
+    encrypto::motion::ShareWrapper b(
+        party->In<kBooleanGmw>(party_id == 1 ? input_b : dummy_input, 1));
+    encrypto::motion::ShareWrapper c(
+        party->In<kBooleanGmw>(party_id == 1 ? input_c : dummy_input, 1));
+    auto xor_output{(a ^ b).Out()};
+    auto and_output{(b & c).Out()};
+
+    if (promise != nullptr) promise->set_value(input_a_0);
+    party->Run();
+    EXPECT_EQ(xor_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_xor_0);
+    EXPECT_EQ(and_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_and);
+
+    // the AND gate would need a fresh multiplication triple
+    EXPECT_THROW(party->ClearDownstream({b.Get()}), std::logic_error);
+
+    // only the input gate of a, the XOR gate and its output gate are re-evaluated
+    party->ClearDownstream({a.Get()});
+    const auto& register_pointer = party->GetBackend()->GetRegister();
+    EXPECT_EQ(register_pointer->GetNumberOfEvaluatedGatesOnline() + 3,
+              register_pointer->GetNumberOfGatesOnline());
+    if (promise != nullptr) promise->set_value(input_a_1);
+    party->Run();
+    EXPECT_EQ(xor_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_xor_1);
+    EXPECT_EQ(and_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_and);
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, ObjectAccounting_Xor_And_64_bit_10_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties = 2;
+  std::vector<encrypto::motion::BitVector<>> input(64, encrypto::motion::BitVector<>(10, false));
+
+  std::vector<PartyPointer> motion_parties(
+      MakeLocallyConnectedParties(kNumberOfParties, kPortOffset));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  }
+#pragma omp parallel for num_threads(kNumberOfParties + 1)
+  for (auto party_id = 0u; party_id < kNumberOfParties; ++party_id) {
+    auto& party = motion_parties.at(party_id);
+    auto& register_pointer = party->GetBackend()->GetRegister();
+    encrypto::motion::ShareWrapper a(party->In<kBooleanGmw>(input, 0));
+    encrypto::motion::ShareWrapper b(party->In<kBooleanGmw>(input, 1));
+    register_pointer->SetObjectAccounting(true);
+    auto a_xor_b = a ^ b;
+    auto a_and_b = a & b;
+    register_pointer->SetObjectAccounting(false);
+    (a_xor_b ^ a_and_b).Out();
+
+    const auto statistics{register_pointer->GetObjectStatistics()};
+    EXPECT_EQ(statistics.count("boolean_gmw::InputGate"), 0);
+    EXPECT_EQ(statistics.at("boolean_gmw::XorGate").number_of_objects, 1);
+    EXPECT_EQ(statistics.at("boolean_gmw::AndGate").number_of_objects, 1);
+    // the output wires of the gates are accounted for their own class
+    const auto& xor_gate{statistics.at("boolean_gmw::XorGate")};
+    EXPECT_GE(xor_gate.arena_bytes, sizeof(encrypto::motion::proto::boolean_gmw::XorGate));
+    EXPECT_LT(xor_gate.arena_bytes, sizeof(encrypto::motion::proto::boolean_gmw::XorGate) + 64);
+    const auto& wires{statistics.at("boolean_gmw::Wire")};
+    EXPECT_GE(wires.number_of_objects, 2 * 64);
+    EXPECT_EQ(wires.arena_bytes % wires.number_of_objects, 0);
+
+    party->Run();
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, ObjectRecycling_Xor_And_64_bit_10_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties = 2, kNumberOfQueries = 3;
+  std::vector<PartyPointer> motion_parties(
+      MakeLocallyConnectedParties(kNumberOfParties, kPortOffset));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  }
+#pragma omp parallel for num_threads(kNumberOfParties + 1)
+  for (auto party_id = 0u; party_id < kNumberOfParties; ++party_id) {
+    auto& party = motion_parties.at(party_id);
+    auto& register_pointer = party->GetBackend()->GetRegister();
+    register_pointer->SetObjectRecycling(true);
+    for (std::size_t query = 0; query < kNumberOfQueries; ++query) {
+      // the ids are dense within the epoch of each query
+      EXPECT_EQ(register_pointer->GetEpoch(), query);
+      EXPECT_EQ(register_pointer->GetTotalNumberOfGates(), 0);
+      {
+        std::vector<encrypto::motion::BitVector<>> input_0, input_1, expected;
+        for (std::size_t i = 0; i < 64; ++i) {
+          input_0.emplace_back(encrypto::motion::BitVector<>(10, (i + query) % 2 == 0));
+          input_1.emplace_back(encrypto::motion::BitVector<>(10, (i + query) % 3 == 0));
+          expected.emplace_back((input_0.back() ^ input_1.back()) & input_0.back());
+        }
+        encrypto::motion::ShareWrapper a(party->In<kBooleanGmw>(input_0, 0));
+        encrypto::motion::ShareWrapper b(party->In<kBooleanGmw>(input_1, 1));
+        auto output = ((a ^ b) & a).Out();
+        EXPECT_EQ(register_pointer->GetGate(0)->GetId(), 0);
+        EXPECT_EQ(register_pointer->GetWire(0)->GetWireId(), 0);
+        // the objects of the previous query are destroyed with its shares and the register
+        if (query == 0) {
+          EXPECT_EQ(register_pointer->GetNumberOfRecycledObjectBytes(), 0);
+        } else {
+          EXPECT_GT(register_pointer->GetNumberOfRecycledObjectBytes(), 0);
+        }
+        party->Run();
+        EXPECT_TRUE(output.As<std::vector<encrypto::motion::BitVector<>>>() == expected);
+      }
+      party->Reset();
+    }
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, InnerProduct_2_bit_10_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfTerms{7}, kNumberOfSimd{10};
+  std::vector<std::vector<encrypto::motion::BitVector<>>> input_a, input_b;
+  std::vector<encrypto::motion::BitVector<>> expected(
+      2, encrypto::motion::BitVector<>(kNumberOfSimd));
+  for (std::size_t i = 0; i < kNumberOfTerms; ++i) {
+    input_a.emplace_back();
+    input_b.emplace_back();
+    for (std::size_t w = 0; w < 2; ++w) {
+      input_a.back().emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+      input_b.back().emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+      expected[w] ^= input_a.back()[w] & input_b.back()[w];
+    }
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      2, encrypto::motion::BitVector<>(kNumberOfSimd));
+  for (std::size_t number_of_parties : {2u, 3u}) {
+    auto motion_parties{MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+        auto& party{*motion_parties.at(party_id)};
+        std::vector<encrypto::motion::ShareWrapper> a, b;
+        for (std::size_t i = 0; i < kNumberOfTerms; ++i) {
+          a.emplace_back(party.In<kBooleanGmw>(party_id == 0 ? input_a[i] : dummy_input, 0));
+          b.emplace_back(party.In<kBooleanGmw>(party_id == 1 ? input_b[i] : dummy_input, 1));
+        }
+        auto output = encrypto::motion::DotProduct(a, b).Out();
+        party.Run();
+        EXPECT_TRUE(output.As<std::vector<encrypto::motion::BitVector<>>>() == expected);
+        party.Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+}
+
+TEST(BooleanGmw, Vectorize_And_Xor_8_bit_5_iterations_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfIterations{5}, kBitLength{8};
+  std::vector<std::vector<encrypto::motion::BitVector<>>> input_a, input_b, expected;
+  for (std::size_t i = 0; i < kNumberOfIterations; ++i) {
+    // the iterations have 1, 2, 3, 1, 2 SIMD values
+    const std::size_t number_of_simd{i % 3 + 1};
+    input_a.emplace_back();
+    input_b.emplace_back();
+    expected.emplace_back();
+    for (std::size_t w = 0; w < kBitLength; ++w) {
+      input_a.back().emplace_back(encrypto::motion::BitVector<>::SecureRandom(number_of_simd));
+      input_b.back().emplace_back(encrypto::motion::BitVector<>::SecureRandom(number_of_simd));
+      expected.back().emplace_back((input_a.back()[w] & input_b.back()[w]) ^ input_a.back()[w]);
+    }
+  }
+  for (std::size_t number_of_parties : {2u, 3u}) {
+    auto motion_parties{MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+        auto& party{*motion_parties.at(party_id)};
+        std::vector<std::vector<encrypto::motion::ShareWrapper>> iterations;
+        for (std::size_t i = 0; i < kNumberOfIterations; ++i) {
+          std::vector<encrypto::motion::BitVector<>> dummy_input(
+              kBitLength, encrypto::motion::BitVector<>(input_a[i][0].GetSize()));
+          iterations.push_back(
+              {party.In<kBooleanGmw>(party_id == 0 ? input_a[i] : dummy_input, 0),
+               party.In<kBooleanGmw>(party_id == 1 ? input_b[i] : dummy_input, 1)});
+        }
+        auto results{encrypto::motion::Vectorize(
+            iterations, [](std::span<const encrypto::motion::ShareWrapper> operands) {
+              return std::vector{(operands[0] & operands[1]) ^ operands[0]};
+            })};
+        ASSERT_EQ(results.size(), kNumberOfIterations);
+        std::vector<encrypto::motion::ShareWrapper> outputs;
+        for (auto& result : results) {
+          ASSERT_EQ(result.size(), 1);
+          outputs.push_back(result[0].Out());
+        }
+        party.Run();
+        for (std::size_t i = 0; i < kNumberOfIterations; ++i) {
+          EXPECT_TRUE(outputs[i].As<std::vector<encrypto::motion::BitVector<>>>() == expected[i]);
+        }
+        party.Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+}
+
+TEST(BooleanGmw, KingOpenings_And_64_bit_10_Simd_3_4_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  std::vector<encrypto::motion::BitVector<>> input_0, input_1, expected;
+  for (std::size_t i = 0; i < 64; ++i) {
+    input_0.emplace_back(encrypto::motion::BitVector<>::SecureRandom(10));
+    input_1.emplace_back(encrypto::motion::BitVector<>::SecureRandom(10));
+    expected.emplace_back(input_0.back() & input_1.back());
+  }
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(64,
+                                                               encrypto::motion::BitVector<>(10));
+  for (std::size_t number_of_parties : {3u, 4u}) {
+    auto motion_parties{MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetKingOpenings(true);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+        auto& party{*motion_parties.at(party_id)};
+        encrypto::motion::ShareWrapper a(
+            party.In<kBooleanGmw>(party_id == 0 ? input_0 : dummy_input, 0));
+        encrypto::motion::ShareWrapper b(
+            party.In<kBooleanGmw>(party_id == 1 ? input_1 : dummy_input, 1));
+        auto output = (a & b).Out();
+        party.Run();
+        EXPECT_TRUE(output.As<std::vector<encrypto::motion::BitVector<>>>() == expected);
+        party.Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+}
+
 TEST(BooleanGmw, Or_1_bit_1_1K_Simd_2_3_parties) {
   for (auto i = 0ull; i < kTestIterations; ++i) {
     constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
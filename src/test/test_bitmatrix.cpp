@@ -64,6 +64,127 @@ TEST(BitMatrix, Transpose) {
   }
 }
 
+TEST(BitMatrix, TransposeArbitraryShapes) {
+  constexpr std::array<std::pair<std::size_t, std::size_t>, 9> kShapes{
+      {{1, 1}, {1, 200}, {200, 1}, {3, 200}, {64, 64}, {65, 63}, {130, 77}, {1000, 129},
+       {1500, 1100}}};
+  for (const auto& [m, n] : kShapes) {
+    std::vector<encrypto::motion::AlignedBitVector> vectors(m);
+    for (auto& vector : vectors) {
+      vector = encrypto::motion::AlignedBitVector::SecureRandom(n);
+    }
+
+    encrypto::motion::BitMatrix bit_matrix(vectors);
+    bit_matrix.Transpose();
+    ASSERT_EQ(bit_matrix.GetNumRows(), n);
+    ASSERT_EQ(bit_matrix.GetNumColumns(), m);
+    for (auto column_i = 0ull; column_i < n; ++column_i) {
+      ASSERT_EQ(bit_matrix.GetRow(column_i).GetSize(), m);
+      for (auto row_i = 0ull; row_i < m; ++row_i) {
+        ASSERT_EQ(vectors[row_i].Get(column_i), bit_matrix.Get(column_i, row_i));
+      }
+    }
+
+    // transposing twice restores the matrix
+    bit_matrix.Transpose();
+    ASSERT_TRUE(bit_matrix == encrypto::motion::BitMatrix(vectors));
+  }
+}
+
+TEST(BitMatrix, TransposeKernelsAgreeWithSse) {
+  using encrypto::motion::BitMatrix;
+  constexpr std::size_t kNumberOfRows{128}, kNumberOfColumns{1024};
+  const auto default_kernel{BitMatrix::GetTransposeKernel()};
+  for (auto test_iterations = 0ull; test_iterations < kTestIterations; ++test_iterations) {
+    std::vector<encrypto::motion::AlignedBitVector> vectors(kNumberOfRows);
+    for (auto& vector : vectors) {
+      vector = encrypto::motion::AlignedBitVector::SecureRandom(kNumberOfColumns);
+    }
+    auto transpose = [&vectors](BitMatrix::TransposeKernel kernel) {
+      auto result{vectors};
+      std::array<std::byte*, kNumberOfRows> pointers;
+      for (auto j = 0u; j < pointers.size(); ++j) {
+        pointers[j] = result[j].GetMutableData().data();
+      }
+      BitMatrix::SetTransposeKernel(kernel);
+      BitMatrix::TransposeUsingBitSlicing(pointers, kNumberOfColumns);
+      return result;
+    };
+    const auto expected{transpose(BitMatrix::TransposeKernel::kSse)};
+    for (auto kernel : {BitMatrix::TransposeKernel::kAvx2, BitMatrix::TransposeKernel::kAvx512}) {
+      if (BitMatrix::IsSupported(kernel)) {
+        EXPECT_EQ(transpose(kernel), expected);
+      } else {
+        EXPECT_THROW(BitMatrix::SetTransposeKernel(kernel), std::invalid_argument);
+      }
+    }
+  }
+  BitMatrix::SetTransposeKernel(default_kernel);
+}
+
+TEST(BitMatrix, EncodeTranspose256MatchesTranspose256Columns) {
+  using encrypto::motion::BitMatrix;
+  constexpr std::size_t kNumberOfCodeWords{16}, kCodeWordStride{256};
+  std::mt19937 random(0);
+  for (std::size_t number_of_inputs : {1, 255, 256, 1000}) {
+    const auto code_words{encrypto::motion::AlignedBitVector::SecureRandom(
+        kNumberOfCodeWords * kCodeWordStride * 8)};
+    std::vector<std::size_t> inputs(number_of_inputs);
+    std::vector<encrypto::motion::AlignedBitVector> encoded(number_of_inputs);
+    for (std::size_t i = 0; i < number_of_inputs; ++i) {
+      inputs[i] = random() % kNumberOfCodeWords;
+      encoded[i] = encrypto::motion::AlignedBitVector(
+          code_words.GetData().data() + kCodeWordStride * inputs[i], 256);
+    }
+    BitMatrix expected(std::move(encoded));
+    expected.Transpose256Columns();
+
+    const std::size_t padded_size{(number_of_inputs + 255) / 256 * 256};
+    std::vector<encrypto::motion::AlignedBitVector> rows(
+        256, encrypto::motion::AlignedBitVector(padded_size));
+    std::array<std::byte*, 256> pointers;
+    for (std::size_t j = 0; j < pointers.size(); ++j) {
+      pointers[j] = rows[j].GetMutableData().data();
+    }
+    BitMatrix::EncodeTranspose256(code_words.GetData().data(), kCodeWordStride, inputs, pointers);
+    for (std::size_t j = 0; j < rows.size(); ++j) {
+      rows[j].Resize(number_of_inputs);
+      EXPECT_EQ(rows[j], expected.GetRow(j));
+    }
+  }
+}
+
+TEST(BitMatrix, EncodeTransposeCodeTransposesCodeWords) {
+  using encrypto::motion::BitMatrix;
+  constexpr std::size_t kNumberOfCodeWords{16};
+  std::mt19937 random(0);
+  for (std::size_t code_bit_length : {128, 256, 512}) {
+    const std::size_t code_word_stride{code_bit_length / 8}, number_of_inputs{1000};
+    const auto code_words{encrypto::motion::AlignedBitVector::SecureRandom(
+        kNumberOfCodeWords * code_word_stride * 8)};
+    std::vector<std::size_t> inputs(number_of_inputs);
+    for (auto& input : inputs) input = random() % kNumberOfCodeWords;
+
+    const std::size_t padded_size{(number_of_inputs + code_bit_length - 1) / code_bit_length *
+                                  code_bit_length};
+    std::vector<encrypto::motion::AlignedBitVector> rows(
+        code_bit_length, encrypto::motion::AlignedBitVector(padded_size));
+    std::vector<std::byte*> pointers(code_bit_length);
+    for (std::size_t j = 0; j < pointers.size(); ++j) {
+      pointers[j] = rows[j].GetMutableData().data();
+    }
+    BitMatrix::EncodeTransposeCode(code_words.GetData().data(), code_word_stride, inputs,
+                                   pointers);
+    for (std::size_t i = 0; i < number_of_inputs; ++i) {
+      for (std::size_t j = 0; j < code_bit_length; ++j) {
+        ASSERT_EQ(rows[j].Get(i), code_words.Get(inputs[i] * code_bit_length + j));
+      }
+    }
+  }
+  std::vector<std::byte*> pointers(384);
+  EXPECT_THROW(BitMatrix::EncodeTransposeCode(nullptr, 48, {}, pointers), std::invalid_argument);
+}
+
 // XXX: adjust to little endian encoding in BitVector or remove, since we can use other methods via
 // simde
 /*
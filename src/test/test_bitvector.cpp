@@ -28,6 +28,8 @@
 #include <gtest/gtest.h>
 
 #include "utility/bit_vector.h"
+#include "utility/block.h"
+#include "utility/huge_page_allocator.h"
 
 #include "test_constants.h"
 
@@ -458,6 +460,123 @@ TEST(BitVector, Copy) {
   }
 }
 
+TEST(BitVector, CopyAtBitOffsets) {
+  using encrypto::motion::BitVector;
+  std::mt19937_64 random(0);
+  for (std::size_t size : {1, 7, 9, 63, 64, 65, 127, 200, 1000}) {
+    for (std::size_t repetition = 0; repetition < 20; ++repetition) {
+      const auto source{BitVector<>::RandomSeeded(size + 80, random())};
+      const std::size_t source_from{random() % 80}, destination_from{random() % 80};
+      const auto original{BitVector<>::RandomSeeded(size + 80, random())};
+
+      BitVector<> destination{original};
+      destination.Copy(destination_from, destination_from + size, source, source_from);
+      for (std::size_t i = 0; i < size + 80; ++i) {
+        const bool is_copied{i >= destination_from && i < destination_from + size};
+        ASSERT_EQ(destination.Get(i),
+                  is_copied ? source.Get(i - destination_from + source_from) : original.Get(i));
+      }
+
+      const auto subset{source.Subset(source_from, source_from + size)};
+      ASSERT_EQ(subset.GetSize(), size);
+      for (std::size_t i = 0; i < size; ++i) ASSERT_EQ(subset.Get(i), source.Get(source_from + i));
+
+      BitVector<> appended{original.Subset(0, destination_from)};
+      const encrypto::motion::BitSpan span(const_cast<std::byte*>(subset.GetData().data()), size);
+      appended.Append(span);
+      ASSERT_EQ(appended.GetSize(), destination_from + size);
+      ASSERT_EQ(appended.Subset(destination_from, destination_from + size), subset);
+    }
+  }
+  EXPECT_THROW(BitVector<>(10).Copy(0, 10, BitVector<>(10), 1), std::out_of_range);
+}
+
+TEST(BitVector, Gather) {
+  using encrypto::motion::BitVector;
+  const auto source{BitVector<>::RandomSeeded(300, 0)};
+  std::vector<std::size_t> positions(1000);
+  std::mt19937_64 random(1);
+  for (auto& position : positions) position = random() % source.GetSize();
+  const auto gathered{source.Gather(positions)};
+  ASSERT_EQ(gathered.GetSize(), positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    ASSERT_EQ(gathered.Get(i), source.Get(positions[i]));
+  }
+  positions.back() = source.GetSize();
+  EXPECT_THROW(source.Gather(positions), std::out_of_range);
+}
+
+TEST(BitVector, BulkKernels) {
+  using encrypto::motion::BitVector;
+  using encrypto::motion::BitwiseKernel;
+  const auto default_kernel{encrypto::motion::GetBitwiseKernel()};
+  for (auto kernel : {BitwiseKernel::kSse, BitwiseKernel::kAvx2, BitwiseKernel::kAvx512}) {
+    if (!encrypto::motion::IsSupported(kernel)) continue;
+    encrypto::motion::SetBitwiseKernel(kernel);
+    for (std::size_t size : {1, 7, 8, 63, 64, 65, 255, 256, 257, 511, 512, 513, 4099}) {
+      const auto a{BitVector<>::RandomSeeded(size, size)}, b{BitVector<>::RandomSeeded(size, 0)};
+      std::size_t expected_popcount{0}, expected_first_set{size};
+      BitVector<> expected_xor(size), expected_and(size), expected_or(size);
+      for (std::size_t i = 0; i < size; ++i) {
+        expected_popcount += a.Get(i);
+        if (a.Get(i) && expected_first_set == size) expected_first_set = i;
+        expected_xor.Set(a.Get(i) != b.Get(i), i);
+        expected_and.Set(a.Get(i) && b.Get(i), i);
+        expected_or.Set(a.Get(i) || b.Get(i), i);
+      }
+      EXPECT_EQ(a ^ b, expected_xor);
+      EXPECT_EQ(a & b, expected_and);
+      EXPECT_EQ(a | b, expected_or);
+      EXPECT_EQ(a.PopCount(), expected_popcount);
+      EXPECT_EQ(a.HammingWeight(), expected_popcount);
+      EXPECT_EQ(a.Parity(), expected_popcount % 2 == 1);
+      EXPECT_EQ(BitVector<>::XorReduceBitVector(a), expected_popcount % 2 == 1);
+      EXPECT_EQ(a.FindFirstSet(), expected_first_set);
+
+      BitVector<> single_bit(size);
+      EXPECT_EQ(single_bit.FindFirstSet(), size);
+      EXPECT_FALSE(BitVector<>::OrReduceBitVector(single_bit));
+      single_bit.Set(true, size - 1);
+      EXPECT_EQ(single_bit.FindFirstSet(), size - 1);
+      EXPECT_TRUE(BitVector<>::OrReduceBitVector(single_bit));
+
+      BitVector<> ones(size, true);
+      EXPECT_TRUE(BitVector<>::AndReduceBitVector(ones));
+      ones.Set(false, size / 2);
+      EXPECT_FALSE(BitVector<>::AndReduceBitVector(ones));
+    }
+  }
+  encrypto::motion::SetBitwiseKernel(default_kernel);
+}
+
+TEST(BitVector, SmallBuffer) {
+  using encrypto::motion::BitVector;
+  // vectors of up to 128 bits are stored inline, longer ones on the heap, and values must survive
+  // copies, moves and growth across both representations
+  for (std::size_t size : {1, 64, 128, 129, 1000}) {
+    const auto random{BitVector<>::RandomSeeded(size, size)};
+    BitVector<> copy{random};
+    EXPECT_EQ(copy, random);
+    BitVector<> moved{std::move(copy)};
+    EXPECT_EQ(moved, random);
+    copy = moved;
+    EXPECT_EQ(copy, random);
+
+    BitVector<> grown{random};
+    grown.Append(random);
+    EXPECT_EQ(grown.Subset(0, size), random);
+    EXPECT_EQ(grown.Subset(size, 2 * size), random);
+    moved = std::move(grown);
+    EXPECT_EQ(moved.GetSize(), 2 * size);
+    EXPECT_EQ(moved.Subset(size, 2 * size), random);
+
+    const BitVector<encrypto::motion::AlignedAllocator> aligned{random};
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned.GetData().data()) %
+                  encrypto::motion::kAlignment,
+              0u);
+  }
+}
+
 TEST(BitSpan, SingleBitOperations) {
   std::mt19937_64 mersenne_twister(0);
   for (std::size_t test_i = 0; test_i < kTestIterations; ++test_i) {
@@ -689,4 +808,66 @@ TEST(BitVectorAndSpan, HammingWeight) {
     }
   }
 }
+
+TEST(BitVectorAndSpan, FusedKernels) {
+  using encrypto::motion::BitVector;
+  for (std::size_t size : {1, 7, 8, 63, 100, 1000}) {
+    const auto a{BitVector<>::RandomSeeded(size, 1)}, b{BitVector<>::RandomSeeded(size, 2)},
+        c{BitVector<>::RandomSeeded(size, 3)}, d{BitVector<>::RandomSeeded(size, 4)};
+    const BitVector<encrypto::motion::AlignedAllocator> aligned_b{b};
+    encrypto::motion::BitSpan span_c(const_cast<std::byte*>(c.GetData().data()), size);
+
+    BitVector<> result;
+    encrypto::motion::XorInto(result, a, aligned_b, span_c);
+    EXPECT_EQ(result, a ^ b ^ c);
+    encrypto::motion::XorInto(result, result, d);
+    EXPECT_EQ(result, a ^ b ^ c ^ d);
+
+    encrypto::motion::AndInto(result, a, span_c);
+    EXPECT_EQ(result, a & c);
+
+    BitVector<> products{d};
+    encrypto::motion::XorAndInto(products, a, b, c, d);
+    EXPECT_EQ(products, d ^ (a & b) ^ (c & d));
+
+    BitVector<> buffer(size);
+    encrypto::motion::BitSpan destination(buffer);
+    encrypto::motion::XorInto(destination, a, b);
+    EXPECT_EQ(buffer, a ^ b);
+  }
+}
+
+
+TEST(BitVector, HugePageAllocation) {
+  using encrypto::motion::BitVector;
+  using encrypto::motion::HugePageMode;
+  constexpr std::size_t kBits{std::size_t(3) << 24};
+  for (auto mode : {HugePageMode::kNone, HugePageMode::kTransparent, HugePageMode::kExplicit}) {
+    encrypto::motion::SetHugePageMode(mode);
+    EXPECT_TRUE(encrypto::motion::GetHugePageMode() == mode);
+
+    // large buffers are aligned to huge pages independently of the mode
+    const auto random{BitVector<>::RandomSeeded(kBits, 5)};
+    encrypto::motion::AlignedBitVector aligned{random};
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned.GetData().data()) %
+                  encrypto::motion::kHugePageSize,
+              0u);
+    EXPECT_TRUE(aligned == random);
+    aligned ^= aligned;
+    EXPECT_TRUE(aligned == encrypto::motion::AlignedBitVector(kBits));
+
+    encrypto::motion::Block128Vector blocks(encrypto::motion::kHugePageSize / 16 + 1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(blocks.data()) % encrypto::motion::kHugePageSize,
+              0u);
+    blocks.SetToZero();
+    for (const auto& block : blocks) EXPECT_TRUE(block == encrypto::motion::Block128::MakeZero());
+
+    // small buffers keep their alignment
+    encrypto::motion::AlignedBitVector small(random.GetData().data(), 100);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small.GetData().data()) %
+                  encrypto::motion::kAlignment,
+              0u);
+  }
+  encrypto::motion::SetHugePageMode(HugePageMode::kNone);
+}
 }  // namespace
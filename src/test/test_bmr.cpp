@@ -118,6 +118,39 @@ TEST_P(BmrTest, InputOutput) {
   }
 }
 
+TEST_P(BmrTest, DeferredInput) {
+  constexpr auto kBmr = encrypto::motion::MpcProtocol::kBmr;
+  const std::size_t input_owner = this->number_of_parties_ - 1;
+  std::vector<encrypto::motion::BitVector<>> input(this->number_of_wires_);
+  for (auto& bv : input) bv = encrypto::motion::BitVector<>::SecureRandom(this->number_of_simd_);
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(this->number_of_parties_, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(this->online_after_setup_);
+  }
+  std::vector<std::thread> threads;
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    threads.emplace_back([party_id, &motion_parties, this, input_owner, &input]() {
+      auto& party{motion_parties.at(party_id)};
+      auto [share, promise]{
+          party->In<kBmr>(input_owner, this->number_of_wires_, this->number_of_simd_)};
+      EXPECT_EQ(promise != nullptr, party_id == input_owner);
+      auto share_output{encrypto::motion::ShareWrapper(share).Out()};
+
+      // the keys of the input wires are generated before the input is known
+      auto running{party->RunAsync()};
+      if (promise != nullptr) promise->set_value(input);
+      running.get();
+
+      EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), input);
+      party->Finish();
+    });
+  }
+  for (auto& t : threads) t.join();
+}
+
 TEST_P(BmrTest, Inv) {
   constexpr auto kBmr = encrypto::motion::MpcProtocol::kBmr;
   std::srand(0);
@@ -605,4 +638,63 @@ INSTANTIATE_TEST_SUITE_P(BMRHeavyTestSuite, BmrHeavyTest,
                                std::get<1>(info.param), std::get<2>(info.param), mode);
                            return name;
                          });
+
+TEST(BmrAggregatedGarbledTables, And) {
+  constexpr auto kBmr = encrypto::motion::MpcProtocol::kBmr;
+  constexpr std::size_t kNumberOfParties{4}, kNumberOfWires{3}, kNumberOfSimd{10};
+  std::srand(0);
+  const std::size_t output_owner = std::rand() % kNumberOfParties;
+  std::vector<std::vector<encrypto::motion::BitVector<>>> global_input(kNumberOfParties);
+  for (auto& bv_v : global_input) {
+    bv_v.resize(kNumberOfWires);
+    for (auto& bv : bv_v) {
+      bv = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+    }
+  }
+  std::vector<encrypto::motion::BitVector<>> dummy_input(
+      kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetAggregateBmrGarbledTables(true);
+  }
+  std::vector<std::thread> threads;
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    threads.emplace_back([party_id, &motion_parties, output_owner, &global_input, &dummy_input]() {
+      std::vector<encrypto::motion::ShareWrapper> share_input;
+      for (auto j = 0ull; j < kNumberOfParties; ++j) {
+        share_input.push_back(motion_parties.at(party_id)->In<kBmr>(
+            j == party_id ? global_input.at(j) : dummy_input, j));
+      }
+
+      // the AND gates have different gate ids and hence different aggregators
+      auto share_and = share_input.at(0) & share_input.at(1);
+      for (auto j = 2ull; j < kNumberOfParties; ++j) {
+        share_and = share_and & share_input.at(j);
+      }
+      auto share_output = share_and.Out(output_owner);
+
+      motion_parties.at(party_id)->Run();
+
+      if (party_id == output_owner) {
+        for (auto j = 0ull; j < kNumberOfWires; ++j) {
+          auto wire_single = std::dynamic_pointer_cast<encrypto::motion::proto::bmr::Wire>(
+              share_output->GetWires().at(j));
+          assert(wire_single);
+          std::vector<encrypto::motion::BitVector<>> global_input_single;
+          for (auto k = 0ull; k < kNumberOfParties; ++k) {
+            global_input_single.push_back(global_input.at(k).at(j));
+          }
+          EXPECT_EQ(wire_single->GetPublicValues(),
+                    encrypto::motion::BitVector<>::AndBitVectors(global_input_single));
+        }
+      }
+      motion_parties.at(party_id)->Finish();
+    });
+  }
+  for (auto& t : threads)
+    if (t.joinable()) t.join();
+}
 }  // namespace
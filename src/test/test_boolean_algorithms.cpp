@@ -22,15 +22,25 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <bit>
 #include <chrono>
+#include <cmath>
 #include <iterator>
+#include <random>
+#include <tuple>
 
+#include "algorithm/array_circuits.h"
 #include "algorithm/boolean_algorithms.h"
+#include "algorithm/floating_point_circuits.h"
+#include "algorithm/integer_circuits.h"
 #include "base/party.h"
 #include "protocols/garbled_circuit/garbled_circuit_constants.h"
 #include "protocols/garbled_circuit/garbled_circuit_provider.h"
+#include "protocols/share_view.h"
 #include "protocols/share_wrapper.h"
+#include "secure_type/secure_array.h"
+#include "secure_type/secure_floating_point.h"
 #include "test_constants.h"
 #include "utility/reusable_future.h"
 
@@ -299,4 +309,576 @@ TEST_F(HammingWeightTest, EightBitsAllPossibleInputs) {
   for (auto& f : futures) f.get();
 }
 
-}  // namespace
\ No newline at end of file
+TEST_F(HammingWeightTest, ThousandBitsWithSimdInLogarithmicDepth) {
+  constexpr std::size_t kNumberOfBits{1000}, kNumberOfSimd{3};
+  std::mt19937_64 random(0);
+  std::vector<encrypto::motion::BitVector<>> input(kNumberOfBits);
+  std::vector<std::size_t> expected(kNumberOfSimd, 0);
+  for (std::size_t bit_i = 0; bit_i < kNumberOfBits; ++bit_i) {
+    for (std::size_t simd_j = 0; simd_j < kNumberOfSimd; ++simd_j) {
+      // the last SIMD value has all bits set
+      const bool bit{simd_j + 1 == kNumberOfSimd || (random() & 1) == 1};
+      input[bit_i].Append(bit);
+      expected[simd_j] += bit;
+    }
+  }
+
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &input, &expected, this]() {
+      auto& party{this->parties_[party_id]};
+      encrypto::motion::ShareWrapper bits{
+          party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(input, 0)};
+      const std::size_t gates_before{party->GetBackend()->GetRegister()->GetGates().size()};
+      auto result{encrypto::motion::algorithm::HammingWeight(bits)};
+      // the full adders of a level are a single gate on SIMD-packed bits
+      EXPECT_LT(party->GetBackend()->GetRegister()->GetGates().size() - gates_before,
+                kNumberOfBits / 2);
+      auto output{result.Out()};
+
+      party->Run();
+
+      auto computed_bvs{output.As<std::vector<encrypto::motion::BitVector<>>>()};
+      EXPECT_EQ(computed_bvs.size(), std::bit_width(kNumberOfBits));
+      for (std::size_t simd_j = 0; simd_j < kNumberOfSimd; ++simd_j) {
+        std::size_t computed_value{0};
+        for (std::size_t bit_k = 0; bit_k < computed_bvs.size(); ++bit_k) {
+          if (computed_bvs[bit_k].Get(simd_j)) computed_value += std::size_t(1) << bit_k;
+        }
+        EXPECT_EQ(computed_value, expected[simd_j]);
+      }
+      party->Finish();
+    }));
+  }
+
+  for (auto& f : futures) f.get();
+}
+
+TEST_F(HammingWeightTest, CountsViewedBitsWithoutSharesPerBit) {
+  constexpr std::size_t kNumberOfBits{9};
+  std::vector<encrypto::motion::BitVector<>> input(kNumberOfBits);
+  for (std::size_t bit_i = 0; bit_i < kNumberOfBits; ++bit_i) input[bit_i].Append(bit_i % 3 != 0);
+
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &input, this]() {
+      auto& party{this->parties_[party_id]};
+      encrypto::motion::ShareWrapper bits{
+          party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(input, 0)};
+      const auto all_bits{bits.View()};
+      EXPECT_EQ(all_bits.GetNumberOfWires(), input.size());
+      EXPECT_TRUE(all_bits.GetWire(4).GetWires()[0] == bits->GetWires()[4]);
+      // a view of a whole share yields the share itself
+      EXPECT_TRUE(encrypto::motion::ShareWrapper::Concatenate(std::span(&all_bits, 1)).Get() ==
+                  bits.Get());
+
+      // the upper 6 bits hold 4 ones
+      std::vector<encrypto::motion::ShareView> upper_bits;
+      for (std::size_t i = 3; i < input.size(); ++i) upper_bits.emplace_back(all_bits.GetWire(i));
+      auto result{encrypto::motion::algorithm::HammingWeight(upper_bits)};
+      auto output{result.Out()};
+
+      party->Run();
+
+      auto computed_bvs{output.As<std::vector<encrypto::motion::BitVector<>>>()};
+      ASSERT_EQ(computed_bvs.size(), 3u);
+      std::size_t computed_value{0};
+      for (std::size_t bit_k = 0; bit_k < computed_bvs.size(); ++bit_k) {
+        if (computed_bvs[bit_k].Get(0)) computed_value += std::size_t(1) << bit_k;
+      }
+      EXPECT_EQ(computed_value, 4u);
+      party->Finish();
+    }));
+  }
+
+  for (auto& f : futures) f.get();
+}
+
+TEST(KoggeStoneAdditionCircuit, AddsOperandsInLogarithmicDepth) {
+  using encrypto::motion::PrimitiveOperationType;
+  std::mt19937_64 random(0);
+  for (std::size_t number_of_operands : {2, 3, 5}) {
+    for (std::size_t bit_length : {1, 3, 8, 32, 64}) {
+      const auto algorithm{encrypto::motion::algorithm::KoggeStoneAdditionCircuit(
+          number_of_operands, bit_length)};
+      ASSERT_EQ(algorithm.number_of_wires,
+                number_of_operands * bit_length + algorithm.gates.size());
+      ASSERT_EQ(algorithm.number_of_output_wires, bit_length);
+
+      // the AND depth is logarithmic in the number of operands and bits
+      std::vector<std::size_t> depths(algorithm.number_of_wires, 0);
+      for (const auto& gate : algorithm.gates) {
+        const std::size_t is_and{gate.type == PrimitiveOperationType::kAnd ? 1u : 0u};
+        depths.at(gate.output_wire) =
+            std::max(depths.at(gate.parent_a), depths.at(*gate.parent_b)) + is_and;
+      }
+      const std::size_t adder_depth{
+          bit_length > 1 ? std::bit_width(bit_length - 2) + std::size_t(1) : std::size_t(0)};
+      EXPECT_LE(*std::max_element(depths.begin(), depths.end()),
+                std::bit_width(number_of_operands - 1) * adder_depth);
+
+      for (std::size_t test_i = 0; test_i < 10; ++test_i) {
+        std::vector<bool> wires(algorithm.number_of_wires);
+        std::uint64_t sum{0};
+        for (std::size_t operand_i = 0; operand_i < number_of_operands; ++operand_i) {
+          const std::uint64_t operand{random()};
+          sum += operand;
+          for (std::size_t bit_i = 0; bit_i < bit_length; ++bit_i) {
+            wires[operand_i * bit_length + bit_i] = (operand >> bit_i) & 1;
+          }
+        }
+        for (const auto& gate : algorithm.gates) {
+          const bool a{wires.at(gate.parent_a)}, b{wires.at(*gate.parent_b)};
+          wires.at(gate.output_wire) = gate.type == PrimitiveOperationType::kAnd ? a && b : a != b;
+        }
+        for (std::size_t bit_i = 0; bit_i < bit_length; ++bit_i) {
+          EXPECT_EQ(wires.at(algorithm.number_of_wires - bit_length + bit_i), (sum >> bit_i) & 1);
+        }
+      }
+    }
+  }
+}
+
+
+TEST(IntegerCircuit, ComputesUnsignedOperationsForAnyBitLength) {
+  using encrypto::motion::IntegerOperationType;
+  using encrypto::motion::PrimitiveOperationType;
+  using encrypto::motion::algorithm::IntegerCircuitOptimization;
+  std::mt19937_64 random(0);
+  for (auto optimization :
+       {IntegerCircuitOptimization::kSize, IntegerCircuitOptimization::kDepth}) {
+    for (auto type : {IntegerOperationType::kAdd, IntegerOperationType::kSub,
+                      IntegerOperationType::kMul, IntegerOperationType::kDiv,
+                      IntegerOperationType::kGt, IntegerOperationType::kEq}) {
+      for (std::size_t bit_length : {1, 3, 8, 13, 32, 64}) {
+        const auto algorithm{
+            encrypto::motion::algorithm::IntegerCircuit(type, bit_length, optimization)};
+        ASSERT_EQ(algorithm.number_of_wires, 2 * bit_length + algorithm.gates.size());
+        const bool is_comparison{type == IntegerOperationType::kGt ||
+                                 type == IntegerOperationType::kEq};
+        const std::size_t number_of_outputs{is_comparison ? 1 : bit_length};
+        ASSERT_EQ(algorithm.number_of_output_wires, number_of_outputs);
+
+        std::vector<std::size_t> depths(algorithm.number_of_wires, 0);
+        for (const auto& gate : algorithm.gates) {
+          const std::size_t is_and{gate.type == PrimitiveOperationType::kAnd ? 1u : 0u};
+          const std::size_t depth_b{gate.parent_b ? depths.at(*gate.parent_b) : 0};
+          depths.at(gate.output_wire) = std::max(depths.at(gate.parent_a), depth_b) + is_and;
+        }
+        // the parallel-prefix adders need the carries into the bits 1, ..., bit_length - 1 and
+        // the comparators the carry out of all bit_length bits
+        if (optimization == IntegerCircuitOptimization::kDepth &&
+            type != IntegerOperationType::kMul && type != IntegerOperationType::kDiv) {
+          EXPECT_LE(*std::max_element(depths.begin(), depths.end()),
+                    std::bit_width(is_comparison ? bit_length : bit_length - 1));
+        }
+
+        const std::uint64_t mask{bit_length == 64 ? ~std::uint64_t(0)
+                                                  : (std::uint64_t(1) << bit_length) - 1};
+        for (std::size_t test_i = 0; test_i < 20; ++test_i) {
+          const std::uint64_t a{random() & mask};
+          // also divide by zero and compare equal operands
+          const std::uint64_t b{test_i == 0 ? 0 : test_i == 1 ? a : random() & mask};
+          std::vector<bool> wires(algorithm.number_of_wires);
+          for (std::size_t bit_i = 0; bit_i < bit_length; ++bit_i) {
+            wires[bit_i] = (a >> bit_i) & 1;
+            wires[bit_length + bit_i] = (b >> bit_i) & 1;
+          }
+          for (const auto& gate : algorithm.gates) {
+            const bool x{wires.at(gate.parent_a)};
+            const bool y{gate.parent_b ? wires.at(*gate.parent_b) : false};
+            switch (gate.type) {
+              case PrimitiveOperationType::kAnd:
+                wires.at(gate.output_wire) = x && y;
+                break;
+              case PrimitiveOperationType::kXor:
+                wires.at(gate.output_wire) = x != y;
+                break;
+              case PrimitiveOperationType::kInv:
+                wires.at(gate.output_wire) = !x;
+                break;
+              default:
+                FAIL() << "unexpected gate type";
+            }
+          }
+          std::uint64_t expected{0};
+          switch (type) {
+            case IntegerOperationType::kAdd:
+              expected = (a + b) & mask;
+              break;
+            case IntegerOperationType::kSub:
+              expected = (a - b) & mask;
+              break;
+            case IntegerOperationType::kMul:
+              expected = (a * b) & mask;
+              break;
+            case IntegerOperationType::kDiv:
+              expected = b == 0 ? mask : a / b;
+              break;
+            case IntegerOperationType::kGt:
+              expected = a > b;
+              break;
+            default:
+              expected = a == b;
+          }
+          std::uint64_t result{0};
+          for (std::size_t bit_i = 0; bit_i < number_of_outputs; ++bit_i) {
+            result |= std::uint64_t(wires.at(algorithm.number_of_wires - number_of_outputs + bit_i))
+                      << bit_i;
+          }
+          EXPECT_EQ(result, expected);
+        }
+      }
+    }
+  }
+}
+
+TEST(IntegerDivisionByConstantCircuit, DividesByPublicDivisorsAndNormalizes) {
+  using encrypto::motion::PrimitiveOperationType;
+  using encrypto::motion::algorithm::IntegerCircuitOptimization;
+  std::mt19937_64 random(0);
+  // evaluates the circuit with the input wires of x and returns the output wires
+  auto evaluate = [](const encrypto::motion::AlgorithmDescription& algorithm, std::uint64_t x) {
+    std::vector<bool> wires(algorithm.number_of_wires);
+    for (std::size_t bit_i = 0; bit_i < algorithm.number_of_input_wires_parent_a; ++bit_i) {
+      wires[bit_i] = (x >> bit_i) & 1;
+    }
+    for (const auto& gate : algorithm.gates) {
+      const bool a{wires.at(gate.parent_a)};
+      const bool b{gate.parent_b ? wires.at(*gate.parent_b) : false};
+      wires.at(gate.output_wire) = gate.type == PrimitiveOperationType::kAnd   ? a && b
+                                   : gate.type == PrimitiveOperationType::kOr  ? a || b
+                                   : gate.type == PrimitiveOperationType::kXor ? a != b
+                                                                               : !a;
+    }
+    std::uint64_t result{0};
+    for (std::size_t bit_i = 0; bit_i < algorithm.number_of_output_wires; ++bit_i) {
+      result |= std::uint64_t(
+                    wires.at(algorithm.number_of_wires - algorithm.number_of_output_wires + bit_i))
+                << bit_i;
+    }
+    return result;
+  };
+  for (auto optimization :
+       {IntegerCircuitOptimization::kSize, IntegerCircuitOptimization::kDepth}) {
+    for (std::size_t bit_length : {1, 5, 8, 32, 64}) {
+      const std::uint64_t mask{bit_length == 64 ? ~std::uint64_t(0)
+                                                : (std::uint64_t(1) << bit_length) - 1};
+      for (std::uint64_t divisor : {std::uint64_t(1), std::uint64_t(3), std::uint64_t(10),
+                                    std::uint64_t(16), std::uint64_t(65537), ~std::uint64_t(0)}) {
+        if ((divisor & mask) != divisor) {
+          EXPECT_THROW(encrypto::motion::algorithm::IntegerDivisionByConstantCircuit(
+                           divisor, bit_length, optimization),
+                       std::invalid_argument);
+          continue;
+        }
+        const auto algorithm{encrypto::motion::algorithm::IntegerDivisionByConstantCircuit(
+            divisor, bit_length, optimization)};
+        ASSERT_EQ(algorithm.number_of_output_wires, bit_length);
+        for (std::size_t test_i = 0; test_i < 50; ++test_i) {
+          const std::uint64_t x{test_i == 0 ? mask : random() & mask};
+          EXPECT_EQ(evaluate(algorithm, x), x / divisor) << x << " / " << divisor;
+        }
+      }
+    }
+    for (std::size_t number_of_scale_bits : {1, 14, 30}) {
+      const auto algorithm{encrypto::motion::algorithm::IntegerNormalizationCircuit(
+          64, number_of_scale_bits, optimization)};
+      ASSERT_EQ(algorithm.number_of_output_wires, number_of_scale_bits);
+      for (std::size_t test_i = 0; test_i < 50; ++test_i) {
+        // the upper bits are ignored
+        const std::uint64_t x{test_i < 2 ? test_i : random() >> (64 - number_of_scale_bits)};
+        const std::uint64_t upper_bits{random() << number_of_scale_bits};
+        const std::size_t bit_width{std::max<std::size_t>(std::bit_width(x), 1)};
+        const std::uint64_t scale{std::uint64_t(1) << (number_of_scale_bits - bit_width)};
+        EXPECT_EQ(evaluate(algorithm, x | upper_bits), scale) << x;
+      }
+    }
+  }
+}
+
+// the IEEE-754 result of the circuits, which flush subnormal numbers to zero and have a single NaN
+float FlushToZero(float x) {
+  return std::fpclassify(x) == FP_SUBNORMAL ? std::copysign(0.0f, x) : x;
+}
+
+float ExpectedFloatingPointResult(encrypto::motion::FloatingPointOperationType type, float a,
+                                  float b) {
+  using encrypto::motion::FloatingPointOperationType;
+  a = FlushToZero(a);
+  b = FlushToZero(b);
+  float result;
+  switch (type) {
+    case FloatingPointOperationType::kAdd:
+      result = a + b;
+      break;
+    case FloatingPointOperationType::kSub:
+      result = a - b;
+      break;
+    case FloatingPointOperationType::kMul:
+      result = a * b;
+      break;
+    case FloatingPointOperationType::kDiv:
+      result = a / b;
+      break;
+    case FloatingPointOperationType::kSqrt:
+      result = std::sqrt(a);
+      break;
+    case FloatingPointOperationType::kLt:
+      return a < b;
+    case FloatingPointOperationType::kLe:
+      return a <= b;
+    default:
+      return a == b;
+  }
+  return std::isnan(result) ? std::bit_cast<float>(0x7FC00000u) : FlushToZero(result);
+}
+
+TEST(FloatingPointCircuit, ComputesIeee754Operations) {
+  using encrypto::motion::FloatingPointOperationType;
+  using encrypto::motion::PrimitiveOperationType;
+  using encrypto::motion::algorithm::IntegerCircuitOptimization;
+  const std::vector<std::uint32_t> special_values{
+      0x00000000, 0x80000000, 0x7F800000, 0xFF800000, 0x7FC00000, 0x3F800000, 0xBF800000,
+      0x00000001, 0x807FFFFF, 0x7F7FFFFF, 0x00800000, 0x80800000, 0x3F800001, 0x4B000000};
+  std::mt19937 random(0);
+  for (auto optimization :
+       {IntegerCircuitOptimization::kSize, IntegerCircuitOptimization::kDepth}) {
+    for (auto type : {FloatingPointOperationType::kAdd, FloatingPointOperationType::kSub,
+                      FloatingPointOperationType::kMul, FloatingPointOperationType::kDiv,
+                      FloatingPointOperationType::kSqrt, FloatingPointOperationType::kLt,
+                      FloatingPointOperationType::kLe, FloatingPointOperationType::kEq}) {
+      const auto algorithm{encrypto::motion::algorithm::FloatingPointCircuit(type, optimization)};
+      const bool is_unary{type == FloatingPointOperationType::kSqrt};
+      ASSERT_EQ(algorithm.number_of_input_wires_parent_b.has_value(), !is_unary);
+      const std::size_t number_of_inputs{is_unary ? 32u : 64u};
+      ASSERT_EQ(algorithm.number_of_wires, number_of_inputs + algorithm.gates.size());
+      const bool is_comparison{algorithm.number_of_output_wires == 1};
+
+      auto check = [&](std::uint32_t a, std::uint32_t b) {
+        std::vector<bool> wires(algorithm.number_of_wires);
+        for (std::size_t bit_i = 0; bit_i < 32; ++bit_i) {
+          wires[bit_i] = (a >> bit_i) & 1;
+          if (!is_unary) wires[32 + bit_i] = (b >> bit_i) & 1;
+        }
+        for (const auto& gate : algorithm.gates) {
+          const bool x{wires.at(gate.parent_a)};
+          const bool y{gate.parent_b ? wires.at(*gate.parent_b) : false};
+          wires.at(gate.output_wire) = gate.type == PrimitiveOperationType::kAnd   ? x && y
+                                       : gate.type == PrimitiveOperationType::kXor ? x != y
+                                                                                   : !x;
+        }
+        std::uint32_t result{0};
+        for (std::size_t bit_i = 0; bit_i < algorithm.number_of_output_wires; ++bit_i) {
+          result |= std::uint32_t(wires.at(algorithm.number_of_wires -
+                                           algorithm.number_of_output_wires + bit_i))
+                    << bit_i;
+        }
+        const float expected{ExpectedFloatingPointResult(type, std::bit_cast<float>(a),
+                                                         std::bit_cast<float>(b))};
+        EXPECT_EQ(result, is_comparison ? std::uint32_t(expected)
+                                        : std::bit_cast<std::uint32_t>(expected))
+            << to_string(type) << std::hex << " a = " << a << " b = " << b;
+      };
+      for (const auto a : special_values) {
+        for (const auto b : special_values) check(a, b);
+      }
+      for (std::size_t test_i = 0; test_i < 200; ++test_i) {
+        const std::uint32_t a{static_cast<std::uint32_t>(random())};
+        // also operands with equal or close exponents
+        const auto b{static_cast<std::uint32_t>(
+            test_i % 2 == 0 ? random() : (a & 0xFF800000) ^ (random() & 0x807FFFFF))};
+        check(a, b);
+      }
+    }
+  }
+}
+
+TEST(ArrayCircuit, ReadsAndWritesAtSecretIndices) {
+  using encrypto::motion::PrimitiveOperationType;
+  std::mt19937_64 random(0);
+  auto evaluate = [](const encrypto::motion::AlgorithmDescription& algorithm,
+                     const std::vector<bool>& inputs) {
+    std::vector<bool> wires(algorithm.number_of_wires);
+    std::copy(inputs.begin(), inputs.end(), wires.begin());
+    for (const auto& gate : algorithm.gates) {
+      const bool a{wires.at(gate.parent_a)};
+      const bool b{gate.parent_b ? wires.at(*gate.parent_b) : false};
+      wires.at(gate.output_wire) = gate.type == PrimitiveOperationType::kAnd   ? a && b
+                                   : gate.type == PrimitiveOperationType::kOr  ? a || b
+                                   : gate.type == PrimitiveOperationType::kXor ? a != b
+                                                                               : !a;
+    }
+    return std::vector<bool>(wires.end() - algorithm.number_of_output_wires, wires.end());
+  };
+  auto append = [](std::vector<bool>& bits, std::uint64_t value, std::size_t bit_length) {
+    for (std::size_t bit_i = 0; bit_i < bit_length; ++bit_i) bits.push_back((value >> bit_i) & 1);
+  };
+  for (auto [number_of_elements, element_bit_length, index_bit_length] :
+       {std::tuple<std::size_t, std::size_t, std::size_t>{1, 3, 1}, {5, 4, 3}, {8, 1, 5},
+        {13, 7, 4}}) {
+    EXPECT_THROW(encrypto::motion::algorithm::ArrayReadCircuit(
+                     (std::size_t(1) << index_bit_length) + 1, element_bit_length,
+                     index_bit_length),
+                 std::invalid_argument);
+    const auto read{encrypto::motion::algorithm::ArrayReadCircuit(
+        number_of_elements, element_bit_length, index_bit_length)};
+    const auto write{encrypto::motion::algorithm::ArrayWriteCircuit(
+        number_of_elements, element_bit_length, index_bit_length)};
+    EXPECT_EQ(read.number_of_output_wires, element_bit_length);
+    EXPECT_EQ(write.number_of_output_wires, number_of_elements * element_bit_length);
+    std::vector<bool> elements;
+    for (std::size_t j = 0; j < number_of_elements; ++j) {
+      append(elements, random(), element_bit_length);
+    }
+    const std::vector<bool> value(element_bit_length, true);
+    for (std::size_t index = 0; index < (std::size_t(1) << index_bit_length); ++index) {
+      std::vector<bool> read_input;
+      append(read_input, index, index_bit_length);
+      read_input.insert(read_input.end(), elements.begin(), elements.end());
+      std::vector<bool> expected_element(element_bit_length, false), expected_elements{elements};
+      if (index < number_of_elements) {
+        const auto begin{elements.begin() + index * element_bit_length};
+        expected_element.assign(begin, begin + element_bit_length);
+        std::fill_n(expected_elements.begin() + index * element_bit_length, element_bit_length,
+                    true);
+      }
+      EXPECT_EQ(evaluate(read, read_input), expected_element);
+
+      std::vector<bool> write_input;
+      append(write_input, index, index_bit_length);
+      write_input.insert(write_input.end(), value.begin(), value.end());
+      write_input.insert(write_input.end(), elements.begin(), elements.end());
+      EXPECT_EQ(evaluate(write, write_input), expected_elements);
+    }
+  }
+}
+
+TEST(SecureFloatingPoint, ComputesOnSimdValuesInBooleanGmwAndBmr) {
+  using encrypto::motion::FloatingPointOperationType;
+  using encrypto::motion::MpcProtocol;
+  constexpr std::size_t kNumberOfSimd{5};
+  const std::vector<float> a{1.5f, -2.25f, 1e30f, 3.0f, 0.0f}, b{0.75f, 4.0f, 1e10f, 3.0f, -0.0f};
+  std::vector<std::uint32_t> raw_a(kNumberOfSimd), raw_b(kNumberOfSimd);
+  auto to_bits = [](float value) { return std::bit_cast<std::uint32_t>(value); };
+  std::transform(a.begin(), a.end(), raw_a.begin(), to_bits);
+  std::transform(b.begin(), b.end(), raw_b.begin(), to_bits);
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      32, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+  for (const auto protocol : {MpcProtocol::kBooleanGmw, MpcProtocol::kBmr}) {
+    auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+    for (auto& party : parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(true);
+    }
+#pragma omp parallel for num_threads(parties.size() + 1)
+    for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+      auto& party{parties.at(party_id)};
+      auto input = [&](const std::vector<std::uint32_t>& values, std::size_t owner) {
+        const auto bits{party_id == owner ? encrypto::motion::ToInput(values) : dummy_input};
+        return protocol == MpcProtocol::kBooleanGmw
+                   ? party->In<MpcProtocol::kBooleanGmw>(bits, owner)
+                   : party->In<MpcProtocol::kBmr>(bits, owner);
+      };
+      const encrypto::motion::SecureFloatingPoint x{input(raw_a, 0)}, y{input(raw_b, 1)};
+      const auto sum{(x + y).Out()}, difference{(x - y).Out()}, product{(x * y).Out()},
+          quotient{(x / y).Out()}, root{x.Sqrt().Out()};
+      const auto is_less{(x < y).Out()}, is_greater_equal{(x >= y).Out()},
+          is_equal{(x == y).Out()};
+
+      party->Run();
+
+      for (auto [type, output] : {std::pair{FloatingPointOperationType::kAdd, sum},
+                                  std::pair{FloatingPointOperationType::kSub, difference},
+                                  std::pair{FloatingPointOperationType::kMul, product},
+                                  std::pair{FloatingPointOperationType::kDiv, quotient},
+                                  std::pair{FloatingPointOperationType::kSqrt, root}}) {
+        const auto result{output.As<std::vector<float>>()};
+        EXPECT_EQ(result.size(), kNumberOfSimd);
+        for (std::size_t simd_i = 0; simd_i < result.size(); ++simd_i) {
+          EXPECT_EQ(std::bit_cast<std::uint32_t>(result[simd_i]),
+                    std::bit_cast<std::uint32_t>(
+                        ExpectedFloatingPointResult(type, a[simd_i], b[simd_i])));
+        }
+      }
+      for (std::size_t simd_i = 0; simd_i < kNumberOfSimd; ++simd_i) {
+        EXPECT_EQ(is_less.As<encrypto::motion::BitVector<>>().Get(simd_i), a[simd_i] < b[simd_i]);
+        EXPECT_EQ(is_greater_equal.As<encrypto::motion::BitVector<>>().Get(simd_i),
+                  a[simd_i] >= b[simd_i]);
+        EXPECT_EQ(is_equal.As<encrypto::motion::BitVector<>>().Get(simd_i),
+                  a[simd_i] == b[simd_i]);
+      }
+      party->Finish();
+    }
+  }
+}
+
+TEST(SecureArray, ReadsAndWritesInBooleanGmwAndBmr) {
+  using encrypto::motion::MpcProtocol;
+  constexpr std::size_t kNumberOfSimd{3};
+  std::mt19937_64 random(0);
+  // 300 elements need a 9-bit index and two levels of OTs in Boolean GMW
+  for (const std::size_t number_of_elements : {5, 300}) {
+    const std::size_t mask{(std::size_t(1) << std::bit_width(number_of_elements - 1)) - 1};
+    std::vector<std::vector<std::uint8_t>> elements(number_of_elements,
+                                                    std::vector<std::uint8_t>(kNumberOfSimd));
+    for (auto& element : elements) {
+      for (auto& value : element) value = random();
+    }
+    // the indices of the reads and writes, of which only the lower bits are used
+    const std::vector<std::uint16_t> read_index{3, 6, std::uint16_t(mask + 2)},
+        write_index{4, 7, 0};
+    const std::vector<std::uint8_t> value{200, 201, 202};
+    const std::vector<encrypto::motion::BitVector<>> dummy_element(
+        8, encrypto::motion::BitVector<>(kNumberOfSimd, false)),
+        dummy_index(16, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+    for (const auto protocol : {MpcProtocol::kBooleanGmw, MpcProtocol::kBmr}) {
+      auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+      for (auto& party : parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetOnlineAfterSetup(true);
+      }
+#pragma omp parallel for num_threads(parties.size() + 1)
+      for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+        auto& party{parties.at(party_id)};
+        auto input = [&](const auto& values, const auto& dummy, std::size_t owner) {
+          const auto bits{party_id == owner ? encrypto::motion::ToInput(values) : dummy};
+          return encrypto::motion::ShareWrapper(
+              protocol == MpcProtocol::kBooleanGmw
+                  ? party->In<MpcProtocol::kBooleanGmw>(bits, owner)
+                  : party->In<MpcProtocol::kBmr>(bits, owner));
+        };
+        std::vector<encrypto::motion::ShareWrapper> element_shares;
+        for (const auto& element : elements) {
+          element_shares.emplace_back(input(element, dummy_element, 0));
+        }
+        encrypto::motion::SecureArray array(std::move(element_shares));
+        const auto read{array.Read(input(read_index, dummy_index, 1)).Out()};
+        array.Write(input(write_index, dummy_index, 1), input(value, dummy_element, 0));
+        const auto read_after_write{array.Read(input(write_index, dummy_index, 1)).Out()};
+        const auto public_read{array.Read(std::size_t(1)).Out()};
+
+        party->Run();
+
+        for (std::size_t simd_i = 0; simd_i < kNumberOfSimd; ++simd_i) {
+          const std::size_t index{read_index[simd_i] & mask};
+          EXPECT_EQ(encrypto::motion::ToVectorOutput<std::uint8_t>(
+                        read.As<std::vector<encrypto::motion::BitVector<>>>())[simd_i],
+                    index < number_of_elements ? elements[index][simd_i] : 0);
+          const std::size_t written_index{write_index[simd_i] & mask};
+          EXPECT_EQ(encrypto::motion::ToVectorOutput<std::uint8_t>(
+                        read_after_write.As<std::vector<encrypto::motion::BitVector<>>>())[simd_i],
+                    written_index < number_of_elements ? value[simd_i] : 0);
+          EXPECT_EQ(encrypto::motion::ToVectorOutput<std::uint8_t>(
+                        public_read.As<std::vector<encrypto::motion::BitVector<>>>())[simd_i],
+                    written_index == 1 ? value[simd_i] : elements[1][simd_i]);
+        }
+        party->Finish();
+      }
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,302 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/circuit_optimizer.h"
+#include "algorithm/circuit_schedule.h"
+#include "algorithm/flat_circuit.h"
+#include "base/configuration.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/config.h"
+
+namespace {
+
+using encrypto::motion::AlgorithmDescription;
+using encrypto::motion::AlgorithmOptimizationStatistics;
+using encrypto::motion::OptimizeAlgorithmDescription;
+using encrypto::motion::PrimitiveOperation;
+using Type = encrypto::motion::PrimitiveOperationType;
+
+// evaluates the Boolean circuit algorithm in the clear
+std::vector<bool> EvaluateInTheClear(const AlgorithmDescription& algorithm,
+                                     const std::vector<bool>& inputs) {
+  std::vector<bool> wires(algorithm.number_of_wires);
+  std::copy(inputs.begin(), inputs.end(), wires.begin());
+  for (const auto& gate : algorithm.gates) {
+    const bool a{wires.at(gate.parent_a)};
+    const bool b{gate.parent_b ? static_cast<bool>(wires.at(*gate.parent_b)) : false};
+    switch (gate.type) {
+      case Type::kXor:
+        wires.at(gate.output_wire) = a != b;
+        break;
+      case Type::kAnd:
+        wires.at(gate.output_wire) = a && b;
+        break;
+      case Type::kOr:
+        wires.at(gate.output_wire) = a || b;
+        break;
+      case Type::kInv:
+        wires.at(gate.output_wire) = !a;
+        break;
+      default:
+        throw std::invalid_argument("Unsupported gate");
+    }
+  }
+  return std::vector<bool>(wires.end() - algorithm.number_of_output_wires, wires.end());
+}
+
+AlgorithmDescription MakeAlgorithm(std::size_t number_of_inputs,
+                                   std::vector<PrimitiveOperation>&& gates,
+                                   std::size_t number_of_outputs) {
+  AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = number_of_inputs;
+  algorithm.number_of_output_wires = number_of_outputs;
+  algorithm.number_of_gates = gates.size();
+  algorithm.number_of_wires = number_of_inputs + gates.size();
+  algorithm.gates = std::move(gates);
+  return algorithm;
+}
+
+std::vector<bool> ToBits(std::size_t value, std::size_t number_of_bits) {
+  std::vector<bool> bits(number_of_bits);
+  for (std::size_t i = 0; i < number_of_bits; ++i) bits[i] = (value >> i) & 1;
+  return bits;
+}
+
+void ExpectOptimizedTo(const AlgorithmDescription& algorithm, std::size_t number_of_and_gates) {
+  AlgorithmOptimizationStatistics statistics;
+  const auto optimized{OptimizeAlgorithmDescription(algorithm, &statistics)};
+  EXPECT_EQ(statistics.number_of_and_gates_before,
+            encrypto::motion::GetNumberOfAndGates(algorithm));
+  EXPECT_EQ(statistics.number_of_and_gates_after, number_of_and_gates);
+  EXPECT_EQ(encrypto::motion::GetNumberOfAndGates(optimized), number_of_and_gates);
+  EXPECT_EQ(statistics.number_of_gates_after, optimized.gates.size());
+  EXPECT_EQ(optimized.number_of_output_wires, algorithm.number_of_output_wires);
+  EXPECT_EQ(optimized.number_of_wires,
+            optimized.number_of_input_wires_parent_a + optimized.number_of_gates);
+  const std::size_t number_of_inputs{algorithm.number_of_input_wires_parent_a};
+  for (std::size_t value = 0; value < (std::size_t(1) << number_of_inputs); ++value) {
+    const auto inputs{ToBits(value, number_of_inputs)};
+    EXPECT_EQ(EvaluateInTheClear(optimized, inputs), EvaluateInTheClear(algorithm, inputs));
+  }
+}
+
+TEST(CircuitOptimizer, RewritesIdioms) {
+  // (s AND a) XOR (NOT s AND b) for s, a, b = 0, 1, 2
+  ExpectOptimizedTo(MakeAlgorithm(3,
+                                  {{Type::kAnd, 0, 1, std::nullopt, 3},
+                                   {Type::kInv, 0, std::nullopt, std::nullopt, 4},
+                                   {Type::kAnd, 4, 2, std::nullopt, 5},
+                                   {Type::kXor, 3, 5, std::nullopt, 6}},
+                                  1),
+                    1);
+  // the same multiplexer with OR
+  ExpectOptimizedTo(MakeAlgorithm(3,
+                                  {{Type::kAnd, 0, 1, std::nullopt, 3},
+                                   {Type::kInv, 0, std::nullopt, std::nullopt, 4},
+                                   {Type::kAnd, 4, 2, std::nullopt, 5},
+                                   {Type::kOr, 3, 5, std::nullopt, 6}},
+                                  1),
+                    1);
+  // majority (a AND b) XOR (a AND c) XOR (b AND c)
+  ExpectOptimizedTo(MakeAlgorithm(3,
+                                  {{Type::kAnd, 0, 1, std::nullopt, 3},
+                                   {Type::kAnd, 0, 2, std::nullopt, 4},
+                                   {Type::kAnd, 1, 2, std::nullopt, 5},
+                                   {Type::kXor, 3, 4, std::nullopt, 6},
+                                   {Type::kXor, 5, 6, std::nullopt, 7}},
+                                  1),
+                    1);
+  // (a AND b) XOR (a AND c) is only rewritten if a AND b is not an output as well
+  ExpectOptimizedTo(MakeAlgorithm(3,
+                                  {{Type::kAnd, 0, 1, std::nullopt, 3},
+                                   {Type::kAnd, 0, 2, std::nullopt, 4},
+                                   {Type::kXor, 3, 4, std::nullopt, 5}},
+                                  1),
+                    1);
+  ExpectOptimizedTo(MakeAlgorithm(3,
+                                  {{Type::kAnd, 0, 1, std::nullopt, 3},
+                                   {Type::kAnd, 0, 2, std::nullopt, 4},
+                                   {Type::kXor, 3, 3, std::nullopt, 5},
+                                   {Type::kXor, 3, 5, std::nullopt, 6},
+                                   {Type::kXor, 3, 4, std::nullopt, 7}},
+                                  2),
+                    2);
+}
+
+TEST(CircuitOptimizer, PropagatesConstantsAndMergesSubexpressions) {
+  // a XOR a = 0, b AND 0 = 0, NOT 0 = 1, 1 AND c = c, and b AND c twice
+  ExpectOptimizedTo(MakeAlgorithm(3,
+                                  {{Type::kXor, 0, 0, std::nullopt, 3},
+                                   {Type::kAnd, 1, 3, std::nullopt, 4},
+                                   {Type::kInv, 4, std::nullopt, std::nullopt, 5},
+                                   {Type::kAnd, 5, 2, std::nullopt, 6},
+                                   {Type::kAnd, 1, 2, std::nullopt, 7},
+                                   {Type::kAnd, 2, 1, std::nullopt, 8},
+                                   {Type::kOr, 0, 0, std::nullopt, 9},
+                                   {Type::kXor, 7, 8, std::nullopt, 10},
+                                   {Type::kInv, 7, std::nullopt, std::nullopt, 11},
+                                   {Type::kInv, 3, std::nullopt, std::nullopt, 12},
+                                   {Type::kAnd, 8, 7, std::nullopt, 13}},
+                                  7),
+                    1);
+}
+
+TEST(CircuitOptimizer, BristolCircuitsStayEquivalent) {
+  const std::string circuits{std::string(encrypto::motion::kRootDir) + "/circuits/"};
+  for (const auto& path : {"int/int_add32_depth.bristol", "int/int_div16_size.bristol",
+                           "float/float_mul32_depth.bristol", "advanced/aes_128.bristol"}) {
+    const auto algorithm{AlgorithmDescription::FromBristol(circuits + path)};
+    AlgorithmOptimizationStatistics statistics;
+    const auto optimized{OptimizeAlgorithmDescription(algorithm, &statistics)};
+    EXPECT_LE(statistics.number_of_and_gates_after, statistics.number_of_and_gates_before);
+    const std::size_t number_of_inputs{algorithm.number_of_input_wires_parent_a +
+                                       *algorithm.number_of_input_wires_parent_b};
+    std::mt19937 random(0);
+    for (std::size_t i = 0; i < 20; ++i) {
+      std::vector<bool> inputs(number_of_inputs);
+      for (std::size_t j = 0; j < number_of_inputs; ++j) inputs[j] = random() & 1;
+      ASSERT_EQ(EvaluateInTheClear(optimized, inputs), EvaluateInTheClear(algorithm, inputs))
+          << path;
+    }
+  }
+  // the depth-optimized adder contains a majority of a generate and a propagated carry per bit
+  const auto adder{AlgorithmDescription::FromBristol(circuits + "int/int_add32_depth.bristol")};
+  EXPECT_LT(encrypto::motion::GetNumberOfAndGates(OptimizeAlgorithmDescription(adder)),
+            encrypto::motion::GetNumberOfAndGates(adder));
+}
+
+TEST(CircuitOptimizer, EvaluateOptimizedAlgorithm) {
+  constexpr std::size_t kNumberOfSimd{10};
+  const auto adder{AlgorithmDescription::FromBristol(std::string(encrypto::motion::kRootDir) +
+                                                     "/circuits/int/int_add8_depth.bristol")};
+  std::mt19937 random(0);
+  std::vector<encrypto::motion::BitVector<>> inputs(16);
+  for (auto& input : inputs) {
+    input = encrypto::motion::BitVector<>(kNumberOfSimd);
+    for (std::size_t i = 0; i < kNumberOfSimd; ++i) input.Set(random() & 1, i);
+  }
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &parties, &adder, &inputs] {
+      auto& party{parties[party_id]};
+      party->GetConfiguration()->SetOptimizeAlgorithms(true);
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      auto input_share{party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+          std::span<const encrypto::motion::BitVector<>>(inputs), 0)};
+      auto output{encrypto::motion::ShareWrapper(input_share).Evaluate(adder).Out()};
+      party->Run();
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        std::size_t a{0}, b{0}, sum{0};
+        for (std::size_t j = 0; j < 8; ++j) {
+          a |= static_cast<std::size_t>(inputs[j].Get(i)) << j;
+          b |= static_cast<std::size_t>(inputs[8 + j].Get(i)) << j;
+          sum |= static_cast<std::size_t>(
+                     output.GetWire(j).As<encrypto::motion::BitVector<>>().Get(i))
+                 << j;
+        }
+        EXPECT_EQ(sum, (a + b) % 256);
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(FlatCircuit, SortsOperationsIntoLayers) {
+  // c = a AND b, d = NOT c, e = d OR a, f = a XOR b
+  const auto algorithm{MakeAlgorithm(2,
+                                     {{Type::kAnd, 0, 1, std::nullopt, 2},
+                                      {Type::kInv, 2, std::nullopt, std::nullopt, 3},
+                                      {Type::kOr, 3, 0, std::nullopt, 4},
+                                      {Type::kXor, 0, 1, std::nullopt, 5}},
+                                     2)};
+  const auto circuit{encrypto::motion::FlatCircuit::FromAlgorithmDescription(algorithm)};
+  using Opcode = encrypto::motion::FlatCircuit::Opcode;
+  ASSERT_EQ(circuit.GetNumberOfLayers(), 3);
+  EXPECT_EQ(circuit.GetNumberOfOperations(), 4);
+  EXPECT_EQ(circuit.number_of_interactive_operations, 2);
+  EXPECT_EQ(circuit.GetNumberOfInteractiveOperations(0), 0);
+  EXPECT_EQ(circuit.GetNumberOfInteractiveOperations(1), 1);
+  EXPECT_EQ(circuit.GetNumberOfInteractiveOperations(2), 1);
+  EXPECT_TRUE(circuit.opcodes ==
+              (std::vector<Opcode>{Opcode::kXor, Opcode::kAnd, Opcode::kInv, Opcode::kOr}));
+  EXPECT_TRUE(circuit.outputs == (std::vector<std::uint32_t>{5, 2, 3, 4}));
+
+  auto unsupported{algorithm};
+  unsupported.gates[3].type = Type::kAdd;
+  EXPECT_THROW(encrypto::motion::FlatCircuit::FromAlgorithmDescription(unsupported),
+               std::invalid_argument);
+}
+
+TEST(CircuitSchedule, LayersWidthsAndLastUses) {
+  // c = a AND b, d = NOT c, e = d OR a, f = a XOR b
+  const auto algorithm{MakeAlgorithm(2,
+                                     {{Type::kAnd, 0, 1, std::nullopt, 2},
+                                      {Type::kInv, 2, std::nullopt, std::nullopt, 3},
+                                      {Type::kOr, 3, 0, std::nullopt, 4},
+                                      {Type::kXor, 0, 1, std::nullopt, 5}},
+                                     2)};
+  const auto schedule{algorithm.GetSchedule()};
+  ASSERT_EQ(schedule->GetNumberOfLayers(), 3);
+  EXPECT_EQ(schedule->GetMultiplicativeDepth(), 2);
+  EXPECT_TRUE(schedule->gate_layers == (std::vector<std::size_t>{1, 1, 2, 0}));
+  EXPECT_TRUE(schedule->wire_layers == (std::vector<std::size_t>{0, 0, 1, 1, 2, 0}));
+  EXPECT_TRUE(schedule->interactive_widths == (std::vector<std::size_t>{0, 1, 1}));
+  EXPECT_TRUE(schedule->local_widths == (std::vector<std::size_t>{1, 1, 0}));
+  EXPECT_TRUE(schedule->order == (std::vector<std::size_t>{3, 0, 1, 2}));
+  // the outputs 4 and 5 are used after the last layer
+  EXPECT_TRUE(schedule->last_use_layers ==
+              (std::vector<std::optional<std::size_t>>{2, 1, 1, 2, 3, 3}));
+}
+
+TEST(CircuitSchedule, ComputedOnceWhenLoaded) {
+  auto adder{AlgorithmDescription::FromBristol(std::string(encrypto::motion::kRootDir) +
+                                               "/circuits/int/int_add8_depth.bristol")};
+  ASSERT_TRUE(adder.schedule);
+  EXPECT_TRUE(adder.GetSchedule() == adder.schedule);
+  const auto circuit{encrypto::motion::FlatCircuit::FromAlgorithmDescription(adder)};
+  EXPECT_EQ(adder.schedule->GetNumberOfLayers(), circuit.GetNumberOfLayers());
+  EXPECT_EQ(adder.schedule->order.size(), adder.gates.size());
+
+  // a schedule that does not match the gates anymore is not used
+  adder.gates.push_back({Type::kXor, 0, 1, std::nullopt, adder.number_of_wires});
+  ++adder.number_of_wires;
+  const auto schedule{adder.GetSchedule()};
+  EXPECT_FALSE(schedule == adder.schedule);
+  EXPECT_EQ(schedule->GetNumberOfGates(), adder.gates.size());
+}
+
+}  // namespace
@@ -20,13 +20,31 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+
 #include <flatbuffers/flatbuffers.h>
 #include <gtest/gtest.h>
+#include <boost/json.hpp>
 #include <boost/log/trivial.hpp>
 
 #include "communication/communication_layer.h"
 #include "communication/message.h"
+#include "communication/message_buffer.h"
+#include "communication/message_compression.h"
 #include "communication/message_manager.h"
+#include "communication/message_priority.h"
+#include "statistics/analysis.h"
+#include "statistics/metrics.h"
+#include "statistics/timeline.h"
+#include "utility/constants.h"
 #include "utility/logger.h"
 
 namespace {
@@ -97,6 +115,666 @@ TEST(CommunicationLayer, Dummy) {
   std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
 }
 
+TEST(CommunicationLayer, MessageBufferPool) {
+  auto pool = std::make_shared<comm::MessageBufferPool>();
+  const std::uint8_t* data;
+  {
+    auto buffer{pool->Acquire(1024)};
+    EXPECT_EQ(buffer.size(), 1024);
+    data = buffer.data();
+    std::fill_n(buffer.data(), buffer.size(), 0x42);
+    // the sub buffer keeps the storage alive after the buffer itself was released
+    auto sub_buffer{buffer.GetSubBuffer(512, 16)};
+    buffer = comm::MessageBuffer();
+    EXPECT_EQ(sub_buffer.size(), 16);
+    EXPECT_EQ(sub_buffer.data(), data + 512);
+    EXPECT_EQ(sub_buffer[0], 0x42);
+  }
+  EXPECT_EQ(pool->GetNumberOfAllocations(), 1);
+  EXPECT_EQ(pool->GetNumberOfReuses(), 0);
+
+  // smaller and equally sized messages reuse the released storage
+  {
+    auto buffer{pool->Acquire(256)};
+    EXPECT_EQ(buffer.size(), 256);
+    EXPECT_EQ(buffer.data(), data);
+  }
+  EXPECT_EQ(pool->Acquire(1024).data(), data);
+  EXPECT_EQ(pool->GetNumberOfAllocations(), 1);
+  EXPECT_EQ(pool->GetNumberOfReuses(), 2);
+
+  // adopted buffers do not belong to the pool
+  comm::MessageBuffer adopted(std::vector<std::uint8_t>{0xde, 0xad, 0xbe, 0xef});
+  EXPECT_EQ(adopted.size(), 4);
+  EXPECT_EQ(adopted[3], 0xef);
+}
+
+TEST(CommunicationLayer, MessageFrameHeader) {
+  const std::vector<std::uint8_t> payload = {0xde, 0xad, 0xbe, 0xef};
+
+  auto bulk_message{comm::BuildMessage(comm::MessageType::kOtExtensionSender, 42, payload)};
+  auto header{comm::ReadMessageFrameHeader(
+      std::span(bulk_message.GetBufferPointer(), bulk_message.GetSize()))};
+  if constexpr (encrypto::motion::kFrameBulkMessages) {
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->message_type, comm::MessageType::kOtExtensionSender);
+    EXPECT_EQ(header->message_id, 42);
+    EXPECT_EQ(header->length + sizeof(comm::MessageFrameHeader), bulk_message.GetSize());
+    // the framed message is an ordinary Message
+    auto message{comm::GetMessage(bulk_message.GetBufferPointer() + sizeof(*header))};
+    EXPECT_EQ(message->message_id(), 42);
+    ASSERT_EQ(message->payload()->size(), payload.size());
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), message->payload()->begin()));
+  } else {
+    EXPECT_FALSE(header.has_value());
+  }
+
+  // control messages are never framed
+  auto control_message{comm::BuildMessage(comm::MessageType::kSynchronizationMessage, payload)};
+  EXPECT_FALSE(comm::ReadMessageFrameHeader(
+                   std::span(control_message.GetBufferPointer(), control_message.GetSize()))
+                   .has_value());
+}
+
+TEST(CommunicationLayer, OutgoingMessageEqualsBuiltMessage) {
+  std::vector<std::uint8_t> payload(1000);
+  std::iota(payload.begin(), payload.end(), 0);
+  for (auto message_type :
+       {comm::MessageType::kGarbledCircuitTableStream, comm::MessageType::kOutputMessage}) {
+    comm::OutgoingMessage outgoing_message(message_type, 7, payload.size());
+    ASSERT_EQ(outgoing_message.GetPayload().size(), payload.size());
+    // the payload is written in two halves, e.g., by two gates
+    std::copy_n(payload.begin(), 500, outgoing_message.GetPayload().begin());
+    std::copy(payload.begin() + 500, payload.end(), outgoing_message.GetPayload().begin() + 500);
+    auto in_place{std::move(outgoing_message).Finish()};
+    auto copied{comm::BuildMessage(message_type, 7, payload)};
+    ASSERT_EQ(in_place.GetSize(), copied.GetSize());
+    EXPECT_TRUE(std::equal(in_place.GetBufferPointer(),
+                           in_place.GetBufferPointer() + in_place.GetSize(),
+                           copied.GetBufferPointer()));
+  }
+}
+
+TEST(CommunicationLayer, MessageRoutingTable) {
+  comm::MessageRoutingTable routing_table;
+  constexpr std::size_t kNumberOfThreads = 4;
+  constexpr std::size_t kNumberOfIdsPerThread = 3 * comm::MessageRoutingTable::kChunkSize;
+  constexpr std::size_t kSparseId = comm::MessageRoutingTable::kMaxDenseMessageId + 42;
+
+  // register disjoint ranges of message ids concurrently
+  std::vector<std::future<std::vector<comm::MessageRoutingTable::future_type>>> futures;
+  for (std::size_t thread_id = 0; thread_id < kNumberOfThreads; ++thread_id) {
+    futures.emplace_back(std::async(std::launch::async, [&routing_table, thread_id] {
+      std::vector<comm::MessageRoutingTable::future_type> message_futures;
+      for (std::size_t i = 0; i < kNumberOfIdsPerThread; ++i) {
+        message_futures.emplace_back(routing_table.Register(
+            comm::MessageType::kOutputMessage, i * kNumberOfThreads + thread_id));
+      }
+      return message_futures;
+    }));
+  }
+  auto sparse_future{routing_table.Register(comm::MessageType::kOutputMessage, kSparseId)};
+  std::vector<std::vector<comm::MessageRoutingTable::future_type>> message_futures;
+  for (auto& future : futures) {
+    message_futures.emplace_back(future.get());
+  }
+
+  EXPECT_EQ(routing_table.Find(comm::MessageType::kBmrAndGate, 0), nullptr);
+  EXPECT_EQ(routing_table.Find(comm::MessageType::kOutputMessage,
+                               kNumberOfThreads * kNumberOfIdsPerThread),
+            nullptr);
+  EXPECT_EQ(routing_table.Find(comm::MessageType::kOutputMessage, kSparseId + 1), nullptr);
+
+  for (std::size_t id = 0; id < kNumberOfThreads * kNumberOfIdsPerThread; ++id) {
+    auto promise{routing_table.Find(comm::MessageType::kOutputMessage, id)};
+    ASSERT_NE(promise, nullptr);
+    promise->set_value(comm::MessageBuffer(std::vector<std::uint8_t>(id % 256 + 1)));
+  }
+  routing_table.Find(comm::MessageType::kOutputMessage, kSparseId)
+      ->set_value(comm::MessageBuffer(std::vector<std::uint8_t>(7)));
+
+  for (std::size_t thread_id = 0; thread_id < kNumberOfThreads; ++thread_id) {
+    for (std::size_t i = 0; i < kNumberOfIdsPerThread; ++i) {
+      const auto id{i * kNumberOfThreads + thread_id};
+      EXPECT_EQ(message_futures.at(thread_id).at(i).get().size(), id % 256 + 1);
+    }
+  }
+  EXPECT_EQ(sparse_future.get().size(), 7);
+
+  // registering again after the futures were destroyed reuses the promises
+  auto promise{routing_table.Find(comm::MessageType::kOutputMessage, 1)};
+  message_futures.clear();
+  auto future{routing_table.Register(comm::MessageType::kOutputMessage, 1)};
+  EXPECT_EQ(routing_table.Find(comm::MessageType::kOutputMessage, 1), promise);
+  promise->set_value(comm::MessageBuffer(std::vector<std::uint8_t>(3)));
+  EXPECT_EQ(future.get().size(), 3);
+}
+
+TEST(CommunicationLayer, MessageCompression) {
+  std::mt19937 random_number_generator(42);
+  std::vector<std::uint8_t> redundant_message(100000);
+  for (std::size_t i = 0; i < redundant_message.size(); i += 97) {
+    redundant_message[i] = static_cast<std::uint8_t>(random_number_generator());
+  }
+  std::vector<std::uint8_t> random_message(100000);
+  std::generate(random_message.begin(), random_message.end(),
+                [&random_number_generator] { return random_number_generator(); });
+
+  auto compressed_message{comm::CompressMessage(redundant_message, redundant_message.size())};
+  ASSERT_TRUE(compressed_message.has_value());
+  EXPECT_LT(compressed_message->size(), redundant_message.size() / 10);
+  auto header{comm::ReadCompressedMessageHeader(*compressed_message)};
+  ASSERT_TRUE(header.has_value());
+  ASSERT_EQ(header->uncompressed_length, redundant_message.size());
+  std::vector<std::uint8_t> decompressed_message(header->uncompressed_length);
+  comm::DecompressMessage(*compressed_message, decompressed_message);
+  EXPECT_EQ(decompressed_message, redundant_message);
+  EXPECT_FALSE(comm::CompressMessage(random_message, random_message.size()).has_value());
+
+  // truncated data is detected
+  compressed_message->pop_back();
+  EXPECT_THROW(comm::DecompressMessage(*compressed_message, decompressed_message),
+               std::runtime_error);
+
+  // compressed messages are transparent to the receiver
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  communication_layers.at(0)->SetMessageCompression(comm::MessageType::kOutputMessage,
+                                                    comm::MessageCompression::kAdaptive);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  auto& message_manager{communication_layers.at(1)->GetMessageManager()};
+  auto redundant_future{message_manager.RegisterReceive(0, comm::MessageType::kOutputMessage, 0)};
+  auto random_future{message_manager.RegisterReceive(0, comm::MessageType::kOutputMessage, 1)};
+  communication_layers.at(0)->SendMessage(
+      1, comm::BuildMessage(comm::MessageType::kOutputMessage, 0, redundant_message).Release());
+  communication_layers.at(0)->SendMessage(
+      1, comm::BuildMessage(comm::MessageType::kOutputMessage, 1, random_message).Release());
+  for (auto [future, message] : {std::pair{&redundant_future, &redundant_message},
+                                 std::pair{&random_future, &random_message}}) {
+    auto received_message{future->get()};
+    auto payload{comm::GetMessage(received_message.data())->payload()};
+    ASSERT_EQ(payload->size(), message->size());
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), message->begin()));
+  }
+
+  const auto statistics{communication_layers.at(1)->GetTransportStatistics().at(0)};
+  EXPECT_GT(statistics.number_of_uncompressed_bytes_received, redundant_message.size());
+  EXPECT_LT(statistics.number_of_compressed_bytes_received, redundant_message.size() / 10);
+  // the random message was sent uncompressed
+  EXPECT_GT(statistics.number_of_bytes_received, random_message.size());
+  EXPECT_LT(statistics.number_of_bytes_received,
+            random_message.size() + redundant_message.size() / 10);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, MessagePrioritization) {
+  std::mt19937 random_number_generator(42);
+  // bulk messages larger than a fragment, of which one compresses
+  std::vector<std::uint8_t> redundant_message(1 << 20);
+  for (std::size_t i = 0; i < redundant_message.size(); i += 97) {
+    redundant_message[i] = static_cast<std::uint8_t>(random_number_generator());
+  }
+  std::vector<std::uint8_t> random_message(300000);
+  std::generate(random_message.begin(), random_message.end(),
+                [&random_number_generator] { return random_number_generator(); });
+  std::vector<std::uint8_t> small_message(100, 42);
+
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  communication_layers.at(0)->SetMessagePrioritization(true);
+  communication_layers.at(0)->SetMessageCompression(comm::MessageType::kOtExtensionSender,
+                                                    comm::MessageCompression::kAlways);
+  // the order of the messages of the same priority is kept
+  communication_layers.at(0)->SetMessagePriority(comm::MessageType::kOutputMessage,
+                                                 comm::MessagePriority::kBulk);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  auto& message_manager{communication_layers.at(1)->GetMessageManager()};
+  std::vector<std::pair<comm::MessageManager::future_type, const std::vector<std::uint8_t>*>>
+      expected_messages;
+  auto send = [&](comm::MessageType message_type, std::size_t message_id,
+                  const std::vector<std::uint8_t>& message) {
+    expected_messages.emplace_back(message_manager.RegisterReceive(0, message_type, message_id),
+                                   &message);
+    communication_layers.at(0)->SendMessage(
+        1, comm::BuildMessage(message_type, message_id, message).Release());
+  };
+  send(comm::MessageType::kOtExtensionSender, 0, redundant_message);
+  send(comm::MessageType::kOtExtensionSender, 1, random_message);
+  send(comm::MessageType::kOutputMessage, 0, random_message);
+  send(comm::MessageType::kBeaverOpening, 0, small_message);
+  send(comm::MessageType::kBeaverOpening, 1, random_message);
+  for (auto& [future, message] : expected_messages) {
+    auto received_message{future.get()};
+    auto payload{comm::GetMessage(received_message.data())->payload()};
+    ASSERT_EQ(payload->size(), message->size());
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), message->begin()));
+  }
+  const auto statistics{communication_layers.at(1)->GetTransportStatistics().at(0)};
+  EXPECT_LT(statistics.number_of_compressed_bytes_received, redundant_message.size() / 10);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+
+  // fragment headers need to be consistent with the fragment
+  std::vector<std::uint8_t> fragment(sizeof(comm::MessageFragmentHeader) + 10);
+  comm::MessageFragmentHeader header{.magic = comm::MessageFragmentHeader::kMagic,
+                                     .length = 10,
+                                     .priority = comm::MessagePriority::kBulk,
+                                     .reserved = {},
+                                     .total_length = 30,
+                                     .offset = 20};
+  std::memcpy(fragment.data(), &header, sizeof(header));
+  EXPECT_TRUE(comm::ReadMessageFragmentHeader(fragment).has_value());
+  header.offset = 21;
+  std::memcpy(fragment.data(), &header, sizeof(header));
+  EXPECT_FALSE(comm::ReadMessageFragmentHeader(fragment).has_value());
+}
+
+TEST(CommunicationLayer, MessageBatch) {
+  constexpr std::size_t kNumberOfParties{3};
+  std::vector<std::uint8_t> message(1000, 42);
+  auto communication_layers = comm::MakeDummyCommunicationLayers(kNumberOfParties);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  std::vector<comm::MessageManager::future_type> futures;
+  for (std::size_t i = 0; i < 3; ++i) {
+    futures.emplace_back(communication_layers.at(1)->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, i));
+  }
+  futures.emplace_back(communication_layers.at(2)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 2));
+  comm::MessageBatch batch(*communication_layers.at(0));
+  {
+    comm::MessageBatch::Scope scope(batch);
+    for (std::size_t i = 0; i < 2; ++i) {
+      communication_layers.at(0)->SendMessage(
+          1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+    }
+    communication_layers.at(0)->BroadcastMessage(
+        comm::BuildMessage(comm::MessageType::kOutputMessage, 2, message).Release());
+  }
+  // messages sent after the scope are not collected
+  futures.emplace_back(communication_layers.at(1)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 3));
+  communication_layers.at(0)->SendMessage(
+      1, comm::BuildMessage(comm::MessageType::kOutputMessage, 3, message).Release());
+  batch.Send();
+  for (auto& f : futures) {
+    auto received_message{f.get()};
+    auto payload{comm::GetMessage(received_message.data())->payload()};
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), message.begin(), message.end()));
+  }
+  std::vector<std::future<void>> shutdown_futures;
+  for (auto& cl : communication_layers) {
+    shutdown_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(shutdown_futures), std::end(shutdown_futures),
+                [](auto& f) { f.get(); });
+
+  // the collected messages are sent as one message per party and received one by one
+  const auto statistics = [](const comm::TransportStatistics& party_statistics,
+                             comm::MessageType type) {
+    return party_statistics.message_type_statistics.at(static_cast<std::size_t>(type));
+  };
+  const auto sender_statistics{communication_layers.at(0)->GetTransportStatistics()};
+  EXPECT_EQ(statistics(sender_statistics.at(0), comm::MessageType::kMessageBatch)
+                .number_of_messages_sent,
+            1);
+  EXPECT_EQ(statistics(sender_statistics.at(0), comm::MessageType::kOutputMessage)
+                .number_of_messages_sent,
+            1);
+  EXPECT_EQ(statistics(sender_statistics.at(1), comm::MessageType::kMessageBatch)
+                .number_of_messages_sent,
+            1);
+  const auto receiver_statistics{communication_layers.at(1)->GetTransportStatistics().at(0)};
+  EXPECT_EQ(statistics(receiver_statistics, comm::MessageType::kOutputMessage)
+                .number_of_messages_received,
+            4);
+}
+
+TEST(CommunicationLayer, MessageTypeStatistics) {
+  constexpr std::size_t kNumberOfMessages{3};
+  std::vector<std::uint8_t> message(1000, 42);
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto registry{std::make_shared<encrypto::motion::MetricsRegistry>()};
+  communication_layers.at(0)->RegisterMetrics(registry);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  std::vector<comm::MessageManager::future_type> futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    futures.emplace_back(communication_layers.at(1)->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, i));
+    communication_layers.at(0)->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+  std::vector<std::future<void>> shutdown_futures;
+  for (auto& cl : communication_layers) {
+    shutdown_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(shutdown_futures), std::end(shutdown_futures),
+                [](auto& f) { f.get(); });
+
+  const auto kOutputMessage{static_cast<std::size_t>(comm::MessageType::kOutputMessage)};
+  const auto sender_statistics{communication_layers.at(0)->GetTransportStatistics().at(0)};
+  const auto& sent{sender_statistics.message_type_statistics.at(kOutputMessage)};
+  EXPECT_EQ(sent.number_of_messages_sent, kNumberOfMessages);
+  EXPECT_GT(sent.number_of_bytes_sent, kNumberOfMessages * message.size());
+  EXPECT_EQ(std::accumulate(std::begin(sent.send_latency_histogram),
+                            std::end(sent.send_latency_histogram), std::size_t(0)),
+            kNumberOfMessages);
+  const auto receiver_statistics{communication_layers.at(1)->GetTransportStatistics().at(0)};
+  const auto& received{receiver_statistics.message_type_statistics.at(kOutputMessage)};
+  EXPECT_EQ(received.number_of_messages_received, kNumberOfMessages);
+  EXPECT_EQ(received.number_of_bytes_received, sent.number_of_bytes_sent);
+
+  encrypto::motion::AccumulatedCommunicationStatistics accumulated_statistics;
+  accumulated_statistics.Add(sender_statistics);
+  const auto json{accumulated_statistics.ToJson()};
+  const auto& message_type_json{
+      json.at("message_types").as_object().at("kOutputMessage").as_object()};
+  EXPECT_EQ(message_type_json.at("num_messages_sent").as_uint64(), kNumberOfMessages);
+
+  const auto metrics{registry->ToOpenMetrics()};
+  EXPECT_NE(
+      metrics.find("motion_messages_sent_total{party=\"0\",peer=\"1\",type=\"kOutputMessage\"} 3"),
+      std::string::npos);
+  EXPECT_NE(metrics.find("motion_sent_message_size_bytes_count{party=\"0\"}"), std::string::npos);
+}
+
+TEST(CommunicationLayer, SendQueueLimit) {
+  constexpr std::size_t kNumberOfMessages{100};
+  constexpr std::size_t kSendQueueLimit{16 << 10};
+  std::vector<std::uint8_t> message(4000, 42);
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  communication_layers.at(0)->SetSendQueueLimit(kSendQueueLimit);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  auto& message_manager{communication_layers.at(1)->GetMessageManager()};
+  std::vector<comm::MessageManager::future_type> futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    futures.emplace_back(message_manager.RegisterReceive(0, comm::MessageType::kOutputMessage, i));
+  }
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    communication_layers.at(0)->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+  }
+  for (auto& future : futures) {
+    auto received_message{future.get()};
+    EXPECT_EQ(comm::GetMessage(received_message.data())->payload()->size(), message.size());
+  }
+  const auto statistics{communication_layers.at(0)->GetTransportStatistics().at(0)};
+  EXPECT_GT(statistics.max_number_of_queued_bytes, message.size());
+  EXPECT_LE(statistics.max_number_of_queued_bytes, kSendQueueLimit);
+
+  std::vector<std::future<void>> shutdown_futures;
+  for (auto& cl : communication_layers) {
+    shutdown_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(shutdown_futures), std::end(shutdown_futures),
+                [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, RelayedBroadcast) {
+  constexpr std::size_t kNumberOfParties{6};
+  constexpr std::size_t kOriginId{2};
+  std::mt19937 random_number_generator(42);
+  std::vector<std::uint8_t> message(10000);
+  std::generate(message.begin(), message.end(),
+                [&random_number_generator] { return random_number_generator(); });
+
+  auto communication_layers = comm::MakeDummyCommunicationLayers(kNumberOfParties);
+  std::vector<comm::MessageManager::future_type> futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    communication_layers.at(party_id)->SetRelayBroadcasts(true);
+    if (party_id != kOriginId) {
+      futures.emplace_back(communication_layers.at(party_id)->GetMessageManager().RegisterReceive(
+          kOriginId, comm::MessageType::kOutputMessage, 0));
+    }
+  }
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  communication_layers.at(kOriginId)->BroadcastMessage(
+      comm::BuildMessage(comm::MessageType::kOutputMessage, 0, message).Release());
+  for (auto& future : futures) {
+    auto received_message{future.get()};
+    auto payload{comm::GetMessage(received_message.data())->payload()};
+    ASSERT_EQ(payload->size(), message.size());
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), message.begin()));
+  }
+  // the origin sent the message to its kRelayFanout children only
+  const auto statistics{communication_layers.at(kOriginId)->GetTransportStatistics()};
+  const auto number_of_bytes_sent{std::accumulate(
+      std::begin(statistics), std::end(statistics), std::size_t(0),
+      [](std::size_t sum, const auto& s) { return sum + s.number_of_bytes_sent; })};
+  EXPECT_LT(number_of_bytes_sent, 3 * message.size());
+
+  std::vector<std::future<void>> shutdown_futures;
+  for (auto& cl : communication_layers) {
+    shutdown_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(shutdown_futures), std::end(shutdown_futures),
+                [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, Sessions) {
+  constexpr std::size_t kNumberOfParties{3};
+  constexpr std::uint32_t kSessionId{7};
+  const std::vector<std::uint8_t> message{0xde, 0xad, 0xbe, 0xef};
+  const std::vector<std::uint8_t> session_message{0xc0, 0xff, 0xee};
+
+  auto communication_layers = comm::MakeDummyCommunicationLayers(kNumberOfParties);
+  std::vector<std::unique_ptr<comm::CommunicationLayer>> sessions;
+  for (auto& cl : communication_layers) {
+    sessions.emplace_back(cl->CreateSession(kSessionId));
+    EXPECT_EQ(sessions.back()->GetSessionId(), kSessionId);
+    EXPECT_THROW(cl->CreateSession(kSessionId), std::invalid_argument);
+    EXPECT_THROW(cl->CreateSession(0), std::invalid_argument);
+  }
+  // messages with the same type and id are delivered to the message manager of their session
+  std::vector<comm::MessageManager::future_type> futures, session_futures;
+  for (std::size_t party_id = 1; party_id < kNumberOfParties; ++party_id) {
+    futures.emplace_back(communication_layers.at(party_id)->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, 0));
+    session_futures.emplace_back(sessions.at(party_id)->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, 0));
+  }
+  std::for_each(std::begin(sessions), std::end(sessions), [](auto& cl) { cl->Start(); });
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  sessions.at(0)->BroadcastMessage(
+      comm::BuildMessage(comm::MessageType::kOutputMessage, 0, session_message).Release());
+  communication_layers.at(0)->BroadcastMessage(
+      comm::BuildMessage(comm::MessageType::kOutputMessage, 0, message).Release());
+  for (std::size_t i = 0; i + 1 < kNumberOfParties; ++i) {
+    auto received_message{futures.at(i).get()};
+    auto payload{comm::GetMessage(received_message.data())->payload()};
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), message.begin(), message.end()));
+    auto received_session_message{session_futures.at(i).get()};
+    auto session_payload{comm::GetMessage(received_session_message.data())->payload()};
+    EXPECT_TRUE(std::equal(session_payload->begin(), session_payload->end(),
+                           session_message.begin(), session_message.end()));
+  }
+
+  // the synchronization states of the sessions are independent as well
+  for (auto* layers : {&sessions, &communication_layers}) {
+    std::vector<std::future<void>> sync_futures;
+    for (auto& cl : *layers) {
+      sync_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Synchronize(); }));
+    }
+    std::for_each(std::begin(sync_futures), std::end(sync_futures), [](auto& f) { f.get(); });
+  }
+
+  // a closed session id can be reused
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    sessions.at(party_id).reset();
+    EXPECT_NO_THROW(sessions.at(party_id) =
+                        communication_layers.at(party_id)->CreateSession(kSessionId));
+  }
+  sessions.clear();
+
+  std::vector<std::future<void>> shutdown_futures;
+  for (auto& cl : communication_layers) {
+    shutdown_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(shutdown_futures), std::end(shutdown_futures),
+                [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, ImplicitSynchronization) {
+  const std::vector<std::uint8_t> message{0xde, 0xad, 0xbe, 0xef};
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  for (auto& cl : communication_layers) {
+    cl->SetImplicitSynchronization(true);
+    cl->Start();
+  }
+
+  // party 0 does not wait for party 1 and sends a message of the next epoch right away, which
+  // party 1 holds until it synchronizes, i.e., until after it registered the receive
+  communication_layers.at(0)->Synchronize();
+  communication_layers.at(0)->SendMessage(
+      1, comm::BuildMessage(comm::MessageType::kOutputMessage, 0, message).Release());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  auto future_1{communication_layers.at(1)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 0)};
+  communication_layers.at(1)->Synchronize();
+  {
+    auto received_message{future_1.get()};
+    auto payload{comm::GetMessage(received_message.data())->payload()};
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), message.begin(), message.end()));
+  }
+
+  // both parties are in the same epoch, so messages are delivered directly
+  auto future_0{communication_layers.at(0)->GetMessageManager().RegisterReceive(
+      1, comm::MessageType::kOutputMessage, 1)};
+  communication_layers.at(1)->SendMessage(
+      0, comm::BuildMessage(comm::MessageType::kOutputMessage, 1, message).Release());
+  EXPECT_EQ(comm::GetMessage(future_0.get().data())->message_id(), 1);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, ClockOffsetsAndMergedTimeline) {
+  const std::vector<std::uint8_t> message{0xde, 0xad, 0xbe, 0xef};
+  auto communication_layers = comm::MakeDummyCommunicationLayers(3);
+  for (auto& cl : communication_layers) {
+    cl->SetMessageTracing(true);
+    cl->Start();
+  }
+
+  std::vector<std::future<std::vector<std::chrono::nanoseconds>>> offset_futures;
+  for (auto& cl : communication_layers) {
+    offset_futures.emplace_back(
+        std::async(std::launch::async, [&cl] { return cl->EstimateClockOffsets(4); }));
+  }
+  for (std::size_t my_id = 0; my_id < communication_layers.size(); ++my_id) {
+    const auto offsets{offset_futures.at(my_id).get()};
+    ASSERT_EQ(offsets.size(), communication_layers.size());
+    EXPECT_EQ(offsets.at(my_id).count(), 0);
+    // all parties share the steady clock of this process
+    for (auto offset : offsets) {
+      EXPECT_LT(std::abs(offset.count()), std::chrono::nanoseconds(std::chrono::seconds(1)).count())
+          << "offset of " << offset.count() << " ns";
+    }
+  }
+
+  auto future{communication_layers.at(1)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 7)};
+  communication_layers.at(0)->SendMessage(
+      1, comm::BuildMessage(comm::MessageType::kOutputMessage, 7, message).Release());
+  future.get();
+
+  // neither the probes nor the synchronization are traced
+  std::vector<std::string> traces;
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    encrypto::motion::PartyTimeline timeline;
+    timeline.party_id = party_id;
+    timeline.message_trace = communication_layers.at(party_id)->TakeMessageTrace();
+    ASSERT_EQ(timeline.message_trace.events.size(), 1u);
+    const auto& event{timeline.message_trace.events.front()};
+    EXPECT_EQ(event.party_id, 1 - party_id);
+    EXPECT_EQ(event.direction, party_id == 0 ? comm::MessageTrace::Direction::kSent
+                                             : comm::MessageTrace::Direction::kReceived);
+    EXPECT_EQ(event.message_type, comm::MessageType::kOutputMessage);
+    EXPECT_EQ(event.message_id, 7u);
+    traces.emplace_back(timeline.ToChromeTrace());
+  }
+
+  const auto merged{boost::json::parse(encrypto::motion::MergeChromeTraces(traces))};
+  std::vector<std::uint64_t> flow_start_ids, flow_end_ids;
+  double first_ts{std::numeric_limits<double>::max()};
+  for (const auto& event : merged.as_object().at("traceEvents").as_array()) {
+    const auto& object{event.as_object()};
+    if (const auto ts{object.if_contains("ts")}) {
+      first_ts = std::min(first_ts, ts->to_number<double>());
+    }
+    if (object.at("ph").as_string() == "s") {
+      flow_start_ids.push_back(object.at("id").to_number<std::uint64_t>());
+    } else if (object.at("ph").as_string() == "f") {
+      flow_end_ids.push_back(object.at("id").to_number<std::uint64_t>());
+    }
+  }
+  EXPECT_EQ(first_ts, 0.0);
+  ASSERT_EQ(flow_start_ids.size(), 1u);
+  EXPECT_EQ(flow_start_ids, flow_end_ids);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, MeasureLinksAgreesOnAllParties) {
+  auto communication_layers = comm::MakeDummyCommunicationLayers(3);
+  for (auto& cl : communication_layers) {
+    cl->Start();
+  }
+  std::vector<std::future<std::vector<std::vector<comm::LinkParameters>>>> link_futures;
+  for (auto& cl : communication_layers) {
+    link_futures.emplace_back(
+        std::async(std::launch::async, [&cl] { return cl->MeasureLinks(2, 1 << 16); }));
+  }
+  std::vector<std::vector<std::vector<comm::LinkParameters>>> links;
+  for (auto& future : link_futures) {
+    links.emplace_back(future.get());
+  }
+  for (std::size_t my_id = 0; my_id < links.size(); ++my_id) {
+    ASSERT_EQ(links.at(my_id).size(), 3u);
+    for (std::size_t i = 0; i < 3; ++i) {
+      ASSERT_EQ(links.at(my_id).at(i).size(), 3u);
+      for (std::size_t j = 0; j < 3; ++j) {
+        const auto& link{links.at(my_id).at(i).at(j)};
+        EXPECT_EQ(link.round_trip_time, links.at(0).at(i).at(j).round_trip_time);
+        EXPECT_EQ(link.bytes_per_second, links.at(0).at(i).at(j).bytes_per_second);
+        EXPECT_EQ(link.bytes_per_second, links.at(my_id).at(j).at(i).bytes_per_second);
+        if (i != j) {
+          EXPECT_GT(link.bytes_per_second, 0.0);
+        }
+      }
+    }
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
 class CommunicationLayerTest : public testing::TestWithParam<bool> {};
 
 TEST_P(CommunicationLayerTest, Tcp) {
@@ -154,6 +832,45 @@ TEST_P(CommunicationLayerTest, Tcp) {
   std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
 }
 
+// the TCP transport sends each span as a message, so each fragment needs to be a single span
+TEST_P(CommunicationLayerTest, TcpMessagePrioritization) {
+  std::mt19937 random_number_generator(42);
+  std::vector<std::uint8_t> large_message(300000);
+  std::generate(large_message.begin(), large_message.end(),
+                [&random_number_generator] { return random_number_generator(); });
+  std::vector<std::uint8_t> small_message(100, 42);
+
+  auto communication_layers = comm::MakeLocalTcpCommunicationLayers(2, GetParam());
+  communication_layers.at(0)->SetMessagePrioritization(true);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  auto& message_manager{communication_layers.at(1)->GetMessageManager()};
+  std::vector<std::pair<comm::MessageManager::future_type, const std::vector<std::uint8_t>*>>
+      expected_messages;
+  auto send = [&](comm::MessageType message_type, std::size_t message_id,
+                  const std::vector<std::uint8_t>& message) {
+    expected_messages.emplace_back(message_manager.RegisterReceive(0, message_type, message_id),
+                                   &message);
+    communication_layers.at(0)->SendMessage(
+        1, comm::BuildMessage(message_type, message_id, message).Release());
+  };
+  send(comm::MessageType::kOtExtensionSender, 0, large_message);
+  send(comm::MessageType::kOutputMessage, 0, large_message);
+  send(comm::MessageType::kBeaverOpening, 0, small_message);
+  for (auto& [future, message] : expected_messages) {
+    auto received_message{future.get()};
+    auto payload{comm::GetMessage(received_message.data())->payload()};
+    ASSERT_EQ(payload->size(), message->size());
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), message->begin()));
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
 INSTANTIATE_TEST_SUITE_P(CommunicationLayerTcpTests, CommunicationLayerTest, testing::Bool(),
                          [](auto& info) { return info.param ? "ipv6" : "ipv4"; });
 }  // namespace
\ No newline at end of file
@@ -475,6 +475,60 @@ TEST_P(BooleanConversionTest, B2A_64_bit) {
   B2ARun<std::uint64_t>(this->number_of_parties_, this->number_of_simd_, this->online_after_setup_);
 }
 
+// converts number_of_bits < k Boolean GMW bits into zero-extended arithmetic GMW values
+template <typename T>
+void B2ABitsRun(const std::size_t number_of_parties, const std::size_t number_of_simd,
+                const bool online_after_setup, const std::size_t number_of_bits) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  const std::size_t input_owner = 0, output_owner = number_of_parties - 1;
+  std::vector<encrypto::motion::BitVector<>> global_input(number_of_bits);
+  for (auto& bv : global_input) {
+    bv = encrypto::motion::BitVector<>::SecureRandom(number_of_simd);
+  }
+  std::vector<T> expected(number_of_simd, 0);
+  for (std::size_t wire_i = 0; wire_i < number_of_bits; ++wire_i) {
+    for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+      expected[simd_i] |= T(global_input[wire_i].Get(simd_i)) << wire_i;
+    }
+  }
+  std::vector<encrypto::motion::BitVector<>> dummy_input(
+      number_of_bits, encrypto::motion::BitVector<>(number_of_simd, false));
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(online_after_setup);
+  }
+  std::vector<std::thread> threads;
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    threads.emplace_back([party_id, &motion_parties, input_owner, output_owner, &global_input,
+                          &expected, &dummy_input]() {
+      encrypto::motion::ShareWrapper share_input(motion_parties.at(party_id)->In<kBooleanGmw>(
+          party_id == input_owner ? global_input : dummy_input, input_owner));
+      const auto share_output{share_input.BitsToArithmeticGmw(sizeof(T) * 8).Out(output_owner)};
+
+      motion_parties.at(party_id)->Run();
+
+      if (party_id == output_owner) {
+        EXPECT_EQ(share_output.As<std::vector<T>>(), expected);
+      }
+      motion_parties.at(party_id)->Finish();
+    });
+  }
+  for (auto& t : threads)
+    if (t.joinable()) t.join();
+}
+
+TEST_P(BooleanConversionTest, B2A_1_of_32_bits) {
+  B2ABitsRun<std::uint32_t>(this->number_of_parties_, this->number_of_simd_,
+                            this->online_after_setup_, 1);
+}
+TEST_P(BooleanConversionTest, B2A_5_of_64_bits) {
+  B2ABitsRun<std::uint64_t>(this->number_of_parties_, this->number_of_simd_,
+                            this->online_after_setup_, 5);
+}
+
 INSTANTIATE_TEST_SUITE_P(BooleanConversionTestSuite, BooleanConversionTest,
                          testing::Combine(testing::ValuesIn(kConversionNumberOfParties),
                                           testing::ValuesIn(kConversionNumberOfSimd),
@@ -591,4 +645,109 @@ INSTANTIATE_TEST_SUITE_P(YaoConversionTestSuite, YaoConversionTest,
                            return name;
                          });
 
+// number of wires, SIMD values, online-after-setup flag
+using GarbledCircuitConversionParametersType = std::tuple<std::size_t, std::size_t, bool>;
+
+// conversions between two-party garbled circuits and Boolean GMW
+class GarbledCircuitConversionTest
+    : public testing::TestWithParam<GarbledCircuitConversionParametersType> {
+ public:
+  void SetUp() override {
+    std::tie(number_of_wires_, number_of_simd_, online_after_setup_) = GetParam();
+    for (auto& input : global_input_) {
+      input.resize(number_of_wires_);
+      for (auto& bv : input) bv = encrypto::motion::BitVector<>::SecureRandom(number_of_simd_);
+    }
+  }
+
+  // Runs the two parties, where each party inputs global_input_[party_id] in protocol P and
+  // function combines the shares of the inputs. The result is output to both parties.
+  template <MpcProtocol P>
+  void Run(std::function<ShareWrapper(const ShareWrapper&, const ShareWrapper&)> function,
+           const std::vector<encrypto::motion::BitVector<>>& expected_output) {
+    std::vector<PartyPointer> motion_parties(MakeLocallyConnectedParties(2, kPortOffset));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(online_after_setup_);
+    }
+    std::vector<encrypto::motion::BitVector<>> dummy_input(
+        number_of_wires_, encrypto::motion::BitVector<>(number_of_simd_, false));
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < motion_parties.size(); ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [&, party_id]() {
+        auto& party{motion_parties.at(party_id)};
+        ShareWrapper input_0{party->In<P>(party_id == 0 ? global_input_[0] : dummy_input, 0)};
+        ShareWrapper input_1{party->In<P>(party_id == 1 ? global_input_[1] : dummy_input, 1)};
+        auto share_output{function(input_0, input_1).Out()};
+
+        party->Run();
+
+        EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_output);
+        party->Finish();
+      }));
+    }
+    for (auto& f : futures) f.get();
+  }
+
+ protected:
+  std::size_t number_of_wires_ = 0, number_of_simd_ = 0;
+  bool online_after_setup_ = false;
+  std::array<std::vector<encrypto::motion::BitVector<>>, 2> global_input_;
+};
+
+TEST_P(GarbledCircuitConversionTest, GarbledCircuitToBooleanGmw) {
+  std::vector<encrypto::motion::BitVector<>> expected_output(number_of_wires_);
+  for (std::size_t i = 0; i < number_of_wires_; ++i) {
+    expected_output[i] = global_input_[0][i] ^ (global_input_[0][i] & global_input_[1][i]);
+  }
+  // the AND and XOR of the labels yield labels of further gates, whose permutation bits are
+  // converted, and the AND of the converted shares checks that the result is a valid GMW share
+  Run<MpcProtocol::kGarbledCircuit>(
+      [](const ShareWrapper& a, const ShareWrapper& b) {
+        const auto a_gmw{a.Convert<MpcProtocol::kBooleanGmw>()};
+        const auto a_and_b_gmw{(a & b).Convert<MpcProtocol::kBooleanGmw>()};
+        EXPECT_TRUE(a_gmw->GetProtocol() == MpcProtocol::kBooleanGmw);
+        return a_gmw ^ (a_gmw & a_and_b_gmw);
+      },
+      expected_output);
+}
+
+TEST_P(GarbledCircuitConversionTest, BooleanGmwToGarbledCircuit) {
+  std::vector<encrypto::motion::BitVector<>> expected_output(number_of_wires_);
+  for (std::size_t i = 0; i < number_of_wires_; ++i) {
+    expected_output[i] = (global_input_[0][i] ^ global_input_[1][i]) & global_input_[1][i];
+  }
+  // the converted labels must be valid inputs of garbled AND gates
+  Run<MpcProtocol::kBooleanGmw>(
+      [](const ShareWrapper& a, const ShareWrapper& b) {
+        const auto a_xor_b_gc{(a ^ b).Convert<MpcProtocol::kGarbledCircuit>()};
+        const auto b_gc{b.Convert<MpcProtocol::kGarbledCircuit>()};
+        EXPECT_TRUE(b_gc->GetProtocol() == MpcProtocol::kGarbledCircuit);
+        return a_xor_b_gc & b_gc;
+      },
+      expected_output);
+}
+
+TEST_P(GarbledCircuitConversionTest, RoundTrip) {
+  Run<MpcProtocol::kBooleanGmw>(
+      [](const ShareWrapper& a, [[maybe_unused]] const ShareWrapper& b) {
+        return a.Convert<MpcProtocol::kGarbledCircuit>().Convert<MpcProtocol::kBooleanGmw>();
+      },
+      global_input_[0]);
+}
+
+constexpr std::array<std::size_t, 3> kGarbledCircuitConversionNumberOfWires{1, 10, 64};
+constexpr std::array<std::size_t, 3> kGarbledCircuitConversionNumberOfSimd{1, 10, 64};
+
+INSTANTIATE_TEST_SUITE_P(
+    GarbledCircuitConversionTestSuite, GarbledCircuitConversionTest,
+    testing::Combine(testing::ValuesIn(kGarbledCircuitConversionNumberOfWires),
+                     testing::ValuesIn(kGarbledCircuitConversionNumberOfSimd),
+                     testing::ValuesIn(kConversionOnlineAfterSetup)),
+    [](const testing::TestParamInfo<GarbledCircuitConversionTest::ParamType>& info) {
+      const auto mode = static_cast<bool>(std::get<2>(info.param)) ? "Seq" : "Par";
+      return fmt::format("{}_Wires_{}_SIMD__{}", std::get<0>(info.param), std::get<1>(info.param),
+                         mode);
+    });
+
 }  // namespace
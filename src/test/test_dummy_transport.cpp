@@ -20,9 +20,15 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <chrono>
+#include <filesystem>
+
 #include <gtest/gtest.h>
 
 #include "communication/dummy_transport.h"
+#include "communication/message.h"
+#include "communication/recording_transport.h"
+#include "communication/simulated_transport.h"
 
 using namespace encrypto::motion::communication;
 
@@ -39,3 +45,78 @@ TEST(DummyTransport, Dummy) {
 
   EXPECT_EQ(ReceivedMessage, message);
 }
+
+TEST(SimulatedTransport, Delay) {
+  using namespace std::chrono_literals;
+  auto [transport_alice, transport_bob] = DummyTransport::MakeTransportPair();
+  // 20 ms latency and 8 Mbit/s, i.e., 1 ms per 1000 bytes
+  SimulatedTransport simulated_transport_alice(std::move(transport_alice),
+                                               NetworkProfile::FromString("20,8"));
+
+  const std::vector<std::uint8_t> message(10000, 0x42);
+  const auto start{std::chrono::steady_clock::now()};
+  for (std::size_t i = 0; i < 3; ++i) {
+    simulated_transport_alice.SendMessage(message);
+  }
+  // the messages are in flight
+  EXPECT_FALSE(transport_bob->Available());
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  }
+  // latencies overlap, transmission times do not
+  const auto duration{std::chrono::steady_clock::now() - start};
+  EXPECT_GE(duration, 50ms);
+  EXPECT_LT(duration, 500ms);
+
+  simulated_transport_alice.ShutdownSend();
+  EXPECT_EQ(transport_bob->ReceiveMessage(), std::nullopt);
+  EXPECT_EQ(simulated_transport_alice.GetStatistics().number_of_messages_sent, 3);
+}
+
+TEST(SimulatedTransport, NetworkProfile) {
+  using namespace std::chrono_literals;
+  const auto wan{NetworkProfile::FromString("wan")};
+  EXPECT_EQ(wan.latency, 50ms);
+  const auto custom{NetworkProfile::FromString("12.5,100,2")};
+  EXPECT_EQ(custom.latency, 12500us);
+  EXPECT_EQ(custom.jitter, 2ms);
+  EXPECT_DOUBLE_EQ(custom.bandwidth, 100e6);
+  EXPECT_THROW(NetworkProfile::FromString("fast"), std::invalid_argument);
+}
+
+TEST(RecordingTransport, ReplaysAfterTheRecordedSynchronizations) {
+  auto [transport_alice, transport_bob] = DummyTransport::MakeTransportPair();
+  auto recording{std::make_shared<TrafficRecording>()};
+  RecordingTransport recording_transport_bob(std::move(transport_bob), recording);
+
+  const std::vector<std::uint8_t> message_1 = {0xde, 0xad}, message_2 = {0xbe, 0xef};
+  const std::vector<std::uint8_t> sync_state(sizeof(std::uint64_t), 0);
+  const auto synchronization_message{
+      BuildMessage(MessageType::kSynchronizationMessage, sync_state).Release()};
+  const std::span synchronization(synchronization_message.data(), synchronization_message.size());
+  transport_alice->SendMessage(message_1);
+  EXPECT_EQ(recording_transport_bob.ReceiveMessage(), message_1);
+  recording_transport_bob.SendMessage(synchronization);
+  transport_alice->SendMessage(message_2);
+  EXPECT_EQ(recording_transport_bob.ReceiveMessage(), message_2);
+  ASSERT_EQ(recording->messages.size(), 2);
+  EXPECT_EQ(recording->messages[0].number_of_synchronizations, 0);
+  EXPECT_EQ(recording->messages[1].number_of_synchronizations, 1);
+
+  const auto path{std::filesystem::temp_directory_path() / "motion_traffic_recording"};
+  recording->Save(path);
+  ReplayTransport replay_transport(TrafficRecording::Load(path));
+  std::filesystem::remove(path);
+  EXPECT_TRUE(replay_transport.Available());
+  EXPECT_EQ(replay_transport.ReceiveMessage(), message_1);
+  // the second message follows the synchronization
+  EXPECT_FALSE(replay_transport.Available());
+  replay_transport.SendMessage(message_1);
+  EXPECT_FALSE(replay_transport.Available());
+  replay_transport.SendMessage(synchronization);
+  EXPECT_TRUE(replay_transport.Available());
+  EXPECT_EQ(replay_transport.ReceiveMessage(), message_2);
+  replay_transport.Shutdown();
+  EXPECT_EQ(replay_transport.ReceiveMessage(), std::nullopt);
+  EXPECT_EQ(replay_transport.GetStatistics().number_of_messages_sent, 2);
+}
@@ -23,25 +23,40 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <filesystem>
 #include <iterator>
 
+#include "base/backend.h"
 #include "base/party.h"
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "data_storage/preprocessing_store.h"
 #include "protocols/garbled_circuit/garbled_circuit_constants.h"
 #include "protocols/garbled_circuit/garbled_circuit_provider.h"
+#include "protocols/garbled_circuit/garbled_table_stream.h"
+#include "protocols/garbled_circuit/wire_label_arena.h"
 #include "protocols/share_wrapper.h"
 #include "test_constants.h"
 #include "utility/reusable_future.h"
 
+namespace encrypto::motion {
+
+// prints the scheme in the names of the parameterized tests
+void PrintTo(GarbledCircuitScheme scheme, std::ostream* os) { *os << to_string(scheme); }
+
+}  // namespace encrypto::motion
+
 namespace {
 
-// number of wires, SIMD values, and online-after-setup flag
-using ParametersType = std::tuple<std::size_t, std::size_t, bool>;
+// number of wires, SIMD values, online-after-setup flag, and garbling scheme
+using ParametersType =
+    std::tuple<std::size_t, std::size_t, bool, encrypto::motion::GarbledCircuitScheme>;
 
 class GarbledCircuitTest : public testing::TestWithParam<ParametersType> {
  public:
   void SetUp() override {
     auto parameters = GetParam();
-    std::tie(number_of_wires_, number_of_simd_, online_after_setup_) = parameters;
+    std::tie(number_of_wires_, number_of_simd_, online_after_setup_, scheme_) = parameters;
 
     parties_ = MakeParties();
     for (auto& party : parties_) {
@@ -49,6 +64,7 @@ class GarbledCircuitTest : public testing::TestWithParam<ParametersType> {
       party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
       party->GetLogger()->SetEnabled(true);
       party->GetConfiguration()->SetOnlineAfterSetup(this->online_after_setup_);
+      party->GetConfiguration()->SetGarbledCircuitScheme(this->scheme_);
     }
 
     global_inputs_.resize(2);
@@ -72,6 +88,8 @@ class GarbledCircuitTest : public testing::TestWithParam<ParametersType> {
  protected:
   std::size_t number_of_wires_ = 0, number_of_simd_ = 0;
   bool online_after_setup_ = false;
+  encrypto::motion::GarbledCircuitScheme scheme_{
+      encrypto::motion::GarbledCircuitScheme::kThreeHalves};
   std::vector<encrypto::motion::PartyPointer> parties_;
   std::size_t bitvector_randomness_seed_ = 0;
   std::vector<std::vector<encrypto::motion::BitVector<>>> global_inputs_;
@@ -152,6 +170,41 @@ TEST_P(GarbledCircuitTest, InputOutput) {
   for (auto& f : futures) f.get();
 }
 
+TEST_P(GarbledCircuitTest, BooleanInputsShareOneGatePerNumberOfSimd) {
+  // the fields of a record of the evaluator, the last one with a single SIMD value
+  const std::vector<std::vector<encrypto::motion::BitVector<>>> inputs{
+      {GenerateRandomBitVector(this->number_of_simd_)},
+      this->global_inputs_[this->evaluator_id_],
+      {GenerateRandomBitVector(this->number_of_simd_),
+       GenerateRandomBitVector(this->number_of_simd_)},
+      {encrypto::motion::BitVector<>(1, true)}};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, this, &inputs]() {
+      auto& backend{*this->parties_[party_id]->GetBackend()};
+      const auto number_of_gates{backend.GetRegister()->GetGates().size()};
+      const auto shares{backend.BooleanInputs(encrypto::motion::MpcProtocol::kGarbledCircuit,
+                                              this->evaluator_id_, inputs)};
+      const std::size_t number_of_input_gates{this->number_of_simd_ == 1 ? 1u : 2u};
+      EXPECT_EQ(backend.GetRegister()->GetGates().size(), number_of_gates + number_of_input_gates);
+      ASSERT_EQ(shares.size(), inputs.size());
+
+      std::vector<encrypto::motion::ShareWrapper> outputs;
+      for (std::size_t i = 0; i < shares.size(); ++i) {
+        EXPECT_EQ(shares[i]->GetBitLength(), inputs[i].size());
+        outputs.emplace_back(shares[i].Out());
+      }
+
+      this->parties_[party_id]->Run();
+      for (std::size_t i = 0; i < outputs.size(); ++i) {
+        EXPECT_EQ(outputs[i].As<std::vector<encrypto::motion::BitVector<>>>(), inputs[i]);
+      }
+      this->parties_[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
 TEST_P(GarbledCircuitTest, DelayedInputOutput) {
   std::vector<std::future<void>> futures;
   for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
@@ -406,21 +459,236 @@ TEST_P(GarbledCircuitTest, And) {
     }
   }
 }
+
 constexpr std::array<std::size_t, 3> kGarbledCircuitNumberOfWires{1, 64, 100};
 constexpr std::array<std::size_t, 3> kGarbledCircuitNumberOfSimd{1, 64, 100};
 constexpr std::array<bool, 2> kGarbledCircuitOnlineAfterSetup{false, true};
+constexpr std::array<encrypto::motion::GarbledCircuitScheme, 2> kGarbledCircuitSchemes{
+    encrypto::motion::GarbledCircuitScheme::kThreeHalves,
+    encrypto::motion::GarbledCircuitScheme::kHalfGates};
 
 INSTANTIATE_TEST_SUITE_P(GarbledCircuitTestSuite, GarbledCircuitTest,
                          testing::Combine(testing::ValuesIn(kGarbledCircuitNumberOfWires),
                                           testing::ValuesIn(kGarbledCircuitNumberOfSimd),
-                                          testing::ValuesIn(kGarbledCircuitOnlineAfterSetup)),
+                                          testing::ValuesIn(kGarbledCircuitOnlineAfterSetup),
+                                          testing::ValuesIn(kGarbledCircuitSchemes)),
                          [](const testing::TestParamInfo<GarbledCircuitTest::ParamType>& info) {
                            const auto mode =
                                static_cast<bool>(std::get<2>(info.param)) ? "Seq" : "Par";
-                           std::string name =
-                               fmt::format("{}_Wires_{}_SIMD__{}", std::get<0>(info.param),
-                                           std::get<1>(info.param), mode);
+                           std::string name = fmt::format(
+                               "{}_Wires_{}_SIMD__{}_{}", std::get<0>(info.param),
+                               std::get<1>(info.param), mode,
+                               encrypto::motion::to_string(std::get<3>(info.param)));
                            return name;
                          });
 
+TEST(GarbledTableStream, ChunksAreSentAndReused) {
+  using encrypto::motion::proto::garbled_circuit::GarbledTableStream;
+  using encrypto::motion::proto::garbled_circuit::GarbledTableStreamPosition;
+  auto communication_layers{encrypto::motion::communication::MakeDummyCommunicationLayers(2)};
+  for (auto& communication_layer : communication_layers) communication_layer->Start();
+  constexpr std::size_t kChunkByteSize{64};
+  GarbledTableStream garbler_stream(*communication_layers[0], kChunkByteSize);
+  GarbledTableStream evaluator_stream(*communication_layers[1], kChunkByteSize);
+
+  // the second gate is padded to 32 B and starts a new chunk, the third and fourth gate do not
+  // fit into the chunk of their predecessor either
+  const std::array<std::size_t, 4> kNumberOfBytes{40, 30, 100, 8};
+  std::vector<GarbledTableStreamPosition> positions;
+  for (auto number_of_bytes : kNumberOfBytes) {
+    auto position{garbler_stream.Reserve(number_of_bytes)};
+    auto evaluator_position{evaluator_stream.Reserve(number_of_bytes)};
+    EXPECT_EQ(position.chunk_index, evaluator_position.chunk_index);
+    EXPECT_EQ(position.byte_offset, evaluator_position.byte_offset);
+    EXPECT_EQ(position.byte_offset % 8, 0);
+    positions.push_back(position);
+  }
+  EXPECT_EQ(garbler_stream.GetNumberOfChunks(), 4);
+
+  for (std::size_t run = 0; run < 2; ++run) {
+    // finish the gates in reverse order, which sends every chunk when its last gate is done
+    for (std::size_t i = kNumberOfBytes.size(); i-- > 0;) {
+      auto tables{garbler_stream.GetMutableTables(positions[i])};
+      for (std::size_t j = 0; j < kNumberOfBytes[i]; ++j) {
+        EXPECT_EQ(tables[j], std::byte(0));
+        tables[j] = std::byte(run + i + j);
+      }
+      garbler_stream.FinishTables(positions[i]);
+    }
+    for (std::size_t i = 0; i < kNumberOfBytes.size(); ++i) {
+      auto tables{evaluator_stream.GetTables(positions[i])};
+      for (std::size_t j = 0; j < kNumberOfBytes[i]; ++j) {
+        EXPECT_EQ(tables[j], std::byte(run + i + j));
+      }
+      evaluator_stream.ReleaseTables(positions[i]);
+    }
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& communication_layer : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async,
+                                    [&communication_layer] { communication_layer->Shutdown(); }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(LabelArena, LabelsAreAdjacentAndOutliveTheArena) {
+  using encrypto::motion::proto::garbled_circuit::ArenaLabels;
+  std::vector<ArenaLabels> labels;
+  {
+    encrypto::motion::proto::garbled_circuit::LabelArena arena(16);
+    // the third allocation does not fit into the first chunk, the fourth exceeds the chunk size
+    // and leaves the current chunk to the fifth
+    for (std::size_t number_of_labels : {4, 10, 3, 20, 1}) {
+      labels.push_back(arena.Allocate(number_of_labels));
+      EXPECT_EQ(labels.back().labels.size(), number_of_labels);
+    }
+    EXPECT_EQ(arena.GetNumberOfLabels(), 38);
+  }
+  EXPECT_EQ(labels[1].chunk.get(), labels[0].chunk.get());
+  EXPECT_EQ(labels[1].labels.data(), labels[0].labels.data() + 4);
+  EXPECT_NE(labels[2].chunk.get(), labels[1].chunk.get());
+  EXPECT_NE(labels[3].chunk.get(), labels[2].chunk.get());
+  EXPECT_EQ(labels[3].chunk->size(), 20);
+  EXPECT_NE(labels[4].chunk.get(), labels[3].chunk.get());
+  EXPECT_EQ(labels[4].labels.data(), labels[2].labels.data() + 3);
+
+  // the chunks are kept alive by the labels
+  for (auto& arena_labels : labels) {
+    for (auto& label : arena_labels.labels) label = encrypto::motion::Block128::MakeZero();
+  }
+}
+
+TEST(GarbledCircuit, StoredCircuitIsEvaluatedOnce) {
+  using encrypto::motion::PreprocessingKind;
+  using encrypto::motion::PreprocessingStore;
+  using encrypto::motion::PreprocessingStoreWriter;
+  using encrypto::motion::proto::garbled_circuit::ThreeHalvesGarblerProvider;
+  static constexpr std::uint64_t kSessionId{0x6a4b1ed};
+  constexpr std::size_t kNumberOfWires{3}, kNumberOfSimd{50};
+  std::array<std::filesystem::path, 2> paths;
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    paths[party_id] = std::filesystem::temp_directory_path() /
+                      fmt::format("motion_test_stored_garbled_circuit_{}.store", party_id);
+  }
+  std::array<std::vector<encrypto::motion::BitVector<>>, 2> inputs;
+  for (auto& input : inputs) {
+    for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+      input.push_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    }
+  }
+
+  // garble the circuit ahead of time with a party that never runs
+  {
+    auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+    auto& garbler{parties[0]};
+    auto [input_share_0, input_promise_0] =
+        garbler->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(0, kNumberOfWires,
+                                                                    kNumberOfSimd);
+    auto [input_share_1, input_promise_1] =
+        garbler->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(1, kNumberOfWires,
+                                                                    kNumberOfSimd);
+    auto output{(encrypto::motion::ShareWrapper(input_share_0) &
+                 encrypto::motion::ShareWrapper(input_share_1))
+                    .Out()};
+    PreprocessingStoreWriter garbler_store(kSessionId, 0, 2), evaluator_store(kSessionId, 1, 2);
+    auto backend{garbler->GetBackend()};
+    dynamic_cast<ThreeHalvesGarblerProvider&>(backend->GetGarbledCircuitProvider())
+        .StoreGarbledCircuit(backend->GetRegister()->GetGates(), garbler_store, evaluator_store);
+    garbler_store.Write(paths[0]);
+    evaluator_store.Write(paths[1]);
+
+    std::vector<std::future<void>> futures;
+    for (auto& party : parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+    }
+    for (auto& future : futures) future.get();
+  }
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &parties, &paths, &inputs] {
+      auto& party{parties[party_id]};
+      auto store{std::make_shared<PreprocessingStore>(paths[party_id], kSessionId, party_id)};
+      auto& provider{party->GetBackend()->GetGarbledCircuitProvider()};
+      provider.LoadGarbledCircuit(store);
+      // neither the provider nor the store hand out the circuit a second time
+      EXPECT_THROW(provider.LoadGarbledCircuit(store), std::logic_error);
+      const auto kind{party_id == 0 ? PreprocessingKind::kGarbledCircuitGarbler
+                                    : PreprocessingKind::kGarbledCircuitEvaluator};
+      EXPECT_THROW(store->ConsumeGarbledCircuit(kind), std::runtime_error);
+
+      auto [input_share_0, input_promise_0] =
+          party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(0, kNumberOfWires,
+                                                                    kNumberOfSimd);
+      auto [input_share_1, input_promise_1] =
+          party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(1, kNumberOfWires,
+                                                                    kNumberOfSimd);
+      if (party_id == 0) {
+        input_promise_0->set_value(inputs[0]);
+      } else {
+        input_promise_1->set_value(inputs[1]);
+      }
+      auto output{(encrypto::motion::ShareWrapper(input_share_0) &
+                   encrypto::motion::ShareWrapper(input_share_1))
+                      .Out()};
+      party->Run();
+      for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+        EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(),
+                  inputs[0][i] & inputs[1][i]);
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+  for (const auto& path : paths) std::filesystem::remove(path);
+}
+
+TEST(GarbledCircuit, ParallelGarbling) {
+  // 37 SIMD values, such that the segments of the threads span several wires
+  constexpr std::size_t kNumberOfWires{5}, kNumberOfSimd{37};
+  std::array<std::vector<encrypto::motion::BitVector<>>, 2> inputs;
+  for (auto& input : inputs) {
+    for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+      input.push_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    }
+  }
+  for (auto scheme : {encrypto::motion::GarbledCircuitScheme::kThreeHalves,
+                      encrypto::motion::GarbledCircuitScheme::kHalfGates}) {
+    auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [party_id, scheme, &parties, &inputs] {
+        auto& party{parties[party_id]};
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetGarbledCircuitScheme(scheme);
+        party->GetConfiguration()->SetNumOfThreads(4);
+        party->GetConfiguration()->SetParallelGateThreshold(1);
+        auto [input_share_0, input_promise_0] =
+            party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(0, kNumberOfWires,
+                                                                      kNumberOfSimd);
+        auto [input_share_1, input_promise_1] =
+            party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(1, kNumberOfWires,
+                                                                      kNumberOfSimd);
+        if (party_id == 0) {
+          input_promise_0->set_value(inputs[0]);
+        } else {
+          input_promise_1->set_value(inputs[1]);
+        }
+        auto output{(encrypto::motion::ShareWrapper(input_share_0) &
+                     encrypto::motion::ShareWrapper(input_share_1))
+                        .Out()};
+        party->Run();
+        for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+          EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(),
+                    inputs[0][i] & inputs[1][i]);
+        }
+        party->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+}
+
 }  // namespace
@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "algorithm/histogram.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+#include "test_constants.h"
+
+namespace {
+
+using encrypto::motion::MpcProtocol;
+
+constexpr std::size_t kNumberOfRecords{50};
+
+// the counts and sums of the records in the bins first_bin, ..., first_bin + number_of_bins - 1
+std::pair<std::vector<std::uint32_t>, std::vector<std::uint32_t>> ExpectedHistogram(
+    const std::vector<std::uint16_t>& bins, const std::vector<std::uint32_t>& values,
+    std::size_t number_of_bins, std::size_t first_bin) {
+  std::vector<std::uint32_t> counts(number_of_bins, 0), sums(number_of_bins, 0);
+  for (std::size_t i = 0; i < bins.size(); ++i) {
+    if (bins[i] >= first_bin && bins[i] < first_bin + number_of_bins) {
+      ++counts[bins[i] - first_bin];
+      sums[bins[i] - first_bin] += values[i];
+    }
+  }
+  return {counts, sums};
+}
+
+// counts the bins of party 0 in protocol P and, for two parties, sums the values of party 1
+template <MpcProtocol P>
+void TestHistogram(std::size_t number_of_parties, std::size_t bin_bit_length,
+                   std::size_t number_of_bins, std::size_t first_bin) {
+  std::mt19937 random(bin_bit_length);
+  // some records are in none of the bins
+  std::uniform_int_distribution<std::uint16_t> bin_distribution(
+      0, std::min<std::size_t>(first_bin + number_of_bins + 2, (1 << bin_bit_length) - 1));
+  std::vector<std::uint16_t> bins(kNumberOfRecords);
+  std::vector<std::uint32_t> values(kNumberOfRecords);
+  for (auto& bin : bins) bin = bin_distribution(random);
+  for (auto& value : values) value = random();
+  const auto [expected_counts, expected_sums]{
+      ExpectedHistogram(bins, values, number_of_bins, first_bin)};
+
+  std::vector<encrypto::motion::PartyPointer> motion_parties(
+      encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(true);
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    threads.emplace_back([&, party_id]() {
+      auto& party{motion_parties.at(party_id)};
+      std::vector<encrypto::motion::BitVector<>> bin_bits(
+          bin_bit_length, encrypto::motion::BitVector<>(kNumberOfRecords));
+      if (party_id == 0) {
+        for (std::size_t i = 0; i < kNumberOfRecords; ++i) {
+          for (std::size_t bit_i = 0; bit_i < bin_bit_length; ++bit_i) {
+            bin_bits[bit_i].Set((bins[i] >> bit_i) & 1, i);
+          }
+        }
+      }
+      const encrypto::motion::ShareWrapper bin_shares{party->In<P>(bin_bits, 0)};
+      const auto counts{
+          encrypto::motion::algorithm::Histogram(bin_shares, number_of_bins, 32, first_bin).Out()};
+      encrypto::motion::ShareWrapper sums;
+      if (number_of_parties == 2) {
+        const encrypto::motion::ShareWrapper value_shares{party->In<MpcProtocol::kArithmeticGmw>(
+            party_id == 1 ? values : std::vector<std::uint32_t>(kNumberOfRecords), 1)};
+        sums = encrypto::motion::algorithm::GroupBySum(bin_shares, value_shares, number_of_bins,
+                                                       first_bin)
+                   .Out();
+      }
+      party->Run();
+      EXPECT_EQ(counts.As<std::vector<std::uint32_t>>(), expected_counts);
+      if (number_of_parties == 2) {
+        EXPECT_EQ(sums.As<std::vector<std::uint32_t>>(), expected_sums);
+      }
+      party->Finish();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+TEST(Histogram, LookupTableInBooleanGmw_2_parties) {
+  TestHistogram<MpcProtocol::kBooleanGmw>(2, 3, 8, 0);
+  TestHistogram<MpcProtocol::kBooleanGmw>(2, 4, 5, 3);
+}
+
+TEST(Histogram, CircuitInBooleanGmw_2_parties) {
+  TestHistogram<MpcProtocol::kBooleanGmw>(2, 10, 20, 0);
+}
+
+TEST(Histogram, CircuitInBooleanGmw_3_parties) {
+  TestHistogram<MpcProtocol::kBooleanGmw>(3, 4, 6, 2);
+}
+
+TEST(Histogram, CircuitInBmr_2_parties) { TestHistogram<MpcProtocol::kBmr>(2, 5, 7, 1); }
+
+}  // namespace
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "test_constants.h"
+
+#include "base/backend.h"
+#include "base/input_ingestion.h"
+#include "base/party.h"
+#include "communication/dummy_transport.h"
+#include "protocols/share_wrapper.h"
+
+namespace {
+
+using encrypto::motion::InputIngestion;
+using encrypto::motion::InputIngestionClient;
+using encrypto::motion::MakeLocallyConnectedParties;
+using encrypto::motion::communication::DummyTransport;
+using encrypto::motion::communication::Transport;
+
+TEST(InputIngestion, BatchesInputsOfManyClients) {
+  constexpr std::size_t kNumberOfParties{3}, kNumberOfClients{20}, kNumberOfValues{4};
+  std::mt19937_64 random(0);
+  std::vector<std::vector<std::uint32_t>> inputs(kNumberOfClients);
+  std::vector<std::uint32_t> expected;
+  for (auto& input : inputs) {
+    for (std::size_t i = 0; i < kNumberOfValues; ++i) {
+      input.push_back(static_cast<std::uint32_t>(random()));
+      expected.push_back(3 * input.back());
+    }
+  }
+
+  std::vector<std::unique_ptr<InputIngestion>> ingestions;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    ingestions.emplace_back(std::make_unique<InputIngestion>(party_id, kNumberOfParties));
+  }
+  // the clients submit concurrently in any order
+  std::vector<std::thread> clients;
+  for (std::size_t client_id = 0; client_id < kNumberOfClients; ++client_id) {
+    std::vector<std::unique_ptr<Transport>> client_transports;
+    for (auto& ingestion : ingestions) {
+      auto [client_transport, party_transport] = DummyTransport::MakeTransportPair();
+      client_transports.emplace_back(std::move(client_transport));
+      ingestion->AddClient(std::move(party_transport));
+    }
+    clients.emplace_back([&inputs, client_id, transports = std::move(client_transports)]() mutable {
+      InputIngestionClient client(std::move(transports));
+      client.Submit<std::uint32_t>(kNumberOfClients - 1 - client_id,
+                                   inputs[kNumberOfClients - 1 - client_id]);
+    });
+  }
+
+  std::vector<std::uint64_t> client_ids(kNumberOfClients);
+  std::iota(client_ids.begin(), client_ids.end(), 0);
+  auto motion_parties{MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      auto& party{*motion_parties.at(party_id)};
+      party.GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      encrypto::motion::ShareWrapper batch{
+          ingestions[party_id]->TakeBatch<std::uint32_t>(*party.GetBackend(), client_ids)};
+      EXPECT_EQ(ingestions[party_id]->GetNumberOfPendingSubmissions(), 0);
+      auto output{(batch + batch + batch).Out()};
+      party.Run();
+      EXPECT_EQ(output.As<std::vector<std::uint32_t>>(), expected);
+      party.Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+  for (auto& client : clients) client.join();
+}
+
+TEST(InputIngestion, RejectsMalformedInputs) {
+  InputIngestion ingestion(0, 2);
+  const std::vector<std::uint16_t> values{1, 2, 3};
+  auto messages{encrypto::motion::MakeClientInputMessages<std::uint16_t>(7, values, 2)};
+  ASSERT_EQ(messages.size(), 2);
+  // client 7 sends the values to party 1 and a seed to party 0
+  EXPECT_LT(messages[0].size(), messages[1].size());
+  auto truncated{messages[1]};
+  truncated.pop_back();
+  EXPECT_THROW(ingestion.Ingest(truncated), std::runtime_error);
+  ingestion.Ingest(messages[0]);
+  EXPECT_THROW(ingestion.Ingest(messages[0]), std::runtime_error);
+  EXPECT_EQ(ingestion.GetNumberOfPendingSubmissions(), 1);
+}
+
+}  // namespace
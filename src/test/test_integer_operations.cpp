@@ -24,13 +24,19 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <limits>
+#include <optional>
 #include <random>
 #include <type_traits>
 
 #include "algorithm/algorithm_description.h"
+#include "algorithm/binary_circuit.h"
+#include "algorithm/circuit_cache.h"
+#include "algorithm/flat_circuit.h"
 #include "base/party.h"
+#include "base/register.h"
 #include "protocols/bmr/bmr_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
 #include "protocols/share_wrapper.h"
@@ -82,6 +88,130 @@ TEST(AlgorithmDescription, FromBristolFormatIntAdd8Size) {
   EXPECT_EQ(gate33.selection_bit.has_value(), false);
 }
 
+TEST(AlgorithmDescription, BinaryCircuitRoundTrip) {
+  auto algorithm = encrypto::motion::AlgorithmDescription::FromBristol(
+      std::string(encrypto::motion::kRootDir) + "/circuits/int/int_sub32_depth.bristol");
+  const auto path{std::filesystem::temp_directory_path() / "motion_test_binary_circuit.mbc"};
+
+  auto expect_equal = [](const AlgorithmDescription& a, const AlgorithmDescription& b) {
+    EXPECT_EQ(a.number_of_gates, b.number_of_gates);
+    EXPECT_EQ(a.number_of_wires, b.number_of_wires);
+    EXPECT_EQ(a.number_of_input_wires_parent_a, b.number_of_input_wires_parent_a);
+    EXPECT_EQ(a.number_of_input_wires_parent_b, b.number_of_input_wires_parent_b);
+    EXPECT_EQ(a.number_of_output_wires, b.number_of_output_wires);
+    ASSERT_EQ(a.gates.size(), b.gates.size());
+    for (std::size_t i = 0; i < a.gates.size(); ++i) {
+      EXPECT_TRUE(a.gates[i].type == b.gates[i].type);
+      EXPECT_EQ(a.gates[i].parent_a, b.gates[i].parent_a);
+      EXPECT_EQ(a.gates[i].parent_b, b.gates[i].parent_b);
+      EXPECT_EQ(a.gates[i].selection_bit, b.gates[i].selection_bit);
+      EXPECT_EQ(a.gates[i].output_wire, b.gates[i].output_wire);
+    }
+  };
+
+  WriteBinaryCircuit(algorithm, path);
+  expect_equal(algorithm, AlgorithmDescription::FromBinary(path));
+  {
+    // the flat circuit is built from the mapped gates without an AlgorithmDescription
+    const MappedBinaryCircuit binary_circuit(path);
+    EXPECT_EQ(binary_circuit.GetGates().size(), algorithm.gates.size());
+    const auto expected{FlatCircuit::FromAlgorithmDescription(algorithm)};
+    const auto flat_circuit{FlatCircuit::FromBinaryCircuit(binary_circuit)};
+    EXPECT_EQ(flat_circuit.number_of_input_wires, expected.number_of_input_wires);
+    EXPECT_TRUE(flat_circuit.opcodes == expected.opcodes);
+    EXPECT_EQ(flat_circuit.parents_a, expected.parents_a);
+    EXPECT_EQ(flat_circuit.parents_b, expected.parents_b);
+    EXPECT_EQ(flat_circuit.outputs, expected.outputs);
+    EXPECT_EQ(flat_circuit.layer_begins, expected.layer_begins);
+    EXPECT_EQ(flat_circuit.local_begins, expected.local_begins);
+  }
+
+  // selection bits and a missing second input party are kept
+  algorithm.number_of_input_wires_parent_b = std::nullopt;
+  algorithm.gates.push_back({.type = PrimitiveOperationType::kMux,
+                             .parent_a = 1,
+                             .parent_b = 2,
+                             .selection_bit = 3,
+                             .output_wire = algorithm.number_of_wires - 1});
+  ++algorithm.number_of_gates;
+  WriteBinaryCircuit(algorithm, path);
+  expect_equal(algorithm, AlgorithmDescription::FromBinary(path));
+
+  // truncated files are rejected
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  EXPECT_THROW(AlgorithmDescription::FromBinary(path), std::runtime_error);
+  std::filesystem::remove(path);
+  EXPECT_THROW(AlgorithmDescription::FromBinary(path), std::runtime_error);
+}
+
+TEST(CircuitCache, LoadsCircuitsByContent) {
+  using encrypto::motion::CircuitCache;
+  using encrypto::motion::CircuitFormat;
+  const std::string path{std::string(encrypto::motion::kRootDir) +
+                         "/circuits/int/int_add8_depth.bristol"};
+  const auto directory{std::filesystem::temp_directory_path() / "motion_test_circuit_cache"};
+  const auto copy_path{std::filesystem::temp_directory_path() / "motion_test_circuit_copy.bristol"};
+  std::filesystem::remove_all(directory);
+  std::filesystem::copy_file(path, copy_path, std::filesystem::copy_options::overwrite_existing);
+  const auto expected{AlgorithmDescription::FromBristol(path)};
+  auto expect_equal = [&expected](const AlgorithmDescription& algorithm) {
+    EXPECT_EQ(algorithm.number_of_wires, expected.number_of_wires);
+    EXPECT_EQ(algorithm.number_of_output_wires, expected.number_of_output_wires);
+    ASSERT_EQ(algorithm.gates.size(), expected.gates.size());
+    for (std::size_t i = 0; i < algorithm.gates.size(); ++i) {
+      EXPECT_TRUE(algorithm.gates[i].type == expected.gates[i].type);
+      EXPECT_EQ(algorithm.gates[i].parent_a, expected.gates[i].parent_a);
+      EXPECT_EQ(algorithm.gates[i].parent_b, expected.gates[i].parent_b);
+      EXPECT_EQ(algorithm.gates[i].output_wire, expected.gates[i].output_wire);
+    }
+    EXPECT_TRUE(algorithm.schedule != nullptr);
+  };
+
+  const auto key{CircuitCache::ComputeKey(path, CircuitFormat::kBristol, false)};
+  EXPECT_EQ(key, CircuitCache::ComputeKey(copy_path, CircuitFormat::kBristol, false));
+  EXPECT_NE(key, CircuitCache::ComputeKey(path, CircuitFormat::kBristol, true));
+  EXPECT_NE(key, CircuitCache::ComputeKey(path, CircuitFormat::kBristolFashion, false));
+  {
+    CircuitCache cache(directory);
+    const auto algorithm{cache.Load(path, CircuitFormat::kBristol)};
+    expect_equal(*algorithm);
+    EXPECT_TRUE(std::filesystem::exists(directory / (key + ".mbc")));
+    // the same contents under another path are not parsed again
+    EXPECT_TRUE(cache.Load(copy_path, CircuitFormat::kBristol) == algorithm);
+    EXPECT_TRUE(cache.Load(path, CircuitFormat::kBristol, true) != algorithm);
+    const auto statistics{cache.GetStatistics()};
+    EXPECT_EQ(statistics.number_of_memory_hits, 1);
+    EXPECT_EQ(statistics.number_of_disk_hits, 0);
+    EXPECT_EQ(statistics.number_of_misses, 2);
+  }
+  {
+    // a new cache, e.g., of a restarted process, starts warm
+    CircuitCache cache(directory);
+    expect_equal(*cache.Load(copy_path, CircuitFormat::kBristol));
+    EXPECT_EQ(cache.GetStatistics().number_of_disk_hits, 1);
+  }
+  {
+    // broken cached files are replaced
+    std::ofstream(directory / (key + ".mbc"), std::ios::trunc) << "garbage";
+    CircuitCache cache(directory);
+    expect_equal(*cache.Load(path, CircuitFormat::kBristol));
+    EXPECT_EQ(cache.GetStatistics().number_of_misses, 1);
+    expect_equal(AlgorithmDescription::FromBinary((directory / (key + ".mbc")).string()));
+  }
+  {
+    // the register caches by path and loads through the circuit cache
+    encrypto::motion::Register register_object(nullptr);
+    register_object.SetCircuitCache(std::make_shared<CircuitCache>(directory));
+    const auto algorithm{register_object.LoadAlgorithmDescription(path, CircuitFormat::kBristol)};
+    expect_equal(*algorithm);
+    EXPECT_TRUE(register_object.GetCachedAlgorithmDescription(path) == algorithm);
+  }
+  EXPECT_THROW(CircuitCache(directory).Load(directory / "missing.bristol", CircuitFormat::kBristol),
+               std::runtime_error);
+  std::filesystem::remove_all(directory);
+  std::filesystem::remove(copy_path);
+}
+
 // TODO: rewrite as generic tests
 template <typename T>
 class SecureUintTest : public ::testing::Test {
@@ -896,6 +1026,122 @@ TYPED_TEST(SecureUintTest, DivisionInGarbledCircuit) {
     if (t.joinable()) t.join();
 }
 
+TYPED_TEST(SecureUintTest, DivisionInArithmeticGmw) {
+  using T = TypeParam;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  constexpr std::size_t kNumberOfSimd{8};
+  std::mt19937 mersenne_twister(sizeof(T));
+  // the operands of secret divisors have to be smaller than 2^((k - 3) / 2 - 3) and the dividends
+  // of public divisors smaller than 2^((k - 1) / 2)
+  constexpr T kSecretBound{T(1) << (std::max<std::size_t>((kBitLength - 3) / 2, 4) - 3)};
+  constexpr T kPublicBound{T(1) << ((kBitLength - 1) / 2)};
+  std::uniform_int_distribution<T> distribution_secret(1, kSecretBound - 1);
+  std::uniform_int_distribution<T> distribution_public(0, kPublicBound - 1);
+  std::vector<T> secret_dividends(kNumberOfSimd), secret_divisors(kNumberOfSimd),
+      public_dividends(kNumberOfSimd);
+  for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+    secret_dividends[i] = i == 0 ? 0 : distribution_secret(mersenne_twister);
+    secret_divisors[i] =
+        i == 1 ? 1 : i == 2 ? secret_dividends[i] : distribution_secret(mersenne_twister);
+    public_dividends[i] = i == 0 ? kPublicBound - 1 : distribution_public(mersenne_twister);
+  }
+  const std::vector<T> public_divisors{1, 3, 10, static_cast<T>(kPublicBound - 1), kPublicBound};
+  const std::vector<T> dummy_input(kNumberOfSimd, 0);
+
+  std::vector<PartyPointer> parties(std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+  for (auto& party : parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(true);
+  }
+
+  std::vector<std::thread> threads;
+  for (auto party_id = 0u; party_id < parties.size(); ++party_id) {
+    threads.emplace_back([party_id, &parties, &secret_dividends, &secret_divisors,
+                          &public_dividends, &public_divisors, &dummy_input]() {
+      auto& party{parties.at(party_id)};
+      const bool party_0 = party->GetConfiguration()->GetMyId() == 0;
+      encrypto::motion::SecureUnsignedInteger
+          dividend = party->In<kArithmeticGmw>(party_0 ? public_dividends : dummy_input, 0),
+          secret_dividend = party->In<kArithmeticGmw>(party_0 ? secret_dividends : dummy_input, 0),
+          secret_divisor = party->In<kArithmeticGmw>(party_0 ? dummy_input : secret_divisors, 1);
+      std::vector<encrypto::motion::SecureUnsignedInteger> public_quotients;
+      for (const T divisor : public_divisors) {
+        public_quotients.emplace_back((dividend / divisor).Out());
+      }
+      std::optional<encrypto::motion::SecureUnsignedInteger> secret_quotient;
+      if constexpr (kBitLength >= 32) secret_quotient = (secret_dividend / secret_divisor).Out();
+
+      party->Run();
+
+      for (std::size_t i = 0; i < public_divisors.size(); ++i) {
+        const auto result{public_quotients[i].As<std::vector<T>>()};
+        ASSERT_EQ(result.size(), public_dividends.size());
+        for (std::size_t simd_i = 0; simd_i < kNumberOfSimd; ++simd_i) {
+          EXPECT_EQ(result[simd_i], public_dividends[simd_i] / public_divisors[i]);
+        }
+      }
+      if (secret_quotient) {
+        const auto result{secret_quotient->As<std::vector<T>>()};
+        ASSERT_EQ(result.size(), secret_dividends.size());
+        for (std::size_t simd_i = 0; simd_i < kNumberOfSimd; ++simd_i) {
+          EXPECT_EQ(result[simd_i], secret_dividends[simd_i] / secret_divisors[simd_i]);
+        }
+      }
+      party->Finish();
+    });
+  }
+  for (auto& t : threads)
+    if (t.joinable()) t.join();
+}
+
+TYPED_TEST(SecureUintTest, DivisionByConstantInGmw) {
+  using T = TypeParam;
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd{8};
+  std::mt19937 mersenne_twister(sizeof(T));
+  std::uniform_int_distribution<T> distribution(0, std::numeric_limits<T>::max());
+  std::vector<T> dividends(kNumberOfSimd);
+  for (auto& dividend : dividends) dividend = distribution(mersenne_twister);
+  dividends[0] = std::numeric_limits<T>::max();
+  const std::vector<T> divisors{1, 3, 8, 10, std::numeric_limits<T>::max()};
+  const auto input{encrypto::motion::ToInput(dividends)};
+  const std::vector<encrypto::motion::BitVector<>> dummy_input(
+      sizeof(T) * 8, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+
+  std::vector<PartyPointer> parties(std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+  for (auto& party : parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(true);
+  }
+
+  std::vector<std::thread> threads;
+  for (auto party_id = 0u; party_id < parties.size(); ++party_id) {
+    threads.emplace_back([party_id, &parties, &dividends, &divisors, &input, &dummy_input]() {
+      auto& party{parties.at(party_id)};
+      const bool party_0 = party->GetConfiguration()->GetMyId() == 0;
+      encrypto::motion::SecureUnsignedInteger dividend =
+          party->In<kBooleanGmw>(party_0 ? input : dummy_input, 0);
+      std::vector<encrypto::motion::SecureUnsignedInteger> quotients;
+      for (const T divisor : divisors) quotients.emplace_back((dividend / divisor).Out());
+      EXPECT_THROW(dividend / std::uint64_t(0), std::invalid_argument);
+
+      party->Run();
+
+      for (std::size_t i = 0; i < divisors.size(); ++i) {
+        const auto result{quotients[i].As<std::vector<T>>()};
+        ASSERT_EQ(result.size(), dividends.size());
+        for (std::size_t simd_i = 0; simd_i < kNumberOfSimd; ++simd_i) {
+          EXPECT_EQ(result[simd_i], dividends[simd_i] / divisors[i]);
+        }
+      }
+      party->Finish();
+    });
+  }
+  for (auto& t : threads)
+    if (t.joinable()) t.join();
+}
+
 TYPED_TEST(SecureUintTest, EqualityInBmr) {
   using T = TypeParam;
   constexpr auto kBmr = encrypto::motion::MpcProtocol::kBmr;
@@ -238,6 +238,51 @@ TEST_P(Kk13ObliviousTransferTest, General1ooNKk13OtsFromKk13OtExtension) {
     }
 }
 
+TEST(Kk13ObliviousTransfer, ConfigurableCodeBitLength) {
+  constexpr std::size_t kNumberOfParties{2}, kNumberOfOts{300};
+  EXPECT_THROW(Configuration(0, kNumberOfParties).SetKk13CodeBitLength(384),
+               std::invalid_argument);
+  for (std::size_t code_bit_length : {128, 512}) {
+    // messages shorter and longer than the code words
+    for (std::size_t bitlength : {64, 700}) {
+      const std::size_t number_of_messages{std::min<std::size_t>(code_bit_length, 256)};
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)));
+      std::array<std::unique_ptr<RKk13OtSender>, kNumberOfParties> sender_ot;
+      std::array<std::unique_ptr<RKk13OtReceiver>, kNumberOfParties> receiver_ot;
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetKk13CodeBitLength(code_bit_length);
+      }
+      std::vector<std::thread> threads(kNumberOfParties);
+      for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+        threads[i] = std::thread([&, i]() {
+          auto& ot_provider{motion_parties[i]->GetBackend()->GetKk13OtProvider(1 - i)};
+          sender_ot[i] = ot_provider.RegisterSendROt(kNumberOfOts, bitlength, number_of_messages);
+          receiver_ot[i] =
+              ot_provider.RegisterReceiveROt(kNumberOfOts, bitlength, number_of_messages);
+          motion_parties[i]->Run();
+          motion_parties[i]->Finish();
+        });
+      }
+      for (auto& t : threads) t.join();
+
+      for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+        sender_ot[i]->ComputeOutputs();
+        receiver_ot[1 - i]->ComputeOutputs();
+        const auto sender_messages{sender_ot[i]->GetOutputs()};
+        const auto receiver_messages{receiver_ot[1 - i]->GetOutputs()};
+        const auto& choices{receiver_ot[1 - i]->GetChoices()};
+        for (std::size_t l = 0; l < kNumberOfOts; ++l) {
+          const std::size_t c{choices[l]};
+          EXPECT_EQ(receiver_messages[l],
+                    sender_messages[l].Subset(c * bitlength, (c + 1) * bitlength));
+        }
+      }
+    }
+  }
+}
+
 using Kk13OtParallelParametersType = std::tuple<std::size_t, std::size_t>;
 
 class Kk13OtParallelTest : public testing::TestWithParam<Kk13OtParallelParametersType> {
@@ -21,7 +21,11 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <random>
+#include <utility>
 #include "algorithm/low_depth_reduce.h"
 
 /**
@@ -115,6 +119,99 @@ TEST_P(LowDepthReduceTest, BitwiseAdd) {
   ASSERT_EQ(result_add, expected_add);
 }
 
+/**
+ * Mock of a share with SIMD values for SimdLowDepthReduce and Scan, which records the depth of the
+ * operations on whole shares, i.e., of the gates, and counts the gates.
+ */
+template <typename T>
+struct SimdValues {
+  std::vector<T> values;
+  std::size_t depth = 0;
+  static inline std::size_t number_of_gates = 0;
+
+  const SimdValues* operator->() const { return this; }
+
+  std::size_t GetNumberOfSimdValues() const { return values.size(); }
+
+  SimdValues Subset(std::vector<std::size_t>&& positions) const {
+    ++number_of_gates;
+    SimdValues result{{}, depth};
+    for (auto position : positions) result.values.push_back(values.at(position));
+    return result;
+  }
+
+  static SimdValues Simdify(std::vector<SimdValues>&& input) {
+    ++number_of_gates;
+    SimdValues result;
+    for (auto& share : input) {
+      result.values.insert(result.values.end(), share.values.begin(), share.values.end());
+      result.depth = std::max(result.depth, share.depth);
+    }
+    return result;
+  }
+};
+
+template <typename T, typename BinaryOperation>
+auto SimdOperation(BinaryOperation operation) {
+  return [operation](const SimdValues<T>& left, const SimdValues<T>& right) {
+    ++SimdValues<T>::number_of_gates;
+    EXPECT_EQ(left.values.size(), right.values.size());
+    SimdValues<T> result{{}, std::max(left.depth, right.depth) + 1};
+    for (std::size_t i = 0; i < left.values.size(); ++i) {
+      result.values.push_back(operation(left.values[i], right.values[i]));
+    }
+    return result;
+  };
+}
+
+// composition of the affine maps x -> a * x + b given as pairs (a, b), which is not commutative
+using AffineMap = std::pair<std::uint32_t, std::uint32_t>;
+AffineMap Compose(const AffineMap& first, const AffineMap& second) {
+  return {first.first * second.first, first.second * second.first + second.second};
+}
+
+TEST_P(LowDepthReduceTest, SimdReduceInLogarithmicDepthAndGates) {
+  const auto expected_depth{static_cast<std::size_t>(std::ceil(std::log2(size)))};
+  SimdValues<std::uint32_t>::number_of_gates = 0;
+  const auto result{SimdLowDepthReduce(SimdValues<std::uint32_t>{integer_values},
+                                       SimdOperation<std::uint32_t>(std::plus<>()))};
+  ASSERT_EQ(result.values.size(), 1);
+  EXPECT_EQ(result.values[0], LowDepthReduce(integer_values, std::plus<>()));
+  EXPECT_EQ(result.depth, expected_depth);
+  // two subsets and the operation per level and a subset and a simdify for odd values
+  EXPECT_LE(SimdValues<std::uint32_t>::number_of_gates, 5 * expected_depth);
+
+  std::vector<AffineMap> maps;
+  for (std::size_t i = 0; i < integer_values.size(); ++i) {
+    maps.emplace_back(integer_values[i], integer_values[(i + 1) % integer_values.size()]);
+  }
+  const auto map_result{
+      SimdLowDepthReduce(SimdValues<AffineMap>{maps}, SimdOperation<AffineMap>(Compose))};
+  EXPECT_TRUE(map_result.values.at(0) == LowDepthReduce(maps, Compose));
+}
+
+TEST_P(LowDepthReduceTest, ScanInLogarithmicDepthAndGates) {
+  const auto expected_depth{static_cast<std::size_t>(std::ceil(std::log2(size)))};
+  SimdValues<std::uint32_t>::number_of_gates = 0;
+  const auto result{Scan(SimdValues<std::uint32_t>{integer_values},
+                         SimdOperation<std::uint32_t>(std::plus<>()))};
+  std::vector<std::uint32_t> expected(integer_values.size());
+  std::inclusive_scan(integer_values.begin(), integer_values.end(), expected.begin());
+  EXPECT_EQ(result.values, expected);
+  EXPECT_EQ(result.depth, expected_depth);
+  // two subsets, the operation, a simdify and a subset per level
+  EXPECT_EQ(SimdValues<std::uint32_t>::number_of_gates, 5 * expected_depth);
+
+  std::vector<AffineMap> maps;
+  for (std::size_t i = 0; i < integer_values.size(); ++i) {
+    maps.emplace_back(integer_values[i], integer_values[(i + 1) % integer_values.size()]);
+  }
+  std::vector<AffineMap> expected_maps(maps.size());
+  std::inclusive_scan(maps.begin(), maps.end(), expected_maps.begin(), Compose);
+  EXPECT_TRUE(Scan(SimdValues<AffineMap>{maps}, SimdOperation<AffineMap>(Compose)).values ==
+              expected_maps);
+}
+
 INSTANTIATE_TEST_SUITE_P(LowDepthReduceTestParameters, LowDepthReduceTest,
                          testing::Values(1, 2, 3, 4, 7, 8, 16, 17, 23, 32, 53, 64, 100,
                                          999999));  // Different sizes for the vector inputs
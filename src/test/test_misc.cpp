@@ -22,16 +22,44 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <future>
+#include <map>
+#include <optional>
+#include <set>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+#include <boost/json.hpp>
+
+#include "base/auto_tuner.h"
+#include "base/register.h"
+#include "data_storage/preprocessing_plan.h"
+#include "statistics/cost_estimate.h"
+#include "statistics/critical_path.h"
+#include "statistics/metrics.h"
+#include "statistics/performance_comparison.h"
 #include "test_constants.h"
 #include "utility/bit_vector.h"
+#include "utility/block.h"
 #include "utility/condition.h"
+#include "utility/contention_tracing.h"
+#include "utility/fiber_signal.h"
+#include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
 #include "utility/helpers.h"
+#include "utility/logger.h"
+#include "utility/mpsc_fiber_queue.h"
+#include "utility/object_arena.h"
+#include "utility/profiled_wait.h"
+#include "utility/synchronized_queue.h"
 
 namespace {
 TEST(Condition, WaitNotifyOne) {
@@ -292,4 +320,557 @@ TYPED_TEST(TwosComplementTest, Conversion) {
   }
 }
 
-}  // namespace
\ No newline at end of file
+TEST(FiberThreadPool, PinnedWorkersRunAllTasks) {
+  constexpr std::size_t kNumberOfTasks = 1000;
+  for (auto pin_threads : {false, true}) {
+    std::atomic<std::size_t> counter = 0;
+    encrypto::motion::FiberThreadPool fiber_pool(2, 0, true, pin_threads);
+    for (std::size_t i = 0; i < kNumberOfTasks; ++i) {
+      fiber_pool.post([&counter] { ++counter; });
+    }
+    while (counter != kNumberOfTasks) {
+      std::this_thread::yield();
+    }
+    fiber_pool.join();
+    EXPECT_EQ(counter, kNumberOfTasks);
+  }
+}
+
+TEST(FiberThreadPool, PostBlocksOnAFullTaskQueue) {
+  constexpr std::size_t kNumberOfTasks = 1000;
+  std::atomic<std::size_t> counter = 0;
+  // far more tasks than the queue holds, including tasks that post further tasks from a fiber
+  encrypto::motion::FiberThreadPool fiber_pool(2, 2);
+  for (std::size_t i = 0; i < kNumberOfTasks; ++i) {
+    fiber_pool.post([&fiber_pool, &counter] {
+      ++counter;
+      fiber_pool.post([&counter] { ++counter; });
+    });
+  }
+  fiber_pool.wait_idle();
+  EXPECT_EQ(counter, 2 * kNumberOfTasks);
+  fiber_pool.join();
+}
+
+TEST(FiberThreadPool, WaitIdleKeepsPoolReusable) {
+  constexpr std::size_t kNumberOfTasks = 100;
+  std::atomic<std::size_t> counter = 0;
+  encrypto::motion::FiberThreadPool fiber_pool(
+      2, 0, true, false, encrypto::motion::FiberStackAllocator::kPooledFixedSize);
+  for (std::size_t round = 1; round <= 3; ++round) {
+    for (std::size_t i = 0; i < kNumberOfTasks; ++i) {
+      fiber_pool.post([&counter] { ++counter; });
+    }
+    fiber_pool.wait_idle();
+    EXPECT_EQ(counter, round * kNumberOfTasks);
+  }
+  fiber_pool.join();
+}
+
+TEST(FiberSignal, WakesUpAllWaitingFibers) {
+  constexpr std::size_t kNumberOfSignals = 100, kNumberOfWaiters = 16;
+  std::vector<std::unique_ptr<encrypto::motion::FiberSignal>> signals;
+  for (std::size_t i = 0; i < kNumberOfSignals; ++i) {
+    signals.emplace_back(std::make_unique<encrypto::motion::FiberSignal>());
+  }
+  std::atomic<std::size_t> counter = 0;
+  encrypto::motion::FiberThreadPool fiber_pool(2);
+  for (std::size_t i = 0; i < kNumberOfWaiters; ++i) {
+    fiber_pool.post([&signals, &counter] {
+      for (const auto& signal : signals) signal->Wait();
+      ++counter;
+    });
+  }
+  for (std::size_t i = 0; i < kNumberOfSignals; ++i) {
+    EXPECT_TRUE(signals[i]->Set());
+    EXPECT_FALSE(signals[i]->Set());
+    if (i % 10 == 0) std::this_thread::yield();
+  }
+  fiber_pool.wait_idle();
+  EXPECT_EQ(counter, kNumberOfWaiters);
+  fiber_pool.join();
+
+  // waiting on a set signal returns immediately
+  signals[0]->Wait();
+  signals[0]->Reset();
+  EXPECT_FALSE(signals[0]->IsSet());
+}
+
+TEST(ProfiledWait, AccountsOnlyBlockingWaits) {
+  encrypto::motion::FiberSignal signal;
+  encrypto::motion::WaitTimes wait_times;
+  auto previous{encrypto::motion::SetFiberWaitTimes(&wait_times)};
+  auto setter = std::async(std::launch::async, [&signal] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    signal.Set();
+  });
+  signal.Wait();
+  setter.get();
+  const auto dependencies{wait_times.dependencies};
+  EXPECT_GE(dependencies, std::chrono::milliseconds(10));
+  // waiting on a set signal does not block
+  signal.Wait();
+  EXPECT_EQ(wait_times.dependencies, dependencies);
+  EXPECT_EQ(wait_times.messages.count(), 0);
+  EXPECT_EQ(wait_times.preprocessing.count(), 0);
+  encrypto::motion::SetFiberWaitTimes(previous);
+}
+
+TEST(Logger, FastPathWritesBufferedMessagesInOrder) {
+  using encrypto::motion::detail::LogRingBuffer;
+  // a party id that no other test uses, such that the log file can be identified
+  constexpr std::size_t kLoggerId{4711};
+  constexpr std::size_t kNumberOfMessages{2 * LogRingBuffer::kCapacity};
+  const auto log_file_prefix{fmt::format("id{}_", kLoggerId)};
+  {
+    encrypto::motion::Logger logger(kLoggerId, boost::log::trivial::info);
+    EXPECT_FALSE(logger.ShouldLog(boost::log::trivial::debug));
+    EXPECT_TRUE(logger.ShouldLog(boost::log::trivial::info));
+    // filtered before formatting
+    logger.LogDebug("hidden {}", 0);
+    // more messages than fit into the ring buffer of a thread
+    std::thread producer([&logger] {
+      for (std::size_t i = 0; i < kNumberOfMessages; ++i) logger.LogInfo("message {}", i);
+    });
+    producer.join();
+    logger.LogError("{}", std::string(2 * LogRingBuffer::kMessageSize, 'x'));
+  }
+
+  std::vector<std::string> lines;
+  for (const auto& entry : std::filesystem::directory_iterator("log")) {
+    if (!entry.path().filename().string().starts_with(log_file_prefix)) continue;
+    std::ifstream file(entry.path());
+    for (std::string line; std::getline(file, line);) lines.push_back(line);
+    file.close();
+    std::filesystem::remove(entry.path());
+  }
+  ASSERT_EQ(lines.size(), kNumberOfMessages + 1);
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    EXPECT_TRUE(lines[i].ends_with(fmt::format("<info> message {}", i)));
+  }
+  // truncated to the size of an entry
+  EXPECT_TRUE(lines.back().ends_with(
+      "<error> " + std::string(LogRingBuffer::kMessageSize, 'x')));
+}
+
+TEST(ContentionTracer, RecordsBlockingWaitsAndWakeUpsPerCallSite) {
+  using encrypto::motion::WaitPrimitive;
+  encrypto::motion::FiberSignal signal;
+  encrypto::motion::SynchronizedFiberQueue<int> queue;
+  // not recorded, no session is open
+  signal.Set();
+  signal.Wait();
+  signal.Reset();
+
+  encrypto::motion::ContentionTracer::BeginSession();
+  auto setter = std::async(std::launch::async, [&signal, &queue] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    signal.Set();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.enqueue(42);
+  });
+  signal.Wait();
+  EXPECT_EQ(queue.dequeue(), 42);
+  setter.get();
+  // neither blocks nor wakes anyone
+  signal.Wait();
+  queue.enqueue(43);
+  EXPECT_EQ(queue.dequeue(), 43);
+  const auto report{encrypto::motion::ContentionTracer::EndSession()};
+  EXPECT_FALSE(encrypto::motion::ContentionTracer::IsEnabled());
+
+  std::size_t number_of_waits{0}, number_of_woken_waiters{0};
+  for (const auto& site : report.sites) {
+    EXPECT_TRUE(site.primitive == WaitPrimitive::kFiberSignal ||
+                site.primitive == WaitPrimitive::kSynchronizedFiberQueue);
+    EXPECT_NE(site.file_name.find("test_misc.cpp"), std::string::npos);
+    number_of_waits += site.number_of_waits;
+    number_of_woken_waiters += site.number_of_woken_waiters;
+    if (site.number_of_waits > 0) {
+      EXPECT_GE(site.total_wait_time, std::chrono::milliseconds(10));
+      EXPECT_LE(site.max_wait_time, site.total_wait_time);
+    }
+  }
+  // one wait and one wake-up site per primitive
+  EXPECT_EQ(report.sites.size(), 4);
+  EXPECT_EQ(number_of_waits, 2);
+  EXPECT_EQ(number_of_woken_waiters, 2);
+  const auto printed{report.PrintTopN(1)};
+  EXPECT_NE(printed.find("top 1 of 2 call sites by total wait time"), std::string::npos);
+}
+
+TEST(MpscFiberQueue, KeepsTheOrderOfEachProducer) {
+  constexpr std::size_t kNumberOfProducers{4}, kNumberOfItems{10000};
+  encrypto::motion::MpscFiberQueue<std::pair<std::size_t, std::size_t>> queue;
+  std::vector<std::thread> producers;
+  for (std::size_t producer_i = 0; producer_i < kNumberOfProducers; ++producer_i) {
+    producers.emplace_back([&queue, producer_i] {
+      for (std::size_t item_i = 0; item_i < kNumberOfItems; ++item_i) {
+        queue.enqueue({producer_i, item_i});
+      }
+    });
+  }
+  std::vector<std::size_t> next_items(kNumberOfProducers, 0);
+  for (std::size_t number_of_items = 0; number_of_items < kNumberOfProducers * kNumberOfItems;) {
+    auto items{queue.BatchDequeue()};
+    ASSERT_TRUE(items.has_value());
+    for (; !items->empty(); items->pop(), ++number_of_items) {
+      const auto [producer_i, item_i]{items->front()};
+      EXPECT_EQ(item_i, next_items[producer_i]++);
+    }
+  }
+  for (auto& producer : producers) producer.join();
+  EXPECT_TRUE(queue.empty());
+
+  // a parked consumer is woken by close
+  auto consumer{std::async(std::launch::async, [&queue] { return queue.BatchDequeue(); })};
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.close();
+  EXPECT_FALSE(consumer.get().has_value());
+  EXPECT_TRUE(queue.IsClosedAndEmpty());
+  EXPECT_THROW(queue.enqueue({0, 0}), std::logic_error);
+}
+
+TEST(CriticalPath, SplitsLatencyAlongTheLastFinishingDependencies) {
+  using encrypto::motion::GateProfile;
+  using std::chrono::microseconds;
+  const auto t0{GateProfile::ClockType::now()};
+  auto make_event = [t0](std::int64_t gate_id, GateProfile::Phase phase,
+                         std::vector<std::int64_t> parent_gate_ids, microseconds start,
+                         microseconds end, microseconds dependencies, microseconds messages) {
+    GateProfile::Event event;
+    event.gate_type = "Gate" + std::to_string(gate_id);
+    event.gate_id = gate_id;
+    event.depth = gate_id;
+    event.parent_gate_ids = std::move(parent_gate_ids);
+    event.phase = phase;
+    event.start = t0 + start;
+    event.end = t0 + end;
+    event.wait_times.dependencies = dependencies;
+    event.wait_times.messages = messages;
+    return event;
+  };
+  constexpr auto kSetup{GateProfile::Phase::kSetup};
+  constexpr auto kOnline{GateProfile::Phase::kOnline};
+  GateProfile profile;
+  // an input gate, an interactive gate with a setup phase, and an output gate
+  profile.events.push_back(make_event(0, kOnline, {}, microseconds(0), microseconds(1000),
+                                      microseconds(0), microseconds(0)));
+  profile.events.push_back(make_event(1, kSetup, {}, microseconds(0), microseconds(2000),
+                                      microseconds(0), microseconds(0)));
+  profile.events.push_back(make_event(1, kOnline, {0}, microseconds(500), microseconds(6000),
+                                      microseconds(1500), microseconds(3000)));
+  profile.events.push_back(make_event(2, kOnline, {1}, microseconds(6500), microseconds(9000),
+                                      microseconds(0), microseconds(2000)));
+
+  const auto path{encrypto::motion::ComputeCriticalPath(profile)};
+  ASSERT_EQ(path.steps.size(), 3);
+  EXPECT_EQ(path.steps[0].event_index, 1);
+  EXPECT_EQ(path.steps[1].event_index, 2);
+  EXPECT_EQ(path.steps[2].event_index, 3);
+  EXPECT_EQ(path.latency, microseconds(9000));
+  EXPECT_EQ(path.preprocessing, microseconds(2000));
+  EXPECT_EQ(path.network, microseconds(5000));
+  EXPECT_EQ(path.compute, microseconds(1500));
+  EXPECT_EQ(path.scheduling, microseconds(500));
+  EXPECT_NE(path.PrintHumanReadable(profile).find("Gate1 online"), std::string::npos);
+}
+
+TEST(MetricsRegistry, ExposesCountersHistogramsAndCollectors) {
+  auto registry{std::make_shared<encrypto::motion::MetricsRegistry>()};
+  auto& counter{registry->GetCounter("test_events", "Events", {{"party", "0"}})};
+  EXPECT_EQ(&counter, &registry->GetCounter("test_events", "Events", {{"party", "0"}}));
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&counter] {
+      for (std::size_t j = 0; j < 1000; ++j) counter.Add();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(counter.Get(), 4000u);
+
+  auto& histogram{registry->GetHistogram("test_sizes", "Sizes")};
+  histogram.Observe(0);
+  histogram.Observe(3);
+  histogram.Observe(4);
+  EXPECT_EQ(histogram.GetSum(), 7u);
+
+  std::optional<encrypto::motion::MetricsCollectorHandle> handle{
+      registry->AddCollector([](encrypto::motion::MetricsSnapshot& snapshot) {
+        snapshot.AddGauge("test_level", "Level", {{"name", "a\"b"}}, 5);
+      })};
+  auto metrics{registry->ToOpenMetrics()};
+  EXPECT_NE(metrics.find("# TYPE test_events counter\n"), std::string::npos);
+  EXPECT_NE(metrics.find("test_events_total{party=\"0\"} 4000\n"), std::string::npos);
+  EXPECT_NE(metrics.find("test_sizes_bucket{le=\"0\"} 1\n"), std::string::npos);
+  EXPECT_NE(metrics.find("test_sizes_bucket{le=\"3\"} 2\n"), std::string::npos);
+  EXPECT_NE(metrics.find("test_sizes_bucket{le=\"+Inf\"} 3\n"), std::string::npos);
+  EXPECT_NE(metrics.find("test_sizes_count 3\n"), std::string::npos);
+  EXPECT_NE(metrics.find("test_level{name=\"a\\\"b\"} 5\n"), std::string::npos);
+  EXPECT_TRUE(metrics.ends_with("# EOF\n"));
+
+  handle.reset();
+  EXPECT_EQ(registry->ToOpenMetrics().find("test_level"), std::string::npos);
+}
+
+TEST(PerformanceComparison, FlagsOnlySignificantAndLargeChanges) {
+  using encrypto::motion::PerformanceChange;
+  using encrypto::motion::PerformanceSample;
+  // t = 1 / sqrt(0.2) with 18 degrees of freedom
+  EXPECT_NEAR(encrypto::motion::ComputeWelchTTestPValue({10.0, 1.0, 10}, {11.0, 1.0, 10}), 0.0382,
+              1e-3);
+  EXPECT_EQ(encrypto::motion::ComputeWelchTTestPValue({10.0, 1.0, 1}, {20.0, 1.0, 1}), 1.0);
+  EXPECT_EQ(encrypto::motion::ComputeWelchTTestPValue({10.0, 0.0, 5}, {20.0, 0.0, 5}), 0.0);
+  EXPECT_DOUBLE_EQ(PerformanceSample::FromUncorrectedStandardDeviation(1.0, 2.0, 4).variance,
+                   16.0 / 3.0);
+
+  const encrypto::motion::PerformanceSamples baseline{{"faster", {100.0, 1.0, 10}},
+                                                      {"noisy", {100.0, 400.0, 10}},
+                                                      {"slower", {100.0, 1.0, 10}},
+                                                      {"slightly slower", {100.0, 1.0, 10}},
+                                                      {"removed", {100.0, 1.0, 10}}};
+  const encrypto::motion::PerformanceSamples current{{"faster", {80.0, 1.0, 10}},
+                                                     {"noisy", {120.0, 400.0, 10}},
+                                                     {"slower", {120.0, 1.0, 10}},
+                                                     {"slightly slower", {102.0, 1.0, 10}},
+                                                     {"added", {100.0, 1.0, 10}}};
+  const auto changes{encrypto::motion::ComparePerformance(baseline, current)};
+  ASSERT_EQ(changes.size(), 4u);
+  std::map<std::string, PerformanceChange::Verdict> verdicts;
+  for (const auto& change : changes) verdicts[change.name] = change.verdict;
+  EXPECT_EQ(verdicts["faster"], PerformanceChange::Verdict::kImprovement);
+  EXPECT_EQ(verdicts["noisy"], PerformanceChange::Verdict::kUnchanged);
+  EXPECT_EQ(verdicts["slower"], PerformanceChange::Verdict::kRegression);
+  EXPECT_EQ(verdicts["slightly slower"], PerformanceChange::Verdict::kUnchanged);
+  EXPECT_NE(encrypto::motion::PrintPerformanceChanges(changes).find("Unchanged (2)"),
+            std::string::npos);
+}
+
+TEST(CostEstimate, EstimatesPreprocessingAndCalibratesGateCosts) {
+  auto model{encrypto::motion::CostModel::Default()};
+  EXPECT_EQ(model.gate_costs.at("boolean_gmw::AndGate").online_rounds, 1u);
+  EXPECT_DOUBLE_EQ(model.gate_costs.at("boolean_gmw::AndGate").online_bytes_per_value, 0.25);
+  EXPECT_EQ(model.gate_costs.at("arithmetic_gmw::MultiplicationGate<unsigned int>").online_rounds,
+            1u);
+
+  model.Calibrate(boost::json::parse(R"({"benchmarks": [
+      {"run_name": "BM_GateCost/boolean_gmw::AndGate", "aggregate_name": "mean",
+       "compute_ns_per_value": 20.0},
+      {"run_name": "BM_GateCost/boolean_gmw::AndGate", "aggregate_name": "stddev",
+       "compute_ns_per_value": 1000.0},
+      {"run_name": "BM_Other", "compute_ns_per_value": 1000.0}]})")
+                      .as_object());
+  EXPECT_DOUBLE_EQ(model.gate_costs.at("boolean_gmw::AndGate").compute_time_per_value.count(),
+                   20e-9);
+  EXPECT_DOUBLE_EQ(model.gate_costs.at("boolean_gmw::AndGate").online_bytes_per_value, 0.25);
+  EXPECT_EQ(model.gate_costs.count("BM_Other"), 0u);
+
+  // without gates, only the preprocessing of the MTs with each of the two peers costs
+  encrypto::motion::Register register_(nullptr);
+  encrypto::motion::PreprocessingPlan plan;
+  plan.number_of_binary_mts = 1000;
+  const auto estimate{encrypto::motion::EstimateCosts(register_, plan, 0, 3, model)};
+  EXPECT_EQ(estimate.online_rounds, 0u);
+  EXPECT_DOUBLE_EQ(estimate.online_bytes_per_party, 0.0);
+  EXPECT_DOUBLE_EQ(estimate.preprocessing_bytes_per_party, 2 * 1000 * model.bytes_per_ot);
+  EXPECT_DOUBLE_EQ(estimate.estimated_time.count(),
+                   model.preprocessing_rounds * model.network.round_trip_time.count() +
+                       estimate.preprocessing_bytes_per_party / model.network.bandwidth);
+}
+
+TEST(AutoTuner, ChoosesConfigurationFromNetworkAndCircuit) {
+  using encrypto::motion::communication::LinkParameters;
+  using namespace std::chrono_literals;
+  const std::vector<std::vector<LinkParameters>> links{
+      {{}, {1ms, 1e9}, {3ms, 2e9}}, {{1ms, 1e9}, {}, {2ms, 1e8}}, {{3ms, 2e9}, {2ms, 1e8}, {}}};
+  const auto slowest{encrypto::motion::GetSlowestLink(links)};
+  EXPECT_DOUBLE_EQ(slowest.round_trip_time.count(), 3e-3);
+  EXPECT_DOUBLE_EQ(slowest.bandwidth, 1e8);
+
+  encrypto::motion::Register register_(nullptr);
+  EXPECT_EQ(encrypto::motion::InspectCircuit(register_).number_of_gates, 0u);
+
+  // a shallow and narrow circuit in a LAN
+  encrypto::motion::ProtocolCostModel lan{.round_trip_time = 100us, .bandwidth = 1e9};
+  encrypto::motion::CircuitShape narrow{.number_of_gates = 100,
+                                        .number_of_interactive_gates = 50,
+                                        .interactive_depth = 10,
+                                        .max_interactive_width = 5};
+  const auto lan_decision{encrypto::motion::ChooseConfiguration(lan, narrow, 16)};
+  EXPECT_EQ(lan_decision.number_of_threads, 1u);
+  EXPECT_TRUE(lan_decision.online_after_setup);
+  EXPECT_EQ(lan_decision.ot_extension_chunk_size, std::size_t(1) << 16);
+  EXPECT_EQ(lan_decision.mt_batch_size, std::size_t(1) << 14);
+  EXPECT_EQ(lan_decision.ot_extension_chunk_size % encrypto::motion::kKappa, 0u);
+  EXPECT_FALSE(lan_decision.PrintHumanReadable().empty());
+
+  // a deep and wide circuit in a WAN
+  encrypto::motion::ProtocolCostModel wan{.round_trip_time = 100ms, .bandwidth = 1e8};
+  encrypto::motion::CircuitShape wide{.number_of_gates = 1'000'000,
+                                      .number_of_interactive_gates = 500'000,
+                                      .interactive_depth = 100,
+                                      .max_interactive_width = 5'000};
+  const auto wan_decision{encrypto::motion::ChooseConfiguration(wan, wide, 16)};
+  EXPECT_EQ(wan_decision.number_of_threads, 16u);
+  EXPECT_FALSE(wan_decision.online_after_setup);
+  EXPECT_EQ(wan_decision.ot_extension_chunk_size, std::size_t(1) << 22);
+  EXPECT_EQ(wan_decision.mt_batch_size, std::size_t(1) << 17);
+  EXPECT_EQ(encrypto::motion::ChooseConfiguration(wan, wide, 0).number_of_threads, 1u);
+}
+
+TEST(ObjectArena, ObjectsKeepTheArenaAlive) {
+  struct alignas(64) Object {
+    std::vector<std::size_t> values;
+  };
+  auto arena{std::make_shared<encrypto::motion::ObjectArena>(256)};
+  std::vector<std::shared_ptr<Object>> objects;
+  for (std::size_t i = 0; i < 100; ++i) {
+    objects.emplace_back(std::allocate_shared<Object>(
+        encrypto::motion::ArenaAllocator<Object>(arena), std::vector<std::size_t>(i, i)));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(objects.back().get()) % alignof(Object), 0u);
+  }
+  std::weak_ptr<encrypto::motion::ObjectArena> weak_arena{arena};
+  arena.reset();
+  EXPECT_FALSE(weak_arena.expired());
+  for (std::size_t i = 0; i < objects.size(); ++i) EXPECT_EQ(objects[i]->values.size(), i);
+  objects.clear();
+  EXPECT_TRUE(weak_arena.expired());
+}
+
+TEST(ObjectArena, RecyclingArenaReusesMemoryPerSize) {
+  struct Small {
+    std::size_t value;
+  };
+  struct alignas(64) Large {
+    std::array<std::size_t, 16> values;
+  };
+  auto arena{std::make_shared<encrypto::motion::ObjectArena>(256, true)};
+  std::vector<std::shared_ptr<Small>> small_objects;
+  std::vector<std::shared_ptr<Large>> large_objects;
+  for (std::size_t i = 0; i < 10; ++i) {
+    small_objects.emplace_back(
+        std::allocate_shared<Small>(encrypto::motion::ArenaAllocator<Small>(arena), Small{i}));
+    large_objects.emplace_back(
+        std::allocate_shared<Large>(encrypto::motion::ArenaAllocator<Large>(arena)));
+  }
+  const auto allocated_bytes{arena->GetNumberOfAllocatedBytes()};
+  std::set<const void*> small_addresses, large_addresses;
+  for (auto& object : small_objects) small_addresses.insert(object.get());
+  for (auto& object : large_objects) large_addresses.insert(object.get());
+  small_objects.clear();
+  large_objects.clear();
+  EXPECT_EQ(arena->GetNumberOfRecycledBytes(), 0);
+
+  // the objects of each class get the memory of their predecessors of the same class
+  for (std::size_t i = 0; i < 10; ++i) {
+    large_objects.emplace_back(
+        std::allocate_shared<Large>(encrypto::motion::ArenaAllocator<Large>(arena)));
+    small_objects.emplace_back(
+        std::allocate_shared<Small>(encrypto::motion::ArenaAllocator<Small>(arena), Small{i}));
+    EXPECT_EQ(large_addresses.count(large_objects.back().get()), 1);
+    EXPECT_EQ(small_addresses.count(small_objects.back().get()), 1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large_objects.back().get()) % alignof(Large), 0u);
+  }
+  EXPECT_EQ(arena->GetNumberOfRecycledBytes(), allocated_bytes);
+  EXPECT_EQ(arena->GetNumberOfAllocatedBytes(), 2 * allocated_bytes);
+}
+
+TEST(Block128Vector, BulkKernelsAgreeWithScalarOperations) {
+  using encrypto::motion::Block128;
+  using encrypto::motion::BitwiseKernel;
+  const auto to_integer = [](const Block128& block) {
+    unsigned __int128 value;
+    std::memcpy(&value, block.data(), sizeof(value));
+    return value;
+  };
+  const auto default_kernel{encrypto::motion::GetBitwiseKernel()};
+  for (auto kernel : {BitwiseKernel::kSse, BitwiseKernel::kAvx2, BitwiseKernel::kAvx512}) {
+    if (!encrypto::motion::IsSupported(kernel)) continue;
+    encrypto::motion::SetBitwiseKernel(kernel);
+    for (std::size_t n : {0, 1, 3, 4, 5, 8, 17, 64, 101}) {
+      const auto a{encrypto::motion::Block128Vector::MakeRandom(n)};
+      const auto b{encrypto::motion::Block128Vector::MakeRandom(n)};
+      const auto offset{Block128::MakeRandom()};
+      const auto bits{encrypto::motion::BitVector<>::SecureRandom(n)};
+      encrypto::motion::Block128Vector xor_result(n), offset_result(n), select_result(n),
+          double_result(n);
+      encrypto::motion::XorBlocks(a.data(), b.data(), xor_result.data(), n);
+      encrypto::motion::XorBlocks(a.data(), offset, offset_result.data(), n);
+      encrypto::motion::SelectXorBlocks(bits.GetData().data(), a.data(), offset,
+                                        select_result.data(), n);
+      encrypto::motion::DoubleBlocks(a.data(), double_result.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_TRUE(xor_result[i] == (a[i] ^ b[i]));
+        EXPECT_TRUE(offset_result[i] == (a[i] ^ offset));
+        EXPECT_TRUE(select_result[i] == (bits.Get(i) ? a[i] ^ offset : a[i]));
+        const auto value{to_integer(a[i])};
+        const unsigned __int128 reduction{(value >> 127) ? 0x87u : 0u};
+        EXPECT_TRUE(to_integer(double_result[i]) == ((value << 1) ^ reduction));
+      }
+      // the output may be equal to an input
+      auto in_place{a};
+      encrypto::motion::XorBlocks(in_place.data(), b.data(), in_place.data(), n);
+      EXPECT_TRUE(std::equal(in_place.begin(), in_place.end(), xor_result.begin()));
+    }
+  }
+  encrypto::motion::SetBitwiseKernel(default_kernel);
+}
+
+TEST(Block128Vector, BorrowedBlocksKeepTheirOwnerAlive) {
+  auto arena{std::make_shared<encrypto::motion::ObjectArena>(256)};
+  std::weak_ptr<encrypto::motion::ObjectArena> weak_arena{arena};
+  encrypto::motion::Block128Vector borrowed(10, arena);
+  arena.reset();
+  EXPECT_TRUE(borrowed.IsBorrowed());
+  EXPECT_FALSE(weak_arena.expired());
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(borrowed.data()) % 16, 0u);
+  borrowed.SetToRandom();
+
+  // copies own their blocks
+  const encrypto::motion::Block128Vector copy{borrowed};
+  EXPECT_FALSE(copy.IsBorrowed());
+  EXPECT_NE(copy.data(), borrowed.data());
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), borrowed.begin()));
+
+  // shrinking keeps the borrowed blocks, growing copies them
+  const auto* borrowed_data{borrowed.data()};
+  borrowed.resize(5);
+  EXPECT_EQ(borrowed.data(), borrowed_data);
+  borrowed.resize(20);
+  EXPECT_FALSE(borrowed.IsBorrowed());
+  EXPECT_TRUE(weak_arena.expired());
+  EXPECT_TRUE(std::equal(borrowed.begin(), borrowed.begin() + 5, copy.begin()));
+  EXPECT_THROW(borrowed.at(20), std::out_of_range);
+
+  // blocks of another vector
+  auto chunk{std::make_shared<encrypto::motion::Block128Vector>(copy)};
+  encrypto::motion::Block128Vector view(std::span(chunk->data() + 2, 3), chunk);
+  EXPECT_EQ(view.size(), 3u);
+  EXPECT_EQ(view.data(), chunk->data() + 2);
+  view[0] = encrypto::motion::Block128::MakeZero();
+  EXPECT_TRUE((*chunk)[2] == encrypto::motion::Block128::MakeZero());
+}
+
+template <typename T>
+class AddBytesToVectorTest : public testing::Test {};
+using AddBytesToVectorTypes =
+    testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t, __uint128_t>;
+TYPED_TEST_SUITE(AddBytesToVectorTest, AddBytesToVectorTypes);
+
+TYPED_TEST(AddBytesToVectorTest, AgreesWithElementwiseAddition) {
+  using T = TypeParam;
+  for (std::size_t n : {0, 1, 7, 8, 9, 33}) {
+    auto accumulator{encrypto::motion::RandomVector<T>(n)};
+    const auto summand{encrypto::motion::RandomVector<T>(n)};
+    auto expected{accumulator};
+    for (std::size_t i = 0; i < n; ++i) expected[i] += summand[i];
+    // the serialized values start at an odd address as in a flatbuffers payload
+    std::vector<std::uint8_t> bytes(n * sizeof(T) + 1);
+    std::memcpy(bytes.data() + 1, summand.data(), n * sizeof(T));
+    encrypto::motion::AddBytesToVector<T>(accumulator,
+                                          std::span(bytes.data() + 1, n * sizeof(T)));
+    EXPECT_TRUE(accumulator == expected);
+  }
+}
+
+}  // namespace
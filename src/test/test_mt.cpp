@@ -28,6 +28,7 @@
 
 #include "base/party.h"
 #include "multiplication_triple/mt_provider.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
 #include "oblivious_transfer/base_ots/base_ot_provider.h"
 
 namespace {
@@ -94,8 +95,271 @@ TEST(MultiplicationTriples, Binary) {
   }
 }
 
+// the MTs are computed in batches of 128 * 128 and a gate only waits for its own batch
+TEST(MultiplicationTriples, BinaryMultipleBatches) {
+  constexpr std::size_t kNumberOfMts = 2 * 128 * 128 + 5;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    try {
+      auto motion_parties =
+          encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetBackend()->GetMtProvider().RequestBinaryMts(kNumberOfMts);
+      }
+
+      std::vector<std::future<void>> futures;
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+          auto& backend = motion_parties.at(j)->GetBackend();
+          backend->GetBaseProvider().Setup();
+          auto& mt_provider = backend->GetMtProvider();
+          mt_provider.PreSetup();
+          backend->GetOtProviderManager().PreSetup();
+          backend->GetBaseOtProvider().PreSetup();
+          backend->Synchronize();
+          backend->GetBaseOtProvider().ComputeBaseOts();
+          backend->OtExtensionSetup();
+          mt_provider.Setup();
+        }));
+      }
+      std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+      auto mts = motion_parties.at(0)->GetBackend()->GetMtProvider().WaitForBinaryMts(
+          kNumberOfMts - 5, 5);
+      const auto view =
+          motion_parties.at(0)->GetBackend()->GetMtProvider().GetBinaryView(kNumberOfMts - 5, 5);
+      EXPECT_EQ(view.GetSize(), 5);
+      EXPECT_EQ(view.SubsetC(0, 5), mts.c.Subset(kNumberOfMts - 5, kNumberOfMts));
+      for (auto j = 1ull; j < motion_parties.size(); ++j) {
+        const auto& mts_j =
+            motion_parties.at(j)->GetBackend()->GetMtProvider().WaitForBinaryMts(0, kNumberOfMts);
+        mts.a ^= mts_j.a;
+        mts.b ^= mts_j.b;
+        mts.c ^= mts_j.c;
+      }
+      EXPECT_EQ(mts.c.GetSize(), kNumberOfMts);
+      EXPECT_EQ(mts.c, mts.a & mts.b);
+
+      futures.clear();
+      for (auto& party : motion_parties) {
+        futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+      }
+      std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+    } catch (std::exception& e) {
+      std::cerr << e.what() << std::endl;
+    }
+  }
+}
+
+// generates the binary MTs with 1-out-of-16 KK13 OTs, where the last OT of each party only covers
+// a single MT
+TEST(MultiplicationTriples, BinaryKk13) {
+  constexpr std::size_t kNumberOfMts = 2 * 128 * 128 + 5;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    try {
+      auto motion_parties =
+          encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        auto& backend = party->GetBackend();
+        auto& mt_provider = backend->GetMtProvider();
+        dynamic_cast<encrypto::motion::MtProviderFromOts&>(mt_provider)
+            .SetKk13BinaryMts(backend->GetKk13OtProviderManager().GetProviders());
+        mt_provider.RequestBinaryMts(kNumberOfMts);
+      }
+
+      std::vector<std::future<void>> futures;
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+          auto& backend = motion_parties.at(j)->GetBackend();
+          backend->GetBaseProvider().Setup();
+          auto& mt_provider = backend->GetMtProvider();
+          mt_provider.PreSetup();
+          backend->GetOtProviderManager().PreSetup();
+          backend->GetKk13OtProviderManager().PreSetup();
+          backend->GetBaseOtProvider().PreSetup();
+          backend->Synchronize();
+          backend->GetBaseOtProvider().ComputeBaseOts();
+          backend->OtExtensionSetup();
+          mt_provider.Setup();
+        }));
+      }
+      std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+      auto mts = motion_parties.at(0)->GetBackend()->GetMtProvider().GetBinaryAll();
+      for (auto j = 1ull; j < motion_parties.size(); ++j) {
+        const auto& mts_j = motion_parties.at(j)->GetBackend()->GetMtProvider().GetBinaryAll();
+        mts.a ^= mts_j.a;
+        mts.b ^= mts_j.b;
+        mts.c ^= mts_j.c;
+      }
+      EXPECT_EQ(mts.c.GetSize(), kNumberOfMts);
+      EXPECT_EQ(mts.c, mts.a & mts.b);
+
+      futures.clear();
+      for (auto& party : motion_parties) {
+        futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+      }
+      std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+    } catch (std::exception& e) {
+      std::cerr << e.what() << std::endl;
+    }
+  }
+}
+
+// only c is stored and a and b are expanded from PRG keys, also for ranges which are not aligned
+TEST(MultiplicationTriples, Compact) {
+  constexpr std::size_t kNumberOfMts = 128 * 128 + 5;
+  constexpr std::size_t kOffset = 13, kLength = 128 * 128 - 8;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    try {
+      auto motion_parties =
+          encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        auto& mt_provider = party->GetBackend()->GetMtProvider();
+        dynamic_cast<encrypto::motion::MtProviderFromOts&>(mt_provider).SetCompactMts(true);
+        mt_provider.RequestBinaryMts(kNumberOfMts);
+        mt_provider.RequestArithmeticMts<std::uint32_t>(kNumberOfMts);
+      }
+
+      std::vector<std::future<void>> futures;
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+          auto& backend = motion_parties.at(j)->GetBackend();
+          backend->GetBaseProvider().Setup();
+          auto& mt_provider = backend->GetMtProvider();
+          mt_provider.PreSetup();
+          backend->GetOtProviderManager().PreSetup();
+          backend->GetBaseOtProvider().PreSetup();
+          backend->Synchronize();
+          backend->GetBaseOtProvider().ComputeBaseOts();
+          backend->OtExtensionSetup();
+          mt_provider.Setup();
+        }));
+      }
+      std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+      const auto& mt_provider_0 = motion_parties.at(0)->GetBackend()->GetMtProvider();
+      EXPECT_TRUE(mt_provider_0.IsCompact());
+      EXPECT_EQ(mt_provider_0.GetBinaryAll().a.GetSize(), 0);
+      auto binary_mts = mt_provider_0.GetBinary(kOffset, kLength);
+      auto integer_mts = mt_provider_0.GetInteger<std::uint32_t>(kOffset, kLength);
+
+      // the views expand the same a and b
+      const auto binary_view = mt_provider_0.GetBinaryView(kOffset, kLength);
+      EXPECT_EQ(binary_view.SubsetA(0, kLength), binary_mts.a);
+      EXPECT_EQ(binary_view.SubsetB(5, kLength), binary_mts.b.Subset(5, kLength));
+      EXPECT_EQ(binary_view.SubsetC(0, kLength), binary_mts.c);
+      const auto integer_view = mt_provider_0.GetIntegerView<std::uint32_t>(kOffset, kLength);
+      EXPECT_TRUE(std::equal(integer_view.a.begin(), integer_view.a.end(), integer_mts.a.begin()));
+      EXPECT_TRUE(std::equal(integer_view.b.begin(), integer_view.b.end(), integer_mts.b.begin()));
+      EXPECT_TRUE(std::equal(integer_view.c.begin(), integer_view.c.end(), integer_mts.c.begin()));
+      for (auto j = 1ull; j < motion_parties.size(); ++j) {
+        const auto& mt_provider_j = motion_parties.at(j)->GetBackend()->GetMtProvider();
+        const auto binary_mts_j = mt_provider_j.GetBinary(kOffset, kLength);
+        binary_mts.a ^= binary_mts_j.a;
+        binary_mts.b ^= binary_mts_j.b;
+        binary_mts.c ^= binary_mts_j.c;
+        const auto integer_mts_j = mt_provider_j.GetInteger<std::uint32_t>(kOffset, kLength);
+        for (std::size_t k = 0; k < kLength; ++k) {
+          integer_mts.a.at(k) += integer_mts_j.a.at(k);
+          integer_mts.b.at(k) += integer_mts_j.b.at(k);
+          integer_mts.c.at(k) += integer_mts_j.c.at(k);
+        }
+      }
+      EXPECT_EQ(binary_mts.c.GetSize(), kLength);
+      EXPECT_EQ(binary_mts.c, binary_mts.a & binary_mts.b);
+      for (std::size_t k = 0; k < kLength; ++k) {
+        EXPECT_EQ(integer_mts.c.at(k),
+                  static_cast<std::uint32_t>(integer_mts.a.at(k) * integer_mts.b.at(k)));
+      }
+
+      futures.clear();
+      for (auto& party : motion_parties) {
+        futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+      }
+      std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+    } catch (std::exception& e) {
+      std::cerr << e.what() << std::endl;
+    }
+  }
+}
+
+// the OTs with each party are sent and the MTs of each type are parsed by concurrent tasks
+TEST(MultiplicationTriples, AllTypesWithFiveParties) {
+  constexpr std::size_t kNumberOfMts = 1000;
+  constexpr std::size_t kNumberOfParties = 5;
+  try {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset);
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      auto& mt_provider = party->GetBackend()->GetMtProvider();
+      mt_provider.RequestBinaryMts(kNumberOfMts);
+      mt_provider.RequestArithmeticMts<std::uint8_t>(kNumberOfMts);
+      mt_provider.RequestArithmeticMts<std::uint32_t>(kNumberOfMts);
+      mt_provider.RequestArithmeticMts<std::uint64_t>(kNumberOfMts);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t j = 0; j < kNumberOfParties; ++j) {
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+        auto& backend = motion_parties.at(j)->GetBackend();
+        backend->GetBaseProvider().Setup();
+        auto& mt_provider = backend->GetMtProvider();
+        mt_provider.PreSetup();
+        backend->GetOtProviderManager().PreSetup();
+        backend->GetBaseOtProvider().PreSetup();
+        backend->Synchronize();
+        backend->GetBaseOtProvider().ComputeBaseOts();
+        backend->OtExtensionSetup();
+        mt_provider.Setup();
+      }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+    auto binary_mts = motion_parties.at(0)->GetBackend()->GetMtProvider().GetBinaryAll();
+    for (auto j = 1ull; j < kNumberOfParties; ++j) {
+      const auto& mts_j = motion_parties.at(j)->GetBackend()->GetMtProvider().GetBinaryAll();
+      binary_mts.a ^= mts_j.a;
+      binary_mts.b ^= mts_j.b;
+      binary_mts.c ^= mts_j.c;
+    }
+    EXPECT_EQ(binary_mts.c, binary_mts.a & binary_mts.b);
+
+    auto check_integer = [&motion_parties](auto type) {
+      using T = decltype(type);
+      auto mts = motion_parties.at(0)->GetBackend()->GetMtProvider().GetIntegerAll<T>();
+      for (auto j = 1ull; j < kNumberOfParties; ++j) {
+        const auto& mts_j =
+            motion_parties.at(j)->GetBackend()->GetMtProvider().GetIntegerAll<T>();
+        for (std::size_t k = 0; k < kNumberOfMts; ++k) {
+          mts.a.at(k) += mts_j.a.at(k);
+          mts.b.at(k) += mts_j.b.at(k);
+          mts.c.at(k) += mts_j.c.at(k);
+        }
+      }
+      for (std::size_t k = 0; k < kNumberOfMts; ++k) {
+        EXPECT_EQ(mts.c.at(k), static_cast<T>(mts.a.at(k) * mts.b.at(k)));
+      }
+    };
+    check_integer(std::uint8_t{});
+    check_integer(std::uint32_t{});
+    check_integer(std::uint64_t{});
+
+    futures.clear();
+    for (auto& party : motion_parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
-void TemplateTestInteger() {
+void TemplateTestInteger(bool packed = false) {
   constexpr std::size_t kNumberOfMts = 100;
   for (auto i = 0ull; i < kTestIterations; ++i) {
     for (auto number_of_parties : {2u, 3u}) {
@@ -104,7 +368,10 @@ void TemplateTestInteger() {
             encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
         for (auto& party : motion_parties) {
           party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
-          party->GetBackend()->GetMtProvider().template RequestArithmeticMts<T>(kNumberOfMts);
+          auto& mt_provider = party->GetBackend()->GetMtProvider();
+          dynamic_cast<encrypto::motion::MtProviderFromOts&>(mt_provider)
+              .template SetPackedIntegerMts<T>(packed);
+          mt_provider.template RequestArithmeticMts<T>(kNumberOfMts);
         }
 
         std::vector<std::future<void>> futures;
@@ -164,6 +431,15 @@ TEST(MultiplicationTriples, Integer) {
   TemplateTestInteger<std::uint16_t>();
   TemplateTestInteger<std::uint32_t>();
   TemplateTestInteger<std::uint64_t>();
+  TemplateTestInteger<__uint128_t>();
+}
+
+TEST(MultiplicationTriples, PackedInteger) {
+  TemplateTestInteger<std::uint8_t>(true);
+  TemplateTestInteger<std::uint16_t>(true);
+  TemplateTestInteger<std::uint32_t>(true);
+  TemplateTestInteger<std::uint64_t>(true);
+  TemplateTestInteger<__uint128_t>(true);
 }
 
 }  // namespace
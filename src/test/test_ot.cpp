@@ -32,6 +32,8 @@
 #include "data_storage/base_ot_data.h"
 #include "oblivious_transfer/base_ots/base_ot_provider.h"
 #include "oblivious_transfer/ot_flavors.h"
+#include "oblivious_transfer/ot_provider.h"
+#include "oblivious_transfer/random_ot_pool.h"
 
 namespace {
 
@@ -135,6 +137,102 @@ TEST(ObliviousTransfer, Random1oo2OtsFromOtExtension) {
   }
 }
 
+TEST(ObliviousTransfer, Random1oo2OtsFromSilentOt) {
+  constexpr std::size_t kNumberOfOts{10};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    std::mt19937_64 random(0);
+    std::uniform_int_distribution<std::size_t> distribution_bitlength(1, 1000);
+    std::uniform_int_distribution<std::size_t> distribution_batch_size(1, 1000);
+    std::array<std::size_t, kNumberOfOts> bitlength, ots_in_batch;
+    for (auto i = 0ull; i < bitlength.size(); ++i) {
+      bitlength.at(i) = distribution_bitlength(random);
+      ots_in_batch.at(i) = distribution_batch_size(random);
+    }
+
+    bitlength.at(bitlength.size() - 1) = 1;
+
+    std::vector<encrypto::motion::PartyPointer> motion_parties(
+        std::move(encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+    std::vector<std::thread> threads(number_of_parties);
+
+    // my id, other id, data
+    vvv<std::unique_ptr<encrypto::motion::ROtSender>> sender_ot(number_of_parties);
+    vvv<std::unique_ptr<encrypto::motion::ROtReceiver>> receiver_ot(number_of_parties);
+    vvv<std::span<const encrypto::motion::BitVector<>>> sender_messages(number_of_parties),
+        receiver_messages(number_of_parties);
+    vvv<encrypto::motion::BitVector<>> choices(number_of_parties);
+
+    for (auto i = 0ull; i < number_of_parties; ++i) {
+      sender_ot.at(i).resize(number_of_parties);
+      receiver_ot.at(i).resize(number_of_parties);
+      sender_messages.at(i).resize(number_of_parties);
+      receiver_messages.at(i).resize(number_of_parties);
+      choices.at(i).resize(number_of_parties);
+    }
+
+    for (auto i = 0u; i < motion_parties.size(); ++i) {
+      threads.at(i) =
+          std::thread([&bitlength, &ots_in_batch, &sender_ot, &receiver_ot, &motion_parties, i]() {
+            motion_parties.at(i)->GetBackend()->GetOtProviderManager().SetSilentOt(true);
+            motion_parties.at(i)->GetBackend()->GetBaseProvider().Setup();
+            for (auto j = 0u; j < motion_parties.size(); ++j) {
+              if (i != j) {
+                auto& ot_provider = motion_parties.at(i)->GetBackend()->GetOtProvider(j);
+                for (auto k = 0ull; k < kNumberOfOts; ++k) {
+                  sender_ot.at(i).at(j).push_back(
+                      ot_provider.RegisterSendROt(ots_in_batch.at(k), bitlength.at(k)));
+                  receiver_ot.at(i).at(j).push_back(
+                      ot_provider.RegisterReceiveROt(ots_in_batch.at(k), bitlength.at(k)));
+                }
+              }
+            }
+            for (std::size_t party_id = 0; party_id < motion_parties.size(); ++party_id) {
+              if (party_id != i) {
+                motion_parties.at(i)->GetBackend()->GetOtProvider(party_id).PreSetup();
+              }
+            }
+            motion_parties.at(i)->GetBackend()->GetBaseOtProvider().PreSetup();
+            motion_parties.at(i)->GetBackend()->Synchronize();
+            motion_parties.at(i)->GetBackend()->GetBaseOtProvider().ComputeBaseOts();
+            motion_parties.at(i)->GetBackend()->OtExtensionSetup();
+            motion_parties.at(i)->Finish();
+          });
+    }
+
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    for (auto i = 0u; i < motion_parties.size(); ++i) {
+      for (auto j = 0u; j < motion_parties.size(); ++j) {
+        if (i != j) {
+          for (auto k = 0ull; k < kNumberOfOts; ++k) {
+            sender_ot.at(i).at(j).at(k)->ComputeOutputs();
+            sender_messages.at(i).at(j).push_back(sender_ot.at(i).at(j).at(k)->GetOutputs());
+            receiver_ot.at(j).at(i).at(k)->ComputeOutputs();
+            choices.at(j).at(i).push_back(receiver_ot.at(j).at(i).at(k)->GetChoices());
+            receiver_messages.at(j).at(i).push_back(receiver_ot.at(j).at(i).at(k)->GetOutputs());
+
+            for (auto l = 0ull; l < ots_in_batch.at(k); ++l) {
+              if (!choices.at(j).at(i).at(k)[l]) {
+                ASSERT_EQ(receiver_messages.at(j).at(i).at(k)[l],
+                          sender_messages.at(i).at(j).at(k)[l].Subset(0, bitlength.at(k)));
+              } else {
+                ASSERT_EQ(receiver_messages.at(j).at(i).at(k)[l],
+                          sender_messages.at(i).at(j).at(k)[l].Subset(bitlength.at(k),
+                                                                      2 * bitlength.at(k)));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(ObliviousTransfer, General1oo2OtsFromOtExtension) {
   constexpr std::size_t kNumberOfOts{10};
   for (auto number_of_parties : kNumberOfPartiesList) {
@@ -396,4 +494,96 @@ TEST(ObliviousTransfer, XorCorrelated1oo2OtsFromOtExtension) {
   }
 }
 
+
+TEST(ObliviousTransfer, DerandomizedOtsFromRandomOtPool) {
+  constexpr std::size_t kNumberOfOts{100};
+  constexpr std::size_t kNumberOfParties{2};
+  using encrypto::motion::BitVector;
+  using encrypto::motion::Block128;
+  using encrypto::motion::Block128Vector;
+
+  std::vector<encrypto::motion::PartyPointer> motion_parties(
+      std::move(encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  }
+
+  // inputs of party i as sender
+  std::array<Block128Vector, kNumberOfParties> messages_0, messages_1, correlations;
+  std::array<std::vector<std::uint32_t>, kNumberOfParties> ring_correlations;
+  std::array<std::array<BitVector<>, 3>, kNumberOfParties> choices;
+  std::mt19937 random(0);
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    messages_0.at(i).resize(kNumberOfOts);
+    messages_1.at(i).resize(kNumberOfOts);
+    correlations.at(i).resize(kNumberOfOts);
+    for (std::size_t l = 0; l < kNumberOfOts; ++l) {
+      messages_0.at(i)[l] = Block128::MakeRandom();
+      messages_1.at(i)[l] = Block128::MakeRandom();
+      correlations.at(i)[l] = Block128::MakeRandom();
+      ring_correlations.at(i).push_back(random());
+    }
+    for (auto& flavor_choices : choices.at(i)) {
+      flavor_choices = BitVector<>::SecureRandom(kNumberOfOts);
+    }
+  }
+
+  std::array<Block128Vector, kNumberOfParties> g_outputs, xc_sender_outputs, xc_receiver_outputs;
+  std::array<std::vector<std::uint32_t>, kNumberOfParties> ac_sender_outputs, ac_receiver_outputs;
+  std::vector<std::thread> threads(kNumberOfParties);
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    threads.at(i) = std::thread([&, i]() {
+      const std::size_t j = 1 - i;
+      auto& backend = *motion_parties.at(i)->GetBackend();
+      auto& pool = backend.GetOtProviderManager().GetRandomOtPool(j);
+      backend.GetBaseProvider().Setup();
+      pool.Reserve(2 * kNumberOfOts);
+      pool.Reserve(kNumberOfOts);
+      backend.GetOtProvider(j).PreSetup();
+      backend.GetBaseOtProvider().PreSetup();
+      backend.Synchronize();
+      backend.GetBaseOtProvider().ComputeBaseOts();
+      backend.OtExtensionSetup();
+
+      std::array<std::unique_ptr<encrypto::motion::PooledOtSender>, 3> senders;
+      std::array<std::unique_ptr<encrypto::motion::PooledOtReceiver>, 3> receivers;
+      for (std::size_t k = 0; k < 3; ++k) {
+        senders.at(k) = pool.TakeSender(kNumberOfOts);
+        receivers.at(k) = pool.TakeReceiver(kNumberOfOts);
+      }
+      EXPECT_EQ(pool.GetNumberOfAvailableSenderOts(), 0);
+      EXPECT_THROW(static_cast<void>(pool.TakeReceiver(1)), std::out_of_range);
+      // the peer needs to have taken its OTs before the messages arrive
+      backend.Synchronize();
+
+      for (std::size_t k = 0; k < 3; ++k) receivers.at(k)->SetChoices(choices.at(i).at(k));
+      senders.at(0)->SendGOts(messages_0.at(i), messages_1.at(i));
+      xc_sender_outputs.at(i) = senders.at(1)->SendXcOts(correlations.at(i));
+      ac_sender_outputs.at(i) =
+          senders.at(2)->SendAcOts(std::span<const std::uint32_t>(ring_correlations.at(i)));
+      g_outputs.at(i) = receivers.at(0)->ReceiveGOts();
+      xc_receiver_outputs.at(i) = receivers.at(1)->ReceiveXcOts();
+      ac_receiver_outputs.at(i) = receivers.at(2)->ReceiveAcOts<std::uint32_t>();
+      motion_parties.at(i)->Finish();
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    const std::size_t j = 1 - i;
+    for (std::size_t l = 0; l < kNumberOfOts; ++l) {
+      EXPECT_TRUE(g_outputs.at(j)[l] ==
+                  (choices.at(j).at(0).Get(l) ? messages_1.at(i)[l] : messages_0.at(i)[l]));
+      auto xc_expected = xc_sender_outputs.at(i)[l];
+      if (choices.at(j).at(1).Get(l)) xc_expected ^= correlations.at(i)[l];
+      EXPECT_TRUE(xc_receiver_outputs.at(j)[l] == xc_expected);
+      std::uint32_t ac_expected = ac_sender_outputs.at(i).at(l);
+      if (choices.at(j).at(2).Get(l)) ac_expected += ring_correlations.at(i).at(l);
+      EXPECT_EQ(ac_receiver_outputs.at(j).at(l), ac_expected);
+    }
+  }
+}
+
 }  // namespace
\ No newline at end of file
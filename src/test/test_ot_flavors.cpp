@@ -22,18 +22,30 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <filesystem>
 #include <future>
 #include <memory>
 
 #include "base/motion_base_provider.h"
 #include "communication/communication_layer.h"
+#include "data_storage/preprocessing_store.h"
 #include "oblivious_transfer/base_ots/base_ot_provider.h"
 #include "oblivious_transfer/ot_flavors.h"
 #include "utility/block.h"
 
 class OtFlavorTest : public ::testing::Test {
  protected:
-  void SetUp() override {
+  void SetUp() override { CreateProviders(); }
+
+  void TearDown() override { ShutDown(); }
+
+  // simulates a restart of both parties with new communication layers and providers
+  void Restart() {
+    ShutDown();
+    CreateProviders();
+  }
+
+  void CreateProviders() {
     communication_layers_ = encrypto::motion::communication::MakeDummyCommunicationLayers(2);
     base_ot_providers_.resize(2);
     motion_base_providers_.resize(2);
@@ -48,7 +60,7 @@ class OtFlavorTest : public ::testing::Test {
     }
   }
 
-  void TearDown() override {
+  void ShutDown() {
     std::vector<std::future<void>> futures;
     for (std::size_t i = 0; i < 2; ++i) {
       futures.emplace_back(
@@ -65,11 +77,15 @@ class OtFlavorTest : public ::testing::Test {
     return ot_provider_wrappers_[receiver_i_]->GetProvider(sender_i_);
   }
 
-  void RunOtExtensionSetup() {
+  // returns whether base OTs were computed, which is the case if no base OTs of the OT extension
+  // setups were kept from a previous setup
+  bool RunOtExtensionSetup() {
     for (std::size_t i = 0; i < 2; ++i) {
       ot_provider_wrappers_[i]->PreSetup();
       base_ot_providers_[i]->PreSetup();
     }
+    const bool computes_base_ots{base_ot_providers_[0]->HasWork()};
+    EXPECT_EQ(base_ot_providers_[1]->HasWork(), computes_base_ots);
 
     std::vector<std::future<void>> futures;
     for (std::size_t i = 0; i < 2; ++i) {
@@ -77,7 +93,9 @@ class OtFlavorTest : public ::testing::Test {
         communication_layers_[i]->Start();
         communication_layers_[i]->Synchronize();
         motion_base_providers_[i]->Setup();
-        base_ot_providers_[i]->ComputeBaseOts();
+        if (base_ot_providers_[i]->HasWork()) {
+          base_ot_providers_[i]->ComputeBaseOts();
+        }
       }));
     }
     std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
@@ -92,6 +110,23 @@ class OtFlavorTest : public ::testing::Test {
       }));
     }
     std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+    for (std::size_t i = 0; i < 2; ++i) {
+      ot_provider_wrappers_[i]->RefreshBaseOts();
+    }
+    return computes_base_ots;
+  }
+
+  static void ExpectMatchingOutputs(encrypto::motion::ROtSender& ot_sender,
+                                    encrypto::motion::ROtReceiver& ot_receiver) {
+    ot_sender.ComputeOutputs();
+    ot_receiver.ComputeOutputs();
+    const auto sender_outputs = ot_sender.GetOutputs();
+    const auto receiver_outputs = ot_receiver.GetOutputs();
+    const auto& choices = ot_receiver.GetChoices();
+    for (std::size_t ot_i = 0; ot_i < receiver_outputs.size(); ++ot_i) {
+      const std::size_t begin{choices.Get(ot_i) ? 128u : 0u};
+      ASSERT_EQ(receiver_outputs[ot_i], sender_outputs[ot_i].Subset(begin, begin + 128));
+    }
   }
 
   const std::size_t sender_i_ = 0;
@@ -300,3 +335,59 @@ TEST_F(OtFlavorTest, GOtBit) {
     }
   }
 }
+
+TEST_F(OtFlavorTest, BaseOtsAreRefreshedBetweenSetups) {
+  constexpr std::size_t kNumberOfOts = 1000;
+  auto first_sender = GetSenderProvider().RegisterSendROt(kNumberOfOts, 128);
+  auto first_receiver = GetReceiverProvider().RegisterReceiveROt(kNumberOfOts, 128);
+  EXPECT_TRUE(RunOtExtensionSetup());
+  ExpectMatchingOutputs(*first_sender, *first_receiver);
+
+  // the next setup, e.g., after Backend::Clear(), takes the base OTs from the previous one
+  for (std::size_t i = 0; i < 2; ++i) {
+    auto second_sender = GetSenderProvider().RegisterSendROt(kNumberOfOts, 128);
+    auto second_receiver = GetReceiverProvider().RegisterReceiveROt(kNumberOfOts, 128);
+    EXPECT_FALSE(RunOtExtensionSetup());
+    ExpectMatchingOutputs(*second_sender, *second_receiver);
+  }
+}
+
+TEST_F(OtFlavorTest, BaseOtsFromStore) {
+  constexpr std::size_t kNumberOfOts = 1000;
+  constexpr std::uint64_t kSessionId{0xba5e};
+  auto path = [](std::size_t party_id) {
+    return std::filesystem::temp_directory_path() /
+           ("motion_test_base_ots_" + std::to_string(party_id) + ".store");
+  };
+  {
+    auto ot_sender = GetSenderProvider().RegisterSendROt(kNumberOfOts, 128);
+    auto ot_receiver = GetReceiverProvider().RegisterReceiveROt(kNumberOfOts, 128);
+    EXPECT_TRUE(RunOtExtensionSetup());
+  }
+  for (std::size_t i = 0; i < 2; ++i) {
+    encrypto::motion::PreprocessingStoreWriter writer(kSessionId, i, 2);
+    EXPECT_TRUE(ot_provider_wrappers_[i]->ExportBaseOts(writer));
+    writer.Write(path(i));
+    // the exported base OTs are not used again by this process
+    encrypto::motion::PreprocessingStoreWriter second_writer(kSessionId, i, 2);
+    EXPECT_FALSE(ot_provider_wrappers_[i]->ExportBaseOts(second_writer));
+    EXPECT_EQ(std::filesystem::status(path(i)).permissions() & std::filesystem::perms::group_all,
+              std::filesystem::perms::none);
+  }
+
+  Restart();
+  for (std::size_t i = 0; i < 2; ++i) {
+    encrypto::motion::PreprocessingStore store(path(i), kSessionId, i);
+    base_ot_providers_[i]->ImportBaseOts(store);
+    using encrypto::motion::PreprocessingKind;
+    EXPECT_EQ(store.GetNumberOfAvailableElements(PreprocessingKind::kRandomOtSender, 1 - i), 0);
+  }
+  auto ot_sender = GetSenderProvider().RegisterSendROt(kNumberOfOts, 128);
+  auto ot_receiver = GetReceiverProvider().RegisterReceiveROt(kNumberOfOts, 128);
+  EXPECT_FALSE(RunOtExtensionSetup());
+  ExpectMatchingOutputs(*ot_sender, *ot_receiver);
+
+  for (std::size_t i = 0; i < 2; ++i) {
+    std::filesystem::remove(path(i));
+  }
+}
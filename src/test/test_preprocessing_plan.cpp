@@ -0,0 +1,149 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "base/backend.h"
+#include "base/party.h"
+#include "data_storage/preprocessing_plan.h"
+#include "multiplication_triple/mt_provider.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "test_helpers.h"
+
+namespace {
+
+using namespace encrypto::motion;
+
+constexpr std::size_t kNumberOfSimd{10};
+
+TEST(PreprocessingPlan, Serialization) {
+  PreprocessingPlan plan;
+  plan.number_of_binary_mts = 1;
+  plan.number_of_integer_mts = {2, 3, 4, 5, 6};
+  plan.number_of_sps = {7, 8, 9, 10, 11};
+  plan.number_of_sbs = {12, 13, 14, 15};
+  const auto message{plan.Serialize()};
+  const auto deserialized_plan{PreprocessingPlan::Deserialize(message)};
+  EXPECT_EQ(deserialized_plan.number_of_binary_mts, plan.number_of_binary_mts);
+  EXPECT_EQ(deserialized_plan.number_of_integer_mts, plan.number_of_integer_mts);
+  EXPECT_EQ(deserialized_plan.number_of_sps, plan.number_of_sps);
+  EXPECT_EQ(deserialized_plan.number_of_sbs, plan.number_of_sbs);
+
+  const std::vector<std::uint8_t> truncated(message.begin(), message.end() - 1);
+  EXPECT_THROW(PreprocessingPlan::Deserialize(truncated), std::runtime_error);
+  auto wrong_magic{message};
+  wrong_magic.at(0) ^= 1;
+  EXPECT_THROW(PreprocessingPlan::Deserialize(wrong_magic), std::runtime_error);
+}
+
+struct CircuitOutputs {
+  ShareWrapper product, square, conversion;
+};
+
+// product x * y and square x * x of the inputs of party 0 and 1, and conversion of the bits z of
+// party 0 to arithmetic GMW, which need MTs, SPs and SBs, respectively
+CircuitOutputs BuildCircuit(Party& party, std::size_t party_id, const std::vector<std::uint32_t>& x,
+                            const std::vector<std::uint32_t>& y,
+                            const std::vector<BitVector<>>& z) {
+  constexpr auto kArithmeticGmw = MpcProtocol::kArithmeticGmw;
+  constexpr auto kBooleanGmw = MpcProtocol::kBooleanGmw;
+  const std::vector<std::uint32_t> zeros(kNumberOfSimd, 0);
+  const std::vector<BitVector<>> zero_bits(z.size(), BitVector<>(kNumberOfSimd, false));
+  ShareWrapper share_x = party.In<kArithmeticGmw>(party_id == 0 ? x : zeros, 0);
+  ShareWrapper share_y = party.In<kArithmeticGmw>(party_id == 1 ? y : zeros, 1);
+  ShareWrapper share_z = party.In<kBooleanGmw>(party_id == 0 ? z : zero_bits, 0);
+  return {(share_x * share_y).Out(), (share_x * share_x).Out(),
+          share_z.Convert<kArithmeticGmw>().Out()};
+}
+
+TEST(PreprocessingPlan, PrimedPreprocessingOverlapsCircuitConstruction) {
+  constexpr std::size_t kNumberOfParties{2};
+  const auto x{::RandomVector<std::uint32_t>(kNumberOfSimd)};
+  const auto y{::RandomVector<std::uint32_t>(kNumberOfSimd)};
+  std::vector<BitVector<>> z(32);
+  for (auto& bits : z) {
+    bits = BitVector<>::SecureRandom(kNumberOfSimd);
+  }
+  const auto z_values{ToVectorOutput<std::uint32_t>(z)};
+
+  auto check = [&](const CircuitOutputs& outputs) {
+    const auto product{outputs.product.As<std::vector<std::uint32_t>>()};
+    const auto square{outputs.square.As<std::vector<std::uint32_t>>()};
+    const auto conversion{outputs.conversion.As<std::vector<std::uint32_t>>()};
+    for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+      EXPECT_EQ(product.at(i), static_cast<std::uint32_t>(x.at(i) * y.at(i)));
+      EXPECT_EQ(square.at(i), static_cast<std::uint32_t>(x.at(i) * x.at(i)));
+      EXPECT_EQ(conversion.at(i), z_values.at(i));
+    }
+  };
+
+  // dry run, which records the plan after the construction of the circuit
+  std::array<std::vector<std::uint8_t>, kNumberOfParties> plans;
+  {
+    auto motion_parties{MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+    std::vector<std::thread> threads;
+    for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+      threads.emplace_back([&, party_id] {
+        auto& party{motion_parties.at(party_id)};
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        const auto outputs{BuildCircuit(*party, party_id, x, y, z)};
+        plans.at(party_id) = party->GetBackend()->GetPreprocessingPlan().Serialize();
+        party->Run();
+        check(outputs);
+        party->Finish();
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+  EXPECT_EQ(plans.at(0), plans.at(1));
+  const auto plan{PreprocessingPlan::Deserialize(plans.at(0))};
+  EXPECT_EQ(plan.number_of_integer_mts[PreprocessingPlan::GetTypeIndex<std::uint32_t>()],
+            kNumberOfSimd);
+  EXPECT_EQ(plan.number_of_sps[PreprocessingPlan::GetTypeIndex<std::uint32_t>()], kNumberOfSimd);
+  EXPECT_EQ(plan.number_of_sbs[PreprocessingPlan::GetTypeIndex<std::uint32_t>()],
+            32 * kNumberOfSimd);
+
+  // the preprocessing of the primed parties runs while the circuit is constructed
+  auto motion_parties{MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  std::vector<std::thread> threads;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    threads.emplace_back([&, party_id] {
+      auto& party{motion_parties.at(party_id)};
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetBackend()->Prime(PreprocessingPlan::Deserialize(plans.at(party_id)));
+      party->StartPreprocessing();
+      const auto outputs{BuildCircuit(*party, party_id, x, y, z)};
+      EXPECT_THROW(party->GetBackend()->GetMtProvider().RequestArithmeticMts<std::uint32_t>(1),
+                   std::logic_error);
+      party->Run();
+      check(outputs);
+      party->Finish();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+}  // namespace
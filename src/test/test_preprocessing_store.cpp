@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <filesystem>
+#include <random>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "test_constants.h"
+
+#include "base/backend.h"
+#include "base/party.h"
+#include "data_storage/preprocessing_store.h"
+#include "oblivious_transfer/ot_flavors.h"
+#include "oblivious_transfer/ot_provider.h"
+
+namespace {
+
+using encrypto::motion::BitVector;
+using encrypto::motion::PreprocessingKind;
+using encrypto::motion::PreprocessingStore;
+using encrypto::motion::PreprocessingStoreWriter;
+
+constexpr std::uint64_t kSessionId{0x5e5510};
+
+std::filesystem::path MakeStorePath(std::string_view name, std::size_t party_id) {
+  return std::filesystem::temp_directory_path() /
+         ("motion_test_" + std::string(name) + "_" + std::to_string(party_id) + ".store");
+}
+
+TEST(PreprocessingStore, ConsumesMaterialOnlyOnce) {
+  constexpr std::size_t kNumberOfOts{300}, kNumberOfMts{100};
+  std::vector<BitVector<>> sender_outputs(kNumberOfOts), receiver_outputs(kNumberOfOts);
+  for (std::size_t i = 0; i < kNumberOfOts; ++i) {
+    sender_outputs[i] = BitVector<>::SecureRandom(256);
+    receiver_outputs[i] = BitVector<>::SecureRandom(128);
+  }
+  const auto choices{BitVector<>::SecureRandom(kNumberOfOts)};
+  const auto a{BitVector<>::SecureRandom(kNumberOfMts)}, b{BitVector<>::SecureRandom(kNumberOfMts)},
+      c{a & b};
+  std::mt19937 random(0);
+  std::vector<std::uint32_t> a32(kNumberOfMts), b32(kNumberOfMts), c32(kNumberOfMts);
+  for (std::size_t i = 0; i < kNumberOfMts; ++i) {
+    a32[i] = random();
+    b32[i] = random();
+    c32[i] = a32[i] * b32[i];
+  }
+
+  PreprocessingStoreWriter writer(kSessionId, 0, 2);
+  writer.AddRandomOtsSender(1, sender_outputs);
+  writer.AddRandomOtsReceiver(1, receiver_outputs, choices);
+  writer.AddBinaryMts(a, b, c);
+  writer.AddIntegerMts<std::uint32_t>(a32, b32, c32);
+  const auto path{MakeStorePath("consume", 0)};
+  writer.Write(path);
+
+  {
+    PreprocessingStore store(path, kSessionId, 0);
+    EXPECT_EQ(store.GetNumberOfAvailableElements(PreprocessingKind::kRandomOtSender, 1),
+              kNumberOfOts);
+    EXPECT_EQ(store.GetNumberOfAvailableElements(PreprocessingKind::kIntegerMts64), 0);
+    // the store is locked while it is open
+    EXPECT_THROW(PreprocessingStore(path, kSessionId, 0), std::runtime_error);
+
+    const auto sender_messages{store.ConsumeRandomOtsSender(1, 3)};
+    for (std::size_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(BitVector<>(sender_messages.data() + 32 * i, 256), sender_outputs[i]);
+    }
+    const auto receiver_material{store.ConsumeRandomOtsReceiver(1, 5)};
+    EXPECT_EQ(receiver_material.choices, choices.Subset(0, 5));
+    const auto [a0, b0, c0] = store.ConsumeBinaryMts(13);
+    EXPECT_EQ(a0, a.Subset(0, 13));
+    EXPECT_EQ(c0, c.Subset(0, 13));
+    const auto [a32_0, b32_0, c32_0] = store.ConsumeIntegerMts<std::uint32_t>(kNumberOfMts);
+    EXPECT_TRUE(std::equal(c32_0.begin(), c32_0.end(), c32.begin()));
+    EXPECT_THROW(store.ConsumeIntegerMts<std::uint32_t>(1), std::runtime_error);
+  }
+
+  // the consumption persists when the store is opened again
+  {
+    PreprocessingStore store(path, kSessionId, 0);
+    EXPECT_EQ(store.GetNumberOfAvailableElements(PreprocessingKind::kRandomOtSender, 1),
+              kNumberOfOts - 3);
+    const auto receiver_material{store.ConsumeRandomOtsReceiver(1, kNumberOfOts - 5)};
+    EXPECT_EQ(receiver_material.choices, choices.Subset(5, kNumberOfOts));
+    for (std::size_t i = 5; i < kNumberOfOts; ++i) {
+      EXPECT_EQ(BitVector<>(receiver_material.outputs.data() + 16 * (i - 5), 128),
+                receiver_outputs[i]);
+    }
+    const auto [a1, b1, c1] = store.ConsumeBinaryMts(kNumberOfMts - 13);
+    EXPECT_EQ(b1, b.Subset(13, kNumberOfMts));
+  }
+
+  EXPECT_THROW(PreprocessingStore(path, kSessionId + 1, 0), std::runtime_error);
+  EXPECT_THROW(PreprocessingStore(path, kSessionId, 1), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(PreprocessingStore, RandomOtsFromFile) {
+  constexpr std::size_t kNumberOfParties{2}, kNumberOfOts{1000};
+  constexpr std::array<std::size_t, 3> kBitlengths{1, 128, 300};
+  constexpr std::size_t kTotalNumberOfOts{kNumberOfOts * kBitlengths.size()};
+
+  // random OTs in which party i is the sender and party 1 - i the receiver
+  std::vector<PreprocessingStoreWriter> writers;
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    writers.emplace_back(kSessionId, i, kNumberOfParties);
+  }
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    std::vector<BitVector<>> sender_outputs(kTotalNumberOfOts), receiver_outputs(kTotalNumberOfOts);
+    const auto choices{BitVector<>::SecureRandom(kTotalNumberOfOts)};
+    for (std::size_t j = 0; j < kTotalNumberOfOts; ++j) {
+      sender_outputs[j] = BitVector<>::SecureRandom(256);
+      receiver_outputs[j] = sender_outputs[j].Subset(choices.Get(j) ? 128 : 0,
+                                                     choices.Get(j) ? 256 : 128);
+    }
+    writers[i].AddRandomOtsSender(1 - i, sender_outputs);
+    writers[1 - i].AddRandomOtsReceiver(i, receiver_outputs, choices);
+  }
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    writers[i].Write(MakeStorePath("random_ots", i));
+  }
+
+  std::vector<encrypto::motion::PartyPointer> motion_parties(
+      encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset));
+  std::vector<std::vector<std::unique_ptr<encrypto::motion::ROtSender>>> sender_ots(
+      kNumberOfParties);
+  std::vector<std::vector<std::unique_ptr<encrypto::motion::ROtReceiver>>> receiver_ots(
+      kNumberOfParties);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    threads.emplace_back([&, i] {
+      auto backend{motion_parties[i]->GetBackend()};
+      backend->SetPreprocessingStore(
+          std::make_shared<PreprocessingStore>(MakeStorePath("random_ots", i), kSessionId, i));
+      auto& ot_provider{backend->GetOtProvider(1 - i)};
+      for (auto bitlength : kBitlengths) {
+        sender_ots[i].push_back(ot_provider.RegisterSendROt(kNumberOfOts, bitlength));
+        receiver_ots[i].push_back(ot_provider.RegisterReceiveROt(kNumberOfOts, bitlength));
+      }
+      ot_provider.PreSetup();
+      backend->OtExtensionSetup();
+      motion_parties[i]->Finish();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    for (std::size_t k = 0; k < kBitlengths.size(); ++k) {
+      auto& sender_ot{sender_ots[i][k]};
+      auto& receiver_ot{receiver_ots[1 - i][k]};
+      sender_ot->ComputeOutputs();
+      receiver_ot->ComputeOutputs();
+      const auto sender_outputs{sender_ot->GetOutputs()};
+      const auto receiver_outputs{receiver_ot->GetOutputs()};
+      const auto& choices{receiver_ot->GetChoices()};
+      for (std::size_t j = 0; j < kNumberOfOts; ++j) {
+        const std::size_t begin{choices.Get(j) ? kBitlengths[k] : 0};
+        ASSERT_EQ(receiver_outputs[j], sender_outputs[j].Subset(begin, begin + kBitlengths[k]));
+      }
+    }
+  }
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    std::filesystem::remove(MakeStorePath("random_ots", i));
+  }
+}
+
+}  // namespace
@@ -0,0 +1,107 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "algorithm/private_set_intersection.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+#include "test_constants.h"
+
+namespace {
+
+using encrypto::motion::MpcProtocol;
+
+// intersects random sets of the given sizes with number_of_common_elements common elements and
+// sums the values of the elements of party 0 over the intersection
+void TestPrivateSetIntersection(std::size_t receiver_set_size, std::size_t sender_set_size,
+                                std::size_t number_of_common_elements) {
+  std::mt19937_64 random(receiver_set_size);
+  std::unordered_set<std::uint64_t> elements;
+  while (elements.size() < receiver_set_size + sender_set_size - number_of_common_elements) {
+    elements.insert(random());
+  }
+  std::vector<std::uint64_t> receiver_set(elements.begin(), elements.end());
+  std::vector<std::uint64_t> sender_set(receiver_set.end() - sender_set_size, receiver_set.end());
+  receiver_set.resize(receiver_set_size);
+  std::shuffle(sender_set.begin(), sender_set.end(), random);
+
+  std::vector<std::uint32_t> values(receiver_set_size);
+  for (auto& value : values) value = random();
+  encrypto::motion::BitVector<> expected_intersection(receiver_set_size);
+  std::uint32_t expected_sum{0};
+  for (std::size_t i = receiver_set_size - number_of_common_elements; i < receiver_set_size; ++i) {
+    expected_intersection.Set(true, i);
+    expected_sum += values[i];
+  }
+
+  std::vector<encrypto::motion::PartyPointer> motion_parties(
+      encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(true);
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    threads.emplace_back([&, party_id]() {
+      auto& party{motion_parties.at(party_id)};
+      auto& backend{*party->GetBackend()};
+      // the sets need to have the public sizes and distinct elements
+      const std::vector<std::uint64_t> invalid_set{sender_set.front(), sender_set.front()};
+      EXPECT_THROW(encrypto::motion::algorithm::PrivateSetIntersection(
+                       backend, invalid_set, receiver_set_size, party_id == 0 ? 3 : 2),
+                   std::invalid_argument);
+      const auto intersection{encrypto::motion::algorithm::PrivateSetIntersection(
+          backend, party_id == 0 ? receiver_set : sender_set, receiver_set_size,
+          sender_set_size)};
+      const encrypto::motion::ShareWrapper value_shares{party->In<MpcProtocol::kArithmeticGmw>(
+          party_id == 0 ? values : std::vector<std::uint32_t>(receiver_set_size), 0)};
+      const auto intersection_output{intersection.Out()};
+      const auto cardinality{
+          encrypto::motion::algorithm::IntersectionCardinality(intersection, 32).Out()};
+      const auto sum{
+          encrypto::motion::algorithm::IntersectionSum(intersection, value_shares).Out()};
+      party->Run();
+      EXPECT_EQ(intersection_output.As<encrypto::motion::BitVector<>>(), expected_intersection);
+      EXPECT_EQ(cardinality.As<std::uint32_t>(), number_of_common_elements);
+      EXPECT_EQ(sum.As<std::uint32_t>(), expected_sum);
+      party->Finish();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+TEST(PrivateSetIntersection, RandomSets_2_parties) {
+  TestPrivateSetIntersection(200, 150, 60);
+  TestPrivateSetIntersection(1, 1, 1);
+  TestPrivateSetIntersection(1000, 3000, 0);
+}
+
+}  // namespace
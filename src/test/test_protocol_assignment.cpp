@@ -0,0 +1,170 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/protocol_assignment.h"
+#include "base/party.h"
+#include "communication/transport.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+
+namespace encrypto::motion {
+
+// prints the protocols in failed expectations
+void PrintTo(MpcProtocol protocol, std::ostream* os) { *os << to_string(protocol); }
+
+}  // namespace encrypto::motion
+
+namespace {
+
+using encrypto::motion::AlgorithmDescription;
+using encrypto::motion::MpcProtocol;
+using encrypto::motion::ProtocolCostModel;
+using Type = encrypto::motion::PrimitiveOperationType;
+
+// a AND b AND b AND ... with number_of_and_gates AND gates in a row
+AlgorithmDescription MakeAndChain(std::size_t number_of_and_gates) {
+  AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = 2;
+  algorithm.number_of_output_wires = 1;
+  for (std::size_t i = 0; i < number_of_and_gates; ++i) {
+    algorithm.gates.push_back({Type::kAnd, i == 0 ? 0 : i + 1, 1, std::nullopt, i + 2});
+  }
+  algorithm.number_of_gates = algorithm.gates.size();
+  algorithm.number_of_wires = 2 + algorithm.gates.size();
+  return algorithm;
+}
+
+ProtocolCostModel MakeCostModel(std::chrono::duration<double> round_trip_time, double bandwidth) {
+  ProtocolCostModel cost_model;
+  cost_model.round_trip_time = round_trip_time;
+  cost_model.bandwidth = bandwidth;
+  return cost_model;
+}
+
+TEST(ProtocolAssignment, DeepCircuitsUseBmrOnSlowLinks) {
+  const auto chain{MakeAndChain(10)};
+  const auto assignment{encrypto::motion::AssignProtocols(
+      chain, MpcProtocol::kBooleanGmw, 2, 1, MakeCostModel(std::chrono::seconds(1), 1e9))};
+  ASSERT_EQ(assignment.gate_protocols.size(), chain.gates.size());
+  for (auto protocol : assignment.gate_protocols) EXPECT_EQ(protocol, MpcProtocol::kBmr);
+  // to BMR after the inputs and back to Boolean GMW for the outputs
+  EXPECT_EQ(assignment.number_of_protocol_switches, 2);
+  EXPECT_LT(assignment.estimated_time, assignment.estimated_time_in_input_protocol);
+  EXPECT_NEAR(assignment.estimated_time_in_input_protocol.count(), 10, 1e-3);
+}
+
+TEST(ProtocolAssignment, ShallowCircuitsStayInGmwOnFastLinks) {
+  const auto chain{MakeAndChain(10)};
+  const auto assignment{encrypto::motion::AssignProtocols(
+      chain, MpcProtocol::kBooleanGmw, 3, 100, MakeCostModel(std::chrono::microseconds(1), 1e6))};
+  for (auto protocol : assignment.gate_protocols) EXPECT_EQ(protocol, MpcProtocol::kBooleanGmw);
+  EXPECT_EQ(assignment.number_of_protocol_switches, 0);
+  EXPECT_EQ(assignment.estimated_time, assignment.estimated_time_in_input_protocol);
+
+  // BMR inputs are converted to Boolean GMW for free, but their outputs need to be converted back
+  const auto bmr_assignment{encrypto::motion::AssignProtocols(
+      chain, MpcProtocol::kBmr, 3, 100, MakeCostModel(std::chrono::microseconds(1), 1e6))};
+  for (auto protocol : bmr_assignment.gate_protocols) {
+    EXPECT_EQ(protocol, MpcProtocol::kBooleanGmw);
+  }
+  EXPECT_EQ(bmr_assignment.number_of_protocol_switches, 2);
+}
+
+TEST(ProtocolAssignment, Errors) {
+  const auto chain{MakeAndChain(2)};
+  EXPECT_THROW(encrypto::motion::AssignProtocols(chain, MpcProtocol::kArithmeticGmw, 2, 1, {}),
+               std::invalid_argument);
+  auto mux{chain};
+  mux.gates[1].type = Type::kMux;
+  EXPECT_THROW(encrypto::motion::AssignProtocols(mux, MpcProtocol::kBooleanGmw, 2, 1, {}),
+               std::invalid_argument);
+
+  std::vector<encrypto::motion::communication::TransportStatistics> statistics(2);
+  statistics[0].number_of_bytes_sent = 1000;
+  statistics[1].number_of_bytes_sent = 3000;
+  const auto cost_model{ProtocolCostModel::FromTransportStatistics(
+      statistics, std::chrono::seconds(2), std::chrono::milliseconds(5))};
+  EXPECT_DOUBLE_EQ(cost_model.bandwidth, 2000);
+  EXPECT_DOUBLE_EQ(cost_model.round_trip_time.count(), 5e-3);
+  EXPECT_THROW(ProtocolCostModel::FromTransportStatistics(statistics, std::chrono::seconds(0),
+                                                          std::chrono::milliseconds(5)),
+               std::invalid_argument);
+}
+
+TEST(ProtocolAssignment, EvaluateInAssignedProtocols) {
+  constexpr std::size_t kNumberOfSimd{10};
+  const auto adder{AlgorithmDescription::FromBristol(std::string(encrypto::motion::kRootDir) +
+                                                     "/circuits/int/int_add8_size.bristol")};
+  std::mt19937 random(0);
+  std::vector<encrypto::motion::BitVector<>> inputs(16);
+  for (auto& input : inputs) {
+    input = encrypto::motion::BitVector<>(kNumberOfSimd);
+    for (std::size_t i = 0; i < kNumberOfSimd; ++i) input.Set(random() & 1, i);
+  }
+
+  // the size-optimized adder has seven layers, which Boolean GMW cannot afford on this link
+  const auto cost_model{MakeCostModel(std::chrono::seconds(1), 1e9)};
+  const auto assignment{encrypto::motion::AssignProtocols(adder, MpcProtocol::kBooleanGmw, 2,
+                                                          kNumberOfSimd, cost_model)};
+  EXPECT_EQ(assignment.number_of_protocol_switches, 2);
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &parties, &adder, &inputs,
+                                                         &cost_model] {
+      auto& party{parties[party_id]};
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      auto input_share{party->In<MpcProtocol::kBooleanGmw>(
+          std::span<const encrypto::motion::BitVector<>>(inputs), 0)};
+      auto output_share{encrypto::motion::ShareWrapper(input_share).Evaluate(adder, cost_model)};
+      EXPECT_EQ(output_share->GetProtocol(), MpcProtocol::kBooleanGmw);
+      auto output{output_share.Out()};
+      party->Run();
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        std::size_t a{0}, b{0}, sum{0};
+        for (std::size_t j = 0; j < 8; ++j) {
+          a |= static_cast<std::size_t>(inputs[j].Get(i)) << j;
+          b |= static_cast<std::size_t>(inputs[8 + j].Get(i)) << j;
+          sum |= static_cast<std::size_t>(
+                     output.GetWire(j).As<encrypto::motion::BitVector<>>().Get(i))
+                 << j;
+        }
+        EXPECT_EQ(sum, (a + b) % 256);
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+}  // namespace
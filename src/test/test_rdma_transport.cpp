@@ -0,0 +1,102 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <filesystem>
+#include <future>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "communication/rdma_transport.h"
+
+using namespace encrypto::motion::communication;
+
+namespace {
+
+bool HasRdmaDevice() {
+  const std::filesystem::path kDevices{"/sys/class/infiniband"};
+  return std::filesystem::exists(kDevices) && !std::filesystem::is_empty(kDevices);
+}
+
+std::pair<std::unique_ptr<Transport>, std::unique_ptr<Transport>> MakeTransportPair(
+    std::uint16_t port, std::size_t capacity) {
+  const TcpPartiesConfiguration parties_configuration{
+      {"127.0.0.1", port}, {"127.0.0.1", static_cast<std::uint16_t>(port + 1)}};
+  RdmaDeviceConfiguration device_configuration;
+  device_configuration.capacity = capacity;
+  auto future_alice = std::async(std::launch::async, [&] {
+    return RdmaSetupHelper(0, parties_configuration, device_configuration).SetupConnections();
+  });
+  auto transports_bob =
+      RdmaSetupHelper(1, parties_configuration, device_configuration).SetupConnections();
+  auto transports_alice = future_alice.get();
+  return {std::move(transports_alice.at(1)), std::move(transports_bob.at(0))};
+}
+
+}  // namespace
+
+TEST(RdmaTransport, SendReceive) {
+  if (!HasRdmaDevice()) GTEST_SKIP() << "no RDMA device";
+  auto [transport_alice, transport_bob] = MakeTransportPair(13441, 4096);
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+
+  EXPECT_FALSE(transport_bob->Available());
+  transport_alice->SendMessage(message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  EXPECT_FALSE(transport_bob->Available());
+
+  transport_bob->SendMessage(message);
+  EXPECT_EQ(transport_alice->ReceiveMessage(), message);
+
+  transport_alice->ShutdownSend();
+  EXPECT_EQ(transport_bob->ReceiveMessage(), std::nullopt);
+}
+
+TEST(RdmaTransport, MessagesLargerThanRing) {
+  if (!HasRdmaDevice()) GTEST_SKIP() << "no RDMA device";
+  // the ring is smaller than the messages which hence wrap around and are streamed through it
+  auto [transport_alice, transport_bob] = MakeTransportPair(13443, 64);
+
+  std::vector<std::vector<std::uint8_t>> messages;
+  for (std::size_t size : {0, 1, 63, 64, 1000, 100000}) {
+    std::vector<std::uint8_t> message(size);
+    std::iota(std::begin(message), std::end(message), static_cast<std::uint8_t>(size));
+    messages.push_back(std::move(message));
+  }
+
+  auto future_send = std::async(std::launch::async, [&, &transport_alice = transport_alice] {
+    for (const auto& message : messages) {
+      transport_alice->SendMessage(message);
+    }
+    transport_alice->ShutdownSend();
+  });
+  auto pool = std::make_shared<MessageBufferPool>();
+  for (const auto& message : messages) {
+    auto received_message = transport_bob->ReceivePooledMessage(*pool);
+    ASSERT_TRUE(received_message.has_value());
+    EXPECT_EQ(std::vector<std::uint8_t>(received_message->begin(), received_message->end()),
+              message);
+  }
+  EXPECT_EQ(transport_bob->ReceiveMessage(), std::nullopt);
+  future_send.get();
+}
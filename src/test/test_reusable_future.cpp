@@ -68,6 +68,21 @@ TEST(ReusableFuture, SetTwiceWithReset) {
   EXPECT_EQ(kInputValue2, output_value_2);
 }
 
+TEST(ReusableFuture, Renew) {
+  ReusablePromise<int> promise;
+  {
+    auto future = promise.get_future();
+    promise.set_value(42);
+    EXPECT_FALSE(promise.renew());
+  }
+  // the value of the destroyed future is dropped
+  EXPECT_TRUE(promise.renew());
+  auto future = promise.get_future();
+  promise.set_value(47);
+  EXPECT_EQ(future.get(), 47);
+  EXPECT_FALSE(promise.renew());
+}
+
 TEST(ReusableFuture, InvalidFuture) {
   ReusableFuture<int> future;
   EXPECT_FALSE(future.valid());
@@ -20,9 +20,14 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <array>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "primitives/blake2b.h"
 #include "primitives/random/aes128_ctr_rng.h"
 #include "primitives/random/openssl_rng.h"
+#include "primitives/sharing_randomness_generator.h"
 #include "test_constants.h"
 
 // Test vectors from NIST FIPS 197, Appendix A
@@ -53,6 +58,26 @@ TEST(Aes128CtrRng, NoTrivialOutput) {
   rngt.RandomBlocksAligned(output_1.data(), 10);
   EXPECT_NE(output_0, output_1);
 }
+
+TEST(Aes128CtrRng, ParallelRandomBytesEqualRandomBytes) {
+  using encrypto::motion::Aes128CtrRng;
+  std::array<std::byte, Aes128CtrRng::kBlockSize> key;
+  for (std::size_t i = 0; i < key.size(); ++i) key[i] = std::byte(i);
+  Aes128CtrRng rng1(key.data()), rng2(key.data());
+
+  // the bytes end within a block and are split into ranges of several threads
+  constexpr std::size_t kNumberOfBytes{
+      5 * Aes128CtrRng::kParallelBlocks * Aes128CtrRng::kBlockSize + 7};
+  std::vector<std::byte> output_0(kNumberOfBytes), output_1(kNumberOfBytes);
+  rng1.RandomBytes(output_0.data(), kNumberOfBytes);
+  rng2.ParallelRandomBytes(output_1.data(), kNumberOfBytes, 4);
+  EXPECT_EQ(output_0, output_1);
+
+  // both continue the stream at the same counter
+  rng1.RandomBytes(output_0.data(), 100);
+  rng2.ParallelRandomBytes(output_1.data(), 100, 4);
+  EXPECT_EQ(output_0, output_1);
+}
 #endif
 
 TEST(OpenSslRng, NoTrivialOutput) {
@@ -80,3 +105,102 @@ TEST(OpenSslRng, NoTrivialOutput) {
   rngt.RandomBlocksAligned(output_1.data(), 10);
   EXPECT_NE(output_0, output_1);
 }
+
+TEST(SharingRandomnessGenerator, UnsignedStream) {
+  using encrypto::motion::primitives::SharingRandomnessGenerator;
+  std::array<std::uint8_t, SharingRandomnessGenerator::kMasterSeedByteLength> seed;
+  for (std::size_t i = 0; i < seed.size(); ++i) seed[i] = static_cast<std::uint8_t>(i);
+  SharingRandomnessGenerator rng1(0), rng2(1);
+  rng1.Initialize(seed.data());
+  rng2.Initialize(seed.data());
+
+  // generators with the same seed expand the same values
+  const auto values{rng1.GetUnsignedStream<std::uint32_t>(42, 1001)};
+  EXPECT_EQ(values, rng2.GetUnsignedStream<std::uint32_t>(42, 1001));
+
+  // requests of a gate are prefixes of each other, also if they end within a block
+  const auto prefix{rng2.GetUnsignedStream<std::uint32_t>(42, 7)};
+  EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), values.begin()));
+  std::vector<std::uint32_t> output(3);
+  rng2.GetUnsignedStream<std::uint32_t>(42, std::span<std::uint32_t>(output));
+  EXPECT_TRUE(std::equal(output.begin(), output.end(), values.begin()));
+
+  // the streams of consecutive gate ids do not overlap
+  const auto next_gate{rng1.GetUnsignedStream<std::uint32_t>(43, 1001)};
+  EXPECT_NE(std::vector(values.begin() + 4, values.end()),
+            std::vector(next_gate.begin(), next_gate.end() - 4));
+  EXPECT_NE(values, next_gate);
+  EXPECT_TRUE(rng1.GetUnsignedStream<std::uint64_t>(42, 0).empty());
+}
+
+TEST(SharingRandomnessGenerator, RandomAccess) {
+  using encrypto::motion::primitives::SharingRandomnessGenerator;
+  constexpr std::size_t kLookahead{SharingRandomnessGenerator::kLookaheadBlocks};
+  std::array<std::uint8_t, SharingRandomnessGenerator::kMasterSeedByteLength> seed;
+  for (std::size_t i = 0; i < seed.size(); ++i) seed[i] = static_cast<std::uint8_t>(3 * i);
+  SharingRandomnessGenerator rng1(0), rng2(1);
+  rng1.Initialize(seed.data());
+  rng2.Initialize(seed.data());
+
+  // large requests are encrypted directly and small ones are served from the lookahead window,
+  // which both yield the values of the gate ids independently of the order of the requests
+  constexpr std::size_t kNumberOfGates{5 * kLookahead + 3};
+  const auto values{rng1.GetUnsigned<std::uint64_t>(7, kNumberOfGates)};
+  for (std::size_t i = kNumberOfGates; i-- > 0;) {
+    EXPECT_EQ(values[i], rng2.GetUnsigned<std::uint64_t>(7 + i));
+  }
+  for (std::size_t i = 0; i + 10 <= kNumberOfGates; i += 10) {
+    const auto chunk{rng2.GetUnsigned<std::uint64_t>(7 + i, 10)};
+    EXPECT_TRUE(std::equal(chunk.begin(), chunk.end(), values.begin() + i));
+  }
+  EXPECT_EQ(rng1.GetUnsigned<std::uint32_t>(11), rng2.GetUnsigned<std::uint32_t>(11, 1).at(0));
+  EXPECT_NE(values[0], values[1]);
+
+  // the same holds for bits at offsets that are not aligned to the blocks
+  constexpr std::size_t kNumberOfBits{3 * kLookahead * 128 + 77};
+  const auto bits{rng1.GetBits(5, kNumberOfBits)};
+  EXPECT_EQ(bits.GetSize(), kNumberOfBits);
+  for (std::size_t from = 0; from < kNumberOfBits; from += 1001) {
+    const std::size_t size{std::min<std::size_t>(1001, kNumberOfBits - from)};
+    EXPECT_TRUE(rng2.GetBits(5 + from, size) == bits.Subset(from, from + size));
+  }
+  rng1.ClearBitPool();
+  EXPECT_TRUE(rng1.GetBits(5 + 300, 3) == bits.Subset(300, 303));
+  EXPECT_TRUE(rng1.GetBits(5, 1) == bits.Subset(0, 1));
+  EXPECT_NE(bits.Subset(0, 128), bits.Subset(128, 256));
+}
+
+TEST(Blake2b, BatchAgreesWithSingleHashes) {
+  using encrypto::motion::BitwiseKernel;
+  constexpr std::size_t kNumberOfMessages{11};
+  constexpr std::size_t kDigestSize{encrypto::motion::kBlake2bDigestSize};
+  const auto default_kernel{encrypto::motion::GetBitwiseKernel()};
+  for (auto kernel : {BitwiseKernel::kSse, BitwiseKernel::kAvx2, BitwiseKernel::kAvx512}) {
+    if (!encrypto::motion::IsSupported(kernel)) continue;
+    encrypto::motion::SetBitwiseKernel(kernel);
+    // the lengths cover the empty message, partial and full last blocks
+    for (std::size_t length : {0, 1, 32, 96, 127, 128, 129, 256, 300}) {
+      std::vector<std::vector<std::uint8_t>> messages(kNumberOfMessages);
+      std::vector<const std::uint8_t*> message_pointers;
+      for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+        messages[i].resize(length);
+        for (std::size_t j = 0; j < length; ++j) messages[i][j] = std::uint8_t(i * 31 + j * 7);
+        message_pointers.push_back(messages[i].data());
+      }
+      std::vector<std::uint8_t> digests(kNumberOfMessages * kDigestSize);
+      std::vector<std::uint8_t*> digest_pointers;
+      for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+        digest_pointers.push_back(digests.data() + i * kDigestSize);
+      }
+      encrypto::motion::Blake2bBatch(message_pointers, length, digest_pointers);
+
+      for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+        std::array<std::uint8_t, EVP_MAX_MD_SIZE> expected;
+        encrypto::motion::Blake2b(messages[i].data(), expected.data(), length);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.begin() + kDigestSize,
+                               digest_pointers[i]));
+      }
+    }
+  }
+  encrypto::motion::SetBitwiseKernel(default_kernel);
+}
@@ -0,0 +1,159 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "base/party.h"
+#include "base/scale_out.h"
+#include "communication/dummy_transport.h"
+#include "protocols/boolean_gmw/boolean_gmw_wire.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+#include "test_constants.h"
+
+namespace {
+
+TEST(ScaleOut, SimdSlicesPartitionAllValues) {
+  for (std::size_t number_of_workers : {1, 3, 4, 7}) {
+    for (std::size_t number_of_simd : {0, 1, 6, 1000}) {
+      std::size_t offset{0};
+      for (std::size_t worker_i = 0; worker_i < number_of_workers; ++worker_i) {
+        const auto slice{
+            encrypto::motion::GetSimdSlice(number_of_simd, number_of_workers, worker_i)};
+        EXPECT_EQ(slice.offset, offset);
+        EXPECT_LE(slice.size, number_of_simd / number_of_workers + 1);
+        EXPECT_GE(slice.size, number_of_simd / number_of_workers);
+        offset += slice.size;
+      }
+      EXPECT_EQ(offset, number_of_simd);
+    }
+  }
+  EXPECT_THROW(encrypto::motion::GetSimdSlice(10, 2, 2), std::invalid_argument);
+}
+
+TEST(ScaleOut, ArithmeticScatterGather) {
+  auto [coordinator_transport, worker_transport] =
+      encrypto::motion::communication::DummyTransport::MakeTransportPair();
+  std::vector<std::unique_ptr<encrypto::motion::communication::Transport>> transports;
+  transports.emplace_back(std::move(coordinator_transport));
+  encrypto::motion::ScaleOutCoordinator coordinator(std::move(transports));
+  encrypto::motion::ScaleOutWorker worker(std::move(worker_transport), 0, 1);
+
+  const std::vector<std::uint32_t> values{1, 2, 3, 42};
+  coordinator.ScatterArithmeticInputs<std::uint32_t>(values);
+  auto received{worker.ReceiveArithmeticInputs<std::uint32_t>()};
+  EXPECT_EQ(received, values);
+  for (auto& value : received) value *= 2;
+  worker.SendArithmeticOutputs<std::uint32_t>(received);
+  EXPECT_EQ(coordinator.GatherArithmeticOutputs<std::uint32_t>(), received);
+  coordinator.Finish();
+}
+
+// two parties which each run two workers evaluate an AND of two wires with 1001 SIMD values
+TEST(ScaleOut, BooleanGmwAndOverWorkers) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties{2}, kNumberOfWorkers{2}, kNumberOfWires{2};
+  constexpr std::size_t kNumberOfSimd{1001};
+
+  std::array<std::vector<encrypto::motion::BitVector<>>, kNumberOfParties> inputs;
+  for (auto& party_inputs : inputs) {
+    for (std::size_t wire_i = 0; wire_i < kNumberOfWires; ++wire_i) {
+      party_inputs.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    }
+  }
+
+  std::vector<std::unique_ptr<encrypto::motion::ScaleOutCoordinator>> coordinators;
+  std::vector<std::unique_ptr<encrypto::motion::ScaleOutWorker>> workers;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    std::vector<std::unique_ptr<encrypto::motion::communication::Transport>> transports;
+    for (std::size_t worker_i = 0; worker_i < kNumberOfWorkers; ++worker_i) {
+      auto [coordinator_transport, worker_transport] =
+          encrypto::motion::communication::DummyTransport::MakeTransportPair();
+      transports.emplace_back(std::move(coordinator_transport));
+      workers.emplace_back(std::make_unique<encrypto::motion::ScaleOutWorker>(
+          std::move(worker_transport), worker_i, kNumberOfWorkers));
+    }
+    coordinators.emplace_back(
+        std::make_unique<encrypto::motion::ScaleOutCoordinator>(std::move(transports)));
+  }
+
+  // worker k of every party forms its own session
+  std::vector<std::vector<encrypto::motion::PartyPointer>> sessions;
+  for (std::size_t worker_i = 0; worker_i < kNumberOfWorkers; ++worker_i) {
+    sessions.emplace_back(
+        encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset));
+    for (auto& party : sessions.back()) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  }
+
+  std::array<std::vector<encrypto::motion::BitVector<>>, kNumberOfParties> outputs;
+  std::vector<std::thread> threads;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    threads.emplace_back([&, party_id] {
+      coordinators[party_id]->ScatterBooleanInputs(inputs[party_id]);
+      outputs[party_id] = coordinators[party_id]->GatherBooleanOutputs();
+      coordinators[party_id]->Finish();
+    });
+    for (std::size_t worker_i = 0; worker_i < kNumberOfWorkers; ++worker_i) {
+      threads.emplace_back([&, party_id, worker_i] {
+        auto& worker{*workers[party_id * kNumberOfWorkers + worker_i]};
+        auto& party{*sessions[worker_i][party_id]};
+        const auto own_inputs{worker.ReceiveBooleanInputs()};
+        const auto slice{worker.GetSimdSlice(kNumberOfSimd)};
+        const encrypto::motion::BitVector<> dummy_input(slice.size, false);
+
+        std::vector<encrypto::motion::ShareWrapper> output_shares;
+        for (std::size_t wire_i = 0; wire_i < kNumberOfWires; ++wire_i) {
+          encrypto::motion::ShareWrapper share_0{
+              party.In<kBooleanGmw>(party_id == 0 ? own_inputs[wire_i] : dummy_input, 0)};
+          encrypto::motion::ShareWrapper share_1{
+              party.In<kBooleanGmw>(party_id == 1 ? own_inputs[wire_i] : dummy_input, 1)};
+          output_shares.emplace_back((share_0 & share_1).Out());
+        }
+        party.Run();
+        party.Finish();
+
+        std::vector<encrypto::motion::BitVector<>> own_outputs;
+        for (const auto& output_share : output_shares) {
+          auto wire{std::dynamic_pointer_cast<encrypto::motion::proto::boolean_gmw::Wire>(
+              output_share->GetWires().at(0))};
+          own_outputs.emplace_back(wire->GetValues());
+        }
+        worker.SendBooleanOutputs(own_outputs);
+      });
+    }
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    ASSERT_EQ(outputs[party_id].size(), kNumberOfWires);
+    for (std::size_t wire_i = 0; wire_i < kNumberOfWires; ++wire_i) {
+      EXPECT_EQ(outputs[party_id][wire_i], inputs[0][wire_i] & inputs[1][wire_i]);
+    }
+  }
+}
+
+}  // namespace
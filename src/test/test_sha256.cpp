@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <gtest/gtest.h>
+
+#include <openssl/sha.h>
+
+#include <future>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithm/sha256.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+#include "test_constants.h"
+
+namespace {
+
+using encrypto::motion::MpcProtocol;
+using encrypto::motion::algorithm::IntegerCircuitOptimization;
+
+// hashes number_of_messages random messages of number_of_bytes bytes with 2 parties in protocol P
+template <MpcProtocol P>
+void TestSha256(std::size_t number_of_messages, std::size_t number_of_bytes,
+                IntegerCircuitOptimization optimization) {
+  std::mt19937 random(number_of_bytes);
+  std::vector<std::vector<std::uint8_t>> messages(number_of_messages,
+                                                  std::vector<std::uint8_t>(number_of_bytes));
+  std::vector<std::vector<std::uint8_t>> expected_digests;
+  for (auto& message : messages) {
+    for (auto& byte : message) byte = static_cast<std::uint8_t>(random());
+    std::vector<std::uint8_t> digest(SHA256_DIGEST_LENGTH);
+    SHA256(message.data(), message.size(), digest.data());
+    expected_digests.emplace_back(std::move(digest));
+  }
+  const auto padded_messages{encrypto::motion::algorithm::Sha256PadMessages(messages)};
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      auto& party{parties[party_id]};
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      encrypto::motion::ShareWrapper input{
+          party->In<P>(std::span<const encrypto::motion::BitVector<>>(padded_messages), 0)};
+      auto output{encrypto::motion::algorithm::Sha256(input, optimization).Out()};
+      party->Run();
+      std::vector<encrypto::motion::BitVector<>> digest_wires;
+      for (std::size_t i = 0; i < encrypto::motion::algorithm::kSha256DigestBitSize; ++i) {
+        digest_wires.emplace_back(output.GetWire(i).As<encrypto::motion::BitVector<>>());
+      }
+      EXPECT_EQ(encrypto::motion::algorithm::Sha256Digests(digest_wires), expected_digests);
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(Sha256, PadMessages) {
+  const std::vector<std::vector<std::uint8_t>> messages{std::vector<std::uint8_t>(55),
+                                                        std::vector<std::uint8_t>(30)};
+  const auto wires{encrypto::motion::algorithm::Sha256PadMessages(messages)};
+  ASSERT_EQ(wires.size(), encrypto::motion::algorithm::kSha256BlockBitSize);
+  EXPECT_EQ(wires[0].GetSize(), messages.size());
+  // the 0x80 padding byte follows each message
+  EXPECT_TRUE(wires[511 - 8 * 55].Get(0));
+  EXPECT_TRUE(wires[511 - 8 * 30].Get(1));
+  // a 56-byte message needs a second block for its length
+  const std::vector<std::vector<std::uint8_t>> mismatching_messages{
+      std::vector<std::uint8_t>(55), std::vector<std::uint8_t>(56)};
+  EXPECT_THROW(encrypto::motion::algorithm::Sha256PadMessages(mismatching_messages),
+               std::invalid_argument);
+}
+
+TEST(Sha256, BooleanGmwMatchesOpenSsl) {
+  for (const auto optimization :
+       {IntegerCircuitOptimization::kSize, IntegerCircuitOptimization::kDepth}) {
+    TestSha256<MpcProtocol::kBooleanGmw>(3, 70, optimization);
+  }
+}
+
+TEST(Sha256, GarbledCircuitMatchesOpenSsl) {
+  TestSha256<MpcProtocol::kGarbledCircuit>(2, 20, IntegerCircuitOptimization::kDepth);
+}
+
+}  // namespace
@@ -0,0 +1,130 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "test_constants.h"
+
+#include "base/backend.h"
+#include "base/party.h"
+#include "data_storage/share_store.h"
+#include "protocols/share_wrapper.h"
+
+namespace {
+
+using encrypto::motion::BitVector;
+using encrypto::motion::MakeLocallyConnectedParties;
+using encrypto::motion::ShareStore;
+using encrypto::motion::ShareStoreWriter;
+using encrypto::motion::ShareWrapper;
+
+constexpr std::uint64_t kSessionId{0x5ba1e5};
+
+std::filesystem::path MakeStorePath(std::size_t party_id) {
+  return std::filesystem::temp_directory_path() /
+         ("motion_test_shares_" + std::to_string(party_id) + ".store");
+}
+
+// the first job stores the products of its inputs, the second job reloads them as shares
+TEST(ShareStore, ReloadsSharesOfTheLastStage) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties{3}, kNumberOfSimd{13};
+  std::mt19937_64 random(0);
+  std::vector<std::uint32_t> input_a(kNumberOfSimd), input_b(kNumberOfSimd);
+  for (auto& value : input_a) value = static_cast<std::uint32_t>(random());
+  for (auto& value : input_b) value = static_cast<std::uint32_t>(random());
+  std::vector<BitVector<>> bits_a, bits_b;
+  for (std::size_t i = 0; i < 5; ++i) {
+    bits_a.emplace_back(BitVector<>::SecureRandom(kNumberOfSimd));
+    bits_b.emplace_back(BitVector<>::SecureRandom(kNumberOfSimd));
+  }
+  const std::vector<std::uint32_t> dummy_input(kNumberOfSimd, 0);
+  const std::vector<BitVector<>> dummy_bits(5, BitVector<>(kNumberOfSimd));
+
+  {
+    auto motion_parties{MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+        auto& party{*motion_parties.at(party_id)};
+        party.GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        ShareWrapper a{party.In<kArithmeticGmw>(party_id == 0 ? input_a : dummy_input, 0)};
+        ShareWrapper b{party.In<kArithmeticGmw>(party_id == 1 ? input_b : dummy_input, 1)};
+        ShareWrapper x{party.In<kBooleanGmw>(party_id == 0 ? bits_a : dummy_bits, 0)};
+        ShareWrapper y{party.In<kBooleanGmw>(party_id == 2 ? bits_b : dummy_bits, 2)};
+        auto product{a * b};
+        auto conjunction{x & y};
+        party.Run();
+        ShareStoreWriter writer(kSessionId, party_id, kNumberOfParties);
+        EXPECT_EQ(writer.Add(product.Get()), 0);
+        EXPECT_EQ(writer.Add(conjunction.Get()), 1);
+        writer.Write(MakeStorePath(party_id));
+        party.Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+
+  auto motion_parties{MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      auto& party{*motion_parties.at(party_id)};
+      party.GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      EXPECT_THROW(ShareStore(MakeStorePath(party_id), kSessionId + 1, party_id),
+                   std::runtime_error);
+      ShareStore store(MakeStorePath(party_id), kSessionId, party_id);
+      ASSERT_EQ(store.GetNumberOfShares(), 2);
+      EXPECT_EQ(store.GetEntry(0).number_of_simd_values, kNumberOfSimd);
+      EXPECT_EQ(store.GetEntry(1).bit_length, 5);
+      ShareWrapper product{store.Load(*party.GetBackend(), 0)};
+      ShareWrapper conjunction{store.Load(*party.GetBackend(), 1)};
+      auto output_product{(product + product).Out()};
+      auto output_conjunction{(conjunction ^ conjunction).Out()};
+      auto output_loaded{conjunction.Out()};
+      party.Run();
+      const auto products{output_product.As<std::vector<std::uint32_t>>()};
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        EXPECT_EQ(products[i], static_cast<std::uint32_t>(2 * input_a[i] * input_b[i]));
+      }
+      const auto conjunctions{output_loaded.As<std::vector<BitVector<>>>()};
+      for (std::size_t i = 0; i < bits_a.size(); ++i) {
+        EXPECT_TRUE(conjunctions[i] == (bits_a[i] & bits_b[i]));
+        EXPECT_TRUE(output_conjunction.As<std::vector<BitVector<>>>()[i] ==
+                    BitVector<>(kNumberOfSimd));
+      }
+      party.Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    std::filesystem::remove(MakeStorePath(party_id));
+  }
+}
+
+}  // namespace
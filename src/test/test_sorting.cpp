@@ -0,0 +1,166 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "algorithm/sorting.h"
+#include "base/party.h"
+#include "secure_type/secure_unsigned_integer.h"
+#include "utility/bit_vector.h"
+
+#include "test_constants.h"
+
+namespace {
+
+using encrypto::motion::MpcProtocol;
+using encrypto::motion::SecureUnsignedInteger;
+using encrypto::motion::algorithm::SortingNetworkType;
+
+constexpr std::array kSortingNetworkTypes{SortingNetworkType::kBitonic,
+                                          SortingNetworkType::kOddEvenMerge};
+
+TEST(SortingNetwork, SortsAllZeroOneInputs) {
+  for (auto type : kSortingNetworkTypes) {
+    for (std::size_t n = 1; n <= 12; ++n) {
+      const auto network{encrypto::motion::algorithm::MakeSortingNetwork(n, type)};
+      // a network sorts all inputs if it sorts all 0-1 inputs
+      for (std::size_t input = 0; input < (std::size_t(1) << n); ++input) {
+        std::vector<bool> values(n);
+        for (std::size_t i = 0; i < n; ++i) values[i] = (input >> i) & 1;
+        for (const auto& layer : network) {
+          std::vector<bool> is_used(n, false);
+          for (const auto& [low, high] : layer) {
+            ASSERT_LT(low, high);
+            ASSERT_LT(high, n);
+            ASSERT_FALSE(is_used[low] || is_used[high]);
+            is_used[low] = is_used[high] = true;
+            if (values[low] && !values[high]) values[low] = false, values[high] = true;
+          }
+        }
+        ASSERT_TRUE(std::is_sorted(values.begin(), values.end())) << n << " " << input;
+      }
+    }
+  }
+  // log(n) * (log(n) + 1) / 2 layers for powers of two
+  for (auto type : kSortingNetworkTypes) {
+    EXPECT_EQ(encrypto::motion::algorithm::MakeSortingNetwork(64, type).size(), 21);
+  }
+}
+
+// evaluates function on the SIMD input values of party 0 in protocol and returns its output
+template <MpcProtocol P, typename Function>
+std::vector<std::vector<std::uint32_t>> EvaluateOnValues(const std::vector<std::uint32_t>& values,
+                                                         std::size_t number_of_parties,
+                                                         Function function) {
+  std::vector<std::vector<std::uint32_t>> results(number_of_parties);
+  std::vector<encrypto::motion::PartyPointer> motion_parties(
+      encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(true);
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    threads.emplace_back([party_id, &motion_parties, &values, &results, &function]() {
+      auto& party{motion_parties.at(party_id)};
+      const std::vector<std::uint32_t> my_values{party_id == 0
+                                                     ? values
+                                                     : std::vector<std::uint32_t>(values.size())};
+      SecureUnsignedInteger input;
+      if constexpr (P == MpcProtocol::kArithmeticGmw) {
+        input = party->In<P>(my_values, 0);
+      } else {
+        input = party->In<P>(encrypto::motion::ToInput(my_values), 0);
+      }
+      auto output{function(input).Out()};
+      party->Run();
+      results.at(party_id) = output.template As<std::vector<std::uint32_t>>();
+      party->Finish();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  return results;
+}
+
+std::vector<std::uint32_t> RandomValues(std::size_t n) {
+  std::mt19937 random(n);
+  // small values such that there are duplicates
+  std::uniform_int_distribution<std::uint32_t> distribution(0, 99);
+  std::vector<std::uint32_t> values(n);
+  for (auto& value : values) value = distribution(random);
+  return values;
+}
+
+template <MpcProtocol P>
+void TestSort(std::size_t number_of_parties) {
+  for (auto type : kSortingNetworkTypes) {
+    const auto values{RandomValues(21)};
+    auto expected{values};
+    std::sort(expected.begin(), expected.end());
+    for (const auto& result : EvaluateOnValues<P>(values, number_of_parties, [type](auto& input) {
+           return encrypto::motion::algorithm::Sort(input, type);
+         })) {
+      EXPECT_EQ(result, expected);
+    }
+
+    const std::vector<std::uint32_t> expected_top_k(expected.end() - 5, expected.end());
+    for (const auto& result : EvaluateOnValues<P>(values, number_of_parties, [type](auto& input) {
+           return encrypto::motion::algorithm::TopK(input, 5, type);
+         })) {
+      EXPECT_EQ(result, expected_top_k);
+    }
+  }
+}
+
+TEST(Sorting, SortAndTopKInBooleanGmw_3_parties) { TestSort<MpcProtocol::kBooleanGmw>(3); }
+
+TEST(Sorting, SortAndTopKInBmr_3_parties) { TestSort<MpcProtocol::kBmr>(3); }
+
+TEST(Sorting, SortAndTopKInArithmeticGmw_2_parties) { TestSort<MpcProtocol::kArithmeticGmw>(2); }
+
+template <MpcProtocol P>
+void TestShuffle(std::size_t number_of_parties) {
+  const auto values{RandomValues(40)};
+  auto expected{values};
+  std::sort(expected.begin(), expected.end());
+  const auto results{EvaluateOnValues<P>(values, number_of_parties, [](auto& input) {
+    return encrypto::motion::algorithm::Shuffle(input);
+  })};
+  for (auto result : results) {
+    EXPECT_EQ(result, results.front());
+    // the shuffled values are a permutation of the input
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, expected);
+  }
+}
+
+TEST(Sorting, ShuffleInBooleanGmw_3_parties) { TestShuffle<MpcProtocol::kBooleanGmw>(3); }
+
+TEST(Sorting, ShuffleInArithmeticGmw_2_parties) { TestShuffle<MpcProtocol::kArithmeticGmw>(2); }
+
+}  // namespace
@@ -22,12 +22,15 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <array>
 #include <future>
+#include <numeric>
 #include <random>
 
 #include <gtest/gtest.h>
 
 #include "base/party.h"
+#include "protocols/data_management/subset_gate.h"
 #include "protocols/share_wrapper.h"
 #include "secure_type/secure_unsigned_integer.h"
 #include "test_constants.h"
@@ -53,6 +56,9 @@ class SubsetTest : public testing::TestWithParam<ParametersType> {
     for (std::size_t& i : this->positions_) {
       i = dist(mersenne_twister);
     }
+    // a run of consecutive positions, which is copied as a range
+    const std::size_t run_begin{dist(mersenne_twister)};
+    for (std::size_t i = run_begin; i < this->number_of_simd_; ++i) this->positions_.push_back(i);
 
     // Generate random inputs.
     plaintext_boolean_input_.resize(this->number_of_wires_);
@@ -204,6 +210,53 @@ TEST_P(BooleanSubsetTest, BooleanGmw) {
   }
 }
 
+TEST(SubsetRanges, CompressesEquidistantPositions) {
+  const std::vector<std::size_t> positions{3, 4, 5, 7, 7, 7, 2, 10, 12, 14, 16, 9};
+  const auto ranges{encrypto::motion::ToSubsetRanges(positions)};
+  ASSERT_EQ(ranges.size(), 5);
+  const std::vector<std::array<std::size_t, 3>> expected{
+      {3, 1, 3}, {7, 0, 3}, {2, 1, 1}, {10, 2, 4}, {9, 1, 1}};
+  for (std::size_t i = 0; i < ranges.size(); ++i) {
+    EXPECT_EQ(ranges[i].from, expected[i][0]);
+    EXPECT_EQ(ranges[i].stride, expected[i][1]);
+    EXPECT_EQ(ranges[i].length, expected[i][2]);
+  }
+
+  // positions, which are not compressed, are gathered one by one
+  EXPECT_TRUE(encrypto::motion::ToSubsetRanges(std::vector<std::size_t>{5, 3, 8, 1}).empty());
+
+  const auto bits{encrypto::motion::BitVector<>::RandomSeeded(20, 0)};
+  const auto subset{encrypto::motion::BitVectorSubset(bits, positions, ranges)};
+  ASSERT_EQ(subset.GetSize(), positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i) EXPECT_EQ(subset[i], bits[positions[i]]);
+}
+
+TEST_P(BooleanSubsetTest, IdentityReferencesParentWires) {
+  std::vector<std::size_t> identity(this->number_of_simd_);
+  std::iota(identity.begin(), identity.end(), 0);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < this->motion_parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [party_id, &identity, this]() {
+      encrypto::motion::ShareWrapper share_input{
+          this->motion_parties_.at(party_id)->In<encrypto::motion::MpcProtocol::kBooleanGmw>(
+              this->plaintext_boolean_input_, this->input_owner_)};
+
+      auto share_subset = share_input.Subset(identity);
+      EXPECT_TRUE(share_subset->GetWires() == share_input->GetWires());
+      auto share_output = share_subset.Out();
+
+      this->motion_parties_.at(party_id)->Run();
+
+      if (party_id == this->input_owner_) {
+        EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(),
+                  this->plaintext_boolean_input_);
+      }
+      this->motion_parties_.at(party_id)->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
 TEST_P(ArithmeticSubsetTest, ArithmeticGmw) {
   try {
     std::vector<std::future<void>> futures;
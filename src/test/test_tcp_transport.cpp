@@ -21,8 +21,21 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <openssl/x509v3.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
+#include <cstdio>
+#include <filesystem>
 #include <future>
+#include <span>
+#include <thread>
+#include <vector>
 
 #include "communication/tcp_transport.h"
 
@@ -56,5 +69,243 @@ TEST_P(TcpTransportTest, dummy) {
   EXPECT_EQ(ReceivedMessage, message);
 }
 
+TEST_P(TcpTransportTest, SendMessages) {
+  auto localhost = GetParam();
+  auto transport_alice_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        0, {{localhost, 13339}, {localhost, 13340}});
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        1, {{localhost, 13339}, {localhost, 13340}});
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_future.get();
+  auto transport_bob = transport_bob_future.get();
+
+  const std::vector<std::vector<std::uint8_t>> messages = {
+      {0xde, 0xad}, {}, {0xbe, 0xef, 0x42}, std::vector<std::uint8_t>(100, 0x13)};
+  const std::vector<std::span<const std::uint8_t>> spans(messages.begin(), messages.end());
+
+  transport_alice->SendMessages(spans);
+  // all messages and their size prefixes fit into a single vectored write
+  EXPECT_EQ(transport_alice->GetStatistics().number_of_send_calls, 1);
+  EXPECT_EQ(transport_alice->GetStatistics().number_of_messages_sent, messages.size());
+  for (const auto& message : messages) {
+    auto received_message = transport_bob->ReceiveMessage();
+    EXPECT_EQ(received_message, message);
+  }
+}
+
+TEST_P(TcpTransportTest, StripedMessages) {
+  constexpr std::size_t kNumberOfConnections = 3;
+  auto localhost = GetParam();
+  auto transport_alice_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        0, {{localhost, 13341}, {localhost, 13342}}, kNumberOfConnections);
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        1, {{localhost, 13341}, {localhost, 13342}}, kNumberOfConnections);
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_future.get();
+  auto transport_bob = transport_bob_future.get();
+
+  // a striped message whose size is not divisible by the number of connections between two
+  // messages sent via the first connection only
+  constexpr auto kLargeMessageSize =
+      encrypto::motion::communication::TcpTransport::kMinStripedMessageSize * 2 + 1;
+  std::vector<std::uint8_t> large_message(kLargeMessageSize);
+  for (std::size_t i = 0; i < large_message.size(); ++i) {
+    large_message[i] = static_cast<std::uint8_t>(i * 7);
+  }
+  const std::vector<std::vector<std::uint8_t>> messages = {
+      {0xde, 0xad}, large_message, {0xbe, 0xef}};
+
+  auto send_future = std::async(std::launch::async, [&] {
+    for (const auto& message : messages) {
+      transport_alice->SendMessage(message);
+    }
+  });
+  for (const auto& message : messages) {
+    auto received_message = transport_bob->ReceiveMessage();
+    EXPECT_EQ(received_message, message);
+  }
+  send_future.get();
+}
+
 INSTANTIATE_TEST_SUITE_P(TcpTransportSuite, TcpTransportTest, testing::Values("127.0.0.1", "::1"),
                          [](auto& info) { return info.param == "::1" ? "ipv6" : "ipv4"; });
+
+TEST(TcpSetupHelper, ConcurrentSetupWithLateParty) {
+  constexpr std::size_t kNumberOfParties = 4, kNumberOfConnections = 2;
+  encrypto::motion::communication::TcpPartiesConfiguration parties_configuration;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    parties_configuration.emplace_back("127.0.0.1", 13345 + party_id);
+  }
+  // party 0 listens late, so the others retry while their remaining connections are established
+  using Transports = std::vector<std::unique_ptr<encrypto::motion::communication::Transport>>;
+  std::vector<std::future<Transports>> transport_futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    transport_futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      if (party_id == 0) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      encrypto::motion::communication::TcpSetupHelper helper(party_id, parties_configuration,
+                                                             kNumberOfConnections);
+      return helper.SetupConnections();
+    }));
+  }
+  std::vector<Transports> transports;
+  for (auto& transport_future : transport_futures) transports.push_back(transport_future.get());
+
+  for (std::size_t sender = 0; sender < kNumberOfParties; ++sender) {
+    for (std::size_t receiver = 0; receiver < kNumberOfParties; ++receiver) {
+      if (sender == receiver) continue;
+      const std::vector<std::uint8_t> message = {static_cast<std::uint8_t>(sender),
+                                                 static_cast<std::uint8_t>(receiver)};
+      transports.at(sender).at(receiver)->SendMessage(message);
+      EXPECT_EQ(transports.at(receiver).at(sender)->ReceiveMessage(), message);
+    }
+  }
+}
+
+TEST(TcpSetupHelper, BoundedRetries) {
+  encrypto::motion::communication::TcpSetupHelper helper(
+      1, {{"127.0.0.1", 13349}, {"127.0.0.1", 13350}});
+  EXPECT_THROW(helper.SetRetryConfiguration({0}), std::invalid_argument);
+  helper.SetRetryConfiguration({3, std::chrono::milliseconds(1), std::chrono::milliseconds(2)});
+  // nobody listens for the connection to party 0
+  EXPECT_THROW(helper.SetupConnections(), std::runtime_error);
+}
+
+namespace {
+
+// check if the kernel can take over TLS connections, i.e., the tls module is loaded
+bool HasKernelTls() {
+  const int listener = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_size = sizeof(address);
+  bool result = false;
+  if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+      getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_size) == 0 &&
+      listen(listener, 1) == 0) {
+    // the tls upper layer protocol can only be attached to connected sockets
+    const int client = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+      result = setsockopt(client, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0;
+    }
+    close(client);
+  }
+  close(listener);
+  return result;
+}
+
+// write a certificate authority and a certificate issued by it, which both parties share, and
+// return the configuration using them
+encrypto::motion::communication::TcpTlsConfiguration WriteTestCertificates(
+    const std::filesystem::path& directory) {
+  auto make_key = [] { return EVP_EC_gen("P-256"); };
+  auto make_certificate = [](EVP_PKEY* key, X509* issuer, EVP_PKEY* issuer_key,
+                             const char* common_name) {
+    X509* certificate = X509_new();
+    X509_set_version(certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), issuer == nullptr ? 1 : 2);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 24 * 60 * 60);
+    X509_set_pubkey(certificate, key);
+    auto* name = X509_get_subject_name(certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>(common_name), -1, -1, 0);
+    X509_set_issuer_name(certificate,
+                         issuer == nullptr ? name : X509_get_subject_name(issuer));
+    if (issuer == nullptr) {
+      X509V3_CTX context;
+      X509V3_set_ctx_nodb(&context);
+      X509V3_set_ctx(&context, certificate, certificate, nullptr, nullptr, 0);
+      auto* extension =
+          X509V3_EXT_conf_nid(nullptr, &context, NID_basic_constraints, "critical,CA:TRUE");
+      X509_add_ext(certificate, extension, -1);
+      X509_EXTENSION_free(extension);
+    }
+    X509_sign(certificate, issuer_key, EVP_sha256());
+    return certificate;
+  };
+  auto write = [](const std::filesystem::path& path, auto&& write_function) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    write_function(file);
+    std::fclose(file);
+  };
+
+  auto* authority_key = make_key();
+  auto* authority = make_certificate(authority_key, nullptr, authority_key, "MOTION test CA");
+  auto* party_key = make_key();
+  auto* party = make_certificate(party_key, authority, authority_key, "MOTION test party");
+  encrypto::motion::communication::TcpTlsConfiguration configuration{
+      (directory / "party.pem").string(), (directory / "party.key").string(),
+      (directory / "authority.pem").string()};
+  write(configuration.certificate_file, [party](FILE* file) { PEM_write_X509(file, party); });
+  write(configuration.private_key_file, [party_key](FILE* file) {
+    PEM_write_PrivateKey(file, party_key, nullptr, nullptr, 0, nullptr, nullptr);
+  });
+  write(configuration.certificate_authority_file,
+        [authority](FILE* file) { PEM_write_X509(file, authority); });
+  X509_free(party);
+  EVP_PKEY_free(party_key);
+  X509_free(authority);
+  EVP_PKEY_free(authority_key);
+  return configuration;
+}
+
+}  // namespace
+
+TEST(TcpTransportTls, KernelTlsStripedMessages) {
+  if (!HasKernelTls()) GTEST_SKIP() << "kernel TLS is not available";
+  constexpr std::size_t kNumberOfConnections = 2;
+  const auto directory{std::filesystem::temp_directory_path() / "motiontest-tls"};
+  std::filesystem::create_directories(directory);
+  const auto tls_configuration{WriteTestCertificates(directory)};
+  auto make_transport = [&tls_configuration](std::size_t my_id) {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        my_id, {{"127.0.0.1", 13343}, {"127.0.0.1", 13344}}, kNumberOfConnections);
+    helper.SetTlsConfiguration(tls_configuration);
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(1 - my_id));
+  };
+  auto transport_alice_future = std::async(std::launch::async, make_transport, 0);
+  auto transport_bob_future = std::async(std::launch::async, make_transport, 1);
+  auto transport_alice = transport_alice_future.get();
+  auto transport_bob = transport_bob_future.get();
+  std::filesystem::remove_all(directory);
+
+  // the records are encrypted by the kernel, so the messages arrive unchanged via the plain
+  // socket reads and writes
+  constexpr auto kLargeMessageSize =
+      encrypto::motion::communication::TcpTransport::kMinStripedMessageSize + 1;
+  std::vector<std::uint8_t> large_message(kLargeMessageSize);
+  for (std::size_t i = 0; i < large_message.size(); ++i) {
+    large_message[i] = static_cast<std::uint8_t>(i * 7);
+  }
+  const std::vector<std::vector<std::uint8_t>> messages = {
+      {0xde, 0xad}, large_message, {0xbe, 0xef}};
+
+  auto send_future = std::async(std::launch::async, [&] {
+    for (const auto& message : messages) {
+      transport_alice->SendMessage(message);
+    }
+  });
+  for (const auto& message : messages) {
+    EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  }
+  send_future.get();
+  transport_bob->SendMessage(messages.front());
+  EXPECT_EQ(transport_alice->ReceiveMessage(), messages.front());
+}
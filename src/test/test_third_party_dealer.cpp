@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "test_constants.h"
+
+#include "base/backend.h"
+#include "base/party.h"
+#include "base/third_party_dealer.h"
+#include "communication/dummy_transport.h"
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sp_provider.h"
+#include "oblivious_transfer/ot_flavors.h"
+#include "oblivious_transfer/ot_provider.h"
+
+namespace {
+
+TEST(ThirdPartyDealer, Correlations) {
+  constexpr std::size_t kNumberOfMts{1000}, kNumberOfSps{1000}, kNumberOfOts{500};
+  constexpr std::array<std::size_t, 2> kBitlengths{64, 200};
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<std::unique_ptr<encrypto::motion::communication::Transport>> dealer_transports;
+    std::vector<std::unique_ptr<encrypto::motion::communication::Transport>> party_transports;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      auto [dealer_transport, party_transport] =
+          encrypto::motion::communication::DummyTransport::MakeTransportPair();
+      dealer_transports.emplace_back(std::move(dealer_transport));
+      party_transports.emplace_back(std::move(party_transport));
+    }
+    encrypto::motion::ThirdPartyDealer dealer(std::move(dealer_transports));
+    std::thread dealer_thread([&dealer] { dealer.Run(); });
+
+    // OTs in which party 0 is the sender and party 1 the receiver
+    std::vector<std::unique_ptr<encrypto::motion::ROtSender>> sender_ots;
+    std::vector<std::unique_ptr<encrypto::motion::ROtReceiver>> receiver_ots;
+    {
+      auto motion_parties =
+          encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+      for (std::size_t i = 0; i < number_of_parties; ++i) {
+        auto& backend{motion_parties[i]->GetBackend()};
+        motion_parties[i]->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        backend->SetThirdPartyDealer(std::move(party_transports[i]));
+        backend->GetMtProvider().RequestBinaryMts(kNumberOfMts);
+        backend->GetMtProvider().RequestArithmeticMts<std::uint32_t>(kNumberOfMts);
+        backend->GetSpProvider().RequestSps<std::uint64_t>(kNumberOfSps);
+      }
+      for (auto bitlength : kBitlengths) {
+        sender_ots.emplace_back(
+            motion_parties[0]->GetBackend()->GetOtProvider(1).RegisterSendROt(kNumberOfOts,
+                                                                              bitlength));
+        receiver_ots.emplace_back(
+            motion_parties[1]->GetBackend()->GetOtProvider(0).RegisterReceiveROt(kNumberOfOts,
+                                                                                 bitlength));
+      }
+
+      std::vector<std::future<void>> futures;
+      for (auto& party : motion_parties) {
+        futures.emplace_back(
+            std::async(std::launch::async, [&party] { party->GetBackend()->RunPreprocessing(); }));
+      }
+      for (auto& future : futures) future.get();
+
+      const auto& binary_mts_0{motion_parties[0]->GetBackend()->GetMtProvider().GetBinaryAll()};
+      auto a{binary_mts_0.a}, b{binary_mts_0.b}, c{binary_mts_0.c};
+      auto integer_mts{
+          motion_parties[0]->GetBackend()->GetMtProvider().GetIntegerAll<std::uint32_t>()};
+      auto sps{motion_parties[0]->GetBackend()->GetSpProvider().GetSpsAll<std::uint64_t>()};
+      for (std::size_t i = 1; i < number_of_parties; ++i) {
+        auto& backend{motion_parties[i]->GetBackend()};
+        const auto& binary_mts{backend->GetMtProvider().GetBinaryAll()};
+        a ^= binary_mts.a;
+        b ^= binary_mts.b;
+        c ^= binary_mts.c;
+        const auto& integer_mts_i{backend->GetMtProvider().GetIntegerAll<std::uint32_t>()};
+        const auto& sps_i{backend->GetSpProvider().GetSpsAll<std::uint64_t>()};
+        for (std::size_t j = 0; j < kNumberOfMts; ++j) {
+          integer_mts.a[j] += integer_mts_i.a[j];
+          integer_mts.b[j] += integer_mts_i.b[j];
+          integer_mts.c[j] += integer_mts_i.c[j];
+        }
+        for (std::size_t j = 0; j < kNumberOfSps; ++j) {
+          sps.a[j] += sps_i.a[j];
+          sps.c[j] += sps_i.c[j];
+        }
+      }
+      EXPECT_EQ(c, a & b);
+      for (std::size_t j = 0; j < kNumberOfMts; ++j) {
+        EXPECT_EQ(integer_mts.c[j],
+                  static_cast<std::uint32_t>(integer_mts.a[j] * integer_mts.b[j]));
+      }
+      for (std::size_t j = 0; j < kNumberOfSps; ++j) {
+        EXPECT_EQ(sps.c[j], sps.a[j] * sps.a[j]);
+      }
+
+      for (std::size_t k = 0; k < kBitlengths.size(); ++k) {
+        sender_ots[k]->ComputeOutputs();
+        receiver_ots[k]->ComputeOutputs();
+        const auto sender_outputs{sender_ots[k]->GetOutputs()};
+        const auto receiver_outputs{receiver_ots[k]->GetOutputs()};
+        const auto& choices{receiver_ots[k]->GetChoices()};
+        for (std::size_t j = 0; j < kNumberOfOts; ++j) {
+          const std::size_t begin{choices.Get(j) ? kBitlengths[k] : 0};
+          EXPECT_EQ(receiver_outputs[j], sender_outputs[j].Subset(begin, begin + kBitlengths[k]));
+        }
+      }
+
+      futures.clear();
+      for (auto& party : motion_parties) {
+        futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+      }
+      for (auto& future : futures) future.get();
+    }
+    // the dealer stops when the parties have closed their transports
+    dealer_thread.join();
+  }
+}
+
+}  // namespace
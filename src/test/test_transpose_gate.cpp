@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <future>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+
+namespace {
+
+// number of parties, wires, SIMD values, online-after-setup flag
+using ParametersType = std::tuple<std::size_t, std::size_t, std::size_t, bool>;
+
+class TransposeTest : public testing::TestWithParam<ParametersType> {
+ public:
+  void SetUp() override {
+    std::tie(number_of_parties_, number_of_wires_, number_of_simd_, online_after_setup_) =
+        GetParam();
+
+    plaintext_input_.resize(number_of_wires_);
+    for (std::size_t i = 0; i < plaintext_input_.size(); ++i) {
+      plaintext_input_[i] = encrypto::motion::BitVector<>::RandomSeeded(number_of_simd_, i);
+    }
+
+    motion_parties_ =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties_, kPortOffset);
+    for (auto& party : motion_parties_) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(online_after_setup_);
+    }
+  }
+
+  // SIMD value i of output wire j must be SIMD value j of input wire i
+  void CheckCorrectness(const std::vector<encrypto::motion::BitVector<>>& transposed) {
+    ASSERT_EQ(transposed.size(), number_of_simd_);
+    for (std::size_t j = 0; j < number_of_simd_; ++j) {
+      ASSERT_EQ(transposed[j].GetSize(), number_of_wires_);
+      for (std::size_t i = 0; i < number_of_wires_; ++i) {
+        EXPECT_EQ(transposed[j].Get(i), plaintext_input_[i].Get(j));
+      }
+    }
+  }
+
+  template <encrypto::motion::MpcProtocol Protocol>
+  void RunTransposition() {
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < motion_parties_.size(); ++party_id) {
+      futures.push_back(std::async(std::launch::async, [party_id, this]() {
+        encrypto::motion::ShareWrapper share_input{
+            motion_parties_.at(party_id)->In<Protocol>(plaintext_input_, input_owner_)};
+
+        encrypto::motion::ShareWrapper share_transposed{share_input.TransposeWiresSimd()};
+        EXPECT_EQ(share_transposed->GetBitLength(), number_of_simd_);
+        EXPECT_EQ(share_transposed->GetNumberOfSimdValues(), number_of_wires_);
+        // transposing twice yields the input again
+        encrypto::motion::ShareWrapper share_restored{share_transposed.TransposeWiresSimd()};
+
+        auto share_output{share_transposed.Out()};
+        auto share_restored_output{share_restored.Out()};
+
+        motion_parties_.at(party_id)->Run();
+
+        CheckCorrectness(share_output.As<std::vector<encrypto::motion::BitVector<>>>());
+        EXPECT_EQ(share_restored_output.As<std::vector<encrypto::motion::BitVector<>>>(),
+                  plaintext_input_);
+
+        motion_parties_.at(party_id)->Finish();
+      }));
+    }
+    for (auto& f : futures) f.get();
+  }
+
+ protected:
+  std::size_t number_of_parties_ = 0, number_of_wires_ = 0, number_of_simd_ = 0, input_owner_ = 0;
+  bool online_after_setup_ = false;
+  std::vector<encrypto::motion::BitVector<>> plaintext_input_;
+  std::vector<encrypto::motion::PartyPointer> motion_parties_;
+};
+
+TEST_P(TransposeTest, BooleanGmw) {
+  RunTransposition<encrypto::motion::MpcProtocol::kBooleanGmw>();
+}
+
+TEST_P(TransposeTest, GarbledCircuit) {
+  // garbled circuits are a two-party protocol
+  if (number_of_parties_ != 2) return;
+  RunTransposition<encrypto::motion::MpcProtocol::kGarbledCircuit>();
+}
+
+constexpr std::array<std::size_t, 2> kNumberOfParties{2, 3};
+constexpr std::array<std::size_t, 3> kNumberOfWires{1, 8, 130};
+constexpr std::array<std::size_t, 3> kNumberOfSimd{1, 64, 100};
+constexpr std::array<bool, 2> kOnlineAfterSetup{false, true};
+
+INSTANTIATE_TEST_SUITE_P(DataManagementTestSuite, TransposeTest,
+                         testing::Combine(testing::ValuesIn(kNumberOfParties),
+                                          testing::ValuesIn(kNumberOfWires),
+                                          testing::ValuesIn(kNumberOfSimd),
+                                          testing::ValuesIn(kOnlineAfterSetup)),
+                         [](const testing::TestParamInfo<TransposeTest::ParamType>& info) {
+                           const auto mode =
+                               static_cast<bool>(std::get<3>(info.param)) ? "Seq" : "Par";
+                           std::string name = fmt::format(
+                               "{}_Parties_{}_Wires_{}_SIMD__{}", std::get<0>(info.param),
+                               std::get<1>(info.param), std::get<2>(info.param), mode);
+                           return name;
+                         });
+
+}  // namespace
@@ -212,6 +212,68 @@ TEST_P(BooleanUnsimdifyTest, BooleanGmw) {
   }
 }
 
+TEST_P(BooleanUnsimdifyTest, BooleanGmwReveal) {
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < this->motion_parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [party_id, this]() {
+      encrypto::motion::ShareWrapper share_input{
+          this->motion_parties_.at(party_id)->In<encrypto::motion::MpcProtocol::kBooleanGmw>(
+              this->plaintext_boolean_input_, this->input_owner_)};
+
+      std::vector<encrypto::motion::ShareWrapper> share_unsimdified = share_input.Unsimdify();
+      auto share_output{
+          this->motion_parties_.at(party_id)->GetBackend()->Reveal(share_unsimdified)};
+
+      this->motion_parties_.at(party_id)->Run();
+
+      // all parties obtain the outputs
+      ASSERT_EQ(share_output.size(), this->number_of_simd_);
+      for (std::size_t i = 0; i < share_output.size(); ++i) {
+        this->CheckCorrectness(share_output[i].As<std::vector<encrypto::motion::BitVector<>>>(),
+                               i);
+      }
+      this->motion_parties_.at(party_id)->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST_P(ArithmeticUnsimdifyTest, ArithmeticGmwReveal) {
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < this->motion_parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [party_id, this]() {
+      auto& party{this->motion_parties_.at(party_id)};
+      std::vector<encrypto::motion::ShareWrapper> share_input{
+          party->In<encrypto::motion::MpcProtocol::kArithmeticGmw>(
+              std::get<std::vector<uint8_t>>(this->plaintext_arithmetic_input_),
+              this->input_owner_),
+          party->In<encrypto::motion::MpcProtocol::kArithmeticGmw>(
+              std::get<std::vector<uint64_t>>(this->plaintext_arithmetic_input_),
+              this->input_owner_)};
+
+      // the values of both rings are revealed at once, interleaved to check the order
+      auto unsimdified_8{share_input[0].Unsimdify()};
+      auto unsimdified_64{share_input[1].Unsimdify()};
+      std::vector<encrypto::motion::ShareWrapper> shares;
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        shares.emplace_back(unsimdified_8[i]);
+        shares.emplace_back(unsimdified_64[i]);
+      }
+      auto share_output{party->GetBackend()->Reveal(shares)};
+
+      party->Run();
+
+      ASSERT_EQ(share_output.size(), 2 * this->number_of_simd_);
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        this->CheckCorrectness(share_output[2 * i].As<uint8_t>(), i);
+        this->CheckCorrectness(share_output[2 * i + 1].As<uint64_t>(), i);
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
 TEST_P(ArithmeticUnsimdifyTest, ArithmeticGmw) {
   try {
     std::vector<std::future<void>> futures;